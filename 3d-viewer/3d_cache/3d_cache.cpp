@@ -23,19 +23,28 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <config.h>
+
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <utility>
 #include <iterator>
+#include <set>
+#include <vector>
+#include <stdint.h>
 
 #include <wx/datetime.h>
+#include <wx/filefn.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/thread.h>
 #include <wx/utils.h>
 #include <wx/stdpaths.h>
 
+#include <boost/bind.hpp>
 #include <boost/uuid/sha1.hpp>
 
 #include <glm/glm.hpp>
@@ -46,14 +55,175 @@
 #include "sg/scenegraph.h"
 #include "3d_filename_resolver.h"
 #include "3d_plugin_manager.h"
+#include "3d_mesh_cache.h"
+#include "3d_mesh_simplify.h"
 #include "plugins/3dapi/ifsg_api.h"
 
+#include <pgm_base.h>
+#include <thread_pool.h>
+#include <memory_stats.h>
+
 
 #define CACHE_CONFIG_NAME wxT( "cache.cfg" )
+#define HASH_INDEX_NAME wxT( "hashes.idx" )
 #define MASK_3D_CACHE "3D_CACHE"
 
+// the models with less triangles have a single level of detail, the full one
+#define LOD_MIN_TRIANGLES 4096
+
+// the triangle ratio of each simplified level of detail, relative to the full model
+static const float lodRatio[S3D_LOD_COUNT] = { 1.0f, 0.25f, 0.0625f };
+
+#if defined( KICAD_3D_FAST_HASH )
+#define HASH_INDEX_HEADER "kicad-3d-hash-index 1 xxh64"
+#else
+#define HASH_INDEX_HEADER "kicad-3d-hash-index 1 sha1"
+#endif
+
 static wxCriticalSection lock3D_cache;
 
+// the 3D plugins switch the process locale and fill static tables while parsing
+static wxCriticalSection lock3D_plugins;
+
+// the hash index is shared by the Preload() tasks
+static wxCriticalSection lock3D_hashes;
+
+#if defined( KICAD_3D_FAST_HASH )
+
+/// The streaming state of an xxHash64 digest, see https://github.com/Cyan4973/xxHash
+class XXH64_STATE
+{
+public:
+    XXH64_STATE() : m_totalSize( 0 ), m_bufferSize( 0 )
+    {
+        m_acc[0] = PRIME1 + PRIME2;
+        m_acc[1] = PRIME2;
+        m_acc[2] = 0;
+        m_acc[3] = 0 - PRIME1;
+    }
+
+    void Update( const unsigned char* aData, size_t aSize )
+    {
+        m_totalSize += aSize;
+
+        if( m_bufferSize + aSize < 32 )
+        {
+            memcpy( m_buffer + m_bufferSize, aData, aSize );
+            m_bufferSize += aSize;
+            return;
+        }
+
+        if( m_bufferSize )
+        {
+            size_t fill = 32 - m_bufferSize;
+
+            memcpy( m_buffer + m_bufferSize, aData, fill );
+            stripe( m_buffer );
+            aData += fill;
+            aSize -= fill;
+            m_bufferSize = 0;
+        }
+
+        for( ; aSize >= 32; aData += 32, aSize -= 32 )
+            stripe( aData );
+
+        memcpy( m_buffer, aData, aSize );
+        m_bufferSize = aSize;
+    }
+
+    uint64_t Digest() const
+    {
+        uint64_t h;
+
+        if( m_totalSize >= 32 )
+        {
+            h = rotl( m_acc[0], 1 ) + rotl( m_acc[1], 7 ) + rotl( m_acc[2], 12 )
+                + rotl( m_acc[3], 18 );
+
+            for( int i = 0; i < 4; ++i )
+                h = ( h ^ round( 0, m_acc[i] ) ) * PRIME1 + PRIME4;
+        }
+        else
+        {
+            h = PRIME5;
+        }
+
+        h += m_totalSize;
+
+        const unsigned char* p = m_buffer;
+        size_t               n = m_bufferSize;
+
+        for( ; n >= 8; p += 8, n -= 8 )
+            h = rotl( h ^ round( 0, read64( p ) ), 27 ) * PRIME1 + PRIME4;
+
+        if( n >= 4 )
+        {
+            h = rotl( h ^ ( read32( p ) * PRIME1 ), 23 ) * PRIME2 + PRIME3;
+            p += 4;
+            n -= 4;
+        }
+
+        for( ; n > 0; ++p, --n )
+            h = rotl( h ^ ( *p * PRIME5 ), 11 ) * PRIME1;
+
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        h *= PRIME3;
+        h ^= h >> 32;
+
+        return h;
+    }
+
+private:
+    static const uint64_t PRIME1 = 11400714785074694791ULL;
+    static const uint64_t PRIME2 = 14029467366897019727ULL;
+    static const uint64_t PRIME3 = 1609587929392839161ULL;
+    static const uint64_t PRIME4 = 9650029242287828579ULL;
+    static const uint64_t PRIME5 = 2870177450012600261ULL;
+
+    static uint64_t rotl( uint64_t aValue, int aBits )
+    {
+        return ( aValue << aBits ) | ( aValue >> ( 64 - aBits ) );
+    }
+
+    static uint64_t round( uint64_t aAcc, uint64_t aInput )
+    {
+        return rotl( aAcc + aInput * PRIME2, 31 ) * PRIME1;
+    }
+
+    // the digest is defined on little endian words
+    static uint64_t read64( const unsigned char* p )
+    {
+        uint64_t v = 0;
+
+        for( int i = 7; i >= 0; --i )
+            v = ( v << 8 ) | p[i];
+
+        return v;
+    }
+
+    static uint64_t read32( const unsigned char* p )
+    {
+        return (uint64_t) p[0] | ( (uint64_t) p[1] << 8 ) | ( (uint64_t) p[2] << 16 )
+               | ( (uint64_t) p[3] << 24 );
+    }
+
+    void stripe( const unsigned char* aData )
+    {
+        for( int i = 0; i < 4; ++i )
+            m_acc[i] = round( m_acc[i], read64( aData + 8 * i ) );
+    }
+
+    uint64_t        m_acc[4];
+    uint64_t        m_totalSize;
+    unsigned char   m_buffer[32];
+    size_t          m_bufferSize;
+};
+
+#endif
+
+
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 {
     for( int i = 0; i < 20; ++i )
@@ -122,12 +292,19 @@ public:
 
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName( void );
-
-    wxDateTime    modTime;      // file modification time
-    unsigned char sha1sum[20];
-    std::string   pluginInfo;   // PluginName:Version string
-    SCENEGRAPH*   sceneData;
-    S3DMODEL*     renderData;
+    void FreeRenderData( void );
+
+    wxDateTime      modTime;        // file modification time
+    unsigned char   sha1sum[20];
+    std::string     pluginInfo;     // PluginName:Version string
+    SCENEGRAPH*     sceneData;
+    S3DMODEL*       renderData;
+    S3D_MESH_CACHE* meshData;       // mapped mesh file holding renderData, if any
+    bool            sceneSkipped;   // sceneData was not loaded, renderData came from meshData
+
+    // the simplified levels of detail 1 and up, NULL until loaded or built
+    S3DMODEL*       lodData[S3D_LOD_COUNT - 1];
+    S3D_MESH_CACHE* lodMeshData[S3D_LOD_COUNT - 1];
 };
 
 
@@ -135,7 +312,15 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    meshData = NULL;
+    sceneSkipped = false;
     memset( sha1sum, 0, 20 );
+
+    for( int i = 0; i < S3D_LOD_COUNT - 1; ++i )
+    {
+        lodData[i] = NULL;
+        lodMeshData[i] = NULL;
+    }
 }
 
 
@@ -144,8 +329,39 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
     if( NULL != sceneData )
         delete sceneData;
 
-    if( NULL != renderData )
+    FreeRenderData();
+}
+
+
+void S3D_CACHE_ENTRY::FreeRenderData( void )
+{
+    // a mapped model belongs to its mesh file
+    if( NULL != meshData )
+    {
+        delete meshData;
+        meshData = NULL;
+        renderData = NULL;
+    }
+    else if( NULL != renderData )
+    {
         S3D::Destroy3DModel( &renderData );
+    }
+
+    for( int i = 0; i < S3D_LOD_COUNT - 1; ++i )
+    {
+        if( NULL != lodMeshData[i] )
+        {
+            delete lodMeshData[i];
+            lodMeshData[i] = NULL;
+            lodData[i] = NULL;
+        }
+        else if( NULL != lodData[i] )
+        {
+            S3D::Destroy3DModel( &lodData[i] );
+        }
+    }
+
+    sceneSkipped = false;
 }
 
 
@@ -182,14 +398,91 @@ const wxString S3D_CACHE_ENTRY::GetCacheBaseName( void )
 S3D_CACHE::S3D_CACHE()
 {
     m_DirtyCache = false;
+    m_HashIndexLoaded = false;
+    m_HashIndexDirty = false;
+    m_BuildLODs = true;
     m_FNResolver = new S3D_FILENAME_RESOLVER;
     m_Plugins = new S3D_PLUGIN_MANAGER;
 
+    MEMORY_STATS::RegisterSource( this, boost::bind( &S3D_CACHE::addMemoryStats, this, _1 ) );
+
     return;
 }
 
+// the size of the arrays of the meshes of a model
+static size_t modelBytes( const S3DMODEL* aModel )
+{
+    size_t bytes = sizeof( S3DMODEL ) + aModel->m_MaterialsSize * sizeof( SMATERIAL );
+
+    for( unsigned int i = 0; i < aModel->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel->m_Meshes[i];
+        size_t       vertexBytes = 2 * sizeof( SFVEC3F );
+
+        if( mesh.m_Texcoords )
+            vertexBytes += sizeof( SFVEC2F );
+
+        if( mesh.m_Color )
+            vertexBytes += sizeof( SFVEC3F );
+
+        bytes += sizeof( SMESH ) + mesh.m_VertexSize * vertexBytes
+                 + mesh.m_FaceIdxSize * sizeof( unsigned int );
+    }
+
+    return bytes;
+}
+
+
+void S3D_CACHE::addMemoryStats( MEMORY_STATS& aStats ) const
+{
+    size_t models = 0, renderBytes = 0;
+    size_t mapped = 0, mappedBytes = 0;
+    size_t lods = 0, lodBytes = 0;
+    size_t scenes = 0;
+
+    std::list< S3D_CACHE_ENTRY* >::const_iterator sL = m_CacheList.begin();
+
+    while( sL != m_CacheList.end() )
+    {
+        const S3D_CACHE_ENTRY* entry = *sL;
+
+        // the mesh files are mapped, their pages are only resident once drawn
+        if( entry->renderData && entry->meshData )
+        {
+            ++mapped;
+            mappedBytes += modelBytes( entry->renderData );
+        }
+        else if( entry->renderData )
+        {
+            ++models;
+            renderBytes += modelBytes( entry->renderData );
+        }
+
+        for( int i = 0; i < S3D_LOD_COUNT - 1; ++i )
+        {
+            if( entry->lodData[i] )
+            {
+                ++lods;
+                lodBytes += modelBytes( entry->lodData[i] );
+            }
+        }
+
+        if( entry->sceneData )
+            ++scenes;
+
+        ++sL;
+    }
+
+    aStats.Add( wxT( "3D models" ), wxT( "render data" ), models, renderBytes );
+    aStats.Add( wxT( "3D models" ), wxT( "mapped render data" ), mapped, mappedBytes );
+    aStats.Add( wxT( "3D models" ), wxT( "levels of detail" ), lods, lodBytes );
+    aStats.Add( wxT( "3D models" ), wxT( "scene graphs (not sized)" ), scenes, 0 );
+}
+
+
 S3D_CACHE::~S3D_CACHE()
 {
+    MEMORY_STATS::UnregisterSource( this );
     FlushCache();
 
     if( m_FNResolver )
@@ -202,7 +495,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aRenderDataOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -249,11 +543,23 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
                 mi->second->sceneData = NULL;
             }
 
-            if( NULL != mi->second->renderData )
-                S3D::Destroy3DModel( &mi->second->renderData );
-
+            mi->second->FreeRenderData();
             mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
         }
+        else if( mi->second->sceneSkipped && !aRenderDataOnly )
+        {
+            // the model was only needed for rendering so far
+            mi->second->sceneSkipped = false;
+
+            if( !loadCacheData( mi->second ) )
+            {
+                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath,
+                                                                mi->second->pluginInfo );
+
+                if( NULL != mi->second->sceneData )
+                    saveCacheData( mi->second );
+            }
+        }
 
         if( NULL != aCachePtr )
             *aCachePtr = mi->second;
@@ -262,7 +568,7 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
     }
 
     // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return checkCache( full3Dpath, aCachePtr, aRenderDataOnly );
 }
 
 
@@ -272,7 +578,80 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+void S3D_CACHE::Preload( const std::list< wxString >& aModelFiles )
+{
+    std::vector< wxString > files;
+    std::set< wxString > resolved;
+
+    // the resolver is not thread safe, and a model is loaded once for all its users
+    for( std::list< wxString >::const_iterator it = aModelFiles.begin();
+         it != aModelFiles.end(); ++it )
+    {
+        wxString full3Dpath = m_FNResolver->ResolvePath( *it );
+
+        if( full3Dpath.empty() || m_CacheMap.find( full3Dpath ) != m_CacheMap.end()
+            || !resolved.insert( full3Dpath ).second )
+            continue;
+
+        files.push_back( full3Dpath );
+    }
+
+    if( files.empty() )
+        return;
+
+    std::vector< S3D_CACHE_ENTRY* > entries( files.size() );
+
+    {
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( size_t i = 0; i < files.size(); ++i )
+        {
+            entries[i] = new S3D_CACHE_ENTRY;
+            tasks.Run( boost::bind( &S3D_CACHE::preloadModel, this, entries[i], &files[i] ) );
+        }
+
+        tasks.Wait();
+    }
+
+    wxCriticalSectionLocker lock( lock3D_cache );
+
+    for( size_t i = 0; i < files.size(); ++i )
+    {
+        // a file which cannot be loaded gets an empty entry, as in checkCache()
+        m_CacheList.push_back( entries[i] );
+        m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( files[i], entries[i] ) );
+    }
+}
+
+
+void S3D_CACHE::preloadModel( S3D_CACHE_ENTRY* aCacheItem, const wxString* aFileName )
+{
+    wxFileName fname( *aFileName );
+    aCacheItem->modTime = fname.GetModificationTime();
+
+    unsigned char sha1sum[20];
+
+    if( !getSHA1( *aFileName, sha1sum ) || m_CacheDir.empty() )
+        return;
+
+    aCacheItem->SetSHA1( sha1sum );
+
+    wxString cachename = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dc" );
+
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return;
+
+    wxCriticalSectionLocker lock( lock3D_plugins );
+
+    aCacheItem->sceneData = m_Plugins->Load3DModel( *aFileName, aCacheItem->pluginInfo );
+
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
+}
+
+
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr,
+                                   bool aRenderDataOnly )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -343,6 +722,10 @@ SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY**
 
     ep->SetSHA1( sha1sum );
 
+    // the mesh file is read without building the scene graph
+    if( aRenderDataOnly && loadMeshData( ep ) )
+        return NULL;
+
     wxString bname = ep->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
@@ -388,11 +771,79 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
         return false;
     }
 
+    wxFileName fname( aFileName );
+    wxULongLong fsize = fname.GetSize();
+    wxDateTime fmdate = fname.GetModificationTime();
+    bool hasStat = fsize != wxInvalidSize && fmdate.IsValid();
+    HASH_RECORD rec;
+
+    if( hasStat )
+    {
+        rec.size = (long long) fsize.GetValue();
+        rec.modTime = (long long) fmdate.GetValue().GetValue();
+
+        wxCriticalSectionLocker lock( lock3D_hashes );
+        loadHashIndex();
+
+        std::map< wxString, HASH_RECORD >::const_iterator it = m_HashIndex.find( aFileName );
+
+        // the contents are hashed again only when the file is changed
+        if( it != m_HashIndex.end() && it->second.size == rec.size
+            && it->second.modTime == rec.modTime )
+        {
+            memcpy( aSHA1Sum, it->second.sha1sum, 20 );
+            return true;
+        }
+    }
+
+    if( !hashFile( aFileName, aSHA1Sum ) )
+        return false;
+
+    if( hasStat )
+    {
+        memcpy( rec.sha1sum, aSHA1Sum, 20 );
+
+        wxCriticalSectionLocker lock( lock3D_hashes );
+        m_HashIndex[aFileName] = rec;
+        m_HashIndexDirty = true;
+    }
+
+    return true;
+}
+
+
+bool S3D_CACHE::hashFile( const wxString& aFileName, unsigned char* aSHA1Sum )
+{
     FILE* fp = fopen( aFileName.ToUTF8(), "rb" );
 
     if( NULL == fp )
         return false;
 
+#if defined( KICAD_3D_FAST_HASH )
+    XXH64_STATE dblock;
+    unsigned char block[4096];
+    size_t bsize = 0;
+    uint64_t fsize = 0;
+
+    while( ( bsize = fread( &block, 1, 4096, fp ) ) > 0 )
+    {
+        dblock.Update( block, bsize );
+        fsize += bsize;
+    }
+
+    fclose( fp );
+
+    // the 64 bits digest, then the file size, in MSB order
+    uint64_t digest = dblock.Digest();
+
+    for( int i = 7; i >= 0; --i, digest >>= 8, fsize >>= 8 )
+    {
+        aSHA1Sum[i] = digest & 0xff;
+        aSHA1Sum[i + 8] = fsize & 0xff;
+    }
+
+    memcpy( aSHA1Sum + 16, "xxh6", 4 );
+#else
     boost::uuids::detail::sha1 dblock;
     unsigned char block[4096];
     size_t bsize = 0;
@@ -417,6 +868,7 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
         tmp >>= 8;
         aSHA1Sum[idx] = tmp & 0xff;
     }
+#endif
 
     return true;
 }
@@ -533,6 +985,56 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+bool S3D_CACHE::loadMeshData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    aCacheItem->FreeRenderData();
+    aCacheItem->meshData = new S3D_MESH_CACHE;
+    aCacheItem->renderData = aCacheItem->meshData->Load( fname );
+
+    if( NULL == aCacheItem->renderData )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot read mesh file '%s'\n",
+            fname.ToUTF8() );
+
+        aCacheItem->FreeRenderData();
+        return false;
+    }
+
+    aCacheItem->sceneSkipped = ( NULL == aCacheItem->sceneData );
+    return true;
+}
+
+
+bool S3D_CACHE::saveMeshData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL == aCacheItem->renderData )
+        return false;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    // a mapped model was read from its mesh file
+    if( NULL != aCacheItem->meshData )
+        return true;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dm" );
+
+    return S3D_MESH_CACHE::Save( fname, *aCacheItem->renderData );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -725,6 +1227,11 @@ void S3D_CACHE::FlushCache( bool closePlugins )
     m_CacheList.clear();
     m_CacheMap.clear();
 
+    {
+        wxCriticalSectionLocker lock( lock3D_hashes );
+        saveHashIndex();
+    }
+
     if( closePlugins )
         ClosePlugins();
 
@@ -732,6 +1239,79 @@ void S3D_CACHE::FlushCache( bool closePlugins )
 }
 
 
+void S3D_CACHE::loadHashIndex( void )
+{
+    if( m_HashIndexLoaded || m_CacheDir.empty() )
+        return;
+
+    m_HashIndexLoaded = true;
+
+    std::ifstream file( ( m_CacheDir + HASH_INDEX_NAME ).fn_str() );
+    std::string line;
+
+    if( !file.is_open() || !std::getline( file, line ) || line != HASH_INDEX_HEADER )
+        return;
+
+    // one line per file: size, modification time, hash and full path
+    while( std::getline( file, line ) )
+    {
+        HASH_RECORD rec;
+        char hash[41];
+        int  pathStart = 0;
+
+        if( sscanf( line.c_str(), "%lld %lld %40s %n", &rec.size, &rec.modTime, hash,
+                    &pathStart ) < 3 || pathStart == 0 || strlen( hash ) != 40 )
+            continue;
+
+        for( int i = 0; i < 20; ++i )
+        {
+            unsigned int byte;
+
+            sscanf( hash + 2 * i, "%2x", &byte );
+            rec.sha1sum[i] = byte;
+        }
+
+        m_HashIndex[wxString::FromUTF8( line.c_str() + pathStart )] = rec;
+    }
+}
+
+
+void S3D_CACHE::saveHashIndex( void )
+{
+    if( !m_HashIndexDirty || m_CacheDir.empty() )
+        return;
+
+    wxString fname = m_CacheDir + HASH_INDEX_NAME;
+    wxString tmpName = fname + wxT( ".tmp" );
+    std::ofstream file( tmpName.fn_str() );
+
+    if( !file.is_open() )
+        return;
+
+    file << HASH_INDEX_HEADER << "\n";
+
+    std::map< wxString, HASH_RECORD >::const_iterator it;
+
+    for( it = m_HashIndex.begin(); it != m_HashIndex.end(); ++it )
+    {
+        // the index only saves the file reads of the files still there
+        if( !wxFileName::FileExists( it->first ) )
+            continue;
+
+        file << it->second.size << " " << it->second.modTime << " ";
+        file << sha1ToWXString( it->second.sha1sum ).ToUTF8() << " ";
+        file << it->first.ToUTF8() << "\n";
+    }
+
+    file.close();
+
+    if( !file.fail() && wxRenameFile( tmpName, fname, true ) )
+        m_HashIndexDirty = false;
+    else
+        wxRemoveFile( tmpName );
+}
+
+
 void S3D_CACHE::ClosePlugins( void )
 {
     if( NULL != m_Plugins )
@@ -741,35 +1321,103 @@ void S3D_CACHE::ClosePlugins( void )
 }
 
 
-S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
+S3DMODEL* S3D_CACHE::getLOD( S3D_CACHE_ENTRY* aCacheItem, int aLOD )
 {
-    S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
+    S3DMODEL*& lod = aCacheItem->lodData[aLOD - 1];
 
-    if( !sp )
-        return NULL;
+    if( NULL != lod )
+        return lod;
+
+    if( !m_BuildLODs || S3D::CountTriangles( *aCacheItem->renderData ) < LOD_MIN_TRIANGLES )
+        return aCacheItem->renderData;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
+    wxString fname;
+
+    if( !bname.empty() && !m_CacheDir.empty() )
+        fname = m_CacheDir + bname + wxString::Format( wxT( "-%d.3dm" ), aLOD );
 
-    if( !cp )
+    if( !fname.empty() && wxFileName::FileExists( fname ) )
     {
-        #ifdef DEBUG
-        do {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
-            ostr << " * [BUG] model loaded with no associated S3D_CACHE_ENTRY";
-            wxLogTrace( MASK_3D_CACHE, "%s\n", ostr.str().c_str() );
-        } while( 0 );
-        #endif
+        aCacheItem->lodMeshData[aLOD - 1] = new S3D_MESH_CACHE;
+        lod = aCacheItem->lodMeshData[aLOD - 1]->Load( fname );
 
-        return NULL;
+        if( NULL != lod )
+            return lod;
+
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot read mesh file '%s'\n",
+            fname.ToUTF8() );
+
+        delete aCacheItem->lodMeshData[aLOD - 1];
+        aCacheItem->lodMeshData[aLOD - 1] = NULL;
+    }
+
+    lod = S3D::SimplifyModel( *aCacheItem->renderData, lodRatio[aLOD] );
+
+    if( !fname.empty() )
+        S3D_MESH_CACHE::Save( fname, *lod );
+
+    return lod;
+}
+
+
+S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName, int aLOD )
+{
+    S3D_CACHE_ENTRY* cp = NULL;
+    SCENEGRAPH* sp = load( aModelFileName, &cp, true );
+
+    // the render data may come from a mesh file, without a scene graph
+    if( !cp || !cp->renderData )
+    {
+        if( !sp )
+            return NULL;
+
+        if( !cp )
+        {
+            #ifdef DEBUG
+            do {
+                std::ostringstream ostr;
+                ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+                ostr << " * [BUG] model loaded with no associated S3D_CACHE_ENTRY";
+                wxLogTrace( MASK_3D_CACHE, "%s\n", ostr.str().c_str() );
+            } while( 0 );
+            #endif
+
+            return NULL;
+        }
+
+        cp->renderData = S3D::GetModel( sp );
+
+        if( NULL == cp->renderData )
+            return NULL;
+
+        saveMeshData( cp );
+
+        // the levels of detail are written along with the mesh file, they are mapped
+        // afterwards as the full model is
+        if( m_BuildLODs )
+        {
+            for( int i = 1; i < S3D_LOD_COUNT; ++i )
+                getLOD( cp, i );
+        }
     }
 
-    if( cp->renderData )
+    if( aLOD <= 0 )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    return getLOD( cp, std::min( aLOD, S3D_LOD_COUNT - 1 ) );
+}
+
+
+int S3D_CACHE::SelectLOD( float aScreenSize )
+{
+    if( aScreenSize >= 256.0f )
+        return 0;
+
+    if( aScreenSize >= 64.0f )
+        return 1;
 
-    return mp;
+    return 2;
 }
 
 
@@ -37,6 +37,9 @@
 #include "3d_info.h"
 #include "plugins/3dapi/c3dmodel.h"
 
+/// the number of levels of detail of a model, the full model being level 0
+#define S3D_LOD_COUNT 3
+
 
 class  PGM_BASE;
 class  S3D_CACHE;
@@ -44,6 +47,7 @@ class  S3D_CACHE_ENTRY;
 class  SCENEGRAPH;
 class  S3D_FILENAME_RESOLVER;
 class  S3D_PLUGIN_MANAGER;
+class  MEMORY_STATS;
 struct S3D_INFO;
 
 
@@ -74,6 +78,29 @@ private:
     /// current KiCad project dir
     wxString m_ProjDir;
 
+    /// the content hash of a model file, valid while the file keeps its size and date
+    struct HASH_RECORD
+    {
+        long long       size;
+        long long       modTime;
+        unsigned char   sha1sum[20];
+    };
+
+    /// content hashes of the model files by full path, saved in the cache directory
+    std::map< wxString, HASH_RECORD > m_HashIndex;
+    bool m_HashIndexLoaded;
+    bool m_HashIndexDirty;
+
+    /// set true to build the simplified levels of detail of the models
+    bool m_BuildLODs;
+
+    // read and write the hash index file of the cache directory
+    void loadHashIndex( void );
+    void saveHashIndex( void );
+
+    // hash the contents of a model file
+    bool hashFile( const wxString& aFileName, unsigned char* aSHA1Sum );
+
     /**
      * Function checkCache
      * searches the cache list for the given filename and retrieves
@@ -82,13 +109,18 @@ private:
      *
      * @param aFileName [in] is a partial or full file path
      * @param [out] if not NULL will hold a pointer to the cache entry for the model
+     * @param aRenderDataOnly [in] is true when only the render data is needed: the scene
+     * graph is not built when the model has a mesh cache file
      * @return on success a pointer to a SCENEGRAPH, otherwise NULL
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                            bool aRenderDataOnly = false );
 
     /**
      * Function getSHA1
-     * calculates the SHA1 hash of the given file
+     * returns the content hash of the given file, the SHA1 hash, or with the
+     * KICAD_3D_FAST_HASH build option an xxHash64 digest.  The hash of the index is
+     * returned while the file keeps the size and modification time it was hashed with.
      *
      * @param aFileName [in] is a fully qualified path to the model file
      * @param aSHA1Sum [out] is a 20-byte character array to hold the SHA1 hash
@@ -102,8 +134,29 @@ private:
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    // map the render data from a mesh cache file
+    bool loadMeshData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a mesh cache file
+    bool saveMeshData( S3D_CACHE_ENTRY* aCacheItem );
+
     // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aRenderDataOnly = false );
+
+    /**
+     * Function getLOD
+     * returns the level of detail @a aLOD, 1 or more, of the render data of a cache
+     * entry: it is mapped from its mesh file, or else simplified from the render data
+     * and saved.  The models with few triangles return their full render data.
+     */
+    S3DMODEL* getLOD( S3D_CACHE_ENTRY* aCacheItem, int aLOD );
+
+    // the Preload() task of a model, filling a new cache entry for the resolved aFileName
+    void preloadModel( S3D_CACHE_ENTRY* aCacheItem, const wxString* aFileName );
+
+    // add the size of the render data of the models to aStats, see MEMORY_STATS
+    void addMemoryStats( MEMORY_STATS& aStats ) const;
 
 public:
     S3D_CACHE();
@@ -166,6 +219,20 @@ public:
      */
     SCENEGRAPH* Load( const wxString& aModelFile );
 
+    /**
+     * Function Preload
+     * loads the scene data of a list of models on the threads of the process, so that
+     * the next Load() or GetModel() calls find them in the cache.  The model files are
+     * resolved first, and each file is loaded once.
+     *
+     * The hashing of the files and the reading of the cache files run concurrently.
+     * The plugins are not reentrant, so their parsing of the models without a cache
+     * file, and the writing of the new cache files, run one at a time.
+     *
+     * @param aModelFiles [in] are the partial or full paths to the models to be loaded
+     */
+    void Preload( const std::list< wxString >& aModelFiles );
+
     S3D_FILENAME_RESOLVER* GetResolver( void );
 
     /**
@@ -194,10 +261,30 @@ public:
      * attempts to load the scene data for a model and to translate it
      * into an S3D_MODEL structure for display by a renderer
      *
+     * The simplified levels of detail of a large model are built with its render data,
+     * and kept next to its mesh file in the cache directory.
+     *
      * @param aModelFileName is the full path to the model to be loaded
+     * @param aLOD is the level of detail, from 0 for the full model to S3D_LOD_COUNT - 1
+     * for the most simplified one, see SelectLOD()
      * @return is a pointer to the render data or NULL if not available
      */
-    S3DMODEL* GetModel( const wxString& aModelFileName );
+    S3DMODEL* GetModel( const wxString& aModelFileName, int aLOD = 0 );
+
+    /**
+     * Function SetBuildLODs
+     * enables the simplification of the models into levels of detail, on by default.
+     * When disabled, GetModel() returns the full model at every level.
+     */
+    void SetBuildLODs( bool aBuildLODs ) { m_BuildLODs = aBuildLODs; }
+
+    /**
+     * Function SelectLOD
+     * returns the level of detail to draw a model with, from its projected size.
+     * @param aScreenSize is the size in pixels of the model on the screen, see
+     * CCAMERA::GetScreenSize()
+     */
+    static int SelectLOD( float aScreenSize );
 
     wxString GetModelHash( const wxString& aModelFileName );
 };
@@ -0,0 +1,307 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#define GLM_FORCE_RADIANS
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdint.h>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include <macros.h>
+#include <richio.h>
+
+#include "3d_mesh_cache.h"
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+/*
+    The mesh file is made of native 32 bits words:
+
+    "KI3DMESH"                          magic
+    version, byte order mark            uint32 uint32
+    size of SMATERIAL                   uint32
+    material count, mesh count          uint32 uint32
+    materials                           SMATERIAL[material count]
+    for each mesh:
+        vertex count, index count       uint32 uint32
+        material index, flags           uint32 uint32
+        positions, normals              float[3 * vertex count] float[3 * vertex count]
+        texture coordinates if flags & 1    float[2 * vertex count]
+        colors if flags & 2             float[3 * vertex count]
+        triangle indexes                uint32[index count]
+
+    All the items are multiples of 4 bytes, the arrays are aligned as in memory.
+*/
+
+static const char       meshMagic[8] = { 'K', 'I', '3', 'D', 'M', 'E', 'S', 'H' };
+static const uint32_t   meshVersion = 1;
+static const uint32_t   byteOrderMark = 0x01020304;
+
+enum MESH_FLAGS
+{
+    HAS_TEXCOORDS = 1,
+    HAS_COLORS    = 2
+};
+
+
+static void writeU32( FILE* aFile, uint32_t aValue )
+{
+    fwrite( &aValue, sizeof( aValue ), 1, aFile );
+}
+
+
+static uint32_t meshFlags( const SMESH& aMesh )
+{
+    return ( aMesh.m_Texcoords ? HAS_TEXCOORDS : 0 ) | ( aMesh.m_Color ? HAS_COLORS : 0 );
+}
+
+
+S3D_MESH_CACHE::S3D_MESH_CACHE() :
+    m_file( NULL )
+{
+    memset( &m_model, 0, sizeof( m_model ) );
+}
+
+
+S3D_MESH_CACHE::~S3D_MESH_CACHE()
+{
+    delete m_file;
+}
+
+
+bool S3D_MESH_CACHE::Save( const wxString& aFileName, const S3DMODEL& aModel )
+{
+    // the meshes of a material, and of the same optional arrays, are merged into one
+    typedef std::map< std::pair< unsigned int, uint32_t >, std::vector< const SMESH* > > GROUPS;
+    GROUPS groups;
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+
+        if( !mesh.m_Positions || !mesh.m_Normals || !mesh.m_FaceIdx
+            || mesh.m_MaterialIdx >= aModel.m_MaterialsSize )
+            return false;
+
+        groups[std::make_pair( mesh.m_MaterialIdx, meshFlags( mesh ) )].push_back( &mesh );
+    }
+
+    // written to a temporary file first, an interrupted save leaves no partial cache
+    wxString tmpName = aFileName + wxT( ".tmp" );
+    FILE*    file = wxFopen( tmpName, wxT( "wb" ) );
+
+    if( !file )
+        return false;
+
+    fwrite( meshMagic, sizeof( meshMagic ), 1, file );
+    writeU32( file, meshVersion );
+    writeU32( file, byteOrderMark );
+    writeU32( file, sizeof( SMATERIAL ) );
+    writeU32( file, aModel.m_MaterialsSize );
+    writeU32( file, groups.size() );
+    fwrite( aModel.m_Materials, sizeof( SMATERIAL ), aModel.m_MaterialsSize, file );
+
+    std::vector< unsigned int > indexes;
+
+    for( GROUPS::const_iterator it = groups.begin(); it != groups.end(); ++it )
+    {
+        const std::vector< const SMESH* >& meshes = it->second;
+        uint32_t vertexCount = 0;
+
+        indexes.clear();
+
+        for( size_t i = 0; i < meshes.size(); ++i )
+        {
+            for( unsigned int j = 0; j < meshes[i]->m_FaceIdxSize; ++j )
+                indexes.push_back( meshes[i]->m_FaceIdx[j] + vertexCount );
+
+            vertexCount += meshes[i]->m_VertexSize;
+        }
+
+        writeU32( file, vertexCount );
+        writeU32( file, indexes.size() );
+        writeU32( file, it->first.first );
+        writeU32( file, it->first.second );
+
+        for( size_t i = 0; i < meshes.size(); ++i )
+            fwrite( meshes[i]->m_Positions, sizeof( SFVEC3F ), meshes[i]->m_VertexSize, file );
+
+        for( size_t i = 0; i < meshes.size(); ++i )
+            fwrite( meshes[i]->m_Normals, sizeof( SFVEC3F ), meshes[i]->m_VertexSize, file );
+
+        if( it->first.second & HAS_TEXCOORDS )
+        {
+            for( size_t i = 0; i < meshes.size(); ++i )
+                fwrite( meshes[i]->m_Texcoords, sizeof( SFVEC2F ), meshes[i]->m_VertexSize,
+                        file );
+        }
+
+        if( it->first.second & HAS_COLORS )
+        {
+            for( size_t i = 0; i < meshes.size(); ++i )
+                fwrite( meshes[i]->m_Color, sizeof( SFVEC3F ), meshes[i]->m_VertexSize, file );
+        }
+
+        if( !indexes.empty() )
+            fwrite( &indexes[0], sizeof( unsigned int ), indexes.size(), file );
+    }
+
+    bool ok = !ferror( file );
+
+    ok = ( fclose( file ) == 0 ) && ok;
+
+    if( ok )
+        ok = wxRenameFile( tmpName, aFileName, true );
+
+    if( !ok )
+        wxRemoveFile( tmpName );
+
+    return ok;
+}
+
+
+/// Reads the words of a mesh file, checking the end of the data
+struct MESH_CURSOR
+{
+    const char* m_pos;
+    const char* m_end;
+
+    ///> Returns aCount items of aSize bytes, or NULL past the end of the data
+    const void* Get( size_t aSize, size_t aCount )
+    {
+        if( aCount > (size_t) ( m_end - m_pos ) / aSize )
+            return NULL;
+
+        const void* data = m_pos;
+        m_pos += aSize * aCount;
+
+        return data;
+    }
+
+    bool Read( uint32_t& aValue )
+    {
+        const void* data = Get( sizeof( aValue ), 1 );
+
+        if( data )
+            memcpy( &aValue, data, sizeof( aValue ) );
+
+        return data != NULL;
+    }
+};
+
+
+S3DMODEL* S3D_MESH_CACHE::Load( const wxString& aFileName )
+{
+    delete m_file;
+    m_file = NULL;
+    m_meshes.clear();
+    memset( &m_model, 0, sizeof( m_model ) );
+
+    if( !wxFileName::FileExists( aFileName ) )
+        return NULL;
+
+    try
+    {
+        m_file = new MAPPED_FILE_LINE_READER( aFileName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] %s\n", TO_UTF8( ioe.errorText ) );
+        return NULL;
+    }
+
+    MESH_CURSOR cursor = { m_file->Data(), m_file->Data() + m_file->Size() };
+    const void* magic = cursor.Get( sizeof( meshMagic ), 1 );
+    uint32_t    version, bom, materialSize, materialCount, meshCount;
+
+    if( !magic || memcmp( magic, meshMagic, sizeof( meshMagic ) )
+        || !cursor.Read( version ) || version != meshVersion
+        || !cursor.Read( bom ) || bom != byteOrderMark
+        || !cursor.Read( materialSize ) || materialSize != sizeof( SMATERIAL )
+        || !cursor.Read( materialCount ) || materialCount == 0
+        || !cursor.Read( meshCount ) || meshCount == 0 )
+        return NULL;
+
+    const SMATERIAL* materials = (const SMATERIAL*) cursor.Get( sizeof( SMATERIAL ),
+                                                                materialCount );
+
+    if( !materials )
+        return NULL;
+
+    m_meshes.resize( meshCount );
+
+    for( uint32_t i = 0; i < meshCount; ++i )
+    {
+        SMESH&   mesh = m_meshes[i];
+        uint32_t vertexCount, indexCount, materialIdx, flags;
+
+        memset( &mesh, 0, sizeof( mesh ) );
+
+        if( !cursor.Read( vertexCount ) || !cursor.Read( indexCount )
+            || !cursor.Read( materialIdx ) || materialIdx >= materialCount
+            || !cursor.Read( flags ) )
+            return NULL;
+
+        mesh.m_VertexSize  = vertexCount;
+        mesh.m_FaceIdxSize = indexCount;
+        mesh.m_MaterialIdx = materialIdx;
+
+        // the renderer only reads the arrays
+        mesh.m_Positions = (SFVEC3F*) cursor.Get( sizeof( SFVEC3F ), vertexCount );
+        mesh.m_Normals   = (SFVEC3F*) cursor.Get( sizeof( SFVEC3F ), vertexCount );
+
+        if( flags & HAS_TEXCOORDS )
+            mesh.m_Texcoords = (SFVEC2F*) cursor.Get( sizeof( SFVEC2F ), vertexCount );
+
+        if( flags & HAS_COLORS )
+            mesh.m_Color = (SFVEC3F*) cursor.Get( sizeof( SFVEC3F ), vertexCount );
+
+        mesh.m_FaceIdx = (unsigned int*) cursor.Get( sizeof( unsigned int ), indexCount );
+
+        if( !mesh.m_Positions || !mesh.m_Normals || !mesh.m_FaceIdx
+            || ( ( flags & HAS_TEXCOORDS ) && !mesh.m_Texcoords )
+            || ( ( flags & HAS_COLORS ) && !mesh.m_Color ) )
+            return NULL;
+
+        for( uint32_t j = 0; j < indexCount; ++j )
+        {
+            if( mesh.m_FaceIdx[j] >= vertexCount )
+                return NULL;
+        }
+    }
+
+    if( cursor.m_pos != cursor.m_end )
+        return NULL;
+
+    m_model.m_MaterialsSize = materialCount;
+    m_model.m_Materials     = (SMATERIAL*) materials;
+    m_model.m_MeshesSize    = meshCount;
+    m_model.m_Meshes        = &m_meshes[0];
+
+    return &m_model;
+}
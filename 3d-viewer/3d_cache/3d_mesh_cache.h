@@ -0,0 +1,84 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_mesh_cache.h
+ * defines the flat binary cache files of the render data of 3D models
+ */
+
+#ifndef MESH_CACHE_3D_H
+#define MESH_CACHE_3D_H
+
+#include <vector>
+#include <wx/string.h>
+#include "plugins/3dapi/c3dmodel.h"
+
+class MAPPED_FILE_LINE_READER;
+
+
+/**
+ * Class S3D_MESH_CACHE
+ * is the flat companion file of a .3dc scene graph cache file, holding the S3DMODEL of
+ * the model: the materials, then for each material the vertex, normal, color and index
+ * arrays of all its triangles.  The file is mapped into memory and the S3DMODEL points
+ * into it, so a model is loaded without building its scene graph, and without copying
+ * the arrays.
+ *
+ * The file is made of native words, it is not meant to be moved to another machine.
+ * It is a cache only: a model whose mesh file cannot be read is loaded again from its
+ * scene graph.
+ */
+class S3D_MESH_CACHE
+{
+public:
+    S3D_MESH_CACHE();
+    ~S3D_MESH_CACHE();
+
+    /**
+     * Function Save
+     * writes @a aModel to the mesh file @a aFileName, merging its meshes of the same
+     * material into one.
+     * @return false if the file could not be written.
+     */
+    static bool Save( const wxString& aFileName, const S3DMODEL& aModel );
+
+    /**
+     * Function Load
+     * maps the mesh file @a aFileName.
+     * @return the model read from the file, owned by this object and valid until it is
+     * destroyed, or NULL if the file cannot be read.  The arrays of the model are read
+     * only.
+     */
+    S3DMODEL* Load( const wxString& aFileName );
+
+private:
+    // prohibit assignment and default copy constructor
+    S3D_MESH_CACHE( const S3D_MESH_CACHE& source );
+    S3D_MESH_CACHE& operator=( const S3D_MESH_CACHE& source );
+
+    MAPPED_FILE_LINE_READER*    m_file;
+    std::vector< SMESH >        m_meshes;
+    S3DMODEL                    m_model;
+};
+
+#endif  // MESH_CACHE_3D_H
@@ -0,0 +1,598 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_mesh_simplify.cpp
+ * implements the quadric error simplification of the render data of 3D models
+ */
+
+#define GLM_FORCE_RADIANS
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <stdint.h>
+
+#include "3d_mesh_simplify.h"
+#include "plugins/3dapi/ifsg_api.h"
+
+/// The meshes with less triangles are copied as they are
+#define MIN_SIMPLIFIED_TRIANGLES 64
+
+/// The weight of the planes keeping the open borders of a mesh, relative to its faces
+#define BORDER_WEIGHT 10.0
+
+
+namespace
+{
+
+/// A symmetric 4x4 matrix, the sum of the squared distances to a set of planes
+struct QUADRIC
+{
+    double m[10];
+
+    QUADRIC()
+    {
+        std::fill( m, m + 10, 0.0 );
+    }
+
+    void AddPlane( const SFVEC3F& aNormal, const SFVEC3F& aPoint, double aWeight )
+    {
+        const double a = aNormal.x;
+        const double b = aNormal.y;
+        const double c = aNormal.z;
+        const double d = -( a * aPoint.x + b * aPoint.y + c * aPoint.z );
+
+        m[0] += aWeight * a * a;
+        m[1] += aWeight * a * b;
+        m[2] += aWeight * a * c;
+        m[3] += aWeight * a * d;
+        m[4] += aWeight * b * b;
+        m[5] += aWeight * b * c;
+        m[6] += aWeight * b * d;
+        m[7] += aWeight * c * c;
+        m[8] += aWeight * c * d;
+        m[9] += aWeight * d * d;
+    }
+
+    void Add( const QUADRIC& aQuadric )
+    {
+        for( int i = 0; i < 10; ++i )
+            m[i] += aQuadric.m[i];
+    }
+
+    double Error( const SFVEC3F& aPoint ) const
+    {
+        const double x = aPoint.x;
+        const double y = aPoint.y;
+        const double z = aPoint.z;
+
+        return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x
+             + m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y
+             + m[7] * z * z + 2.0 * m[8] * z
+             + m[9];
+    }
+};
+
+
+/// The collapse of the position m_from into m_to, moved to m_target
+struct COLLAPSE
+{
+    double          m_cost;
+    unsigned int    m_from;
+    unsigned int    m_to;
+    unsigned int    m_fromStamp;    // the collapse is outdated once a position changes
+    unsigned int    m_toStamp;
+    SFVEC3F         m_target;
+
+    // the top of a std::priority_queue is its greatest element, make it the cheapest
+    bool operator<( const COLLAPSE& aCollapse ) const
+    {
+        return m_cost > aCollapse.m_cost;
+    }
+};
+
+
+/// Orders the vertices of a mesh by position, to weld the equal ones
+struct POSITION_LESS
+{
+    const SFVEC3F* m_positions;
+
+    bool operator()( unsigned int a, unsigned int b ) const
+    {
+        const SFVEC3F& pa = m_positions[a];
+        const SFVEC3F& pb = m_positions[b];
+
+        if( pa.x != pb.x )
+            return pa.x < pb.x;
+
+        if( pa.y != pb.y )
+            return pa.y < pb.y;
+
+        return pa.z < pb.z;
+    }
+};
+
+
+/// The simplification of a single mesh, on its welded positions
+class MESH_SIMPLIFIER
+{
+public:
+    MESH_SIMPLIFIER( const SMESH& aMesh );
+
+    void Simplify( unsigned int aTargetTriangles );
+
+    /// Fills aMesh with the triangles left, and their vertices
+    void Output( SMESH& aMesh ) const;
+
+private:
+    void weld();
+    void buildQuadrics();
+    void pushEdge( unsigned int aPosA, unsigned int aPosB );
+    bool flips( const COLLAPSE& aCollapse ) const;
+    void collapse( const COLLAPSE& aCollapse );
+
+    const SMESH&                m_mesh;
+
+    std::vector< SFVEC3F >      m_positions;        // the welded positions
+    std::vector< unsigned int > m_vertexPosition;   // the welded position of each vertex
+    std::vector< QUADRIC >      m_quadrics;
+    std::vector< unsigned int > m_stamps;
+    std::vector< bool >         m_collapsed;
+    std::vector< std::vector< unsigned int > > m_positionTriangles;
+
+    std::vector< unsigned int > m_triangles;        // 3 welded positions per triangle
+    std::vector< bool >         m_removed;
+    unsigned int                m_triangleCount;
+
+    std::priority_queue< COLLAPSE > m_heap;
+};
+
+
+MESH_SIMPLIFIER::MESH_SIMPLIFIER( const SMESH& aMesh ) : m_mesh( aMesh )
+{
+    weld();
+
+    const unsigned int nrTriangles = m_mesh.m_FaceIdxSize / 3;
+
+    m_triangles.resize( nrTriangles * 3 );
+    m_removed.resize( nrTriangles, false );
+    m_triangleCount = 0;
+    m_positionTriangles.resize( m_positions.size() );
+
+    for( unsigned int t = 0; t < nrTriangles; ++t )
+    {
+        unsigned int* tri = &m_triangles[t * 3];
+
+        for( int k = 0; k < 3; ++k )
+            tri[k] = m_vertexPosition[m_mesh.m_FaceIdx[t * 3 + k]];
+
+        if( tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0] )
+        {
+            m_removed[t] = true;
+            continue;
+        }
+
+        for( int k = 0; k < 3; ++k )
+            m_positionTriangles[tri[k]].push_back( t );
+
+        ++m_triangleCount;
+    }
+
+    m_quadrics.resize( m_positions.size() );
+    m_stamps.resize( m_positions.size(), 0 );
+    m_collapsed.resize( m_positions.size(), false );
+
+    buildQuadrics();
+}
+
+
+void MESH_SIMPLIFIER::weld()
+{
+    std::vector< unsigned int > order( m_mesh.m_VertexSize );
+
+    for( unsigned int i = 0; i < order.size(); ++i )
+        order[i] = i;
+
+    POSITION_LESS less = { m_mesh.m_Positions };
+
+    std::sort( order.begin(), order.end(), less );
+
+    m_vertexPosition.resize( m_mesh.m_VertexSize );
+
+    for( unsigned int i = 0; i < order.size(); ++i )
+    {
+        if( i == 0 || less( order[i - 1], order[i] ) )
+            m_positions.push_back( m_mesh.m_Positions[order[i]] );
+
+        m_vertexPosition[order[i]] = m_positions.size() - 1;
+    }
+}
+
+
+void MESH_SIMPLIFIER::buildQuadrics()
+{
+    // the edges of the triangles, as the two positions in the high and low words
+    std::vector< std::pair< uint64_t, unsigned int > > edges;
+
+    for( unsigned int t = 0; t < m_removed.size(); ++t )
+    {
+        if( m_removed[t] )
+            continue;
+
+        const unsigned int* tri = &m_triangles[t * 3];
+        const SFVEC3F& p0 = m_positions[tri[0]];
+        SFVEC3F normal = glm::cross( m_positions[tri[1]] - p0, m_positions[tri[2]] - p0 );
+        const float length = glm::length( normal );
+
+        if( length > 0.0f )
+        {
+            normal /= length;
+
+            // weighted by the area of the triangle
+            for( int k = 0; k < 3; ++k )
+                m_quadrics[tri[k]].AddPlane( normal, p0, length * 0.5 );
+        }
+
+        for( int k = 0; k < 3; ++k )
+        {
+            const unsigned int a = std::min( tri[k], tri[( k + 1 ) % 3] );
+            const unsigned int b = std::max( tri[k], tri[( k + 1 ) % 3] );
+
+            edges.push_back( std::make_pair( ( (uint64_t) a << 32 ) | b, t ) );
+        }
+    }
+
+    std::sort( edges.begin(), edges.end() );
+
+    for( unsigned int i = 0; i < edges.size(); )
+    {
+        unsigned int j = i + 1;
+
+        while( j < edges.size() && edges[j].first == edges[i].first )
+            ++j;
+
+        const unsigned int a = (unsigned int)( edges[i].first >> 32 );
+        const unsigned int b = (unsigned int)( edges[i].first & 0xFFFFFFFF );
+
+        // an edge of a single triangle is an open border: a plane across the triangle
+        // keeps it in place
+        if( j == i + 1 )
+        {
+            const unsigned int* tri = &m_triangles[edges[i].second * 3];
+            const SFVEC3F& p0 = m_positions[tri[0]];
+            const SFVEC3F faceNormal = glm::cross( m_positions[tri[1]] - p0,
+                                                   m_positions[tri[2]] - p0 );
+            const SFVEC3F edge = m_positions[b] - m_positions[a];
+            SFVEC3F normal = glm::cross( edge, faceNormal );
+            const float length = glm::length( normal );
+
+            if( length > 0.0f )
+            {
+                normal /= length;
+
+                const double weight = BORDER_WEIGHT * glm::dot( edge, edge );
+
+                m_quadrics[a].AddPlane( normal, m_positions[a], weight );
+                m_quadrics[b].AddPlane( normal, m_positions[a], weight );
+            }
+        }
+
+        pushEdge( a, b );
+        i = j;
+    }
+}
+
+
+void MESH_SIMPLIFIER::pushEdge( unsigned int aPosA, unsigned int aPosB )
+{
+    QUADRIC quadric = m_quadrics[aPosA];
+
+    quadric.Add( m_quadrics[aPosB] );
+
+    const SFVEC3F& a = m_positions[aPosA];
+    const SFVEC3F& b = m_positions[aPosB];
+    const SFVEC3F middle = ( a + b ) * 0.5f;
+
+    const double costA = quadric.Error( a );
+    const double costB = quadric.Error( b );
+    const double costMiddle = quadric.Error( middle );
+
+    COLLAPSE collapse;
+
+    if( costB <= costA && costB <= costMiddle )
+    {
+        collapse.m_from = aPosA;
+        collapse.m_to = aPosB;
+        collapse.m_target = b;
+        collapse.m_cost = costB;
+    }
+    else if( costA <= costMiddle )
+    {
+        collapse.m_from = aPosB;
+        collapse.m_to = aPosA;
+        collapse.m_target = a;
+        collapse.m_cost = costA;
+    }
+    else
+    {
+        collapse.m_from = aPosA;
+        collapse.m_to = aPosB;
+        collapse.m_target = middle;
+        collapse.m_cost = costMiddle;
+    }
+
+    collapse.m_fromStamp = m_stamps[collapse.m_from];
+    collapse.m_toStamp = m_stamps[collapse.m_to];
+
+    m_heap.push( collapse );
+}
+
+
+bool MESH_SIMPLIFIER::flips( const COLLAPSE& aCollapse ) const
+{
+    const unsigned int ends[2] = { aCollapse.m_from, aCollapse.m_to };
+
+    for( int e = 0; e < 2; ++e )
+    {
+        const std::vector< unsigned int >& triangles = m_positionTriangles[ends[e]];
+
+        for( unsigned int i = 0; i < triangles.size(); ++i )
+        {
+            if( m_removed[triangles[i]] )
+                continue;
+
+            const unsigned int* tri = &m_triangles[triangles[i] * 3];
+            SFVEC3F before[3];
+            SFVEC3F after[3];
+            int     nrEnds = 0;
+
+            for( int k = 0; k < 3; ++k )
+            {
+                before[k] = m_positions[tri[k]];
+                after[k] = before[k];
+
+                if( tri[k] == aCollapse.m_from || tri[k] == aCollapse.m_to )
+                {
+                    after[k] = aCollapse.m_target;
+                    ++nrEnds;
+                }
+            }
+
+            // the triangles of the collapsed edge are removed
+            if( nrEnds == 2 )
+                continue;
+
+            const SFVEC3F normalBefore = glm::cross( before[1] - before[0], before[2] - before[0] );
+            const SFVEC3F normalAfter = glm::cross( after[1] - after[0], after[2] - after[0] );
+
+            if( glm::dot( normalBefore, normalAfter ) <= 0.0f )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+void MESH_SIMPLIFIER::collapse( const COLLAPSE& aCollapse )
+{
+    const unsigned int from = aCollapse.m_from;
+    const unsigned int to = aCollapse.m_to;
+
+    m_collapsed[from] = true;
+    m_positions[to] = aCollapse.m_target;
+    m_quadrics[to].Add( m_quadrics[from] );
+    ++m_stamps[from];
+    ++m_stamps[to];
+
+    std::vector< unsigned int >& toTriangles = m_positionTriangles[to];
+
+    for( unsigned int i = 0; i < m_positionTriangles[from].size(); ++i )
+    {
+        const unsigned int t = m_positionTriangles[from][i];
+
+        if( m_removed[t] )
+            continue;
+
+        unsigned int* tri = &m_triangles[t * 3];
+
+        if( tri[0] == to || tri[1] == to || tri[2] == to )
+        {
+            m_removed[t] = true;
+            --m_triangleCount;
+            continue;
+        }
+
+        for( int k = 0; k < 3; ++k )
+        {
+            if( tri[k] == from )
+                tri[k] = to;
+        }
+
+        toTriangles.push_back( t );
+    }
+
+    std::vector< unsigned int >().swap( m_positionTriangles[from] );
+
+    // the triangles left around the new position, and its new edges
+    std::vector< unsigned int > neighbours;
+    unsigned int alive = 0;
+
+    for( unsigned int i = 0; i < toTriangles.size(); ++i )
+    {
+        const unsigned int t = toTriangles[i];
+
+        if( m_removed[t] )
+            continue;
+
+        toTriangles[alive++] = t;
+
+        for( int k = 0; k < 3; ++k )
+        {
+            if( m_triangles[t * 3 + k] != to )
+                neighbours.push_back( m_triangles[t * 3 + k] );
+        }
+    }
+
+    toTriangles.resize( alive );
+
+    std::sort( neighbours.begin(), neighbours.end() );
+    neighbours.erase( std::unique( neighbours.begin(), neighbours.end() ), neighbours.end() );
+
+    for( unsigned int i = 0; i < neighbours.size(); ++i )
+        pushEdge( to, neighbours[i] );
+}
+
+
+void MESH_SIMPLIFIER::Simplify( unsigned int aTargetTriangles )
+{
+    while( m_triangleCount > aTargetTriangles && !m_heap.empty() )
+    {
+        const COLLAPSE collapse = m_heap.top();
+
+        m_heap.pop();
+
+        if( m_collapsed[collapse.m_from] || m_collapsed[collapse.m_to]
+            || collapse.m_fromStamp != m_stamps[collapse.m_from]
+            || collapse.m_toStamp != m_stamps[collapse.m_to] )
+            continue;
+
+        // the edge is pushed again when one of its ends changes
+        if( flips( collapse ) )
+            continue;
+
+        this->collapse( collapse );
+    }
+}
+
+
+void MESH_SIMPLIFIER::Output( SMESH& aMesh ) const
+{
+    std::vector< int > remap( m_mesh.m_VertexSize, -1 );
+    std::vector< unsigned int > vertices;       // the vertices kept
+    std::vector< unsigned int > positions;      // and their final welded position
+    std::vector< unsigned int > faces;
+
+    for( unsigned int t = 0; t < m_removed.size(); ++t )
+    {
+        if( m_removed[t] )
+            continue;
+
+        for( int k = 0; k < 3; ++k )
+        {
+            const unsigned int vertex = m_mesh.m_FaceIdx[t * 3 + k];
+
+            if( remap[vertex] < 0 )
+            {
+                remap[vertex] = vertices.size();
+                vertices.push_back( vertex );
+                positions.push_back( m_triangles[t * 3 + k] );
+            }
+
+            faces.push_back( remap[vertex] );
+        }
+    }
+
+    S3D::Init3DMesh( aMesh );
+
+    aMesh.m_MaterialIdx = m_mesh.m_MaterialIdx;
+
+    if( faces.empty() )
+        return;
+
+    aMesh.m_VertexSize = vertices.size();
+    aMesh.m_Positions = new SFVEC3F[vertices.size()];
+    aMesh.m_Normals = new SFVEC3F[vertices.size()];
+
+    if( m_mesh.m_Texcoords )
+        aMesh.m_Texcoords = new SFVEC2F[vertices.size()];
+
+    if( m_mesh.m_Color )
+        aMesh.m_Color = new SFVEC3F[vertices.size()];
+
+    for( unsigned int i = 0; i < vertices.size(); ++i )
+    {
+        // the vertices of a collapsed position keep their normal and color
+        aMesh.m_Positions[i] = m_positions[positions[i]];
+        aMesh.m_Normals[i] = m_mesh.m_Normals[vertices[i]];
+
+        if( m_mesh.m_Texcoords )
+            aMesh.m_Texcoords[i] = m_mesh.m_Texcoords[vertices[i]];
+
+        if( m_mesh.m_Color )
+            aMesh.m_Color[i] = m_mesh.m_Color[vertices[i]];
+    }
+
+    aMesh.m_FaceIdxSize = faces.size();
+    aMesh.m_FaceIdx = new unsigned int[faces.size()];
+    std::copy( faces.begin(), faces.end(), aMesh.m_FaceIdx );
+}
+
+}   // namespace
+
+
+unsigned int S3D::CountTriangles( const S3DMODEL& aModel )
+{
+    unsigned int count = 0;
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+        count += aModel.m_Meshes[i].m_FaceIdxSize / 3;
+
+    return count;
+}
+
+
+S3DMODEL* S3D::SimplifyModel( const S3DMODEL& aModel, float aRatio )
+{
+    S3DMODEL* model = S3D::New3DModel();
+
+    if( aModel.m_MaterialsSize > 0 )
+    {
+        model->m_MaterialsSize = aModel.m_MaterialsSize;
+        model->m_Materials = new SMATERIAL[aModel.m_MaterialsSize];
+        std::copy( aModel.m_Materials, aModel.m_Materials + aModel.m_MaterialsSize,
+                   model->m_Materials );
+    }
+
+    if( aModel.m_MeshesSize > 0 )
+    {
+        model->m_MeshesSize = aModel.m_MeshesSize;
+        model->m_Meshes = new SMESH[aModel.m_MeshesSize];
+    }
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+        const unsigned int nrTriangles = mesh.m_FaceIdxSize / 3;
+        MESH_SIMPLIFIER simplifier( mesh );
+
+        if( nrTriangles >= MIN_SIMPLIFIED_TRIANGLES )
+            simplifier.Simplify( std::max( (unsigned int)( nrTriangles * aRatio ),
+                                           (unsigned int) MIN_SIMPLIFIED_TRIANGLES / 4 ) );
+
+        simplifier.Output( model->m_Meshes[i] );
+    }
+
+    return model;
+}
@@ -0,0 +1,59 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_mesh_simplify.h
+ * defines the simplification of the render data of 3D models, for their levels of detail
+ */
+
+#ifndef MESH_SIMPLIFY_3D_H
+#define MESH_SIMPLIFY_3D_H
+
+#include "plugins/3dapi/c3dmodel.h"
+
+namespace S3D
+{
+    /**
+     * Function CountTriangles
+     * returns the number of triangles of all the meshes of @a aModel
+     */
+    unsigned int CountTriangles( const S3DMODEL& aModel );
+
+    /**
+     * Function SimplifyModel
+     * returns a copy of @a aModel with about @a aRatio of its triangles, removed by the
+     * edge collapses of the lowest quadric error, as in "Surface Simplification Using
+     * Quadric Error Metrics", M. Garland and P. Heckbert, 1997.
+     *
+     * The vertices of the same position are collapsed together, so the seams of the
+     * normals and colors of the mesh stay closed.  The open borders of the meshes are
+     * kept, and the collapses which would flip a triangle are skipped.
+     *
+     * @param aModel [in] is the model to simplify
+     * @param aRatio [in] is the ratio of the triangles to keep, between 0.0 and 1.0
+     * @return a new model, to be freed with S3D::Destroy3DModel()
+     */
+    S3DMODEL* SimplifyModel( const S3DMODEL& aModel, float aRatio );
+}
+
+#endif  // MESH_SIMPLIFY_3D_H
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <sstream>
 #include <wx/log.h>
+#include <wx/thread.h>
 
 #include "3d_cache/sg/sg_node.h"
 #include "plugins/3dapi/c3dmodel.h"
@@ -47,6 +48,9 @@ static const std::string node_names[S3D::SGTYPE_END + 1] = {
 
 static unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
 
+// the scene graphs of several models may be read on different threads
+static wxCriticalSection lock_node_counts;
+
 
 char const* S3D::GetNodeTypeName( S3D::SGTYPES aType )
 {
@@ -62,8 +66,14 @@ static void getNodeName( S3D::SGTYPES nodeType, std::string& aName )
         return;
     }
 
-    unsigned int seqNum = node_counts[nodeType];
-    ++node_counts[nodeType];
+    unsigned int seqNum;
+
+    {
+        wxCriticalSectionLocker lock( lock_node_counts );
+
+        seqNum = node_counts[nodeType];
+        ++node_counts[nodeType];
+    }
 
     std::ostringstream ostr;
     ostr << node_names[nodeType] << "_" << seqNum;
@@ -303,6 +313,8 @@ void SGNODE::DisassociateWrapper( SGNODE** aWrapperRef )
 
 void SGNODE::ResetNodeIndex( void )
 {
+    wxCriticalSectionLocker lock( lock_node_counts );
+
     for( int i = 0; i < (int)S3D::SGTYPE_END; ++i )
         node_counts[i] = 1;
 
@@ -54,6 +54,29 @@ static void CALLBACK    tessEndCB();
 static void CALLBACK    tessErrorCB( GLenum errorCode );
 static void CALLBACK    tessCPolyPt2Vertex( const GLvoid* data );
 
+// Draw the triangles cached by SHAPE_POLY_SET::CacheTriangulation(), like the tessellator
+static void drawTriangulatedPolygons( const SHAPE_POLY_SET& aPolysList )
+{
+    glBegin( GL_TRIANGLES );
+
+    for( unsigned ii = 0; ii < aPolysList.TriangulatedPolyCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* poly = aPolysList.TriangulatedPolygon( ii );
+        const std::vector<VECTOR2I>& vertices = poly->Vertices();
+
+        for( int jj = 0; jj < poly->GetTriangleCount(); jj++ )
+        {
+            const SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI& tri = poly->Triangles()[jj];
+
+            tessCPolyPt2Vertex( &vertices[tri.a] );
+            tessCPolyPt2Vertex( &vertices[tri.b] );
+            tessCPolyPt2Vertex( &vertices[tri.c] );
+        }
+    }
+
+    glEnd();
+}
+
 void TransfertToGLlist( std::vector< S3D_VERTEX >& aVertices, double aBiuTo3DUnits );
 
 /* Draw3D_VerticalPolygonalCylinder is a helper function.
@@ -184,10 +207,15 @@ void Draw3D_SolidHorizontalPolyPolygons( const SHAPE_POLY_SET& aPolysList,
     // Draw solid areas contained in this list
     SHAPE_POLY_SET polylist = aPolysList;    // temporary copy for gluTessVertex
 
+    // The areas triangulated once, e.g. the filled areas of the zones, are not tessellated
+    bool triangulated = polylist.IsTriangulationUpToDate();
+
     for( int side = 0; side < 2; side++ )
     {
+        if( triangulated )
+            drawTriangulatedPolygons( polylist );
 
-        for ( int idx = 0; idx < polylist.OutlineCount(); ++idx )
+        for( int idx = 0; !triangulated && idx < polylist.OutlineCount(); ++idx )
         {
             gluTessBeginPolygon( tess, NULL );
 
@@ -79,6 +79,20 @@ SHAPE_POLY_SET::POLYGON_MODE polygonsCalcMode = SHAPE_POLY_SET::PM_FAST;
  */
 GLfloat  Get3DLayer_Z_Orientation( LAYER_NUM aLayer );
 
+
+// The polygons of a copper layer, built for all the layers before they are merged
+struct COPPER_LAYER_POLYS
+{
+    LAYER_ID        m_layer;
+    SHAPE_POLY_SET  m_polys;        // copper areas: tracks, pads and filled zones areas
+                                    // when holes are removed from zones
+    SHAPE_POLY_SET  m_zonesPolys;   // copper filled zones outlines
+                                    // when holes are not removed from zones
+    SHAPE_POLY_SET  m_holes;        // holes of the layer
+    std::vector<const ZONE_CONTAINER*> m_zones;     // the zones, the filled areas
+                                                    // of which are triangulated
+};
+
 void EDA_3D_CANVAS::buildBoardThroughHolesPolygonList( SHAPE_POLY_SET& allBoardHoles,
                                                 int aSegCountPerCircle, bool aOptimizeLargeCircles )
 {
@@ -176,12 +190,7 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                                                 // a fine representation
     double          correctionFactorLQ  = 1.0 / cos( M_PI / (segcountLowQuality * 2.0) );
 
-    SHAPE_POLY_SET  bufferPolys;        // copper areas: tracks, pads and filled zones areas
-                                        // when holes are removed from zones
     SHAPE_POLY_SET  bufferPcbOutlines;  // stores the board main outlines
-    SHAPE_POLY_SET  bufferZonesPolys;   // copper filled zones areas
-                                        // when holes are not removed from zones
-    SHAPE_POLY_SET  currLayerHoles;     // Contains holes for the current layer
     SHAPE_POLY_SET  allLayerHoles;      // Contains holes for all layers
 
     // Build a polygon from edge cut items
@@ -203,24 +212,34 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
 
     LSET            cu_set = LSET::AllCuMask( GetPrm3DVisu().m_CopperLayersCount );
 
-    glNewList( aBoardList, GL_COMPILE );
+    // The polygons of all the layers are built first, then merged in parallel, and then
+    // drawn in the display list
+    std::vector<COPPER_LAYER_POLYS> copperLayers;
 
     for( LSEQ cu = cu_set.CuStack();  cu;  ++cu )
     {
-        LAYER_ID layer = *cu;
-
         // Skip non enabled layers in normal mode,
         // and internal layers in realistic mode
-        if( !is3DLayerEnabled( layer ) )
-            continue;
+        if( is3DLayerEnabled( *cu ) )
+        {
+            copperLayers.push_back( COPPER_LAYER_POLYS() );
+            copperLayers.back().m_layer = *cu;
+        }
+    }
+
+    SHAPE_POLY_SET::BOOLEAN_BATCH batch;
+
+    for( unsigned ll = 0; ll < copperLayers.size(); ll++ )
+    {
+        LAYER_ID layer = copperLayers[ll].m_layer;
+        SHAPE_POLY_SET& bufferPolys = copperLayers[ll].m_polys;
+        SHAPE_POLY_SET& bufferZonesPolys = copperLayers[ll].m_zonesPolys;
+        SHAPE_POLY_SET& currLayerHoles = copperLayers[ll].m_holes;
+        std::vector<const ZONE_CONTAINER*>& layerZones = copperLayers[ll].m_zones;
 
         if( aActivity )
             aActivity->Report( wxString::Format( _( "Build layer %s" ), LSET::Name( layer ) ) );
 
-        bufferPolys.RemoveAllContours();
-        bufferZonesPolys.RemoveAllContours();
-        currLayerHoles.RemoveAllContours();
-
         // Draw track shapes:
         for( TRACK* track = pcb->m_Track;  track;  track = track->Next() )
         {
@@ -274,7 +293,8 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
         // * if the holes are removed from copper zones
         // the polygons are stored in bufferPolys (which contains all other polygons)
         // * if the holes are NOT removed from copper zones
-        // the polygons are stored in bufferZonesPolys
+        // the outlines are stored in bufferZonesPolys, and the filled areas are
+        // drawn from their cached triangles
         if( isEnabled( FL_ZONE ) )
         {
             for( int ii = 0; ii < pcb->GetAreaCount(); ii++ )
@@ -282,11 +302,19 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                 ZONE_CONTAINER* zone = pcb->GetArea( ii );
                 LAYER_NUM       zonelayer = zone->GetLayer();
 
-                if( zonelayer == layer )
+                if( zonelayer != layer )
+                    continue;
+
+                if( remove_Holes )
                 {
                     zone->TransformSolidAreasShapesToPolygonSet(
-                        remove_Holes ? bufferPolys : bufferZonesPolys,
-                        segcountLowQuality, correctionFactorLQ );
+                        bufferPolys, segcountLowQuality, correctionFactorLQ );
+                }
+                else
+                {
+                    zone->TransformSolidAreasOutlinesToPolygonSet(
+                        bufferZonesPolys, segcountLowQuality, correctionFactorLQ );
+                    layerZones.push_back( zone );
                 }
             }
         }
@@ -320,14 +348,31 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
             continue;
 
         // Use Clipper lib to subtract holes to copper areas
+        batch.NewJob();
+
         if( currLayerHoles.OutlineCount() )
         {
             currLayerHoles.Append(allLayerHoles);
-            currLayerHoles.Simplify( polygonsCalcMode );
-            bufferPolys.BooleanSubtract( currLayerHoles, polygonsCalcMode );
+            batch.Simplify( currLayerHoles, polygonsCalcMode );
+            batch.Subtract( bufferPolys, currLayerHoles, polygonsCalcMode );
         }
         else
-            bufferPolys.BooleanSubtract( allLayerHoles, polygonsCalcMode );
+            batch.Subtract( bufferPolys, allLayerHoles, polygonsCalcMode );
+    }
+
+    batch.Run();
+
+    glNewList( aBoardList, GL_COMPILE );
+
+    for( unsigned ll = 0; ll < copperLayers.size(); ll++ )
+    {
+        LAYER_ID layer = copperLayers[ll].m_layer;
+        const SHAPE_POLY_SET& bufferPolys = copperLayers[ll].m_polys;
+        const SHAPE_POLY_SET& bufferZonesPolys = copperLayers[ll].m_zonesPolys;
+        const std::vector<const ZONE_CONTAINER*>& layerZones = copperLayers[ll].m_zones;
+
+        if( bufferPolys.IsEmpty() )
+            continue;
 
         int thickness = GetPrm3DVisu().GetLayerObjectThicknessBIU( layer );
         int zpos = GetPrm3DVisu().GetLayerZcoordBIU( layer );
@@ -363,6 +408,13 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                                     GetPrm3DVisu().m_BiuTo3Dunits, useTextures,
                                     zNormal );
         }
+
+        for( unsigned ii = 0; ii < layerZones.size(); ii++ )
+        {
+            Draw3D_SolidHorizontalPolyPolygons( layerZones[ii]->GetFilledPolysList(), zpos,
+                                    thickness, GetPrm3DVisu().m_BiuTo3Dunits, useTextures,
+                                    zNormal );
+        }
     }
 
     if( aActivity )
@@ -47,6 +47,21 @@
 #endif
 
 
+// The count of floats of the SIMD kernels of the raytracer: 8 with the AVX instructions,
+// 4 with SSE2, enabled by the GLM_ENABLE_SIMD_* build options, else the scalar kernels
+#if defined( GLM_FORCE_PURE )
+#define FASTMATH_SIMD_WIDTH 1
+#elif defined( __AVX__ )
+#include <immintrin.h>
+#define FASTMATH_SIMD_WIDTH 8
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+#include <emmintrin.h>
+#define FASTMATH_SIMD_WIDTH 4
+#else
+#define FASTMATH_SIMD_WIDTH 1
+#endif
+
+
 /**
  * This part contains some functions from the PBRT 3 source code.
  * https://github.com/mmp/pbrt-v3/blob/master/src/core/pbrt.h
@@ -43,6 +43,7 @@
 void C3D_RENDER_OGL_LEGACY::reload()
 {
     m_reloadRequested = false;
+    m_reloadLayers.reset();
 
     ogl_free_all_display_lists();
 
@@ -178,615 +179,634 @@ void C3D_RENDER_OGL_LEGACY::reload()
     }
 
 
-    float calc_sides_min_factor = (float)(   10.0 * IU_PER_MILS * m_settings.BiuTo3Dunits() );
-    float calc_sides_max_factor = (float)( 1000.0 * IU_PER_MILS * m_settings.BiuTo3Dunits() );
-
-
     // Add layers maps (except B_Mask and F_Mask)
     // /////////////////////////////////////////////////////////////////////////
     printf("Add layers maps...\n");
     for( MAP_CONTAINER_2D::const_iterator ii = m_settings.GetMapLayers().begin();
          ii != m_settings.GetMapLayers().end();
          ii++ )
+        generate_layer( static_cast<LAYER_ID>(ii->first) );
+}
+
+
+void C3D_RENDER_OGL_LEGACY::reload_layers()
+{
+    for( int i = 0; i < LAYER_ID_COUNT; ++i )
     {
-        LAYER_ID layer_id = static_cast<LAYER_ID>(ii->first);
+        LAYER_ID layer_id = static_cast<LAYER_ID>( i );
 
-        if( !m_settings.Is3DLayerEnabled( layer_id ) )
+        if( !m_reloadLayers[layer_id] )
             continue;
 
-        const CBVHCONTAINER2D *container2d = static_cast<const CBVHCONTAINER2D *>(ii->second);
-        const LIST_OBJECT2D listObject2d = container2d->GetList();
+        ogl_free_layer( layer_id );
+        generate_layer( layer_id );
+    }
 
-        if( listObject2d.size() == 0 )
-            continue;
+    m_reloadLayers.reset();
+}
 
-        //CMATERIAL *materialLayer = &m_materials.m_SilkS;
-        SFVEC3F layerColor = SFVEC3F( 0.3f, 0.4f, 0.5f );
 
-        float layer_z_bot = m_settings.GetLayerBottomZpos3DU( layer_id );
-        float layer_z_top = m_settings.GetLayerTopZpos3DU( layer_id );
+void C3D_RENDER_OGL_LEGACY::generate_layer( LAYER_ID layer_id )
+{
+    MAP_CONTAINER_2D::const_iterator ii = m_settings.GetMapLayers().find( layer_id );
 
-        if( layer_z_top < layer_z_bot )
-        {
-            float tmpFloat = layer_z_bot;
-            layer_z_bot = layer_z_top;
-            layer_z_top = tmpFloat;
-        }
+    if( ii == m_settings.GetMapLayers().end() || !m_settings.Is3DLayerEnabled( layer_id ) )
+        return;
+
+    const CBVHCONTAINER2D *container2d = static_cast<const CBVHCONTAINER2D *>(ii->second);
+    const LIST_OBJECT2D listObject2d = container2d->GetList();
+
+    if( listObject2d.size() == 0 )
+        return;
+
+    float calc_sides_min_factor = (float)(   10.0 * IU_PER_MILS * m_settings.BiuTo3Dunits() );
+    float calc_sides_max_factor = (float)( 1000.0 * IU_PER_MILS * m_settings.BiuTo3Dunits() );
+
+    //CMATERIAL *materialLayer = &m_materials.m_SilkS;
+    SFVEC3F layerColor = SFVEC3F( 0.3f, 0.4f, 0.5f );
 
-        layer_z_bot -= m_settings.GetNonCopperLayerThickness3DU();
-        layer_z_top += m_settings.GetNonCopperLayerThickness3DU();
+    float layer_z_bot = m_settings.GetLayerBottomZpos3DU( layer_id );
+    float layer_z_top = m_settings.GetLayerTopZpos3DU( layer_id );
 
-        if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
+    if( layer_z_top < layer_z_bot )
+    {
+        float tmpFloat = layer_z_bot;
+        layer_z_bot = layer_z_top;
+        layer_z_top = tmpFloat;
+    }
+
+    layer_z_bot -= m_settings.GetNonCopperLayerThickness3DU();
+    layer_z_top += m_settings.GetNonCopperLayerThickness3DU();
+
+    if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
+    {
+        switch( layer_id )
         {
-            switch( layer_id )
-            {
-                case B_Adhes:
-                case F_Adhes:
+            case B_Adhes:
+            case F_Adhes:
 
-                break;
+            break;
 
-                case B_Paste:
-                case F_Paste:
-    //                materialLayer = &m_materials.m_Paste;
-                break;
+            case B_Paste:
+            case F_Paste:
+//                materialLayer = &m_materials.m_Paste;
+            break;
 
-                case B_SilkS:
-                case F_SilkS:
+            case B_SilkS:
+            case F_SilkS:
 
-    //                materialLayer = &m_materials.m_SilkS;
-    //                layerColor = g_silkscreenColor;
-                break;
+//                materialLayer = &m_materials.m_SilkS;
+//                layerColor = g_silkscreenColor;
+            break;
 
-                case Dwgs_User:
-                case Cmts_User:
-                case Eco1_User:
-                case Eco2_User:
-                case Edge_Cuts:
-                case Margin:
-                break;
+            case Dwgs_User:
+            case Cmts_User:
+            case Eco1_User:
+            case Eco2_User:
+            case Edge_Cuts:
+            case Margin:
+            break;
 
-                case B_CrtYd:
-                case F_CrtYd:
-                break;
+            case B_CrtYd:
+            case F_CrtYd:
+            break;
 
-                case B_Fab:
-                case F_Fab:
-                break;
+            case B_Fab:
+            case F_Fab:
+            break;
 
-                default:
-                    //materialLayer = &m_materials.m_Copper;
+            default:
+                //materialLayer = &m_materials.m_Copper;
 
-                        //layerColor = g_copperColor;
+                    //layerColor = g_copperColor;
 
 
-                break;
-            }
+            break;
         }
-        else
-        {
-            layerColor = m_settings.GetLayerColor( layer_id );
+    }
+    else
+    {
+        layerColor = m_settings.GetLayerColor( layer_id );
 
-        }
+    }
 
 
-        // Calculate an estiation for then nr of triangles based on the nr of objects
-        unsigned int nrTrianglesEstimation = listObject2d.size() * 8;
+    // Calculate an estiation for then nr of triangles based on the nr of objects
+    unsigned int nrTrianglesEstimation = listObject2d.size() * 8;
 
-        CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( nrTrianglesEstimation );
+    CLAYER_TRIANGLES *layerTriangles = new CLAYER_TRIANGLES( nrTrianglesEstimation );
 
-        m_triangles[layer_id] = layerTriangles;
+    m_triangles[layer_id] = layerTriangles;
 
-        for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
-             itemOnLayer != listObject2d.end();
-             itemOnLayer++ )
+    for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
+         itemOnLayer != listObject2d.end();
+         itemOnLayer++ )
+    {
+        const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
+
+        switch( object2d_A->GetObjectType() )
         {
-            const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
 
-            switch( object2d_A->GetObjectType() )
+            case OBJ2D_FILLED_CIRCLE:
             {
+                const CFILLEDCIRCLE2D *filledCircle = (const CFILLEDCIRCLE2D *)object2d_A;
+                const SFVEC2F &center = filledCircle->GetCenter();
+                float radius = filledCircle->GetRadius() * 2.0f;            // Double because the render triangle
+                float radiusSquared = radius * radius;
 
-                case OBJ2D_FILLED_CIRCLE:
-                {
-                    const CFILLEDCIRCLE2D *filledCircle = (const CFILLEDCIRCLE2D *)object2d_A;
-                    const SFVEC2F &center = filledCircle->GetCenter();
-                    float radius = filledCircle->GetRadius() * 2.0f;            // Double because the render triangle
-                    float radiusSquared = radius * radius;
+                const float f = (sqrtf(2.0f) / 2.0f) * radius * 0.9;// * texture_factor;
 
-                    const float f = (sqrtf(2.0f) / 2.0f) * radius * 0.9;// * texture_factor;
+                layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( center.x + f, center.y, layer_z_top ),
+                                                                       SFVEC3F( center.x - f, center.y, layer_z_top ),
+                                                                       SFVEC3F( center.x,
+                                                                                center.y - f, layer_z_top ) );
 
-                    layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( center.x + f, center.y, layer_z_top ),
-                                                                           SFVEC3F( center.x - f, center.y, layer_z_top ),
-                                                                           SFVEC3F( center.x,
-                                                                                    center.y - f, layer_z_top ) );
+                layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( center.x - f, center.y, layer_z_top ),
+                                                                       SFVEC3F( center.x + f, center.y, layer_z_top ),
+                                                                       SFVEC3F( center.x,
+                                                                                center.y + f, layer_z_top ) );
 
-                    layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( center.x - f, center.y, layer_z_top ),
-                                                                           SFVEC3F( center.x + f, center.y, layer_z_top ),
-                                                                           SFVEC3F( center.x,
-                                                                                    center.y + f, layer_z_top ) );
+                layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( center.x - f, center.y, layer_z_bot ),
+                                                                       SFVEC3F( center.x + f, center.y, layer_z_bot ),
+                                                                       SFVEC3F( center.x,
+                                                                                center.y - f, layer_z_bot ) );
 
-                    layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( center.x - f, center.y, layer_z_bot ),
-                                                                           SFVEC3F( center.x + f, center.y, layer_z_bot ),
-                                                                           SFVEC3F( center.x,
-                                                                                    center.y - f, layer_z_bot ) );
+                layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( center.x + f, center.y, layer_z_bot ),
+                                                                       SFVEC3F( center.x - f, center.y, layer_z_bot ),
+                                                                       SFVEC3F( center.x,
+                                                                                center.y + f, layer_z_bot ) );
 
-                    layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( center.x + f, center.y, layer_z_bot ),
-                                                                           SFVEC3F( center.x - f, center.y, layer_z_bot ),
-                                                                           SFVEC3F( center.x,
-                                                                                    center.y + f, layer_z_bot ) );
+                unsigned int nr_sides_per_circle = (unsigned int)mapf( radiusSquared,
+                                                                       calc_sides_min_factor, calc_sides_max_factor,
+                                                                       24.0f, 256.0f );
 
-                    unsigned int nr_sides_per_circle = (unsigned int)mapf( radiusSquared,
-                                                                           calc_sides_min_factor, calc_sides_max_factor,
-                                                                           24.0f, 256.0f );
+                wxASSERT( nr_sides_per_circle >= 24 );
 
-                    wxASSERT( nr_sides_per_circle >= 24 );
+                // Normal radius for the circle
+                radius = filledCircle->GetRadius();
 
-                    // Normal radius for the circle
-                    radius = filledCircle->GetRadius();
+                std::vector< SFVEC2F > contournPoints;
 
-                    std::vector< SFVEC2F > contournPoints;
+                contournPoints.clear();
+                contournPoints.reserve( nr_sides_per_circle + 2 );
+                int    delta       = 3600 / nr_sides_per_circle;
+                int ii;
+                for( ii = 0; ii < 3600; ii += delta )
+                {
+                    const SFVEC2F rotatedDir = glm::rotate( SFVEC2F( 0.0f, 1.0f ),  (float)ii  * 2.0f * 3.14f / 3600.0f );
+                    contournPoints.push_back(   SFVEC2F( center.x - rotatedDir.y * radius, center.y + rotatedDir.x * radius ) );
+                }
+                contournPoints.push_back( contournPoints[0] );
 
-                    contournPoints.clear();
-                    contournPoints.reserve( nr_sides_per_circle + 2 );
-                    int    delta       = 3600 / nr_sides_per_circle;
-                    int ii;
-                    for( ii = 0; ii < 3600; ii += delta )
+                if( contournPoints.size() > 1 )
+                {
+                    for( unsigned int i = 0; i < ( contournPoints.size() - 1 ); ++i )
                     {
-                        const SFVEC2F rotatedDir = glm::rotate( SFVEC2F( 0.0f, 1.0f ),  (float)ii  * 2.0f * 3.14f / 3600.0f );
-                        contournPoints.push_back(   SFVEC2F( center.x - rotatedDir.y * radius, center.y + rotatedDir.x * radius ) );
-                    }
-                    contournPoints.push_back( contournPoints[0] );
+                        const SFVEC2F &v0 = contournPoints[i + 0];
+                        const SFVEC2F &v1 = contournPoints[i + 1];
 
-                    if( contournPoints.size() > 1 )
-                    {
-                        for( unsigned int i = 0; i < ( contournPoints.size() - 1 ); ++i )
-                        {
-                            const SFVEC2F &v0 = contournPoints[i + 0];
-                            const SFVEC2F &v1 = contournPoints[i + 1];
-
-                            layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, NextFloatUp( layer_z_bot ) ),
-                                                                                     SFVEC3F( v1.x, v1.y, NextFloatUp( layer_z_bot ) ),
-                                                                                     SFVEC3F( v1.x, v1.y, NextFloatDown( layer_z_top ) ),
-                                                                                     SFVEC3F( v0.x, v0.y, NextFloatDown( layer_z_top ) ) );
-
-
-                            const SFVEC2F n0 = glm::normalize( v0 - center );
-                            const SFVEC2F n1 = glm::normalize( v1 - center );
-                            const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
-                            const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
-                            layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
-                        }
-                    }
-                    contournPoints.clear();
+                        layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, NextFloatUp( layer_z_bot ) ),
+                                                                                 SFVEC3F( v1.x, v1.y, NextFloatUp( layer_z_bot ) ),
+                                                                                 SFVEC3F( v1.x, v1.y, NextFloatDown( layer_z_top ) ),
+                                                                                 SFVEC3F( v0.x, v0.y, NextFloatDown( layer_z_top ) ) );
 
-                }
-                break;
 
-                case OBJ2D_DUMMYBLOCK:
-                {
+                        const SFVEC2F n0 = glm::normalize( v0 - center );
+                        const SFVEC2F n1 = glm::normalize( v1 - center );
+                        const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
+                        const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
+                        layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
+                    }
                 }
-                break;
+                contournPoints.clear();
 
-                case OBJ2D_POLYGON4PT:
-                {
-                    const CPOLYGON4PTS2D *poly = (const CPOLYGON4PTS2D *)object2d_A;
-                    const SFVEC2F &v0 = poly->GetV0();
-                    const SFVEC2F &v1 = poly->GetV1();
-                    const SFVEC2F &v2 = poly->GetV2();
-                    const SFVEC2F &v3 = poly->GetV3();
-
-                    add_triangle_top_bot( layerTriangles, v0, v2, v1, layer_z_top, layer_z_bot );
-                    add_triangle_top_bot( layerTriangles, v2, v0, v3, layer_z_top, layer_z_bot );
-
-                    const SFVEC2F &n0 = poly->GetN0();
-                    const SFVEC2F &n1 = poly->GetN1();
-                    const SFVEC2F &n2 = poly->GetN2();
-                    const SFVEC2F &n3 = poly->GetN3();
-
-                    const SFVEC3F n3d0 = SFVEC3F(-n0.y, n0.x, 0.0f );
-                    const SFVEC3F n3d1 = SFVEC3F(-n1.y, n1.x, 0.0f );
-                    const SFVEC3F n3d2 = SFVEC3F(-n2.y, n2.x, 0.0f );
-                    const SFVEC3F n3d3 = SFVEC3F(-n3.y, n3.x, 0.0f );
-
-                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_bot ),
-                                                                             SFVEC3F( v1.x, v1.y, layer_z_bot ),
-                                                                             SFVEC3F( v1.x, v1.y, layer_z_top ),
-                                                                             SFVEC3F( v0.x, v0.y, layer_z_top ) );
-                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d0, n3d0, n3d0, n3d0 );
-
-
-                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v2.x, v2.y, layer_z_top ),
-                                                                             SFVEC3F( v1.x, v1.y, layer_z_top ),
-                                                                             SFVEC3F( v1.x, v1.y, layer_z_bot ),
-                                                                             SFVEC3F( v2.x, v2.y, layer_z_bot ) );
-                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d1, n3d1, n3d1, n3d1 );
-
-
-                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v3.x, v3.y, layer_z_top ),
-                                                                             SFVEC3F( v2.x, v2.y, layer_z_top ),
-                                                                             SFVEC3F( v2.x, v2.y, layer_z_bot ),
-                                                                             SFVEC3F( v3.x, v3.y, layer_z_bot ) );
-                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d2, n3d2, n3d2, n3d2 );
-
-
-                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_top ),
-                                                                             SFVEC3F( v3.x, v3.y, layer_z_top ),
-                                                                             SFVEC3F( v3.x, v3.y, layer_z_bot ),
-                                                                             SFVEC3F( v0.x, v0.y, layer_z_bot ) );
-                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d3, n3d3, n3d3, n3d3 );
-                }
-                break;
+            }
+            break;
 
+            case OBJ2D_DUMMYBLOCK:
+            {
+            }
+            break;
 
-                case OBJ2D_RING:
-                {
-                    const CRING2D *ring = (const CRING2D *)object2d_A;
-                    const SFVEC2F &center = ring->GetCenter();
-                    float inner = ring->GetInnerRadius();
-                    float outer = ring->GetOuterRadius();
+            case OBJ2D_POLYGON4PT:
+            {
+                const CPOLYGON4PTS2D *poly = (const CPOLYGON4PTS2D *)object2d_A;
+                const SFVEC2F &v0 = poly->GetV0();
+                const SFVEC2F &v1 = poly->GetV1();
+                const SFVEC2F &v2 = poly->GetV2();
+                const SFVEC2F &v3 = poly->GetV3();
+
+                add_triangle_top_bot( layerTriangles, v0, v2, v1, layer_z_top, layer_z_bot );
+                add_triangle_top_bot( layerTriangles, v2, v0, v3, layer_z_top, layer_z_bot );
+
+                const SFVEC2F &n0 = poly->GetN0();
+                const SFVEC2F &n1 = poly->GetN1();
+                const SFVEC2F &n2 = poly->GetN2();
+                const SFVEC2F &n3 = poly->GetN3();
+
+                const SFVEC3F n3d0 = SFVEC3F(-n0.y, n0.x, 0.0f );
+                const SFVEC3F n3d1 = SFVEC3F(-n1.y, n1.x, 0.0f );
+                const SFVEC3F n3d2 = SFVEC3F(-n2.y, n2.x, 0.0f );
+                const SFVEC3F n3d3 = SFVEC3F(-n3.y, n3.x, 0.0f );
+
+                layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_bot ),
+                                                                         SFVEC3F( v1.x, v1.y, layer_z_bot ),
+                                                                         SFVEC3F( v1.x, v1.y, layer_z_top ),
+                                                                         SFVEC3F( v0.x, v0.y, layer_z_top ) );
+                layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d0, n3d0, n3d0, n3d0 );
+
+
+                layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v2.x, v2.y, layer_z_top ),
+                                                                         SFVEC3F( v1.x, v1.y, layer_z_top ),
+                                                                         SFVEC3F( v1.x, v1.y, layer_z_bot ),
+                                                                         SFVEC3F( v2.x, v2.y, layer_z_bot ) );
+                layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d1, n3d1, n3d1, n3d1 );
+
+
+                layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v3.x, v3.y, layer_z_top ),
+                                                                         SFVEC3F( v2.x, v2.y, layer_z_top ),
+                                                                         SFVEC3F( v2.x, v2.y, layer_z_bot ),
+                                                                         SFVEC3F( v3.x, v3.y, layer_z_bot ) );
+                layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d2, n3d2, n3d2, n3d2 );
+
+
+                layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_top ),
+                                                                         SFVEC3F( v3.x, v3.y, layer_z_top ),
+                                                                         SFVEC3F( v3.x, v3.y, layer_z_bot ),
+                                                                         SFVEC3F( v0.x, v0.y, layer_z_bot ) );
+                layerTriangles->m_layer_middle_contourns_quads->AddNormal( n3d3, n3d3, n3d3, n3d3 );
+            }
+            break;
 
-                    unsigned int nr_sides_per_circle = (unsigned int)mapf( outer,
-                                                                           calc_sides_min_factor, calc_sides_max_factor,
-                                                                           24.0f, 256.0f );
 
-                    wxASSERT( nr_sides_per_circle >= 24 );
+            case OBJ2D_RING:
+            {
+                const CRING2D *ring = (const CRING2D *)object2d_A;
+                const SFVEC2F &center = ring->GetCenter();
+                float inner = ring->GetInnerRadius();
+                float outer = ring->GetOuterRadius();
 
+                unsigned int nr_sides_per_circle = (unsigned int)mapf( outer,
+                                                                       calc_sides_min_factor, calc_sides_max_factor,
+                                                                       24.0f, 256.0f );
 
-                    std::vector< SFVEC2F > innerContour;
-                    std::vector< SFVEC2F > outerContour;
-                    innerContour.clear();
-                    innerContour.reserve( nr_sides_per_circle + 2 );
+                wxASSERT( nr_sides_per_circle >= 24 );
 
-                    outerContour.clear();
-                    outerContour.reserve( nr_sides_per_circle + 2 );
 
-                    int    delta       = 3600 / nr_sides_per_circle;
-                    for( int ii = 0; ii < 3600; ii += delta )
-                    {
-                        const SFVEC2F rotatedDir = glm::rotate( SFVEC2F( 0.0f, 1.0f),  (float)        ii  * 2.0f * 3.14f / 3600.0f );
+                std::vector< SFVEC2F > innerContour;
+                std::vector< SFVEC2F > outerContour;
+                innerContour.clear();
+                innerContour.reserve( nr_sides_per_circle + 2 );
 
-                        innerContour.push_back( SFVEC2F( center.x - rotatedDir.y * inner, center.y + rotatedDir.x * inner ) );
-                        outerContour.push_back( SFVEC2F( center.x - rotatedDir.y * outer, center.y + rotatedDir.x * outer ) );
-                    }
+                outerContour.clear();
+                outerContour.reserve( nr_sides_per_circle + 2 );
 
-                    innerContour.push_back( innerContour[0] );
-                    outerContour.push_back( outerContour[0] );
+                int    delta       = 3600 / nr_sides_per_circle;
+                for( int ii = 0; ii < 3600; ii += delta )
+                {
+                    const SFVEC2F rotatedDir = glm::rotate( SFVEC2F( 0.0f, 1.0f),  (float)        ii  * 2.0f * 3.14f / 3600.0f );
 
-                    wxASSERT( innerContour.size() == outerContour.size() );
+                    innerContour.push_back( SFVEC2F( center.x - rotatedDir.y * inner, center.y + rotatedDir.x * inner ) );
+                    outerContour.push_back( SFVEC2F( center.x - rotatedDir.y * outer, center.y + rotatedDir.x * outer ) );
+                }
 
-                    for( unsigned int i = 0; i < ( innerContour.size() - 1 ); ++i )
-                    {
-                        const SFVEC2F &vi0 = innerContour[i + 0];
-                        const SFVEC2F &vi1 = innerContour[i + 1];
-                        const SFVEC2F &vo0 = outerContour[i + 0];
-                        const SFVEC2F &vo1 = outerContour[i + 1];
-
-                        layerTriangles->m_layer_top_triangles->AddQuad( SFVEC3F( vi1.x, vi1.y, layer_z_top ),
-                                                                        SFVEC3F( vi0.x, vi0.y, layer_z_top ),
-                                                                        SFVEC3F( vo0.x, vo0.y, layer_z_top ),
-                                                                        SFVEC3F( vo1.x, vo1.y, layer_z_top ) );
-
-                        layerTriangles->m_layer_bot_triangles->AddQuad( SFVEC3F( vi1.x, vi1.y, layer_z_bot ),
-                                                                        SFVEC3F( vo1.x, vo1.y, layer_z_bot ),
-                                                                        SFVEC3F( vo0.x, vo0.y, layer_z_bot ),
-                                                                        SFVEC3F( vi0.x, vi0.y, layer_z_bot ) );
-                    }
+                innerContour.push_back( innerContour[0] );
+                outerContour.push_back( outerContour[0] );
 
-                    for( unsigned int i = 0; i < ( innerContour.size() - 1 ); ++i )
-                    {
-                        const SFVEC2F &v0 = innerContour[i + 0];
-                        const SFVEC2F &v1 = innerContour[i + 1];
+                wxASSERT( innerContour.size() == outerContour.size() );
 
-                        layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v1.x, v1.y, NextFloatUp( layer_z_bot ) ),
-                                                                                 SFVEC3F( v0.x, v0.y, NextFloatUp( layer_z_bot ) ),
-                                                                                 SFVEC3F( v0.x, v0.y, NextFloatDown( layer_z_top ) ),
-                                                                                 SFVEC3F( v1.x, v1.y, NextFloatDown( layer_z_top ) ) );
+                for( unsigned int i = 0; i < ( innerContour.size() - 1 ); ++i )
+                {
+                    const SFVEC2F &vi0 = innerContour[i + 0];
+                    const SFVEC2F &vi1 = innerContour[i + 1];
+                    const SFVEC2F &vo0 = outerContour[i + 0];
+                    const SFVEC2F &vo1 = outerContour[i + 1];
+
+                    layerTriangles->m_layer_top_triangles->AddQuad( SFVEC3F( vi1.x, vi1.y, layer_z_top ),
+                                                                    SFVEC3F( vi0.x, vi0.y, layer_z_top ),
+                                                                    SFVEC3F( vo0.x, vo0.y, layer_z_top ),
+                                                                    SFVEC3F( vo1.x, vo1.y, layer_z_top ) );
+
+                    layerTriangles->m_layer_bot_triangles->AddQuad( SFVEC3F( vi1.x, vi1.y, layer_z_bot ),
+                                                                    SFVEC3F( vo1.x, vo1.y, layer_z_bot ),
+                                                                    SFVEC3F( vo0.x, vo0.y, layer_z_bot ),
+                                                                    SFVEC3F( vi0.x, vi0.y, layer_z_bot ) );
+                }
 
+                for( unsigned int i = 0; i < ( innerContour.size() - 1 ); ++i )
+                {
+                    const SFVEC2F &v0 = innerContour[i + 0];
+                    const SFVEC2F &v1 = innerContour[i + 1];
 
-                        const SFVEC2F n0 = glm::normalize( v0 - center );
-                        const SFVEC2F n1 = glm::normalize( v1 - center );
-                        const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
-                        const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
-                        layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
-                    }
+                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v1.x, v1.y, NextFloatUp( layer_z_bot ) ),
+                                                                             SFVEC3F( v0.x, v0.y, NextFloatUp( layer_z_bot ) ),
+                                                                             SFVEC3F( v0.x, v0.y, NextFloatDown( layer_z_top ) ),
+                                                                             SFVEC3F( v1.x, v1.y, NextFloatDown( layer_z_top ) ) );
 
 
-                    for( unsigned int i = 0; i < ( outerContour.size() - 1 ); ++i )
-                    {
-                        const SFVEC2F &v0 = outerContour[i + 0];
-                        const SFVEC2F &v1 = outerContour[i + 1];
+                    const SFVEC2F n0 = glm::normalize( v0 - center );
+                    const SFVEC2F n1 = glm::normalize( v1 - center );
+                    const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
+                    const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
+                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
+                }
 
-                        layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, NextFloatUp( layer_z_bot ) ),
-                                                                                 SFVEC3F( v1.x, v1.y, NextFloatUp( layer_z_bot ) ),
-                                                                                 SFVEC3F( v1.x, v1.y, NextFloatDown( layer_z_top ) ),
-                                                                                 SFVEC3F( v0.x, v0.y, NextFloatDown( layer_z_top ) ) );
 
+                for( unsigned int i = 0; i < ( outerContour.size() - 1 ); ++i )
+                {
+                    const SFVEC2F &v0 = outerContour[i + 0];
+                    const SFVEC2F &v1 = outerContour[i + 1];
 
-                        const SFVEC2F n0 = glm::normalize( v0 - center );
-                        const SFVEC2F n1 = glm::normalize( v1 - center );
-                        const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
-                        const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
-                        layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
-                    }
+                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, NextFloatUp( layer_z_bot ) ),
+                                                                             SFVEC3F( v1.x, v1.y, NextFloatUp( layer_z_bot ) ),
+                                                                             SFVEC3F( v1.x, v1.y, NextFloatDown( layer_z_top ) ),
+                                                                             SFVEC3F( v0.x, v0.y, NextFloatDown( layer_z_top ) ) );
 
+
+                    const SFVEC2F n0 = glm::normalize( v0 - center );
+                    const SFVEC2F n1 = glm::normalize( v1 - center );
+                    const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
+                    const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
+                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
                 }
-                break;
 
+            }
+            break;
 
-                case OBJ2D_TRIANGLE:
-                {
-                    const CTRIANGLE2D *tri = (const CTRIANGLE2D *)object2d_A;
-                    const SFVEC2F &v1 = tri->GetP1();
-                    const SFVEC2F &v2 = tri->GetP2();
-                    const SFVEC2F &v3 = tri->GetP3();
 
-                    add_triangle_top_bot( layerTriangles, v1, v2, v3, layer_z_top, layer_z_bot );
+            case OBJ2D_TRIANGLE:
+            {
+                const CTRIANGLE2D *tri = (const CTRIANGLE2D *)object2d_A;
+                const SFVEC2F &v1 = tri->GetP1();
+                const SFVEC2F &v2 = tri->GetP2();
+                const SFVEC2F &v3 = tri->GetP3();
+
+                add_triangle_top_bot( layerTriangles, v1, v2, v3, layer_z_top, layer_z_bot );
+            }
+            break;
+
+            case OBJ2D_ROUNDSEG:
+            {
+                const CROUNDSEGMENT2D &roundSeg = (const CROUNDSEGMENT2D &) *object2d_A;
+                unsigned int nr_sides_per_circle = (unsigned int)mapf( roundSeg.GetWidth(),
+                                                                       calc_sides_min_factor, calc_sides_max_factor,
+                                                                       24.0f, 256.0f );
+
+                wxASSERT( nr_sides_per_circle >= 24 );
+
+                SFVEC2F leftStart   = roundSeg.GetLeftStar();
+                SFVEC2F leftEnd     = roundSeg.GetLeftEnd();
+                SFVEC2F leftDir     = roundSeg.GetLeftDir();
+
+                SFVEC2F rightStart  = roundSeg.GetRightStar();
+                SFVEC2F rightEnd    = roundSeg.GetRightEnd();
+                SFVEC2F rightDir    = roundSeg.GetRightDir();
+                float   radius      = roundSeg.GetRadius();
+
+                SFVEC2F start       = roundSeg.GetStart();
+                SFVEC2F end         = roundSeg.GetEnd();
+
+                float texture_factor = (12.0f/(float)SIZE_OF_CIRCLE_TEXTURE) + 1.0f;
+                float texture_factorF= ( 4.0f/(float)SIZE_OF_CIRCLE_TEXTURE) + 1.0f;
+
+                const float radius_of_the_square = sqrtf( roundSeg.GetRadiusSquared() * 2.0f );
+                const float radius_triangle_factor = (radius_of_the_square - radius) / radius;
+
+                const SFVEC2F factorS = SFVEC2F( -rightDir.y * radius * radius_triangle_factor, rightDir.x * radius * radius_triangle_factor );
+                const SFVEC2F factorE = SFVEC2F( -leftDir.y  * radius * radius_triangle_factor, leftDir.x  * radius * radius_triangle_factor );
+
+                // Top end segment triangles
+                layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( rightEnd.x   + texture_factor * factorS.x, rightEnd.y  + texture_factor * factorS.y, layer_z_top ),
+                                                                       SFVEC3F( leftStart.x  + texture_factor * factorE.x, leftStart.y + texture_factor * factorE.y, layer_z_top ),
+                                                                       SFVEC3F( start.x - texture_factorF * leftDir.x * radius * sqrtf(2.0f),
+                                                                                start.y - texture_factorF * leftDir.y * radius * sqrtf(2.0f), layer_z_top ) );
+
+                layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( leftEnd.x    + texture_factor * factorE.x, leftEnd.y    + texture_factor * factorE.y, layer_z_top ),
+                                                                       SFVEC3F( rightStart.x + texture_factor * factorS.x, rightStart.y + texture_factor * factorS.y, layer_z_top ),
+                                                                       SFVEC3F( end.x - texture_factorF * rightDir.x * radius * sqrtf(2.0f),
+                                                                                end.y - texture_factorF * rightDir.y * radius * sqrtf(2.0f), layer_z_top ) );
+
+                // Bot end segment triangles
+                layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( leftStart.x  + texture_factor * factorE.x, leftStart.y + texture_factor * factorE.y, layer_z_bot ),
+                                                                       SFVEC3F( rightEnd.x   + texture_factor * factorS.x, rightEnd.y  + texture_factor * factorS.y, layer_z_bot ),
+                                                                       SFVEC3F( start.x - texture_factorF * leftDir.x * radius * sqrtf(2.0f),
+                                                                                start.y - texture_factorF * leftDir.y * radius * sqrtf(2.0f), layer_z_bot ) );
+
+                layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( rightStart.x + texture_factor * factorS.x, rightStart.y + texture_factor * factorS.y, layer_z_bot ),
+                                                                       SFVEC3F( leftEnd.x    + texture_factor * factorE.x, leftEnd.y    + texture_factor * factorE.y, layer_z_bot ),
+                                                                       SFVEC3F( end.x - texture_factorF * rightDir.x * radius * sqrtf(2.0f),
+                                                                                end.y - texture_factorF * rightDir.y * radius * sqrtf(2.0f), layer_z_bot ) );
+
+                // Segment top and bot planes
+                layerTriangles->m_layer_top_triangles->AddQuad( SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_top ),
+                                                                SFVEC3F( rightStart.x, rightStart.y, layer_z_top ),
+                                                                SFVEC3F( leftEnd.x,    leftEnd.y,    layer_z_top ),
+                                                                SFVEC3F( leftStart.x,  leftStart.y,  layer_z_top ) );
+
+                layerTriangles->m_layer_bot_triangles->AddQuad( SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_bot ),
+                                                                SFVEC3F( leftStart.x,  leftStart.y,  layer_z_bot ),
+                                                                SFVEC3F( leftEnd.x,    leftEnd.y,    layer_z_bot ),
+                                                                SFVEC3F( rightStart.x, rightStart.y, layer_z_bot ) );
+
+                // Middle contourns (two sides of the segment)
+                layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( leftStart.x, leftStart.y, layer_z_top ),
+                                                                         SFVEC3F( leftEnd.x,   leftEnd.y,   layer_z_top ),
+                                                                         SFVEC3F( leftEnd.x,   leftEnd.y,   layer_z_bot ),
+                                                                         SFVEC3F( leftStart.x, leftStart.y, layer_z_bot ) );
+                const SFVEC3F leftNormal = SFVEC3F( -leftDir.y, leftDir.x, 0.0f );
+                layerTriangles->m_layer_middle_contourns_quads->AddNormal( leftNormal, leftNormal, leftNormal, leftNormal );
+
+
+                layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( rightStart.x, rightStart.y, layer_z_top ),
+                                                                         SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_top ),
+                                                                         SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_bot ),
+                                                                         SFVEC3F( rightStart.x, rightStart.y, layer_z_bot ) );
+                const SFVEC3F rightNormal = SFVEC3F( -rightDir.y, rightDir.x, 0.0f );
+                layerTriangles->m_layer_middle_contourns_quads->AddNormal( rightNormal, rightNormal, rightNormal, rightNormal );
+
+
+                // Compute the outlines of the segment, and creates a polygon
+                // add right rounded end:
+
+                std::vector< SFVEC2F > roundedEndPointsStart;
+                std::vector< SFVEC2F > roundedEndPointsEnd;
+                roundedEndPointsStart.clear();
+                roundedEndPointsStart.reserve( nr_sides_per_circle + 2 );
+
+                roundedEndPointsEnd.clear();
+                roundedEndPointsEnd.reserve( nr_sides_per_circle + 2 );
+
+                roundedEndPointsStart.push_back( SFVEC2F( leftStart.x, leftStart.y ) );
+                roundedEndPointsEnd.push_back(   SFVEC2F( leftEnd.x,   leftEnd.y ) );
+
+                int    delta       = 3600 / nr_sides_per_circle;
+                for( int ii = delta; ii < 1800; ii += delta )
+                {
+                    const SFVEC2F rotatedDirL = glm::rotate( leftDir,  (float)        ii  * 2.0f * 3.14f / 3600.0f );
+                    const SFVEC2F rotatedDirR = glm::rotate( rightDir, (float)(1800 - ii) * 2.0f * 3.14f / 3600.0f );
+                    roundedEndPointsStart.push_back( SFVEC2F( start.x - rotatedDirL.y * radius, start.y + rotatedDirL.x * radius ) );
+                    roundedEndPointsEnd.push_back(   SFVEC2F( end.x   - rotatedDirR.y * radius, end.y   + rotatedDirR.x * radius ) );
                 }
-                break;
+                roundedEndPointsStart.push_back( SFVEC2F( rightEnd.x, rightEnd.y ) );
+                roundedEndPointsEnd.push_back(   SFVEC2F( rightStart.x, rightStart.y ) );
 
-                case OBJ2D_ROUNDSEG:
+                if( roundedEndPointsStart.size() > 1 )
                 {
-                    const CROUNDSEGMENT2D &roundSeg = (const CROUNDSEGMENT2D &) *object2d_A;
-                    unsigned int nr_sides_per_circle = (unsigned int)mapf( roundSeg.GetWidth(),
-                                                                           calc_sides_min_factor, calc_sides_max_factor,
-                                                                           24.0f, 256.0f );
-
-                    wxASSERT( nr_sides_per_circle >= 24 );
-
-                    SFVEC2F leftStart   = roundSeg.GetLeftStar();
-                    SFVEC2F leftEnd     = roundSeg.GetLeftEnd();
-                    SFVEC2F leftDir     = roundSeg.GetLeftDir();
-
-                    SFVEC2F rightStart  = roundSeg.GetRightStar();
-                    SFVEC2F rightEnd    = roundSeg.GetRightEnd();
-                    SFVEC2F rightDir    = roundSeg.GetRightDir();
-                    float   radius      = roundSeg.GetRadius();
-
-                    SFVEC2F start       = roundSeg.GetStart();
-                    SFVEC2F end         = roundSeg.GetEnd();
-
-                    float texture_factor = (12.0f/(float)SIZE_OF_CIRCLE_TEXTURE) + 1.0f;
-                    float texture_factorF= ( 4.0f/(float)SIZE_OF_CIRCLE_TEXTURE) + 1.0f;
-
-                    const float radius_of_the_square = sqrtf( roundSeg.GetRadiusSquared() * 2.0f );
-                    const float radius_triangle_factor = (radius_of_the_square - radius) / radius;
-
-                    const SFVEC2F factorS = SFVEC2F( -rightDir.y * radius * radius_triangle_factor, rightDir.x * radius * radius_triangle_factor );
-                    const SFVEC2F factorE = SFVEC2F( -leftDir.y  * radius * radius_triangle_factor, leftDir.x  * radius * radius_triangle_factor );
-
-                    // Top end segment triangles
-                    layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( rightEnd.x   + texture_factor * factorS.x, rightEnd.y  + texture_factor * factorS.y, layer_z_top ),
-                                                                           SFVEC3F( leftStart.x  + texture_factor * factorE.x, leftStart.y + texture_factor * factorE.y, layer_z_top ),
-                                                                           SFVEC3F( start.x - texture_factorF * leftDir.x * radius * sqrtf(2.0f),
-                                                                                    start.y - texture_factorF * leftDir.y * radius * sqrtf(2.0f), layer_z_top ) );
-
-                    layerTriangles->m_layer_top_segment_ends->AddTriangle( SFVEC3F( leftEnd.x    + texture_factor * factorE.x, leftEnd.y    + texture_factor * factorE.y, layer_z_top ),
-                                                                           SFVEC3F( rightStart.x + texture_factor * factorS.x, rightStart.y + texture_factor * factorS.y, layer_z_top ),
-                                                                           SFVEC3F( end.x - texture_factorF * rightDir.x * radius * sqrtf(2.0f),
-                                                                                    end.y - texture_factorF * rightDir.y * radius * sqrtf(2.0f), layer_z_top ) );
-
-                    // Bot end segment triangles
-                    layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( leftStart.x  + texture_factor * factorE.x, leftStart.y + texture_factor * factorE.y, layer_z_bot ),
-                                                                           SFVEC3F( rightEnd.x   + texture_factor * factorS.x, rightEnd.y  + texture_factor * factorS.y, layer_z_bot ),
-                                                                           SFVEC3F( start.x - texture_factorF * leftDir.x * radius * sqrtf(2.0f),
-                                                                                    start.y - texture_factorF * leftDir.y * radius * sqrtf(2.0f), layer_z_bot ) );
-
-                    layerTriangles->m_layer_bot_segment_ends->AddTriangle( SFVEC3F( rightStart.x + texture_factor * factorS.x, rightStart.y + texture_factor * factorS.y, layer_z_bot ),
-                                                                           SFVEC3F( leftEnd.x    + texture_factor * factorE.x, leftEnd.y    + texture_factor * factorE.y, layer_z_bot ),
-                                                                           SFVEC3F( end.x - texture_factorF * rightDir.x * radius * sqrtf(2.0f),
-                                                                                    end.y - texture_factorF * rightDir.y * radius * sqrtf(2.0f), layer_z_bot ) );
-
-                    // Segment top and bot planes
-                    layerTriangles->m_layer_top_triangles->AddQuad( SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_top ),
-                                                                    SFVEC3F( rightStart.x, rightStart.y, layer_z_top ),
-                                                                    SFVEC3F( leftEnd.x,    leftEnd.y,    layer_z_top ),
-                                                                    SFVEC3F( leftStart.x,  leftStart.y,  layer_z_top ) );
-
-                    layerTriangles->m_layer_bot_triangles->AddQuad( SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_bot ),
-                                                                    SFVEC3F( leftStart.x,  leftStart.y,  layer_z_bot ),
-                                                                    SFVEC3F( leftEnd.x,    leftEnd.y,    layer_z_bot ),
-                                                                    SFVEC3F( rightStart.x, rightStart.y, layer_z_bot ) );
-
-                    // Middle contourns (two sides of the segment)
-                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( leftStart.x, leftStart.y, layer_z_top ),
-                                                                             SFVEC3F( leftEnd.x,   leftEnd.y,   layer_z_top ),
-                                                                             SFVEC3F( leftEnd.x,   leftEnd.y,   layer_z_bot ),
-                                                                             SFVEC3F( leftStart.x, leftStart.y, layer_z_bot ) );
-                    const SFVEC3F leftNormal = SFVEC3F( -leftDir.y, leftDir.x, 0.0f );
-                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( leftNormal, leftNormal, leftNormal, leftNormal );
-
-
-                    layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( rightStart.x, rightStart.y, layer_z_top ),
-                                                                             SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_top ),
-                                                                             SFVEC3F( rightEnd.x,   rightEnd.y,   layer_z_bot ),
-                                                                             SFVEC3F( rightStart.x, rightStart.y, layer_z_bot ) );
-                    const SFVEC3F rightNormal = SFVEC3F( -rightDir.y, rightDir.x, 0.0f );
-                    layerTriangles->m_layer_middle_contourns_quads->AddNormal( rightNormal, rightNormal, rightNormal, rightNormal );
-
-
-                    // Compute the outlines of the segment, and creates a polygon
-                    // add right rounded end:
-
-                    std::vector< SFVEC2F > roundedEndPointsStart;
-                    std::vector< SFVEC2F > roundedEndPointsEnd;
-                    roundedEndPointsStart.clear();
-                    roundedEndPointsStart.reserve( nr_sides_per_circle + 2 );
-
-                    roundedEndPointsEnd.clear();
-                    roundedEndPointsEnd.reserve( nr_sides_per_circle + 2 );
-
-                    roundedEndPointsStart.push_back( SFVEC2F( leftStart.x, leftStart.y ) );
-                    roundedEndPointsEnd.push_back(   SFVEC2F( leftEnd.x,   leftEnd.y ) );
-
-                    int    delta       = 3600 / nr_sides_per_circle;
-                    for( int ii = delta; ii < 1800; ii += delta )
+                    for( unsigned int i = 0; i < ( roundedEndPointsStart.size() - 1 ); ++i )
                     {
-                        const SFVEC2F rotatedDirL = glm::rotate( leftDir,  (float)        ii  * 2.0f * 3.14f / 3600.0f );
-                        const SFVEC2F rotatedDirR = glm::rotate( rightDir, (float)(1800 - ii) * 2.0f * 3.14f / 3600.0f );
-                        roundedEndPointsStart.push_back( SFVEC2F( start.x - rotatedDirL.y * radius, start.y + rotatedDirL.x * radius ) );
-                        roundedEndPointsEnd.push_back(   SFVEC2F( end.x   - rotatedDirR.y * radius, end.y   + rotatedDirR.x * radius ) );
-                    }
-                    roundedEndPointsStart.push_back( SFVEC2F( rightEnd.x, rightEnd.y ) );
-                    roundedEndPointsEnd.push_back(   SFVEC2F( rightStart.x, rightStart.y ) );
+                        const SFVEC2F &v0 = roundedEndPointsStart[i + 0];
+                        const SFVEC2F &v1 = roundedEndPointsStart[i + 1];
 
-                    if( roundedEndPointsStart.size() > 1 )
-                    {
-                        for( unsigned int i = 0; i < ( roundedEndPointsStart.size() - 1 ); ++i )
-                        {
-                            const SFVEC2F &v0 = roundedEndPointsStart[i + 0];
-                            const SFVEC2F &v1 = roundedEndPointsStart[i + 1];
-
-                            layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_bot ),
-                                                                                     SFVEC3F( v1.x, v1.y, layer_z_bot ),
-                                                                                     SFVEC3F( v1.x, v1.y, layer_z_top ),
-                                                                                     SFVEC3F( v0.x, v0.y, layer_z_top ) );
-
-
-                            const SFVEC2F n0 = glm::normalize( v0 - start );
-                            const SFVEC2F n1 = glm::normalize( v1 - start );
-                            const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
-                            const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
-                            layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
-                        }
-                    }
-                    roundedEndPointsStart.clear();
+                        layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_bot ),
+                                                                                 SFVEC3F( v1.x, v1.y, layer_z_bot ),
+                                                                                 SFVEC3F( v1.x, v1.y, layer_z_top ),
+                                                                                 SFVEC3F( v0.x, v0.y, layer_z_top ) );
 
-                    if( roundedEndPointsEnd.size() > 1 )
-                    {
-                        for( unsigned int i = 0; i < ( roundedEndPointsEnd.size() - 1 ); ++i )
-                        {
-                            const SFVEC2F &v0 = roundedEndPointsEnd[i + 0];
-                            const SFVEC2F &v1 = roundedEndPointsEnd[i + 1];
-
-                            layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_top ),
-                                                                                     SFVEC3F( v1.x, v1.y, layer_z_top ),
-                                                                                     SFVEC3F( v1.x, v1.y, layer_z_bot ),
-                                                                                     SFVEC3F( v0.x, v0.y, layer_z_bot ) );
-
-
-                            const SFVEC2F n0 = glm::normalize( v0 - end );
-                            const SFVEC2F n1 = glm::normalize( v1 - end );
-                            const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
-                            const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
-                            layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
-                        }
+
+                        const SFVEC2F n0 = glm::normalize( v0 - start );
+                        const SFVEC2F n1 = glm::normalize( v1 - start );
+                        const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
+                        const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
+                        layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
                     }
-                    roundedEndPointsEnd.clear();
                 }
-                break;
+                roundedEndPointsStart.clear();
 
-                default:
+                if( roundedEndPointsEnd.size() > 1 )
                 {
+                    for( unsigned int i = 0; i < ( roundedEndPointsEnd.size() - 1 ); ++i )
+                    {
+                        const SFVEC2F &v0 = roundedEndPointsEnd[i + 0];
+                        const SFVEC2F &v1 = roundedEndPointsEnd[i + 1];
+
+                        layerTriangles->m_layer_middle_contourns_quads->AddQuad( SFVEC3F( v0.x, v0.y, layer_z_top ),
+                                                                                 SFVEC3F( v1.x, v1.y, layer_z_top ),
+                                                                                 SFVEC3F( v1.x, v1.y, layer_z_bot ),
+                                                                                 SFVEC3F( v0.x, v0.y, layer_z_bot ) );
+
+
+                        const SFVEC2F n0 = glm::normalize( v0 - end );
+                        const SFVEC2F n1 = glm::normalize( v1 - end );
+                        const SFVEC3F n0z = SFVEC3F( n0.x, n0.y, 0.0f );
+                        const SFVEC3F n1z = SFVEC3F( n1.x, n1.y, 0.0f );
+                        layerTriangles->m_layer_middle_contourns_quads->AddNormal( n0z, n1z, n1z, n0z );
+                    }
                 }
-                break;
+                roundedEndPointsEnd.clear();
+            }
+            break;
+
+            default:
+            {
             }
+            break;
+        }
 #if 0
-            // not yet used / implemented (can be used in future to clip the objects in the board borders
-            COBJECT2D *object2d_C = CSGITEM_FULL;
+        // not yet used / implemented (can be used in future to clip the objects in the board borders
+        COBJECT2D *object2d_C = CSGITEM_FULL;
 
-            std::vector<const COBJECT2D *> *object2d_B = CSGITEM_EMPTY;
+        std::vector<const COBJECT2D *> *object2d_B = CSGITEM_EMPTY;
 
-            if( m_settings.GetFlag( FL_RENDER_SHOW_HOLES_IN_ZONES ) )
-            {
-                object2d_B = new std::vector<const COBJECT2D *>();
+        if( m_settings.GetFlag( FL_RENDER_SHOW_HOLES_IN_ZONES ) )
+        {
+            object2d_B = new std::vector<const COBJECT2D *>();
 
-                // Check if there are any layerhole that intersects this object
-                // Eg: a segment is cutted by a via hole or THT hole.
-                // /////////////////////////////////////////////////////////////
-                const MAP_CONTAINER_2D &layerHolesMap = m_settings.GetMapLayersHoles();
-                if( layerHolesMap.find(layer_id) != layerHolesMap.end() )
-                {
-                    MAP_CONTAINER_2D::const_iterator ii_hole = layerHolesMap.find(layer_id);
-                    const CBVHCONTAINER2D *containerLayerHoles2d = static_cast<const CBVHCONTAINER2D *>(ii_hole->second);
+            // Check if there are any layerhole that intersects this object
+            // Eg: a segment is cutted by a via hole or THT hole.
+            // /////////////////////////////////////////////////////////////
+            const MAP_CONTAINER_2D &layerHolesMap = m_settings.GetMapLayersHoles();
+            if( layerHolesMap.find(layer_id) != layerHolesMap.end() )
+            {
+                MAP_CONTAINER_2D::const_iterator ii_hole = layerHolesMap.find(layer_id);
+                const CBVHCONTAINER2D *containerLayerHoles2d = static_cast<const CBVHCONTAINER2D *>(ii_hole->second);
 
 
-                    CONST_LIST_OBJECT2D intersectionList;
-                    containerLayerHoles2d->GetListObjectsIntersects( object2d_A->GetBBox(), intersectionList );
+                CONST_LIST_OBJECT2D intersectionList;
+                containerLayerHoles2d->GetListObjectsIntersects( object2d_A->GetBBox(), intersectionList );
 
-                    if( !intersectionList.empty() )
+                if( !intersectionList.empty() )
+                {
+                    for( CONST_LIST_OBJECT2D::const_iterator holeOnLayer = intersectionList.begin();
+                         holeOnLayer != intersectionList.end();
+                         holeOnLayer++ )
                     {
-                        for( CONST_LIST_OBJECT2D::const_iterator holeOnLayer = intersectionList.begin();
-                             holeOnLayer != intersectionList.end();
-                             holeOnLayer++ )
-                        {
-                            const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*holeOnLayer);
-
-                            //if( object2d_A->Intersects( hole2d->GetBBox() ) )
-                                //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
-                                    object2d_B->push_back( hole2d );
-                        }
+                        const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*holeOnLayer);
+
+                        //if( object2d_A->Intersects( hole2d->GetBBox() ) )
+                            //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
+                                object2d_B->push_back( hole2d );
                     }
                 }
+            }
 
-                // Check if there are any THT that intersects this object
-                // /////////////////////////////////////////////////////////////
-                if( !m_settings.GetThroughHole_Inflated().GetList().empty() )
-                {
-                    CONST_LIST_OBJECT2D intersectionList;
-                    m_settings.GetThroughHole_Inflated().GetListObjectsIntersects( object2d_A->GetBBox(), intersectionList );
+            // Check if there are any THT that intersects this object
+            // /////////////////////////////////////////////////////////////
+            if( !m_settings.GetThroughHole_Inflated().GetList().empty() )
+            {
+                CONST_LIST_OBJECT2D intersectionList;
+                m_settings.GetThroughHole_Inflated().GetListObjectsIntersects( object2d_A->GetBBox(), intersectionList );
 
-                    if( !intersectionList.empty() )
+                if( !intersectionList.empty() )
+                {
+                    for( CONST_LIST_OBJECT2D::const_iterator hole = intersectionList.begin();
+                         hole != intersectionList.end();
+                         hole++ )
                     {
-                        for( CONST_LIST_OBJECT2D::const_iterator hole = intersectionList.begin();
-                             hole != intersectionList.end();
-                             hole++ )
-                        {
-                            const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*hole);
-
-                            //if( object2d_A->Intersects( hole2d->GetBBox() ) )
-                                //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
-                                    object2d_B->push_back( hole2d );
-                        }
-                    }
-                }
+                        const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*hole);
 
-                if( object2d_B->empty() )
-                {
-                    delete object2d_B;
-                    object2d_B = CSGITEM_EMPTY;
+                        //if( object2d_A->Intersects( hole2d->GetBBox() ) )
+                            //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
+                                object2d_B->push_back( hole2d );
+                    }
                 }
             }
 
-            if( (object2d_B == CSGITEM_EMPTY) &&
-                (object2d_C == CSGITEM_FULL) )
+            if( object2d_B->empty() )
             {
+                delete object2d_B;
+                object2d_B = CSGITEM_EMPTY;
+            }
+        }
+
+        if( (object2d_B == CSGITEM_EMPTY) &&
+            (object2d_C == CSGITEM_FULL) )
+        {
 #if 0
-               create_3d_object_from( m_object_container, object2d_A, m_settings.GetLayerBottomZpos3DU( layer_id ),
-                                                                       m_settings.GetLayerTopZpos3DU( layer_id ),
-                                       materialLayer,
-                                       layerColor );
+           create_3d_object_from( m_object_container, object2d_A, m_settings.GetLayerBottomZpos3DU( layer_id ),
+                                                                   m_settings.GetLayerTopZpos3DU( layer_id ),
+                                   materialLayer,
+                                   layerColor );
 #else
-                CLAYERITEM *objPtr = new CLAYERITEM( object2d_A, m_settings.GetLayerBottomZpos3DU( layer_id ),
-                                                                 m_settings.GetLayerTopZpos3DU( layer_id ) );
-                objPtr->SetMaterial( materialLayer );
-                objPtr->SetColor( layerColor );
-                m_object_container.Add( objPtr );
+            CLAYERITEM *objPtr = new CLAYERITEM( object2d_A, m_settings.GetLayerBottomZpos3DU( layer_id ),
+                                                             m_settings.GetLayerTopZpos3DU( layer_id ) );
+            objPtr->SetMaterial( materialLayer );
+            objPtr->SetColor( layerColor );
+            m_object_container.Add( objPtr );
 #endif
-            }
-            else
-            {
+        }
+        else
+        {
 #if 1
-                CITEMLAYERCSG2D *itemCSG2d = new CITEMLAYERCSG2D( object2d_A, object2d_B, object2d_C,
-                                                                  object2d_A->GetBoardItem() );
-                m_containerWithObjectsToDelete.Add( itemCSG2d );
+            CITEMLAYERCSG2D *itemCSG2d = new CITEMLAYERCSG2D( object2d_A, object2d_B, object2d_C,
+                                                              object2d_A->GetBoardItem() );
+            m_containerWithObjectsToDelete.Add( itemCSG2d );
 
-                CLAYERITEM *objPtr = new CLAYERITEM( itemCSG2d, m_settings.GetLayerBottomZpos3DU( layer_id ),
-                                                     m_settings.GetLayerTopZpos3DU( layer_id ) );
+            CLAYERITEM *objPtr = new CLAYERITEM( itemCSG2d, m_settings.GetLayerBottomZpos3DU( layer_id ),
+                                                 m_settings.GetLayerTopZpos3DU( layer_id ) );
 
-                objPtr->SetMaterial( materialLayer );
-                objPtr->SetColor( layerColor );
-                m_object_container.Add( objPtr );
-#endif
-            }
+            objPtr->SetMaterial( materialLayer );
+            objPtr->SetColor( layerColor );
+            m_object_container.Add( objPtr );
 #endif
         }
+#endif
+    }
 
-        // Create display list
-        // /////////////////////////////////////////////////////////////////////
-        m_ogl_disp_lists_layers[layer_id] = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
-                                                                        m_ogl_circle_texture,
-                                                                        layerColor );
-    }// for each layer on map
-
+    // Create display list
+    // /////////////////////////////////////////////////////////////////////
+    m_ogl_disp_lists_layers[layer_id] = new CLAYERS_OGL_DISP_LISTS( *layerTriangles,
+                                                                    m_ogl_circle_texture,
+                                                                    layerColor );
 }
 
 
@@ -461,6 +461,8 @@ void C3D_RENDER_OGL_LEGACY::Redraw( bool aIsMoving )
 */
     if( m_reloadRequested )
         reload();
+    else if( m_reloadLayers.any() )
+        reload_layers();
 
     init();
 
@@ -712,3 +714,23 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
     delete m_ogl_disp_list_board;
     m_ogl_disp_list_board = 0;
 }
+
+
+void C3D_RENDER_OGL_LEGACY::ogl_free_layer( LAYER_ID aLayerId )
+{
+    MAP_OGL_DISP_LISTS::iterator list = m_ogl_disp_lists_layers.find( aLayerId );
+
+    if( list != m_ogl_disp_lists_layers.end() )
+    {
+        delete list->second;
+        m_ogl_disp_lists_layers.erase( list );
+    }
+
+    MAP_TRIANGLES::iterator triangles = m_triangles.find( aLayerId );
+
+    if( triangles != m_triangles.end() )
+    {
+        delete triangles->second;
+        m_triangles.erase( triangles );
+    }
+}
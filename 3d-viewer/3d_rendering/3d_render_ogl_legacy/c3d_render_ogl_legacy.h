@@ -54,20 +54,31 @@ public:
     // Imported from C3D_RENDER_BASE
     void SetCurWindowSize( const wxSize &aSize );
     void Redraw( bool aIsMoving );
+    void ReloadRequest( LAYER_ID aLayerId ) { m_reloadLayers.set( aLayerId ); }
+    using C3D_RENDER_BASE::ReloadRequest;
 
 private:
     bool initializeOpenGL();
     void reload();
 
+    /// Rebuild the triangles and display lists of the layers in m_reloadLayers only
+    void reload_layers();
+
+    /// Build the triangles and display lists of a layer from its 2D container
+    void generate_layer( LAYER_ID layer_id );
+
     void ogl_set_arrow_material();
 
     void ogl_free_all_display_lists();
+    void ogl_free_layer( LAYER_ID aLayerId );
     MAP_OGL_DISP_LISTS      m_ogl_disp_lists_layers;
     CLAYERS_OGL_DISP_LISTS* m_ogl_disp_list_board;
     MAP_TRIANGLES           m_triangles;
 
     GLuint m_ogl_circle_texture;
 
+    LSET   m_reloadLayers;                                                      ///< layers to rebuild at the next redraw
+
 private:
     void add_triangle_top_bot( CLAYER_TRIANGLES *aDst, const SFVEC2F &v0, const SFVEC2F &v1, const SFVEC2F &v2, float top, float bot );
 
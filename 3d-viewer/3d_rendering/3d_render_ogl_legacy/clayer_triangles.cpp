@@ -128,6 +128,23 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS(const CLAYER_TRIANGLES &aLayerTri
     m_layer_bot_triangles           = 0;
     m_layer_bot_segment_ends        = 0;
 
+    m_layer_color       = aLayerColor;
+    m_seg_ends_texture  = aTextureIndexForSegEnds;
+
+    // Vertex buffers are core since OpenGL 1.5
+    m_use_vbo = GLEW_VERSION_1_5;
+
+    if( m_use_vbo )
+    {
+        generate_vbo_batch( m_vbo_top_segment_ends,       aLayerTriangles.m_layer_top_segment_ends,       true  );
+        generate_vbo_batch( m_vbo_top_triangles,          aLayerTriangles.m_layer_top_triangles,          false );
+        generate_vbo_batch( m_vbo_middle_contourns_quads, aLayerTriangles.m_layer_middle_contourns_quads, false );
+        generate_vbo_batch( m_vbo_bot_triangles,          aLayerTriangles.m_layer_bot_triangles,          false );
+        generate_vbo_batch( m_vbo_bot_segment_ends,       aLayerTriangles.m_layer_bot_segment_ends,       true  );
+
+        return;
+    }
+
     m_layer_top_segment_ends = generate_top_or_bot_seg_ends(  aLayerTriangles.m_layer_top_segment_ends, aLayerColor, true, aTextureIndexForSegEnds );
     m_layer_top_triangles    = generate_top_or_bot_triangles( aLayerTriangles.m_layer_top_triangles,    aLayerColor, true  );
     m_layer_bot_triangles    = generate_top_or_bot_triangles( aLayerTriangles.m_layer_bot_triangles,    aLayerColor, false );
@@ -139,6 +156,15 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS(const CLAYER_TRIANGLES &aLayerTri
 
 CLAYERS_OGL_DISP_LISTS::~CLAYERS_OGL_DISP_LISTS()
 {
+    if( m_use_vbo )
+    {
+        free_vbo_batch( m_vbo_top_segment_ends );
+        free_vbo_batch( m_vbo_top_triangles );
+        free_vbo_batch( m_vbo_middle_contourns_quads );
+        free_vbo_batch( m_vbo_bot_triangles );
+        free_vbo_batch( m_vbo_bot_segment_ends );
+    }
+
     if( glIsList( m_layer_top_segment_ends ) )
         glDeleteLists( m_layer_top_segment_ends, 1 );
 
@@ -158,77 +184,47 @@ CLAYERS_OGL_DISP_LISTS::~CLAYERS_OGL_DISP_LISTS()
 
 void CLAYERS_OGL_DISP_LISTS::DrawTopAndMiddle() const
 {
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
-
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
-
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
-
+    draw_triangles( m_vbo_top_triangles, m_layer_top_triangles, true );
+    draw_middle( m_vbo_middle_contourns_quads, m_layer_middle_contourns_quads );
+    draw_seg_ends( m_vbo_top_segment_ends, m_layer_top_segment_ends, true );
 }
 
 
 void CLAYERS_OGL_DISP_LISTS::DrawBotAndMiddle() const
 {
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
-
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
-
+    draw_triangles( m_vbo_bot_triangles, m_layer_bot_triangles, false );
+    draw_middle( m_vbo_middle_contourns_quads, m_layer_middle_contourns_quads );
+    draw_seg_ends( m_vbo_bot_segment_ends, m_layer_bot_segment_ends, false );
 }
 
 
 void CLAYERS_OGL_DISP_LISTS::DrawTop() const
 {
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
-
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
+    draw_triangles( m_vbo_top_triangles, m_layer_top_triangles, true );
+    draw_seg_ends( m_vbo_top_segment_ends, m_layer_top_segment_ends, true );
 }
 
 
 void CLAYERS_OGL_DISP_LISTS::DrawBot() const
 {
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
+    draw_triangles( m_vbo_bot_triangles, m_layer_bot_triangles, false );
+    draw_seg_ends( m_vbo_bot_segment_ends, m_layer_bot_segment_ends, false );
 }
 
 
 void CLAYERS_OGL_DISP_LISTS::DrawMiddle() const
 {
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
+    draw_middle( m_vbo_middle_contourns_quads, m_layer_middle_contourns_quads );
 }
 
 
 void CLAYERS_OGL_DISP_LISTS::DrawAll() const
 {
-
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
-
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
-
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
-
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
-
+    draw_triangles( m_vbo_top_triangles, m_layer_top_triangles, true );
+    draw_middle( m_vbo_middle_contourns_quads, m_layer_middle_contourns_quads );
+    draw_triangles( m_vbo_bot_triangles, m_layer_bot_triangles, false );
+    draw_seg_ends( m_vbo_top_segment_ends, m_layer_top_segment_ends, true );
+    draw_seg_ends( m_vbo_bot_segment_ends, m_layer_bot_segment_ends, false );
 }
 
 
@@ -439,3 +435,189 @@ GLuint CLAYERS_OGL_DISP_LISTS::generate_middle_triangles( const CLAYER_TRIANGLE_
     return 0;
 }
 
+
+void CLAYERS_OGL_DISP_LISTS::generate_vbo_batch( VBO_BATCH &aBatch,
+                                                 const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer,
+                                                 bool aWithUV ) const
+{
+    wxASSERT( aTriangleContainer != NULL );
+
+    aBatch.m_vertex_buffer = 0;
+    aBatch.m_attrib_buffer = 0;
+    aBatch.m_vertex_count  = 0;
+
+    const unsigned int nrVertex = aTriangleContainer->GetVertexSize();
+    const bool withNormals = aTriangleContainer->GetNormalsSize() > 0;
+
+    if( (nrVertex == 0) || ((nrVertex % 3) != 0) ||
+        (withNormals && (aTriangleContainer->GetNormalsSize() != nrVertex)) )
+        return;
+
+    glGenBuffers( 1, &aBatch.m_vertex_buffer );
+    glBindBuffer( GL_ARRAY_BUFFER, aBatch.m_vertex_buffer );
+    glBufferData( GL_ARRAY_BUFFER, nrVertex * sizeof( SFVEC3F ),
+                  aTriangleContainer->GetVertexPointer(), GL_STATIC_DRAW );
+
+    if( aWithUV )
+    {
+        // Same UV text coordinates as the display lists
+        std::vector< SFVEC2F > uvArray( nrVertex );
+
+        for( unsigned int i = 0; i < nrVertex; i += 3 )
+        {
+            uvArray[i + 0] = SFVEC2F( 1.0f, 0.0f );
+            uvArray[i + 1] = SFVEC2F( 0.0f, 1.0f );
+            uvArray[i + 2] = SFVEC2F( 0.0f, 0.0f );
+        }
+
+        glGenBuffers( 1, &aBatch.m_attrib_buffer );
+        glBindBuffer( GL_ARRAY_BUFFER, aBatch.m_attrib_buffer );
+        glBufferData( GL_ARRAY_BUFFER, nrVertex * sizeof( SFVEC2F ), &uvArray[0].x,
+                      GL_STATIC_DRAW );
+    }
+    else if( withNormals )
+    {
+        glGenBuffers( 1, &aBatch.m_attrib_buffer );
+        glBindBuffer( GL_ARRAY_BUFFER, aBatch.m_attrib_buffer );
+        glBufferData( GL_ARRAY_BUFFER, nrVertex * sizeof( SFVEC3F ),
+                      aTriangleContainer->GetNormalsPointer(), GL_STATIC_DRAW );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    aBatch.m_vertex_count = nrVertex;
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::free_vbo_batch( VBO_BATCH &aBatch )
+{
+    if( aBatch.m_vertex_buffer )
+        glDeleteBuffers( 1, &aBatch.m_vertex_buffer );
+
+    if( aBatch.m_attrib_buffer )
+        glDeleteBuffers( 1, &aBatch.m_attrib_buffer );
+
+    aBatch.m_vertex_buffer = 0;
+    aBatch.m_attrib_buffer = 0;
+    aBatch.m_vertex_count  = 0;
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::bind_vbo_batch( const VBO_BATCH &aBatch, GLenum aAttribArray )
+{
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_VERTEX_ARRAY );
+
+    glBindBuffer( GL_ARRAY_BUFFER, aBatch.m_vertex_buffer );
+    glVertexPointer( 3, GL_FLOAT, 0, NULL );
+
+    if( aAttribArray == GL_TEXTURE_COORD_ARRAY )
+    {
+        glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+        glBindBuffer( GL_ARRAY_BUFFER, aBatch.m_attrib_buffer );
+        glTexCoordPointer( 2, GL_FLOAT, 0, NULL );
+    }
+    else if( aAttribArray == GL_NORMAL_ARRAY )
+    {
+        glEnableClientState( GL_NORMAL_ARRAY );
+        glBindBuffer( GL_ARRAY_BUFFER, aBatch.m_attrib_buffer );
+        glNormalPointer( GL_FLOAT, 0, NULL );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::draw_seg_ends( const VBO_BATCH &aBatch, GLuint aListIdx, bool aIsNormalUp ) const
+{
+    if( !m_use_vbo )
+    {
+        if( glIsList( aListIdx ) )
+            glCallList( aListIdx );
+
+        return;
+    }
+
+    if( aBatch.m_vertex_count == 0 )
+        return;
+
+    bind_vbo_batch( aBatch, GL_TEXTURE_COORD_ARRAY );
+
+    // Same render states as generate_top_or_bot_seg_ends
+    glEnable( GL_TEXTURE_2D );
+    glBindTexture( GL_TEXTURE_2D, m_seg_ends_texture );
+
+    glAlphaFunc( GL_GREATER, 0.60f );
+    glEnable( GL_ALPHA_TEST );
+
+    glEnable( GL_BLEND );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+    glEnable( GL_COLOR_MATERIAL );
+    glColor4f( m_layer_color.x, m_layer_color.y, m_layer_color.z, 1.0f );
+    glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
+
+    glDrawArrays( GL_TRIANGLES, 0, aBatch.m_vertex_count );
+
+    glDisable( GL_TEXTURE_2D );
+    glDisable( GL_ALPHA_TEST );
+    glDisable( GL_BLEND );
+    glDisable( GL_COLOR_MATERIAL );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::draw_triangles( const VBO_BATCH &aBatch, GLuint aListIdx, bool aIsNormalUp ) const
+{
+    if( !m_use_vbo )
+    {
+        if( glIsList( aListIdx ) )
+            glCallList( aListIdx );
+
+        return;
+    }
+
+    if( aBatch.m_vertex_count == 0 )
+        return;
+
+    bind_vbo_batch( aBatch, 0 );
+
+    // Same render states as generate_top_or_bot_triangles
+    glEnable( GL_COLOR_MATERIAL );
+    glColor4f( m_layer_color.x, m_layer_color.y, m_layer_color.z, 1.0f );
+    glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
+
+    glDrawArrays( GL_TRIANGLES, 0, aBatch.m_vertex_count );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::draw_middle( const VBO_BATCH &aBatch, GLuint aListIdx ) const
+{
+    if( !m_use_vbo )
+    {
+        if( glIsList( aListIdx ) )
+            glCallList( aListIdx );
+
+        return;
+    }
+
+    if( aBatch.m_vertex_count == 0 )
+        return;
+
+    bind_vbo_batch( aBatch, GL_NORMAL_ARRAY );
+
+    // Same render states as generate_middle_triangles
+    glEnable( GL_COLOR_MATERIAL );
+    glColor4f( m_layer_color.x, m_layer_color.y, m_layer_color.z, 1.0f );
+
+    glDrawArrays( GL_TRIANGLES, 0, aBatch.m_vertex_count );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+}
@@ -150,7 +150,9 @@ public:
 
 /**
  * @brief The CLAYERS_OGL_DISP_LISTS class stores the openGL display lists to
- * related with a layer
+ * related with a layer. Where the driver has vertex buffer objects (OpenGL 1.5),
+ * the triangles are stored in a vertex buffer per part of the layer instead, which
+ * are drawn with the same render states as the display lists.
  */
 class CLAYERS_OGL_DISP_LISTS
 {
@@ -200,6 +202,22 @@ public:
     void DrawAll() const;
 
 private:
+    /// The triangles of a part of the layer, in vertex buffers
+    struct VBO_BATCH
+    {
+        GLuint  m_vertex_buffer;    ///< vertex positions
+        GLuint  m_attrib_buffer;    ///< normals or texture coordinates, 0 if none
+        GLsizei m_vertex_count;     ///< number of vertex, 0 if the batch is empty
+    };
+
+    void generate_vbo_batch( VBO_BATCH &aBatch, const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer, bool aWithUV ) const;
+    static void free_vbo_batch( VBO_BATCH &aBatch );
+    static void bind_vbo_batch( const VBO_BATCH &aBatch, GLenum aAttribArray );
+
+    void draw_seg_ends( const VBO_BATCH &aBatch, GLuint aListIdx, bool aIsNormalUp ) const;
+    void draw_triangles( const VBO_BATCH &aBatch, GLuint aListIdx, bool aIsNormalUp ) const;
+    void draw_middle( const VBO_BATCH &aBatch, GLuint aListIdx ) const;
+
     GLuint generate_top_or_bot_seg_ends(const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer, const SFVEC3F& aLayerColor, bool aIsNormalUp , GLuint aTextureId ) const;
     GLuint generate_top_or_bot_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer, const SFVEC3F& aLayerColor, bool aIsNormalUp ) const;
     GLuint generate_middle_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer, const SFVEC3F& aLayerColor ) const;
@@ -210,6 +228,15 @@ private:
     GLuint m_layer_middle_contourns_quads;
     GLuint m_layer_bot_triangles;
     GLuint m_layer_bot_segment_ends;
+
+    bool      m_use_vbo;                                                        ///< true if the layer is in the VBO batches, not in the display lists
+    VBO_BATCH m_vbo_top_segment_ends;
+    VBO_BATCH m_vbo_top_triangles;
+    VBO_BATCH m_vbo_middle_contourns_quads;
+    VBO_BATCH m_vbo_bot_triangles;
+    VBO_BATCH m_vbo_bot_segment_ends;
+    SFVEC3F   m_layer_color;
+    GLuint    m_seg_ends_texture;
 };
 
 #endif // CLAYER_TRIANGLES_H_
@@ -0,0 +1,428 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  ccontainer2d.cpp
+ * @brief
+ */
+
+#include "ccontainer2d.h"
+#include <algorithm>
+#include <float.h>
+#include <vector>
+#include <boost/bind.hpp>
+#include <thread_pool.h>
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// CGENERICCONTAINER2
+// /////////////////////////////////////////////////////////////////////////////
+
+CGENERICCONTAINER2D::CGENERICCONTAINER2D( OBJECT2D_TYPE aObjType )
+{
+    (void) aObjType;
+
+    m_bbox.Reset();
+}
+
+
+void CGENERICCONTAINER2D::Clear()
+{
+    m_bbox.Reset();
+
+    for( LIST_OBJECT2D::iterator ii = m_objects.begin(); ii != m_objects.end(); ++ii )
+    {
+        delete *ii;
+        *ii = NULL;
+    }
+
+    m_objects.clear();
+}
+
+
+CGENERICCONTAINER2D::~CGENERICCONTAINER2D()
+{
+    Clear();
+}
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// CCONTAINER2D
+// /////////////////////////////////////////////////////////////////////////////
+
+CCONTAINER2D::CCONTAINER2D() : CGENERICCONTAINER2D( OBJ2D_CONTAINER )
+{
+}
+
+
+void CCONTAINER2D::GetListObjectsIntersects( const CBBOX2D &aBBox,
+                                             CONST_LIST_OBJECT2D &aOutList ) const
+{
+    for( LIST_OBJECT2D::const_iterator ii = m_objects.begin(); ii != m_objects.end(); ++ii )
+    {
+        if( (*ii)->Intersects( aBBox ) )
+            aOutList.push_back( *ii );
+    }
+}
+
+
+// /////////////////////////////////////////////////////////////////////////////
+// CBVHCONTAINER2D
+// /////////////////////////////////////////////////////////////////////////////
+
+/// The nodes with this count of objects or less are always leaves
+#define BVH_CONTAINER2D_MAX_OBJ_PER_LEAF 4
+
+/// The SAH nodes with more objects are always split, even at a higher cost
+#define BVH_CONTAINER2D_SAH_MAX_OBJ_PER_LEAF 16
+
+/// The number of bins of the centroids, where the SAH split is searched for
+#define BVH_CONTAINER2D_SAH_BINS 16
+
+/// The SAH subtrees with more objects are built as a task of the thread pool
+#define BVH_CONTAINER2D_SAH_MIN_OBJ_PER_TASK 4096
+
+
+CBVHCONTAINER2D::CBVHCONTAINER2D() : CGENERICCONTAINER2D( OBJ2D_BVHCONTAINER )
+{
+    m_isInitialized = false;
+    m_elements_to_delete.clear();
+    m_Tree = NULL;
+}
+
+
+void CBVHCONTAINER2D::destroy()
+{
+    for( std::list<BVH_CONTAINER_NODE_2D *>::iterator ii = m_elements_to_delete.begin();
+         ii != m_elements_to_delete.end();
+         ++ii )
+        delete *ii;
+
+    m_elements_to_delete.clear();
+    m_Tree = NULL;
+    m_isInitialized = false;
+}
+
+
+CBVHCONTAINER2D::~CBVHCONTAINER2D()
+{
+    destroy();
+}
+
+
+BVH_CONTAINER_NODE_2D *CBVHCONTAINER2D::newNode()
+{
+    BVH_CONTAINER_NODE_2D *node = new BVH_CONTAINER_NODE_2D;
+
+    node->m_BBox.Reset();
+    node->m_Children[0] = NULL;
+    node->m_Children[1] = NULL;
+
+    boost::mutex::scoped_lock lock( m_elements_lock );
+
+    m_elements_to_delete.push_back( node );
+
+    return node;
+}
+
+
+void CBVHCONTAINER2D::BuildBVH( BVH_SPLIT_METHOD aMethod, THREAD_POOL *aPool )
+{
+    if( m_isInitialized )
+        destroy();
+
+    m_isInitialized = true;
+
+    if( m_objects.empty() )
+        return;
+
+    m_Tree = newNode();
+
+    if( aMethod == BVH_SPLIT_MIDDLE )
+    {
+        m_Tree->m_BBox = m_bbox;
+
+        for( LIST_OBJECT2D::const_iterator ii = m_objects.begin(); ii != m_objects.end(); ++ii )
+            m_Tree->m_LeafList.push_back( static_cast<const COBJECT2D *>(*ii) );
+
+        recursiveBuild_MIDDLE_SPLIT( m_Tree );
+    }
+    else
+    {
+        std::vector<const COBJECT2D *> objects( m_objects.begin(), m_objects.end() );
+
+        recursiveBuild_SAH( m_Tree, &objects[0], &objects[0] + objects.size(), aPool );
+    }
+}
+
+
+// Based on a blog post by VADIM KRAVCENKO
+// http://www.vadimkravcenko.com/bvh-tree-building
+// Implements:
+
+// "Split in the middle of the longest Axis"
+// "Creates a binary tree with Top-Down approach.
+//  Fastest BVH building, but least [speed] accuracy."
+
+static bool sortByCentroid_X( const COBJECT2D *a, const COBJECT2D *b )
+{
+    return a->GetCentroid()[0] < b->GetCentroid()[0];
+}
+
+
+static bool sortByCentroid_Y( const COBJECT2D *a, const COBJECT2D *b )
+{
+    return a->GetCentroid()[1] < b->GetCentroid()[1];
+}
+
+
+void CBVHCONTAINER2D::recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent )
+{
+    if( aNodeParent->m_LeafList.size() <= BVH_CONTAINER2D_MAX_OBJ_PER_LEAF )
+        return;     // It is a leaf
+
+    BVH_CONTAINER_NODE_2D *leftNode  = newNode();
+    BVH_CONTAINER_NODE_2D *rightNode = newNode();
+
+    // Divide the objects along the longest axis
+    if( aNodeParent->m_BBox.MaxDimension() == 0 )
+        aNodeParent->m_LeafList.sort( sortByCentroid_X );
+    else
+        aNodeParent->m_LeafList.sort( sortByCentroid_Y );
+
+    const unsigned int nrLeft = aNodeParent->m_LeafList.size() / 2;
+    unsigned int i = 0;
+
+    for( CONST_LIST_OBJECT2D::const_iterator ii = aNodeParent->m_LeafList.begin();
+         ii != aNodeParent->m_LeafList.end();
+         ++ii, ++i )
+    {
+        BVH_CONTAINER_NODE_2D *node = ( i < nrLeft ) ? leftNode : rightNode;
+
+        node->m_BBox.Union( (*ii)->GetBBox() );
+        node->m_LeafList.push_back( *ii );
+    }
+
+    aNodeParent->m_Children[0] = leftNode;
+    aNodeParent->m_Children[1] = rightNode;
+    aNodeParent->m_LeafList.clear();
+
+    recursiveBuild_MIDDLE_SPLIT( leftNode );
+    recursiveBuild_MIDDLE_SPLIT( rightNode );
+}
+
+
+/// True if the centroid of an object is before a split position along an axis
+struct CENTROID_BEFORE
+{
+    unsigned int m_axis;
+    float        m_split;
+
+    bool operator()( const COBJECT2D *aObject ) const
+    {
+        return aObject->GetCentroid()[m_axis] < m_split;
+    }
+};
+
+
+// Binned SAH, as in "On fast Construction of SAH-based Bounding Volume Hierarchies",
+// I. Wald, 2007. The centroids are counted in bins along the longest axis of their
+// bounds, and the split is the bin boundary of the lowest cost:
+//      nrLeft * perimeter( left bbox ) + nrRight * perimeter( right bbox )
+// the perimeter being the 2D surface area.
+
+void CBVHCONTAINER2D::recursiveBuild_SAH( BVH_CONTAINER_NODE_2D *aNode,
+                                          const COBJECT2D **aBegin,
+                                          const COBJECT2D **aEnd,
+                                          THREAD_POOL *aPool )
+{
+    const unsigned int nrObjects = aEnd - aBegin;
+    CBBOX2D centroidsBBox;
+
+    centroidsBBox.Reset();
+
+    for( const COBJECT2D **ii = aBegin; ii != aEnd; ++ii )
+    {
+        aNode->m_BBox.Union( (*ii)->GetBBox() );
+        centroidsBBox.Union( (*ii)->GetCentroid() );
+    }
+
+    if( nrObjects <= BVH_CONTAINER2D_MAX_OBJ_PER_LEAF )
+    {
+        aNode->m_LeafList.assign( aBegin, aEnd );
+        return;
+    }
+
+    const unsigned int axis = centroidsBBox.MaxDimension();
+    const float axisMin = centroidsBBox.Min()[axis];
+    const float axisExtent = centroidsBBox.Max()[axis] - axisMin;
+
+    const COBJECT2D **middle = NULL;
+
+    if( axisExtent > 0.0f )
+    {
+        unsigned int binCount[BVH_CONTAINER2D_SAH_BINS];
+        CBBOX2D      binBBox[BVH_CONTAINER2D_SAH_BINS];
+
+        for( unsigned int b = 0; b < BVH_CONTAINER2D_SAH_BINS; ++b )
+        {
+            binCount[b] = 0;
+            binBBox[b].Reset();
+        }
+
+        const float toBin = BVH_CONTAINER2D_SAH_BINS / axisExtent;
+
+        for( const COBJECT2D **ii = aBegin; ii != aEnd; ++ii )
+        {
+            unsigned int b = (unsigned int)( ( (*ii)->GetCentroid()[axis] - axisMin ) * toBin );
+
+            b = std::min( b, (unsigned int)( BVH_CONTAINER2D_SAH_BINS - 1 ) );
+            binCount[b]++;
+            binBBox[b].Union( (*ii)->GetBBox() );
+        }
+
+        // The cost of the objects right of each bin boundary, sweeping from the right
+        float        rightCost[BVH_CONTAINER2D_SAH_BINS];
+        CBBOX2D      sweepBBox;
+        unsigned int sweepCount = 0;
+
+        sweepBBox.Reset();
+
+        for( unsigned int b = BVH_CONTAINER2D_SAH_BINS - 1; b > 0; --b )
+        {
+            sweepBBox.Union( binBBox[b] );
+            sweepCount += binCount[b];
+            rightCost[b] = sweepCount ? sweepCount * sweepBBox.Perimeter() : 0.0f;
+        }
+
+        float        bestCost = FLT_MAX;
+        unsigned int bestBin = 0;
+
+        sweepBBox.Reset();
+        sweepCount = 0;
+
+        for( unsigned int b = 1; b < BVH_CONTAINER2D_SAH_BINS; ++b )
+        {
+            sweepBBox.Union( binBBox[b - 1] );
+            sweepCount += binCount[b - 1];
+
+            if( sweepCount == 0 || sweepCount == nrObjects )
+                continue;
+
+            const float cost = sweepCount * sweepBBox.Perimeter() + rightCost[b];
+
+            if( cost < bestCost )
+            {
+                bestCost = cost;
+                bestBin = b;
+            }
+        }
+
+        // A leaf costs its count of object tests, a split one node test more
+        const float nodeCost = aNode->m_BBox.Perimeter();
+
+        if( ( bestBin > 0 ) &&
+            ( ( nodeCost + bestCost < nrObjects * nodeCost ) ||
+              ( nrObjects > BVH_CONTAINER2D_SAH_MAX_OBJ_PER_LEAF ) ) )
+        {
+            CENTROID_BEFORE before;
+
+            before.m_axis = axis;
+            before.m_split = axisMin + bestBin / toBin;
+
+            middle = std::partition( aBegin, aEnd, before );
+
+            // The rounding of the split position may leave a side empty
+            if( ( middle == aBegin ) || ( middle == aEnd ) )
+                middle = NULL;
+        }
+    }
+
+    if( middle == NULL )
+    {
+        // No split is worth its cost, or the centroids cannot be told apart
+        if( nrObjects <= BVH_CONTAINER2D_SAH_MAX_OBJ_PER_LEAF )
+        {
+            aNode->m_LeafList.assign( aBegin, aEnd );
+            return;
+        }
+
+        middle = aBegin + nrObjects / 2;
+    }
+
+    BVH_CONTAINER_NODE_2D *leftNode  = newNode();
+    BVH_CONTAINER_NODE_2D *rightNode = newNode();
+
+    aNode->m_Children[0] = leftNode;
+    aNode->m_Children[1] = rightNode;
+
+    if( aPool && ( nrObjects >= BVH_CONTAINER2D_SAH_MIN_OBJ_PER_TASK ) )
+    {
+        TASK_GROUP tasks( *aPool );
+
+        tasks.Run( boost::bind( &CBVHCONTAINER2D::recursiveBuild_SAH, this,
+                                leftNode, aBegin, middle, aPool ) );
+
+        recursiveBuild_SAH( rightNode, middle, aEnd, aPool );
+
+        tasks.Wait();
+    }
+    else
+    {
+        recursiveBuild_SAH( leftNode, aBegin, middle, aPool );
+        recursiveBuild_SAH( rightNode, middle, aEnd, aPool );
+    }
+}
+
+
+void CBVHCONTAINER2D::GetListObjectsIntersects( const CBBOX2D &aBBox,
+                                                CONST_LIST_OBJECT2D &aOutList ) const
+{
+    if( m_Tree )
+        recursiveGetListObjectsIntersects( m_Tree, aBBox, aOutList );
+}
+
+
+void CBVHCONTAINER2D::recursiveGetListObjectsIntersects( const BVH_CONTAINER_NODE_2D *aNode,
+                                                         const CBBOX2D &aBBox,
+                                                         CONST_LIST_OBJECT2D &aOutList ) const
+{
+    if( !aNode->m_BBox.Intersects( aBBox ) )
+        return;
+
+    if( aNode->m_Children[0] == NULL )
+    {
+        for( CONST_LIST_OBJECT2D::const_iterator ii = aNode->m_LeafList.begin();
+             ii != aNode->m_LeafList.end();
+             ++ii )
+        {
+            if( (*ii)->Intersects( aBBox ) )
+                aOutList.push_back( *ii );
+        }
+    }
+    else
+    {
+        recursiveGetListObjectsIntersects( aNode->m_Children[0], aBBox, aOutList );
+        recursiveGetListObjectsIntersects( aNode->m_Children[1], aBBox, aOutList );
+    }
+}
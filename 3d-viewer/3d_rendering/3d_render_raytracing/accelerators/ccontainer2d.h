@@ -32,6 +32,9 @@
 
 #include "../shapes2D/cobject2d.h"
 #include <list>
+#include <boost/thread/mutex.hpp>
+
+class THREAD_POOL;
 
 typedef std::list<COBJECT2D *> LIST_OBJECT2D;
 typedef std::list<const COBJECT2D *> CONST_LIST_OBJECT2D;
@@ -90,21 +93,42 @@ struct BVH_CONTAINER_NODE_2D
 };
 
 
+/// How CBVHCONTAINER2D::BuildBVH() splits the nodes of the tree
+enum BVH_SPLIT_METHOD
+{
+    BVH_SPLIT_MIDDLE,   ///< halves the objects along the longest axis, the fastest build
+    BVH_SPLIT_SAH       ///< binned surface area heuristic, the fastest queries
+};
+
+
 class GLM_ALIGN(CLASS_ALIGNMENT) CBVHCONTAINER2D : public CGENERICCONTAINER2D
 {
 public:
     CBVHCONTAINER2D();
     ~CBVHCONTAINER2D();
 
-    void BuildBVH();
+    /**
+     * @brief BuildBVH - build the tree of the objects added, before any query
+     * @param aMethod: how the nodes are split. The middle split makes overlapping
+     * nodes in the dense areas of a board, like BGA fan-outs, which are slow to query.
+     * @param aPool: the threads building the large SAH subtrees in parallel, or NULL
+     * to build the tree on the calling thread
+     */
+    void BuildBVH( BVH_SPLIT_METHOD aMethod = BVH_SPLIT_SAH, THREAD_POOL *aPool = NULL );
 
 private:
     bool m_isInitialized;
     std::list<BVH_CONTAINER_NODE_2D *> m_elements_to_delete;
+    boost::mutex m_elements_lock;                                               ///< protects m_elements_to_delete in a parallel build
     BVH_CONTAINER_NODE_2D   *m_Tree;
 
     void destroy();
+    BVH_CONTAINER_NODE_2D *newNode();
     void recursiveBuild_MIDDLE_SPLIT( BVH_CONTAINER_NODE_2D *aNodeParent );
+    void recursiveBuild_SAH( BVH_CONTAINER_NODE_2D *aNode,
+                             const COBJECT2D **aBegin,
+                             const COBJECT2D **aEnd,
+                             THREAD_POOL *aPool );
     void recursiveGetListObjectsIntersects( const BVH_CONTAINER_NODE_2D *aNode, const CBBOX2D & aBBox, CONST_LIST_OBJECT2D &aOutList ) const;
 
 public:
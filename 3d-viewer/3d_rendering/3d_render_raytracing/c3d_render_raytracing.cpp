@@ -0,0 +1,393 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  c3d_render_raytracing.cpp
+ * @brief
+ */
+
+#include "c3d_render_raytracing.h"
+#include "common_ogl/openGL_includes.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include <boost/bind.hpp>
+
+#include <pgm_base.h>
+#include <thread_pool.h>
+
+
+C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( CINFO3D_VISU &aSettings,
+                                              S3D_CACHE *a3DModelManager ) :
+                       C3D_RENDER_BASE( aSettings, a3DModelManager )
+{
+    wxLogTrace( m_logTrace, wxT( "C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING" ) );
+
+    m_layers.clear();
+    m_boardMin = SFVEC2F( 0.0f );
+    m_boardMax = SFVEC2F( 0.0f );
+    m_step = 0;
+    m_firstPass = true;
+}
+
+
+C3D_RENDER_RAYTRACING::~C3D_RENDER_RAYTRACING()
+{
+    wxLogTrace( m_logTrace, wxT( "C3D_RENDER_RAYTRACING::~C3D_RENDER_RAYTRACING" ) );
+}
+
+
+void C3D_RENDER_RAYTRACING::SetCurWindowSize( const wxSize &aSize )
+{
+    if( m_windowSize != aSize )
+    {
+        m_windowSize = aSize;
+        glViewport( 0, 0, m_windowSize.x, m_windowSize.y );
+
+        const unsigned int nrPixels = std::max( m_windowSize.x, 0 ) *
+                                      std::max( m_windowSize.y, 0 );
+
+        m_samples.resize( nrPixels * 4 );
+        m_image.resize( nrPixels * 4 );
+
+        // The rays traced are not the ones of the new pixels
+        m_step = 0;
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving )
+{
+    if( m_reloadRequested )
+    {
+        reload();
+        m_step = 0;
+    }
+
+    // Only this render reads the flag of the camera, a change restarts the refinement
+    if( m_settings.CameraGet().ParametersChanged() )
+        m_step = 0;
+
+    if( m_image.empty() )
+        return;
+
+    if( m_step == 0 )
+        render_pass( RT_COARSEST_STEP, true );
+    else if( ( m_step > 1 ) && !aIsMoving )
+        render_pass( m_step / 2, false );
+
+    glDisable( GL_DEPTH_TEST );
+    glDisable( GL_LIGHTING );
+    glDisable( GL_TEXTURE_2D );
+
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    glMatrixMode( GL_MODELVIEW );
+    glLoadIdentity();
+
+    glRasterPos2f( -1.0f, -1.0f );
+    glDrawPixels( m_windowSize.x, m_windowSize.y, GL_RGBA, GL_UNSIGNED_BYTE, &m_image[0] );
+}
+
+
+void C3D_RENDER_RAYTRACING::reload()
+{
+    m_reloadRequested = false;
+    m_layers.clear();
+
+    const CBBOX &boardBBox = m_settings.GetBBox3DU();
+
+    m_boardMin = SFVEC2F( boardBBox.Min().x, boardBBox.Min().y );
+    m_boardMax = SFVEC2F( boardBBox.Max().x, boardBBox.Max().y );
+
+    for( MAP_CONTAINER_2D::const_iterator ii = m_settings.GetMapLayers().begin();
+         ii != m_settings.GetMapLayers().end();
+         ++ii )
+    {
+        const LAYER_ID layer_id = static_cast<LAYER_ID>(ii->first);
+
+        if( !m_settings.Is3DLayerEnabled( layer_id ) || ii->second->GetList().empty() )
+            continue;
+
+        RT_LAYER layer;
+
+        layer.m_layerId = layer_id;
+        layer.m_container = ii->second;
+        layer.m_zBot = m_settings.GetLayerBottomZpos3DU( layer_id );
+        layer.m_zTop = m_settings.GetLayerTopZpos3DU( layer_id );
+        layer.m_color = m_settings.GetLayerColor( layer_id );
+
+        if( layer.m_zTop < layer.m_zBot )
+            std::swap( layer.m_zBot, layer.m_zTop );
+
+        layer.m_zBot -= m_settings.GetNonCopperLayerThickness3DU();
+        layer.m_zTop += m_settings.GetNonCopperLayerThickness3DU();
+
+        m_layers.push_back( layer );
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::render_pass( unsigned int aStep, bool aFirstPass )
+{
+    m_step = aStep;
+    m_firstPass = aFirstPass;
+
+    const unsigned int nrSampleRows = ( m_windowSize.y + aStep - 1 ) / aStep;
+    const unsigned int nrBands = ( nrSampleRows + RAYPACKET_DIM - 1 ) / RAYPACKET_DIM;
+
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+    for( unsigned int band = 0; band < nrBands; ++band )
+        tasks.Run( boost::bind( &C3D_RENDER_RAYTRACING::render_band, this, band ) );
+
+    tasks.Wait();
+
+    // Each pixel shows the ray traced at the up left of its block of aStep x aStep pixels.
+    // The openGL image starts at the bottom row.
+    const unsigned int width = m_windowSize.x;
+    const unsigned int height = m_windowSize.y;
+
+    for( unsigned int y = 0; y < height; ++y )
+    {
+        const unsigned char *srcRow = &m_samples[( y - y % aStep ) * width * 4];
+        unsigned char *dstRow = &m_image[( height - 1 - y ) * width * 4];
+
+        for( unsigned int x = 0; x < width; ++x )
+            memcpy( &dstRow[x * 4], &srcRow[( x - x % aStep ) * 4], 4 );
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::render_band( unsigned int aBand )
+{
+    const unsigned int nrSampleColumns = ( m_windowSize.x + m_step - 1 ) / m_step;
+
+    for( unsigned int sampleX = 0; sampleX < nrSampleColumns; sampleX += RAYPACKET_DIM )
+        render_tile( sampleX, aBand * RAYPACKET_DIM );
+}
+
+
+void C3D_RENDER_RAYTRACING::render_tile( unsigned int aSampleX, unsigned int aSampleY )
+{
+    RAY          rays[RAYPACKET_RAYS_PER_PACKET];
+    HITINFO      hits[RAYPACKET_RAYS_PER_PACKET];
+    SFVEC2I      pixels[RAYPACKET_RAYS_PER_PACKET];
+    unsigned int nrRays = 0;
+
+    const CCAMERA &camera = m_settings.CameraGet();
+    const unsigned int previousStep = m_step * 2;
+
+    for( unsigned int j = 0; j < RAYPACKET_DIM; ++j )
+    {
+        const unsigned int y = ( aSampleY + j ) * m_step;
+
+        if( y >= (unsigned int)m_windowSize.y )
+            break;
+
+        for( unsigned int i = 0; i < RAYPACKET_DIM; ++i )
+        {
+            const unsigned int x = ( aSampleX + i ) * m_step;
+
+            if( x >= (unsigned int)m_windowSize.x )
+                break;
+
+            if( !m_firstPass && ( x % previousStep == 0 ) && ( y % previousStep == 0 ) )
+                continue;
+
+            SFVEC3F rayOrigin;
+            SFVEC3F rayDir;
+
+            camera.MakeRay( SFVEC2I( x, y ), rayOrigin, rayDir );
+
+            rays[nrRays].Init( rayOrigin, rayDir );
+            hits[nrRays].m_tHit = FLT_MAX;
+            hits[nrRays].pHitObject = NULL;
+            hits[nrRays].m_acc_node_info = 0;
+            pixels[nrRays] = SFVEC2I( x, y );
+            nrRays++;
+        }
+    }
+
+    if( nrRays == 0 )
+        return;
+
+    RAYPACKET_SOA packet;
+
+    packet.Set( rays, nrRays );
+
+    for( unsigned int layer = 0; layer < m_layers.size(); ++layer )
+        intersect_layer( layer, rays, packet, hits );
+
+    for( unsigned int r = 0; r < nrRays; ++r )
+    {
+        const SFVEC3F color = glm::clamp( ( hits[r].m_tHit < FLT_MAX ) ?
+                                          shade( rays[r], hits[r] ) :
+                                          background( pixels[r].y ),
+                                          SFVEC3F( 0.0f ), SFVEC3F( 1.0f ) );
+
+        unsigned char *pixel = &m_samples[( pixels[r].y * m_windowSize.x + pixels[r].x ) * 4];
+
+        pixel[0] = (unsigned char)( color.r * 255.0f + 0.5f );
+        pixel[1] = (unsigned char)( color.g * 255.0f + 0.5f );
+        pixel[2] = (unsigned char)( color.b * 255.0f + 0.5f );
+        pixel[3] = 255;
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::intersect_layer( unsigned int aLayerIndex, const RAY *aRays,
+                                             const RAYPACKET_SOA &aPacket,
+                                             HITINFO *aHits ) const
+{
+    const RT_LAYER &layer = m_layers[aLayerIndex];
+    const CBBOX layerBBox( SFVEC3F( m_boardMin.x, m_boardMin.y, layer.m_zBot ),
+                           SFVEC3F( m_boardMax.x, m_boardMax.y, layer.m_zTop ) );
+
+    float        tIn[RAYPACKET_RAYS_PER_PACKET];
+    float        tOut[RAYPACKET_RAYS_PER_PACKET];
+    unsigned int active[RAYPACKET_RAYS_PER_PACKET];
+    unsigned int nrActive = 0;
+    CBBOX2D      tileBBox;
+
+    if( !layerBBox.Intersect( aPacket, tIn, tOut ) )
+        return;
+
+    tileBBox.Reset();
+
+    // The part of each ray in the layer, before the closest hit of the previous layers
+    for( unsigned int r = 0; r < aPacket.m_NrRays; ++r )
+    {
+        if( ( tIn[r] > tOut[r] ) || ( tIn[r] >= aHits[r].m_tHit ) )
+            continue;
+
+        tOut[r] = std::min( tOut[r], aHits[r].m_tHit );
+
+        tileBBox.Union( aRays[r].at2D( tIn[r] ) );
+        tileBBox.Union( aRays[r].at2D( tOut[r] ) );
+        active[nrActive++] = r;
+    }
+
+    if( nrActive == 0 )
+        return;
+
+    // A single query of the BVH for the items that the rays of the tile may hit
+    CONST_LIST_OBJECT2D candidates;
+
+    layer.m_container->GetListObjectsIntersects( tileBBox, candidates );
+
+    if( candidates.empty() )
+        return;
+
+    for( unsigned int a = 0; a < nrActive; ++a )
+    {
+        const unsigned int r = active[a];
+        const RAY &ray = aRays[r];
+        const SFVEC2F start = ray.at2D( tIn[r] );
+        const SFVEC2F end = ray.at2D( tOut[r] );
+
+        // A ray starting inside an item hits its top or bottom face, nothing is closer
+        bool hitFace = false;
+
+        for( CONST_LIST_OBJECT2D::const_iterator ii = candidates.begin();
+             ii != candidates.end();
+             ++ii )
+        {
+            if( (*ii)->GetBBox().Inside( start ) && (*ii)->IsPointInside( start ) )
+            {
+                hitFace = true;
+                break;
+            }
+        }
+
+        if( hitFace )
+        {
+            aHits[r].m_tHit = tIn[r];
+            aHits[r].m_HitNormal = SFVEC3F( 0.0f, 0.0f, ( ray.m_Dir.z < 0.0f ) ? 1.0f : -1.0f );
+            aHits[r].m_acc_node_info = aLayerIndex;
+
+            continue;
+        }
+
+        // Else it may hit the side of an item, a ray along z has no side to hit
+        if( ( start.x == end.x ) && ( start.y == end.y ) )
+            continue;
+
+        const RAYSEG2D segment( start, end );
+        float   closestT = FLT_MAX;
+        SFVEC2F closestNormal;
+
+        for( CONST_LIST_OBJECT2D::const_iterator ii = candidates.begin();
+             ii != candidates.end();
+             ++ii )
+        {
+            float   t;
+            SFVEC2F normal;
+
+            if( (*ii)->GetBBox().Intersect( segment ) &&
+                (*ii)->Intersect( segment, &t, &normal ) &&
+                ( t < closestT ) )
+            {
+                closestT = t;
+                closestNormal = normal;
+            }
+        }
+
+        if( closestT < FLT_MAX )
+        {
+            aHits[r].m_tHit = tIn[r] + closestT * ( tOut[r] - tIn[r] );
+            aHits[r].m_HitNormal = SFVEC3F( closestNormal.x, closestNormal.y, 0.0f );
+            aHits[r].m_acc_node_info = aLayerIndex;
+        }
+    }
+}
+
+
+SFVEC3F C3D_RENDER_RAYTRACING::shade( const RAY &aRay, const HITINFO &aHit ) const
+{
+    const RT_LAYER &layer = m_layers[aHit.m_acc_node_info];
+
+    // A headlight at the camera, lighting both sides of the faces
+    const float NdotL = fabs( glm::dot( aHit.m_HitNormal, aRay.m_Dir ) );
+
+    return layer.m_color * ( 0.3f + 0.7f * NdotL );
+}
+
+
+SFVEC3F C3D_RENDER_RAYTRACING::background( unsigned int aWindowY ) const
+{
+    const SFVEC3F top( m_settings.m_BgColor_Top.Red()   / 255.0f,
+                       m_settings.m_BgColor_Top.Green() / 255.0f,
+                       m_settings.m_BgColor_Top.Blue()  / 255.0f );
+
+    const SFVEC3F bottom( m_settings.m_BgColor.Red()   / 255.0f,
+                          m_settings.m_BgColor.Green() / 255.0f,
+                          m_settings.m_BgColor.Blue()  / 255.0f );
+
+    const float t = (float)aWindowY / (float)m_windowSize.y;
+
+    return top * ( 1.0f - t ) + bottom * t;
+}
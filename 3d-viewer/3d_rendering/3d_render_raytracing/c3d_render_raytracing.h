@@ -0,0 +1,118 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  c3d_render_raytracing.h
+ * @brief
+ */
+
+#ifndef C3D_RENDER_RAYTRACING_H
+#define C3D_RENDER_RAYTRACING_H
+
+#include "../c3d_render_base.h"
+#include "accelerators/ccontainer2d.h"
+#include "raypacket.h"
+#include "hitinfo.h"
+#include <vector>
+
+/// The pixel step of the rays traced while the camera moves, halved by each refinement
+#define RT_COARSEST_STEP 4
+
+
+/// An enabled layer of the board, its 2D items extruded between two z planes
+struct RT_LAYER
+{
+    LAYER_ID                m_layerId;
+    const CBVHCONTAINER2D  *m_container;
+    float                   m_zBot;
+    float                   m_zTop;
+    SFVEC3F                 m_color;
+};
+
+
+/**
+ * @brief The C3D_RENDER_RAYTRACING class render the board by tracing a ray per pixel
+ * against the 2D items of the layers, extruded between the z positions of each layer.
+ *
+ * The image is cut in bands of tiles of RAYPACKET_DIM x RAYPACKET_DIM rays, a task of the
+ * thread pool per band, so the idle threads steal the bands left. The rays of a tile
+ * query the BVH of a layer once, for the items crossed by the whole tile.
+ *
+ * A ray is traced every RT_COARSEST_STEP pixels after the camera moved, each of the
+ * following redraws halves the step, keeping the rays already traced, until a ray per
+ * pixel.
+ */
+class C3D_RENDER_RAYTRACING : public C3D_RENDER_BASE
+{
+public:
+    C3D_RENDER_RAYTRACING( CINFO3D_VISU &aSettings,
+                           S3D_CACHE *a3DModelManager );
+
+    ~C3D_RENDER_RAYTRACING();
+
+    // Imported from C3D_RENDER_BASE
+    void SetCurWindowSize( const wxSize &aSize );
+    void Redraw( bool aIsMoving );
+
+    /**
+     * @brief RefinementPending - the image is not traced yet at a ray per pixel, the canvas
+     * should redraw it again while the camera is idle
+     */
+    bool RefinementPending() const { return m_step != 1; }
+
+private:
+    void reload();
+
+    /**
+     * @brief render_pass - trace the rays of a pass, then update the displayed image
+     * @param aStep: the pixel step between the rays
+     * @param aFirstPass: trace all the rays, else only the ones not traced by the
+     * previous pass at twice aStep
+     */
+    void render_pass( unsigned int aStep, bool aFirstPass );
+
+    /// Trace the rays of the tiles of a band, the task run by the threads
+    void render_band( unsigned int aBand );
+
+    void render_tile( unsigned int aSampleX, unsigned int aSampleY );
+
+    /// Intersect the rays of a tile with a layer, keeping the closest hits
+    void intersect_layer( unsigned int aLayerIndex, const RAY *aRays,
+                          const RAYPACKET_SOA &aPacket, HITINFO *aHits ) const;
+
+    SFVEC3F shade( const RAY &aRay, const HITINFO &aHit ) const;
+    SFVEC3F background( unsigned int aWindowY ) const;
+
+    std::vector<RT_LAYER>       m_layers;
+
+    SFVEC2F                     m_boardMin;                                     ///< xy extent of the board
+    SFVEC2F                     m_boardMax;
+
+    std::vector<unsigned char>  m_samples;                                      ///< RGBA of the traced rays, top row first
+    std::vector<unsigned char>  m_image;                                        ///< RGBA displayed, bottom row first
+
+    unsigned int                m_step;                                         ///< pixel step of the last pass, 0 before the first one
+    bool                        m_firstPass;                                    ///< the pass traces all the rays of its step
+};
+
+#endif // C3D_RENDER_RAYTRACING_H
@@ -50,4 +50,40 @@ GLM_ALIGNED_STRUCT(CLASS_ALIGNMENT) RAYPACKET
 };
 
 
+/// The rays of a packet in structure of arrays layout, for the SIMD kernels. The arrays
+/// are padded with the last ray to a multiple of 8 rays, the widest SIMD kernel.
+GLM_ALIGNED_STRUCT(CLASS_ALIGNMENT) RAYPACKET_SOA
+{
+    float m_OriginX[RAYPACKET_RAYS_PER_PACKET];
+    float m_OriginY[RAYPACKET_RAYS_PER_PACKET];
+    float m_OriginZ[RAYPACKET_RAYS_PER_PACKET];
+
+    float m_InvDirX[RAYPACKET_RAYS_PER_PACKET];
+    float m_InvDirY[RAYPACKET_RAYS_PER_PACKET];
+    float m_InvDirZ[RAYPACKET_RAYS_PER_PACKET];
+
+    unsigned int m_NrRays;      ///< the rays set, without the padding
+
+    void Set( const RAY *aRays, unsigned int aNrRays )
+    {
+        m_NrRays = aNrRays;
+
+        const unsigned int nrPadded = ( aNrRays + 7 ) & ~7u;
+
+        for( unsigned int i = 0; i < nrPadded; ++i )
+        {
+            const RAY &ray = aRays[( i < aNrRays ) ? i : ( aNrRays - 1 )];
+
+            m_OriginX[i] = ray.m_Origin.x;
+            m_OriginY[i] = ray.m_Origin.y;
+            m_OriginZ[i] = ray.m_Origin.z;
+
+            m_InvDirX[i] = ray.m_InvDir.x;
+            m_InvDirY[i] = ray.m_InvDir.y;
+            m_InvDirZ[i] = ray.m_InvDir.z;
+        }
+    }
+};
+
+
 #endif // _RAYPACKET_H_
@@ -34,6 +34,8 @@
 #include "3d_rendering/3d_render_raytracing/ray.h"
 #include <fctsys.h>                                                             // For the DBG(
 
+struct RAYPACKET_SOA;
+
 /**
  * Class CBBOX
  * manages a bounding box defined by two SFVEC3F min max points.
@@ -244,6 +246,18 @@ public:
      */
     bool Intersect( const RAY &aRay, float *aOutHitt0, float *aOutHitt1 ) const;
 
+    /**
+     * Function Intersect - the slab test of all the rays of a packet, FASTMATH_SIMD_WIDTH
+     * rays at a time
+     * @param aPacket = the rays to intersect the box
+     * @param aOutHitt0 = the enter distance of each ray, 0.0 if it starts inside the bbox,
+     * or greater than its exit distance if it misses the bbox
+     * @param aOutHitt1 = the exit distance of each ray, both arrays of
+     * RAYPACKET_RAYS_PER_PACKET distances
+     * @return true if a ray of the packet hits the box
+     */
+    bool Intersect( const RAYPACKET_SOA &aPacket, float *aOutHitt0, float *aOutHitt1 ) const;
+
 private:
 
     SFVEC3F m_min;           ///< (12) point of the lower position of the bounding box
@@ -28,6 +28,9 @@
  */
 
 #include "cbbox.h"
+#include "../raypacket.h"
+#include "3d_math/3d_fastmath.h"
+#include <algorithm>
 #include <fctsys.h>
 #include <wx/debug.h>
 
@@ -903,3 +906,123 @@ bool CBBOX::Intersect( const RAY &aRay ) const
 
     return false;
 }
+
+
+// The slab test of "An Efficient and Robust Ray-Box Intersection Algorithm",
+// A. Williams, S. Barrus, R. K. Morley and P. Shirley, on the rays of a packet. The
+// directions along an axis have an inverse of FLT_MAX, not infinite, so no NaN is made.
+
+bool CBBOX::Intersect( const RAYPACKET_SOA &aPacket, float *aOutHitt0, float *aOutHitt1 ) const
+{
+#if FASTMATH_SIMD_WIDTH == 8
+    const __m256 minX = _mm256_set1_ps( m_min.x );
+    const __m256 minY = _mm256_set1_ps( m_min.y );
+    const __m256 minZ = _mm256_set1_ps( m_min.z );
+    const __m256 maxX = _mm256_set1_ps( m_max.x );
+    const __m256 maxY = _mm256_set1_ps( m_max.y );
+    const __m256 maxZ = _mm256_set1_ps( m_max.z );
+
+    int hits = 0;
+
+    for( unsigned int i = 0; i < aPacket.m_NrRays; i += 8 )
+    {
+        const __m256 ox = _mm256_loadu_ps( &aPacket.m_OriginX[i] );
+        const __m256 ix = _mm256_loadu_ps( &aPacket.m_InvDirX[i] );
+        const __m256 x0 = _mm256_mul_ps( _mm256_sub_ps( minX, ox ), ix );
+        const __m256 x1 = _mm256_mul_ps( _mm256_sub_ps( maxX, ox ), ix );
+
+        __m256 t0 = _mm256_max_ps( _mm256_setzero_ps(), _mm256_min_ps( x0, x1 ) );
+        __m256 t1 = _mm256_max_ps( x0, x1 );
+
+        const __m256 oy = _mm256_loadu_ps( &aPacket.m_OriginY[i] );
+        const __m256 iy = _mm256_loadu_ps( &aPacket.m_InvDirY[i] );
+        const __m256 y0 = _mm256_mul_ps( _mm256_sub_ps( minY, oy ), iy );
+        const __m256 y1 = _mm256_mul_ps( _mm256_sub_ps( maxY, oy ), iy );
+
+        t0 = _mm256_max_ps( t0, _mm256_min_ps( y0, y1 ) );
+        t1 = _mm256_min_ps( t1, _mm256_max_ps( y0, y1 ) );
+
+        const __m256 oz = _mm256_loadu_ps( &aPacket.m_OriginZ[i] );
+        const __m256 iz = _mm256_loadu_ps( &aPacket.m_InvDirZ[i] );
+        const __m256 z0 = _mm256_mul_ps( _mm256_sub_ps( minZ, oz ), iz );
+        const __m256 z1 = _mm256_mul_ps( _mm256_sub_ps( maxZ, oz ), iz );
+
+        t0 = _mm256_max_ps( t0, _mm256_min_ps( z0, z1 ) );
+        t1 = _mm256_min_ps( t1, _mm256_max_ps( z0, z1 ) );
+
+        _mm256_storeu_ps( &aOutHitt0[i], t0 );
+        _mm256_storeu_ps( &aOutHitt1[i], t1 );
+
+        hits |= _mm256_movemask_ps( _mm256_cmp_ps( t0, t1, _CMP_LE_OQ ) );
+    }
+
+    return hits != 0;
+#elif FASTMATH_SIMD_WIDTH == 4
+    const __m128 minX = _mm_set1_ps( m_min.x );
+    const __m128 minY = _mm_set1_ps( m_min.y );
+    const __m128 minZ = _mm_set1_ps( m_min.z );
+    const __m128 maxX = _mm_set1_ps( m_max.x );
+    const __m128 maxY = _mm_set1_ps( m_max.y );
+    const __m128 maxZ = _mm_set1_ps( m_max.z );
+
+    int hits = 0;
+
+    for( unsigned int i = 0; i < aPacket.m_NrRays; i += 4 )
+    {
+        const __m128 ox = _mm_loadu_ps( &aPacket.m_OriginX[i] );
+        const __m128 ix = _mm_loadu_ps( &aPacket.m_InvDirX[i] );
+        const __m128 x0 = _mm_mul_ps( _mm_sub_ps( minX, ox ), ix );
+        const __m128 x1 = _mm_mul_ps( _mm_sub_ps( maxX, ox ), ix );
+
+        __m128 t0 = _mm_max_ps( _mm_setzero_ps(), _mm_min_ps( x0, x1 ) );
+        __m128 t1 = _mm_max_ps( x0, x1 );
+
+        const __m128 oy = _mm_loadu_ps( &aPacket.m_OriginY[i] );
+        const __m128 iy = _mm_loadu_ps( &aPacket.m_InvDirY[i] );
+        const __m128 y0 = _mm_mul_ps( _mm_sub_ps( minY, oy ), iy );
+        const __m128 y1 = _mm_mul_ps( _mm_sub_ps( maxY, oy ), iy );
+
+        t0 = _mm_max_ps( t0, _mm_min_ps( y0, y1 ) );
+        t1 = _mm_min_ps( t1, _mm_max_ps( y0, y1 ) );
+
+        const __m128 oz = _mm_loadu_ps( &aPacket.m_OriginZ[i] );
+        const __m128 iz = _mm_loadu_ps( &aPacket.m_InvDirZ[i] );
+        const __m128 z0 = _mm_mul_ps( _mm_sub_ps( minZ, oz ), iz );
+        const __m128 z1 = _mm_mul_ps( _mm_sub_ps( maxZ, oz ), iz );
+
+        t0 = _mm_max_ps( t0, _mm_min_ps( z0, z1 ) );
+        t1 = _mm_min_ps( t1, _mm_max_ps( z0, z1 ) );
+
+        _mm_storeu_ps( &aOutHitt0[i], t0 );
+        _mm_storeu_ps( &aOutHitt1[i], t1 );
+
+        hits |= _mm_movemask_ps( _mm_cmple_ps( t0, t1 ) );
+    }
+
+    return hits != 0;
+#else
+    bool hits = false;
+
+    for( unsigned int i = 0; i < aPacket.m_NrRays; ++i )
+    {
+        const float x0 = ( m_min.x - aPacket.m_OriginX[i] ) * aPacket.m_InvDirX[i];
+        const float x1 = ( m_max.x - aPacket.m_OriginX[i] ) * aPacket.m_InvDirX[i];
+        const float y0 = ( m_min.y - aPacket.m_OriginY[i] ) * aPacket.m_InvDirY[i];
+        const float y1 = ( m_max.y - aPacket.m_OriginY[i] ) * aPacket.m_InvDirY[i];
+        const float z0 = ( m_min.z - aPacket.m_OriginZ[i] ) * aPacket.m_InvDirZ[i];
+        const float z1 = ( m_max.z - aPacket.m_OriginZ[i] ) * aPacket.m_InvDirZ[i];
+
+        const float t0 = std::max( std::max( 0.0f, std::min( x0, x1 ) ),
+                                   std::max( std::min( y0, y1 ), std::min( z0, z1 ) ) );
+        const float t1 = std::min( std::max( x0, x1 ),
+                                   std::min( std::max( y0, y1 ), std::max( z0, z1 ) ) );
+
+        aOutHitt0[i] = t0;
+        aOutHitt1[i] = t1;
+
+        hits = hits || ( t0 <= t1 );
+    }
+
+    return hits;
+#endif
+}
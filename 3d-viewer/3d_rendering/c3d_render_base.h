@@ -56,6 +56,14 @@ public:
 
     void ReloadRequest() { m_reloadRequested = true; }
 
+    /**
+     * @brief ReloadRequest - request the rebuild of the render data of a single layer,
+     * after its 2D items in the settings were updated, or its color or visibility
+     * changed. A render without an incremental rebuild reloads the whole board.
+     * @param aLayerId: the layer to rebuild
+     */
+    virtual void ReloadRequest( LAYER_ID aLayerId ) { (void) aLayerId; ReloadRequest(); }
+
     // Attributes
 
 protected:
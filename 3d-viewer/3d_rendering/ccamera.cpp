@@ -30,6 +30,7 @@
 #include <cstring>
 #include "../common_ogl/openGL_includes.h"
 #include "ccamera.h"
+#include "3d_render_raytracing/shapes3D/cbbox.h"
 #include <wx/log.h>
 
 
@@ -217,6 +218,27 @@ void CCAMERA::MakeRay( const SFVEC2I &aWindowPos, SFVEC3F &aOutOrigin, SFVEC3F &
 }
 
 
+float CCAMERA::GetScreenSize( const CBBOX &aBBox ) const
+{
+    const SFVEC3F center = aBBox.GetCenter();
+    const float   radius = glm::length( aBBox.GetExtent() ) * 0.5f;
+    const glm::mat4 viewProjection = m_projectionMatrix * m_viewMatrix;
+
+    // the sphere radius is measured across the view, along the up vector
+    const glm::vec4 c0 = viewProjection * glm::vec4( center, 1.0f );
+    const glm::vec4 c1 = viewProjection * glm::vec4( center + m_up * radius, 1.0f );
+
+    if( ( c0.w <= 0.0f ) || ( c1.w <= 0.0f ) )
+        return 0.0f;
+
+    const SFVEC2F ndc0 = SFVEC2F( c0.x, c0.y ) / c0.w;
+    const SFVEC2F ndc1 = SFVEC2F( c1.x, c1.y ) / c1.w;
+
+    // the normalized device coordinates span 2 units on the window height
+    return glm::length( ndc1 - ndc0 ) * (float)m_windowSize.y;
+}
+
+
 void CCAMERA::GLdebug_Lines()
 {
     SFVEC3F ntl = m_frustum.ntl;
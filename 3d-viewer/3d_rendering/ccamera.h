@@ -35,6 +35,8 @@
 #include <wx/gdicmn.h>                                                          // for wxSize
 #include <vector>
 
+class CBBOX;
+
 enum PROJECTION_TYPE
 {
     PROJECTION_ORTHO,
@@ -145,6 +147,13 @@ class CCAMERA
 
     void MakeRay( const SFVEC2I &aWindowPos, SFVEC3F &aOutOrigin, SFVEC3F &aOutDirection ) const;
 
+    /**
+     *  Function GetScreenSize
+     *  @return the projected size in pixels of the bounding sphere of aBBox, on the
+     *  window height, or 0 if it is behind the camera
+     */
+    float GetScreenSize( const CBBOX &aBBox ) const;
+
     void GLdebug_Lines();
 
     void GLdebug_Planes();
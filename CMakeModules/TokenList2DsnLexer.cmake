@@ -240,6 +240,9 @@ class ${LEXERCLASS} : public DSNLEXER
     static const KEYWORD  keywords[];
     static const unsigned keyword_count;
 
+    /// Perfect hash of the keywords, built once for all the lexer instances
+    static const KEYWORD_HASH keyword_hash;
+
 public:
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -248,7 +251,7 @@ public:
      *   If left empty, then _(\"clipboard\") is used.
      */
     ${LEXERCLASS}( const std::string& aSExpression, const wxString& aSource = wxEmptyString ) :
-        DSNLEXER( keywords, keyword_count, aSExpression, aSource )
+        DSNLEXER( keywords, keyword_count, aSExpression, aSource, &keyword_hash )
     {
     }
 
@@ -262,7 +265,7 @@ public:
      * @param aFilename is the name of the opened file, needed for error reporting.
      */
     ${LEXERCLASS}( FILE* aFile, const wxString& aFilename ) :
-        DSNLEXER( keywords, keyword_count, aFile, aFilename )
+        DSNLEXER( keywords, keyword_count, aFile, aFilename, &keyword_hash )
     {
     }
 
@@ -278,7 +281,7 @@ public:
      *  STRING_LINE_READER or FILE_LINE_READER.  No ownership is taken of aLineReader.
      */
     ${LEXERCLASS}( LINE_READER* aLineReader ) :
-        DSNLEXER( keywords, keyword_count, aLineReader )
+        DSNLEXER( keywords, keyword_count, aLineReader, &keyword_hash )
     {
     }
 
@@ -288,6 +291,12 @@ public:
      */
     static const char* TokenName( ${enum}::T aTok );
 
+    /**
+     * Function KeywordHash
+     * returns the perfect hash of the keywords, to find them out of a lexer, see SEXPR_DOM.
+     */
+    static const KEYWORD_HASH* KeywordHash() { return &keyword_hash; }
+
     /**
      * Function NextTok
      * returns the next token found in the input file or T_EOF when reaching
@@ -369,6 +378,8 @@ file( APPEND "${outCppFile}"
 
 const unsigned ${LEXERCLASS}::keyword_count = unsigned( sizeof( ${LEXERCLASS}::keywords )/sizeof( ${LEXERCLASS}::keywords[0] ) );
 
+const KEYWORD_HASH ${LEXERCLASS}::keyword_hash( ${LEXERCLASS}::keywords, ${LEXERCLASS}::keyword_count );
+
 
 const char* ${LEXERCLASS}::TokenName( T aTok )
 {
@@ -69,6 +69,9 @@
 /// When defined, build the GITHUB_PLUGIN for pcbnew.
 #cmakedefine BUILD_GITHUB_PLUGIN
 
+/// When defined, hash the 3D model files with xxHash64 instead of SHA1.
+#cmakedefine KICAD_3D_FAST_HASH
+
 /// When defined, use KIWAY and KIFACE DSOs
 #cmakedefine USE_KIWAY_DLLS
 
@@ -39,6 +39,11 @@
 #include "bitmap2component.h"
 
 
+/// The number of groups of paths converted at once by CreateOutputFile(), which bounds
+/// the memory used by the polygons waiting to be written
+#define GROUPS_PER_BATCH    256
+
+
 /* free a potrace bitmap */
 static void bm_free( potrace_bitmap_t* bm )
 {
@@ -103,6 +108,16 @@ private:
      */
     void OuputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char* aBrdLayerName );
 
+    /**
+     * Function buildGroupPolygons
+     * converts a group of paths, a positive path and its negative children, to the
+     * polygons to output: the outline of the positive path minus its holes, fractured.
+     * It only reads the paths, so the groups can be converted concurrently.
+     * @param aGroup is the first path of the group, the positive one
+     * @param aPolygons [out] receives the polygons of the group
+     */
+    void buildGroupPolygons( potrace_path_t* aGroup, SHAPE_POLY_SET& aPolygons ) const;
+
 };
 
 static void BezierToPolyline( std::vector <potrace_dpoint_t>& aCornersBuffer,
@@ -409,32 +424,22 @@ void BITMAPCONV_INFO::OuputOnePolygon( SHAPE_LINE_CHAIN & aPolygon, const char*
 }
 
 
-void BITMAPCONV_INFO::CreateOutputFile( BMP2CMP_MOD_LAYER aModLayer )
+void BITMAPCONV_INFO::buildGroupPolygons( potrace_path_t* aGroup,
+                                          SHAPE_POLY_SET& aPolygons ) const
 {
     std::vector <potrace_dpoint_t> cornersBuffer;
 
-    // polyset_areas is a set of polygon to draw
-    SHAPE_POLY_SET polyset_areas;
-
-    // polyset_holes is the set of holes inside polyset_areas outlines
+    // polyset_holes is the set of holes inside aPolygons outlines
     SHAPE_POLY_SET polyset_holes;
 
     potrace_dpoint_t( *c )[3];
 
-    LOCALE_IO toggle;   // Temporary switch the locale to standard C to r/w floats
-
-    // The layer name has meaning only for .kicad_mod files.
-    // For these files the header creates 2 invisible texts: value and ref
-    // (needed but not usefull) on silk screen layer
-    OuputFileHeader( getBrdLayerName( MOD_LYR_FSILKS ) );
-
     bool main_outline = true;
 
     /* draw each as a polygon with no hole.
      * Bezier curves are approximated by a polyline
      */
-    potrace_path_t* paths = m_Paths;    // the list of paths
-    while( paths != NULL )
+    for( potrace_path_t* paths = aGroup; paths != NULL; paths = paths->next )
     {
         int cnt  = paths->curve.n;
         int* tag = paths->curve.tag;
@@ -463,11 +468,11 @@ void BITMAPCONV_INFO::CreateOutputFile( BMP2CMP_MOD_LAYER aModLayer )
             main_outline = false;
 
             // build the current main polygon
-            polyset_areas.NewOutline();
+            aPolygons.NewOutline();
             for( unsigned int i = 0; i < cornersBuffer.size(); i++ )
             {
-                polyset_areas.Append( int( cornersBuffer[i].x * m_ScaleX ),
-                                      int( cornersBuffer[i].y * m_ScaleY ) );
+                aPolygons.Append( int( cornersBuffer[i].x * m_ScaleX ),
+                                  int( cornersBuffer[i].y * m_ScaleY ) );
             }
         }
         else
@@ -483,28 +488,63 @@ void BITMAPCONV_INFO::CreateOutputFile( BMP2CMP_MOD_LAYER aModLayer )
 
         cornersBuffer.clear();
 
-        /* at the end of a group of a positive path and its negative children, fill.
-         */
+        // the group ends before the next positive path
         if( paths->next == NULL || paths->next->sign == '+' )
+            break;
+    }
+
+    // Substract holes to main polygon:
+    aPolygons.Simplify( SHAPE_POLY_SET::PM_FAST );
+    polyset_holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+    aPolygons.BooleanSubtract( polyset_holes, SHAPE_POLY_SET::PM_FAST );
+    aPolygons.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+}
+
+
+void BITMAPCONV_INFO::CreateOutputFile( BMP2CMP_MOD_LAYER aModLayer )
+{
+    LOCALE_IO toggle;   // Temporary switch the locale to standard C to r/w floats
+
+    // The layer name has meaning only for .kicad_mod files.
+    // For these files the header creates 2 invisible texts: value and ref
+    // (needed but not usefull) on silk screen layer
+    OuputFileHeader( getBrdLayerName( MOD_LYR_FSILKS ) );
+
+    // The groups of a positive path and its negative children, by their first path
+    std::vector<potrace_path_t*> groups;
+
+    for( potrace_path_t* paths = m_Paths; paths != NULL; paths = paths->next )
+    {
+        if( paths == m_Paths || paths->sign == '+' )
+            groups.push_back( paths );
+    }
+
+    // The groups are independent, a batch of them is converted on the threads of
+    // OpenMP, then written in the order of the paths, before the next batch
+    std::vector<SHAPE_POLY_SET> polygons;
+
+    for( unsigned first = 0; first < groups.size(); first += GROUPS_PER_BATCH )
+    {
+        int count = std::min( (int) ( groups.size() - first ), GROUPS_PER_BATCH );
+
+        polygons.clear();
+        polygons.resize( count );
+
+#ifdef USE_OPENMP
+        #pragma omp parallel for schedule( dynamic )
+#endif
+        for( int i = 0; i < count; i++ )
+            buildGroupPolygons( groups[first + i], polygons[i] );
+
+        // Output current resulting polygon(s)
+        for( int i = 0; i < count; i++ )
         {
-            // Substract holes to main polygon:
-            polyset_areas.Simplify( SHAPE_POLY_SET::PM_FAST );
-            polyset_holes.Simplify( SHAPE_POLY_SET::PM_FAST );
-            polyset_areas.BooleanSubtract( polyset_holes, SHAPE_POLY_SET::PM_FAST );
-            polyset_areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
-
-            // Output current resulting polygon(s)
-            for( int ii = 0; ii < polyset_areas.OutlineCount(); ii++ )
+            for( int ii = 0; ii < polygons[i].OutlineCount(); ii++ )
             {
-                SHAPE_LINE_CHAIN& poly = polyset_areas.Outline( ii );
+                SHAPE_LINE_CHAIN& poly = polygons[i].Outline( ii );
                 OuputOnePolygon(poly, getBrdLayerName( aModLayer ) );
             }
-
-            polyset_areas.RemoveAllContours();
-            polyset_holes.RemoveAllContours();
-            main_outline = true;
         }
-        paths = paths->next;
     }
 
     OuputFileEnd();
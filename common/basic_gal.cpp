@@ -40,6 +40,7 @@
 using namespace KIGFX;
 
 BASIC_GAL basic_gal;
+boost::recursive_mutex basic_gal_lock;
 
 const VECTOR2D BASIC_GAL::transform( const VECTOR2D& aPoint ) const
 {
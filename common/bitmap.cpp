@@ -23,6 +23,8 @@
  */
 
 
+#include <map>
+
 #include <wx/image.h>
 #include <wx/bitmap.h>
 #include <wx/mstream.h>
@@ -30,16 +32,44 @@
 #include <bitmaps.h>
 
 
-wxBitmap KiBitmap( BITMAP_DEF aBitmap )
+/// The bitmaps decoded from their memory record, by record
+typedef std::map<BITMAP_DEF, wxBitmap> BITMAP_CACHE;
+
+
+static BITMAP_CACHE& bitmapCache()
 {
-    wxMemoryInputStream is( aBitmap->png, aBitmap->byteCount );
+    // Never freed: the bitmaps cannot be destroyed after the GUI toolkit at exit
+    static BITMAP_CACHE* cache = new BITMAP_CACHE;
 
-    return wxBitmap( wxImage( is, wxBITMAP_TYPE_PNG, -1 ), -1 );
+    return *cache;
 }
 
-wxBitmap* KiBitmapNew( BITMAP_DEF aBitmap )
+
+static const wxBitmap& cachedBitmap( BITMAP_DEF aBitmap )
 {
-    wxMemoryInputStream is( aBitmap->png, aBitmap->byteCount );
+    // Only used on the GUI thread, as the bitmaps themselves
+    BITMAP_CACHE&           cache = bitmapCache();
+    BITMAP_CACHE::iterator  it = cache.find( aBitmap );
+
+    if( it == cache.end() )
+    {
+        wxMemoryInputStream is( aBitmap->png, aBitmap->byteCount );
 
-    return new wxBitmap( wxImage( is, wxBITMAP_TYPE_PNG, -1 ), -1 );
+        it = cache.insert( std::make_pair( aBitmap,
+                                           wxBitmap( wxImage( is, wxBITMAP_TYPE_PNG, -1 ),
+                                                     -1 ) ) ).first;
+    }
+
+    return it->second;
+}
+
+
+wxBitmap KiBitmap( BITMAP_DEF aBitmap )
+{
+    return cachedBitmap( aBitmap );
+}
+
+wxBitmap* KiBitmapNew( BITMAP_DEF aBitmap )
+{
+    return new wxBitmap( cachedBitmap( aBitmap ) );
 }
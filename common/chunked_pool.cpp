@@ -0,0 +1,118 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file chunked_pool.cpp
+ */
+
+#include <algorithm>
+#include <new>
+
+#include <chunked_pool.h>
+
+
+// The granularity of the slot sizes, enough to align any member of the pooled items
+static const size_t s_sizeStep = 16;
+
+// The number of pools of ForSize(), one per multiple of s_sizeStep
+static const size_t s_poolCount = CHUNKED_POOL::MAX_POOLED_SIZE / s_sizeStep;
+
+
+CHUNKED_POOL::CHUNKED_POOL( size_t aSlotSize, size_t aChunkSize ) :
+    m_freeSlots( NULL ),
+    m_nextSlot( NULL ),
+    m_chunkEnd( NULL )
+{
+    // A slot holds the free list link once freed, and keeps the alignment of the items
+    m_slotSize = std::max( aSlotSize, sizeof( FREE_SLOT ) );
+    m_slotSize = ( m_slotSize + s_sizeStep - 1 ) / s_sizeStep * s_sizeStep;
+    m_slotsPerChunk = std::max( aChunkSize / m_slotSize, (size_t) 1 );
+}
+
+
+CHUNKED_POOL::~CHUNKED_POOL()
+{
+    for( unsigned i = 0; i < m_chunks.size(); ++i )
+        delete[] m_chunks[i];
+}
+
+
+void* CHUNKED_POOL::Allocate()
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    if( m_freeSlots )
+    {
+        FREE_SLOT* slot = m_freeSlots;
+
+        m_freeSlots = slot->m_next;
+        return slot;
+    }
+
+    if( m_nextSlot == m_chunkEnd )
+    {
+        // operator new[] of char gives memory aligned for any object
+        char* chunk = new char[ m_slotSize * m_slotsPerChunk ];
+
+        m_chunks.push_back( chunk );
+        m_nextSlot = chunk;
+        m_chunkEnd = chunk + m_slotSize * m_slotsPerChunk;
+    }
+
+    void* slot = m_nextSlot;
+
+    m_nextSlot += m_slotSize;
+
+    return slot;
+}
+
+
+void CHUNKED_POOL::Free( void* aSlot )
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    FREE_SLOT* slot = static_cast<FREE_SLOT*>( aSlot );
+
+    slot->m_next = m_freeSlots;
+    m_freeSlots = slot;
+}
+
+
+CHUNKED_POOL* CHUNKED_POOL::ForSize( size_t aSize )
+{
+    // Created on first use, and intentionally never destroyed: see the class comment
+    static CHUNKED_POOL* pools[s_poolCount];
+    static boost::mutex  poolsLock;
+
+    if( aSize == 0 || aSize > MAX_POOLED_SIZE )
+        return NULL;
+
+    size_t index = ( aSize - 1 ) / s_sizeStep;
+
+    boost::mutex::scoped_lock lock( poolsLock );
+
+    if( !pools[index] )
+        pools[index] = new CHUNKED_POOL( ( index + 1 ) * s_sizeStep );
+
+    return pools[index];
+}
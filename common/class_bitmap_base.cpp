@@ -231,6 +231,9 @@ void BITMAP_BASE::DrawBitmap( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint&
     pos.x -= size.x / 2;
     pos.y -= size.y / 2;
 
+    // The lines batched before the bitmap are drawn below it, with the DC coordinates
+    GRFlushLineBatch( aDC );
+
     double scale;
     int    logicalOriginX, logicalOriginY;
     aDC->GetUserScale( &scale, &scale );
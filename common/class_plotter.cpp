@@ -445,6 +445,14 @@ void PLOTTER::sketchOval( const wxPoint& pos, const wxSize& aSize, double orient
 }
 
 
+void PLOTTER::PlotPolys( const std::vector< std::vector< wxPoint > >& aPolygons,
+                         FILL_T aFill, int aWidth )
+{
+    for( unsigned ii = 0; ii < aPolygons.size(); ii++ )
+        PlotPoly( aPolygons[ii], aFill, aWidth );
+}
+
+
 void PLOTTER::ThickSegment( const wxPoint& start, const wxPoint& end, int width,
                             EDA_DRAW_MODE_T tracemode )
 {
@@ -38,12 +38,20 @@
 #include <confirm.h>
 #include <base_units.h>
 #include <reporter.h>
+#include <ki_mutex.h>
 
 #include <wx/process.h>
 #include <wx/config.h>
 #include <wx/utils.h>
 #include <wx/stdpaths.h>
 
+#include <clocale>
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
+#include <boost/thread/tss.hpp>
+
 #include <pgm_base.h>
 
 
@@ -68,32 +76,61 @@ EDA_COLOR_T    g_GhostColor;
  * is thrown, or not.
  */
 
-int LOCALE_IO::m_c_count = 0;
+// The count of the LOCALE_IO objects of each thread
+static boost::thread_specific_ptr<int> localeNesting;
+
+static int& threadLocaleNesting()
+{
+    if( !localeNesting.get() )
+        localeNesting.reset( new int( 0 ) );
+
+    return *localeNesting;
+}
+
+
+#if !defined( _WIN32 )
+static locale_t cLocale()
+{
+    // created once, and never freed
+    static locale_t locale = newlocale( LC_ALL_MASK, "C", (locale_t) 0 );
+
+    return locale;
+}
+#endif
+
 
 LOCALE_IO::LOCALE_IO()
 {
-    wxASSERT_MSG( m_c_count >= 0, wxT( "LOCALE_IO::m_c_count mismanaged." ) );
+#if defined( _WIN32 )
+    // setlocale() then only changes the locale of this thread
+    m_threadLocaleMode = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
+    m_user_locale = setlocale( LC_ALL, 0 );
+    setlocale( LC_ALL, "C" );
+#else
+    m_user_locale = uselocale( cLocale() );
+#endif
 
-    // use thread safe, atomic operation
-    if( __sync_fetch_and_add( &m_c_count, 1 ) == 0 )
-    {
-        // Store the user locale name, to restore this locale later, in dtor
-        m_user_locale = setlocale( LC_ALL, 0 );
-        // Switch the locale to C locale, to read/write files with fp numbers
-        setlocale( LC_ALL, "C" );
-    }
+    ++threadLocaleNesting();
 }
 
 LOCALE_IO::~LOCALE_IO()
 {
-    // use thread safe, atomic operation
-    if( __sync_sub_and_fetch( &m_c_count, 1 ) == 0 )
-    {
-        // revert to the user locale
-        setlocale( LC_ALL, m_user_locale.c_str() );
-    }
+#if defined( _WIN32 )
+    setlocale( LC_ALL, m_user_locale.c_str() );
+    _configthreadlocale( m_threadLocaleMode );
+#else
+    uselocale( (locale_t) m_user_locale );
+#endif
 
-    wxASSERT_MSG( m_c_count >= 0, wxT( "LOCALE_IO::m_c_count mismanaged." ) );
+    wxASSERT_MSG( threadLocaleNesting() > 0, wxT( "LOCALE_IO nesting mismanaged." ) );
+
+    --threadLocaleNesting();
+}
+
+
+bool LOCALE_IO::IsActive()
+{
+    return threadLocaleNesting() > 0;
 }
 
 
@@ -396,7 +433,6 @@ wxString GetKicadConfigPath()
 }
 
 
-#include <ki_mutex.h>
 const wxString ExpandEnvVarSubstitutions( const wxString& aString )
 {
     // wxGetenv( wchar_t* ) is not re-entrant on linux.
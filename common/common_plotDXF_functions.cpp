@@ -31,6 +31,7 @@
 #include <wxstruct.h>
 #include <base_struct.h>
 #include <plot_common.h>
+#include <numeric_io.h>
 #include <macros.h>
 #include <kicad_string.h>
 #include <convert_basic_shapes_to_polygon.h>
@@ -139,42 +140,42 @@ bool DXF_PLOTTER::StartPlot()
     static const char *style_name[4] = {"KICAD", "KICADB", "KICADI", "KICADBI"};
     for(int i = 0; i < 4; i++ )
     {
-        fprintf( outputFile,
-                 "  0\n"
-                 "STYLE\n"
-                 "  2\n"
-                 "%s\n"         // Style name
-                 "  70\n"
-                 "0\n"          // Standard flags
-                 "  40\n"
-                 "0\n"          // Non-fixed height text
-                 "  41\n"
-                 "1\n"          // Width factor (base)
-                 "  42\n"
-                 "1\n"          // Last height (mandatory)
-                 "  50\n"
-                 "%g\n"         // Oblique angle
-                 "  71\n"
-                 "0\n"          // Generation flags (default)
-                 "  3\n"
-                 // The standard ISO font (when kicad is build with it
-                 // the dxf text in acad matches *perfectly*)
-                 "isocp.shx\n", // Font name (when not bigfont)
-                 // Apply a 15 degree angle to italic text
-                 style_name[i], i < 2 ? 0 : DXF_OBLIQUE_ANGLE );
+        KiFprintf( outputFile,
+                   "  0\n"
+                   "STYLE\n"
+                   "  2\n"
+                   "%s\n"         // Style name
+                   "  70\n"
+                   "0\n"          // Standard flags
+                   "  40\n"
+                   "0\n"          // Non-fixed height text
+                   "  41\n"
+                   "1\n"          // Width factor (base)
+                   "  42\n"
+                   "1\n"          // Last height (mandatory)
+                   "  50\n"
+                   "%g\n"         // Oblique angle
+                   "  71\n"
+                   "0\n"          // Generation flags (default)
+                   "  3\n"
+                   // The standard ISO font (when kicad is build with it
+                   // the dxf text in acad matches *perfectly*)
+                   "isocp.shx\n", // Font name (when not bigfont)
+                   // Apply a 15 degree angle to italic text
+                   style_name[i], i < 2 ? 0 : DXF_OBLIQUE_ANGLE );
     }
 
 
     // Layer table - one layer per color
-    fprintf( outputFile,
-             "  0\n"
-             "ENDTAB\n"
-             "  0\n"
-             "TABLE\n"
-             "  2\n"
-             "LAYER\n"
-             "  70\n"
-             "%d\n", NBCOLORS );
+    KiFprintf( outputFile,
+               "  0\n"
+               "ENDTAB\n"
+               "  0\n"
+               "TABLE\n"
+               "  2\n"
+               "LAYER\n"
+               "  70\n"
+               "%d\n", NBCOLORS );
 
     /* The layer/colors palette. The acad/DXF palette is divided in 3 zones:
 
@@ -228,18 +229,18 @@ bool DXF_PLOTTER::StartPlot()
 
     for( EDA_COLOR_T i = BLACK; i < NBCOLORS; i = NextColor(i) )
     {
-        fprintf( outputFile,
-                 "  0\n"
-                 "LAYER\n"
-                 "  2\n"
-                 "%s\n"         // Layer name
-                 "  70\n"
-                 "0\n"          // Standard flags
-                 "  62\n"
-                 "%d\n"         // Color number
-                 "  6\n"
-                 "CONTINUOUS\n",// Linetype name
-                 dxf_layer[i].name, dxf_layer[i].color );
+        KiFprintf( outputFile,
+                   "  0\n"
+                   "LAYER\n"
+                   "  2\n"
+                   "%s\n"         // Layer name
+                   "  70\n"
+                   "0\n"          // Standard flags
+                   "  62\n"
+                   "%d\n"         // Color number
+                   "  6\n"
+                   "CONTINUOUS\n",// Linetype name
+                   dxf_layer[i].name, dxf_layer[i].color );
     }
 
     // End of layer table, begin entities
@@ -318,23 +319,23 @@ void DXF_PLOTTER::Circle( const wxPoint& centre, int diameter, FILL_T fill, int
         wxString cname( ColorGetName( m_currentColor ) );
         if (!fill)
         {
-            fprintf( outputFile, "0\nCIRCLE\n8\n%s\n10\n%g\n20\n%g\n40\n%g\n",
-                    TO_UTF8( cname ),
-                    centre_dev.x, centre_dev.y, radius );
+            KiFprintf( outputFile, "0\nCIRCLE\n8\n%s\n10\n%g\n20\n%g\n40\n%g\n",
+                      TO_UTF8( cname ),
+                      centre_dev.x, centre_dev.y, radius );
         }
         if (fill == FILLED_SHAPE)
         {
             double r = radius*0.5;
-            fprintf( outputFile, "0\nPOLYLINE\n");
-            fprintf( outputFile, "8\n%s\n66\n1\n70\n1\n", TO_UTF8( cname ));
-            fprintf( outputFile, "40\n%g\n41\n%g\n", radius, radius);
-            fprintf( outputFile, "0\nVERTEX\n8\n%s\n", TO_UTF8( cname ));
-            fprintf( outputFile, "10\n%g\n 20\n%g\n42\n1.0\n",
-                    centre_dev.x-r, centre_dev.y );
-            fprintf( outputFile, "0\nVERTEX\n8\n%s\n", TO_UTF8( cname ));
-            fprintf( outputFile, "10\n%g\n 20\n%g\n42\n1.0\n",
-                    centre_dev.x+r, centre_dev.y );
-            fprintf( outputFile, "0\nSEQEND\n");
+            KiFprintf( outputFile, "0\nPOLYLINE\n");
+            KiFprintf( outputFile, "8\n%s\n66\n1\n70\n1\n", TO_UTF8( cname ));
+            KiFprintf( outputFile, "40\n%g\n41\n%g\n", radius, radius);
+            KiFprintf( outputFile, "0\nVERTEX\n8\n%s\n", TO_UTF8( cname ));
+            KiFprintf( outputFile, "10\n%g\n 20\n%g\n42\n1.0\n",
+                      centre_dev.x-r, centre_dev.y );
+            KiFprintf( outputFile, "0\nVERTEX\n8\n%s\n", TO_UTF8( cname ));
+            KiFprintf( outputFile, "10\n%g\n 20\n%g\n42\n1.0\n",
+                      centre_dev.x+r, centre_dev.y );
+            KiFprintf( outputFile, "0\nSEQEND\n");
         }
     }
 }
@@ -463,9 +464,9 @@ void DXF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     {
         // DXF LINE
         wxString cname( ColorGetName( m_currentColor ) );
-        fprintf( outputFile, "0\nLINE\n8\n%s\n10\n%g\n20\n%g\n11\n%g\n21\n%g\n",
-                 TO_UTF8( cname ),
-                 pen_lastpos_dev.x, pen_lastpos_dev.y, pos_dev.x, pos_dev.y );
+        KiFprintf( outputFile, "0\nLINE\n8\n%s\n10\n%g\n20\n%g\n11\n%g\n21\n%g\n",
+                   TO_UTF8( cname ),
+                   pen_lastpos_dev.x, pen_lastpos_dev.y, pos_dev.x, pos_dev.y );
     }
     penLastpos = pos;
 }
@@ -510,11 +511,11 @@ void DXF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
 
     // Emit a DXF ARC entity
     wxString cname( ColorGetName( m_currentColor ) );
-    fprintf( outputFile,
-             "0\nARC\n8\n%s\n10\n%g\n20\n%g\n40\n%g\n50\n%g\n51\n%g\n",
-             TO_UTF8( cname ),
-             centre_dev.x, centre_dev.y, radius_dev,
-             StAngle / 10.0, EndAngle / 10.0 );
+    KiFprintf( outputFile,
+               "0\nARC\n8\n%s\n10\n%g\n20\n%g\n40\n%g\n50\n%g\n51\n%g\n",
+               TO_UTF8( cname ),
+               centre_dev.x, centre_dev.y, radius_dev,
+               StAngle / 10.0, EndAngle / 10.0 );
 }
 
 /**
@@ -759,45 +760,45 @@ void DXF_PLOTTER::Text( const wxPoint&              aPos,
         // Position, size, rotation and alignment
         // The two alignment point usages is somewhat idiot (see the DXF ref)
         // Anyway since we don't use the fit/aligned options, they're the same
-        fprintf( outputFile,
-                "  0\n"
-                "TEXT\n"
-                "  7\n"
-                "%s\n"          // Text style
-                "  8\n"
-                "%s\n"          // Layer name
-                "  10\n"
-                "%g\n"          // First point X
-                "  11\n"
-                "%g\n"          // Second point X
-                "  20\n"
-                "%g\n"          // First point Y
-                "  21\n"
-                "%g\n"          // Second point Y
-                "  40\n"
-                "%g\n"          // Text height
-                "  41\n"
-                "%g\n"          // Width factor
-                "  50\n"
-                "%g\n"          // Rotation
-                "  51\n"
-                "%g\n"          // Oblique angle
-                "  71\n"
-                "%d\n"          // Mirror flags
-                "  72\n"
-                "%d\n"          // H alignment
-                "  73\n"
-                "%d\n",         // V alignment
-                aBold ? (aItalic ? "KICADBI" : "KICADB")
-                      : (aItalic ? "KICADI" : "KICAD"),
-                TO_UTF8( cname ),
-                origin_dev.x, origin_dev.x,
-                origin_dev.y, origin_dev.y,
-                size_dev.y, fabs( size_dev.x / size_dev.y ),
-                aOrient / 10.0,
-                aItalic ? DXF_OBLIQUE_ANGLE : 0,
-                size_dev.x < 0 ? 2 : 0, // X mirror flag
-                h_code, v_code );
+        KiFprintf( outputFile,
+                  "  0\n"
+                  "TEXT\n"
+                  "  7\n"
+                  "%s\n"          // Text style
+                  "  8\n"
+                  "%s\n"          // Layer name
+                  "  10\n"
+                  "%g\n"          // First point X
+                  "  11\n"
+                  "%g\n"          // Second point X
+                  "  20\n"
+                  "%g\n"          // First point Y
+                  "  21\n"
+                  "%g\n"          // Second point Y
+                  "  40\n"
+                  "%g\n"          // Text height
+                  "  41\n"
+                  "%g\n"          // Width factor
+                  "  50\n"
+                  "%g\n"          // Rotation
+                  "  51\n"
+                  "%g\n"          // Oblique angle
+                  "  71\n"
+                  "%d\n"          // Mirror flags
+                  "  72\n"
+                  "%d\n"          // H alignment
+                  "  73\n"
+                  "%d\n",         // V alignment
+                  aBold ? (aItalic ? "KICADBI" : "KICADB")
+                        : (aItalic ? "KICADI" : "KICAD"),
+                  TO_UTF8( cname ),
+                  origin_dev.x, origin_dev.x,
+                  origin_dev.y, origin_dev.y,
+                  size_dev.y, fabs( size_dev.x / size_dev.y ),
+                  aOrient / 10.0,
+                  aItalic ? DXF_OBLIQUE_ANGLE : 0,
+                  size_dev.x < 0 ? 2 : 0, // X mirror flag
+                  h_code, v_code );
 
         /* There are two issue in emitting the text:
            - Our overline character (~) must be converted to the appropriate
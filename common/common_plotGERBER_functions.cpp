@@ -34,6 +34,7 @@
 #include <base_struct.h>
 #include <common.h>
 #include <plot_common.h>
+#include <numeric_io.h>
 #include <macros.h>
 #include <kicad_string.h>
 #include <convert_basic_shapes_to_polygon.h>
@@ -56,6 +57,10 @@ GERBER_PLOTTER::GERBER_PLOTTER()
     // happen easily.
     m_gerberUnitInch = false;
     m_gerberUnitFmt = 6;
+
+    m_optimizeOutput = false;
+    m_inRegion = false;
+    m_lastPosValid = false;
 }
 
 
@@ -96,9 +101,34 @@ void GERBER_PLOTTER::SetGerberCoordinatesFormat( int aResolution, bool aUseInche
 
 void GERBER_PLOTTER::emitDcode( const DPOINT& pt, int dcode )
 {
+    wxPoint pos( KiROUND( pt.x ), KiROUND( pt.y ) );
+
+    if( !m_optimizeOutput )
+    {
+        KiFprintf( outputFile, "X%dY%dD%02d*\n", pos.x, pos.y, dcode );
+    }
+    else
+    {
+        // Coordinates are modal: only the ones changed since the last operation
+        // are written
+        if( !m_lastPosValid || pos.x != m_lastPos.x )
+            KiFprintf( outputFile, "X%d", pos.x );
 
-    fprintf( outputFile, "X%dY%dD%02d*\n",
-	    KiROUND( pt.x ), KiROUND( pt.y ), dcode );
+        if( !m_lastPosValid || pos.y != m_lastPos.y )
+            KiFprintf( outputFile, "Y%d", pos.y );
+
+        KiFprintf( outputFile, "D%02d*\n", dcode );
+    }
+
+    m_lastPos = pos;
+    m_lastPosValid = true;
+}
+
+
+bool GERBER_PLOTTER::isCurrentPos( const DPOINT& aPos ) const
+{
+    return m_lastPosValid
+           && KiROUND( aPos.x ) == m_lastPos.x && KiROUND( aPos.y ) == m_lastPos.y;
 }
 
 
@@ -118,10 +148,13 @@ bool GERBER_PLOTTER::StartPlot()
     if( outputFile == NULL )
         return false;
 
+    m_inRegion = false;
+    m_lastPosValid = false;
+
     for( unsigned ii = 0; ii < m_headerExtraLines.GetCount(); ii++ )
     {
         if( ! m_headerExtraLines[ii].IsEmpty() )
-            fprintf( outputFile, "%s\n", TO_UTF8( m_headerExtraLines[ii] ) );
+            KiFprintf( outputFile, "%s\n", TO_UTF8( m_headerExtraLines[ii] ) );
     }
 
     // Set coordinate format to 3.6 or 4.5 absolute, leading zero omitted
@@ -130,17 +163,17 @@ bool GERBER_PLOTTER::StartPlot()
     // It is fixed here to 3 (inch) or 4 (mm), but is not actually used
     int leadingDigitCount = m_gerberUnitInch ? 3 : 4;
 
-    fprintf( outputFile, "%%FSLAX%d%dY%d%d*%%\n",
-             leadingDigitCount, m_gerberUnitFmt,
-             leadingDigitCount, m_gerberUnitFmt );
-    fprintf( outputFile,
-             "G04 Gerber Fmt %d.%d, Leading zero omitted, Abs format (unit %s)*\n",
-             leadingDigitCount, m_gerberUnitFmt,
-             m_gerberUnitInch ? "inch" : "mm" );
+    KiFprintf( outputFile, "%%FSLAX%d%dY%d%d*%%\n",
+               leadingDigitCount, m_gerberUnitFmt,
+               leadingDigitCount, m_gerberUnitFmt );
+    KiFprintf( outputFile,
+               "G04 Gerber Fmt %d.%d, Leading zero omitted, Abs format (unit %s)*\n",
+               leadingDigitCount, m_gerberUnitFmt,
+               m_gerberUnitInch ? "inch" : "mm" );
 
     wxString Title = creator + wxT( " " ) + GetBuildVersion();
-    fprintf( outputFile, "G04 Created by KiCad (%s) date %s*\n",
-             TO_UTF8( Title ), TO_UTF8( DateAndTime() ) );
+    KiFprintf( outputFile, "G04 Created by KiCad (%s) date %s*\n",
+               TO_UTF8( Title ), TO_UTF8( DateAndTime() ) );
 
     /* Mass parameter: unit = INCHES/MM */
     if( m_gerberUnitInch )
@@ -232,7 +265,7 @@ std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize&
     {
         last_D_code = tool->DCode;
 
-        if( (tool->Type == type) && (tool->Size == size) )
+        if( apertureMatches( *tool, size, type ) )
             return tool;
 
         tool++;
@@ -248,18 +281,33 @@ std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize&
 }
 
 
+bool GERBER_PLOTTER::apertureMatches( const APERTURE& aTool, const wxSize& size,
+                                      APERTURE::APERTURE_TYPE type ) const
+{
+    if( aTool.Size != size )
+        return false;
+
+    if( aTool.Type == type )
+        return true;
+
+    // The round plotting and flashing apertures have the same definition
+    return m_optimizeOutput
+           && ( aTool.Type == APERTURE::Circle || aTool.Type == APERTURE::Plotting )
+           && ( type == APERTURE::Circle || type == APERTURE::Plotting );
+}
+
+
 void GERBER_PLOTTER::selectAperture( const wxSize&           size,
                                      APERTURE::APERTURE_TYPE type )
 {
     wxASSERT( outputFile );
 
     if( ( currentAperture == apertures.end() )
-       || ( currentAperture->Type != type )
-       || ( currentAperture->Size != size ) )
+       || !apertureMatches( *currentAperture, size, type ) )
     {
         // Pick an existing aperture or create a new one
         currentAperture = getAperture( size, type );
-        fprintf( outputFile, "D%d*\n", currentAperture->DCode );
+        KiFprintf( outputFile, "D%d*\n", currentAperture->DCode );
     }
 }
 
@@ -280,7 +328,8 @@ void GERBER_PLOTTER::writeApertureList()
         if(! m_gerberUnitInch )
             fscale *= 25.4;     // size in mm
 
-        char* text = cbuf + sprintf( cbuf, "%%ADD%d", tool->DCode );
+        char*  text = cbuf + KiSnprintf( cbuf, sizeof( cbuf ), "%%ADD%d", tool->DCode );
+        size_t room = sizeof( cbuf ) - ( text - cbuf );
 
         /* Please note: the Gerber specs for mass parameters say that
            exponential syntax is *not* allowed and the decimal point should
@@ -292,23 +341,21 @@ void GERBER_PLOTTER::writeApertureList()
         switch( tool->Type )
         {
         case APERTURE::Circle:
-            sprintf( text, "C,%#f*%%\n", tool->Size.x * fscale );
+            KiSnprintf( text, room, "C,%#f*%%\n", tool->Size.x * fscale );
             break;
 
         case APERTURE::Rect:
-            sprintf( text, "R,%#fX%#f*%%\n",
-	             tool->Size.x * fscale,
-                     tool->Size.y * fscale );
+            KiSnprintf( text, room, "R,%#fX%#f*%%\n",
+                        tool->Size.x * fscale, tool->Size.y * fscale );
             break;
 
         case APERTURE::Plotting:
-            sprintf( text, "C,%#f*%%\n", tool->Size.x * fscale );
+            KiSnprintf( text, room, "C,%#f*%%\n", tool->Size.x * fscale );
             break;
 
         case APERTURE::Oval:
-            sprintf( text, "O,%#fX%#f*%%\n",
-	            tool->Size.x * fscale,
-		    tool->Size.y * fscale );
+            KiSnprintf( text, room, "O,%#fX%#f*%%\n",
+                        tool->Size.x * fscale, tool->Size.y * fscale );
             break;
         }
 
@@ -328,7 +375,11 @@ void GERBER_PLOTTER::PenTo( const wxPoint& aPos, char plume )
         break;
 
     case 'U':
-        emitDcode( pos_dev, 2 );
+        // Outside a region, a move to the current point is useless.  Inside a region,
+        // the move closes the contour and cannot be removed
+        if( !m_optimizeOutput || m_inRegion || !isCurrentPos( pos_dev ) )
+            emitDcode( pos_dev, 2 );
+
         break;
 
     case 'D':
@@ -377,17 +428,20 @@ void GERBER_PLOTTER::Arc( const wxPoint& aCenter, double aStAngle, double aEndAn
     DPOINT devEnd = userToDeviceCoordinates( end );
     DPOINT devCenter = userToDeviceCoordinates( aCenter ) - userToDeviceCoordinates( start );
 
-    fprintf( outputFile, "G75*\n" ); // Multiquadrant mode
+    KiFprintf( outputFile, "G75*\n" ); // Multiquadrant mode
 
     if( aStAngle < aEndAngle )
-        fprintf( outputFile, "G03" );
+        KiFprintf( outputFile, "G03" );
     else
-        fprintf( outputFile, "G02" );
+        KiFprintf( outputFile, "G02" );
 
-    fprintf( outputFile, "X%dY%dI%dJ%dD01*\n",
-             KiROUND( devEnd.x ), KiROUND( devEnd.y ),
-             KiROUND( devCenter.x ), KiROUND( devCenter.y ) );
-    fprintf( outputFile, "G01*\n" ); // Back to linear interp.
+    KiFprintf( outputFile, "X%dY%dI%dJ%dD01*\n",
+               KiROUND( devEnd.x ), KiROUND( devEnd.y ),
+               KiROUND( devCenter.x ), KiROUND( devCenter.y ) );
+    KiFprintf( outputFile, "G01*\n" ); // Back to linear interp.
+
+    m_lastPos = wxPoint( KiROUND( devEnd.x ), KiROUND( devEnd.y ) );
+    m_lastPosValid = true;
 }
 
 
@@ -406,6 +460,7 @@ void GERBER_PLOTTER:: PlotPoly( const std::vector< wxPoint >& aCornerList,
     if( aFill )
     {
         fputs( "G36*\n", outputFile );
+        m_inRegion = true;
 
         MoveTo( aCornerList[0] );
 
@@ -414,6 +469,7 @@ void GERBER_PLOTTER:: PlotPoly( const std::vector< wxPoint >& aCornerList,
 
         FinishTo( aCornerList[0] );
         fputs( "G37*\n", outputFile );
+        m_inRegion = false;
     }
 
     if( aWidth > 0 )
@@ -433,6 +489,74 @@ void GERBER_PLOTTER:: PlotPoly( const std::vector< wxPoint >& aCornerList,
 }
 
 
+void GERBER_PLOTTER::PlotPolys( const std::vector< std::vector< wxPoint > >& aPolygons,
+                                FILL_T aFill, int aWidth )
+{
+    if( !m_optimizeOutput || !aFill )
+    {
+        PLOTTER::PlotPolys( aPolygons, aFill, aWidth );
+        return;
+    }
+
+    SetCurrentLineWidth( aWidth );
+
+    // One region, each polygon being a contour of it: a D02 starts a new contour
+    fputs( "G36*\n", outputFile );
+    m_inRegion = true;
+
+    for( unsigned ii = 0; ii < aPolygons.size(); ii++ )
+    {
+        const std::vector< wxPoint >& poly = aPolygons[ii];
+
+        if( poly.size() <= 1 )
+            continue;
+
+        MoveTo( poly[0] );
+
+        for( unsigned jj = 1; jj < poly.size(); jj++ )
+            LineTo( poly[jj] );
+
+        FinishTo( poly[0] );
+    }
+
+    fputs( "G37*\n", outputFile );
+    m_inRegion = false;
+
+    if( aWidth <= 0 )
+        return;
+
+    // The thick outlines, as PlotPoly()
+    for( unsigned ii = 0; ii < aPolygons.size(); ii++ )
+    {
+        const std::vector< wxPoint >& poly = aPolygons[ii];
+
+        if( poly.size() <= 1 )
+            continue;
+
+        MoveTo( poly[0] );
+
+        for( unsigned jj = 1; jj < poly.size(); jj++ )
+            LineTo( poly[jj] );
+
+        if( poly[poly.size()-1] != poly[0] )
+            LineTo( poly[0] );
+
+        PenFinish();
+    }
+}
+
+
+void GERBER_PLOTTER::ThickSegment( const wxPoint& start, const wxPoint& end, int width,
+                                   EDA_DRAW_MODE_T tracemode )
+{
+    if( m_optimizeOutput && tracemode == FILLED && start != end
+        && isCurrentPos( userToDeviceCoordinates( end ) ) )
+        PLOTTER::ThickSegment( end, start, width, tracemode );
+    else
+        PLOTTER::ThickSegment( start, end, width, tracemode );
+}
+
+
 void GERBER_PLOTTER::FlashPadCircle( const wxPoint& pos, int diametre, EDA_DRAW_MODE_T trace_mode )
 {
     wxASSERT( outputFile );
@@ -654,7 +778,7 @@ void GERBER_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos,  const wxPoint* aCo
 void GERBER_PLOTTER::SetLayerPolarity( bool aPositive )
 {
     if( aPositive )
-        fprintf( outputFile, "%%LPD*%%\n" );
+        KiFprintf( outputFile, "%%LPD*%%\n" );
     else
-        fprintf( outputFile, "%%LPC*%%\n" );
+        KiFprintf( outputFile, "%%LPC*%%\n" );
 }
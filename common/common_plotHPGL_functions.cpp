@@ -200,6 +200,7 @@
 #include <wxstruct.h>
 #include <base_struct.h>
 #include <plot_common.h>
+#include <numeric_io.h>
 #include <macros.h>
 #include <kicad_string.h>
 #include <convert_basic_shapes_to_polygon.h>
@@ -243,11 +244,11 @@ void HPGL_PLOTTER::SetViewport( const wxPoint& aOffset, double aIusPerDecimil,
 bool HPGL_PLOTTER::StartPlot()
 {
     wxASSERT( outputFile );
-    fprintf( outputFile, "IN;VS%d;PU;PA;SP%d;\n", penSpeed, penNumber );
+    KiFprintf( outputFile, "IN;VS%d;PU;PA;SP%d;\n", penSpeed, penNumber );
 
     // Set HPGL Pen Thickness (in mm) (usefull in polygon fill command)
     double penThicknessMM = userToDeviceSize( penDiameter )/40;
-    fprintf( outputFile, "PT %.1f;\n", penThicknessMM );
+    KiFprintf( outputFile, "PT %.1f;\n", penThicknessMM );
 
     return true;
 }
@@ -279,7 +280,7 @@ void HPGL_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int
     wxASSERT( outputFile );
     DPOINT p2dev = userToDeviceCoordinates( p2 );
     MoveTo( p1 );
-    fprintf( outputFile, "EA %.0f,%.0f;\n", p2dev.x, p2dev.y );
+    KiFprintf( outputFile, "EA %.0f,%.0f;\n", p2dev.x, p2dev.y );
     PenFinish();
 }
 
@@ -296,15 +297,15 @@ void HPGL_PLOTTER::Circle( const wxPoint& centre, int diameter, FILL_T fill,
     {
         // Draw the filled area
         MoveTo( centre );
-        fprintf( outputFile, "PM 0; CI %g;\n", radius );
-        fprintf( outputFile, hpgl_end_polygon_cmd );   // Close, fill polygon and draw outlines
+        KiFprintf( outputFile, "PM 0; CI %g;\n", radius );
+        KiFprintf( outputFile, hpgl_end_polygon_cmd );   // Close, fill polygon and draw outlines
         PenFinish();
     }
 
     if( radius > 0 )
     {
         MoveTo( centre );
-        fprintf( outputFile, "CI %g;\n", radius );
+        KiFprintf( outputFile, "CI %g;\n", radius );
         PenFinish();
     }
 }
@@ -327,7 +328,7 @@ void HPGL_PLOTTER::PlotPoly( const std::vector<wxPoint>& aCornerList,
     {
         // Draw the filled area
         SetCurrentLineWidth( USE_DEFAULT_LINE_WIDTH );
-        fprintf( outputFile, "PM 0;\n" );       // Start polygon
+        KiFprintf( outputFile, "PM 0;\n" );       // Start polygon
 
         for( unsigned ii = 1; ii < aCornerList.size(); ++ii )
             LineTo( aCornerList[ii] );
@@ -337,7 +338,7 @@ void HPGL_PLOTTER::PlotPoly( const std::vector<wxPoint>& aCornerList,
         if( aCornerList[ii] != aCornerList[0] )
             LineTo( aCornerList[0] );
 
-        fprintf( outputFile, hpgl_end_polygon_cmd );   // Close, fill polygon and draw outlines
+        KiFprintf( outputFile, hpgl_end_polygon_cmd );   // Close, fill polygon and draw outlines
     }
     else
     {
@@ -412,7 +413,7 @@ void HPGL_PLOTTER::PenTo( const wxPoint& pos, char plume )
     DPOINT pos_dev = userToDeviceCoordinates( pos );
 
     if( penLastpos != pos )
-        fprintf( outputFile, "PA %.0f,%.0f;\n", pos_dev.x, pos_dev.y );
+        KiFprintf( outputFile, "PA %.0f,%.0f;\n", pos_dev.x, pos_dev.y );
 
     penLastpos = pos;
 }
@@ -483,12 +484,12 @@ void HPGL_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle,
     cmap.y  = centre.y - KiROUND( sindecideg( radius, StAngle ) );
     DPOINT  cmap_dev = userToDeviceCoordinates( cmap );
 
-    fprintf( outputFile,
-             "PU;PA %.0f,%.0f;PD;AA %.0f,%.0f,",
-             cmap_dev.x, cmap_dev.y,
-             centre_dev.x, centre_dev.y );
-    fprintf( outputFile, "%.0f", angle );
-    fprintf( outputFile, ";PU;\n" );
+    KiFprintf( outputFile,
+               "PU;PA %.0f,%.0f;PD;AA %.0f,%.0f,",
+               cmap_dev.x, cmap_dev.y,
+               centre_dev.x, centre_dev.y );
+    KiFprintf( outputFile, "%.0f", angle );
+    KiFprintf( outputFile, ";PU;\n" );
     PenFinish();
 }
 
@@ -559,14 +560,14 @@ void HPGL_PLOTTER::FlashPadCircle( const wxPoint& pos, int diametre,
         // Gives a correct current starting point for the circle
         MoveTo( wxPoint( pos.x+radius, pos.y ) );
         // Plot filled area and its outline
-        fprintf( outputFile, "PM 0; PA %.0f,%.0f;CI %.0f;%s",
-                         pos_dev.x, pos_dev.y, rsize, hpgl_end_polygon_cmd );
+        KiFprintf( outputFile, "PM 0; PA %.0f,%.0f;CI %.0f;%s",
+                           pos_dev.x, pos_dev.y, rsize, hpgl_end_polygon_cmd );
     }
     else
     {
         // Draw outline only:
-        fprintf( outputFile, "PA %.0f,%.0f;CI %.0f;\n",
-                     pos_dev.x, pos_dev.y, rsize );
+        KiFprintf( outputFile, "PA %.0f,%.0f;CI %.0f;\n",
+                       pos_dev.x, pos_dev.y, rsize );
     }
 
     PenFinish();
@@ -34,10 +34,11 @@
 #include <base_struct.h>
 #include <common.h>
 #include <plot_common.h>
+#include <numeric_io.h>
 #include <macros.h>
 #include <kicad_string.h>
-#include <wx/zstream.h>
-#include <wx/mstream.h>
+#include <deflate_writer.h>
+#include <wx/filename.h>
 
 
 /*
@@ -63,14 +64,14 @@ bool PDF_PLOTTER::OpenFile( const wxString& aFullFilename )
 
 void PDF_PLOTTER::SetPageSettings( const PAGE_INFO& aPageSettings )
 {
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
     pageInfo = aPageSettings;
 }
 
 void PDF_PLOTTER::SetViewport( const wxPoint& aOffset, double aIusPerDecimil,
                               double aScale, bool aMirror )
 {
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
     m_plotMirror = aMirror;
     plotOffset = aOffset;
     plotScale = aScale;
@@ -96,7 +97,7 @@ void PDF_PLOTTER::SetViewport( const wxPoint& aOffset, double aIusPerDecimil,
  */
 void PDF_PLOTTER::SetCurrentLineWidth( int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     int pen_width;
 
     if( width > 0 )
@@ -107,7 +108,7 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width )
         pen_width = defaultPenWidth;
 
     if( pen_width != currentPenWidth )
-        fprintf( workFile, "%g w\n",
+        workStream->Printf( "%g w\n",
                  userToDeviceSize( pen_width ) );
 
     currentPenWidth = pen_width;
@@ -125,8 +126,8 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width )
  */
 void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
 {
-    wxASSERT( workFile );
-    fprintf( workFile, "%g %g %g rg %g %g %g RG\n",
+    wxASSERT( workStream );
+    workStream->Printf( "%g %g %g rg %g %g %g RG\n",
              r, g, b, r, g, b );
 }
 
@@ -135,12 +136,12 @@ void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
  */
 void PDF_PLOTTER::SetDash( bool dashed )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( dashed )
-        fprintf( workFile, "[%d %d] 0 d\n",
+        workStream->Printf( "[%d %d] 0 d\n",
                  (int) GetDashMarkLenIU(), (int) GetDashGapLenIU() );
     else
-        fputs( "[] 0 d\n", workFile );
+        workStream->Puts( "[] 0 d\n" );
 }
 
 
@@ -149,12 +150,12 @@ void PDF_PLOTTER::SetDash( bool dashed )
  */
 void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     DPOINT p1_dev = userToDeviceCoordinates( p1 );
     DPOINT p2_dev = userToDeviceCoordinates( p2 );
 
     SetCurrentLineWidth( width );
-    fprintf( workFile, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
+    workStream->Printf( "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
              p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y,
              fill == NO_FILL ? 'S' : 'B' );
 }
@@ -165,7 +166,7 @@ void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int w
  */
 void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     DPOINT pos_dev = userToDeviceCoordinates( pos );
     double radius = userToDeviceSize( diametre / 2.0 );
 
@@ -179,11 +180,11 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
     double magic = radius * 0.551784; // You don't want to know where this come from
 
     // This is the convex hull for the bezier approximated circle
-    fprintf( workFile, "%g %g m "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c %c\n",
+    workStream->Printf( "%g %g m "
+                        "%g %g %g %g %g %g c "
+                        "%g %g %g %g %g %g c "
+                        "%g %g %g %g %g %g c "
+                        "%g %g %g %g %g %g c %c\n",
              pos_dev.x - radius, pos_dev.y,
 
              pos_dev.x - radius, pos_dev.y + magic,
@@ -213,7 +214,7 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
 void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, int radius,
                       FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( radius <= 0 )
         return;
 
@@ -231,30 +232,30 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
     start.x = centre.x + KiROUND( cosdecideg( radius, -StAngle ) );
     start.y = centre.y + KiROUND( sindecideg( radius, -StAngle ) );
     DPOINT pos_dev = userToDeviceCoordinates( start );
-    fprintf( workFile, "%g %g m ", pos_dev.x, pos_dev.y );
+    workStream->Printf( "%g %g m ", pos_dev.x, pos_dev.y );
     for( int ii = StAngle + delta; ii < EndAngle; ii += delta )
     {
         end.x = centre.x + KiROUND( cosdecideg( radius, -ii ) );
         end.y = centre.y + KiROUND( sindecideg( radius, -ii ) );
         pos_dev = userToDeviceCoordinates( end );
-        fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+        workStream->Printf( "%g %g l ", pos_dev.x, pos_dev.y );
     }
 
     end.x = centre.x + KiROUND( cosdecideg( radius, -EndAngle ) );
     end.y = centre.y + KiROUND( sindecideg( radius, -EndAngle ) );
     pos_dev = userToDeviceCoordinates( end );
-    fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+    workStream->Printf( "%g %g l ", pos_dev.x, pos_dev.y );
 
     // The arc is drawn... if not filled we stroke it, otherwise we finish
     // closing the pie at the center
     if( fill == NO_FILL )
     {
-        fputs( "S\n", workFile );
+        workStream->Puts( "S\n" );
     }
     else
     {
         pos_dev = userToDeviceCoordinates( centre );
-        fprintf( workFile, "%g %g l b\n", pos_dev.x, pos_dev.y );
+        workStream->Printf( "%g %g l b\n", pos_dev.x, pos_dev.y );
     }
 }
 
@@ -265,34 +266,34 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
 void PDF_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
                            FILL_T aFill, int aWidth )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( aCornerList.size() <= 1 )
         return;
 
     SetCurrentLineWidth( aWidth );
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( workFile, "%g %g m\n", pos.x, pos.y );
+    workStream->Printf( "%g %g m\n", pos.x, pos.y );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( workFile, "%g %g l\n", pos.x, pos.y );
+        workStream->Printf( "%g %g l\n", pos.x, pos.y );
     }
 
     // Close path and stroke(/fill)
-    fprintf( workFile, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
+    workStream->Printf( "%c\n", aFill == NO_FILL ? 'S' : 'b' );
 }
 
 
 void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( plume == 'Z' )
     {
         if( penState != 'Z' )
         {
-            fputs( "S\n", workFile );
+            workStream->Puts( "S\n" );
             penState     = 'Z';
             penLastpos.x = -1;
             penLastpos.y = -1;
@@ -303,7 +304,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( workFile, "%g %g %c\n",
+        workStream->Printf( "%g %g %c\n",
                  pos_dev.x, pos_dev.y,
                  ( plume=='D' ) ? 'l' : 'm' );
     }
@@ -317,7 +318,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
                             double aScaleFactor )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     wxSize pix_size( aImage.GetWidth(), aImage.GetHeight() );
 
     // Requested size (in IUs)
@@ -340,7 +341,7 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        3) restore the CTM
        4) profit
      */
-    fprintf( workFile, "q %g 0 0 %g %g %g cm\n", // Step 1
+    workStream->Printf( "q %g 0 0 %g %g %g cm\n", // Step 1
             userToDeviceSize( drawsize.x ),
             userToDeviceSize( drawsize.y ),
             dev_start.x, dev_start.y );
@@ -349,7 +350,7 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        A real ugly construct (compared with the elegance of the PDF
        format). Also it accepts some 'abbreviations', which is stupid
        since the content stream is usually compressed anyway... */
-    fprintf( workFile,
+    workStream->Printf(
              "BI\n"
              "  /BPC 8\n"
              "  /CS %s\n"
@@ -369,19 +370,19 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
             // As usual these days, stdio buffering has to suffeeeeerrrr
             if( colorMode )
             {
-            putc( r, workFile );
-            putc( g, workFile );
-            putc( b, workFile );
+            workStream->Putc( r );
+            workStream->Putc( g );
+            workStream->Putc( b );
             }
             else
             {
                 // Grayscale conversion
-                putc( (r + g + b) / 3, workFile );
+                workStream->Putc( (r + g + b) / 3 );
             }
         }
     }
 
-    fputs( "EI Q\n", workFile ); // Finish step 2 and do step 3
+    workStream->Puts( "EI Q\n" ); // Finish step 2 and do step 3
 }
 
 
@@ -404,12 +405,12 @@ int PDF_PLOTTER::allocPdfObject()
 int PDF_PLOTTER::startPdfObject(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
     if( handle < 0)
         handle = allocPdfObject();
 
     xrefTable[handle] = ftell( outputFile );
-    fprintf( outputFile, "%d 0 obj\n", handle );
+    KiFprintf( outputFile, "%d 0 obj\n", handle );
     return handle;
 }
 
@@ -420,7 +421,7 @@ int PDF_PLOTTER::startPdfObject(int handle)
 void PDF_PLOTTER::closePdfObject()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
     fputs( "endobj\n", outputFile );
 }
 
@@ -434,83 +435,88 @@ void PDF_PLOTTER::closePdfObject()
 int PDF_PLOTTER::startPdfStream(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
     handle = startPdfObject( handle );
 
     // This is guaranteed to be handle+1 but needs to be allocated since
     // you could allocate more object during stream preparation
     streamLengthHandle = allocPdfObject();
-    fprintf( outputFile,
-             "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
-             "stream\n", handle + 1 );
-
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
-    workFile = wxFopen( workFilename, wxT( "w+b" ));
-    wxASSERT( workFile );
+    KiFprintf( outputFile,
+               "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
+               "stream\n", handle + 1 );
+
+    openWorkStream();
     return handle;
 }
 
 
 /**
- * Finish the current PDF stream (writes the deferred length, too)
+ * Open the stream compressing the page content, to the output file.  A plotter without
+ * output file, rendering a page for another plotter, compresses it in pageData.
  */
-void PDF_PLOTTER::closePdfStream()
+void PDF_PLOTTER::openWorkStream()
 {
-    wxASSERT( workFile );
-
-    long stream_len = ftell( workFile );
-
-    if( stream_len < 0 )
+    if( outputFile )
     {
-        wxASSERT( false );
-        return;
+        workStream = new DEFLATE_WRITER( outputFile, compressionLevel );
+    }
+    else
+    {
+        pageData.clear();
+        workStream = new DEFLATE_WRITER( &pageData, compressionLevel );
     }
+}
 
-    // Rewind the file, read in the page stream and DEFLATE it
-    fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
 
-    int rc = fread( inbuf, 1, stream_len, workFile );
-    wxASSERT( rc == stream_len );
-    (void) rc;
+/**
+ * Compress the end of the page content, and close its stream
+ * @return the size of the compressed data
+ */
+size_t PDF_PLOTTER::closeWorkStream()
+{
+    wxASSERT( workStream );
 
-    // We are done with the temporary file, junk it
-    fclose( workFile );
-    workFile = 0;
-    ::wxRemoveFile( workFilename );
+    size_t length = workStream->Finish();
 
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
+    delete workStream;
+    workStream = NULL;
 
-    {
-        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-         *                    8, Z_DEFAULT_STRATEGY );
-         */
-
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+    return length;
+}
 
-        zos.Write( inbuf, stream_len );
 
-        delete[] inbuf;
+/**
+ * Finish the current PDF stream (writes the deferred length, too)
+ */
+void PDF_PLOTTER::closePdfStream()
+{
+    // The compressed data is already in the output file
+    endPdfStream( closeWorkStream() );
+}
 
-    }   // flush the zip stream using zos destructor
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+/**
+ * Write the compressed data of a PDF stream, then the deferred length
+ */
+void PDF_PLOTTER::writePdfStreamData( const std::string& aStream )
+{
+    fwrite( aStream.data(), 1, aStream.size(), outputFile );
 
-    unsigned out_count = sb->Tell();
+    endPdfStream( aStream.size() );
+}
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
 
+/**
+ * Close the current PDF stream object, and write its deferred length
+ */
+void PDF_PLOTTER::endPdfStream( size_t aLength )
+{
     fputs( "endstream\n", outputFile );
     closePdfObject();
 
     // Writing the deferred length as an indirect object
     startPdfObject( streamLengthHandle );
-    fprintf( outputFile, "%u\n", out_count );
+    KiFprintf( outputFile, "%u\n", (unsigned) aLength );
     closePdfObject();
 }
 
@@ -519,22 +525,25 @@ void PDF_PLOTTER::closePdfStream()
  */
 void PDF_PLOTTER::StartPage()
 {
-    wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
 
     // Compute the paper size in IUs
     paperSize = pageInfo.GetSizeMils();
     paperSize.x *= 10.0 / iuPerDeviceUnit;
     paperSize.y *= 10.0 / iuPerDeviceUnit;
 
-    // Open the content stream; the page object will go later
-    pageStreamHandle = startPdfStream();
+    // Open the content stream; the page object will go later.  Without output file,
+    // the content is only accumulated for ClosePageStream()
+    if( outputFile )
+        pageStreamHandle = startPdfStream();
+    else
+        openWorkStream();
 
-    /* Now, until ClosePage *everything* must be wrote in workFile, to be
-       compressed later in closePdfStream */
+    /* Now, until ClosePage *everything* must be wrote in workStream, which
+       compresses it on the fly */
 
     // Default graphic settings (coordinate system, default color and line style)
-    fprintf( workFile,
+    workStream->Printf(
              "%g 0 0 %g 0 0 cm 1 J 1 j 0 0 0 rg 0 0 0 RG %g w\n",
              0.0072 * plotScaleAdjX, 0.0072 * plotScaleAdjY,
              userToDeviceSize( defaultPenWidth ) );
@@ -545,11 +554,48 @@ void PDF_PLOTTER::StartPage()
  */
 void PDF_PLOTTER::ClosePage()
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
 
     // Close the page stream (and compress it)
     closePdfStream();
 
+    emitPageObject();
+}
+
+
+void PDF_PLOTTER::ClosePageStream( std::string& aStream )
+{
+    wxASSERT( !outputFile );
+
+    closeWorkStream();
+    aStream.swap( pageData );
+    pageData.clear();
+}
+
+
+void PDF_PLOTTER::AddPage( const std::string& aStream )
+{
+    wxASSERT( outputFile );
+    wxASSERT( !workStream );
+
+    pageStreamHandle = startPdfObject();
+    streamLengthHandle = allocPdfObject();
+
+    KiFprintf( outputFile,
+               "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
+               "stream\n", streamLengthHandle );
+
+    writePdfStreamData( aStream );
+
+    emitPageObject();
+}
+
+
+/**
+ * Emit the page object of the closed page stream
+ */
+void PDF_PLOTTER::emitPageObject()
+{
     // Emit the page object and put it in the page list for later
     pageHandles.push_back( startPdfObject() );
 
@@ -562,21 +608,21 @@ void PDF_PLOTTER::ClosePage()
     const double BIGPTsPERMIL = 0.072;
     wxSize psPaperSize = pageInfo.GetSizeMils();
 
-    fprintf( outputFile,
-             "<<\n"
-             "/Type /Page\n"
-             "/Parent %d 0 R\n"
-             "/Resources <<\n"
-             "    /ProcSet [/PDF /Text /ImageC /ImageB]\n"
-             "    /Font %d 0 R >>\n"
-             "/MediaBox [0 0 %d %d]\n"
-             "/Contents %d 0 R\n"
-             ">>\n",
-             pageTreeHandle,
-             fontResDictHandle,
-             int( ceil( psPaperSize.x * BIGPTsPERMIL ) ),
-             int( ceil( psPaperSize.y * BIGPTsPERMIL ) ),
-             pageStreamHandle );
+    KiFprintf( outputFile,
+               "<<\n"
+               "/Type /Page\n"
+               "/Parent %d 0 R\n"
+               "/Resources <<\n"
+               "    /ProcSet [/PDF /Text /ImageC /ImageB]\n"
+               "    /Font %d 0 R >>\n"
+               "/MediaBox [0 0 %d %d]\n"
+               "/Contents %d 0 R\n"
+               ">>\n",
+               pageTreeHandle,
+               fontResDictHandle,
+               int( ceil( psPaperSize.x * BIGPTsPERMIL ) ),
+               int( ceil( psPaperSize.y * BIGPTsPERMIL ) ),
+               pageStreamHandle );
     closePdfObject();
 
     // Mark the page stream as idle
@@ -621,8 +667,10 @@ bool PDF_PLOTTER::EndPlot()
 {
     wxASSERT( outputFile );
 
-    // Close the current page (often the only one)
-    ClosePage();
+    // Close the current page (often the only one), unless the last page was added
+    // by AddPage()
+    if( workStream )
+        ClosePage();
 
     /* We need to declare the resources we're using (fonts in particular)
        The useful standard one is the Helvetica family. Adding external fonts
@@ -644,16 +692,16 @@ bool PDF_PLOTTER::EndPlot()
     for( int i = 0; i < 4; i++ )
     {
         fontdefs[i].font_handle = startPdfObject();
-        fprintf( outputFile,
-                 "<< /BaseFont %s\n"
-                 "   /Type /Font\n"
-                 "   /Subtype /Type1\n"
-
-                 /* Adobe is so Mac-based that the nearest thing to Latin1 is
-                    the Windows ANSI encoding! */
-                 "   /Encoding /WinAnsiEncoding\n"
-                 ">>\n",
-                 fontdefs[i].psname );
+        KiFprintf( outputFile,
+                   "<< /BaseFont %s\n"
+                   "   /Type /Font\n"
+                   "   /Subtype /Type1\n"
+
+                   /* Adobe is so Mac-based that the nearest thing to Latin1 is
+                      the Windows ANSI encoding! */
+                   "   /Encoding /WinAnsiEncoding\n"
+                   ">>\n",
+                   fontdefs[i].psname );
         closePdfObject();
     }
 
@@ -662,8 +710,8 @@ bool PDF_PLOTTER::EndPlot()
     fputs( "<<\n", outputFile );
     for( int i = 0; i < 4; i++ )
     {
-        fprintf( outputFile, "    %s %d 0 R\n",
-                fontdefs[i].rsname, fontdefs[i].font_handle );
+        KiFprintf( outputFile, "    %s %d 0 R\n",
+                  fontdefs[i].rsname, fontdefs[i].font_handle );
     }
     fputs( ">>\n", outputFile );
     closePdfObject();
@@ -677,12 +725,12 @@ bool PDF_PLOTTER::EndPlot()
            "/Kids [\n", outputFile );
 
     for( unsigned i = 0; i < pageHandles.size(); i++ )
-        fprintf( outputFile, "%d 0 R\n", pageHandles[i] );
+        KiFprintf( outputFile, "%d 0 R\n", pageHandles[i] );
 
-    fprintf( outputFile,
-            "]\n"
-            "/Count %ld\n"
-             ">>\n", (long) pageHandles.size() );
+    KiFprintf( outputFile,
+              "]\n"
+              "/Count %ld\n"
+               ">>\n", (long) pageHandles.size() );
     closePdfObject();
 
 
@@ -692,53 +740,53 @@ bool PDF_PLOTTER::EndPlot()
     time_t ltime = time( NULL );
     strftime( date_buf, 250, "D:%Y%m%d%H%M%S",
               localtime( &ltime ) );
-    fprintf( outputFile,
-             "<<\n"
-             "/Producer (KiCAD PDF)\n"
-             "/CreationDate (%s)\n"
-             "/Creator (%s)\n"
-             "/Title (%s)\n"
-             "/Trapped false\n",
-             date_buf,
-             TO_UTF8( creator ),
-             TO_UTF8( filename ) );
+    KiFprintf( outputFile,
+               "<<\n"
+               "/Producer (KiCAD PDF)\n"
+               "/CreationDate (%s)\n"
+               "/Creator (%s)\n"
+               "/Title (%s)\n"
+               "/Trapped false\n",
+               date_buf,
+               TO_UTF8( creator ),
+               TO_UTF8( filename ) );
 
     fputs( ">>\n", outputFile );
     closePdfObject();
 
     // The catalog, at last
     int catalogHandle = startPdfObject();
-    fprintf( outputFile,
-             "<<\n"
-             "/Type /Catalog\n"
-             "/Pages %d 0 R\n"
-             "/Version /1.5\n"
-             "/PageMode /UseNone\n"
-             "/PageLayout /SinglePage\n"
-             ">>\n", pageTreeHandle );
+    KiFprintf( outputFile,
+               "<<\n"
+               "/Type /Catalog\n"
+               "/Pages %d 0 R\n"
+               "/Version /1.5\n"
+               "/PageMode /UseNone\n"
+               "/PageLayout /SinglePage\n"
+               ">>\n", pageTreeHandle );
     closePdfObject();
 
     /* Emit the xref table (format is crucial to the byte, each entry must
        be 20 bytes long, and object zero must be done in that way). Also
        the offset must be kept along for the trailer */
     long xref_start = ftell( outputFile );
-    fprintf( outputFile,
-             "xref\n"
-             "0 %ld\n"
-             "0000000000 65535 f \n", (long) xrefTable.size() );
+    KiFprintf( outputFile,
+               "xref\n"
+               "0 %ld\n"
+               "0000000000 65535 f \n", (long) xrefTable.size() );
     for( unsigned i = 1; i < xrefTable.size(); i++ )
     {
-        fprintf( outputFile, "%010ld 00000 n \n", xrefTable[i] );
+        KiFprintf( outputFile, "%010ld 00000 n \n", xrefTable[i] );
     }
 
     // Done the xref, go for the trailer
-    fprintf( outputFile,
-             "trailer\n"
-             "<< /Size %lu /Root %d 0 R /Info %d 0 R >>\n"
-             "startxref\n"
-             "%ld\n" // The offset we saved before
-             "%%%%EOF\n",
-             (unsigned long) xrefTable.size(), catalogHandle, infoDictHandle, xref_start );
+    KiFprintf( outputFile,
+               "trailer\n"
+               "<< /Size %lu /Root %d 0 R /Info %d 0 R >>\n"
+               "startxref\n"
+               "%ld\n" // The offset we saved before
+               "%%%%EOF\n",
+               (unsigned long) xrefTable.size(), catalogHandle, infoDictHandle, xref_start );
 
     fclose( outputFile );
     outputFile = NULL;
@@ -788,15 +836,15 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
            for the trig part of the matrix to avoid %g going in exponential
            format (which is not supported)
            Rendermode 0 shows the text, rendermode 3 is invisible */
-        fprintf( workFile, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
+        workStream->Printf( "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
                 ctm_a, ctm_b, ctm_c, ctm_d, ctm_e, ctm_f,
                 fontname, heightFactor,
                 (m_textMode == PLOTTEXTMODE_NATIVE) ? 0 : 3,
                 wideningFactor * 100 );
 
         // The text must be escaped correctly
-        fputsPostscriptString( workFile, aText );
-        fputs( " Tj ET\n", workFile );
+        workStream->Puts( encodePostscriptString( aText ).c_str() );
+        workStream->Puts( " Tj ET\n" );
 
         /* We are still in text coordinates, plot the overbars (if we're
          * not doing phantom text) */
@@ -813,13 +861,13 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
                    is the right function to use here... */
                 DPOINT dev_from = userToDeviceSize( wxSize( pos_pairs[i], overbar_y ) );
                 DPOINT dev_to = userToDeviceSize( wxSize( pos_pairs[i + 1], overbar_y ) );
-                fprintf( workFile, "%g %g m %g %g l ",
+                workStream->Printf( "%g %g m %g %g l ",
                         dev_from.x, dev_from.y, dev_to.x, dev_to.y );
             }
         }
 
         // Stroke and restore the CTM
-        fputs( "S Q\n", workFile );
+        workStream->Puts( "S Q\n" );
     }
 
     // Plot the stroked text (if requested)
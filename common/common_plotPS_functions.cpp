@@ -33,6 +33,7 @@
 #include <base_struct.h>
 #include <common.h>
 #include <plot_common.h>
+#include <numeric_io.h>
 #include <macros.h>
 #include <kicad_string.h>
 #include <convert_basic_shapes_to_polygon.h>
@@ -143,7 +144,7 @@ void PSLIKE_PLOTTER::FlashPadCircle( const wxPoint& aPadPos, int aDiameter,
 void PSLIKE_PLOTTER::FlashPadRect( const wxPoint& aPadPos, const wxSize& aSize,
                                    double aPadOrient, EDA_DRAW_MODE_T aTraceMode )
 {
-    static std::vector< wxPoint > cornerList;
+    std::vector< wxPoint > cornerList;
     wxSize size( aSize );
     cornerList.clear();
 
@@ -263,7 +264,7 @@ void PSLIKE_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
 void PSLIKE_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCorners,
                                      double aPadOrient, EDA_DRAW_MODE_T aTraceMode )
 {
-    static std::vector< wxPoint > cornerList;
+    std::vector< wxPoint > cornerList;
     cornerList.clear();
 
     for( int ii = 0; ii < 4; ii++ )
@@ -307,14 +308,14 @@ void PSLIKE_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCor
 
 
 /**
- * Write on a stream a string escaped for postscript/PDF
+ * Return a string escaped for postscript/PDF, with its parentheses
  */
-void PSLIKE_PLOTTER::fputsPostscriptString(FILE *fout, const wxString& txt)
+std::string PSLIKE_PLOTTER::encodePostscriptString( const wxString& txt )
 {
-    putc( '(', fout );
+    std::string encoded( 1, '(' );
+
     for( unsigned i = 0; i < txt.length(); i++ )
     {
-        // Lazyness made me use stdio buffering yet another time...
         wchar_t ch = txt[i];
 
         if( ch < 256 )
@@ -328,17 +329,28 @@ void PSLIKE_PLOTTER::fputsPostscriptString(FILE *fout, const wxString& txt)
             case '(':
             case ')':
             case '\\':
-                putc( '\\', fout );
+                encoded += '\\';
 
                 // FALLTHRU
             default:
-                putc( ch, fout );
+                encoded += (char) ch;
                 break;
             }
         }
     }
 
-    putc( ')', fout );
+    encoded += ')';
+
+    return encoded;
+}
+
+
+/**
+ * Write on a stream a string escaped for postscript/PDF
+ */
+void PSLIKE_PLOTTER::fputsPostscriptString(FILE *fout, const wxString& txt)
+{
+    fputs( encodePostscriptString( txt ).c_str(), fout );
 }
 
 
@@ -526,7 +538,7 @@ void PS_PLOTTER::SetCurrentLineWidth( int width )
         pen_width = defaultPenWidth;
 
     if( pen_width != GetCurrentLineWidth() )
-        fprintf( outputFile, "%g setlinewidth\n", userToDeviceSize( pen_width ) );
+        KiFprintf( outputFile, "%g setlinewidth\n", userToDeviceSize( pen_width ) );
 
     currentPenWidth = pen_width;
 }
@@ -537,7 +549,7 @@ void PS_PLOTTER::emitSetRGBColor( double r, double g, double b )
     wxASSERT( outputFile );
 
     // XXX why %.3g ? shouldn't %g suffice? who cares...
-    fprintf( outputFile, "%.3g %.3g %.3g setrgbcolor\n", r, g, b );
+    KiFprintf( outputFile, "%.3g %.3g %.3g setrgbcolor\n", r, g, b );
 }
 
 
@@ -548,8 +560,8 @@ void PS_PLOTTER::SetDash( bool dashed )
 {
     wxASSERT( outputFile );
     if( dashed )
-        fprintf( outputFile, "[%d %d] 0 setdash\n",
-                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU() );
+        KiFprintf( outputFile, "[%d %d] 0 setdash\n",
+                   (int) GetDashMarkLenIU(), (int) GetDashGapLenIU() );
     else
         fputs( "solidline\n", outputFile );
 }
@@ -561,8 +573,8 @@ void PS_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int wi
     DPOINT p2_dev = userToDeviceCoordinates( p2 );
 
     SetCurrentLineWidth( width );
-    fprintf( outputFile, "%g %g %g %g rect%d\n", p1_dev.x, p1_dev.y,
-             p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y, fill );
+    KiFprintf( outputFile, "%g %g %g %g rect%d\n", p1_dev.x, p1_dev.y,
+               p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y, fill );
 }
 
 
@@ -573,7 +585,7 @@ void PS_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T fill, int widt
     double radius = userToDeviceSize( diametre / 2.0 );
 
     SetCurrentLineWidth( width );
-    fprintf( outputFile, "%g %g %g cir%d\n", pos_dev.x, pos_dev.y, radius, fill );
+    KiFprintf( outputFile, "%g %g %g cir%d\n", pos_dev.x, pos_dev.y, radius, fill );
 }
 
 
@@ -608,8 +620,8 @@ void PS_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle,
         }
     }
 
-    fprintf( outputFile, "%g %g %g %g %g arc%d\n", centre_dev.x, centre_dev.y,
-             radius_dev, StAngle / 10.0, EndAngle / 10.0, fill );
+    KiFprintf( outputFile, "%g %g %g %g %g arc%d\n", centre_dev.x, centre_dev.y,
+               radius_dev, StAngle / 10.0, EndAngle / 10.0, fill );
 }
 
 
@@ -622,16 +634,16 @@ void PS_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
     SetCurrentLineWidth( aWidth );
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( outputFile, "newpath\n%g %g moveto\n", pos.x, pos.y );
+    KiFprintf( outputFile, "newpath\n%g %g moveto\n", pos.x, pos.y );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( outputFile, "%g %g lineto\n", pos.x, pos.y );
+        KiFprintf( outputFile, "%g %g lineto\n", pos.x, pos.y );
     }
 
     // Close/(fill) the path
-    fprintf( outputFile, "poly%d\n", aFill );
+    KiFprintf( outputFile, "poly%d\n", aFill );
 }
 
 
@@ -657,23 +669,23 @@ void PS_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
     end.x = start.x + drawsize.x;
     end.y = start.y - drawsize.y;
 
-    fprintf( outputFile, "/origstate save def\n" );
-    fprintf( outputFile, "/pix %d string def\n", pix_size.x );
+    KiFprintf( outputFile, "/origstate save def\n" );
+    KiFprintf( outputFile, "/pix %d string def\n", pix_size.x );
 
     // Locate lower-left corner of image
     DPOINT start_dev = userToDeviceCoordinates( start );
-    fprintf( outputFile, "%g %g translate\n", start_dev.x, start_dev.y );
+    KiFprintf( outputFile, "%g %g translate\n", start_dev.x, start_dev.y );
     // Map image size to device
     DPOINT end_dev = userToDeviceCoordinates( end );
-    fprintf( outputFile, "%g %g scale\n",
-             std::abs(end_dev.x - start_dev.x), std::abs(end_dev.y - start_dev.y));
+    KiFprintf( outputFile, "%g %g scale\n",
+               std::abs(end_dev.x - start_dev.x), std::abs(end_dev.y - start_dev.y));
 
     // Dimensions of source image (in pixels
-    fprintf( outputFile, "%d %d 8", pix_size.x, pix_size.y );
+    KiFprintf( outputFile, "%d %d 8", pix_size.x, pix_size.y );
     //  Map unit square to source
-    fprintf( outputFile, " [%d 0 0 %d 0 %d]\n", pix_size.x, -pix_size.y , pix_size.y);
+    KiFprintf( outputFile, " [%d 0 0 %d 0 %d]\n", pix_size.x, -pix_size.y , pix_size.y);
     // include image data in ps file
-    fprintf( outputFile, "{currentfile pix readhexstring pop}\n" );
+    KiFprintf( outputFile, "{currentfile pix readhexstring pop}\n" );
 
     if( colorMode )
         fputs( "false 3 colorimage\n", outputFile );
@@ -690,7 +702,7 @@ void PS_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
             if( jj >= 16 )
             {
                 jj = 0;
-                fprintf( outputFile, "\n");
+                KiFprintf( outputFile, "\n");
             }
 
             int red, green, blue;
@@ -699,14 +711,14 @@ void PS_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
             blue = aImage.GetBlue( xx, yy) & 0xFF;
 
             if( colorMode )
-                fprintf( outputFile, "%2.2X%2.2X%2.2X", red, green, blue );
+                KiFprintf( outputFile, "%2.2X%2.2X%2.2X", red, green, blue );
             else
-                fprintf( outputFile, "%2.2X", (red + green + blue) / 3 );
+                KiFprintf( outputFile, "%2.2X", (red + green + blue) / 3 );
         }
     }
 
-    fprintf( outputFile, "\n");
-    fprintf( outputFile, "origstate restore\n" );
+    KiFprintf( outputFile, "\n");
+    KiFprintf( outputFile, "origstate restore\n" );
 }
 
 
@@ -735,9 +747,9 @@ void PS_PLOTTER::PenTo( const wxPoint& pos, char plume )
     if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( outputFile, "%g %g %sto\n",
-                 pos_dev.x, pos_dev.y,
-                 ( plume=='D' ) ? "line" : "move" );
+        KiFprintf( outputFile, "%g %g %sto\n",
+                   pos_dev.x, pos_dev.y,
+                   ( plume=='D' ) ? "line" : "move" );
     }
 
     penState   = plume;
@@ -820,14 +832,14 @@ bool PS_PLOTTER::StartPlot()
 
     fputs( "%!PS-Adobe-3.0\n", outputFile );    // Print header
 
-    fprintf( outputFile, "%%%%Creator: %s\n", TO_UTF8( creator ) );
+    KiFprintf( outputFile, "%%%%Creator: %s\n", TO_UTF8( creator ) );
 
     /* A "newline" character ("\n") is not included in the following string,
        because it is provided by the ctime() function. */
-    fprintf( outputFile, "%%%%CreationDate: %s", ctime( &time1970 ) );
-    fprintf( outputFile, "%%%%Title: %s\n", TO_UTF8( filename ) );
-    fprintf( outputFile, "%%%%Pages: 1\n" );
-    fprintf( outputFile, "%%%%PageOrder: Ascend\n" );
+    KiFprintf( outputFile, "%%%%CreationDate: %s", ctime( &time1970 ) );
+    KiFprintf( outputFile, "%%%%Title: %s\n", TO_UTF8( filename ) );
+    KiFprintf( outputFile, "%%%%Pages: 1\n" );
+    KiFprintf( outputFile, "%%%%PageOrder: Ascend\n" );
 
     // Print boundary box in 1/72 pixels per inch, box is in mils
     const double BIGPTsPERMIL = 0.072;
@@ -840,9 +852,9 @@ bool PS_PLOTTER::StartPlot()
     if( !pageInfo.IsPortrait() )
         psPaperSize.Set( pageInfo.GetHeightMils(), pageInfo.GetWidthMils() );
 
-    fprintf( outputFile, "%%%%BoundingBox: 0 0 %d %d\n",
-        (int) ceil( psPaperSize.x * BIGPTsPERMIL ),
-        (int) ceil( psPaperSize.y * BIGPTsPERMIL ) );
+    KiFprintf( outputFile, "%%%%BoundingBox: 0 0 %d %d\n",
+          (int) ceil( psPaperSize.x * BIGPTsPERMIL ),
+          (int) ceil( psPaperSize.y * BIGPTsPERMIL ) );
 
     // Specify the size of the sheet and the name associated with that size.
     // (If the "User size" option has been selected for the sheet size,
@@ -860,22 +872,22 @@ bool PS_PLOTTER::StartPlot()
     // converted to internal units.
 
     if( pageInfo.IsCustom() )
-        fprintf( outputFile, "%%%%DocumentMedia: Custom %d %d 0 () ()\n",
-                 KiROUND( psPaperSize.x * BIGPTsPERMIL ),
-                 KiROUND( psPaperSize.y * BIGPTsPERMIL ) );
+        KiFprintf( outputFile, "%%%%DocumentMedia: Custom %d %d 0 () ()\n",
+                   KiROUND( psPaperSize.x * BIGPTsPERMIL ),
+                   KiROUND( psPaperSize.y * BIGPTsPERMIL ) );
 
     else  // a standard paper size
-        fprintf( outputFile, "%%%%DocumentMedia: %s %d %d 0 () ()\n",
-                 TO_UTF8( pageInfo.GetType() ),
-                 KiROUND( psPaperSize.x * BIGPTsPERMIL ),
-                 KiROUND( psPaperSize.y * BIGPTsPERMIL ) );
+        KiFprintf( outputFile, "%%%%DocumentMedia: %s %d %d 0 () ()\n",
+                   TO_UTF8( pageInfo.GetType() ),
+                   KiROUND( psPaperSize.x * BIGPTsPERMIL ),
+                   KiROUND( psPaperSize.y * BIGPTsPERMIL ) );
 
     if( pageInfo.IsPortrait() )
-        fprintf( outputFile, "%%%%Orientation: Portrait\n" );
+        KiFprintf( outputFile, "%%%%Orientation: Portrait\n" );
     else
-        fprintf( outputFile, "%%%%Orientation: Landscape\n" );
+        KiFprintf( outputFile, "%%%%Orientation: Landscape\n" );
 
-    fprintf( outputFile, "%%%%EndComments\n" );
+    KiFprintf( outputFile, "%%%%EndComments\n" );
 
     // Now specify various other details.
 
@@ -897,15 +909,15 @@ bool PS_PLOTTER::StartPlot()
 
     // Rototranslate the coordinate to achieve the landscape layout
     if( !pageInfo.IsPortrait() )
-        fprintf( outputFile, "%d 0 translate 90 rotate\n", 10 * psPaperSize.x );
+        KiFprintf( outputFile, "%d 0 translate 90 rotate\n", 10 * psPaperSize.x );
 
     // Apply the user fine scale adjustments
     if( plotScaleAdjX != 1.0 || plotScaleAdjY != 1.0 )
-        fprintf( outputFile, "%g %g scale\n",
-                 plotScaleAdjX, plotScaleAdjY );
+        KiFprintf( outputFile, "%g %g scale\n",
+                   plotScaleAdjX, plotScaleAdjY );
 
     // Set default line width
-    fprintf( outputFile, "%g setlinewidth\n", userToDeviceSize( defaultPenWidth ) );
+    KiFprintf( outputFile, "%g setlinewidth\n", userToDeviceSize( defaultPenWidth ) );
     fputs( "%%EndPageSetup\n", outputFile );
 
     return true;
@@ -966,9 +978,9 @@ void PS_PLOTTER::Text( const wxPoint&       aPos,
         // parameters. The CTM is formatted with %f since sin/cos tends
         // to make %g use exponential notation (which is not supported)
         fputsPostscriptString( outputFile, aText );
-        fprintf( outputFile, " %g [%f %f %f %f %f %f] %g %s textshow\n",
-                wideningFactor, ctm_a, ctm_b, ctm_c, ctm_d, ctm_e, ctm_f,
-                heightFactor, fontname );
+        KiFprintf( outputFile, " %g [%f %f %f %f %f %f] %g %s textshow\n",
+                  wideningFactor, ctm_a, ctm_b, ctm_c, ctm_d, ctm_e, ctm_f,
+                  heightFactor, fontname );
 
         /* The textshow operator retained the coordinate system, we use it
          * to plot the overbars. See the PDF sister function for more
@@ -982,8 +994,8 @@ void PS_PLOTTER::Text( const wxPoint&       aPos,
         {
             DPOINT dev_from = userToDeviceSize( wxSize( pos_pairs[i], overbar_y ) );
             DPOINT dev_to = userToDeviceSize( wxSize( pos_pairs[i + 1], overbar_y ) );
-            fprintf( outputFile, "%g %g %g %g line ",
-                     dev_from.x, dev_from.y, dev_to.x, dev_to.y );
+            KiFprintf( outputFile, "%g %g %g %g line ",
+                       dev_from.x, dev_from.y, dev_to.x, dev_to.y );
         }
 
         // Restore the CTM
@@ -995,7 +1007,7 @@ void PS_PLOTTER::Text( const wxPoint&       aPos,
     {
         fputsPostscriptString( outputFile, aText );
         DPOINT pos_dev = userToDeviceCoordinates( aPos );
-        fprintf( outputFile, " %g %g phantomshow\n", pos_dev.x, pos_dev.y );
+        KiFprintf( outputFile, " %g %g phantomshow\n", pos_dev.x, pos_dev.y );
     }
 
     // Draw the stroked text (if requested)
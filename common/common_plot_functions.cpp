@@ -38,6 +38,8 @@
 #include "class_worksheet_dataitem.h"
 #include <wx/filename.h>
 
+#include <boost/thread/mutex.hpp>
+
 
 
 wxString GetDefaultPlotExtension( PlotFormat aFormat )
@@ -69,6 +71,12 @@ wxString GetDefaultPlotExtension( PlotFormat aFormat )
 }
 
 
+// BuildWorkSheetGraphicList() updates the items of the shared page layout: the sheets
+// plotted on several threads build their worksheet one at a time.  The item list is kept
+// under the lock, and built again only for a page differing from the one plotted before.
+static boost::mutex worksheetLock;
+static WS_DRAW_ITEM_LIST worksheetItems;
+
 
 void PlotWorkSheet( PLOTTER* plotter, const TITLE_BLOCK& aTitleBlock,
                     const PAGE_INFO& aPageInfo,
@@ -81,7 +89,8 @@ void PlotWorkSheet( PLOTTER* plotter, const TITLE_BLOCK& aTitleBlock,
 
     EDA_COLOR_T plotColor = plotter->GetColorMode() ? RED : BLACK;
     plotter->SetColor( plotColor );
-    WS_DRAW_ITEM_LIST drawList;
+    boost::mutex::scoped_lock lock( worksheetLock );
+    WS_DRAW_ITEM_LIST& drawList = worksheetItems;
 
     // Print only a short filename, if aFilename is the full filename
     wxFileName fn( aFilename );
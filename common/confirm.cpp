@@ -29,9 +29,35 @@
 
 #include <wx/stockitem.h>
 
+#include <cstdio>
+
+#include <macros.h>
 #include <bitmaps.h>
 #include <html_messagebox.h>
 #include <dialog_exit_base.h>
+#include <confirm.h>
+
+
+static bool batchMode = false;
+
+
+void SetBatchMode( bool aBatchMode )
+{
+    batchMode = aBatchMode;
+}
+
+
+bool IsBatchMode()
+{
+    return batchMode;
+}
+
+
+// The messages of the batch mode go to the standard error output
+static void batchMessage( const wxString& aTitle, const wxString& aText )
+{
+    fprintf( stderr, "%s: %s\n", TO_UTF8( aTitle ), TO_UTF8( aText ) );
+}
 
 
 class DIALOG_EXIT: public DIALOG_EXIT_BASE
@@ -57,6 +83,9 @@ private:
 
 int DisplayExitDialog( wxWindow* parent, const wxString& aMessage )
 {
+    if( batchMode )
+        return wxID_CANCEL;
+
     DIALOG_EXIT dlg( parent, aMessage );
 
     int ret = dlg.ShowModal();
@@ -68,6 +97,12 @@ int DisplayExitDialog( wxWindow* parent, const wxString& aMessage )
 
 void DisplayError( wxWindow* parent, const wxString& text, int displaytime )
 {
+    if( batchMode )
+    {
+        batchMessage( displaytime > 0 ? _( "Warning" ) : _( "Error" ), text );
+        return;
+    }
+
     wxMessageDialog* dialog;
 
     if( displaytime > 0 )
@@ -88,6 +123,12 @@ void DisplayError( wxWindow* parent, const wxString& text, int displaytime )
 
 void DisplayInfoMessage( wxWindow* parent, const wxString& text, int displaytime )
 {
+    if( batchMode )
+    {
+        batchMessage( _( "Info" ), text );
+        return;
+    }
+
     wxMessageDialog* dialog;
 
     dialog = new wxMessageDialog( parent, text, _( "Info" ),
@@ -101,6 +142,12 @@ void DisplayInfoMessage( wxWindow* parent, const wxString& text, int displaytime
 void DisplayHtmlInfoMessage( wxWindow* parent, const wxString& title,
                              const wxString& text, const wxSize& size )
 {
+    if( batchMode )
+    {
+        batchMessage( title, text );
+        return;
+    }
+
     HTML_MESSAGE_BOX dlg( parent, title, wxDefaultPosition, size );
 
     dlg.AddHTML_Text( text );
@@ -110,6 +157,12 @@ void DisplayHtmlInfoMessage( wxWindow* parent, const wxString& title,
 
 bool IsOK( wxWindow* aParent, const wxString& aMessage )
 {
+    if( batchMode )
+    {
+        batchMessage( _( "Confirmation" ), aMessage );
+        return false;
+    }
+
     wxMessageDialog dlg( aParent, aMessage, _( "Confirmation" ),
                          wxYES_NO | wxCENTRE | wxICON_QUESTION );
 
@@ -152,6 +205,12 @@ int YesNoCancelDialog( wxWindow*       aParent,
                        const wxString& aNoButtonText,
                        const wxString& aCancelButtonText )
 {
+    if( batchMode )
+    {
+        batchMessage( aPrimaryMessage, aSecondaryMessage );
+        return wxID_CANCEL;
+    }
+
     DIALOG_YES_NO_CANCEL dlg( aParent, aPrimaryMessage, aSecondaryMessage,
                               aYesButtonText, aNoButtonText, aCancelButtonText );
 
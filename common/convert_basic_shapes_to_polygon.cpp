@@ -25,6 +25,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 #include <vector>
+#include <algorithm>
 
 #include <fctsys.h>
 #include <trigo.h>
@@ -233,39 +234,101 @@ void TransformArcToPolygon( SHAPE_POLY_SET& aCornerBuffer,
                             wxPoint aCentre, wxPoint aStart, double aArcAngle,
                             int aCircleToSegmentsCount, int aWidth )
 {
-    wxPoint arc_start, arc_end;
-    int     delta = 3600 / aCircleToSegmentsCount;   // rotate angle in 0.1 degree
-
-    arc_end = arc_start = aStart;
+    wxPoint arc_start = aStart;
 
-    if( aArcAngle != 3600 )
+    if( aArcAngle < 0 )
     {
-        RotatePoint( &arc_end, aCentre, -aArcAngle );
+        RotatePoint( &arc_start, aCentre, -aArcAngle );
+        aArcAngle = -aArcAngle;
     }
 
-    if( aArcAngle < 0 )
+    double radius   = EuclideanNorm( arc_start - aCentre );
+    double halfWidth = aWidth / 2.0;
+
+    if( aArcAngle >= 3600 )
     {
-        std::swap( arc_start, arc_end );
-        aArcAngle = -aArcAngle;
+        TransformRingToPolygon( aCornerBuffer, aCentre, KiROUND( radius ),
+                                aCircleToSegmentsCount, aWidth );
+        return;
     }
 
-    // Compute the ends of segments and creates poly
-    wxPoint curr_end    = arc_start;
-    wxPoint curr_start  = arc_start;
+    int delta = 3600 / aCircleToSegmentsCount;   // rotate angle in 0.1 degree
+
+    // the distance between the ends of the arc, where its rounded ends would overlap
+    double endsDist = 2.0 * radius * sin( DECIDEG2RAD( aArcAngle ) / 2.0 );
 
-    for( int ii = delta; ii < aArcAngle; ii += delta )
+    if( radius <= halfWidth || ( aArcAngle > 1800 && endsDist < aWidth * 1.1 ) )
     {
-        curr_end = arc_start;
-        RotatePoint( &curr_end, aCentre, -ii );
-        TransformRoundedEndsSegmentToPolygon( aCornerBuffer, curr_start, curr_end,
-                                              aCircleToSegmentsCount, aWidth );
-        curr_start = curr_end;
+        // No inner side, or the ends of the arc overlap: its outline would not be
+        // simple, the arc is the union of its segments with rounded ends
+        wxPoint curr_end    = arc_start;
+        wxPoint curr_start  = arc_start;
+        wxPoint arc_end     = arc_start;
+
+        RotatePoint( &arc_end, aCentre, -aArcAngle );
+
+        for( int ii = delta; ii < aArcAngle; ii += delta )
+        {
+            curr_end = arc_start;
+            RotatePoint( &curr_end, aCentre, -ii );
+            TransformRoundedEndsSegmentToPolygon( aCornerBuffer, curr_start, curr_end,
+                                                  aCircleToSegmentsCount, aWidth );
+            curr_start = curr_end;
+        }
+
+        if( curr_end != arc_end )
+            TransformRoundedEndsSegmentToPolygon( aCornerBuffer,
+                                                  curr_end, arc_end,
+                                                  aCircleToSegmentsCount, aWidth );
+        return;
     }
 
-    if( curr_end != arc_end )
-        TransformRoundedEndsSegmentToPolygon( aCornerBuffer,
-                                              curr_end, arc_end,
-                                              aCircleToSegmentsCount, aWidth );
+    // A single outline: the outer side of the arc, the rounded end, the inner side
+    // and the rounded start, instead of a set of overlapping rounded segments.
+    int arcSteps = std::max( 1, KiROUND( ceil( aArcAngle / delta ) ) );
+    int capSteps = std::max( 2, aCircleToSegmentsCount / 2 );
+
+    double dirX = ( arc_start.x - aCentre.x ) / radius;
+    double dirY = ( arc_start.y - aCentre.y ) / radius;
+
+    aCornerBuffer.NewOutline();
+
+    for( int side = 0; side < 2; side++ )
+    {
+        // the outer side from the start to the end, then the inner side backwards
+        double sideRadius = side == 0 ? radius + halfWidth : radius - halfWidth;
+
+        for( int ii = 0; ii <= arcSteps; ii++ )
+        {
+            double angle = aArcAngle * ( side == 0 ? ii : arcSteps - ii ) / arcSteps;
+            double x = dirX * sideRadius;
+            double y = dirY * sideRadius;
+
+            RotatePoint( &x, &y, -angle );
+            aCornerBuffer.Append( aCentre.x + KiROUND( x ), aCentre.y + KiROUND( y ) );
+        }
+
+        // the rounded end around the end of the arc (from its outer side), or the
+        // rounded start around the start of the arc (from its inner side)
+        double capAngle = side == 0 ? aArcAngle : 0.0;
+        double capX = dirX * radius;
+        double capY = dirY * radius;
+
+        RotatePoint( &capX, &capY, -capAngle );
+
+        double capDirX = side == 0 ? capX / radius : -capX / radius;
+        double capDirY = side == 0 ? capY / radius : -capY / radius;
+
+        for( int ii = 1; ii < capSteps; ii++ )
+        {
+            double x = capDirX * halfWidth;
+            double y = capDirY * halfWidth;
+
+            RotatePoint( &x, &y, -1800.0 * ii / capSteps );
+            aCornerBuffer.Append( aCentre.x + KiROUND( capX + x ),
+                                  aCentre.y + KiROUND( capY + y ) );
+        }
+    }
 }
 
 
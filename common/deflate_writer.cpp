@@ -0,0 +1,177 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file deflate_writer.cpp
+ */
+
+#include <algorithm>
+#include <cstdarg>
+#include <vector>
+
+#include <fctsys.h>
+#include <pgm_base.h>
+#include <deflate_writer.h>
+
+#include <boost/bind.hpp>
+
+
+size_t DEFLATE_WRITER::SINK::OnSysWrite( const void* aBuffer, size_t aSize )
+{
+    if( m_file )
+    {
+        aSize = fwrite( aBuffer, 1, aSize, m_file );
+
+        if( ferror( m_file ) )
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+    }
+    else
+    {
+        m_string->append( (const char*) aBuffer, aSize );
+    }
+
+    m_count += aSize;
+
+    return aSize;
+}
+
+
+DEFLATE_WRITER::DEFLATE_WRITER( FILE* aOutput, int aLevel, size_t aChunkSize ) :
+    m_sink( aOutput, NULL ),
+    m_chunkSize( aChunkSize ),
+    m_tasks( Pgm().GetThreadPool() )
+{
+    init( aLevel );
+}
+
+
+DEFLATE_WRITER::DEFLATE_WRITER( std::string* aOutput, int aLevel, size_t aChunkSize ) :
+    m_sink( NULL, aOutput ),
+    m_chunkSize( aChunkSize ),
+    m_tasks( Pgm().GetThreadPool() )
+{
+    init( aLevel );
+}
+
+
+void DEFLATE_WRITER::init( int aLevel )
+{
+    /* The PDF spec is misleading, it says it wants a DEFLATE stream but it really
+     * want a ZLIB stream! (a DEFLATE stream would be generated with -15 instead of 15)
+     */
+    m_zlib = new wxZlibOutputStream( m_sink, aLevel, wxZLIB_ZLIB );
+
+    m_filling.reserve( m_chunkSize );
+    m_compressing.reserve( m_chunkSize );
+}
+
+
+DEFLATE_WRITER::~DEFLATE_WRITER()
+{
+    m_tasks.Wait();
+    delete m_zlib;
+}
+
+
+void DEFLATE_WRITER::Write( const char* aData, size_t aSize )
+{
+    wxASSERT( m_zlib );
+
+    while( aSize > 0 )
+    {
+        size_t count = std::min( aSize, m_chunkSize - m_filling.size() );
+
+        m_filling.append( aData, count );
+        aData += count;
+        aSize -= count;
+
+        if( m_filling.size() >= m_chunkSize )
+            flushChunk();
+    }
+}
+
+
+void DEFLATE_WRITER::Printf( const char* aFormat, ... )
+{
+    char    buffer[512];
+    va_list args;
+
+    va_start( args, aFormat );
+    int len = vsnprintf( buffer, sizeof( buffer ), aFormat, args );
+    va_end( args );
+
+    if( len < 0 )
+        return;
+
+    if( len < (int) sizeof( buffer ) )
+    {
+        Write( buffer, len );
+        return;
+    }
+
+    // A long text: format it again in a buffer big enough
+    std::vector<char> text( len + 1 );
+
+    va_start( args, aFormat );
+    vsnprintf( &text[0], text.size(), aFormat, args );
+    va_end( args );
+
+    Write( &text[0], len );
+}
+
+
+void DEFLATE_WRITER::flushChunk()
+{
+    // The zlib stream is not shared: one chunk is compressed at a time, in order
+    m_tasks.Wait();
+
+    m_compressing.swap( m_filling );
+    m_filling.clear();
+
+    m_tasks.Run( boost::bind( &DEFLATE_WRITER::compressChunk, this ) );
+}
+
+
+void DEFLATE_WRITER::compressChunk()
+{
+    m_zlib->Write( m_compressing.data(), m_compressing.size() );
+}
+
+
+size_t DEFLATE_WRITER::Finish()
+{
+    wxASSERT( m_zlib );
+
+    m_tasks.Wait();
+
+    if( !m_filling.empty() )
+        m_zlib->Write( m_filling.data(), m_filling.size() );
+
+    m_filling.clear();
+
+    // flush the zip stream using its destructor
+    delete m_zlib;
+    m_zlib = NULL;
+
+    return m_sink.GetCount();
+}
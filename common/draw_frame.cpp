@@ -376,7 +376,7 @@ int EDA_DRAW_FRAME::WriteHotkeyConfig( struct EDA_HOTKEY_CONFIG* aDescList, wxSt
 {
     int result = EDA_BASE_FRAME::WriteHotkeyConfig( aDescList, aFullFileName );
 
-    if( IsGalCanvasActive() )
+    if( IsGalCanvasActive() && GetToolManager() )
         GetToolManager()->UpdateHotKeys();
 
     return result;
@@ -1109,7 +1109,10 @@ void EDA_DRAW_FRAME::UseGalCanvas( bool aEnable )
         // Transfer EDA_DRAW_PANEL settings
         GetGalCanvas()->GetViewControls()->EnableCursorWarping( !m_canvas->GetEnableZoomNoCenter() );
         GetGalCanvas()->GetViewControls()->EnableMousewheelPan( m_canvas->GetEnableMousewheelPan() );
-        GetToolManager()->RunAction( "pcbnew.Control.switchCursor" );
+
+        // Some frames (GerbView) display their GAL canvas without tools
+        if( GetToolManager() )
+            GetToolManager()->RunAction( "pcbnew.Control.switchCursor" );
     }
     else if( m_galCanvasActive )
     {
@@ -638,7 +638,10 @@ void EDA_DRAW_PANEL::ReDraw( wxDC* DC, bool erasebg )
     if( erasebg )
         EraseScreen( DC );
 
+    // The lines of the items are batched by pen, they are drawn at the end of the redraw
+    GRBeginLineBatch( DC );
     GetParent()->RedrawActiveWindow( DC, erasebg );
+    GREndLineBatch();
 
     // Verfies that the clipping is working correctly.  If these two sets of numbers are
     // not the same or really close.  The clipping algorithms are broken.
@@ -747,6 +750,9 @@ void EDA_DRAW_PANEL::DrawGrid( wxDC* aDC )
     double right = ( double ) m_ClipBox.GetRight();
     double bottom = ( double ) m_ClipBox.GetBottom();
 
+    // The points are drawn directly on the DC
+    GRFlushLineBatch( aDC );
+
 #if defined( __WXMAC__ ) && defined( USE_WX_GRAPHICS_CONTEXT )
     wxGCDC *gcdc = wxDynamicCast( aDC, wxGCDC );
     if( gcdc )
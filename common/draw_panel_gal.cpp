@@ -30,7 +30,7 @@
 #include <class_draw_panel_gal.h>
 #include <view/view.h>
 #include <view/wx_view_controls.h>
-#include <pcb_painter.h>
+#include <painter.h>
 
 #include <gal/graphics_abstraction_layer.h>
 #include <gal/opengl/opengl_gal.h>
@@ -41,9 +41,7 @@
 
 #include <boost/foreach.hpp>
 
-#ifdef PROFILE
-#include <profile.h>
-#endif /* PROFILE */
+#include <frame_profiler.h>
 
 
 EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
@@ -67,15 +65,14 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
     ShowScrollbars( wxSHOW_SB_ALWAYS, wxSHOW_SB_ALWAYS );
     EnableScrolling( false, false );    // otherwise Zoom Auto disables GAL canvas
 
-    m_painter = new KIGFX::PCB_PAINTER( m_gal );
-
+    // The painter is created by the derived classes, which know the items they display
     m_view = new KIGFX::VIEW( true );
-    m_view->SetPainter( m_painter );
     m_view->SetGAL( m_gal );
 
     Connect( wxEVT_SIZE, wxSizeEventHandler( EDA_DRAW_PANEL_GAL::onSize ), NULL, this );
     Connect( wxEVT_ENTER_WINDOW, wxEventHandler( EDA_DRAW_PANEL_GAL::onEnter ), NULL, this );
     Connect( wxEVT_KILL_FOCUS, wxFocusEventHandler( EDA_DRAW_PANEL_GAL::onLostFocus ), NULL, this );
+    Connect( wxEVT_IDLE, wxIdleEventHandler( EDA_DRAW_PANEL_GAL::onIdle ), NULL, this );
 
     const wxEventType events[] =
     {
@@ -114,6 +111,22 @@ EDA_DRAW_PANEL_GAL::EDA_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWin
             wxTimerEventHandler( EDA_DRAW_PANEL_GAL::onShowTimer ), NULL, this );
     m_onShowTimer.Start( 10 );
 
+    // Frame timings are displayed on the canvas, or written to a CSV file
+    wxString profile;
+    m_profilerOverlay = false;
+
+    if( wxGetEnv( wxT( "KICAD_GAL_PROFILE" ), &profile ) && !profile.IsEmpty() )
+    {
+        KIGFX::FRAME_PROFILER& profiler = KIGFX::FRAME_PROFILER::Instance();
+
+        if( profile == wxT( "overlay" ) )
+            m_profilerOverlay = true;
+        else if( !profiler.IsEnabled() && !profiler.OpenCsv( profile.fn_str() ) )
+            wxLogWarning( wxT( "Could not create the frame profile file %s" ), GetChars( profile ) );
+
+        profiler.Enable( true );
+    }
+
     LoadGalSettings();
 }
 
@@ -157,8 +170,11 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     prof_start( &totalRealTime );
 #endif /* PROFILE */
 
+    KIGFX::FRAME_PROFILER& profiler = KIGFX::FRAME_PROFILER::Instance();
+    uint64_t frameStart = profiler.IsEnabled() ? get_tics() : 0;
+
     m_drawing = true;
-    KIGFX::PCB_RENDER_SETTINGS* settings = static_cast<KIGFX::PCB_RENDER_SETTINGS*>( m_painter->GetSettings() );
+    KIGFX::RENDER_SETTINGS* settings = m_painter->GetSettings();
 
     m_viewControls->UpdateScrollbars();
     m_view->UpdateItems();
@@ -166,8 +182,11 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
     m_gal->BeginDrawing();
     m_gal->ClearScreen( settings->GetBackgroundColor() );
 
-    KIGFX::COLOR4D gridColor = settings->GetLayerColor( ITEM_GAL_LAYER( GRID_VISIBLE ) );
-    m_gal->SetGridColor( gridColor );
+    m_gal->SetGridColor( settings->GetGridColor() );
+
+    // The overlay target is cleared, so the timings are not drawn over the previous ones
+    if( m_profilerOverlay )
+        m_view->MarkTargetDirty( KIGFX::TARGET_OVERLAY );
 
     if( m_view->IsDirty() )
     {
@@ -178,11 +197,20 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
             m_gal->DrawGrid();
 
         m_view->Redraw();
+
+        if( m_profilerOverlay )
+            drawProfilerOverlay();
     }
 
     m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
     m_gal->EndDrawing();
 
+    if( profiler.IsEnabled() )
+    {
+        profiler.AddTime( KIGFX::FRAME_PROFILER::FRAME, get_tics() - frameStart );
+        profiler.EndFrame();
+    }
+
 #ifdef PROFILE
     prof_end( &totalRealTime );
     wxLogDebug( wxT( "EDA_DRAW_PANEL_GAL::onPaint(): %.1f ms" ), totalRealTime.msecs() );
@@ -193,6 +221,51 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 }
 
 
+void EDA_DRAW_PANEL_GAL::drawProfilerOverlay()
+{
+    const KIGFX::FRAME_PROFILER& profiler = KIGFX::FRAME_PROFILER::Instance();
+    const double lineHeight = 14.0;         // in pixels
+    int line = 1;
+    KIGFX::RENDER_TARGET oldTarget = m_gal->GetTarget();
+
+    m_gal->SetTarget( KIGFX::TARGET_OVERLAY );
+    m_gal->SetLayerDepth( m_gal->GetMinDepth() );
+    m_gal->SetHorizontalJustify( GR_TEXT_HJUSTIFY_LEFT );
+    m_gal->SetVerticalJustify( GR_TEXT_VJUSTIFY_CENTER );
+    m_gal->SetFontBold( false );
+    m_gal->SetFontItalic( false );
+    m_gal->SetTextMirrored( false );
+    m_gal->SetGlyphSize( VECTOR2D( m_view->ToWorld( 8.0 ), m_view->ToWorld( 10.0 ) ) );
+    m_gal->SetLineWidth( m_view->ToWorld( 1.0 ) );
+    m_gal->SetStrokeColor( KIGFX::COLOR4D( 1.0, 1.0, 1.0, 1.0 ) );
+    m_gal->SetIsStroke( true );
+    m_gal->SetIsFill( false );
+
+    for( int i = 0; i < KIGFX::FRAME_PROFILER::PHASE_COUNT; i++, line++ )
+    {
+        KIGFX::FRAME_PROFILER::PHASE phase = (KIGFX::FRAME_PROFILER::PHASE) i;
+        wxString text = wxString::Format( wxT( "%-18s %7.2f ms (avg %7.2f)" ),
+                                          KIGFX::FRAME_PROFILER::PhaseName( phase ),
+                                          profiler.LastMsecs( phase ),
+                                          profiler.AverageMsecs( phase ) );
+
+        m_gal->BitmapText( text, m_view->ToWorld( VECTOR2D( 10.0, lineHeight * line ) ), 0.0 );
+    }
+
+    for( int i = 0; i < KIGFX::FRAME_PROFILER::COUNTER_COUNT; i++, line++ )
+    {
+        KIGFX::FRAME_PROFILER::COUNTER counter = (KIGFX::FRAME_PROFILER::COUNTER) i;
+        wxString text = wxString::Format( wxT( "%-18s %10lu" ),
+                                          KIGFX::FRAME_PROFILER::CounterName( counter ),
+                                          (unsigned long) profiler.LastCount( counter ) );
+
+        m_gal->BitmapText( text, m_view->ToWorld( VECTOR2D( 10.0, lineHeight * line ) ), 0.0 );
+    }
+
+    m_gal->SetTarget( oldTarget );
+}
+
+
 void EDA_DRAW_PANEL_GAL::onSize( wxSizeEvent& aEvent )
 {
     m_gal->ResizeScreen( aEvent.GetSize().x, aEvent.GetSize().y );
@@ -426,6 +499,16 @@ void EDA_DRAW_PANEL_GAL::onEvent( wxEvent& aEvent )
 }
 
 
+void EDA_DRAW_PANEL_GAL::onIdle( wxIdleEvent& aEvent )
+{
+    // All the queued input events were received, the tools get the last mouse motion
+    if( m_eventDispatcher )
+        m_eventDispatcher->DispatchPendingEvents();
+
+    aEvent.Skip();
+}
+
+
 void EDA_DRAW_PANEL_GAL::onEnter( wxEvent& aEvent )
 {
     // Getting focus is necessary in order to receive key events properly
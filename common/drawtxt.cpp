@@ -87,6 +87,8 @@ int Clamp_Text_PenSize( int aPenSize, wxSize aSize, bool aBold )
 
 int GraphicTextWidth( const wxString& aText, const wxSize& aSize, bool aItalic, bool aBold )
 {
+    boost::recursive_mutex::scoped_lock lock( basic_gal_lock );
+
     basic_gal.SetFontItalic( aItalic );
     basic_gal.SetFontBold( aBold );
     basic_gal.SetGlyphSize( VECTOR2D( aSize ) );
@@ -145,9 +147,6 @@ void DrawGraphicText( EDA_RECT* aClipBox,
         fill_mode = false;
     }
 
-    basic_gal.SetIsFill( fill_mode );
-    basic_gal.SetLineWidth( aWidth );
-
     EDA_TEXT dummy;
     dummy.SetItalic( aItalic );
     dummy.SetBold( aBold );
@@ -162,6 +161,11 @@ void DrawGraphicText( EDA_RECT* aClipBox,
 
     dummy.SetSize( size );
 
+    // The plotter is called back from basic_gal while it is locked
+    boost::recursive_mutex::scoped_lock lock( basic_gal_lock );
+
+    basic_gal.SetIsFill( fill_mode );
+    basic_gal.SetLineWidth( aWidth );
     basic_gal.SetTextAttributes( &dummy );
     basic_gal.SetPlotter( aPlotter );
     basic_gal.SetCallback( aCallback );
@@ -26,8 +26,10 @@
 
 #include <cstdarg>
 #include <cstdio>
-#include <cstdlib>         // bsearch()
+#include <cstdlib>
+#include <cstring>
 #include <cctype>
+#include <algorithm>
 
 #include <macros.h>
 #include <fctsys.h>
@@ -39,6 +41,115 @@
 #define FMT_CLIPBOARD       _( "clipboard" )
 
 
+//-----<KEYWORD_HASH>---------------------------------------------------------
+
+KEYWORD_HASH::KEYWORD_HASH( const KEYWORD* aKeywords, unsigned aCount ) :
+    m_mask( 0 )
+{
+    unsigned slotCount = 1;
+
+    while( slotCount < aCount )
+        slotCount <<= 1;
+
+    // a load factor of 1/2 makes the displacements quick to find, larger tables are
+    // only needed if there is a full hash collision
+    while( aCount && !build( aKeywords, aCount, slotCount * 2 ) )
+        slotCount <<= 1;
+}
+
+
+bool KEYWORD_HASH::build( const KEYWORD* aKeywords, unsigned aCount, unsigned aSlotCount )
+{
+    const unsigned  maxDisplacement = 1 << 16;
+    unsigned        bucketCount = aCount / 4 + 1;
+
+    std::vector< std::vector<unsigned> > buckets( bucketCount );
+    std::vector<uint64_t> hashes( aCount );
+
+    for( unsigned i = 0; i < aCount; ++i )
+    {
+        hashes[i] = hash( aKeywords[i].name, strlen( aKeywords[i].name ) );
+        buckets[hashes[i] % bucketCount].push_back( i );
+    }
+
+    SLOT empty = { NULL, 0, DSN_SYMBOL };
+
+    m_slots.assign( aSlotCount, empty );
+    m_displacements.assign( bucketCount, 0 );
+    m_mask = aSlotCount - 1;
+
+    // the largest buckets are placed first, while there are many free slots
+    std::vector<unsigned> order;
+
+    for( unsigned size = aCount; size > 0; --size )
+    {
+        for( unsigned b = 0; b < bucketCount; ++b )
+        {
+            if( buckets[b].size() == size )
+                order.push_back( b );
+        }
+    }
+
+    std::vector<unsigned> taken;
+
+    for( unsigned i = 0; i < order.size(); ++i )
+    {
+        const std::vector<unsigned>& bucket = buckets[order[i]];
+        unsigned d;
+
+        for( d = 0; d < maxDisplacement; ++d )
+        {
+            taken.clear();
+
+            for( unsigned k = 0; k < bucket.size(); ++k )
+            {
+                unsigned s = slot( hashes[bucket[k]], d );
+
+                if( m_slots[s].name || std::find( taken.begin(), taken.end(), s ) != taken.end() )
+                    break;
+
+                taken.push_back( s );
+            }
+
+            if( taken.size() == bucket.size() )
+                break;
+        }
+
+        if( d == maxDisplacement )
+            return false;
+
+        m_displacements[order[i]] = d;
+
+        for( unsigned k = 0; k < bucket.size(); ++k )
+        {
+            const KEYWORD& kw = aKeywords[bucket[k]];
+            SLOT& entry = m_slots[taken[k]];
+
+            entry.name   = kw.name;
+            entry.length = strlen( kw.name );
+            entry.token  = kw.token;
+        }
+    }
+
+    return true;
+}
+
+
+int KEYWORD_HASH::Find( const char* aText, size_t aLength ) const
+{
+    if( m_slots.empty() )
+        return DSN_SYMBOL;
+
+    uint64_t    h = hash( aText, aLength );
+    const SLOT& entry = m_slots[slot( h, m_displacements[h % m_displacements.size()] )];
+
+    if( entry.name && entry.length == aLength && !memcmp( entry.name, aText, aLength ) )
+        return entry.token;
+
+    return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
+}
+
+
 //-----<DSNLEXER>-------------------------------------------------------------
 
 void DSNLEXER::init()
@@ -54,34 +165,26 @@ void DSNLEXER::init()
 
     curOffset = 0;
 
-#if 1
-    if( keywordCount > 11 )
-    {
-        // resize the hashtable bucket count
-        keyword_hash.reserve( keywordCount );
-    }
-
-    // fill the specialized "C string" hashtable from keywords[]
-    const KEYWORD*  it  = keywords;
-    const KEYWORD*  end = it + keywordCount;
-
-    for( ; it < end; ++it )
+    if( !keywordHash )
     {
-        keyword_hash[it->name] = it->token;
+        ownKeywordHash = new KEYWORD_HASH( keywords, keywordCount );
+        keywordHash = ownKeywordHash;
     }
-#endif
 }
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    FILE* aFile, const wxString& aFilename ) :
+                    FILE* aFile, const wxString& aFilename,
+                    const KEYWORD_HASH* aKeywordHash ) :
     iOwnReaders( true ),
     start( NULL ),
     next( NULL ),
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordHash( aKeywordHash ),
+    ownKeywordHash( NULL )
 {
     FILE_LINE_READER* fileReader = new FILE_LINE_READER( aFile, aFilename );
     PushReader( fileReader );
@@ -90,14 +193,17 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    const std::string& aClipboardTxt, const wxString& aSource ) :
+                    const std::string& aClipboardTxt, const wxString& aSource,
+                    const KEYWORD_HASH* aKeywordHash ) :
     iOwnReaders( true ),
     start( NULL ),
     next( NULL ),
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordHash( aKeywordHash ),
+    ownKeywordHash( NULL )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aClipboardTxt, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -107,14 +213,16 @@ DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
 
 
 DSNLEXER::DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-                    LINE_READER* aLineReader ) :
+                    LINE_READER* aLineReader, const KEYWORD_HASH* aKeywordHash ) :
     iOwnReaders( false ),
     start( NULL ),
     next( NULL ),
     limit( NULL ),
     reader( NULL ),
     keywords( aKeywordTable ),
-    keywordCount( aKeywordCount )
+    keywordCount( aKeywordCount ),
+    keywordHash( aKeywordHash ),
+    ownKeywordHash( NULL )
 {
     if( aLineReader )
         PushReader( aLineReader );
@@ -131,7 +239,9 @@ DSNLEXER::DSNLEXER( const std::string& aSExpression, const wxString& aSource ) :
     limit( NULL ),
     reader( NULL ),
     keywords( empty_keywords ),
-    keywordCount( 0 )
+    keywordCount( 0 ),
+    keywordHash( NULL ),
+    ownKeywordHash( NULL )
 {
     STRING_LINE_READER* stringReader = new STRING_LINE_READER( aSExpression, aSource.IsEmpty() ?
                                         wxString( FMT_CLIPBOARD ) : aSource );
@@ -142,6 +252,8 @@ DSNLEXER::DSNLEXER( const std::string& aSExpression, const wxString& aSource ) :
 
 DSNLEXER::~DSNLEXER()
 {
+    delete ownKeywordHash;
+
     if( iOwnReaders )
     {
         // delete the LINE_READERs from the stack, since I own them.
@@ -231,42 +343,6 @@ LINE_READER* DSNLEXER::PopReader()
 }
 
 
-#if 0
-static int compare( const void* a1, const void* a2 )
-{
-    const KEYWORD* k1 = (const KEYWORD*) a1;
-    const KEYWORD* k2 = (const KEYWORD*) a2;
-
-    int ret = strcmp( k1->name, k2->name );
-    return ret;
-}
-
-int DSNLEXER::findToken( const std::string& tok )
-{
-    KEYWORD search;
-
-    search.name = tok.c_str();
-
-    const KEYWORD* findings = (const KEYWORD*) bsearch( &search,
-                                   keywords, keywordCount,
-                                   sizeof(KEYWORD), compare );
-    if( findings )
-        return findings->token;
-    else
-        return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
-}
-
-#else
-
-inline int DSNLEXER::findToken( const std::string& tok )
-{
-    KEYWORD_MAP::const_iterator it = keyword_hash.find( tok.c_str() );
-    if( it != keyword_hash.end() )
-        return it->second;
-
-    return DSN_SYMBOL;      // not a keyword, some arbitrary symbol.
-}
-#endif
 
 
 const char* DSNLEXER::Syntax( int aTok )
@@ -541,6 +617,12 @@ static bool isNumber( const char* cp, const char* limit )
 }
 
 
+bool DSNLEXER::IsNumber( const char* aStart, const char* aLimit )
+{
+    return isNumber( aStart, aLimit );
+}
+
+
 int DSNLEXER::NextTok() throw( IO_ERROR )
 {
     const char*   cur  = next;
@@ -97,6 +97,8 @@ void EDA_TEXT::SetOrientation( double aOrientation )
 
 int EDA_TEXT::LenSize( const wxString& aLine ) const
 {
+    boost::recursive_mutex::scoped_lock lock( basic_gal_lock );
+
     basic_gal.SetFontItalic( m_Italic );
     basic_gal.SetFontBold( m_Bold );
     basic_gal.SetGlyphSize( VECTOR2D( m_Size ) );
@@ -168,7 +170,9 @@ EDA_RECT EDA_TEXT::GetTextBox( int aLine, int aThickness, bool aInvertY ) const
         }
     }
 
-    // calculate the H and V size
+    // calculate the H and V size, with the font of the shared basic_gal
+    boost::recursive_mutex::scoped_lock lock( basic_gal_lock );
+
     int dx = KiROUND( basic_gal.GetStrokeFont().ComputeStringBoundaryLimits(
                             text, VECTOR2D( m_Size ), double( thickness ) ).x );
     int dy = GetInterline( thickness );
@@ -27,14 +27,6 @@
  * @file footprint_info.cpp
  */
 
-
-/**
-    No. concurrent threads doing "http(s) GET". More than 6 is not significantly
-    faster, less than 6 is likely slower. Main thread is in this count, so if
-    set to 1 then no temp threads are created.
-*/
-#define READER_THREADS      6
-
 /*
  * Functions to read footprint libraries and fill m_footprints by available footprints names
  * and their documentation (comments and keywords)
@@ -50,9 +42,14 @@
 #include <fp_lib_table.h>
 #include <fpid.h>
 #include <class_module.h>
-#include <boost/thread.hpp>
+#include <richio.h>
+#include <thread_pool.h>
+#include <boost/bind.hpp>
 #include <html_messagebox.h>
 
+#include <wx/dir.h>
+#include <wx/filename.h>
+
 
 /*
 static wxString ToHTMLFragment( const IO_ERROR* aDerivative )
@@ -125,6 +122,254 @@ void FOOTPRINT_INFO::load()
 }
 
 
+#define INDEX_HEADER        "kicad-footprint-index 1"
+
+
+wxString FOOTPRINT_INDEX::GetFileName()
+{
+    wxFileName fn( GetKicadConfigPath(), wxT( "fp-info-cache" ) );
+
+    return fn.GetFullPath();
+}
+
+
+static uint64_t hashString( uint64_t aHash, const wxString& aText )
+{
+    std::string text = TO_UTF8( aText );
+
+    // FNV-1a
+    for( unsigned i = 0;  i < text.size();  ++i )
+    {
+        aHash ^= (unsigned char) text[i];
+        aHash *= 1099511628211ull;
+    }
+
+    return aHash;
+}
+
+
+static uint64_t fileHash( const wxString& aPath )
+{
+    wxFileName  fn( aPath );
+    uint64_t    h = hashString( 14695981039346656037ull, fn.GetFullName() );
+
+    h = ( h ^ fn.GetModificationTime().GetValue().GetValue() ) * 1099511628211ull;
+    h = ( h ^ fn.GetSize().GetValue() ) * 1099511628211ull;
+
+    return h;
+}
+
+
+wxString FOOTPRINT_INDEX::LibraryTimestamp( const wxString& aLibraryPath )
+{
+    uint64_t    h = 0;
+
+    if( wxDir::Exists( aLibraryPath ) )
+    {
+        // A footprint per file: the hashes of the files are summed, since the order they
+        // are listed in is unspecified
+        wxDir       dir( aLibraryPath );
+        wxString    name;
+
+        if( !dir.IsOpened() )
+            return wxEmptyString;
+
+        for( bool cont = dir.GetFirst( &name, wxEmptyString, wxDIR_FILES );  cont;
+             cont = dir.GetNext( &name ) )
+        {
+            h += fileHash( wxFileName( aLibraryPath, name ).GetFullPath() );
+        }
+    }
+    else if( wxFileName::FileExists( aLibraryPath ) )
+        h = fileHash( aLibraryPath );
+    else
+        return wxEmptyString;       // a remote library
+
+    return wxString::Format( wxT( "%08x%08x" ), (unsigned) ( h >> 32 ), (unsigned) h );
+}
+
+
+/// Escapes the tabs, newlines and backslashes of aText, the separators of the index file
+static std::string escapeField( const wxString& aText )
+{
+    std::string text = TO_UTF8( aText );
+    std::string ret;
+
+    for( unsigned i = 0;  i < text.size();  ++i )
+    {
+        switch( text[i] )
+        {
+        case '\\':   ret += "\\\\";   break;
+        case '\t':   ret += "\\t";    break;
+        case '\n':   ret += "\\n";    break;
+        case '\r':   ret += "\\r";    break;
+        default:     ret += text[i];  break;
+        }
+    }
+
+    return ret;
+}
+
+
+static wxString unescapeField( const std::string& aText )
+{
+    std::string text;
+
+    for( unsigned i = 0;  i < aText.size();  ++i )
+    {
+        if( aText[i] == '\\' && i + 1 < aText.size() )
+        {
+            switch( aText[++i] )
+            {
+            case 't':   text += '\t';        break;
+            case 'n':   text += '\n';        break;
+            case 'r':   text += '\r';        break;
+            default:    text += aText[i];    break;
+            }
+        }
+        else
+            text += aText[i];
+    }
+
+    return FROM_UTF8( text.c_str() );
+}
+
+
+/// Splits a line of the index file at its tabs
+static void splitFields( const char* aLine, std::vector<std::string>& aFields )
+{
+    aFields.clear();
+    aFields.push_back( std::string() );
+
+    for( const char* cc = aLine;  *cc && *cc != '\n' && *cc != '\r';  ++cc )
+    {
+        if( *cc == '\t' )
+            aFields.push_back( std::string() );
+        else
+            aFields.back() += *cc;
+    }
+}
+
+
+void FOOTPRINT_INDEX::Load( const wxString& aFileName )
+{
+    m_libraries.clear();
+    m_loaded = true;
+    m_modified = false;
+
+    if( !wxFileName::FileExists( aFileName ) )
+        return;
+
+    try
+    {
+        FILE_LINE_READER            reader( aFileName );
+        std::vector<std::string>    fields;
+        LIBRARY*                    library = NULL;
+        char*                       line = reader.ReadLine();
+
+        if( !line || strncmp( line, INDEX_HEADER, strlen( INDEX_HEADER ) ) )
+            return;     // another version, it will be replaced
+
+        while( ( line = reader.ReadLine() ) != NULL )
+        {
+            splitFields( line, fields );
+
+            // "L nickname uri timestamp" starts a library, "F name pads unique_pads doc
+            // keywords" is one of its footprints
+            if( fields[0] == "L" && fields.size() == 4 )
+            {
+                library = &m_libraries[ unescapeField( fields[1] ) ];
+                library->m_uri = unescapeField( fields[2] );
+                library->m_timestamp = unescapeField( fields[3] );
+                library->m_entries.clear();
+            }
+            else if( fields[0] == "F" && fields.size() == 6 && library )
+            {
+                ENTRY entry;
+
+                entry.m_fpname = unescapeField( fields[1] );
+                entry.m_pad_count = atoi( fields[2].c_str() );
+                entry.m_unique_pad_count = atoi( fields[3].c_str() );
+                entry.m_doc = unescapeField( fields[4] );
+                entry.m_keywords = unescapeField( fields[5] );
+
+                library->m_entries.push_back( entry );
+            }
+            else
+            {
+                // a damaged index
+                m_libraries.clear();
+                return;
+            }
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+        m_libraries.clear();
+    }
+}
+
+
+bool FOOTPRINT_INDEX::Save( const wxString& aFileName )
+{
+    try
+    {
+        FILE_OUTPUTFORMATTER out( aFileName );
+
+        out.Print( 0, "%s\n", INDEX_HEADER );
+
+        for( LIBRARIES::const_iterator it = m_libraries.begin();  it != m_libraries.end();  ++it )
+        {
+            const LIBRARY& library = it->second;
+
+            out.Print( 0, "L\t%s\t%s\t%s\n", escapeField( it->first ).c_str(),
+                       escapeField( library.m_uri ).c_str(),
+                       escapeField( library.m_timestamp ).c_str() );
+
+            for( unsigned i = 0;  i < library.m_entries.size();  ++i )
+            {
+                const ENTRY& entry = library.m_entries[i];
+
+                out.Print( 0, "F\t%s\t%d\t%d\t%s\t%s\n", escapeField( entry.m_fpname ).c_str(),
+                           entry.m_pad_count, entry.m_unique_pad_count,
+                           escapeField( entry.m_doc ).c_str(),
+                           escapeField( entry.m_keywords ).c_str() );
+            }
+        }
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    m_modified = false;
+
+    return true;
+}
+
+
+bool FOOTPRINT_INDEX::Find( const wxString& aNickname, const wxString& aURI,
+                            const wxString& aTimestamp, LIBRARY& aLibrary ) const
+{
+    LIBRARIES::const_iterator it = m_libraries.find( aNickname );
+
+    if( it == m_libraries.end() || it->second.m_uri != aURI
+        || it->second.m_timestamp != aTimestamp )
+        return false;
+
+    aLibrary = it->second;
+
+    return true;
+}
+
+
+void FOOTPRINT_INDEX::Set( const wxString& aNickname, const LIBRARY& aLibrary )
+{
+    m_libraries[aNickname] = aLibrary;
+    m_modified = true;
+}
+
+
 void FOOTPRINT_LIST::loader_job( const wxString* aNicknameList, int aJobZ )
 {
     for( int i=0; i<aJobZ; ++i )
@@ -133,6 +378,30 @@ void FOOTPRINT_LIST::loader_job( const wxString* aNicknameList, int aJobZ )
 
         try
         {
+            FOOTPRINT_INDEX::LIBRARY library;
+
+            library.m_uri = m_lib_table->FindRow( nickname )->GetFullURI( true );
+            library.m_timestamp = FOOTPRINT_INDEX::LibraryTimestamp( library.m_uri );
+
+            bool indexed;
+
+            {
+                MUTLOCK lock( m_index_lock );
+
+                m_library_stamps[nickname] = library.m_uri + wxT( "\t" ) + library.m_timestamp;
+
+                indexed = !library.m_timestamp.IsEmpty()
+                          && m_index.Find( nickname, library.m_uri, library.m_timestamp, library );
+            }
+
+            if( indexed )
+            {
+                for( unsigned ni=0;  ni<library.m_entries.size();  ++ni )
+                    addItem( new FOOTPRINT_INFO( this, nickname, library.m_entries[ni] ) );
+
+                continue;
+            }
+
             wxArrayString fpnames = m_lib_table->FootprintEnumerate( nickname );
 
             for( unsigned ni=0;  ni<fpnames.GetCount();  ++ni )
@@ -140,6 +409,23 @@ void FOOTPRINT_LIST::loader_job( const wxString* aNicknameList, int aJobZ )
                 FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO( this, nickname, fpnames[ni] );
 
                 addItem( fpinfo );
+
+                FOOTPRINT_INDEX::ENTRY entry;
+
+                entry.m_fpname = fpnames[ni];
+                entry.m_doc = fpinfo->GetDoc();
+                entry.m_keywords = fpinfo->GetKeywords();
+                entry.m_pad_count = fpinfo->GetPadCount();
+                entry.m_unique_pad_count = fpinfo->GetUniquePadCount();
+
+                library.m_entries.push_back( entry );
+            }
+
+            if( !library.m_timestamp.IsEmpty() )
+            {
+                MUTLOCK lock( m_index_lock );
+
+                m_index.Set( nickname, library );
             }
         }
         catch( const PARSE_ERROR& pe )
@@ -186,11 +472,16 @@ bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* a
     bool retv = true;
 
     m_lib_table = aTable;
+    m_all_libraries = !aNickname;
 
     // Clear data before reading files
     m_error_count = 0;
     m_errors.clear();
     m_list.clear();
+    m_library_stamps.clear();
+
+    if( !m_index.IsLoaded() )
+        m_index.Load( FOOTPRINT_INDEX::GetFileName() );
 
     if( aNickname )
         // single footprint
@@ -202,56 +493,27 @@ bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* a
         // do all of them
         nicknames = aTable->GetLogicalLibs();
 
-        // Even though the PLUGIN API implementation is the place for the
-        // locale toggling, in order to keep LOCAL_IO::C_count at 1 or greater
-        // for the duration of all helper threads, we increment by one here via instantiation.
-        // Only done here because of the multi-threaded nature of this code.
-        // Without this C_count skips in and out of "equal to zero" and causes
-        // needless locale toggling among the threads, based on which of them
-        // are in a PLUGIN::FootprintLoad() function.  And that is occasionally
-        // none of them.
+        // The locale of the loader threads is the one of this thread: in the "C" locale,
+        // the jobs queued below run in the "C" locale too, without switching it back and
+        // forth in each PLUGIN::FootprintLoad() call.
         LOCALE_IO   top_most_nesting;
 
-        // Something which will not invoke a thread copy constructor, one of many ways obviously:
-        typedef boost::ptr_vector< boost::thread >  MYTHREADS;
-
-        MYTHREADS threads;
+        // A job per library, on the threads of the process.  The libraries are read
+        // from the disk or by "http(s) GET", the waiting thread runs jobs too.
+        TASK_GROUP jobs( Pgm().GetThreadPool() );
 
-        unsigned jobz = (nicknames.size() + READER_THREADS - 1) / READER_THREADS;
+        for( unsigned i=0; i<nicknames.size();  ++i )
+            jobs.Run( boost::bind( &FOOTPRINT_LIST::loader_job, this, &nicknames[i], 1 ) );
 
-        // Give each thread JOBZ nicknames to process.  The last portion of, or if the entire
-        // size() is small, I'll do myself.
-        for( unsigned i=0; i<nicknames.size();  )
-        {
-            if( i + jobz >= nicknames.size() )  // on the last iteration of this for(;;)
-            {
-                jobz = nicknames.size() - i;
-
-                // Only a little bit to do, I'll do it myself on current thread.
-                // I am part of the READER_THREADS count.
-                loader_job( &nicknames[i], jobz );
-            }
-            else
-            {
-                // Delegate the job to a temporary thread created here.
-                threads.push_back( new boost::thread( &FOOTPRINT_LIST::loader_job,
-                        this, &nicknames[i], jobz ) );
-            }
-
-            i += jobz;
-        }
-
-        // Wait for all the worker threads to complete, it does not matter in what order
-        // we wait for them as long as a full sweep is made.  Think of the great race,
-        // everyone must finish.
-        for( unsigned i=0;  i<threads.size();  ++i )
-        {
-            threads[i].join();
-        }
+        // loader_job() catches its exceptions
+        jobs.Wait();
 
         m_list.sort();
     }
 
+    if( m_index.IsModified() )
+        m_index.Save( FOOTPRINT_INDEX::GetFileName() );
+
     // The result of this function can be a blend of successes and failures, whose
     // mix is given by the Count()s of the two lists.  The return value indicates whether
     // an abort occurred, even true does not necessarily mean full success, although
@@ -261,22 +523,89 @@ bool FOOTPRINT_LIST::ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* a
 }
 
 
+bool FOOTPRINT_LIST::IsUpToDate( FP_LIB_TABLE* aTable ) const
+{
+    if( aTable != m_lib_table || !m_all_libraries || !m_errors.empty() )
+        return false;
+
+    std::vector<wxString> nicknames = aTable->GetLogicalLibs();
+
+    if( nicknames.size() != m_library_stamps.size() )
+        return false;
+
+    for( unsigned i = 0;  i < nicknames.size();  ++i )
+    {
+        LIBRARY_STAMPS::const_iterator it = m_library_stamps.find( nicknames[i] );
+
+        if( it == m_library_stamps.end() )
+            return false;
+
+        try
+        {
+            wxString uri = aTable->FindRow( nicknames[i] )->GetFullURI( true );
+
+            if( it->second != uri + wxT( "\t" ) + FOOTPRINT_INDEX::LibraryTimestamp( uri ) )
+                return false;
+        }
+        catch( const IO_ERROR& )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+boost::shared_ptr<FOOTPRINT_LIST> SHARED_FOOTPRINT_LIST::Get( FP_LIB_TABLE* aTable )
+{
+    // The libraries are read by one caller at a time, the others wait for its list
+    // rather than reading them too
+    MUTLOCK read_lock( m_read_lock );
+
+    boost::shared_ptr<FOOTPRINT_LIST> list;
+
+    {
+        MUTLOCK lock( m_list_lock );
+
+        list = m_list;
+    }
+
+    if( list && list->IsUpToDate( aTable ) )
+        return list;
+
+    // A new list, the snapshots held by the readers of the previous one stay valid
+    list.reset( new FOOTPRINT_LIST );
+    list->ReadFootprintFiles( aTable );
+
+    MUTLOCK lock( m_list_lock );
+
+    m_list = list;
+
+    return list;
+}
+
+
 FOOTPRINT_INFO* FOOTPRINT_LIST::GetModuleInfo( const wxString& aFootprintName )
 {
     if( aFootprintName.IsEmpty() )
         return NULL;
 
-    BOOST_FOREACH( FOOTPRINT_INFO& fp, m_list )
-    {
-        FPID fpid;
+    if( m_list.empty() )
+        return NULL;
 
-        wxCHECK_MSG( fpid.Parse( aFootprintName ) < 0, NULL,
-                     wxString::Format( wxT( "'%s' is not a valid FPID." ),
-                                       GetChars( aFootprintName ) ) );
+    // Parsed once, not for each footprint of the list
+    FPID fpid;
 
-        wxString libNickname   = fpid.GetLibNickname();
-        wxString footprintName = fpid.GetFootprintName();
+    wxCHECK_MSG( fpid.Parse( aFootprintName ) < 0, NULL,
+                 wxString::Format( wxT( "'%s' is not a valid FPID." ),
+                                   GetChars( aFootprintName ) ) );
 
+    wxString libNickname   = fpid.GetLibNickname();
+    wxString footprintName = fpid.GetFootprintName();
+
+    BOOST_FOREACH( FOOTPRINT_INFO& fp, m_list )
+    {
         if( libNickname == fp.GetNickname() && footprintName == fp.GetFootprintName() )
             return &fp;
     }
@@ -24,6 +24,10 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 #include <wx/image.h>
 #include <wx/log.h>
 
@@ -53,6 +57,8 @@ CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
     isDeleteSavedPixels = false;
     validCompositor     = false;
     groupCounter        = 0;
+    currentTarget       = TARGET_CACHED;
+    tileHeight          = 0;
 
     // Connecting the event handlers
     Connect( wxEVT_PAINT,       wxPaintEventHandler( CAIRO_GAL::onPaint ) );
@@ -92,6 +98,7 @@ CAIRO_GAL::~CAIRO_GAL()
 {
     deinitSurface();
     deleteBitmaps();
+    deleteTiles();
 
     delete cursorPixels;
     delete cursorPixelsSaved;
@@ -274,6 +281,7 @@ void CAIRO_GAL::ResizeScreen( int aWidth, int aHeight )
     // Recreate the bitmaps
     deleteBitmaps();
     allocateBitmaps();
+    deleteTiles();
 
     if( validCompositor )
         compositor->Resize( aWidth, aHeight );
@@ -297,6 +305,7 @@ bool CAIRO_GAL::Show( bool aShow )
 
 void CAIRO_GAL::Flush()
 {
+    drawTiles();
     storePath();
 }
 
@@ -406,7 +415,7 @@ void CAIRO_GAL::SetLayerDepth( double aLayerDepth )
 
     if( isInitialized )
     {
-        storePath();
+        Flush();
 
         cairo_pop_group_to_source( currentContext );
         cairo_paint_with_alpha( currentContext, LAYER_ALPHA );
@@ -550,87 +559,130 @@ void CAIRO_GAL::EndGroup()
 
 
 void CAIRO_GAL::DrawGroup( int aGroupNumber )
+{
+    storePath();
+
+    REPLAY_STATE state = { isFillEnabled, isStrokeEnabled, fillColor, strokeColor };
+
+    if( isTiling() )
+    {
+        // The group is rendered later, with the current settings. Its settings and
+        // transformations are applied now, as the groups drawn next start from them.
+        TILED_GROUP tiled;
+
+        tiled.groupNumber = aGroupNumber;
+        tiled.state = state;
+        cairo_get_matrix( currentContext, &tiled.matrix );
+        tiled.lineWidth = cairo_get_line_width( currentContext );
+        tiledGroups.push_back( tiled );
+
+        replayGroup( currentContext, aGroupNumber, state, false );
+    }
+    else
+    {
+        replayGroup( currentContext, aGroupNumber, state, true );
+    }
+
+    isFillEnabled   = state.isFillEnabled;
+    isStrokeEnabled = state.isStrokeEnabled;
+    fillColor       = state.fillColor;
+    strokeColor     = state.strokeColor;
+}
+
+
+void CAIRO_GAL::replayGroup( cairo_t* aContext, int aGroupNumber, REPLAY_STATE& aState,
+                             bool aDraw ) const
 {
     // This method implements a small Virtual Machine - all stored commands
     // are executed; nested calling is also possible
 
-    storePath();
+    std::map<int, GROUP>::const_iterator group = groups.find( aGroupNumber );
 
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
+    if( group == groups.end() )
+        return;
+
+    for( GROUP::const_iterator it = group->second.begin(); it != group->second.end(); ++it )
     {
         switch( it->command )
         {
         case CMD_SET_FILL:
-            isFillEnabled = it->boolArgument;
+            aState.isFillEnabled = it->boolArgument;
             break;
 
         case CMD_SET_STROKE:
-            isStrokeEnabled = it->boolArgument;
+            aState.isStrokeEnabled = it->boolArgument;
             break;
 
         case CMD_SET_FILLCOLOR:
-            fillColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
-                                 it->arguments[3] );
+            aState.fillColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
+                                        it->arguments[3] );
             break;
 
         case CMD_SET_STROKECOLOR:
-            strokeColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
-                                   it->arguments[3] );
+            aState.strokeColor = COLOR4D( it->arguments[0], it->arguments[1],
+                                          it->arguments[2], it->arguments[3] );
             break;
 
         case CMD_SET_LINE_WIDTH:
             {
                 // Make lines appear at least 1 pixel wide, no matter of zoom
                 double x = 1.0, y = 1.0;
-                cairo_device_to_user_distance( currentContext, &x, &y );
+                cairo_device_to_user_distance( aContext, &x, &y );
                 double minWidth = std::min( fabs( x ), fabs( y ) );
-                cairo_set_line_width( currentContext, std::max( it->arguments[0], minWidth ) );
+                cairo_set_line_width( aContext, std::max( it->arguments[0], minWidth ) );
             }
             break;
 
 
         case CMD_STROKE_PATH:
-            cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g, strokeColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
+            if( !aDraw )
+                break;
+
+            cairo_set_source_rgb( aContext, aState.strokeColor.r, aState.strokeColor.g,
+                                  aState.strokeColor.b );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_stroke( aContext );
             break;
 
         case CMD_FILL_PATH:
-            cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
+            if( !aDraw )
+                break;
+
+            cairo_set_source_rgb( aContext, aState.fillColor.r, aState.fillColor.g,
+                                  aState.fillColor.b );
+            cairo_append_path( aContext, it->cairoPath );
+            cairo_fill( aContext );
             break;
 
         case CMD_TRANSFORM:
             cairo_matrix_t matrix;
             cairo_matrix_init( &matrix, it->arguments[0], it->arguments[1], it->arguments[2],
                                it->arguments[3], it->arguments[4], it->arguments[5] );
-            cairo_transform( currentContext, &matrix );
+            cairo_transform( aContext, &matrix );
             break;
 
         case CMD_ROTATE:
-            cairo_rotate( currentContext, it->arguments[0] );
+            cairo_rotate( aContext, it->arguments[0] );
             break;
 
         case CMD_TRANSLATE:
-            cairo_translate( currentContext, it->arguments[0], it->arguments[1] );
+            cairo_translate( aContext, it->arguments[0], it->arguments[1] );
             break;
 
         case CMD_SCALE:
-            cairo_scale( currentContext, it->arguments[0], it->arguments[1] );
+            cairo_scale( aContext, it->arguments[0], it->arguments[1] );
             break;
 
         case CMD_SAVE:
-            cairo_save( currentContext );
+            cairo_save( aContext );
             break;
 
         case CMD_RESTORE:
-            cairo_restore( currentContext );
+            cairo_restore( aContext );
             break;
 
         case CMD_CALL_GROUP:
-            DrawGroup( it->intArgument );
+            replayGroup( aContext, it->intArgument, aState, aDraw );
             break;
         }
     }
@@ -693,6 +745,8 @@ void CAIRO_GAL::ClearCache()
 
 void CAIRO_GAL::SaveScreen()
 {
+    drawTiles();
+
     // Copy the current bitmap to the backup buffer
     int offset = 0;
 
@@ -732,7 +786,7 @@ void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
     // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
     if( isInitialized )
     {
-        storePath();
+        Flush();
 
         cairo_pop_group_to_source( currentContext );
         cairo_paint_with_alpha( currentContext, LAYER_ALPHA );
@@ -766,6 +820,8 @@ RENDER_TARGET CAIRO_GAL::GetTarget() const
 
 void CAIRO_GAL::ClearTarget( RENDER_TARGET aTarget )
 {
+    drawTiles();
+
     // Save the current state
     unsigned int currentBuffer = compositor->GetBuffer();
 
@@ -821,6 +877,10 @@ void CAIRO_GAL::storePath()
     {
         isElementAdded = false;
 
+        // The path is drawn over the groups drawn before
+        if( !isGrouping )
+            drawTiles();
+
         if( !isGrouping )
         {
             if( isFillEnabled )
@@ -863,6 +923,102 @@ void CAIRO_GAL::storePath()
 }
 
 
+bool CAIRO_GAL::isTiling() const
+{
+#ifdef USE_OPENMP
+    // Only the cached target is made of groups, the other ones are drawn immediately
+    return isInitialized && validCompositor && !isGrouping && currentTarget == TARGET_CACHED
+           && omp_get_max_threads() > 1;
+#else
+    return false;
+#endif /* USE_OPENMP */
+}
+
+
+void CAIRO_GAL::drawTiles()
+{
+    if( tiledGroups.empty() )
+        return;
+
+    if( tileSurfaces.empty() )
+    {
+        int tileCount = 1;
+
+#ifdef USE_OPENMP
+        // More bands than threads, so that the threads are busy when the items are not
+        // evenly spread on the screen
+        tileCount = std::max( 1, std::min( 2 * omp_get_max_threads(), screenSize.y / 32 ) );
+#endif /* USE_OPENMP */
+        tileHeight = ( screenSize.y + tileCount - 1 ) / tileCount;
+
+        for( int i = 0; i < tileCount; ++i )
+        {
+            tileSurfaces.push_back( cairo_image_surface_create( CAIRO_FORMAT_ARGB32,
+                                                                screenSize.x, tileHeight ) );
+        }
+    }
+
+    const int tileCount = tileSurfaces.size();
+
+    // Each band is rendered by a thread, with its own context. The groups are only read.
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+    for( int i = 0; i < tileCount; ++i )
+    {
+        cairo_t* tileContext = cairo_create( tileSurfaces[i] );
+
+        cairo_set_operator( tileContext, CAIRO_OPERATOR_CLEAR );
+        cairo_paint( tileContext );
+        cairo_set_operator( tileContext, CAIRO_OPERATOR_OVER );
+
+        cairo_set_antialias( tileContext, CAIRO_ANTIALIAS_SUBPIXEL );
+        cairo_set_line_join( tileContext, CAIRO_LINE_JOIN_ROUND );
+        cairo_set_line_cap( tileContext, CAIRO_LINE_CAP_ROUND );
+
+        for( std::vector<TILED_GROUP>::const_iterator it = tiledGroups.begin();
+             it != tiledGroups.end(); ++it )
+        {
+            // The band starts at the row i * tileHeight of the screen
+            cairo_matrix_t matrix = it->matrix;
+            matrix.y0 -= i * tileHeight;
+
+            REPLAY_STATE state = it->state;
+
+            cairo_set_matrix( tileContext, &matrix );
+            cairo_set_line_width( tileContext, it->lineWidth );
+            replayGroup( tileContext, it->groupNumber, state, true );
+        }
+
+        cairo_destroy( tileContext );
+    }
+
+    tiledGroups.clear();
+
+    // Composite the bands, using screen coordinates
+    cairo_save( currentContext );
+    cairo_identity_matrix( currentContext );
+
+    for( int i = 0; i < tileCount; ++i )
+    {
+        cairo_set_source_surface( currentContext, tileSurfaces[i], 0.0, i * tileHeight );
+        cairo_paint( currentContext );
+    }
+
+    cairo_restore( currentContext );
+}
+
+
+void CAIRO_GAL::deleteTiles()
+{
+    for( unsigned int i = 0; i < tileSurfaces.size(); ++i )
+        cairo_surface_destroy( tileSurfaces[i] );
+
+    tileSurfaces.clear();
+    tiledGroups.clear();
+}
+
+
 void CAIRO_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 {
     PostPaint();
@@ -1003,6 +1159,8 @@ void CAIRO_GAL::deinitSurface()
     if( !isInitialized )
         return;
 
+    drawTiles();
+
     // Destroy Cairo objects
     cairo_destroy( context );
     cairo_surface_destroy( surface );
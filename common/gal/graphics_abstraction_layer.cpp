@@ -28,6 +28,7 @@
 
 #include <gal/graphics_abstraction_layer.h>
 #include <gal/definitions.h>
+#include <geometry/shape_poly_set.h>
 
 using namespace KIGFX;
 
@@ -120,6 +121,23 @@ void GAL::ComputeWorldScreenMatrix()
 }
 
 
+void GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    std::deque<VECTOR2D> corners;
+
+    for( int i = 0; i < aPolySet.OutlineCount(); i++ )
+    {
+        const SHAPE_LINE_CHAIN& outline = aPolySet.COutline( i );
+
+        for( int j = 0; j < outline.PointCount(); j++ )
+            corners.push_back( (VECTOR2D) outline.CPoint( j ) );
+
+        DrawPolygon( corners );
+        corners.clear();
+    }
+}
+
+
 void GAL::DrawGrid()
 {
     if( !gridVisibility )
@@ -36,9 +36,13 @@
 #include <gal/opengl/utils.h>
 
 #include <confirm.h>
+#include <memory_stats.h>
 #include <list>
+#include <algorithm>
 #include <cassert>
 
+#include <boost/bind.hpp>
+
 #ifdef __WXDEBUG__
 #include <wx/log.h>
 #include <profile.h>
@@ -53,11 +57,16 @@ CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
 {
     // In the beginning there is only free space
     m_freeChunks.insert( std::make_pair( aSize, 0 ) );
+
+    MEMORY_STATS::RegisterSource( this, boost::bind( &CACHED_CONTAINER::addMemoryStats,
+                                                     this, _1 ) );
 }
 
 
 CACHED_CONTAINER::~CACHED_CONTAINER()
 {
+    MEMORY_STATS::UnregisterSource( this );
+
     if( m_isMapped )
         Unmap();
 
@@ -68,6 +77,13 @@ CACHED_CONTAINER::~CACHED_CONTAINER()
 }
 
 
+void CACHED_CONTAINER::addMemoryStats( MEMORY_STATS& aStats ) const
+{
+    aStats.Add( wxT( "GAL" ), wxT( "cached vertices" ), usedSpace(),
+                (size_t) m_currentSize * VertexSize );
+}
+
+
 void CACHED_CONTAINER::SetItem( VERTEX_ITEM* aItem )
 {
     assert( aItem != NULL );
@@ -459,25 +475,17 @@ bool CACHED_CONTAINER::defragmentResize( unsigned int aNewSize )
     }
     else
     {
-        int newOffset = 0;
-        ITEMS::iterator it, it_end;
+        USED_RUNS runs;
+        findUsedRuns( runs );
 
-        for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
+        for( USED_RUNS::const_iterator it = runs.begin(); it != runs.end(); ++it )
         {
-            VERTEX_ITEM* item = *it;
-            int itemOffset    = item->GetOffset();
-            int itemSize      = item->GetSize();
-
-            // Move an item to the new container
+            // Move a run of items to the new container
             glCopyBufferSubData( GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER,
-                    itemOffset * VertexSize, newOffset * VertexSize, itemSize * VertexSize );
-
-            // Update new offset
-            item->setOffset( newOffset );
-
-            // Move to the next free space
-            newOffset += itemSize;
+                    it->oldOffset * VertexSize, it->newOffset * VertexSize, it->size * VertexSize );
         }
+
+        relocateItems( runs );
     }
 
     // Cleanup
@@ -557,24 +565,17 @@ bool CACHED_CONTAINER::defragmentResizeMemcpy( unsigned int aNewSize )
     }
     else
     {
-        ITEMS::iterator it, it_end;
-        int newOffset = 0;
+        USED_RUNS runs;
+        findUsedRuns( runs );
 
-        for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
+        for( USED_RUNS::const_iterator it = runs.begin(); it != runs.end(); ++it )
         {
-            VERTEX_ITEM* item = *it;
-            int itemOffset    = item->GetOffset();
-            int itemSize      = item->GetSize();
-
-            // Move an item to the new container
-            memcpy( &newBufferMem[newOffset], &m_vertices[itemOffset], itemSize * VertexSize );
-
-            // Update new offset
-            item->setOffset( newOffset );
-
-            // Move to the next free space
-            newOffset += itemSize;
+            // Move a run of items to the new container
+            memcpy( &newBufferMem[it->newOffset], &m_vertices[it->oldOffset],
+                    it->size * VertexSize );
         }
+
+        relocateItems( runs );
     }
 
     // Cleanup
@@ -607,6 +608,63 @@ bool CACHED_CONTAINER::defragmentResizeMemcpy( unsigned int aNewSize )
 }
 
 
+void CACHED_CONTAINER::findUsedRuns( USED_RUNS& aRuns ) const
+{
+    // Free chunks sorted by offset
+    std::vector<CHUNK> freeChunks;
+    freeChunks.reserve( m_freeChunks.size() + 1 );
+
+    for( FREE_CHUNK_MAP::const_iterator it = m_freeChunks.begin(); it != m_freeChunks.end(); ++it )
+        freeChunks.push_back( std::make_pair( getChunkOffset( *it ), it->first ) );
+
+    std::sort( freeChunks.begin(), freeChunks.end() );
+
+    // The end of the container closes the last run
+    freeChunks.push_back( std::make_pair( m_currentSize, 0u ) );
+
+    unsigned int offset = 0;
+    unsigned int newOffset = 0;
+
+    for( std::vector<CHUNK>::const_iterator it = freeChunks.begin(); it != freeChunks.end(); ++it )
+    {
+        if( it->first > offset )
+        {
+            USED_RUN run;
+            run.oldOffset = offset;
+            run.newOffset = newOffset;
+            run.size = it->first - offset;
+            aRuns.push_back( run );
+
+            newOffset += run.size;
+        }
+
+        offset = it->first + it->second;
+    }
+}
+
+
+unsigned int CACHED_CONTAINER::relocatedOffset( unsigned int aOffset, const USED_RUNS& aRuns )
+{
+    USED_RUNS::const_iterator run = std::upper_bound( aRuns.begin(), aRuns.end(), aOffset,
+                                                      runOrder );
+    assert( run != aRuns.begin() );
+    --run;
+
+    return aOffset - run->oldOffset + run->newOffset;
+}
+
+
+void CACHED_CONTAINER::relocateItems( const USED_RUNS& aRuns )
+{
+    for( ITEMS::iterator it = m_items.begin(); it != m_items.end(); ++it )
+        ( *it )->setOffset( relocatedOffset( ( *it )->GetOffset(), aRuns ) );
+
+    // The currently modified item is not in m_items yet, if it is a new one
+    if( m_item && m_item->GetSize() > 0 && m_items.find( m_item ) == m_items.end() )
+        m_item->setOffset( relocatedOffset( m_item->GetOffset(), aRuns ) );
+}
+
+
 void CACHED_CONTAINER::addFreeChunk( unsigned int aOffset, unsigned int aSize )
 {
     assert( aOffset + aSize <= m_currentSize );
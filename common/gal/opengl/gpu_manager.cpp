@@ -35,6 +35,7 @@
 
 #include <typeinfo>
 #include <confirm.h>
+#include <frame_profiler.h>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -81,7 +82,8 @@ void GPU_MANAGER::SetShader( SHADER& aShader )
 // Cached manager
 GPU_CACHED_MANAGER::GPU_CACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
     GPU_MANAGER( aContainer ), m_buffersInitialized( false ), m_indicesPtr( NULL ),
-    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 )
+    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 ), m_indicesUploaded( 0 ),
+    m_indicesChanged( true )
 {
     // Allocate the biggest possible buffer for indices
     resizeIndices( aContainer->GetSize() );
@@ -125,8 +127,19 @@ void GPU_CACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSize )
 {
     wxASSERT( m_isDrawing );
 
-    // Copy indices of items that should be drawn to GPU memory
-    for( unsigned int i = aOffset; i < aOffset + aSize; *m_indicesPtr++ = i++ );
+    // Copy indices of items that should be drawn to GPU memory, noting if they differ from
+    // the ones drawn in the previous frame
+    const GLuint* end = m_indicesPtr + aSize;
+    GLuint diff = 0;
+
+    for( GLuint i = aOffset; m_indicesPtr < end; ++m_indicesPtr, ++i )
+    {
+        diff |= *m_indicesPtr ^ i;
+        *m_indicesPtr = i;
+    }
+
+    if( diff )
+        m_indicesChanged = true;
 
     m_indicesSize += aSize;
 }
@@ -136,8 +149,10 @@ void GPU_CACHED_MANAGER::DrawAll()
 {
     wxASSERT( m_isDrawing );
 
-    m_indicesSize = m_container->GetSize();
-    for( unsigned int i = 0; i < m_indicesSize; *m_indicesPtr++ = i++ );
+    m_indicesSize = 0;
+    m_indicesPtr = m_indices.get();
+
+    DrawIndices( 0, m_container->GetSize() );
 }
 
 
@@ -148,6 +163,8 @@ void GPU_CACHED_MANAGER::EndDrawing()
     prof_start( &totalRealTime );
 #endif /* __WXDEBUG__ */
 
+    FRAME_PROFILER_TIMER drawTimer( FRAME_PROFILER::CACHED_DRAW );
+
     wxASSERT( m_isDrawing );
 
     CACHED_CONTAINER* cached = static_cast<CACHED_CONTAINER*>( m_container );
@@ -179,10 +196,22 @@ void GPU_CACHED_MANAGER::EndDrawing()
     }
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
-            (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+
+    // Upload only the indices that changed since the previous frame: panning or zooming
+    // with the same items visible does not transfer anything
+    if( m_indicesChanged || m_indicesSize != m_indicesUploaded )
+    {
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
+                (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+
+        FRAME_PROFILER::Instance().AddCount( FRAME_PROFILER::UPLOADED_INDICES, m_indicesSize );
+
+        m_indicesUploaded = m_indicesSize;
+        m_indicesChanged = false;
+    }
 
     glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+    FRAME_PROFILER::Instance().AddCount( FRAME_PROFILER::CACHED_INDICES, m_indicesSize );
 
 #ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d" ), m_indicesSize );
@@ -216,7 +245,8 @@ void GPU_CACHED_MANAGER::resizeIndices( unsigned int aNewSize )
     if( aNewSize > m_indicesCapacity )
     {
         m_indicesCapacity = aNewSize;
-        m_indices.reset( new GLuint[m_indicesCapacity] );
+        m_indices.reset( new GLuint[m_indicesCapacity]() );
+        m_indicesChanged = true;
     }
 }
 
@@ -254,6 +284,8 @@ void GPU_NONCACHED_MANAGER::EndDrawing()
     prof_start( &totalRealTime );
 #endif /* __WXDEBUG__ */
 
+    FRAME_PROFILER_TIMER drawTimer( FRAME_PROFILER::NONCACHED_DRAW );
+
     if( m_container->GetSize() == 0 )
         return;
 
@@ -279,6 +311,8 @@ void GPU_NONCACHED_MANAGER::EndDrawing()
     }
 
     glDrawArrays( GL_TRIANGLES, 0, m_container->GetSize() );
+    FRAME_PROFILER::Instance().AddCount( FRAME_PROFILER::NONCACHED_VERTICES,
+                                         m_container->GetSize() );
 
 #ifdef __WXDEBUG__
     wxLogTrace( "GAL_PROFILE", wxT( "Noncached manager size: %d" ), m_container->GetSize() );
@@ -31,6 +31,8 @@
 #include <gal/opengl/opengl_compositor.h>
 #include <gal/opengl/utils.h>
 
+#include <frame_profiler.h>
+
 #include <stdexcept>
 #include <cassert>
 
@@ -229,6 +231,8 @@ void OPENGL_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
     assert( m_initialized );
     assert( aBufferHandle != 0 && aBufferHandle <= usedBuffers() );
 
+    FRAME_PROFILER_TIMER compositeTimer( FRAME_PROFILER::COMPOSITE );
+
     // Switch to the main framebuffer and blit the scene
     bindFb( DIRECT_RENDERING );
 
@@ -270,6 +274,43 @@ void OPENGL_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
 }
 
 
+void OPENGL_COMPOSITOR::ReadBuffer( unsigned int aBufferHandle, GLuint aPixelBuffer )
+{
+    assert( m_initialized );
+    assert( aBufferHandle != 0 && aBufferHandle <= usedBuffers() );
+
+    // With a pixel pack buffer bound, glReadPixels() only queues the transfer
+    bindFb( m_mainFbo );
+    glReadBuffer( m_buffers[aBufferHandle - 1].attachmentPoint );
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, aPixelBuffer );
+    glPixelStorei( GL_PACK_ALIGNMENT, 4 );
+    glReadPixels( 0, 0, m_width, m_height, GL_BGRA, GL_UNSIGNED_BYTE, NULL );
+    checkGlError( "reading framebuffer pixels" );
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+    bindFb( DIRECT_RENDERING );
+}
+
+
+void OPENGL_COMPOSITOR::ReadRect( unsigned int aBufferHandle, int aX, int aY,
+                                  int aWidth, int aHeight, unsigned char* aPixels )
+{
+    assert( m_initialized );
+    assert( aBufferHandle != 0 && aBufferHandle <= usedBuffers() );
+    assert( aX >= 0 && aY >= 0 && aX + aWidth <= (int) m_width
+            && aY + aHeight <= (int) m_height );
+
+    // The rows of the targets are the rows of the screen from the top, see DrawBuffer()
+    bindFb( m_mainFbo );
+    glReadBuffer( m_buffers[aBufferHandle - 1].attachmentPoint );
+    glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+    glReadPixels( aX, aY, aWidth, aHeight, GL_RGBA, GL_UNSIGNED_BYTE, aPixels );
+    checkGlError( "reading framebuffer rectangle" );
+
+    bindFb( DIRECT_RENDERING );
+}
+
+
 void OPENGL_COMPOSITOR::bindFb( unsigned int aFb ) {
     // Currently there are only 2 valid FBOs
     assert( aFb == DIRECT_RENDERING || aFb == m_mainFbo );
@@ -31,13 +31,21 @@
 #include <gal/definitions.h>
 
 #include <macros.h>
+#include <frame_profiler.h>
+#include <geometry/shape_poly_set.h>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
 #include <wx/log.h>
 #endif /* __WXDEBUG__ */
 
+#include <wx/image.h>
+
+#include <algorithm>
+#include <cassert>
 #include <limits>
+#include <map>
+#include <stdexcept>
 #include <boost/bind.hpp>
 
 using namespace KIGFX;
@@ -77,7 +85,13 @@ OPENGL_GAL::OPENGL_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
     // Initialize the flags
     isFramebufferInitialized = false;
     isBitmapFontInitialized  = false;
+    pixelBuffers[0] = pixelBuffers[1] = 0;
+    pixelBufferWidth = pixelBufferHeight = 0;
+    nextPixelBuffer = 0;
+    pickingBuffer = 0;
+    ufm_picking = ufm_pickColor = 0;
     isGrouping               = false;
+    isClipping               = false;
     groupCounter             = 0;
 
 #ifdef RETINA_OPENGL_PATCH
@@ -137,6 +151,9 @@ OPENGL_GAL::~OPENGL_GAL()
     SetCurrent( *OPENGL_GAL::glContext );
 #endif
 
+    if( pixelBuffers[0] )
+        glDeleteBuffers( 2, pixelBuffers );
+
     glFlush();
 
     if( --instanceCounter == 0 )
@@ -166,19 +183,7 @@ void OPENGL_GAL::BeginDrawing()
     SetCurrent( *glContext );
     clientDC = new wxClientDC( this );
 
-#ifdef RETINA_OPENGL_PATCH
-    const float scaleFactor = GetBackingScaleFactor();
-#else
-    const float scaleFactor = 1.0f;
-#endif
-
-    // Set up the view port
-    glMatrixMode( GL_PROJECTION );
-    glLoadIdentity();
-    glViewport( 0, 0, (GLsizei) screenSize.x * scaleFactor, (GLsizei) screenSize.y * scaleFactor );
-
-    // Create the screen transformation
-    glOrtho( 0, (GLint) screenSize.x, 0, (GLsizei) screenSize.y, -depthRange.x, -depthRange.y );
+    setUpTransformations();
 
     if( !isFramebufferInitialized )
     {
@@ -187,6 +192,9 @@ void OPENGL_GAL::BeginDrawing()
         mainBuffer = compositor.CreateBuffer();
         overlayBuffer = compositor.CreateBuffer();
 
+        // Created again by the next BeginPicking()
+        pickingBuffer = 0;
+
         isFramebufferInitialized = true;
     }
 
@@ -203,22 +211,6 @@ void OPENGL_GAL::BeginDrawing()
     glEnable( GL_BLEND );
     glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 
-    glMatrixMode( GL_MODELVIEW );
-
-    // Set up the world <-> screen transformation
-    ComputeWorldScreenMatrix();
-    GLdouble matrixData[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
-    matrixData[0]   = worldScreenMatrix.m_data[0][0];
-    matrixData[1]   = worldScreenMatrix.m_data[1][0];
-    matrixData[2]   = worldScreenMatrix.m_data[2][0];
-    matrixData[4]   = worldScreenMatrix.m_data[0][1];
-    matrixData[5]   = worldScreenMatrix.m_data[1][1];
-    matrixData[6]   = worldScreenMatrix.m_data[2][1];
-    matrixData[12]  = worldScreenMatrix.m_data[0][2];
-    matrixData[13]  = worldScreenMatrix.m_data[1][2];
-    matrixData[14]  = worldScreenMatrix.m_data[2][2];
-    glLoadMatrixd( matrixData );
-
     // Set defaults
     SetFillColor( fillColor );
     SetStrokeColor( strokeColor );
@@ -255,8 +247,11 @@ void OPENGL_GAL::BeginDrawing()
 
         // Set shader parameter
         GLint ufm_fontTexture = shader.AddParameter( "fontTexture" );
+        ufm_picking = shader.AddParameter( "picking" );
+        ufm_pickColor = shader.AddParameter( "pickColor" );
         shader.Use();
         shader.SetParameter( ufm_fontTexture, (int) FONT_TEXTURE_UNIT );
+        shader.SetParameter( ufm_picking, 0.0f );
         shader.Deactivate();
         checkGlError( "setting bitmap font sampler as shader parameter" );
 
@@ -283,9 +278,20 @@ void OPENGL_GAL::EndDrawing()
 
     // Cached & non-cached containers are rendered to the same buffer
     compositor.SetBuffer( mainBuffer );
+
+    if( isClipping )
+    {
+        glEnable( GL_SCISSOR_TEST );
+        glScissor( clipRect[0], clipRect[1], clipRect[2], clipRect[3] );
+    }
+
     nonCachedManager.EndDrawing();
     cachedManager.EndDrawing();
 
+    // Clipping lasts a single frame
+    glDisable( GL_SCISSOR_TEST );
+    isClipping = false;
+
     // Overlay container is rendered to a different buffer
     compositor.SetBuffer( overlayBuffer );
     overlayManager.EndDrawing();
@@ -298,7 +304,10 @@ void OPENGL_GAL::EndDrawing()
     compositor.DrawBuffer( overlayBuffer );
     blitCursor();
 
-    SwapBuffers();
+    {
+        FRAME_PROFILER_TIMER swapTimer( FRAME_PROFILER::SWAP );
+        SwapBuffers();
+    }
 
     delete clientDC;
 
@@ -309,6 +318,102 @@ void OPENGL_GAL::EndDrawing()
 }
 
 
+unsigned int OPENGL_GAL::EndOffscreenDrawing()
+{
+    // Cached & non-cached containers are rendered to the same buffer
+    compositor.SetBuffer( mainBuffer );
+
+    if( isClipping )
+    {
+        glEnable( GL_SCISSOR_TEST );
+        glScissor( clipRect[0], clipRect[1], clipRect[2], clipRect[3] );
+    }
+
+    nonCachedManager.EndDrawing();
+    cachedManager.EndDrawing();
+
+    glDisable( GL_SCISSOR_TEST );
+    isClipping = false;
+
+    unsigned int width  = compositor.GetWidth();
+    unsigned int height = compositor.GetHeight();
+
+    if( !pixelBuffers[0] )
+        glGenBuffers( 2, pixelBuffers );
+
+    if( width != pixelBufferWidth || height != pixelBufferHeight )
+    {
+        for( int i = 0; i < 2; ++i )
+        {
+            glBindBuffer( GL_PIXEL_PACK_BUFFER, pixelBuffers[i] );
+            glBufferData( GL_PIXEL_PACK_BUFFER, width * height * 4, NULL, GL_STREAM_READ );
+        }
+
+        glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+        checkGlError( "allocating pixel buffers" );
+
+        pixelBufferWidth  = width;
+        pixelBufferHeight = height;
+    }
+
+    unsigned int buffer = nextPixelBuffer;
+    nextPixelBuffer = 1 - nextPixelBuffer;
+
+    compositor.ReadBuffer( mainBuffer, pixelBuffers[buffer] );
+
+    // Start the rendering and the transfer, ReadPixels() waits for them
+    glFlush();
+
+    delete clientDC;
+    clientDC = NULL;
+
+    return buffer;
+}
+
+
+bool OPENGL_GAL::ReadPixels( unsigned int aPixelBuffer, wxImage& aImage,
+                             const COLOR4D& aBackground )
+{
+    assert( aPixelBuffer < 2 && pixelBuffers[aPixelBuffer] );
+
+    SetCurrent( *glContext );
+
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, pixelBuffers[aPixelBuffer] );
+
+    const unsigned char* bgra = (const unsigned char*) glMapBuffer( GL_PIXEL_PACK_BUFFER,
+                                                                     GL_READ_ONLY );
+
+    if( !bgra )
+    {
+        glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+        return false;
+    }
+
+    aImage.Create( pixelBufferWidth, pixelBufferHeight, false );
+
+    unsigned char* rgb = aImage.GetData();
+    unsigned int   count = pixelBufferWidth * pixelBufferHeight;
+    const int      bg[3] = { (int) ( aBackground.r * 255 + 0.5 ),
+                             (int) ( aBackground.g * 255 + 0.5 ),
+                             (int) ( aBackground.b * 255 + 0.5 ) };
+
+    // The targets hold premultiplied colors, blended as OPENGL_COMPOSITOR::DrawBuffer() does
+    for( unsigned int i = 0; i < count; ++i, bgra += 4, rgb += 3 )
+    {
+        int transparency = 255 - bgra[3];
+
+        rgb[0] = std::min( 255, bgra[2] + ( bg[0] * transparency + 127 ) / 255 );
+        rgb[1] = std::min( 255, bgra[1] + ( bg[1] * transparency + 127 ) / 255 );
+        rgb[2] = std::min( 255, bgra[0] + ( bg[2] * transparency + 127 ) / 255 );
+    }
+
+    glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+    return true;
+}
+
+
 void OPENGL_GAL::BeginUpdate()
 {
     SetCurrent( *OPENGL_GAL::glContext );
@@ -602,69 +707,68 @@ void OPENGL_GAL::DrawPolyline( const VECTOR2D aPointList[], int aListSize )
 
 void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 {
-    currentManager->Shader( SHADER_NONE );
-    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
-
-    // Any non convex polygon needs to be tesselated
-    // for this purpose the GLU standard functions are used
-    TessParams params = { currentManager, tessIntersects };
-    gluTessBeginPolygon( tesselator, &params );
-    gluTessBeginContour( tesselator );
-
-    boost::shared_array<GLdouble> points( new GLdouble[3 * aPointList.size()] );
-    int v = 0;
+    std::vector<GLdouble> points;
+    points.reserve( 3 * aPointList.size() );
 
     for( std::deque<VECTOR2D>::const_iterator it = aPointList.begin(); it != aPointList.end(); ++it )
     {
-        points[v]     = it->x;
-        points[v + 1] = it->y;
-        points[v + 2] = layerDepth;
-        gluTessVertex( tesselator, &points[v], &points[v] );
-        v += 3;
+        points.push_back( it->x );
+        points.push_back( it->y );
+        points.push_back( layerDepth );
     }
 
-    gluTessEndContour( tesselator );
-    gluTessEndPolygon( tesselator );
-
-    // Free allocated intersecting points
-    tessIntersects.clear();
-
-    // vertexList destroyed here
+    fillPolygon( points );
 }
 
 
 void OPENGL_GAL::DrawPolygon( const VECTOR2D aPointList[], int aListSize )
 {
-    currentManager->Shader( SHADER_NONE );
-    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
+    std::vector<GLdouble> points;
+    points.reserve( 3 * aListSize );
 
-    // Any non convex polygon needs to be tesselated
-    // for this purpose the GLU standard functions are used
-    TessParams params = { currentManager, tessIntersects };
-    gluTessBeginPolygon( tesselator, &params );
-    gluTessBeginContour( tesselator );
+    for( int i = 0; i < aListSize; ++i )
+    {
+        points.push_back( aPointList[i].x );
+        points.push_back( aPointList[i].y );
+        points.push_back( layerDepth );
+    }
 
-    boost::shared_array<GLdouble> points( new GLdouble[3 * aListSize] );
-    int v = 0;
-    const VECTOR2D* ptr = aPointList;
+    fillPolygon( points );
+}
 
-    for( int i = 0; i < aListSize; ++i )
+
+void OPENGL_GAL::DrawPolygon( const SHAPE_POLY_SET& aPolySet )
+{
+    if( !aPolySet.IsTriangulationUpToDate() )
     {
-        points[v]     = ptr->x;
-        points[v + 1] = ptr->y;
-        points[v + 2] = layerDepth;
-        gluTessVertex( tesselator, &points[v], &points[v] );
-        ++ptr;
-        v += 3;
+        GAL::DrawPolygon( aPolySet );
+        return;
     }
 
-    gluTessEndContour( tesselator );
-    gluTessEndPolygon( tesselator );
+    currentManager->Shader( SHADER_NONE );
+    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
 
-    // Free allocated intersecting points
-    tessIntersects.clear();
+    for( unsigned int i = 0; i < aPolySet.TriangulatedPolyCount(); i++ )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* poly = aPolySet.TriangulatedPolygon( i );
+        const std::vector<VECTOR2I>& vertices = poly->Vertices();
+        const std::vector<SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI>& triangles =
+                poly->Triangles();
 
-    // vertexList destroyed here
+        if( triangles.empty() || !currentManager->Reserve( 3 * triangles.size() ) )
+            continue;
+
+        for( unsigned int j = 0; j < triangles.size(); j++ )
+        {
+            const VECTOR2I& a = vertices[triangles[j].a];
+            const VECTOR2I& b = vertices[triangles[j].b];
+            const VECTOR2I& c = vertices[triangles[j].c];
+
+            currentManager->Vertex( a.x, a.y, layerDepth );
+            currentManager->Vertex( b.x, b.y, layerDepth );
+            currentManager->Vertex( c.x, c.y, layerDepth );
+        }
+    }
 }
 
 
@@ -1059,6 +1163,148 @@ void OPENGL_GAL::ClearCache()
 }
 
 
+bool OPENGL_GAL::BeginPicking( const VECTOR2D& aPosition, int aRadius )
+{
+    // The targets and the shader parameters are set up by the first frame
+    if( !IsShownOnScreen() || !isFramebufferInitialized || !isBitmapFontInitialized )
+        return false;
+
+    SetCurrent( *glContext );
+
+    if( !pickingBuffer )
+    {
+        try
+        {
+            pickingBuffer = compositor.CreateBuffer();
+        }
+        catch( const std::runtime_error& err )
+        {
+            wxLogTrace( "GAL_PROFILE", wxT( "No picking target: %s" ), err.what() );
+            return false;
+        }
+    }
+
+#ifdef RETINA_OPENGL_PATCH
+    const float scaleFactor = GetBackingScaleFactor();
+#else
+    const float scaleFactor = 1.0f;
+#endif
+
+    // The window in the pixels of the targets, whose rows are the rows of the screen
+    pickingCenter = VECTOR2I( KiROUND( aPosition.x * scaleFactor ),
+                              KiROUND( aPosition.y * scaleFactor ) );
+    int radius = KiROUND( aRadius * scaleFactor );
+    int left   = std::max( pickingCenter.x - radius, 0 );
+    int top    = std::max( pickingCenter.y - radius, 0 );
+    int right  = std::min( pickingCenter.x + radius + 1, (int) compositor.GetWidth() );
+    int bottom = std::min( pickingCenter.y + radius + 1, (int) compositor.GetHeight() );
+
+    if( left >= right || top >= bottom )
+        return false;
+
+    pickingRect[0] = left;
+    pickingRect[1] = top;
+    pickingRect[2] = right - left;
+    pickingRect[3] = bottom - top;
+
+    // The view may have moved since the last frame
+    setUpTransformations();
+
+    // Only the window is cleared and drawn: the depth buffer is shared with the other
+    // targets, whose window is drawn again by any frame that shows it
+    compositor.SetBuffer( pickingBuffer );
+    glEnable( GL_SCISSOR_TEST );
+    glScissor( pickingRect[0], pickingRect[1], pickingRect[2], pickingRect[3] );
+    compositor.ClearBuffer();
+
+    // The ids are written as they are, the closest group hides the others
+    glDisable( GL_BLEND );
+    glEnable( GL_DEPTH_TEST );
+    glDepthFunc( GL_LESS );
+
+    shader.Use();
+    shader.SetParameter( ufm_picking, 1.0f );
+    shader.Deactivate();
+
+    return true;
+}
+
+
+void OPENGL_GAL::DrawGroupPicking( int aGroupNumber, unsigned int aId )
+{
+    wxASSERT( aId > 0 && aId <= 0xFFFFFF );
+
+    // The id is a shader parameter, so each group has its own draw call
+    shader.Use();
+    shader.SetParameter( ufm_pickColor, ( aId & 0xFF ) / 255.0f, ( ( aId >> 8 ) & 0xFF ) / 255.0f,
+                         ( ( aId >> 16 ) & 0xFF ) / 255.0f, 1.0f );
+    shader.Deactivate();
+
+    cachedManager.BeginDrawing();
+    cachedManager.DrawItem( *groups[aGroupNumber] );
+    cachedManager.EndDrawing();
+}
+
+
+void OPENGL_GAL::EndPicking( std::vector<unsigned int>& aIds )
+{
+    shader.Use();
+    shader.SetParameter( ufm_picking, 0.0f );
+    shader.Deactivate();
+
+    glEnable( GL_BLEND );
+
+    const int width = pickingRect[2];
+    const int height = pickingRect[3];
+    std::vector<unsigned char> pixels( width * height * 4 );
+
+    compositor.ReadRect( pickingBuffer, pickingRect[0], pickingRect[1], width, height,
+                         &pixels[0] );
+    glDisable( GL_SCISSOR_TEST );
+
+    // The distance of each id to the center is the one of its closest pixel
+    std::map<unsigned int, int> distances;
+
+    for( int y = 0; y < height; ++y )
+    {
+        for( int x = 0; x < width; ++x )
+        {
+            const unsigned char* pixel = &pixels[( y * width + x ) * 4];
+            unsigned int id = pixel[0] | ( pixel[1] << 8 ) | ( pixel[2] << 16 );
+
+            if( !id )
+                continue;
+
+            int dx = pickingRect[0] + x - pickingCenter.x;
+            int dy = pickingRect[1] + y - pickingCenter.y;
+            int distance = dx * dx + dy * dy;
+
+            std::map<unsigned int, int>::iterator it = distances.find( id );
+
+            if( it == distances.end() )
+                distances[id] = distance;
+            else
+                it->second = std::min( it->second, distance );
+        }
+    }
+
+    std::vector< std::pair<int, unsigned int> > sorted;
+
+    for( std::map<unsigned int, int>::const_iterator it = distances.begin();
+         it != distances.end(); ++it )
+    {
+        sorted.push_back( std::make_pair( it->second, it->first ) );
+    }
+
+    std::sort( sorted.begin(), sorted.end() );
+
+    aIds.clear();
+
+    for( unsigned int i = 0; i < sorted.size(); ++i )
+        aIds.push_back( sorted[i].second );
+}
+
+
 void OPENGL_GAL::SaveScreen()
 {
     wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
@@ -1111,6 +1357,13 @@ void OPENGL_GAL::ClearTarget( RENDER_TARGET aTarget )
     case TARGET_CACHED:
     case TARGET_NONCACHED:
         compositor.SetBuffer( mainBuffer );
+
+        if( isClipping )
+        {
+            glEnable( GL_SCISSOR_TEST );
+            glScissor( clipRect[0], clipRect[1], clipRect[2], clipRect[3] );
+        }
+
         break;
 
     case TARGET_OVERLAY:
@@ -1119,12 +1372,44 @@ void OPENGL_GAL::ClearTarget( RENDER_TARGET aTarget )
     }
 
     compositor.ClearBuffer();
+    glDisable( GL_SCISSOR_TEST );
 
     // Restore the previous state
     compositor.SetBuffer( oldTarget );
 }
 
 
+bool OPENGL_GAL::SetClipRect( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+{
+#ifdef RETINA_OPENGL_PATCH
+    const double scaleFactor = GetBackingScaleFactor();
+#else
+    const double scaleFactor = 1.0;
+#endif
+
+    // The buffers use the screen coordinates, scaled for high resolution displays
+    VECTOR2D start = ToScreen( aStartPoint ) * scaleFactor;
+    VECTOR2D end = ToScreen( aEndPoint ) * scaleFactor;
+    VECTOR2D size = VECTOR2D( screenSize ) * scaleFactor;
+
+    // A margin covers the antialiasing and the minimal line width of the shaders
+    const double margin = 2.0 * scaleFactor;
+
+    double x0 = std::max( 0.0, std::min( start.x, end.x ) - margin );
+    double y0 = std::max( 0.0, std::min( start.y, end.y ) - margin );
+    double x1 = std::min( size.x, std::max( start.x, end.x ) + margin );
+    double y1 = std::min( size.y, std::max( start.y, end.y ) + margin );
+
+    clipRect[0] = (GLint) floor( x0 );
+    clipRect[1] = (GLint) floor( y0 );
+    clipRect[2] = std::max( 0, (GLint) ceil( x1 ) - clipRect[0] );
+    clipRect[3] = std::max( 0, (GLint) ceil( y1 ) - clipRect[1] );
+    isClipping = true;
+
+    return true;
+}
+
+
 void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 {
     // Now we should only store the position of the mouse cursor
@@ -1135,6 +1420,59 @@ void OPENGL_GAL::DrawCursor( const VECTOR2D& aCursorPosition )
 }
 
 
+void OPENGL_GAL::fillPolygon( const std::vector<GLdouble>& aPoints )
+{
+    currentManager->Shader( SHADER_NONE );
+    currentManager->Color( fillColor.r, fillColor.g, fillColor.b, fillColor.a );
+
+    // Copies of a footprint draw their polygons with the same local coordinates,
+    // so they share the triangles of the first one
+    bool cached = aPoints.size() <= 3 * TESS_CACHE_POINTS;
+
+    if( cached )
+    {
+        TESS_CACHE::const_iterator it = tessCache.find( aPoints );
+
+        if( it != tessCache.end() )
+        {
+            const std::vector<GLdouble>& triangles = it->second;
+
+            for( unsigned int i = 0; i < triangles.size(); i += 3 )
+                currentManager->Vertex( triangles[i], triangles[i + 1], triangles[i + 2] );
+
+            return;
+        }
+
+        if( tessCache.size() >= (unsigned int) TESS_CACHE_SIZE )
+            tessCache.clear();
+    }
+
+    std::vector<GLdouble> triangles;
+
+    // Any non convex polygon needs to be tesselated
+    // for this purpose the GLU standard functions are used
+    TessParams params = { currentManager, tessIntersects, cached ? &triangles : NULL };
+    gluTessBeginPolygon( tesselator, &params );
+    gluTessBeginContour( tesselator );
+
+    // The tesselator only reads the vertices, while the vector stays unchanged
+    for( unsigned int v = 0; v < aPoints.size(); v += 3 )
+    {
+        GLdouble* point = const_cast<GLdouble*>( &aPoints[v] );
+        gluTessVertex( tesselator, point, point );
+    }
+
+    gluTessEndContour( tesselator );
+    gluTessEndPolygon( tesselator );
+
+    // Free allocated intersecting points
+    tessIntersects.clear();
+
+    if( cached )
+        tessCache[aPoints].swap( triangles );
+}
+
+
 void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     /* Helper drawing:                   ____--- v3       ^
@@ -1431,6 +1769,40 @@ void OPENGL_GAL::blitCursor()
 }
 
 
+void OPENGL_GAL::setUpTransformations()
+{
+#ifdef RETINA_OPENGL_PATCH
+    const float scaleFactor = GetBackingScaleFactor();
+#else
+    const float scaleFactor = 1.0f;
+#endif
+
+    // Set up the view port
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    glViewport( 0, 0, (GLsizei) screenSize.x * scaleFactor, (GLsizei) screenSize.y * scaleFactor );
+
+    // Create the screen transformation
+    glOrtho( 0, (GLint) screenSize.x, 0, (GLsizei) screenSize.y, -depthRange.x, -depthRange.y );
+
+    glMatrixMode( GL_MODELVIEW );
+
+    // Set up the world <-> screen transformation
+    ComputeWorldScreenMatrix();
+    GLdouble matrixData[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+    matrixData[0]   = worldScreenMatrix.m_data[0][0];
+    matrixData[1]   = worldScreenMatrix.m_data[1][0];
+    matrixData[2]   = worldScreenMatrix.m_data[2][0];
+    matrixData[4]   = worldScreenMatrix.m_data[0][1];
+    matrixData[5]   = worldScreenMatrix.m_data[1][1];
+    matrixData[6]   = worldScreenMatrix.m_data[2][1];
+    matrixData[12]  = worldScreenMatrix.m_data[0][2];
+    matrixData[13]  = worldScreenMatrix.m_data[1][2];
+    matrixData[14]  = worldScreenMatrix.m_data[2][2];
+    glLoadMatrixd( matrixData );
+}
+
+
 unsigned int OPENGL_GAL::getNewGroupNumber()
 {
     wxASSERT_MSG( groups.size() < std::numeric_limits<unsigned int>::max(),
@@ -1598,6 +1970,9 @@ void CALLBACK VertexCallback( GLvoid* aVertexPtr, void* aData )
 
     if( vboManager )
         vboManager->Vertex( vertex[0], vertex[1], vertex[2] );
+
+    if( param->triangles )
+        param->triangles->insert( param->triangles->end(), vertex, vertex + 3 );
 }
 
 
@@ -146,6 +146,12 @@ void SHADER::SetParameter( int parameterNumber, int value ) const
 }
 
 
+void SHADER::SetParameter( int parameterNumber, float x, float y, float z, float w ) const
+{
+    glUniform4f( parameterLocation[parameterNumber], x, y, z, w );
+}
+
+
 int SHADER::GetAttribute( std::string aAttributeName ) const
 {
     return glGetAttribLocation( programNumber, aAttributeName.c_str() );
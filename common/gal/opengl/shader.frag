@@ -36,6 +36,10 @@ varying vec4 shaderParams;
 varying vec2 circleCoords;
 uniform sampler2D fontTexture;
 
+// Item id drawn instead of the colors by the picking pass, see OPENGL_GAL::BeginPicking()
+uniform float picking;
+uniform vec4 pickColor;
+
 void filledCircle( vec2 aCoord )
 {
     if( dot( aCoord, aCoord ) < 1.0 )
@@ -83,4 +87,8 @@ void main()
         // Simple pass-through
         gl_FragColor = gl_Color;
     }
+
+    // The discarded fragments are not picked either
+    if( picking > 0.5 )
+        gl_FragColor = pickColor;
 }
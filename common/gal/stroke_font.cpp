@@ -30,6 +30,8 @@
 #include <gal/graphics_abstraction_layer.h>
 #include <wx/string.h>
 
+#include <map>
+
 using namespace KIGFX;
 
 const double STROKE_FONT::INTERLINE_PITCH_RATIO = 1.5;
@@ -38,18 +40,45 @@ const double STROKE_FONT::BOLD_FACTOR = 1.3;
 const double STROKE_FONT::STROKE_FONT_SCALE = 1.0 / 21.0;
 const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
 
+/// Glyphs of a parsed font
+struct PARSED_FONT
+{
+    GLYPH_LIST          m_glyphs;
+    std::vector<BOX2D>  m_glyphBoundingBoxes;
+};
+
+/// Fonts parsed by STROKE_FONT::LoadNewStrokeFont(), indexed by their data. Every GAL
+/// loads the newstroke font, which is then parsed only once.
+static std::map<const char* const*, PARSED_FONT> parsedFonts;
+
+
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
-    m_gal( aGal )
+    m_gal( aGal ), m_glyphs( NULL ), m_glyphBoundingBoxes( NULL )
 {
 }
 
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
-    m_glyphs.clear();
-    m_glyphBoundingBoxes.clear();
-    m_glyphs.resize( aNewStrokeFontSize );
-    m_glyphBoundingBoxes.resize( aNewStrokeFontSize );
+    std::map<const char* const*, PARSED_FONT>::iterator cached =
+            parsedFonts.find( aNewStrokeFont );
+
+    if( cached != parsedFonts.end() && (int) cached->second.m_glyphs.size() == aNewStrokeFontSize )
+    {
+        m_glyphs = &cached->second.m_glyphs;
+        m_glyphBoundingBoxes = &cached->second.m_glyphBoundingBoxes;
+
+        return true;
+    }
+
+    PARSED_FONT& font = parsedFonts[aNewStrokeFont];
+    GLYPH_LIST& glyphs = font.m_glyphs;
+    std::vector<BOX2D>& glyphBoundingBoxes = font.m_glyphBoundingBoxes;
+
+    glyphs.clear();
+    glyphBoundingBoxes.clear();
+    glyphs.resize( aNewStrokeFontSize );
+    glyphBoundingBoxes.resize( aNewStrokeFontSize );
 
     for( int j = 0; j < aNewStrokeFontSize; j++ )
     {
@@ -58,7 +87,7 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
         double   glyphEndX = 0.0;
         VECTOR2D glyphBoundingX;
 
-        std::deque<VECTOR2D> pointList;
+        std::vector<VECTOR2D> pointList;
 
         int i = 0;
 
@@ -112,12 +141,15 @@ bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNe
         if( pointList.size() > 0 )
             glyph.push_back( pointList );
 
-        m_glyphs[j] = glyph;
-
         // Compute the bounding box of the glyph
-        m_glyphBoundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
+        glyphBoundingBoxes[j] = computeBoundingBox( glyph, glyphBoundingX );
+
+        glyphs[j].swap( glyph );
     }
 
+    m_glyphs = &glyphs;
+    m_glyphBoundingBoxes = &glyphBoundingBoxes;
+
     return true;
 }
 
@@ -146,7 +178,7 @@ BOX2D STROKE_FONT::computeBoundingBox( const GLYPH& aGLYPH, const VECTOR2D& aGLY
 
     for( GLYPH::const_iterator pointListIt = aGLYPH.begin(); pointListIt != aGLYPH.end(); ++pointListIt )
     {
-        for( std::deque<VECTOR2D>::const_iterator pointIt = pointListIt->begin();
+        for( std::vector<VECTOR2D>::const_iterator pointIt = pointListIt->begin();
                 pointIt != pointListIt->end(); ++pointIt )
         {
             boundingPoints.push_back( VECTOR2D( aGLYPHBoundingX.x, pointIt->y ) );
@@ -248,6 +280,12 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
     VECTOR2D    glyphSize( m_gal->GetGlyphSize() );
     double      overbar_italic_comp = computeOverbarVerticalPosition() * ITALIC_TILT;
 
+    // Italic texts are slanted to the right, mirrored ones to the left
+    double      italicTilt = 0.0;
+
+    if( m_gal->IsFontItalic() )
+        italicTilt = m_gal->IsTextMirrored() ? ITALIC_TILT : -ITALIC_TILT;
+
     if( m_gal->IsTextMirrored() )
         overbar_italic_comp = -overbar_italic_comp;
 
@@ -319,11 +357,11 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
 
         int dd = *chIt - ' ';
 
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+        if( dd >= (int) m_glyphBoundingBoxes->size() || dd < 0 )
             dd = '?' - ' ';
 
-        GLYPH& glyph = m_glyphs[dd];
-        BOX2D& bbox  = m_glyphBoundingBoxes[dd];
+        const GLYPH& glyph = (*m_glyphs)[dd];
+        const BOX2D& bbox  = (*m_glyphBoundingBoxes)[dd];
 
         if( overbar )
         {
@@ -348,30 +386,25 @@ void STROKE_FONT::drawSingleLineText( const UTF8& aText )
             last_had_overbar = false;
         }
 
-        for( GLYPH::iterator pointListIt = glyph.begin(); pointListIt != glyph.end();
+        for( GLYPH::const_iterator pointListIt = glyph.begin(); pointListIt != glyph.end();
              ++pointListIt )
         {
-            std::deque<VECTOR2D> pointListScaled;
+            m_strokePoints.resize( pointListIt->size() );
 
-            for( std::deque<VECTOR2D>::iterator pointIt = pointListIt->begin();
-                 pointIt != pointListIt->end(); ++pointIt )
+            for( unsigned int i = 0; i < pointListIt->size(); ++i )
             {
-                VECTOR2D pointPos( pointIt->x * glyphSize.x + xOffset, pointIt->y * glyphSize.y );
-
-                if( m_gal->IsFontItalic() )
-                {
-                    // FIXME should be done other way - referring to the lowest Y value of point
-                    // because now italic fonts are translated a bit
-                    if( m_gal->IsTextMirrored() )
-                        pointPos.x += pointPos.y * STROKE_FONT::ITALIC_TILT;
-                    else
-                        pointPos.x -= pointPos.y * STROKE_FONT::ITALIC_TILT;
-                }
-
-                pointListScaled.push_back( pointPos );
+                const VECTOR2D& point = (*pointListIt)[i];
+                VECTOR2D& pointPos = m_strokePoints[i];
+
+                pointPos.x = point.x * glyphSize.x + xOffset;
+                pointPos.y = point.y * glyphSize.y;
+
+                // FIXME should be done other way - referring to the lowest Y value of point
+                // because now italic fonts are translated a bit
+                pointPos.x += pointPos.y * italicTilt;
             }
 
-            m_gal->DrawPolyline( pointListScaled );
+            m_gal->DrawPolyline( &m_strokePoints[0], m_strokePoints.size() );
         }
 
         xOffset += glyphSize.x * bbox.GetEnd().x;
@@ -428,10 +461,10 @@ VECTOR2D STROKE_FONT::ComputeStringBoundaryLimits( const UTF8& aText, VECTOR2D a
         // Index in the bounding boxes table
         int dd = *it - ' ';
 
-        if( dd >= (int) m_glyphBoundingBoxes.size() || dd < 0 )
+        if( dd >= (int) m_glyphBoundingBoxes->size() || dd < 0 )
             dd = '?' - ' ';
 
-        const BOX2D& box = m_glyphBoundingBoxes[dd];
+        const BOX2D& box = (*m_glyphBoundingBoxes)[dd];
 
         result.x += box.GetEnd().x;
 
@@ -73,10 +73,31 @@ bool SEG::PointCloserThan( const VECTOR2I& aP, int aDist ) const
 }
 
 
+// Same test as SEG::Intersect( aSeg ) returning a point, without computing the point
+static inline bool segmentsIntersect( const SEG& aSegA, const SEG& aSegB )
+{
+    typedef VECTOR2I::extended_type ecoord;
+
+    const VECTOR2I  e( aSegA.B - aSegA.A );
+    const VECTOR2I  f( aSegB.B - aSegB.A );
+    const VECTOR2I  ac( aSegB.A - aSegA.A );
+
+    ecoord d = f.Cross( e );
+    ecoord p = f.Cross( ac );
+    ecoord q = e.Cross( ac );
+
+    if( d > 0 )
+        return q >= 0 && q <= d && p >= 0 && p <= d;
+    else if( d < 0 )
+        return q <= 0 && q >= d && p <= 0 && p >= d;
+
+    return false;
+}
+
+
 SEG::ecoord SEG::SquaredDistance( const SEG& aSeg ) const
 {
-    // fixme: rather inefficient....
-    if( Intersect( aSeg ) )
+    if( segmentsIntersect( *this, aSeg ) )
         return 0;
 
     const VECTOR2I pts[4] =
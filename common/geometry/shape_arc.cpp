@@ -0,0 +1,231 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <math.h>
+
+#include <geometry/geometry_utils.h>
+#include <geometry/shape_arc.h>
+#include <geometry/shape_line_chain.h>
+
+
+static inline const VECTOR2I roundVector( const VECTOR2D& aV )
+{
+    return VECTOR2I( (int) floor( aV.x + 0.5 ), (int) floor( aV.y + 0.5 ) );
+}
+
+
+const VECTOR2I SHAPE_ARC::GetP1() const
+{
+    VECTOR2D rvec = VECTOR2D( m_p0 - m_pc ).Rotate( m_centralAngle * M_PI / 180.0 );
+
+    return m_pc + roundVector( rvec );
+}
+
+
+double SHAPE_ARC::GetStartAngle() const
+{
+    return VECTOR2D( m_p0 - m_pc ).Angle() * 180.0 / M_PI;
+}
+
+
+double SHAPE_ARC::GetEndAngle() const
+{
+    return GetStartAngle() + m_centralAngle;
+}
+
+
+int SHAPE_ARC::GetRadius() const
+{
+    return ( m_p0 - m_pc ).EuclideanNorm();
+}
+
+
+bool SHAPE_ARC::sweepContains( const VECTOR2I& aP ) const
+{
+    if( fabs( m_centralAngle ) >= 360.0 || aP == m_pc )
+        return true;
+
+    VECTOR2D v0( m_p0 - m_pc );
+    VECTOR2D v( aP - m_pc );
+
+    // the angle from the start point to aP, in the direction of the arc
+    double angle = atan2( v0.x * v.y - v0.y * v.x, v0.x * v.x + v0.y * v.y ) * 180.0 / M_PI;
+
+    if( m_centralAngle < 0.0 )
+        angle = -angle;
+
+    if( angle < 0.0 )
+        angle += 360.0;
+
+    return angle <= fabs( m_centralAngle );
+}
+
+
+const BOX2I SHAPE_ARC::BBox( int aClearance ) const
+{
+    BOX2I box( m_p0, VECTOR2I( 0, 0 ) );
+    int radius = GetRadius();
+
+    box.Merge( GetP1() );
+
+    // the extremes of the circle along the axes which are in the sweep of the arc
+    const VECTOR2I extremes[4] =
+    {
+        m_pc + VECTOR2I( radius, 0 ), m_pc + VECTOR2I( 0, radius ),
+        m_pc + VECTOR2I( -radius, 0 ), m_pc + VECTOR2I( 0, -radius )
+    };
+
+    for( int i = 0; i < 4; i++ )
+    {
+        if( sweepContains( extremes[i] ) )
+            box.Merge( extremes[i] );
+    }
+
+    return box.Inflate( aClearance + ( m_width + 1 ) / 2 );
+}
+
+
+double SHAPE_ARC::Distance( const VECTOR2I& aP ) const
+{
+    if( sweepContains( aP ) )
+        return fabs( VECTOR2D( aP - m_pc ).EuclideanNorm() - VECTOR2D( m_p0 - m_pc ).EuclideanNorm() );
+
+    return std::min( VECTOR2D( aP - m_p0 ).EuclideanNorm(), VECTOR2D( aP - GetP1() ).EuclideanNorm() );
+}
+
+
+double SHAPE_ARC::Distance( const SEG& aSeg ) const
+{
+    const double radius = VECTOR2D( m_p0 - m_pc ).EuclideanNorm();
+    const VECTOR2D d( aSeg.B - aSeg.A );
+    const VECTOR2D f( aSeg.A - m_pc );
+
+    // the segment crosses the arc where it crosses the circle in the sweep
+    double a = d.x * d.x + d.y * d.y;
+    double b = 2.0 * ( f.x * d.x + f.y * d.y );
+    double c = f.x * f.x + f.y * f.y - radius * radius;
+    double disc = b * b - 4.0 * a * c;
+
+    if( a > 0.0 && disc >= 0.0 )
+    {
+        double sq = sqrt( disc );
+        double t[2] = { ( -b - sq ) / ( 2.0 * a ), ( -b + sq ) / ( 2.0 * a ) };
+
+        for( int i = 0; i < 2; i++ )
+        {
+            if( t[i] >= 0.0 && t[i] <= 1.0
+                && sweepContains( aSeg.A + roundVector( d * t[i] ) ) )
+                return 0.0;
+        }
+    }
+
+    // Else the closest points are an end of the arc and a point of the segment, or a
+    // point of the arc and an end of the segment, or the point of the segment nearest
+    // to the center and its projection on the arc
+    double dist = std::min( (double) aSeg.Distance( m_p0 ), (double) aSeg.Distance( GetP1() ) );
+    const VECTOR2I candidates[3] = { aSeg.A, aSeg.B, aSeg.NearestPoint( m_pc ) };
+
+    for( int i = 0; i < 3; i++ )
+    {
+        if( sweepContains( candidates[i] ) )
+            dist = std::min( dist, fabs( VECTOR2D( candidates[i] - m_pc ).EuclideanNorm() - radius ) );
+    }
+
+    return dist;
+}
+
+
+double SHAPE_ARC::Distance( const SHAPE_ARC& aArc ) const
+{
+    const double ra = VECTOR2D( m_p0 - m_pc ).EuclideanNorm();
+    const double rb = VECTOR2D( aArc.m_p0 - aArc.m_pc ).EuclideanNorm();
+    const VECTOR2D delta( aArc.m_pc - m_pc );
+    const double d = delta.EuclideanNorm();
+
+    double dist = std::min( std::min( Distance( aArc.m_p0 ), Distance( aArc.GetP1() ) ),
+                            std::min( aArc.Distance( m_p0 ), aArc.Distance( GetP1() ) ) );
+
+    // concentric arcs are closest at an end of one of them
+    if( d == 0.0 )
+        return dist;
+
+    const VECTOR2D u = delta * ( 1.0 / d );
+    const VECTOR2D n( -u.y, u.x );
+
+    // the arcs cross where the circles cross in both sweeps
+    if( d <= ra + rb && d >= fabs( ra - rb ) )
+    {
+        double a = ( ra * ra - rb * rb + d * d ) / ( 2.0 * d );
+        double h = sqrt( std::max( 0.0, ra * ra - a * a ) );
+
+        for( int side = -1; side <= 1; side += 2 )
+        {
+            VECTOR2I p = m_pc + roundVector( u * a + n * ( h * side ) );
+
+            if( sweepContains( p ) && aArc.sweepContains( p ) )
+                return 0.0;
+        }
+    }
+
+    // Else the closest points are an end of an arc and a point of the other one, or
+    // two points on the line of the centers
+    for( int sa = -1; sa <= 1; sa += 2 )
+    {
+        VECTOR2I pa = m_pc + roundVector( u * ( ra * sa ) );
+
+        if( !sweepContains( pa ) )
+            continue;
+
+        for( int sb = -1; sb <= 1; sb += 2 )
+        {
+            VECTOR2I pb = aArc.m_pc + roundVector( u * ( rb * sb ) );
+
+            if( aArc.sweepContains( pb ) )
+                dist = std::min( dist, VECTOR2D( pb - pa ).EuclideanNorm() );
+        }
+    }
+
+    return dist;
+}
+
+
+const SHAPE_LINE_CHAIN SHAPE_ARC::ConvertToPolyline( double aAccuracy ) const
+{
+    SHAPE_LINE_CHAIN rv;
+    int n = GetArcToSegmentCount( GetRadius(), aAccuracy, m_centralAngle );
+    VECTOR2D rvec( m_p0 - m_pc );
+
+    rv.Append( m_p0 );
+
+    for( int i = 1; i < n; i++ )
+    {
+        double angle = m_centralAngle * M_PI / 180.0 * i / n;
+
+        rv.Append( m_pc + roundVector( rvec.Rotate( angle ) ) );
+    }
+
+    rv.Append( GetP1() );
+
+    return rv;
+}
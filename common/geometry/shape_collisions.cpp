@@ -31,6 +31,7 @@
 #include <geometry/shape_rect.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_convex.h>
+#include <geometry/shape_arc.h>
 
 typedef VECTOR2I::extended_type ecoord;
 
@@ -150,13 +151,22 @@ static inline bool Collide( const SHAPE_CIRCLE& aA, const SHAPE_LINE_CHAIN& aB,
                             bool aNeedMTV, VECTOR2I& aMTV )
 {
     bool found = false;
+    const BOX2I center( aA.GetCenter(), VECTOR2I( 0, 0 ) );
 
-    for( int s = 0; s < aB.SegmentCount(); s++ )
+    // the distances computed by SHAPE_CIRCLE::Collide() are rounded, hence the extra 1
+    const int margin = aClearance + aA.GetRadius() + 1;
+
+    for( int first = 0; first < aB.SegmentCount() && !found; first += 32 )
     {
-        if( aA.Collide( aB.CSegment( s ), aClearance ) )
+        unsigned int near = aB.NearSegments( center, margin, first );
+
+        for( int s = first; near; s++, near >>= 1 )
         {
-            found = true;
-            break;
+            if( ( near & 1 ) && aA.Collide( aB.CSegment( s ), aClearance ) )
+            {
+                found = true;
+                break;
+            }
         }
     }
 
@@ -301,6 +311,66 @@ static inline bool Collide( const SHAPE_RECT& aA, const SHAPE_RECT& aB, int aCle
 }
 
 
+// The collisions of the arcs are exact, but do not compute a MTV
+static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_CIRCLE& aB, int aClearance,
+                            bool aNeedMTV, VECTOR2I& aMTV )
+{
+    return aA.Collide( aB.GetCenter(), aClearance + aB.GetRadius() );
+}
+
+
+static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_SEGMENT& aB, int aClearance,
+                            bool aNeedMTV, VECTOR2I& aMTV )
+{
+    return aA.Collide( aB.GetSeg(), aClearance + aB.GetWidth() / 2 );
+}
+
+
+static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_LINE_CHAIN& aB, int aClearance,
+                            bool aNeedMTV, VECTOR2I& aMTV )
+{
+    const BOX2I box = aA.BBox( aClearance );
+
+    for( int first = 0; first < aB.SegmentCount(); first += 32 )
+    {
+        unsigned int near = aB.NearSegments( box, 1, first );
+
+        for( int s = first; near; s++, near >>= 1 )
+        {
+            if( ( near & 1 ) && aA.Collide( aB.CSegment( s ), aClearance ) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_RECT& aB, int aClearance,
+                            bool aNeedMTV, VECTOR2I& aMTV )
+{
+    // an arc inside the rectangle does not cross its outline
+    if( aB.Collide( SEG( aA.GetP0(), aA.GetP0() ), aClearance ) )
+        return true;
+
+    return Collide( aA, aB.Outline(), aClearance, aNeedMTV, aMTV );
+}
+
+
+static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_CONVEX& aB, int aClearance,
+                            bool aNeedMTV, VECTOR2I& aMTV )
+{
+    return Collide( aA, aB.Vertices(), aClearance, aNeedMTV, aMTV );
+}
+
+
+static inline bool Collide( const SHAPE_ARC& aA, const SHAPE_ARC& aB, int aClearance,
+                            bool aNeedMTV, VECTOR2I& aMTV )
+{
+    return aA.Distance( aB ) < ( aA.GetWidth() + 1 ) / 2 + ( aB.GetWidth() + 1 ) / 2 + aClearance;
+}
+
+
 template<class ShapeAType, class ShapeBType>
 inline bool CollCase( const SHAPE* aA, const SHAPE* aB, int aClearance, bool aNeedMTV, VECTOR2I& aMTV )
 {
@@ -343,6 +413,9 @@ bool CollideShapes( const SHAPE* aA, const SHAPE* aB, int aClearance, bool aNeed
                 case SH_CONVEX:
                     return CollCase<SHAPE_RECT, SHAPE_CONVEX>( aA, aB, aClearance, aNeedMTV, aMTV );
 
+                case SH_ARC:
+                    return CollCaseReversed<SHAPE_RECT, SHAPE_ARC>( aA, aB, aClearance, aNeedMTV, aMTV );
+
                 default:
                     break;
             }
@@ -366,6 +439,9 @@ bool CollideShapes( const SHAPE* aA, const SHAPE* aB, int aClearance, bool aNeed
                 case SH_CONVEX:
                     return CollCase<SHAPE_CIRCLE, SHAPE_CONVEX>( aA, aB, aClearance, aNeedMTV, aMTV );
 
+                case SH_ARC:
+                    return CollCaseReversed<SHAPE_CIRCLE, SHAPE_ARC>( aA, aB, aClearance, aNeedMTV, aMTV );
+
                 default:
                     break;
             }
@@ -389,6 +465,9 @@ bool CollideShapes( const SHAPE* aA, const SHAPE* aB, int aClearance, bool aNeed
                 case SH_CONVEX:
                     return CollCase<SHAPE_LINE_CHAIN, SHAPE_CONVEX>( aA, aB, aClearance, aNeedMTV, aMTV );
 
+                case SH_ARC:
+                    return CollCaseReversed<SHAPE_LINE_CHAIN, SHAPE_ARC>( aA, aB, aClearance, aNeedMTV, aMTV );
+
                 default:
                     break;
             }
@@ -412,6 +491,9 @@ bool CollideShapes( const SHAPE* aA, const SHAPE* aB, int aClearance, bool aNeed
                 case SH_CONVEX:
                     return CollCase<SHAPE_CONVEX, SHAPE_SEGMENT>( aB, aA, aClearance, aNeedMTV, aMTV );
 
+                case SH_ARC:
+                    return CollCaseReversed<SHAPE_SEGMENT, SHAPE_ARC>( aA, aB, aClearance, aNeedMTV, aMTV );
+
                 default:
                     break;
             }
@@ -435,6 +517,35 @@ bool CollideShapes( const SHAPE* aA, const SHAPE* aB, int aClearance, bool aNeed
                 case SH_CONVEX:
                     return CollCase<SHAPE_CONVEX, SHAPE_CONVEX>( aA, aB, aClearance, aNeedMTV, aMTV );
 
+                case SH_ARC:
+                    return CollCaseReversed<SHAPE_CONVEX, SHAPE_ARC>( aA, aB, aClearance, aNeedMTV, aMTV );
+
+                default:
+                    break;
+            }
+            break;
+
+        case SH_ARC:
+            switch( aB->Type() )
+            {
+                case SH_RECT:
+                    return CollCase<SHAPE_ARC, SHAPE_RECT>( aA, aB, aClearance, aNeedMTV, aMTV );
+
+                case SH_CIRCLE:
+                    return CollCase<SHAPE_ARC, SHAPE_CIRCLE>( aA, aB, aClearance, aNeedMTV, aMTV );
+
+                case SH_LINE_CHAIN:
+                    return CollCase<SHAPE_ARC, SHAPE_LINE_CHAIN>( aA, aB, aClearance, aNeedMTV, aMTV );
+
+                case SH_SEGMENT:
+                    return CollCase<SHAPE_ARC, SHAPE_SEGMENT>( aA, aB, aClearance, aNeedMTV, aMTV );
+
+                case SH_CONVEX:
+                    return CollCase<SHAPE_ARC, SHAPE_CONVEX>( aA, aB, aClearance, aNeedMTV, aMTV );
+
+                case SH_ARC:
+                    return CollCase<SHAPE_ARC, SHAPE_ARC>( aA, aB, aClearance, aNeedMTV, aMTV );
+
                 default:
                     break;
             }
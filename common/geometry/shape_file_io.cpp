@@ -26,11 +26,14 @@
 #include <cassert>
 
 #include <geometry/shape.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
 #include <geometry/shape_file_io.h>
 
 SHAPE_FILE_IO::SHAPE_FILE_IO( const std::string& aFilename, SHAPE_FILE_IO::IO_MODE aMode )
 {
     m_groupActive = false;
+    m_readStreamLoaded = false;
 
     if( aFilename.length() )
     {
@@ -65,42 +68,63 @@ SHAPE_FILE_IO::~SHAPE_FILE_IO()
 }
 
 
-SHAPE* SHAPE_FILE_IO::Read()
+SHAPE* SHAPE_FILE_IO::Read( std::string* aName )
 {
- /*   char tmp[1024];
+    assert( m_mode == IOM_READ );
 
-    do {
+    if( !m_file )
+        return NULL;
 
-        if (fscanf(m_file, "%s", tmp) != 1)
-            return NULL;
+    if( !m_readStreamLoaded )
+    {
+        char buf[4096];
+        size_t len;
+
+        while( ( len = fread( buf, 1, sizeof( buf ), m_file ) ) > 0 )
+            m_readStream.write( buf, len );
 
-        if( !strcmp( tmp, "shape" )
-            break;
+        m_readStreamLoaded = true;
     }
 
+    std::string token, name;
     int type;
 
-    SHAPE *rv = NULL;
+    while( m_readStream >> token )
+    {
+        if( token == "group" )
+        {
+            m_readStream >> token;     // the group name
+            continue;
+        }
 
-    fscanf(m_file,"%d %s", &type, tmp);
+        if( token != "shape" )
+            continue;
 
-    printf("create shape %d\n", type);
+        if( !( m_readStream >> type >> name ) )
+            return NULL;
 
-    switch(type)
-    {
-        case SHAPE::LINE_CHAIN:
-            rv = new SHAPE_LINE_CHAIN;
-            break;
-    }
+        SHAPE* shape;
 
-    if(!rv)
-        return NULL;
+        switch( type )
+        {
+        case SH_POLY_SET:   shape = new SHAPE_POLY_SET; break;
+        case SH_LINE_CHAIN: shape = new SHAPE_LINE_CHAIN; break;
+        default:
+            return NULL;    // The end of the data of other shapes cannot be found
+        }
+
+        if( !shape->Parse( m_readStream ) )
+        {
+            delete shape;
+            return NULL;
+        }
 
-    rv.Parse ( )
+        if( aName )
+            *aName = name;
+
+        return shape;
+    }
 
-    fprintf(m_file,"shape %d %s %s\n", aShape->Type(), aName.c_str(), sh.c_str() );
-*/
-    assert( false );
     return NULL;
 }
 
@@ -22,11 +22,92 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <climits>
+
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_circle.h>
+#include <geometry/shape_arc.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define USE_SSE2_NEAR_SEGMENTS
+#endif
 
 using boost::optional;
 
+
+static inline int clampCoord( BOX2I::ecoord_type aValue )
+{
+    aValue = std::min<BOX2I::ecoord_type>( INT_MAX, aValue );
+
+    return (int) std::max<BOX2I::ecoord_type>( INT_MIN, aValue );
+}
+
+
+/// @return true if the segment aA-aB lies entirely on one side of the box aLo-aHi
+static inline bool outsideBox( const VECTOR2I& aA, const VECTOR2I& aB,
+                               const VECTOR2I& aLo, const VECTOR2I& aHi )
+{
+    return ( aA.x < aLo.x && aB.x < aLo.x ) || ( aA.x > aHi.x && aB.x > aHi.x ) ||
+           ( aA.y < aLo.y && aB.y < aLo.y ) || ( aA.y > aHi.y && aB.y > aHi.y );
+}
+
+
+unsigned int SHAPE_LINE_CHAIN::NearSegments( const BOX2I& aBox, int aMargin, int aFirst ) const
+{
+    const int count = std::min( SegmentCount() - aFirst, 32 );
+
+    // the closing segment of a closed chain does not join two consecutive points
+    const int open = std::min( count, (int) m_points.size() - 1 - aFirst );
+
+    const VECTOR2I lo( clampCoord( (BOX2I::ecoord_type) aBox.GetX() - aMargin ),
+                       clampCoord( (BOX2I::ecoord_type) aBox.GetY() - aMargin ) );
+    const VECTOR2I hi( clampCoord( (BOX2I::ecoord_type) aBox.GetRight() + aMargin ),
+                       clampCoord( (BOX2I::ecoord_type) aBox.GetBottom() + aMargin ) );
+
+    unsigned int mask = 0;
+    int i = 0;
+
+#ifdef USE_SSE2_NEAR_SEGMENTS
+    // two segments at once: the lanes hold (x0, y0, x1, y1) for the start points,
+    // and (x1, y1, x2, y2) for the end points
+    const __m128i lo4 = _mm_set_epi32( lo.y, lo.x, lo.y, lo.x );
+    const __m128i hi4 = _mm_set_epi32( hi.y, hi.x, hi.y, hi.x );
+
+    for( ; i + 1 < open; i += 2 )
+    {
+        const VECTOR2I* p = &m_points[aFirst + i];
+        const __m128i a = _mm_loadu_si128( (const __m128i*) p );
+        const __m128i b = _mm_loadu_si128( (const __m128i*) ( p + 1 ) );
+
+        const __m128i below = _mm_and_si128( _mm_cmplt_epi32( a, lo4 ),
+                                             _mm_cmplt_epi32( b, lo4 ) );
+        const __m128i above = _mm_and_si128( _mm_cmpgt_epi32( a, hi4 ),
+                                             _mm_cmpgt_epi32( b, hi4 ) );
+        const int outside = _mm_movemask_ps( _mm_castsi128_ps( _mm_or_si128( below, above ) ) );
+
+        if( !( outside & 3 ) )
+            mask |= 1u << i;
+
+        if( !( outside & 12 ) )
+            mask |= 2u << i;
+    }
+#endif
+
+    for( ; i < open; i++ )
+    {
+        if( !outsideBox( m_points[aFirst + i], m_points[aFirst + i + 1], lo, hi ) )
+            mask |= 1u << i;
+    }
+
+    if( open < count && !outsideBox( m_points.back(), m_points[0], lo, hi ) )
+        mask |= 1u << open;
+
+    return mask;
+}
+
+
 bool SHAPE_LINE_CHAIN::Collide( const VECTOR2I& aP, int aClearance ) const
 {
     // fixme: ugly!
@@ -40,17 +121,27 @@ bool SHAPE_LINE_CHAIN::Collide( const SEG& aSeg, int aClearance ) const
     BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
     BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
 
-    for( int i = 0; i < SegmentCount(); i++ )
-    {
-        const SEG& s = CSegment( i );
-        BOX2I box_b( s.A, s.B - s.A );
+    box_a.Normalize();
 
-        BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
+    for( int first = 0; first < SegmentCount(); first += 32 )
+    {
+        unsigned int near = NearSegments( box_a, std::abs( aClearance ), first );
 
-        if( d < dist_sq )
+        for( int i = first; near; i++, near >>= 1 )
         {
-            if( s.Collide( aSeg, aClearance ) )
-                return true;
+            if( !( near & 1 ) )
+                continue;
+
+            const SEG& s = CSegment( i );
+            BOX2I box_b( s.A, s.B - s.A );
+
+            BOX2I::ecoord_type d = box_a.SquaredDistance( box_b );
+
+            if( d < dist_sq )
+            {
+                if( s.Collide( aSeg, aClearance ) )
+                    return true;
+            }
         }
     }
 
@@ -80,6 +171,15 @@ int SHAPE_LINE_CHAIN::Length() const
 }
 
 
+void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc, double aAccuracy )
+{
+    const SHAPE_LINE_CHAIN chain = aArc.ConvertToPolyline( aAccuracy );
+
+    for( int i = 0; i < chain.PointCount(); i++ )
+        Append( chain.CPoint( i ) );
+}
+
+
 void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I& aP )
 {
     if( aEndIndex < 0 )
@@ -229,17 +329,29 @@ struct compareOriginDistance
 
 int SHAPE_LINE_CHAIN::Intersect( const SEG& aSeg, INTERSECTIONS& aIp ) const
 {
-    for( int s = 0; s < SegmentCount(); s++ )
+    BOX2I box( aSeg.A, aSeg.B - aSeg.A );
+
+    box.Normalize();
+
+    for( int first = 0; first < SegmentCount(); first += 32 )
     {
-        OPT_VECTOR2I p = CSegment( s ).Intersect( aSeg );
+        unsigned int near = NearSegments( box, 1, first );
 
-        if( p )
+        for( int s = first; near; s++, near >>= 1 )
         {
-            INTERSECTION is;
-            is.our = CSegment( s );
-            is.their = aSeg;
-            is.p = *p;
-            aIp.push_back( is );
+            if( !( near & 1 ) )
+                continue;
+
+            OPT_VECTOR2I p = CSegment( s ).Intersect( aSeg );
+
+            if( p )
+            {
+                INTERSECTION is;
+                is.our = CSegment( s );
+                is.their = aSeg;
+                is.p = *p;
+                aIp.push_back( is );
+            }
         }
     }
 
@@ -257,13 +369,24 @@ int SHAPE_LINE_CHAIN::Intersect( const SHAPE_LINE_CHAIN& aChain, INTERSECTIONS&
     for( int s1 = 0; s1 < SegmentCount(); s1++ )
     {
         const SEG& a = CSegment( s1 );
-        const BOX2I bb_cur( a.A, a.B - a.A );
+        BOX2I bb_cur( a.A, a.B - a.A );
 
         if( !bb_other.Intersects( bb_cur ) )
             continue;
 
-        for( int s2 = 0; s2 < aChain.SegmentCount(); s2++ )
+        bb_cur.Normalize();
+
+        unsigned int near = 0;
+
+        for( int s2 = 0; s2 < aChain.SegmentCount(); s2++, near >>= 1 )
         {
+            // only the segments closer than 1 to a can touch it
+            if( s2 % 32 == 0 )
+                near = aChain.NearSegments( bb_cur, 1, s2 );
+
+            if( !( near & 1 ) )
+                continue;
+
             const SEG& b = aChain.CSegment( s2 );
             INTERSECTION is;
 
@@ -370,8 +493,20 @@ const optional<SHAPE_LINE_CHAIN::INTERSECTION> SHAPE_LINE_CHAIN::SelfIntersectin
 {
     for( int s1 = 0; s1 < SegmentCount(); s1++ )
     {
-        for( int s2 = s1 + 1; s2 < SegmentCount(); s2++ )
+        const SEG seg1 = CSegment( s1 );
+        BOX2I box1( seg1.A, seg1.B - seg1.A );
+        unsigned int near = 0;
+
+        box1.Normalize();
+
+        for( int s2 = s1 + 1; s2 < SegmentCount(); s2++, near >>= 1 )
         {
+            if( ( s2 - s1 - 1 ) % 32 == 0 )
+                near = NearSegments( box1, 1, s2 );
+
+            if( !( near & 1 ) )
+                continue;
+
             const VECTOR2I s2a = CSegment( s2 ).A, s2b = CSegment( s2 ).B;
 
             if( s1 + 1 != s2 && CSegment( s1 ).Contains( s2a ) )
@@ -33,6 +33,8 @@
 #include <algorithm>
 
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
@@ -41,7 +43,9 @@
 using namespace ClipperLib;
 
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
-    SHAPE( SH_POLY_SET )
+    SHAPE( SH_POLY_SET ),
+    m_triangulationHash( 0 ),
+    m_triangulationValid( false )
 {
 
 }
@@ -54,6 +58,8 @@ SHAPE_POLY_SET::~SHAPE_POLY_SET()
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    invalidateContainsIndex();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
     poly.push_back( empty_path );
@@ -64,6 +70,8 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    invalidateContainsIndex();
+
     m_polys.back().push_back( SHAPE_LINE_CHAIN() );
 
     return m_polys.back().size() - 2;
@@ -72,6 +80,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole )
 {
+    invalidateContainsIndex();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -131,6 +141,8 @@ const VECTOR2I& SHAPE_POLY_SET::CVertex( int index, int aOutline , int aHole ) c
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int index, int aOutline , int aHole )
 {
+    invalidateContainsIndex();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -150,6 +162,8 @@ VECTOR2I& SHAPE_POLY_SET::Vertex( int index, int aOutline , int aHole )
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    invalidateContainsIndex();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -164,6 +178,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    invalidateContainsIndex();
+
     assert ( m_polys.size() );
 
     if( aOutline < 0 )
@@ -300,8 +316,223 @@ void SHAPE_POLY_SET::BooleanIntersection( const SHAPE_POLY_SET& a, const SHAPE_P
 }
 
 
+/**
+ * Function pointInOutline
+ * @return true if aP is inside the closed outline aPath, of any shape (crossing number test).
+ * A point on the outline itself can be found inside or outside.
+ */
+static bool pointInOutline( const SHAPE_LINE_CHAIN& aPath, const VECTOR2I& aP )
+{
+    bool inside = false;
+    int count = aPath.PointCount();
+
+    for( int i = 0, j = count - 1; i < count; j = i++ )
+    {
+        const VECTOR2I& a = aPath.CPoint( i );
+        const VECTOR2I& b = aPath.CPoint( j );
+
+        if( ( a.y > aP.y ) != ( b.y > aP.y ) )
+        {
+            double x = a.x + (double) ( aP.y - a.y ) * ( b.x - a.x ) / ( b.y - a.y );
+
+            if( aP.x < x )
+                inside = !inside;
+        }
+    }
+
+    return inside;
+}
+
+
+void SHAPE_POLY_SET::BooleanSubtractTiled( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
+                                           int aTileCount, POLYGON_MODE aFastMode )
+{
+    if( aTileCount < 2 || a.IsEmpty() )
+    {
+        BooleanSubtract( a, b, aFastMode );
+        return;
+    }
+
+    // The tiles overlap a little, so that the rounding of the intersections found on the
+    // tile borders cannot leave a gap between two tiles once they are merged
+    const int overlap = 64;
+
+    const BOX2I bbox = a.BBox();
+    const int tileCount = aTileCount * aTileCount;
+
+    std::vector<BOX2I> holeBoxes( b.m_polys.size() );
+
+    for( unsigned i = 0; i < b.m_polys.size(); i++ )
+        holeBoxes[i] = b.m_polys[i][0].BBox();
+
+    std::vector<SHAPE_POLY_SET> tiles( tileCount );
+
+    // Holes of the result far enough from the tile borders, which no other tile can cover
+    std::vector< std::vector<SHAPE_LINE_CHAIN> > innerHoles( tileCount );
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for( int t = 0; t < tileCount; t++ )
+    {
+        int col = t % aTileCount;
+        int row = t / aTileCount;
+
+        VECTOR2I start( bbox.GetX() + (int) ( (int64_t) bbox.GetWidth() * col / aTileCount ),
+                        bbox.GetY() + (int) ( (int64_t) bbox.GetHeight() * row / aTileCount ) );
+        VECTOR2I end( bbox.GetX() + (int) ( (int64_t) bbox.GetWidth() * ( col + 1 ) / aTileCount ),
+                      bbox.GetY() + (int) ( (int64_t) bbox.GetHeight() * ( row + 1 ) / aTileCount ) );
+
+        // The neighbour tiles cover up to overlap inside this one
+        const BOX2I inner( start + VECTOR2I( overlap, overlap ),
+                           end - start - VECTOR2I( 2 * overlap, 2 * overlap ) );
+
+        start -= VECTOR2I( overlap, overlap );
+        end += VECTOR2I( overlap, overlap );
+
+        SHAPE_POLY_SET tile;
+
+        tile.NewOutline();
+        tile.Append( start.x, start.y );
+        tile.Append( end.x, start.y );
+        tile.Append( end.x, end.y );
+        tile.Append( start.x, end.y );
+
+        // Only the outlines and holes of a, and the holes of b, which are on the tile are used
+        const BOX2I tileBox( start, end - start );
+        SHAPE_POLY_SET area, holes;
+
+        BOOST_FOREACH( const POLYGON& poly, a.m_polys )
+        {
+            if( !poly[0].BBox().Intersects( tileBox ) )
+                continue;
+
+            area.m_polys.push_back( POLYGON( 1, poly[0] ) );
+
+            for( unsigned i = 1; i < poly.size(); i++ )
+            {
+                if( poly[i].BBox().Intersects( tileBox ) )
+                    area.m_polys.back().push_back( poly[i] );
+            }
+        }
+
+        for( unsigned i = 0; i < holeBoxes.size(); i++ )
+        {
+            if( holeBoxes[i].Intersects( tileBox ) )
+                holes.m_polys.push_back( b.m_polys[i] );
+        }
+
+        tiles[t].BooleanIntersection( area, tile, aFastMode );
+
+        if( !tiles[t].IsEmpty() && !holes.IsEmpty() )
+            tiles[t].BooleanSubtract( holes, aFastMode );
+
+        if( inner.GetWidth() <= 0 || inner.GetHeight() <= 0 )
+            continue;
+
+        // A hole with an island inside stays in the union, which would merge the island into
+        // the polygon around the hole otherwise
+        std::vector<BOX2I> outlineBoxes;
+
+        BOOST_FOREACH( const POLYGON& poly, tiles[t].m_polys )
+            outlineBoxes.push_back( poly[0].BBox() );
+
+        BOOST_FOREACH( POLYGON& poly, tiles[t].m_polys )
+        {
+            POLYGON kept;
+
+            kept.push_back( poly[0] );
+
+            for( unsigned i = 1; i < poly.size(); i++ )
+            {
+                const BOX2I holeBox = poly[i].BBox();
+                bool isInner = inner.Contains( holeBox );
+
+                for( unsigned j = 0; isInner && j < outlineBoxes.size(); j++ )
+                {
+                    if( holeBox.Contains( outlineBoxes[j] ) )
+                        isInner = false;
+                }
+
+                if( isInner )
+                    innerHoles[t].push_back( poly[i] );
+                else
+                    kept.push_back( poly[i] );
+            }
+
+            poly.swap( kept );
+        }
+    }
+
+    // Stitch the tiles back together: the union removes the overlaps and the seams.  The inner
+    // holes are left out of it, most of the vertices of a large zone being in these holes.
+    m_polys.clear();
+
+    for( int t = 0; t < tileCount; t++ )
+        m_polys.insert( m_polys.end(), tiles[t].m_polys.begin(), tiles[t].m_polys.end() );
+
+    Simplify( aFastMode );
+
+    // Then give each inner hole back to the innermost polygon of the union which contains it
+    std::vector<const SHAPE_LINE_CHAIN*> allHoles;
+
+    for( int t = 0; t < tileCount; t++ )
+    {
+        for( unsigned i = 0; i < innerHoles[t].size(); i++ )
+            allHoles.push_back( &innerHoles[t][i] );
+    }
+
+    int polyCount = m_polys.size();
+    int holeCount = allHoles.size();
+    std::vector<BOX2I> outlineBoxes( polyCount );
+    std::vector<int> owners( holeCount, -1 );
+
+    for( int i = 0; i < polyCount; i++ )
+        outlineBoxes[i] = m_polys[i][0].BBox();
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for
+#endif
+    for( int h = 0; h < holeCount; h++ )
+    {
+        const SHAPE_LINE_CHAIN& hole = *allHoles[h];
+        const BOX2I holeBox = hole.BBox();
+
+        for( int i = 0; i < polyCount; i++ )
+        {
+            if( !outlineBoxes[i].Contains( holeBox ) )
+                continue;
+
+            // The polygons nested in a hole of another polygon have a smaller bounding box
+            if( owners[h] >= 0 && outlineBoxes[owners[h]].GetArea() <= outlineBoxes[i].GetArea() )
+                continue;
+
+            // A vertex of the hole can touch the outline, and then be found outside of it: a
+            // few vertices are tried.  No vertex of the hole is inside the outline of a
+            // polygon which does not contain the hole, or of a polygon nested in its own.
+            for( int p = 0; p < 3; p++ )
+            {
+                if( pointInOutline( m_polys[i][0], hole.CPoint( p * hole.PointCount() / 3 ) ) )
+                {
+                    owners[h] = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    for( int h = 0; h < holeCount; h++ )
+    {
+        if( owners[h] >= 0 )
+            m_polys[owners[h]].push_back( *allHoles[h] );
+    }
+}
+
+
 void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount )
 {
+    invalidateContainsIndex();
+
     // A static table to avoid repetitive calculations of the coefficient
     // 1.0 - cos( M_PI/aCircleSegmentsCount)
     // aCircleSegmentsCount is most of time <= 64 and usually 8, 12, 16, 32
@@ -348,6 +579,8 @@ void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount )
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree)
 {
+    invalidateContainsIndex();
+
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -408,7 +641,50 @@ struct FractureEdge
 
 typedef std::vector<FractureEdge*> FractureEdgeSet;
 
-static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
+
+/**
+ * Struct FractureEdgeStrips
+ * sorts the fracture edges of a polygon in horizontal strips, so that the edges crossing
+ * a horizontal line are found without scanning all the edges.  The edges of each strip are
+ * kept in the order they are added, like in the FractureEdgeSet.
+ */
+struct FractureEdgeStrips
+{
+    FractureEdgeStrips( int aYMin, int aYMax, int aStripCount ) :
+        m_yMin( aYMin ),
+        m_strips( aStripCount )
+    {
+        m_height = ( (int64_t) aYMax - aYMin ) / aStripCount + 1;
+    }
+
+    int stripIndex( int y ) const
+    {
+        int64_t index = ( (int64_t) y - m_yMin ) / m_height;
+
+        return std::max<int64_t>( 0, std::min<int64_t>( index, m_strips.size() - 1 ) );
+    }
+
+    void Add( FractureEdge* aEdge )
+    {
+        int last = stripIndex( std::max( aEdge->m_p1.y, aEdge->m_p2.y ) );
+
+        for( int i = stripIndex( std::min( aEdge->m_p1.y, aEdge->m_p2.y ) ); i <= last; i++ )
+            m_strips[i].push_back( aEdge );
+    }
+
+    ///> @return the edges which can cross the horizontal line at y (and some which do not)
+    const FractureEdgeSet& Strip( int y ) const
+    {
+        return m_strips[ stripIndex( y ) ];
+    }
+
+    int m_yMin;
+    int64_t m_height;
+    std::vector<FractureEdgeSet> m_strips;
+};
+
+
+static int processEdge( FractureEdgeSet& edges, FractureEdgeStrips& strips, FractureEdge* edge )
 {
     int x = edge->m_p1.x;
     int y = edge->m_p1.y;
@@ -417,9 +693,13 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
     FractureEdge* e_nearest = NULL;
 
-    for( FractureEdgeSet::iterator i = edges.begin(); i != edges.end(); ++i )
+    // Only the edges of the strip of y can cross the line at y.  They are in the same order
+    // as in edges, so the same edge is found when several ones are at the same distance.
+    const FractureEdgeSet& candidates = strips.Strip( y );
+
+    for( FractureEdgeSet::const_iterator i = candidates.begin(); i != candidates.end(); ++i )
     {
-        if( !(*i)->matches( y ) )
+        if( !(*i)->m_connected || !(*i)->matches( y ) )
             continue;
 
         int x_intersect;
@@ -431,7 +711,7 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
         int dist = ( x - x_intersect );
 
-        if( dist >= 0 && dist < min_dist && (*i)->m_connected )
+        if( dist >= 0 && dist < min_dist )
         {
             min_dist = dist;
             x_nearest = x_intersect;
@@ -451,6 +731,12 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
         edges.push_back( lead1 );
         edges.push_back( lead2 );
 
+        // e_nearest is shortened below, but stays in the strips of its initial length:
+        // matches() rejects it where it is no more
+        strips.Add( split_2 );
+        strips.Add( lead1 );
+        strips.Add( lead2 );
+
         FractureEdge* link = e_nearest->m_next;
 
         e_nearest->m_p2 = VECTOR2I( x_nearest, y );
@@ -475,6 +761,15 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
     return 0;
 }
 
+
+/// Sort functor for the left-most edges of the holes: from left to right, and in the order
+/// they were found for the same x (with std::stable_sort)
+static bool fractureEdgeLessX( const FractureEdge* aA, const FractureEdge* aB )
+{
+    return aA->m_p1.x < aB->m_p1.x;
+}
+
+
 void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 {
     FractureEdgeSet edges;
@@ -486,8 +781,6 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
     if( paths.size() == 1 )
         return;
 
-    int num_unconnected = 0;
-
     BOOST_FOREACH( SHAPE_LINE_CHAIN& path, paths )
     {
         int index = 0;
@@ -528,33 +821,28 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
                 if( fe->m_p1.x == x_min )
                     border_edges.push_back( fe );
             }
-
-            if( !fe->m_connected )
-                num_unconnected++;
         }
         first = false; // first path is always the outline
     }
 
-    // keep connecting holes to the main outline, until there's no holes left...
-    while( num_unconnected > 0 )
-    {
-        int x_min = std::numeric_limits<int>::max();
-
-        FractureEdge* smallestX = NULL;
+    // About 16 edges per strip, most edges being small hole edges
+    const BOX2I bbox = paths[0].BBox();
+    FractureEdgeStrips strips( bbox.GetY(), bbox.GetBottom(),
+                               std::max( 1, std::min<int>( edges.size() / 16, 16384 ) ) );
 
-        // find the left-most hole edge and merge with the outline
-        for( FractureEdgeSet::iterator i = border_edges.begin(); i != border_edges.end(); ++i )
-        {
-            int xt = (*i)->m_p1.x;
+    for( FractureEdgeSet::iterator i = edges.begin(); i != edges.end(); ++i )
+        strips.Add( *i );
 
-            if( ( xt < x_min ) && ! (*i)->m_connected )
-            {
-                x_min = xt;
-                smallestX = *i;
-            }
-        }
+    // Connect the holes to the main outline from the left-most one to the right-most one.
+    // A hole only connects to edges on its left, which are the outline or the edges of the
+    // holes already connected, and all the edges of a hole are connected at once: its other
+    // border edges are skipped.
+    std::stable_sort( border_edges.begin(), border_edges.end(), fractureEdgeLessX );
 
-        num_unconnected -= processEdge( edges, smallestX );
+    for( FractureEdgeSet::iterator i = border_edges.begin(); i != border_edges.end(); ++i )
+    {
+        if( !(*i)->m_connected )
+            processEdge( edges, strips, *i );
     }
 
     paths.clear();
@@ -576,14 +864,24 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 }
 
 
-void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
+void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode, int aTileCount )
 {
-    Simplify( aFastMode ); // remove overlapping holes/degeneracy
+    invalidateContainsIndex();
 
-    BOOST_FOREACH( POLYGON& paths, m_polys )
-    {
-        fractureSingle( paths );
-    }
+    // remove overlapping holes/degeneracy
+    if( aTileCount > 1 )
+        BooleanSubtractTiled( *this, SHAPE_POLY_SET(), aTileCount, aFastMode );
+    else
+        Simplify( aFastMode );
+
+    // The polygons are fractured independently of each other
+    int count = m_polys.size();
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for( int i = 0; i < count; i++ )
+        fractureSingle( m_polys[i] );
 }
 
 
@@ -595,6 +893,168 @@ void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 }
 
 
+/// Interleaves the bits of two 16 bit values, to sort points along a Z-order curve
+static unsigned mortonCode( unsigned aX, unsigned aY )
+{
+    unsigned code = 0;
+
+    for( int bit = 0; bit < 16; bit++ )
+    {
+        code |= ( ( aX >> bit ) & 1 ) << ( 2 * bit );
+        code |= ( ( aY >> bit ) & 1 ) << ( 2 * bit + 1 );
+    }
+
+    return code;
+}
+
+
+void SHAPE_POLY_SET::SimplifyBatched( POLYGON_MODE aFastMode )
+{
+    invalidateContainsIndex();
+
+    // Number of polygons merged together in the first pass.  Small enough for the batches
+    // to be cheap, large enough for most overlaps to be inside a batch.
+    const int batchSize = 64;
+
+    int count = m_polys.size();
+
+    if( count <= 2 * batchSize )
+    {
+        Simplify( aFastMode );
+        return;
+    }
+
+    // Sort the polygons along a Z-order curve of their bounding box centres, so that the
+    // polygons of a batch are close to each other
+    const BOX2I bbox = BBox();
+    const double scaleX = bbox.GetWidth() > 0 ? 65535.0 / bbox.GetWidth() : 0.0;
+    const double scaleY = bbox.GetHeight() > 0 ? 65535.0 / bbox.GetHeight() : 0.0;
+
+    std::vector< std::pair<unsigned, int> > order( count );
+
+    for( int i = 0; i < count; i++ )
+    {
+        const VECTOR2I centre = m_polys[i][0].BBox().Centre() - bbox.GetOrigin();
+
+        order[i].first = mortonCode( (unsigned) ( centre.x * scaleX ),
+                                     (unsigned) ( centre.y * scaleY ) );
+        order[i].second = i;
+    }
+
+    std::sort( order.begin(), order.end() );
+
+    int batchCount = ( count + batchSize - 1 ) / batchSize;
+    std::vector<SHAPE_POLY_SET> batches( batchCount );
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for( int b = 0; b < batchCount; b++ )
+    {
+        int last = std::min( count, ( b + 1 ) * batchSize );
+
+        for( int i = b * batchSize; i < last; i++ )
+            batches[b].m_polys.push_back( m_polys[ order[i].second ] );
+
+        batches[b].Simplify( aFastMode );
+    }
+
+    // Merge the batches in a single pass: the overlaps inside the batches are already removed,
+    // so this pass has much less work to do than a Simplify() of the initial polygons.
+    // (Merging the batches pairwise was measured to be slower, each pass sweeping again over
+    // all the vertices.)
+    m_polys.clear();
+
+    for( int b = 0; b < batchCount; b++ )
+        m_polys.insert( m_polys.end(), batches[b].m_polys.begin(), batches[b].m_polys.end() );
+
+    Simplify( aFastMode );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::NewJob()
+{
+    m_jobs.push_back( std::vector<OPERATION>() );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::addOperation( OPERATION_TYPE aType, SHAPE_POLY_SET& aTarget,
+                                                  const SHAPE_POLY_SET* aOther,
+                                                  POLYGON_MODE aFastMode )
+{
+    if( m_jobs.empty() )
+        NewJob();
+
+    OPERATION op = { aType, &aTarget, aOther, aFastMode };
+
+    m_jobs.back().push_back( op );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::Add( SHAPE_POLY_SET& aTarget, const SHAPE_POLY_SET& aOther,
+                                         POLYGON_MODE aFastMode )
+{
+    addOperation( OP_ADD, aTarget, &aOther, aFastMode );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::Subtract( SHAPE_POLY_SET& aTarget,
+                                              const SHAPE_POLY_SET& aOther,
+                                              POLYGON_MODE aFastMode )
+{
+    addOperation( OP_SUBTRACT, aTarget, &aOther, aFastMode );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::Intersect( SHAPE_POLY_SET& aTarget,
+                                               const SHAPE_POLY_SET& aOther,
+                                               POLYGON_MODE aFastMode )
+{
+    addOperation( OP_INTERSECT, aTarget, &aOther, aFastMode );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::Simplify( SHAPE_POLY_SET& aTarget, POLYGON_MODE aFastMode )
+{
+    addOperation( OP_SIMPLIFY, aTarget, NULL, aFastMode );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::Fracture( SHAPE_POLY_SET& aTarget, POLYGON_MODE aFastMode )
+{
+    addOperation( OP_FRACTURE, aTarget, NULL, aFastMode );
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::runOperation( const OPERATION& aOp )
+{
+    switch( aOp.m_type )
+    {
+    case OP_ADD:        aOp.m_target->BooleanAdd( *aOp.m_other, aOp.m_mode );          break;
+    case OP_SUBTRACT:   aOp.m_target->BooleanSubtract( *aOp.m_other, aOp.m_mode );     break;
+    case OP_INTERSECT:  aOp.m_target->BooleanIntersection( *aOp.m_other, aOp.m_mode ); break;
+    case OP_SIMPLIFY:   aOp.m_target->Simplify( aOp.m_mode );                          break;
+    case OP_FRACTURE:   aOp.m_target->Fracture( aOp.m_mode );                          break;
+    }
+}
+
+
+void SHAPE_POLY_SET::BOOLEAN_BATCH::Run()
+{
+    // Each job builds its own Clipper objects, the jobs share no data
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for( int i = 0; i < (int) m_jobs.size(); i++ )
+    {
+        for( unsigned j = 0; j < m_jobs[i].size(); j++ )
+            runOperation( m_jobs[i][j] );
+    }
+
+    m_jobs.clear();
+}
+
+
 const std::string SHAPE_POLY_SET::Format() const
 {
     std::stringstream ss;
@@ -619,6 +1079,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    invalidateContainsIndex();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -693,18 +1155,24 @@ const BOX2I SHAPE_POLY_SET::BBox( int aClearance ) const
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    invalidateContainsIndex();
+
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    invalidateContainsIndex();
+
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    invalidateContainsIndex();
+
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
@@ -715,6 +1183,107 @@ void SHAPE_POLY_SET::Append( const VECTOR2I& aP, int aOutline, int aHole )
 }
 
 
+/**
+ * Struct CONTAINS_INDEX
+ * The bounding boxes of the outlines of a set, and for the outlines with many vertices,
+ * their edges bucketed by the rows of the bounding box they cross.  An edge is in all
+ * the rows its y range overlaps, so the edges at a given height are in its row.
+ */
+struct SHAPE_POLY_SET::CONTAINS_INDEX
+{
+    struct OUTLINE
+    {
+        BOX2I               m_bbox;
+        double              m_rowScale;     // rows per unit of y, 0 if not bucketed
+        std::vector<int>    m_rowStart;     // first edge of each row in m_edges, then the end
+        std::vector<int>    m_edges;        // edge i goes from vertex i to vertex i + 1
+
+        int Row( int aY ) const
+        {
+            int row = (int) ( ( (double) aY - m_bbox.GetY() ) * m_rowScale );
+
+            return std::max( 0, std::min( row, (int) m_rowStart.size() - 2 ) );
+        }
+    };
+
+    std::vector<OUTLINE> m_outlines;
+};
+
+
+// Below this count of vertices, the edges of an outline are just all tested
+static const int CONTAINS_INDEX_MIN_VERTICES = 64;
+
+// Guards the lazy builds of the index from concurrent calls to Contains()
+static boost::mutex s_containsIndexLock;
+
+
+boost::shared_ptr<const SHAPE_POLY_SET::CONTAINS_INDEX> SHAPE_POLY_SET::containsIndex() const
+{
+    boost::mutex::scoped_lock lock( s_containsIndexLock );
+
+    if( m_containsIndex )
+        return m_containsIndex;
+
+    CONTAINS_INDEX* index = new CONTAINS_INDEX;
+
+    index->m_outlines.resize( m_polys.size() );
+
+    for( unsigned i = 0; i < m_polys.size(); i++ )
+    {
+        if( m_polys[i].empty() )
+            continue;
+
+        const SHAPE_LINE_CHAIN& path = m_polys[i][0];
+        CONTAINS_INDEX::OUTLINE& outline = index->m_outlines[i];
+        int cnt = path.PointCount();
+
+        outline.m_bbox = path.BBox();
+        outline.m_rowScale = 0.0;
+
+        if( cnt < CONTAINS_INDEX_MIN_VERTICES || outline.m_bbox.GetHeight() <= 0 )
+            continue;
+
+        // About 4 edges by row for the outlines crossed twice by most horizontal lines
+        int rows = std::min( cnt / 4, 65536 );
+
+        outline.m_rowScale = (double) rows / ( (double) outline.m_bbox.GetHeight() + 1.0 );
+        outline.m_rowStart.assign( rows + 1, 0 );
+
+        // count the edges of each row, then store them
+        for( int j = 0; j < cnt; j++ )
+        {
+            int y0 = path.CPoint( j ).y;
+            int y1 = path.CPoint( j + 1 < cnt ? j + 1 : 0 ).y;
+            int last = outline.Row( std::max( y0, y1 ) );
+
+            for( int row = outline.Row( std::min( y0, y1 ) ); row <= last; row++ )
+                outline.m_rowStart[row + 1]++;
+        }
+
+        for( int row = 0; row < rows; row++ )
+            outline.m_rowStart[row + 1] += outline.m_rowStart[row];
+
+        std::vector<int> fill( outline.m_rowStart.begin(), outline.m_rowStart.end() - 1 );
+
+        outline.m_edges.resize( outline.m_rowStart[rows] );
+
+        for( int j = 0; j < cnt; j++ )
+        {
+            int y0 = path.CPoint( j ).y;
+            int y1 = path.CPoint( j + 1 < cnt ? j + 1 : 0 ).y;
+            int last = outline.Row( std::max( y0, y1 ) );
+
+            for( int row = outline.Row( std::min( y0, y1 ) ); row <= last; row++ )
+                outline.m_edges[fill[row]++] = j;
+        }
+    }
+
+    m_containsIndex.reset( index );
+
+    return m_containsIndex;
+}
+
+
 bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex ) const
 {
     // fixme: support holes!
@@ -722,15 +1291,17 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex ) const
     if( m_polys.size() == 0 ) // empty set?
         return false;
 
+    boost::shared_ptr<const CONTAINS_INDEX> index = containsIndex();
+
     if( aSubpolyIndex >= 0 )
-        return pointInPolygon( aP, m_polys[aSubpolyIndex][0] );
+        return pointInPolygon( aP, m_polys[aSubpolyIndex][0], *index, aSubpolyIndex );
 
-    BOOST_FOREACH ( const POLYGON& polys, m_polys )
+    for( unsigned i = 0; i < m_polys.size(); i++ )
     {
-        if( polys.size() == 0 )
+        if( m_polys[i].size() == 0 )
             continue;
 
-        if( pointInPolygon( aP, polys[0] ) )
+        if( pointInPolygon( aP, m_polys[i][0], *index, i ) )
             return true;
     }
 
@@ -738,64 +1309,101 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex ) const
 }
 
 
-bool SHAPE_POLY_SET::pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN& aPath ) const
+/**
+ * Function edgeCrossing
+ * tests the edge aStart aEnd of a polygon against the horizontal ray going from aP to
+ * the right.
+ * @return 1 if the ray crosses the edge, 0 if not, and -1 if aP is on the edge.
+ */
+static int edgeCrossing( const VECTOR2I& aP, const VECTOR2I& ip, const VECTOR2I& ipNext )
 {
+    if( ipNext.y == aP.y )
+    {
+        if( ( ipNext.x == aP.x ) || ( ip.y == aP.y &&
+            ( ( ipNext.x > aP.x ) == ( ip.x < aP.x ) ) ) )
+            return -1;
+    }
+
+    if( ( ip.y < aP.y ) != ( ipNext.y < aP.y ) )
+    {
+        if( ip.x >= aP.x )
+        {
+            if( ipNext.x > aP.x )
+                return 1;
+
+            int64_t d = (int64_t)( ip.x - aP.x ) * (int64_t)( ipNext.y - aP.y ) -
+                        (int64_t)( ipNext.x - aP.x ) * (int64_t)( ip.y - aP.y );
+
+            if( !d )
+                return -1;
+
+            if( ( d > 0 ) == ( ipNext.y > ip.y ) )
+                return 1;
+        }
+        else
+        {
+            if( ipNext.x > aP.x )
+            {
+                int64_t d = (int64_t)( ip.x - aP.x ) * (int64_t)( ipNext.y - aP.y ) -
+                            (int64_t)( ipNext.x - aP.x ) * (int64_t)( ip.y - aP.y );
+
+                if( !d )
+                    return -1;
+
+                if( ( d > 0 ) == ( ipNext.y > ip.y ) )
+                    return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+bool SHAPE_POLY_SET::pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN& aPath,
+                                     const CONTAINS_INDEX& aIndex, int aOutline ) const
+{
+    const CONTAINS_INDEX::OUTLINE& outline = aIndex.m_outlines[aOutline];
     int result = 0;
     int cnt = aPath.PointCount();
 
-    if ( !aPath.BBox().Contains( aP ) ) // test with bounding box first
+    if ( !outline.m_bbox.Contains( aP ) ) // test with bounding box first
         return false;
 
     if( cnt < 3 )
         return false;
 
-    VECTOR2I ip = aPath.CPoint( 0 );
-
-    for( int i = 1; i <= cnt; ++i )
+    if( outline.m_rowScale > 0.0 )
     {
-        VECTOR2I ipNext = ( i == cnt ? aPath.CPoint( 0 ) : aPath.CPoint( i ) );
+        // only the edges of the row of aP can be at its height
+        int row = outline.Row( aP.y );
 
-        if( ipNext.y == aP.y )
+        for( int k = outline.m_rowStart[row]; k < outline.m_rowStart[row + 1]; ++k )
         {
-            if( ( ipNext.x == aP.x ) || ( ip.y == aP.y &&
-                ( ( ipNext.x > aP.x ) == ( ip.x < aP.x ) ) ) )
+            int i = outline.m_edges[k];
+            int crossing = edgeCrossing( aP, aPath.CPoint( i ),
+                                         aPath.CPoint( i + 1 < cnt ? i + 1 : 0 ) );
+
+            if( crossing < 0 )
                 return true;
-        }
 
-        if( ( ip.y < aP.y ) != ( ipNext.y < aP.y ) )
-        {
-            if( ip.x >= aP.x )
-            {
-                if( ipNext.x > aP.x )
-                    result = 1 - result;
-                else
-                {
-                    int64_t d = (int64_t)( ip.x - aP.x ) * (int64_t)( ipNext.y - aP.y ) -
-                                (int64_t)( ipNext.x - aP.x ) * (int64_t)( ip.y - aP.y );
+            result ^= crossing;
+        }
 
-                    if( !d )
-                        return true;
+        return result ? true : false;
+    }
 
-                    if( ( d > 0 ) == ( ipNext.y > ip.y ) )
-                        result = 1 - result;
-                }
-            }
-            else
-            {
-                if( ipNext.x > aP.x )
-                {
-                    int64_t d = (int64_t)( ip.x - aP.x ) * (int64_t)( ipNext.y - aP.y ) -
-                                (int64_t)( ipNext.x - aP.x ) * (int64_t)( ip.y - aP.y );
+    VECTOR2I ip = aPath.CPoint( 0 );
 
-                if( !d )
-                    return true;
+    for( int i = 1; i <= cnt; ++i )
+    {
+        VECTOR2I ipNext = ( i == cnt ? aPath.CPoint( 0 ) : aPath.CPoint( i ) );
+        int crossing = edgeCrossing( aP, ip, ipNext );
 
-                if( ( d > 0 ) == ( ipNext.y > ip.y ) )
-                    result = 1 - result;
-                }
-            }
-        }
+        if( crossing < 0 )
+            return true;
 
+        result ^= crossing;
         ip = ipNext;
     }
 
@@ -805,6 +1413,8 @@ bool SHAPE_POLY_SET::pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN&
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    invalidateContainsIndex();
+
     BOOST_FOREACH( POLYGON &poly, m_polys )
     {
         BOOST_FOREACH( SHAPE_LINE_CHAIN &path, poly )
@@ -829,3 +1439,408 @@ int SHAPE_POLY_SET::TotalVertices() const
 
     return c;
 }
+
+
+namespace
+{
+
+/**
+ * Class EAR_CLIPPER
+ * triangulates a polygon without holes by ear clipping.  The vertices are kept in a
+ * circular list, and the ones of the large polygons in a second list sorted along a
+ * Z-order curve, so that the search of the vertices inside an ear is limited to the
+ * bounding box of the ear.  The slits of the fractured polygons are duplicated edges,
+ * the ears are then only checked against the reflex vertices.
+ */
+class EAR_CLIPPER
+{
+public:
+    EAR_CLIPPER( SHAPE_POLY_SET::TRIANGULATED_POLYGON& aResult ) :
+        m_result( aResult ),
+        m_hashed( false ),
+        m_minX( 0 ),
+        m_minY( 0 ),
+        m_scale( 0.0 )
+    {
+    }
+
+    bool Triangulate( const SHAPE_LINE_CHAIN& aOutline )
+    {
+        m_result.Clear();
+
+        VERTEX* first = createList( aOutline );
+
+        if( !first )
+            return true;        // nothing to fill
+
+        if( m_hashed )
+            sortByZ( first );
+
+        return clip( first, 0 );
+    }
+
+private:
+    struct VERTEX
+    {
+        int         i;          // index of the vertex in the result
+        long long   x, y;
+        unsigned    z;          // Z-order of the vertex in the bounding box
+        VERTEX*     prev;
+        VERTEX*     next;
+        VERTEX*     prevZ;
+        VERTEX*     nextZ;
+    };
+
+    // above this count of vertices, the vertices inside an ear are found by their Z-order
+    static const int HASHED_THRESHOLD = 80;
+
+    SHAPE_POLY_SET::TRIANGULATED_POLYGON& m_result;
+    std::vector<VERTEX> m_vertices;
+    bool        m_hashed;
+    long long   m_minX, m_minY;
+    double      m_scale;
+
+    ///> twice the signed area of the triangle abc, positive when abc is counterclockwise
+    static long long area( const VERTEX* a, const VERTEX* b, const VERTEX* c )
+    {
+        return ( b->x - a->x ) * ( c->y - a->y ) - ( b->y - a->y ) * ( c->x - a->x );
+    }
+
+    static bool equals( const VERTEX* a, const VERTEX* b )
+    {
+        return a->x == b->x && a->y == b->y;
+    }
+
+    ///> true if p is inside the counterclockwise triangle abc, or on its edges
+    static bool inTriangle( const VERTEX* a, const VERTEX* b, const VERTEX* c, const VERTEX* p )
+    {
+        return area( a, b, p ) >= 0 && area( b, c, p ) >= 0 && area( c, a, p ) >= 0;
+    }
+
+    unsigned zOrder( long long x, long long y ) const
+    {
+        return mortonCode( (unsigned) ( ( x - m_minX ) * m_scale ),
+                           (unsigned) ( ( y - m_minY ) * m_scale ) );
+    }
+
+    VERTEX* createList( const SHAPE_LINE_CHAIN& aOutline )
+    {
+        int count = aOutline.PointCount();
+
+        if( count < 3 )
+            return NULL;
+
+        // The vertices are linked counterclockwise, whatever the orientation of the outline
+        long long signedArea = 0;
+
+        for( int i = 0, j = count - 1; i < count; j = i++ )
+        {
+            const VECTOR2I& a = aOutline.CPoint( j );
+            const VECTOR2I& b = aOutline.CPoint( i );
+            signedArea += (long long) a.x * b.y - (long long) b.x * a.y;
+        }
+
+        m_vertices.resize( count );
+        m_hashed = count > HASHED_THRESHOLD;
+
+        BOX2I bbox = aOutline.BBox();
+        long long size = std::max( bbox.GetWidth(), bbox.GetHeight() );
+
+        m_minX = bbox.GetX();
+        m_minY = bbox.GetY();
+        m_scale = size > 0 ? 65535.0 / size : 0.0;
+
+        for( int i = 0; i < count; i++ )
+        {
+            const VECTOR2I& p = aOutline.CPoint( signedArea < 0 ? count - 1 - i : i );
+            VERTEX& v = m_vertices[i];
+
+            v.i = m_result.Vertices().size();
+            v.x = p.x;
+            v.y = p.y;
+            v.z = m_hashed ? zOrder( v.x, v.y ) : 0;
+            v.prev = &m_vertices[( i + count - 1 ) % count];
+            v.next = &m_vertices[( i + 1 ) % count];
+            v.prevZ = v.nextZ = NULL;
+
+            m_result.AddVertex( p );
+        }
+
+        return removeNullTriangles( &m_vertices[0] );
+    }
+
+    void sortByZ( VERTEX* aFirst )
+    {
+        std::vector<VERTEX*> sorted;
+        VERTEX* p = aFirst;
+
+        do
+        {
+            sorted.push_back( p );
+            p = p->next;
+        } while( p != aFirst );
+
+        std::sort( sorted.begin(), sorted.end(), compareZ );
+
+        for( unsigned i = 0; i < sorted.size(); i++ )
+        {
+            sorted[i]->prevZ = i > 0 ? sorted[i - 1] : NULL;
+            sorted[i]->nextZ = i + 1 < sorted.size() ? sorted[i + 1] : NULL;
+        }
+    }
+
+    static bool compareZ( const VERTEX* a, const VERTEX* b )
+    {
+        return a->z < b->z;
+    }
+
+    static void remove( VERTEX* p )
+    {
+        p->next->prev = p->prev;
+        p->prev->next = p->next;
+
+        if( p->prevZ )
+            p->prevZ->nextZ = p->nextZ;
+
+        if( p->nextZ )
+            p->nextZ->prevZ = p->prevZ;
+    }
+
+    /**
+     * Function removeNullTriangles
+     * removes the duplicated vertices and the vertices aligned with their neighbours,
+     * which would make null triangles
+     * @return a vertex of the list, or NULL if less than 3 vertices are left
+     */
+    static VERTEX* removeNullTriangles( VERTEX* aStart )
+    {
+        VERTEX* p = aStart;
+        VERTEX* end = aStart;
+
+        do
+        {
+            if( p->next == p->prev )
+                return NULL;
+
+            if( equals( p, p->next ) || area( p->prev, p, p->next ) == 0 )
+            {
+                remove( p );
+                p = end = p->prev;
+            }
+            else
+            {
+                p = p->next;
+            }
+        } while( p != end );
+
+        return p->next->next == p ? NULL : p;
+    }
+
+    bool isEar( const VERTEX* aEar ) const
+    {
+        const VERTEX* a = aEar->prev;
+        const VERTEX* c = aEar->next;
+
+        if( area( a, aEar, c ) <= 0 )
+            return false;       // reflex
+
+        if( m_hashed )
+            return isEarHashed( aEar );
+
+        // no reflex vertex in the ear
+        for( const VERTEX* p = c->next; p != a; p = p->next )
+        {
+            if( inTriangle( a, aEar, c, p ) && area( p->prev, p, p->next ) <= 0 )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool isEarHashed( const VERTEX* aEar ) const
+    {
+        const VERTEX* a = aEar->prev;
+        const VERTEX* c = aEar->next;
+
+        long long minX = std::min( a->x, std::min( aEar->x, c->x ) );
+        long long minY = std::min( a->y, std::min( aEar->y, c->y ) );
+        long long maxX = std::max( a->x, std::max( aEar->x, c->x ) );
+        long long maxY = std::max( a->y, std::max( aEar->y, c->y ) );
+
+        // the vertices in the bounding box of the ear have a Z-order between the ones of
+        // its corners
+        unsigned minZ = zOrder( minX, minY );
+        unsigned maxZ = zOrder( maxX, maxY );
+
+        for( const VERTEX* p = aEar->nextZ; p && p->z <= maxZ; p = p->nextZ )
+        {
+            if( p != a && p != c && inTriangle( a, aEar, c, p )
+                && area( p->prev, p, p->next ) <= 0 )
+                return false;
+        }
+
+        for( const VERTEX* p = aEar->prevZ; p && p->z >= minZ; p = p->prevZ )
+        {
+            if( p != a && p != c && inTriangle( a, aEar, c, p )
+                && area( p->prev, p, p->next ) <= 0 )
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Function cureLocalIntersections
+     * clips the small self intersections of the outline: when the edges before and after
+     * two vertices cross, the two vertices are replaced by a triangle.
+     */
+    VERTEX* cureLocalIntersections( VERTEX* aStart )
+    {
+        VERTEX* p = aStart;
+
+        do
+        {
+            VERTEX* a = p->prev;
+            VERTEX* b = p->next->next;
+
+            if( !equals( a, b ) && intersects( a, p, p->next, b )
+                && area( a, p, b ) > 0 && area( p, b, a ) > 0 )
+            {
+                m_result.AddTriangle( a->i, p->i, b->i );
+
+                remove( p );
+                remove( p->next );
+
+                p = aStart = b;
+            }
+
+            p = p->next;
+        } while( p != aStart );
+
+        return p;
+    }
+
+    static int sign( long long aValue )
+    {
+        return aValue > 0 ? 1 : ( aValue < 0 ? -1 : 0 );
+    }
+
+    ///> true if the segments p1q1 and p2q2 cross each other
+    static bool intersects( const VERTEX* p1, const VERTEX* q1, const VERTEX* p2, const VERTEX* q2 )
+    {
+        return sign( area( p1, q1, p2 ) ) != sign( area( p1, q1, q2 ) )
+               && sign( area( p2, q2, p1 ) ) != sign( area( p2, q2, q1 ) );
+    }
+
+    /**
+     * Function clip
+     * clips the ears of the outline until a triangle is left.  When no ear is found,
+     * the null triangles are removed, then the self intersections.
+     * @param aPass is the number of the attempts failed since the last ear
+     * @return false if the outline could not be triangulated
+     */
+    bool clip( VERTEX* aEar, int aPass )
+    {
+        VERTEX* stop = aEar;
+
+        while( aEar->prev != aEar->next )
+        {
+            VERTEX* prev = aEar->prev;
+            VERTEX* next = aEar->next;
+
+            if( isEar( aEar ) )
+            {
+                m_result.AddTriangle( prev->i, aEar->i, next->i );
+                remove( aEar );
+
+                // skipping the next vertex leads to less sliver triangles
+                aEar = next->next;
+                stop = next->next;
+                aPass = 0;
+                continue;
+            }
+
+            aEar = next;
+
+            if( aEar != stop )
+                continue;
+
+            // a whole turn without any ear
+            if( aPass > 1 )
+                return false;
+
+            aEar = removeNullTriangles( aEar );
+
+            if( aEar && aPass == 1 )
+                aEar = removeNullTriangles( cureLocalIntersections( aEar ) );
+
+            if( !aEar )
+                return true;
+
+            stop = aEar;
+            aPass++;
+        }
+
+        return true;
+    }
+};
+
+}
+
+
+size_t SHAPE_POLY_SET::checksum() const
+{
+    size_t hash = m_polys.size();
+
+    for( unsigned i = 0; i < m_polys.size(); i++ )
+    {
+        const SHAPE_LINE_CHAIN& outline = m_polys[i][0];
+
+        boost::hash_combine( hash, outline.PointCount() );
+
+        for( int j = 0; j < outline.PointCount(); j++ )
+        {
+            boost::hash_combine( hash, outline.CPoint( j ).x );
+            boost::hash_combine( hash, outline.CPoint( j ).y );
+        }
+    }
+
+    return hash;
+}
+
+
+void SHAPE_POLY_SET::CacheTriangulation()
+{
+    size_t hash = checksum();
+
+    if( m_triangulationValid && hash == m_triangulationHash
+            && m_triangulatedPolys.size() == m_polys.size() )
+        return;
+
+    int count = m_polys.size();
+    int failed = 0;
+
+    m_triangulatedPolys.clear();
+    m_triangulatedPolys.resize( count );
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1) reduction(+:failed)
+#endif
+    for( int i = 0; i < count; i++ )
+    {
+        EAR_CLIPPER clipper( m_triangulatedPolys[i] );
+
+        if( !clipper.Triangulate( m_polys[i][0] ) )
+            failed++;
+    }
+
+    m_triangulationHash = hash;
+    m_triangulationValid = ( failed == 0 );
+}
+
+
+bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
+{
+    return m_triangulationValid && m_triangulatedPolys.size() == m_polys.size()
+           && checksum() == m_triangulationHash;
+}
@@ -77,6 +77,95 @@ static EDA_COLOR_T   s_DC_lastbrushcolor = UNSPECIFIED_COLOR;
 static bool  s_DC_lastbrushfill  = false;
 static wxDC* s_DC_lastDC = NULL;
 
+/* The line batch of GRBeginLineBatch():
+ * the lines drawn on s_batchDC with the same pen are kept, and drawn at once when the pen
+ * changes or before any other shape: the connected lines as one polyline.
+ * The pen of the batch is set once, as long as it does not change.
+ */
+static wxDC*                s_batchDC = NULL;
+static std::vector<wxPoint> s_batchPoints;      // the points of the polylines of the batch
+static std::vector<int>     s_batchCounts;      // the point count of each polyline
+static bool                 s_batchPenSet = false;
+static EDA_COLOR_T          s_batchPenColor = UNSPECIFIED_COLOR;
+static int                  s_batchPenWidth = 0;
+static wxPenStyle           s_batchPenStyle = wxPENSTYLE_SOLID;
+
+
+/* Draw the pending lines of the batch of aDC, before the pen changes or before drawing
+ * any other shape on aDC.
+ */
+static void flushLineBatch( wxDC* aDC )
+{
+    if( aDC != s_batchDC || s_batchCounts.empty() )
+        return;
+
+#if defined( __WXMAC__ ) && defined( USE_WX_GRAPHICS_CONTEXT )
+    wxGCDC *gcdc = wxDynamicCast( aDC, wxGCDC );
+    if( gcdc )
+    {
+        wxGraphicsContext *gc = gcdc->GetGraphicsContext();
+
+        // a single path for all the polylines
+        wxGraphicsPath path = gc->CreatePath();
+        int first = 0;
+
+        for( unsigned ii = 0; ii < s_batchCounts.size(); ii++ )
+        {
+            path.MoveToPoint( s_batchPoints[first].x, s_batchPoints[first].y );
+
+            for( int jj = 1; jj < s_batchCounts[ii]; jj++ )
+                path.AddLineToPoint( s_batchPoints[first + jj].x, s_batchPoints[first + jj].y );
+
+            first += s_batchCounts[ii];
+        }
+
+        gc->StrokePath( path );
+    }
+    else
+#endif
+    {
+        int first = 0;
+
+        for( unsigned ii = 0; ii < s_batchCounts.size(); ii++ )
+        {
+            if( s_batchCounts[ii] == 2 )
+                aDC->DrawLine( s_batchPoints[first], s_batchPoints[first + 1] );
+            else
+                aDC->DrawLines( s_batchCounts[ii], &s_batchPoints[first] );
+
+            first += s_batchCounts[ii];
+        }
+    }
+
+    s_batchPoints.clear();
+    s_batchCounts.clear();
+}
+
+
+/* Draw a clipped line, or add it to the line batch of DC.  A line starting at the end of
+ * the previous one continues its polyline.
+ */
+static void drawLine( wxDC* DC, int x1, int y1, int x2, int y2 )
+{
+    if( DC != s_batchDC )
+    {
+        DC->DrawLine( x1, y1, x2, y2 );
+        return;
+    }
+
+    if( !s_batchCounts.empty() && s_batchPoints.back() == wxPoint( x1, y1 ) )
+    {
+        s_batchCounts.back()++;
+    }
+    else
+    {
+        s_batchPoints.push_back( wxPoint( x1, y1 ) );
+        s_batchCounts.push_back( 2 );
+    }
+
+    s_batchPoints.push_back( wxPoint( x2, y2 ) );
+}
+
 /***
  * Utility for the line clipping code, returns the boundary code of
  * a point. Bit allocation is arbitrary
@@ -186,7 +275,7 @@ static void WinClipAndDrawLine( EDA_RECT* ClipBox, wxDC* DC, int x1, int y1, int
             return;
     }
 
-    DC->DrawLine( x1, y1, x2, y2 );
+    drawLine( DC, x1, y1, x2, y2 );
 }
 
 
@@ -195,10 +284,44 @@ static void WinClipAndDrawLine( EDA_RECT* ClipBox, wxDC* DC, int x1, int y1, int
  */
 void GRResetPenAndBrush( wxDC* DC )
 {
+    flushLineBatch( DC );
+
     GRSetBrush( DC, BLACK );  // Force no fill
     s_DC_lastbrushcolor = UNSPECIFIED_COLOR;
     s_DC_lastcolor =  UNSPECIFIED_COLOR;
     s_DC_lastDC    = NULL;
+    s_batchPenSet  = false;
+}
+
+
+void GRBeginLineBatch( wxDC* aDC )
+{
+    GREndLineBatch();
+
+    s_batchDC = aDC;
+    s_batchPenSet = false;
+}
+
+
+void GREndLineBatch()
+{
+    if( !s_batchDC )
+        return;
+
+    flushLineBatch( s_batchDC );
+
+    s_batchDC = NULL;
+    s_batchPenSet = false;
+}
+
+
+void GRFlushLineBatch( wxDC* aDC )
+{
+    flushLineBatch( aDC );
+
+    // the pen can be changed by the caller
+    if( aDC == s_batchDC )
+        s_batchPenSet = false;
 }
 
 
@@ -216,6 +339,21 @@ void GRSetColorPen( wxDC* DC, EDA_COLOR_T Color, int width, wxPenStyle style )
     if( s_ForceBlackPen )
         Color = BLACK;
 
+    if( DC == s_batchDC )
+    {
+        // The pen of the batch is left as is while it does not change
+        if( s_batchPenSet && Color == s_batchPenColor && width == s_batchPenWidth
+                && style == s_batchPenStyle )
+            return;
+
+        flushLineBatch( DC );
+
+        s_batchPenSet   = true;
+        s_batchPenColor = Color;
+        s_batchPenWidth = width;
+        s_batchPenStyle = style;
+    }
+
     wxColour wx_color = MakeColour( Color );
     const wxPen& curr_pen = DC->GetPen();
 
@@ -290,6 +428,8 @@ bool GetGRForceBlackPenState( void )
 /*************************************/
 void GRSetDrawMode( wxDC* DC, GR_DRAWMODE draw_mode )
 {
+    wxRasterOperationMode previousMode = DC->GetLogicalFunction();
+
     if( draw_mode & GR_OR )
 #if defined(__WXMAC__) && (wxMAC_USE_CORE_GRAPHICS || wxCHECK_VERSION( 2, 9, 0 ) )
 
@@ -334,6 +474,16 @@ void GRSetDrawMode( wxDC* DC, GR_DRAWMODE draw_mode )
 #ifdef USE_WX_OVERLAY
     DC->SetLogicalFunction( wxCOPY );
 #endif
+
+    // The pending lines of the batch are drawn in the previous mode
+    if( DC == s_batchDC && !s_batchCounts.empty() && DC->GetLogicalFunction() != previousMode )
+    {
+        wxRasterOperationMode mode = DC->GetLogicalFunction();
+
+        DC->SetLogicalFunction( previousMode );
+        flushLineBatch( DC );
+        DC->SetLogicalFunction( mode );
+    }
 }
 
 
@@ -343,6 +493,7 @@ void GRPutPixel( EDA_RECT* ClipBox, wxDC* DC, int x, int y, EDA_COLOR_T Color )
         return;
 
     GRSetColorPen( DC, Color );
+    flushLineBatch( DC );
     DC->DrawPoint( x, y );
 }
 
@@ -438,6 +589,7 @@ void GRLineArray( EDA_RECT* aClipBox, wxDC* aDC, std::vector<wxPoint>& aLines,
     if( gcdc )
     {
         wxGraphicsContext *gc = gcdc->GetGraphicsContext();
+        flushLineBatch( aDC );
 
         // create path
         wxGraphicsPath path = gc->CreatePath();
@@ -466,7 +618,7 @@ void GRLineArray( EDA_RECT* aClipBox, wxDC* aDC, std::vector<wxPoint>& aLines,
             int x2 = aLines[i+1].x;
             int y2 = aLines[i+1].y;
             if( ( aClipBox == NULL ) || !clipLine( aClipBox, x1, y1, x2, y2 ) )
-                aDC->DrawLine( x1, y1, x2, y2 );
+                drawLine( aDC, x1, y1, x2, y2 );
         }
     }
     GRMoveTo( aLines[aLines.size() - 1].x, aLines[aLines.size() - 1].y );
@@ -495,12 +647,13 @@ void GRCSegm( EDA_RECT* ClipBox, wxDC* DC, int x1, int y1, int x2, int y2,
     if( width <= 2 )   /*  single line or 2 pixels */
     {
         GRSetColorPen( DC, Color, width );
-        DC->DrawLine( x1, y1, x2, y2 );
+        drawLine( DC, x1, y1, x2, y2 );
         return;
     }
 
     GRSetBrush( DC, Color, NOT_FILLED );
     GRSetColorPen( DC, Color, aPenSize );
+    flushLineBatch( DC );
 
     int radius = (width + 1) >> 1;
     int dx = x2 - x1;
@@ -662,6 +815,7 @@ static void GRSPoly( EDA_RECT* ClipBox, wxDC* DC, int n, wxPoint Points[],
         if( gcdc )
         {
             wxGraphicsContext *gc = gcdc->GetGraphicsContext();
+            flushLineBatch( DC );
 
             // set pen
             GRSetColorPen( DC, Color, width );
@@ -719,6 +873,7 @@ static void GRSClosedPoly( EDA_RECT* aClipBox, wxDC* aDC,
         if( gcdc )
         {
             wxGraphicsContext *gc = gcdc->GetGraphicsContext();
+            flushLineBatch( aDC );
 
             // set pen
             GRSetColorPen( aDC, aColor, aWidth );
@@ -812,6 +967,7 @@ void GRCircle( EDA_RECT* ClipBox, wxDC* DC, int xc, int yc, int r, int width, ED
 
     GRSetBrush( DC, Color, NOT_FILLED );
     GRSetColorPen( DC, Color, width );
+    flushLineBatch( DC );
     DC->DrawEllipse( xc - r, yc - r, r + r, r + r );
 }
 
@@ -855,6 +1011,7 @@ void GRFilledCircle( EDA_RECT* ClipBox, wxDC* DC, int x, int y, int r,
 
     GRSetBrush( DC, BgColor, FILLED );
     GRSetColorPen( DC, Color, width );
+    flushLineBatch( DC );
     DC->DrawEllipse( x - r, y - r, r + r, r + r );
 }
 
@@ -902,6 +1059,7 @@ void GRArc1( EDA_RECT* ClipBox, wxDC* DC, int x1, int y1, int x2, int y2,
 
     GRSetBrush( DC, Color );
     GRSetColorPen( DC, Color, width );
+    flushLineBatch( DC );
     DC->DrawArc( x1, y1, x2, y2, xc, yc );
 }
 
@@ -962,6 +1120,7 @@ void GRFilledArc( EDA_RECT* ClipBox,
 
     GRSetBrush( DC, BgColor, FILLED );
     GRSetColorPen( DC, Color, width );
+    flushLineBatch( DC );
     DC->DrawArc( x + x1, y - y1, x + x2, y - y2, x, y );
 }
 
@@ -1014,6 +1173,7 @@ void GRArc( EDA_RECT* ClipBox, wxDC* DC, int xc, int yc, double StAngle,
 
     GRSetBrush( DC, Color, NOT_FILLED );
     GRSetColorPen( DC, Color );
+    flushLineBatch( DC );
     DC->DrawArc( xc + x1, yc - y1, xc + x2, yc - y2, xc, yc );
 }
 
@@ -1065,6 +1225,7 @@ void GRArc( EDA_RECT* ClipBox,
 
     GRSetBrush( DC, Color );
     GRSetColorPen( DC, Color, width );
+    flushLineBatch( DC );
     DC->DrawArc( x + x1, y - y1, x + x2, y - y2, x, y );
 }
 
@@ -1187,6 +1348,8 @@ void GRSFilledRect( EDA_RECT* aClipBox, wxDC* aDC, int x1, int y1, int x2, int y
 
 void ClipAndDrawPoly( EDA_RECT* aClipBox, wxDC* aDC, wxPoint aPoints[], int n )
 {
+    flushLineBatch( aDC );
+
     if( aClipBox == NULL )
     {
         aDC->DrawPolygon( n, aPoints );
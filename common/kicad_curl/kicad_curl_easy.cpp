@@ -24,7 +24,9 @@
 
 #include <kicad_curl/kicad_curl_easy.h>
 
+#include <cctype>
 #include <cstddef>
+#include <cstring>
 #include <exception>
 #include <stdarg.h>
 #include <sstream>
@@ -43,6 +45,22 @@ static size_t write_callback( void* contents, size_t size, size_t nmemb, void* u
 }
 
 
+static size_t header_callback( char* contents, size_t size, size_t nmemb, void* userp )
+{
+    size_t realsize = size * nmemb;
+
+    std::string* p = (std::string*) userp;
+
+    // a new status line starts the headers of a new response, after a redirect
+    if( realsize >= 5 && !strncmp( contents, "HTTP/", 5 ) )
+        p->clear();
+
+    p->append( contents, realsize );
+
+    return realsize;
+}
+
+
 KICAD_CURL_EASY::KICAD_CURL_EASY() :
     m_headers( NULL )
 {
@@ -61,6 +79,8 @@ KICAD_CURL_EASY::KICAD_CURL_EASY() :
 
     curl_easy_setopt( m_CURL, CURLOPT_WRITEFUNCTION, write_callback );
     curl_easy_setopt( m_CURL, CURLOPT_WRITEDATA, (void*) &m_buffer );
+    curl_easy_setopt( m_CURL, CURLOPT_HEADERFUNCTION, header_callback );
+    curl_easy_setopt( m_CURL, CURLOPT_HEADERDATA, (void*) &m_responseHeaders );
 }
 
 
@@ -82,6 +102,7 @@ void KICAD_CURL_EASY::Perform()
 
     // bonus: retain worst case memory allocation, should re-use occur
     m_buffer.clear();
+    m_responseHeaders.clear();
 
     CURLcode res = curl_easy_perform( m_CURL );
 
@@ -92,3 +113,39 @@ void KICAD_CURL_EASY::Perform()
         THROW_IO_ERROR( msg );
     }
 }
+
+
+std::string KICAD_CURL_EASY::GetResponseHeader( const std::string& aName ) const
+{
+    size_t start = 0;
+
+    while( start < m_responseHeaders.size() )
+    {
+        size_t end = m_responseHeaders.find( '\n', start );
+
+        if( end == std::string::npos )
+            end = m_responseHeaders.size();
+
+        size_t colon = start + aName.size();
+        bool   match = colon < end && m_responseHeaders[colon] == ':';
+
+        for( size_t i = 0; match && i < aName.size(); ++i )
+            match = tolower( (unsigned char) m_responseHeaders[start + i] )
+                    == tolower( (unsigned char) aName[i] );
+
+        if( match )
+        {
+            size_t first = m_responseHeaders.find_first_not_of( " \t", colon + 1 );
+            size_t last  = m_responseHeaders.find_last_not_of( " \t\r\n", end );
+
+            if( first == std::string::npos || first > last )
+                return std::string();
+
+            return m_responseHeaders.substr( first, last - first + 1 );
+        }
+
+        start = end + 1;
+    }
+
+    return std::string();
+}
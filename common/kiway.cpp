@@ -31,6 +31,7 @@
 #include <pgm_base.h>
 #include <config.h>
 #include <id.h>
+#include <trace_events.h>
 
 #include <wx/stdpaths.h>
 #include <wx/debug.h>
@@ -156,6 +157,8 @@ KIFACE*  KIWAY::KiFACE( FACE_T aFaceId, bool doLoad )
     // DSO with KIFACE has not been loaded yet, does caller want to load it?
     if( doLoad  )
     {
+        TRACE_SCOPE( "KIWAY::KiFACE" );
+
         wxString dname = dso_full_path( aFaceId );
 
         wxDynamicLibrary dso;
@@ -0,0 +1,156 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file memory_stats.cpp
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include <fctsys.h>
+#include <macros.h>
+#include <memory_stats.h>
+
+#include <wx/ffile.h>
+
+#include <boost/thread/mutex.hpp>
+
+
+typedef std::vector< std::pair<const void*, MEMORY_STATS::SOURCE> > SOURCE_LIST;
+
+static boost::mutex sourcesLock;
+static SOURCE_LIST  sources;
+
+
+static wxString formatBytes( size_t aBytes )
+{
+    return wxString::Format( wxT( "%.1f MB" ), aBytes / ( 1024.0 * 1024.0 ) );
+}
+
+
+void MEMORY_STATS::Add( const wxString& aSubsystem, const wxString& aItems, size_t aCount,
+                        size_t aBytes )
+{
+    ENTRY entry = { aSubsystem, aItems, aCount, aBytes };
+
+    m_entries.push_back( entry );
+}
+
+
+size_t MEMORY_STATS::GetTotalBytes() const
+{
+    size_t total = 0;
+
+    for( unsigned i = 0; i < m_entries.size(); i++ )
+        total += m_entries[i].m_Bytes;
+
+    return total;
+}
+
+
+wxString MEMORY_STATS::Format() const
+{
+    // The subsystems in the order of their first entry
+    std::vector<wxString> subsystems;
+
+    for( unsigned i = 0; i < m_entries.size(); i++ )
+    {
+        if( std::find( subsystems.begin(), subsystems.end(), m_entries[i].m_Subsystem )
+            == subsystems.end() )
+            subsystems.push_back( m_entries[i].m_Subsystem );
+    }
+
+    wxString report;
+
+    for( unsigned s = 0; s < subsystems.size(); s++ )
+    {
+        size_t total = 0;
+
+        report << subsystems[s] << wxT( "\n" );
+
+        for( unsigned i = 0; i < m_entries.size(); i++ )
+        {
+            const ENTRY& entry = m_entries[i];
+
+            if( entry.m_Subsystem != subsystems[s] )
+                continue;
+
+            report << wxString::Format( wxT( "    %-28s %10lu %12s\n" ),
+                                        GetChars( entry.m_Items ),
+                                        (unsigned long) entry.m_Count,
+                                        GetChars( formatBytes( entry.m_Bytes ) ) );
+            total += entry.m_Bytes;
+        }
+
+        report << wxString::Format( wxT( "    %-39s %12s\n\n" ), GetChars( _( "Total" ) ),
+                                    GetChars( formatBytes( total ) ) );
+    }
+
+    report << wxString::Format( wxT( "%-43s %12s\n" ), GetChars( _( "Total" ) ),
+                                GetChars( formatBytes( GetTotalBytes() ) ) );
+
+    return report;
+}
+
+
+bool MEMORY_STATS::Write( const wxString& aFileName ) const
+{
+    wxFFile file( aFileName, wxT( "wt" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    return file.Write( Format() );
+}
+
+
+void MEMORY_STATS::RegisterSource( const void* aOwner, const SOURCE& aSource )
+{
+    boost::mutex::scoped_lock lock( sourcesLock );
+
+    sources.push_back( std::make_pair( aOwner, aSource ) );
+}
+
+
+void MEMORY_STATS::UnregisterSource( const void* aOwner )
+{
+    boost::mutex::scoped_lock lock( sourcesLock );
+
+    for( SOURCE_LIST::iterator it = sources.begin(); it != sources.end(); )
+    {
+        if( it->first == aOwner )
+            it = sources.erase( it );
+        else
+            ++it;
+    }
+}
+
+
+void MEMORY_STATS::CollectRegistered( MEMORY_STATS& aStats )
+{
+    boost::mutex::scoped_lock lock( sourcesLock );
+
+    for( unsigned i = 0; i < sources.size(); i++ )
+        sources[i].second( aStats );
+}
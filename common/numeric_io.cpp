@@ -0,0 +1,163 @@
+/**
+ * @file numeric_io.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <clocale>
+#include <cstdlib>
+
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
+#include <numeric_io.h>
+
+
+#if defined( _WIN32 )
+
+static _locale_t cLocale()
+{
+    // created once, and never freed: the conversions can run until the exit
+    static _locale_t locale = _create_locale( LC_ALL, "C" );
+
+    return locale;
+}
+
+
+double KiStrtod( const char* aText, char** aEnd )
+{
+    return _strtod_l( aText, aEnd, cLocale() );
+}
+
+
+int KiVsnprintf( char* aBuffer, size_t aSize, const char* aFormat, va_list aArgs )
+{
+    va_list tmp;
+    va_copy( tmp, aArgs );
+
+    // _vsnprintf_l() returns -1 on overflow, and does not always write the trailing nul
+    int len = _vsnprintf_l( aBuffer, aSize, aFormat, cLocale(), aArgs );
+
+    if( len < 0 || (size_t) len >= aSize )
+    {
+        len = _vscprintf_l( aFormat, cLocale(), tmp );
+
+        if( aSize > 0 )
+            aBuffer[aSize - 1] = '\0';
+    }
+
+    va_end( tmp );
+
+    return len;
+}
+
+
+static int kiVfprintf( FILE* aFile, const char* aFormat, va_list aArgs )
+{
+    return _vfprintf_l( aFile, aFormat, cLocale(), aArgs );
+}
+
+#else   // POSIX
+
+static locale_t cLocale()
+{
+    // created once, and never freed: the conversions can run until the exit
+    static locale_t locale = newlocale( LC_ALL_MASK, "C", (locale_t) 0 );
+
+    return locale;
+}
+
+
+/**
+ * Class C_LOCALE_SCOPE
+ * sets the "C" locale of the calling thread only, and restores its locale when
+ * destroyed.  uselocale() is only a pointer swap, unlike setlocale().
+ */
+class C_LOCALE_SCOPE
+{
+public:
+    C_LOCALE_SCOPE() :
+        m_previous( uselocale( cLocale() ) )
+    {
+    }
+
+    ~C_LOCALE_SCOPE()
+    {
+        uselocale( m_previous );
+    }
+
+private:
+    locale_t    m_previous;
+};
+
+
+double KiStrtod( const char* aText, char** aEnd )
+{
+    C_LOCALE_SCOPE scope;
+
+    return strtod( aText, aEnd );
+}
+
+
+int KiVsnprintf( char* aBuffer, size_t aSize, const char* aFormat, va_list aArgs )
+{
+    C_LOCALE_SCOPE scope;
+
+    return vsnprintf( aBuffer, aSize, aFormat, aArgs );
+}
+
+
+static int kiVfprintf( FILE* aFile, const char* aFormat, va_list aArgs )
+{
+    C_LOCALE_SCOPE scope;
+
+    return vfprintf( aFile, aFormat, aArgs );
+}
+
+#endif
+
+
+int KiSnprintf( char* aBuffer, size_t aSize, const char* aFormat, ... )
+{
+    va_list args;
+
+    va_start( args, aFormat );
+    int ret = KiVsnprintf( aBuffer, aSize, aFormat, args );
+    va_end( args );
+
+    return ret;
+}
+
+
+int KiFprintf( FILE* aFile, const char* aFormat, ... )
+{
+    va_list args;
+
+    va_start( args, aFormat );
+    int ret = kiVfprintf( aFile, aFormat, args );
+    va_end( args );
+
+    return ret;
+}
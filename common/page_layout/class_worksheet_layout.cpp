@@ -63,6 +63,9 @@
 static WORKSHEET_LAYOUT wksTheInstance;
 static WORKSHEET_LAYOUT* wksAltInstance;
 
+// the last revision given to a layout, see WORKSHEET_LAYOUT::GetRevision()
+static unsigned long wksLastRevision;
+
 WORKSHEET_LAYOUT::WORKSHEET_LAYOUT()
 {
     m_allowVoidList = false;
@@ -70,6 +73,15 @@ WORKSHEET_LAYOUT::WORKSHEET_LAYOUT()
     m_rightMargin = 10.0;   // the right page margin in mm
     m_topMargin = 10.0;     // the top page margin in mm
     m_bottomMargin = 10.0;  // the bottom page margin in mm
+    touch();
+}
+
+
+void WORKSHEET_LAYOUT::touch()
+{
+    // the revisions are unique among the instances: an instance allocated where a
+    // deleted one was does not have its revision
+    m_revision = ++wksLastRevision;
 }
 
 /* static function: returns the instance of WORKSHEET_LAYOUT
@@ -98,24 +110,28 @@ void WORKSHEET_LAYOUT::SetAltInstance( WORKSHEET_LAYOUT* aLayout )
 void WORKSHEET_LAYOUT::SetLeftMargin( double aMargin )
 {
     m_leftMargin = aMargin;    // the left page margin in mm
+    touch();
 }
 
 
 void WORKSHEET_LAYOUT::SetRightMargin( double aMargin )
 {
     m_rightMargin = aMargin;   // the right page margin in mm
+    touch();
 }
 
 
 void WORKSHEET_LAYOUT::SetTopMargin( double aMargin )
 {
     m_topMargin = aMargin;     // the top page margin in mm
+    touch();
 }
 
 
 void WORKSHEET_LAYOUT::SetBottomMargin( double aMargin )
 {
     m_bottomMargin = aMargin;  // the bottom page margin in mm
+    touch();
 }
 
 
@@ -124,6 +140,7 @@ void WORKSHEET_LAYOUT::ClearList()
     for( unsigned ii = 0; ii < m_list.size(); ii++ )
         delete m_list[ii];
     m_list.clear();
+    touch();
 }
 
 
@@ -132,7 +149,10 @@ void WORKSHEET_LAYOUT::Insert( WORKSHEET_DATAITEM* aItem, unsigned aIdx )
     if ( aIdx >= GetCount() )
         Append( aItem );
     else
+    {
         m_list.insert(  m_list.begin() + aIdx, aItem );
+        touch();
+    }
 }
 
 
@@ -141,6 +161,7 @@ bool WORKSHEET_LAYOUT::Remove( unsigned aIdx )
     if ( aIdx >= GetCount() )
         return false;
     m_list.erase( m_list.begin() + aIdx );
+    touch();
     return true;
 }
 
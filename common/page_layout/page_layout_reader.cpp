@@ -35,6 +35,7 @@
 #include <worksheet_shape_builder.h>
 #include <class_worksheet_dataitem.h>
 #include <page_layout_reader_lexer.h>
+#include <sexpr_dom.h>
 
 
 using namespace TB_READER_T;
@@ -43,8 +44,10 @@ using namespace TB_READER_T;
  * Class PAGE_LAYOUT_READER_PARSER
  * holds data and functions pertinent to parsing a S-expression file
  * for a WORKSHEET_LAYOUT.
+ * The whole description is read in a SEXPR_DOM first: the strings, and the png data
+ * of the bitmaps, are not copied until an item is built with them.
  */
-class PAGE_LAYOUT_READER_PARSER : public PAGE_LAYOUT_READER_LEXER
+class PAGE_LAYOUT_READER_PARSER
 {
 public:
     PAGE_LAYOUT_READER_PARSER( const char* aLine, const wxString& aSource );
@@ -52,64 +55,100 @@ public:
                 throw( PARSE_ERROR, IO_ERROR );
 
 private:
+    const char* m_text;     ///< the S-expression description
+    SEXPR_DOM   m_dom;
 
     /**
      * Function parseInt
-     * parses an integer and constrains it between two values.
+     * parses the integer of a list like "(repeat 3)" and constrains it between two values.
      * @param aMin is the smallest return value.
      * @param aMax is the largest return value.
      * @return int - the parsed integer.
      */
-    int parseInt( int aMin, int aMax );
+    int parseInt( const SEXPR_NODE* aList, int aMin, int aMax ) throw( PARSE_ERROR );
 
     /**
      * Function parseDouble
-     * parses a double
+     * parses the double of a list like "(linewidth 0.15)".
      * @return double - the parsed double.
      */
-    double parseDouble();
+    double parseDouble( const SEXPR_NODE* aList ) throw( PARSE_ERROR );
 
-    void parseSetup( WORKSHEET_LAYOUT* aLayout ) throw( IO_ERROR, PARSE_ERROR );
+    /**
+     * Function readDouble
+     * reads the number @a aNode of @a aList, and moves @a aNode to the next element.
+     */
+    double readDouble( const SEXPR_NODE*& aNode, const SEXPR_NODE* aList )
+        throw( PARSE_ERROR );
+
+    /**
+     * Function parseString
+     * parses the symbol or number of a list like "(name foo)".
+     */
+    wxString parseString( const SEXPR_NODE* aList ) throw( PARSE_ERROR );
+
+    /// Throws a PARSE_ERROR if @a aNode is not the end of its list
+    void needEnd( const SEXPR_NODE* aNode ) throw( PARSE_ERROR );
+
+    /**
+     * Function parseItems
+     * parses the items of the layout, starting with @a aNode.
+     */
+    void parseItems( const SEXPR_NODE* aNode, WORKSHEET_LAYOUT* aLayout )
+        throw( IO_ERROR, PARSE_ERROR );
+
+    void parseSetup( const SEXPR_NODE* aList, WORKSHEET_LAYOUT* aLayout )
+        throw( IO_ERROR, PARSE_ERROR );
 
     /**
      * parse a graphic item starting by "(line" or "(rect" and read parameters.
      */
-    void parseGraphic( WORKSHEET_DATAITEM * aItem ) throw( IO_ERROR, PARSE_ERROR );
+    void parseGraphic( const SEXPR_NODE* aList, WORKSHEET_DATAITEM * aItem )
+        throw( IO_ERROR, PARSE_ERROR );
 
     /**
      * parse a text item starting by "(tbtext" and read parameters.
      */
-    void parseText( WORKSHEET_DATAITEM_TEXT * aItem ) throw( IO_ERROR, PARSE_ERROR );
+    void parseText( const SEXPR_NODE* aList, WORKSHEET_DATAITEM_TEXT * aItem )
+        throw( IO_ERROR, PARSE_ERROR );
 
     /**
      * parse a polygon item starting by "( polygon" and read parameters.
      * the list of corners included in this description is read by parsePolyOutline
      */
-    void parsePolygon( WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
+    void parsePolygon( const SEXPR_NODE* aList, WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
         throw( IO_ERROR, PARSE_ERROR );
 
     /**
      * parse a list of corners starting by "( pts" and read coordinates.
      */
-    void parsePolyOutline( WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
+    void parsePolyOutline( const SEXPR_NODE* aList, WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
         throw( IO_ERROR, PARSE_ERROR );
 
 
     /**
      * parse a bitmap item starting by "( bitmap" and read parameters.
      */
-    void parseBitmap( WORKSHEET_DATAITEM_BITMAP * aItem )
+    void parseBitmap( const SEXPR_NODE* aList, WORKSHEET_DATAITEM_BITMAP * aItem )
         throw( IO_ERROR, PARSE_ERROR );
 
-    void parseCoordinate( POINT_COORD& aCoord) throw( IO_ERROR, PARSE_ERROR );
-    void readOption( WORKSHEET_DATAITEM * aItem ) throw( IO_ERROR, PARSE_ERROR );
-    void readPngdata( WORKSHEET_DATAITEM_BITMAP * aItem ) throw( IO_ERROR, PARSE_ERROR );
+    /**
+     * parse the coordinate starting at @a aNode, up to the end of @a aList: a position
+     * and an optional anchor, like " 25 1 ltcorner)"
+     */
+    void parseCoordinate( const SEXPR_NODE* aNode, const SEXPR_NODE* aList,
+                          POINT_COORD& aCoord ) throw( IO_ERROR, PARSE_ERROR );
+    void readOption( const SEXPR_NODE* aList, WORKSHEET_DATAITEM * aItem )
+        throw( IO_ERROR, PARSE_ERROR );
+    void readPngdata( const SEXPR_NODE* aList, WORKSHEET_DATAITEM_BITMAP * aItem )
+        throw( IO_ERROR, PARSE_ERROR );
 };
 
 // PCB_PLOT_PARAMS_PARSER
 
 PAGE_LAYOUT_READER_PARSER::PAGE_LAYOUT_READER_PARSER( const char* aLine, const wxString& aSource ) :
-    PAGE_LAYOUT_READER_LEXER( aLine, aSource )
+    m_text( aLine ),
+    m_dom( PAGE_LAYOUT_READER_LEXER::KeywordHash(), aSource )
 {
 }
 
@@ -117,190 +156,184 @@ PAGE_LAYOUT_READER_PARSER::PAGE_LAYOUT_READER_PARSER( const char* aLine, const w
 void PAGE_LAYOUT_READER_PARSER::Parse( WORKSHEET_LAYOUT* aLayout )
                              throw( PARSE_ERROR, IO_ERROR )
 {
-    T token;
-    WORKSHEET_DATAITEM * item;
-
     LOCALE_IO toggle;
 
-    while( ( token = NextTok() ) != T_RIGHT )
-    {
-        if( token == T_EOF)
-           break;
+    m_dom.Parse( m_text );
 
-        if( token == T_LEFT )
-            token = NextTok();
+    parseItems( m_dom.GetFirst(), aLayout );
+}
 
-        if( token == T_page_layout )
-            continue;
 
-        switch( token )
+void PAGE_LAYOUT_READER_PARSER::parseItems( const SEXPR_NODE* aNode, WORKSHEET_LAYOUT* aLayout )
+    throw( IO_ERROR, PARSE_ERROR )
+{
+    WORKSHEET_DATAITEM * item;
+
+    for( ; aNode; aNode = aNode->m_next )
+    {
+        if( !aNode->IsList() )
+            m_dom.Unexpected( aNode );
+
+        switch( aNode->Keyword() )
         {
+        case T_page_layout:
+            // the items are inside; the text after the layout is not read
+            parseItems( aNode->Arguments(), aLayout );
+            return;
+
         case T_setup:   // Defines default values for graphic items
-            parseSetup( aLayout );
+            parseSetup( aNode, aLayout );
             break;
 
         case T_line:
             item = new WORKSHEET_DATAITEM( WORKSHEET_DATAITEM::WS_SEGMENT );
-            parseGraphic( item );
+            parseGraphic( aNode, item );
             aLayout->Append( item );
             break;
 
         case T_rect:
             item = new WORKSHEET_DATAITEM( WORKSHEET_DATAITEM::WS_RECT );
-            parseGraphic( item );
+            parseGraphic( aNode, item );
             aLayout->Append( item );
             break;
 
         case T_polygon:
             item = new WORKSHEET_DATAITEM_POLYPOLYGON();
-            parsePolygon(  (WORKSHEET_DATAITEM_POLYPOLYGON*) item );
+            parsePolygon( aNode, (WORKSHEET_DATAITEM_POLYPOLYGON*) item );
             aLayout->Append( item );
             break;
 
         case T_bitmap:
             item = new WORKSHEET_DATAITEM_BITMAP( NULL );
-            parseBitmap( (WORKSHEET_DATAITEM_BITMAP*) item );
+            parseBitmap( aNode, (WORKSHEET_DATAITEM_BITMAP*) item );
             aLayout->Append( item );
             break;
 
         case T_tbtext:
-            NeedSYMBOLorNUMBER();
-            item = new WORKSHEET_DATAITEM_TEXT( FromUTF8() );
-            parseText( (WORKSHEET_DATAITEM_TEXT*) item );
+        {
+            const SEXPR_NODE* text = aNode->Arguments();
+
+            if( !text || text->IsList() )
+                m_dom.Expecting( "symbol|number", text ? text : aNode );
+
+            item = new WORKSHEET_DATAITEM_TEXT( text->FromUTF8() );
+            parseText( aNode, (WORKSHEET_DATAITEM_TEXT*) item );
             aLayout->Append( item );
             break;
+        }
 
         default:
-            Unexpected( CurText() );
+            m_dom.Unexpected( aNode );
             break;
         }
     }
 }
 
-void PAGE_LAYOUT_READER_PARSER::parseSetup( WORKSHEET_LAYOUT* aLayout )
+void PAGE_LAYOUT_READER_PARSER::parseSetup( const SEXPR_NODE* aList, WORKSHEET_LAYOUT* aLayout )
     throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( const SEXPR_NODE* node = aList->Arguments(); node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
+        if( !node->IsList() )
+            m_dom.Unexpected( node );
 
-        switch( token )
+        switch( node->Keyword() )
         {
-        case T_LEFT:
-            break;
-
         case T_linewidth:
-            WORKSHEET_DATAITEM::m_DefaultLineWidth = parseDouble();
-            NeedRIGHT();
+            WORKSHEET_DATAITEM::m_DefaultLineWidth = parseDouble( node );
             break;
 
         case T_textsize:
-            WORKSHEET_DATAITEM::m_DefaultTextSize.x = parseDouble();
-            WORKSHEET_DATAITEM::m_DefaultTextSize.y = parseDouble();
-            NeedRIGHT();
+        {
+            const SEXPR_NODE* arg = node->Arguments();
+
+            WORKSHEET_DATAITEM::m_DefaultTextSize.x = readDouble( arg, node );
+            WORKSHEET_DATAITEM::m_DefaultTextSize.y = readDouble( arg, node );
+            needEnd( arg );
             break;
+        }
 
         case T_textlinewidth:
-            WORKSHEET_DATAITEM::m_DefaultTextThickness = parseDouble();
-            NeedRIGHT();
+            WORKSHEET_DATAITEM::m_DefaultTextThickness = parseDouble( node );
             break;
 
         case T_left_margin:
-            aLayout->SetLeftMargin( parseDouble() );
-            NeedRIGHT();
+            aLayout->SetLeftMargin( parseDouble( node ) );
             break;
 
         case T_right_margin:
-            aLayout->SetRightMargin( parseDouble() );
-            NeedRIGHT();
+            aLayout->SetRightMargin( parseDouble( node ) );
             break;
 
         case T_top_margin:
-            aLayout->SetTopMargin( parseDouble() );
-            NeedRIGHT();
+            aLayout->SetTopMargin( parseDouble( node ) );
             break;
 
         case T_bottom_margin:
-            aLayout->SetBottomMargin( parseDouble() );
-            NeedRIGHT();
+            aLayout->SetBottomMargin( parseDouble( node ) );
             break;
 
         default:
-            Unexpected( CurText() );
+            m_dom.Unexpected( node );
             break;
         }
     }
 }
 
-void PAGE_LAYOUT_READER_PARSER::parsePolygon( WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
+void PAGE_LAYOUT_READER_PARSER::parsePolygon( const SEXPR_NODE* aList,
+                                              WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
     throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
-
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( const SEXPR_NODE* node = aList->Arguments(); node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
+        if( !node->IsList() )
+            m_dom.Unexpected( node );
 
-        if( token == T_LEFT )
-            token = NextTok();
-
-        switch( token )
+        switch( node->Keyword() )
         {
         case T_comment:
-            NeedSYMBOLorNUMBER();
-            aItem->m_Info =  FromUTF8();
-            NeedRIGHT();
+            aItem->m_Info = parseString( node );
             break;
 
         case T_pos:
-            parseCoordinate( aItem->m_Pos );
+            parseCoordinate( node->Arguments(), node, aItem->m_Pos );
             break;
 
         case T_name:
-            NeedSYMBOLorNUMBER();
-            aItem->m_Name =  FromUTF8();
-            NeedRIGHT();
+            aItem->m_Name = parseString( node );
             break;
 
         case T_option:
-            readOption( aItem );
+            readOption( node, aItem );
             break;
 
         case T_pts:
-            parsePolyOutline( aItem );
+            parsePolyOutline( node, aItem );
             aItem->CloseContour();
             break;
 
         case T_rotate:
-            aItem->m_Orient = parseDouble();
-            NeedRIGHT();
+            aItem->m_Orient = parseDouble( node );
             break;
 
         case T_repeat:
-            aItem->m_RepeatCount = parseInt( -1, 100 );
-            NeedRIGHT();
+            aItem->m_RepeatCount = parseInt( node, -1, 100 );
             break;
 
         case T_incrx:
-            aItem->m_IncrementVector.x = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.x = parseDouble( node );
             break;
 
         case T_incry:
-            aItem->m_IncrementVector.y = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.y = parseDouble( node );
             break;
 
         case T_linewidth:
-            aItem->m_LineWidth = parseDouble();
-            NeedRIGHT();
+            aItem->m_LineWidth = parseDouble( node );
             break;
 
         default:
-            Unexpected( CurText() );
+            m_dom.Unexpected( node );
             break;
         }
     }
@@ -308,131 +341,103 @@ void PAGE_LAYOUT_READER_PARSER::parsePolygon( WORKSHEET_DATAITEM_POLYPOLYGON * a
     aItem->SetBoundingBox();
 }
 
-void PAGE_LAYOUT_READER_PARSER::parsePolyOutline( WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
+void PAGE_LAYOUT_READER_PARSER::parsePolyOutline( const SEXPR_NODE* aList,
+                                                  WORKSHEET_DATAITEM_POLYPOLYGON * aItem )
     throw( IO_ERROR, PARSE_ERROR )
 {
     DPOINT corner;
-    T token;
 
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( const SEXPR_NODE* node = aList->Arguments(); node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
+        if( !node->IsList() || node->Keyword() != T_xy )
+            m_dom.Unexpected( node );
 
-        if( token == T_LEFT )
-            token = NextTok();
+        const SEXPR_NODE* arg = node->Arguments();
 
-        switch( token )
-        {
-        case T_xy:
-            corner.x = parseDouble();
-            corner.y = parseDouble();
-            aItem->AppendCorner( corner );
-            NeedRIGHT();
-            break;
-
-        default:
-            Unexpected( CurText() );
-            break;
-        }
+        corner.x = readDouble( arg, node );
+        corner.y = readDouble( arg, node );
+        aItem->AppendCorner( corner );
+        needEnd( arg );
     }
 }
 
 #include <wx/mstream.h>
-void PAGE_LAYOUT_READER_PARSER::parseBitmap( WORKSHEET_DATAITEM_BITMAP * aItem )
+void PAGE_LAYOUT_READER_PARSER::parseBitmap( const SEXPR_NODE* aList,
+                                             WORKSHEET_DATAITEM_BITMAP * aItem )
     throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
     BITMAP_BASE* image = new BITMAP_BASE;
     aItem->m_ImageBitmap = image;
 
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( const SEXPR_NODE* node = aList->Arguments(); node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
-
-        if( token == T_LEFT )
-            token = NextTok();
+        if( !node->IsList() )
+            m_dom.Unexpected( node );
 
-        switch( token )
+        switch( node->Keyword() )
         {
         case T_name:
-            NeedSYMBOLorNUMBER();
-            aItem->m_Name =  FromUTF8();
-            NeedRIGHT();
+            aItem->m_Name = parseString( node );
             break;
 
         case T_pos:
-            parseCoordinate( aItem->m_Pos );
+            parseCoordinate( node->Arguments(), node, aItem->m_Pos );
             break;
 
         case T_repeat:
-            aItem->m_RepeatCount = parseInt( -1, 100 );
-            NeedRIGHT();
+            aItem->m_RepeatCount = parseInt( node, -1, 100 );
             break;
 
         case T_incrx:
-            aItem->m_IncrementVector.x = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.x = parseDouble( node );
             break;
 
         case T_incry:
-            aItem->m_IncrementVector.y = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.y = parseDouble( node );
             break;
 
         case T_linewidth:
-            aItem->m_LineWidth = parseDouble();
-            NeedRIGHT();
+            aItem->m_LineWidth = parseDouble( node );
             break;
 
         case T_scale:
-            aItem->m_ImageBitmap->m_Scale = parseDouble();
-            NeedRIGHT();
+            aItem->m_ImageBitmap->m_Scale = parseDouble( node );
             break;
 
         case T_pngdata:
-            readPngdata( aItem );
+            readPngdata( node, aItem );
             break;
 
         case T_option:
-            readOption( aItem );
+            readOption( node, aItem );
             break;
 
         default:
-            Unexpected( CurText() );
+            m_dom.Unexpected( node );
             break;
         }
     }
 }
 
-void PAGE_LAYOUT_READER_PARSER::readPngdata( WORKSHEET_DATAITEM_BITMAP * aItem )
+void PAGE_LAYOUT_READER_PARSER::readPngdata( const SEXPR_NODE* aList,
+                                             WORKSHEET_DATAITEM_BITMAP * aItem )
             throw( IO_ERROR, PARSE_ERROR )
 {
     std::string tmp;
-    T token;
 
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( const SEXPR_NODE* node = aList->Arguments(); node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
+        if( !node->IsList() || node->Keyword() != T_data )
+            m_dom.Unexpected( node );
 
-        if( token == T_LEFT )
-            token = NextTok();
+        const SEXPR_NODE* data = node->Arguments();
 
-        switch( token )
-        {
-            case T_data:
-                NeedSYMBOLorNUMBER();
-                tmp += CurStr();
-                tmp += "\n";
-                NeedRIGHT();
-                break;
+        if( !data || data->IsList() )
+            m_dom.Expecting( "symbol|number", data ? data : node );
 
-            default:
-                Unexpected( CurText() );
-                break;
-        }
+        tmp.append( data->m_text, data->m_length );
+        tmp += "\n";
+        needEnd( data->m_next );
     }
 
     tmp += "EndData";
@@ -447,17 +452,13 @@ void PAGE_LAYOUT_READER_PARSER::readPngdata( WORKSHEET_DATAITEM_BITMAP * aItem )
 }
 
 
-void PAGE_LAYOUT_READER_PARSER::readOption( WORKSHEET_DATAITEM * aItem )
+void PAGE_LAYOUT_READER_PARSER::readOption( const SEXPR_NODE* aList,
+                                            WORKSHEET_DATAITEM * aItem )
     throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
-
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( const SEXPR_NODE* node = aList->Arguments(); node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
-
-        switch( token )
+        switch( node->IsList() ? DSN_LEFT : node->m_token )
         {
         case T_page1only:
             aItem->SetPage1Option( 1 );
@@ -468,165 +469,136 @@ void PAGE_LAYOUT_READER_PARSER::readOption( WORKSHEET_DATAITEM * aItem )
             break;
 
         default:
-            Unexpected( CurText() );
+            m_dom.Unexpected( node );
             break;
         }
     }
 }
 
 
-void PAGE_LAYOUT_READER_PARSER::parseGraphic( WORKSHEET_DATAITEM * aItem )
+void PAGE_LAYOUT_READER_PARSER::parseGraphic( const SEXPR_NODE* aList,
+                                              WORKSHEET_DATAITEM * aItem )
     throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
-
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( const SEXPR_NODE* node = aList->Arguments(); node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
-
-        if( token == T_LEFT )
-            token = NextTok();
-        else
+        if( !node->IsList() )
         {
-            // If an other token than T_LEFT is read here, this is an error
+            // If an other token than a list is read here, this is an error
             // however, due to a old bug in kicad, the token T_end can be found
             // without T_LEFT in a very few .wks files (perhaps only one in a demo).
+            // Its coordinate then ends the item.
             // So this ugly hack disables the error detection.
-            if( token != T_end )
-                Unexpected( CurText() );
+            if( node->m_token != T_end )
+                m_dom.Unexpected( node );
+
+            parseCoordinate( node->m_next, aList, aItem->m_End );
+            return;
         }
 
-        switch( token )
+        switch( node->Keyword() )
         {
         case T_comment:
-            NeedSYMBOLorNUMBER();
-            aItem->m_Info = FromUTF8();
-            NeedRIGHT();
+            aItem->m_Info = parseString( node );
             break;
 
         case T_option:
-            readOption( aItem );
+            readOption( node, aItem );
             break;
 
         case T_name:
-            NeedSYMBOLorNUMBER();
-            aItem->m_Name = FromUTF8();
-            NeedRIGHT();
+            aItem->m_Name = parseString( node );
             break;
 
         case T_start:
-            parseCoordinate( aItem->m_Pos );
+            parseCoordinate( node->Arguments(), node, aItem->m_Pos );
             break;
 
         case T_end:
-            parseCoordinate( aItem->m_End );
+            parseCoordinate( node->Arguments(), node, aItem->m_End );
             break;
 
         case T_repeat:
-            aItem->m_RepeatCount = parseInt( -1, 100 );
-            NeedRIGHT();
+            aItem->m_RepeatCount = parseInt( node, -1, 100 );
             break;
 
         case T_incrx:
-            aItem->m_IncrementVector.x = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.x = parseDouble( node );
             break;
 
         case T_incry:
-            aItem->m_IncrementVector.y = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.y = parseDouble( node );
             break;
 
         case T_linewidth:
-            aItem->m_LineWidth = parseDouble();
-            NeedRIGHT();
+            aItem->m_LineWidth = parseDouble( node );
             break;
 
         default:
-            Unexpected( CurText() );
+            m_dom.Unexpected( node );
             break;
         }
     }
 }
 
 
-void PAGE_LAYOUT_READER_PARSER::parseText( WORKSHEET_DATAITEM_TEXT* aItem )
+void PAGE_LAYOUT_READER_PARSER::parseText( const SEXPR_NODE* aList,
+                                           WORKSHEET_DATAITEM_TEXT* aItem )
     throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
-
-    while( ( token = NextTok() ) != T_RIGHT )
+    // the text itself is the first argument, read by the caller
+    for( const SEXPR_NODE* node = aList->Arguments()->m_next; node; node = node->m_next )
     {
-        if( token == T_EOF)
-           break;
+        if( !node->IsList() )
+            m_dom.Unexpected( node );
 
-        if( token == T_LEFT )
-            token = NextTok();
-
-        switch( token )
+        switch( node->Keyword() )
         {
         case T_comment:
-            NeedSYMBOLorNUMBER();
-            aItem->m_Info =  FromUTF8();
-            NeedRIGHT();
+            aItem->m_Info = parseString( node );
             break;
 
         case T_option:
-            readOption( aItem );
+            readOption( node, aItem );
             break;
 
         case T_name:
-            NeedSYMBOLorNUMBER();
-            aItem->m_Name =  FromUTF8();
-            NeedRIGHT();
+            aItem->m_Name = parseString( node );
             break;
 
         case T_pos:
-            parseCoordinate( aItem->m_Pos );
+            parseCoordinate( node->Arguments(), node, aItem->m_Pos );
             break;
 
         case T_repeat:
-            aItem->m_RepeatCount = parseInt( -1, 100 );
-            NeedRIGHT();
+            aItem->m_RepeatCount = parseInt( node, -1, 100 );
             break;
 
         case T_incrx:
-            aItem->m_IncrementVector.x = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.x = parseDouble( node );
             break;
 
         case T_incry:
-            aItem->m_IncrementVector.y = parseDouble();
-            NeedRIGHT();
+            aItem->m_IncrementVector.y = parseDouble( node );
             break;
 
         case T_incrlabel:
-            aItem->m_IncrementLabel = parseInt(INT_MIN, INT_MAX);
-            NeedRIGHT();
+            aItem->m_IncrementLabel = parseInt( node, INT_MIN, INT_MAX );
             break;
 
         case T_maxlen:
-            aItem->m_BoundingBoxSize.x = parseDouble();
-            NeedRIGHT();
+            aItem->m_BoundingBoxSize.x = parseDouble( node );
             break;
 
         case T_maxheight:
-            aItem->m_BoundingBoxSize.y = parseDouble();
-            NeedRIGHT();
+            aItem->m_BoundingBoxSize.y = parseDouble( node );
             break;
 
         case T_font:
-            while( ( token = NextTok() ) != T_RIGHT )
+            for( const SEXPR_NODE* font = node->Arguments(); font; font = font->m_next )
             {
-                if( token == T_EOF)
-                   break;
-
-                switch( token )
+                switch( font->Keyword() )
                 {
-                case T_LEFT:
-                    break;
-
                 case T_bold:
                     aItem->SetBold( true );
                     break;
@@ -636,30 +608,37 @@ void PAGE_LAYOUT_READER_PARSER::parseText( WORKSHEET_DATAITEM_TEXT* aItem )
                     break;
 
                 case T_size:
-                    aItem->m_TextSize.x = parseDouble();
-                    aItem->m_TextSize.y = parseDouble();
-                    NeedRIGHT();
+                {
+                    if( !font->IsList() )
+                        m_dom.Unexpected( font );
+
+                    const SEXPR_NODE* arg = font->Arguments();
+
+                    aItem->m_TextSize.x = readDouble( arg, font );
+                    aItem->m_TextSize.y = readDouble( arg, font );
+                    needEnd( arg );
                     break;
+                }
 
                 case T_linewidth:
-                    aItem->m_LineWidth = parseDouble();
-                    NeedRIGHT();
+                    if( !font->IsList() )
+                        m_dom.Unexpected( font );
+
+                    aItem->m_LineWidth = parseDouble( font );
                     break;
 
                 default:
-                    Unexpected( CurText() );
+                    m_dom.Unexpected( font );
                     break;
                 }
             }
             break;
 
         case T_justify:
-            while( ( token = NextTok() ) != T_RIGHT )
+            for( const SEXPR_NODE* justify = node->Arguments(); justify;
+                 justify = justify->m_next )
             {
-                if( token == T_EOF)
-                   break;
-
-                switch( token )
+                switch( justify->IsList() ? DSN_LEFT : justify->m_token )
                 {
                 case T_center:
                     aItem->m_Hjustify = GR_TEXT_HJUSTIFY_CENTER;
@@ -683,36 +662,35 @@ void PAGE_LAYOUT_READER_PARSER::parseText( WORKSHEET_DATAITEM_TEXT* aItem )
                     break;
 
                 default:
-                    Unexpected( CurText() );
+                    m_dom.Unexpected( justify );
                     break;
                 }
             }
             break;
 
         case T_rotate:
-            aItem->m_Orient = parseDouble();
-            NeedRIGHT();
+            aItem->m_Orient = parseDouble( node );
             break;
 
         default:
-            Unexpected( CurText() );
+            m_dom.Unexpected( node );
             break;
         }
     }
 }
 
 // parse an expression like " 25 1 ltcorner)"
-void PAGE_LAYOUT_READER_PARSER::parseCoordinate( POINT_COORD& aCoord)
+void PAGE_LAYOUT_READER_PARSER::parseCoordinate( const SEXPR_NODE* aNode,
+                                                 const SEXPR_NODE* aList,
+                                                 POINT_COORD& aCoord )
     throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
-
-    aCoord.m_Pos.x = parseDouble();
-    aCoord.m_Pos.y = parseDouble();
+    aCoord.m_Pos.x = readDouble( aNode, aList );
+    aCoord.m_Pos.y = readDouble( aNode, aList );
 
-    while( ( token = NextTok() ) != T_RIGHT )
+    for( ; aNode; aNode = aNode->m_next )
     {
-        switch( token )
+        switch( aNode->IsList() ? DSN_LEFT : aNode->m_token )
         {
             case T_ltcorner:
                 aCoord.m_Anchor = LT_CORNER;   // left top corner
@@ -731,42 +709,80 @@ void PAGE_LAYOUT_READER_PARSER::parseCoordinate( POINT_COORD& aCoord)
                 break;
 
             default:
-                Unexpected( CurText() );
+                m_dom.Unexpected( aNode );
                 break;
         }
     }
 }
 
-int PAGE_LAYOUT_READER_PARSER::parseInt( int aMin, int aMax )
+double PAGE_LAYOUT_READER_PARSER::readDouble( const SEXPR_NODE*& aNode,
+                                              const SEXPR_NODE* aList )
+    throw( PARSE_ERROR )
 {
-    T token = NextTok();
+    if( !aNode || aNode->m_token != DSN_NUMBER )
+        m_dom.Expecting( "number", aNode ? aNode : aList );
 
-    if( token != T_NUMBER )
-        Expecting( T_NUMBER );
+    double val = aNode->ToDouble();
 
-    int val = atoi( CurText() );
+    aNode = aNode->m_next;
+
+    return val;
+}
+
+int PAGE_LAYOUT_READER_PARSER::parseInt( const SEXPR_NODE* aList, int aMin, int aMax )
+    throw( PARSE_ERROR )
+{
+    const SEXPR_NODE* arg = aList->Arguments();
+
+    if( !arg || arg->m_token != DSN_NUMBER )
+        m_dom.Expecting( "number", arg ? arg : aList );
+
+    int val = arg->ToInt();
 
     if( val < aMin )
         val = aMin;
     else if( val > aMax )
         val = aMax;
 
+    needEnd( arg->m_next );
+
     return val;
 }
 
 
-double PAGE_LAYOUT_READER_PARSER::parseDouble()
+double PAGE_LAYOUT_READER_PARSER::parseDouble( const SEXPR_NODE* aList )
+    throw( PARSE_ERROR )
 {
-    T token = NextTok();
+    const SEXPR_NODE* arg = aList->Arguments();
 
-    if( token != T_NUMBER )
-        Expecting( T_NUMBER );
+    double val = readDouble( arg, aList );
 
-    double val = strtod( CurText(), NULL );
+    needEnd( arg );
 
     return val;
 }
 
+
+wxString PAGE_LAYOUT_READER_PARSER::parseString( const SEXPR_NODE* aList )
+    throw( PARSE_ERROR )
+{
+    const SEXPR_NODE* arg = aList->Arguments();
+
+    if( !arg || arg->IsList() )
+        m_dom.Expecting( "symbol|number", arg ? arg : aList );
+
+    needEnd( arg->m_next );
+
+    return arg->FromUTF8();
+}
+
+
+void PAGE_LAYOUT_READER_PARSER::needEnd( const SEXPR_NODE* aNode ) throw( PARSE_ERROR )
+{
+    if( aNode )
+        m_dom.Expecting( ")", aNode );
+}
+
 // defaultPageLayout is the default page layout description
 // using the S expr.
 // see page_layout_default_shape.cpp
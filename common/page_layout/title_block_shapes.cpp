@@ -63,6 +63,25 @@
 #include <class_worksheet_dataitem.h>
 
 
+bool WS_DRAW_ITEM_LIST::BUILD_KEY::operator==( const BUILD_KEY& aOther ) const
+{
+    // the cheap comparisons first
+    return m_layout == aOther.m_layout
+        && m_layoutRevision == aOther.m_layoutRevision
+        && m_pageSize == aOther.m_pageSize
+        && m_milsToIu == aOther.m_milsToIu
+        && m_penSize == aOther.m_penSize
+        && m_sheetNumber == aOther.m_sheetNumber
+        && m_sheetCount == aOther.m_sheetCount
+        && m_color == aOther.m_color
+        && m_altColor == aOther.m_altColor
+        && m_paperFormat == aOther.m_paperFormat
+        && m_fileName == aOther.m_fileName
+        && m_sheetFullName == aOther.m_sheetFullName
+        && m_titleBlock == aOther.m_titleBlock;
+}
+
+
 void WS_DRAW_ITEM_LIST::BuildWorkSheetGraphicList(
                        const PAGE_INFO& aPageInfo,
                        const TITLE_BLOCK& aTitleBlock,
@@ -87,6 +106,30 @@ void WS_DRAW_ITEM_LIST::BuildWorkSheetGraphicList(
     if( pglayout.GetCount() == 0 && !pglayout.VoidListAllowed() )
         pglayout.SetPageLayout();
 
+    BUILD_KEY key;
+
+    key.m_layout = &pglayout;
+    key.m_layoutRevision = pglayout.GetRevision();
+    key.m_paperFormat = aPageInfo.GetType();
+    key.m_pageSize = m_pageSize;
+    key.m_titleBlock = aTitleBlock;
+    key.m_fileName = m_fileName;
+    key.m_sheetFullName = m_sheetFullName ? *m_sheetFullName : wxString();
+    key.m_milsToIu = m_milsToIu;
+    key.m_penSize = m_penSize;
+    key.m_sheetNumber = m_sheetNumber;
+    key.m_sheetCount = m_sheetCount;
+    key.m_color = aColor;
+    key.m_altColor = aAltColor;
+
+    // The page layout editor modifies the layout items themselves
+    if( m_built && !pglayout.VoidListAllowed() && key == m_builtKey )
+        return;
+
+    clearList();
+    m_builtKey = key;
+    m_built = true;
+
     WORKSHEET_DATAITEM::m_WSunits2Iu = m_milsToIu / milsTomm;
     WORKSHEET_DATAITEM::m_Color = aColor;       // the default color to draw items
     WORKSHEET_DATAITEM::m_AltColor = aAltColor; // an alternate color to draw items
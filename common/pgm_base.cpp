@@ -51,6 +51,7 @@
 #include <menus_helpers.h>
 #include <confirm.h>
 #include <dialog_env_var_config.h>
+#include <thread_pool.h>
 
 
 #define KICAD_COMMON                     wxT( "kicad_common" )
@@ -279,6 +280,7 @@ PGM_BASE::PGM_BASE()
 
     m_wx_app = NULL;
     m_show_env_var_dialog = true;
+    m_thread_pool = NULL;
 
     setLanguageId( wxLANGUAGE_DEFAULT );
 
@@ -304,6 +306,21 @@ void PGM_BASE::destroy()
 
     delete m_locale;
     m_locale = 0;
+
+    // joins the worker threads, which must be idle by now
+    delete m_thread_pool;
+    m_thread_pool = 0;
+}
+
+
+THREAD_POOL& PGM_BASE::GetThreadPool()
+{
+    MUTLOCK lock( m_thread_pool_lock );
+
+    if( !m_thread_pool )
+        m_thread_pool = new THREAD_POOL();
+
+    return *m_thread_pool;
 }
 
 
@@ -0,0 +1,110 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file progress_reporter.cpp
+ */
+
+#include <algorithm>
+
+#include <wx/progdlg.h>
+
+#include <pgm_base.h>
+#include <progress_reporter.h>
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
+
+/// The period of the updates of the progress dialog, in milliseconds
+#define PROGRESS_REFRESH_PERIOD     50
+
+
+void PROGRESS_REPORTER::AdvanceProgress( int aCount )
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    m_progress += aCount;
+}
+
+
+void PROGRESS_REPORTER::Report( const wxString& aMessage )
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    // wxString is not thread safe, keep a copy which does not share its buffer
+    m_message = wxString( aMessage.wc_str() );
+}
+
+
+void PROGRESS_REPORTER::Cancel()
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    m_cancelled = true;
+}
+
+
+bool PROGRESS_REPORTER::IsCancelled() const
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    return m_cancelled;
+}
+
+
+int PROGRESS_REPORTER::GetProgress( wxString* aMessage ) const
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    *aMessage = wxString( m_message.wc_str() );
+
+    return m_progress;
+}
+
+
+bool RunInBackground( const BACKGROUND_JOB& aJob, wxProgressDialog* aDialog )
+{
+    PROGRESS_REPORTER reporter;
+    TASK_GROUP        job( Pgm().GetThreadPool() );
+
+    job.Run( boost::bind( aJob, boost::ref( reporter ) ) );
+
+    if( aDialog )
+    {
+        // Only the workers of the pool run the job: the calling thread keeps handling
+        // the events, the dialog ones in particular, until it ended
+        while( !job.WaitFor( PROGRESS_REFRESH_PERIOD ) )
+        {
+            wxString message;
+            int      progress = std::min( reporter.GetProgress( &message ),
+                                          aDialog->GetRange() );
+
+            if( !aDialog->Update( progress, message ) )
+                reporter.Cancel();      // Aborted by user
+        }
+    }
+
+    bool ok = job.Wait();
+
+    return ok && !reporter.IsCancelled();
+}
@@ -23,10 +23,19 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <richio.h>
+#include <numeric_io.h>
 
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
@@ -46,7 +55,7 @@ static int vprint( std::string* result, const char* format, va_list ap )
     va_list tmp;
     va_copy( tmp, ap );
 
-    size_t  len = vsnprintf( msg, sizeof(msg), format, ap );
+    size_t  len = KiVsnprintf( msg, sizeof(msg), format, ap );
 
     if( len < sizeof(msg) )     // the output fit into msg
     {
@@ -61,7 +70,7 @@ static int vprint( std::string* result, const char* format, va_list ap )
 
         buf.reserve( len+1 );   // reserve(), not resize() which writes. +1 for trailing nul.
 
-        len = vsnprintf( &buf[0], len+1, format, tmp );
+        len = KiVsnprintf( &buf[0], len+1, format, tmp );
 
         result->append( &buf[0], &buf[0] + len );
     }
@@ -267,14 +276,139 @@ char* FILE_LINE_READER::ReadLine() throw( IO_ERROR )
 }
 
 
-STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ) :
+MAPPED_FILE_LINE_READER::MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber,
+            unsigned aMaxLineLength ) throw( IO_ERROR ) :
+    LINE_READER( aMaxLineLength ),
+    data( NULL ),
+    size( 0 ),
+    ndx( 0 ),
+    mapped( false )
+{
+    source  = aFileName;
+    lineNum = aStartingLineNumber;
+
+#if !defined( _WIN32 )
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+    struct stat st;
+
+    if( fd >= 0 && fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) )
+    {
+        size = st.st_size;
+
+        // an empty file cannot be mapped, but there is nothing to read then
+        if( size == 0 )
+        {
+            close( fd );
+            return;
+        }
+
+        void* addr = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+        if( addr != MAP_FAILED )
+        {
+            madvise( addr, size, MADV_SEQUENTIAL );
+
+            data   = (const char*) addr;
+            mapped = true;
+        }
+    }
+
+    if( fd >= 0 )
+        close( fd );
+
+    if( mapped )
+        return;
+#endif
+
+    // the file cannot be mapped, read it at once
+    FILE* fp = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !fp )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename '%s' for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    char    chunk[BUFSIZ * 8];
+    size_t  count;
+
+    buffer.clear();
+
+    while( ( count = fread( chunk, 1, sizeof( chunk ), fp ) ) > 0 )
+        buffer.insert( buffer.end(), chunk, chunk + count );
+
+    bool failed = ferror( fp );
+
+    fclose( fp );
+
+    if( failed )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to read file '%s'" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    size = buffer.size();
+    data = size ? &buffer[0] : NULL;
+}
+
+
+MAPPED_FILE_LINE_READER::~MAPPED_FILE_LINE_READER()
+{
+#if !defined( _WIN32 )
+    if( mapped )
+        munmap( (void*) data, size );
+#endif
+}
+
+
+char* MAPPED_FILE_LINE_READER::ReadLine() throw( IO_ERROR )
+{
+    length = 0;
+
+    if( ndx < size )
+    {
+        const char* begin = data + ndx;
+        const char* nl = (const char*) memchr( begin, '\n', size - ndx );
+
+        if( nl )
+            length = nl - begin + 1;     // include the newline, so +1
+        else
+            length = size - ndx;
+
+        if( length >= maxLineLength )
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+        if( length+1 > capacity )   // +1 for terminating nul
+            expandCapacity( length+1 );
+
+        memcpy( line, begin, length );
+
+        ndx += length;
+    }
+
+    line[ length ] = 0;
+
+    // lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++lineNum;
+
+    return length ? line : NULL;
+}
+
+
+STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                                        unsigned aStartingLineNumber ) :
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     lines( aString ),
     ndx( 0 )
 {
     // Clipboard text should be nice and _use multiple lines_ so that
     // we can report _line number_ oriented error messages when parsing.
-    source = aSource;
+    source  = aSource;
+    lineNum = aStartingLineNumber;
 }
 
 
@@ -417,12 +551,12 @@ int OUTPUTFORMATTER::vprint( const char* fmt,  va_list ap )  throw( IO_ERROR )
     // we make a copy of va_list ap for the second call, if happens
     va_list tmp;
     va_copy( tmp, ap );
-    int ret = vsnprintf( &buffer[0], buffer.size(), fmt, ap );
+    int ret = KiVsnprintf( &buffer[0], buffer.size(), fmt, ap );
 
     if( ret >= (int) buffer.size() )
     {
         buffer.resize( ret + 1000 );
-        ret = vsnprintf( &buffer[0], buffer.size(), fmt, tmp );
+        ret = KiVsnprintf( &buffer[0], buffer.size(), fmt, tmp );
     }
 
     va_end( tmp );      // Release the temporary va_list, initialised from ap
@@ -446,25 +580,42 @@ int OUTPUTFORMATTER::sprint( const char* fmt, ... )  throw( IO_ERROR )
 }
 
 
-int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... ) throw( IO_ERROR )
-{
 #define NESTWIDTH           2   ///< how many spaces per nestLevel
 
-    va_list     args;
+int OUTPUTFORMATTER::Write( int nestLevel, const char* aText, int aCount ) throw( IO_ERROR )
+{
+    static const char spaces[] = "                                ";
+    const int   spaceCount = sizeof( spaces ) - 1;
+    int         total = 0;
 
-    va_start( args, fmt );
+    // no error checking needed, an exception indicates an error.
+    for( int indent = nestLevel * NESTWIDTH;  indent > 0;  indent -= spaceCount )
+    {
+        int count = std::min( indent, spaceCount );
 
-    int result = 0;
-    int total  = 0;
+        write( spaces, count );
+        total += count;
+    }
 
-    for( int i=0; i<nestLevel;  ++i )
+    if( aCount > 0 )
     {
-        // no error checking needed, an exception indicates an error.
-        result = sprint( "%*c", NESTWIDTH, ' ' );
-
-        total += result;
+        write( aText, aCount );
+        total += aCount;
     }
 
+    return total;
+}
+
+
+int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... ) throw( IO_ERROR )
+{
+    va_list     args;
+
+    va_start( args, fmt );
+
+    int result = 0;
+    int total  = Write( nestLevel, NULL, 0 );
+
     // no error checking needed, an exception indicates an error.
     result = vprint( fmt, args );
 
@@ -573,6 +724,10 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName,
                             m_filename.GetData() );
         THROW_IO_ERROR( msg );
     }
+
+    // a large buffer, the files written are often tens of MB
+    m_buffer.resize( FILEFMTBUFZ );
+    setvbuf( m_fp, &m_buffer[0], _IOFBF, m_buffer.size() );
 }
 
 
@@ -0,0 +1,344 @@
+/**
+ * @file sexpr_dom.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include <numeric_io.h>
+#include <sexpr_dom.h>
+
+
+/// The count of nodes allocated at once
+#define SEXPR_NODE_BLOCK 1024
+
+
+// the separators of DSNLEXER
+static bool isSpace( char cc )
+{
+    switch( (unsigned char) cc )
+    {
+    case ' ':
+    case '\n':
+    case '\r':
+    case '\t':
+    case '\0':
+        return true;
+    }
+
+    return false;
+}
+
+
+static bool isSep( char cc )
+{
+    return isSpace( cc ) || cc == '(' || cc == ')';
+}
+
+
+double SEXPR_NODE::ToDouble() const
+{
+    // a number atom is followed by a separator or by the end of the text
+    return KiStrtod( m_text, NULL );
+}
+
+
+int SEXPR_NODE::ToInt() const
+{
+    return atoi( m_text );
+}
+
+
+SEXPR_DOM::SEXPR_DOM( const KEYWORD_HASH* aKeywords, const wxString& aSource ) :
+    m_keywords( aKeywords ),
+    m_source( aSource ),
+    m_blockUsed( SEXPR_NODE_BLOCK ),
+    m_first( NULL )
+{
+}
+
+
+SEXPR_DOM::~SEXPR_DOM()
+{
+    clear();
+}
+
+
+void SEXPR_DOM::clear()
+{
+    for( unsigned i = 0; i < m_blocks.size(); ++i )
+        delete[] m_blocks[i];
+
+    m_blocks.clear();
+    m_blockUsed = SEXPR_NODE_BLOCK;
+    m_decoded.clear();
+    m_lines.clear();
+    m_first = NULL;
+}
+
+
+SEXPR_NODE* SEXPR_DOM::newNode( int aToken, const char* aText, unsigned aLength, int aLine,
+                                int aOffset )
+{
+    if( m_blockUsed == SEXPR_NODE_BLOCK )
+    {
+        m_blocks.push_back( new SEXPR_NODE[SEXPR_NODE_BLOCK] );
+        m_blockUsed = 0;
+    }
+
+    SEXPR_NODE* node = &m_blocks.back()[m_blockUsed++];
+
+    node->m_text    = aText;
+    node->m_length  = aLength;
+    node->m_token   = aToken;
+    node->m_line    = aLine;
+    node->m_offset  = aOffset;
+    node->m_child   = NULL;
+    node->m_next    = NULL;
+
+    return node;
+}
+
+
+void SEXPR_DOM::Parse( const char* aText ) throw( PARSE_ERROR )
+{
+    clear();
+
+    m_text = aText;
+
+    const char* cp  = m_text.c_str();
+    const char* end = cp + m_text.size();
+    int         line = 0;
+
+    // where to link the next node of each list being read, the top level first
+    std::vector<SEXPR_NODE**> tails( 1, &m_first );
+
+    while( cp < end )
+    {
+        const char* lineStart = cp;
+        const char* lineEnd = (const char*) memchr( cp, '\n', end - cp );
+
+        lineEnd = lineEnd ? lineEnd + 1 : end;
+        m_lines.push_back( lineStart );
+        ++line;
+
+        cp = lineEnd;
+
+        const char* p = lineStart;
+
+        while( p < lineEnd && isSpace( *p ) )
+            ++p;
+
+        // If the first non-blank character is #, this line is a comment.
+        if( p < lineEnd && *p == '#' )
+            continue;
+
+        while( p < lineEnd )
+        {
+            if( isSpace( *p ) )
+            {
+                ++p;
+                continue;
+            }
+
+            int         offset = p - lineStart;
+            SEXPR_NODE* node;
+
+            if( *p == '(' )
+            {
+                node = newNode( DSN_LEFT, p, 1, line, offset );
+                *tails.back() = node;
+                tails.back() = &node->m_next;
+                tails.push_back( &node->m_child );
+                ++p;
+                continue;
+            }
+
+            if( *p == ')' )
+            {
+                if( tails.size() == 1 )
+                    return;     // the end of the outer list
+
+                tails.pop_back();
+                ++p;
+                continue;
+            }
+
+            if( *p == '"' )
+            {
+                const char* head = ++p;
+
+                // most strings have no escape sequence, and are used in place
+                while( head < lineEnd && *head != '"' && *head != '\\' )
+                    ++head;
+
+                if( head < lineEnd && *head == '"' )
+                {
+                    node = newNode( DSN_STRING, p, head - p, line, offset );
+                    p = head + 1;
+                }
+                else
+                {
+                    m_decoded.push_back( std::string( p, head ) );
+
+                    std::string& text = m_decoded.back();
+                    bool         terminated = false;
+
+                    while( head < lineEnd )
+                    {
+                        // ESCAPE SEQUENCES, as DSNLEXER::NextTok()
+                        if( *head == '\\' )
+                        {
+                            char    tbuf[8];
+                            char    c;
+                            int     i;
+
+                            if( ++head >= lineEnd )
+                                break;
+
+                            switch( *head++ )
+                            {
+                            case '"':
+                            case '\\':  c = head[-1];   break;
+                            case 'a':   c = '\x07';     break;
+                            case 'b':   c = '\x08';     break;
+                            case 'f':   c = '\x0c';     break;
+                            case 'n':   c = '\n';       break;
+                            case 'r':   c = '\r';       break;
+                            case 't':   c = '\x09';     break;
+                            case 'v':   c = '\x0b';     break;
+
+                            case 'x':   // 1 or 2 byte hex escape sequence
+                                for( i = 0; i < 2 && head + i < lineEnd; ++i )
+                                {
+                                    if( !isxdigit( (unsigned char) head[i] ) )
+                                        break;
+                                    tbuf[i] = head[i];
+                                }
+                                tbuf[i] = '\0';
+                                c = i > 0 ? (char) strtoul( tbuf, NULL, 16 ) : 'x';
+                                head += i;
+                                break;
+
+                            default:    // 1-3 byte octal escape sequence
+                                --head;
+                                for( i = 0; i < 3 && head + i < lineEnd; ++i )
+                                {
+                                    if( head[i] < '0' || head[i] > '7' )
+                                        break;
+                                    tbuf[i] = head[i];
+                                }
+                                tbuf[i] = '\0';
+                                c = i > 0 ? (char) strtoul( tbuf, NULL, 8 ) : '\\';
+                                head += i;
+                                break;
+                            }
+
+                            text += c;
+                        }
+                        else if( *head == '"' )
+                        {
+                            ++head;
+                            terminated = true;
+                            break;
+                        }
+                        else
+                            text += *head++;
+                    }
+
+                    if( !terminated )
+                        throwError( _( "Un-terminated delimited string" ), line, offset );
+
+                    node = newNode( DSN_STRING, text.c_str(), text.size(), line, offset );
+                    p = head;
+                }
+            }
+            else
+            {
+                const char* head = p;
+
+                while( head < lineEnd && !isSep( *head ) )
+                    ++head;
+
+                int token;
+
+                if( DSNLEXER::IsNumber( p, head ) )
+                    token = DSN_NUMBER;
+                else if( m_keywords )
+                    token = m_keywords->Find( p, head - p );
+                else
+                    token = DSN_SYMBOL;
+
+                node = newNode( token, p, head - p, line, offset );
+                p = head;
+            }
+
+            *tails.back() = node;
+            tails.back() = &node->m_next;
+        }
+    }
+}
+
+
+void SEXPR_DOM::throwError( const wxString& aMessage, int aLine, int aOffset ) const
+    throw( PARSE_ERROR )
+{
+    std::string lineText;
+
+    if( aLine >= 1 && aLine <= (int) m_lines.size() )
+    {
+        const char* start = m_lines[aLine - 1];
+        const char* limit = aLine < (int) m_lines.size() ? m_lines[aLine] :
+                                                          m_text.c_str() + m_text.size();
+
+        lineText.assign( start, limit );
+    }
+
+    THROW_PARSE_ERROR( aMessage, m_source, lineText.c_str(), aLine, aOffset );
+}
+
+
+void SEXPR_DOM::Expecting( const char* aText, const SEXPR_NODE* aNode ) const
+    throw( PARSE_ERROR )
+{
+    wxString errText = wxString::Format(
+        _( "Expecting '%s'" ), GetChars( wxString::FromUTF8( aText ) ) );
+
+    throwError( errText, aNode ? aNode->m_line : 0, aNode ? aNode->m_offset : 0 );
+}
+
+
+void SEXPR_DOM::Unexpected( const SEXPR_NODE* aNode ) const throw( PARSE_ERROR )
+{
+    // a list is reported by its keyword, as the DSNLEXER parsers do
+    if( aNode && aNode->IsList() && aNode->m_child )
+        aNode = aNode->m_child;
+
+    wxString text = aNode && !aNode->IsList() ? aNode->FromUTF8() : wxString( wxT( ")" ) );
+    wxString errText = wxString::Format( _( "Unexpected '%s'" ), GetChars( text ) );
+
+    throwError( errText, aNode ? aNode->m_line : 0, aNode ? aNode->m_offset : 0 );
+}
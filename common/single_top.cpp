@@ -45,6 +45,9 @@
 #include <pgm_base.h>
 #include <kiway_player.h>
 #include <confirm.h>
+#include <trace_events.h>
+
+#include <boost/bind.hpp>
 
 
 // Only a single KIWAY is supported in this single_top top level component,
@@ -60,9 +63,18 @@ KIWAY    Kiway( &Pgm(), KFCTL_STANDALONE );
  */
 static struct PGM_SINGLE_TOP : public PGM_BASE
 {
+    PGM_SINGLE_TOP() :
+        m_batchJob( false ),
+        m_batchStatus( 0 )
+    {
+    }
+
     bool OnPgmInit( wxApp* aWxApp );                    // overload PGM_BASE virtual
     void OnPgmExit();                                   // overload PGM_BASE virtual
     void MacOpenFile( const wxString& aFileName );      // overload PGM_BASE virtual
+
+    bool    m_batchJob;         ///< true if a --batch job ran in OnPgmInit(), without GUI
+    int     m_batchStatus;      ///< the exit status of the batch job
 } program;
 
 
@@ -134,7 +146,15 @@ struct APP_SINGLE_TOP : public wxApp
 
         try
         {
-            ret = wxApp::OnRun();
+            // A batch job has already run in OnPgmInit(), there are no events to wait
+            // for: only its frame to delete, before the KIFACE ends.
+            if( program.m_batchJob )
+            {
+                DeletePendingObjects();
+                ret = program.m_batchStatus;
+            }
+            else
+                ret = wxApp::OnRun();
         }
         catch( const std::exception& e )
         {
@@ -174,11 +194,23 @@ struct APP_SINGLE_TOP : public wxApp
 IMPLEMENT_APP( APP_SINGLE_TOP );
 
 
+// Records the startup until the first events handled once the top frame is shown, i.e.
+// about the time to its first paint
+static void traceFirstEvents( uint64_t aStart )
+{
+    TRACE_EVENTS::Record( "startup until the first events", aStart, get_tics() );
+}
+
+
 bool PGM_SINGLE_TOP::OnPgmInit( wxApp* aWxApp )
 {
     // first thing: set m_wx_app
     m_wx_app = aWxApp;
 
+    // The phases of the startup are traced, see TRACE_EVENTS
+    uint64_t    startTics = get_tics();
+    TRACE_SCOPE( "PGM_SINGLE_TOP::OnPgmInit" );
+
     wxString absoluteArgv0 = wxStandardPaths::Get().GetExecutablePath();
 
     if( !wxIsAbsolutePath( absoluteArgv0 ) )
@@ -187,8 +219,12 @@ bool PGM_SINGLE_TOP::OnPgmInit( wxApp* aWxApp )
         return false;
     }
 
-    if( !initPgm() )
-        return false;
+    {
+        TRACE_SCOPE( "initPgm" );
+
+        if( !initPgm() )
+            return false;
+    }
 
 #if !defined(BUILD_KIWAY_DLL)
     // Get the getter, it is statically linked into this binary image.
@@ -207,7 +243,13 @@ bool PGM_SINGLE_TOP::OnPgmInit( wxApp* aWxApp )
     // Use KIWAY to create a top window, which registers its existence also.
     // "TOP_FRAME" is a macro that is passed on compiler command line from CMake,
     // and is one of the types in FRAME_T.
-    KIWAY_PLAYER* frame = Kiway.Player( TOP_FRAME, true );
+    KIWAY_PLAYER* frame;
+
+    {
+        TRACE_SCOPE( "KIWAY::Player" );
+
+        frame = Kiway.Player( TOP_FRAME, true );
+    }
 
     Kiway.SetTop( frame );
 
@@ -216,6 +258,25 @@ bool PGM_SINGLE_TOP::OnPgmInit( wxApp* aWxApp )
     // Open project or file specified on the command line:
     int argc = App().argc;
 
+    // A command line job, "<program> --batch <job arguments>": the frame runs the job
+    // without being shown, and the program exits with its status
+    if( argc > 1 && wxString( App().argv[1] ) == wxT( "--batch" ) )
+    {
+        std::vector<wxString>   argSet;
+
+        for( int i=2;  i<argc;  ++i )
+            argSet.push_back( App().argv[i] );
+
+        SetBatchMode( true );
+
+        m_batchJob = true;
+        m_batchStatus = frame->RunBatchJob( argSet );
+
+        frame->Destroy();
+
+        return true;
+    }
+
     if( argc > 1 )
     {
         /*
@@ -253,6 +314,8 @@ bool PGM_SINGLE_TOP::OnPgmInit( wxApp* aWxApp )
             argSet[0] = argv1.GetFullPath();
         }
 
+        TRACE_SCOPE( "KIWAY_PLAYER::OpenProjectFiles" );
+
         // Use the KIWAY_PLAYER::OpenProjectFiles() API function:
         if( !frame->OpenProjectFiles( argSet ) )
         {
@@ -273,6 +336,9 @@ bool PGM_SINGLE_TOP::OnPgmInit( wxApp* aWxApp )
 
     frame->Show();
 
+    if( TRACE_EVENTS::IsEnabled() )
+        frame->CallAfter( boost::bind( &traceFirstEvents, startTics ) );
+
     return true;
 }
 
@@ -0,0 +1,255 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file thread_pool.cpp
+ */
+
+#include <algorithm>
+
+#include <common.h>       // LOCALE_IO
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
+
+
+THREAD_POOL::THREAD_POOL( int aThreadCount ) :
+    m_queued( 0 ),
+    m_stop( false )
+{
+    if( aThreadCount <= 0 )
+        aThreadCount = boost::thread::hardware_concurrency();
+
+    // the thread waiting for the tasks runs them too
+    m_workerCount = std::max( aThreadCount - 1, 1 );
+
+    for( int i = 0; i <= m_workerCount; ++i )
+        m_queues.push_back( new TASK_QUEUE );
+
+    for( int i = 0; i < m_workerCount; ++i )
+        m_threads.create_thread( boost::bind( &THREAD_POOL::workerLoop, this, i ) );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        boost::mutex::scoped_lock lock( m_wakeUpLock );
+
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_all();
+    m_threads.join_all();
+}
+
+
+THREAD_POOL::TASK_QUEUE& THREAD_POOL::ownQueue()
+{
+    int* index = m_workerIndex.get();
+
+    return m_queues[index ? *index : m_workerCount];
+}
+
+
+void THREAD_POOL::push( const TASK& aTask, TASK_GROUP* aGroup )
+{
+    QUEUED_TASK queued = { aTask, aGroup, LOCALE_IO::IsActive() };
+    TASK_QUEUE& queue = ownQueue();
+
+    {
+        boost::mutex::scoped_lock lock( queue.m_lock );
+
+        queue.m_tasks.push_back( queued );
+    }
+
+    {
+        boost::mutex::scoped_lock lock( m_wakeUpLock );
+
+        ++m_queued;
+    }
+
+    m_wakeUp.notify_one();
+}
+
+
+bool THREAD_POOL::takeTask( TASK_QUEUE& aQueue, TASK_GROUP* aGroup, bool aNewest,
+                            QUEUED_TASK& aTask )
+{
+    boost::mutex::scoped_lock lock( aQueue.m_lock );
+
+    std::deque<QUEUED_TASK>& tasks = aQueue.m_tasks;
+
+    for( unsigned i = 0; i < tasks.size(); ++i )
+    {
+        unsigned index = aNewest ? tasks.size() - 1 - i : i;
+
+        if( aGroup && tasks[index].m_group != aGroup )
+            continue;
+
+        aTask = tasks[index];
+        tasks.erase( tasks.begin() + index );
+
+        return true;
+    }
+
+    return false;
+}
+
+
+bool THREAD_POOL::runOne( TASK_GROUP* aGroup )
+{
+    TASK_QUEUE& own = ownQueue();
+    QUEUED_TASK task;
+
+    // the last task of its own queue is the one whose data is likely in the cache
+    bool found = takeTask( own, aGroup, true, task );
+
+    // else steal the oldest task of another queue, likely the biggest job
+    for( unsigned i = 0; !found && i < m_queues.size(); ++i )
+    {
+        if( &m_queues[i] != &own )
+            found = takeTask( m_queues[i], aGroup, false, task );
+    }
+
+    if( !found )
+        return false;
+
+    {
+        boost::mutex::scoped_lock lock( m_wakeUpLock );
+
+        --m_queued;
+    }
+
+    bool failed = false;
+
+    try
+    {
+        if( task.m_cLocale )
+        {
+            LOCALE_IO toggle;
+
+            task.m_task();
+        }
+        else
+        {
+            task.m_task();
+        }
+    }
+    catch( ... )
+    {
+        failed = true;
+    }
+
+    task.m_group->taskDone( failed );
+
+    return true;
+}
+
+
+void THREAD_POOL::workerLoop( int aIndex )
+{
+    m_workerIndex.reset( new int( aIndex ) );
+
+    for( ;; )
+    {
+        if( runOne() )
+            continue;
+
+        boost::mutex::scoped_lock lock( m_wakeUpLock );
+
+        if( m_stop )
+            return;
+
+        // m_queued is incremented under the lock before being notified, no wake up is lost
+        if( m_queued == 0 )
+            m_wakeUp.wait( lock );
+    }
+}
+
+
+void TASK_GROUP::Run( const THREAD_POOL::TASK& aTask )
+{
+    {
+        boost::mutex::scoped_lock lock( m_lock );
+
+        ++m_pending;
+    }
+
+    m_pool.push( aTask, this );
+}
+
+
+bool TASK_GROUP::Wait()
+{
+    for( ;; )
+    {
+        {
+            boost::mutex::scoped_lock lock( m_lock );
+
+            if( m_pending == 0 )
+                break;
+        }
+
+        // Help with the queued tasks of this group only: another task could run for long,
+        // or must not run on the waiting thread, e.g. the GUI thread.  Once there is none
+        // left, the tasks of the group still pending are running on other threads.
+        if( m_pool.runOne( this ) )
+            continue;
+
+        boost::mutex::scoped_lock lock( m_lock );
+
+        if( m_pending > 0 )
+            m_done.wait( lock );
+    }
+
+    boost::mutex::scoped_lock lock( m_lock );
+    bool ok = !m_failed;
+
+    m_failed = false;
+
+    return ok;
+}
+
+
+bool TASK_GROUP::WaitFor( unsigned aMilliseconds )
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    if( m_pending > 0 )
+        m_done.timed_wait( lock, boost::posix_time::milliseconds( aMilliseconds ) );
+
+    return m_pending == 0;
+}
+
+
+void TASK_GROUP::taskDone( bool aFailed )
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    m_failed = m_failed || aFailed;
+
+    // the group can be destroyed once m_pending is 0, notify under the lock
+    if( --m_pending == 0 )
+        m_done.notify_all();
+}
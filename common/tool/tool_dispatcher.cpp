@@ -353,6 +353,12 @@ void TOOL_DISPATCHER::DispatchWxCommand( wxCommandEvent& aEvent )
 }
 
 
+void TOOL_DISPATCHER::DispatchPendingEvents()
+{
+    m_toolMgr->DispatchPendingMotion();
+}
+
+
 void TOOL_DISPATCHER::updateUI()
 {
     // TODO I don't feel it is the right place for updating UI,
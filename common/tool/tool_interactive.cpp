@@ -24,6 +24,11 @@
 
 #include <string>
 
+#include <wx/progdlg.h>
+
+#include <draw_frame.h>
+#include <class_draw_panel_gal.h>
+
 #include <tool/tool_event.h>
 #include <tool/tool_manager.h>
 #include <tool/tool_interactive.h>
@@ -58,6 +63,27 @@ OPT_TOOL_EVENT TOOL_INTERACTIVE::Wait( const TOOL_EVENT_LIST& aEventList )
 }
 
 
+bool TOOL_INTERACTIVE::RunInBackground( const BACKGROUND_JOB& aJob, const wxString& aTitle,
+                                        int aMaxProgress )
+{
+    EDA_DRAW_FRAME*     frame = getEditFrame<EDA_DRAW_FRAME>();
+    EDA_DRAW_PANEL_GAL* canvas = frame->GetGalCanvas();
+
+    // One more step than the job, so that the dialog is not hidden before it ended
+    wxProgressDialog dialog( aTitle, wxEmptyString, aMaxProgress + 1, frame,
+                             wxPD_AUTO_HIDE | wxPD_CAN_ABORT | wxPD_APP_MODAL |
+                             wxPD_ELAPSED_TIME );
+
+    canvas->StopDrawing();
+
+    bool completed = ::RunInBackground( aJob, &dialog );
+
+    canvas->StartDrawing();
+
+    return completed;
+}
+
+
 void TOOL_INTERACTIVE::goInternal( TOOL_STATE_FUNC& aState, const TOOL_EVENT_LIST& aConditions )
 {
     m_toolMgr->ScheduleNextState( this, aState, aConditions );
@@ -49,6 +49,7 @@
 #include <wxPcbStruct.h>
 #include <confirm.h>
 #include <class_draw_panel_gal.h>
+#include <frame_profiler.h>
 
 using boost::optional;
 
@@ -199,7 +200,8 @@ TOOL_MANAGER::TOOL_MANAGER() :
     m_view( NULL ),
     m_viewControls( NULL ),
     m_editFrame( NULL ),
-    m_passEvent( false )
+    m_passEvent( false ),
+    m_coalescedEvents( 0 )
 {
     m_actionMgr = new ACTION_MANAGER( this );
 }
@@ -657,6 +659,50 @@ void TOOL_MANAGER::finishTool( TOOL_STATE* aState )
 
 
 bool TOOL_MANAGER::ProcessEvent( const TOOL_EVENT& aEvent )
+{
+    // Mouse motions come faster than the tools can handle them, only the
+    // most recent one is worth processing
+    if( aEvent.Category() == TC_MOUSE &&
+        ( aEvent.Action() == TA_MOUSE_MOTION || aEvent.Action() == TA_MOUSE_DRAG ) )
+    {
+        if( m_pendingMotion && m_pendingMotion->Action() == aEvent.Action() &&
+            m_pendingMotion->Buttons() == aEvent.Buttons() &&
+            m_pendingMotion->Modifier() == aEvent.Modifier() )
+        {
+            m_coalescedEvents++;
+            KIGFX::FRAME_PROFILER::Instance().AddCount(
+                    KIGFX::FRAME_PROFILER::COALESCED_EVENTS );
+        }
+        else
+        {
+            DispatchPendingMotion();
+        }
+
+        m_pendingMotion = aEvent;
+
+        return false;
+    }
+
+    // Keep the order of the events
+    DispatchPendingMotion();
+
+    return processEvent( aEvent );
+}
+
+
+void TOOL_MANAGER::DispatchPendingMotion()
+{
+    if( !m_pendingMotion )
+        return;
+
+    TOOL_EVENT event = *m_pendingMotion;
+
+    m_pendingMotion = boost::none;
+    processEvent( event );
+}
+
+
+bool TOOL_MANAGER::processEvent( const TOOL_EVENT& aEvent )
 {
     // Early dispatch of events destined for the TOOL_MANAGER
     if( !dispatchStandardEvents( aEvent ) )
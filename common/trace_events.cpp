@@ -0,0 +1,170 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file trace_events.cpp
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <trace_events.h>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+
+bool TRACE_EVENTS::m_enabled = false;
+
+
+struct TRACE_EVENT
+{
+    const char* m_name;
+    uint64_t    m_start;
+    uint64_t    m_end;
+};
+
+
+// The events of a thread.  Its lock is only taken by Write() concurrently.
+struct THREAD_TRACE
+{
+    int                         m_tid;
+    boost::mutex                m_lock;
+    std::vector<TRACE_EVENT>    m_events;
+};
+
+
+// The traces outlive their threads: the events are written at exit
+static void keepThreadTrace( THREAD_TRACE* )
+{
+}
+
+
+static boost::mutex                             traceLock;
+static std::vector<THREAD_TRACE*>               threadTraces;
+static boost::thread_specific_ptr<THREAD_TRACE> currentTrace( keepThreadTrace );
+static std::string                              traceFileName;
+static uint64_t                                 traceOrigin;
+
+
+// Enables the tracing from the environment, and writes the trace file at exit.
+// Declared after the data above, so it is destroyed before them.
+static struct TRACE_EVENTS_WRITER
+{
+    TRACE_EVENTS_WRITER()
+    {
+        const char* fileName = getenv( "KICAD_TRACE_EVENTS" );
+
+        if( fileName && *fileName )
+            TRACE_EVENTS::Enable( fileName );
+    }
+
+    ~TRACE_EVENTS_WRITER()
+    {
+        TRACE_EVENTS::Write();
+
+        for( unsigned i = 0; i < threadTraces.size(); ++i )
+            delete threadTraces[i];
+
+        threadTraces.clear();
+    }
+} traceEventsWriter;
+
+
+void TRACE_EVENTS::Enable( const std::string& aFileName )
+{
+    boost::mutex::scoped_lock lock( traceLock );
+
+    traceFileName = aFileName;
+    traceOrigin = get_tics();
+    m_enabled = true;
+}
+
+
+void TRACE_EVENTS::Record( const char* aName, uint64_t aStart, uint64_t aEnd )
+{
+    THREAD_TRACE* trace = currentTrace.get();
+
+    if( !trace )
+    {
+        trace = new THREAD_TRACE;
+
+        boost::mutex::scoped_lock lock( traceLock );
+
+        trace->m_tid = threadTraces.size() + 1;
+        threadTraces.push_back( trace );
+        currentTrace.reset( trace );
+    }
+
+    TRACE_EVENT event = { aName, aStart, aEnd };
+    boost::mutex::scoped_lock lock( trace->m_lock );
+
+    trace->m_events.push_back( event );
+}
+
+
+bool TRACE_EVENTS::Write()
+{
+    boost::mutex::scoped_lock lock( traceLock );
+
+    if( !m_enabled )
+        return false;
+
+    FILE* file = fopen( traceFileName.c_str(), "w" );
+
+    if( !file )
+        return false;
+
+    const char* separator = "\n";
+
+    fprintf( file, "{ \"displayTimeUnit\": \"ms\", \"traceEvents\": [" );
+
+    for( unsigned i = 0; i < threadTraces.size(); ++i )
+    {
+        THREAD_TRACE* trace = threadTraces[i];
+        boost::mutex::scoped_lock eventsLock( trace->m_lock );
+
+        fprintf( file, "%s{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                       "\"args\": { \"name\": \"thread %d\" } }",
+                 separator, trace->m_tid, trace->m_tid );
+        separator = ",\n";
+
+        for( unsigned j = 0; j < trace->m_events.size(); ++j )
+        {
+            const TRACE_EVENT& event = trace->m_events[j];
+
+            // the events started before Enable() start at the origin
+            uint64_t start = event.m_start > traceOrigin ? event.m_start - traceOrigin : 0;
+
+            fprintf( file, "%s{ \"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                           "\"ts\": %llu, \"dur\": %llu }",
+                     separator, event.m_name, trace->m_tid, (unsigned long long) start,
+                     (unsigned long long) ( event.m_end - event.m_start ) );
+        }
+    }
+
+    fprintf( file, "\n] }\n" );
+
+    return fclose( file ) == 0;
+}
@@ -24,6 +24,7 @@
  */
 
 #include <boost/foreach.hpp>
+#include <map>
 
 #include <base_struct.h>
 #include <layers_id_colors_and_visibility.h>
@@ -34,6 +35,8 @@
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
+#include <frame_profiler.h>
+#include <trace_events.h>
 
 #ifdef __WXDEBUG__
 #include <profile.h>
@@ -52,6 +55,11 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_boundary.SetMaximum();
     m_needsUpdate.reserve( 32768 );
 
+    for( int i = 0; i < TARGETS_NUMBER; ++i )
+        m_damagedTargets[i] = false;
+
+    m_clipRedraw = false;
+
     // Redraw everything at the beginning
     MarkDirty();
 
@@ -94,6 +102,7 @@ void VIEW::Add( VIEW_ITEM* aItem )
 
     aItem->ViewGetLayers( layers, layers_count );
     aItem->saveLayers( layers, layers_count );
+    aItem->m_viewBBox = aItem->ViewBBox();
 
     if( m_dynamic )
         aItem->viewAssign( this );
@@ -102,10 +111,43 @@ void VIEW::Add( VIEW_ITEM* aItem )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        markTargetDamaged( l.target, aItem->m_viewBBox );
+    }
+
+    // The item has just been inserted with its current layers and bounding box,
+    // so only its geometry has to be cached
+    aItem->ViewUpdate( VIEW_ITEM::REPAINT );
+}
+
+
+void VIEW::AddItems( const std::vector<VIEW_ITEM*>& aItems )
+{
+    std::map<int, std::vector<VIEW_ITEM*> > layerItems;
+    int layers[VIEW_MAX_LAYERS], layers_count;
+
+    BOOST_FOREACH( VIEW_ITEM* item, aItems )
+    {
+        item->ViewGetLayers( layers, layers_count );
+        item->saveLayers( layers, layers_count );
+        item->m_viewBBox = item->ViewBBox();
+
+        if( m_dynamic )
+            item->viewAssign( this );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            layerItems[layers[i]].push_back( item );
+            markTargetDamaged( m_layers[layers[i]].target, item->m_viewBBox );
+        }
+
+        item->ViewUpdate( VIEW_ITEM::REPAINT );
     }
 
-    aItem->ViewUpdate( VIEW_ITEM::ALL );
+    for( std::map<int, std::vector<VIEW_ITEM*> >::const_iterator it = layerItems.begin();
+         it != layerItems.end(); ++it )
+    {
+        m_layers[it->first].items->BulkLoad( it->second );
+    }
 }
 
 
@@ -132,8 +174,8 @@ void VIEW::Remove( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Remove( aItem, aItem->m_viewBBox );
+        markTargetDamaged( l.target, aItem->m_viewBBox );
 
         // Clear the GAL cache
         int prevGroup = aItem->getGroup( layers[i] );
@@ -205,6 +247,93 @@ int VIEW::Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) con
 }
 
 
+struct VIEW::pickItem
+{
+    pickItem( VIEW* aView, int aLayer, std::map<VIEW_ITEM*, unsigned int>& aIds,
+              std::vector<VIEW_ITEM*>& aItems ) :
+        view( aView ), layer( aLayer ), ids( aIds ), items( aItems )
+    {
+    }
+
+    bool operator()( VIEW_ITEM* aItem )
+    {
+        // As drawItem, except that only the items already cached are drawn
+        int group = aItem->getGroup( layer );
+
+        if( group < 0 || !aItem->isRenderable() || aItem->ViewGetLOD( layer ) >= view->m_scale )
+            return true;
+
+        // An item has the same id on all its layers
+        std::map<VIEW_ITEM*, unsigned int>::iterator it = ids.find( aItem );
+        unsigned int id;
+
+        if( it != ids.end() )
+        {
+            id = it->second;
+        }
+        else
+        {
+            items.push_back( aItem );
+            id = items.size();
+            ids[aItem] = id;
+        }
+
+        view->m_gal->DrawGroupPicking( group, id );
+
+        return true;
+    }
+
+    VIEW* view;
+    int layer;
+    std::map<VIEW_ITEM*, unsigned int>& ids;
+    std::vector<VIEW_ITEM*>& items;
+};
+
+
+bool VIEW::Pick( const VECTOR2D& aPosition, int aRadius, std::vector<VIEW_ITEM*>& aResult )
+{
+    aResult.clear();
+
+    if( !m_gal->BeginPicking( aPosition, aRadius ) )
+        return false;
+
+    // The items near the window, one more pixel around it for the rounding
+    VECTOR2D corner( aRadius + 1, aRadius + 1 );
+    VECTOR2D start = ToWorld( aPosition - corner );
+    VECTOR2D end = ToWorld( aPosition + corner );
+    BOX2I rect( VECTOR2I( start ), VECTOR2I( end - start ) );
+
+    rect.Normalize();
+
+    std::map<VIEW_ITEM*, unsigned int> ids;
+    std::vector<VIEW_ITEM*> items;
+
+    BOOST_FOREACH( VIEW_LAYER* l, m_orderedLayers )
+    {
+        // The other targets are drawn again at every frame, their items are not kept
+        if( l->visible && !l->displayOnly && IsCached( l->id )
+                && areRequiredLayersEnabled( l->id ) )
+        {
+            pickItem pickFunc( this, l->id, ids, items );
+
+            l->items->Query( rect, pickFunc );
+        }
+    }
+
+    std::vector<unsigned int> shown;
+
+    m_gal->EndPicking( shown );
+
+    for( unsigned int i = 0; i < shown.size(); ++i )
+    {
+        if( shown[i] <= items.size() )
+            aResult.push_back( items[shown[i] - 1] );
+    }
+
+    return true;
+}
+
+
 VECTOR2D VIEW::ToWorld( const VECTOR2D& aCoord, bool aAbsolute ) const
 {
     const MATRIX3x3D& matrix = m_gal->GetScreenWorldMatrix();
@@ -618,9 +747,12 @@ void VIEW::redrawRect( const BOX2I& aRect )
         {
             drawItem drawFunc( this, l->id );
 
+            // Outside of the clipped area, the previous contents of the targets are kept
+            bool clipped = m_clipRedraw && l->target != TARGET_OVERLAY;
+
             m_gal->SetTarget( l->target );
             m_gal->SetLayerDepth( l->renderingOrder );
-            l->items->Query( aRect, drawFunc );
+            l->items->Query( clipped ? m_clipArea : aRect, drawFunc );
         }
     }
 }
@@ -628,6 +760,10 @@ void VIEW::redrawRect( const BOX2I& aRect )
 
 void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
 {
+    FRAME_PROFILER& profiler = FRAME_PROFILER::Instance();
+
+    profiler.AddCount( FRAME_PROFILER::DRAWN_ITEMS );
+
     if( IsCached( aLayer ) && !aImmediate )
     {
         // Draw using cached information or create one
@@ -639,6 +775,9 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
         }
         else
         {
+            FRAME_PROFILER_TIMER paintTimer( FRAME_PROFILER::PAINT );
+            profiler.AddCount( FRAME_PROFILER::PAINTED_ITEMS );
+
             group = m_gal->BeginGroup();
             aItem->setGroup( aLayer, group );
 
@@ -651,6 +790,9 @@ void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
     else
     {
         // Immediate mode
+        FRAME_PROFILER_TIMER paintTimer( FRAME_PROFILER::PAINT );
+        profiler.AddCount( FRAME_PROFILER::PAINTED_ITEMS );
+
         if( !m_painter->Draw( aItem, aLayer ) )
             aItem->ViewDraw( aLayer, m_gal );  // Alternative drawing method
     }
@@ -710,7 +852,7 @@ struct VIEW::recacheItem
             gal->DeleteGroup( group );
 
         aItem->setGroup( layer, -1 );
-        aItem->ViewUpdate( VIEW_ITEM::ALL );
+        aItem->ViewUpdate( VIEW_ITEM::REPAINT );
 
         return true;
     }
@@ -749,14 +891,38 @@ void VIEW::Clear()
 
 void VIEW::ClearTargets()
 {
+    m_clipRedraw = false;
+
     if( IsTargetDirty( TARGET_CACHED ) || IsTargetDirty( TARGET_NONCACHED ) )
     {
+        // Unless one of the targets is dirty as a whole, only their damaged areas are
+        // cleared and redrawn, if the GAL is able to clip them
+        if( !m_dirtyTargets[TARGET_CACHED] && !m_dirtyTargets[TARGET_NONCACHED] )
+        {
+            m_clipArea = m_damagedAreas[m_damagedTargets[TARGET_CACHED] ? TARGET_CACHED
+                                                                         : TARGET_NONCACHED];
+
+            if( m_damagedTargets[TARGET_CACHED] && m_damagedTargets[TARGET_NONCACHED] )
+                m_clipArea.Merge( m_damagedAreas[TARGET_NONCACHED] );
+
+            m_clipRedraw = m_gal->SetClipRect( VECTOR2D( m_clipArea.GetOrigin() ),
+                                               VECTOR2D( m_clipArea.GetEnd() ) );
+        }
+
         // TARGET_CACHED and TARGET_NONCACHED have to be redrawn together, as they contain
         // layers that rely on each other (eg. netnames are noncached, but tracks - are cached)
         m_gal->ClearTarget( TARGET_NONCACHED );
         m_gal->ClearTarget( TARGET_CACHED );
 
-        MarkDirty();
+        if( m_clipRedraw )
+        {
+            m_damagedTargets[TARGET_CACHED] = true;
+            m_damagedTargets[TARGET_NONCACHED] = true;
+        }
+        else
+        {
+            MarkDirty();
+        }
     }
 
     if( IsTargetDirty( TARGET_OVERLAY ) )
@@ -768,11 +934,15 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
+    TRACE_SCOPE( "VIEW::Redraw" );
+
 #ifdef __WXDEBUG__
     prof_counter totalRealTime;
     prof_start( &totalRealTime );
 #endif /* __WXDEBUG__ */
 
+    FRAME_PROFILER_TIMER redrawTimer( FRAME_PROFILER::REDRAW );
+
     VECTOR2D screenSize = m_gal->GetScreenPixelSize();
     BOX2I    rect( ToWorld( VECTOR2D( 0, 0 ) ),
                    ToWorld( screenSize ) - ToWorld( VECTOR2D( 0, 0 ) ) );
@@ -784,6 +954,7 @@ void VIEW::Redraw()
     markTargetClean( TARGET_CACHED );
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
+    m_clipRedraw = false;
 
 #ifdef __WXDEBUG__
     prof_end( &totalRealTime );
@@ -849,20 +1020,39 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
 
         if( IsCached( layerId ) )
         {
-            if( aUpdateFlags & ( VIEW_ITEM::GEOMETRY | VIEW_ITEM::LAYERS ) )
+            if( aUpdateFlags & ( VIEW_ITEM::GEOMETRY | VIEW_ITEM::LAYERS | VIEW_ITEM::REPAINT ) )
                 updateItemGeometry( aItem, layerId );
             else if( aUpdateFlags & VIEW_ITEM::COLOR )
                 updateItemColor( aItem, layerId );
         }
 
-        // Mark those layers as dirty, so the VIEW will be refreshed
-        MarkTargetDirty( m_layers[layerId].target );
+        // Mark the item area as damaged, so the VIEW will be refreshed
+        markTargetDamaged( m_layers[layerId].target, aItem->m_viewBBox );
     }
 
     aItem->clearUpdateFlags();
 }
 
 
+void VIEW::markTargetDamaged( int aTarget, const BOX2I& aArea )
+{
+    wxASSERT( aTarget < TARGETS_NUMBER );
+
+    if( m_dirtyTargets[aTarget] )
+        return;
+
+    if( m_damagedTargets[aTarget] )
+    {
+        m_damagedAreas[aTarget].Merge( aArea );
+    }
+    else
+    {
+        m_damagedAreas[aTarget] = aArea;
+        m_damagedTargets[aTarget] = true;
+    }
+}
+
+
 void VIEW::sortLayers()
 {
     int n = 0;
@@ -925,12 +1115,16 @@ void VIEW::updateBbox( VIEW_ITEM* aItem )
 
     aItem->ViewGetLayers( layers, layers_count );
 
+    // The area previously covered by the item has to be redrawn too
+    const BOX2I oldBBox = aItem->m_viewBBox;
+    aItem->m_viewBBox = aItem->ViewBBox();
+
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
+        l.items->Remove( aItem, oldBBox );
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        markTargetDamaged( l.target, oldBBox );
     }
 }
 
@@ -945,8 +1139,8 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        MarkTargetDirty( l.target );
+        l.items->Remove( aItem, aItem->m_viewBBox );
+        markTargetDamaged( l.target, aItem->m_viewBBox );
 
         if( IsCached( l.id ) )
         {
@@ -964,12 +1158,13 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     aItem->saveLayers( layers, layers_count );
+    aItem->m_viewBBox = aItem->ViewBBox();
 
     for( int i = 0; i < layers_count; i++ )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
         l.items->Insert( aItem );
-        MarkTargetDirty( l.target );
+        markTargetDamaged( l.target, aItem->m_viewBBox );
     }
 }
 
@@ -1013,6 +1208,8 @@ void VIEW::RecacheAllItems()
 
 void VIEW::UpdateItems()
 {
+    FRAME_PROFILER_TIMER updateTimer( FRAME_PROFILER::UPDATE_ITEMS );
+
     m_gal->BeginUpdate();
 
     BOOST_FOREACH( VIEW_ITEM* item, m_needsUpdate )
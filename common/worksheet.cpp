@@ -55,7 +55,9 @@ void DrawPageLayout( wxDC* aDC, EDA_RECT* aClipBox,
                      int aPenWidth, double aScalar,
                      EDA_COLOR_T aColor, EDA_COLOR_T aAltColor )
 {
-    WS_DRAW_ITEM_LIST drawList;
+    // Kept from one redraw to the next, its items are built again only when the page,
+    // its title block or inscriptions, or the page layout change
+    static WS_DRAW_ITEM_LIST drawList;
 
     drawList.SetPenSize( aPenWidth );
     drawList.SetMilsToIUfactor( aScalar );
@@ -34,6 +34,8 @@
 #include <id.h>
 #include <class_drawpanel.h>
 #include <view/view.h>
+#include <class_draw_panel_gal.h>
+#include <gal/graphics_abstraction_layer.h>
 #include <class_base_screen.h>
 #include <draw_frame.h>
 #include <kicad_device_context.h>
@@ -91,8 +93,19 @@ void EDA_DRAW_FRAME::Zoom_Automatique( bool aWarpPointer )
 
     if( !IsGalCanvasActive() )
         RedrawScreen( GetScrollCenterPosition(), aWarpPointer );
-    else
+    else if( m_toolManager )
         m_toolManager->RunAction( "common.Control.zoomFitScreen", true );
+    else
+    {
+        // No tools to zoom the GAL canvas: convert the legacy zoom, as in UseGalCanvas()
+        KIGFX::GAL* gal = GetGalCanvas()->GetGAL();
+        KIGFX::VIEW* view = GetGalCanvas()->GetView();
+        double zoomFactor = gal->GetWorldScale() / gal->GetZoomFactor();
+
+        view->SetScale( 1.0 / ( zoomFactor * bestzoom ) );
+        view->SetCenter( VECTOR2D( GetScrollCenterPosition() ) );
+        GetGalCanvas()->Refresh();
+    }
 }
 
 
@@ -39,6 +39,7 @@
 #include <pgm_base.h>
 #include <kicad_string.h>
 #include <macros.h>
+#include <hashtables.h>
 
 #include <cvpcb.h>
 #include <cvpcb_mainframe.h>
@@ -75,10 +76,16 @@ wxString GetQuotedText( wxString & text )
 // (m_ComponentValue member)
 bool sortListbyCmpValue( const FOOTPRINT_EQUIVALENCE& ref, const FOOTPRINT_EQUIVALENCE& test )
 {
-    return ref.m_ComponentValue.Cmp( test.m_ComponentValue ) >= 0;
+    // std::sort() needs a strict ordering
+    return ref.m_ComponentValue.Cmp( test.m_ComponentValue ) > 0;
 }
 
 
+// The equivalences of each component value, by their index in the sorted list.  The
+// component values are matched case insensitively.
+typedef boost::unordered_map< wxString, std::vector<unsigned>, WXSTRING_HASH > EQUIVALENCE_INDEX;
+
+
 // read the .equ files and populate the list of equivalents
 int CVPCB_MAINFRAME::buildEquivalenceList( FOOTPRINT_EQUIVALENCE_LIST& aList, wxString * aErrorMessages )
 {
@@ -184,6 +191,11 @@ void CVPCB_MAINFRAME::AutomaticFootprintMatching( wxCommandEvent& event )
     // having the same component value) is more easy.
     std::sort( equiv_List.begin(), equiv_List.end(), sortListbyCmpValue );
 
+    EQUIVALENCE_INDEX equivIndex;
+
+    for( unsigned idx = 0; idx < equiv_List.size(); idx++ )
+        equivIndex[equiv_List[idx].m_ComponentValue.Lower()].push_back( idx );
+
     // Display the number of footprint/component equivalences.
     msg.Printf( _( "%lu footprint/cmp equivalences found." ), (unsigned long)equiv_List.size() );
     SetStatusText( msg, 0 );
@@ -208,14 +220,15 @@ void CVPCB_MAINFRAME::AutomaticFootprintMatching( wxCommandEvent& event )
         // When happens, using the footprint filter of components can remove the ambiguity by
         // filtering equivItem so one can use multiple equiv_List (for polar and
         // non-polar caps for example)
-        for( unsigned idx = 0; idx < equiv_List.size(); idx++ )
+        EQUIVALENCE_INDEX::const_iterator equivs = equivIndex.find( component->GetValue().Lower() );
+
+        for( unsigned ll = 0; equivs != equivIndex.end() && ll < equivs->second.size(); ll++ )
         {
+            unsigned idx = equivs->second[ll];
             FOOTPRINT_EQUIVALENCE& equivItem = equiv_List[idx];
 
-            if( equivItem.m_ComponentValue.CmpNoCase( component->GetValue() ) != 0 )
-                continue;
-
-            const FOOTPRINT_INFO *module = m_FootprintsList.GetModuleInfo( equivItem.m_FootprintFPID );
+            const FOOTPRINT_INFO *module =
+                    m_FootprintsFilterIndex.GetModuleInfo( equivItem.m_FootprintFPID );
 
             bool equ_is_unique = true;
             unsigned next = idx+1;
@@ -277,7 +290,8 @@ void CVPCB_MAINFRAME::AutomaticFootprintMatching( wxCommandEvent& event )
         {
             // we do not need to analyze wildcards: single footprint do not
             // contain them and if there are wildcards it just will not match any
-            const FOOTPRINT_INFO* module = m_FootprintsList.GetModuleInfo( component->GetFootprintFilters()[0] );
+            const FOOTPRINT_INFO* module =
+                    m_FootprintsFilterIndex.GetModuleInfo( component->GetFootprintFilters()[0] );
 
             if( module )
                 SetNewPkg( component->GetFootprintFilters()[0] );
@@ -497,7 +497,7 @@ void DISPLAY_FOOTPRINTS_FRAME::InitDisplay()
 
         SetTitle( msg );
         const FOOTPRINT_INFO* module_info =
-                parentframe->m_FootprintsList.GetModuleInfo( footprintName );
+                parentframe->m_FootprintsFilterIndex.GetModuleInfo( footprintName );
 
         const wxChar* libname;
 
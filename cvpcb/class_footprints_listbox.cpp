@@ -34,7 +34,7 @@
 #include <cvpcb_mainframe.h>
 #include <listview_classes.h>
 #include <cvpcb_id.h>
-#include <eda_pattern_match.h>
+#include <footprint_filter_index.h>
 
 
 FOOTPRINTS_LISTBOX::FOOTPRINTS_LISTBOX( CVPCB_MAINFRAME* parent,
@@ -124,7 +124,7 @@ void FOOTPRINTS_LISTBOX::SetSelection( int index, bool State )
 }
 
 
-void FOOTPRINTS_LISTBOX::SetFootprints( FOOTPRINT_LIST& aList, const wxString& aLibName,
+void FOOTPRINTS_LISTBOX::SetFootprints( FOOTPRINT_FILTER_INDEX& aIndex, const wxString& aLibName,
                                         COMPONENT* aComponent,
                                         const wxString &aFootPrintFilterPattern,
                                         int aFilterType )
@@ -133,51 +133,22 @@ void FOOTPRINTS_LISTBOX::SetFootprints( FOOTPRINT_LIST& aList, const wxString& a
     wxString        msg;
     wxString        oldSelection;
 
-    EDA_PATTERN_MATCH_WILDCARD patternFilter;
-    patternFilter.SetPattern( aFootPrintFilterPattern.Lower() );    // Use case insensitive search
-
     if( GetSelection() >= 0 && GetSelection() < (int)m_footprintList.GetCount() )
         oldSelection = m_footprintList[ GetSelection() ];
 
-    for( unsigned ii = 0; ii < aList.GetCount(); ii++ )
-    {
-        if( aFilterType == UNFILTERED_FP_LIST )
-        {
-            msg.Printf( wxT( "%3d %s:%s" ), int( newList.GetCount() + 1 ),
-                        GetChars( aList.GetItem( ii ).GetNickname() ),
-                        GetChars( aList.GetItem( ii ).GetFootprintName() ) );
-            newList.Add( msg );
-            continue;
-        }
-
-        if( (aFilterType & FILTERING_BY_LIBRARY) && !aLibName.IsEmpty()
-            && !aList.GetItem( ii ).InLibrary( aLibName ) )
-            continue;
+    FOOTPRINT_FILTER_INDEX::ITEMS items;
 
-        if( (aFilterType & FILTERING_BY_COMPONENT_KEYWORD) && aComponent
-            && !aComponent->MatchesFootprintFilters( aList.GetItem( ii ).GetFootprintName() ) )
-            continue;
+    aIndex.Filter( aLibName, aComponent, aFootPrintFilterPattern, aFilterType, items );
 
-        if( (aFilterType & FILTERING_BY_PIN_COUNT) && aComponent
-            && aComponent->GetNetCount() != aList.GetItem( ii ).GetUniquePadCount() )
-            continue;
+    newList.Alloc( items.size() );
 
-        // We can search (Using case insensitive search) in full FPID or only
-        // in the fp name itself.
-        // After tests, only in the fp name itself looks better.
-        // However, the code to take in account the nickname is just commented, no removed.
-        wxString currname = //aList.GetItem( ii ).GetNickname().Lower() + ":" +
-                            aList.GetItem( ii ).GetFootprintName().Lower();
-
-        if( (aFilterType & FILTERING_BY_NAME) && !aFootPrintFilterPattern.IsEmpty()
-            && patternFilter.Find( currname ) == EDA_PATTERN_NOT_FOUND )
-        {
-            continue;
-        }
+    for( unsigned ii = 0; ii < items.size(); ii++ )
+    {
+        FOOTPRINT_INFO& fp = aIndex.GetList()->GetItem( items[ii] );
 
         msg.Printf( wxT( "%3d %s:%s" ), int( newList.GetCount() + 1 ),
-                    GetChars( aList.GetItem( ii ).GetNickname() ),
-                    GetChars( aList.GetItem( ii ).GetFootprintName() ) );
+                    GetChars( fp.GetNickname() ),
+                    GetChars( fp.GetFootprintName() ) );
         newList.Add( msg );
     }
 
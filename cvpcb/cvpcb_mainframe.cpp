@@ -455,7 +455,8 @@ void CVPCB_MAINFRAME::OnEditFootprintLibraryTable( wxCommandEvent& aEvent )
     {
         wxBusyCursor dummy;
         BuildLIBRARY_LISTBOX();
-        m_FootprintsList.ReadFootprintFiles( Prj().PcbFootprintLibs() );
+        m_FootprintsList = Prj().PcbFootprintList();
+        m_FootprintsFilterIndex.Build( *m_FootprintsList );
     }
 }
 
@@ -488,7 +489,7 @@ void CVPCB_MAINFRAME::OnSelectComponent( wxListEvent& event )
     COMPONENT* component = GetSelectedComponent();
     libraryName = m_libListBox->GetSelectedLibrary();
 
-    m_footprintListBox->SetFootprints( m_FootprintsList, libraryName, component,
+    m_footprintListBox->SetFootprints( m_FootprintsFilterIndex, libraryName, component,
                                        m_currentSearchPattern, m_filteringOptions);
 
     refreshAfterComponentSearch (component);
@@ -663,7 +664,7 @@ void CVPCB_MAINFRAME::DisplayStatus()
     {
         wxString footprintName = GetSelectedFootprint();
 
-        FOOTPRINT_INFO* module = m_FootprintsList.GetModuleInfo( footprintName );
+        FOOTPRINT_INFO* module = m_FootprintsFilterIndex.GetModuleInfo( footprintName );
 
         if( module )    // can be NULL if no netlist loaded
         {
@@ -734,12 +735,14 @@ bool CVPCB_MAINFRAME::LoadFootprintFiles()
     {
     wxBusyCursor dummy;  // Let the user know something is happening.
 
-    m_FootprintsList.ReadFootprintFiles( fptbl );
+    // Read once for all the frames of the project, and again only if modified
+    m_FootprintsList = Prj().PcbFootprintList();
+    m_FootprintsFilterIndex.Build( *m_FootprintsList );
     }
 
-    if( m_FootprintsList.GetErrorCount() )
+    if( m_FootprintsList->GetErrorCount() )
     {
-        m_FootprintsList.DisplayErrors( this );
+        m_FootprintsList->DisplayErrors( this );
     }
 
     return true;
@@ -867,7 +870,7 @@ void CVPCB_MAINFRAME::BuildFOOTPRINTS_LISTBOX()
                                              wxFONTWEIGHT_NORMAL ) );
     }
 
-    m_footprintListBox->SetFootprints( m_FootprintsList, wxEmptyString, NULL,
+    m_footprintListBox->SetFootprints( m_FootprintsFilterIndex, wxEmptyString, NULL,
                     wxEmptyString, FOOTPRINTS_LISTBOX::UNFILTERED_FP_LIST );
     DisplayStatus();
 }
@@ -37,6 +37,7 @@
 #include <wxBasePcbFrame.h>
 #include <config_params.h>
 #include <autosel.h>
+#include <footprint_filter_index.h>
 
 
 /*  Forward declarations of all top-level window classes. */
@@ -72,7 +73,8 @@ public:
     wxArrayString             m_ModuleLibNames;
     wxArrayString             m_EquFilesNames;
     wxString                  m_DocModulesFileName;
-    FOOTPRINT_LIST            m_FootprintsList;
+    boost::shared_ptr<FOOTPRINT_LIST> m_FootprintsList;   ///< see PROJECT::PcbFootprintList()
+    FOOTPRINT_FILTER_INDEX    m_FootprintsFilterIndex;  ///< rebuilt when m_FootprintsList is read
 
 protected:
     int             m_undefinedComponentCnt;
@@ -0,0 +1,232 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_filter_index.cpp
+ */
+
+#include <algorithm>
+#include <iterator>
+
+#include <fctsys.h>
+#include <footprint_info.h>
+#include <fpid.h>
+#include <pcb_netlist.h>
+#include <eda_pattern_match.h>
+
+#include <listview_classes.h>
+#include <footprint_filter_index.h>
+
+
+static bool fewerItems( const FOOTPRINT_FILTER_INDEX::ITEMS* aA,
+                        const FOOTPRINT_FILTER_INDEX::ITEMS* aB )
+{
+    return aA->size() < aB->size();
+}
+
+
+void FOOTPRINT_FILTER_INDEX::Build( FOOTPRINT_LIST& aList )
+{
+    m_list = &aList;
+    m_upperNames.clear();
+    m_lowerNames.clear();
+    m_fpids.clear();
+    m_libraries.clear();
+    m_filterSets.clear();
+    m_padCounts.clear();
+    m_padCountsBuilt = false;
+
+    m_upperNames.reserve( aList.GetCount() );
+    m_lowerNames.reserve( aList.GetCount() );
+
+    for( unsigned ii = 0; ii < aList.GetCount(); ii++ )
+    {
+        const FOOTPRINT_INFO& fp = aList.GetItem( ii );
+
+        m_upperNames.push_back( std::make_pair( fp.GetFootprintName().Upper(), ii ) );
+        m_lowerNames.push_back( fp.GetFootprintName().Lower() );
+
+        // the first of the footprints with the same FPID is the one found
+        m_fpids.insert( std::make_pair( fp.GetNickname() + wxT( ':' ) + fp.GetFootprintName(),
+                                        ii ) );
+        m_libraries[fp.GetNickname()].push_back( ii );
+    }
+
+    std::sort( m_upperNames.begin(), m_upperNames.end() );
+}
+
+
+FOOTPRINT_INFO* FOOTPRINT_FILTER_INDEX::GetModuleInfo( const wxString& aFootprintName ) const
+{
+    if( !m_list || aFootprintName.IsEmpty() )
+        return NULL;
+
+    FPID fpid;
+
+    wxCHECK_MSG( fpid.Parse( aFootprintName ) < 0, NULL,
+                 wxString::Format( wxT( "'%s' is not a valid FPID." ),
+                                   GetChars( aFootprintName ) ) );
+
+    wxString libNickname   = fpid.GetLibNickname();
+    wxString footprintName = fpid.GetFootprintName();
+
+    // A nickname has no ':', the key of a FPID is unique
+    wxString key = libNickname + wxT( ':' ) + footprintName;
+
+    boost::unordered_map< wxString, unsigned, WXSTRING_HASH >::const_iterator it =
+            m_fpids.find( key );
+
+    return it != m_fpids.end() ? &m_list->GetItem( it->second ) : NULL;
+}
+
+
+const FOOTPRINT_FILTER_INDEX::ITEMS& FOOTPRINT_FILTER_INDEX::filterItems(
+        const wxArrayString& aFilters )
+{
+    // The matching is case insensitive, as COMPONENT::MatchesFootprintFilters()
+    wxString key;
+
+    for( unsigned ii = 0; ii < aFilters.GetCount(); ii++ )
+        key << aFilters[ii].Upper() << wxT( '\n' );
+
+    ITEMS_MAP::iterator it = m_filterSets.find( key );
+
+    if( it != m_filterSets.end() )
+        return it->second;
+
+    ITEMS& items = m_filterSets[key];
+
+    for( unsigned ii = 0; ii < aFilters.GetCount(); ii++ )
+    {
+        wxString filter = aFilters[ii].Upper();
+
+        // A matching name starts with the characters of the filter before its first
+        // wildcard: only the sorted names starting so are matched against the filter
+        wxString prefix = filter.substr( 0, filter.find_first_of( wxT( "*?" ) ) );
+
+        std::vector< std::pair<wxString, unsigned> >::const_iterator name =
+                std::lower_bound( m_upperNames.begin(), m_upperNames.end(),
+                                  std::make_pair( prefix, 0u ) );
+
+        for( ; name != m_upperNames.end() && name->first.StartsWith( prefix ); ++name )
+        {
+            if( name->first.Matches( filter ) )
+                items.push_back( name->second );
+        }
+    }
+
+    std::sort( items.begin(), items.end() );
+    items.erase( std::unique( items.begin(), items.end() ), items.end() );
+
+    return items;
+}
+
+
+const FOOTPRINT_FILTER_INDEX::ITEMS& FOOTPRINT_FILTER_INDEX::padCountItems( int aPadCount )
+{
+    // The pad counts of the footprints not in the footprint index need them loaded
+    if( !m_padCountsBuilt )
+    {
+        m_padCounts.clear();
+
+        for( unsigned ii = 0; ii < m_list->GetCount(); ii++ )
+            m_padCounts[m_list->GetItem( ii ).GetUniquePadCount()].push_back( ii );
+
+        m_padCountsBuilt = true;
+    }
+
+    std::map<int, ITEMS>::const_iterator it = m_padCounts.find( aPadCount );
+
+    return it != m_padCounts.end() ? it->second : m_none;
+}
+
+
+void FOOTPRINT_FILTER_INDEX::Filter( const wxString& aLibName, const COMPONENT* aComponent,
+                                     const wxString& aPattern, int aFilterType, ITEMS& aItems )
+{
+    aItems.clear();
+
+    if( !m_list )
+        return;
+
+    // The footprints meeting each criterion, intersected from the smallest set
+    std::vector<const ITEMS*> sets;
+
+    if( ( aFilterType & FOOTPRINTS_LISTBOX::FILTERING_BY_LIBRARY ) && !aLibName.IsEmpty() )
+    {
+        ITEMS_MAP::const_iterator it = m_libraries.find( aLibName );
+
+        sets.push_back( it != m_libraries.end() ? &it->second : &m_none );
+    }
+
+    if( ( aFilterType & FOOTPRINTS_LISTBOX::FILTERING_BY_COMPONENT_KEYWORD ) && aComponent
+        && aComponent->GetFootprintFilters().GetCount() )
+    {
+        sets.push_back( &filterItems( aComponent->GetFootprintFilters() ) );
+    }
+
+    if( ( aFilterType & FOOTPRINTS_LISTBOX::FILTERING_BY_PIN_COUNT ) && aComponent )
+        sets.push_back( &padCountItems( aComponent->GetNetCount() ) );
+
+    if( sets.empty() )
+    {
+        aItems.resize( m_lowerNames.size() );
+
+        for( unsigned ii = 0; ii < aItems.size(); ii++ )
+            aItems[ii] = ii;
+    }
+    else
+    {
+        std::sort( sets.begin(), sets.end(), fewerItems );
+
+        aItems = *sets[0];
+
+        for( unsigned ii = 1; ii < sets.size() && !aItems.empty(); ii++ )
+        {
+            ITEMS common;
+
+            std::set_intersection( aItems.begin(), aItems.end(),
+                                   sets[ii]->begin(), sets[ii]->end(),
+                                   std::back_inserter( common ) );
+            aItems.swap( common );
+        }
+    }
+
+    // The names are searched last, in the footprints left only.  The search is in the
+    // footprint name itself, which looked better than in the full FPID.
+    if( ( aFilterType & FOOTPRINTS_LISTBOX::FILTERING_BY_NAME ) && !aPattern.IsEmpty() )
+    {
+        EDA_PATTERN_MATCH_WILDCARD patternFilter;
+        patternFilter.SetPattern( aPattern.Lower() );    // Use case insensitive search
+
+        unsigned count = 0;
+
+        for( unsigned ii = 0; ii < aItems.size(); ii++ )
+        {
+            if( patternFilter.Find( m_lowerNames[aItems[ii]] ) != EDA_PATTERN_NOT_FOUND )
+                aItems[count++] = aItems[ii];
+        }
+
+        aItems.resize( count );
+    }
+}
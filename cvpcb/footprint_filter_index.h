@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_filter_index.h
+ */
+
+#ifndef FOOTPRINT_FILTER_INDEX_H
+#define FOOTPRINT_FILTER_INDEX_H
+
+#include <map>
+#include <vector>
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+#include <hashtables.h>
+
+class COMPONENT;
+class FOOTPRINT_INFO;
+class FOOTPRINT_LIST;
+
+
+/**
+ * Class FOOTPRINT_FILTER_INDEX
+ * holds the footprints of a FOOTPRINT_LIST grouped by library, sorted by their case
+ * folded names and, once pin count filtering is used, grouped by pad count, so that
+ * filtering the list for another component does not test the whole list again.  The
+ * footprints are also indexed by FPID.
+ *
+ * The footprints matching the footprint filters of a component are kept by filter set,
+ * the components of a same kind share them.  The index is rebuilt each time the list
+ * is read.
+ */
+class FOOTPRINT_FILTER_INDEX
+{
+public:
+    typedef std::vector<unsigned> ITEMS;    ///< indexes in the list, in increasing order
+
+    FOOTPRINT_FILTER_INDEX() :
+        m_list( NULL ),
+        m_padCountsBuilt( false )
+    {
+    }
+
+    /**
+     * Function Build
+     * indexes the footprints of @a aList, which must not change before the next Build().
+     */
+    void Build( FOOTPRINT_LIST& aList );
+
+    FOOTPRINT_LIST* GetList() const { return m_list; }
+
+    /**
+     * Function GetModuleInfo
+     * returns the footprint of the FPID @a aFootprintName, as FOOTPRINT_LIST::GetModuleInfo()
+     * does, without searching the list.
+     */
+    FOOTPRINT_INFO* GetModuleInfo( const wxString& aFootprintName ) const;
+
+    /**
+     * Function Filter
+     * returns in @a aItems the footprints meeting the criteria of FOOTPRINTS_LISTBOX,
+     * with the same results as testing each footprint of the list.
+     *
+     * @param aLibName is the library of FILTERING_BY_LIBRARY, or empty.
+     * @param aComponent is the component of FILTERING_BY_COMPONENT_KEYWORD and
+     *                   FILTERING_BY_PIN_COUNT, or NULL.
+     * @param aPattern is the footprint name pattern of FILTERING_BY_NAME, or empty.
+     * @param aFilterType is the set of FOOTPRINTS_LISTBOX filtering flags.
+     */
+    void Filter( const wxString& aLibName, const COMPONENT* aComponent,
+                 const wxString& aPattern, int aFilterType, ITEMS& aItems );
+
+private:
+    typedef boost::unordered_map< wxString, ITEMS, WXSTRING_HASH > ITEMS_MAP;
+
+    ///> the footprints matching at least one of the filters @a aFilters
+    const ITEMS& filterItems( const wxArrayString& aFilters );
+
+    ///> the footprints with @a aPadCount unique pads
+    const ITEMS& padCountItems( int aPadCount );
+
+    FOOTPRINT_LIST*         m_list;
+
+    /// the upper case names of the footprints, and their index, sorted by name
+    std::vector< std::pair<wxString, unsigned> > m_upperNames;
+
+    /// the lower case names of the footprints, in the order of the list
+    std::vector<wxString>   m_lowerNames;
+
+    /// the index of the footprints by their FPID
+    boost::unordered_map< wxString, unsigned, WXSTRING_HASH > m_fpids;
+
+    ITEMS_MAP               m_libraries;        ///< the footprints by library nickname
+    ITEMS_MAP               m_filterSets;       ///< see filterItems()
+
+    bool                    m_padCountsBuilt;
+    std::map<int, ITEMS>    m_padCounts;        ///< the footprints by unique pad count
+
+    const ITEMS             m_none;
+};
+
+#endif  // FOOTPRINT_FILTER_INDEX_H
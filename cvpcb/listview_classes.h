@@ -34,7 +34,7 @@
 /*  Forward declarations of all top-level window classes. */
 class CVPCB_MAINFRAME;
 class COMPONENT;
-class FOOTPRINT_LIST;
+class FOOTPRINT_FILTER_INDEX;
 
 #define LISTBOX_STYLE     ( wxSUNKEN_BORDER | wxLC_NO_HEADER | wxLC_REPORT | wxLC_VIRTUAL | \
                             wxVSCROLL | wxHSCROLL )
@@ -114,14 +114,14 @@ public:
      * populates the wxListCtrl with the footprints from \a aList that meet the filter
      * criteria defined by \a aFilterType.
      *
-     * @param aList is a #FOOTPRINT_LIST item containing the footprints.
+     * @param aIndex is the #FOOTPRINT_FILTER_INDEX of the list of footprints.
      * @param aLibName is wxString containing the name of the selected library.  Can be
      *                 wxEmptyString.
      * @param aComponent is the #COMPONENT used by the filtering criteria.  Can be NULL.
      * @param aFootPrintFilterPattern = a filter used to filter list by names
      * @param aFilterType defines the criteria to filter \a aList.
      */
-    void     SetFootprints( FOOTPRINT_LIST& aList, const wxString& aLibName,
+    void     SetFootprints( FOOTPRINT_FILTER_INDEX& aIndex, const wxString& aLibName,
                             COMPONENT* aComponent, const wxString &aFootPrintFilterPattern, int aFilterType );
 
     wxString GetSelectedFootprint();
@@ -0,0 +1,363 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file batch_job.cpp
+ * @brief The command line job of Eeschema: ERC and netlist without GUI.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fctsys.h>
+#include <common.h>
+#include <macros.h>
+#include <confirm.h>
+#include <profile.h>
+#include <reporter.h>
+#include <wildcards_and_files_ext.h>
+#include <schframe.h>
+
+#include <netlist.h>
+#include <class_netlist_object.h>
+#include <class_sch_screen.h>
+#include <sch_marker.h>
+#include <sch_sheet.h>
+#include <sch_sheet_path.h>
+#include <erc.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+// The exit status of the job
+#define BATCH_OK            0
+#define BATCH_FAILED        1
+#define BATCH_ERC_ERRORS    2
+
+/// The time of each phase of the job, in milliseconds
+typedef std::vector< std::pair< std::string, double > > BATCH_TIMINGS;
+
+
+static void batchUsage()
+{
+    fprintf( stderr, "usage: eeschema --batch [--erc <report.json>] "
+                     "[--netlist <file> [--format kicad|orcadpcb2|cadstar|spice]] "
+                     "<schematic.sch>\n" );
+}
+
+
+static int netlistFormat( const wxString& aName )
+{
+    if( aName == wxT( "kicad" ) )
+        return NET_TYPE_PCBNEW;
+    else if( aName == wxT( "orcadpcb2" ) )
+        return NET_TYPE_ORCADPCB2;
+    else if( aName == wxT( "cadstar" ) )
+        return NET_TYPE_CADSTAR;
+    else if( aName == wxT( "spice" ) )
+        return NET_TYPE_SPICE;
+
+    return NET_TYPE_UNINIT;
+}
+
+
+static void endPhase( BATCH_TIMINGS& aTimings, const char* aName, prof_counter& aCounter )
+{
+    prof_end( &aCounter );
+
+    printf( "%-12s %10.1f ms\n", aName, aCounter.msecs() );
+    fflush( stdout );
+
+    aTimings.push_back( std::make_pair( std::string( aName ), (double) aCounter.msecs() ) );
+}
+
+
+static wxString jsonString( const wxString& aText )
+{
+    wxString json = wxT( "\"" );
+
+    for( wxString::const_iterator it = aText.begin(); it != aText.end(); ++it )
+    {
+        wxUint32 ch = (*it).GetValue();
+
+        if( ch == '"' )
+            json += wxT( "\\\"" );
+        else if( ch == '\\' )
+            json += wxT( "\\\\" );
+        else if( ch == '\n' )
+            json += wxT( "\\n" );
+        else if( ch < 0x20 )
+            json += wxString::Format( wxT( "\\u%04x" ), ch );
+        else
+            json += *it;
+    }
+
+    return json + wxT( "\"" );
+}
+
+
+static wxString jsonItem( const wxString& aText, const wxPoint& aPos )
+{
+    return wxString::Format( wxT( "{ \"description\": %s, \"x_mils\": %d, \"y_mils\": %d }" ),
+                             GetChars( jsonString( aText ) ), aPos.x, aPos.y );
+}
+
+
+/**
+ * Function writeErcReport
+ * writes the ERC markers of the schematic to the JSON file @a aFileName, like
+ * WriteDiagnosticERC() writes the .erc report.
+ * @param aErrorCount [out] is the number of markers of severity error
+ * @param aWarningCount [out] is the number of markers of severity warning
+ * @return true if the file was written.
+ */
+static bool writeErcReport( const wxString& aFileName, const wxString& aSchematic,
+                            const BATCH_TIMINGS& aTimings, int* aErrorCount, int* aWarningCount )
+{
+    wxString violations;
+    SCH_SHEET_LIST sheetList( g_RootSheet );
+
+    *aErrorCount = *aWarningCount = 0;
+
+    for( unsigned i = 0;  i < sheetList.size(); i++ )
+    {
+        for( SCH_ITEM* item = sheetList[i].LastDrawList(); item != NULL; item = item->Next() )
+        {
+            if( item->Type() != SCH_MARKER_T )
+                continue;
+
+            SCH_MARKER* marker = (SCH_MARKER*) item;
+
+            if( marker->GetMarkerType() != MARKER_BASE::MARKER_ERC )
+                continue;
+
+            const DRC_ITEM& drc = marker->GetReporter();
+            const char*     severity = "info";
+
+            if( marker->GetErrorLevel() == MARKER_BASE::MARKER_SEVERITY_ERROR )
+            {
+                severity = "error";
+                ++*aErrorCount;
+            }
+            else if( marker->GetErrorLevel() == MARKER_BASE::MARKER_SEVERITY_WARNING )
+            {
+                severity = "warning";
+                ++*aWarningCount;
+            }
+
+            wxString items = jsonItem( drc.GetTextA(), drc.GetPointA() );
+
+            if( drc.HasSecondItem() )
+                items += wxT( ", " ) + jsonItem( drc.GetTextB(), drc.GetPointB() );
+
+            if( !violations.IsEmpty() )
+                violations += wxT( ",\n" );
+
+            violations += wxString::Format(
+                    wxT( "    { \"sheet\": %s, \"code\": %d, \"type\": %s, \"severity\": \"%s\",\n"
+                         "      \"items\": [ %s ] }" ),
+                    GetChars( jsonString( sheetList[i].PathHumanReadable() ) ),
+                    drc.GetErrorCode(), GetChars( jsonString( drc.GetErrorText() ) ),
+                    GetChars( FROM_UTF8( severity ) ), GetChars( items ) );
+        }
+    }
+
+    wxString timings;
+
+    for( unsigned i = 0; i < aTimings.size(); i++ )
+    {
+        if( i > 0 )
+            timings += wxT( ", " );
+
+        timings += wxString::Format( wxT( "\"%s\": %.1f" ),
+                                     GetChars( FROM_UTF8( aTimings[i].first.c_str() ) ),
+                                     aTimings[i].second );
+    }
+
+    wxString json;
+
+    json << wxT( "{\n" )
+         << wxT( "  \"source\": " ) << jsonString( aSchematic ) << wxT( ",\n" )
+         << wxT( "  \"date\": " ) << jsonString( DateAndTime() ) << wxT( ",\n" )
+         << wxString::Format( wxT( "  \"errors\": %d,\n  \"warnings\": %d,\n" ),
+                              *aErrorCount, *aWarningCount )
+         << wxT( "  \"timings_ms\": { " ) << timings << wxT( " },\n" )
+         << wxT( "  \"violations\": [\n" ) << violations << wxT( "\n  ]\n}\n" );
+
+    wxFFile file( aFileName, wxT( "wt" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    // Written using UTF8, as the .erc report
+    return file.Write( json );
+}
+
+
+int SCH_EDIT_FRAME::RunBatchJob( const std::vector<wxString>& aArgs )
+{
+    wxString schematic;
+    wxString ercReport;
+    wxString netlist;
+    int      format = NET_TYPE_PCBNEW;
+    bool     usageError = false;
+
+    for( unsigned i = 0; i < aArgs.size(); i++ )
+    {
+        bool hasValue = i + 1 < aArgs.size();
+
+        if( aArgs[i] == wxT( "--erc" ) && hasValue )
+            ercReport = aArgs[++i];
+        else if( aArgs[i] == wxT( "--netlist" ) && hasValue )
+            netlist = aArgs[++i];
+        else if( aArgs[i] == wxT( "--format" ) && hasValue )
+            format = netlistFormat( aArgs[++i] );
+        else if( !aArgs[i].StartsWith( wxT( "--" ) ) && schematic.IsEmpty() )
+            schematic = aArgs[i];
+        else
+            usageError = true;
+    }
+
+    if( usageError || schematic.IsEmpty() || format == NET_TYPE_UNINIT )
+    {
+        batchUsage();
+        return BATCH_FAILED;
+    }
+
+    // The output files are relative to the working directory, not to the project
+    wxFileName fn( schematic );
+
+    if( fn.GetExt().IsEmpty() )
+        fn.SetExt( SchematicFileExtension );
+
+    fn.MakeAbsolute();
+
+    if( !ercReport.IsEmpty() )
+    {
+        wxFileName reportFn( ercReport );
+        reportFn.MakeAbsolute();
+        ercReport = reportFn.GetFullPath();
+    }
+
+    if( !netlist.IsEmpty() )
+    {
+        wxFileName netlistFn( netlist );
+        netlistFn.MakeAbsolute();
+        netlist = netlistFn.GetFullPath();
+    }
+
+    BATCH_TIMINGS timings;
+    prof_counter  counter;
+
+    // A missing schematic is not created by OpenProjectFiles(): IsOK() answers no in
+    // batch mode
+    prof_start( &counter );
+    bool loaded = OpenProjectFiles( std::vector<wxString>( 1, fn.GetFullPath() ) );
+    endPhase( timings, "load", counter );
+
+    if( !loaded )
+        return BATCH_FAILED;
+
+    // The ERC and the netlist both need an annotated schematic
+    prof_start( &counter );
+
+    SCH_SHEET_LIST sheets( g_RootSheet );
+    wxArrayString  messages;
+
+    sheets.AnnotatePowerSymbols( Prj().SchLibs() );
+
+    int annotationErrors = CheckAnnotate( &messages, false );
+
+    endPhase( timings, "annotation", counter );
+
+    if( annotationErrors )
+    {
+        for( unsigned i = 0; i < messages.GetCount(); i++ )
+            fprintf( stderr, "%s", TO_UTF8( messages[i] ) );
+
+        fprintf( stderr, "%s\n", TO_UTF8( _( "Annotation required!" ) ) );
+        return BATCH_FAILED;
+    }
+
+    if( !ercReport.IsEmpty() )
+    {
+        // As DIALOG_ERC::TestErc(), with its default options
+        prof_start( &counter );
+
+        SCH_SCREENS screens;
+
+        screens.DeleteAllMarkers( MARKER_BASE::MARKER_ERC );
+        screens.SchematicCleanUp();
+
+        TestDuplicateSheetNames( true );
+
+        std::auto_ptr<NETLIST_OBJECT_LIST> objectsConnectedList( BuildNetListBase() );
+
+        TestErcConnections( objectsConnectedList.get(), true, true );
+
+        endPhase( timings, "erc", counter );
+    }
+
+    if( !netlist.IsEmpty() )
+    {
+        wxString  netlistMessages;
+        WX_STRING_REPORTER reporter( &netlistMessages );
+
+        prof_start( &counter );
+        bool written = CreateNetlist( format, netlist, 0, &reporter );
+        endPhase( timings, "netlist", counter );
+
+        if( !netlistMessages.IsEmpty() )
+            fprintf( stderr, "%s\n", TO_UTF8( netlistMessages ) );
+
+        if( !written )
+        {
+            fprintf( stderr, "%s\n", TO_UTF8( wxString::Format( _( "Failed to create file '%s'" ),
+                                                               GetChars( netlist ) ) ) );
+            return BATCH_FAILED;
+        }
+    }
+
+    if( !ercReport.IsEmpty() )
+    {
+        // Written at the end, with the time of all the phases
+        int errors, warnings;
+
+        if( !writeErcReport( ercReport, fn.GetFullPath(), timings, &errors, &warnings ) )
+        {
+            fprintf( stderr, "%s\n", TO_UTF8( wxString::Format( _( "Failed to create file '%s'" ),
+                                                               GetChars( ercReport ) ) ) );
+            return BATCH_FAILED;
+        }
+
+        printf( "ERC: %d errors, %d warnings\n", errors, warnings );
+
+        if( errors > 0 )
+            return BATCH_ERC_ERRORS;
+    }
+
+    return BATCH_OK;
+}
@@ -50,6 +50,7 @@
 #include <lib_text.h>
 
 #include <boost/foreach.hpp>
+#include <boost/thread/mutex.hpp>
 
 // the separator char between the subpart id and the reference
 // 0 (no separator) or '.' or some other character
@@ -179,7 +180,8 @@ struct null_deleter
 
 LIB_PART::LIB_PART( const wxString& aName, PART_LIB* aLibrary ) :
     EDA_ITEM( LIB_PART_T ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_drawingsDeferred( false )
 {
     m_name                = aName;
     m_library             = aLibrary;
@@ -209,7 +211,8 @@ LIB_PART::LIB_PART( const wxString& aName, PART_LIB* aLibrary ) :
 
 LIB_PART::LIB_PART( LIB_PART& aPart, PART_LIB* aLibrary ) :
     EDA_ITEM( aPart ),
-    m_me( this, null_deleter() )
+    m_me( this, null_deleter() ),
+    m_drawingsDeferred( false )
 {
     LIB_ITEM* newItem;
 
@@ -231,7 +234,7 @@ LIB_PART::LIB_PART( LIB_PART& aPart, PART_LIB* aLibrary ) :
 
         newItem = (LIB_ITEM*) oldItem.Clone();
         newItem->SetParent( this );
-        drawings.push_back( newItem );
+        drawItems().push_back( newItem );
     }
 
     for( size_t i = 0; i < aPart.m_aliases.size(); i++ )
@@ -327,7 +330,7 @@ void LIB_PART::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDc, const wxPoint& aOffset,
     if( ! (screen && screen->m_IsPrinting && GetGRForceBlackPenState())
             && (aColor == UNSPECIFIED_COLOR) )
     {
-        BOOST_FOREACH( LIB_ITEM& drawItem, drawings )
+        BOOST_FOREACH( LIB_ITEM& drawItem, drawItems() )
         {
             if( drawItem.m_Fill != FILLED_WITH_BG_BODYCOLOR )
                 continue;
@@ -363,7 +366,7 @@ void LIB_PART::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDc, const wxPoint& aOffset,
     // Track the index into the dangling pins list
     size_t pin_index = 0;
 
-    BOOST_FOREACH( LIB_ITEM& drawItem, drawings )
+    BOOST_FOREACH( LIB_ITEM& drawItem, drawItems() )
     {
         if( aOnlySelected && !drawItem.IsSelected() )
             continue;
@@ -446,7 +449,7 @@ void LIB_PART::Plot( PLOTTER* aPlotter, int aUnit, int aConvert,
 
     // draw background for filled items using background option
     // Solid lines will be drawn after the background
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         // Lib Fields are not plotted here, because this plot function
         // is used to plot schematic items, which have they own fields
@@ -465,7 +468,7 @@ void LIB_PART::Plot( PLOTTER* aPlotter, int aUnit, int aConvert,
 
     // Not filled items and filled shapes are now plotted
     // (plot only items which are not already plotted)
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( item.Type() == LIB_FIELD_T )
             continue;
@@ -489,7 +492,7 @@ void LIB_PART::PlotLibFields( PLOTTER* aPlotter, int aUnit, int aConvert,
     aPlotter->SetColor( GetLayerColor( LAYER_FIELDS ) );
     bool fill = aPlotter->GetColorMode();
 
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( item.Type() != LIB_FIELD_T )
             continue;
@@ -537,7 +540,7 @@ void LIB_PART::RemoveDrawItem( LIB_ITEM* aItem, EDA_DRAW_PANEL* aPanel, wxDC* aD
 
     LIB_ITEMS::iterator i;
 
-    for( i = drawings.begin(); i != drawings.end(); i++ )
+    for( i = drawItems().begin(); i != drawItems().end(); i++ )
     {
         if( *i == aItem )
         {
@@ -545,7 +548,7 @@ void LIB_PART::RemoveDrawItem( LIB_ITEM* aItem, EDA_DRAW_PANEL* aPanel, wxDC* aD
                 aItem->Draw( aPanel, aDc, wxPoint( 0, 0 ), UNSPECIFIED_COLOR,
                              g_XorMode, NULL, DefaultTransform );
 
-            drawings.erase( i );
+            drawItems().erase( i );
             SetModified();
             break;
         }
@@ -557,8 +560,8 @@ void LIB_PART::AddDrawItem( LIB_ITEM* aItem )
 {
     wxASSERT( aItem != NULL );
 
-    drawings.push_back( aItem );
-    drawings.sort();
+    drawItems().push_back( aItem );
+    drawItems().sort();
 }
 
 
@@ -567,20 +570,20 @@ LIB_ITEM* LIB_PART::GetNextDrawItem( LIB_ITEM* aItem, KICAD_T aType )
     /* Return the next draw object pointer.
      * If item is NULL return the first item of type in the list.
      */
-    if( drawings.empty() )
+    if( drawItems().empty() )
         return NULL;
 
     if( aItem == NULL && aType == TYPE_NOT_INIT )    // type is unspecified
-        return &drawings[0];
+        return &drawItems()[0];
 
     // Search for last item
     size_t idx = 0;
 
     if( aItem )
     {
-        for( ; idx < drawings.size(); idx++ )
+        for( ; idx < drawItems().size(); idx++ )
         {
-            if( aItem == &drawings[idx] )
+            if( aItem == &drawItems()[idx] )
             {
                 idx++;   // Prepare the next item search
                 break;
@@ -589,10 +592,10 @@ LIB_ITEM* LIB_PART::GetNextDrawItem( LIB_ITEM* aItem, KICAD_T aType )
     }
 
     // Search the next item
-    for( ; idx < drawings.size(); idx++ )
+    for( ; idx < drawItems().size(); idx++ )
     {
-        if( aType == TYPE_NOT_INIT || drawings[ idx ].Type() == aType )
-            return &drawings[ idx ];
+        if( aType == TYPE_NOT_INIT || drawItems()[ idx ].Type() == aType )
+            return &drawItems()[ idx ];
     }
 
     return NULL;
@@ -607,7 +610,7 @@ void LIB_PART::GetPins( LIB_PINS& aList, int aUnit, int aConvert )
      * when .m_Unit == 0, the body item is common to units
      * when .m_Convert == 0, the body item is common to shapes
      */
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( item.Type() != LIB_PIN_T )    // we search pins only
             continue;
@@ -814,15 +817,15 @@ bool LIB_PART::Save( OUTPUTFORMATTER& aFormatter )
     }
 
     // Save graphics items (including pins)
-    if( !drawings.empty() )
+    if( !drawItems().empty() )
     {
         /* we sort the draw items, in order to have an edition more easy,
          *  when a file editing "by hand" is made */
-        drawings.sort();
+        drawItems().sort();
 
         aFormatter.Print( 0, "DRAW\n" );
 
-        BOOST_FOREACH( LIB_ITEM& item, drawings )
+        BOOST_FOREACH( LIB_ITEM& item, drawItems() )
         {
             if( item.Type() == LIB_FIELD_T )
                 continue;
@@ -840,7 +843,7 @@ bool LIB_PART::Save( OUTPUTFORMATTER& aFormatter )
 }
 
 
-bool LIB_PART::Load( LINE_READER& aLineReader, wxString& aErrorMsg )
+bool LIB_PART::Load( LINE_READER& aLineReader, wxString& aErrorMsg, bool aDeferDrawings )
 {
     int      unused;
     char*    p;
@@ -957,6 +960,8 @@ bool LIB_PART::Load( LINE_READER& aLineReader, wxString& aErrorMsg )
             result = LoadField( aLineReader, Msg );
         else if( strcmp( p, "ENDDEF" ) == 0 )   // End of component description
             goto ok;
+        else if( strcmp( p, "DRAW" ) == 0 && aDeferDrawings )
+            result = DeferDrawEntries( aLineReader, Msg );
         else if( strcmp( p, "DRAW" ) == 0 )
             result = LoadDrawEntries( aLineReader, Msg );
         else if( strncmp( p, "ALIAS", 5 ) == 0 )
@@ -1080,6 +1085,68 @@ bool LIB_PART::LoadDrawEntries( LINE_READER& aLineReader, wxString& aErrorMsg )
 }
 
 
+bool LIB_PART::DeferDrawEntries( LINE_READER& aLineReader, wxString& aErrorMsg )
+{
+    char* line;
+
+    m_deferredDrawings.clear();
+
+    // Keep the lines up to ENDDRAW as read, for LoadDrawEntries()
+    while( ( line = aLineReader.ReadLine() ) != NULL )
+    {
+        unsigned length = aLineReader.Length();
+
+        m_deferredDrawings.append( line, length );
+
+        if( length == 0 || line[length - 1] != '\n' )
+            m_deferredDrawings += '\n';
+
+        if( strncmp( line, "ENDDRAW", 7 ) == 0 )
+        {
+            m_drawingsDeferred.store( true, boost::memory_order_release );
+            return true;
+        }
+    }
+
+    aErrorMsg = wxT( "file ended prematurely loading component draw element" );
+    m_deferredDrawings.clear();
+
+    return false;
+}
+
+
+// Parsing the deferred draw items of a part used by several threads, for instance by
+// the netlist extraction of several sheets, is done once
+static boost::mutex deferredDrawingsLock;
+
+
+void LIB_PART::loadDeferredDrawings() const
+{
+    boost::mutex::scoped_lock lock( deferredDrawingsLock );
+
+    if( !m_drawingsDeferred.load( boost::memory_order_acquire ) )
+        return;
+
+    LIB_PART*          part = const_cast<LIB_PART*>( this );
+    STRING_LINE_READER reader( m_deferredDrawings, part->GetLibraryName() );
+    wxString           msg;
+
+    if( !part->LoadDrawEntries( reader, msg ) )
+    {
+        wxLogWarning( _( "Library '%s' component load error %s." ),
+                      GetChars( part->GetLibraryName() ), GetChars( msg ) );
+    }
+
+    // Reorder drawings: transparent polygons first, pins and text last.
+    part->drawings.sort();
+
+    // Free the text
+    std::string().swap( part->m_deferredDrawings );
+
+    part->m_drawingsDeferred.store( false, boost::memory_order_release );
+}
+
+
 bool LIB_PART::LoadAliases( char* aLine, wxString& aErrorMsg )
 {
     char* text = strtok( aLine, " \t\r\n" );
@@ -1159,9 +1226,9 @@ const EDA_RECT LIB_PART::GetBoundingBox( int aUnit, int aConvert ) const
     EDA_RECT bBox;
     bool initialized = false;
 
-    for( unsigned ii = 0; ii < drawings.size(); ii++  )
+    for( unsigned ii = 0; ii < drawItems().size(); ii++  )
     {
-        const LIB_ITEM& item = drawings[ii];
+        const LIB_ITEM& item = drawItems()[ii];
 
         if( ( item.m_Unit > 0 ) && ( ( m_unitCount > 1 ) && ( aUnit > 0 )
                                      && ( aUnit != item.m_Unit ) ) )
@@ -1191,9 +1258,9 @@ const EDA_RECT LIB_PART::GetBodyBoundingBox( int aUnit, int aConvert ) const
     EDA_RECT bBox;
     bool initialized = false;
 
-    for( unsigned ii = 0; ii < drawings.size(); ii++  )
+    for( unsigned ii = 0; ii < drawItems().size(); ii++  )
     {
-        const LIB_ITEM& item = drawings[ii];
+        const LIB_ITEM& item = drawItems()[ii];
 
         if( ( item.m_Unit > 0 ) && ( ( m_unitCount > 1 ) && ( aUnit > 0 )
                                      && ( aUnit != item.m_Unit ) ) )
@@ -1222,7 +1289,7 @@ void LIB_PART::deleteAllFields()
 {
     LIB_ITEMS::iterator it;
 
-    for( it = drawings.begin();  it != drawings.end();  /* deleting */  )
+    for( it = drawItems().begin();  it != drawItems().end();  /* deleting */  )
     {
         if( it->Type() != LIB_FIELD_T  )
         {
@@ -1231,7 +1298,7 @@ void LIB_PART::deleteAllFields()
         }
 
         // 'it' is not advanced, but should point to next in list after erase()
-        it = drawings.erase( it );
+        it = drawItems().erase( it );
     }
 }
 
@@ -1246,12 +1313,12 @@ void LIB_PART::SetFields( const std::vector <LIB_FIELD>& aFields )
         LIB_FIELD* field = new LIB_FIELD( aFields[i] );
 
         field->SetParent( this );
-        drawings.push_back( field );
+        drawItems().push_back( field );
     }
 
     // Reorder drawings: transparent polygons first, pins and text last.
     // so texts have priority on screen.
-    drawings.sort();
+    drawItems().sort();
 }
 
 
@@ -1275,7 +1342,7 @@ void LIB_PART::GetFields( LIB_FIELDS& aList )
     }
 
     // Now grab all the rest of fields.
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( item.Type() != LIB_FIELD_T )
             continue;
@@ -1292,7 +1359,7 @@ void LIB_PART::GetFields( LIB_FIELDS& aList )
 
 LIB_FIELD* LIB_PART::GetField( int aId )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( item.Type() != LIB_FIELD_T )
             continue;
@@ -1309,7 +1376,7 @@ LIB_FIELD* LIB_PART::GetField( int aId )
 
 LIB_FIELD* LIB_PART::FindField( const wxString& aFieldName )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( item.Type() != LIB_FIELD_T )
             continue;
@@ -1381,7 +1448,7 @@ bool LIB_PART::LoadDateAndTime( char* aLine )
 
 void LIB_PART::SetOffset( const wxPoint& aOffset )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         item.SetOffset( aOffset );
     }
@@ -1390,15 +1457,15 @@ void LIB_PART::SetOffset( const wxPoint& aOffset )
 
 void LIB_PART::RemoveDuplicateDrawItems()
 {
-    drawings.unique();
+    drawItems().unique();
 }
 
 
 bool LIB_PART::HasConversion() const
 {
-    for( unsigned ii = 0; ii < drawings.size(); ii++  )
+    for( unsigned ii = 0; ii < drawItems().size(); ii++  )
     {
-        const LIB_ITEM& item = drawings[ii];
+        const LIB_ITEM& item = drawItems()[ii];
         if( item.m_Convert > 1 )
             return true;
     }
@@ -1409,7 +1476,7 @@ bool LIB_PART::HasConversion() const
 
 void LIB_PART::ClearStatus()
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         item.m_Flags = 0;
     }
@@ -1420,7 +1487,7 @@ int LIB_PART::SelectItems( EDA_RECT& aRect, int aUnit, int aConvert, bool aEditP
 {
     int itemCount = 0;
 
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         item.ClearFlags( SELECTED );
 
@@ -1449,7 +1516,7 @@ int LIB_PART::SelectItems( EDA_RECT& aRect, int aUnit, int aConvert, bool aEditP
 
 void LIB_PART::MoveSelectedItems( const wxPoint& aOffset )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( !item.IsSelected() )
             continue;
@@ -1458,13 +1525,13 @@ void LIB_PART::MoveSelectedItems( const wxPoint& aOffset )
         item.m_Flags = 0;
     }
 
-    drawings.sort();
+    drawItems().sort();
 }
 
 
 void LIB_PART::ClearSelectedItems()
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         item.m_Flags = 0;
     }
@@ -1473,14 +1540,14 @@ void LIB_PART::ClearSelectedItems()
 
 void LIB_PART::DeleteSelectedItems()
 {
-    LIB_ITEMS::iterator item = drawings.begin();
+    LIB_ITEMS::iterator item = drawItems().begin();
 
     // We *do not* remove the 2 mandatory fields: reference and value
     // so skip them (do not remove) if they are flagged selected.
     // Skip also not visible items.
     // But I think fields must not be deleted by a block delete command or other global command
     // because they are not really graphic items
-    while( item != drawings.end() )
+    while( item != drawItems().end() )
     {
         if( item->Type() == LIB_FIELD_T )
         {
@@ -1496,7 +1563,7 @@ void LIB_PART::DeleteSelectedItems()
         if( !item->IsSelected() )
             item++;
         else
-            item = drawings.erase( item );
+            item = drawItems().erase( item );
     }
 }
 
@@ -1508,11 +1575,11 @@ void LIB_PART::CopySelectedItems( const wxPoint& aOffset )
      * When push_back elements in buffer,
      * a memory reallocation can happen and will break pointers
      */
-    unsigned icnt = drawings.size();
+    unsigned icnt = drawItems().size();
 
     for( unsigned ii = 0; ii < icnt; ii++  )
     {
-        LIB_ITEM& item = drawings[ii];
+        LIB_ITEM& item = drawItems()[ii];
 
         // We *do not* copy fields because they are unique for the whole component
         // so skip them (do not duplicate) if they are flagged selected.
@@ -1525,18 +1592,18 @@ void LIB_PART::CopySelectedItems( const wxPoint& aOffset )
         item.ClearFlags( SELECTED );
         LIB_ITEM* newItem = (LIB_ITEM*) item.Clone();
         newItem->SetFlags( SELECTED );
-        drawings.push_back( newItem );
+        drawItems().push_back( newItem );
     }
 
     MoveSelectedItems( aOffset );
-    drawings.sort();
+    drawItems().sort();
 }
 
 
 
 void LIB_PART::MirrorSelectedItemsH( const wxPoint& aCenter )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( !item.IsSelected() )
             continue;
@@ -1545,12 +1612,12 @@ void LIB_PART::MirrorSelectedItemsH( const wxPoint& aCenter )
         item.m_Flags = 0;
     }
 
-    drawings.sort();
+    drawItems().sort();
 }
 
 void LIB_PART::MirrorSelectedItemsV( const wxPoint& aCenter )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( !item.IsSelected() )
             continue;
@@ -1559,12 +1626,12 @@ void LIB_PART::MirrorSelectedItemsV( const wxPoint& aCenter )
         item.m_Flags = 0;
     }
 
-    drawings.sort();
+    drawItems().sort();
 }
 
 void LIB_PART::RotateSelectedItems( const wxPoint& aCenter )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( !item.IsSelected() )
             continue;
@@ -1573,7 +1640,7 @@ void LIB_PART::RotateSelectedItems( const wxPoint& aCenter )
         item.m_Flags = 0;
     }
 
-    drawings.sort();
+    drawItems().sort();
 }
 
 
@@ -1581,7 +1648,7 @@ void LIB_PART::RotateSelectedItems( const wxPoint& aCenter )
 LIB_ITEM* LIB_PART::LocateDrawItem( int aUnit, int aConvert,
                                     KICAD_T aType, const wxPoint& aPoint )
 {
-    BOOST_FOREACH( LIB_ITEM& item, drawings )
+    BOOST_FOREACH( LIB_ITEM& item, drawItems() )
     {
         if( ( aUnit && item.m_Unit && ( aUnit != item.m_Unit) )
             || ( aConvert && item.m_Convert && ( aConvert != item.m_Convert ) )
@@ -1625,12 +1692,12 @@ void LIB_PART::SetUnitCount( int aCount )
     if( aCount < m_unitCount )
     {
         LIB_ITEMS::iterator i;
-        i = drawings.begin();
+        i = drawItems().begin();
 
-        while( i != drawings.end() )
+        while( i != drawItems().end() )
         {
             if( i->m_Unit > aCount )
-                i = drawings.erase( i );
+                i = drawItems().erase( i );
             else
                 i++;
         }
@@ -1642,22 +1709,22 @@ void LIB_PART::SetUnitCount( int aCount )
         // We cannot use an iterator here, because when adding items in vector
         // the buffer can be reallocated, that change the previous value of
         // .begin() and .end() iterators and invalidate others iterators
-        unsigned imax = drawings.size();
+        unsigned imax = drawItems().size();
 
         for( unsigned ii = 0; ii < imax; ii++ )
         {
-            if( drawings[ii].m_Unit != 1 )
+            if( drawItems()[ii].m_Unit != 1 )
                 continue;
 
             for( int j = prevCount + 1; j <= aCount; j++ )
             {
-                LIB_ITEM* newItem = (LIB_ITEM*) drawings[ii].Clone();
+                LIB_ITEM* newItem = (LIB_ITEM*) drawItems()[ii].Clone();
                 newItem->m_Unit = j;
-                drawings.push_back( newItem );
+                drawItems().push_back( newItem );
             }
         }
 
-        drawings.sort();
+        drawItems().sort();
     }
 
     m_unitCount = aCount;
@@ -1674,7 +1741,7 @@ void LIB_PART::SetConversion( bool aSetConvert )
     {
         std::vector< LIB_ITEM* > tmp;     // Temporarily store the duplicated pins here.
 
-        BOOST_FOREACH( LIB_ITEM& item, drawings )
+        BOOST_FOREACH( LIB_ITEM& item, drawItems() )
         {
             // Only pins are duplicated.
             if( item.Type() != LIB_PIN_T )
@@ -1690,18 +1757,18 @@ void LIB_PART::SetConversion( bool aSetConvert )
 
         // Transfer the new pins to the LIB_PART.
         for( unsigned i = 0;  i < tmp.size();  i++ )
-            drawings.push_back( tmp[i] );
+            drawItems().push_back( tmp[i] );
     }
     else
     {
         // Delete converted shape items because the converted shape does
         // not exist
-        LIB_ITEMS::iterator i = drawings.begin();
+        LIB_ITEMS::iterator i = drawItems().begin();
 
-        while( i != drawings.end() )
+        while( i != drawItems().end() )
         {
             if( i->m_Convert > 1 )
-                i = drawings.erase( i );
+                i = drawItems().erase( i );
             else
                 i++;
         }
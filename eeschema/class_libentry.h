@@ -35,6 +35,8 @@
 #include <lib_field.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <string>
 #include <vector>
 
 class LINE_READER;
@@ -211,6 +213,9 @@ class LIB_PART : public EDA_ITEM
     LIBRENTRYOPTIONS    m_options;          ///< Special part features such as POWER or NORMAL.)
     int                 m_unitCount;        ///< Number of units (parts) per package.
     LIB_ITEMS           drawings;           ///< How to draw this part.
+    std::string         m_deferredDrawings; ///< The unparsed DRAW section of a part loaded
+                                            ///< from a library, see drawItems().
+    boost::atomic<bool> m_drawingsDeferred; ///< True until m_deferredDrawings is parsed.
     wxArrayString       m_FootprintList;    /**< List of suitable footprint names for the
                                                  part (wild card names accepted). */
     LIB_ALIASES         m_aliases;          ///< List of alias object pointers associated with the
@@ -226,6 +231,30 @@ class LIB_PART : public EDA_ITEM
 private:
     void deleteAllFields();
 
+    /**
+     * Function drawItems
+     * returns the draw items of the part, parsing the deferred DRAW section of the library
+     * file on the first call.  All the accesses to the draw items, the fields included,
+     * go through it.
+     */
+    LIB_ITEMS& drawItems()
+    {
+        if( m_drawingsDeferred.load( boost::memory_order_acquire ) )
+            loadDeferredDrawings();
+
+        return drawings;
+    }
+
+    const LIB_ITEMS& drawItems() const
+    {
+        if( m_drawingsDeferred.load( boost::memory_order_acquire ) )
+            loadDeferredDrawings();
+
+        return drawings;
+    }
+
+    void loadDeferredDrawings() const;
+
     // LIB_PART()  { }     // not legal
 
 public:
@@ -343,11 +372,14 @@ public:
      *
      * @param aReader A LINE_READER object to load file from.
      * @param aErrorMsg - Description of error on load failure.
+     * @param aDeferDrawings - True to keep the DRAW section unparsed until the draw
+     *                         items are first used.
      * @return True if the load was successful, false if there was an error.
      */
-    bool Load( LINE_READER& aReader, wxString& aErrorMsg );
+    bool Load( LINE_READER& aReader, wxString& aErrorMsg, bool aDeferDrawings = false );
     bool LoadField( LINE_READER& aReader, wxString& aErrorMsg );
     bool LoadDrawEntries( LINE_READER& aReader, wxString& aErrorMsg );
+    bool DeferDrawEntries( LINE_READER& aReader, wxString& aErrorMsg );
     bool LoadAliases( char* aLine, wxString& aErrorMsg );
     bool LoadFootprints( LINE_READER& aReader, wxString& aErrorMsg );
 
@@ -662,7 +694,7 @@ public:
      *
      * @return LIB_ITEMS& - Reference to the draw item object list.
      */
-    LIB_ITEMS& GetDrawItemList() { return drawings; }
+    LIB_ITEMS& GetDrawItemList() { return drawItems(); }
 
     /**
      * Set the units per part count.
@@ -559,10 +559,11 @@ bool PART_LIB::Load( wxString& aErrorMsg )
 
         if( strnicmp( line, "DEF", 3 ) == 0 )
         {
-            // Read one DEF/ENDDEF part entry from library:
+            // Read one DEF/ENDDEF part entry from library.  The draw items are only
+            // parsed when the part is first used: most parts of a library never are.
             LIB_PART* part = new LIB_PART( wxEmptyString, this );
 
-            if( part->Load( reader, msg ) )
+            if( part->Load( reader, msg, true ) )
             {
                 // Check for duplicate entry names and warn the user about
                 // the potential conflict.
@@ -835,6 +836,7 @@ PART_LIB* PART_LIBS::AddLibrary( const wxString& aFileName ) throw( IO_ERROR, bo
     lib = PART_LIB::LoadLibrary( aFileName );
 
     push_back( lib );
+    invalidateEntryIndex();
 
     return lib;
 }
@@ -859,6 +861,8 @@ PART_LIB* PART_LIBS::AddLibrary( const wxString& aFileName, PART_LIBS::iterator&
     else
         push_back( lib );
 
+    invalidateEntryIndex();
+
     return lib;
 }
 
@@ -873,6 +877,7 @@ void PART_LIBS::RemoveLibrary( const wxString& aName )
         if( it->GetName().CmpNoCase( aName ) == 0 )
         {
             erase( it );
+            invalidateEntryIndex();
             return;
         }
     }
@@ -915,10 +920,51 @@ wxArrayString PART_LIBS::GetLibraryNames( bool aSorted )
 }
 
 
+const std::vector<LIB_ALIAS*>* PART_LIBS::findIndexedEntries( const wxString& aEntryName )
+{
+    // The libraries can be modified directly, their modification hashes tell when
+    bool valid = m_indexedLibs.size() == size();
+
+    for( unsigned i = 0; valid && i < size(); ++i )
+    {
+        const PART_LIB& lib = (*this)[i];
+
+        valid = m_indexedLibs[i].first == &lib && m_indexedLibs[i].second == lib.m_mod_hash;
+    }
+
+    if( !valid )
+    {
+        invalidateEntryIndex();
+
+        BOOST_FOREACH( PART_LIB& lib, *this )
+        {
+            for( LIB_ALIAS_MAP::iterator it = lib.m_amap.begin(); it != lib.m_amap.end(); ++it )
+                m_entryIndex[it->first].push_back( it->second );
+
+            m_indexedLibs.push_back( std::make_pair( (const PART_LIB*) &lib, lib.m_mod_hash ) );
+        }
+    }
+
+    ENTRY_INDEX::const_iterator entries = m_entryIndex.find( aEntryName );
+
+    if( entries == m_entryIndex.end() )
+        return NULL;
+
+    return &entries->second;
+}
+
+
 LIB_PART* PART_LIBS::FindLibPart( const wxString& aPartName, const wxString& aLibraryName )
 {
     LIB_PART* part = NULL;
 
+    if( aLibraryName.IsEmpty() )
+    {
+        const std::vector<LIB_ALIAS*>* entries = findIndexedEntries( aPartName );
+
+        return entries ? entries->front()->GetPart() : NULL;
+    }
+
     BOOST_FOREACH( PART_LIB& lib, *this )
     {
         if( !aLibraryName.IsEmpty() && lib.GetName() != aLibraryName )
@@ -938,6 +984,13 @@ LIB_ALIAS* PART_LIBS::FindLibraryEntry( const wxString& aEntryName, const wxStri
 {
     LIB_ALIAS* entry = NULL;
 
+    if( aLibraryName.IsEmpty() )
+    {
+        const std::vector<LIB_ALIAS*>* entries = findIndexedEntries( aEntryName );
+
+        return entries ? entries->front() : NULL;
+    }
+
     BOOST_FOREACH( PART_LIB& lib, *this )
     {
         if( !!aLibraryName && lib.GetName() != aLibraryName )
@@ -954,13 +1007,10 @@ LIB_ALIAS* PART_LIBS::FindLibraryEntry( const wxString& aEntryName, const wxStri
 
 void PART_LIBS::FindLibraryEntries( const wxString& aEntryName, std::vector<LIB_ALIAS*>& aEntries )
 {
-    BOOST_FOREACH( PART_LIB& lib, *this )
-    {
-        LIB_ALIAS* entry = lib.FindEntry( aEntryName );
+    const std::vector<LIB_ALIAS*>* entries = findIndexedEntries( aEntryName );
 
-        if( entry )
-            aEntries.push_back( entry );
-    }
+    if( entries )
+        aEntries.insert( aEntries.end(), entries->begin(), entries->end() );
 }
 
 /* searches all libraries in the list for an entry, using a case insensitive comparison.
@@ -33,6 +33,9 @@
 
 #include <wx/filename.h>
 
+#include <boost/unordered_map.hpp>
+
+#include <hashtables.h>
 #include <class_libentry.h>
 
 #include <project.h>
@@ -230,7 +233,11 @@ public:
      */
     void RemoveLibrary( const wxString& aName );
 
-    void RemoveAllLibraries()       { clear(); }
+    void RemoveAllLibraries()
+    {
+        clear();
+        invalidateEntryIndex();
+    }
 
     /**
      * Function LoadAllLibraries
@@ -334,6 +341,29 @@ public:
 
     int GetLibraryCount() { return size(); }
 
+private:
+    /// The entries of all the libraries by name, in the library order.
+    typedef boost::unordered_map< wxString, std::vector<LIB_ALIAS*>, WXSTRING_HASH > ENTRY_INDEX;
+
+    ENTRY_INDEX m_entryIndex;
+
+    /// The libraries of m_entryIndex and their modification hashes when it was built.
+    std::vector< std::pair<const PART_LIB*, int> > m_indexedLibs;
+
+    /**
+     * Function findIndexedEntries
+     * returns the entries named \a aEntryName of all the libraries, from the name index
+     * rebuilt when a library was added, removed or modified.
+     *
+     * @return The entries in the library order, or NULL if none is found.
+     */
+    const std::vector<LIB_ALIAS*>* findIndexedEntries( const wxString& aEntryName );
+
+    void invalidateEntryIndex()
+    {
+        m_entryIndex.clear();
+        m_indexedLibs.clear();
+    }
 };
 
 
@@ -36,6 +36,7 @@
 #include <class_netlist_object.h>
 
 #include <wx/regex.h>
+#include <boost/thread/mutex.hpp>
 
 
 /**
@@ -45,12 +46,18 @@
  */
 static wxRegEx busLabelRe( wxT( "^([^[:space:]]+)(\\[[\\d]+\\.+[\\d]+\\])$" ), wxRE_ADVANCED );
 
+/// The matches of busLabelRe are kept in the object: the net list items are built on
+/// several threads, see NETLIST_OBJECT_LIST::BuildNetListInfo()
+static boost::mutex busLabelLock;
+
 
 bool IsBusLabel( const wxString& aLabel )
 {
     wxCHECK_MSG( busLabelRe.IsValid(), false,
                  wxT( "Invalid regular expression in IsBusLabel()." ) );
 
+    boost::mutex::scoped_lock lock( busLabelLock );
+
     return busLabelRe.Matches( aLabel );
 }
 
@@ -241,8 +248,17 @@ bool NETLIST_OBJECT::IsLabelConnected( NETLIST_OBJECT* aNetItem )
 
 void NETLIST_OBJECT::ConvertBusToNetListItems( NETLIST_OBJECT_LIST& aNetListItems )
 {
-    wxCHECK_RET( IsBusLabel( m_Label ),
-                 wxT( "<" ) + m_Label + wxT( "> is not a valid bus label." ) );
+    wxString tmp, busName, busNumber;
+
+    {
+        boost::mutex::scoped_lock lock( busLabelLock );
+
+        wxCHECK_RET( busLabelRe.IsValid() && busLabelRe.Matches( m_Label ),
+                     wxT( "<" ) + m_Label + wxT( "> is not a valid bus label." ) );
+
+        busName = busLabelRe.GetMatch( m_Label, 1 );
+        busNumber = busLabelRe.GetMatch( m_Label, 2 );
+    }
 
     if( m_Type == NET_HIERLABEL )
         m_Type = NET_HIERBUSLABELMEMBER;
@@ -256,12 +272,8 @@ void NETLIST_OBJECT::ConvertBusToNetListItems( NETLIST_OBJECT_LIST& aNetListItem
         wxCHECK_RET( false, wxT( "Net list object type is not valid." ) );
 
     unsigned i;
-    wxString tmp, busName, busNumber;
     long begin, end, member;
 
-    busName = busLabelRe.GetMatch( m_Label, 1 );
-    busNumber = busLabelRe.GetMatch( m_Label, 2 );
-
     /* Search for  '[' because a bus label is like "busname[nn..mm]" */
     i = busNumber.Find( '[' );
     i++;
@@ -285,6 +285,8 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastNetCode;      // Used in intermediate calculation: last net code created
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
+    std::vector<int> m_netSets;     // Used in intermediate calculation: the union-find
+    std::vector<int> m_busSets;     // sets of the items connected by wires, and by buses
 
 public:
     /**
@@ -419,18 +421,37 @@ public:
 
 private:
     /*
-     * Propagate aNewNetCode to items having an internal netcode aOldNetCode
-     * used to interconnect group of items already physically connected,
-     * when a new connection is found between aOldNetCode and aNewNetCode
+     * Fill aItems with the net list items of the sheet aSheet: one task of
+     * BuildNetListInfo(), which runs a task per sheet
      */
-    void propageNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
+    static void extractSheetItems( SCH_SHEET_PATH* aSheet, NETLIST_OBJECT_LIST* aItems );
+
+    /*
+     * Fill aItems with the net list items of the sheet aSheet, another instance of the
+     * screen of the items aSource already extracted: the items of the wires, labels and
+     * sheets are copied to aSheet, those of the components, whose units depend on the
+     * instance, are extracted again
+     */
+    static void copySheetItems( SCH_SHEET_PATH* aSheet, const NETLIST_OBJECT_LIST* aSource,
+                                NETLIST_OBJECT_LIST* aItems );
+
+    /*
+     * Return the root item of the set of aItem, the first item of the set
+     */
+    int findSet( std::vector<int>& aSets, int aItem );
+
+    /*
+     * Merge the sets of aItem1 and aItem2, used to interconnect group of items already
+     * physically connected, when a new connection is found between them
+     */
+    void mergeSets( std::vector<int>& aSets, int aItem1, int aItem2 );
 
     /*
      * This function merges the net codes of groups of objects already connected
      * to labels (wires, bus, pins ... ) when 2 labels are equivalents
      * (i.e. group objects connected by labels)
      */
-    void labelConnect( NETLIST_OBJECT* aLabelRef );
+    void labelConnect();
 
     /* Comparison function to sort by increasing Netcode the list of connected items
      */
@@ -449,25 +470,27 @@ private:
     /**
      * Propagate net codes from a parent sheet to an include sheet,
      * from a pin sheet connection
+     * @param aSheetStarts = the index of the first item of each sheet, then the list size
      */
-    void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
+    void sheetLabelConnect( const std::vector<unsigned>& aSheetStarts );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Search connections between the end points of the items of a sheet, from index
+     * aStart to aEnd - 1 of the list sorted by sheets
+     */
+    void pointToPointConnect( unsigned aStart, unsigned aEnd, bool aIsBus );
 
     /**
-     * Search connections between a junction and segments
-     * Propagate the junction net code to objects connected by this junction.
-     * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * Search connections between junctions or labels and segments
+     * of a sheet, from index aStart to aEnd - 1 of the list sorted by sheets
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( unsigned aStart, unsigned aEnd, bool aIsBus );
 
 
     /**
      * Function connectBusLabels
-     * Propagate the net code (and create it, if not yet existing) between
-     * all bus label member objects connected by they name.
+     * Merge the nets of all bus label member objects connected by a bus
+     * and having the same member value.
      * Search is done in the entire list
      */
     void connectBusLabels();
@@ -250,43 +250,33 @@ int SCH_REFERENCE_LIST::GetLastReference( int aIndex, int aMinValue )
 }
 
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
+int SCH_REFERENCE_NUMBERS::CreateFirstFree( const std::string& aPrefix, int aFirstValue )
 {
-    int expectedId = aFirstValue;
+    PREFIX_NUMBERS& numbers = m_prefixes[aPrefix];
 
-    // We search for expected Id a value >= aFirstValue.
-    // Skip existing Id < aFirstValue
-    unsigned ii = 0;
+    // The numbers are only added, so the search starts after the last number found from
+    // the same first value
+    std::map<int, int>::iterator hint = numbers.m_FirstFree.find( aFirstValue );
+    int expectedId = hint != numbers.m_FirstFree.end() ? hint->second : aFirstValue;
 
-    for( ; ii < aIdList.size(); ii++ )
-    {
-        if( expectedId <= aIdList[ii] )
-            break;
-    }
+    std::set<int>::const_iterator it = numbers.m_Used.lower_bound( expectedId );
 
-    // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
+    // Search for the first hole in the numbers in use
+    while( it != numbers.m_Used.end() && *it == expectedId )
     {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
-
-        expectedId++;
+        ++it;
+        ++expectedId;
     }
 
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
+    numbers.m_Used.insert( expectedId );
+    numbers.m_FirstFree[aFirstValue] = expectedId + 1;
+
     return expectedId;
 }
 
 
 void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
-      SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap )
+      SCH_MULTI_UNIT_REFERENCE_MAP& aLockedUnitMap )
 {
     if ( componentFlatList.size() == 0 )
         return;
@@ -320,33 +310,31 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
     if( aUseSheetNum )
         minRefId = componentFlatList[first].m_SheetNum * aSheetIntervalId + 1;
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    // The numbers in use of all the reference prefixes, found in one pass instead of a
+    // pass for each prefix
+    SCH_REFERENCE_NUMBERS numbers;
 #endif
+    // The count of components still to be annotated by reference prefix: the already
+    // annotated components of the prefixes without any have no unit to give
+    std::map<std::string, int> newCount;
+
+    for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
+    {
+        std::string prefix = componentFlatList[ii].GetRefStr();
+
+        if( componentFlatList[ii].m_IsNew )
+            ++newCount[prefix];
+#ifndef USE_OLD_ALGO
+        numbers.Add( prefix, componentFlatList[ii].m_NumRef );
+#endif
+    }
+
     for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
     {
         if( componentFlatList[ii].m_Flag )
             continue;
 
-        // Check whether this component is in aLockedUnitMap.
-        SCH_REFERENCE_LIST* lockedList = NULL;
-        BOOST_FOREACH( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair, aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
-            {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
-
-                if( thisRef.IsSameInstance( componentFlatList[ii] ) )
-                {
-                    lockedList = &pair.second;
-                    break;
-                }
-            }
-            if( lockedList != NULL ) break;
-        }
+        std::string prefix = componentFlatList[ii].GetRefStr();
 
         if(  ( componentFlatList[first].CompareRef( componentFlatList[ii] ) != 0 )
           || ( aUseSheetNum && ( componentFlatList[first].m_SheetNum != componentFlatList[ii].m_SheetNum ) )  )
@@ -367,8 +355,6 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             // when using sheet number, ensure ref number >= sheet number* aSheetIntervalId
             if( aUseSheetNum )
                 minRefId = componentFlatList[ii].m_SheetNum * aSheetIntervalId + 1;
-
-            GetRefsInUse( first, idList, minRefId );
 #endif
         }
 
@@ -380,9 +366,10 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 #ifdef USE_OLD_ALGO
                 LastReferenceNumber++;
 #else
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+                LastReferenceNumber = numbers.CreateFirstFree( prefix, minRefId );
 #endif
                 componentFlatList[ii].m_NumRef = LastReferenceNumber;
+                --newCount[prefix];
             }
 
             componentFlatList[ii].m_Unit  = 1;
@@ -391,6 +378,24 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             continue;
         }
 
+        // Check whether this component is in aLockedUnitMap.
+        SCH_REFERENCE_LIST* lockedList = NULL;
+        BOOST_FOREACH( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair, aLockedUnitMap )
+        {
+            unsigned n_refs = pair.second.GetCount();
+            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
+            {
+                SCH_REFERENCE &thisRef = pair.second[thisRefI];
+
+                if( thisRef.IsSameInstance( componentFlatList[ii] ) )
+                {
+                    lockedList = &pair.second;
+                    break;
+                }
+            }
+            if( lockedList != NULL ) break;
+        }
+
         // Annotation of multi-unit parts ( n units per part ) (complex case)
         NumberOfUnits = componentFlatList[ii].GetLibComponent()->GetUnitCount();
 
@@ -399,9 +404,10 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 #ifdef USE_OLD_ALGO
             LastReferenceNumber++;
 #else
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+            LastReferenceNumber = numbers.CreateFirstFree( prefix, minRefId );
 #endif
             componentFlatList[ii].m_NumRef = LastReferenceNumber;
+            --newCount[prefix];
 
             if( !componentFlatList[ii].IsUnitsLocked() )
                 componentFlatList[ii].m_Unit = 1;
@@ -430,6 +436,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
                 for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
                 {
                     if( ! thisRef.IsSameInstance( componentFlatList[jj] ) ) continue;
+                    if( componentFlatList[jj].m_IsNew ) --newCount[prefix];
                     componentFlatList[jj].m_NumRef = componentFlatList[ii].m_NumRef;
                     componentFlatList[jj].m_Unit = thisRef.m_Unit;
                     componentFlatList[jj].m_IsNew = false;
@@ -439,7 +446,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             }
         }
 
-        else
+        else if( newCount[prefix] > 0 )
         {
             /* search for others units of this component.
             * we search for others parts that have the same value and the same
@@ -461,8 +468,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
                     if( componentFlatList[jj].m_Flag )    // already tested
                         continue;
 
+                    // The list is sorted by reference prefix first
                     if( componentFlatList[ii].CompareRef( componentFlatList[jj] ) != 0 )
-                        continue;
+                        break;
 
                     if( componentFlatList[jj].CompareValue( componentFlatList[ii] ) != 0 )
                         continue;
@@ -481,6 +489,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
                         componentFlatList[jj].m_Unit   = Unit;
                         componentFlatList[jj].m_Flag   = 1;
                         componentFlatList[jj].m_IsNew  = false;
+                        --newCount[prefix];
                         break;
                     }
                 }
@@ -44,6 +44,14 @@
 // result is very unspecific.
 static const unsigned kLowestDefaultScore = 1;
 
+// The maximum number of aliases shown in the tree for a search: the best scoring ones.
+// Building the tree is the slowest part of a search with many results.
+static const unsigned kMaxSearchResults = 1000;
+
+// The characters of the regular expression and wildcard syntaxes.  The terms without any
+// are plain substrings: all the matchers find them at the same position.
+static const wxString kPatternChars = wxT( ".*+?^${}()|[]\\" );
+
 struct COMPONENT_TREE_SEARCH_CONTAINER::TREE_NODE
 {
     // Levels of nodes.
@@ -62,7 +70,8 @@ struct COMPONENT_TREE_SEARCH_CONTAINER::TREE_NODE
           DisplayInfo( aDisplayInfo ),
           MatchName( aName.Lower() ),
           SearchText( aSearchText.Lower() ),
-          MatchScore( 0 ), PreviousScore( 0 )
+          Index( 0 ),
+          MatchScore( 0 )
     {
     }
 
@@ -76,8 +85,10 @@ struct COMPONENT_TREE_SEARCH_CONTAINER::TREE_NODE
     const wxString MatchName;     ///< Preprocessed: lowercased display name.
     const wxString SearchText;    ///< Other text (keywords, description..) to search in.
 
+    unsigned Index;               ///< Index of an alias in m_aliases, and in the trigram index.
+    std::vector<TREE_NODE*> Units;  ///< The unit nodes of an alias.
+
     unsigned MatchScore;          ///< Result-Score after UpdateSearchTerm()
-    unsigned PreviousScore;       ///< Optimization: used to see if we need any tree update.
     wxTreeItemId TreeId;          ///< Tree-ID if stored in the tree (if MatchScore > 0).
 };
 
@@ -101,7 +112,8 @@ bool COMPONENT_TREE_SEARCH_CONTAINER::scoreComparator( const TREE_NODE* a1, cons
 
 
 COMPONENT_TREE_SEARCH_CONTAINER::COMPONENT_TREE_SEARCH_CONTAINER( PART_LIBS* aLibs )
-    : m_tree( NULL ),
+    : m_index_valid( false ),
+      m_tree( NULL ),
       m_libraries_added( 0 ),
       m_components_added( 0 ),
       m_preselect_unit_number( -1 ),
@@ -157,6 +169,11 @@ void COMPONENT_TREE_SEARCH_CONTAINER::AddAliasList( const wxString& aNodeName,
     TREE_NODE* const lib_node = new TREE_NODE( TREE_NODE::TYPE_LIB,  NULL, NULL,
                                                aNodeName, wxEmptyString, wxEmptyString );
     m_nodes.push_back( lib_node );
+    m_lib_nodes.push_back( lib_node );
+
+    // The new aliases are not in the index, nor in the results of the last search
+    m_index_valid = false;
+    m_last_search.Empty();
 
     BOOST_FOREACH( const wxString& aName, aAliasNameList )
     {
@@ -197,7 +214,9 @@ void COMPONENT_TREE_SEARCH_CONTAINER::AddAliasList( const wxString& aNodeName,
 
         TREE_NODE* alias_node = new TREE_NODE( TREE_NODE::TYPE_ALIAS, lib_node,
                                                a, a->GetName(), display_info, search_text );
+        alias_node->Index = m_aliases.size();
         m_nodes.push_back( alias_node );
+        m_aliases.push_back( alias_node );
 
         if( a->GetPart()->IsMulti() )    // Add all units as sub-nodes.
         {
@@ -211,6 +230,7 @@ void COMPONENT_TREE_SEARCH_CONTAINER::AddAliasList( const wxString& aNodeName,
                                                       wxEmptyString, wxEmptyString );
                 unit_node->Unit = u;
                 m_nodes.push_back( unit_node );
+                alias_node->Units.push_back( unit_node );
             }
         }
 
@@ -226,9 +246,9 @@ LIB_ALIAS* COMPONENT_TREE_SEARCH_CONTAINER::GetSelectedAlias( int* aUnit )
 
     const wxTreeItemId& select_id = m_tree->GetSelection();
 
-    BOOST_FOREACH( TREE_NODE* node, m_nodes )
+    BOOST_FOREACH( TREE_NODE* node, m_shown )
     {
-        if( node->MatchScore > 0 && node->TreeId == select_id )
+        if( node->TreeId == select_id )
         {
             if( aUnit && node->Unit > 0 )
                 *aUnit = node->Unit;
@@ -260,8 +280,18 @@ namespace
 class EDA_COMBINED_MATCHER
 {
 public:
-    EDA_COMBINED_MATCHER( const wxString &aPattern )
+    EDA_COMBINED_MATCHER( const wxString &aPattern ) :
+        m_weight( 1 )
     {
+        // A plain substring is found at the same position by all the matchers below:
+        // only search it once, counting all of them.
+        if( aPattern.find_first_of( kPatternChars ) == wxString::npos )
+        {
+            AddMatcher( aPattern, new EDA_PATTERN_MATCH_SUBSTR() );
+            m_weight = 3;
+            return;
+        }
+
         // Whatever syntax users prefer, it shall be matched.
         AddMatcher( aPattern, new EDA_PATTERN_MATCH_REGEX() );
         AddMatcher( aPattern, new EDA_PATTERN_MATCH_WILDCARD() );
@@ -290,7 +320,7 @@ public:
 
             if ( local_find != EDA_PATTERN_NOT_FOUND )
             {
-                *aMatchersTriggered += 1;
+                *aMatchersTriggered += m_weight;
 
                 if ( local_find < result || result == EDA_PATTERN_NOT_FOUND )
                 {
@@ -317,10 +347,103 @@ private:
     }
 
     std::vector<const EDA_PATTERN_MATCH*> m_matchers;
+    int m_weight;       // the number of matchers a match counts for
 };
 }
 
 
+// The trigrams of a text, each the codes of 3 consecutive characters packed in 63 bits.
+static void addTrigrams( const wxString& aText, std::vector<uint64_t>& aTrigrams )
+{
+    const uint64_t mask = ( (uint64_t) 1 << 63 ) - 1;
+    uint64_t key = 0;
+    unsigned count = 0;
+
+    for( wxString::const_iterator it = aText.begin(); it != aText.end(); ++it )
+    {
+        key = ( ( key << 21 ) | ( (uint64_t) (*it).GetValue() & 0x1FFFFF ) ) & mask;
+
+        if( ++count >= 3 )
+            aTrigrams.push_back( key );
+    }
+}
+
+
+// A term without any regular expression or wildcard syntax, found as a substring.
+static bool isPlainTerm( const wxString& aTerm )
+{
+    return aTerm.find_first_of( kPatternChars ) == wxString::npos;
+}
+
+
+void COMPONENT_TREE_SEARCH_CONTAINER::buildIndex()
+{
+    std::vector<uint64_t> trigrams;
+
+    m_index.clear();
+
+    BOOST_FOREACH( TREE_NODE* node, m_aliases )
+    {
+        trigrams.clear();
+        addTrigrams( node->MatchName, trigrams );
+        addTrigrams( node->Parent->MatchName, trigrams );
+        addTrigrams( node->SearchText, trigrams );
+
+        std::sort( trigrams.begin(), trigrams.end() );
+        trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+        // The aliases are visited in order: each list is sorted
+        BOOST_FOREACH( uint64_t trigram, trigrams )
+            m_index[trigram].push_back( node->Index );
+    }
+
+    m_index_valid = true;
+}
+
+
+void COMPONENT_TREE_SEARCH_CONTAINER::filterCandidates( const wxString& aTerm,
+                                                        std::vector<TREE_NODE*>& aCandidates )
+{
+    if( !m_index_valid )
+        buildIndex();
+
+    std::vector<uint64_t> trigrams;
+    addTrigrams( aTerm, trigrams );
+
+    std::sort( trigrams.begin(), trigrams.end() );
+    trigrams.erase( std::unique( trigrams.begin(), trigrams.end() ), trigrams.end() );
+
+    BOOST_FOREACH( uint64_t trigram, trigrams )
+    {
+        if( aCandidates.empty() )
+            return;
+
+        TRIGRAM_INDEX::const_iterator entry = m_index.find( trigram );
+
+        if( entry == m_index.end() )
+        {
+            aCandidates.clear();
+            return;
+        }
+
+        // Intersection of two lists sorted by alias index
+        const std::vector<unsigned>& aliases = entry->second;
+        std::vector<unsigned>::const_iterator alias = aliases.begin();
+        unsigned kept = 0;
+
+        for( unsigned ii = 0; ii < aCandidates.size() && alias != aliases.end(); ++ii )
+        {
+            alias = std::lower_bound( alias, aliases.end(), aCandidates[ii]->Index );
+
+            if( alias != aliases.end() && *alias == aCandidates[ii]->Index )
+                aCandidates[kept++] = aCandidates[ii];
+        }
+
+        aCandidates.resize( kept );
+    }
+}
+
+
 void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch )
 {
     if( m_tree == NULL )
@@ -331,17 +454,40 @@ void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch
     unsigned starttime =  GetRunningMicroSecs();
 #endif
 
-    // We score the list by going through it several time, essentially with a complexity
-    // of O(n). For the default library of 2000+ items, this typically takes less than 5ms
-    // on an i5. Good enough, no index needed.
+    // Only the aliases containing the trigrams of the plain terms of 3 characters or more
+    // are scored.  A search extending the previous plain search only finds some of its
+    // results: the previous terms, or their extensions, are still substrings to find.
+    const wxString search = aSearch.Lower();
+    const bool     refine = !m_last_search.IsEmpty() && isPlainTerm( search )
+                            && search.StartsWith( m_last_search );
 
-    // Initial AND condition: Leaf nodes are considered to match initially.
-    BOOST_FOREACH( TREE_NODE* node, m_nodes )
+    std::vector<TREE_NODE*> candidates( refine ? m_matches : m_aliases );
+    wxStringTokenizer       tokenizer( search );
+
+    while( tokenizer.HasMoreTokens() )
     {
-        node->PreviousScore = node->MatchScore;
-        node->MatchScore = ( node->Type == TREE_NODE::TYPE_LIB ) ? 0 : kLowestDefaultScore;
+        const wxString term = tokenizer.GetNextToken();
+
+        if( term.length() >= 3 && isPlainTerm( term ) )
+            filterCandidates( term, candidates );
+    }
+
+    // The scores of the previous search, to see if we need any tree update.
+    std::vector< std::pair<TREE_NODE*, unsigned> > previous;
+
+    BOOST_FOREACH( TREE_NODE* node, m_matches )
+    {
+        previous.push_back( std::make_pair( node, node->MatchScore ) );
+        node->MatchScore = 0;
+
+        BOOST_FOREACH( TREE_NODE* unit, node->Units )
+            unit->MatchScore = 0;
     }
 
+    // Initial AND condition: Leaf nodes are considered to match initially.
+    BOOST_FOREACH( TREE_NODE* node, candidates )
+        node->MatchScore = kLowestDefaultScore;
+
     // Create match scores for each node for all the terms, that come space-separated.
     // Scoring adds up values for each term according to importance of the match. If a term does
     // not match at all, the result is thrown out of the results (AND semantics).
@@ -353,18 +499,15 @@ void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch
     //     first so contribute more to the score.
     //
     // This is of course subject to tweaking.
-    wxStringTokenizer tokenizer( aSearch );
+    tokenizer.SetString( search );
 
     while ( tokenizer.HasMoreTokens() )
     {
-        const wxString term = tokenizer.GetNextToken().Lower();
+        const wxString term = tokenizer.GetNextToken();
         EDA_COMBINED_MATCHER matcher( term );
 
-        BOOST_FOREACH( TREE_NODE* node, m_nodes )
+        BOOST_FOREACH( TREE_NODE* node, candidates )
         {
-            if( node->Type != TREE_NODE::TYPE_ALIAS )
-                continue;      // Only aliases are actually scored here.
-
             if( node->MatchScore == 0)
                 continue;   // Leaf node without score are out of the game.
 
@@ -401,39 +544,92 @@ void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch
         }
     }
 
-    // Library nodes have the maximum score seen in any of their children.
-    // Alias nodes have the score of their parents.
-    unsigned highest_score_seen = 0;
-    bool any_change = false;
+    m_matches.clear();
 
-    BOOST_FOREACH( TREE_NODE* node, m_nodes )
+    BOOST_FOREACH( TREE_NODE* node, candidates )
     {
-        switch( node->Type )
-        {
-        case TREE_NODE::TYPE_ALIAS:
-            {
-                any_change |= (node->PreviousScore != node->MatchScore);
-                // Update library score.
-                node->Parent->MatchScore = std::max( node->Parent->MatchScore, node->MatchScore );
-                highest_score_seen = std::max( highest_score_seen, node->MatchScore );
-            }
-            break;
+        if( node->MatchScore > 0 )
+            m_matches.push_back( node );
+    }
 
-        case TREE_NODE::TYPE_UNIT:
-            node->MatchScore = node->Parent->MatchScore;
-            break;
+    m_last_search = search;
 
-        default:
-            break;
-        }
-    }
+    bool any_change = ( previous.size() != m_matches.size() );
+
+    for( unsigned ii = 0; !any_change && ii < m_matches.size(); ++ii )
+        any_change = ( previous[ii].first != m_matches[ii]
+                       || previous[ii].second != m_matches[ii]->MatchScore );
 
     // The tree update might be slow, so we want to bail out if there is no change.
     if( !any_change )
         return;
 
-    // Now: sort all items according to match score, libraries first.
-    std::sort( m_nodes.begin(), m_nodes.end(), scoreComparator );
+    // Library nodes have the maximum score seen in any of their children.
+    // Unit nodes have the score of their parents.
+    unsigned highest_score_seen = 0;
+
+    BOOST_FOREACH( TREE_NODE* node, m_lib_nodes )
+        node->MatchScore = 0;
+
+    BOOST_FOREACH( TREE_NODE* node, m_matches )
+    {
+        node->Parent->MatchScore = std::max( node->Parent->MatchScore, node->MatchScore );
+        highest_score_seen = std::max( highest_score_seen, node->MatchScore );
+
+        BOOST_FOREACH( TREE_NODE* unit, node->Units )
+            unit->MatchScore = node->MatchScore;
+    }
+
+    // If we have nodes that go beyond the default score, suppress nodes that
+    // have the default score. That can happen if they have an honary += 0 score due to
+    // some one-letter match in the keyword or description. In this case, we prefer matches
+    // that just have higher scores. Improves relevancy and performance as the tree has to
+    // display less items.
+    std::vector<TREE_NODE*> aliases;
+
+    BOOST_FOREACH( TREE_NODE* node, m_matches )
+    {
+        if( highest_score_seen <= kLowestDefaultScore || node->MatchScore > kLowestDefaultScore )
+            aliases.push_back( node );
+    }
+
+    // Now: sort the aliases according to match score.  Only the best ones of a search with
+    // too many results are shown.
+    if( !search.IsEmpty() && aliases.size() > kMaxSearchResults )
+    {
+        std::partial_sort( aliases.begin(), aliases.begin() + kMaxSearchResults, aliases.end(),
+                           scoreComparator );
+        aliases.resize( kMaxSearchResults );
+    }
+    else
+    {
+        std::sort( aliases.begin(), aliases.end(), scoreComparator );
+    }
+
+    // The nodes of the tree: the libraries of the shown aliases first, then the aliases,
+    // then their units.
+    std::set<const TREE_NODE*> shown_libs;
+    std::vector<TREE_NODE*>    units;
+
+    m_shown.clear();
+
+    BOOST_FOREACH( TREE_NODE* node, aliases )
+    {
+        shown_libs.insert( node->Parent );
+        units.insert( units.end(), node->Units.begin(), node->Units.end() );
+    }
+
+    std::sort( m_lib_nodes.begin(), m_lib_nodes.end(), scoreComparator );
+    std::sort( units.begin(), units.end(), scoreComparator );
+
+    BOOST_FOREACH( TREE_NODE* node, m_lib_nodes )
+    {
+        if( shown_libs.count( node ) )
+            m_shown.push_back( node );
+    }
+
+    m_shown.insert( m_shown.end(), aliases.begin(), aliases.end() );
+    m_shown.insert( m_shown.end(), units.begin(), units.end() );
 
 #ifdef SHOW_CALC_TIME
     unsigned sorttime = GetRunningMicroSecs();
@@ -447,19 +643,8 @@ void COMPONENT_TREE_SEARCH_CONTAINER::UpdateSearchTerm( const wxString& aSearch
     const TREE_NODE* first_match = NULL;
     const TREE_NODE* preselected_node = NULL;
 
-    BOOST_FOREACH( TREE_NODE* node, m_nodes )
+    BOOST_FOREACH( TREE_NODE* node, m_shown )
     {
-        if( node->MatchScore == 0 )
-            continue;
-
-        // If we have nodes that go beyond the default score, suppress nodes that
-        // have the default score. That can happen if they have an honary += 0 score due to
-        // some one-letter match in the keyword or description. In this case, we prefer matches
-        // that just have higher scores. Improves relevancy and performance as the tree has to
-        // display less items.
-        if( highest_score_seen > kLowestDefaultScore && node->MatchScore == kLowestDefaultScore )
-            continue;
-
         wxString node_text;
 #if 0
         // Node text with scoring information for debugging
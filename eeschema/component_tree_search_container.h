@@ -25,6 +25,8 @@
 #define COMPONENT_TREE_SEARCH_CONTAINER_H
 
 #include <vector>
+#include <stdint.h>
+#include <boost/unordered_map.hpp>
 #include <wx/string.h>
 
 class LIB_ALIAS;
@@ -39,7 +41,8 @@ class wxArrayString;
 // libraries, leafs: components), scored by relevance.
 //
 // The scored result list is adpated on each update on the search-term: this allows
-// to have a search-as-you-type experience.
+// to have a search-as-you-type experience.  The aliases are indexed by the trigrams of
+// their texts, and a search extending the previous one only scores the previous results.
 class COMPONENT_TREE_SEARCH_CONTAINER
 {
 public:
@@ -129,7 +132,33 @@ private:
     struct TREE_NODE;
     static bool scoreComparator( const TREE_NODE* a1, const TREE_NODE* a2 );
 
-    std::vector<TREE_NODE*> m_nodes;
+    /**
+     * Function buildIndex
+     * fills m_index with the aliases whose name, library name, keywords or description
+     * contain each sequence of 3 characters: the trigrams of the searched texts.
+     */
+    void buildIndex();
+
+    /**
+     * Function filterCandidates
+     * removes from aCandidates, sorted in the order of m_aliases, the aliases missing
+     * one of the trigrams of aTerm: they cannot contain aTerm as a substring.
+     */
+    void filterCandidates( const wxString& aTerm, std::vector<TREE_NODE*>& aCandidates );
+
+    /// The aliases of each trigram, by their index in m_aliases
+    typedef boost::unordered_map< uint64_t, std::vector<unsigned> > TRIGRAM_INDEX;
+
+    std::vector<TREE_NODE*> m_nodes;        ///< all the nodes, owned
+    std::vector<TREE_NODE*> m_lib_nodes;    ///< the library nodes
+    std::vector<TREE_NODE*> m_aliases;      ///< the alias nodes, in the order they were added
+    std::vector<TREE_NODE*> m_matches;      ///< the aliases of the last search, in that order
+    std::vector<TREE_NODE*> m_shown;        ///< the nodes in the tree, libraries first
+
+    TRIGRAM_INDEX   m_index;
+    bool            m_index_valid;
+    wxString        m_last_search;          ///< the lowercased last search, for a refinement
+
     wxTreeCtrl* m_tree;
     int m_libraries_added;
     int m_components_added;
@@ -489,74 +489,8 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
 
     std::auto_ptr<NETLIST_OBJECT_LIST> objectsConnectedList( m_parent->BuildNetListBase() );
 
-    // Reset the connection type indicator
-    objectsConnectedList->ResetConnectionsType();
-
-    unsigned lastNet;
-    unsigned nextNet = lastNet = 0;
-    int MinConn    = NOC;
-
-    for( unsigned net = 0; net < objectsConnectedList->size(); net++ )
-    {
-        if( objectsConnectedList->GetItemNet( lastNet ) !=
-            objectsConnectedList->GetItemNet( net ) )
-        {
-            // New net found:
-            MinConn    = NOC;
-            nextNet   = net;
-        }
-
-        switch( objectsConnectedList->GetItemType( net ) )
-        {
-        // These items do not create erc problems
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
-        case NET_BUSLABELMEMBER:
-        case NET_PINLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-            break;
-
-        case NET_HIERLABEL:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_SHEETLABEL:
-        case NET_SHEETBUSLABELMEMBER:
-            // ERC problems when pin sheets do not match hierarchical labels.
-            // Each pin sheet must match a hierarchical label
-            // Each hierarchical label must match a pin sheet
-            objectsConnectedList->TestforNonOrphanLabel( net, nextNet );
-            break;
-        case NET_GLOBLABEL:
-            if( m_tstUniqueGlobalLabels )
-                objectsConnectedList->TestforNonOrphanLabel( net, nextNet );
-            break;
-
-        case NET_NOCONNECT:
-
-            // ERC problems when a noconnect symbol is connected to more than one pin.
-            MinConn = NET_NC;
-
-            if( objectsConnectedList->CountPinsInNet( nextNet ) > 1 )
-                Diagnose( objectsConnectedList->GetItem( net ), NULL, MinConn, UNC );
-
-            break;
-
-        case NET_PIN:
-
-            // Look for ERC problems between pins:
-            TestOthersItems( objectsConnectedList.get(), net, nextNet, &MinConn );
-            break;
-        }
-
-        lastNet = net;
-    }
-
-    // Test similar labels (i;e. labels which are identical when
-    // using case insensitive comparisons)
-    if( m_TestSimilarLabels )
-        objectsConnectedList->TestforSimilarLabels();
+    TestErcConnections( objectsConnectedList.get(), m_tstUniqueGlobalLabels,
+                        m_TestSimilarLabels );
 
     // Displays global results:
     updateMarkerCounts( &screens );
@@ -40,6 +40,8 @@
 #include <dialog_plot_schematic.h>
 #include <wx_html_report_panel.h>
 
+#include <set>
+
 // Keys for configuration
 #define PLOT_FORMAT_KEY wxT( "PlotFormat" )
 #define PLOT_MODECOLOR_KEY wxT( "PlotModeColor" )
@@ -354,3 +356,26 @@ wxFileName DIALOG_PLOT_SCHEMATIC::createPlotFileName( wxTextCtrl* aOutputDirecto
     fn.SetPath( outputDir.GetFullPath() );
     return fn;
 }
+
+
+void DIALOG_PLOT_SCHEMATIC::splitPlotBatches( SCH_SHEET_LIST& aSheetList,
+                                              std::vector<unsigned>& aBatchStarts )
+{
+    std::set<const SCH_SCREEN*> screens;
+
+    aBatchStarts.clear();
+
+    for( unsigned i = 0; i < aSheetList.size(); i++ )
+    {
+        const SCH_SCREEN* screen = aSheetList[i].LastScreen();
+
+        if( i == 0 || !screens.insert( screen ).second )
+        {
+            aBatchStarts.push_back( i );
+            screens.clear();
+            screens.insert( screen );
+        }
+    }
+
+    aBatchStarts.push_back( aSheetList.size() );
+}
@@ -91,11 +91,45 @@ private:
 
     void PlotSchematic( bool aPlotAll );
 
+    /// A sheet plotted on a thread, with the state of the frame for its sheet path
+    struct PLOT_SHEET
+    {
+        SCH_SCREEN* m_screen;
+        wxString    m_sheetDesc;        ///< the human readable sheet path
+        wxString    m_fileName;         ///< the plot file, for the formats with a file per sheet
+        bool        m_success;
+        wxString    m_error;            ///< the exception message of a failed plot
+        std::string m_pageStream;       ///< the compressed content of a PDF page
+    };
+
+    /**
+     * Function splitPlotBatches
+     * splits a sheet list in ranges of consecutive sheets using each screen once: the
+     * sheets of a range can be plotted on several threads.  The component references of
+     * a screen shared by several sheets depend on the sheet being plotted.
+     *
+     * @param aSheetList is the list of the sheets to plot.
+     * @param aBatchStarts [out] is the index of the first sheet of each range, followed
+     *                     by the count of sheets.
+     */
+    static void splitPlotBatches( SCH_SHEET_LIST& aSheetList,
+                                  std::vector<unsigned>& aBatchStarts );
+
     // PDF
     void    createPDFFile( bool aPlotAll, bool aPlotFrameRef );
-    void    plotOneSheetPDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen, bool aPlotFrameRef);
+    void    plotOneSheetPDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen,
+                             const wxString& aSheetDesc, bool aPlotFrameRef );
     void    setupPlotPagePDF( PLOTTER* aPlotter, SCH_SCREEN* aScreen );
 
+    /**
+     * Function plotPagePDF
+     * plots a page into \a aPlotter, or else into a new plotter whose compressed page
+     * is kept in \a aSheet.  The task of a sheet plotted on a thread: the options of
+     * the dialog are passed, its controls are not read.
+     */
+    void    plotPagePDF( PLOT_SHEET* aSheet, PDF_PLOTTER* aPlotter, bool aPlotColor,
+                         bool aPlotFrameRef );
+
     /**
     * Everything done, close the plot and restore the environment
     * @param aPlotter the plotter to close and destroy
@@ -134,6 +168,14 @@ private:
     // SVG
     void    createSVGFile( bool aPlotAll, bool aPlotFrameRef );
 
+    static bool plotOneSheetSVG( const wxString& aFileName, SCH_SCREEN* aScreen,
+                                 const TITLE_BLOCK& aTitleBlock, const PAGE_INFO& aPageInfo,
+                                 const wxString& aSheetDesc,
+                                 bool aPlotBlackAndWhite, bool aPlotFrameRef );
+
+    // The task of a sheet plotted on a thread
+    static void plotSheetSVG( PLOT_SHEET* aSheet, bool aPlotBlackAndWhite, bool aPlotFrameRef );
+
     /**
      * Create a file name with an absolute path name
      * @param aOutputDirectoryName the diretory name to plot,
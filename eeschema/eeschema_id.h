@@ -64,6 +64,10 @@ enum id_eeschema_frm
     /* Schematic editor main menubar IDs. */
     ID_RESCUE_CACHED,
 
+    ID_MENU_SCH_CANVAS_LEGACY,
+    ID_MENU_SCH_CANVAS_OPENGL,
+    ID_MENU_SCH_CANVAS_CAIRO,
+
     /* Schematic editor horizontal toolbar IDs */
     ID_HIERARCHY,
     ID_TO_LIBVIEW,
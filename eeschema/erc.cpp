@@ -41,6 +41,8 @@
 #include <sch_component.h>
 #include <sch_sheet.h>
 
+#include <hashtables.h>
+
 #include <wx/ffile.h>
 
 
@@ -522,6 +524,79 @@ int NETLIST_OBJECT_LIST::CountPinsInNet( unsigned aNetStart )
     return count;
 }
 
+void TestErcConnections( NETLIST_OBJECT_LIST* aList, bool aTestUniqueGlobalLabels,
+                         bool aTestSimilarLabels )
+{
+    // Reset the connection type indicator
+    aList->ResetConnectionsType();
+
+    unsigned lastNet;
+    unsigned nextNet = lastNet = 0;
+    int MinConn    = NOC;
+
+    for( unsigned net = 0; net < aList->size(); net++ )
+    {
+        if( aList->GetItemNet( lastNet ) != aList->GetItemNet( net ) )
+        {
+            // New net found:
+            MinConn    = NOC;
+            nextNet   = net;
+        }
+
+        switch( aList->GetItemType( net ) )
+        {
+        // These items do not create erc problems
+        case NET_ITEM_UNSPECIFIED:
+        case NET_SEGMENT:
+        case NET_BUS:
+        case NET_JUNCTION:
+        case NET_LABEL:
+        case NET_BUSLABELMEMBER:
+        case NET_PINLABEL:
+        case NET_GLOBBUSLABELMEMBER:
+            break;
+
+        case NET_HIERLABEL:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_SHEETLABEL:
+        case NET_SHEETBUSLABELMEMBER:
+            // ERC problems when pin sheets do not match hierarchical labels.
+            // Each pin sheet must match a hierarchical label
+            // Each hierarchical label must match a pin sheet
+            aList->TestforNonOrphanLabel( net, nextNet );
+            break;
+        case NET_GLOBLABEL:
+            if( aTestUniqueGlobalLabels )
+                aList->TestforNonOrphanLabel( net, nextNet );
+            break;
+
+        case NET_NOCONNECT:
+
+            // ERC problems when a noconnect symbol is connected to more than one pin.
+            MinConn = NET_NC;
+
+            if( aList->CountPinsInNet( nextNet ) > 1 )
+                Diagnose( aList->GetItem( net ), NULL, MinConn, UNC );
+
+            break;
+
+        case NET_PIN:
+
+            // Look for ERC problems between pins:
+            TestOthersItems( aList, net, nextNet, &MinConn );
+            break;
+        }
+
+        lastNet = net;
+    }
+
+    // Test similar labels (i;e. labels which are identical when
+    // using case insensitive comparisons)
+    if( aTestSimilarLabels )
+        aList->TestforSimilarLabels();
+}
+
+
 bool WriteDiagnosticERC( const wxString& aFullFileName )
 {
     wxString    msg;
@@ -620,51 +695,64 @@ void NETLIST_OBJECT_LIST::TestforNonOrphanLabel( unsigned aNetItemRef, unsigned
 // when they are compared using case insensitive coparisons.
 
 
-// A helper struct to compare NETLIST_OBJECT items by sheetpath and label texts
-// for a std::set<NETLIST_OBJECT*> container
-// the full text is "sheetpath+label" for local labels and "label" for global labels
-struct compare_labels
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
-    {
-        wxString str1 = lab1->m_SheetPath.Path() + lab1->m_Label;
-        wxString str2 = lab2->m_SheetPath.Path() + lab2->m_Label;
+// Helper function: creates a marker for similar labels ERC warning
+static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
 
-        return str1.Cmp( str2 ) < 0;
-    }
-};
 
-struct compare_label_names
+typedef boost::unordered_map< wxString, int, WXSTRING_HASH >                    LABEL_COUNTS;
+typedef boost::unordered_map< wxString, std::vector<unsigned>, WXSTRING_HASH >  LABEL_GROUPS;
+
+
+// The labels examined by TestforSimilarLabels(), each label name once per sheet path,
+// and the number of each label, used to choose the better item in diag messages
+struct SIMILAR_LABELS
 {
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
+    std::vector<NETLIST_OBJECT*>    m_labels;
+    std::vector<wxString>           m_keys;         // sheet path + label of m_labels
+    LABEL_COUNTS                    m_sheetCounts;  // by sheet path + label
+    LABEL_COUNTS                    m_globalCounts; // of the global labels, by label
+
+    // Count the number of labels identical to a label:
+    //  for global label: global labels in the full project
+    //  for local label: all labels in the current sheet
+    int Count( unsigned aLabel )
     {
-        return lab1->m_Label.Cmp( lab2->m_Label ) < 0;
+        if( m_labels[aLabel]->IsLabelGlobal() )
+            return m_globalCounts[ m_labels[aLabel]->m_Label ];
+
+        return m_sheetCounts[ m_keys[aLabel] ];
     }
-};
 
-struct compare_paths
-{
-    bool operator() ( const NETLIST_OBJECT* lab1, const NETLIST_OBJECT* lab2 )
+    // Create the markers of a group of labels, which are different when using case
+    // sensitive comparisons but are equal when using case insensitive comparisons
+    void DiagnoseGroup( const std::vector<unsigned>& aGroup, bool aSkipGlobalPairs )
     {
-        return lab1->m_SheetPath.Path().Cmp( lab2->m_SheetPath.Path() ) < 0;
+        for( unsigned ii = 0; ii < aGroup.size(); ii++ )
+        {
+            for( unsigned jj = ii + 1; jj < aGroup.size(); jj++ )
+            {
+                NETLIST_OBJECT* itemA = m_labels[aGroup[ii]];
+                NETLIST_OBJECT* itemB = m_labels[aGroup[jj]];
+
+                if( aSkipGlobalPairs && itemA->IsLabelGlobal() && itemB->IsLabelGlobal() )
+                    continue;
+
+                if( Count( aGroup[ii] ) <= Count( aGroup[jj] ) )
+                    SimilarLabelsDiagnose( itemA, itemB );
+                else
+                    SimilarLabelsDiagnose( itemB, itemA );
+            }
+        }
     }
 };
 
-// Helper functions to build the warning messages about Similar Labels:
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel );
-static void SimilarLabelsDiagnose( NETLIST_OBJECT* aItemA, NETLIST_OBJECT* aItemB );
-
 
 void NETLIST_OBJECT_LIST::TestforSimilarLabels()
 {
     // Similar labels which are different when using case sensitive comparisons
-    // but are equal when using case insensitive comparisons
-
-    // list of all labels (used the better item to build diag messages)
-    std::vector<NETLIST_OBJECT*> fullLabelList;
-    // list of all labels , each label appears only once (used to to detect similar labels)
-    std::set<NETLIST_OBJECT*, compare_labels> uniqueLabelList;
-    wxString msg;
+    // but are equal when using case insensitive comparisons.  The labels are grouped
+    // in hash maps by their case folded texts, only the labels of a group are compared.
+    SIMILAR_LABELS labels;
 
     // Build a list of differents labels. If inside a given sheet there are
     // more than one given label, only one label is stored.
@@ -683,9 +771,20 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         case NET_HIERLABEL:
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBLABEL:
+        {
             // add this label in lists
-            uniqueLabelList.insert( GetItem( netItem ) );
-            fullLabelList.push_back( GetItem( netItem ) );
+            NETLIST_OBJECT* item = GetItem( netItem );
+            wxString        key = item->m_SheetPath.Path() + item->m_Label;
+
+            if( ++labels.m_sheetCounts[key] == 1 )
+            {
+                labels.m_labels.push_back( item );
+                labels.m_keys.push_back( key );
+            }
+
+            if( item->IsLabelGlobal() )
+                ++labels.m_globalCounts[item->m_Label];
+        }
             break;
 
         case NET_SHEETLABEL:
@@ -695,118 +794,50 @@ void NETLIST_OBJECT_LIST::TestforSimilarLabels()
         }
     }
 
-    // build global labels and compare
-    std::set<NETLIST_OBJECT*, compare_label_names> loc_labelList;
-    std::set<NETLIST_OBJECT*>::const_iterator it;
+    // Group the global labels (same label names appears only once in groups),
+    // and the labels inside each sheet path
+    LABEL_COUNTS          globalNames;
+    LABEL_GROUPS          globalGroups;
+    LABEL_GROUPS          sheetGroups;
+    std::vector<wxString> globalKeys( labels.m_labels.size() );
+    std::vector<wxString> sheetKeys( labels.m_labels.size() );
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
+    for( unsigned ii = 0; ii < labels.m_labels.size(); ii++ )
     {
-        if( (*it)->IsLabelGlobal() )
-            loc_labelList.insert( *it );
-    }
+        NETLIST_OBJECT* item = labels.m_labels[ii];
 
-    // compare global labels (same label names appears only once in list)
-    for( it = loc_labelList.begin(); it != loc_labelList.end(); ++it )
-    {
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = it;
-
-        for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
+        if( item->IsLabelGlobal()
+            && globalNames.insert( std::make_pair( item->m_Label, (int) ii ) ).second )
         {
-            if( (*it)->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-            {
-                // Create new marker for ERC.
-                int cntA = countIndenticalLabels( fullLabelList, *it );
-                int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                if( cntA <= cntB )
-                    SimilarLabelsDiagnose( (*it), (*it_aux) );
-                else
-                    SimilarLabelsDiagnose( (*it_aux), (*it) );
-            }
+            globalKeys[ii] = item->m_Label.Lower();
+            globalGroups[globalKeys[ii]].push_back( ii );
         }
-    }
-
-    // Build paths list
-    std::set<NETLIST_OBJECT*, compare_paths> pathsList;
 
-    for( it = uniqueLabelList.begin(); it != uniqueLabelList.end(); ++it )
-        pathsList.insert( *it );
+        sheetKeys[ii] = labels.m_keys[ii].Lower();
+        sheetGroups[sheetKeys[ii]].push_back( ii );
+    }
 
-    // Examine each label inside a sheet path:
-    for( it = pathsList.begin(); it != pathsList.end(); ++it )
+    // compare global labels, the markers of a group are created at its first label
+    for( unsigned ii = 0; ii < labels.m_labels.size(); ii++ )
     {
-        loc_labelList.clear();
-
-        std::set<NETLIST_OBJECT*>::const_iterator it_aux = uniqueLabelList.begin();
-
-        for( ; it_aux != uniqueLabelList.end(); ++it_aux )
-        {
-            if( (*it)->m_SheetPath.Path() == (*it_aux)->m_SheetPath.Path() )
-                loc_labelList.insert( *it_aux );
-        }
-
-        // at this point, loc_labelList contains labels of the current sheet path.
-        // Detect similar labels (same label names appears only once in list)
-        std::set<NETLIST_OBJECT*>::const_iterator ref_it;
-
-        for( ref_it = loc_labelList.begin(); ref_it != loc_labelList.end(); ++ref_it )
-        {
-            NETLIST_OBJECT* ref_item = *ref_it;
-            it_aux = ref_it;
+        if( globalKeys[ii].IsEmpty() )
+            continue;
 
-            for( ++it_aux; it_aux != loc_labelList.end(); ++it_aux )
-            {
-                // global label versus global label was already examined.
-                // here, at least one label must be local
-                if( ref_item->IsLabelGlobal() && (*it_aux)->IsLabelGlobal() )
-                    continue;
+        const std::vector<unsigned>& group = globalGroups[globalKeys[ii]];
 
-                if( ref_item->m_Label.CmpNoCase( (*it_aux)->m_Label ) == 0 )
-                {
-                    // Create new marker for ERC.
-                    int cntA = countIndenticalLabels( fullLabelList, ref_item );
-                    int cntB = countIndenticalLabels( fullLabelList, *it_aux );
-
-                    if( cntA <= cntB )
-                        SimilarLabelsDiagnose( ref_item, (*it_aux) );
-                    else
-                        SimilarLabelsDiagnose( (*it_aux), ref_item );
-                }
-            }
-        }
+        if( group[0] == ii )
+            labels.DiagnoseGroup( group, false );
     }
-}
-
-// Helper function: count the number of labels identical to aLabel
-//  for global label: global labels in the full project
-//  for local label: all labels in the current sheet
-static int countIndenticalLabels( std::vector<NETLIST_OBJECT*>& aList, NETLIST_OBJECT* aLabel )
-{
-    int count = 0;
 
-    if( aLabel->IsLabelGlobal() )
+    // Examine each label inside a sheet path: global label versus global label was
+    // already examined, here at least one label must be local
+    for( unsigned ii = 0; ii < labels.m_labels.size(); ii++ )
     {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
+        const std::vector<unsigned>& group = sheetGroups[sheetKeys[ii]];
 
-            if( item->IsLabelGlobal() && item->m_Label == aLabel->m_Label )
-                count++;
-        }
+        if( group[0] == ii )
+            labels.DiagnoseGroup( group, true );
     }
-    else
-    {
-        for( unsigned netItem = 0; netItem < aList.size(); ++netItem )
-        {
-            NETLIST_OBJECT* item = aList[netItem];
-
-            if( item->m_Label == aLabel->m_Label &&
-                item->m_SheetPath.Path() == aLabel->m_SheetPath.Path() )
-                count++;
-        }
-    }
-
-    return count;
 }
 
 // Helper function: creates a marker for similar labels ERC warning
@@ -98,6 +98,19 @@ void TestOthersItems( NETLIST_OBJECT_LIST* aList,
                              unsigned aNetItemRef, unsigned aNetStart,
                              int* aMinConnexion );
 
+/**
+ * Function TestErcConnections
+ * performs the ERC tests of the connected items of the schematic, and creates the ERC
+ * markers of the problems found.
+ * @param aList = the list of connected objects, see SCH_EDIT_FRAME::BuildNetListBase()
+ * @param aTestUniqueGlobalLabels = true to test the global labels not connected to
+ *                                  another global label
+ * @param aTestSimilarLabels = true to test the labels equal when using case insensitive
+ *                             comparisons
+ */
+void TestErcConnections( NETLIST_OBJECT_LIST* aList, bool aTestUniqueGlobalLabels,
+                         bool aTestSimilarLabels );
+
 /**
  * Function TestDuplicateSheetNames( )
  * inside a given sheet, one cannot have sheets with duplicate names (file
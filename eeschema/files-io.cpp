@@ -309,10 +309,13 @@ bool SCH_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
         UpdateFileHistory( fullFileName );
 
         // Check to see whether some old library parts need to be rescued
-        // Only do this if RescueNeverShow was not set.
+        // Only do this if RescueNeverShow was not set, and not in a batch job
+        // whose rescue dialog would have no user.
         wxConfigBase *config = Kiface().KifaceSettings();
-        bool rescueNeverShow = false;
-        config->Read( RescueNeverShowEntry, &rescueNeverShow, false );
+        bool rescueNeverShow = IsBatchMode();
+
+        if( !rescueNeverShow )
+            config->Read( RescueNeverShowEntry, &rescueNeverShow, false );
 
         if( !rescueNeverShow )
         {
@@ -328,7 +331,7 @@ bool SCH_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
     Zoom_Automatique( false );
     SetSheetNumberAndCount();
 
-    m_canvas->Refresh( true );
+    RedrawCanvas( true );
 
     return true;
 }
@@ -454,7 +457,7 @@ bool SCH_EDIT_FRAME::AppendOneEEProject()
     GetScreen()->SetGrid( ID_POPUP_GRID_LEVEL_1000 + m_LastGridSizeId );
     Zoom_Automatique( false );
     SetSheetNumberAndCount();
-    m_canvas->Refresh( true );
+    RedrawCanvas( true );
     return success;
 }
 
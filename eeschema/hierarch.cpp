@@ -308,6 +308,6 @@ void SCH_EDIT_FRAME::DisplayCurrentSheet()
     // ( previous position of cursor ...) and artefacts can happen
     // mainly when sheet size has changed
     // This second refresh clears artefacts because at this point,
-    // all parameters are now updated
-    m_canvas->Refresh();
+    // all parameters are now updated.  The GAL canvas loads the items of the new sheet.
+    RedrawCanvas( true );
 }
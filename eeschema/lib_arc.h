@@ -124,6 +124,15 @@ public:
 
     wxPoint GetPosition() const { return m_Pos; }
 
+    int GetRadius() const { return m_Radius; }
+
+    ///> The angles of the arc ends, in 0.1 degrees
+    int GetFirstRadiusAngle() const { return m_t1; }
+    int GetSecondRadiusAngle() const { return m_t2; }
+
+    wxPoint GetStart() const { return m_ArcStart; }
+    wxPoint GetEnd() const { return m_ArcEnd; }
+
     void MirrorHorizontal( const wxPoint& aCenter );
 
     void MirrorVertical( const wxPoint& aCenter );
@@ -161,6 +161,7 @@ int LIB_BEZIER::compare( const LIB_ITEM& aOther ) const
 
 void LIB_BEZIER::SetOffset( const wxPoint& aOffset )
 {
+    m_drawCorners.Clear();
     size_t i;
 
     for( i = 0; i < m_BezierPoints.size(); i++ )
@@ -191,6 +192,7 @@ void LIB_BEZIER::Move( const wxPoint& aPosition )
 
 void LIB_BEZIER::MirrorHorizontal( const wxPoint& aCenter )
 {
+    m_drawCorners.Clear();
     size_t i, imax = m_PolyPoints.size();
 
     for( i = 0; i < imax; i++ )
@@ -212,6 +214,7 @@ void LIB_BEZIER::MirrorHorizontal( const wxPoint& aCenter )
 
 void LIB_BEZIER::MirrorVertical( const wxPoint& aCenter )
 {
+    m_drawCorners.Clear();
     size_t i, imax = m_PolyPoints.size();
 
     for( i = 0; i < imax; i++ )
@@ -233,6 +236,7 @@ void LIB_BEZIER::MirrorVertical( const wxPoint& aCenter )
 
 void LIB_BEZIER::Rotate( const wxPoint& aCenter, bool aRotateCCW )
 {
+    m_drawCorners.Clear();
     int rot_angle = aRotateCCW ? -900 : 900;
 
     size_t i, imax = m_PolyPoints.size();
@@ -256,8 +260,7 @@ void LIB_BEZIER::Plot( PLOTTER* aPlotter, const wxPoint& aOffset, bool aFill,
 {
     wxASSERT( aPlotter != NULL );
 
-    static std::vector< wxPoint > cornerList;
-    cornerList.clear();
+    std::vector< wxPoint > cornerList;
 
     for( unsigned ii = 0; ii < m_PolyPoints.size(); ii++ )
     {
@@ -292,16 +295,19 @@ void LIB_BEZIER::drawGraphic( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint&
 
     EDA_COLOR_T color = GetLayerColor( LAYER_DEVICE );
 
-    m_PolyPoints = Bezier2Poly( m_BezierPoints[0],
-                                m_BezierPoints[1],
-                                m_BezierPoints[2],
-                                m_BezierPoints[3] );
+    // The curve is approximated again only once its points changed
+    if( m_drawCorners.IsEmpty() )
+        m_PolyPoints = Bezier2Poly( m_BezierPoints[0],
+                                    m_BezierPoints[1],
+                                    m_BezierPoints[2],
+                                    m_BezierPoints[3] );
 
-    PolyPointsTraslated.clear();
+    const std::vector<wxPoint>& corners = m_drawCorners.Get( aTransform, m_PolyPoints );
 
-    for( unsigned int i = 0; i < m_PolyPoints.size() ; i++ )
-        PolyPointsTraslated.push_back( aTransform.TransformCoordinate( m_PolyPoints[i] ) +
-                                       aOffset );
+    PolyPointsTraslated.reserve( corners.size() );
+
+    for( unsigned int i = 0; i < corners.size() ; i++ )
+        PolyPointsTraslated.push_back( corners[i] + aOffset );
 
     if( aColor < 0 )                // Used normal color or selected color
     {
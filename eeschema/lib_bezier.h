@@ -41,6 +41,7 @@ class LIB_BEZIER : public LIB_ITEM
     int m_Width;                           // Line width
     std::vector<wxPoint> m_BezierPoints;   // list of parameter (3|4)
     std::vector<wxPoint> m_PolyPoints;     // list of points (>= 2)
+    LIB_CORNERS_CACHE m_drawCorners;       // m_PolyPoints by the drawn orientations
 
     void drawGraphic( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aOffset,
                       EDA_COLOR_T aColor, GR_DRAWMODE aDrawMode, void* aData,
@@ -72,6 +73,9 @@ public:
      */
     unsigned GetCornerCount() const { return m_PolyPoints.size(); }
 
+    ///> The control points of the curve, see Bezier2Poly()
+    const std::vector<wxPoint>& GetBezierPoints() const { return m_BezierPoints; }
+
     bool HitTest( const wxPoint& aPosition ) const;
 
     bool HitTest( const wxPoint& aPosRef, int aThreshold, const TRANSFORM& aTransform ) const;
@@ -38,6 +38,29 @@
 
 const int fill_tab[3] = { 'N', 'F', 'f' };
 
+
+const std::vector<wxPoint>& LIB_CORNERS_CACHE::Get( const TRANSFORM& aTransform,
+                                                    const std::vector<wxPoint>& aCorners )
+{
+    // A few orientations at most: mirrored or not, by 4 rotations
+    for( unsigned i = 0; i < m_entries.size(); i++ )
+    {
+        if( m_entries[i].first == aTransform )
+            return m_entries[i].second;
+    }
+
+    m_entries.push_back( std::make_pair( aTransform, std::vector<wxPoint>() ) );
+
+    std::vector<wxPoint>& corners = m_entries.back().second;
+
+    corners.reserve( aCorners.size() );
+
+    for( unsigned i = 0; i < aCorners.size(); i++ )
+        corners.push_back( aTransform.TransformCoordinate( aCorners[i] ) );
+
+    return corners;
+}
+
 //#define DRAW_ARC_WITH_ANGLE       // Used to draw arcs
 
 
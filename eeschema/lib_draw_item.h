@@ -69,6 +69,31 @@ typedef boost::ptr_vector< LIB_ITEM > LIB_ITEMS;
 typedef std::vector< LIB_PIN* > LIB_PINS;
 
 
+/**
+ * Class LIB_CORNERS_CACHE
+ * keeps the corners of a graphic item transformed by the orientations of the components
+ * drawing it.  A part is shared by all its components, so its corners are transformed
+ * once per orientation and not on every redraw.  The owner item clears it each time
+ * its corners change.
+ */
+class LIB_CORNERS_CACHE
+{
+    std::vector< std::pair< TRANSFORM, std::vector<wxPoint> > > m_entries;
+
+public:
+    bool IsEmpty() const { return m_entries.empty(); }
+
+    void Clear() { m_entries.clear(); }
+
+    /**
+     * Function Get
+     * returns \a aCorners transformed by \a aTransform, from the cache.
+     */
+    const std::vector<wxPoint>& Get( const TRANSFORM& aTransform,
+                                     const std::vector<wxPoint>& aCorners );
+};
+
+
 /**
  * Class LIB_ITEM
  * is the base class for drawable items used by schematic library components.
@@ -57,9 +57,6 @@ static const int pin_orientation_codes[] =
 };
 #define PIN_ORIENTATION_CNT DIM( pin_orientation_codes )
 
-// small margin in internal units between the pin text and the pin line
-#define PIN_TEXT_MARGIN 4
-
 // bitmaps to show pins orientations in dialog editor
 // must have same order than pin_orientation_names
 static const BITMAP_DEF iconsPinsOrientations[] =
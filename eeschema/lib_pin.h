@@ -37,6 +37,9 @@
 
 #define TARGET_PIN_RADIUS   12  // Circle diameter drawn at the active end of pins
 
+// small margin in internal units between the pin text and the pin line
+#define PIN_TEXT_MARGIN 4
+
 /* Pin visibility flag bit. */
 #define PIN_INVISIBLE 1    /* Set makes pin invisible */
 
@@ -296,7 +299,7 @@ public:
      */
     void SetLength( int aLength );
 
-    int GetLength() { return m_length; }
+    int GetLength() const { return m_length; }
 
     /**
      * Set the pin part number.
@@ -164,6 +164,7 @@ int LIB_POLYLINE::compare( const LIB_ITEM& aOther ) const
 
 void LIB_POLYLINE::SetOffset( const wxPoint& aOffset )
 {
+    m_drawCorners.Clear();
     for( size_t i = 0; i < m_PolyPoints.size(); i++ )
         m_PolyPoints[i] += aOffset;
 }
@@ -189,6 +190,7 @@ void LIB_POLYLINE::Move( const wxPoint& aPosition )
 
 void LIB_POLYLINE::MirrorHorizontal( const wxPoint& aCenter )
 {
+    m_drawCorners.Clear();
     size_t i, imax = m_PolyPoints.size();
 
     for( i = 0; i < imax; i++ )
@@ -201,6 +203,7 @@ void LIB_POLYLINE::MirrorHorizontal( const wxPoint& aCenter )
 
 void LIB_POLYLINE::MirrorVertical( const wxPoint& aCenter )
 {
+    m_drawCorners.Clear();
     size_t i, imax = m_PolyPoints.size();
 
     for( i = 0; i < imax; i++ )
@@ -213,6 +216,7 @@ void LIB_POLYLINE::MirrorVertical( const wxPoint& aCenter )
 
 void LIB_POLYLINE::Rotate( const wxPoint& aCenter, bool aRotateCCW )
 {
+    m_drawCorners.Clear();
     int rot_angle = aRotateCCW ? -900 : 900;
 
     size_t i, imax = m_PolyPoints.size();
@@ -229,8 +233,7 @@ void LIB_POLYLINE::Plot( PLOTTER* aPlotter, const wxPoint& aOffset, bool aFill,
 {
     wxASSERT( aPlotter != NULL );
 
-    static std::vector< wxPoint > cornerList;
-    cornerList.clear();
+    std::vector< wxPoint > cornerList;
 
     for( unsigned ii = 0; ii < m_PolyPoints.size(); ii++ )
     {
@@ -253,6 +256,7 @@ void LIB_POLYLINE::Plot( PLOTTER* aPlotter, const wxPoint& aOffset, bool aFill,
 
 void LIB_POLYLINE::AddPoint( const wxPoint& point )
 {
+    m_drawCorners.Clear();
     m_PolyPoints.push_back( point );
 }
 
@@ -283,9 +287,11 @@ void LIB_POLYLINE::drawGraphic( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint
 
     buffer = new wxPoint[ m_PolyPoints.size() ];
 
-    for( unsigned ii = 0; ii < m_PolyPoints.size(); ii++ )
+    const std::vector<wxPoint>& corners = m_drawCorners.Get( aTransform, m_PolyPoints );
+
+    for( unsigned ii = 0; ii < corners.size(); ii++ )
     {
-        buffer[ii] = aTransform.TransformCoordinate( m_PolyPoints[ii] ) + aOffset;
+        buffer[ii] = corners[ii] + aOffset;
     }
 
     FILL_T fill = aData ? NO_FILL : m_Fill;
@@ -381,6 +387,7 @@ const EDA_RECT LIB_POLYLINE::GetBoundingBox() const
 
 void LIB_POLYLINE::DeleteSegment( const wxPoint aPosition )
 {
+    m_drawCorners.Clear();
     // First segment is kept, only its end point is changed
     while( GetCornerCount() > 2 )
     {
@@ -424,6 +431,7 @@ wxString LIB_POLYLINE::GetSelectMenuText() const
 
 void LIB_POLYLINE::BeginEdit( STATUS_FLAGS aEditMode, const wxPoint aPosition )
 {
+    m_drawCorners.Clear();
     wxCHECK_RET( ( aEditMode & ( IS_NEW | IS_MOVED | IS_RESIZED ) ) != 0,
                  wxT( "Invalid edit mode for LIB_POLYLINE object." ) );
 
@@ -494,6 +502,7 @@ void LIB_POLYLINE::BeginEdit( STATUS_FLAGS aEditMode, const wxPoint aPosition )
 
 bool LIB_POLYLINE::ContinueEdit( const wxPoint aPosition )
 {
+    m_drawCorners.Clear();
     wxCHECK_MSG( ( m_Flags & ( IS_NEW | IS_MOVED | IS_RESIZED ) ) != 0, false,
                 wxT( "Bad call to ContinueEdit().  LIB_POLYLINE is not being edited." ) );
 
@@ -512,6 +521,7 @@ bool LIB_POLYLINE::ContinueEdit( const wxPoint aPosition )
 
 void LIB_POLYLINE::EndEdit( const wxPoint& aPosition, bool aAbort )
 {
+    m_drawCorners.Clear();
     wxCHECK_RET( ( m_Flags & ( IS_NEW | IS_MOVED | IS_RESIZED ) ) != 0,
                  wxT( "Bad call to EndEdit().  LIB_POLYLINE is not being edited." ) );
 
@@ -540,6 +550,7 @@ void LIB_POLYLINE::EndEdit( const wxPoint& aPosition, bool aAbort )
 
 void LIB_POLYLINE::calcEdit( const wxPoint& aPosition )
 {
+    m_drawCorners.Clear();
     if( m_Flags == IS_NEW )
     {
         m_PolyPoints[ GetCornerCount() - 1 ] = aPosition;
@@ -39,6 +39,8 @@ class LIB_POLYLINE : public LIB_ITEM
 
     int m_ModifyIndex;                        // Index of the polyline point to modify
 
+    LIB_CORNERS_CACHE m_drawCorners;          // m_PolyPoints by the drawn orientations
+
     void drawGraphic( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aOffset,
                       EDA_COLOR_T aColor, GR_DRAWMODE aDrawMode, void* aData,
                       const TRANSFORM& aTransform );
@@ -74,6 +76,8 @@ public:
      */
     unsigned GetCornerCount() const { return m_PolyPoints.size(); }
 
+    const std::vector<wxPoint>& GetPolyPoints() const { return m_PolyPoints; }
+
     bool HitTest( const wxPoint& aPosition ) const;
 
     bool HitTest( const wxPoint &aPosition, int aThreshold, const TRANSFORM& aTransform ) const;
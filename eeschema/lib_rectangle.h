@@ -61,6 +61,8 @@ public:
 
     void SetEndPosition( const wxPoint& aPosition ) { m_End = aPosition; }
 
+    wxPoint GetEnd() const { return m_End; }
+
     bool Save( OUTPUTFORMATTER& aFormatter );
 
     bool Load( LINE_READER& aLineReader, wxString& aErrorMsg );
@@ -385,6 +385,24 @@ void SCH_EDIT_FRAME::ReCreateMenuBar()
                  KiBitmap( preference_xpm ) );
 #endif // __WXMAC__
 
+    preferencesMenu->AppendSeparator();
+
+    AddMenuItem( preferencesMenu, ID_MENU_SCH_CANVAS_LEGACY,
+                 _( "Switch Canvas to &Legacy" ),
+                 _( "Switch the canvas implementation to Legacy" ),
+                 KiBitmap( tools_xpm ) );
+
+    AddMenuItem( preferencesMenu, ID_MENU_SCH_CANVAS_OPENGL,
+                 _( "Switch Canvas to Open&GL" ),
+                 _( "Switch the canvas implementation to OpenGL" ),
+                 KiBitmap( tools_xpm ) );
+
+    AddMenuItem( preferencesMenu, ID_MENU_SCH_CANVAS_CAIRO,
+                 _( "Switch Canvas to &Cairo" ),
+                 _( "Switch the canvas implementation to Cairo" ),
+                 KiBitmap( tools_xpm ) );
+
+    preferencesMenu->AppendSeparator();
 
     // Language submenu
     Pgm().AddMenuLanguageList( preferencesMenu );
@@ -28,6 +28,7 @@
  */
 
 #include <fctsys.h>
+#include <pgm_base.h>
 #include <schframe.h>
 #include <confirm.h>
 #include <netlist_exporter_kicad.h>
@@ -43,24 +44,19 @@
 #include <sch_no_connect.h>
 #include <sch_text.h>
 #include <sch_sheet.h>
+#include <trigo.h>
+#include <hashtables.h>
 #include <algorithm>
+#include <map>
 #include <invoke_sch_dialog.h>
+#include <thread_pool.h>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 #define IS_WIRE false
 #define IS_BUS true
 
-/** @brief Kicad can use case sensitive or case insensitive comparisons for labels
- * Currently, it uses case insensitive.
- * Can be changed by comment/uncomment next lines.
- */
-inline int CmpLabel_KEEPCASE( const wxString& aString1, const wxString& aString2 )
-{
-    return aString1.Cmp( aString2 );          // case sensitive
-    //return aString1.CmpNoCase( aString2 );  // case insensitive
-}
-
-
 //Imported function:
 int TestDuplicateSheetNames( bool aCreateMarker );
 
@@ -192,179 +188,263 @@ NETLIST_OBJECT_LIST* SCH_EDIT_FRAME::BuildNetListBase()
 }
 
 
-bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
+// The cells of the grid indexing the wire and bus segments of a sheet
+#define CONNECT_GRID_SIZE 1024
+
+static int gridCell( int aCoord )
 {
-    SCH_SHEET_PATH* sheet;
+    return aCoord >= 0 ? aCoord / CONNECT_GRID_SIZE : -( ( -aCoord - 1 ) / CONNECT_GRID_SIZE ) - 1;
+}
 
-    // Fill list with connected items from the flattened sheet list
-    for( unsigned i = 0; i < aSheets.size();  i++ )
+
+// The items connected by their end points, to wires or to buses
+static bool isPointTarget( NETLIST_ITEM_T aType, bool aIsBus )
+{
+    switch( aType )
     {
-        sheet = &aSheets[i];
+    case NET_SEGMENT:
+    case NET_PIN:
+    case NET_LABEL:
+    case NET_HIERLABEL:
+    case NET_GLOBLABEL:
+    case NET_SHEETLABEL:
+    case NET_PINLABEL:
+    case NET_NOCONNECT:
+        return !aIsBus;
+
+    case NET_BUS:
+    case NET_BUSLABELMEMBER:
+    case NET_SHEETBUSLABELMEMBER:
+    case NET_HIERBUSLABELMEMBER:
+    case NET_GLOBBUSLABELMEMBER:
+        return aIsBus;
+
+    case NET_JUNCTION:
+        return true;
+
+    case NET_ITEM_UNSPECIFIED:
+        break;
+    }
 
-        for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
-        {
-            item->GetNetListItem( *this, sheet );
-        }
+    return false;
+}
+
+
+// The items connecting all the items sharing one of their end points: two labels, or a
+// label and a junction, at the same place are not connected by themselves
+static bool isPointSource( NETLIST_ITEM_T aType, bool aIsBus )
+{
+    if( aIsBus )
+        return aType == NET_BUS || aType == NET_SHEETBUSLABELMEMBER;
+
+    return aType == NET_SEGMENT || aType == NET_PIN || aType == NET_PINLABEL
+        || aType == NET_SHEETLABEL || aType == NET_NOCONNECT;
+}
+
+
+// The items connected to the wire or bus segments going through their position
+static bool isSegmentTarget( NETLIST_ITEM_T aType, bool aIsBus )
+{
+    if( aIsBus )
+        return aType == NET_JUNCTION || aType == NET_BUSLABELMEMBER
+            || aType == NET_HIERBUSLABELMEMBER || aType == NET_GLOBBUSLABELMEMBER;
+
+    return aType == NET_JUNCTION || aType == NET_LABEL || aType == NET_HIERLABEL
+        || aType == NET_GLOBLABEL;
+}
+
+
+// The labels connecting the labels of the same name: the other labels are only connected
+// by them
+static bool isLabelSource( NETLIST_ITEM_T aType )
+{
+    return aType == NET_LABEL || aType == NET_GLOBLABEL || aType == NET_PINLABEL
+        || aType == NET_BUSLABELMEMBER || aType == NET_GLOBBUSLABELMEMBER;
+}
+
+
+void NETLIST_OBJECT_LIST::extractSheetItems( SCH_SHEET_PATH* aSheet,
+                                             NETLIST_OBJECT_LIST* aItems )
+{
+    for( SCH_ITEM* item = aSheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
+        item->GetNetListItem( *aItems, aSheet );
+}
+
+
+void NETLIST_OBJECT_LIST::copySheetItems( SCH_SHEET_PATH* aSheet,
+                                          const NETLIST_OBJECT_LIST* aSource,
+                                          NETLIST_OBJECT_LIST* aItems )
+{
+    aItems->reserve( aSource->size() );
+
+    for( unsigned ii = 0; ii < aSource->size(); ii++ )
+    {
+        NETLIST_OBJECT* source = aSource->GetItem( ii );
+
+        // The items of the component pins, see SCH_COMPONENT::GetNetListItem()
+        if( source->m_Type == NET_PIN || source->m_Type == NET_PINLABEL )
+            continue;
+
+        NETLIST_OBJECT* item = new NETLIST_OBJECT( *source );
+
+        item->m_SheetPath = *aSheet;
+        item->m_SheetPathInclude = *aSheet;
+
+        // The sheet pins include the sheet they belong to
+        if( source->m_SheetPathInclude != source->m_SheetPath )
+            item->m_SheetPathInclude.push_back( source->m_SheetPathInclude.Last() );
+
+        aItems->push_back( item );
     }
 
-    if( size() == 0 )
-        return false;
+    for( SCH_ITEM* item = aSheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
+    {
+        if( item->Type() == SCH_COMPONENT_T )
+            item->GetNetListItem( *aItems, aSheet );
+    }
+}
 
-    // Sort objects by Sheet
-    SortListbySheet();
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
-    m_lastNetCode = m_lastBusNetCode = 1;
+bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
+{
+    // Fill list with connected items from the flattened sheet list.  The items of each
+    // sheet are extracted on the threads of the process, in a list per sheet, and the
+    // other instances of a screen copy the items of its first one.
+    boost::ptr_vector<NETLIST_OBJECT_LIST> sheetItems;
+    std::vector<unsigned> firstInstance( aSheets.size() );
+    std::map<SCH_SCREEN*, unsigned> screenInstances;
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    for( unsigned i = 0; i < aSheets.size();  i++ )
     {
-        NETLIST_OBJECT* net_item = GetItem( ii );
+        sheetItems.push_back( new NETLIST_OBJECT_LIST() );
+        firstInstance[i] = screenInstances.insert(
+                std::make_pair( aSheets[i].LastScreen(), i ) ).first->second;
+    }
 
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
+    {
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned i = 0; i < aSheets.size();  i++ )
         {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+            if( firstInstance[i] == i )
+                tasks.Run( boost::bind( &NETLIST_OBJECT_LIST::extractSheetItems,
+                                        &aSheets[i], &sheetItems[i] ) );
         }
 
-        switch( net_item->m_Type )
-        {
-        case NET_ITEM_UNSPECIFIED:
-            wxMessageBox( wxT( "BuildNetListInfo() error" ) );
-            break;
+        tasks.Wait();
 
-        case NET_PIN:
-        case NET_PINLABEL:
-        case NET_SHEETLABEL:
-        case NET_NOCONNECT:
-            if( net_item->GetNet() != 0 )
-                break;
+        for( unsigned i = 0; i < aSheets.size();  i++ )
+        {
+            if( firstInstance[i] != i )
+                tasks.Run( boost::bind( &NETLIST_OBJECT_LIST::copySheetItems, &aSheets[i],
+                                        &sheetItems[firstInstance[i]], &sheetItems[i] ) );
+        }
 
-        case NET_SEGMENT:
-            // Test connections point to point type without bus.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+        tasks.Wait();
+    }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
-            break;
+    // Merge the lists in the sheet order, this list owns their items now
+    size_t count = size();
 
-        case NET_JUNCTION:
-            // Control of the junction outside BUS.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+    for( unsigned i = 0; i < sheetItems.size();  i++ )
+        count += sheetItems[i].size();
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+    reserve( count );
 
-            // Control of the junction, on BUS.
-            if( net_item->m_BusNetCode == 0 )
-            {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
-            }
+    for( unsigned i = 0; i < sheetItems.size();  i++ )
+    {
+        insert( end(), sheetItems[i].begin(), sheetItems[i].end() );
+        sheetItems[i].clear();
+    }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
-            break;
+    if( size() == 0 )
+        return false;
 
-        case NET_LABEL:
-        case NET_HIERLABEL:
-        case NET_GLOBLABEL:
-            // Test connections type junction without bus.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+    // Sort objects by Sheet
+    SortListbySheet();
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
-            break;
+    // The connections are merged in sets of items, a net or a bus each, and the nets are
+    // numbered once all are found: merging two nets costs nothing then, instead of
+    // renumbering the whole list.
+    m_netSets.resize( size() );
+    m_busSets.resize( size() );
 
-        case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
-                break;
+    for( unsigned ii = 0; ii < size(); ii++ )
+        m_netSets[ii] = m_busSets[ii] = ii;
 
-        case NET_BUS:
-            // Control type connections point to point mode bus
-            if( net_item->m_BusNetCode == 0 )
-            {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
-            }
+    // The first item of each sheet, then the end of the list
+    std::vector<unsigned> sheetStarts;
 
-            pointToPointConnect( net_item, IS_BUS, istart );
-            break;
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        if( ii == 0 || GetItem( ii )->m_SheetPath != GetItem( ii - 1 )->m_SheetPath )
+            sheetStarts.push_back( ii );
+    }
 
-        case NET_BUSLABELMEMBER:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_GLOBBUSLABELMEMBER:
-            // Control connections similar has on BUS
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
-            }
+    sheetStarts.push_back( size() );
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
-            break;
-        }
+    // The physical connections, inside each sheet
+    for( unsigned ii = 0; ii + 1 < sheetStarts.size(); ii++ )
+    {
+        pointToPointConnect( sheetStarts[ii], sheetStarts[ii + 1], IS_WIRE );
+        pointToPointConnect( sheetStarts[ii], sheetStarts[ii + 1], IS_BUS );
+        segmentToPointConnect( sheetStarts[ii], sheetStarts[ii + 1], IS_WIRE );
+        segmentToPointConnect( sheetStarts[ii], sheetStarts[ii + 1], IS_BUS );
     }
 
-#if defined(NETLIST_DEBUG) && defined(DEBUG)
-    std::cout << "\n\nafter sheet local\n\n";
-    DumpNetTable();
-#endif
-
     // Updating the Bus Labels Netcode connected by Bus
     connectBusLabels();
 
     // Group objects by label.
+    labelConnect();
+
+    // Connection between hierarchy sheets
+    sheetLabelConnect( sheetStarts );
+
+    // Number the nets and buses, in the order of their first item.  The buses have no
+    // net code, the other items all have one.
+    std::vector<int> netCodes( size(), 0 );
+    std::vector<int> busCodes( size(), 0 );
+
+    m_lastNetCode = m_lastBusNetCode = 0;
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
-        switch( GetItem( ii )->m_Type )
+        NETLIST_OBJECT* net_item = GetItem( ii );
+
+        if( net_item->m_Type == NET_ITEM_UNSPECIFIED )
         {
-        case NET_PIN:
-        case NET_SHEETLABEL:
-        case NET_SEGMENT:
-        case NET_JUNCTION:
-        case NET_BUS:
-        case NET_NOCONNECT:
-            break;
+            wxMessageBox( wxT( "BuildNetListInfo() error" ) );
+            net_item->SetNet( 0 );
+            continue;
+        }
 
-        case NET_LABEL:
-        case NET_GLOBLABEL:
-        case NET_PINLABEL:
-        case NET_BUSLABELMEMBER:
-        case NET_GLOBBUSLABELMEMBER:
-            labelConnect( GetItem( ii ) );
-            break;
+        if( net_item->m_Type != NET_BUS )
+        {
+            int& code = netCodes[findSet( m_netSets, ii )];
 
-        case NET_SHEETBUSLABELMEMBER:
-        case NET_HIERLABEL:
-        case NET_HIERBUSLABELMEMBER:
-            break;
+            if( code == 0 )
+                code = ++m_lastNetCode;
 
-        case NET_ITEM_UNSPECIFIED:
-            break;
+            net_item->SetNet( code );
         }
-    }
+        else
+            net_item->SetNet( 0 );
 
-#if defined(NETLIST_DEBUG) && defined(DEBUG)
-    std::cout << "\n\nafter sheet global\n\n";
-    DumpNetTable();
-#endif
+        if( isPointTarget( net_item->m_Type, IS_BUS ) )
+        {
+            int& code = busCodes[findSet( m_busSets, ii )];
 
-    // Connection between hierarchy sheets
-    for( unsigned ii = 0; ii < size(); ii++ )
-    {
-        if( GetItem( ii )->m_Type == NET_SHEETLABEL
-            || GetItem( ii )->m_Type == NET_SHEETBUSLABELMEMBER )
-            sheetLabelConnect( GetItem( ii ) );
+            if( code == 0 )
+                code = ++m_lastBusNetCode;
+
+            net_item->m_BusNetCode = code;
+        }
     }
 
+    m_netSets.clear();
+    m_busSets.clear();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -373,21 +453,6 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     DumpNetTable();
 #endif
 
-    // Compress numbers of Netcode having consecutive values.
-    int NetCode = 0;
-    m_lastNetCode = 0;
-
-    for( unsigned ii = 0; ii < size(); ii++ )
-    {
-        if( GetItem( ii )->GetNet() != m_lastNetCode )
-        {
-            NetCode++;
-            m_lastNetCode = GetItem( ii )->GetNet();
-        }
-
-        GetItem( ii )->SetNet( NetCode );
-    }
-
     // Set the minimal connection info:
     setUnconnectedFlag();
 
@@ -397,6 +462,31 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     return true;
 }
 
+
+int NETLIST_OBJECT_LIST::findSet( std::vector<int>& aSets, int aItem )
+{
+    while( aSets[aItem] != aItem )
+    {
+        aSets[aItem] = aSets[aSets[aItem]];     // halves the path for the next searches
+        aItem = aSets[aItem];
+    }
+
+    return aItem;
+}
+
+
+void NETLIST_OBJECT_LIST::mergeSets( std::vector<int>& aSets, int aItem1, int aItem2 )
+{
+    int set1 = findSet( aSets, aItem1 );
+    int set2 = findSet( aSets, aItem2 );
+
+    // the first item of a set stays its root
+    if( set1 < set2 )
+        aSets[set2] = set1;
+    else if( set2 < set1 )
+        aSets[set1] = set2;
+}
+
 // Helper function to give a priority to sort labels:
 // NET_PINLABEL, NET_GLOBBUSLABELMEMBER and NET_GLOBLABEL are global labels
 // and the priority is high
@@ -612,372 +702,302 @@ void NETLIST_OBJECT_LIST::findBestNetNameForEachNet()
 }
 
 
-void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
+void NETLIST_OBJECT_LIST::sheetLabelConnect( const std::vector<unsigned>& aSheetStarts )
 {
-    if( SheetLabel->GetNet() == 0 )
-        return;
+    // The hierarchical labels by sheet and name
+    std::map< std::pair<unsigned, wxString>, std::vector<unsigned> > hierLabels;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
+    for( unsigned ii = 0; ii + 1 < aSheetStarts.size(); ii++ )
     {
-        NETLIST_OBJECT* ObjetNet = GetItem( ii );
+        for( unsigned jj = aSheetStarts[ii]; jj < aSheetStarts[ii + 1]; jj++ )
+        {
+            NETLIST_OBJECT* item = GetItem( jj );
 
-        if( ObjetNet->m_SheetPath != SheetLabel->m_SheetPathInclude )
-            continue;  //use SheetInclude, not the sheet!!
+            if( item->m_Type == NET_HIERLABEL || item->m_Type == NET_HIERBUSLABELMEMBER )
+                hierLabels[ std::make_pair( ii, item->m_Label ) ].push_back( jj );
+        }
+    }
 
-        if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* sheetLabel = GetItem( ii );
+
+        if( sheetLabel->m_Type != NET_SHEETLABEL && sheetLabel->m_Type != NET_SHEETBUSLABELMEMBER )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
-            continue;  //already connected.
+        // The sheets are sorted by path: find the one of the include path, use SheetInclude,
+        // not the sheet!!
+        unsigned first = 0;
+        unsigned last = aSheetStarts.size() - 1;
 
-        if( CmpLabel_KEEPCASE( ObjetNet->m_Label, SheetLabel->m_Label ) != 0 )
-            continue;  //different names.
+        while( first < last )
+        {
+            unsigned middle = ( first + last ) / 2;
 
-        // Propagate Netcode having all the objects of the same Netcode.
-        if( ObjetNet->GetNet() )
-            propageNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
-        else
-            ObjetNet->SetNet( SheetLabel->GetNet() );
-    }
-}
+            if( GetItem( aSheetStarts[middle] )->m_SheetPath.Cmp( sheetLabel->m_SheetPathInclude ) < 0 )
+                first = middle + 1;
+            else
+                last = middle;
+        }
 
+        for( ; first + 1 < aSheetStarts.size(); first++ )
+        {
+            const SCH_SHEET_PATH& path = GetItem( aSheetStarts[first] )->m_SheetPath;
 
-void NETLIST_OBJECT_LIST::connectBusLabels()
-{
-    // Propagate the net code between all bus label member objects connected by they name.
-    // If the net code is not yet existing, a new one is created
-    // Search is done in the entire list
-    for( unsigned ii = 0; ii < size(); ii++ )
-    {
-        NETLIST_OBJECT* Label = GetItem( ii );
+            if( path.Cmp( sheetLabel->m_SheetPathInclude ) != 0 )
+                break;
 
-        if( Label->IsLabelBusMemberType() )
-        {
-            if( Label->GetNet() == 0 )
-            {
-                // Not yet existiing net code: create a new one.
-                Label->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
+            if( path != sheetLabel->m_SheetPathInclude )
+                continue;
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+            std::map< std::pair<unsigned, wxString>, std::vector<unsigned> >::const_iterator it;
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
-
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propageNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
-            }
+            it = hierLabels.find( std::make_pair( first, sheetLabel->m_Label ) );
+
+            if( it == hierLabels.end() )
+                continue;
+
+            for( unsigned jj = 0; jj < it->second.size(); jj++ )
+                mergeSets( m_netSets, ii, it->second[jj] );
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::propageNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
+void NETLIST_OBJECT_LIST::connectBusLabels()
 {
-    if( aOldNetCode == aNewNetCode )
-        return;
+    // Merge the nets of all bus label member objects connected by a bus, and having the
+    // same member value
+    std::map< std::pair<int, int>, unsigned > members;
 
-    if( aIsBus == false )    // Propagate NetCode
+    for( unsigned ii = 0; ii < size(); ii++ )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        NETLIST_OBJECT* label = GetItem( ii );
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
-    }
-    else               // Propagate BusNetCode
-    {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        if( !label->IsLabelBusMemberType() )
+            continue;
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
+        std::pair<int, int> key( findSet( m_busSets, ii ), label->m_Member );
+        std::map< std::pair<int, int>, unsigned >::iterator it = members.find( key );
+
+        if( it == members.end() )
+            members[key] = ii;
+        else
+            mergeSets( m_netSets, it->second, ii );
     }
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+void NETLIST_OBJECT_LIST::pointToPointConnect( unsigned aStart, unsigned aEnd, bool aIsBus )
 {
-    int netCode;
+    // The end points of the items of the sheet, grouped by position
+    std::vector< std::pair< std::pair<int, int>, unsigned > > points;
 
-    if( aIsBus == false )    // Objects other than BUS and BUSLABELS
+    for( unsigned i = aStart; i < aEnd; i++ )
     {
-        netCode = aRef->GetNet();
+        NETLIST_OBJECT* item = GetItem( i );
 
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
+        if( !isPointTarget( item->m_Type, aIsBus ) )
+            continue;
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
+        points.push_back( std::make_pair( std::make_pair( item->m_Start.x, item->m_Start.y ), i ) );
 
-            switch( item->m_Type )
-            {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propageNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
-                break;
-
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
-            }
-        }
+        if( item->m_End != item->m_Start )
+            points.push_back( std::make_pair( std::make_pair( item->m_End.x, item->m_End.y ), i ) );
     }
-    else    // Object type BUS, BUSLABELS, and junctions.
-    {
-        netCode = aRef->m_BusNetCode;
 
-        for( unsigned i = start; i < size(); i++ )
-        {
-            NETLIST_OBJECT* item = GetItem( i );
+    std::sort( points.begin(), points.end() );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
+    std::vector<int>& sets = aIsBus ? m_busSets : m_netSets;
 
-            switch( item->m_Type )
-            {
-            case NET_ITEM_UNSPECIFIED:
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_NOCONNECT:
-                break;
+    for( unsigned i = 0, j; i < points.size(); i = j )
+    {
+        bool connected = false;
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        propageNetCode( item->m_BusNetCode, netCode, IS_BUS );
-                }
-                break;
-            }
+        for( j = i; j < points.size() && points[j].first == points[i].first; j++ )
+        {
+            if( isPointSource( GetItemType( points[j].second ), aIsBus ) )
+                connected = true;
         }
+
+        if( !connected )
+            continue;
+
+        for( unsigned k = i + 1; k < j; k++ )
+            mergeSets( sets, points[i].second, points[k].second );
     }
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::segmentToPointConnect( unsigned aStart, unsigned aEnd, bool aIsBus )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    NETLIST_ITEM_T segmentType = aIsBus ? NET_BUS : NET_SEGMENT;
+
+    // The segments of the sheet, by the grid cells of their bounding box
+    std::map< std::pair<int, int>, std::vector<unsigned> > cells;
+
+    for( unsigned i = aStart; i < aEnd; i++ )
     {
         NETLIST_OBJECT* segment = GetItem( i );
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
+        if( segment->m_Type != segmentType )
             continue;
 
-        if( aIsBus == IS_WIRE )
-        {
-            if( segment->m_Type != NET_SEGMENT )
-                continue;
-        }
-        else
-        {
-            if( segment->m_Type != NET_BUS )
-                continue;
-        }
+        int x0 = gridCell( std::min( segment->m_Start.x, segment->m_End.x ) );
+        int x1 = gridCell( std::max( segment->m_Start.x, segment->m_End.x ) );
+        int y0 = gridCell( std::min( segment->m_Start.y, segment->m_End.y ) );
+        int y1 = gridCell( std::max( segment->m_Start.y, segment->m_End.y ) );
 
-        if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
+        for( int x = x0; x <= x1; x++ )
         {
-            // Propagation Netcode has all the objects of the same Netcode.
-            if( aIsBus == IS_WIRE )
-            {
-                if( segment->GetNet() )
-                    propageNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
-                else
-                    segment->SetNet( aJonction->GetNet() );
-            }
-            else
-            {
-                if( segment->m_BusNetCode )
-                    propageNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
-                else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
-            }
+            for( int y = y0; y <= y1; y++ )
+                cells[ std::make_pair( x, y ) ].push_back( i );
         }
     }
-}
 
-
-void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
-{
-    if( aLabelRef->GetNet() == 0 )
+    if( cells.empty() )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
+    std::vector<int>& sets = aIsBus ? m_busSets : m_netSets;
+
+    for( unsigned i = aStart; i < aEnd; i++ )
     {
         NETLIST_OBJECT* item = GetItem( i );
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+        if( !isSegmentTarget( item->m_Type, aIsBus ) )
             continue;
 
-        if( item->m_SheetPath != aLabelRef->m_SheetPath )
-        {
-            if( item->m_Type != NET_PINLABEL && item->m_Type != NET_GLOBLABEL
-                && item->m_Type != NET_GLOBBUSLABELMEMBER )
-                continue;
+        std::map< std::pair<int, int>, std::vector<unsigned> >::const_iterator it;
 
-            if( (item->m_Type == NET_GLOBLABEL
-                 || item->m_Type == NET_GLOBBUSLABELMEMBER)
-               && item->m_Type != aLabelRef->m_Type )
-                //global labels only connect other global labels.
-                continue;
-        }
+        it = cells.find( std::make_pair( gridCell( item->m_Start.x ), gridCell( item->m_Start.y ) ) );
 
-        // NET_HIERLABEL are used to connect sheets.
-        // NET_LABEL are local to a sheet
-        // NET_GLOBLABEL are global.
-        // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
+        if( it == cells.end() )
+            continue;
+
+        for( unsigned j = 0; j < it->second.size(); j++ )
         {
-            if( CmpLabel_KEEPCASE( item->m_Label, aLabelRef->m_Label ) != 0 )
-                continue;
+            NETLIST_OBJECT* segment = GetItem( it->second[j] );
 
-            if( item->GetNet() )
-                propageNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
+            if( IsPointOnSegment( segment->m_Start, segment->m_End, item->m_Start ) )
+                mergeSets( sets, i, it->second[j] );
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::setUnconnectedFlag()
+void NETLIST_OBJECT_LIST::labelConnect()
 {
-    NETLIST_OBJECT* NetItemRef;
-    unsigned NetStart, NetEnd;
-    NET_CONNECTION_T StateFlag;
+    // The labels by name, in the order of the list: the labels of a sheet follow each other.
+    // The label names are case sensitive.
+    typedef boost::unordered_map< wxString, std::vector<unsigned>, WXSTRING_HASH > LABEL_GROUPS;
 
-    NetStart  = NetEnd = 0;
-    StateFlag = UNCONNECTED;
-    for( unsigned ii = 0; ii < size(); ii++ )
+    LABEL_GROUPS labels;
+
+    for( unsigned i = 0; i < size(); i++ )
     {
-        NetItemRef = GetItem( ii );
-        if( NetItemRef->m_Type == NET_NOCONNECT && StateFlag != PAD_CONNECT )
-            StateFlag = NOCONNECT_SYMBOL_PRESENT;
+        if( GetItem( i )->IsLabelType() )
+            labels[ GetItem( i )->m_Label ].push_back( i );
+    }
 
-        // Analysis of current net.
-        unsigned idxtoTest = ii + 1;
+    LABEL_GROUPS::const_iterator it;
 
-        if( ( idxtoTest >= size() )
-           || ( NetItemRef->GetNet() != GetItem( idxtoTest )->GetNet() ) )
+    for( it = labels.begin(); it != labels.end(); ++it )
+    {
+        const std::vector<unsigned>& group = it->second;
+
+        // NET_LABEL are local to a sheet: a label connects the labels of its sheet
+        for( unsigned i = 0, j; i < group.size(); i = j )
         {
-            // Net analysis to update m_ConnectionType
-            NetEnd = idxtoTest;
+            const SCH_SHEET_PATH& path = GetItem( group[i] )->m_SheetPath;
+            bool connected = false;
 
-            /* set m_ConnectionType member to StateFlag for all items of
-             * this net: */
-            for( unsigned kk = NetStart; kk < NetEnd; kk++ )
-                GetItem( kk )->m_ConnectionType = StateFlag;
+            for( j = i; j < group.size() && GetItem( group[j] )->m_SheetPath == path; j++ )
+            {
+                if( isLabelSource( GetItemType( group[j] ) ) )
+                    connected = true;
+            }
 
-            if( idxtoTest >= size() )
-                return;
+            if( !connected )
+                continue;
 
-            // Start Analysis next Net
-            StateFlag = UNCONNECTED;
-            NetStart  = idxtoTest;
-            continue;
+            for( unsigned k = i + 1; k < j; k++ )
+                mergeSets( m_netSets, group[i], group[k] );
         }
 
-        /* test the current item: if this is a pin and if the reference item
-         * is also a pin, then 2 pins are connected, so set StateFlag to
-         * PAD_CONNECT (can be already done)  Of course, if the current
-         * item is a no connect symbol, set StateFlag to
-         * NOCONNECT_SYMBOL_PRESENT to inhibit error diags. However if
-         * StateFlag is already set to PAD_CONNECT this state is kept (the
-         * no connect symbol was surely an error and an ERC will report this)
-         */
-       for( ; ; idxtoTest++ )
-        {
-            if( ( idxtoTest >= size() )
-               || ( NetItemRef->GetNet() != GetItem( idxtoTest )->GetNet() ) )
-                break;
+        // NET_GLOBLABEL are global, and only connect other global labels.
+        // NET_PINLABEL is a kind of global label (generated by a power pin invisible),
+        // connected to all the labels.
+        int globLabel = -1;
+        int globBusLabel = -1;
+        int pinLabel = -1;
 
-            switch( GetItem( idxtoTest )->m_Type )
+        for( unsigned i = 0; i < group.size(); i++ )
+        {
+            switch( GetItemType( group[i] ) )
             {
-            case NET_ITEM_UNSPECIFIED:
-                wxMessageBox( wxT( "BuildNetListBase() error" ) );
+            case NET_GLOBLABEL:
+                if( globLabel < 0 )
+                    globLabel = group[i];
+                else
+                    mergeSets( m_netSets, globLabel, group[i] );
                 break;
 
-            case NET_SEGMENT:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
             case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
+                if( globBusLabel < 0 )
+                    globBusLabel = group[i];
+                else
+                    mergeSets( m_netSets, globBusLabel, group[i] );
                 break;
 
-            case NET_PIN:
-                if( NetItemRef->m_Type == NET_PIN )
-                    StateFlag = PAD_CONNECT;
-
+            case NET_PINLABEL:
+                if( pinLabel < 0 )
+                    pinLabel = group[i];
                 break;
 
-            case NET_NOCONNECT:
-                if( StateFlag != PAD_CONNECT )
-                    StateFlag = NOCONNECT_SYMBOL_PRESENT;
-
+            default:
                 break;
             }
         }
+
+        if( pinLabel < 0 )
+            continue;
+
+        for( unsigned i = 0; i < group.size(); i++ )
+        {
+            if( isLabelSource( GetItemType( group[i] ) ) )
+                mergeSets( m_netSets, pinLabel, group[i] );
+        }
+    }
+}
+
+
+void NETLIST_OBJECT_LIST::setUnconnectedFlag()
+{
+    // Two pins make a connection, else a no connect symbol is enough.  If there are both
+    // the connection is kept: the no connect symbol was surely an error and an ERC will
+    // report this.
+    for( unsigned netStart = 0, netEnd; netStart < size(); netStart = netEnd )
+    {
+        int  pinCount = 0;
+        bool noConnect = false;
+
+        for( netEnd = netStart; netEnd < size()
+             && GetItem( netEnd )->GetNet() == GetItem( netStart )->GetNet(); netEnd++ )
+        {
+            if( GetItem( netEnd )->m_Type == NET_PIN )
+                pinCount++;
+            else if( GetItem( netEnd )->m_Type == NET_NOCONNECT )
+                noConnect = true;
+        }
+
+        NET_CONNECTION_T stateFlag = UNCONNECTED;
+
+        if( pinCount > 1 )
+            stateFlag = PAD_CONNECT;
+        else if( noConnect )
+            stateFlag = NOCONNECT_SYMBOL_PRESENT;
+
+        for( unsigned kk = netStart; kk < netEnd; kk++ )
+            GetItem( kk )->m_ConnectionType = stateFlag;
     }
 }
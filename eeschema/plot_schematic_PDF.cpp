@@ -37,6 +37,10 @@
 
 #include <dialog_plot_schematic.h>
 #include <wx_html_report_panel.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
 
 void DIALOG_PLOT_SCHEMATIC::createPDFFile( bool aPlotAll, bool aPlotFrameRef )
 {
@@ -68,57 +72,113 @@ void DIALOG_PLOT_SCHEMATIC::createPDFFile( bool aPlotAll, bool aPlotFrameRef )
     REPORTER& reporter = m_MessagesBox->Reporter();
     LOCALE_IO toggle;       // Switch the locale to standard C
 
-    for( unsigned i = 0; i < sheetList.size(); i++ )
+    /* The sheets not sharing their screen are plotted on the threads of the process,
+     * each following page into its own plotter, whose compressed page is then added
+     * to the document in the order of the sheets.  Their texts are drawn one at a time,
+     * through the shared basic_gal (see basic_gal_lock).
+     */
+    std::vector<unsigned> batchStarts;
+    bool                  firstPageOpen = true;
+
+    splitPlotBatches( sheetList, batchStarts );
+
+    for( unsigned batch = 0; batch + 1 < batchStarts.size(); batch++ )
     {
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-        screen = m_parent->GetCurrentSheet().LastScreen();
+        std::vector<PLOT_SHEET> sheets;
 
-        if( i == 0 )
+        for( unsigned i = batchStarts[batch]; i < batchStarts[batch + 1]; i++ )
         {
+            m_parent->SetCurrentSheet( sheetList[i] );
+            m_parent->GetCurrentSheet().UpdateAllScreenReferences();
+            m_parent->SetSheetNumberAndCount();
+            screen = m_parent->GetCurrentSheet().LastScreen();
+
+            PLOT_SHEET sheet;
+
+            sheet.m_screen = screen;
+            sheet.m_sheetDesc = m_parent->GetScreenDesc();
+            sheet.m_success = true;
 
-            try
+            // Resolved here, the plot of the screen does not search the libraries
+            screen->CheckComponentsToPartsLinks();
+
+            sheets.push_back( sheet );
+
+            if( i == 0 )
             {
-                wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
-                wxString ext = PDF_PLOTTER::GetDefaultFileExtension();
-                plotFileName = createPlotFileName( m_outputDirectoryName,
-                                                   fname, ext, &reporter );
 
-                if( !plotter->OpenFile( plotFileName.GetFullPath() ) )
+                try
                 {
-                    msg.Printf( _( "Unable to create file '%s'.\n" ),
-                                GetChars( plotFileName.GetFullPath() ) );
+                    wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
+                    wxString ext = PDF_PLOTTER::GetDefaultFileExtension();
+                    plotFileName = createPlotFileName( m_outputDirectoryName,
+                                                       fname, ext, &reporter );
+
+                    if( !plotter->OpenFile( plotFileName.GetFullPath() ) )
+                    {
+                        msg.Printf( _( "Unable to create file '%s'.\n" ),
+                                    GetChars( plotFileName.GetFullPath() ) );
+                        reporter.Report( msg, REPORTER::RPT_ERROR );
+                        delete plotter;
+                        return;
+                    }
+
+                    // Open the plotter and do the first page
+                    setupPlotPagePDF( plotter, screen );
+                    plotter->StartPlot();
+                }
+                catch( const IO_ERROR& e )
+                {
+                    // Cannot plot PDF file
+                    msg.Printf( wxT( "PDF Plotter exception: %s" ), GetChars( e.errorText ) );
                     reporter.Report( msg, REPORTER::RPT_ERROR );
-                    delete plotter;
+
+                    restoreEnvironment( plotter, oldsheetpath );
                     return;
                 }
 
-                // Open the plotter and do the first page
-                setupPlotPagePDF( plotter, screen );
-                plotter->StartPlot();
             }
-            catch( const IO_ERROR& e )
+        }
+
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned k = 0; k < sheets.size(); k++ )
+        {
+            bool firstPage = batchStarts[batch] + k == 0;
+
+            tasks.Run( boost::bind( &DIALOG_PLOT_SCHEMATIC::plotPagePDF, this, &sheets[k],
+                                    firstPage ? plotter : (PDF_PLOTTER*) NULL,
+                                    plotter->GetColorMode(), aPlotFrameRef ) );
+        }
+
+        tasks.Wait();
+
+        for( unsigned k = 0; k < sheets.size(); k++ )
+        {
+            if( !sheets[k].m_error.IsEmpty() )
             {
                 // Cannot plot PDF file
-                msg.Printf( wxT( "PDF Plotter exception: %s" ), GetChars( e.errorText ) );
+                msg.Printf( wxT( "PDF Plotter exception: %s" ), GetChars( sheets[k].m_error ) );
                 reporter.Report( msg, REPORTER::RPT_ERROR );
 
                 restoreEnvironment( plotter, oldsheetpath );
                 return;
             }
 
-        }
-        else
-        {
-            /* For the following pages you need to close the (finished) page,
-             *  reconfigure, and then start a new one */
-            plotter->ClosePage();
-            setupPlotPagePDF( plotter, screen );
-            plotter->StartPage();
-        }
+            if( batchStarts[batch] + k == 0 )
+                continue;
+
+            /* For the following pages you need to close the (finished) first page,
+             *  reconfigure, and then add the page plotted on its own */
+            if( firstPageOpen )
+            {
+                plotter->ClosePage();
+                firstPageOpen = false;
+            }
 
-        plotOneSheetPDF( plotter, screen, aPlotFrameRef );
+            setupPlotPagePDF( plotter, sheets[k].m_screen );
+            plotter->AddPage( sheets[k].m_pageStream );
+        }
     }
 
     // Everything done, close the plot and restore the environment
@@ -142,18 +202,50 @@ void DIALOG_PLOT_SCHEMATIC::restoreEnvironment( PDF_PLOTTER* aPlotter,
 }
 
 
+void DIALOG_PLOT_SCHEMATIC::plotPagePDF( PLOT_SHEET* aSheet, PDF_PLOTTER* aPlotter,
+                                         bool aPlotColor, bool aPlotFrameRef )
+{
+    try
+    {
+        if( aPlotter )
+        {
+            plotOneSheetPDF( aPlotter, aSheet->m_screen, aSheet->m_sheetDesc, aPlotFrameRef );
+            return;
+        }
+
+        // A plotter without output file, with the job level parameters of the document
+        PDF_PLOTTER* plotter = new PDF_PLOTTER();
+        plotter->SetDefaultLineWidth( GetDefaultLineThickness() );
+        plotter->SetColorMode( aPlotColor );
+        plotter->SetCreator( wxT( "Eeschema-PDF" ) );
+
+        setupPlotPagePDF( plotter, aSheet->m_screen );
+        plotter->StartPage();
+
+        plotOneSheetPDF( plotter, aSheet->m_screen, aSheet->m_sheetDesc, aPlotFrameRef );
+
+        plotter->ClosePageStream( aSheet->m_pageStream );
+        delete plotter;
+    }
+    catch( const IO_ERROR& e )
+    {
+        aSheet->m_error = e.errorText;
+    }
+}
+
+
 void DIALOG_PLOT_SCHEMATIC::plotOneSheetPDF( PLOTTER* aPlotter,
                                              SCH_SCREEN* aScreen,
+                                             const wxString& aSheetDesc,
                                              bool aPlotFrameRef )
 {
     if( aPlotFrameRef )
     {
         aPlotter->SetColor( BLACK );
-        PlotWorkSheet( aPlotter, m_parent->GetTitleBlock(),
-                       m_parent->GetPageSettings(),
+        PlotWorkSheet( aPlotter, aScreen->GetTitleBlock(),
+                       aScreen->GetPageSettings(),
                        aScreen->m_ScreenNumber, aScreen->m_NumberOfScreens,
-                       m_parent->GetScreenDesc(),
-                       aScreen->GetFileName() );
+                       aSheetDesc, aScreen->GetFileName() );
     }
 
     aScreen->Plot( aPlotter );
@@ -40,6 +40,9 @@
 
 #include <dialog_plot_schematic.h>
 #include <wx_html_report_panel.h>
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
 
 void DIALOG_PLOT_SCHEMATIC::createSVGFile( bool aPrintAll, bool aPrintFrameRef )
 {
@@ -53,45 +56,87 @@ void DIALOG_PLOT_SCHEMATIC::createSVGFile( bool aPrintAll, bool aPrintFrameRef )
     else
         sheetList.push_back( m_parent->GetCurrentSheet() );
 
-    for( unsigned i = 0; i < sheetList.size(); i++ )
+    // Each sheet is a file: the sheets not sharing their screen are plotted on the threads
+    // of the process.  The locale is switched once for all of them, and their texts are
+    // drawn one at a time, through the shared basic_gal (see basic_gal_lock).
+    std::vector<unsigned> batchStarts;
+    bool                  failed = false;
+    LOCALE_IO             toggle;
+
+    splitPlotBatches( sheetList, batchStarts );
+
+    for( unsigned batch = 0; batch + 1 < batchStarts.size() && !failed; batch++ )
     {
-        SCH_SCREEN*  screen;
-        m_parent->SetCurrentSheet( sheetList[i] );
-        m_parent->GetCurrentSheet().UpdateAllScreenReferences();
-        m_parent->SetSheetNumberAndCount();
-        screen = m_parent->GetCurrentSheet().LastScreen();
+        std::vector<PLOT_SHEET> sheets;
+
+        for( unsigned i = batchStarts[batch]; i < batchStarts[batch + 1]; i++ )
+        {
+            m_parent->SetCurrentSheet( sheetList[i] );
+            m_parent->GetCurrentSheet().UpdateAllScreenReferences();
+            m_parent->SetSheetNumberAndCount();
+
+            PLOT_SHEET sheet;
+
+            sheet.m_screen = m_parent->GetCurrentSheet().LastScreen();
+            sheet.m_sheetDesc = m_parent->GetScreenDesc();
+            sheet.m_success = false;
+
+            // Resolved here, the plot of the screen does not search the libraries
+            sheet.m_screen->CheckComponentsToPartsLinks();
+
+            try
+            {
+                wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
+                wxString ext = SVG_PLOTTER::GetDefaultFileExtension();
+                wxFileName plotFileName = createPlotFileName( m_outputDirectoryName,
+                                                              fname, ext, &reporter );
+
+                sheet.m_fileName = plotFileName.GetFullPath();
+            }
+            catch( const IO_ERROR& e )
+            {
+                msg.Printf( wxT( "SVG Plotter exception: %s" ), GetChars( e.errorText ) );
+                reporter.Report( msg, REPORTER::RPT_ERROR );
+                failed = true;
+                break;
+            }
+
+            sheets.push_back( sheet );
+        }
 
-        try
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned i = 0; i < sheets.size(); i++ )
         {
-            wxString fname = m_parent->GetUniqueFilenameForCurrentSheet();
-            wxString ext = SVG_PLOTTER::GetDefaultFileExtension();
-            wxFileName plotFileName = createPlotFileName( m_outputDirectoryName,
-                                                          fname, ext, &reporter );
+            tasks.Run( boost::bind( &DIALOG_PLOT_SCHEMATIC::plotSheetSVG, &sheets[i],
+                                    getModeColor() ? false : true, aPrintFrameRef ) );
+        }
 
-            bool success = plotOneSheetSVG( m_parent, plotFileName.GetFullPath(), screen,
-                                            getModeColor() ? false : true,
-                                            aPrintFrameRef );
+        tasks.Wait();
 
-            if( !success )
+        for( unsigned i = 0; i < sheets.size(); i++ )
+        {
+            if( !sheets[i].m_error.IsEmpty() )
+            {
+                // Cannot plot SVG file
+                msg.Printf( wxT( "SVG Plotter exception: %s" ), GetChars( sheets[i].m_error ) );
+                reporter.Report( msg, REPORTER::RPT_ERROR );
+                failed = true;
+                break;
+            }
+            else if( !sheets[i].m_success )
             {
                 msg.Printf( _( "Cannot create file '%s'.\n" ),
-                            GetChars( plotFileName.GetFullPath() ) );
+                            GetChars( sheets[i].m_fileName ) );
                 reporter.Report( msg, REPORTER::RPT_ERROR );
             }
             else
             {
                 msg.Printf( _( "Plot: '%s' OK.\n" ),
-                            GetChars( plotFileName.GetFullPath() ) );
+                            GetChars( sheets[i].m_fileName ) );
                 reporter.Report( msg, REPORTER::RPT_ACTION );
             }
         }
-        catch( const IO_ERROR& e )
-        {
-            // Cannot plot SVG file
-            msg.Printf( wxT( "SVG Plotter exception: %s" ), GetChars( e.errorText ) );
-            reporter.Report( msg, REPORTER::RPT_ERROR );
-            break;
-        }
     }
 
     m_parent->SetCurrentSheet( oldsheetpath );
@@ -100,11 +145,45 @@ void DIALOG_PLOT_SCHEMATIC::createSVGFile( bool aPrintAll, bool aPrintFrameRef )
 }
 
 
+void DIALOG_PLOT_SCHEMATIC::plotSheetSVG( PLOT_SHEET* aSheet, bool aPlotBlackAndWhite,
+                                          bool aPlotFrameRef )
+{
+    try
+    {
+        aSheet->m_success = plotOneSheetSVG( aSheet->m_fileName, aSheet->m_screen,
+                                             aSheet->m_screen->GetTitleBlock(),
+                                             aSheet->m_screen->GetPageSettings(),
+                                             aSheet->m_sheetDesc,
+                                             aPlotBlackAndWhite, aPlotFrameRef );
+    }
+    catch( const IO_ERROR& e )
+    {
+        aSheet->m_error = e.errorText;
+    }
+}
+
+
 bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( EDA_DRAW_FRAME*    aFrame,
                                              const wxString&    aFileName,
                                              SCH_SCREEN*        aScreen,
                                              bool               aPlotBlackAndWhite,
                                              bool               aPlotFrameRef )
+{
+    LOCALE_IO   toggle;
+
+    return plotOneSheetSVG( aFileName, aScreen, aFrame->GetTitleBlock(),
+                            aFrame->GetPageSettings(), aFrame->GetScreenDesc(),
+                            aPlotBlackAndWhite, aPlotFrameRef );
+}
+
+
+bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( const wxString&    aFileName,
+                                             SCH_SCREEN*        aScreen,
+                                             const TITLE_BLOCK& aTitleBlock,
+                                             const PAGE_INFO&   aPageInfo,
+                                             const wxString&    aSheetDesc,
+                                             bool               aPlotBlackAndWhite,
+                                             bool               aPlotFrameRef )
 {
     SVG_PLOTTER* plotter = new SVG_PLOTTER();
 
@@ -125,18 +204,14 @@ bool DIALOG_PLOT_SCHEMATIC::plotOneSheetSVG( EDA_DRAW_FRAME*    aFrame,
         return false;
     }
 
-    LOCALE_IO   toggle;
-
     plotter->StartPlot();
 
     if( aPlotFrameRef )
     {
         plotter->SetColor( BLACK );
-        PlotWorkSheet( plotter, aFrame->GetTitleBlock(),
-                       aFrame->GetPageSettings(),
+        PlotWorkSheet( plotter, aTitleBlock, aPageInfo,
                        aScreen->m_ScreenNumber, aScreen->m_NumberOfScreens,
-                       aFrame->GetScreenDesc(),
-                       aScreen->GetFileName() );
+                       aSheetDesc, aScreen->GetFileName() );
     }
 
     aScreen->Plot( plotter );
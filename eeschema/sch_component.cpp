@@ -1524,6 +1524,14 @@ const EDA_RECT SCH_COMPONENT::GetBoundingBox() const
 }
 
 
+void SCH_COMPONENT::ViewGetLayers( int aLayers[], int& aCount ) const
+{
+    // The body, the pins and the fields are drawn in a single cached group
+    aCount      = 1;
+    aLayers[0]  = LAYER_DEVICE;
+}
+
+
 void SCH_COMPONENT::GetMsgPanelInfo( MSG_PANEL_ITEMS& aList )
 {
     // part and alias can differ if alias is not the root
@@ -165,6 +165,13 @@ public:
 
     static void ResolveAll( const SCH_COLLECTOR& aComponents, PART_LIBS* aLibs );
 
+    /**
+     * Function GetPartRef
+     * @return the reference to the LIB_PART of the component, which is expired when the
+     * part cannot be found in the libraries.
+     */
+    const PART_REF& GetPartRef() const { return m_part; }
+
     int GetUnit() const { return m_unit; }
 
     /**
@@ -259,6 +266,9 @@ public:
 
     const EDA_RECT GetBoundingBox() const;    // Virtual
 
+    /// @copydoc VIEW_ITEM::ViewGetLayers()
+    void ViewGetLayers( int aLayers[], int& aCount ) const;
+
     /**
      * Function GetBodyBoundingBox
      * Return a bounding box for the component body but not the fields.
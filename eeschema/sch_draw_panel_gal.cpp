@@ -0,0 +1,127 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+
+#include <sch_draw_panel_gal.h>
+#include <sch_painter.h>
+#include <schframe.h>
+#include <class_sch_screen.h>
+#include <sch_item_struct.h>
+
+#include <view/view.h>
+#include <gal/graphics_abstraction_layer.h>
+
+
+SCH_DRAW_PANEL_GAL::SCH_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
+                                        const wxPoint& aPosition, const wxSize& aSize,
+                                        GAL_TYPE aGalType ) :
+EDA_DRAW_PANEL_GAL( aParentWindow, aWindowId, aPosition, aSize, aGalType )
+{
+    m_painter = new KIGFX::SCH_PAINTER( m_gal );
+    m_view->SetPainter( m_painter );
+
+    // The GAL was created by the base class, before LoadGalSettings() could be overridden
+    setWorldUnitLength();
+
+    // Each schematic layer is a cached group, displayed in the order of the layer ids.
+    // The background of the component bodies is the last one, below all the others.
+    for( int layer = LAYER_FIRST; layer <= LAYER_DEVICE_BACKGROUND; ++layer )
+    {
+        m_view->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
+        m_view->SetLayerOrder( layer, layer );
+    }
+
+    loadSettings();
+}
+
+
+SCH_DRAW_PANEL_GAL::~SCH_DRAW_PANEL_GAL()
+{
+}
+
+
+void SCH_DRAW_PANEL_GAL::DisplaySheet( const SCH_SCREEN* aScreen )
+{
+    m_view->Clear();
+
+    // The items are collected, to be added to the view at once
+    std::vector<KIGFX::VIEW_ITEM*> items;
+
+    for( SCH_ITEM* item = aScreen->GetDrawItems(); item; item = item->Next() )
+        items.push_back( item );
+
+    loadSettings();
+    m_view->AddItems( items );
+}
+
+
+void SCH_DRAW_PANEL_GAL::SyncSettings()
+{
+    loadSettings();
+
+    // The colors are stored in the cached groups
+    m_view->RecacheAllItems();
+    m_view->MarkDirty();
+}
+
+
+bool SCH_DRAW_PANEL_GAL::LoadGalSettings()
+{
+    setWorldUnitLength();
+
+    return EDA_DRAW_PANEL_GAL::LoadGalSettings();
+}
+
+
+void SCH_DRAW_PANEL_GAL::OnShow()
+{
+    SyncSettings();
+}
+
+
+void SCH_DRAW_PANEL_GAL::loadSettings()
+{
+    SCH_EDIT_FRAME* frame = dynamic_cast<SCH_EDIT_FRAME*>( GetParentEDAFrame() );
+
+    if( !frame )
+        return;
+
+    KIGFX::SCH_RENDER_SETTINGS* rs;
+    rs = static_cast<KIGFX::SCH_RENDER_SETTINGS*>( m_view->GetPainter()->GetSettings() );
+
+    rs->ImportLegacyColors( NULL );
+
+    KIGFX::COLOR4D background = rs->TranslateColor( frame->GetDrawBgColor() );
+    background.a = 1.0;
+
+    rs->SetBackgroundColor( background );
+    rs->SetShowHiddenPins( frame->GetShowAllPins() );
+}
+
+
+void SCH_DRAW_PANEL_GAL::setWorldUnitLength()
+{
+    // Eeschema IU is 1 mil
+    m_gal->SetWorldUnitLength( 25400.0 / KIGFX::GAL::METRIC_UNIT_LENGTH * 2.54 );
+}
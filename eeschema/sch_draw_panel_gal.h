@@ -0,0 +1,73 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SCH_DRAW_PANEL_GAL_H_
+#define SCH_DRAW_PANEL_GAL_H_
+
+#include <class_draw_panel_gal.h>
+
+class SCH_SCREEN;
+
+/**
+ * Class SCH_DRAW_PANEL_GAL
+ * is the GAL canvas of Eeschema.  Each schematic layer is a view layer, cached by the
+ * GAL, so that zooming and panning only redraw the cached layers.
+ */
+class SCH_DRAW_PANEL_GAL : public EDA_DRAW_PANEL_GAL
+{
+public:
+    SCH_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
+                        const wxPoint& aPosition, const wxSize& aSize,
+                        GAL_TYPE aGalType = GAL_TYPE_OPENGL );
+
+    virtual ~SCH_DRAW_PANEL_GAL();
+
+    /**
+     * Function DisplaySheet
+     * adds all items of a schematic sheet to the VIEW, so they can be displayed by GAL.
+     * @param aScreen is the screen of the sheet to be loaded.
+     */
+    void DisplaySheet( const SCH_SCREEN* aScreen );
+
+    /**
+     * Function SyncSettings
+     * updates the colors of the layers and the display of the invisible pins from the
+     * parent SCH_EDIT_FRAME, and redraws the cached items with them.
+     */
+    void SyncSettings();
+
+    ///> @copydoc EDA_DRAW_PANEL_GAL::LoadGalSettings()
+    virtual bool LoadGalSettings();
+
+    ///> @copydoc EDA_DRAW_PANEL_GAL::OnShow()
+    void OnShow() override;
+
+protected:
+    ///> Loads the settings of the parent SCH_EDIT_FRAME, without redrawing the items.
+    void loadSettings();
+
+    ///> Sets the length of the world unit of the GAL, the Eeschema internal unit
+    void setWorldUnitLength();
+};
+
+#endif /* SCH_DRAW_PANEL_GAL_H_ */
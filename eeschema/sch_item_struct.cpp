@@ -85,6 +85,14 @@ bool SCH_ITEM::IsConnected( const wxPoint& aPosition ) const
 }
 
 
+void SCH_ITEM::ViewGetLayers( int aLayers[], int& aCount ) const
+{
+    // The GAL canvas has a view layer per schematic layer, that is per item color
+    aCount      = 1;
+    aLayers[0]  = m_Layer;
+}
+
+
 void SCH_ITEM::SwapData( SCH_ITEM* aItem )
 {
     wxFAIL_MSG( wxT( "SwapData() method not implemented for class " ) + GetClass() );
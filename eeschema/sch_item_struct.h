@@ -170,6 +170,9 @@ public:
      */
     void SetLayer( LAYERSCH_ID aLayer )  { m_Layer = aLayer; }
 
+    /// @copydoc VIEW_ITEM::ViewGetLayers()
+    virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
+
     /**
      * Function GetPenSize virtual pure
      * @return the size of the "pen" that be used to draw or plot this item
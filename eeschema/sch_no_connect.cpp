@@ -80,6 +80,13 @@ const EDA_RECT SCH_NO_CONNECT::GetBoundingBox() const
 }
 
 
+void SCH_NO_CONNECT::ViewGetLayers( int aLayers[], int& aCount ) const
+{
+    aCount      = 1;
+    aLayers[0]  = LAYER_NOCONNECT;
+}
+
+
 bool SCH_NO_CONNECT::Save( FILE* aFile ) const
 {
     bool success = true;
@@ -66,6 +66,9 @@ public:
 
     const EDA_RECT GetBoundingBox() const;  // Virtual
 
+    /// @copydoc VIEW_ITEM::ViewGetLayers()
+    void ViewGetLayers( int aLayers[], int& aCount ) const;
+
     // Geometric transforms (used in block operations):
 
     void Move( const wxPoint& aMoveVector )
@@ -93,6 +96,8 @@ public:
 
     wxPoint GetPosition() const { return m_pos; }
 
+    wxSize GetSize() const { return m_size; }
+
     void SetPosition( const wxPoint& aPosition ) { m_pos = aPosition; }
 
     bool HitTest( const wxPoint& aPosition, int aAccuracy ) const;
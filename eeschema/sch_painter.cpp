@@ -0,0 +1,751 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sch_painter.cpp
+ * @brief The GAL painter of the schematic items, drawing them as their Draw() functions
+ * draw them on the legacy canvas.
+ */
+
+#include <fctsys.h>
+#include <trigo.h>
+#include <drawtxt.h>
+#include <bezier_curves.h>
+
+#include <sch_painter.h>
+#include <sch_line.h>
+#include <sch_junction.h>
+#include <sch_no_connect.h>
+#include <sch_bus_entry.h>
+#include <sch_text.h>
+#include <sch_field.h>
+#include <sch_sheet.h>
+#include <sch_component.h>
+#include <class_libentry.h>
+#include <lib_arc.h>
+#include <lib_bezier.h>
+#include <lib_circle.h>
+#include <lib_pin.h>
+#include <lib_polyline.h>
+#include <lib_rectangle.h>
+#include <lib_text.h>
+#include <transform.h>
+#include <template_fieldnames.h>
+#include <gal/graphics_abstraction_layer.h>
+
+#include <deque>
+#include <boost/foreach.hpp>
+
+using namespace KIGFX;
+
+SCH_RENDER_SETTINGS::SCH_RENDER_SETTINGS()
+{
+    m_backgroundColor    = m_legacyColorMap[WHITE];
+    m_invisibleItemColor = m_legacyColorMap[DARKGRAY];
+    m_showHiddenPins     = false;
+
+    for( int i = 0; i < LAYERSCH_ID_COUNT; i++ )
+        m_layerColors[i] = m_legacyColorMap[BLACK];
+
+    update();
+}
+
+
+void SCH_RENDER_SETTINGS::ImportLegacyColors( const COLORS_DESIGN_SETTINGS* aSettings )
+{
+    for( LAYERSCH_ID layer = LAYER_FIRST; layer < LAYERSCH_ID_COUNT; ++layer )
+        m_layerColors[layer] = m_legacyColorMap[::GetLayerColor( layer )];
+
+    m_invisibleItemColor = m_legacyColorMap[GetInvisibleItemColor()];
+
+    update();
+}
+
+
+const COLOR4D& SCH_RENDER_SETTINGS::GetColor( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    if( aLayer < 0 || aLayer >= LAYERSCH_ID_COUNT )
+        return m_backgroundColor;
+
+    return m_layerColors[aLayer];
+}
+
+
+SCH_PAINTER::SCH_PAINTER( GAL* aGal ) :
+    PAINTER( aGal )
+{
+}
+
+
+bool SCH_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
+{
+    const EDA_ITEM* item = static_cast<const EDA_ITEM*>( aItem );
+
+    switch( item->Type() )
+    {
+    case SCH_LINE_T:
+        draw( static_cast<const SCH_LINE*>( item ), aLayer );
+        break;
+
+    case SCH_JUNCTION_T:
+        draw( static_cast<const SCH_JUNCTION*>( item ), aLayer );
+        break;
+
+    case SCH_NO_CONNECT_T:
+        draw( static_cast<const SCH_NO_CONNECT*>( item ), aLayer );
+        break;
+
+    case SCH_BUS_WIRE_ENTRY_T:
+    case SCH_BUS_BUS_ENTRY_T:
+        draw( static_cast<const SCH_BUS_ENTRY_BASE*>( item ), aLayer );
+        break;
+
+    case SCH_TEXT_T:
+    case SCH_LABEL_T:
+    case SCH_GLOBAL_LABEL_T:
+    case SCH_HIERARCHICAL_LABEL_T:
+    case SCH_SHEET_PIN_T:
+        draw( static_cast<const SCH_TEXT*>( item ), aLayer );
+        break;
+
+    case SCH_SHEET_T:
+        draw( static_cast<const SCH_SHEET*>( item ), aLayer );
+        break;
+
+    case SCH_COMPONENT_T:
+        draw( static_cast<const SCH_COMPONENT*>( item ), aLayer );
+        break;
+
+    default:
+        // Painter does not know how to draw the object
+        return false;
+    }
+
+    return true;
+}
+
+
+void SCH_PAINTER::draw( const SCH_LINE* aLine, int aLayer )
+{
+    // GAL has no dashed lines: the graphic lines of the notes are drawn solid
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_schSettings.GetColor( aLine, aLayer ) );
+    m_gal->SetLineWidth( aLine->GetPenSize() );
+    m_gal->DrawLine( VECTOR2D( aLine->GetStartPoint() ), VECTOR2D( aLine->GetEndPoint() ) );
+}
+
+
+void SCH_PAINTER::draw( const SCH_JUNCTION* aJunction, int aLayer )
+{
+    m_gal->SetIsFill( true );
+    m_gal->SetIsStroke( false );
+    m_gal->SetFillColor( m_schSettings.GetColor( aJunction, aLayer ) );
+    m_gal->DrawCircle( VECTOR2D( aJunction->GetPosition() ),
+                       SCH_JUNCTION::GetSymbolSize() / 2 );
+}
+
+
+void SCH_PAINTER::draw( const SCH_NO_CONNECT* aNoConnect, int aLayer )
+{
+    int      delta = aNoConnect->GetSize().x / 2;
+    VECTOR2D pos( aNoConnect->GetPosition() );
+
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_schSettings.GetColor( aNoConnect, aLayer ) );
+    m_gal->SetLineWidth( aNoConnect->GetPenSize() );
+    m_gal->DrawLine( pos + VECTOR2D( -delta, -delta ), pos + VECTOR2D( delta, delta ) );
+    m_gal->DrawLine( pos + VECTOR2D( delta, -delta ), pos + VECTOR2D( -delta, delta ) );
+}
+
+
+void SCH_PAINTER::draw( const SCH_BUS_ENTRY_BASE* aEntry, int aLayer )
+{
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_schSettings.GetColor( aEntry, aLayer ) );
+    m_gal->SetLineWidth( aEntry->GetPenSize() );
+    m_gal->DrawLine( VECTOR2D( aEntry->GetPosition() ), VECTOR2D( aEntry->m_End() ) );
+}
+
+
+void SCH_PAINTER::draw( const SCH_TEXT* aText, int aLayer )
+{
+    // The shapes of the labels are computed by the non const CreateGraphicShape()
+    SCH_TEXT* text = const_cast<SCH_TEXT*>( aText );
+    std::vector<wxPoint> shape;
+
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_schSettings.GetColor( aText, aLayer ) );
+    m_gal->SetLineWidth( aText->GetPenSize() );
+    m_gal->SetTextAttributes( aText );
+    m_gal->StrokeText( aText->GetShownText(),
+                       VECTOR2D( aText->GetPosition() + aText->GetSchematicTextOffset() ),
+                       aText->GetOrientationRadians() );
+
+    text->CreateGraphicShape( shape, aText->GetPosition() );
+
+    if( !shape.empty() )
+        drawPoly( shape, false );
+}
+
+
+void SCH_PAINTER::draw( const SCH_FIELD* aField, int aLayer )
+{
+    if( !aField->IsVisible() || aField->IsVoid() )
+        return;
+
+    SCH_COMPONENT* parentComponent = (SCH_COMPONENT*) aField->GetParent();
+    int            orient = aField->GetOrientation();
+
+    // As SCH_FIELD::Draw(), the text is centered on its bounding box, oriented by the
+    // component orientation
+    if( parentComponent->GetTransform().y1 )
+        orient = ( orient == TEXT_ORIENT_HORIZ ) ? TEXT_ORIENT_VERT : TEXT_ORIENT_HORIZ;
+
+    LAYERSCH_ID layer = LAYER_FIELDS;
+
+    if( aField->GetId() == REFERENCE )
+        layer = LAYER_REFERENCEPART;
+    else if( aField->GetId() == VALUE )
+        layer = LAYER_VALUEPART;
+
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_schSettings.GetLayerColor( layer ) );
+    drawText( aField->GetFullyQualifiedText(), aField->GetBoundingBox().Centre(), orient,
+              aField->GetSize(), GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER,
+              aField->GetPenSize(), aField->IsItalic(), aField->IsBold() );
+}
+
+
+void SCH_PAINTER::draw( const SCH_SHEET* aSheet, int aLayer )
+{
+    // The sheet accessors of the name positions and of the size are not const
+    SCH_SHEET* sheet = const_cast<SCH_SHEET*>( aSheet );
+    wxPoint    pos = aSheet->GetPosition();
+    int        lineWidth = aSheet->GetPenSize();
+    int        orient = aSheet->IsVerticalOrientation() ? TEXT_ORIENT_VERT : TEXT_ORIENT_HORIZ;
+    int        nameSize = aSheet->GetSheetNameSize();
+    int        fileNameSize = aSheet->GetFileNameSize();
+
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( m_schSettings.GetColor( aSheet, aLayer ) );
+    m_gal->SetLineWidth( lineWidth );
+    m_gal->DrawRectangle( VECTOR2D( pos ), VECTOR2D( pos + sheet->GetSize() ) );
+
+    m_gal->SetStrokeColor( m_schSettings.GetLayerColor( LAYER_SHEETNAME ) );
+    drawText( wxT( "Sheet: " ) + aSheet->GetName(), sheet->GetSheetNamePosition(), orient,
+              wxSize( nameSize, nameSize ), GR_TEXT_HJUSTIFY_LEFT, GR_TEXT_VJUSTIFY_BOTTOM,
+              lineWidth, false, false );
+
+    m_gal->SetStrokeColor( m_schSettings.GetLayerColor( LAYER_SHEETFILENAME ) );
+    drawText( wxT( "File: " ) + aSheet->GetFileName(), sheet->GetFileNamePosition(), orient,
+              wxSize( fileNameSize, fileNameSize ), GR_TEXT_HJUSTIFY_LEFT,
+              GR_TEXT_VJUSTIFY_TOP, lineWidth, false, false );
+
+    BOOST_FOREACH( SCH_SHEET_PIN& sheetPin, sheet->GetPins() )
+        draw( &sheetPin, LAYER_SHEETLABEL );
+}
+
+
+void SCH_PAINTER::draw( const SCH_COMPONENT* aComponent, int aLayer )
+{
+    // The components whose part is not found in the libraries only show their fields
+    if( PART_SPTR part = aComponent->GetPartRef().lock() )
+    {
+        drawPart( part.get(), aComponent->GetUnit(), aComponent->GetConvert(),
+                  aComponent->GetTransform(), aComponent->GetPosition() );
+    }
+
+    for( int ii = 0; ii < aComponent->GetFieldCount(); ii++ )
+        draw( aComponent->GetField( ii ), aLayer );
+}
+
+
+void SCH_PAINTER::drawPart( LIB_PART* aPart, int aUnit, int aConvert,
+                            const TRANSFORM& aTransform, const wxPoint& aPosition )
+{
+    // As LIB_PART::Draw(), the background of the body is drawn first, below all the items
+    for( int pass = 0; pass < 2; pass++ )
+    {
+        bool background = ( pass == 0 );
+
+        BOOST_FOREACH( LIB_ITEM& item, aPart->GetDrawItemList() )
+        {
+            // Do not draw items not attached to the current part
+            if( aUnit && item.GetUnit() && item.GetUnit() != aUnit )
+                continue;
+
+            if( aConvert && item.GetConvert() && item.GetConvert() != aConvert )
+                continue;
+
+            // The fields of the components are SCH_FIELDs
+            if( item.Type() == LIB_FIELD_T )
+                continue;
+
+            if( background )
+            {
+                if( item.GetFillMode() == FILLED_WITH_BG_BODYCOLOR )
+                    drawLibItem( &item, aTransform, aPosition, true );
+            }
+            else if( item.Type() == LIB_PIN_T )
+            {
+                drawPin( aPart, static_cast<LIB_PIN*>( &item ), aTransform, aPosition );
+            }
+            else
+            {
+                drawLibItem( &item, aTransform, aPosition, false );
+            }
+        }
+    }
+}
+
+
+void SCH_PAINTER::drawLibItem( const LIB_ITEM* aItem, const TRANSFORM& aTransform,
+                               const wxPoint& aPosition, bool aBackground )
+{
+    const COLOR4D& color = m_schSettings.GetLayerColor( LAYER_DEVICE );
+    FILL_T         fill = aItem->GetFillMode();
+
+    if( aBackground )
+    {
+        m_gal->SetIsFill( true );
+        m_gal->SetIsStroke( false );
+        m_gal->SetFillColor( m_schSettings.GetLayerColor( LAYER_DEVICE_BACKGROUND ) );
+    }
+    else
+    {
+        m_gal->SetIsFill( fill == FILLED_SHAPE );
+        m_gal->SetIsStroke( true );
+        m_gal->SetFillColor( color );
+        m_gal->SetStrokeColor( color );
+        m_gal->SetLineWidth( aItem->GetPenSize() );
+    }
+
+    switch( aItem->Type() )
+    {
+    case LIB_RECTANGLE_T:
+    {
+        const LIB_RECTANGLE* rect = static_cast<const LIB_RECTANGLE*>( aItem );
+
+        m_gal->DrawRectangle(
+                VECTOR2D( aTransform.TransformCoordinate( rect->GetPosition() ) + aPosition ),
+                VECTOR2D( aTransform.TransformCoordinate( rect->GetEnd() ) + aPosition ) );
+    }
+        break;
+
+    case LIB_CIRCLE_T:
+    {
+        const LIB_CIRCLE* circle = static_cast<const LIB_CIRCLE*>( aItem );
+
+        m_gal->DrawCircle(
+                VECTOR2D( aTransform.TransformCoordinate( circle->GetPosition() ) + aPosition ),
+                circle->GetRadius() );
+    }
+        break;
+
+    case LIB_ARC_T:
+    {
+        const LIB_ARC* arc = static_cast<const LIB_ARC*>( aItem );
+        VECTOR2D pos1( aTransform.TransformCoordinate( arc->GetEnd() ) + aPosition );
+        VECTOR2D pos2( aTransform.TransformCoordinate( arc->GetStart() ) + aPosition );
+        VECTOR2D center( aTransform.TransformCoordinate( arc->GetPosition() ) + aPosition );
+        int      t1 = arc->GetFirstRadiusAngle();
+        int      t2 = arc->GetSecondRadiusAngle();
+
+        if( aTransform.MapAngles( &t1, &t2 ) )
+            std::swap( pos1, pos2 );
+
+        // As GRArc1(), the arc goes counterclockwise on screen from pos1 to pos2, that is
+        // from pos2 to pos1 with increasing angles, the Y axis being top to bottom
+        double startAngle = ( pos2 - center ).Angle();
+        double endAngle = ( pos1 - center ).Angle();
+
+        if( endAngle <= startAngle )
+            endAngle += 2 * M_PI;
+
+        m_gal->DrawArc( center, arc->GetRadius(), startAngle, endAngle );
+    }
+        break;
+
+    case LIB_POLYLINE_T:
+    case LIB_BEZIER_T:
+    {
+        std::vector<wxPoint> corners;
+
+        if( aItem->Type() == LIB_POLYLINE_T )
+        {
+            corners = static_cast<const LIB_POLYLINE*>( aItem )->GetPolyPoints();
+        }
+        else
+        {
+            const std::vector<wxPoint>& bezier =
+                    static_cast<const LIB_BEZIER*>( aItem )->GetBezierPoints();
+
+            if( bezier.size() < 4 )
+                break;
+
+            corners = Bezier2Poly( bezier[0], bezier[1], bezier[2], bezier[3] );
+        }
+
+        for( unsigned ii = 0; ii < corners.size(); ii++ )
+            corners[ii] = aTransform.TransformCoordinate( corners[ii] ) + aPosition;
+
+        // the outline of a body filled with the background color is not closed
+        drawPoly( corners, aBackground || fill == FILLED_SHAPE );
+    }
+        break;
+
+    case LIB_TEXT_T:
+    {
+        const LIB_TEXT* text = static_cast<const LIB_TEXT*>( aItem );
+
+        if( aBackground || !text->IsVisible() )
+            break;
+
+        // As LIB_TEXT::drawGraphic(), the text is centered on its bounding box and
+        // oriented by the component orientation
+        int orient = text->GetOrientation();
+
+        if( aTransform.y1 )
+            orient = ( orient == TEXT_ORIENT_HORIZ ) ? TEXT_ORIENT_VERT : TEXT_ORIENT_HORIZ;
+
+        EDA_RECT bBox = text->GetBoundingBox();
+
+        // convert coordinates from draw Y axis to libedit Y axis:
+        bBox.RevertYAxis();
+
+        drawText( text->GetShownText(), aTransform.TransformCoordinate( bBox.Centre() ) + aPosition,
+                  orient, text->GetSize(), GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER,
+                  text->GetPenSize(), text->IsItalic(), text->IsBold() );
+    }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void SCH_PAINTER::drawPin( LIB_PART* aPart, const LIB_PIN* aPin, const TRANSFORM& aTransform,
+                           const wxPoint& aPosition )
+{
+    COLOR4D color     = m_schSettings.GetLayerColor( LAYER_PIN );
+    COLOR4D nameColor = m_schSettings.GetLayerColor( LAYER_PINNAM );
+    COLOR4D numColor  = m_schSettings.GetLayerColor( LAYER_PINNUM );
+
+    // Invisible pins are drawn only on request, in the invisible item color
+    if( !aPin->IsVisible() )
+    {
+        if( !m_schSettings.m_showHiddenPins )
+            return;
+
+        color = nameColor = numColor = m_schSettings.m_invisibleItemColor;
+    }
+
+    int     orient = aPin->PinDrawOrient( aTransform );
+    wxPoint pos = aTransform.TransformCoordinate( aPin->GetPosition() ) + aPosition;
+    int     len = aPin->GetLength();
+    int     mapX = 0, mapY = 0;
+    wxPoint end = pos;
+
+    switch( orient )
+    {
+    case PIN_UP:
+        end.y = pos.y - len;
+        mapY  = 1;
+        break;
+
+    case PIN_DOWN:
+        end.y = pos.y + len;
+        mapY  = -1;
+        break;
+
+    case PIN_LEFT:
+        end.x = pos.x - len;
+        mapX  = 1;
+        break;
+
+    case PIN_RIGHT:
+        end.x = pos.x + len;
+        mapX  = -1;
+        break;
+    }
+
+    GRAPHIC_PINSHAPE shape = aPin->GetShape();
+
+    // the decoration sizes, as InternalPinDecoSize() and ExternalPinDecoSize()
+    int internalSize = aPin->GetNameTextSize() / 2;
+    int externalSize = aPin->GetNumberTextSize() / 2;
+
+    std::vector<wxPoint> line;
+
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetStrokeColor( color );
+    m_gal->SetLineWidth( aPin->GetPenSize() );
+
+    // The pin line, as LIB_PIN::DrawPinSymbol(), and the external decorations
+    if( shape == PINSHAPE_INVERTED || shape == PINSHAPE_INVERTED_CLOCK )
+    {
+        m_gal->DrawCircle( VECTOR2D( end.x + mapX * externalSize, end.y + mapY * externalSize ),
+                           externalSize );
+        m_gal->DrawLine( VECTOR2D( end.x + mapX * externalSize * 2,
+                                   end.y + mapY * externalSize * 2 ), VECTOR2D( pos ) );
+    }
+    else if( shape == PINSHAPE_FALLING_EDGE_CLOCK )
+    {
+        if( mapY == 0 )
+        {
+            line.push_back( wxPoint( end.x, end.y + internalSize ) );
+            line.push_back( wxPoint( end.x + mapX * internalSize * 2, end.y ) );
+            line.push_back( wxPoint( end.x, end.y - internalSize ) );
+        }
+        else
+        {
+            line.push_back( wxPoint( end.x + internalSize, end.y ) );
+            line.push_back( wxPoint( end.x, end.y + mapY * internalSize * 2 ) );
+            line.push_back( wxPoint( end.x - internalSize, end.y ) );
+        }
+
+        drawPoly( line, false );
+        m_gal->DrawLine( VECTOR2D( end.x + mapX * internalSize * 2,
+                                   end.y + mapY * internalSize * 2 ), VECTOR2D( pos ) );
+    }
+    else
+    {
+        m_gal->DrawLine( VECTOR2D( end ), VECTOR2D( pos ) );
+    }
+
+    // The clock, drawn inside the body
+    if( shape == PINSHAPE_CLOCK || shape == PINSHAPE_INVERTED_CLOCK
+            || shape == PINSHAPE_CLOCK_LOW )
+    {
+        line.clear();
+
+        if( mapY == 0 )
+        {
+            line.push_back( wxPoint( end.x, end.y + internalSize ) );
+            line.push_back( wxPoint( end.x - mapX * internalSize * 2, end.y ) );
+            line.push_back( wxPoint( end.x, end.y - internalSize ) );
+        }
+        else
+        {
+            line.push_back( wxPoint( end.x + internalSize, end.y ) );
+            line.push_back( wxPoint( end.x, end.y - mapY * internalSize * 2 ) );
+            line.push_back( wxPoint( end.x - internalSize, end.y ) );
+        }
+
+        drawPoly( line, false );
+    }
+
+    if( shape == PINSHAPE_INPUT_LOW || shape == PINSHAPE_CLOCK_LOW )
+    {
+        line.clear();
+
+        if( mapY == 0 )
+        {
+            line.push_back( wxPoint( end.x + mapX * externalSize * 2, end.y ) );
+            line.push_back( wxPoint( end.x + mapX * externalSize * 2,
+                                     end.y - externalSize * 2 ) );
+            line.push_back( end );
+        }
+        else
+        {
+            line.push_back( wxPoint( end.x, end.y + mapY * externalSize * 2 ) );
+            line.push_back( wxPoint( end.x - externalSize * 2,
+                                     end.y + mapY * externalSize * 2 ) );
+            line.push_back( end );
+        }
+
+        drawPoly( line, false );
+    }
+
+    if( shape == PINSHAPE_OUTPUT_LOW )    // IEEE symbol "Active Low Output"
+    {
+        if( mapY == 0 )
+            m_gal->DrawLine( VECTOR2D( end.x, end.y - externalSize * 2 ),
+                             VECTOR2D( end.x + mapX * externalSize * 2, end.y ) );
+        else
+            m_gal->DrawLine( VECTOR2D( end.x - externalSize * 2, end.y ),
+                             VECTOR2D( end.x, end.y + mapY * externalSize * 2 ) );
+    }
+    else if( shape == PINSHAPE_NONLOGIC )
+    {
+        m_gal->DrawLine( VECTOR2D( end.x - ( mapX + mapY ) * externalSize,
+                                   end.y - ( mapY - mapX ) * externalSize ),
+                         VECTOR2D( end.x + ( mapX + mapY ) * externalSize,
+                                   end.y + ( mapY - mapX ) * externalSize ) );
+        m_gal->DrawLine( VECTOR2D( end.x - ( mapX - mapY ) * externalSize,
+                                   end.y - ( mapY + mapX ) * externalSize ),
+                         VECTOR2D( end.x + ( mapX - mapY ) * externalSize,
+                                   end.y + ( mapY + mapX ) * externalSize ) );
+    }
+
+    if( aPin->GetType() == PIN_NC )   // Draw a N.C. symbol
+    {
+        VECTOR2D center( pos );
+        m_gal->DrawLine( center + VECTOR2D( -TARGET_PIN_RADIUS, -TARGET_PIN_RADIUS ),
+                         center + VECTOR2D( TARGET_PIN_RADIUS, TARGET_PIN_RADIUS ) );
+        m_gal->DrawLine( center + VECTOR2D( TARGET_PIN_RADIUS, -TARGET_PIN_RADIUS ),
+                         center + VECTOR2D( -TARGET_PIN_RADIUS, TARGET_PIN_RADIUS ) );
+    }
+
+    drawPinTexts( aPart, aPin, pos, orient, nameColor, numColor );
+}
+
+
+void SCH_PAINTER::drawPinTexts( LIB_PART* aPart, const LIB_PIN* aPin, const wxPoint& aPinPos,
+                                int aOrient, const COLOR4D& aNameColor,
+                                const COLOR4D& aNumColor )
+{
+    bool drawName = aPart->ShowPinNames() && !aPin->GetName().IsEmpty();
+    bool drawNum  = aPart->ShowPinNumbers();
+
+    if( !drawName && !drawNum )
+        return;
+
+    int    textInside = aPart->GetPinNameOffset();
+    int    nameTextSize = aPin->GetNameTextSize();
+    int    numTextSize = aPin->GetNumberTextSize();
+    wxSize nameSize( nameTextSize, nameTextSize );
+    wxSize numSize( numTextSize, numTextSize );
+    int    nameLineWidth = Clamp_Text_PenSize( aPin->GetPenSize(), nameTextSize, false );
+    int    numLineWidth = Clamp_Text_PenSize( aPin->GetPenSize(), numTextSize, false );
+    int    nameOffset = PIN_TEXT_MARGIN + ( nameLineWidth + GetDefaultLineThickness() ) / 2;
+    int    numOffset = PIN_TEXT_MARGIN + ( numLineWidth + GetDefaultLineThickness() ) / 2;
+    bool   horizontal = ( aOrient == PIN_LEFT || aOrient == PIN_RIGHT );
+    int    orient = horizontal ? TEXT_ORIENT_HORIZ : TEXT_ORIENT_VERT;
+
+    wxPoint end = aPinPos;
+
+    switch( aOrient )
+    {
+    case PIN_UP:    end.y -= aPin->GetLength(); break;
+    case PIN_DOWN:  end.y += aPin->GetLength(); break;
+    case PIN_LEFT:  end.x -= aPin->GetLength(); break;
+    case PIN_RIGHT: end.x += aPin->GetLength(); break;
+    }
+
+    wxPoint middle( ( end.x + aPinPos.x ) / 2, ( end.y + aPinPos.y ) / 2 );
+    wxPoint namePos, numPos;
+    EDA_TEXT_HJUSTIFY_T nameHJustify = GR_TEXT_HJUSTIFY_CENTER;
+    EDA_TEXT_VJUSTIFY_T nameVJustify = GR_TEXT_VJUSTIFY_BOTTOM;
+    EDA_TEXT_VJUSTIFY_T numVJustify = GR_TEXT_VJUSTIFY_TOP;
+
+    // As LIB_PIN::DrawPinTexts(), the names are drawn inside the body after the pin end,
+    // or else above the pin line.  The numbers are drawn above the pin line when the
+    // names are inside, else below it.
+    if( textInside )
+    {
+        nameVJustify = GR_TEXT_VJUSTIFY_CENTER;
+        numVJustify = GR_TEXT_VJUSTIFY_BOTTOM;
+
+        switch( aOrient )
+        {
+        case PIN_RIGHT:
+            namePos = wxPoint( end.x + textInside, end.y );
+            nameHJustify = GR_TEXT_HJUSTIFY_LEFT;
+            break;
+
+        case PIN_LEFT:
+            namePos = wxPoint( end.x - textInside, end.y );
+            nameHJustify = GR_TEXT_HJUSTIFY_RIGHT;
+            break;
+
+        case PIN_DOWN:
+            // vertical texts are drawn from bottom to top
+            namePos = wxPoint( end.x, end.y + textInside );
+            nameHJustify = GR_TEXT_HJUSTIFY_RIGHT;
+            break;
+
+        case PIN_UP:
+            namePos = wxPoint( end.x, end.y - textInside );
+            nameHJustify = GR_TEXT_HJUSTIFY_LEFT;
+            break;
+        }
+
+        numPos = horizontal ? wxPoint( middle.x, end.y - numOffset )
+                            : wxPoint( end.x - numOffset, middle.y );
+    }
+    else if( horizontal )
+    {
+        namePos = wxPoint( middle.x, end.y - nameOffset );
+        numPos = wxPoint( middle.x, end.y + numOffset );
+    }
+    else
+    {
+        namePos = wxPoint( end.x - nameOffset, middle.y );
+        numPos = wxPoint( end.x + numOffset, middle.y );
+    }
+
+    if( drawName )
+    {
+        m_gal->SetStrokeColor( aNameColor );
+        drawText( aPin->GetName(), namePos, orient, nameSize, nameHJustify, nameVJustify,
+                  nameLineWidth, false, false );
+    }
+
+    if( drawNum )
+    {
+        m_gal->SetStrokeColor( aNumColor );
+        drawText( aPin->GetNumberString(), numPos, orient, numSize, GR_TEXT_HJUSTIFY_CENTER,
+                  numVJustify, numLineWidth, false, false );
+    }
+}
+
+
+void SCH_PAINTER::drawText( const wxString& aText, const wxPoint& aPosition, double aAngle,
+                            const wxSize& aSize, EDA_TEXT_HJUSTIFY_T aHJustify,
+                            EDA_TEXT_VJUSTIFY_T aVJustify, int aWidth, bool aItalic,
+                            bool aBold )
+{
+    m_gal->SetIsFill( false );
+    m_gal->SetIsStroke( true );
+    m_gal->SetLineWidth( aWidth );
+    m_gal->SetGlyphSize( VECTOR2D( aSize ) );
+    m_gal->SetHorizontalJustify( aHJustify );
+    m_gal->SetVerticalJustify( aVJustify );
+    m_gal->SetFontItalic( aItalic );
+    m_gal->SetFontBold( aBold );
+    m_gal->SetTextMirrored( false );
+    m_gal->StrokeText( aText, VECTOR2D( aPosition ), DECIDEG2RAD( aAngle ) );
+}
+
+
+void SCH_PAINTER::drawPoly( const std::vector<wxPoint>& aPoints, bool aClosed )
+{
+    std::deque<VECTOR2D> points;
+
+    for( unsigned ii = 0; ii < aPoints.size(); ii++ )
+        points.push_back( VECTOR2D( aPoints[ii] ) );
+
+    if( aClosed )
+        m_gal->DrawPolygon( points );
+    else
+        m_gal->DrawPolyline( points );
+}
@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __SCH_PAINTER_H
+#define __SCH_PAINTER_H
+
+#include <vector>
+#include <painter.h>
+#include <eda_text.h>
+#include <general.h>
+
+
+class COLORS_DESIGN_SETTINGS;
+class TRANSFORM;
+class SCH_LINE;
+class SCH_JUNCTION;
+class SCH_NO_CONNECT;
+class SCH_BUS_ENTRY_BASE;
+class SCH_TEXT;
+class SCH_FIELD;
+class SCH_SHEET;
+class SCH_COMPONENT;
+class LIB_PART;
+class LIB_ITEM;
+class LIB_PIN;
+
+namespace KIGFX
+{
+class GAL;
+
+/**
+ * Class SCH_RENDER_SETTINGS
+ * Stores Eeschema specific render settings: the colors of the schematic layers and the
+ * display of the invisible pins.
+ */
+class SCH_RENDER_SETTINGS : public RENDER_SETTINGS
+{
+public:
+    friend class SCH_PAINTER;
+
+    SCH_RENDER_SETTINGS();
+
+    /**
+     * Function ImportLegacyColors
+     * Loads the colors of the schematic layers, see GetLayerColor().  Eeschema does not
+     * store them in a COLORS_DESIGN_SETTINGS, @a aSettings is not used.
+     */
+    void ImportLegacyColors( const COLORS_DESIGN_SETTINGS* aSettings );
+
+    /// @copydoc RENDER_SETTINGS::GetColor()
+    virtual const COLOR4D& GetColor( const VIEW_ITEM* aItem, int aLayer ) const;
+
+    /// @copydoc RENDER_SETTINGS::GetGridColor()
+    virtual const COLOR4D& GetGridColor() const
+    {
+        return m_layerColors[LAYER_GRID];
+    }
+
+    /**
+     * Function GetLayerColor
+     * Returns the color used to draw the items of a schematic layer.
+     */
+    const COLOR4D& GetLayerColor( LAYERSCH_ID aLayer ) const
+    {
+        return m_layerColors[aLayer];
+    }
+
+    /**
+     * Function SetShowHiddenPins
+     * Sets the display of the invisible pins of the components, as
+     * SCH_EDIT_FRAME::GetShowAllPins().
+     */
+    void SetShowHiddenPins( bool aShow )
+    {
+        m_showHiddenPins = aShow;
+    }
+
+protected:
+    ///> Colors of the schematic layers
+    COLOR4D m_layerColors[LAYERSCH_ID_COUNT];
+
+    ///> Color of the invisible pins, when they are shown
+    COLOR4D m_invisibleItemColor;
+
+    ///> Flag determining if the invisible pins are shown
+    bool    m_showHiddenPins;
+};
+
+
+/**
+ * Class SCH_PAINTER
+ * Contains methods for drawing the schematic items, and the library items of the
+ * components.
+ */
+class SCH_PAINTER : public PAINTER
+{
+public:
+    SCH_PAINTER( GAL* aGal );
+
+    /// @copydoc PAINTER::ApplySettings()
+    virtual void ApplySettings( const RENDER_SETTINGS* aSettings )
+    {
+        m_schSettings = *static_cast<const SCH_RENDER_SETTINGS*>( aSettings );
+    }
+
+    /// @copydoc PAINTER::GetSettings()
+    virtual RENDER_SETTINGS* GetSettings()
+    {
+        return &m_schSettings;
+    }
+
+    /// @copydoc PAINTER::Draw()
+    virtual bool Draw( const VIEW_ITEM* aItem, int aLayer );
+
+protected:
+    SCH_RENDER_SETTINGS m_schSettings;
+
+    void draw( const SCH_LINE* aLine, int aLayer );
+    void draw( const SCH_JUNCTION* aJunction, int aLayer );
+    void draw( const SCH_NO_CONNECT* aNoConnect, int aLayer );
+    void draw( const SCH_BUS_ENTRY_BASE* aEntry, int aLayer );
+    void draw( const SCH_TEXT* aText, int aLayer );
+    void draw( const SCH_FIELD* aField, int aLayer );
+    void draw( const SCH_SHEET* aSheet, int aLayer );
+    void draw( const SCH_COMPONENT* aComponent, int aLayer );
+
+    ///> Draws the items of a unit of a part, placed by aTransform at aPosition
+    void drawPart( LIB_PART* aPart, int aUnit, int aConvert, const TRANSFORM& aTransform,
+                   const wxPoint& aPosition );
+
+    ///> Draws a graphic item of a part, aBackground to draw only the body background fill
+    void drawLibItem( const LIB_ITEM* aItem, const TRANSFORM& aTransform,
+                      const wxPoint& aPosition, bool aBackground );
+
+    ///> Draws a pin, its shape and its texts, as LIB_PIN::drawGraphic()
+    void drawPin( LIB_PART* aPart, const LIB_PIN* aPin, const TRANSFORM& aTransform,
+                  const wxPoint& aPosition );
+
+    ///> Draws the name and the number of a pin, as LIB_PIN::DrawPinTexts()
+    void drawPinTexts( LIB_PART* aPart, const LIB_PIN* aPin, const wxPoint& aPinPos,
+                       int aOrient, const COLOR4D& aNameColor, const COLOR4D& aNumColor );
+
+    ///> Draws a line of text with the given attributes, the angle in 0.1 degrees
+    void drawText( const wxString& aText, const wxPoint& aPosition, double aAngle,
+                   const wxSize& aSize, EDA_TEXT_HJUSTIFY_T aHJustify,
+                   EDA_TEXT_VJUSTIFY_T aVJustify, int aWidth, bool aItalic, bool aBold );
+
+    ///> Draws a polyline, or a polygon when aClosed is true
+    void drawPoly( const std::vector<wxPoint>& aPoints, bool aClosed );
+};
+} // namespace KIGFX
+
+#endif /* __SCH_PAINTER_H */
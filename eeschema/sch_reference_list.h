@@ -40,6 +40,7 @@
 #include <sch_text.h>
 
 #include <map>
+#include <set>
 
 class SCH_REFERENCE;
 class SCH_REFERENCE_LIST;
@@ -172,6 +173,43 @@ public:
 };
 
 
+/**
+ * Class SCH_REFERENCE_NUMBERS
+ * holds the reference numbers in use by reference prefix, so that the first free number of
+ * a prefix from a given value is found in logarithmic time, instead of searching a sorted
+ * list of the numbers for a hole.
+ */
+class SCH_REFERENCE_NUMBERS
+{
+public:
+    /**
+     * Function Add
+     * marks the number of a reference as in use for its prefix.
+     */
+    void Add( const std::string& aPrefix, int aNumber )
+    {
+        m_prefixes[aPrefix].m_Used.insert( aNumber );
+    }
+
+    /**
+     * Function CreateFirstFree
+     * returns the first number not in use for \a aPrefix from \a aFirstValue, and marks it
+     * as in use.
+     */
+    int CreateFirstFree( const std::string& aPrefix, int aFirstValue );
+
+private:
+    struct PREFIX_NUMBERS
+    {
+        std::set<int>       m_Used;         ///< The numbers in use
+        std::map<int, int>  m_FirstFree;    ///< From each first value asked for, all the
+                                            ///< numbers below this one are in use
+    };
+
+    std::map<std::string, PREFIX_NUMBERS> m_prefixes;
+};
+
+
 /**
  * Class SCH_REFERENCE_LIST
  * is used to create a flattened list of components because in a complex hierarchy, a component
@@ -282,7 +320,8 @@ public:
 
     /**
      * Function Annotate
-     * set the reference designators in the list that have not been annotated.
+     * set the reference designators in the list that have not been annotated.  The list
+     * has to be sorted by reference prefix first, as by SortByXCoordinate().
      * @param aUseSheetNum Set to true to start annotation for each sheet at the sheet number
      *                     times \a aSheetIntervalId.  Otherwise annotate incrementally.
      * @param aSheetIntervalId The per sheet reference designator multiplier.
@@ -296,7 +335,8 @@ public:
      * referenced U201 to U351, and items in sheet 3 start from U352
      * </p>
      */
-    void Annotate( bool aUseSheetNum, int aSheetIntervalId, SCH_MULTI_UNIT_REFERENCE_MAP aLockedUnitMap );
+    void Annotate( bool aUseSheetNum, int aSheetIntervalId,
+                   SCH_MULTI_UNIT_REFERENCE_MAP& aLockedUnitMap );
 
     /**
      * Function CheckAnnotation
@@ -451,19 +491,6 @@ private:
     static bool sortByTimeStamp( const SCH_REFERENCE& item1, const SCH_REFERENCE& item2 );
 
     static bool sortByReferenceOnly( const SCH_REFERENCE& item1, const SCH_REFERENCE& item2 );
-
-    /**
-     * Function CreateFirstFreeRefId
-     * searches for the first free reference number in \a aListId of reference numbers in use.
-     * This function just searches for a hole in a list of incremented numbers, this list must
-     * be sorted by increasing values and each value can be stored only once.  The new value
-     * is added to the list.
-     * @see BuildRefIdInUseList to prepare this list
-     * @param aIdList The buffer that contains the reference numbers in use.
-     * @param aFirstValue The first expected free value
-     * @return The first free (not yet used) value.
-     */
-    int CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue );
 };
 
 #endif    // _SCH_REFERENCE_LIST_H_
@@ -54,6 +54,9 @@
 #include <sch_text.h>
 #include <lib_pin.h>
 
+#include <algorithm>
+#include <map>
+
 #include <boost/foreach.hpp>
 
 #define EESCHEMA_FILE_STAMP   "EESchema"
@@ -929,6 +932,15 @@ int SCH_SCREEN::UpdatePickList()
 }
 
 
+// The size of the cells of the grid indexing the end points in TestDanglingEnds()
+#define DANGLING_GRID_SIZE 256
+
+static int danglingGridCell( int aCoord )
+{
+    return aCoord >= 0 ? aCoord / DANGLING_GRID_SIZE : -( ( -aCoord - 1 ) / DANGLING_GRID_SIZE ) - 1;
+}
+
+
 bool SCH_SCREEN::TestDanglingEnds()
 {
     SCH_ITEM* item;
@@ -938,9 +950,79 @@ bool SCH_SCREEN::TestDanglingEnds()
     for( item = m_drawList.begin(); item; item = item->Next() )
         item->GetEndPoints( endPoints );
 
+    // An item is only connected at its own end points, tested against the end points at
+    // the same position and the wires and buses going through it.  The grid gives each
+    // item these end points only, in the list order, instead of the whole list.  The wires
+    // and buses are a start and end pair in the list, kept together under the start.
+    typedef std::map< std::pair<int, int>, std::vector<unsigned> > GRID;
+
+    GRID grid;
+
+    for( unsigned ii = 0; ii < endPoints.size(); ii++ )
+    {
+        const wxPoint& pos = endPoints[ii].GetPosition();
+        DANGLING_END_T type = endPoints[ii].GetType();
+
+        if( ( type == WIRE_START_END || type == BUS_START_END ) && ii + 1 < endPoints.size() )
+        {
+            const wxPoint& end = endPoints[ii + 1].GetPosition();
+            int x0 = danglingGridCell( std::min( pos.x, end.x ) );
+            int x1 = danglingGridCell( std::max( pos.x, end.x ) );
+            int y0 = danglingGridCell( std::min( pos.y, end.y ) );
+            int y1 = danglingGridCell( std::max( pos.y, end.y ) );
+
+            for( int x = x0; x <= x1; x++ )
+            {
+                for( int y = y0; y <= y1; y++ )
+                    grid[ std::make_pair( x, y ) ].push_back( ii );
+            }
+
+            ii++;
+        }
+        else
+        {
+            grid[ std::make_pair( danglingGridCell( pos.x ), danglingGridCell( pos.y ) ) ].push_back( ii );
+        }
+    }
+
+    std::vector< DANGLING_END_ITEM > ownPoints;
+    std::vector< DANGLING_END_ITEM > nearPoints;
+    std::vector< unsigned > candidates;
+
     for( item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( item->IsDanglingStateChanged( endPoints ) )
+        ownPoints.clear();
+        item->GetEndPoints( ownPoints );
+
+        candidates.clear();
+
+        for( unsigned ii = 0; ii < ownPoints.size(); ii++ )
+        {
+            const wxPoint& pos = ownPoints[ii].GetPosition();
+            GRID::const_iterator cell = grid.find( std::make_pair( danglingGridCell( pos.x ),
+                                                                   danglingGridCell( pos.y ) ) );
+
+            if( cell != grid.end() )
+                candidates.insert( candidates.end(), cell->second.begin(), cell->second.end() );
+        }
+
+        std::sort( candidates.begin(), candidates.end() );
+        candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
+        nearPoints.clear();
+
+        for( unsigned ii = 0; ii < candidates.size(); ii++ )
+        {
+            DANGLING_END_T type = endPoints[candidates[ii]].GetType();
+
+            nearPoints.push_back( endPoints[candidates[ii]] );
+
+            if( ( type == WIRE_START_END || type == BUS_START_END )
+                && candidates[ii] + 1 < endPoints.size() )
+                nearPoints.push_back( endPoints[candidates[ii] + 1] );
+        }
+
+        if( item->IsDanglingStateChanged( nearPoints ) )
             hasStateChanged = true;
     }
 
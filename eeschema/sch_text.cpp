@@ -661,7 +661,7 @@ bool SCH_TEXT::HitTest( const EDA_RECT& aRect, bool aContained, int aAccuracy )
 
 void SCH_TEXT::Plot( PLOTTER* aPlotter )
 {
-    static std::vector <wxPoint> Poly;
+    std::vector <wxPoint> Poly;
     EDA_COLOR_T color = GetLayerColor( GetLayer() );
     int         thickness = GetPenSize();
 
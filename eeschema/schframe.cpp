@@ -62,6 +62,38 @@
 
 #include <netlist_exporter_kicad.h>
 #include <kiway.h>
+#include <sch_draw_panel_gal.h>
+#include <view/view.h>
+
+
+// Config keywords
+static const wxString   cfgCanvasType( wxT( "canvas_type" ) );
+
+
+static EDA_DRAW_PANEL_GAL::GAL_TYPE loadCanvasTypeSetting()
+{
+    EDA_DRAW_PANEL_GAL::GAL_TYPE canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE;
+    wxConfigBase* cfg = Kiface().KifaceSettings();
+
+    if( cfg )
+        canvasType = (EDA_DRAW_PANEL_GAL::GAL_TYPE) cfg->ReadLong(
+                cfgCanvasType, EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE );
+
+    if( canvasType < EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE
+            || canvasType >= EDA_DRAW_PANEL_GAL::GAL_TYPE_LAST )
+        canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE;
+
+    return canvasType;
+}
+
+
+static void saveCanvasTypeSetting( EDA_DRAW_PANEL_GAL::GAL_TYPE aCanvasType )
+{
+    wxConfigBase* cfg = Kiface().KifaceSettings();
+
+    if( cfg )
+        cfg->Write( cfgCanvasType, (long) aCanvasType );
+}
 
 
 // non-member so it can be moved easily, and kept REALLY private.
@@ -242,6 +274,10 @@ BEGIN_EVENT_TABLE( SCH_EDIT_FRAME, EDA_DRAW_FRAME )
 
     EVT_TOOL( wxID_PREFERENCES, SCH_EDIT_FRAME::OnPreferencesOptions )
 
+    EVT_MENU( ID_MENU_SCH_CANVAS_LEGACY, SCH_EDIT_FRAME::SwitchCanvas )
+    EVT_MENU( ID_MENU_SCH_CANVAS_OPENGL, SCH_EDIT_FRAME::SwitchCanvas )
+    EVT_MENU( ID_MENU_SCH_CANVAS_CAIRO, SCH_EDIT_FRAME::SwitchCanvas )
+
     EVT_TOOL( ID_RUN_LIBRARY, SCH_EDIT_FRAME::OnOpenLibraryEditor )
     EVT_TOOL( ID_POPUP_SCH_CALL_LIBEDIT_AND_LOAD_CMP, SCH_EDIT_FRAME::OnOpenLibraryEditor )
     EVT_TOOL( ID_TO_LIBVIEW, SCH_EDIT_FRAME::OnOpenLibraryViewer )
@@ -374,6 +410,10 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
     if( m_canvas )
         m_canvas->SetEnableBlockCommands( true );
 
+    // Create the GAL canvas, used once a GAL backend is selected
+    SetGalCanvas( new SCH_DRAW_PANEL_GAL( this, -1, wxPoint( 0, 0 ), m_FrameSize,
+                                          EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE ) );
+
     ReCreateMenuBar();
     ReCreateHToolbar();
     ReCreateVToolbar();
@@ -410,6 +450,10 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
     if( m_canvas )
         m_auimgr.AddPane( m_canvas, wxAuiPaneInfo().Name( wxT( "DrawFrame" ) ).CentrePane() );
 
+    if( GetGalCanvas() )
+        m_auimgr.AddPane( (wxWindow*) GetGalCanvas(),
+                          wxAuiPaneInfo().Name( wxT( "DrawFrameGal" ) ).CentrePane().Hide() );
+
     if( m_messagePanel )
         m_auimgr.AddPane( m_messagePanel, wxAuiPaneInfo( mesg ).Name( wxT( "MsgPanel" ) ).Bottom().
                           Layer(10) );
@@ -423,6 +467,14 @@ SCH_EDIT_FRAME::SCH_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ):
 
     // Net list generator
     DefaultExecFlags();
+
+    EDA_DRAW_PANEL_GAL::GAL_TYPE canvasType = loadCanvasTypeSetting();
+
+    if( canvasType != EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE )
+    {
+        if( GetGalCanvas()->SwitchBackend( canvasType ) )
+            UseGalCanvas( true );
+    }
 }
 
 
@@ -748,6 +800,81 @@ void SCH_EDIT_FRAME::OnModify()
     GetScreen()->SetSave();
 
     m_foundItems.SetForceSearch();
+
+    // The GAL canvas caches the items of the sheet
+    if( IsGalCanvasActive() )
+        RedrawCanvas( true );
+}
+
+
+void SCH_EDIT_FRAME::SwitchCanvas( wxCommandEvent& aEvent )
+{
+    bool use_gal = false;
+    EDA_DRAW_PANEL_GAL::GAL_TYPE canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE;
+
+    switch( aEvent.GetId() )
+    {
+    case ID_MENU_SCH_CANVAS_LEGACY:
+        break;
+
+    case ID_MENU_SCH_CANVAS_CAIRO:
+        use_gal = GetGalCanvas()->SwitchBackend( EDA_DRAW_PANEL_GAL::GAL_TYPE_CAIRO );
+
+        if( use_gal )
+            canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_CAIRO;
+        break;
+
+    case ID_MENU_SCH_CANVAS_OPENGL:
+        use_gal = GetGalCanvas()->SwitchBackend( EDA_DRAW_PANEL_GAL::GAL_TYPE_OPENGL );
+
+        if( use_gal )
+            canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_OPENGL;
+        break;
+    }
+
+    saveCanvasTypeSetting( canvasType );
+    UseGalCanvas( use_gal );
+}
+
+
+void SCH_EDIT_FRAME::UseGalCanvas( bool aEnable )
+{
+    EDA_DRAW_FRAME::UseGalCanvas( aEnable );
+
+    SCH_DRAW_PANEL_GAL* galCanvas = static_cast<SCH_DRAW_PANEL_GAL*>( GetGalCanvas() );
+
+    if( aEnable )
+    {
+        // The items are not kept in the view while the legacy canvas is used
+        galCanvas->DisplaySheet( GetScreen() );
+        galCanvas->StartDrawing();
+    }
+    else
+    {
+        galCanvas->GetView()->Clear();
+
+        // Redirect all events to the legacy canvas
+        galCanvas->SetEventDispatcher( NULL );
+    }
+}
+
+
+void SCH_EDIT_FRAME::RedrawCanvas( bool aSheetChanged )
+{
+    if( !IsGalCanvasActive() )
+    {
+        m_canvas->Refresh();
+        return;
+    }
+
+    SCH_DRAW_PANEL_GAL* galCanvas = static_cast<SCH_DRAW_PANEL_GAL*>( GetGalCanvas() );
+
+    if( aSheetChanged )
+        galCanvas->DisplaySheet( GetScreen() );
+    else
+        galCanvas->SyncSettings();
+
+    galCanvas->Refresh();
 }
 
 
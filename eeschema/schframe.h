@@ -392,6 +392,25 @@ public:
      */
     void OnModify();
 
+    /**
+     * Function SwitchCanvas
+     * switches the canvas between the legacy canvas and the GAL backends, from the
+     * ID_MENU_SCH_CANVAS_xxx menu events.
+     */
+    void SwitchCanvas( wxCommandEvent& aEvent );
+
+    ///> @copydoc EDA_DRAW_FRAME::UseGalCanvas()
+    virtual void UseGalCanvas( bool aEnable );
+
+    /**
+     * Function RedrawCanvas
+     * redraws the active canvas.  The GAL canvas caches the items: it reloads the
+     * display settings, and the items of the current sheet when they are changed.
+     * @param aSheetChanged = true when items of the current sheet were added, removed
+     * or changed, or when the current sheet is another one
+     */
+    void RedrawCanvas( bool aSheetChanged = false );
+
     virtual wxString GetScreenDesc() const;
 
     void InstallConfigFrame( wxCommandEvent& event );
@@ -689,6 +708,19 @@ public:
 
     bool OpenProjectFiles( const std::vector<wxString>& aFileSet, int aCtl = 0 );  // virtual from KIWAY_PLAYER
 
+    /**
+     * Function RunBatchJob
+     * runs the command line job of "eeschema --batch", without GUI:
+     * <p>
+     * eeschema --batch [--erc report.json] [--netlist file [--format name]] schematic.sch
+     * <p>
+     * loads the schematic hierarchy, then runs the ERC and writes its JSON report, and
+     * writes the netlist, in the kicad, orcadpcb2, cadstar or spice format, kicad by
+     * default.  The time of each phase is written to the standard output.
+     * @return 0 on success, 1 if the job failed, 2 if the ERC found errors.
+     */
+    int RunBatchJob( const std::vector<wxString>& aArgs );      // virtual from KIWAY_PLAYER
+
     /**
      * Function AppendOneEEProject
      * read an entire project and loads it into the schematic editor *without*
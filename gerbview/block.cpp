@@ -208,14 +208,20 @@ void GERBVIEW_FRAME::Block_Move( wxDC* DC )
     /* Calculate displacement vectors. */
     delta = GetScreen()->m_BlockLocate.GetMoveVector();
 
-    /* Move items in block */
-    for( GERBER_DRAW_ITEM* item = GetItemsList(); item; item = item->Next() )
+    /* Move items in block: only the items found in the index of the layout can be inside */
+    std::vector<GERBER_DRAW_ITEM*> candidates;
+
+    GetGerberLayout()->QueryItems( GetScreen()->m_BlockLocate, -1, candidates );
+
+    for( unsigned ii = 0; ii < candidates.size(); ii++ )
     {
-        GERBER_DRAW_ITEM* gerb_item = (GERBER_DRAW_ITEM*) item;
+        GERBER_DRAW_ITEM* gerb_item = candidates[ii];
 
         if( gerb_item->HitTest( GetScreen()->m_BlockLocate ) )
             gerb_item->MoveAB( delta );
     }
 
-    m_canvas->Refresh( true );
+    GetGerberLayout()->InvalidateItemIndex();
+
+    RedrawCanvas( true );
 }
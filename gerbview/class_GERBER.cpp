@@ -85,6 +85,7 @@ void GERBER_LAYER::ResetDefaultValues()
     m_XRepeatCount        = 1;                      // The repeat count on X axis
     m_YRepeatCount        = 1;                      // The repeat count on Y axis
     m_StepForRepeatMetric = false;                  // false = Inches, true = metric
+    m_RepeatOffsets.reset();
 }
 
 
@@ -278,7 +279,7 @@ void GERBER_IMAGE::InitToolTable()
  */
 void GERBER_IMAGE::ReportMessage( const wxString aMessage )
 {
-    m_Parent->ReportMessage( aMessage );
+    m_messages.Add( aMessage );
 }
 
 
@@ -289,7 +290,7 @@ void GERBER_IMAGE::ReportMessage( const wxString aMessage )
  */
 void GERBER_IMAGE::ClearMessageList()
 {
-    m_Parent->ClearMessageList();
+    m_messages.Clear();
 }
 
 
@@ -299,33 +300,40 @@ void GERBER_IMAGE::ClearMessageList()
  * This function must be called when reading a gerber file and
  * after creating a new gerber item that must be repeated
  * (i.e when m_XRepeatCount or m_YRepeatCount are > 1)
+ * The item is not copied: it is given the grid of offsets of the block, shared by all
+ * the items of the block, and is drawn at each offset.
  * @param aItem = the item to repeat
  */
-void GERBER_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
+void GERBER_IMAGE::StepAndRepeatItem( GERBER_DRAW_ITEM& aItem )
 {
-    if( GetLayerParams().m_XRepeatCount < 2 &&
-        GetLayerParams().m_YRepeatCount < 2 )
+    GERBER_LAYER& layer = GetLayerParams();
+
+    if( layer.m_XRepeatCount < 2 && layer.m_YRepeatCount < 2 )
         return; // Nothing to repeat
-    // Duplicate item:
-    wxString msg;
-    for( int ii = 0; ii < GetLayerParams().m_XRepeatCount; ii++ )
+
+    // The grid is built at the first item of the block
+    if( !layer.m_RepeatOffsets )
     {
-        for( int jj = 0; jj < GetLayerParams().m_YRepeatCount; jj++ )
+        GBR_REPEAT_OFFSETS* offsets = new GBR_REPEAT_OFFSETS;
+
+        // the first offset (0,0) is the item itself
+        for( int ii = 0; ii < layer.m_XRepeatCount; ii++ )
         {
-            // the first gerber item already exists (this is the template)
-            // create duplicate only if ii or jj > 0
-            if( jj == 0 && ii == 0 )
-                continue;
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
-            wxPoint           move_vector;
-            move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
-                                   GetLayerParams().m_StepForRepeatMetric );
-            move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
-                                   GetLayerParams().m_StepForRepeatMetric );
-            dupItem->MoveXY( move_vector );
-            m_Parent->GetGerberLayout()->m_Drawings.Append( dupItem );
+            for( int jj = 0; jj < layer.m_YRepeatCount; jj++ )
+            {
+                wxPoint move_vector;
+                move_vector.x = scaletoIU( ii * layer.m_StepForRepeat.x,
+                                           layer.m_StepForRepeatMetric );
+                move_vector.y = scaletoIU( jj * layer.m_StepForRepeat.y,
+                                           layer.m_StepForRepeatMetric );
+                offsets->push_back( move_vector );
+            }
         }
+
+        layer.m_RepeatOffsets.reset( offsets );
     }
+
+    aItem.SetRepeatOffsets( layer.m_RepeatOffsets );
 }
 
 
@@ -425,6 +433,10 @@ int GERBER_IMAGE_LIST::AddGbrImage( GERBER_IMAGE* aGbrImage, int aIdx )
     if( idx >= (int)m_GERBER_List.size() )
         return -1;  // No room
 
+    // A replaced image is not in use: its items are already deleted
+    if( m_GERBER_List[idx] != aGbrImage )
+        delete m_GERBER_List[idx];
+
     m_GERBER_List[idx] = aGbrImage;
 
     return idx;
@@ -28,6 +28,7 @@
 #include <vector>
 #include <set>
 
+#include <dlist.h>
 #include <dcode.h>
 #include <class_gerber_draw_item.h>
 #include <class_aperture_macro.h>
@@ -38,6 +39,7 @@
 
 class GERBVIEW_FRAME;
 class D_CODE;
+class LINE_READER;
 
 /* gerber files have different parameters to define units and how items must be plotted.
  *  some are for the entire file, and other can change along a file.
@@ -79,6 +81,8 @@ public:
                                         // gerber items can have coordinates
                                         // in different units than step parameters
                                         // and the actual coordinates calculation must handle this
+    GBR_REPEAT_OFFSETS_PTR m_RepeatOffsets; // The grid of the current step and repeat block,
+                                        // shared by its items, built by StepAndRepeatItem()
 
 public:
     GERBER_LAYER();
@@ -100,6 +104,8 @@ class GERBER_IMAGE
 
     GERBER_LAYER       m_GBRLayerParams; // hold params for the current gerber layer
 
+    wxArrayString      m_messages;       ///< the errors found when reading the file
+
 public:
     bool               m_InUse;                                 // true if this image is currently in use
                                                                 // (a file is loaded in it)
@@ -140,9 +146,9 @@ public:
     wxPoint            m_PreviousPos;                           // old current specified coord for plot
     wxPoint            m_IJPos;                                 // IJ coord (for arcs & circles )
 
-    FILE*              m_Current_File;                          // Current file to read
+    LINE_READER*       m_Current_File;                          // Current file to read
     #define            INCLUDE_FILES_CNT_MAX 10
-    FILE*              m_FilesList[INCLUDE_FILES_CNT_MAX + 2];  // Included files list
+    LINE_READER*       m_FilesList[INCLUDE_FILES_CNT_MAX + 2];  // Included files list
     int                m_FilesPtr;                              // Stack pointer for files list
 
     int                m_Selected_Tool;                         // For hightlight: current selected Dcode
@@ -154,6 +160,9 @@ public:
 
     APERTURE_MACRO_SET m_aperture_macros;                       ///< a collection of APERTURE_MACROS, sorted by name
 
+    /// The items read from the file, until the frame moves them to the layout
+    DLIST<GERBER_DRAW_ITEM> m_Drawings;
+
 private:
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -163,6 +172,24 @@ private:
                                                                 // 0 = no negative items found
                                                                 // 1 = have negative items found
 
+    /**
+     * Function readCoordinate
+     * reads the value of a coordinate after its X, Y, I or J letter and converts it to
+     * internal units.  The integer values are parsed from the format of the %FS command
+     * (m_FmtScale, m_FmtLen and m_NoTrailingZeros), without copying their digits.
+     * @param aText is the text to read, advanced after the value.
+     * @param aIsY is true for the Y and J coordinates, which have their own format.
+     * @param aIsFloat is true to read a decimal value, and is set if the value has a
+     *  decimal point.
+     */
+    int readCoordinate( char*& aText, bool aIsY, bool& aIsFloat );
+
+    /**
+     * Function closeFiles
+     * closes the file being read and its including files.
+     */
+    void closeFiles();
+
 public:
     GERBER_IMAGE( GERBVIEW_FRAME* aParent, int layer );
     virtual ~GERBER_IMAGE();
@@ -170,6 +197,16 @@ public:
     int  UsedDcodeNumber();
     virtual void ResetDefaultValues();
 
+    /**
+     * Function LoadFile
+     * reads a file in this image, its items in m_Drawings.  It does not use the frame: the
+     * images can read their files at once, see GERBVIEW_FRAME::LoadGerberFiles().  The
+     * caller sets the C locale, with a LOCALE_IO.
+     * @param aFullFileName is the file to read.
+     * @return true if the file was read, and m_InUse is set.
+     */
+    virtual bool LoadFile( const wxString& aFullFileName );
+
     /**
      * Function GetParent
      * @return the GERBVIEW_FRAME parent of this GERBER_IMAGE
@@ -217,6 +254,16 @@ public:
      */
     void    ClearMessageList();
 
+    /**
+     * Function GetMessages
+     * @return the messages reported when reading the file, displayed by the frame once
+     * the file is read
+     */
+    const wxArrayString& GetMessages() const
+    {
+        return m_messages;
+    }
+
     /**
      * Function InitToolTable
      */
@@ -246,30 +293,28 @@ public:
 
     /**
      * Function ReadRS274XCommand
-     * reads a single RS274X command terminated with a %
+     * reads a single RS274X command terminated with a %, reading the next lines of
+     * m_Current_File while the command spans several lines.
      */
-    bool ReadRS274XCommand( char aBuff[GERBER_BUFZ], char* & text );
+    bool ReadRS274XCommand( char* & text );
 
     /**
      * Function ExecuteRS274XCommand
      * executes 1 command
      */
-    bool ExecuteRS274XCommand( int command, char aBuff[GERBER_BUFZ],
-                               char* & text );
+    bool ExecuteRS274XCommand( int command, char* & text );
 
 
     /**
      * Function ReadApertureMacro
      * reads in an aperture macro and saves it in m_aperture_macros.
-     * @param aBuff a character buffer at least GERBER_BUFZ long that can be
-     *          used to read successive lines from the gerber file.
      * @param text A reference to a character pointer which gives the initial
      *              text to read from.
-     * @param gerber_file Which file to read from for continuation.
+     * @param aReader Which file to read from for continuation.  Its line buffer holds
+     *              the text.
      * @return bool - true if a macro was read in successfully, else false.
      */
-    bool ReadApertureMacro( char aBuff[GERBER_BUFZ], char* & text,
-                            FILE * gerber_file );
+    bool ReadApertureMacro( char* & text, LINE_READER* aReader );
 
 
     /**
@@ -299,9 +344,11 @@ public:
      * This function must be called when reading a gerber file and
      * after creating a new gerber item that must be repeated
      * (i.e when m_XRepeatCount or m_YRepeatCount are > 1)
+     * The item is not copied: it is given the grid of offsets of the block, shared by all
+     * the items of the block, and is drawn at each offset.
      * @param aItem = the item to repeat
      */
-    void            StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem );
+    void            StepAndRepeatItem( GERBER_DRAW_ITEM& aItem );
 
     /**
      * Function DisplayImageInfo
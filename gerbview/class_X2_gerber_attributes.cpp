@@ -42,6 +42,7 @@
  */
 
 #include <wx/log.h>
+#include <richio.h>
 #include <class_X2_gerber_attributes.h>
 
 /*
@@ -91,11 +92,10 @@ void X2_ATTRIBUTE::DbgListPrms()
 
 /*
  * parse a TF command and fill m_Prms by the parameters found.
- * aFile = a FILE* ptr to the current Gerber file.
- * buff = the buffer containing current Gerber data (GERBER_BUFZ size)
+ * aReader = the reader of the current Gerber file, can be NULL
  * text = a pointer to the first char to read in Gerber data
  */
-bool X2_ATTRIBUTE::ParseAttribCmd( FILE* aFile, char *aBuffer, int aBuffSize, char* &aText )
+bool X2_ATTRIBUTE::ParseAttribCmd( LINE_READER* aReader, char* &aText )
 {
     bool ok = true;
     wxString data;
@@ -135,16 +135,16 @@ bool X2_ATTRIBUTE::ParseAttribCmd( FILE* aFile, char *aBuffer, int aBuffSize, ch
         }
 
         // end of current line, read another one.
-        if( aBuffer )
+        if( aReader )
         {
-            if( fgets( aBuffer, aBuffSize, aFile ) == NULL )
+            if( aReader->ReadLine() == NULL )
             {
                 // end of file
                 ok = false;
                 break;
             }
 
-            aText = aBuffer;
+            aText = aReader->Line();
         }
         else
             return ok;
@@ -125,133 +125,92 @@ int AM_PRIMITIVE::GetExposure(GERBER_DRAW_ITEM* aParent) const
 }
 
 /**
- * Function DrawBasicShape
- * Draw the primitive shape for flashed items.
+ * Function addPolygon
+ * rotates the corners of a primitive polygon by aRotation, moves them by aOffset, the
+ * position of the primitive in the macro, and appends the polygon to aShapes.
  */
-void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
-                                   EDA_RECT* aClipBox,
-                                   wxDC* aDC,
-                                   EDA_COLOR_T aColor, EDA_COLOR_T aAltColor,
-                                   wxPoint aShapePos,
-                                   bool aFilledShape )
+static void addPolygon( AM_SHAPES& aShapes, std::vector<wxPoint>& aPolygon, double aRotation,
+                        const wxPoint& aOffset, bool aAltColor = false )
 {
-    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
-    polybuffer.clear();
+    if( aPolygon.empty() )
+        return;
 
-    wxPoint curPos = aShapePos;
-    D_CODE* tool   = aParent->GetDcodeDescr();
-    double rotation;
-    if( mapExposure( aParent ) == false )
+    for( unsigned ii = 0; ii < aPolygon.size(); ii++ )
     {
-        std::swap( aColor, aAltColor );
+        if( aRotation != 0 )
+            RotatePoint( &aPolygon[ii], -aRotation );
+
+        aPolygon[ii] += aOffset;
     }
 
+    aShapes.push_back( AM_SHAPE() );
+
+    AM_SHAPE& shape = aShapes.back();
+
+    shape.m_AltColor = aAltColor;
+    shape.m_Corners.swap( aPolygon );
+}
+
+
+/**
+ * Function addCircle
+ * appends a circle to aShapes, a disc if aPenWidth is 0, else a ring of width aPenWidth.
+ */
+static void addCircle( AM_SHAPES& aShapes, const wxPoint& aCenter, int aRadius, int aPenWidth = 0 )
+{
+    aShapes.push_back( AM_SHAPE() );
+
+    AM_SHAPE& shape = aShapes.back();
+
+    shape.m_Center   = aCenter;
+    shape.m_Radius   = aRadius;
+    shape.m_PenWidth = aPenWidth;
+}
+
+
+void AM_PRIMITIVE::ConvertBasicShape( D_CODE* aTool, AM_SHAPES& aShapes )
+{
+    std::vector<wxPoint> polybuffer;
+
     switch( primitive_id )
     {
     case AMP_CIRCLE:        // Circle, given diameter and position
-    {
         /* Generated by an aperture macro declaration like:
          * "1,1,0.3,0.5, 1.0*"
          * type (1), exposure, diameter, pos.x, pos.y
          * type is not stored in parameters list, so the first parameter is exposure
          */
-        curPos += mapPt( params[2].GetValue( tool ), params[3].GetValue( tool ), m_GerbMetric );
-        curPos = aParent->GetABPosition( curPos );
-        int radius = scaletoIU( params[1].GetValue( tool ), m_GerbMetric ) / 2;
-        if( !aFilledShape )
-            GRCircle( aClipBox, aDC, curPos, radius, 0, aColor );
-        else
-            GRFilledCircle( aClipBox, aDC, curPos, radius, aColor );
-    }
-    break;
+        addCircle( aShapes, mapPt( params[2].GetValue( aTool ), params[3].GetValue( aTool ),
+                                   m_GerbMetric ),
+                   scaletoIU( params[1].GetValue( aTool ), m_GerbMetric ) / 2 );
+        break;
 
     case AMP_LINE2:
     case AMP_LINE20:        // Line with rectangle ends. (Width, start and end pos + rotation)
-    {
         /* Generated by an aperture macro declaration like:
          * "2,1,0.3,0,0, 0.5, 1.0,-135*"
          * type (2), exposure, width, start.x, start.y, end.x, end.y, rotation
          * type is not stored in parameters list, so the first parameter is exposure
          */
-        ConvertShapeToPolygon( aParent, polybuffer );
-
-        // shape rotation:
-        rotation = params[6].GetValue( tool ) * 10.0;
-        if( rotation != 0)
-        {
-            for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-                RotatePoint( &polybuffer[ii], -rotation );
-        }
-
-        // Move to current position:
-        for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-        {
-            polybuffer[ii] += curPos;
-            polybuffer[ii] = aParent->GetABPosition( polybuffer[ii] );
-        }
-
-        GRClosedPoly( aClipBox, aDC,
-                      polybuffer.size(), &polybuffer[0], aFilledShape, aColor, aColor );
-    }
-    break;
+        ConvertShapeToPolygon( aTool, polybuffer );
+        addPolygon( aShapes, polybuffer, params[6].GetValue( aTool ) * 10.0, wxPoint( 0, 0 ) );
+        break;
 
     case AMP_LINE_CENTER:
-    {
         /* Generated by an aperture macro declaration like:
          * "21,1,0.3,0.03,0,0,-135*"
          * type (21), exposure, ,width, height, center pos.x, center pos.y, rotation
          * type is not stored in parameters list, so the first parameter is exposure
          */
-        ConvertShapeToPolygon( aParent, polybuffer );
-
-        // shape rotation:
-        rotation = params[5].GetValue( tool ) * 10.0;
-        if( rotation != 0 )
-        {
-            for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-                RotatePoint( &polybuffer[ii], -rotation );
-        }
-
-        // Move to current position:
-        for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-        {
-            polybuffer[ii] += curPos;
-            polybuffer[ii] = aParent->GetABPosition( polybuffer[ii] );
-        }
-
-        GRClosedPoly( aClipBox, aDC,
-                      polybuffer.size(), &polybuffer[0], aFilledShape, aColor, aColor );
-    }
-    break;
-
     case AMP_LINE_LOWER_LEFT:
-    {
         /* Generated by an aperture macro declaration like:
          * "22,1,0.3,0.03,0,0,-135*"
          * type (22), exposure, ,width, height, corner pos.x, corner pos.y, rotation
          * type is not stored in parameters list, so the first parameter is exposure
          */
-        ConvertShapeToPolygon( aParent, polybuffer );
-
-        // shape rotation:
-        rotation = params[5].GetValue( tool ) * 10.0;
-        if( rotation != 0)
-        {
-            for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-                RotatePoint( &polybuffer[ii], -rotation );
-        }
-
-        // Move to current position:
-        for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-        {
-            polybuffer[ii] += curPos;
-            polybuffer[ii] = aParent->GetABPosition( polybuffer[ii] );
-        }
-
-        GRClosedPoly( aClipBox, aDC,
-                      polybuffer.size(), &polybuffer[0], aFilledShape, aColor, aColor );
-    }
-    break;
+        ConvertShapeToPolygon( aTool, polybuffer );
+        addPolygon( aShapes, polybuffer, params[5].GetValue( aTool ) * 10.0, wxPoint( 0, 0 ) );
+        break;
 
     case AMP_THERMAL:
     {
@@ -260,89 +219,55 @@ void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
          * type (7), center.x , center.y, outside diam, inside diam, crosshair thickness, rotation
          * type is not stored in parameters list, so the first parameter is center.x
          */
-        curPos += mapPt( params[0].GetValue( tool ), params[1].GetValue( tool ), m_GerbMetric );
-        ConvertShapeToPolygon( aParent, polybuffer );
+        wxPoint center = mapPt( params[0].GetValue( aTool ), params[1].GetValue( aTool ),
+                                m_GerbMetric );
+        double  rotation = params[5].GetValue( aTool ) * 10.0;
 
-        // shape rotation:
-        rotation = params[5].GetValue( tool ) * 10.0;
+        ConvertShapeToPolygon( aTool, polybuffer );
 
         // Because a thermal shape has 4 identical sub-shapes, only one is created in polybuffer.
-        // We must draw 4 sub-shapes rotated by 90 deg
+        // The 4 sub-shapes are rotated by 90 deg, and drawn with the alt color
         std::vector<wxPoint> subshape_poly;
+
         for( int ii = 0; ii < 4; ii++ )
         {
             subshape_poly = polybuffer;
-            double sub_rotation = rotation + 900 * ii;
-            for( unsigned jj = 0; jj < subshape_poly.size(); jj++ )
-                RotatePoint( &subshape_poly[jj], -sub_rotation );
-
-            // Move to current position:
-            for( unsigned jj = 0; jj < subshape_poly.size(); jj++ )
-            {
-                subshape_poly[jj] += curPos;
-                subshape_poly[jj] = aParent->GetABPosition( subshape_poly[jj] );
-            }
-
-            GRClosedPoly( aClipBox, aDC,
-                          subshape_poly.size(), &subshape_poly[0], true, aAltColor,
-                          aAltColor );
+            addPolygon( aShapes, subshape_poly, rotation + 900 * ii, center, true );
         }
     }
-    break;
+        break;
 
     case AMP_MOIRE:     // A cross hair with n concentric circles
     {
-        curPos += mapPt( params[0].GetValue( tool ), params[1].GetValue( tool ),
-                         m_GerbMetric );
-
         /* Generated by an aperture macro declaration like:
          * "6,0,0,0.125,.01,0.01,3,0.003,0.150,0"
          * type(6), pos.x, pos.y, diam, penwidth, gap, circlecount, crosshair thickness, crosshaire len, rotation
          * type is not stored in parameters list, so the first parameter is pos.x
          */
-        int outerDiam    = scaletoIU( params[2].GetValue( tool ), m_GerbMetric );
-        int penThickness = scaletoIU( params[3].GetValue( tool ), m_GerbMetric );
-        int gap = scaletoIU( params[4].GetValue( tool ), m_GerbMetric );
-        int numCircles = KiROUND( params[5].GetValue( tool ) );
+        wxPoint center = mapPt( params[0].GetValue( aTool ), params[1].GetValue( aTool ),
+                                m_GerbMetric );
+
+        int outerDiam    = scaletoIU( params[2].GetValue( aTool ), m_GerbMetric );
+        int penThickness = scaletoIU( params[3].GetValue( aTool ), m_GerbMetric );
+        int gap = scaletoIU( params[4].GetValue( aTool ), m_GerbMetric );
+        int numCircles = KiROUND( params[5].GetValue( aTool ) );
 
-        // Draw circles:
-        wxPoint center = aParent->GetABPosition( curPos );
         // adjust outerDiam by this on each nested circle
         int diamAdjust = (gap + penThickness); //*2;     //Should we use * 2 ?
+
         for( int i = 0; i < numCircles; ++i, outerDiam -= diamAdjust )
         {
             if( outerDiam <= 0 )
                 break;
-            if( !aFilledShape )
-            {
-                // draw the border of the pen's path using two circles, each as narrow as possible
-                GRCircle( aClipBox, aDC, center, outerDiam / 2, 0, aColor );
-                GRCircle( aClipBox, aDC, center, outerDiam / 2 - penThickness, 0, aColor );
-            }
-            else    // Filled mode
-            {
-                GRCircle( aClipBox, aDC, center,
-                          (outerDiam - penThickness) / 2, penThickness, aColor );
-            }
-        }
-
-        // Draw the cross:
-        ConvertShapeToPolygon( aParent, polybuffer );
 
-        rotation = params[8].GetValue( tool ) * 10.0;
-        for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-        {
-            // shape rotation:
-            RotatePoint( &polybuffer[ii], -rotation );
-            // Move to current position:
-            polybuffer[ii] += curPos;
-            polybuffer[ii] = aParent->GetABPosition( polybuffer[ii] );
+            addCircle( aShapes, center, outerDiam / 2, penThickness );
         }
 
-        GRClosedPoly( aClipBox, aDC,
-                      polybuffer.size(), &polybuffer[0], aFilledShape, aColor, aColor );
+        // The cross:
+        ConvertShapeToPolygon( aTool, polybuffer );
+        addPolygon( aShapes, polybuffer, params[8].GetValue( aTool ) * 10.0, center );
     }
-    break;
+        break;
 
     case AMP_OUTLINE:
     {
@@ -351,35 +276,20 @@ void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
          * type(4), exposure, corners count, corner1.x, corner.1y, ..., rotation
          * type is not stored in parameters list, so the first parameter is exposure
          */
-        int numPoints = (int) params[1].GetValue( tool );
-        rotation  = params[numPoints * 2 + 4].GetValue( tool ) * 10.0;
-        wxPoint pos;
+        int numPoints = (int) params[1].GetValue( aTool );
+        double rotation = params[numPoints * 2 + 4].GetValue( aTool ) * 10.0;
+
         // Read points. numPoints does not include the starting point, so add 1.
-        for( int i = 0; i<numPoints + 1; ++i )
+        for( int i = 0; i < numPoints + 1; ++i )
         {
             int jj = i * 2 + 2;
-            pos.x = scaletoIU( params[jj].GetValue( tool ), m_GerbMetric );
-            pos.y = scaletoIU( params[jj + 1].GetValue( tool ), m_GerbMetric );
-            polybuffer.push_back(pos);
-        }
-        // rotate polygon and move it to the actual position
-        // shape rotation:
-        for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-        {
-            RotatePoint( &polybuffer[ii], -rotation );
-       }
-
-        // Move to current position:
-        for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-        {
-            polybuffer[ii] += curPos;
-            polybuffer[ii] = aParent->GetABPosition( polybuffer[ii] );
+            polybuffer.push_back( mapPt( params[jj].GetValue( aTool ),
+                                         params[jj + 1].GetValue( aTool ), m_GerbMetric ) );
         }
 
-        GRClosedPoly( aClipBox, aDC,
-                      polybuffer.size(), &polybuffer[0], aFilledShape, aColor, aColor );
+        addPolygon( aShapes, polybuffer, rotation, wxPoint( 0, 0 ) );
     }
-    break;
+        break;
 
     case AMP_POLYGON:   // Is a regular polygon
         /* Generated by an aperture macro declaration like:
@@ -387,29 +297,22 @@ void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
          * type(5), exposure, vertices count, pox.x, pos.y, diameter, rotation
          * type is not stored in parameters list, so the first parameter is exposure
          */
-        curPos += mapPt( params[2].GetValue( tool ), params[3].GetValue( tool ), m_GerbMetric );
-        // Creates the shape:
-        ConvertShapeToPolygon( aParent, polybuffer );
-
-        // rotate polygon and move it to the actual position
-        rotation  = params[5].GetValue( tool ) * 10.0;
-        for( unsigned ii = 0; ii < polybuffer.size(); ii++ )
-        {
-            RotatePoint( &polybuffer[ii], -rotation );
-            polybuffer[ii] += curPos;
-            polybuffer[ii] = aParent->GetABPosition( polybuffer[ii] );
-        }
-        GRClosedPoly( aClipBox, aDC,
-                      polybuffer.size(), &polybuffer[0], aFilledShape, aColor, aColor );
+        ConvertShapeToPolygon( aTool, polybuffer );
+        addPolygon( aShapes, polybuffer, params[5].GetValue( aTool ) * 10.0,
+                    mapPt( params[2].GetValue( aTool ), params[3].GetValue( aTool ),
+                           m_GerbMetric ) );
         break;
 
     case AMP_EOF:
         // not yet supported, waiting for you.
         break;
 
+    case AMP_COMMENT:
+        break;
+
     case AMP_UNKNOWN:
     default:
-        DBG( printf( "AM_PRIMITIVE::DrawBasicShape() err: unknown prim id %d\n",primitive_id) );
+        DBG( printf( "AM_PRIMITIVE::ConvertBasicShape() err: unknown prim id %d\n",primitive_id) );
         break;
     }
 }
@@ -425,11 +328,8 @@ void AM_PRIMITIVE::DrawBasicShape( GERBER_DRAW_ITEM* aParent,
  * because circles are very easy to draw (no rotation problem) so convert them in polygons,
  * and draw them as polygons is not a good idea.
  */
-void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
-                                          std::vector<wxPoint>& aBuffer )
+void AM_PRIMITIVE::ConvertShapeToPolygon( D_CODE* aTool, std::vector<wxPoint>& aBuffer )
 {
-    D_CODE* tool = aParent->GetDcodeDescr();
-
     switch( primitive_id )
     {
     case AMP_CIRCLE:        // Circle, currently convertion not needed
@@ -438,11 +338,11 @@ void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
     case AMP_LINE2:
     case AMP_LINE20:        // Line with rectangle ends. (Width, start and end pos + rotation)
     {
-        int     width = scaletoIU( params[1].GetValue( tool ), m_GerbMetric );
-        wxPoint start = mapPt( params[2].GetValue( tool ),
-                               params[3].GetValue( tool ), m_GerbMetric );
-        wxPoint end = mapPt( params[4].GetValue( tool ),
-                             params[5].GetValue( tool ), m_GerbMetric );
+        int     width = scaletoIU( params[1].GetValue( aTool ), m_GerbMetric );
+        wxPoint start = mapPt( params[2].GetValue( aTool ),
+                               params[3].GetValue( aTool ), m_GerbMetric );
+        wxPoint end = mapPt( params[4].GetValue( aTool ),
+                             params[5].GetValue( aTool ), m_GerbMetric );
         wxPoint delta = end - start;
         int     len   = KiROUND( EuclideanNorm( delta ) );
 
@@ -471,8 +371,8 @@ void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
 
     case AMP_LINE_CENTER:
     {
-        wxPoint size = mapPt( params[1].GetValue( tool ), params[2].GetValue( tool ), m_GerbMetric );
-        wxPoint pos  = mapPt( params[3].GetValue( tool ), params[4].GetValue( tool ), m_GerbMetric );
+        wxPoint size = mapPt( params[1].GetValue( aTool ), params[2].GetValue( aTool ), m_GerbMetric );
+        wxPoint pos  = mapPt( params[3].GetValue( aTool ), params[4].GetValue( aTool ), m_GerbMetric );
 
         // Build poly:
         pos.x -= size.x / 2;
@@ -489,9 +389,9 @@ void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
 
     case AMP_LINE_LOWER_LEFT:
     {
-        wxPoint size = mapPt( params[1].GetValue( tool ), params[2].GetValue( tool ), m_GerbMetric );
-        wxPoint lowerLeft = mapPt( params[3].GetValue( tool ), params[4].GetValue(
-                                       tool ), m_GerbMetric );
+        wxPoint size = mapPt( params[1].GetValue( aTool ), params[2].GetValue( aTool ), m_GerbMetric );
+        wxPoint lowerLeft = mapPt( params[3].GetValue( aTool ), params[4].GetValue(
+                                       aTool ), m_GerbMetric );
 
         // Build poly:
         aBuffer.push_back( lowerLeft );
@@ -509,9 +409,9 @@ void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
         // Only 1/4 of the full shape is built, because the other 3 shapes will be draw from this first
         // rotated by 90, 180 and 270 deg.
         // params = center.x (unused here), center.y (unused here), outside diam, inside diam, crosshair thickness
-        int outerRadius   = scaletoIU( params[2].GetValue( tool ), m_GerbMetric ) / 2;
-        int innerRadius   = scaletoIU( params[3].GetValue( tool ), m_GerbMetric ) / 2;
-        int halfthickness = scaletoIU( params[4].GetValue( tool ), m_GerbMetric ) / 2;
+        int outerRadius   = scaletoIU( params[2].GetValue( aTool ), m_GerbMetric ) / 2;
+        int innerRadius   = scaletoIU( params[3].GetValue( aTool ), m_GerbMetric ) / 2;
+        int halfthickness = scaletoIU( params[4].GetValue( aTool ), m_GerbMetric ) / 2;
         double angle_start = RAD2DECIDEG( asin( (double) halfthickness / innerRadius ) );
 
         // Draw shape in the first cadrant (X and Y > 0)
@@ -558,8 +458,8 @@ void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
     case AMP_MOIRE:     // A cross hair with n concentric circles. Only the cros is build as polygon
                         // because circles can be drawn easily
     {
-        int crossHairThickness = scaletoIU( params[6].GetValue( tool ), m_GerbMetric );
-        int crossHairLength    = scaletoIU( params[7].GetValue( tool ), m_GerbMetric );
+        int crossHairThickness = scaletoIU( params[6].GetValue( aTool ), m_GerbMetric );
+        int crossHairLength    = scaletoIU( params[7].GetValue( aTool ), m_GerbMetric );
 
         // Create cross. First create 1/4 of the shape.
         // Others point are the same, totated by 90, 180 and 270 deg
@@ -591,8 +491,8 @@ void AM_PRIMITIVE::ConvertShapeToPolygon( GERBER_DRAW_ITEM*     aParent,
 
     case AMP_POLYGON:   // Creates a regular polygon
     {
-        int vertexcount = KiROUND( params[1].GetValue( tool ) );
-        int radius    = scaletoIU( params[4].GetValue( tool ), m_GerbMetric ) / 2;
+        int vertexcount = KiROUND( params[1].GetValue( aTool ) );
+        int radius    = scaletoIU( params[4].GetValue( aTool ), m_GerbMetric ) / 2;
         // rs274x said: vertex count = 3 ... 10, and the first corner is on the X axis
         if( vertexcount < 3 )
             vertexcount = 3;
@@ -728,13 +628,69 @@ void APERTURE_MACRO::DrawApertureMacroShape( GERBER_DRAW_ITEM* aParent,
                                              EDA_COLOR_T aColor, EDA_COLOR_T aAltColor,
                                              wxPoint aShapePos, bool aFilledShape )
 {
-    for( AM_PRIMITIVES::iterator prim_macro = primitives.begin();
-         prim_macro != primitives.end(); ++prim_macro )
+    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
+
+    const AM_SHAPES& shapes = aParent->GetDcodeDescr()->GetMacroShapes();
+
+    for( unsigned ii = 0; ii < shapes.size(); ii++ )
+    {
+        const AM_SHAPE& shape = shapes[ii];
+        bool exposure = primitives[shape.m_Primitive].mapExposure( aParent );
+        EDA_COLOR_T color = exposure != shape.m_AltColor ? aColor : aAltColor;
+
+        if( shape.m_Radius > 0 )
+        {
+            wxPoint center = aParent->GetABPosition( shape.m_Center + aShapePos );
+
+            if( shape.m_PenWidth == 0 )
+            {
+                if( !aFilledShape )
+                    GRCircle( aClipBox, aDC, center, shape.m_Radius, 0, color );
+                else
+                    GRFilledCircle( aClipBox, aDC, center, shape.m_Radius, color );
+            }
+            else if( !aFilledShape )
+            {
+                // draw the border of the pen's path using two circles, each as narrow as possible
+                GRCircle( aClipBox, aDC, center, shape.m_Radius, 0, color );
+                GRCircle( aClipBox, aDC, center, shape.m_Radius - shape.m_PenWidth, 0, color );
+            }
+            else    // Filled mode
+            {
+                GRCircle( aClipBox, aDC, center, shape.m_Radius - shape.m_PenWidth / 2,
+                          shape.m_PenWidth, color );
+            }
+
+            continue;
+        }
+
+        polybuffer.resize( shape.m_Corners.size() );
+
+        for( unsigned jj = 0; jj < polybuffer.size(); jj++ )
+            polybuffer[jj] = aParent->GetABPosition( shape.m_Corners[jj] + aShapePos );
+
+        // the sub-shapes of a thermal are always filled
+        bool filled = aFilledShape || shape.m_AltColor;
+
+        GRClosedPoly( aClipBox, aDC, polybuffer.size(), &polybuffer[0], filled, color, color );
+    }
+}
+
+
+/**
+ * Function ConvertToShapes
+ * evaluates the primitives with the parameters of a D_CODE.
+ */
+void APERTURE_MACRO::ConvertToShapes( D_CODE* aTool, AM_SHAPES& aShapes )
+{
+    for( unsigned ii = 0; ii < primitives.size(); ii++ )
     {
-        prim_macro->DrawBasicShape( aParent, aClipBox, aDC,
-                                    aColor, aAltColor,
-                                    aShapePos,
-                                    aFilledShape );
+        unsigned first = aShapes.size();
+
+        primitives[ii].ConvertBasicShape( aTool, aShapes );
+
+        for( unsigned jj = first; jj < aShapes.size(); jj++ )
+            aShapes[jj].m_Primitive = ii;
     }
 }
 
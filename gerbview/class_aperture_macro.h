@@ -121,21 +121,16 @@ public: AM_PRIMITIVE( bool aGerbMetric, AM_PRIMITIVE_ID aId = AMP_UNKNOWN )
      */
     bool mapExposure( GERBER_DRAW_ITEM* aParent );
 
-    /* Draw functions: */
-
     /**
-     * Function DrawBasicShape
-     * Draw the primitive shape for flashed items.
-     * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
-     * @param aClipBox = DC clip box (NULL is no clip)
-     * @param aDC = device context
-     * @param aColor = the normal color to use
-     * @param aAltColor = the color used to draw with "reverse" exposure mode (used in aperture macros only)
-     * @param aShapePos = the actual shape position
-     * @param aFilledShape = true to draw in filled mode, false to draw in skecth mode
+     * Function ConvertBasicShape
+     * evaluates the primitive with the parameters of a D_CODE, and appends its shapes to
+     * @a aShapes, relative to the flashed position.  The circles stay circles, the other
+     * shapes are converted to polygons.  The shapes do not depend on the flashed item: they
+     * are built once per D_CODE, see D_CODE::GetMacroShapes().
+     * @param aTool = the D_CODE which defines the parameters of the macro
+     * @param aShapes = the buffer to append the shapes to
      */
-    void DrawBasicShape( GERBER_DRAW_ITEM* aParent, EDA_RECT* aClipBox, wxDC* aDC,
-                         EDA_COLOR_T aColor, EDA_COLOR_T aAltColor, wxPoint aShapePos, bool aFilledShape );
+    void ConvertBasicShape( D_CODE* aTool, AM_SHAPES& aShapes );
 
     /** GetShapeDim
      * Calculate a value that can be used to evaluate the size of text
@@ -158,7 +153,7 @@ private:
      * Useful when a shape is not a graphic primitive (shape with hole,
      * rotated shape ... ) and cannot be easily drawn.
      */
-    void ConvertShapeToPolygon( GERBER_DRAW_ITEM* aParent, std::vector<wxPoint>& aBuffer );
+    void ConvertShapeToPolygon( D_CODE* aTool, std::vector<wxPoint>& aBuffer );
 };
 
 
@@ -205,10 +200,21 @@ struct APERTURE_MACRO
      * @param aAltColor = the color used to draw with "reverse" exposure mode (used in aperture macros only)
      * @param aShapePos = the actual shape position
      * @param aFilledShape = true to draw in filled mode, false to draw in skecth mode
+     * The shapes of the D_CODE of aParent, see D_CODE::GetMacroShapes(), are moved to
+     * aShapePos: the primitives are not evaluated again for each flash.
      */
     void DrawApertureMacroShape( GERBER_DRAW_ITEM* aParent, EDA_RECT* aClipBox, wxDC* aDC,
                                  EDA_COLOR_T aColor, EDA_COLOR_T aAltColor, wxPoint aShapePos, bool aFilledShape );
 
+    /**
+     * Function ConvertToShapes
+     * evaluates the primitives with the parameters of a D_CODE, and appends their shapes
+     * to @a aShapes, see AM_PRIMITIVE::ConvertBasicShape().
+     * @param aTool = the D_CODE that uses this aperture macro and defines defered parameters
+     * @param aShapes = the buffer to append the shapes to
+     */
+    void ConvertToShapes( D_CODE* aTool, AM_SHAPES& aShapes );
+
     /**
      * Function GetShapeDim
      * Calculate a value that can be used to evaluate the size of text
@@ -113,6 +113,9 @@ public: EXCELLON_IMAGE( GERBVIEW_FRAME* aParent, int layer ) :
     }
 
 
+    ///> @copydoc GERBER_IMAGE::LoadFile()
+    virtual bool LoadFile( const wxString& aFullFileName );
+
     bool Read_EXCELLON_File( FILE* aFile, const wxString& aFullFileName );
 
 private:
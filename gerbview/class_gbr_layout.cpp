@@ -34,7 +34,8 @@
 #include <common.h>
 #include <class_gbr_layout.h>
 
-GBR_LAYOUT::GBR_LAYOUT()
+GBR_LAYOUT::GBR_LAYOUT() :
+    m_itemIndexValid( false )
 {
     m_printLayersMask.set();
 }
@@ -55,3 +56,120 @@ EDA_RECT GBR_LAYOUT::ComputeBoundingBox()
     SetBoundingBox( bbox );
     return bbox;
 }
+
+
+/**
+ * Function indexedArea
+ * @return the area in A,B axis of the positions where @a aItem can be hit: its start and
+ * end points, inflated by the hit radius, for all the copies of a step and repeat block.
+ * The items bounding box is not used, it does not cover the end of the segments.
+ */
+static EDA_RECT indexedArea( const GERBER_DRAW_ITEM* aItem )
+{
+    int      radius = std::min( aItem->m_Size.x, aItem->m_Size.y ) / 2;
+    EDA_RECT xyArea( aItem->m_Start, wxSize( 0, 0 ) );
+
+    xyArea.Merge( aItem->m_End );
+    xyArea.Normalize();
+    xyArea.Inflate( radius + 1 );
+
+    const wxPoint corners[4] =
+    {
+        xyArea.GetOrigin(),
+        wxPoint( xyArea.GetRight(), xyArea.GetY() ),
+        xyArea.GetEnd(),
+        wxPoint( xyArea.GetX(), xyArea.GetBottom() )
+    };
+
+    EDA_RECT area( aItem->GetABPosition( corners[0] ), wxSize( 0, 0 ) );
+
+    for( int ii = 0; ii < aItem->GetInstanceCount(); ii++ )
+    {
+        aItem->SetInstance( ii );
+
+        // the rotation of the image is not always a multiple of 90 deg
+        for( int jj = 0; jj < 4; jj++ )
+            area.Merge( aItem->GetABPosition( corners[jj] ) );
+    }
+
+    aItem->SetInstance( 0 );
+
+    return area;
+}
+
+
+void GBR_LAYOUT::buildItemIndex()
+{
+    for( int layer = 0; layer < GERBER_DRAWLAYERS_COUNT; ++layer )
+        m_itemTrees[layer].RemoveAll();
+
+    m_indexedItems.clear();
+
+    for( GERBER_DRAW_ITEM* item = m_Drawings; item; item = item->Next() )
+    {
+        int layer = item->GetLayer();
+
+        if( layer < 0 || layer >= GERBER_DRAWLAYERS_COUNT )
+            continue;
+
+        EDA_RECT  area = indexedArea( item );
+        const int mmin[2] = { area.GetX(), area.GetY() };
+        const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+        m_itemTrees[layer].Insert( mmin, mmax, (int) m_indexedItems.size() );
+        m_indexedItems.push_back( item );
+    }
+
+    m_itemIndexValid = true;
+}
+
+
+/// Search visitor of the item trees: stores the ordinals found
+struct ITEM_COLLECTOR
+{
+    ITEM_COLLECTOR( std::vector<int>& aOrdinals ) :
+        m_ordinals( aOrdinals )
+    {
+    }
+
+    bool operator()( int aOrdinal )
+    {
+        m_ordinals.push_back( aOrdinal );
+        return true;
+    }
+
+    std::vector<int>& m_ordinals;
+};
+
+
+void GBR_LAYOUT::QueryItems( const EDA_RECT& aArea, int aLayer,
+                             std::vector<GERBER_DRAW_ITEM*>& aItems )
+{
+    if( !m_itemIndexValid )
+        buildItemIndex();
+
+    EDA_RECT  area = aArea;
+
+    area.Normalize();
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+    std::vector<int> ordinals;
+    ITEM_COLLECTOR   collector( ordinals );
+
+    for( int layer = 0; layer < GERBER_DRAWLAYERS_COUNT; ++layer )
+    {
+        if( aLayer < 0 || layer == aLayer )
+            m_itemTrees[layer].Search( mmin, mmax, collector );
+    }
+
+    // each item is in one tree only, there are no duplicates
+    std::sort( ordinals.begin(), ordinals.end() );
+
+    aItems.clear();
+    aItems.reserve( ordinals.size() );
+
+    for( unsigned ii = 0; ii < ordinals.size(); ii++ )
+        aItems.push_back( m_indexedItems[ordinals[ii]] );
+}
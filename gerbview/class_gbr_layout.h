@@ -32,6 +32,8 @@
 #define CLASS_GBR_LAYOUT_H
 
 
+#include <vector>
+
 #include <dlist.h>
 
 #include <class_colors_design_settings.h>
@@ -39,6 +41,7 @@
 #include <gerbview.h>                       // GERBER_DRAWLAYERS_COUNT
 #include <class_title_block.h>
 #include <class_gerber_draw_item.h>
+#include <geometry/rtree.h>
 
 #include <gr_basic.h>
 
@@ -53,6 +56,21 @@ private:
     TITLE_BLOCK         m_titles;
     wxPoint             m_originAxisPosition;
     std::bitset <GERBER_DRAWLAYERS_COUNT> m_printLayersMask; // When printing: the list of layers to print
+
+    typedef RTree<int, int, 2, float> ITEM_TREE;
+
+    // The spatial index of the items of m_Drawings, one tree per graphic layer.  The trees
+    // store ordinals in m_indexedItems, which is in the order of m_Drawings.
+    ITEM_TREE           m_itemTrees[GERBER_DRAWLAYERS_COUNT];
+    std::vector<GERBER_DRAW_ITEM*> m_indexedItems;
+    bool                m_itemIndexValid;
+
+    void buildItemIndex();
+
+    // RTree owns its nodes through raw pointers, so the layout cannot be copied
+    GBR_LAYOUT( const GBR_LAYOUT& );
+    GBR_LAYOUT& operator=( const GBR_LAYOUT& );
+
 public:
 
     DLIST<GERBER_DRAW_ITEM> m_Drawings;     // linked list of Gerber Items to draw
@@ -96,6 +114,24 @@ public:
 
     void SetBoundingBox( const EDA_RECT& aBox ) { m_BoundingBox = aBox; }
 
+    /**
+     * Function InvalidateItemIndex
+     * must be called when items are added to or removed from m_Drawings, moved, or
+     * moved to another layer: the spatial index is rebuilt by the next QueryItems().
+     */
+    void InvalidateItemIndex() { m_itemIndexValid = false; }
+
+    /**
+     * Function QueryItems
+     * collects the items which may be hit by a point or area of @a aArea, to be tested
+     * by GERBER_DRAW_ITEM::HitTest().  The items are searched in a spatial index of
+     * their areas, built once for all the items after they are loaded.
+     * @param aArea is the search area, in A,B axis (a point is a 1x1 area)
+     * @param aLayer is the graphic layer to search, or -1 for all layers
+     * @param aItems is filled with the items found, in the order of m_Drawings
+     */
+    void QueryItems( const EDA_RECT& aArea, int aLayer, std::vector<GERBER_DRAW_ITEM*>& aItems );
+
     /**
      * Function Draw.
      * Redraw the CLASS_GBR_LAYOUT items but not cursors, axis or grid.
@@ -87,6 +87,7 @@ GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( const GERBER_DRAW_ITEM& aSource ) :
     m_layerOffset   = aSource.m_layerOffset;
     m_drawScale     = aSource.m_drawScale;
     m_lyrRotation   = aSource.m_lyrRotation;
+    m_repeatOffsets = aSource.m_repeatOffsets;
 }
 
 
@@ -107,7 +108,7 @@ wxPoint GERBER_DRAW_ITEM::GetABPosition( const wxPoint& aXYPosition ) const
      * For instance: Rotation must be made after or before mirroring ?
      * Note: if something is changed here, GetYXPosition must reflect changes
      */
-    wxPoint abPos = aXYPosition + m_imageParams->m_ImageJustifyOffset;
+    wxPoint abPos = aXYPosition + m_instanceOffset + m_imageParams->m_ImageJustifyOffset;
 
     if( m_swapAxis )
         std::swap( abPos.x, abPos.y );
@@ -154,7 +155,7 @@ wxPoint GERBER_DRAW_ITEM::GetXYPosition( const wxPoint& aABPosition ) const
     if( m_swapAxis )
         std::swap( xyPos.x, xyPos.y );
 
-    return xyPos - m_imageParams->m_ImageJustifyOffset;
+    return xyPos - m_imageParams->m_ImageJustifyOffset - m_instanceOffset;
 }
 
 
@@ -239,16 +240,158 @@ D_CODE* GERBER_DRAW_ITEM::GetDcodeDescr()
 const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
 {
     // return a rectangle which is (pos,dim) in nature.  therefore the +1
-    EDA_RECT bbox( m_Start, wxSize( 1, 1 ) );
+    EDA_RECT rect( m_Start, wxSize( 1, 1 ) );
 
-    bbox.Inflate( m_Size.x / 2, m_Size.y / 2 );
+    rect.Inflate( m_Size.x / 2, m_Size.y / 2 );
+
+    EDA_RECT bbox;
+
+    // the box of all the copies of a step and repeat block
+    for( int ii = 0; ii < GetInstanceCount(); ii++ )
+    {
+        SetInstance( ii );
+
+        EDA_RECT instanceBox;
+
+        instanceBox.SetOrigin( GetABPosition( rect.GetOrigin() ) );
+        instanceBox.SetEnd( GetABPosition( rect.GetEnd() ) );
+
+        if( ii == 0 )
+            bbox = instanceBox;
+        else
+            bbox.Merge( instanceBox );
+    }
+
+    SetInstance( 0 );
 
-    bbox.SetOrigin( GetABPosition( bbox.GetOrigin() ) );
-    bbox.SetEnd( GetABPosition( bbox.GetEnd() ) );
     return bbox;
 }
 
 
+const BOX2I GERBER_DRAW_ITEM::ViewBBox() const
+{
+    BOX2I bbox = instanceViewBBox();
+
+    // the box of all the copies of a step and repeat block
+    for( int ii = 1; ii < GetInstanceCount(); ii++ )
+    {
+        SetInstance( ii );
+        bbox.Merge( instanceViewBBox() );
+    }
+
+    SetInstance( 0 );
+
+    return bbox;
+}
+
+
+const BOX2I GERBER_DRAW_ITEM::instanceViewBBox() const
+{
+    // GetDcodeDescr() and the aperture macros are not const
+    GERBER_DRAW_ITEM*    item = const_cast<GERBER_DRAW_ITEM*>( this );
+    D_CODE*              dcode = item->GetDcodeDescr();
+    std::vector<wxPoint> corners;       // the extent of the shape, in X,Y gerber axis
+    std::vector<wxPoint> abCorners;    // the same in A,B axis
+    wxSize               margin;        // the pen or flashed shape size, in X,Y gerber axis
+
+    switch( m_Shape )
+    {
+    case GBR_POLYGON:
+        corners = m_PolyCorners;
+        break;
+
+    case GBR_CIRCLE:
+    case GBR_ARC:
+    {
+        // The whole circle of an arc, which is enough for the view
+        wxPoint center = m_Shape == GBR_CIRCLE ? m_Start : m_ArcCentre;
+        int     radius = KiROUND( GetLineLength( center, m_Shape == GBR_CIRCLE ? m_End : m_Start ) );
+
+        corners.push_back( center - wxPoint( radius, radius ) );
+        corners.push_back( center + wxPoint( radius, radius ) );
+        margin = wxSize( m_Size.x / 2, m_Size.x / 2 );
+    }
+        break;
+
+    case GBR_SEGMENT:
+        // a round or a rectangular pen
+        corners.push_back( m_Start );
+        corners.push_back( m_End );
+        margin = wxSize( m_Size.x / 2, m_Size.y / 2 );
+        break;
+
+    case GBR_SPOT_MACRO:
+        if( dcode && dcode->GetMacro() )
+        {
+            const AM_SHAPES& shapes = dcode->GetMacroShapes();
+
+            for( unsigned ii = 0; ii < shapes.size(); ii++ )
+            {
+                const AM_SHAPE& shape = shapes[ii];
+
+                if( shape.m_Radius > 0 )
+                {
+                    wxPoint radius( shape.m_Radius, shape.m_Radius );
+
+                    corners.push_back( m_Start + shape.m_Center - radius );
+                    corners.push_back( m_Start + shape.m_Center + radius );
+                }
+
+                for( unsigned jj = 0; jj < shape.m_Corners.size(); jj++ )
+                    corners.push_back( m_Start + shape.m_Corners[jj] );
+            }
+
+            break;
+        }
+
+        // fall through
+    default:
+    {
+        // a flashed shape of size m_Size, which can be rotated
+        int radius = KiROUND( hypot( (double) m_Size.x, (double) m_Size.y ) / 2 );
+
+        corners.push_back( m_Start );
+        margin = wxSize( radius, radius );
+    }
+        break;
+    }
+
+    if( corners.size() )
+    {
+        EDA_RECT rect( corners[0], wxSize( 0, 0 ) );
+
+        for( unsigned ii = 1; ii < corners.size(); ii++ )
+            rect.Merge( corners[ii] );
+
+        rect.Inflate( margin.x, margin.y );
+
+        // The 4 corners, the A,B axis can be rotated from the X,Y axis
+        abCorners.push_back( GetABPosition( rect.GetOrigin() ) );
+        abCorners.push_back( GetABPosition( rect.GetEnd() ) );
+        abCorners.push_back( GetABPosition( wxPoint( rect.GetX(), rect.GetBottom() ) ) );
+        abCorners.push_back( GetABPosition( wxPoint( rect.GetRight(), rect.GetY() ) ) );
+    }
+
+    if( abCorners.empty() )
+        return BOX2I( VECTOR2I( GetABPosition( m_Start ) ), VECTOR2I( 0, 0 ) );
+
+    BOX2I bbox( VECTOR2I( abCorners[0] ), VECTOR2I( 0, 0 ) );
+
+    for( unsigned ii = 1; ii < abCorners.size(); ii++ )
+        bbox.Merge( VECTOR2I( abCorners[ii] ) );
+
+    return bbox;
+}
+
+
+void GERBER_DRAW_ITEM::ViewGetLayers( int aLayers[], int& aCount ) const
+{
+    // The view layers are the gerber draw layers
+    aCount      = 1;
+    aLayers[0]  = m_Layer;
+}
+
+
 void GERBER_DRAW_ITEM::MoveAB( const wxPoint& aMoveVector )
 {
     wxPoint xymove = GetXYPosition( aMoveVector );
@@ -308,6 +451,20 @@ bool GERBER_DRAW_ITEM::HasNegativeItems()
 
 void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
                              const wxPoint& aOffset )
+{
+    // the copies of a step and repeat block are drawn from the same item
+    for( int ii = 0; ii < GetInstanceCount(); ii++ )
+    {
+        SetInstance( ii );
+        drawInstance( aPanel, aDC, aDrawMode, aOffset );
+    }
+
+    SetInstance( 0 );
+}
+
+
+void GERBER_DRAW_ITEM::drawInstance( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
+                                     const wxPoint& aOffset )
 {
     // used when a D_CODE is not found. default D_CODE to draw a flashed item
     static D_CODE dummyD_CODE( 0 );
@@ -580,6 +737,22 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( std::vector< MSG_PANEL_ITEM >& aList )
 
 
 bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos ) const
+{
+    bool hit = false;
+
+    for( int ii = 0; ii < GetInstanceCount() && !hit; ii++ )
+    {
+        SetInstance( ii );
+        hit = hitTestInstance( aRefPos );
+    }
+
+    SetInstance( 0 );
+
+    return hit;
+}
+
+
+bool GERBER_DRAW_ITEM::hitTestInstance( const wxPoint& aRefPos ) const
 {
     // calculate aRefPos in XY gerber axis:
     wxPoint ref_pos = GetXYPosition( aRefPos );
@@ -595,6 +768,22 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos ) const
 
 
 bool GERBER_DRAW_ITEM::HitTest( const EDA_RECT& aRefArea ) const
+{
+    bool hit = false;
+
+    for( int ii = 0; ii < GetInstanceCount() && !hit; ii++ )
+    {
+        SetInstance( ii );
+        hit = hitTestInstance( aRefArea );
+    }
+
+    SetInstance( 0 );
+
+    return hit;
+}
+
+
+bool GERBER_DRAW_ITEM::hitTestInstance( const EDA_RECT& aRefArea ) const
 {
     wxPoint pos = GetABPosition( m_Start );
 
@@ -34,6 +34,8 @@
 #include <layers_id_colors_and_visibility.h>
 #include <gr_basic.h>
 
+#include <boost/shared_ptr.hpp>
+
 class GERBER_IMAGE;
 class GBR_LAYOUT;
 class D_CODE;
@@ -54,6 +56,14 @@ enum Gbr_Basic_Shapes {
     GBR_LAST                // last value for this list
 };
 
+/**
+ * Type GBR_REPEAT_OFFSETS
+ * is the grid of a step and repeat block: the offsets of its copies in X,Y gerber axis,
+ * the first one (0,0) being the item itself.  It is shared by the items of the block.
+ */
+typedef std::vector<wxPoint>                        GBR_REPEAT_OFFSETS;
+typedef boost::shared_ptr<const GBR_REPEAT_OFFSETS> GBR_REPEAT_OFFSETS_PTR;
+
 /***/
 
 class GERBER_DRAW_ITEM : public EDA_ITEM
@@ -103,6 +113,16 @@ private:
     wxPoint     m_layerOffset;              // Offset for A and B axis, from OF parameter
     double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
 
+    // A step and repeat block is not copied: its items are drawn once per offset of its grid
+    GBR_REPEAT_OFFSETS_PTR m_repeatOffsets;
+    mutable wxPoint        m_instanceOffset;    // offset of the copy being drawn or tested
+
+    void drawInstance( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
+                       const wxPoint& aOffset );
+    bool hitTestInstance( const wxPoint& aRefPos ) const;
+    bool hitTestInstance( const EDA_RECT& aRefArea ) const;
+    const BOX2I instanceViewBBox() const;
+
 public:
     GERBER_DRAW_ITEM( GBR_LAYOUT* aParent, GERBER_IMAGE* aGerberparams );
     GERBER_DRAW_ITEM( const GERBER_DRAW_ITEM& aSource );
@@ -163,6 +183,45 @@ public:
         m_LayerNegative = aNegative;
     }
 
+    /**
+     * Function SetRepeatOffsets
+     * makes this item the template of a step and repeat block, drawn at each offset of
+     * @a aOffsets instead of being copied.
+     */
+    void SetRepeatOffsets( const GBR_REPEAT_OFFSETS_PTR& aOffsets )
+    {
+        m_repeatOffsets = aOffsets;
+    }
+
+    /**
+     * Function GetInstanceCount
+     * @return the number of copies of this item, more than 1 in a step and repeat block.
+     */
+    int GetInstanceCount() const
+    {
+        return m_repeatOffsets ? (int) m_repeatOffsets->size() : 1;
+    }
+
+    /**
+     * Function GetInstanceOffset
+     * @return the offset in X,Y gerber axis of the copy @a aInstance of this item.
+     */
+    wxPoint GetInstanceOffset( int aInstance ) const
+    {
+        return m_repeatOffsets ? (*m_repeatOffsets)[aInstance] : wxPoint( 0, 0 );
+    }
+
+    /**
+     * Function SetInstance
+     * selects the copy @a aInstance of this item: GetABPosition() and GetXYPosition() then
+     * give the positions of this copy.  The drawing and hit test functions select each copy
+     * in turn, and select back the copy 0, the item itself.
+     */
+    void SetInstance( int aInstance ) const
+    {
+        m_instanceOffset = GetInstanceOffset( aInstance );
+    }
+
     /**
      * Function MoveAB
      * move this object.
@@ -215,6 +274,12 @@ public:
 
     const EDA_RECT GetBoundingBox() const;  // Virtual
 
+    /// @copydoc VIEW_ITEM::ViewBBox()
+    virtual const BOX2I ViewBBox() const;
+
+    /// @copydoc VIEW_ITEM::ViewGetLayers()
+    virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
+
     /* Display on screen: */
     void Draw( EDA_DRAW_PANEL*         aPanel,
                wxDC*                   aDC,
@@ -206,14 +206,15 @@ void GERBER_LAYER_WIDGET::onPopupSelection( wxCommandEvent& event )
         }
 
         myframe->SetVisibleLayers( visibleLayers );
-        myframe->GetCanvas()->Refresh();
+        myframe->RedrawCanvas();
         break;
 
     case ID_SORT_GBR_LAYERS:
         g_GERBER_List.SortImagesByZOrder( myframe->GetItemsList() );
+        myframe->GetGerberLayout()->InvalidateItemIndex();
         myframe->ReFillLayerWidget();
         myframe->syncLayerBox();
-        myframe->GetCanvas()->Refresh();
+        myframe->RedrawCanvas( true );
         break;
     }
 }
@@ -257,7 +258,7 @@ void GERBER_LAYER_WIDGET::OnLayerColorChange( int aLayer, EDA_COLOR_T aColor )
 {
     myframe->SetLayerColor( aLayer, aColor );
     myframe->m_SelLayerBox->ResyncBitmapOnly();
-    myframe->GetCanvas()->Refresh();
+    myframe->RedrawCanvas();
 }
 
 bool GERBER_LAYER_WIDGET::OnLayerSelect( int aLayer )
@@ -271,7 +272,7 @@ bool GERBER_LAYER_WIDGET::OnLayerSelect( int aLayer )
     if( layer != myframe->getActiveLayer( ) )
     {
         if( ! OnLayerSelected() )
-            myframe->GetCanvas()->Refresh();
+            myframe->RedrawCanvas();
     }
 
     return true;
@@ -289,19 +290,19 @@ void GERBER_LAYER_WIDGET::OnLayerVisible( int aLayer, bool isVisible, bool isFin
     myframe->SetVisibleLayers( visibleLayers );
 
     if( isFinal )
-        myframe->GetCanvas()->Refresh();
+        myframe->RedrawCanvas();
 }
 
 void GERBER_LAYER_WIDGET::OnRenderColorChange( int aId, EDA_COLOR_T aColor )
 {
     myframe->SetVisibleElementColor( (GERBER_VISIBLE_ID)aId, aColor );
-    myframe->GetCanvas()->Refresh();
+    myframe->RedrawCanvas();
 }
 
 void GERBER_LAYER_WIDGET::OnRenderEnable( int aId, bool isEnabled )
 {
     myframe->SetElementVisibility( (GERBER_VISIBLE_ID)aId, isEnabled );
-    myframe->GetCanvas()->Refresh();
+    myframe->RedrawCanvas();
 }
 
 //-----</LAYER_WIDGET callbacks>------------------------------------------
@@ -93,6 +93,17 @@ void D_CODE::Clear_D_CODE_Data()
     m_Rotation   = 0.0;
     m_EdgesCount = 0;
     m_PolyCorners.clear();
+    m_MacroShapes.clear();
+}
+
+
+const AM_SHAPES& D_CODE::GetMacroShapes()
+{
+    // A macro has at least one shape, an empty list is not built yet
+    if( m_MacroShapes.empty() && m_Macro )
+        m_Macro->ConvertToShapes( this, m_MacroShapes );
+
+    return m_MacroShapes;
 }
 
 
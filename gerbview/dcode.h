@@ -71,6 +71,35 @@ enum APERTURE_DEF_HOLETYPE {
 struct APERTURE_MACRO;
 
 
+/**
+ * Struct AM_SHAPE
+ * is a shape of an aperture macro evaluated with the parameters of a D_CODE: a polygon
+ * or a circle.  Its coordinates are relative to the flashed position, in X,Y gerber axis:
+ * the rotation and the position of its primitive are applied, the flashed position and the
+ * conversion to the A,B axis are not.
+ */
+struct AM_SHAPE
+{
+    unsigned             m_Primitive;   ///< index of its primitive in APERTURE_MACRO::primitives
+    bool                 m_AltColor;    ///< true for the thermal sub-shapes, drawn with the alt
+                                        ///< color when their primitive is exposed
+    int                  m_Radius;      ///< 0 for a polygon, else the radius of a circle
+    int                  m_PenWidth;    ///< for a circle, the width of its ring, 0 for a disc
+    wxPoint              m_Center;      ///< the center of a circle
+    std::vector<wxPoint> m_Corners;     ///< the corners of a polygon
+
+    AM_SHAPE() :
+        m_Primitive( 0 ),
+        m_AltColor( false ),
+        m_Radius( 0 ),
+        m_PenWidth( 0 )
+    {
+    }
+};
+
+typedef std::vector<AM_SHAPE> AM_SHAPES;
+
+
 /**
  * Class D_CODE
  * holds a gerber DCODE definition.
@@ -91,6 +120,8 @@ private:
                                              * (shapes with hole )
                                              */
 
+    AM_SHAPES             m_MacroShapes;    ///< the evaluated shapes of m_Macro, see GetMacroShapes()
+
 public:
     wxSize                m_Size;           /* Horizontal and vertical dimensions. */
     APERTURE_T            m_Shape;          /* shape ( Line, rectangle, circle , oval .. ) */
@@ -116,6 +147,7 @@ public:
     void AppendParam( double aValue )
     {
         m_am_params.push_back( aValue );
+        m_MacroShapes.clear();
     }
 
     /**
@@ -145,6 +177,7 @@ public:
     void SetMacro( APERTURE_MACRO* aMacro )
     {
         m_Macro = aMacro;
+        m_MacroShapes.clear();
     }
 
 
@@ -200,6 +233,28 @@ public:
      */
     void ConvertShapeToPolygon();
 
+    /**
+     * Function GetShapePolygon
+     * returns the polygon of the shape, relative to the shape position, converting
+     * the shape by ConvertShapeToPolygon() on the first call.
+     */
+    const std::vector<wxPoint>& GetShapePolygon()
+    {
+        if( m_PolyCorners.size() == 0 )
+            ConvertShapeToPolygon();
+
+        return m_PolyCorners;
+    }
+
+    /**
+     * Function GetMacroShapes
+     * returns the shapes of the aperture macro of this D_CODE, relative to the shape
+     * position.  They are evaluated with the parameters of this D_CODE on the first call,
+     * by APERTURE_MACRO::ConvertToShapes(), and moved to the position of each flash by the
+     * drawing functions.
+     */
+    const AM_SHAPES& GetMacroShapes();
+
     /**
      * Function GetShapeDim
      * calculates a value that can be used to evaluate the size of text
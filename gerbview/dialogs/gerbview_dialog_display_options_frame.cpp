@@ -69,7 +69,7 @@ void GERBVIEW_FRAME::InstallGerberOptionsDialog( wxCommandEvent& event )
     int opt = dlg.ShowModal();
 
     if( opt > 0 )
-        m_canvas->Refresh();
+        RedrawCanvas();
 }
 
 
@@ -184,7 +184,7 @@ void DIALOG_DISPLAY_OPTIONS::OnOKBUttonClick( wxCommandEvent& event )
     m_Parent->GetCanvas()->SetEnableMiddleButtonPan( m_OptMiddleButtonPan->GetValue() );
     m_Parent->GetCanvas()->SetMiddleButtonPanLimited( m_OptMiddleButtonPanLimited->GetValue() );
 
-    m_Parent->GetCanvas()->Refresh();
+    m_Parent->RedrawCanvas();
 
     EndModal( 1 );
 }
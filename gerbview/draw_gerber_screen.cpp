@@ -372,7 +372,8 @@ void GBR_LAYOUT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
     {
         // For this Blit call, aDC and screenDC must have the same settings
         // So we set device origin, logical origin and scale to default values
-        // in aDC
+        // in aDC, once its pending lines are drawn
+        GRFlushLineBatch( aDC );
         aDC->SetDeviceOrigin( 0, 0);
         aDC->SetLogicalOrigin( 0, 0 );
         aDC->SetUserScale( 1, 1 );
@@ -419,8 +420,6 @@ void GERBVIEW_FRAME::DrawItemsDCodeID( wxDC* aDC, GR_DRAWMODE aDrawMode )
             pos.y = (item->m_Start.y + item->m_End.y) / 2;
         }
 
-        pos = item->GetABPosition( pos );
-
         Line.Printf( wxT( "D%d" ), item->m_DCode );
 
         if( item->GetDcodeDescr() )
@@ -449,9 +448,18 @@ void GERBVIEW_FRAME::DrawItemsDCodeID( wxDC* aDC, GR_DRAWMODE aDrawMode )
 
         int color = GetVisibleElementColor( DCODES_VISIBLE );
 
-        DrawGraphicText( m_canvas->GetClipBox(), aDC, pos, (EDA_COLOR_T) color, Line,
-                         orient, wxSize( width, width ),
-                         GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER,
-                         0, false, false );
+        // the copies of a step and repeat block are labelled too
+        for( int ii = 0; ii < item->GetInstanceCount(); ii++ )
+        {
+            item->SetInstance( ii );
+
+            DrawGraphicText( m_canvas->GetClipBox(), aDC, item->GetABPosition( pos ),
+                             (EDA_COLOR_T) color, Line,
+                             orient, wxSize( width, width ),
+                             GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER,
+                             0, false, false );
+        }
+
+        item->SetInstance( 0 );
     }
 }
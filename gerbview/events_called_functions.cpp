@@ -62,6 +62,7 @@ BEGIN_EVENT_TABLE( GERBVIEW_FRAME, EDA_DRAW_FRAME )
     EVT_MENU( ID_NEW_BOARD, GERBVIEW_FRAME::Files_io )
     EVT_MENU( ID_GEN_PLOT, GERBVIEW_FRAME::ToPlotter )
     EVT_MENU( ID_GERBVIEW_EXPORT_TO_PCBNEW, GERBVIEW_FRAME::ExportDataInPcbnewFormat )
+    EVT_MENU( ID_GERBVIEW_EXPORT_TO_BITMAP_TILES, GERBVIEW_FRAME::ExportLayerToBitmapTiles )
 
     EVT_MENU_RANGE( wxID_FILE1, wxID_FILE9, GERBVIEW_FRAME::OnGbrFileHistory )
     EVT_MENU_RANGE( ID_GERBVIEW_DRILL_FILE1, ID_GERBVIEW_DRILL_FILE9,
@@ -76,10 +77,14 @@ BEGIN_EVENT_TABLE( GERBVIEW_FRAME, EDA_DRAW_FRAME )
     EVT_MENU( ID_MENU_GERBVIEW_SHOW_HIDE_LAYERS_MANAGER_DIALOG,
               GERBVIEW_FRAME::OnSelectOptionToolbar )
     EVT_MENU( wxID_PREFERENCES, GERBVIEW_FRAME::InstallGerberOptionsDialog )
+    EVT_MENU( ID_MENU_GERBVIEW_CANVAS_LEGACY, GERBVIEW_FRAME::SwitchCanvas )
+    EVT_MENU( ID_MENU_GERBVIEW_CANVAS_OPENGL, GERBVIEW_FRAME::SwitchCanvas )
+    EVT_MENU( ID_MENU_GERBVIEW_CANVAS_CAIRO, GERBVIEW_FRAME::SwitchCanvas )
 
     // menu Postprocess
     EVT_MENU( ID_GERBVIEW_SHOW_LIST_DCODES, GERBVIEW_FRAME::Process_Special_Functions )
     EVT_MENU( ID_GERBVIEW_SHOW_SOURCE, GERBVIEW_FRAME::OnShowGerberSourceFile )
+    EVT_MENU( ID_GERBVIEW_COMPARE_LAYERS, GERBVIEW_FRAME::OnCompareLayers )
     EVT_MENU( ID_MENU_GERBVIEW_SELECT_PREFERED_EDITOR,
               EDA_BASE_FRAME::OnSelectPreferredEditor )
 
@@ -178,7 +183,7 @@ void GERBVIEW_FRAME::Process_Special_Functions( wxCommandEvent& event )
             DIALOG_PAGE_SHOW_PAGE_BORDERS dlg( this );
 
             if( dlg.ShowModal() == wxID_OK )
-                m_canvas->Refresh();
+                RedrawCanvas();
         }
         break;
 
@@ -232,7 +237,7 @@ void GERBVIEW_FRAME::OnSelectActiveDCode( wxCommandEvent& event )
         if( tool != gerber_image->m_Selected_Tool )
         {
             gerber_image->m_Selected_Tool = tool;
-            m_canvas->Refresh();
+            RedrawCanvas();
         }
     }
 }
@@ -247,7 +252,7 @@ void GERBVIEW_FRAME::OnSelectActiveLayer( wxCommandEvent& event )
     if( layer != getActiveLayer() )
     {
         if( m_LayersManager->OnLayerSelected() )
-            m_canvas->Refresh();
+            RedrawCanvas();
     }
 }
 
@@ -298,7 +303,7 @@ void GERBVIEW_FRAME::OnSelectDisplayMode( wxCommandEvent& event )
     }
 
     if( GetDisplayMode() != oldMode )
-        m_canvas->Refresh();
+        RedrawCanvas();
 }
 
 
@@ -348,27 +353,27 @@ void GERBVIEW_FRAME::OnSelectOptionToolbar( wxCommandEvent& event )
 
     case ID_TB_OPTIONS_SHOW_FLASHED_ITEMS_SKETCH:
         m_DisplayOptions.m_DisplayFlashedItemsFill = not state;
-        m_canvas->Refresh( true );
+        RedrawCanvas();
         break;
 
     case ID_TB_OPTIONS_SHOW_LINES_SKETCH:
         m_DisplayOptions.m_DisplayLinesFill = not state;
-        m_canvas->Refresh( true );
+        RedrawCanvas();
         break;
 
     case ID_TB_OPTIONS_SHOW_POLYGONS_SKETCH:
         m_DisplayOptions.m_DisplayPolygonsFill = not state;
-        m_canvas->Refresh( true );
+        RedrawCanvas();
         break;
 
     case ID_TB_OPTIONS_SHOW_DCODES:
         SetElementVisibility( DCODES_VISIBLE, state );
-        m_canvas->Refresh( true );
+        RedrawCanvas();
         break;
 
     case ID_TB_OPTIONS_SHOW_NEGATIVE_ITEMS:
         SetElementVisibility( NEGATIVE_OBJECTS_VISIBLE, state );
-        m_canvas->Refresh( true );
+        RedrawCanvas();
         break;
 
     case ID_TB_OPTIONS_SHOW_LAYERS_MANAGER_VERTICAL_TOOLBAR:
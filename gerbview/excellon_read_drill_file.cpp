@@ -79,7 +79,6 @@
 
 #include <cmath>
 
-#include <html_messagebox.h>
 
 // Default format for dimensions
 // number of digits in mantissa:
@@ -172,50 +171,22 @@ static EXCELLON_CMD excellon_G_CmdList[] =
  *   integer 2.4 format in imperial units,
  *   integer 3.2 or 3.3 format (metric units).
  */
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
+bool EXCELLON_IMAGE::LoadFile( const wxString& aFullFileName )
 {
-    wxString msg;
-    int layerId = getActiveLayer();      // current layer used in GerbView
-    EXCELLON_IMAGE* drill_Layer = (EXCELLON_IMAGE*) g_GERBER_List.GetGbrImage( layerId );
-
-    if( drill_Layer == NULL )
-    {
-        drill_Layer = new EXCELLON_IMAGE( this, layerId );
-        layerId = g_GERBER_List.AddGbrImage( drill_Layer, layerId );
-    }
-
-    if( layerId < 0 )
-    {
-        DisplayError( this, _( "No room to load file" ) );
-        return false;
-    }
-
     ClearMessageList();
 
-    /* Read the gerber file */
+    /* Read the drill file */
     FILE * file = wxFopen( aFullFileName, wxT( "rt" ) );
+
     if( file == NULL )
     {
+        wxString msg;
         msg.Printf( _( "File %s not found" ), GetChars( aFullFileName ) );
-        DisplayError( this, msg );
+        ReportMessage( msg );
         return false;
     }
 
-    wxString path = wxPathOnly( aFullFileName );
-
-    if( path != wxEmptyString )
-        wxSetWorkingDirectory( path );
-
-    bool success = drill_Layer->Read_EXCELLON_File( file, aFullFileName );
-
-    // Display errors list
-    if( m_Messages.size() > 0 )
-    {
-        HTML_MESSAGE_BOX dlg( this, _( "Files not found" ) );
-        dlg.ListSet( m_Messages );
-        dlg.ShowModal();
-    }
-    return success;
+    return Read_EXCELLON_File( file, aFullFileName );
 }
 
 bool EXCELLON_IMAGE::Read_EXCELLON_File( FILE * aFile,
@@ -225,18 +196,12 @@ bool EXCELLON_IMAGE::Read_EXCELLON_File( FILE * aFile,
     ResetDefaultValues();
 
     m_FileName = aFullFileName;
-    m_Current_File = aFile;
-
-    LOCALE_IO toggleIo;
 
     // FILE_LINE_READER will close the file.
-    if( m_Current_File == NULL )
-    {
-        wxMessageBox( wxT("NULL!"), m_FileName );
+    if( aFile == NULL )
         return false;
-    }
 
-    FILE_LINE_READER excellonReader( m_Current_File, m_FileName );
+    FILE_LINE_READER excellonReader( aFile, m_FileName );
     while( true )
     {
         if( excellonReader.ReadLine() == 0 )
@@ -289,8 +254,7 @@ bool EXCELLON_IMAGE::Read_EXCELLON_File( FILE * aFile,
             {
                 wxString msg;
                 msg.Printf( wxT( "Unexpected symbol &lt;%c&gt;" ), *text );
-                if( GetParent() )
-                    GetParent()->ReportMessage( msg );
+                ReportMessage( msg );
             }
                 break;
             }   // End switch
@@ -300,7 +264,7 @@ bool EXCELLON_IMAGE::Read_EXCELLON_File( FILE * aFile,
     // Add our file attribute, to identify the drill file
     X2_ATTRIBUTE dummy;
     char* text = (char*)file_attribute;
-    dummy.ParseAttribCmd( m_Current_File, NULL, 0, text );
+    dummy.ParseAttribCmd( NULL, text );
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
@@ -536,18 +500,18 @@ bool EXCELLON_IMAGE::Execute_Drill_Command( char*& text )
                     return false;
                 }
                 gbritem = new GERBER_DRAW_ITEM( GetParent()->GetGerberLayout(), this );
-                GetParent()->GetGerberLayout()->m_Drawings.Append( gbritem );
+                m_Drawings.Append( gbritem );
                 if( m_SlotOn )  // Oval hole
                 {
                     fillLineGBRITEM( gbritem,
-                                    tool->m_Num_Dcode, GetParent()->getActiveLayer(),
+                                    tool->m_Num_Dcode, m_GraphicLayer,
                                     m_PreviousPos, m_CurrentPos,
                                     tool->m_Size, false );
                 }
                 else
                 {
                     fillFlashedGBRITEM( gbritem, tool->m_Shape,
-                                    tool->m_Num_Dcode, GetParent()->getActiveLayer(),
+                                    tool->m_Num_Dcode, m_GraphicLayer,
                                     m_CurrentPos,
                                     tool->m_Size, false );
                 }
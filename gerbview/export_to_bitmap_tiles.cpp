@@ -0,0 +1,181 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file export_to_bitmap_tiles.cpp
+ * @brief Export of the active layer to a set of PNG tiles, for high resolution bitmaps.
+ */
+
+#include <fctsys.h>
+#include <common.h>
+#include <confirm.h>
+#include <pgm_base.h>
+#include <richio.h>
+#include <thread_pool.h>
+#include <wildcards_and_files_ext.h>
+
+#include <gerbview.h>
+#include <gerbview_frame.h>
+#include <class_gbr_layout.h>
+#include <class_GERBER.h>
+#include <gerber_raster.h>
+
+#include <boost/bind.hpp>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/image.h>
+#include <wx/imagpng.h>
+#include <wx/textdlg.h>
+
+
+// The default resolution of the tiles, in dots per inch
+#define BITMAP_TILES_DEFAULT_DPI    10000
+
+
+/**
+ * Function tileFileName
+ * @return the name of the tile file of the row aRow and column aCol, from the name
+ * chosen by the user: "name_r<row>_c<col>.png", rows and columns starting at 0
+ */
+static wxString tileFileName( const wxFileName& aBaseName, int aRow, int aCol )
+{
+    wxFileName fn( aBaseName );
+
+    fn.SetName( aBaseName.GetName() + wxString::Format( wxT( "_r%03d_c%03d" ), aRow, aCol ) );
+    fn.SetExt( wxT( "png" ) );
+
+    return fn.GetFullPath();
+}
+
+
+/**
+ * Function writeTile
+ * fills the tile aTile of the grid of aLayer, and writes it to its PNG file, in greyscale:
+ * the dark pixels are black.  This is a task of the thread pool: only the tile is in
+ * memory, and a failure is reported by an exception.
+ */
+static void writeTile( const GERBER_RASTER_LAYER* aLayer, int aTile, int aCols,
+                       const wxFileName* aBaseName )
+{
+    RASTER_TILE tile = aLayer->FillTile( aTile );
+    wxImage     image( GERBER_RASTER_TILE_SIZE, GERBER_RASTER_TILE_SIZE, false );
+    unsigned char* rgb = image.GetData();
+
+    // the pixels rows are top to bottom in A,B axis, as in the image
+    for( unsigned ii = 0; ii < tile.m_pixels.size(); ii++ )
+    {
+        unsigned char value = tile.m_pixels[ii] ? 0 : 255;
+
+        rgb[3 * ii] = rgb[3 * ii + 1] = rgb[3 * ii + 2] = value;
+    }
+
+    image.SetOption( wxIMAGE_OPTION_PNG_FORMAT, wxPNG_TYPE_GREY );
+
+    wxString fileName = tileFileName( *aBaseName, aTile / aCols, aTile % aCols );
+
+    if( !image.SaveFile( fileName, wxBITMAP_TYPE_PNG ) )
+        THROW_IO_ERROR( wxString::Format( _( "Cannot create file '%s'" ), GetChars( fileName ) ) );
+}
+
+
+void GERBVIEW_FRAME::ExportLayerToBitmapTiles( wxCommandEvent& event )
+{
+    int layer = getActiveLayer();
+
+    if( !g_GERBER_List.IsUsed( layer ) )
+    {
+        DisplayInfoMessage( this, _( "The active layer does not contain any data" ) );
+        return;
+    }
+
+    wxString text = wxGetTextFromUser( _( "Resolution (dpi):" ), _( "Export to Bitmap Tiles" ),
+                                       wxString::Format( wxT( "%d" ),
+                                                         BITMAP_TILES_DEFAULT_DPI ),
+                                       this );
+    long     dpi;
+
+    if( text.IsEmpty() )
+        return;
+
+    if( !text.ToLong( &dpi ) || dpi <= 0 )
+    {
+        DisplayError( this, _( "Invalid resolution" ) );
+        return;
+    }
+
+    wxFileDialog dlg( this, _( "Tiles base file name:" ), m_mruPath, wxEmptyString,
+                      PngFileWildcard, wxFD_SAVE );
+
+    if( dlg.ShowModal() == wxID_CANCEL )
+        return;
+
+    wxFileName baseName( dlg.GetPath() );
+    m_mruPath = baseName.GetPath();
+
+    int resolution = std::max( KiROUND( 25.4 * IU_PER_MM / dpi ), 1 );
+
+    GERBER_RASTER_LAYER raster( GetGerberLayout(), layer );
+
+    wxBusyCursor dummy;
+
+    if( !raster.CollectItems() )
+        return;
+
+    // The grid covers the area, one more pixel for the items on its right and bottom edges
+    const EDA_RECT& area = raster.GetArea();
+    int tileSize = GERBER_RASTER_TILE_SIZE * resolution;
+    int cols = area.GetWidth() / tileSize + 1;
+    int rows = area.GetHeight() / tileSize + 1;
+
+    raster.SetGrid( area.GetOrigin(), resolution, cols, rows );
+
+    // Each tile is written by its task: the memory used is the tiles being written
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+    for( int tile = 0; tile < cols * rows; tile++ )
+        tasks.Run( boost::bind( writeTile, &raster, tile, cols, &baseName ) );
+
+    bool ok = tasks.Wait();
+
+    // The placement of the tiles, for the tools which read them
+    wxFileName indexName( baseName );
+    indexName.SetExt( wxT( "txt" ) );
+
+    wxFFile index( indexName.GetFullPath(), wxT( "wt" ) );
+
+    if( index.IsOpened() )
+    {
+        index.Write( wxString::Format( wxT( "dpi %ld\ntile_size %d\ncolumns %d\nrows %d\n"
+                                            "origin_mm %.6f %.6f\n" ),
+                                       dpi, GERBER_RASTER_TILE_SIZE, cols, rows,
+                                       area.GetX() / IU_PER_MM, area.GetY() / IU_PER_MM ) );
+    }
+    else
+    {
+        ok = false;
+    }
+
+    if( !ok )
+        DisplayError( this, _( "Some of the tile files cannot be written" ) );
+}
@@ -28,6 +28,9 @@
  */
 
 #include <vector>
+#include <set>
+#include <map>
+#include <string>
 
 #include <fctsys.h>
 #include <common.h>
@@ -43,6 +46,7 @@
 #include <select_layers_to_pcb.h>
 #include <build_version.h>
 #include <wildcards_and_files_ext.h>
+#include <geometry/shape_poly_set.h>
 
 
 // Imported function
@@ -52,6 +56,9 @@ extern const wxString GetPCBDefaultLayerName( LAYER_NUM aLayerNumber );
 
 #define TRACK_TYPE  0
 
+// The size of the buffer of the board file, which is written by many short prints
+#define EXPORT_FILE_BUFFER_SIZE ( 1 << 20 )
+
 /* A helper class to export a Gerber set of files to Pcbnew
  */
 class GBR_TO_PCB_EXPORTER
@@ -61,9 +68,20 @@ private:
     wxString                m_pcb_file_name;    // BOARD file to write to
     FILE*                   m_fp;               // the board file
     int                     m_pcbCopperLayersCount;
-    std::vector<wxPoint>    m_vias_coordinates; // list of already generated vias,
+    std::set< std::pair<int, int> > m_vias_coordinates; // already generated vias,
                                                 // used to export only once a via
                                                 // having a given coordinate
+    std::string             m_layerNames[LAYER_ID_COUNT];   // board layer names, in UTF8
+
+    /// The polygon regions of a board layer, merged before being written
+    struct REGIONS
+    {
+        SHAPE_POLY_SET  m_merged;               // the regions already merged
+        SHAPE_POLY_SET  m_added;                // the positive regions not yet merged
+    };
+
+    std::map<LAYER_NUM, REGIONS> m_regions;     // by board layer
+
 public:
     GBR_TO_PCB_EXPORTER( GERBVIEW_FRAME* aFrame, const wxString& aFileName );
     ~GBR_TO_PCB_EXPORTER();
@@ -75,6 +93,16 @@ public:
     bool    ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLayers );
 
 private:
+    /**
+     * Function export_item
+     * writes each copy of a gerber item to the board file: the item, or the copies of a
+     * step and repeat block, which are not stored as items.
+     * @param aGbrItem = the Gerber item to export
+     * @param aLayer = the layer to use
+     * @param aCopper = true to export to a copper layer, see export_copper_item()
+     */
+    void    export_item( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer, bool aCopper );
+
     /**
      * Function export_non_copper_item
      * write a non copper line or arc to the board file.
@@ -115,6 +143,39 @@ private:
      */
     void    export_segarc_copper_item( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer );
 
+    /**
+     * Function export_region
+     * adds a polygon region (G36 to G37) to the regions of a layer, which are written
+     * merged by writeRegions().  A clear region is removed from the regions added before it.
+     * @param aGbrItem = the Gerber item (polygon only) to export
+     * @param aLayer = the layer to use
+     */
+    void    export_region( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer );
+
+    /**
+     * Function writeRegions
+     * writes the merged regions of all the layers, and clears them: a zone for each region
+     * of a copper layer, a polygon for each region of a technical layer.
+     * @param aCopper = true when the regions are on copper layers
+     */
+    void    writeRegions( bool aCopper );
+
+    /**
+     * function writePolygonPoints
+     * basic write function to write the (pts ...) list of a polygon
+     * to the board file
+     */
+    void    writePolygonPoints( const SHAPE_LINE_CHAIN& aPolygon );
+
+    /**
+     * function layerName
+     * @return the board name of the layer aLayer, in UTF8
+     */
+    const char* layerName( LAYER_NUM aLayer ) const
+    {
+        return m_layerNames[aLayer].c_str();
+    }
+
     /**
      * function writePcbLineItem
      * basic write function to write a DRAWSEGMENT item or a TRACK item
@@ -145,6 +206,9 @@ GBR_TO_PCB_EXPORTER::GBR_TO_PCB_EXPORTER( GERBVIEW_FRAME* aFrame, const wxString
     m_pcb_file_name     = aFileName;
     m_fp                = NULL;
     m_pcbCopperLayersCount = 2;
+
+    for( int ii = 0; ii < LAYER_ID_COUNT; ii++ )
+        m_layerNames[ii] = TO_UTF8( GetPCBDefaultLayerName( ii ) );
 }
 
 
@@ -218,6 +282,8 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
         return false;
     }
 
+    setvbuf( m_fp, NULL, _IOFBF, EXPORT_FILE_BUFFER_SIZE );
+
     m_pcbCopperLayersCount = aCopperLayers;
 
     writePcbHeader( aLayerLookUpTable );
@@ -236,9 +302,11 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
             continue;
 
         if( pcb_layer_number > pcbCopperLayerMax )
-            export_non_copper_item( gerb_item, pcb_layer_number );
+            export_item( gerb_item, pcb_layer_number, false );
     }
 
+    writeRegions( false );
+
     // Copper layers
     gerb_item = m_gerbview_frame->GetItemsList();
 
@@ -251,9 +319,11 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
             continue;
 
         else
-            export_copper_item( gerb_item, pcb_layer_number );
+            export_item( gerb_item, pcb_layer_number, true );
     }
 
+    writeRegions( true );
+
     fprintf( m_fp, ")\n" );
 
     fclose( m_fp );
@@ -262,8 +332,42 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
 }
 
 
+void GBR_TO_PCB_EXPORTER::export_item( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer,
+                                       bool aCopper )
+{
+    if( aGbrItem->GetInstanceCount() == 1 )
+    {
+        if( aCopper )
+            export_copper_item( aGbrItem, aLayer );
+        else
+            export_non_copper_item( aGbrItem, aLayer );
+
+        return;
+    }
+
+    // Each copy is exported from a temporary item moved to its offset
+    for( int ii = 0; ii < aGbrItem->GetInstanceCount(); ii++ )
+    {
+        GERBER_DRAW_ITEM instance( *aGbrItem );
+
+        instance.MoveXY( aGbrItem->GetInstanceOffset( ii ) );
+
+        if( aCopper )
+            export_copper_item( &instance, aLayer );
+        else
+            export_non_copper_item( &instance, aLayer );
+    }
+}
+
+
 void GBR_TO_PCB_EXPORTER::export_non_copper_item( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer )
 {
+    if( aGbrItem->m_Shape == GBR_POLYGON )
+    {
+        export_region( aGbrItem, aLayer );
+        return;
+    }
+
     bool isArc = false;
 
     double     angle   = 0;
@@ -308,6 +412,10 @@ void GBR_TO_PCB_EXPORTER::export_copper_item( GERBER_DRAW_ITEM* aGbrItem, LAYER_
         export_segarc_copper_item( aGbrItem, aLayer );
         break;
 
+    case GBR_POLYGON:
+        export_region( aGbrItem, aLayer );
+        break;
+
     default:
         export_segline_copper_item( aGbrItem, aLayer );
         break;
@@ -339,7 +447,7 @@ void GBR_TO_PCB_EXPORTER::writeCopperLineItem( wxPoint& aStart, wxPoint& aEnd,
                   Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
                   Double2Str( TO_PCB_UNIT(aEnd.y) ).c_str(),
                   Double2Str( TO_PCB_UNIT( aWidth ) ).c_str(),
-                  TO_UTF8( GetPCBDefaultLayerName( aLayer ) ) );
+                  layerName( aLayer ) );
 }
 
 
@@ -404,13 +512,10 @@ void GBR_TO_PCB_EXPORTER::export_segarc_copper_item( GERBER_DRAW_ITEM* aGbrItem,
 void GBR_TO_PCB_EXPORTER::export_flashed_copper_item( GERBER_DRAW_ITEM* aGbrItem )
 {
     // First, explore already created vias, before creating a new via
-    for( unsigned ii = 0; ii < m_vias_coordinates.size(); ii++ )
-    {
-        if( m_vias_coordinates[ii] == aGbrItem->m_Start ) // Already created
-            return;
-    }
+    std::pair<int, int> position( aGbrItem->m_Start.x, aGbrItem->m_Start.y );
 
-    m_vias_coordinates.push_back( aGbrItem->m_Start );
+    if( !m_vias_coordinates.insert( position ).second )    // Already created
+        return;
 
     wxPoint via_pos = aGbrItem->m_Start;
     int width   = (aGbrItem->m_Size.x + aGbrItem->m_Size.y) / 2;
@@ -424,8 +529,97 @@ void GBR_TO_PCB_EXPORTER::export_flashed_copper_item( GERBER_DRAW_ITEM* aGbrItem
                   Double2Str( TO_PCB_UNIT( width ) ).c_str() );
 
     fprintf( m_fp, " (layers %s %s))\n",
-                  TO_UTF8( GetPCBDefaultLayerName( F_Cu ) ),
-                  TO_UTF8( GetPCBDefaultLayerName( B_Cu ) ) );
+                  layerName( F_Cu ), layerName( B_Cu ) );
+}
+
+
+void GBR_TO_PCB_EXPORTER::export_region( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer )
+{
+    if( aGbrItem->m_PolyCorners.size() < 3 )
+        return;
+
+    REGIONS& regions = m_regions[aLayer];
+    bool     isClear = aGbrItem->GetLayerPolarity() ^ aGbrItem->m_imageParams->m_ImageNegative;
+    SHAPE_POLY_SET  clearRegion;
+    SHAPE_POLY_SET& region = isClear ? clearRegion : regions.m_added;
+
+    region.NewOutline();
+
+    // Reverse Y axis:
+    for( unsigned ii = 0; ii < aGbrItem->m_PolyCorners.size(); ii++ )
+        region.Append( aGbrItem->m_PolyCorners[ii].x, -aGbrItem->m_PolyCorners[ii].y );
+
+    if( !isClear )
+        return;
+
+    // The positive regions are merged at once, up to the next clear region
+    if( regions.m_added.OutlineCount() )
+    {
+        regions.m_merged.BooleanAdd( regions.m_added, SHAPE_POLY_SET::PM_FAST );
+        regions.m_added.RemoveAllContours();
+    }
+
+    regions.m_merged.BooleanSubtract( clearRegion, SHAPE_POLY_SET::PM_FAST );
+}
+
+
+void GBR_TO_PCB_EXPORTER::writeRegions( bool aCopper )
+{
+    for( std::map<LAYER_NUM, REGIONS>::iterator it = m_regions.begin();
+         it != m_regions.end(); ++it )
+    {
+        REGIONS& regions = it->second;
+
+        if( regions.m_added.OutlineCount() )
+            regions.m_merged.BooleanAdd( regions.m_added, SHAPE_POLY_SET::PM_FAST );
+
+        // Neither the zones nor the polygons of the board have holes
+        regions.m_merged.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+        for( int ii = 0; ii < regions.m_merged.OutlineCount(); ii++ )
+        {
+            const SHAPE_LINE_CHAIN& outline = regions.m_merged.COutline( ii );
+
+            if( aCopper )
+            {
+                fprintf( m_fp, "(zone (net 0) (net_name \"\") (layer %s) (tstamp 0) "
+                               "(hatch edge 0.508)\n", layerName( it->first ) );
+                fprintf( m_fp, "  (connect_pads (clearance 0))\n  (min_thickness 0.0254)\n" );
+                fprintf( m_fp, "  (fill yes (arc_segments 16) (thermal_gap 0.508) "
+                               "(thermal_bridge_width 0.508))\n" );
+                fprintf( m_fp, "  (polygon " );
+                writePolygonPoints( outline );
+                fprintf( m_fp, ")\n  (filled_polygon " );
+                writePolygonPoints( outline );
+                fprintf( m_fp, ")\n)\n" );
+            }
+            else
+            {
+                fprintf( m_fp, "(gr_poly " );
+                writePolygonPoints( outline );
+                fprintf( m_fp, " (layer %s) (width 0))\n", layerName( it->first ) );
+            }
+        }
+    }
+
+    m_regions.clear();
+}
+
+
+void GBR_TO_PCB_EXPORTER::writePolygonPoints( const SHAPE_LINE_CHAIN& aPolygon )
+{
+    fprintf( m_fp, "(pts" );
+
+    for( int ii = 0; ii < aPolygon.PointCount(); ii++ )
+    {
+        const VECTOR2I& point = aPolygon.CPoint( ii );
+
+        fprintf( m_fp, " (xy %s %s)",
+                 Double2Str( TO_PCB_UNIT( point.x ) ).c_str(),
+                 Double2Str( TO_PCB_UNIT( point.y ) ).c_str() );
+    }
+
+    fprintf( m_fp, ")" );
 }
 
 void GBR_TO_PCB_EXPORTER::writePcbHeader( LAYER_NUM* aLayerLookUpTable )
@@ -443,12 +637,12 @@ void GBR_TO_PCB_EXPORTER::writePcbHeader( LAYER_NUM* aLayerLookUpTable )
         if( ii == m_pcbCopperLayersCount-1)
             id = B_Cu;
 
-        fprintf( m_fp, "    (%d %s signal)\n", id, TO_UTF8( GetPCBDefaultLayerName( id ) ) );
+        fprintf( m_fp, "    (%d %s signal)\n", id, layerName( id ) );
     }
 
     for( int ii = B_Adhes; ii < LAYER_ID_COUNT; ii++ )
     {
-        fprintf( m_fp, "    (%d %s user)\n", ii, TO_UTF8( GetPCBDefaultLayerName( ii ) ) );
+        fprintf( m_fp, "    (%d %s user)\n", ii, layerName( ii ) );
     }
 
     fprintf( m_fp, "  )\n\n" );
@@ -465,7 +659,7 @@ void GBR_TO_PCB_EXPORTER::writePcbLineItem( bool aIsArc, wxPoint& aStart, wxPoin
                  Double2Str( TO_PCB_UNIT(aStart.y) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.y) ).c_str(),
-                 TO_UTF8( GetPCBDefaultLayerName( aLayer ) ),
+                 layerName( aLayer ),
                  Double2Str( TO_PCB_UNIT( aWidth ) ).c_str()
                  );
     }
@@ -477,7 +671,7 @@ void GBR_TO_PCB_EXPORTER::writePcbLineItem( bool aIsArc, wxPoint& aStart, wxPoin
                  Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.y) ).c_str(),
                  Double2Str( aAngle ).c_str(),
-                 TO_UTF8( GetPCBDefaultLayerName( aLayer ) ),
+                 layerName( aLayer ),
                  Double2Str( TO_PCB_UNIT( aWidth ) ).c_str()
                  );
     }
@@ -488,7 +682,7 @@ void GBR_TO_PCB_EXPORTER::writePcbLineItem( bool aIsArc, wxPoint& aStart, wxPoin
                  Double2Str( TO_PCB_UNIT(aStart.y) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.y) ).c_str(),
-                 TO_UTF8( GetPCBDefaultLayerName( aLayer ) ),
+                 layerName( aLayer ),
                  Double2Str( TO_PCB_UNIT( aWidth ) ).c_str()
                  );
     }
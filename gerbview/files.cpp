@@ -37,6 +37,96 @@
 #include <gerbview_id.h>
 #include <class_gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
+#include <class_GERBER.h>
+#include <class_excellon.h>
+#include <html_messagebox.h>
+#include <pgm_base.h>
+#include <richio.h>
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
+
+
+/**
+ * Function readImageFile
+ * is the task reading a file in its image.
+ */
+static void readImageFile( GERBER_IMAGE* aImage, const wxString& aFileName )
+{
+    try
+    {
+        aImage->LoadFile( aFileName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        aImage->ReportMessage( ioe.errorText );
+    }
+}
+
+
+/**
+ * Function readImageFiles
+ * reads each file of @a aFileNames in its image of @a aImages.  The files are independent
+ * until their items are moved to the layout: they are read at once, on the threads of the
+ * process.
+ */
+static void readImageFiles( const std::vector<GERBER_IMAGE*>& aImages,
+                            const std::vector<wxString>& aFileNames )
+{
+    // The locale is process wide, it is set for all the files
+    LOCALE_IO toggleIo;
+
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+    for( unsigned ii = 0; ii < aImages.size(); ii++ )
+        tasks.Run( boost::bind( readImageFile, aImages[ii], aFileNames[ii] ) );
+
+    tasks.Wait();
+}
+
+
+/**
+ * Function addImageItems
+ * displays the messages of an image which has read its file, and moves the items read to
+ * the layout.
+ * @return true if the file was read.
+ */
+static bool addImageItems( GERBVIEW_FRAME* aFrame, GERBER_IMAGE* aImage,
+                           const wxString& aTitle )
+{
+    // Display errors list
+    if( aImage->GetMessages().size() > 0 )
+    {
+        HTML_MESSAGE_BOX dlg( aFrame, aTitle );
+        dlg.ListSet( aImage->GetMessages() );
+        dlg.ShowModal();
+    }
+
+    if( !aImage->m_InUse )
+    {
+        // The layer is free again
+        aImage->m_FileName.Empty();
+        aImage->m_Drawings.DeleteAll();
+        return false;
+    }
+
+    aFrame->GetGerberLayout()->m_Drawings.Append( aImage->m_Drawings );
+    aFrame->GetGerberLayout()->InvalidateItemIndex();
+
+    return true;
+}
+
+
+/**
+ * Function nextLayerAfter
+ * @return the empty layer following the layer of @a aImage, or this layer if there is none.
+ */
+static int nextLayerAfter( GERBVIEW_FRAME* aFrame, GERBER_IMAGE* aImage )
+{
+    int layer = aFrame->getNextAvailableLayer( aImage->m_GraphicLayer );
+
+    return layer == NO_AVAILABLE_LAYERS ? aImage->m_GraphicLayer : layer;
+}
 
 
 void GERBVIEW_FRAME::OnGbrFileHistory( wxCommandEvent& event )
@@ -82,14 +172,13 @@ void GERBVIEW_FRAME::Files_io( wxCommandEvent& event )
     case ID_GERBVIEW_ERASE_ALL:
         Clear_DrawLayers( false );
         Zoom_Automatique( false );
-        m_canvas->Refresh();
+        RedrawCanvas( true );
         ClearMsgPanel();
         ReFillLayerWidget();
         break;
 
     case ID_GERBVIEW_LOAD_DRILL_FILE:
         LoadExcellonFiles( wxEmptyString );
-        m_canvas->Refresh();
         break;
 
     default:
@@ -172,11 +261,22 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
         m_mruPath = currentPath;
     }
 
-    // Read gerber files: each file is loaded on a new GerbView layer
+    // Read gerber files: each file is loaded on a new GerbView layer.  The layers are
+    // chosen first, then the files are read at once.
+    std::vector<GERBER_IMAGE*> images;
+    std::vector<wxString>      fileNames;
     int layer = getActiveLayer();
 
     for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
     {
+        if( layer == NO_AVAILABLE_LAYERS )
+        {
+            wxString msg = wxT( "No more empty available layers.\n"
+                                "The remaining gerber files will not be loaded." );
+            wxMessageBox( msg );
+            break;
+        }
+
         filename = filenamesList[ii];
 
         if( !filename.IsAbsolute() )
@@ -184,26 +284,51 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
 
         m_lastFileName = filename.GetFullPath();
 
-        setActiveLayer( layer, false );
+        GERBER_IMAGE* gerber = g_GERBER_List.GetGbrImage( layer );
 
-        if( Read_GERBER_File( filename.GetFullPath(), filename.GetFullPath() ) )
+        // A drill image does not read gerber files
+        if( gerber == NULL || dynamic_cast<EXCELLON_IMAGE*>( gerber ) )
         {
-            UpdateFileHistory( m_lastFileName );
+            gerber = new GERBER_IMAGE( this, layer );
+            g_GERBER_List.AddGbrImage( gerber, layer );
+        }
+
+        // The file name reserves the layer until the image reads the file
+        gerber->m_FileName = m_lastFileName;
+
+        images.push_back( gerber );
+        fileNames.push_back( m_lastFileName );
+
+        layer = getNextAvailableLayer( layer );
+    }
 
-            layer = getNextAvailableLayer( layer );
+    readImageFiles( images, fileNames );
 
-            if( layer == NO_AVAILABLE_LAYERS )
-            {
-                wxString msg = wxT( "No more empty available layers.\n"
-                                    "The remaining gerber files will not be loaded." );
-                wxMessageBox( msg );
-                break;
-            }
+    for( unsigned ii = 0; ii < images.size(); ii++ )
+    {
+        GERBER_IMAGE* gerber = images[ii];
+
+        if( !addImageItems( this, gerber, _( "Errors" ) ) )
+            continue;
 
-            setActiveLayer( layer, false );
+        UpdateFileHistory( gerber->m_FileName );
+
+        /* if the gerber file is only a RS274D file
+         * (i.e. without any aperture information), wran the user:
+         */
+        if( !gerber->m_Has_DCode )
+        {
+            wxString msg = _( "Warning: this file has no D-Code definition\n"
+                              "It is perhaps an old RS274D file\n"
+                              "Therefore the size of items is undefined" );
+            wxMessageBox( msg );
         }
     }
 
+    // The active layer is the next empty one
+    if( !images.empty() )
+        setActiveLayer( nextLayerAfter( this, images.back() ), false );
+
     Zoom_Automatique( false );
 
     // Synchronize layers tools with actual active layer:
@@ -211,6 +336,7 @@ bool GERBVIEW_FRAME::LoadGerberFiles( const wxString& aFullFileName )
     setActiveLayer( getActiveLayer() );
     m_LayersManager->UpdateLayerIcons();
     syncLayerBox();
+    RedrawCanvas( true );
     return true;
 }
 
@@ -256,11 +382,22 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
         m_mruPath = currentPath;
     }
 
-    // Read gerber files: each file is loaded on a new GerbView layer
+    // Read drill files: each file is loaded on a new GerbView layer.  The layers are
+    // chosen first, then the files are read at once.
+    std::vector<GERBER_IMAGE*> images;
+    std::vector<wxString>      fileNames;
     int layer = getActiveLayer();
 
     for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
     {
+        if( layer == NO_AVAILABLE_LAYERS )
+        {
+            wxString msg = wxT( "No more empty available layers.\n"
+                                "The remaining gerber files will not be loaded." );
+            wxMessageBox( msg );
+            break;
+        }
+
         filename = filenamesList[ii];
 
         if( !filename.IsAbsolute() )
@@ -268,27 +405,37 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 
         m_lastFileName = filename.GetFullPath();
 
-        setActiveLayer( layer, false );
+        GERBER_IMAGE* drill_Layer = g_GERBER_List.GetGbrImage( layer );
 
-        if( Read_EXCELLON_File( filename.GetFullPath() ) )
+        // Only a drill image reads drill files
+        if( dynamic_cast<EXCELLON_IMAGE*>( drill_Layer ) == NULL )
         {
-            // Update the list of recent drill files.
-            UpdateFileHistory( filename.GetFullPath(),  &m_drillFileHistory );
+            drill_Layer = new EXCELLON_IMAGE( this, layer );
+            g_GERBER_List.AddGbrImage( drill_Layer, layer );
+        }
 
-            layer = getNextAvailableLayer( layer );
+        // The file name reserves the layer until the image reads the file
+        drill_Layer->m_FileName = m_lastFileName;
 
-            if( layer == NO_AVAILABLE_LAYERS )
-            {
-                wxString msg = wxT( "No more empty available layers.\n"
-                                    "The remaining gerber files will not be loaded." );
-                wxMessageBox( msg );
-                break;
-            }
+        images.push_back( drill_Layer );
+        fileNames.push_back( m_lastFileName );
 
-            setActiveLayer( layer, false );
-        }
+        layer = getNextAvailableLayer( layer );
+    }
+
+    readImageFiles( images, fileNames );
+
+    for( unsigned ii = 0; ii < images.size(); ii++ )
+    {
+        // Update the list of recent drill files.
+        if( addImageItems( this, images[ii], _( "Files not found" ) ) )
+            UpdateFileHistory( images[ii]->m_FileName, &m_drillFileHistory );
     }
 
+    // The active layer is the next empty one
+    if( !images.empty() )
+        setActiveLayer( nextLayerAfter( this, images.back() ), false );
+
     Zoom_Automatique( false );
 
     // Synchronize layers tools with actual active layer:
@@ -296,6 +443,7 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
     setActiveLayer( getActiveLayer() );
     m_LayersManager->UpdateLayerIcons();
     syncLayerBox();
+    RedrawCanvas( true );
 
     return true;
 }
@@ -0,0 +1,332 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_compare.cpp
+ * @brief Comparison of two graphic layers, and the command which lists the changed areas.
+ */
+
+#include <algorithm>
+
+#include <fctsys.h>
+#include <common.h>
+#include <confirm.h>
+#include <html_messagebox.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
+
+#include <gerbview.h>
+#include <gerbview_frame.h>
+#include <class_gbr_layout.h>
+#include <class_GERBER.h>
+#include <gerber_compare.h>
+
+#include <boost/bind.hpp>
+
+#include <wx/choicdlg.h>
+#include <wx/textdlg.h>
+
+
+// The default size of a pixel, in mm
+#define COMPARE_DEFAULT_RESOLUTION  0.01
+
+
+GERBER_COMPARE::GERBER_COMPARE( GBR_LAYOUT* aLayout, int aLayerA, int aLayerB,
+                                int aResolution ) :
+    m_layerA( aLayout, aLayerA ),
+    m_layerB( aLayout, aLayerB ),
+    m_resolution( std::max( aResolution, 1 ) ),
+    m_tileCols( 0 ),
+    m_tileRows( 0 )
+{
+}
+
+
+int GERBER_COMPARE::Run()
+{
+    m_changedAreas.clear();
+    m_tileAreas.clear();
+    m_tileCols = m_tileRows = 0;
+
+    bool hasA = m_layerA.CollectItems();
+    bool hasB = m_layerB.CollectItems();
+
+    if( !hasA && !hasB )
+        return 0;
+
+    m_area = hasA ? m_layerA.GetArea() : m_layerB.GetArea();
+
+    if( hasA && hasB )
+        m_area.Merge( m_layerB.GetArea() );
+
+    // The grid covers the area, one more pixel for the items on its right and bottom edges
+    int tileSize = GERBER_RASTER_TILE_SIZE * m_resolution;
+
+    m_tileCols = m_area.GetWidth() / tileSize + 1;
+    m_tileRows = m_area.GetHeight() / tileSize + 1;
+
+    m_layerA.SetGrid( m_area.GetOrigin(), m_resolution, m_tileCols, m_tileRows );
+    m_layerB.SetGrid( m_area.GetOrigin(), m_resolution, m_tileCols, m_tileRows );
+
+    m_tileAreas.resize( m_tileCols * m_tileRows );
+
+    // Each tile writes its own areas only
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+    for( int tile = 0; tile < m_tileCols * m_tileRows; tile++ )
+    {
+        if( m_layerA.HasItems( tile ) || m_layerB.HasItems( tile ) )
+            tasks.Run( boost::bind( &GERBER_COMPARE::compareTile, this, tile ) );
+    }
+
+    tasks.Wait();
+
+    mergeAreas();
+
+    return m_changedAreas.size();
+}
+
+
+void GERBER_COMPARE::compareTile( int aTile )
+{
+    RASTER_TILE tileA = m_layerA.FillTile( aTile );
+    RASTER_TILE tileB = m_layerB.FillTile( aTile );
+    wxPoint     origin = tileA.m_origin;
+
+    // XOR the layers, reusing the pixels of the first one
+    std::vector<unsigned char>& diff = tileA.m_pixels;
+
+    for( unsigned ii = 0; ii < diff.size(); ii++ )
+        diff[ii] ^= tileB.m_pixels[ii];
+
+    // The bounding box of each group of 8-connected pixels, the pixels of a group being
+    // cleared while it is filled
+    std::vector<int>       stack;
+    std::vector<EDA_RECT>& areas = m_tileAreas[aTile];
+
+    for( int start = 0; start < (int) diff.size(); start++ )
+    {
+        if( !diff[start] )
+            continue;
+
+        int minCol = start % GERBER_RASTER_TILE_SIZE, maxCol = minCol;
+        int minRow = start / GERBER_RASTER_TILE_SIZE, maxRow = minRow;
+
+        diff[start] = 0;
+        stack.push_back( start );
+
+        while( !stack.empty() )
+        {
+            int pixel = stack.back();
+            int col = pixel % GERBER_RASTER_TILE_SIZE;
+            int row = pixel / GERBER_RASTER_TILE_SIZE;
+
+            stack.pop_back();
+
+            minCol = std::min( minCol, col );
+            maxCol = std::max( maxCol, col );
+            minRow = std::min( minRow, row );
+            maxRow = std::max( maxRow, row );
+
+            for( int dy = -1; dy <= 1; dy++ )
+            {
+                for( int dx = -1; dx <= 1; dx++ )
+                {
+                    int x = col + dx;
+                    int y = row + dy;
+
+                    if( x < 0 || y < 0 || x >= GERBER_RASTER_TILE_SIZE
+                        || y >= GERBER_RASTER_TILE_SIZE )
+                        continue;
+
+                    int neighbour = y * GERBER_RASTER_TILE_SIZE + x;
+
+                    if( diff[neighbour] )
+                    {
+                        diff[neighbour] = 0;
+                        stack.push_back( neighbour );
+                    }
+                }
+            }
+        }
+
+        areas.push_back( EDA_RECT( wxPoint( origin.x + minCol * m_resolution,
+                                            origin.y + minRow * m_resolution ),
+                                   wxSize( ( maxCol - minCol + 1 ) * m_resolution,
+                                           ( maxRow - minRow + 1 ) * m_resolution ) ) );
+    }
+}
+
+
+static bool compareAreaPositions( const EDA_RECT& aFirst, const EDA_RECT& aSecond )
+{
+    if( aFirst.GetY() != aSecond.GetY() )
+        return aFirst.GetY() < aSecond.GetY();
+
+    return aFirst.GetX() < aSecond.GetX();
+}
+
+
+void GERBER_COMPARE::mergeAreas()
+{
+    // Only the areas which touch a tile border can be merged with the areas of the other
+    // tiles: the groups of pixels found in a tile are not connected
+    std::vector<EDA_RECT> borderAreas;
+    int tileSize = GERBER_RASTER_TILE_SIZE * m_resolution;
+
+    for( unsigned tile = 0; tile < m_tileAreas.size(); tile++ )
+    {
+        EDA_RECT inner( m_layerA.GetTileOrigin( tile ), wxSize( tileSize, tileSize ) );
+
+        inner.Inflate( -m_resolution );
+
+        for( unsigned ii = 0; ii < m_tileAreas[tile].size(); ii++ )
+        {
+            const EDA_RECT& area = m_tileAreas[tile][ii];
+
+            if( area.GetX() < inner.GetX() || area.GetY() < inner.GetY()
+                || area.GetRight() > inner.GetRight() || area.GetBottom() > inner.GetBottom() )
+                borderAreas.push_back( area );
+            else
+                m_changedAreas.push_back( area );
+        }
+    }
+
+    m_tileAreas.clear();
+
+    // Merge the border areas which touch, including by a corner, until none is merged
+    bool merged = true;
+
+    while( merged )
+    {
+        merged = false;
+
+        for( unsigned ii = 0; ii < borderAreas.size(); ii++ )
+        {
+            for( unsigned jj = ii + 1; jj < borderAreas.size(); )
+            {
+                EDA_RECT inflated = borderAreas[jj];
+
+                inflated.Inflate( 1 );
+
+                if( inflated.Intersects( borderAreas[ii] ) )
+                {
+                    borderAreas[ii].Merge( borderAreas[jj] );
+                    borderAreas.erase( borderAreas.begin() + jj );
+                    merged = true;
+                }
+                else
+                {
+                    jj++;
+                }
+            }
+        }
+    }
+
+    m_changedAreas.insert( m_changedAreas.end(), borderAreas.begin(), borderAreas.end() );
+    std::sort( m_changedAreas.begin(), m_changedAreas.end(), compareAreaPositions );
+}
+
+
+void GERBVIEW_FRAME::OnCompareLayers( wxCommandEvent& event )
+{
+    int layerA = getActiveLayer();
+
+    if( !g_GERBER_List.IsUsed( layerA ) )
+    {
+        DisplayInfoMessage( this, _( "The active layer does not contain any data" ) );
+        return;
+    }
+
+    wxArrayString   names;
+    std::vector<int> layers;
+
+    for( int layer = 0; layer < GERBER_DRAWLAYERS_COUNT; ++layer )
+    {
+        if( layer != layerA && g_GERBER_List.IsUsed( layer ) )
+        {
+            names.Add( g_GERBER_List.GetDisplayName( layer ) );
+            layers.push_back( layer );
+        }
+    }
+
+    if( layers.empty() )
+    {
+        DisplayInfoMessage( this, _( "There is no other layer to compare with" ) );
+        return;
+    }
+
+    wxSingleChoiceDialog choice( this, _( "Compare the active layer with:" ),
+                                 _( "Compare Layers" ), names );
+
+    if( choice.ShowModal() != wxID_OK )
+        return;
+
+    int layerB = layers[choice.GetSelection()];
+
+    wxString text = wxGetTextFromUser( _( "Pixel size (mm):" ), _( "Compare Layers" ),
+                                       wxString::Format( wxT( "%g" ),
+                                                         COMPARE_DEFAULT_RESOLUTION ),
+                                       this );
+    double   resolution;
+
+    if( text.IsEmpty() )
+        return;
+
+    if( !text.ToDouble( &resolution ) || resolution <= 0 )
+    {
+        DisplayError( this, _( "Invalid pixel size" ) );
+        return;
+    }
+
+    GERBER_COMPARE compare( GetGerberLayout(), layerA, layerB,
+                            KiROUND( resolution * IU_PER_MM ) );
+    int            count;
+
+    {
+        wxBusyCursor dummy;
+        count = compare.Run();
+    }
+
+    wxArrayString list;
+
+    if( count == 0 )
+        list.Add( _( "The layers are identical at this resolution" ) );
+
+    for( int ii = 0; ii < count; ii++ )
+    {
+        const EDA_RECT& area = compare.GetChangedAreas()[ii];
+
+        list.Add( wxString::Format( _( "Changed area %d: (%.3f, %.3f) to (%.3f, %.3f) mm" ),
+                                    ii + 1,
+                                    area.GetX() / IU_PER_MM, area.GetY() / IU_PER_MM,
+                                    area.GetRight() / IU_PER_MM,
+                                    area.GetBottom() / IU_PER_MM ) );
+    }
+
+    HTML_MESSAGE_BOX dlg( this, wxString::Format( _( "Compare %s with %s" ),
+                                                  GetChars( g_GERBER_List.GetDisplayName( layerA ) ),
+                                                  GetChars( g_GERBER_List.GetDisplayName( layerB ) ) ) );
+    dlg.ListSet( list );
+    dlg.ShowModal();
+}
@@ -0,0 +1,97 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_compare.h
+ * @brief Class GERBER_COMPARE to find the differences between two graphic layers
+ */
+
+#ifndef GERBER_COMPARE_H
+#define GERBER_COMPARE_H
+
+#include <vector>
+
+#include <class_eda_rect.h>
+#include <gerber_raster.h>
+
+class GBR_LAYOUT;
+
+
+/**
+ * Class GERBER_COMPARE
+ * compares two graphic layers of a layout: both layers are rasterized at a given
+ * resolution, the images are XORed, and the areas of the pixels which differ are listed.
+ * The layers are rasterized by GERBER_RASTER_LAYER in tiles of GERBER_RASTER_TILE_SIZE
+ * pixels, so the memory used does not depend on the size of the layers.  The tiles are
+ * compared at once on the threads of the process.
+ */
+class GERBER_COMPARE
+{
+public:
+    /**
+     * Constructor GERBER_COMPARE
+     * @param aLayout = the layout of the items
+     * @param aLayerA, aLayerB = the graphic layers to compare
+     * @param aResolution = the size of a pixel, in internal units
+     */
+    GERBER_COMPARE( GBR_LAYOUT* aLayout, int aLayerA, int aLayerB, int aResolution );
+
+    /**
+     * Function Run
+     * compares the layers.
+     * @return the number of changed areas, see GetChangedAreas()
+     */
+    int Run();
+
+    /**
+     * Function GetChangedAreas
+     * @return the bounding boxes, in A,B axis, of the groups of touching pixels which
+     * differ between the layers, the groups which touch across the tile borders being
+     * merged.  They are sorted top to bottom, then left to right.
+     */
+    const std::vector<EDA_RECT>& GetChangedAreas() const { return m_changedAreas; }
+
+    /**
+     * Function GetTileCount
+     * @return the number of tiles examined by the last Run().
+     */
+    int GetTileCount() const { return m_tileCols * m_tileRows; }
+
+private:
+    GERBER_RASTER_LAYER     m_layerA;
+    GERBER_RASTER_LAYER     m_layerB;
+    int                     m_resolution;
+    EDA_RECT                m_area;                 // the area compared, in A,B axis
+    int                     m_tileCols;
+    int                     m_tileRows;
+    std::vector< std::vector<EDA_RECT> > m_tileAreas;   // changed areas, by tile
+    std::vector<EDA_RECT>   m_changedAreas;
+
+    // rasterize both layers in tile aTile, and store its changed areas
+    void compareTile( int aTile );
+
+    // merge the changed areas of the tiles in m_changedAreas
+    void mergeAreas();
+};
+
+#endif  // GERBER_COMPARE_H
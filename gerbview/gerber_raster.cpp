@@ -0,0 +1,461 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_raster.cpp
+ * @brief Rasterization of the graphic layers in tiles of pixels
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <fctsys.h>
+#include <common.h>
+#include <macros.h>
+#include <trigo.h>
+
+#include <gerbview.h>
+#include <class_gbr_layout.h>
+#include <class_gerber_draw_item.h>
+#include <class_GERBER.h>
+#include <dcode.h>
+#include <class_aperture_macro.h>
+#include <gerber_raster.h>
+
+
+// The number of segments used to approximate a circle
+#define RASTER_CIRCLE_SEGMENTS  32
+
+
+// Start a new shape, with an empty contour
+static std::vector<wxPoint>& newShape( RASTER_SHAPES& aShapes, bool aDark )
+{
+    aShapes.push_back( RASTER_SHAPE() );
+    aShapes.back().m_dark = aDark;
+    aShapes.back().m_contours.resize( 1 );
+
+    return aShapes.back().m_contours.back();
+}
+
+
+// Append the points of an arc, angles in radians
+static void appendArc( std::vector<wxPoint>& aContour, const wxPoint& aCenter, double aRadius,
+                       double aStartAngle, double aEndAngle )
+{
+    int steps = KiROUND( std::abs( aEndAngle - aStartAngle ) * RASTER_CIRCLE_SEGMENTS
+                         / ( 2 * M_PI ) );
+
+    steps = std::max( steps, 2 );
+
+    for( int ii = 0; ii <= steps; ii++ )
+    {
+        double angle = aStartAngle + ( aEndAngle - aStartAngle ) * ii / steps;
+
+        aContour.push_back( wxPoint( aCenter.x + KiROUND( aRadius * cos( angle ) ),
+                                     aCenter.y + KiROUND( aRadius * sin( angle ) ) ) );
+    }
+}
+
+
+static void addDisc( RASTER_SHAPES& aShapes, const wxPoint& aCenter, int aRadius, bool aDark )
+{
+    if( aRadius > 0 )
+        appendArc( newShape( aShapes, aDark ), aCenter, aRadius, 0, 2 * M_PI );
+}
+
+
+static void addRing( RASTER_SHAPES& aShapes, const wxPoint& aCenter, int aOuterRadius,
+                     int aInnerRadius, bool aDark )
+{
+    if( aOuterRadius <= 0 )
+        return;
+
+    addDisc( aShapes, aCenter, aOuterRadius, aDark );
+
+    // Both circles are in the same shape: the even-odd rule fills the ring only
+    if( aInnerRadius > 0 )
+    {
+        std::vector< std::vector<wxPoint> >& contours = aShapes.back().m_contours;
+
+        contours.resize( 2 );
+        appendArc( contours.back(), aCenter, aInnerRadius, 0, 2 * M_PI );
+    }
+}
+
+
+// A segment with round ends
+static void addSegment( RASTER_SHAPES& aShapes, const wxPoint& aStart, const wxPoint& aEnd,
+                        int aWidth, bool aDark )
+{
+    if( aStart == aEnd )
+    {
+        addDisc( aShapes, aStart, aWidth / 2, aDark );
+        return;
+    }
+
+    if( aWidth <= 0 )
+        return;
+
+    double angle = atan2( (double) ( aEnd.y - aStart.y ), (double) ( aEnd.x - aStart.x ) );
+    std::vector<wxPoint>& contour = newShape( aShapes, aDark );
+
+    appendArc( contour, aEnd, aWidth / 2.0, angle - M_PI / 2, angle + M_PI / 2 );
+    appendArc( contour, aStart, aWidth / 2.0, angle + M_PI / 2, angle + 3 * M_PI / 2 );
+}
+
+
+// A polygon in X,Y axis, moved by aOffset
+static void addPolygon( RASTER_SHAPES& aShapes, const GERBER_DRAW_ITEM* aItem,
+                        const std::vector<wxPoint>& aCorners, const wxPoint& aOffset,
+                        bool aDark )
+{
+    if( aCorners.size() < 3 )
+        return;
+
+    std::vector<wxPoint>& contour = newShape( aShapes, aDark );
+
+    contour.reserve( aCorners.size() );
+
+    for( unsigned ii = 0; ii < aCorners.size(); ii++ )
+        contour.push_back( aItem->GetABPosition( aCorners[ii] + aOffset ) );
+}
+
+
+/**
+ * Function itemShapes
+ * converts a copy of an item to filled shapes in A,B axis, as they are drawn by
+ * GERBVIEW_PAINTER in filled mode.
+ * The convertions cached by the items and the D_CODEs (segments drawn with a rectangular
+ * pen, polygons of the flashed shapes, shapes of the aperture macros) are done by the
+ * first call for an item: once done for all the items, they are only read, and the
+ * function is reentrant.  It does not select the instance of the item.
+ * @param aItem = the item, which instance 0 is selected
+ * @param aOffset = the offset of the copy, in X,Y axis, see GetInstanceOffset()
+ * @param aShapes = the buffer to store the shapes
+ */
+static void itemShapes( GERBER_DRAW_ITEM* aItem, const wxPoint& aOffset, RASTER_SHAPES& aShapes )
+{
+    D_CODE* dcode = aItem->GetDcodeDescr();
+    bool    isDark = !( aItem->GetLayerPolarity() ^ aItem->m_imageParams->m_ImageNegative );
+    wxPoint start = aItem->GetABPosition( aItem->m_Start + aOffset );
+    int     width = aItem->m_Size.x;
+
+    aShapes.clear();
+
+    switch( aItem->m_Shape )
+    {
+    case GBR_POLYGON:
+        addPolygon( aShapes, aItem, aItem->m_PolyCorners, aOffset, isDark );
+        break;
+
+    case GBR_CIRCLE:
+    {
+        int radius = KiROUND( GetLineLength( aItem->m_Start, aItem->m_End ) );
+
+        addRing( aShapes, start, radius + width / 2, radius - width / 2, isDark );
+    }
+        break;
+
+    case GBR_ARC:
+    {
+        // As in GERBVIEW_PAINTER: from m_End to m_Start with increasing angles in A,B axis
+        wxPoint center = aItem->GetABPosition( aItem->m_ArcCentre + aOffset );
+        wxPoint end = aItem->GetABPosition( aItem->m_End + aOffset );
+        double  startAngle = atan2( (double) ( end.y - center.y ), (double) ( end.x - center.x ) );
+        double  endAngle = atan2( (double) ( start.y - center.y ),
+                                  (double) ( start.x - center.x ) );
+
+        if( endAngle <= startAngle )
+            endAngle += 2 * M_PI;
+
+        std::vector<wxPoint> path;
+
+        appendArc( path, center, GetLineLength( start, center ), startAngle, endAngle );
+
+        for( unsigned ii = 1; ii < path.size(); ii++ )
+            addSegment( aShapes, path[ii - 1], path[ii], width, isDark );
+    }
+        break;
+
+    case GBR_SEGMENT:
+        // A line plotted with a rectangular pen is a polygon
+        if( dcode && dcode->m_Shape == APT_RECT )
+        {
+            if( aItem->m_PolyCorners.size() == 0 )
+                aItem->ConvertSegmentToPolygon();
+
+            addPolygon( aShapes, aItem, aItem->m_PolyCorners, aOffset, isDark );
+        }
+        else
+        {
+            addSegment( aShapes, start, aItem->GetABPosition( aItem->m_End + aOffset ),
+                        width, isDark );
+        }
+        break;
+
+    case GBR_SPOT_CIRCLE:
+    case GBR_SPOT_RECT:
+    case GBR_SPOT_OVAL:
+    case GBR_SPOT_POLY:
+    case GBR_SPOT_MACRO:
+        if( dcode == NULL )
+        {
+            addDisc( aShapes, start, width / 2, isDark );
+            break;
+        }
+
+        if( dcode->m_Shape == APT_MACRO )
+        {
+            APERTURE_MACRO* macro = dcode->GetMacro();
+
+            if( macro == NULL )
+                break;
+
+            const AM_SHAPES& shapes = dcode->GetMacroShapes();
+
+            for( unsigned ii = 0; ii < shapes.size(); ii++ )
+            {
+                const AM_SHAPE& shape = shapes[ii];
+                bool exposure = macro->primitives[shape.m_Primitive].mapExposure( aItem );
+                bool dark = isDark == ( exposure != shape.m_AltColor );
+
+                if( shape.m_Radius > 0 )
+                {
+                    wxPoint center = aItem->GetABPosition( shape.m_Center + aItem->m_Start +
+                                                           aOffset );
+
+                    addRing( aShapes, center, shape.m_Radius,
+                             shape.m_PenWidth ? shape.m_Radius - shape.m_PenWidth : 0, dark );
+                }
+                else
+                {
+                    addPolygon( aShapes, aItem, shape.m_Corners, aItem->m_Start + aOffset,
+                                dark );
+                }
+            }
+        }
+        else if( dcode->m_Shape == APT_CIRCLE && dcode->m_DrillShape == APT_DEF_NO_HOLE )
+        {
+            addDisc( aShapes, start, dcode->m_Size.x / 2, isDark );
+        }
+        else
+        {
+            addPolygon( aShapes, aItem, dcode->GetShapePolygon(), aItem->m_Start + aOffset,
+                        isDark );
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+// Merge the area of a shape to aArea, which is set by the first point when aEmpty is true
+static void mergeShapeArea( const RASTER_SHAPE& aShape, EDA_RECT& aArea, bool& aEmpty )
+{
+    for( unsigned ii = 0; ii < aShape.m_contours.size(); ii++ )
+    {
+        const std::vector<wxPoint>& contour = aShape.m_contours[ii];
+
+        for( unsigned jj = 0; jj < contour.size(); jj++ )
+        {
+            if( aEmpty )
+                aArea = EDA_RECT( contour[jj], wxSize( 0, 0 ) );
+            else
+                aArea.Merge( contour[jj] );
+
+            aEmpty = false;
+        }
+    }
+}
+
+
+int RASTER_TILE::firstPixel( double aCoord, int aOrigin ) const
+{
+    return (int) ceil( ( aCoord - aOrigin ) / m_resolution - 0.5 );
+}
+
+
+void RASTER_TILE::Fill( const RASTER_SHAPE& aShape )
+{
+    EDA_RECT area;
+    bool     empty = true;
+
+    mergeShapeArea( aShape, area, empty );
+
+    int firstRow = std::max( firstPixel( area.GetY(), m_origin.y ), 0 );
+    int lastRow = std::min( firstPixel( area.GetBottom(), m_origin.y ),
+                            GERBER_RASTER_TILE_SIZE );
+    unsigned char value = aShape.m_dark ? 1 : 0;
+    std::vector<double> crossings;
+
+    for( int row = firstRow; row < lastRow; row++ )
+    {
+        double y = m_origin.y + ( row + 0.5 ) * m_resolution;
+
+        crossings.clear();
+
+        for( unsigned ii = 0; ii < aShape.m_contours.size(); ii++ )
+        {
+            const std::vector<wxPoint>& contour = aShape.m_contours[ii];
+
+            for( unsigned jj = 0; jj < contour.size(); jj++ )
+            {
+                const wxPoint& a = contour[jj];
+                const wxPoint& b = contour[( jj + 1 ) % contour.size()];
+
+                if( ( a.y <= y ) != ( b.y <= y ) )
+                    crossings.push_back( a.x + ( y - a.y ) * ( b.x - a.x ) / ( b.y - a.y ) );
+            }
+        }
+
+        std::sort( crossings.begin(), crossings.end() );
+
+        unsigned char* line = &m_pixels[row * GERBER_RASTER_TILE_SIZE];
+
+        for( unsigned ii = 0; ii + 1 < crossings.size(); ii += 2 )
+        {
+            int first = std::max( firstPixel( crossings[ii], m_origin.x ), 0 );
+            int last = std::min( firstPixel( crossings[ii + 1], m_origin.x ),
+                                 GERBER_RASTER_TILE_SIZE );
+
+            if( first < last )
+                std::fill( line + first, line + last, value );
+        }
+    }
+}
+
+
+GERBER_RASTER_LAYER::GERBER_RASTER_LAYER( GBR_LAYOUT* aLayout, int aLayer ) :
+    m_layout( aLayout ),
+    m_layer( aLayer ),
+    m_resolution( 1 ),
+    m_cols( 0 )
+{
+}
+
+
+bool GERBER_RASTER_LAYER::CollectItems()
+{
+    RASTER_SHAPES shapes;
+    bool          empty = true;
+
+    m_items.clear();
+    m_boxes.clear();
+    m_tiles.clear();
+
+    for( GERBER_DRAW_ITEM* item = m_layout->m_Drawings; item; item = item->Next() )
+    {
+        if( item->GetLayer() != m_layer )
+            continue;
+
+        for( int ii = 0; ii < item->GetInstanceCount(); ii++ )
+        {
+            // Also does the convertions cached by the item and its D_CODE, before the
+            // tiles are filled on other threads
+            itemShapes( item, item->GetInstanceOffset( ii ), shapes );
+
+            if( shapes.empty() )
+                continue;
+
+            ITEM_REF ref = { item, ii };
+            EDA_RECT box;
+            bool     emptyBox = true;
+
+            for( unsigned jj = 0; jj < shapes.size(); jj++ )
+                mergeShapeArea( shapes[jj], box, emptyBox );
+
+            if( empty )
+                m_area = box;
+            else
+                m_area.Merge( box );
+
+            empty = false;
+            m_items.push_back( ref );
+            m_boxes.push_back( box );
+        }
+    }
+
+    return !empty;
+}
+
+
+void GERBER_RASTER_LAYER::SetGrid( const wxPoint& aOrigin, int aResolution, int aCols,
+                                   int aRows )
+{
+    int tileSize = GERBER_RASTER_TILE_SIZE * aResolution;
+
+    m_origin = aOrigin;
+    m_resolution = aResolution;
+    m_cols = aCols;
+    m_tiles.assign( aCols * aRows, std::vector<int>() );
+
+    for( unsigned ii = 0; ii < m_boxes.size(); ii++ )
+    {
+        const EDA_RECT& box = m_boxes[ii];
+
+        if( box.GetRight() < aOrigin.x || box.GetBottom() < aOrigin.y )
+            continue;
+
+        int firstCol = std::max( box.GetX() - aOrigin.x, 0 ) / tileSize;
+        int lastCol = std::min( ( box.GetRight() - aOrigin.x ) / tileSize, aCols - 1 );
+        int firstRow = std::max( box.GetY() - aOrigin.y, 0 ) / tileSize;
+        int lastRow = std::min( ( box.GetBottom() - aOrigin.y ) / tileSize, aRows - 1 );
+
+        for( int row = firstRow; row <= lastRow; row++ )
+        {
+            for( int col = firstCol; col <= lastCol; col++ )
+                m_tiles[row * aCols + col].push_back( ii );
+        }
+    }
+}
+
+
+wxPoint GERBER_RASTER_LAYER::GetTileOrigin( int aTile ) const
+{
+    int tileSize = GERBER_RASTER_TILE_SIZE * m_resolution;
+
+    return wxPoint( m_origin.x + ( aTile % m_cols ) * tileSize,
+                    m_origin.y + ( aTile / m_cols ) * tileSize );
+}
+
+
+RASTER_TILE GERBER_RASTER_LAYER::FillTile( int aTile ) const
+{
+    RASTER_TILE             tile( GetTileOrigin( aTile ), m_resolution );
+    RASTER_SHAPES           shapes;
+    const std::vector<int>& refs = m_tiles[aTile];
+
+    for( unsigned ii = 0; ii < refs.size(); ii++ )
+    {
+        const ITEM_REF& ref = m_items[refs[ii]];
+
+        itemShapes( ref.m_item, ref.m_item->GetInstanceOffset( ref.m_instance ), shapes );
+
+        for( unsigned jj = 0; jj < shapes.size(); jj++ )
+            tile.Fill( shapes[jj] );
+    }
+
+    return tile;
+}
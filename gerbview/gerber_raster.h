@@ -0,0 +1,160 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_raster.h
+ * @brief Rasterization of the graphic layers in tiles of pixels
+ */
+
+#ifndef GERBER_RASTER_H
+#define GERBER_RASTER_H
+
+#include <vector>
+
+#include <class_eda_rect.h>
+
+class GBR_LAYOUT;
+class GERBER_DRAW_ITEM;
+
+
+/// The size in pixels of the square tiles the layers are rasterized in
+#define GERBER_RASTER_TILE_SIZE 1024
+
+
+/// A filled shape of an item, in A,B axis: its contours are filled with the even-odd rule
+struct RASTER_SHAPE
+{
+    bool                                m_dark;
+    std::vector< std::vector<wxPoint> > m_contours;
+};
+
+typedef std::vector<RASTER_SHAPE> RASTER_SHAPES;
+
+
+/**
+ * Struct RASTER_TILE
+ * is a square tile of GERBER_RASTER_TILE_SIZE pixels, one byte per pixel, 1 for the dark
+ * pixels.  A pixel is dark when its center is inside a dark shape.
+ */
+struct RASTER_TILE
+{
+    wxPoint                     m_origin;       // A,B position of the first pixel corner
+    int                         m_resolution;   // the size of a pixel, in internal units
+    std::vector<unsigned char>  m_pixels;       // row by row
+
+    RASTER_TILE( const wxPoint& aOrigin, int aResolution ) :
+        m_origin( aOrigin ),
+        m_resolution( aResolution ),
+        m_pixels( GERBER_RASTER_TILE_SIZE * GERBER_RASTER_TILE_SIZE, 0 )
+    {
+    }
+
+    /**
+     * Function Fill
+     * sets the pixels whose center is inside a shape, to 1 for a dark shape, else to 0,
+     * with a scanline filler.
+     */
+    void Fill( const RASTER_SHAPE& aShape );
+
+private:
+    // the first pixel whose center is at or after aCoord, along an axis
+    int firstPixel( double aCoord, int aOrigin ) const;
+};
+
+
+/**
+ * Class GERBER_RASTER_LAYER
+ * rasterizes the items of a graphic layer in a grid of tiles, each tile only from the
+ * items it overlaps.  The items are filled as by GERBVIEW_PAINTER in filled mode, and in
+ * the order of the items list as on the legacy canvas: the clear items erase the items
+ * drawn before them.
+ *
+ * Once the items are collected, FillTile() only reads the items and their D_CODEs, so
+ * the tiles can be filled at once on several threads.
+ */
+class GERBER_RASTER_LAYER
+{
+public:
+    GERBER_RASTER_LAYER( GBR_LAYOUT* aLayout, int aLayer );
+
+    /**
+     * Function CollectItems
+     * finds the items of the layer and their filled area, and does the convertions
+     * cached by the items and their D_CODEs.
+     * @return false if the layer has nothing to fill
+     */
+    bool CollectItems();
+
+    /**
+     * Function GetArea
+     * @return the area, in A,B axis, filled by the items found by CollectItems().
+     */
+    const EDA_RECT& GetArea() const { return m_area; }
+
+    /**
+     * Function SetGrid
+     * sets the grid of tiles, and finds the items which overlap each tile.
+     * @param aOrigin = the A,B position of the first pixel corner of the first tile
+     * @param aResolution = the size of a pixel, in internal units
+     * @param aCols, aRows = the size of the grid, in tiles, the tiles being stored
+     *                       row by row
+     */
+    void SetGrid( const wxPoint& aOrigin, int aResolution, int aCols, int aRows );
+
+    /**
+     * Function HasItems
+     * @return true if at least one item overlaps the tile aTile.
+     */
+    bool HasItems( int aTile ) const { return !m_tiles[aTile].empty(); }
+
+    /**
+     * Function FillTile
+     * @return the pixels of the tile aTile of the grid.
+     */
+    RASTER_TILE FillTile( int aTile ) const;
+
+    /**
+     * Function GetTileOrigin
+     * @return the A,B position of the first pixel corner of the tile aTile.
+     */
+    wxPoint GetTileOrigin( int aTile ) const;
+
+private:
+    struct ITEM_REF
+    {
+        GERBER_DRAW_ITEM*   m_item;
+        int                 m_instance;     // the copy of a step and repeat block
+    };
+
+    GBR_LAYOUT*                     m_layout;
+    int                             m_layer;
+    EDA_RECT                        m_area;
+    std::vector<ITEM_REF>           m_items;
+    std::vector<EDA_RECT>           m_boxes;    // the filled area of each of m_items
+    wxPoint                         m_origin;
+    int                             m_resolution;
+    int                             m_cols;
+    std::vector< std::vector<int> > m_tiles;    // indexes in m_items, by tile
+};
+
+#endif  // GERBER_RASTER_H
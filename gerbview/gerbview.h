@@ -38,6 +38,12 @@
 */
 #define GERBER_BUFZ     4000
 
+/**
+* maximum length of a line read from a gerber file.  Some exporters write a whole region,
+* or a whole file, on one line: the line buffer of the reader grows up to this size.
+*/
+#define GERBER_LINE_MAX ( 64 * 1024 * 1024 )
+
 /// List of page sizes
 extern const wxChar* g_GerberPageSizeList[8];
 
@@ -0,0 +1,135 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+
+#include <gerbview_draw_panel_gal.h>
+#include <gerbview_painter.h>
+#include <gerbview_frame.h>
+#include <class_gbr_layout.h>
+#include <class_gerber_draw_item.h>
+
+#include <view/view.h>
+#include <gal/graphics_abstraction_layer.h>
+
+
+GERBVIEW_DRAW_PANEL_GAL::GERBVIEW_DRAW_PANEL_GAL( wxWindow* aParentWindow, wxWindowID aWindowId,
+                                                  const wxPoint& aPosition, const wxSize& aSize,
+                                                  GAL_TYPE aGalType ) :
+EDA_DRAW_PANEL_GAL( aParentWindow, aWindowId, aPosition, aSize, aGalType )
+{
+    m_painter = new KIGFX::GERBVIEW_PAINTER( m_gal );
+    m_view->SetPainter( m_painter );
+
+    // The GAL was created by the base class, before LoadGalSettings() could be overridden
+    setWorldUnitLength();
+
+    // Each gerber draw layer is a cached group.  As on the legacy canvas, the first layers
+    // are displayed over the last ones, and the active layer over all of them.
+    for( int layer = 0; layer < GERBER_DRAWLAYERS_COUNT; ++layer )
+    {
+        m_view->SetLayerTarget( layer, KIGFX::TARGET_CACHED );
+        m_view->SetLayerOrder( layer, layer );
+    }
+
+    loadSettings();
+}
+
+
+GERBVIEW_DRAW_PANEL_GAL::~GERBVIEW_DRAW_PANEL_GAL()
+{
+}
+
+
+void GERBVIEW_DRAW_PANEL_GAL::DisplayLayout( const GBR_LAYOUT* aLayout )
+{
+    m_view->Clear();
+
+    // The items are collected, to be added to the view at once
+    std::vector<KIGFX::VIEW_ITEM*> items;
+
+    for( GERBER_DRAW_ITEM* item = aLayout->m_Drawings; item; item = item->Next() )
+        items.push_back( item );
+
+    loadSettings();
+    m_view->AddItems( items );
+}
+
+
+void GERBVIEW_DRAW_PANEL_GAL::SyncSettings()
+{
+    loadSettings();
+
+    // The colors and the filled modes are stored in the cached groups
+    m_view->RecacheAllItems();
+    m_view->MarkDirty();
+}
+
+
+bool GERBVIEW_DRAW_PANEL_GAL::LoadGalSettings()
+{
+    setWorldUnitLength();
+
+    return EDA_DRAW_PANEL_GAL::LoadGalSettings();
+}
+
+
+void GERBVIEW_DRAW_PANEL_GAL::OnShow()
+{
+    SyncSettings();
+}
+
+
+void GERBVIEW_DRAW_PANEL_GAL::loadSettings()
+{
+    GERBVIEW_FRAME* frame = dynamic_cast<GERBVIEW_FRAME*>( GetParentEDAFrame() );
+
+    if( !frame )
+        return;
+
+    KIGFX::GERBVIEW_RENDER_SETTINGS* rs;
+    rs = static_cast<KIGFX::GERBVIEW_RENDER_SETTINGS*>( m_view->GetPainter()->GetSettings() );
+
+    for( int layer = 0; layer < GERBER_DRAWLAYERS_COUNT; ++layer )
+    {
+        m_view->SetLayerVisible( layer, frame->IsLayerVisible( layer ) );
+        rs->SetLayerColor( layer, rs->TranslateColor( frame->GetLayerColor( layer ) ) );
+    }
+
+    KIGFX::COLOR4D background = rs->TranslateColor( frame->GetDrawBgColor() );
+    background.a = 1.0;
+
+    rs->SetBackgroundColor( background );
+    rs->SetNegativeColor( rs->TranslateColor( frame->GetNegativeItemsColor() ) );
+    rs->SetGridColor( rs->TranslateColor( frame->GetGridColor() ) );
+    rs->LoadDisplayOptions( &frame->m_DisplayOptions );
+
+    SetTopLayer( (LAYER_ID) frame->getActiveLayer() );
+}
+
+
+void GERBVIEW_DRAW_PANEL_GAL::setWorldUnitLength()
+{
+    // GerbView IU is 10 nanometers
+    m_gal->SetWorldUnitLength( 10.0 / KIGFX::GAL::METRIC_UNIT_LENGTH * 2.54 );
+}
@@ -50,6 +50,8 @@
 #include <class_DCodeSelectionbox.h>
 #include <class_gerbview_layer_widget.h>
 #include <class_gbr_screen.h>
+#include <gerbview_draw_panel_gal.h>
+#include <view/view.h>
 
 
 // Config keywords
@@ -57,6 +59,33 @@ static const wxString   cfgShowPageSizeOption( wxT( "PageSizeOpt" ) );
 static const wxString   cfgShowDCodes( wxT( "ShowDCodesOpt" ) );
 static const wxString   cfgShowNegativeObjects( wxT( "ShowNegativeObjectsOpt" ) );
 static const wxString   cfgShowBorderAndTitleBlock( wxT( "ShowBorderAndTitleBlock" ) );
+static const wxString   cfgCanvasType( wxT( "canvas_type" ) );
+
+
+static EDA_DRAW_PANEL_GAL::GAL_TYPE loadCanvasTypeSetting()
+{
+    EDA_DRAW_PANEL_GAL::GAL_TYPE canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE;
+    wxConfigBase* cfg = Kiface().KifaceSettings();
+
+    if( cfg )
+        canvasType = (EDA_DRAW_PANEL_GAL::GAL_TYPE) cfg->ReadLong( cfgCanvasType,
+                                                                   EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE );
+
+    if( canvasType < EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE
+            || canvasType >= EDA_DRAW_PANEL_GAL::GAL_TYPE_LAST )
+        canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE;
+
+    return canvasType;
+}
+
+
+static void saveCanvasTypeSetting( EDA_DRAW_PANEL_GAL::GAL_TYPE aCanvasType )
+{
+    wxConfigBase* cfg = Kiface().KifaceSettings();
+
+    if( cfg )
+        cfg->Write( cfgCanvasType, (long) aCanvasType );
+}
 
 
 GERBVIEW_FRAME::GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent ):
@@ -97,6 +126,10 @@ GERBVIEW_FRAME::GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent ):
 
     SetScreen( new GBR_SCREEN( GetPageSettings().GetSizeIU() ) );
 
+    // Create the GAL canvas, used once a GAL backend is selected
+    SetGalCanvas( new GERBVIEW_DRAW_PANEL_GAL( this, -1, wxPoint( 0, 0 ), m_FrameSize,
+                                               EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE ) );
+
     // Create the PCB_LAYER_WIDGET *after* SetLayout():
     wxFont  font = wxSystemSettings::GetFont( wxSYS_DEFAULT_GUI_FONT );
     int     pointSize       = font.GetPointSize();
@@ -163,6 +196,10 @@ GERBVIEW_FRAME::GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent ):
         m_auimgr.AddPane( m_canvas,
                           wxAuiPaneInfo().Name( wxT( "DrawFrame" ) ).CentrePane() );
 
+    if( GetGalCanvas() )
+        m_auimgr.AddPane( (wxWindow*) GetGalCanvas(),
+                          wxAuiPaneInfo().Name( wxT( "DrawFrameGal" ) ).CentrePane().Hide() );
+
     if( m_messagePanel )
         m_auimgr.AddPane( m_messagePanel,
                           wxAuiPaneInfo( mesg ).Name( wxT( "MsgPanel" ) ).Bottom().Layer( 10 ) );
@@ -173,6 +210,14 @@ GERBVIEW_FRAME::GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent ):
 
     setActiveLayer( 0, true );
     Zoom_Automatique( false );           // Gives a default zoom value
+
+    EDA_DRAW_PANEL_GAL::GAL_TYPE canvasType = loadCanvasTypeSetting();
+
+    if( canvasType != EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE )
+    {
+        if( GetGalCanvas()->SwitchBackend( canvasType ) )
+            UseGalCanvas( true );
+    }
 }
 
 
@@ -250,6 +295,77 @@ double GERBVIEW_FRAME::BestZoom()
 }
 
 
+void GERBVIEW_FRAME::SwitchCanvas( wxCommandEvent& aEvent )
+{
+    bool use_gal = false;
+    EDA_DRAW_PANEL_GAL::GAL_TYPE canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE;
+
+    switch( aEvent.GetId() )
+    {
+    case ID_MENU_GERBVIEW_CANVAS_LEGACY:
+        break;
+
+    case ID_MENU_GERBVIEW_CANVAS_CAIRO:
+        use_gal = GetGalCanvas()->SwitchBackend( EDA_DRAW_PANEL_GAL::GAL_TYPE_CAIRO );
+
+        if( use_gal )
+            canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_CAIRO;
+        break;
+
+    case ID_MENU_GERBVIEW_CANVAS_OPENGL:
+        use_gal = GetGalCanvas()->SwitchBackend( EDA_DRAW_PANEL_GAL::GAL_TYPE_OPENGL );
+
+        if( use_gal )
+            canvasType = EDA_DRAW_PANEL_GAL::GAL_TYPE_OPENGL;
+        break;
+    }
+
+    saveCanvasTypeSetting( canvasType );
+    UseGalCanvas( use_gal );
+}
+
+
+void GERBVIEW_FRAME::UseGalCanvas( bool aEnable )
+{
+    EDA_DRAW_FRAME::UseGalCanvas( aEnable );
+
+    GERBVIEW_DRAW_PANEL_GAL* galCanvas = static_cast<GERBVIEW_DRAW_PANEL_GAL*>( GetGalCanvas() );
+
+    if( aEnable )
+    {
+        // The items are not kept in the view while the legacy canvas is used
+        galCanvas->DisplayLayout( GetGerberLayout() );
+        galCanvas->StartDrawing();
+    }
+    else
+    {
+        galCanvas->GetView()->Clear();
+
+        // Redirect all events to the legacy canvas
+        galCanvas->SetEventDispatcher( NULL );
+    }
+}
+
+
+void GERBVIEW_FRAME::RedrawCanvas( bool aLayoutChanged )
+{
+    if( !IsGalCanvasActive() )
+    {
+        m_canvas->Refresh();
+        return;
+    }
+
+    GERBVIEW_DRAW_PANEL_GAL* galCanvas = static_cast<GERBVIEW_DRAW_PANEL_GAL*>( GetGalCanvas() );
+
+    if( aLayoutChanged )
+        galCanvas->DisplayLayout( GetGerberLayout() );
+    else
+        galCanvas->SyncSettings();
+
+    galCanvas->Refresh();
+}
+
+
 void GERBVIEW_FRAME::LoadSettings( wxConfigBase* aCfg )
 {
     EDA_DRAW_FRAME::LoadSettings( aCfg );
@@ -203,9 +203,6 @@ private:
 
     bool            m_show_layer_manager_tools;
 
-    // An array sting to store warning messages when reaging a gerber file.
-    wxArrayString   m_Messages;
-
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
@@ -239,33 +236,31 @@ public:
     void    UpdateStatusBar();
 
     /**
-     * Function GetZoomLevelIndicator
-     * returns a human readable value which can be displayed as zoom
-     * level indicator in dialogs.
-     * Virtual from the base class
+     * Function SwitchCanvas
+     * switches the canvas between the legacy canvas and the GAL backends, from the
+     * ID_MENU_GERBVIEW_CANVAS_xxx menu events.
      */
-    const wxString GetZoomLevelIndicator() const;
+    void    SwitchCanvas( wxCommandEvent& aEvent );
+
+    ///> @copydoc EDA_DRAW_FRAME::UseGalCanvas()
+    virtual void UseGalCanvas( bool aEnable );
 
     /**
-     * Function ReportMessage
-     * Add a message (a string) in message list
-     * for instance when reading a Gerber file
-     * @param aMessage = the string to add in list
+     * Function RedrawCanvas
+     * redraws the active canvas.  The GAL canvas caches the items: it reloads the
+     * display settings, and the items when they are changed.
+     * @param aLayoutChanged = true when items were added to, removed from or moved in
+     * the gerber layout
      */
-    void ReportMessage( const wxString aMessage )
-    {
-        m_Messages.Add( aMessage );
-    }
+    void    RedrawCanvas( bool aLayoutChanged = false );
 
     /**
-     * Function ClearMessageList
-     * Clear the message list
-     * Call it before reading a Gerber file
+     * Function GetZoomLevelIndicator
+     * returns a human readable value which can be displayed as zoom
+     * level indicator in dialogs.
+     * Virtual from the base class
      */
-    void ClearMessageList()
-    {
-        m_Messages.Clear();
-    }
+    const wxString GetZoomLevelIndicator() const;
 
     /**
      * Function GetDisplayMode
@@ -495,6 +490,13 @@ public:
      */
     void                OnShowGerberSourceFile( wxCommandEvent& event );
 
+    /**
+     * Function OnCompareLayers
+     * compares the active layer with a layer chosen by the user, at a chosen
+     * resolution, and lists the areas which differ, see GERBER_COMPARE
+     */
+    void                OnCompareLayers( wxCommandEvent& event );
+
     /**
      * Function OnSelectDisplayMode
      * called on a display mode selection
@@ -617,8 +619,6 @@ public:
      */
     bool                LoadGerberFiles( const wxString& aFileName );
     int                 ReadGerberFile( FILE* File, bool Append );
-    bool                Read_GERBER_File( const wxString&   GERBER_FullFileName,
-                                          const wxString&   D_Code_FullFileName );
 
     /**
      * function LoadDrllFiles
@@ -629,7 +629,6 @@ public:
      * @return true if file was opened successfully.
      */
     bool                LoadExcellonFiles( const wxString& aFileName );
-    bool                Read_EXCELLON_File( const wxString& aFullFileName );
 
     bool                GeneralControl( wxDC* aDC, const wxPoint& aPosition, EDA_KEY aHotKey = 0 );
 
@@ -646,6 +645,13 @@ public:
     // Conversion function
     void                ExportDataInPcbnewFormat( wxCommandEvent& event );
 
+    /**
+     * Function ExportLayerToBitmapTiles
+     * rasterizes the active layer at a resolution chosen by the user, to a set of PNG
+     * files of GERBER_RASTER_TILE_SIZE pixels, and a text file giving their placement
+     */
+    void                ExportLayerToBitmapTiles( wxCommandEvent& event );
+
     /* SaveCopyInUndoList() virtual
      * currently: do nothing in GerbView.
      */
@@ -45,10 +45,16 @@ enum gerbview_ids
     ID_TOOLBARH_GERBER_SELECT_ACTIVE_DCODE,
     ID_GERBVIEW_SHOW_SOURCE,
     ID_GERBVIEW_EXPORT_TO_PCBNEW,
+    ID_GERBVIEW_EXPORT_TO_BITMAP_TILES,
+    ID_GERBVIEW_COMPARE_LAYERS,
 
     ID_MENU_GERBVIEW_SHOW_HIDE_LAYERS_MANAGER_DIALOG,
     ID_MENU_GERBVIEW_SELECT_PREFERED_EDITOR,
 
+    ID_MENU_GERBVIEW_CANVAS_LEGACY,
+    ID_MENU_GERBVIEW_CANVAS_OPENGL,
+    ID_MENU_GERBVIEW_CANVAS_CAIRO,
+
     // IDs for drill file history (wxID_FILEnn is already in use)
     ID_GERBVIEW_DRILL_FILE,
     ID_GERBVIEW_DRILL_FILE1,
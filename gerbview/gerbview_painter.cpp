@@ -0,0 +1,379 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerbview_painter.cpp
+ * @brief The GAL painter of the GerbView items, drawing them as GERBER_DRAW_ITEM::Draw()
+ * draws them on the legacy canvas.
+ */
+
+#include <fctsys.h>
+#include <trigo.h>
+#include <class_colors_design_settings.h>
+
+#include <gerbview_painter.h>
+#include <gerbview_frame.h>
+#include <class_gerber_draw_item.h>
+#include <class_GERBER.h>
+#include <gal/graphics_abstraction_layer.h>
+
+#include <deque>
+
+using namespace KIGFX;
+
+GERBVIEW_RENDER_SETTINGS::GERBVIEW_RENDER_SETTINGS()
+{
+    m_backgroundColor  = COLOR4D( 0.0, 0.0, 0.0, 1.0 );
+    m_negativeColor    = m_backgroundColor;
+    m_gridColor        = m_legacyColorMap[DARKGRAY];
+    m_flashedItemsFill = true;
+    m_linesFill        = true;
+    m_polygonsFill     = true;
+
+    for( int i = 0; i < GERBER_DRAWLAYERS_COUNT; i++ )
+        m_layerColors[i] = m_legacyColorMap[WHITE];
+
+    update();
+}
+
+
+void GERBVIEW_RENDER_SETTINGS::ImportLegacyColors( const COLORS_DESIGN_SETTINGS* aSettings )
+{
+    for( int i = 0; i < GERBER_DRAWLAYERS_COUNT; i++ )
+        m_layerColors[i] = m_legacyColorMap[aSettings->GetLayerColor( i )];
+
+    update();
+}
+
+
+void GERBVIEW_RENDER_SETTINGS::LoadDisplayOptions( const GBR_DISPLAY_OPTIONS* aOptions )
+{
+    if( aOptions == NULL )
+        return;
+
+    m_flashedItemsFill = aOptions->m_DisplayFlashedItemsFill;
+    m_linesFill        = aOptions->m_DisplayLinesFill;
+    m_polygonsFill     = aOptions->m_DisplayPolygonsFill;
+
+    update();
+}
+
+
+const COLOR4D& GERBVIEW_RENDER_SETTINGS::GetColor( const VIEW_ITEM* aItem, int aLayer ) const
+{
+    if( aLayer < 0 || aLayer >= GERBER_DRAWLAYERS_COUNT )
+        return m_backgroundColor;
+
+    return m_layerColors[aLayer];
+}
+
+
+GERBVIEW_PAINTER::GERBVIEW_PAINTER( GAL* aGal ) :
+    PAINTER( aGal )
+{
+}
+
+
+bool GERBVIEW_PAINTER::Draw( const VIEW_ITEM* aItem, int aLayer )
+{
+    const EDA_ITEM* item = static_cast<const EDA_ITEM*>( aItem );
+
+    switch( item->Type() )
+    {
+    case TYPE_GERBER_DRAW_ITEM:
+    {
+        const GERBER_DRAW_ITEM* gbrItem = static_cast<const GERBER_DRAW_ITEM*>( item );
+
+        // the copies of a step and repeat block are drawn from the same item
+        for( int ii = 0; ii < gbrItem->GetInstanceCount(); ii++ )
+        {
+            gbrItem->SetInstance( ii );
+            draw( gbrItem, aLayer );
+        }
+
+        gbrItem->SetInstance( 0 );
+    }
+        break;
+
+    default:
+        // Painter does not know how to draw the object
+        return false;
+    }
+
+    return true;
+}
+
+
+void GERBVIEW_PAINTER::draw( const GERBER_DRAW_ITEM* aItem, int aLayer )
+{
+    // used when a D_CODE is not found. default D_CODE to draw a flashed item
+    static D_CODE dummyD_CODE( 0 );
+
+    // The D_CODE lookup, and the shapes converted to polygons, are cached by the item
+    GERBER_DRAW_ITEM* item = const_cast<GERBER_DRAW_ITEM*>( aItem );
+    D_CODE*           d_codeDescr = item->GetDcodeDescr();
+
+    if( d_codeDescr == NULL )
+        d_codeDescr = &dummyD_CODE;
+
+    COLOR4D color    = m_gerbviewSettings.GetColor( aItem, aLayer );
+    COLOR4D altColor = m_gerbviewSettings.m_negativeColor;
+
+    // Negative items are drawn with the negative color.  There is no drawing order inside
+    // a view layer, so unlike on the legacy canvas they do not erase the items below them.
+    bool isDark = !( item->GetLayerPolarity() ^ item->m_imageParams->m_ImageNegative );
+
+    if( !isDark )
+        std::swap( color, altColor );
+
+    bool     isFilled = m_gerbviewSettings.m_linesFill;
+    VECTOR2D start( item->GetABPosition( item->m_Start ) );
+
+    switch( item->m_Shape )
+    {
+    case GBR_POLYGON:
+        isFilled = m_gerbviewSettings.m_polygonsFill || !isDark;
+        drawPolygon( item, item->m_PolyCorners, wxPoint( 0, 0 ), color, isFilled );
+        break;
+
+    case GBR_CIRCLE:
+    {
+        double radius = GetLineLength( item->m_Start, item->m_End );
+
+        m_gal->SetIsFill( false );
+        m_gal->SetIsStroke( true );
+        m_gal->SetStrokeColor( color );
+
+        if( isFilled )
+        {
+            m_gal->SetLineWidth( item->m_Size.x );
+            m_gal->DrawCircle( start, radius );
+        }
+        else
+        {
+            // draw the border of the pen's path using two circles
+            m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
+            m_gal->DrawCircle( start, radius - item->m_Size.x / 2 );
+            m_gal->DrawCircle( start, radius + item->m_Size.x / 2 );
+        }
+    }
+        break;
+
+    case GBR_ARC:
+    {
+        // As GRArc1(), the arc goes counterclockwise on screen from m_Start to m_End,
+        // that is from m_End to m_Start with increasing angles, the Y axis being top to bottom
+        VECTOR2D center( item->GetABPosition( item->m_ArcCentre ) );
+        VECTOR2D end( item->GetABPosition( item->m_End ) );
+        double   startAngle = ( end - center ).Angle();
+        double   endAngle = ( start - center ).Angle();
+
+        if( endAngle <= startAngle )
+            endAngle += 2 * M_PI;
+
+        m_gal->SetIsFill( false );
+        m_gal->SetIsStroke( true );
+        m_gal->SetStrokeColor( color );
+        m_gal->SetLineWidth( isFilled ? item->m_Size.x : m_gerbviewSettings.m_outlineWidth );
+        m_gal->DrawArc( center, ( start - center ).EuclideanNorm(), startAngle, endAngle );
+    }
+        break;
+
+    case GBR_SPOT_CIRCLE:
+    case GBR_SPOT_RECT:
+    case GBR_SPOT_OVAL:
+    case GBR_SPOT_POLY:
+    case GBR_SPOT_MACRO:
+        isFilled = m_gerbviewSettings.m_flashedItemsFill;
+        drawFlashedShape( item, d_codeDescr, color, altColor, isFilled );
+        break;
+
+    case GBR_SEGMENT:
+        // A line plotted with a rectangular pen is a polygon
+        if( d_codeDescr->m_Shape == APT_RECT )
+        {
+            if( item->m_PolyCorners.size() == 0 )
+                item->ConvertSegmentToPolygon();
+
+            drawPolygon( item, item->m_PolyCorners, wxPoint( 0, 0 ), color, isFilled );
+        }
+        else
+        {
+            m_gal->SetIsFill( isFilled );
+            m_gal->SetIsStroke( !isFilled );
+            m_gal->SetFillColor( color );
+            m_gal->SetStrokeColor( color );
+            m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
+            m_gal->DrawSegment( start, VECTOR2D( item->GetABPosition( item->m_End ) ),
+                                item->m_Size.x );
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, D_CODE* aDCode,
+                                         const COLOR4D& aColor, const COLOR4D& aAltColor,
+                                         bool aFilled )
+{
+    switch( aDCode->m_Shape )
+    {
+    case APT_MACRO:
+    {
+        APERTURE_MACRO* macro = aDCode->GetMacro();
+
+        if( macro == NULL )
+            break;
+
+        // The shapes are evaluated once per D_CODE, and moved to each flash
+        const AM_SHAPES& shapes = aDCode->GetMacroShapes();
+        std::vector<wxPoint> points;
+
+        for( unsigned ii = 0; ii < shapes.size(); ii++ )
+        {
+            const AM_SHAPE& shape = shapes[ii];
+            bool exposure = macro->primitives[shape.m_Primitive].mapExposure( aItem );
+            const COLOR4D& color = exposure != shape.m_AltColor ? aColor : aAltColor;
+
+            if( shape.m_Radius > 0 )
+            {
+                drawMacroCircle( aItem->GetABPosition( shape.m_Center + aItem->m_Start ),
+                                 shape.m_Radius, shape.m_PenWidth, color, aFilled );
+                continue;
+            }
+
+            points.resize( shape.m_Corners.size() );
+
+            for( unsigned jj = 0; jj < points.size(); jj++ )
+                points[jj] = aItem->GetABPosition( shape.m_Corners[jj] + aItem->m_Start );
+
+            drawABPolygon( points, color, aFilled );
+        }
+    }
+        break;
+
+    case APT_CIRCLE:
+        if( !aFilled || aDCode->m_DrillShape == APT_DEF_NO_HOLE )
+        {
+            m_gal->SetIsFill( aFilled );
+            m_gal->SetIsStroke( !aFilled );
+            m_gal->SetFillColor( aColor );
+            m_gal->SetStrokeColor( aColor );
+            m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
+            m_gal->DrawCircle( VECTOR2D( aItem->GetABPosition( aItem->m_Start ) ),
+                               aDCode->m_Size.x / 2 );
+            break;
+        }
+
+        // fall through: a shape with a hole is drawn as its polygon
+    case APT_RECT:
+    case APT_OVAL:
+    case APT_POLYGON:
+        drawPolygon( aItem, aDCode->GetShapePolygon(), aItem->m_Start, aColor, aFilled );
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void GERBVIEW_PAINTER::drawMacroCircle( const wxPoint& aCenter, int aRadius, int aPenWidth,
+                                        const COLOR4D& aColor, bool aFilled )
+{
+    m_gal->SetFillColor( aColor );
+    m_gal->SetStrokeColor( aColor );
+
+    if( aPenWidth == 0 )
+    {
+        m_gal->SetIsFill( aFilled );
+        m_gal->SetIsStroke( !aFilled );
+        m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
+        m_gal->DrawCircle( VECTOR2D( aCenter ), aRadius );
+    }
+    else if( aFilled )
+    {
+        // a ring, the path of a pen of width aPenWidth
+        m_gal->SetIsFill( false );
+        m_gal->SetIsStroke( true );
+        m_gal->SetLineWidth( aPenWidth );
+        m_gal->DrawCircle( VECTOR2D( aCenter ), aRadius - aPenWidth / 2.0 );
+    }
+    else
+    {
+        // the borders of the ring
+        m_gal->SetIsFill( false );
+        m_gal->SetIsStroke( true );
+        m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
+        m_gal->DrawCircle( VECTOR2D( aCenter ), aRadius );
+        m_gal->DrawCircle( VECTOR2D( aCenter ), aRadius - aPenWidth );
+    }
+}
+
+
+void GERBVIEW_PAINTER::drawPolygon( const GERBER_DRAW_ITEM* aItem,
+                                    const std::vector<wxPoint>& aCorners,
+                                    const wxPoint& aOffset, const COLOR4D& aColor, bool aFilled )
+{
+    std::vector<wxPoint> points( aCorners.size() );
+
+    for( unsigned ii = 0; ii < aCorners.size(); ii++ )
+        points[ii] = aItem->GetABPosition( aCorners[ii] + aOffset );
+
+    drawABPolygon( points, aColor, aFilled );
+}
+
+
+void GERBVIEW_PAINTER::drawABPolygon( const std::vector<wxPoint>& aCorners,
+                                      const COLOR4D& aColor, bool aFilled )
+{
+    if( aCorners.size() < 2 )
+        return;
+
+    std::deque<VECTOR2D> points;
+
+    for( unsigned ii = 0; ii < aCorners.size(); ii++ )
+        points.push_back( VECTOR2D( aCorners[ii] ) );
+
+    if( aFilled )
+    {
+        m_gal->SetIsFill( true );
+        m_gal->SetIsStroke( false );
+        m_gal->SetFillColor( aColor );
+        m_gal->DrawPolygon( points );
+    }
+    else
+    {
+        m_gal->SetIsFill( false );
+        m_gal->SetIsStroke( true );
+        m_gal->SetStrokeColor( aColor );
+        m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
+
+        // the outline is closed
+        points.push_back( points.front() );
+        m_gal->DrawPolyline( points );
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __GERBVIEW_PAINTER_H
+#define __GERBVIEW_PAINTER_H
+
+#include <vector>
+#include <painter.h>
+#include <gerbview.h>
+
+
+class COLORS_DESIGN_SETTINGS;
+class GBR_DISPLAY_OPTIONS;
+class GERBER_DRAW_ITEM;
+class D_CODE;
+
+namespace KIGFX
+{
+class GAL;
+
+/**
+ * Class GERBVIEW_RENDER_SETTINGS
+ * Stores GerbView specific render settings: the colors of the gerber draw layers and
+ * the filled or sketch modes of the items.
+ */
+class GERBVIEW_RENDER_SETTINGS : public RENDER_SETTINGS
+{
+public:
+    friend class GERBVIEW_PAINTER;
+
+    GERBVIEW_RENDER_SETTINGS();
+
+    /// @copydoc RENDER_SETTINGS::ImportLegacyColors()
+    void ImportLegacyColors( const COLORS_DESIGN_SETTINGS* aSettings );
+
+    /**
+     * Function LoadDisplayOptions
+     * Loads the filled or sketch modes of the flashed items, lines and polygons.
+     * @param aOptions are settings that you want to use for displaying items.
+     */
+    void LoadDisplayOptions( const GBR_DISPLAY_OPTIONS* aOptions );
+
+    /// @copydoc RENDER_SETTINGS::GetColor()
+    virtual const COLOR4D& GetColor( const VIEW_ITEM* aItem, int aLayer ) const;
+
+    /// @copydoc RENDER_SETTINGS::GetGridColor()
+    virtual const COLOR4D& GetGridColor() const
+    {
+        return m_gridColor;
+    }
+
+    /**
+     * Function SetLayerColor
+     * Changes the color used to draw a gerber draw layer.
+     * @param aLayer is the layer number.
+     * @param aColor is the new color.
+     */
+    void SetLayerColor( int aLayer, const COLOR4D& aColor )
+    {
+        m_layerColors[aLayer] = aColor;
+    }
+
+    /**
+     * Function SetGridColor
+     * Changes the color used to draw the grid.
+     */
+    void SetGridColor( const COLOR4D& aColor )
+    {
+        m_gridColor = aColor;
+    }
+
+    /**
+     * Function SetNegativeColor
+     * Changes the color of the negative items, the background color unless they are
+     * shown in their own color.
+     */
+    void SetNegativeColor( const COLOR4D& aColor )
+    {
+        m_negativeColor = aColor;
+    }
+
+protected:
+    ///> Colors of the gerber draw layers
+    COLOR4D m_layerColors[GERBER_DRAWLAYERS_COUNT];
+
+    ///> Color of the negative items (which erase the previous items in the legacy canvas)
+    COLOR4D m_negativeColor;
+
+    ///> Color of the grid
+    COLOR4D m_gridColor;
+
+    ///> Flags determining if items are drawn filled, or as outlines
+    bool    m_flashedItemsFill;
+    bool    m_linesFill;
+    bool    m_polygonsFill;
+};
+
+
+/**
+ * Class GERBVIEW_PAINTER
+ * Contains methods for drawing GerbView-specific items.
+ */
+class GERBVIEW_PAINTER : public PAINTER
+{
+public:
+    GERBVIEW_PAINTER( GAL* aGal );
+
+    /// @copydoc PAINTER::ApplySettings()
+    virtual void ApplySettings( const RENDER_SETTINGS* aSettings )
+    {
+        m_gerbviewSettings = *static_cast<const GERBVIEW_RENDER_SETTINGS*>( aSettings );
+    }
+
+    /// @copydoc PAINTER::GetSettings()
+    virtual RENDER_SETTINGS* GetSettings()
+    {
+        return &m_gerbviewSettings;
+    }
+
+    /// @copydoc PAINTER::Draw()
+    virtual bool Draw( const VIEW_ITEM* aItem, int aLayer );
+
+protected:
+    GERBVIEW_RENDER_SETTINGS m_gerbviewSettings;
+
+    void draw( const GERBER_DRAW_ITEM* aItem, int aLayer );
+
+    ///> Draws the flashed shape of an item, as D_CODE::DrawFlashedShape()
+    void drawFlashedShape( GERBER_DRAW_ITEM* aItem, D_CODE* aDCode, const COLOR4D& aColor,
+                           const COLOR4D& aAltColor, bool aFilled );
+
+    ///> Draws a circle of an aperture macro, a disc or a ring of width aPenWidth, given in
+    ///> drawing (A,B) coordinates
+    void drawMacroCircle( const wxPoint& aCenter, int aRadius, int aPenWidth,
+                          const COLOR4D& aColor, bool aFilled );
+
+    ///> Draws a polygon given in X,Y gerber axis, moved by aOffset
+    void drawPolygon( const GERBER_DRAW_ITEM* aItem, const std::vector<wxPoint>& aCorners,
+                      const wxPoint& aOffset, const COLOR4D& aColor, bool aFilled );
+
+    ///> Draws a polygon given in drawing (A,B) coordinates
+    void drawABPolygon( const std::vector<wxPoint>& aCorners, const COLOR4D& aColor,
+                        bool aFilled );
+};
+} // namespace KIGFX
+
+#endif /* __GERBVIEW_PAINTER_H */
@@ -172,34 +172,34 @@ bool GERBVIEW_FRAME::OnHotKey( wxDC* aDC, int aHotkeyCode, const wxPoint& aPosit
 
     case HK_GBR_LINES_DISPLAY_MODE:
         CHANGE(  m_DisplayOptions.m_DisplayLinesFill );
-        m_canvas->Refresh();
+        RedrawCanvas();
         break;
 
     case HK_GBR_FLASHED_DISPLAY_MODE:
         CHANGE( m_DisplayOptions.m_DisplayFlashedItemsFill );
-        m_canvas->Refresh( true );
+        RedrawCanvas();
         break;
 
     case HK_GBR_POLYGON_DISPLAY_MODE:
         CHANGE( m_DisplayOptions.m_DisplayPolygonsFill );
-        m_canvas->Refresh();
+        RedrawCanvas();
         break;
 
     case HK_GBR_NEGATIVE_DISPLAY_ONOFF:
         SetElementVisibility( NEGATIVE_OBJECTS_VISIBLE, not IsElementVisible( NEGATIVE_OBJECTS_VISIBLE ) );
-        m_canvas->Refresh();
+        RedrawCanvas();
         break;
 
     case HK_GBR_DCODE_DISPLAY_ONOFF:
         SetElementVisibility( DCODES_VISIBLE, not IsElementVisible( DCODES_VISIBLE ) );
-        m_canvas->Refresh();
+        RedrawCanvas();
         break;
 
     case HK_SWITCH_LAYER_TO_PREVIOUS:
         if( getActiveLayer() > 0 )
         {
             setActiveLayer( getActiveLayer() - 1 );
-            m_canvas->Refresh();
+            RedrawCanvas();
         }
         break;
 
@@ -207,7 +207,7 @@ bool GERBVIEW_FRAME::OnHotKey( wxDC* aDC, int aHotkeyCode, const wxPoint& aPosit
         if( getActiveLayer() < 31 )
         {
             setActiveLayer( getActiveLayer() + 1 );
-            m_canvas->Refresh();
+            RedrawCanvas();
         }
         break;
     }
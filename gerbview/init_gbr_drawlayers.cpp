@@ -37,6 +37,8 @@
 #include <class_GERBER.h>
 #include <class_gerbview_layer_widget.h>
 #include <class_gbr_layout.h>
+#include <class_draw_panel_gal.h>
+#include <view/view.h>
 
 bool GERBVIEW_FRAME::Clear_DrawLayers( bool query )
 {
@@ -49,7 +51,12 @@ bool GERBVIEW_FRAME::Clear_DrawLayers( bool query )
             return false;
     }
 
+    // The items are removed from the view at once, before being deleted
+    if( GetGalCanvas() )
+        GetGalCanvas()->GetView()->Clear();
+
     GetGerberLayout()->m_Drawings.DeleteAll();
+    GetGerberLayout()->InvalidateItemIndex();
 
     g_GERBER_List.ClearList();
 
@@ -89,10 +96,12 @@ void GERBVIEW_FRAME::Erase_Current_DrawLayer( bool query )
         item->DeleteStructure();
     }
 
+    GetGerberLayout()->InvalidateItemIndex();
+
     g_GERBER_List.ClearImage( layer );
 
     GetScreen()->SetModify();
-    m_canvas->Refresh();
+    RedrawCanvas( true );
     m_LayersManager->UpdateLayerIcons();
     syncLayerBox();
 }
@@ -49,30 +49,29 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
 
     int layer = getActiveLayer();
 
+    // Only the items found in the index of the layout around ref are tested,
+    // in the order of the items list
+    std::vector<GERBER_DRAW_ITEM*> candidates;
+    EDA_RECT          area( ref, wxSize( 1, 1 ) );
+    GERBER_DRAW_ITEM* gerb_item = NULL;
+
     // Search first on active layer
-    GERBER_DRAW_ITEM* gerb_item = GetItemsList();
+    GetGerberLayout()->QueryItems( area, layer, candidates );
 
-    for( ; gerb_item; gerb_item = gerb_item->Next() )
+    for( unsigned ii = 0; ii < candidates.size() && !found; ii++ )
     {
-        if( gerb_item->GetLayer()!= layer )
-            continue;
-
-        if( gerb_item->HitTest( ref ) )
-        {
-            found = true;
-            break;
-        }
+        gerb_item = candidates[ii];
+        found = gerb_item->HitTest( ref );
     }
 
     if( !found ) // Search on all layers
     {
-        for( gerb_item = GetItemsList(); gerb_item; gerb_item = gerb_item->Next() )
+        GetGerberLayout()->QueryItems( area, -1, candidates );
+
+        for( unsigned ii = 0; ii < candidates.size() && !found; ii++ )
         {
-            if( gerb_item->HitTest( ref ) )
-            {
-                found = true;
-                break;
-            }
+            gerb_item = candidates[ii];
+            found = gerb_item->HitTest( ref );
         }
     }
 
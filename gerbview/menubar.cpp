@@ -127,6 +127,13 @@ void GERBVIEW_FRAME::ReCreateMenuBar()
                  _( "Export data in Pcbnew format" ),
                  KiBitmap( export_xpm ) );
 
+    // Export to bitmap tiles
+    AddMenuItem( fileMenu,
+                 ID_GERBVIEW_EXPORT_TO_BITMAP_TILES,
+                 _( "Export to &Bitmap Tiles" ),
+                 _( "Export the current layer to high resolution PNG tiles" ),
+                 KiBitmap( export_xpm ) );
+
     // Separator
     fileMenu->AppendSeparator();
 
@@ -170,6 +177,32 @@ void GERBVIEW_FRAME::ReCreateMenuBar()
                  KiBitmap( preference_xpm ) );
 #endif // __WXMAC__
 
+    configMenu->AppendSeparator();
+
+    AddMenuItem( configMenu, ID_MENU_GERBVIEW_CANVAS_LEGACY,
+                 _( "Switch Canvas to &Legacy" ),
+                 _( "Switch the canvas implementation to Legacy" ),
+                 KiBitmap( tools_xpm ) );
+
+    // Compare layers
+    AddMenuItem( miscellaneousMenu,
+                 ID_GERBVIEW_COMPARE_LAYERS,
+                 _( "Com&pare Layers" ),
+                 _( "List the areas which differ between the current layer and another layer" ),
+                 KiBitmap( layers_manager_xpm ) );
+
+    AddMenuItem( configMenu, ID_MENU_GERBVIEW_CANVAS_OPENGL,
+                 _( "Switch Canvas to Open&GL" ),
+                 _( "Switch the canvas implementation to OpenGL" ),
+                 KiBitmap( tools_xpm ) );
+
+    AddMenuItem( configMenu, ID_MENU_GERBVIEW_CANVAS_CAIRO,
+                 _( "Switch Canvas to &Cairo" ),
+                 _( "Switch the canvas implementation to Cairo" ),
+                 KiBitmap( tools_xpm ) );
+
+    configMenu->AppendSeparator();
+
     // Language submenu
     Pgm().AddMenuLanguageList( configMenu );
 
@@ -31,169 +31,159 @@
 #include <gerbview_frame.h>
 #include <class_GERBER.h>
 
-#include <html_messagebox.h>
 #include <macros.h>
+#include <richio.h>
+
+
+void GERBER_IMAGE::closeFiles()
+{
+    delete m_Current_File;
+    m_Current_File = NULL;
+
+    while( m_FilesPtr > 0 )
+    {
+        m_FilesPtr--;
+        delete m_FilesList[m_FilesPtr];
+        m_FilesList[m_FilesPtr] = NULL;
+    }
+}
+
 
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName,
-                                           const wxString& D_Code_FullFileName )
+bool GERBER_IMAGE::LoadFile( const wxString& aFullFileName )
 {
     int      G_command = 0;        // command number for G commands like G04
     int      D_commande = 0;       // command number for D commands like D02
 
-    char     line[GERBER_BUFZ];
-
     wxString msg;
     char*    text;
-    int layer;         // current layer used in GerbView
-
-    layer = getActiveLayer();
-    GERBER_IMAGE* gerber = g_GERBER_List.GetGbrImage( layer );
-
-    if( gerber == NULL )
-    {
-        gerber = new GERBER_IMAGE( this, layer );
-        g_GERBER_List.AddGbrImage( gerber, layer );
-    }
 
     ClearMessageList( );
 
     /* Set the gerber scale: */
-    gerber->ResetDefaultValues();
+    ResetDefaultValues();
 
-    /* Read the gerber file */
-    gerber->m_Current_File = wxFopen( GERBER_FullFileName, wxT( "rt" ) );
-    if( gerber->m_Current_File == 0 )
+    /* Read the gerber file: it is mapped in memory, the large region files are not
+     * copied through a stdio buffer */
+    try
+    {
+        m_Current_File = new MAPPED_FILE_LINE_READER( aFullFileName, 0, GERBER_LINE_MAX );
+    }
+    catch( const IO_ERROR& )
     {
-        msg.Printf( _( "File <%s> not found" ), GetChars( GERBER_FullFileName ) );
-        DisplayError( this, msg, 10 );
+        msg.Printf( _( "File <%s> not found" ), GetChars( aFullFileName ) );
+        ReportMessage( msg );
         return false;
     }
 
-    gerber->m_FileName = GERBER_FullFileName;
+    m_FileName = aFullFileName;
 
-    wxString path = wxPathOnly( GERBER_FullFileName );
-    if( path != wxEmptyString )
-        wxSetWorkingDirectory( path );
-
-    LOCALE_IO toggleIo;
-
-    while( true )
+    try
     {
-        if( fgets( line, sizeof(line), gerber->m_Current_File ) == NULL )
+        while( true )
         {
-            if( gerber->m_FilesPtr == 0 )
-                break;
+            if( m_Current_File->ReadLine() == NULL )
+            {
+                if( m_FilesPtr == 0 )
+                    break;
 
-            fclose( gerber->m_Current_File );
+                delete m_Current_File;
 
-            gerber->m_FilesPtr--;
-            gerber->m_Current_File =
-                gerber->m_FilesList[gerber->m_FilesPtr];
+                m_FilesPtr--;
+                m_Current_File = m_FilesList[m_FilesPtr];
+                m_FilesList[m_FilesPtr] = NULL;
 
-            continue;
-        }
+                continue;
+            }
 
-        text = StrPurge( line );
+            text = StrPurge( m_Current_File->Line() );
 
-        while( text && *text )
-        {
-            switch( *text )
+            while( text && *text )
             {
-            case ' ':
-            case '\r':
-            case '\n':
-                text++;
-                break;
-
-            case '*':       // End command
-                gerber->m_CommandState = END_BLOCK;
-                text++;
-                break;
-
-            case 'M':       // End file
-                gerber->m_CommandState = CMD_IDLE;
-                while( *text )
-                    text++;
-                break;
-
-            case 'G':    /* Line type Gxx : command */
-                G_command = gerber->GCodeNumber( text );
-                gerber->Execute_G_Command( text, G_command );
-                break;
-
-            case 'D':       /* Line type Dxx : Tool selection (xx > 0) or
-                             * command if xx = 0..9 */
-                D_commande = gerber->DCodeNumber( text );
-                gerber->Execute_DCODE_Command( text, D_commande );
-                break;
-
-            case 'X':
-            case 'Y':                   /* Move or draw command */
-                gerber->m_CurrentPos = gerber->ReadXYCoord( text );
-                if( *text == '*' )      // command like X12550Y19250*
-                {
-                    gerber->Execute_DCODE_Command( text,
-                                                   gerber->m_Last_Pen_Command );
-                }
-                break;
-
-            case 'I':
-            case 'J':       /* Auxiliary Move command */
-                gerber->m_IJPos = gerber->ReadIJCoord( text );
-                if( *text == '*' )      // command like X35142Y15945J504*
+                switch( *text )
                 {
-                    gerber->Execute_DCODE_Command( text,
-                                                   gerber->m_Last_Pen_Command );
-                }
-                break;
+                case ' ':
+                case '\r':
+                case '\n':
+                    text++;
+                    break;
 
-            case '%':
-                if( gerber->m_CommandState != ENTER_RS274X_CMD )
-                {
-                    gerber->m_CommandState = ENTER_RS274X_CMD;
-                    gerber->ReadRS274XCommand( line, text );
-                }
-                else        //Error
-                {
-                    ReportMessage( wxT("Expected RS274X Command")  );
-                    gerber->m_CommandState = CMD_IDLE;
+                case '*':       // End command
+                    m_CommandState = END_BLOCK;
+                    text++;
+                    break;
+
+                case 'M':       // End file
+                    m_CommandState = CMD_IDLE;
+                    while( *text )
+                        text++;
+                    break;
+
+                case 'G':    /* Line type Gxx : command */
+                    G_command = GCodeNumber( text );
+                    Execute_G_Command( text, G_command );
+                    break;
+
+                case 'D':       /* Line type Dxx : Tool selection (xx > 0) or
+                                 * command if xx = 0..9 */
+                    D_commande = DCodeNumber( text );
+                    Execute_DCODE_Command( text, D_commande );
+                    break;
+
+                case 'X':
+                case 'Y':                   /* Move or draw command */
+                    m_CurrentPos = ReadXYCoord( text );
+                    if( *text == '*' )      // command like X12550Y19250*
+                    {
+                        Execute_DCODE_Command( text,
+                                                       m_Last_Pen_Command );
+                    }
+                    break;
+
+                case 'I':
+                case 'J':       /* Auxiliary Move command */
+                    m_IJPos = ReadIJCoord( text );
+                    if( *text == '*' )      // command like X35142Y15945J504*
+                    {
+                        Execute_DCODE_Command( text,
+                                                       m_Last_Pen_Command );
+                    }
+                    break;
+
+                case '%':
+                    if( m_CommandState != ENTER_RS274X_CMD )
+                    {
+                        m_CommandState = ENTER_RS274X_CMD;
+                        ReadRS274XCommand( text );
+                    }
+                    else        //Error
+                    {
+                        ReportMessage( wxT("Expected RS274X Command")  );
+                        m_CommandState = CMD_IDLE;
+                        text++;
+                    }
+                    break;
+
+                default:
                     text++;
+                    msg.Printf( wxT("Unexpected symbol <%c>"), *text );
+                    ReportMessage( msg );
+                    break;
                 }
-                break;
-
-            default:
-                text++;
-                msg.Printf( wxT("Unexpected symbol <%c>"), *text );
-                ReportMessage( msg );
-                break;
             }
         }
     }
-
-    fclose( gerber->m_Current_File );
-
-    gerber->m_InUse = true;
-
-    // Display errors list
-    if( m_Messages.size() > 0 )
+    catch( const IO_ERROR& )
     {
-        HTML_MESSAGE_BOX dlg( this, _("Errors") );
-        dlg.ListSet(m_Messages);
-        dlg.ShowModal();
+        // a line too long for the reader
+        closeFiles();
+        throw;
     }
 
-    /* if the gerber file is only a RS274D file
-     * (i.e. without any aperture information), wran the user:
-     */
-    if( !gerber->m_Has_DCode )
-    {
-        msg = _("Warning: this file has no D-Code definition\n"
-                "It is perhaps an old RS274D file\n"
-                "Therefore the size of items is undefined");
-        wxMessageBox( msg );
-    }
+    closeFiles();
+
+    m_InUse = true;
 
     return true;
 }
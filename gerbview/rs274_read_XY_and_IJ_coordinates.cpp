@@ -71,14 +71,73 @@ int scaletoIU( double aCoord, bool isMetric )
 }
 
 
+int GERBER_IMAGE::readCoordinate( char*& aText, bool aIsY, bool& aIsFloat )
+{
+    char* end = aText;
+
+    while( IsNumber( *end ) )
+    {
+        if( *end == '.' )   // Force decimal format if reading a floating point number
+            aIsFloat = true;
+
+        end++;
+    }
+
+    int coord;
+
+    if( aIsFloat )
+    {
+        // When X or Y values are float numbers, they are given in mm or inches
+        if( m_GerbMetric )  // units are mm
+            coord = KiROUND( atof( aText ) * IU_PER_MILS / 0.0254 );
+        else    // units are inches
+            coord = KiROUND( atof( aText ) * IU_PER_MILS * 1000 );
+
+        aText = end;
+        return coord;
+    }
+
+    // Integer format: the digits are accumulated here, and the missing trailing zeros
+    // are multiplied in, rather than copying the digits to a buffer for atoi()
+    long long value = 0;
+    int       nbdigits = 0;
+    bool      negative = false;
+
+    for( ; aText < end; aText++ )
+    {
+        if( *aText == '-' )
+            negative = true;
+        else if( *aText >= '0' && *aText <= '9' )
+        {
+            value = value * 10 + ( *aText - '0' );
+            nbdigits++;     // sign is not counted
+        }
+    }
+
+    if( m_NoTrailingZeros )
+    {
+        int min_digit = aIsY ? m_FmtLen.y : m_FmtLen.x;
+
+        for( ; nbdigits < min_digit; nbdigits++ )
+            value *= 10;
+    }
+
+    if( negative )
+        value = -value;
+
+    double real_scale = scale_list[ aIsY ? m_FmtScale.y : m_FmtScale.x ];
+
+    if( m_GerbMetric )
+        real_scale = real_scale / 25.4;
+
+    return KiROUND( value * real_scale );
+}
+
+
 wxPoint GERBER_IMAGE::ReadXYCoord( char*& Text )
 {
     wxPoint pos;
-    int     type_coord = 0, current_coord, nbdigits;
-    bool    is_float   = m_DecimalFormat;
-    char*   text;
-    char    line[256];
-
+    bool    is_float = m_DecimalFormat;
 
     if( m_Relative )
         pos.x = pos.y = 0;
@@ -88,72 +147,15 @@ wxPoint GERBER_IMAGE::ReadXYCoord( char*& Text )
     if( Text == NULL )
         return pos;
 
-    text = line;
-    while( *Text )
+    while( *Text == 'X' || *Text == 'Y' )
     {
-        if( (*Text == 'X') || (*Text == 'Y') )
-        {
-            type_coord = *Text;
-            Text++;
-            text     = line;
-            nbdigits = 0;
-
-            while( IsNumber( *Text ) )
-            {
-                if( *Text == '.' )  // Force decimat format if reading a floating point number
-                    is_float = true;
-
-                // count digits only (sign and decimal point are not counted)
-                if( (*Text >= '0') && (*Text <='9') )
-                    nbdigits++;
-                *(text++) = *(Text++);
-            }
-
-            *text = 0;
-
-            if( is_float )
-            {
-                // When X or Y values are float numbers, they are given in mm or inches
-                if( m_GerbMetric )  // units are mm
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS / 0.0254 );
-                else    // units are inches
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS * 1000 );
-            }
-            else
-            {
-                int fmt_scale = (type_coord == 'X') ? m_FmtScale.x : m_FmtScale.y;
-
-                if( m_NoTrailingZeros )
-                {
-                    int min_digit =
-                        (type_coord == 'X') ? m_FmtLen.x : m_FmtLen.y;
-                    while( nbdigits < min_digit )
-                    {
-                        *(text++) = '0';
-                        nbdigits++;
-                    }
-
-                    *text = 0;
-                }
-
-                current_coord = atoi( line );
-                double real_scale = scale_list[fmt_scale];
-
-                if( m_GerbMetric )
-                    real_scale = real_scale / 25.4;
-
-                current_coord = KiROUND( current_coord * real_scale );
-            }
-
-            if( type_coord == 'X' )
-                pos.x = current_coord;
-            else if( type_coord == 'Y' )
-                pos.y = current_coord;
-
-            continue;
-        }
+        bool isY = *Text++ == 'Y';
+        int  current_coord = readCoordinate( Text, isY, is_float );
+
+        if( isY )
+            pos.y = current_coord;
         else
-            break;
+            pos.x = current_coord;
     }
 
     if( m_Relative )
@@ -174,81 +176,20 @@ wxPoint GERBER_IMAGE::ReadXYCoord( char*& Text )
 wxPoint GERBER_IMAGE::ReadIJCoord( char*& Text )
 {
     wxPoint pos( 0, 0 );
-
-    int     type_coord = 0, current_coord, nbdigits;
-    bool    is_float   = false;
-    char*   text;
-    char    line[256];
+    bool    is_float = false;
 
     if( Text == NULL )
         return pos;
 
-    text = line;
-    while( *Text )
+    while( *Text == 'I' || *Text == 'J' )
     {
-        if( (*Text == 'I') || (*Text == 'J') )
-        {
-            type_coord = *Text;
-            Text++;
-            text     = line;
-            nbdigits = 0;
-            while( IsNumber( *Text ) )
-            {
-                if( *Text == '.' )
-                    is_float = true;
-
-                // count digits only (sign and decimal point are not counted)
-                if( (*Text >= '0') && (*Text <='9') )
-                    nbdigits++;
-
-                *(text++) = *(Text++);
-            }
-
-            *text = 0;
-            if( is_float )
-            {
-                // When X or Y values are float numbers, they are given in mm or inches
-                if( m_GerbMetric )  // units are mm
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS / 0.0254 );
-                else    // units are inches
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS * 1000 );
-            }
-            else
-            {
-                int fmt_scale =
-                    (type_coord == 'I') ? m_FmtScale.x : m_FmtScale.y;
-
-                if( m_NoTrailingZeros )
-                {
-                    int min_digit =
-                        (type_coord == 'I') ? m_FmtLen.x : m_FmtLen.y;
-                    while( nbdigits < min_digit )
-                    {
-                        *(text++) = '0';
-                        nbdigits++;
-                    }
-
-                    *text = 0;
-                }
-
-                current_coord = atoi( line );
-
-                double real_scale = scale_list[fmt_scale];
-
-                if( m_GerbMetric )
-                    real_scale = real_scale / 25.4;
-
-                current_coord = KiROUND( current_coord * real_scale );
-            }
-            if( type_coord == 'I' )
-                pos.x = current_coord;
-            else if( type_coord == 'J' )
-                pos.y = current_coord;
-
-            continue;
-        }
+        bool isJ = *Text++ == 'J';
+        int  current_coord = readCoordinate( Text, isJ, is_float );
+
+        if( isJ )
+            pos.y = current_coord;
         else
-            break;
+            pos.x = current_coord;
     }
 
     m_IJPos = pos;
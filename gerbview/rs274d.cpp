@@ -345,8 +345,9 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
     /* in order to calculate arc parameters, we use fillArcGBRITEM
      * so we muse create a dummy track and use its geometric parameters
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL, NULL );
-    static const int drawlayer = 0;
+    // not static: the images read their files at once
+    GERBER_DRAW_ITEM dummyGbrItem( NULL, NULL );
+    const int drawlayer = 0;
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
@@ -481,7 +482,7 @@ bool GERBER_IMAGE::Execute_G_Command( char*& text, int G_command )
         {
             text += 7;
             X2_ATTRIBUTE dummy;
-            dummy.ParseAttribCmd( m_Current_File, NULL, 0, text );
+            dummy.ParseAttribCmd( NULL, text );
             if( dummy.IsFileFunction() )
             {
                 delete m_FileFunction;
@@ -552,9 +553,9 @@ bool GERBER_IMAGE::Execute_G_Command( char*& text, int G_command )
         break;
 
     case GC_TURN_OFF_POLY_FILL:
-        if( m_Exposure && m_Parent->GetGerberLayout()->m_Drawings )    // End of polygon
+        if( m_Exposure && m_Drawings )    // End of polygon
         {
-            GERBER_DRAW_ITEM * gbritem = m_Parent->GetGerberLayout()->m_Drawings.GetLast();
+            GERBER_DRAW_ITEM * gbritem = m_Drawings.GetLast();
             StepAndRepeatItem( *gbritem );
         }
         m_Exposure = false;
@@ -585,7 +586,8 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
     GERBER_DRAW_ITEM* gbritem;
     GBR_LAYOUT*       layout = m_Parent->GetGerberLayout();
 
-    int activeLayer = m_Parent->getActiveLayer();
+    // The items are read in m_Drawings, on the graphic layer of the image
+    int activeLayer = m_GraphicLayer;
 
     int      dcode = 0;
     D_CODE*  tool  = NULL;
@@ -622,7 +624,7 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             {
                 m_Exposure = true;
                 gbritem    = new GERBER_DRAW_ITEM( layout, this );
-                layout->m_Drawings.Append( gbritem );
+                m_Drawings.Append( gbritem );
                 gbritem->m_Shape = GBR_POLYGON;
                 gbritem->SetLayer( activeLayer );
                 gbritem->m_Flashed = false;
@@ -632,7 +634,7 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             {
             case GERB_INTERPOL_ARC_NEG:
             case GERB_INTERPOL_ARC_POS:
-                gbritem = layout->m_Drawings.GetLast();
+                gbritem = m_Drawings.GetLast();
 
                 //               D( printf( "Add arc poly %d,%d to %d,%d fill %d interpol %d 360_enb %d\n",
                 //                          m_PreviousPos.x, m_PreviousPos.y, m_CurrentPos.x,
@@ -645,7 +647,7 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 break;
 
             default:
-                gbritem = layout->m_Drawings.GetLast();
+                gbritem = m_Drawings.GetLast();
 
 //                D( printf( "Add poly edge %d,%d to %d,%d fill %d\n",
 //                           m_PreviousPos.x, m_PreviousPos.y,
@@ -665,9 +667,9 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             break;
 
         case 2:     // code D2: exposure OFF (i.e. "move to")
-            if( m_Exposure && layout->m_Drawings )    // End of polygon
+            if( m_Exposure && m_Drawings )    // End of polygon
             {
-                gbritem = layout->m_Drawings.GetLast();
+                gbritem = m_Drawings.GetLast();
                 StepAndRepeatItem( *gbritem );
             }
             m_Exposure    = false;
@@ -698,7 +700,7 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             {
             case GERB_INTERPOL_LINEAR_1X:
                 gbritem = new GERBER_DRAW_ITEM( layout, this );
-                layout->m_Drawings.Append( gbritem );
+                m_Drawings.Append( gbritem );
 
 //                D( printf( "Add line %d,%d to %d,%d\n",
 //                           m_PreviousPos.x, m_PreviousPos.y,
@@ -711,13 +713,15 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             case GERB_INTERPOL_LINEAR_01X:
             case GERB_INTERPOL_LINEAR_001X:
             case GERB_INTERPOL_LINEAR_10X:
-                wxBell();
+                msg.Printf( wxT( "RS274D: DCODE Command: interpol not handled (type %X)" ),
+                            m_Iterpolation );
+                ReportMessage( msg );
                 break;
 
             case GERB_INTERPOL_ARC_NEG:
             case GERB_INTERPOL_ARC_POS:
                 gbritem = new GERBER_DRAW_ITEM( layout, this );
-                layout->m_Drawings.Append( gbritem );
+                m_Drawings.Append( gbritem );
 
 //                D( printf( "Add arc %d,%d to %d,%d center %d, %d interpol %d 360_enb %d\n",
 //                           m_PreviousPos.x, m_PreviousPos.y, m_CurrentPos.x,
@@ -755,7 +759,7 @@ bool GERBER_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             }
 
             gbritem = new GERBER_DRAW_ITEM( layout, this );
-            layout->m_Drawings.Append( gbritem );
+            m_Drawings.Append( gbritem );
             fillFlashedGBRITEM( gbritem, aperture,
                                 dcode, activeLayer, m_CurrentPos,
                                 size, GetLayerParams().m_LayerNegative );
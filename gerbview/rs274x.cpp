@@ -34,10 +34,13 @@
 #include <gerbview.h>
 #include <class_GERBER.h>
 #include <class_X2_gerber_attributes.h>
+#include <richio.h>
+
+#include <wx/filename.h>
 
 extern int ReadInt( char*& text, bool aSkipSeparator = true );
 extern double ReadDouble( char*& text, bool aSkipSeparator = true );
-extern bool GetEndOfBlock( char buff[GERBER_BUFZ], char*& text, FILE* gerber_file );
+extern bool GetEndOfBlock( char*& text, LINE_READER* aReader );
 
 
 #define CODE( x, y ) ( ( (x) << 8 ) + (y) )
@@ -128,7 +131,7 @@ static int ReadXCommand( char*& text )
 }
 
 
-bool GERBER_IMAGE::ReadRS274XCommand( char buff[GERBER_BUFZ], char*& text )
+bool GERBER_IMAGE::ReadRS274XCommand( char*& text )
 {
     bool ok = true;
     int  code_command;
@@ -158,7 +161,7 @@ bool GERBER_IMAGE::ReadRS274XCommand( char buff[GERBER_BUFZ], char*& text )
 
             default:
                 code_command = ReadXCommand( text );
-                ok = ExecuteRS274XCommand( code_command, buff, text );
+                ok = ExecuteRS274XCommand( code_command, text );
                 if( !ok )
                     goto exit;
                 break;
@@ -166,14 +169,14 @@ bool GERBER_IMAGE::ReadRS274XCommand( char buff[GERBER_BUFZ], char*& text )
         }
 
         // end of current line, read another one.
-        if( fgets( buff, GERBER_BUFZ, m_Current_File ) == NULL )
+        if( m_Current_File->ReadLine() == NULL )
         {
             // end of file
             ok = false;
             break;
         }
 
-        text = buff;
+        text = m_Current_File->Line();
     }
 
 exit:
@@ -181,9 +184,7 @@ exit:
 }
 
 
-bool GERBER_IMAGE::ExecuteRS274XCommand( int       command,
-                                   char buff[GERBER_BUFZ],
-                                   char*&    text )
+bool GERBER_IMAGE::ExecuteRS274XCommand( int command, char*& text )
 {
     int      code;
     int      seq_len;    // not used, just provided
@@ -299,7 +300,7 @@ bool GERBER_IMAGE::ExecuteRS274XCommand( int       command,
                 msg.Printf( wxT( "Unknown id (%c) in FS command" ),
                            *text );
                 ReportMessage( msg );
-                GetEndOfBlock( buff, text, m_Current_File );
+                GetEndOfBlock( text, m_Current_File );
                 ok = false;
                 break;
             }
@@ -353,7 +354,7 @@ bool GERBER_IMAGE::ExecuteRS274XCommand( int       command,
         m_IsX2_file = true;
     {
         X2_ATTRIBUTE dummy;
-        dummy.ParseAttribCmd( m_Current_File, buff, GERBER_BUFZ, text );
+        dummy.ParseAttribCmd( m_Current_File, text );
         if( dummy.IsFileFunction() )
         {
             delete m_FileFunction;
@@ -451,6 +452,7 @@ bool GERBER_IMAGE::ExecuteRS274XCommand( int       command,
         GetLayerParams().m_XRepeatCount = 1;
         GetLayerParams().m_YRepeatCount = 1;            // The repeat count
         GetLayerParams().m_StepForRepeatMetric = m_GerbMetric;  // the step units
+        GetLayerParams().m_RepeatOffsets.reset();       // a new grid for the new block
         while( *text && *text != '*' )
         {
             switch( *text )
@@ -602,24 +604,38 @@ bool GERBER_IMAGE::ExecuteRS274XCommand( int       command,
         line[sizeof(line)-1] = '\0';
 
         strtok( line, "*%%\n\r" );
-        m_FilesList[m_FilesPtr] = m_Current_File;
 
-        m_Current_File = fopen( line, "rt" );
-        if( m_Current_File == 0 )
         {
-            msg.Printf( wxT( "include file <%s> not found." ), line );
-            ReportMessage( msg );
-            ok = false;
-            m_Current_File = m_FilesList[m_FilesPtr];
-            break;
+            // A relative name is relative to the main file, not to the working directory,
+            // which is shared by the images reading their files at once
+            wxFileName includeFile( FROM_UTF8( line ) );
+
+            if( includeFile.IsRelative() )
+                includeFile.MakeAbsolute( wxPathOnly( m_FileName ) );
+
+            try
+            {
+                LINE_READER* reader = new MAPPED_FILE_LINE_READER( includeFile.GetFullPath(),
+                                                                   0, GERBER_LINE_MAX );
+
+                // the text of the including file stays valid in the line buffer of its
+                // reader, until the end of this command
+                m_FilesList[m_FilesPtr++] = m_Current_File;
+                m_Current_File = reader;
+            }
+            catch( const IO_ERROR& )
+            {
+                msg.Printf( wxT( "include file <%s> not found." ), line );
+                ReportMessage( msg );
+                ok = false;
+            }
         }
-        m_FilesPtr++;
         break;
 
     case AP_MACRO:  // lines like %AMMYMACRO*
                     // 5,1,8,0,0,1.08239X$1,22.5*
                     // %
-        /*ok = */ReadApertureMacro( buff, text, m_Current_File );
+        /*ok = */ReadApertureMacro( text, m_Current_File );
         break;
 
     case AP_DEFINITION:
@@ -818,17 +834,17 @@ bool GERBER_IMAGE::ExecuteRS274XCommand( int       command,
 
     (void) seq_len;     // quiet g++, or delete the unused variable.
 
-    ok = GetEndOfBlock( buff, text, m_Current_File );
+    ok = GetEndOfBlock( text, m_Current_File );
 
     return ok;
 }
 
 
-bool GetEndOfBlock( char buff[GERBER_BUFZ], char*& text, FILE* gerber_file )
+bool GetEndOfBlock( char*& text, LINE_READER* aReader )
 {
     for( ; ; )
     {
-        while( (text < buff + GERBER_BUFZ) && *text )
+        while( *text )
         {
             if( *text == '*' )
                 return true;
@@ -839,10 +855,10 @@ bool GetEndOfBlock( char buff[GERBER_BUFZ], char*& text, FILE* gerber_file )
             text++;
         }
 
-        if( fgets( buff, GERBER_BUFZ, gerber_file ) == NULL )
+        if( aReader->ReadLine() == NULL )
             break;
 
-        text = buff;
+        text = aReader->Line();
     }
 
     return false;
@@ -854,13 +870,13 @@ bool GetEndOfBlock( char buff[GERBER_BUFZ], char*& text, FILE* gerber_file )
  * test for an end of line
  * if an end of line is found:
  *   read a new line
- * @param aBuff = buffer (size = GERBER_BUFZ) to fill with a new line
- * @param aText = pointer to the last useful char in aBuff
+ * @param aText = pointer to the last useful char in the line buffer of aReader
  *          on return: points the beginning of the next line.
- * @param aFile = the opened GERBER file to read
+ * @param aReader = the opened GERBER file to read, its line buffer is filled with
+ *          the new line
  * @return a pointer to the beginning of the next line or NULL if end of file
 */
-static char* GetNextLine(  char aBuff[GERBER_BUFZ], char* aText, FILE* aFile  )
+static char* GetNextLine( char* aText, LINE_READER* aReader )
 {
     for( ; ; )
     {
@@ -873,9 +889,9 @@ static char* GetNextLine(  char aBuff[GERBER_BUFZ], char* aText, FILE* aFile  )
                 break;
 
             case 0:    // End of text found in aBuff: Read a new string
-                if( fgets( aBuff, GERBER_BUFZ, aFile ) == NULL )
+                if( aReader->ReadLine() == NULL )
                     return NULL;
-                aText = aBuff;
+                aText = aReader->Line();
                 return aText;
 
             default:
@@ -886,9 +902,7 @@ static char* GetNextLine(  char aBuff[GERBER_BUFZ], char* aText, FILE* aFile  )
 }
 
 
-bool GERBER_IMAGE::ReadApertureMacro( char buff[GERBER_BUFZ],
-                                char*&    text,
-                                FILE*     gerber_file )
+bool GERBER_IMAGE::ReadApertureMacro( char*& text, LINE_READER* aReader )
 {
     wxString       msg;
     APERTURE_MACRO am;
@@ -911,7 +925,7 @@ bool GERBER_IMAGE::ReadApertureMacro( char buff[GERBER_BUFZ],
         if( *text == '*' )
             ++text;
 
-        text = GetNextLine( buff, text, gerber_file );  // Get next line
+        text = GetNextLine( text, aReader );  // Get next line
         if( text == NULL )  // End of File
             return false;
 
@@ -934,7 +948,7 @@ bool GERBER_IMAGE::ReadApertureMacro( char buff[GERBER_BUFZ],
         {
             am.m_localparamStack.push_back( AM_PARAM() );
             AM_PARAM& param = am.m_localparamStack.back();
-            text = GetNextLine(  buff, text, gerber_file );
+            text = GetNextLine( text, aReader );
             if( text == NULL)   // End of File
                 return false;
             param.ReadParam( text );
@@ -943,7 +957,7 @@ bool GERBER_IMAGE::ReadApertureMacro( char buff[GERBER_BUFZ],
         else if( !isdigit(*text)  )     // Ill. symbol
         {
             msg.Printf( wxT( "RS274X: Aperture Macro \"%s\": ill. symbol, line: \"%s\"" ),
-                        GetChars( am.name ), GetChars( FROM_UTF8( buff ) ) );
+                        GetChars( am.name ), GetChars( FROM_UTF8( aReader->Line() ) ) );
             ReportMessage( msg );
             primitive_type = AMP_COMMENT;
         }
@@ -996,7 +1010,7 @@ bool GERBER_IMAGE::ReadApertureMacro( char buff[GERBER_BUFZ],
         default:
             // @todo, there needs to be a way of reporting the line number
             msg.Printf( wxT( "RS274X: Aperture Macro \"%s\": Invalid primitive id code %d, line: \"%s\"" ),
-                        GetChars( am.name ), primitive_type,  GetChars( FROM_UTF8( buff ) ) );
+                        GetChars( am.name ), primitive_type,  GetChars( FROM_UTF8( aReader->Line() ) ) );
             ReportMessage( msg );
             return false;
         }
@@ -1011,7 +1025,7 @@ bool GERBER_IMAGE::ReadApertureMacro( char buff[GERBER_BUFZ],
 
             AM_PARAM& param = prim.params.back();
 
-            text = GetNextLine(  buff, text, gerber_file );
+            text = GetNextLine( text, aReader );
 
             if( text == NULL)   // End of File
                 return false;
@@ -1045,7 +1059,7 @@ bool GERBER_IMAGE::ReadApertureMacro( char buff[GERBER_BUFZ],
 
                 AM_PARAM& param = prim.params.back();
 
-                text = GetNextLine(  buff, text, gerber_file );
+                text = GetNextLine( text, aReader );
 
                 if( text == NULL )  // End of File
                     return false;
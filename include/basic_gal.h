@@ -25,6 +25,8 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <boost/thread/recursive_mutex.hpp>
+
 #include <plot_common.h>
 
 #include <gal/stroke_font.h>
@@ -160,4 +162,8 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/// basic_gal is shared by all the threads, e.g. by the layers or the sheets plotted
+/// concurrently: its users hold this lock while they set its state and use it
+extern boost::recursive_mutex basic_gal_lock;
+
 #endif      // define BASIC_GAL_H
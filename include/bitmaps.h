@@ -54,7 +54,9 @@ typedef const BITMAP_OPAQUE *BITMAP_DEF;
 /**
  * Function KiBitmap
  * constructs a wxBitmap from a memory record, held in a
- * BITMAP_DEF.
+ * BITMAP_DEF.  The record is decoded once, by the first call, and the bitmaps
+ * returned share the decoded data: copy the bitmap before drawing into it.
+ * Call it from the GUI thread only.
  */
 wxBitmap KiBitmap( BITMAP_DEF aBitmap );
 
@@ -0,0 +1,137 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file chunked_pool.h
+ * @brief Allocation of the numerous small items of a board in contiguous chunks.
+ */
+
+#ifndef CHUNKED_POOL_H_
+#define CHUNKED_POOL_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+
+/**
+ * Class CHUNKED_POOL
+ * allocates slots of a fixed size in chunks of contiguous memory.  The items allocated
+ * one after the other, like the tracks of a board being loaded, are neighbours in memory,
+ * so the traversals of their lists read the memory in sequence instead of jumping around
+ * the heap.  The slots never move, their addresses are stable handles.
+ *
+ * The freed slots are reused by the next allocations.  The chunks are kept for the life
+ * of the process: the pools returned by ForSize() are never destroyed, so the items can
+ * be freed at any time, even by static destructors.  A pool can be used by several
+ * threads.
+ *
+ * A class allocated from the pools declares the operators of CHUNKED_POOL_ALLOCATED.
+ */
+class CHUNKED_POOL
+{
+public:
+    /**
+     * Constructor CHUNKED_POOL
+     * @param aSlotSize is the size of the slots, in bytes.
+     * @param aChunkSize is the size of the chunks of slots, in bytes.
+     */
+    CHUNKED_POOL( size_t aSlotSize, size_t aChunkSize = 65536 );
+    ~CHUNKED_POOL();
+
+    /**
+     * Function Allocate
+     * @return a free slot.  Throws std::bad_alloc when the memory is exhausted.
+     */
+    void* Allocate();
+
+    /**
+     * Function Free
+     * returns aSlot, allocated by this pool, to the pool.
+     */
+    void Free( void* aSlot );
+
+    /**
+     * Function ForSize
+     * @return the pool of the process for the objects of aSize bytes, or NULL if the
+     * objects are too large to be pooled, and are allocated by the global operator new.
+     */
+    static CHUNKED_POOL* ForSize( size_t aSize );
+
+    /// The size of the largest objects allocated from the pools
+    static const size_t MAX_POOLED_SIZE = 1024;
+
+private:
+    // Not copyable: the pool owns its chunks
+    CHUNKED_POOL( const CHUNKED_POOL& );
+    CHUNKED_POOL& operator=( const CHUNKED_POOL& );
+
+    /// A free slot, the start of its memory is the link to the next free slot
+    struct FREE_SLOT
+    {
+        FREE_SLOT* m_next;
+    };
+
+    size_t              m_slotSize;
+    size_t              m_slotsPerChunk;
+    std::vector<char*>  m_chunks;
+
+    /// The free slots, the last one freed first
+    FREE_SLOT*          m_freeSlots;
+
+    /// The slots of the last chunk never allocated yet
+    char*               m_nextSlot;
+    char*               m_chunkEnd;
+
+    boost::mutex        m_lock;
+};
+
+
+/**
+ * Macro DECLARE_CHUNKED_POOL_ALLOCATION
+ * declares in a class the operators new and delete which allocate its objects, and the
+ * objects of its derived classes, from CHUNKED_POOL::ForSize().  The class destructor has
+ * to be virtual, so that operator delete is given the size of the real object.
+ */
+#define DECLARE_CHUNKED_POOL_ALLOCATION                                     \
+    static void* operator new( size_t aSize )                               \
+    {                                                                       \
+        CHUNKED_POOL* pool = CHUNKED_POOL::ForSize( aSize );                \
+        return pool ? pool->Allocate() : ::operator new( aSize );           \
+    }                                                                       \
+                                                                            \
+    static void operator delete( void* aItem, size_t aSize )                \
+    {                                                                       \
+        if( !aItem )                                                        \
+            return;                                                         \
+                                                                            \
+        CHUNKED_POOL* pool = CHUNKED_POOL::ForSize( aSize );                \
+                                                                            \
+        if( pool )                                                          \
+            pool->Free( aItem );                                            \
+        else                                                                \
+            ::operator delete( aItem );                                     \
+    }
+
+#endif  // CHUNKED_POOL_H_
@@ -214,8 +214,9 @@ public:
 
     /**
      * Function UnLink
-     * detaches this object from its owner.  This base class implementation
-     * should work for all derived classes which are held in a DLIST<>.
+     * detaches this object from its owner, and notifies the listeners of its board.
+     * This base class implementation should work for all derived classes which are
+     * held in a DLIST<>.
      */
     virtual void UnLink();
 
@@ -315,6 +316,15 @@ public:
      */
     static std::string FormatInternalUnits( int aValue );
 
+    /**
+     * Function FormatInternalUnits
+     * converts \a aValue like above, into \a aBuffer, without any allocation.
+     *
+     * @param aBuffer must have room for at least 50 bytes, the result is nul terminated.
+     * @return the length of the converted value.
+     */
+    static int FormatInternalUnits( int aValue, char* aBuffer );
+
     /**
      * Function FormatAngle
      * converts \a aAngle from board units to a string appropriate for writing to file.
@@ -198,11 +198,15 @@ protected:
     void onPaint( wxPaintEvent& WXUNUSED( aEvent ) );
     void onSize( wxSizeEvent& aEvent );
     void onEvent( wxEvent& aEvent );
+    void onIdle( wxIdleEvent& aEvent );
     void onEnter( wxEvent& aEvent );
     void onLostFocus( wxFocusEvent& aEvent );
     void onRefreshTimer( wxTimerEvent& aEvent );
     void onShowTimer( wxTimerEvent& aEvent );
 
+    /// Draws the timings of the last frame, see KIGFX::FRAME_PROFILER
+    void drawProfilerOverlay();
+
     static const int MinRefreshPeriod = 17;             ///< 60 FPS.
 
     /// Pointer to the parent window
@@ -251,6 +255,9 @@ protected:
     /// for cases when the panel loses keyboard focus, so it does not react to hotkeys anymore.
     bool                     m_lostFocus;
 
+    /// Are the frame timings displayed on the canvas?
+    bool                     m_profilerOverlay;
+
     /// Grid style setting string
     static const wxChar GRID_STYLE_CFG[];
 };
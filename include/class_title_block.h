@@ -130,6 +130,11 @@ public:
         m_tbTexts.Clear();
     }
 
+    bool operator==( const TITLE_BLOCK& aOther ) const
+    {
+        return m_tbTexts == aOther.m_tbTexts;
+    }
+
     /**
      * Function Format
      * outputs the object to \a aFormatter in s-expression form.
@@ -188,6 +188,11 @@ extern EDA_COLOR_T  g_GhostColor;
  * to read/print files with fp numbers.
  * Its destructor insures that the default locale is restored if an exception
  * is thrown, or not.
+ *
+ * Only the locale of the calling thread is switched: the other threads, and the user
+ * interface, keep the user locale.  The tasks queued on the THREAD_POOL by a thread in
+ * the "C" locale run in the "C" locale too.  The numbers of the files are better
+ * converted with the functions of numeric_io.h, which need no LOCALE_IO at all.
  */
 class LOCALE_IO
 {
@@ -195,15 +200,21 @@ public:
     LOCALE_IO();
     ~LOCALE_IO();
 
-private:
-    void setUserLocale( const char* aUserLocale );
-
-    // allow for nesting of LOCALE_IO instantiations
-    static int  m_c_count;
+    /**
+     * Function IsActive
+     * @return bool - true if the calling thread is in the scope of a LOCALE_IO.
+     */
+    static bool IsActive();
 
-    // The locale in use before switching to the "C" locale
-    // (the locale can be set by user, and is not always the system locale)
+private:
+#if defined( _WIN32 )
+    // The _configthreadlocale() mode of the thread, and its locale, before the switch
+    int         m_threadLocaleMode;
     std::string m_user_locale;
+#else
+    // The locale_t of the thread before the switch, restored by uselocale()
+    void*       m_user_locale;
+#endif
 };
 
 
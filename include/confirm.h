@@ -33,6 +33,21 @@
 
 #include <wx/window.h>
 
+/**
+ * Function SetBatchMode
+ * sets the batch mode of the command line jobs, without a user: the messages
+ * of the functions below are then written to the standard error output instead
+ * of a dialog, and the questions get the answer no, or cancel.
+ */
+void SetBatchMode( bool aBatchMode );
+
+/**
+ * Function IsBatchMode
+ * @return true if the messages go to the standard error output, see SetBatchMode().
+ */
+bool IsBatchMode();
+
+
 /**
  * Function DisplayExitDialog
  * displays a dialog with 3 buttons:
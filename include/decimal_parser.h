@@ -0,0 +1,141 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file decimal_parser.h
+ * @brief Locale independent conversion of the decimal numbers of the KiCad files.
+ */
+
+#ifndef __DECIMAL_PARSER_H
+#define __DECIMAL_PARSER_H
+
+#include <climits>
+#include <stdint.h>
+
+/**
+ * Struct DECIMAL_NUMBER
+ * is a number in the fixed notation KiCad writes its files with ("-12.345"): a sign,
+ * an integer made of all the digits, and the count of digits after the decimal point.
+ */
+struct DECIMAL_NUMBER
+{
+    bool        negative;
+    uint64_t    digits;
+    int         decimals;
+
+    /**
+     * Function Parse
+     * reads the whole of @a aText as a number in fixed notation.
+     * @return false if @a aText is something else, like an exponent, a leading blank or
+     * a trailing character, or if it has more than 18 significant digits.
+     */
+    bool Parse( const char* aText )
+    {
+        const char* cc = aText;
+        bool any = false;
+        int  significant = 0;
+
+        negative = ( *cc == '-' );
+
+        if( *cc == '-' || *cc == '+' )
+            ++cc;
+
+        digits = 0;
+        decimals = 0;
+
+        for( ; *cc >= '0' && *cc <= '9'; ++cc )
+        {
+            if( digits || *cc != '0' )
+                ++significant;
+
+            digits = digits * 10 + ( *cc - '0' );
+            any = true;
+        }
+
+        if( *cc == '.' )
+        {
+            for( ++cc; *cc >= '0' && *cc <= '9'; ++cc, ++decimals )
+            {
+                if( digits || *cc != '0' )
+                    ++significant;
+
+                digits = digits * 10 + ( *cc - '0' );
+                any = true;
+            }
+        }
+
+        return *cc == 0 && any && significant <= 18;
+    }
+
+    /**
+     * Function ToDouble
+     * sets @a aValue to the double nearest to the number, which is what strtod() returns.
+     * @return false if the exactness cannot be guaranteed: more than 15 significant
+     * digits, or more than 22 decimals.
+     */
+    bool ToDouble( double& aValue ) const
+    {
+        static const double powersOf10[] =
+        {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        // The digits and the power of 10 are both exact doubles, so the division is
+        // correctly rounded, as is the conversion of strtod()
+        if( digits >= 1000000000000000ull || decimals > 22 )
+            return false;
+
+        aValue = (double) digits / powersOf10[decimals];
+
+        if( negative )
+            aValue = -aValue;
+
+        return true;
+    }
+
+    /**
+     * Function ToMillionths
+     * sets @a aValue to the number times 1000000, which is KiROUND( strtod() * 1e6 ) for
+     * the numbers with at most 6 decimals: the nanometres of a length in mm.
+     * @return false if there are more decimals, or if the result does not fit an int.
+     */
+    bool ToMillionths( int& aValue ) const
+    {
+        static const unsigned scales[] = { 1000000, 100000, 10000, 1000, 100, 10, 1 };
+
+        if( decimals > 6 || digits > (uint64_t) INT_MAX )
+            return false;
+
+        uint64_t value = digits * scales[decimals];
+
+        if( value > (uint64_t) INT_MAX )
+            return false;
+
+        aValue = negative ? -(int) value : (int) value;
+
+        return true;
+    }
+};
+
+#endif /* __DECIMAL_PARSER_H */
@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file deflate_writer.h
+ */
+
+#ifndef DEFLATE_WRITER_H_
+#define DEFLATE_WRITER_H_
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <wx/zstream.h>
+
+#include <thread_pool.h>
+
+
+/**
+ * Class DEFLATE_WRITER
+ * compresses in the zlib format a stream written in small pieces, as the content stream
+ * of a PDF page.  The data is gathered in chunks, and each full chunk is compressed by
+ * a task of the thread pool while the next one is filled: the writing does not wait for
+ * the compression, and the memory used is two chunks, whatever the length of the stream.
+ *
+ * The compressed data goes to a FILE, or to a string.
+ */
+class DEFLATE_WRITER
+{
+public:
+    /// The default size of a chunk
+    static const size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+    /**
+     * Constructor DEFLATE_WRITER
+     * @param aOutput is the file receiving the compressed data, at its current position.
+     * It is written by the compression tasks until Finish().
+     * @param aLevel is the zlib compression level, from 0 (no compression) to 9 (the
+     * best compression), or -1 for the zlib default.
+     */
+    DEFLATE_WRITER( FILE* aOutput, int aLevel, size_t aChunkSize = DEFAULT_CHUNK_SIZE );
+
+    /**
+     * Constructor DEFLATE_WRITER
+     * @param aOutput is the string receiving the compressed data, appended to it
+     */
+    DEFLATE_WRITER( std::string* aOutput, int aLevel, size_t aChunkSize = DEFAULT_CHUNK_SIZE );
+
+    ~DEFLATE_WRITER();
+
+    void Write( const char* aData, size_t aSize );
+
+    void Puts( const char* aText )      { Write( aText, strlen( aText ) ); }
+
+    void Putc( char aChar )
+    {
+        m_filling += aChar;
+
+        if( m_filling.size() >= m_chunkSize )
+            flushChunk();
+    }
+
+    /// Writes formatted text, as fprintf()
+    void Printf( const char* aFormat, ... );
+
+    /**
+     * Function Finish
+     * compresses the remaining data and ends the zlib stream.  Nothing can be written
+     * after it.
+     * @return the size of the compressed data.
+     */
+    size_t Finish();
+
+private:
+    /// The wxOutputStream receiving the data of the zlib stream
+    class SINK : public wxOutputStream
+    {
+    public:
+        SINK( FILE* aFile, std::string* aString ) :
+            m_file( aFile ), m_string( aString ), m_count( 0 )
+        {
+        }
+
+        size_t GetCount() const { return m_count; }
+
+    protected:
+        size_t OnSysWrite( const void* aBuffer, size_t aSize );
+
+    private:
+        FILE*           m_file;
+        std::string*    m_string;
+        size_t          m_count;
+    };
+
+    void init( int aLevel );
+
+    // queues the compression of the chunk being filled, once the previous one is done
+    void flushChunk();
+
+    // the task compressing m_compressing
+    void compressChunk();
+
+    SINK                    m_sink;
+    wxZlibOutputStream*     m_zlib;
+    size_t                  m_chunkSize;
+    std::string             m_filling;      // the chunk being written
+    std::string             m_compressing;  // the chunk being compressed
+    TASK_GROUP              m_tasks;        // the compression of m_compressing
+};
+
+#endif  // DEFLATE_WRITER_H_
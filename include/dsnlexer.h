@@ -26,6 +26,7 @@
 #define DSNLEXER_H_
 
 #include <stdio.h>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <hashtables.h>
@@ -42,6 +43,68 @@ struct KEYWORD
     const char* name;       ///< unique keyword.
     int         token;      ///< a zero based index into an array of KEYWORDs
 };
+
+
+/**
+ * Class KEYWORD_HASH
+ * is a perfect hash of a KEYWORD table: each keyword has its own slot in the table, so
+ * a lookup is a hash of the token text, and a single comparison.  The table is built
+ * at construction, using the "hash and displace" method: the keywords are spread in
+ * small buckets, and each bucket gets a displacement to move its keywords to free slots.
+ * The lexers generated by TokenList2DsnLexer.cmake own a static KEYWORD_HASH, shared by
+ * all their instances.
+ */
+class KEYWORD_HASH
+{
+public:
+    KEYWORD_HASH( const KEYWORD* aKeywords, unsigned aCount );
+
+    /**
+     * Function Find
+     * returns the token of the keyword @a aText of @a aLength bytes, or DSN_SYMBOL if
+     * @a aText is not a keyword.
+     */
+    int Find( const char* aText, size_t aLength ) const;
+
+private:
+    struct SLOT
+    {
+        const char* name;
+        size_t      length;
+        int         token;
+    };
+
+    static uint64_t hash( const char* aText, size_t aLength )
+    {
+        uint64_t h = 14695981039346656037ull;      // FNV-1a
+
+        for( size_t i = 0; i < aLength; ++i )
+        {
+            h ^= (unsigned char) aText[i];
+            h *= 1099511628211ull;
+        }
+
+        return h;
+    }
+
+    unsigned slot( uint64_t aHash, unsigned aDisplacement ) const
+    {
+        uint64_t h = aHash + aDisplacement * 0x9e3779b97f4a7c15ull;
+
+        // the MurmurHash3 finalizer, mixing the displacement in all the bits
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+
+        return (unsigned) h & m_mask;
+    }
+
+    bool build( const KEYWORD* aKeywords, unsigned aCount, unsigned aSlotCount );
+
+    std::vector<SLOT>       m_slots;
+    std::vector<unsigned>   m_displacements;
+    unsigned                m_mask;
+};
 #endif
 
 // something like this macro can be used to help initialize a KEYWORD table.
@@ -110,7 +173,8 @@ protected:
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
-    KEYWORD_MAP         keyword_hash;           ///< fast, specialized "C string" hashtable
+    const KEYWORD_HASH* keywordHash;            ///< perfect hash of keywords
+    KEYWORD_HASH*       ownKeywordHash;         ///< keywordHash, when built by this lexer
 
     void init();
 
@@ -142,7 +206,10 @@ protected:
      * @return int - with a value from the enum DSN_T matching the keyword text,
      *         or DSN_SYMBOL if @a aToken is not in the kewords table.
      */
-    int findToken( const std::string& aToken );
+    int findToken( const std::string& aToken )
+    {
+        return keywordHash->Find( aToken.data(), aToken.size() );
+    }
 
     bool isStringTerminator( char cc )
     {
@@ -169,9 +236,11 @@ public:
      * @param aKeywordCount is the count of tokens in aKeywordTable.
      * @param aFile is an open file, which will be closed when this is destructed.
      * @param aFileName is the name of the file
+     * @param aKeywordHash is the perfect hash of aKeywordTable, or NULL to build one.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              FILE* aFile, const wxString& aFileName );
+              FILE* aFile, const wxString& aFileName,
+              const KEYWORD_HASH* aKeywordHash = NULL );
 
     /**
      * Constructor ( const KEYWORD*, unsigned, const std::string&, const wxString& )
@@ -182,9 +251,11 @@ public:
      * @param aKeywordCount is the count of tokens in aKeywordTable.
      * @param aSExpression is text to feed through a STRING_LINE_READER
      * @param aSource is a description of aSExpression, used for error reporting.
+     * @param aKeywordHash is the perfect hash of aKeywordTable, or NULL to build one.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              const std::string& aSExpression, const wxString& aSource = wxEmptyString );
+              const std::string& aSExpression, const wxString& aSource = wxEmptyString,
+              const KEYWORD_HASH* aKeywordHash = NULL );
 
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -209,9 +280,11 @@ public:
      *
      * @param aLineReader is any subclassed instance of LINE_READER, such as
      *  STRING_LINE_READER or FILE_LINE_READER.  No ownership is taken.
+     *
+     * @param aKeywordHash is the perfect hash of aKeywordTable, or NULL to build one.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              LINE_READER* aLineReader = NULL );
+              LINE_READER* aLineReader = NULL, const KEYWORD_HASH* aKeywordHash = NULL );
 
     virtual ~DSNLEXER();
 
@@ -397,6 +470,13 @@ public:
      */
     static bool IsSymbol( int aTok );
 
+    /**
+     * Function IsNumber
+     * returns true if the text [@a aStart, @a aLimit) is a DSN_NUMBER token: an integer,
+     * a fixed point or a float with exponent.
+     */
+    static bool IsNumber( const char* aStart, const char* aLimit );
+
     /**
      * Function Expecting
      * throws an IO_ERROR exception with an input file specific error message.
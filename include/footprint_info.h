@@ -30,11 +30,16 @@
 #define FOOTPRINT_INFO_H_
 
 
+#include <map>
+#include <vector>
+
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/foreach.hpp>
 
 #include <ki_mutex.h>
 #include <kicad_string.h>
+#include <project.h>
 
 
 #define USE_FPI_LAZY            0   // 1:yes lazy,  0:no early
@@ -45,6 +50,88 @@ class FOOTPRINT_LIST;
 class wxTopLevelWindow;
 
 
+/**
+ * Class FOOTPRINT_INDEX
+ * is the persistent index of the footprint libraries.  It holds the names, the
+ * documentation and the pad counts of the footprints of each library, along with a
+ * timestamp of the library files, so that only the libraries modified since the index
+ * was saved have to be read again.
+ */
+class FOOTPRINT_INDEX
+{
+public:
+    ///> The indexed information of a footprint
+    struct ENTRY
+    {
+        wxString    m_fpname;
+        wxString    m_doc;
+        wxString    m_keywords;
+        int         m_pad_count;
+        int         m_unique_pad_count;
+    };
+
+    ///> The indexed footprints of a library
+    struct LIBRARY
+    {
+        wxString            m_uri;          ///< full URI, environment variables substituted
+        wxString            m_timestamp;    ///< see LibraryTimestamp()
+        std::vector<ENTRY>  m_entries;
+    };
+
+    FOOTPRINT_INDEX() :
+        m_loaded( false ),
+        m_modified( false )
+    {
+    }
+
+    ///> Returns the name of the index file, in the KiCad configuration directory
+    static wxString GetFileName();
+
+    /**
+     * Function LibraryTimestamp
+     * returns a string which changes whenever a file of the library @a aLibraryPath is
+     * added, removed or modified, or an empty string if the library is not a local file
+     * or directory.  The libraries without a timestamp are never indexed.
+     */
+    static wxString LibraryTimestamp( const wxString& aLibraryPath );
+
+    bool IsLoaded() const       { return m_loaded; }
+    bool IsModified() const     { return m_modified; }
+
+    /**
+     * Function Load
+     * reads the index file @a aFileName.  A missing or unreadable index is empty.
+     */
+    void Load( const wxString& aFileName );
+
+    /**
+     * Function Save
+     * writes the index to the file @a aFileName.
+     * @return false if the file could not be written.
+     */
+    bool Save( const wxString& aFileName );
+
+    /**
+     * Function Find
+     * copies to @a aLibrary the footprints of the library @a aNickname, if they were
+     * indexed from the same URI and timestamp.
+     * @return true if the library was found.
+     */
+    bool Find( const wxString& aNickname, const wxString& aURI, const wxString& aTimestamp,
+               LIBRARY& aLibrary ) const;
+
+    ///> Replaces the footprints of the library @a aNickname
+    void Set( const wxString& aNickname, const LIBRARY& aLibrary );
+
+private:
+    typedef std::map<wxString, LIBRARY> LIBRARIES;
+
+    LIBRARIES   m_libraries;
+    bool        m_loaded;
+    bool        m_modified;
+};
+
+
 /*
  * Class FOOTPRINT_INFO
  * is a helper class to handle the list of footprints available in libraries. It stores
@@ -76,6 +163,21 @@ public:
 #endif
     }
 
+    /// Creates the information of a footprint from the FOOTPRINT_INDEX, without reading it
+    FOOTPRINT_INFO( FOOTPRINT_LIST* aOwner, const wxString& aNickname,
+                    const FOOTPRINT_INDEX::ENTRY& aEntry ) :
+        m_owner( aOwner ),
+        m_loaded( true ),
+        m_nickname( aNickname ),
+        m_fpname( aEntry.m_fpname ),
+        m_num( 0 ),
+        m_pad_count( aEntry.m_pad_count ),
+        m_unique_pad_count( aEntry.m_unique_pad_count ),
+        m_doc( aEntry.m_doc ),
+        m_keywords( aEntry.m_keywords )
+    {
+    }
+
     const wxString& GetDoc()
     {
         ensure_loaded();
@@ -173,10 +275,20 @@ class FOOTPRINT_LIST
     MUTEX   m_errors_lock;
     MUTEX   m_list_lock;
 
+    FOOTPRINT_INDEX m_index;            ///< the libraries read by the previous sessions
+    MUTEX           m_index_lock;
+
+    /// the URI and timestamp of each library read, by nickname, see IsUpToDate()
+    typedef std::map<wxString, wxString> LIBRARY_STAMPS;
+
+    LIBRARY_STAMPS  m_library_stamps;   ///< under m_index_lock
+    bool            m_all_libraries;    ///< all the libraries of m_lib_table were read
+
     /**
      * Function loader_job
      * loads footprints from @a aNicknameList and calls AddItem() on to help fill
-     * m_list.
+     * m_list.  The libraries not modified since they were indexed are not read, their
+     * footprints come from m_index.
      *
      * @param aNicknameList is a wxString[] holding libraries to load all footprints from.
      * @param aJobZ is the size of the job, i.e. the count of nicknames.
@@ -197,7 +309,8 @@ public:
 
     FOOTPRINT_LIST() :
         m_lib_table( 0 ),
-        m_error_count( 0 )
+        m_error_count( 0 ),
+        m_all_libraries( false )
     {
     }
 
@@ -248,9 +361,45 @@ public:
      */
     bool ReadFootprintFiles( FP_LIB_TABLE* aTable, const wxString* aNickname = NULL );
 
+    /**
+     * Function IsUpToDate
+     * tells if the list holds all the footprints of @a aTable as they are now: all its
+     * libraries were read without error, from their current URIs, and none of their
+     * files was modified since, see FOOTPRINT_INDEX::LibraryTimestamp().  The remote
+     * libraries, which have no timestamp, are assumed to be unchanged.
+     */
+    bool IsUpToDate( FP_LIB_TABLE* aTable ) const;
+
     void DisplayErrors( wxTopLevelWindow* aCaller = NULL );
 
     FP_LIB_TABLE* GetTable() const { return m_lib_table; }
 };
 
+
+/**
+ * Class SHARED_FOOTPRINT_LIST
+ * is the FOOTPRINT_LIST of all the footprint libraries of a project, kept by the
+ * PROJECT so that the frames of all the kifaces share it instead of each reading
+ * the libraries again, see PROJECT::PcbFootprintList().
+ *
+ * A list is never modified once read: the readers keep a snapshot of it, which stays
+ * valid while the libraries are read again into a new list by Get().
+ */
+class SHARED_FOOTPRINT_LIST : public PROJECT::_ELEM
+{
+public:
+    /**
+     * Function Get
+     * returns the list of the footprints of all the libraries of @a aTable, and reads
+     * it first if the libraries were modified since the current list was read, see
+     * FOOTPRINT_LIST::IsUpToDate().  The errors of the libraries are in the list.
+     */
+    boost::shared_ptr<FOOTPRINT_LIST> Get( FP_LIB_TABLE* aTable );
+
+private:
+    boost::shared_ptr<FOOTPRINT_LIST>   m_list;
+    MUTEX                               m_read_lock;    ///< one reader of the libraries
+    MUTEX                               m_list_lock;    ///< for m_list
+};
+
 #endif  // FOOTPRINT_INFO_H_
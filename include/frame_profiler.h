@@ -0,0 +1,270 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file frame_profiler.h
+ * @brief Per-phase timers and counters of the GAL frames.
+ */
+
+#ifndef __FRAME_PROFILER_H
+#define __FRAME_PROFILER_H
+
+#include <cstdio>
+#include <profile.h>
+
+namespace KIGFX
+{
+/**
+ * Class FRAME_PROFILER
+ * accumulates the time spent in each phase of a GAL frame, and counts the items and
+ * vertices handled by the frame. It is disabled by default, and then costs a test per
+ * measured call. The timers measure the CPU side: OpenGL calls are asynchronous, so the
+ * time the GPU takes to render shows up in the SWAP phase.
+ *
+ * The profiler is enabled by setting the KICAD_GAL_PROFILE environment variable to
+ * "overlay", to display the timings on the canvas, or to the name of a CSV file to
+ * write a line per frame to.
+ */
+class FRAME_PROFILER
+{
+public:
+    ///> Measured phases of a frame
+    enum PHASE
+    {
+        UPDATE_ITEMS,       ///< VIEW::UpdateItems(), caching the modified items
+        REDRAW,             ///< VIEW::Redraw(), the layer trees traversal and the drawing
+        PAINT,              ///< painter calls of VIEW::Redraw(), part of REDRAW
+        CACHED_DRAW,        ///< GPU_CACHED_MANAGER::EndDrawing(), including the index upload
+        NONCACHED_DRAW,     ///< GPU_NONCACHED_MANAGER::EndDrawing()
+        COMPOSITE,          ///< OPENGL_COMPOSITOR::DrawBuffer(), blending the targets
+        SWAP,               ///< buffers swap, waiting for the GPU
+        FRAME,              ///< EDA_DRAW_PANEL_GAL::onPaint(), the whole frame
+        PHASE_COUNT
+    };
+
+    ///> Counted quantities of a frame
+    enum COUNTER
+    {
+        DRAWN_ITEMS,        ///< items drawn by VIEW::Redraw(), once per layer
+        PAINTED_ITEMS,      ///< items drawn by the painter, the others using their cache
+        CACHED_INDICES,     ///< indices of the drawn cached vertices
+        UPLOADED_INDICES,   ///< indices uploaded to the GPU
+        NONCACHED_VERTICES, ///< vertices of the non cached items
+        COALESCED_EVENTS,   ///< mouse motions replaced by a more recent one, see TOOL_MANAGER
+        COUNTER_COUNT
+    };
+
+    static FRAME_PROFILER& Instance()
+    {
+        static FRAME_PROFILER profiler;
+
+        return profiler;
+    }
+
+    ~FRAME_PROFILER()
+    {
+        CloseCsv();
+    }
+
+    bool IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    void Enable( bool aEnable )
+    {
+        m_enabled = aEnable;
+    }
+
+    void AddTime( PHASE aPhase, uint64_t aUsecs )
+    {
+        m_current[aPhase] += aUsecs;
+    }
+
+    void AddCount( COUNTER aCounter, uint64_t aCount = 1 )
+    {
+        if( m_enabled )
+            m_currentCounts[aCounter] += aCount;
+    }
+
+    /**
+     * Function EndFrame
+     * makes the measures of the current frame available, and writes them to the CSV file.
+     */
+    void EndFrame()
+    {
+        m_frames++;
+
+        for( int i = 0; i < PHASE_COUNT; i++ )
+        {
+            m_last[i] = m_current[i];
+            m_total[i] += m_current[i];
+            m_current[i] = 0;
+        }
+
+        for( int i = 0; i < COUNTER_COUNT; i++ )
+        {
+            m_lastCounts[i] = m_currentCounts[i];
+            m_currentCounts[i] = 0;
+        }
+
+        if( m_csv )
+        {
+            fprintf( m_csv, "%u", m_frames );
+
+            for( int i = 0; i < PHASE_COUNT; i++ )
+                fprintf( m_csv, ",%.3f", m_last[i] / 1000.0 );
+
+            for( int i = 0; i < COUNTER_COUNT; i++ )
+                fprintf( m_csv, ",%llu", (unsigned long long) m_lastCounts[i] );
+
+            fprintf( m_csv, "\n" );
+        }
+    }
+
+    ///> Returns the time spent in a phase by the last frame, in milliseconds
+    double LastMsecs( PHASE aPhase ) const
+    {
+        return m_last[aPhase] / 1000.0;
+    }
+
+    ///> Returns the average time spent in a phase by the frames, in milliseconds
+    double AverageMsecs( PHASE aPhase ) const
+    {
+        return m_frames ? m_total[aPhase] / 1000.0 / m_frames : 0.0;
+    }
+
+    uint64_t LastCount( COUNTER aCounter ) const
+    {
+        return m_lastCounts[aCounter];
+    }
+
+    static const char* PhaseName( PHASE aPhase )
+    {
+        static const char* names[PHASE_COUNT] =
+        {
+            "update_items", "redraw", "paint", "cached_draw", "noncached_draw",
+            "composite", "swap", "frame"
+        };
+
+        return names[aPhase];
+    }
+
+    static const char* CounterName( COUNTER aCounter )
+    {
+        static const char* names[COUNTER_COUNT] =
+        {
+            "drawn_items", "painted_items", "cached_indices", "uploaded_indices",
+            "noncached_vertices", "coalesced_events"
+        };
+
+        return names[aCounter];
+    }
+
+    /**
+     * Function OpenCsv
+     * starts writing the measures of each frame to a CSV file, the times in milliseconds.
+     * @return false if the file could not be created.
+     */
+    bool OpenCsv( const char* aFileName )
+    {
+        CloseCsv();
+
+        m_csv = fopen( aFileName, "w" );
+
+        if( !m_csv )
+            return false;
+
+        fprintf( m_csv, "frame" );
+
+        for( int i = 0; i < PHASE_COUNT; i++ )
+            fprintf( m_csv, ",%s_ms", PhaseName( (PHASE) i ) );
+
+        for( int i = 0; i < COUNTER_COUNT; i++ )
+            fprintf( m_csv, ",%s", CounterName( (COUNTER) i ) );
+
+        fprintf( m_csv, "\n" );
+
+        return true;
+    }
+
+    void CloseCsv()
+    {
+        if( m_csv )
+            fclose( m_csv );
+
+        m_csv = NULL;
+    }
+
+private:
+    FRAME_PROFILER() :
+        m_enabled( false ), m_frames( 0 ), m_csv( NULL )
+    {
+        for( int i = 0; i < PHASE_COUNT; i++ )
+            m_current[i] = m_last[i] = m_total[i] = 0;
+
+        for( int i = 0; i < COUNTER_COUNT; i++ )
+            m_currentCounts[i] = m_lastCounts[i] = 0;
+    }
+
+    bool        m_enabled;
+    unsigned    m_frames;
+    FILE*       m_csv;
+
+    uint64_t    m_current[PHASE_COUNT];
+    uint64_t    m_last[PHASE_COUNT];
+    uint64_t    m_total[PHASE_COUNT];
+
+    uint64_t    m_currentCounts[COUNTER_COUNT];
+    uint64_t    m_lastCounts[COUNTER_COUNT];
+};
+
+
+/**
+ * Class FRAME_PROFILER_TIMER
+ * adds the time elapsed during its lifetime to a phase of the frame profiler.
+ */
+class FRAME_PROFILER_TIMER
+{
+public:
+    FRAME_PROFILER_TIMER( FRAME_PROFILER::PHASE aPhase ) :
+        m_phase( aPhase ), m_enabled( FRAME_PROFILER::Instance().IsEnabled() )
+    {
+        if( m_enabled )
+            m_start = get_tics();
+    }
+
+    ~FRAME_PROFILER_TIMER()
+    {
+        if( m_enabled )
+            FRAME_PROFILER::Instance().AddTime( m_phase, get_tics() - m_start );
+    }
+
+private:
+    FRAME_PROFILER::PHASE   m_phase;
+    bool                    m_enabled;
+    uint64_t                m_start;
+};
+} // namespace KIGFX
+
+#endif /* __FRAME_PROFILER_H */
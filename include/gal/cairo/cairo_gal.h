@@ -29,6 +29,7 @@
 
 #include <map>
 #include <iterator>
+#include <vector>
 
 #include <cairo.h>
 
@@ -329,6 +330,29 @@ private:
     unsigned int                groupCounter;       ///< Counter used for generating keys for groups
     GROUP*                      currentGroup;       ///< Currently used group
 
+    /// Fill and stroke settings of a group replay
+    typedef struct
+    {
+        bool        isFillEnabled;
+        bool        isStrokeEnabled;
+        COLOR4D     fillColor;
+        COLOR4D     strokeColor;
+    } REPLAY_STATE;
+
+    /// Group drawn to the cached target, waiting for the tiles rendering
+    typedef struct
+    {
+        int             groupNumber;                ///< Drawn group
+        REPLAY_STATE    state;                      ///< Settings the group is drawn with
+        cairo_matrix_t  matrix;                     ///< Transformation the group is drawn with
+        double          lineWidth;                  ///< Line width the group is drawn with
+    } TILED_GROUP;
+
+    // Variables for the tiles rendering
+    std::vector<TILED_GROUP>        tiledGroups;    ///< Groups to be rendered in the tiles
+    std::vector<cairo_surface_t*>   tileSurfaces;   ///< Horizontal bands of the screen
+    int                             tileHeight;     ///< Height of the bands, in pixels
+
     // Variables related to Cairo <-> wxWidgets
     cairo_matrix_t      cairoWorldScreenMatrix; ///< Cairo world to screen transformation matrix
     cairo_t*            currentContext;         ///< Currently used Cairo context for drawing
@@ -343,6 +367,27 @@ private:
     // Methods
     void storePath();                           ///< Store the actual path
 
+    /**
+     * @brief Executes the commands of a group.
+     *
+     * @param aContext is the context to execute the commands on.
+     * @param aGroupNumber is the group number.
+     * @param aState is the fill and stroke settings, updated by the group commands.
+     * @param aDraw tells if the paths are drawn, or if only the settings and the
+     * transformations of the group are applied.
+     */
+    void replayGroup( cairo_t* aContext, int aGroupNumber, REPLAY_STATE& aState,
+                      bool aDraw ) const;
+
+    /// Returns true if the groups drawn now are to be rendered in tiles, by several threads
+    bool isTiling() const;
+
+    /// Renders the groups waiting for the tiles in parallel, and composites the tiles
+    void drawTiles();
+
+    /// Destroys the tile surfaces, e.g. when the screen is resized
+    void deleteTiles();
+
     // Event handlers
     /**
      * @brief Paint event handler.
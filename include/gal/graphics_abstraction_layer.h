@@ -29,6 +29,7 @@
 
 #include <deque>
 #include <stack>
+#include <vector>
 #include <limits>
 
 #include <math/matrix3x3.h>
@@ -38,6 +39,8 @@
 #include <gal/stroke_font.h>
 #include <newstroke_font.h>
 
+class SHAPE_POLY_SET;
+
 namespace KIGFX
 {
 /**
@@ -149,6 +152,16 @@ public:
     virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) {};
     virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) {};
 
+    /**
+     * @brief Draw the outlines of a polygon set, e.g. the filled areas of a zone.  The holes
+     * are not drawn, the set is expected to be fractured.  The default draws each outline
+     * with DrawPolygon(), a GAL can rather use the triangles cached by
+     * SHAPE_POLY_SET::CacheTriangulation().
+     *
+     * @param aPolySet is the polygon set to draw.
+     */
+    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet );
+
     /**
      * @brief Draw a cubic bezier spline.
      *
@@ -534,6 +547,39 @@ public:
      */
     virtual void ClearCache() {};
 
+    // --------------------------------------------------------
+    // Picking methods
+    // --------------------------------------------------------
+
+    /**
+     * @brief Begin drawing groups with item ids, to find the items shown in a window of the
+     * screen.
+     *
+     * It is called out of a frame.  The groups hide each other as on the screen, by their
+     * depth, so that the id found in a pixel is the one of the item shown there.
+     *
+     * @param aPosition is the center of the window, in screen pixels.
+     * @param aRadius is the distance from the center to the sides of the window, in pixels.
+     * @return false if the items cannot be picked: DrawGroupPicking() and EndPicking() are
+     * not called then.
+     */
+    virtual bool BeginPicking( const VECTOR2D& aPosition, int aRadius ) { return false; };
+
+    /**
+     * @brief Draw a stored group with an item id.
+     *
+     * @param aGroupNumber is the group number.
+     * @param aId is the item id, from 1 to 0xFFFFFF.
+     */
+    virtual void DrawGroupPicking( int aGroupNumber, unsigned int aId ) {};
+
+    /**
+     * @brief End drawing groups with item ids.
+     *
+     * @param aIds receives the ids shown in the window, the ones closest to its center first.
+     */
+    virtual void EndPicking( std::vector<unsigned int>& aIds ) {};
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -733,6 +779,20 @@ public:
      */
     virtual void ClearTarget( RENDER_TARGET aTarget ) {};
 
+    /**
+     * @brief Restricts the clearing of and the drawing to the cached and non-cached targets
+     * to an area, until the end of the current frame. The rest of the targets keeps the
+     * contents of the previous frame.
+     *
+     * @param aStartPoint is a corner of the area, in world coordinates.
+     * @param aEndPoint is the opposite corner of the area, in world coordinates.
+     * @return false if the GAL is not able to clip, then the targets are to be entirely redrawn.
+     */
+    virtual bool SetClipRect( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+    {
+        return false;
+    }
+
     // -------------
     // Grid methods
     // -------------
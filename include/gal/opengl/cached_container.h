@@ -35,6 +35,9 @@
 #include <gal/opengl/vertex_container.h>
 #include <map>
 #include <set>
+#include <vector>
+
+class MEMORY_STATS;
 
 namespace KIGFX
 {
@@ -94,6 +97,16 @@ protected:
     /// List of all the stored items
     typedef std::set<VERTEX_ITEM*> ITEMS;
 
+    ///> Run of used space, between two free chunks, moved as a whole by defragmentation
+    struct USED_RUN
+    {
+        unsigned int oldOffset;
+        unsigned int newOffset;
+        unsigned int size;
+    };
+
+    typedef std::vector<USED_RUN> USED_RUNS;
+
     ///> Stores size & offset of free chunks.
     FREE_CHUNK_MAP      m_freeChunks;
 
@@ -148,6 +161,31 @@ protected:
     bool defragmentResize( unsigned int aNewSize );
     bool defragmentResizeMemcpy( unsigned int aNewSize );
 
+    /**
+     * Function findUsedRuns()
+     * finds the runs of used space between the free chunks, and their offsets once the container
+     * is defragmented. Moving whole runs takes a copy per hole, instead of a copy per item.
+     *
+     * @param aRuns receives the runs, sorted by offset.
+     */
+    void findUsedRuns( USED_RUNS& aRuns ) const;
+
+    /**
+     * Function relocateItems()
+     * updates the offsets of the stored items (and of the currently modified one) after the
+     * runs of used space have been moved.
+     */
+    void relocateItems( const USED_RUNS& aRuns );
+
+    ///> Returns the offset aOffset is moved to, when the runs of used space are moved
+    static unsigned int relocatedOffset( unsigned int aOffset, const USED_RUNS& aRuns );
+
+    ///> Orders an offset before the runs starting after it
+    static bool runOrder( unsigned int aOffset, const USED_RUN& aRun )
+    {
+        return aOffset < aRun.oldOffset;
+    }
+
     /**
      * Function mergeFreeChunks()
      * looks for consecutive free memory chunks and merges them, decreasing fragmentation of
@@ -164,6 +202,9 @@ protected:
     unsigned int getPowerOf2( unsigned int aNumber ) const;
 
 private:
+    ///> Adds the size of the vertex buffer to aStats, see MEMORY_STATS::RegisterSource()
+    void addMemoryStats( MEMORY_STATS& aStats ) const;
+
     /**
      * Function getChunkSize()
      * returns size of the given chunk.
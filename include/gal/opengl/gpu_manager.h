@@ -142,6 +142,12 @@ protected:
 
     ///> Current indices buffer size
     unsigned int m_indicesCapacity;
+
+    ///> Number of indices stored in the GPU indices buffer
+    unsigned int m_indicesUploaded;
+
+    ///> Flag saying that the indices differ from the ones stored in the GPU indices buffer
+    bool m_indicesChanged;
 };
 
 
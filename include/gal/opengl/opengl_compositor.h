@@ -70,6 +70,35 @@ public:
     /// @copydoc COMPOSITOR::DrawBuffer()
     virtual void DrawBuffer( unsigned int aBufferHandle );
 
+    /**
+     * Function ReadBuffer()
+     * starts the transfer of the pixels of a buffer to a pixel buffer object, as BGRA
+     * bytes, without waiting for the rendering to end.  The rows are top to bottom, as
+     * DrawBuffer() shows them.  The pixel buffer object holds at least
+     * GetWidth() * GetHeight() * 4 bytes.
+     *
+     * @param aBufferHandle is the handle of the buffer to be read.
+     * @param aPixelBuffer is the name of the pixel buffer object receiving the pixels.
+     */
+    void ReadBuffer( unsigned int aBufferHandle, GLuint aPixelBuffer );
+
+    /**
+     * Function ReadRect()
+     * reads the pixels of a rectangle of a buffer as RGBA bytes, waiting for the rendering
+     * to end.  The rectangle is in the pixels of the buffer, from its top left corner as
+     * DrawBuffer() shows it, and its rows are stored from the top.
+     *
+     * @param aBufferHandle is the handle of the buffer to be read.
+     * @param aX, aY, aWidth, aHeight are the rectangle, that has to be inside the buffer.
+     * @param aPixels receives aWidth * aHeight * 4 bytes.
+     */
+    void ReadRect( unsigned int aBufferHandle, int aX, int aY, int aWidth, int aHeight,
+                   unsigned char* aPixels );
+
+    /// Returns the size of the buffers, in pixels
+    unsigned int GetWidth() const { return m_width; }
+    unsigned int GetHeight() const { return m_height; }
+
     // Constant used by glBindFramebuffer to turn off rendering to framebuffers
     static const unsigned int DIRECT_RENDERING = 0;
 
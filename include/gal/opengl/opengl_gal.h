@@ -41,9 +41,12 @@
 #include <wx/glcanvas.h>
 
 #include <map>
+#include <vector>
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <boost/smart_ptr/shared_array.hpp>
 
+class wxImage;
+
 #ifndef CALLBACK
 #define CALLBACK
 #endif
@@ -96,6 +99,30 @@ public:
     /// @copydoc GAL::EndDrawing()
     virtual void EndDrawing();
 
+    /**
+     * Function EndOffscreenDrawing()
+     * ends a frame started with BeginDrawing(), as EndDrawing() does, except that the main
+     * target is not shown on the screen: its pixels are read back to one of two pixel
+     * buffers, without waiting for the GPU.  The next frame can be drawn while they are
+     * transferred.  The overlay target and the cursor are not drawn.
+     *
+     * @return the index of the pixel buffer receiving the frame, for ReadPixels().  The
+     * buffers are used in turn, so the frame stays there until the second next call.
+     */
+    unsigned int EndOffscreenDrawing();
+
+    /**
+     * Function ReadPixels()
+     * waits for the transfer of a frame read back by EndOffscreenDrawing(), and copies it
+     * to an image of the size of the frame.
+     *
+     * @param aPixelBuffer is the index returned by EndOffscreenDrawing().
+     * @param aImage receives the pixels, blended over aBackground as on the screen.
+     * @param aBackground is the color of the areas without any item.
+     * @return false if the pixels cannot be read.
+     */
+    bool ReadPixels( unsigned int aPixelBuffer, wxImage& aImage, const COLOR4D& aBackground );
+
     /// @copydoc GAL::BeginUpdate()
     virtual void BeginUpdate();
 
@@ -127,6 +154,13 @@ public:
     virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList );
     virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize );
 
+    /**
+     * @copydoc GAL::DrawPolygon( const SHAPE_POLY_SET& )
+     * The cached triangles of the set are used as they are, without calling the GLU
+     * tessellator, when they are up to date.
+     */
+    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet );
+
     /// @copydoc GAL::DrawCurve()
     virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
                             const VECTOR2D& controlPointB, const VECTOR2D& endPoint );
@@ -201,6 +235,19 @@ public:
     /// @copydoc GAL::ClearCache()
     virtual void ClearCache();
 
+    // --------------------------------------------------------
+    // Picking methods
+    // --------------------------------------------------------
+
+    /// @copydoc GAL::BeginPicking()
+    virtual bool BeginPicking( const VECTOR2D& aPosition, int aRadius );
+
+    /// @copydoc GAL::DrawGroupPicking()
+    virtual void DrawGroupPicking( int aGroupNumber, unsigned int aId );
+
+    /// @copydoc GAL::EndPicking()
+    virtual void EndPicking( std::vector<unsigned int>& aIds );
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -220,6 +267,9 @@ public:
     /// @copydoc GAL::ClearTarget()
     virtual void ClearTarget( RENDER_TARGET aTarget );
 
+    /// @copydoc GAL::SetClipRect()
+    virtual bool SetClipRect( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
+
     // -------
     // Cursor
     // -------
@@ -259,6 +309,9 @@ public:
 
         /// Intersect points, that have to be freed after tessellation
         std::deque< boost::shared_array<GLdouble> >& intersectPoints;
+
+        /// If not NULL, the coordinates of the triangle vertices are appended to it
+        std::vector<GLdouble>* triangles;
     } TessParams;
 
 private:
@@ -267,6 +320,8 @@ private:
 
     static const int    CIRCLE_POINTS   = 64;   ///< The number of points for circle approximation
     static const int    CURVE_POINTS    = 32;   ///< The number of points for curve approximation
+    static const int    TESS_CACHE_POINTS = 32; ///< The max number of points of a cached tessellation
+    static const int    TESS_CACHE_SIZE = 4096; ///< The max number of cached tessellations
 
     wxClientDC*             clientDC;               ///< Drawing context
     static wxGLContext*     glContext;              ///< OpenGL context of wxWidgets
@@ -291,6 +346,19 @@ private:
     unsigned int            overlayBuffer;          ///< Auxiliary rendering target (for menus etc.)
     RENDER_TARGET           currentTarget;          ///< Current rendering target
 
+    // Offscreen read back
+    GLuint                  pixelBuffers[2];        ///< Pixel buffers of EndOffscreenDrawing()
+    unsigned int            pixelBufferWidth;       ///< Size of the frames in the pixel buffers
+    unsigned int            pixelBufferHeight;
+    unsigned int            nextPixelBuffer;        ///< Index of the next pixel buffer to fill
+
+    // Picking
+    unsigned int            pickingBuffer;          ///< Target of the item ids, 0 until used
+    VECTOR2I                pickingCenter;          ///< Center of the picking window
+    int                     pickingRect[4];         ///< Picking window, in target pixels
+    int                     ufm_picking;            ///< Shader parameters of the picking pass
+    int                     ufm_pickColor;
+
     // Shader
     SHADER                  shader;         ///< There is only one shader used for different objects
 
@@ -299,12 +367,26 @@ private:
     static bool             isBitmapFontLoaded;         ///< Is the bitmap font texture loaded?
     bool                    isBitmapFontInitialized;    ///< Is the shader set to use bitmap fonts?
     bool                    isGrouping;                 ///< Was a group started?
+    bool                    isClipping;                 ///< Is the main buffer clipped?
+    GLint                   clipRect[4];                ///< Clipped area (x, y, width, height)
 
     // Polygon tesselation
     /// The tessellator
     GLUtesselator*          tesselator;
     /// Storage for intersecting points
     std::deque< boost::shared_array<GLdouble> > tessIntersects;
+    /// Triangles of the small polygons already tessellated (e.g. footprint polygons and
+    /// trapezoidal pads, drawn in their local coordinates), indexed by the polygon vertices
+    typedef std::map< std::vector<GLdouble>, std::vector<GLdouble> > TESS_CACHE;
+    TESS_CACHE              tessCache;
+
+    /**
+     * @brief Fill a polygon with the triangles of an identical polygon drawn before, or
+     * tessellate it.
+     *
+     * @param aPoints are the coordinates (x, y, depth) of the polygon vertices.
+     */
+    void fillPolygon( const std::vector<GLdouble>& aPoints );
 
     /**
      * @brief Draw a quad for the line.
@@ -394,6 +476,11 @@ private:
      */
     void blitCursor();
 
+    /**
+     * @brief Loads the viewport and the world <-> screen transformation of the frames.
+     */
+    void setUpTransformations();
+
     /**
      * @brief Returns a valid key that can be used as a new group number.
      *
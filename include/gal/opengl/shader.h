@@ -154,6 +154,14 @@ public:
     void SetParameter( int aParameterNumber, float aValue ) const;
     void SetParameter( int aParameterNumber, int aValue ) const;
 
+    /**
+     * @brief Set a vec4 parameter of the shader.
+     *
+     * @param aParameterNumber is the number of the parameter.
+     * @param aX, aY, aZ, aW are the components of the parameter.
+     */
+    void SetParameter( int aParameterNumber, float aX, float aY, float aZ, float aW ) const;
+
     /**
      * @brief Gets an attribute location.
      *
@@ -30,6 +30,7 @@
 #define STROKE_FONT_H_
 
 #include <deque>
+#include <vector>
 #include <utf8.h>
 
 #include <eda_text.h>
@@ -40,8 +41,8 @@ namespace KIGFX
 {
 class GAL;
 
-typedef std::deque< std::deque<VECTOR2D> > GLYPH;
-typedef std::vector<GLYPH>                 GLYPH_LIST;
+typedef std::vector< std::vector<VECTOR2D> > GLYPH;
+typedef std::vector<GLYPH>                   GLYPH_LIST;
 
 /**
  * @brief Class STROKE_FONT implements stroke font drawing.
@@ -57,7 +58,8 @@ public:
     STROKE_FONT( GAL* aGal );
 
     /**
-     * @brief Load the new stroke font.
+     * @brief Load the new stroke font. The font data is parsed once, the glyphs are then
+     * shared by all the STROKE_FONT instances loading the same data.
      *
      * @param aNewStrokeFont is the pointer to the font data.
      * @param aNewStrokeFontSize is the size of the font data.
@@ -123,9 +125,12 @@ public:
 
 
 private:
-    GAL*                m_gal;                  ///< Pointer to the GAL
-    GLYPH_LIST          m_glyphs;               ///< Glyph list
-    std::vector<BOX2D>  m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+    GAL*                        m_gal;                  ///< Pointer to the GAL
+    const GLYPH_LIST*           m_glyphs;               ///< Glyph list
+    const std::vector<BOX2D>*   m_glyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+
+    ///> Scaled points of the stroke being drawn, kept to avoid an allocation per stroke
+    std::vector<VECTOR2D>       m_strokePoints;
 
     /**
      * @brief Compute the X and Y size of a given text. The text is expected to be
@@ -0,0 +1,64 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file geometry_utils.h
+ * a few functions useful in geometry calculations.
+ */
+
+#ifndef GEOMETRY_UTILS_H
+#define GEOMETRY_UTILS_H
+
+#include <cmath>
+#include <algorithm>
+
+/// the min number of segments used to approximate a full circle
+#define MIN_SEGCOUNT_FOR_CIRCLE 8
+
+/**
+ * Function GetArcToSegmentCount
+ * returns the number of segments approximating an arc with a chord error, the max
+ * distance between the arc and its segments, not greater than @a aErrorMax.
+ * @param aRadius is the radius of the arc
+ * @param aErrorMax is the max error, in the units of aRadius
+ * @param aArcAngleDegree is the central angle of the arc, in degrees
+ * @return the number of segments, at least 1
+ */
+inline int GetArcToSegmentCount( int aRadius, double aErrorMax, double aArcAngleDegree )
+{
+    // the angle of the segments of a full circle with MIN_SEGCOUNT_FOR_CIRCLE segments
+    double arcIncrement = 360.0 / MIN_SEGCOUNT_FOR_CIRCLE;
+
+    if( aErrorMax > 0.0 && aErrorMax < aRadius )
+    {
+        // the chord error of a segment of angle a is aRadius * ( 1 - cos( a / 2 ) )
+        double relError = aErrorMax / aRadius;
+        arcIncrement = std::min( arcIncrement, 2.0 * acos( 1.0 - relError ) * 180.0 / M_PI );
+    }
+
+    int segCount = (int) ceil( fabs( aArcAngleDegree ) / arcIncrement );
+
+    return std::max( segCount, 1 );
+}
+
+#endif  // GEOMETRY_UTILS_H
@@ -29,6 +29,10 @@
 #include <math.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <limits.h>
+
+#include <algorithm>
+#include <vector>
 
 #define ASSERT assert    // RTree uses ASSERT( condition )
 #ifndef rMin
@@ -38,6 +42,14 @@
   #define rMax std::max
 #endif    // rMax
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+  #include <emmintrin.h>
+  #define RTREE_USE_SSE2
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+  #include <arm_neon.h>
+  #define RTREE_USE_NEON
+#endif
+
 //
 // RTree.h
 //
@@ -58,6 +70,86 @@
 class RTFileStream;    // File I/O helper class, look below for implementation and notes.
 
 
+/// Tests the rects of the branches of a node against a rect, see RTree::OverlapMask()
+template <class ELEMTYPE, int NUMDIMS>
+struct RTreeOverlapMask
+{
+    template <class RECT, class BRANCH>
+    static unsigned int Get( const RECT* a_rect, const BRANCH* a_branch, int a_count )
+    {
+        unsigned int mask = 0;
+
+        for( int index = 0; index < a_count; ++index )
+        {
+            const RECT& rect = a_branch[index].m_rect;
+            bool overlap = true;
+
+            for( int axis = 0; axis < NUMDIMS && overlap; ++axis )
+            {
+                overlap = a_rect->m_min[axis] <= rect.m_max[axis]
+                          && rect.m_min[axis] <= a_rect->m_max[axis];
+            }
+
+            if( overlap )
+                mask |= 1u << index;
+        }
+
+        return mask;
+    }
+};
+
+
+#if defined( RTREE_USE_SSE2 ) || defined( RTREE_USE_NEON )
+/// The rect of a 2-D tree of ints, (min x, min y, max x, max y), is a single 128-bit word:
+/// it does not overlap when one of its min is above the max of the rect, or one of its max
+/// is below the min of the rect, tested with two SIMD compares
+template <>
+struct RTreeOverlapMask<int, 2>
+{
+    template <class RECT, class BRANCH>
+    static unsigned int Get( const RECT* a_rect, const BRANCH* a_branch, int a_count )
+    {
+        unsigned int mask = 0;
+
+#ifdef RTREE_USE_SSE2
+        const __m128i above = _mm_set_epi32( INT_MAX, INT_MAX,
+                                             a_rect->m_max[1], a_rect->m_max[0] );
+        const __m128i below = _mm_set_epi32( a_rect->m_min[1], a_rect->m_min[0],
+                                             INT_MIN, INT_MIN );
+
+        for( int index = 0; index < a_count; ++index )
+        {
+            const __m128i rect = _mm_loadu_si128( (const __m128i*) &a_branch[index].m_rect );
+            const __m128i outside = _mm_or_si128( _mm_cmpgt_epi32( rect, above ),
+                                                  _mm_cmplt_epi32( rect, below ) );
+
+            if( _mm_movemask_epi8( outside ) == 0 )
+                mask |= 1u << index;
+        }
+#else
+        const int32_t aboveLanes[4] = { a_rect->m_max[0], a_rect->m_max[1], INT_MAX, INT_MAX };
+        const int32_t belowLanes[4] = { INT_MIN, INT_MIN, a_rect->m_min[0], a_rect->m_min[1] };
+        const int32x4_t above = vld1q_s32( aboveLanes );
+        const int32x4_t below = vld1q_s32( belowLanes );
+
+        for( int index = 0; index < a_count; ++index )
+        {
+            const int32x4_t rect = vld1q_s32( (const int32_t*) &a_branch[index].m_rect );
+            const uint32x4_t outside = vorrq_u32( vcgtq_s32( rect, above ),
+                                                  vcltq_s32( rect, below ) );
+            const uint32x2_t any = vorr_u32( vget_low_u32( outside ), vget_high_u32( outside ) );
+
+            if( ( vget_lane_u32( any, 0 ) | vget_lane_u32( any, 1 ) ) == 0 )
+                mask |= 1u << index;
+        }
+#endif
+
+        return mask;
+    }
+};
+#endif
+
+
 /// \class RTree
 /// Implementation of RTree, a multidimensional bounding rectangle tree.
 /// Example usage: For a 3-dimensional tree use RTree<Object*, float, 3> myTree;
@@ -116,10 +208,25 @@ public:
     /// \param a_min Min of bounding rect
     /// \param a_max Max of bounding rect
     /// \param a_dataId Positive Id of data.  Maybe zero, but negative numbers not allowed.
-    void Remove( const ELEMTYPE     a_min[NUMDIMS],
+    /// \return true if the entry was found within the rect, and removed
+    bool Remove( const ELEMTYPE     a_min[NUMDIMS],
                  const ELEMTYPE     a_max[NUMDIMS],
                  const DATATYPE&    a_dataId );
 
+    /// Entry of a bulk load
+    struct BulkEntry
+    {
+        ELEMTYPE    m_min[NUMDIMS];                 ///< Min of bounding rect
+        ELEMTYPE    m_max[NUMDIMS];                 ///< Max of bounding rect
+        DATATYPE    m_data;                         ///< Data Id or Ptr
+    };
+
+    /// Insert many entries at once.  The tree is rebuilt with its current entries and
+    /// a_entries, packed with the Sort-Tile-Recursive algorithm: the leaves are full,
+    /// and their rects overlap much less than the ones built by successive insertions.
+    /// \param a_entries Entries to insert
+    void BulkLoad( const std::vector<BulkEntry>& a_entries );
+
     /// Find all within search rectangle
     /// \param a_min Min of search bounding rect
     /// \param a_max Max of search bounding rect
@@ -465,6 +572,15 @@ protected:
     ListNode*       AllocListNode();
     void            FreeListNode( ListNode* a_listNode );
     bool            Overlap( Rect* a_rectA, Rect* a_rectB );
+
+    /// Returns the mask of the branches of a_node whose rect overlaps a_rect, bit 0 for
+    /// the first branch
+    unsigned int OverlapMask( Rect* a_rect, Node* a_node )
+    {
+        return RTreeOverlapMask<ELEMTYPE, NUMDIMS>::Get( a_rect, a_node->m_branch,
+                                                         a_node->m_count );
+    }
+
     void            ReInsert( Node* a_node, ListNode** a_listNode );
     ELEMTYPE        MinDist( const ELEMTYPE a_point[NUMDIMS], Rect* a_rect );
     void            InsertNNListSorted( std::vector<NNNode*>* nodeList, NNNode* newNode );
@@ -480,11 +596,13 @@ protected:
         ASSERT( a_node->m_level >= 0 );
         ASSERT( a_rect );
 
+        unsigned int overlap = OverlapMask( a_rect, a_node );
+
         if( a_node->IsInternalNode() ) // This is an internal node in the tree
         {
-            for( int index = 0; index < a_node->m_count; ++index )
+            for( int index = 0; overlap; ++index, overlap >>= 1 )
             {
-                if( Overlap( a_rect, &a_node->m_branch[index].m_rect ) )
+                if( overlap & 1 )
                 {
                     if( !Search( a_node->m_branch[index].m_child, a_rect, a_visitor, a_foundCount ) )
                     {
@@ -495,9 +613,9 @@ protected:
         }
         else // This is a leaf node
         {
-            for( int index = 0; index < a_node->m_count; ++index )
+            for( int index = 0; overlap; ++index, overlap >>= 1 )
             {
-                if( Overlap( a_rect, &a_node->m_branch[index].m_rect ) )
+                if( overlap & 1 )
                 {
                     DATATYPE& id = a_node->m_branch[index].m_data;
 
@@ -519,6 +637,27 @@ protected:
     bool    SaveRec( Node* a_node, RTFileStream& a_stream );
     bool    LoadRec( Node* a_node, RTFileStream& a_stream );
 
+    /// Orders the branches of a bulk load by the center of their rects along an axis
+    struct BranchCenterLess
+    {
+        BranchCenterLess( int a_axis ) : m_axis( a_axis ) {}
+
+        bool operator()( const Branch& a_branchA, const Branch& a_branchB ) const
+        {
+            return (ELEMTYPEREAL) a_branchA.m_rect.m_min[m_axis] +
+                   (ELEMTYPEREAL) a_branchA.m_rect.m_max[m_axis] <
+                   (ELEMTYPEREAL) a_branchB.m_rect.m_min[m_axis] +
+                   (ELEMTYPEREAL) a_branchB.m_rect.m_max[m_axis];
+        }
+
+        int m_axis;
+    };
+
+    void    CollectLeafBranches( Node* a_node, std::vector<Branch>& a_branches );
+    void    PackTiles( typename std::vector<Branch>::iterator a_begin,
+                       typename std::vector<Branch>::iterator a_end,
+                       int a_axis, int a_level, std::vector<Branch>& a_parents );
+
     Node*           m_root;                         ///< Root of tree
     ELEMTYPEREAL    m_unitSphereVolume;             ///< Unit sphere constant for required number of dimensions
 };
@@ -608,6 +747,7 @@ public:
 RTREE_TEMPLATE RTREE_QUAL::RTree()
 {
     ASSERT( MAXNODES > MINNODES );
+    ASSERT( MAXNODES <= 32 );   // the branches of a node fit the mask of OverlapMask()
     ASSERT( MINNODES > 0 );
 
 
@@ -666,7 +806,124 @@ void RTREE_QUAL::Insert( const ELEMTYPE     a_min[NUMDIMS],
 
 
 RTREE_TEMPLATE
-void RTREE_QUAL::Remove( const ELEMTYPE     a_min[NUMDIMS],
+void RTREE_QUAL::BulkLoad( const std::vector<BulkEntry>& a_entries )
+{
+    std::vector<Branch> branches;
+
+    CollectLeafBranches( m_root, branches );
+    branches.reserve( branches.size() + a_entries.size() );
+
+    for( typename std::vector<BulkEntry>::const_iterator it = a_entries.begin();
+         it != a_entries.end(); ++it )
+    {
+        Branch branch;
+
+        for( int axis = 0; axis < NUMDIMS; ++axis )
+        {
+#ifdef _DEBUG
+            ASSERT( it->m_min[axis] <= it->m_max[axis] );
+#endif    // _DEBUG
+            branch.m_rect.m_min[axis] = it->m_min[axis];
+            branch.m_rect.m_max[axis] = it->m_max[axis];
+        }
+
+        branch.m_data = it->m_data;
+        branches.push_back( branch );
+    }
+
+    RemoveAll();
+
+    if( branches.empty() )
+        return;
+
+    // Pack each level into the nodes of the next one, until a single node is left
+    int level = 0;
+
+    while( branches.size() > (size_t) MAXNODES )
+    {
+        std::vector<Branch> parents;
+
+        PackTiles( branches.begin(), branches.end(), 0, level, parents );
+        branches.swap( parents );
+        ++level;
+    }
+
+    m_root->m_level = level;
+    m_root->m_count = branches.size();
+    std::copy( branches.begin(), branches.end(), m_root->m_branch );
+}
+
+
+// Sort-Tile-Recursive packing of a level of a bulk load.  The branches are sorted along
+// an axis and cut into slabs, which are packed along the next axis.  Along the last axis,
+// the slabs are cut into nodes of a_level, added to a_parents.
+RTREE_TEMPLATE
+void RTREE_QUAL::PackTiles( typename std::vector<Branch>::iterator a_begin,
+                            typename std::vector<Branch>::iterator a_end,
+                            int a_axis, int a_level, std::vector<Branch>& a_parents )
+{
+    typedef typename std::vector<Branch>::iterator BRANCH_ITER;
+
+    const int count = a_end - a_begin;
+    const int nodeCount = ( count + MAXNODES - 1 ) / MAXNODES;
+
+    std::sort( a_begin, a_end, BranchCenterLess( a_axis ) );
+
+    if( a_axis == NUMDIMS - 1 )
+    {
+        // The branches are spread evenly, so that the nodes are filled at least to
+        // MINNODES whenever possible
+        for( int i = 0; i < nodeCount; ++i )
+        {
+            BRANCH_ITER first = a_begin + (int) ( (double) count * i / nodeCount );
+            BRANCH_ITER last = a_begin + (int) ( (double) count * ( i + 1 ) / nodeCount );
+            Node* node = AllocNode();
+            Branch parent;
+
+            node->m_level = a_level;
+            node->m_count = last - first;
+            std::copy( first, last, node->m_branch );
+
+            parent.m_rect = NodeCover( node );
+            parent.m_child = node;
+            a_parents.push_back( parent );
+        }
+
+        return;
+    }
+
+    // A grid of nodeCount tiles in the remaining dimensions has slabCount slabs along a_axis
+    int slabCount = (int) ceil( pow( (double) nodeCount, 1.0 / ( NUMDIMS - a_axis ) ) );
+
+    for( int i = 0; i < slabCount; ++i )
+    {
+        BRANCH_ITER first = a_begin + (int) ( (double) count * i / slabCount );
+        BRANCH_ITER last = a_begin + (int) ( (double) count * ( i + 1 ) / slabCount );
+
+        if( first != last )
+            PackTiles( first, last, a_axis + 1, a_level, a_parents );
+    }
+}
+
+
+RTREE_TEMPLATE
+void RTREE_QUAL::CollectLeafBranches( Node* a_node, std::vector<Branch>& a_branches )
+{
+    if( a_node->IsInternalNode() )
+    {
+        for( int index = 0; index < a_node->m_count; ++index )
+            CollectLeafBranches( a_node->m_branch[index].m_child, a_branches );
+    }
+    else
+    {
+        a_branches.insert( a_branches.end(), a_node->m_branch,
+                           a_node->m_branch + a_node->m_count );
+    }
+}
+
+
+RTREE_TEMPLATE
+bool RTREE_QUAL::Remove( const ELEMTYPE     a_min[NUMDIMS],
                          const ELEMTYPE     a_max[NUMDIMS],
                          const DATATYPE&    a_dataId )
 {
@@ -687,7 +944,7 @@ void RTREE_QUAL::Remove( const ELEMTYPE     a_min[NUMDIMS],
         rect.m_max[axis]    = a_max[axis];
     }
 
-    RemoveRect( &rect, a_dataId, &m_root );
+    return !RemoveRect( &rect, a_dataId, &m_root );
 }
 
 
@@ -1815,11 +2072,13 @@ bool RTREE_QUAL::Search( Node* a_node, Rect* a_rect, int& a_foundCount, bool a_r
     ASSERT( a_node->m_level >= 0 );
     ASSERT( a_rect );
 
+    unsigned int overlap = OverlapMask( a_rect, a_node );
+
     if( a_node->IsInternalNode() ) // This is an internal node in the tree
     {
-        for( int index = 0; index < a_node->m_count; ++index )
+        for( int index = 0; overlap; ++index, overlap >>= 1 )
         {
-            if( Overlap( a_rect, &a_node->m_branch[index].m_rect ) )
+            if( overlap & 1 )
             {
                 if( !Search( a_node->m_branch[index].m_child, a_rect, a_foundCount,
                              a_resultCallback, a_context ) )
@@ -1831,9 +2090,9 @@ bool RTREE_QUAL::Search( Node* a_node, Rect* a_rect, int& a_foundCount, bool a_r
     }
     else // This is a leaf node
     {
-        for( int index = 0; index < a_node->m_count; ++index )
+        for( int index = 0; overlap; ++index, overlap >>= 1 )
         {
-            if( Overlap( a_rect, &a_node->m_branch[index].m_rect ) )
+            if( overlap & 1 )
             {
                 DATATYPE& id = a_node->m_branch[index].m_data;
 
@@ -46,7 +46,8 @@ enum SHAPE_TYPE
     SH_CIRCLE,          ///> circle
     SH_CONVEX,          ///> convex polygon
     SH_POLY_SET,         ///> any polygon (with holes, etc.)
-    SH_COMPOUND         ///> compound shape, consisting of multiple simple shapes
+    SH_COMPOUND,        ///> compound shape, consisting of multiple simple shapes
+    SH_ARC              ///> circular arc
 };
 
 /**
@@ -0,0 +1,133 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __SHAPE_ARC_H
+#define __SHAPE_ARC_H
+
+#include <geometry/shape.h>
+#include <geometry/seg.h>
+
+class SHAPE_LINE_CHAIN;
+
+/**
+ * Class SHAPE_ARC
+ *
+ * Represents a circular arc of a given width, defined by its center, its start point and
+ * its central angle.  The collisions and the distances are exact: the arc is converted
+ * to segments only when a polygon is needed, see ConvertToPolyline().
+ */
+class SHAPE_ARC : public SHAPE
+{
+public:
+    SHAPE_ARC() :
+        SHAPE( SH_ARC ), m_centralAngle( 0.0 ), m_width( 0 ) {};
+
+    /**
+     * Constructor
+     * @param aArcCenter is the center of the arc
+     * @param aArcStartPoint is the start point of the arc
+     * @param aCenterAngle is the central angle of the arc in degrees, the arc runs from
+     * the start point in the direction of VECTOR2::Rotate() for a positive angle
+     * @param aWidth is the width of the arc
+     */
+    SHAPE_ARC( const VECTOR2I& aArcCenter, const VECTOR2I& aArcStartPoint,
+               double aCenterAngle, int aWidth = 0 ) :
+        SHAPE( SH_ARC ), m_p0( aArcStartPoint ), m_pc( aArcCenter ),
+        m_centralAngle( aCenterAngle ), m_width( aWidth ) {};
+
+    ~SHAPE_ARC() {};
+
+    SHAPE* Clone() const
+    {
+        return new SHAPE_ARC( *this );
+    }
+
+    const VECTOR2I& GetP0() const { return m_p0; }
+    const VECTOR2I GetP1() const;
+    const VECTOR2I& GetCenter() const { return m_pc; }
+
+    double GetCentralAngle() const { return m_centralAngle; }
+    double GetStartAngle() const;
+    double GetEndAngle() const;
+    int GetRadius() const;
+
+    void SetWidth( int aWidth )
+    {
+        m_width = aWidth;
+    }
+
+    int GetWidth() const
+    {
+        return m_width;
+    }
+
+    const BOX2I BBox( int aClearance = 0 ) const;
+
+    /**
+     * Function Distance()
+     * returns the distance between the centerline of the arc and a point, a segment, or
+     * the centerline of another arc.
+     */
+    double Distance( const VECTOR2I& aP ) const;
+    double Distance( const SEG& aSeg ) const;
+    double Distance( const SHAPE_ARC& aArc ) const;
+
+    bool Collide( const SEG& aSeg, int aClearance = 0 ) const
+    {
+        return Distance( aSeg ) < ( m_width + 1 ) / 2 + aClearance;
+    }
+
+    bool Collide( const VECTOR2I& aP, int aClearance = 0 ) const
+    {
+        return Distance( aP ) < ( m_width + 1 ) / 2 + aClearance;
+    }
+
+    bool IsSolid() const
+    {
+        return true;
+    }
+
+    void Move( const VECTOR2I& aVector )
+    {
+        m_p0 += aVector;
+        m_pc += aVector;
+    }
+
+    /**
+     * Function ConvertToPolyline()
+     * returns the centerline of the arc as segments, with the start and end points of
+     * the arc as the ends of the chain.
+     * @param aAccuracy is the max distance between the arc and its segments
+     */
+    const SHAPE_LINE_CHAIN ConvertToPolyline( double aAccuracy = 5000.0 ) const;
+
+private:
+    // returns true if the direction of aP seen from the center is in the sweep of the arc
+    bool sweepContains( const VECTOR2I& aP ) const;
+
+    VECTOR2I m_p0, m_pc;
+    double m_centralAngle;
+    int m_width;
+};
+
+#endif
@@ -27,6 +27,8 @@
 #define __SHAPE_FILE_IO_H
 
 #include <cstdio>
+#include <sstream>
+#include <string>
 
 class SHAPE;
 
@@ -51,7 +53,15 @@ class SHAPE_FILE_IO
         void BeginGroup( const std::string aName = "<noname>");
         void EndGroup();
 
-        SHAPE* Read();
+        /**
+         * Function Read
+         * reads the next shape of the file, in any group.  Only the polygon sets and the line
+         * chains can be read.
+         * @param aName is set to the name of the shape, if not NULL.
+         * @return the new shape, owned by the caller, or NULL at the end of the file or on
+         * a read error.
+         */
+        SHAPE* Read( std::string* aName = NULL );
 
         void Write( const SHAPE* aShape, const std::string aName = "<noname>" );
 
@@ -64,6 +74,10 @@ class SHAPE_FILE_IO
         FILE* m_file;
         bool m_groupActive;
         IO_MODE m_mode;
+
+        ///> The file contents, loaded by the first Read(): SHAPE::Parse() reads from a stream
+        std::stringstream m_readStream;
+        bool m_readStreamLoaded;
 };
 
 #endif
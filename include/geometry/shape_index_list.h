@@ -27,6 +27,8 @@
 
 #include <boost/unordered_map.hpp>
 
+#include <math/box2_array.h>
+
 template <class T>
 const SHAPE* defaultShapeFunctor( const T aItem )
 {
@@ -210,6 +212,7 @@ public:
         SHAPE_ENTRY s( aItem );
 
         m_shapes.push_back( s );
+        m_bboxes.Add( s.bbox );
     }
 
     void Remove( const T aItem )
@@ -225,6 +228,7 @@ public:
         if( i == m_shapes.end() )
             return;
 
+        m_bboxes.Remove( i - m_shapes.begin() );
         m_shapes.erase( i );
     }
 
@@ -236,22 +240,32 @@ public:
     template <class Visitor>
     int Query( const SHAPE* aShape, int aMinDistance, Visitor& aV, bool aExact = true )    // const
     {
-        SHAPE_VEC_ITER i;
         int n = 0;
         VECTOR2I::extended_type minDistSq = (VECTOR2I::extended_type) aMinDistance * aMinDistance;
 
         BOX2I refBBox = aShape->BBox();
 
-        for( i = m_shapes.begin(); i != m_shapes.end(); ++i )
+        // the boxes within aMinDistance along both axes first, 32 at a time
+        for( int first = 0; first < m_bboxes.Size(); first += 32 )
         {
-            if( refBBox.SquaredDistance( i->bbox ) <= minDistSq )
+            unsigned int near = m_bboxes.IntersectsMask( refBBox, first, std::abs( aMinDistance ) );
+
+            for( int i = first; near; i++, near >>= 1 )
             {
-                if( !aExact || i->shape->Collide( aShape, aMinDistance ) )
+                if( !( near & 1 ) )
+                    continue;
+
+                const SHAPE_ENTRY& entry = m_shapes[i];
+
+                if( refBBox.SquaredDistance( entry.bbox ) <= minDistSq )
                 {
-                    n++;
+                    if( !aExact || entry.shape->Collide( aShape, aMinDistance ) )
+                    {
+                        n++;
 
-                    if( !aV( i->parent ) )
-                        return n;
+                        if( !aV( entry.parent ) )
+                            return n;
+                    }
                 }
             }
         }
@@ -262,6 +276,7 @@ public:
     void Clear()
     {
         m_shapes.clear();
+        m_bboxes.Clear();
     }
 
     query_iterator qbegin( SHAPE* aShape, int aMinDistance, bool aExact )
@@ -286,6 +301,9 @@ public:
 
 private:
     SHAPE_VEC m_shapes;
+
+    /// the bounding boxes of m_shapes, for Query()
+    BOX2I_ARRAY m_bboxes;
 };
 
 #endif
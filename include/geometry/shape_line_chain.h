@@ -34,6 +34,8 @@
 #include <geometry/shape.h>
 #include <geometry/seg.h>
 
+class SHAPE_ARC;
+
 /**
  * Class SHAPE_LINE_CHAIN
  *
@@ -292,6 +294,18 @@ public:
      */
     bool Collide( const SEG& aSeg, int aClearance = 0 ) const;
 
+    /**
+     * Function NearSegments()
+     *
+     * Finds, among up to 32 segments starting from segment aFirst, the ones whose
+     * bounding box is not farther than aMargin from aBox along each axis. The other
+     * segments can be skipped by any test for a distance not over aMargin. The segments
+     * are tested in pairs with SSE2, where available.
+     * @param aBox the normalized bounding box of the tested shape
+     * @return a mask of the found segments, bit i standing for segment aFirst + i
+     */
+    unsigned int NearSegments( const BOX2I& aBox, int aMargin, int aFirst ) const;
+
     /**
      * Function Distance()
      *
@@ -374,6 +388,16 @@ public:
         }
     }
 
+    /**
+     * Function Append()
+     *
+     * Appends the centerline of an arc at the end, as segments: the arc is tessellated
+     * here, with a number of segments given by the accuracy and not by a fixed count.
+     * @param aArc the arc to be appended.
+     * @param aAccuracy the max distance between the arc and its segments.
+     */
+    void Append( const SHAPE_ARC& aArc, double aAccuracy );
+
     void Insert( int aVertex, const VECTOR2I& aP )
     {
         m_points.insert( m_points.begin() + aVertex, aP );
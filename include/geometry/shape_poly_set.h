@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <cstdio>
+#include <boost/shared_ptr.hpp>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 
@@ -48,6 +49,66 @@ class SHAPE_POLY_SET : public SHAPE
         ///> the remaining (if any), are the holes
         typedef std::vector<SHAPE_LINE_CHAIN> POLYGON;
 
+        /**
+         * Class TRIANGULATED_POLYGON
+         *
+         * The triangles of a polygon without holes, indexing its vertices.  See
+         * CacheTriangulation().
+         */
+        class TRIANGULATED_POLYGON
+        {
+            public:
+                struct TRI
+                {
+                    int a, b, c;
+                };
+
+                void Clear()
+                {
+                    m_vertices.clear();
+                    m_triangles.clear();
+                }
+
+                void AddVertex( const VECTOR2I& aP )
+                {
+                    m_vertices.push_back( aP );
+                }
+
+                void AddTriangle( int a, int b, int c )
+                {
+                    TRI tri = { a, b, c };
+                    m_triangles.push_back( tri );
+                }
+
+                int GetTriangleCount() const
+                {
+                    return m_triangles.size();
+                }
+
+                void GetTriangle( int aIndex, VECTOR2I& a, VECTOR2I& b, VECTOR2I& c ) const
+                {
+                    const TRI& tri = m_triangles[aIndex];
+
+                    a = m_vertices[tri.a];
+                    b = m_vertices[tri.b];
+                    c = m_vertices[tri.c];
+                }
+
+                const std::vector<VECTOR2I>& Vertices() const
+                {
+                    return m_vertices;
+                }
+
+                const std::vector<TRI>& Triangles() const
+                {
+                    return m_triangles;
+                }
+
+            private:
+                std::vector<VECTOR2I>   m_vertices;
+                std::vector<TRI>        m_triangles;
+        };
+
         /**
          * Class ITERATOR_TEMPLATE
          *
@@ -96,7 +157,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T& Get()
             {
-                return m_poly->Polygon( m_currentOutline )[0].Point( m_currentVertex );
+                return m_poly->m_polys[m_currentOutline][0].Point( m_currentVertex );
             }
 
             T& operator*()
@@ -170,20 +231,24 @@ class SHAPE_POLY_SET : public SHAPE
         }
 
         ///> Returns the reference to aIndex-th outline in the set
+        ///> (the reference is not to be modified after a call to Contains())
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            invalidateContainsIndex();
             return m_polys[aIndex][0];
         }
 
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            invalidateContainsIndex();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            invalidateContainsIndex();
             return m_polys[aIndex];
         }
 
@@ -207,6 +272,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            invalidateContainsIndex();
+
             iter.m_poly = this;
             iter.m_currentOutline = aFirst;
             iter.m_lastOutline = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -289,13 +356,25 @@ class SHAPE_POLY_SET : public SHAPE
         void BooleanIntersection( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
                                   POLYGON_MODE aFastMode );
 
+        ///> Same as BooleanSubtract( a, b ), for a large area with many holes (e.g. a ground
+        ///> plane): the bounding box of a is split into aTileCount x aTileCount tiles, the holes
+        ///> are subtracted from each tile in parallel (when OpenMP is enabled), and the tiles
+        ///> are merged back together.  The result can differ from BooleanSubtract() by the
+        ///> rounding of the intersections.
+        ///> For aFastMode meaning, see function booleanOp
+        void BooleanSubtractTiled( const SHAPE_POLY_SET& a, const SHAPE_POLY_SET& b,
+                                   int aTileCount, POLYGON_MODE aFastMode );
+
         ///> Performs outline inflation/deflation, using round corners.
         void Inflate( int aFactor, int aCircleSegmentsCount );
 
         ///> Converts a set of polygons with holes to a singe outline with "slits"/"fractures" connecting the outer ring
         ///> to the inner holes
+        ///> The polygons are fractured in parallel when OpenMP is enabled, and are first
+        ///> simplified by aTileCount x aTileCount tiles when aTileCount > 1 (see
+        ///> BooleanSubtractTiled()).
         ///> For aFastMode meaning, see function booleanOp
-        void Fracture( POLYGON_MODE aFastMode );
+        void Fracture( POLYGON_MODE aFastMode, int aTileCount = 1 );
 
         ///> Converts a set of slitted polygons to a set of polygons with holes
         void Unfracture();
@@ -307,6 +386,70 @@ class SHAPE_POLY_SET : public SHAPE
         ///> For aFastMode meaning, see function booleanOp
         void Simplify( POLYGON_MODE aFastMode );
 
+        ///> Same as Simplify(), for a set of many small overlapping polygons (e.g. the clearance
+        ///> areas of the pads and tracks of a board): the polygons are sorted along a space
+        ///> filling curve, merged by batches of neighbours in parallel (when OpenMP is enabled),
+        ///> and the batches are then merged together.  Only faster than Simplify() when several
+        ///> threads are available.  The result can differ from Simplify() by the rounding of
+        ///> the intersections.
+        ///> For aFastMode meaning, see function booleanOp
+        void SimplifyBatched( POLYGON_MODE aFastMode );
+
+        /**
+         * Class BOOLEAN_BATCH
+         *
+         * A list of independent jobs of boolean operations, run in parallel by Run() (when
+         * OpenMP is enabled), for instance one job per layer.  The operations of a job run
+         * in their order, and must only use the polygon sets of their job.
+         */
+        class BOOLEAN_BATCH
+        {
+        public:
+            ///> Starts a new job: the next operations are added to it
+            void NewJob();
+
+            ///> Adds an operation to the current job: aTarget = aTarget op aOther
+            void Add( SHAPE_POLY_SET& aTarget, const SHAPE_POLY_SET& aOther,
+                      POLYGON_MODE aFastMode );
+            void Subtract( SHAPE_POLY_SET& aTarget, const SHAPE_POLY_SET& aOther,
+                           POLYGON_MODE aFastMode );
+            void Intersect( SHAPE_POLY_SET& aTarget, const SHAPE_POLY_SET& aOther,
+                            POLYGON_MODE aFastMode );
+
+            ///> Adds the simplification or the fracturing of aTarget to the current job
+            void Simplify( SHAPE_POLY_SET& aTarget, POLYGON_MODE aFastMode );
+            void Fracture( SHAPE_POLY_SET& aTarget, POLYGON_MODE aFastMode );
+
+            ///> Runs all the jobs, and clears the list
+            void Run();
+
+            int JobCount() const
+            {
+                return m_jobs.size();
+            }
+
+        private:
+            enum OPERATION_TYPE
+            {
+                OP_ADD, OP_SUBTRACT, OP_INTERSECT, OP_SIMPLIFY, OP_FRACTURE
+            };
+
+            struct OPERATION
+            {
+                OPERATION_TYPE          m_type;
+                SHAPE_POLY_SET*         m_target;
+                const SHAPE_POLY_SET*   m_other;
+                POLYGON_MODE            m_mode;
+            };
+
+            void addOperation( OPERATION_TYPE aType, SHAPE_POLY_SET& aTarget,
+                               const SHAPE_POLY_SET* aOther, POLYGON_MODE aFastMode );
+
+            static void runOperation( const OPERATION& aOp );
+
+            std::vector< std::vector<OPERATION> > m_jobs;
+        };
+
         /// @copydoc SHAPE::Format()
         const std::string Format() const;
 
@@ -331,6 +474,9 @@ class SHAPE_POLY_SET : public SHAPE
 
         ///> Returns true is a given subpolygon contains the point aP. If aSubpolyIndex < 0 (default value),
         ///> checks all polygons in the set
+        ///> The bounding boxes of the outlines, and an index of the edges of the large ones by
+        ///> their y range, are built by the first call after a change of the set: only the
+        ///> edges at the height of aP are tested.
         bool Contains( const VECTOR2I& aP, int aSubpolyIndex = -1 ) const;
 
         ///> Returns true if the set is empty (no polygons at all)
@@ -348,6 +494,37 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Deletes aIdx-th polygon from the set
         void DeletePolygon( int aIdx );
 
+        /**
+         * Function CacheTriangulation
+         * triangulates the outlines of the set and keeps the triangles with it, for the
+         * renderers which would otherwise tessellate the polygons at each redraw (see
+         * TriangulatedPolygon()).  The set should be fractured: the holes are ignored.
+         * The outlines are triangulated by ear clipping, in parallel when OpenMP is enabled.
+         * The cache is kept by the copies of the set.
+         */
+        void CacheTriangulation();
+
+        /**
+         * Function IsTriangulationUpToDate
+         * returns true if the cached triangulation was built from the current outlines: the
+         * cache is not invalidated by the changes of the set, but checked against a hash of
+         * its vertices, so a false answer just means the polygons are to be tessellated by
+         * the caller.  False too if an outline could not be triangulated.
+         */
+        bool IsTriangulationUpToDate() const;
+
+        ///> Returns the number of triangulated outlines, see CacheTriangulation()
+        unsigned int TriangulatedPolyCount() const
+        {
+            return m_triangulatedPolys.size();
+        }
+
+        ///> Returns the triangles of the aIndex-th outline, see CacheTriangulation()
+        const TRIANGULATED_POLYGON* TriangulatedPolygon( int aIndex ) const
+        {
+            return &m_triangulatedPolys[aIndex];
+        }
+
     private:
 
         SHAPE_LINE_CHAIN& getContourForCorner( int aCornerId, int& aIndexWithinContour );
@@ -376,14 +553,35 @@ class SHAPE_POLY_SET : public SHAPE
                         const SHAPE_POLY_SET& aShape,
                         const SHAPE_POLY_SET& aOtherShape, POLYGON_MODE aFastMode );
 
-        bool pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN& aPath ) const;
+        struct CONTAINS_INDEX;
+
+        bool pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN& aPath,
+                             const CONTAINS_INDEX& aIndex, int aOutline ) const;
+
+        ///> Returns the index of the outlines used by Contains(), built if needed
+        boost::shared_ptr<const CONTAINS_INDEX> containsIndex() const;
+
+        void invalidateContainsIndex()
+        {
+            m_containsIndex.reset();
+        }
 
         const ClipperLib::Path convertToClipper( const SHAPE_LINE_CHAIN& aPath, bool aRequiredOrientation );
         const SHAPE_LINE_CHAIN convertFromClipper( const ClipperLib::Path& aPath );
 
+        ///> Returns a hash of the vertices of the outlines, see IsTriangulationUpToDate()
+        size_t checksum() const;
+
         typedef std::vector<POLYGON> Polyset;
 
         Polyset m_polys;
+
+        ///> Built by Contains() and shared by the copies, reset by the changes of the set
+        mutable boost::shared_ptr<const CONTAINS_INDEX> m_containsIndex;
+
+        std::vector<TRIANGULATED_POLYGON> m_triangulatedPolys;
+        size_t  m_triangulationHash;
+        bool    m_triangulationValid;
 };
 
 #endif
@@ -97,6 +97,28 @@ void GRResetPenAndBrush( wxDC* DC );
 void GRSetColorPen( wxDC* DC, EDA_COLOR_T Color, int width = 1, wxPenStyle stype = wxPENSTYLE_SOLID );
 void GRSetBrush( wxDC* DC, EDA_COLOR_T Color, bool fill = false );
 
+/**
+ * Function GRBeginLineBatch
+ * starts to batch the lines drawn on @a aDC: the lines drawn with the same pen are drawn
+ * at once, the connected ones as polylines, when the pen changes or before another shape
+ * is drawn, and the pen is set only once.  GREndLineBatch() draws the pending lines, and
+ * must be called before @a aDC is deleted.
+ */
+void GRBeginLineBatch( wxDC* aDC );
+
+/**
+ * Function GREndLineBatch
+ * draws the pending lines of the batch started by GRBeginLineBatch(), and ends it.
+ */
+void GREndLineBatch();
+
+/**
+ * Function GRFlushLineBatch
+ * draws the pending lines of the batch of @a aDC, if any.  Must be called before drawing
+ * directly on @a aDC, or changing its pen or its coordinates, while a batch is started.
+ */
+void GRFlushLineBatch( wxDC* aDC );
+
 /**
  * Function GRForceBlackPen
  * @param flagforce True to force a black pen whenever the asked color
@@ -175,10 +175,33 @@ public:
         return m_buffer;
     }
 
+    /**
+     * Function GetResponseCode
+     * returns the HTTP status code of the last response, i.e. 304 for a conditional
+     * request whose resource did not change, or 0 if no response was received.
+     */
+    long GetResponseCode()
+    {
+        long code = 0;
+
+        curl_easy_getinfo( m_CURL, CURLINFO_RESPONSE_CODE, &code );
+
+        return code;
+    }
+
+    /**
+     * Function GetResponseHeader
+     * returns the value of the header @a aName of the last response, like "ETag",
+     * or an empty string if the response has no such header.  The name is not case
+     * sensitive.
+     */
+    std::string GetResponseHeader( const std::string& aName ) const;
+
 private:
     CURL*           m_CURL;
     curl_slist*     m_headers;
     std::string     m_buffer;
+    std::string     m_responseHeaders;  ///< the header lines of the last response
 };
 
 #endif // KICAD_CURL_EASY_H_
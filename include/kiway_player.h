@@ -192,6 +192,21 @@ public:
      */
     VTBL_ENTRY bool ShowModal( wxString* aResult = NULL, wxWindow* aResultantFocusWindow = NULL );
 
+    /**
+     * Function RunBatchJob
+     * runs the command line job @a aArgs of a program started with the --batch option,
+     * see single_top.cpp.  The frame is not shown, the messages go to the standard
+     * output and error output, and the program exits once the job is done.
+     *
+     * @param aArgs are the arguments of the command line, after --batch.
+     * @return int - the exit status of the program: 0 if the job succeeded.
+     */
+    VTBL_ENTRY int RunBatchJob( const std::vector<wxString>& aArgs )
+    {
+        // overload me for your wxFrame type.
+        return 1;
+    }
+
     //----</Cross Module API>----------------------------------------------------
 
 
@@ -0,0 +1,183 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __BOX2_ARRAY_H
+#define __BOX2_ARRAY_H
+
+#include <math/box2.h>
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define USE_SSE2_BOX2_ARRAY
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#include <arm_neon.h>
+#define USE_NEON_BOX2_ARRAY
+#endif
+
+/**
+ * Class BOX2I_ARRAY
+ * holds an array of integer boxes as four arrays of their left, top, right and bottom
+ * coordinates, so that a box is tested against four of them at once with SSE2 or NEON
+ * instructions.
+ */
+class BOX2I_ARRAY
+{
+public:
+    void Add( const BOX2I& aBox )
+    {
+        BOX2I box( aBox );
+
+        box.Normalize();
+
+        m_left.push_back( box.GetX() );
+        m_top.push_back( box.GetY() );
+        m_right.push_back( clampCoord( (BOX2I::ecoord_type) box.GetX() + box.GetWidth() ) );
+        m_bottom.push_back( clampCoord( (BOX2I::ecoord_type) box.GetY() + box.GetHeight() ) );
+    }
+
+    void Remove( int aIndex )
+    {
+        m_left.erase( m_left.begin() + aIndex );
+        m_top.erase( m_top.begin() + aIndex );
+        m_right.erase( m_right.begin() + aIndex );
+        m_bottom.erase( m_bottom.begin() + aIndex );
+    }
+
+    void Clear()
+    {
+        m_left.clear();
+        m_top.clear();
+        m_right.clear();
+        m_bottom.clear();
+    }
+
+    int Size() const
+    {
+        return m_left.size();
+    }
+
+    /**
+     * Function IntersectsMask
+     * tests the boxes aFirst to aFirst + 31 against aBox grown by aMargin, with the
+     * semantics of BOX2::Intersects(): the boxes touching aBox intersect it.
+     * @return the mask of the boxes intersecting aBox, bit 0 for the box aFirst
+     */
+    unsigned int IntersectsMask( const BOX2I& aBox, int aFirst, int aMargin = 0 ) const
+    {
+        const int count = std::min( Size() - aFirst, 32 );
+
+        if( count <= 0 )
+            return 0;
+
+        BOX2I box( aBox );
+
+        box.Normalize();
+
+        const int left = clampCoord( (BOX2I::ecoord_type) box.GetX() - aMargin );
+        const int top = clampCoord( (BOX2I::ecoord_type) box.GetY() - aMargin );
+        const int right =
+                clampCoord( (BOX2I::ecoord_type) box.GetX() + box.GetWidth() + aMargin );
+        const int bottom =
+                clampCoord( (BOX2I::ecoord_type) box.GetY() + box.GetHeight() + aMargin );
+
+        const int* l = &m_left[0] + aFirst;
+        const int* t = &m_top[0] + aFirst;
+        const int* r = &m_right[0] + aFirst;
+        const int* b = &m_bottom[0] + aFirst;
+
+        unsigned int mask = 0;
+        int i = 0;
+
+#if defined( USE_SSE2_BOX2_ARRAY )
+        const __m128i left4 = _mm_set1_epi32( left );
+        const __m128i top4 = _mm_set1_epi32( top );
+        const __m128i right4 = _mm_set1_epi32( right );
+        const __m128i bottom4 = _mm_set1_epi32( bottom );
+
+        for( ; i + 3 < count; i += 4 )
+        {
+            __m128i outside = _mm_or_si128(
+                    _mm_cmpgt_epi32( _mm_loadu_si128( (const __m128i*) ( l + i ) ), right4 ),
+                    _mm_cmplt_epi32( _mm_loadu_si128( (const __m128i*) ( r + i ) ), left4 ) );
+
+            outside = _mm_or_si128( outside,
+                    _mm_cmpgt_epi32( _mm_loadu_si128( (const __m128i*) ( t + i ) ), bottom4 ) );
+            outside = _mm_or_si128( outside,
+                    _mm_cmplt_epi32( _mm_loadu_si128( (const __m128i*) ( b + i ) ), top4 ) );
+
+            mask |= (unsigned int) ( ~_mm_movemask_ps( _mm_castsi128_ps( outside ) ) & 15 ) << i;
+        }
+#elif defined( USE_NEON_BOX2_ARRAY )
+        static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+
+        const int32x4_t left4 = vdupq_n_s32( left );
+        const int32x4_t top4 = vdupq_n_s32( top );
+        const int32x4_t right4 = vdupq_n_s32( right );
+        const int32x4_t bottom4 = vdupq_n_s32( bottom );
+        const uint32x4_t bits4 = vld1q_u32( laneBits );
+
+        for( ; i + 3 < count; i += 4 )
+        {
+            uint32x4_t inside = vandq_u32( vcleq_s32( vld1q_s32( l + i ), right4 ),
+                                           vcgeq_s32( vld1q_s32( r + i ), left4 ) );
+
+            inside = vandq_u32( inside, vcleq_s32( vld1q_s32( t + i ), bottom4 ) );
+            inside = vandq_u32( inside, vcgeq_s32( vld1q_s32( b + i ), top4 ) );
+
+            // sum the bits of the lanes: no horizontal add before AArch64
+            uint32x4_t bits = vandq_u32( inside, bits4 );
+            uint32x2_t sum = vadd_u32( vget_low_u32( bits ), vget_high_u32( bits ) );
+
+            sum = vpadd_u32( sum, sum );
+            mask |= vget_lane_u32( sum, 0 ) << i;
+        }
+#endif
+
+        for( ; i < count; i++ )
+        {
+            if( l[i] <= right && r[i] >= left && t[i] <= bottom && b[i] >= top )
+                mask |= 1u << i;
+        }
+
+        return mask;
+    }
+
+private:
+    static int clampCoord( BOX2I::ecoord_type aValue )
+    {
+        aValue = std::min<BOX2I::ecoord_type>( INT_MAX, aValue );
+
+        return (int) std::max<BOX2I::ecoord_type>( INT_MIN, aValue );
+    }
+
+    std::vector<int> m_left;
+    std::vector<int> m_top;
+    std::vector<int> m_right;
+    std::vector<int> m_bottom;
+};
+
+#endif
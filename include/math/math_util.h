@@ -50,7 +50,16 @@ int sign( T val )
 template <>
 int rescale( int aNumerator, int aValue, int aDenominator );
 
+#ifdef __SIZEOF_INT128__
+// Inlined, it is called in the inner loops of the geometry functions (see SEG)
+template <>
+inline int64_t rescale( int64_t aNumerator, int64_t aValue, int64_t aDenominator )
+{
+    return ( (__int128_t) aNumerator * (__int128_t) aValue ) / aDenominator;
+}
+#else
 template <>
 int64_t rescale( int64_t aNumerator, int64_t aValue, int64_t aDenominator );
+#endif
 
 #endif // __MATH_UTIL_H
@@ -0,0 +1,108 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file memory_stats.h
+ * @brief The memory used by the subsystems of a program, for the diagnostics.
+ */
+
+#ifndef __MEMORY_STATS_H
+#define __MEMORY_STATS_H
+
+#include <vector>
+#include <wx/string.h>
+
+#include <boost/function.hpp>
+
+/**
+ * Class MEMORY_STATS
+ * is a report of the memory used by the subsystems of a program: for each kind of
+ * data, the number of objects and an estimate of their size.  The sizes are computed
+ * when the report is built, from the sizes of the objects and of their arrays, and do
+ * not count the overhead of the allocator: the data is not tracked while it is
+ * allocated, so the accounting costs nothing until a report is asked for.
+ *
+ * The data owned by the frames is added by the frames.  The objects without a frame
+ * to report them, like the caches of the GAL and of the 3D models, register a source
+ * while they exist, see RegisterSource().
+ */
+class MEMORY_STATS
+{
+public:
+    typedef boost::function<void ( MEMORY_STATS& )> SOURCE;
+
+    /**
+     * Function Add
+     * adds a line to the report.
+     * @param aSubsystem is the name of the subsystem owning the data, e.g. "Board".
+     * @param aItems is the kind of data, e.g. "tracks".
+     * @param aCount is the number of objects.
+     * @param aBytes is the estimated size of the objects.
+     */
+    void Add( const wxString& aSubsystem, const wxString& aItems, size_t aCount,
+              size_t aBytes );
+
+    size_t GetTotalBytes() const;
+
+    /**
+     * Function Format
+     * returns the report as a text table, a line per kind of data followed by the
+     * total of each subsystem, and the total of the program.
+     */
+    wxString Format() const;
+
+    /**
+     * Function Write
+     * writes the Format() table to the file aFileName.
+     * @return false if the file could not be written.
+     */
+    bool Write( const wxString& aFileName ) const;
+
+    /**
+     * Function RegisterSource
+     * adds aSource to the sources of CollectRegistered(), until UnregisterSource() is
+     * called with the same aOwner, usually in the destructor of aOwner.
+     */
+    static void RegisterSource( const void* aOwner, const SOURCE& aSource );
+
+    static void UnregisterSource( const void* aOwner );
+
+    /**
+     * Function CollectRegistered
+     * adds the data of the registered sources to aStats.
+     */
+    static void CollectRegistered( MEMORY_STATS& aStats );
+
+private:
+    struct ENTRY
+    {
+        wxString    m_Subsystem;
+        wxString    m_Items;
+        size_t      m_Count;
+        size_t      m_Bytes;
+    };
+
+    std::vector<ENTRY>  m_entries;
+};
+
+#endif  // __MEMORY_STATS_H
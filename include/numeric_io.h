@@ -0,0 +1,68 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file numeric_io.h
+ * @brief Locale independent formatting and parsing of the numbers of the files.
+ *
+ * The files of KiCad use the '.' decimal separator of the "C" locale, whatever the user
+ * locale is.  These functions convert the numbers with the "C" locale of the C library,
+ * without changing the locale of the process or of the thread calling them: they can be
+ * called from any thread, and from several threads at once.
+ */
+
+#ifndef NUMERIC_IO_H_
+#define NUMERIC_IO_H_
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+
+
+/**
+ * Function KiStrtod
+ * is strtod() in the "C" locale.
+ */
+double KiStrtod( const char* aText, char** aEnd = NULL );
+
+/**
+ * Function KiVsnprintf
+ * is vsnprintf() in the "C" locale.
+ * @return int - the length of the whole output, which does not fit @a aBuffer when it is
+ * @a aSize or more, as vsnprintf() returns on every platform.
+ */
+int KiVsnprintf( char* aBuffer, size_t aSize, const char* aFormat, va_list aArgs );
+
+/**
+ * Function KiSnprintf
+ * is snprintf() in the "C" locale; the return value is the one of KiVsnprintf().
+ */
+int KiSnprintf( char* aBuffer, size_t aSize, const char* aFormat, ... );
+
+/**
+ * Function KiFprintf
+ * is fprintf() in the "C" locale, used by the plotters.
+ */
+int KiFprintf( FILE* aFile, const char* aFormat, ... );
+
+#endif  // NUMERIC_IO_H_
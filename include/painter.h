@@ -172,6 +172,13 @@ public:
      */
     virtual const COLOR4D& GetColor( const VIEW_ITEM* aItem, int aLayer ) const = 0;
 
+    /**
+     * Function GetGridColor
+     * Returns the color used to draw the grid of the canvas.
+     * @return The grid color.
+     */
+    virtual const COLOR4D& GetGridColor() const = 0;
+
     float GetWorksheetLineWidth() const
     {
         return m_worksheetLineWidth;
@@ -35,6 +35,7 @@
 #include <wx/filename.h>
 #include <search_stack.h>
 #include <wx/gdicmn.h>
+#include <ki_mutex.h>
 
 
 class wxConfigBase;
@@ -42,6 +43,7 @@ class wxSingleInstanceChecker;
 class wxApp;
 class wxMenu;
 class wxWindow;
+class THREAD_POOL;
 
 
 // inter program module calling
@@ -275,6 +277,13 @@ public:
      * returns a bare naked wxApp, which may come from wxPython, SINGLE_TOP, or kicad.exe.
      * Use this function instead of wxGetApp().
      */
+    /**
+     * Function GetThreadPool
+     * returns the worker threads of the process, created at the first call.  All the
+     * kifaces queue their parallel jobs there, so that they share the cores.
+     */
+    VTBL_ENTRY THREAD_POOL& GetThreadPool();
+
     VTBL_ENTRY wxApp&   App()
     {
         wxASSERT( m_wx_app );
@@ -357,6 +366,10 @@ protected:
 
     wxApp*          m_wx_app;
 
+    /// The worker threads, see GetThreadPool()
+    THREAD_POOL*    m_thread_pool;
+    MUTEX           m_thread_pool_lock;
+
     // The PGM_* classes can have difficulties at termination if they
     // are not destroyed soon enough.  Relying on a static destructor can be
     // too late for contained objects like wxSingleInstanceChecker.
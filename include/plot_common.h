@@ -32,6 +32,7 @@
 #ifndef PLOT_COMMON_H_
 #define PLOT_COMMON_H_
 
+#include <string>
 #include <vector>
 #include <math/box2.h>
 #include <drawtxt.h>
@@ -39,6 +40,7 @@
 #include <eda_text.h>       // FILL_T
 
 class SHAPE_POLY_SET;
+class DEFLATE_WRITER;
 
 /**
  * Enum PlotFormat
@@ -251,6 +253,17 @@ public:
     virtual void PlotPoly( const std::vector< wxPoint >& aCornerList, FILL_T aFill,
                int aWidth = USE_DEFAULT_LINE_WIDTH ) = 0;
 
+    /**
+     * Function PlotPolys
+     * @brief Draw a set of polygons ( filled or not ), like the filled areas of a zone
+     * By default each polygon is drawn by PlotPoly()
+     * @param aPolygons = the corners lists of the polygons
+     * @param aFill = type of fill
+     * @param aWidth = line width
+     */
+    virtual void PlotPolys( const std::vector< std::vector< wxPoint > >& aPolygons,
+                            FILL_T aFill, int aWidth = USE_DEFAULT_LINE_WIDTH );
+
     /**
      * Function PlotImage
      * Only Postscript plotters can plot bitmaps
@@ -373,6 +386,11 @@ public:
         // NOP for most plotters. Only for Gerber plotter
     }
 
+    virtual void SetGerberOptimization( bool aOptimize )
+    {
+        // NOP for most plotters. Only for Gerber plotter
+    }
+
 protected:
     // These are marker subcomponents
     /**
@@ -646,6 +664,9 @@ protected:
                                       std::vector<int> *pos_pairs );
     void fputsPostscriptString(FILE *fout, const wxString& txt);
 
+    /// Return the string escaped for postscript/PDF, as written by fputsPostscriptString
+    std::string encodePostscriptString( const wxString& txt );
+
     /// Virtual primitive for emitting the setrgbcolor operator
     virtual void emitSetRGBColor( double r, double g, double b ) = 0;
 
@@ -722,11 +743,12 @@ protected:
 class PDF_PLOTTER : public PSLIKE_PLOTTER
 {
 public:
-    PDF_PLOTTER() : pageStreamHandle( 0 ), workFile( NULL )
+    PDF_PLOTTER() : pageStreamHandle( 0 ), workStream( NULL )
     {
         // Avoid non initialized variables:
         pageStreamHandle = streamLengthHandle = fontResDictHandle = 0;
         pageTreeHandle = 0;
+        compressionLevel = 9;   // the best compression
     }
 
     virtual PlotFormat GetPlotterType() const
@@ -753,6 +775,29 @@ public:
     virtual bool EndPlot();
     virtual void StartPage();
     virtual void ClosePage();
+
+    /**
+     * Function ClosePageStream
+     * closes the page of a plotter without output file, opened by StartPage(), and
+     * returns its compressed content stream, for AddPage() of another plotter.  The
+     * pages of a document can so be plotted on several threads.
+     */
+    void ClosePageStream( std::string& aStream );
+
+    /**
+     * Function AddPage
+     * adds a page whose content was plotted by another plotter, see ClosePageStream().
+     * The page settings are the current ones, and no page must be open.
+     */
+    void AddPage( const std::string& aStream );
+
+    /**
+     * Function SetCompressionLevel
+     * sets the zlib compression level of the page content streams, from 1 (the faster)
+     * to 9 (the smaller, the default).  The pages are compressed while they are plotted.
+     */
+    void SetCompressionLevel( int aLevel ) { compressionLevel = aLevel; }
+
     virtual void SetCurrentLineWidth( int width );
     virtual void SetDash( bool dashed );
 
@@ -796,13 +841,19 @@ protected:
     void closePdfObject();
     int startPdfStream(int handle = -1);
     void closePdfStream();
+    void openWorkStream();
+    size_t closeWorkStream();
+    void writePdfStreamData( const std::string& aStream );
+    void endPdfStream( size_t aLength );
+    void emitPageObject();
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
     int pageStreamHandle;	 /// Handle of the page content object
     int streamLengthHandle;      /// Handle to the deferred stream length
-    wxString workFilename;
-    FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
+    DEFLATE_WRITER* workStream;  /// Compresses the page stream while it is written
+    std::string pageData;        /// The compressed page stream of a plotter without output file
+    int compressionLevel;        /// The zlib compression level of the page streams
     std::vector<long> xrefTable; /// The PDF xref offset table
 };
 
@@ -955,6 +1006,20 @@ public:
     virtual void PlotPoly( const std::vector< wxPoint >& aCornerList,
                            FILL_T aFill, int aWidth = USE_DEFAULT_LINE_WIDTH );
 
+    /**
+     * In optimized mode, the filled polygons are written as the contours of a single
+     * G36/G37 region
+     */
+    virtual void PlotPolys( const std::vector< std::vector< wxPoint > >& aPolygons,
+                            FILL_T aFill, int aWidth = USE_DEFAULT_LINE_WIDTH );
+
+    /**
+     * In optimized mode, a segment ending at the current point is drawn backwards,
+     * so that it continues the current line without a move
+     */
+    virtual void ThickSegment( const wxPoint& start, const wxPoint& end, int width,
+                               EDA_DRAW_MODE_T tracemode );
+
     virtual void PenTo( const wxPoint& pos, char plume );
 
     /**
@@ -1014,9 +1079,29 @@ public:
      */
     virtual void SetGerberCoordinatesFormat( int aResolution, bool aUseInches = false );
 
+    /**
+     * Function SetGerberOptimization
+     * enables the optimized output: the coordinates unchanged since the last operation
+     * are omitted, the moves to the current point are not written, and the round
+     * plotting and flashing apertures of the same size share their D code.
+     * Should be called before StartPlot()
+     */
+    virtual void SetGerberOptimization( bool aOptimize ) { m_optimizeOutput = aOptimize; }
+
 protected:
     void selectAperture( const wxSize& size, APERTURE::APERTURE_TYPE type );
 
+    /**
+     * Function apertureMatches
+     * @return true if the aperture @a aTool can be used for the aperture of @a size
+     * and @a type
+     */
+    bool apertureMatches( const APERTURE& aTool, const wxSize& size,
+                          APERTURE::APERTURE_TYPE type ) const;
+
+    /// @return true if @a aPos, in device units, is the current point
+    bool isCurrentPos( const DPOINT& aPos ) const;
+
     /**
      * Emit a D-Code record, using proper conversions
      * to format a leading zero omitted gerber coordinate
@@ -1042,6 +1127,11 @@ protected:
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
+
+    bool     m_optimizeOutput;  // true to write the compact output, see SetGerberOptimization
+    bool     m_inRegion;        // true between G36 and G37
+    bool     m_lastPosValid;    // true when m_lastPos is the current point
+    wxPoint  m_lastPos;         // the current point, in device units
 };
 
 
@@ -0,0 +1,96 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef PROGRESS_REPORTER_H_
+#define PROGRESS_REPORTER_H_
+
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <wx/string.h>
+
+class wxProgressDialog;
+
+
+/**
+ * Class PROGRESS_REPORTER
+ * is shared by a job running on a thread of the pool and the GUI thread showing its
+ * progress.  The job reports the steps it has done, in the units of the range of the
+ * progress dialog, and checks IsCancelled() between them to end early once the user
+ * cancelled it.  All the functions are thread safe.
+ */
+class PROGRESS_REPORTER
+{
+public:
+    PROGRESS_REPORTER() :
+        m_progress( 0 ), m_cancelled( false )
+    {
+    }
+
+    ///> Advances the progress of the job by @a aCount steps
+    void AdvanceProgress( int aCount = 1 );
+
+    ///> Sets the message describing the current step of the job
+    void Report( const wxString& aMessage );
+
+    ///> Asks the job to end early
+    void Cancel();
+
+    bool IsCancelled() const;
+
+    /**
+     * Function GetProgress
+     * returns the progress of the job, and the message of its current step.
+     * @param aMessage [out] is the message of the current step.
+     * @return the number of steps done.
+     */
+    int GetProgress( wxString* aMessage ) const;
+
+private:
+    mutable boost::mutex    m_lock;
+    int                     m_progress;
+    wxString                m_message;
+    bool                    m_cancelled;
+};
+
+
+///> A job run by RunInBackground(), which reports to its PROGRESS_REPORTER
+typedef boost::function<void (PROGRESS_REPORTER&)> BACKGROUND_JOB;
+
+
+/**
+ * Function RunInBackground
+ * runs @a aJob on a thread of the pool and returns once it ended.  Meanwhile the calling
+ * thread, the GUI one, updates @a aDialog with the progress of the job, so that the
+ * windows are still drawn; the Abort button of the dialog cancels the job.
+ *
+ * The dialog is expected to be modal, as the job usually reads the items the user would
+ * edit.  Without dialog the job runs on the calling thread.
+ *
+ * @param aJob is the job to run.
+ * @param aDialog, if not NULL, shows the progress of the job, up to its range.
+ * @return false if the job was cancelled, or ended with an exception.
+ */
+bool RunInBackground( const BACKGROUND_JOB& aJob, wxProgressDialog* aDialog );
+
+#endif  // PROGRESS_REPORTER_H_
@@ -25,6 +25,7 @@
 #define PROJECT_H_
 
 #include <vector>
+#include <boost/shared_ptr.hpp>
 #include <wx/string.h>
 #include <wx/filename.h>
 
@@ -36,6 +37,7 @@
 class wxConfigBase;
 class PARAM_CFG_ARRAY;
 class FP_LIB_TABLE;
+class FOOTPRINT_LIST;
 class PART_LIBS;
 class SEARCH_STACK;
 class S3D_CACHE;
@@ -193,6 +195,7 @@ public:
         ELEM_SCH_PART_LIBS,
         ELEM_SCH_SEARCH_STACK,
         ELEM_3DCACHE,
+        ELEM_FPLIST,
 
         ELEM_COUNT
     };
@@ -253,6 +256,14 @@ public:
     // These are all prefaced with "Pcb"
     FP_LIB_TABLE* PcbFootprintLibs();
 
+    /**
+     * Function PcbFootprintList
+     * returns the footprints of all the libraries of PcbFootprintLibs(), shared by the
+     * frames of the project.  The libraries are read on the first call, and read again
+     * when one of their files changed, see SHARED_FOOTPRINT_LIST.
+     */
+    boost::shared_ptr<FOOTPRINT_LIST> PcbFootprintList();
+
     /**
      * Function Get3DCacheManager
      * returns a pointer to an instance of the 3D cache manager;
@@ -413,6 +413,62 @@ public:
 };
 
 
+/**
+ * Class MAPPED_FILE_LINE_READER
+ * is a LINE_READER that reads a whole file mapped into memory, which is faster than
+ * a FILE_LINE_READER for large files: the bytes are not copied into a stdio buffer
+ * first, and each line is found with memchr() and copied at once instead of byte by
+ * byte. Where the file cannot be mapped, its contents are read into memory at once.
+ */
+class MAPPED_FILE_LINE_READER : public LINE_READER
+{
+protected:
+
+    const char*         data;       ///< the file contents
+    size_t              size;       ///< no. bytes in data
+    size_t              ndx;        ///< offset of the next line in data
+    bool                mapped;     ///< true if data is mapped, false if it is in buffer
+    std::vector<char>   buffer;     ///< the file contents, when the file cannot be mapped
+
+public:
+
+    /**
+     * Constructor MAPPED_FILE_LINE_READER
+     * maps @a aFileName into memory.
+     *
+     * @param aFileName is the name of the file to read and to use for error reporting
+     *  purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum allowed length of a line.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or read.
+     */
+    MAPPED_FILE_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX ) throw( IO_ERROR );
+
+    ~MAPPED_FILE_LINE_READER();
+
+    char* ReadLine() throw( IO_ERROR );   // see LINE_READER::ReadLine() description
+
+    /**
+     * Function Rewind
+     * goes back to the beginning of the file and resets the line number back to zero.
+     */
+    void Rewind()
+    {
+        ndx = 0;
+        lineNum = 0;
+    }
+
+    ///> Returns the whole contents of the file
+    const char* Data() const    { return data; }
+
+    ///> Returns the size of the file
+    size_t Size() const         { return size; }
+};
+
+
 /**
  * Class STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -434,8 +490,12 @@ public:
      *
      * @param aSource describes the source of aString for error reporting purposes
      *  can be anything meaninful, such as wxT( "clipboard" ).
+     *
+     * @param aStartingLineNumber is the initial line number to report on error, and is
+     *  accessible here for the case where a section of a larger text is being read.
      */
-    STRING_LINE_READER( const std::string& aString, const wxString& aSource );
+    STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                        unsigned aStartingLineNumber = 0 );
 
     /**
      * Constructor STRING_LINE_READER( const STRING_LINE_READER& )
@@ -473,6 +533,7 @@ public:
 
 
 #define OUTPUTFMTBUFZ    500        ///< default buffer size for any OUTPUT_FORMATTER
+#define FILEFMTBUFZ      (1 << 20)  ///< stdio buffer size of a FILE_OUTPUTFORMATTER
 
 /**
  * Class OUTPUTFORMATTER
@@ -562,6 +623,19 @@ public:
      */
     int PRINTF_FUNC Print( int nestLevel, const char* fmt, ... ) throw( IO_ERROR );
 
+    /**
+     * Function Write
+     * writes already formatted text to the output stream.  It is the fast path of
+     * Print() for the text formatted without printf(), like the coordinates.
+     *
+     * @param nestLevel The multiple of spaces to precede the output with.
+     * @param aText is the text to output, not necessarily nul terminated.
+     * @param aCount is the count of bytes of aText.
+     * @return int - the number of characters output.
+     * @throw IO_ERROR, if there is a problem outputting, such as a full disk.
+     */
+    int Write( int nestLevel, const char* aText, int aCount ) throw( IO_ERROR );
+
     /**
      * Function GetQuoteChar
      * performs quote character need determination.
@@ -682,6 +756,7 @@ protected:
 
     FILE*       m_fp;               ///< takes ownership
     wxString    m_filename;
+    std::vector<char> m_buffer;     ///< stdio buffer of m_fp
 };
 
 
@@ -0,0 +1,143 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SEXPR_DOM_H_
+#define SEXPR_DOM_H_
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <dsnlexer.h>
+
+
+/**
+ * Struct SEXPR_NODE
+ * is an element of a SEXPR_DOM: a list, or an atom of a list.  The text of an atom is
+ * a view into the text of the DOM, it is not nul terminated, and it is valid as long as
+ * the DOM is.
+ */
+struct SEXPR_NODE
+{
+    const char* m_text;         ///< the text of an atom, the '(' of a list
+    unsigned    m_length;       ///< the length of m_text
+    int         m_token;        ///< DSN_LEFT for a list, else DSN_STRING, DSN_NUMBER,
+                                ///< DSN_SYMBOL or a keyword token
+    int         m_line;         ///< the line number, from 1
+    int         m_offset;       ///< the byte offset in the line
+    SEXPR_NODE* m_child;        ///< the first element of a list
+    SEXPR_NODE* m_next;         ///< the next element of the list holding this one
+
+    bool IsList() const { return m_token == DSN_LEFT; }
+
+    /**
+     * Function Keyword
+     * returns the token of the first element of a list, its keyword, DSN_RIGHT for an
+     * empty list, or DSN_LEFT if it is a list too.  For an atom, its own token.
+     */
+    int Keyword() const
+    {
+        if( !IsList() )
+            return m_token;
+
+        return m_child ? m_child->m_token : DSN_RIGHT;
+    }
+
+    /// The elements of a list after its keyword
+    SEXPR_NODE* Arguments() const { return m_child ? m_child->m_next : NULL; }
+
+    std::string Str() const { return std::string( m_text, m_length ); }
+
+    wxString FromUTF8() const { return wxString::FromUTF8( m_text, m_length ); }
+
+    /// The value of a DSN_NUMBER atom
+    double ToDouble() const;
+    int ToInt() const;
+};
+
+
+/**
+ * Class SEXPR_DOM
+ * holds the tree of the s-expressions of a text, with the syntax of DSNLEXER outside of
+ * the specctra mode: '#' comment lines, and quoted strings with escape sequences.
+ *
+ * Unlike DSNLEXER it does not copy the tokens: the text is copied once, the atoms point
+ * into it, and the nodes are allocated by blocks, all freed with the DOM.  The keywords
+ * are found with the KEYWORD_HASH of a generated lexer, so the parsers can switch on
+ * the same tokens.  This suits the parsers which look at a whole item before creating
+ * it, or which keep the text of the items.
+ */
+class SEXPR_DOM
+{
+public:
+    /**
+     * Constructor
+     * @param aKeywords is the keyword hash of a generated lexer, see KeywordHash().
+     * @param aSource is the origin of the text, for the error messages.
+     */
+    SEXPR_DOM( const KEYWORD_HASH* aKeywords, const wxString& aSource );
+    ~SEXPR_DOM();
+
+    /**
+     * Function Parse
+     * builds the nodes of the nul terminated @a aText, replacing those of a previous
+     * call.  A ')' closing no list ends the text, and the lists left open at the end
+     * of the text are closed, as the DSNLEXER parsers stopping at DSN_EOF do.
+     */
+    void Parse( const char* aText ) throw( PARSE_ERROR );
+
+    /// The first node of the text, or NULL
+    SEXPR_NODE* GetFirst() const { return m_first; }
+
+    const wxString& GetSource() const { return m_source; }
+
+    /**
+     * Function Expecting
+     * throws a PARSE_ERROR at @a aNode, as DSNLEXER::Expecting().
+     * @param aNode is where @a aText was expected, or the list which ended early.
+     */
+    void Expecting( const char* aText, const SEXPR_NODE* aNode ) const throw( PARSE_ERROR );
+
+    /// Throws a PARSE_ERROR for @a aNode, as DSNLEXER::Unexpected()
+    void Unexpected( const SEXPR_NODE* aNode ) const throw( PARSE_ERROR );
+
+private:
+    const KEYWORD_HASH*         m_keywords;
+    wxString                    m_source;
+    std::string                 m_text;         ///< the text parsed, the atoms point in it
+    std::deque<std::string>     m_decoded;      ///< the strings with escape sequences
+    std::vector<const char*>    m_lines;        ///< the start of each line of m_text
+    std::vector<SEXPR_NODE*>    m_blocks;       ///< the node allocation blocks
+    unsigned                    m_blockUsed;    ///< count of nodes used in the last block
+    SEXPR_NODE*                 m_first;
+
+    SEXPR_NODE* newNode( int aToken, const char* aText, unsigned aLength, int aLine,
+                         int aOffset );
+
+    void clear();
+
+    void throwError( const wxString& aMessage, int aLine, int aOffset ) const
+        throw( PARSE_ERROR );
+};
+
+#endif  // SEXPR_DOM_H_
@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file thread_pool.h
+ * @brief The process wide pool of worker threads.
+ */
+
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <deque>
+
+#include <boost/function.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+
+class TASK_GROUP;
+
+
+/**
+ * Class THREAD_POOL
+ * is a work stealing scheduler: each worker thread has its own queue of tasks, and takes
+ * the tasks of the other queues when its own is empty.  The tasks queued by a task go to
+ * the queue of its worker, so the nested parallel jobs share the same threads instead of
+ * creating new ones.
+ *
+ * There is a single pool per process, see PGM_BASE::GetThreadPool(), sized to the
+ * hardware: the parallel jobs of the different kifaces compose instead of competing for
+ * the cores.  The tasks are queued and waited for through a TASK_GROUP.
+ */
+class THREAD_POOL
+{
+public:
+    typedef boost::function<void ()>    TASK;
+
+    /**
+     * Constructor THREAD_POOL
+     * @param aThreadCount is the number of threads running the tasks, including the
+     * thread waiting for them, or 0 for the number of hardware threads.
+     */
+    THREAD_POOL( int aThreadCount = 0 );
+    ~THREAD_POOL();
+
+    ///> Returns the number of threads running the tasks, including the waiting thread
+    int GetThreadCount() const      { return m_workerCount + 1; }
+
+private:
+    friend class TASK_GROUP;
+
+    struct QUEUED_TASK
+    {
+        TASK        m_task;
+        TASK_GROUP* m_group;
+        bool        m_cLocale;  ///< queued in the scope of a LOCALE_IO, run in one too
+    };
+
+    struct TASK_QUEUE
+    {
+        boost::mutex                m_lock;
+        std::deque<QUEUED_TASK>     m_tasks;
+    };
+
+    ///> Queues a task, in the queue of the calling thread
+    void push( const TASK& aTask, TASK_GROUP* aGroup );
+
+    /**
+     * Function runOne
+     * runs a task of the queue of the calling thread, the last queued one, or else the
+     * oldest task of another queue.
+     * @param aGroup is the group of the task to run, or NULL for a task of any group.
+     * @return false if there was no task to run.
+     */
+    bool runOne( TASK_GROUP* aGroup = NULL );
+
+    ///> Removes from @a aQueue its newest or oldest task of @a aGroup (of any group
+    ///> if NULL) into @a aTask, @return false if there is none
+    bool takeTask( TASK_QUEUE& aQueue, TASK_GROUP* aGroup, bool aNewest, QUEUED_TASK& aTask );
+
+    ///> Returns the queue of the calling thread, the shared one for the non worker threads
+    TASK_QUEUE& ownQueue();
+
+    void workerLoop( int aIndex );
+
+    int                                 m_workerCount;
+    boost::ptr_vector<TASK_QUEUE>       m_queues;       ///< one per worker, then the shared one
+    boost::thread_group                 m_threads;
+    boost::thread_specific_ptr<int>     m_workerIndex;  ///< index of the queue of a worker
+
+    boost::mutex                        m_wakeUpLock;   ///< protects m_queued and m_stop
+    boost::condition_variable           m_wakeUp;
+    int                                 m_queued;       ///< count of tasks in the queues
+    bool                                m_stop;
+};
+
+
+/**
+ * Class TASK_GROUP
+ * queues tasks to a THREAD_POOL, and waits for them.  The waiting thread runs the queued
+ * tasks of the group meanwhile, so a task can queue and wait for tasks without a deadlock,
+ * and never runs the tasks of another group.
+ *
+ * The tasks should catch their exceptions: an exception left by a task is only reported
+ * by the return value of Wait().
+ */
+class TASK_GROUP
+{
+public:
+    TASK_GROUP( THREAD_POOL& aPool ) :
+        m_pool( aPool ), m_pending( 0 ), m_failed( false )
+    {
+    }
+
+    ~TASK_GROUP()
+    {
+        Wait();
+    }
+
+    ///> Queues @a aTask, which may run at once on any thread of the pool
+    void Run( const THREAD_POOL::TASK& aTask );
+
+    /**
+     * Function Wait
+     * returns once all the tasks of the group have run.
+     * @return false if a task ended with an exception.
+     */
+    bool Wait();
+
+    /**
+     * Function WaitFor
+     * waits at most @a aMilliseconds for the tasks of the group, without running any task
+     * on the calling thread, which stays available to handle its events.
+     * @return true if all the tasks of the group have run.  Wait() then returns at once.
+     */
+    bool WaitFor( unsigned aMilliseconds );
+
+private:
+    friend class THREAD_POOL;
+
+    ///> Called by the pool after running a task of the group
+    void taskDone( bool aFailed );
+
+    THREAD_POOL&                m_pool;
+    boost::mutex                m_lock;
+    boost::condition_variable   m_done;
+    int                         m_pending;
+    bool                        m_failed;
+};
+
+#endif  // THREAD_POOL_H_
@@ -81,6 +81,12 @@ public:
      */
     virtual void DispatchWxCommand( wxCommandEvent& aEvent );
 
+    /**
+     * Function DispatchPendingEvents()
+     * Processes the mouse motion coalesced by the TOOL_MANAGER, once the application is idle.
+     */
+    virtual void DispatchPendingEvents();
+
 private:
     ///> Number of mouse buttons that is handled in events.
     static const int MouseButtonCount = 3;
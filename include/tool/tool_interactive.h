@@ -29,6 +29,7 @@
 
 #include <tool/tool_event.h>
 #include <tool/tool_base.h>
+#include <progress_reporter.h>
 
 class CONTEXT_MENU;
 
@@ -81,6 +82,22 @@ public:
      */
     OPT_TOOL_EVENT Wait( const TOOL_EVENT_LIST& aEventList = TOOL_EVENT( TC_ANY, TA_ANY ) );
 
+    /**
+     * Function RunInBackground()
+     *
+     * Runs the heavy step of an action on a thread of the pool, and resumes the tool on the
+     * GUI thread once it ended.  Meanwhile a modal dialog, whose Abort button cancels the
+     * job, shows its progress: the events of the frame are still handled, but the user
+     * cannot edit the items the job works on.  The GAL canvas is not drawn either, as the
+     * job may modify the items it draws; the views of the items have to be updated once
+     * this function returns.
+     * @param aJob is the job to run, which reports its progress to the PROGRESS_REPORTER.
+     * @param aTitle is the title of the progress dialog.
+     * @param aMaxProgress is the number of steps of the job.
+     * @return false if the job was cancelled, or ended with an exception.
+     */
+    bool RunInBackground( const BACKGROUND_JOB& aJob, const wxString& aTitle, int aMaxProgress );
+
     /** functions below are not yet implemented - their interface may change */
     /*template <class Parameters, class ReturnValue>
         bool InvokeTool( const std::string& aToolName, const Parameters& parameters,
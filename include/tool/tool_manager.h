@@ -32,6 +32,8 @@
 
 #include <tool/tool_base.h>
 
+#include <boost/optional.hpp>
+
 class TOOL_BASE;
 class ACTION_MANAGER;
 class CONTEXT_MENU;
@@ -193,10 +195,31 @@ public:
 
     /**
      * Propagates an event to tools that requested events of matching type(s).
+     *
+     * The mouse motion and drag events are coalesced: such an event is kept pending until
+     * the application is idle, see DispatchPendingMotion(), and a more recent one of the
+     * same kind replaces it.  Any other event dispatches the pending one first.
      * @param aEvent is the event to be processed.
      */
     bool ProcessEvent( const TOOL_EVENT& aEvent );
 
+    /**
+     * Function DispatchPendingMotion()
+     * Processes the mouse motion or drag event kept pending by ProcessEvent(), if any.
+     * Called when the application is idle, once the input events are all received.
+     */
+    void DispatchPendingMotion();
+
+    /**
+     * Function GetCoalescedEventCount()
+     * Returns the number of mouse motion or drag events replaced by a more recent one
+     * before being processed.
+     */
+    unsigned int GetCoalescedEventCount() const
+    {
+        return m_coalescedEvents;
+    }
+
     /**
      * Puts an event to the event queue to be processed at the end of event processing cycle.
      * @param aEvent is the event to be put into the queue.
@@ -318,6 +341,12 @@ private:
     struct TOOL_STATE;
     typedef std::pair<TOOL_EVENT_LIST, TOOL_STATE_FUNC> TRANSITION;
 
+    /**
+     * Function processEvent
+     * Propagates an event to the tools, without coalescing, see ProcessEvent().
+     */
+    bool processEvent( const TOOL_EVENT& aEvent );
+
     /**
      * Function dispatchInternal
      * Passes an event at first to the active tools, then to all others.
@@ -441,6 +470,12 @@ private:
 
     /// Flag saying if the currently processed event should be passed to other tools.
     bool m_passEvent;
+
+    /// The last mouse motion or drag event, waiting for the application to be idle.
+    boost::optional<TOOL_EVENT> m_pendingMotion;
+
+    /// Number of the motion events replaced by a more recent one.
+    unsigned int m_coalescedEvents;
 };
 
 #endif
@@ -0,0 +1,110 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file trace_events.h
+ * @brief Scoped trace zones of the long running operations, written as Chrome trace events.
+ */
+
+#ifndef __TRACE_EVENTS_H
+#define __TRACE_EVENTS_H
+
+#include <string>
+#include <profile.h>
+
+/**
+ * Class TRACE_EVENTS
+ * records the time spans of the trace zones of each thread, and writes them in the
+ * Chrome trace event JSON format, read by chrome://tracing and the Perfetto UI.
+ *
+ * The tracing is enabled by setting the KICAD_TRACE_EVENTS environment variable to
+ * the name of the JSON file, written when the program exits.  When disabled, a trace
+ * zone costs a test.  The events of a thread are recorded without taking a shared
+ * lock, so zones may be used by the tasks of the thread pool.
+ */
+class TRACE_EVENTS
+{
+public:
+    static bool IsEnabled()
+    {
+        return m_enabled;
+    }
+
+    /**
+     * Function Enable
+     * starts recording the trace zones, to be written to aFileName by Write() or when
+     * the program exits.
+     */
+    static void Enable( const std::string& aFileName );
+
+    /**
+     * Function Record
+     * adds a complete event to the events of the calling thread.
+     * @param aName is the name of the zone, a string literal: the pointer is kept.
+     * @param aStart and aEnd are the get_tics() at the start and the end of the zone.
+     */
+    static void Record( const char* aName, uint64_t aStart, uint64_t aEnd );
+
+    /**
+     * Function Write
+     * writes the events recorded so far to the trace file.
+     * @return false if the tracing is disabled or the file could not be written.
+     */
+    static bool Write();
+
+private:
+    static bool m_enabled;
+};
+
+
+/**
+ * Class TRACE_ZONE
+ * records a trace event spanning its lifetime, see TRACE_SCOPE().
+ */
+class TRACE_ZONE
+{
+public:
+    TRACE_ZONE( const char* aName ) :
+        m_name( aName ), m_start( TRACE_EVENTS::IsEnabled() ? get_tics() : 0 )
+    {
+    }
+
+    ~TRACE_ZONE()
+    {
+        if( m_start )
+            TRACE_EVENTS::Record( m_name, m_start, get_tics() );
+    }
+
+private:
+    const char* m_name;
+    uint64_t    m_start;
+};
+
+
+#define TRACE_ZONE_CONCAT2( a, b ) a##b
+#define TRACE_ZONE_CONCAT( a, b ) TRACE_ZONE_CONCAT2( a, b )
+
+/// Traces the rest of the enclosing scope as an event named aName, a string literal
+#define TRACE_SCOPE( aName ) TRACE_ZONE TRACE_ZONE_CONCAT( traceZone, __LINE__ )( aName )
+
+#endif /* __TRACE_EVENTS_H */
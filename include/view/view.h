@@ -77,6 +77,15 @@ public:
      */
     void Add( VIEW_ITEM* aItem );
 
+    /**
+     * Function AddItems()
+     * Adds many VIEW_ITEMs to the view at once, e.g. a whole board. The R-trees of the
+     * layers are then packed, which is faster than adding the items one by one and
+     * results in faster queries.
+     * @param aItems: items to be added. No ownership is given
+     */
+    void AddItems( const std::vector<VIEW_ITEM*>& aItems );
+
     /**
      * Function Remove()
      * Removes a VIEW_ITEM from the view.
@@ -95,6 +104,18 @@ public:
      */
     int Query( const BOX2I& aRect, std::vector<LAYER_ITEM_PAIR>& aResult ) const;
 
+    /**
+     * Function Pick()
+     * Finds the items shown in a small window of the screen: the cached items near it are
+     * drawn with their ids by the GAL, and read back.  Only the item on top is found in each
+     * pixel, as it is seen, without any hit test.
+     * @param aPosition is the center of the window, in screen pixels.
+     * @param aRadius is the distance from the center to the sides of the window, in pixels.
+     * @param aResult receives the items found, the ones closest to aPosition first.
+     * @return false if the GAL cannot pick items: the caller has to Query() and hit test them.
+     */
+    bool Pick( const VECTOR2D& aPosition, int aRadius, std::vector<VIEW_ITEM*>& aResult );
+
     /**
      * Function SetRequired()
      * Marks the aRequiredId layer as required for the aLayerId layer. In order to display the
@@ -502,7 +523,7 @@ public:
     {
         wxASSERT( aTarget < TARGETS_NUMBER );
 
-        return m_dirtyTargets[aTarget];
+        return m_dirtyTargets[aTarget] || m_damagedTargets[aTarget];
     }
 
     /**
@@ -584,6 +605,7 @@ private:
     struct clearLayerCache;
     struct recacheItem;
     struct drawItem;
+    struct pickItem;
     struct unlinkItem;
     struct updateItemsColor;
     struct changeItemsDepth;
@@ -598,8 +620,16 @@ private:
         wxASSERT( aTarget < TARGETS_NUMBER );
 
         m_dirtyTargets[aTarget] = false;
+        m_damagedTargets[aTarget] = false;
     }
 
+    /**
+     * Function markTargetDamaged()
+     * Marks an area of a target to be redrawn, e.g. the bounding box of a modified item.
+     * Unless a target is marked dirty as a whole, only its damaged area is redrawn.
+     */
+    void markTargetDamaged( int aTarget, const BOX2I& aArea );
+
     /**
      * Function draw()
      * Draws an item, but on a specified layers. It has to be marked that some of drawing settings
@@ -708,6 +738,18 @@ private:
     /// Flags to mark targets as dirty, so they have to be redrawn on the next refresh event
     bool m_dirtyTargets[TARGETS_NUMBER];
 
+    /// Flags to mark targets with a damaged area, to be redrawn on the next refresh event
+    bool m_damagedTargets[TARGETS_NUMBER];
+
+    /// Union of the damaged areas of each target
+    BOX2I m_damagedAreas[TARGETS_NUMBER];
+
+    /// Are only the damaged areas of the cached and non-cached targets redrawn?
+    bool m_clipRedraw;
+
+    /// Area of the cached and non-cached targets redrawn, if m_clipRedraw is set
+    BOX2I m_clipArea;
+
     /// Rendering order modifier for layers that are marked as top layers
     static const int TOP_LAYER_MODIFIER;
 
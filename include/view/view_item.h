@@ -73,6 +73,7 @@ public:
         COLOR       = 0x02,     /// Color has changed
         GEOMETRY    = 0x04,     /// Position or shape has changed
         LAYERS      = 0x08,     /// Layers have changed
+        REPAINT     = 0x10,     /// Only the cached geometry is to be redrawn (bounding box and layers are unchanged)
         ALL         = 0xff
     };
 
@@ -304,6 +305,10 @@ protected:
     /// Stores layer numbers used by the item.
     std::bitset<VIEW::VIEW_MAX_LAYERS> m_layers;
 
+    /// Bounding box the item was inserted in the layers R-trees with, it is also the area
+    /// to be redrawn when the item changes.
+    BOX2I m_viewBBox;
+
     /**
      * Function saveLayers()
      * Saves layers used by the item.
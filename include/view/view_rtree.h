@@ -55,6 +55,29 @@ public:
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function BulkLoad()
+     * Inserts many items into the tree at once. The tree is rebuilt packed, with its current
+     * items and aItems. Items' bounding boxes are taken via their ViewBBox() method.
+     */
+    void BulkLoad( const std::vector<VIEW_ITEM*>& aItems )
+    {
+        std::vector<BulkEntry> entries( aItems.size() );
+
+        for( unsigned int i = 0; i < aItems.size(); ++i )
+        {
+            const BOX2I& bbox = aItems[i]->ViewBBox();
+
+            entries[i].m_min[0] = bbox.GetX();
+            entries[i].m_min[1] = bbox.GetY();
+            entries[i].m_max[0] = bbox.GetRight();
+            entries[i].m_max[1] = bbox.GetBottom();
+            entries[i].m_data = aItems[i];
+        }
+
+        VIEW_RTREE_BASE::BulkLoad( entries );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
@@ -71,6 +94,20 @@ public:
         VIEW_RTREE_BASE::Remove( mmin, mmax, aItem );
     }
 
+    /**
+     * Function Remove()
+     * Removes an item from the tree, searching it only within the bounding box it was
+     * inserted with. The whole tree is searched if the item is not found there.
+     */
+    void Remove( VIEW_ITEM* aItem, const BOX2I& aBBox )
+    {
+        const int       mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int       mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+        if( !VIEW_RTREE_BASE::Remove( mmin, mmax, aItem ) )
+            Remove( aItem );
+    }
+
     /**
      * Function Query()
      * Executes a function object aVisitor for each item whose bounding box intersects
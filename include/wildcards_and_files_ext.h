@@ -94,6 +94,7 @@ extern const wxString AllFilesWildcard;
 extern const wxString ComponentFileWildcard;
 extern const wxString DrillFileWildcard;
 extern const wxString SVGFileWildcard;
+extern const wxString PngFileWildcard;
 extern const wxString ReportFileWildcard;
 extern const wxString FootprintPlaceFileWildcard;
 extern const wxString Shapes3DFileWildcard;
@@ -35,9 +35,10 @@
 #include <eda_text.h>
 #include <eda_text.h>
 #include <class_bitmap_base.h>
+#include <class_title_block.h>
 
 class WORKSHEET_DATAITEM;        // Forward declaration
-class TITLE_BLOCK;
+class WORKSHEET_LAYOUT;
 class PAGE_INFO;
 
 #define TB_DEFAULT_TEXTSIZE             1.5  // default worksheet text size in mm
@@ -335,6 +336,37 @@ protected:
     wxString        m_fileName;         // for basic inscriptions
     const wxString* m_sheetFullName;    // for basic inscriptions
 
+    // The parameters the items of m_graphicList were built with: a list kept from one
+    // draw to the next is built again only when one of them changes
+    struct BUILD_KEY
+    {
+        const WORKSHEET_LAYOUT* m_layout;
+        unsigned long   m_layoutRevision;
+        wxString        m_paperFormat;
+        wxSize          m_pageSize;
+        TITLE_BLOCK     m_titleBlock;
+        wxString        m_fileName;
+        wxString        m_sheetFullName;
+        double          m_milsToIu;
+        int             m_penSize;
+        int             m_sheetNumber;
+        int             m_sheetCount;
+        EDA_COLOR_T     m_color;
+        EDA_COLOR_T     m_altColor;
+
+        bool operator==( const BUILD_KEY& aOther ) const;
+    };
+
+    BUILD_KEY m_builtKey;
+    bool      m_built;      // true if m_builtKey is the key of m_graphicList
+
+    void clearList()
+    {
+        for( unsigned ii = 0; ii < m_graphicList.size(); ii++ )
+            delete m_graphicList[ii];
+
+        m_graphicList.clear();
+    }
 
 public:
     WS_DRAW_ITEM_LIST()
@@ -347,12 +379,12 @@ public:
         m_titleBlock = NULL;
         m_paperFormat = NULL;
         m_sheetFullName = NULL;
+        m_built = false;
     }
 
     ~WS_DRAW_ITEM_LIST()
     {
-        for( unsigned ii = 0; ii < m_graphicList.size(); ii++ )
-            delete m_graphicList[ii];
+        clearList();
     }
 
     /**
@@ -479,6 +511,10 @@ public:
      *   SetFileName( aFileName );
      *   SetSheetName( aFullSheetName );
      *
+     * The items of a list built before are kept when these parameters, the page, the
+     * title block and the page layout did not change; otherwise they are built again.
+     * The page layout editor, which edits the layout items in place, always builds them.
+     *
      * @param aPageInfo The PAGE_INFO, for page size, margins...
      * @param aTitleBlock The sheet title block, for basic inscriptions.
      * @param aColor The color for drawing.
@@ -541,6 +577,10 @@ class WORKSHEET_LAYOUT
     double m_rightMargin;   // the right page margin in mm
     double m_topMargin;     // the top page margin in mm
     double m_bottomMargin;  // the bottom page margin in mm
+    unsigned long m_revision;   // changed by each change of the list or the margins,
+                                // unique among all the instances
+
+    void touch();
 
 public:
     WORKSHEET_LAYOUT();
@@ -580,6 +620,12 @@ public:
      */
     void AllowVoidList( bool Allow ) { m_allowVoidList = Allow; }
 
+    /**
+     * @return the revision of the list, which changes when items are added or removed
+     * and when the margins are set, but not when the items themselves are modified.
+     */
+    unsigned long GetRevision() const { return m_revision; }
+
     /**
      * @return true if an empty list is allowed
      * (mainly allowed for page layout editor).
@@ -609,6 +655,7 @@ public:
     void Append( WORKSHEET_DATAITEM* aItem )
     {
         m_list.push_back( aItem );
+        touch();
     }
 
     /**
@@ -34,6 +34,8 @@
 #include <config_params.h>
 #include <class_undoredo_container.h>
 #include <zones.h>
+#include <thread_pool.h>
+#include <board_journal.h>
 
 
 /*  Forward declarations of classes. */
@@ -42,6 +44,7 @@ class BOARD;
 class TEXTE_PCB;
 class MODULE;
 class TRACK;
+class TRACK_EDIT_BATCH;
 class SEGZONE;
 class VIA;
 class D_PAD;
@@ -60,6 +63,7 @@ class BOARD_ITEM;
 class PCB_LAYER_BOX_SELECTOR;
 class NETLIST;
 class REPORTER;
+class MEMORY_STATS;
 struct PARSE_ERROR;
 struct IO_ERROR;
 class FP_LIB_TABLE;
@@ -95,6 +99,11 @@ protected:
 
     wxString          m_lastNetListRead;        ///< Last net list read with relative path.
 
+    TASK_GROUP        m_autoSaveTasks;          ///< the auto save written on the thread pool
+
+    BOARD_JOURNAL     m_journal;                ///< the changes saved since the board file
+    bool              m_incrementalSave;        ///< save to the journal of the board file
+
     // The Tool Framework initalization
     void setupTools();
 
@@ -164,12 +173,27 @@ protected:
     /**
      * Function doAutoSave
      * performs auto save when the board has been modified and not saved within the
-     * auto save interval.
+     * auto save interval.  A snapshot of the board is written on the thread pool, see
+     * BOARD::Snapshot().
      *
-     * @return true if the auto save was successful.
+     * @return true if the auto save was started.
      */
     virtual bool doAutoSave();
 
+    /**
+     * Function writeAutoSaveFile
+     * is the task of doAutoSave() run on the thread pool: writes the board snapshot
+     * \a aBoard to \a aFileName, deletes it, and reports to onAutoSaveDone().
+     */
+    void writeAutoSaveFile( BOARD* aBoard, const wxString& aFileName );
+
+    /**
+     * Function onAutoSaveDone
+     * is called on the GUI thread once the auto save file is written.
+     * @param aError is the error message, empty if the file was written.
+     */
+    void onAutoSaveDone( const wxString& aError );
+
     /**
      * Function isautoSaveRequired
      * returns true if the board has been modified.
@@ -258,6 +282,8 @@ public:
     void OnUpdateLayerPair( wxUpdateUIEvent& aEvent );
     void OnUpdateLayerSelectBox( wxUpdateUIEvent& aEvent );
     void OnUpdateDrcEnable( wxUpdateUIEvent& aEvent );
+    void OnUpdateOnlineDrc( wxUpdateUIEvent& aEvent );
+    void OnUpdateIncrementalSave( wxUpdateUIEvent& aEvent );
     void OnUpdateShowBoardRatsnest( wxUpdateUIEvent& aEvent );
     void OnUpdateShowModuleRatsnest( wxUpdateUIEvent& aEvent );
     void OnUpdateAutoDeleteTrack( wxUpdateUIEvent& aEvent );
@@ -819,6 +845,14 @@ public:
 
     void InstallDrillFrame( wxCommandEvent& event );
     void GenD356File( wxCommandEvent& event );
+
+    /**
+     * Function DoGenD356File
+     * creates the IPC-D-356 netlist test file @a aFullFileName of the board, with the
+     * test points of the pads and of the vias.
+     * @return true if the file was written
+     */
+    bool DoGenD356File( const wxString& aFullFileName );
     void ToPostProcess( wxCommandEvent& event );
 
     void OnFileHistory( wxCommandEvent& event );
@@ -863,6 +897,21 @@ public:
      */
     bool OpenProjectFiles( const std::vector<wxString>& aFileSet, int aCtl = 0 );
 
+    /**
+     * Function RunBatchJob
+     * runs the command line job of "pcbnew --batch", without GUI:
+     * <p>
+     * pcbnew --batch job_file [board_file]
+     * <p>
+     * loads the board once, fills its outdated zones, then runs the exporters enabled
+     * by the job file concurrently: the gerber and PDF plots, the drill and drill map
+     * files, the footprint position files and the IPC-D-356 netlist.  See batch_job.cpp
+     * for the job file format.  The time of each exporter is written to the standard
+     * output.
+     * @return 0 on success, 1 if the job failed.
+     */
+    int RunBatchJob( const std::vector<wxString>& aArgs );      // virtual from KIWAY_PLAYER
+
     /**
      * Function AppendBoardFile
      * appends a board file onto the current one, creating God knows what.
@@ -884,6 +933,20 @@ public:
      */
     bool SavePcbFile( const wxString& aFileName, bool aCreateBackupFile = CREATE_BACKUP_FILE );
 
+    /**
+     * Function SavePcbJournal
+     * appends the changes of the board since the last save to the journal of its board
+     * file, see BOARD_JOURNAL, and updates the modified and saved flags.
+     *
+     * @return false if the changes cannot be journaled and the board must be saved with
+     *         SavePcbFile(): the board file was not loaded or saved in this session, the
+     *         board settings changed, or the journal cannot be written.
+     */
+    bool SavePcbJournal();
+
+    ///> Returns the journal of the board file, see BOARD_JOURNAL
+    BOARD_JOURNAL& GetJournal() { return m_journal; }
+
     /**
      * Function SavePcbCopy
      * writes the board data structures to \a a aFileName
@@ -991,6 +1054,43 @@ public:
                           bool aUsePlainPCB, const wxString & a3D_Subdir,
                           double aXRef, double aYRef );
 
+    /**
+     * Function OnExportSTEP
+     * will export the current BOARD and its components to a STEP file.
+     */
+    void OnExportSTEP( wxCommandEvent& event );
+
+    /**
+     * Function ExportSTEP_File
+     * Creates a STEP AP214 file of the current BOARD: the board body and the copper
+     * layers as faceted solids, and the 3D models of the footprints as the triangles of
+     * their render data.  Each model is written once, and placed at each of its
+     * footprints by a transformation.
+     *
+     * @param aFullFileName = the full filename of the file to create
+     * @param aExportComponents = true to export the 3D models of the footprints
+     * @return true if Ok.
+     */
+    bool ExportSTEP_File( const wxString& aFullFileName, bool aExportComponents );
+
+    /**
+     * Function OnExportImage
+     * will export the visible layers of the current BOARD to a PNG image.
+     */
+    void OnExportImage( wxCommandEvent& event );
+
+    /**
+     * Function ExportBoardImage
+     * Creates a PNG image of the board bounding box, with the layers visible in the
+     * OpenGL canvas.  The image is rendered by the canvas to its offscreen main target,
+     * in tiles of the canvas size, each tile being read back while the next one is drawn.
+     *
+     * @param aFullFileName = the full filename of the file to create
+     * @param aDpi = the resolution of the image, in dots per inch
+     * @return true if Ok, false also when the OpenGL canvas is not active.
+     */
+    bool ExportBoardImage( const wxString& aFullFileName, int aDpi );
+
     /**
      * Function ExportToIDF3
      * will export the current BOARD to a IDFv3 board and lib files.
@@ -1053,6 +1153,19 @@ public:
      */
     void ListNetsAndSelect( wxCommandEvent& event );
 
+    /**
+     * Function CollectMemoryStats
+     * adds to aStats an estimate of the memory used by the board, its undo history, its
+     * ratsnest, and by the registered sources: the GAL, 3D model caches and the router.
+     */
+    void CollectMemoryStats( MEMORY_STATS& aStats );
+
+    /**
+     * Function ShowMemoryStats
+     * displays the CollectMemoryStats() report, which can be saved to a file.
+     */
+    void ShowMemoryStats( wxCommandEvent& event );
+
     void Swap_Layers( wxCommandEvent& event );
 
     // Handling texts on the board
@@ -1328,11 +1441,15 @@ public:
      *                           (can be NULL)
      * @param aUseNetclassValue = true to use NetClass value, false to use
      *                            current designSettings value
+     * @param aBatch = the batch of edits aTrackItem belongs to (can be NULL): the DRC
+     *                 then uses its indexes, and the board is not marked as modified,
+     *                 which the caller does once for the batch
      * @return  true if done, false if no not change (because DRC error)
      */
     bool SetTrackSegmentWidth( TRACK*             aTrackItem,
                                PICKED_ITEMS_LIST* aItemsListPicker,
-                               bool               aUseNetclassValue );
+                               bool               aUseNetclassValue,
+                               TRACK_EDIT_BATCH*  aBatch = NULL );
 
 
     // zone handling
@@ -1394,9 +1511,14 @@ public:
      * The old fillings are removed
      * @param aActiveWindow = the current active window, if a progress bar is shown
      *                      = NULL to do not display a progress bar
-     * @param aVerbose = true to show error messages
+     * @param aVerbose = true to fill all the zones even if some of them cannot be filled,
+     *                 false to stop after the first one
+     * @param aStaleOnly = true to refill only the zones whose fill inputs have changed since
+     *                   they were filled (see ZONE_CONTAINER::IsFillUpToDate()), e.g. before
+     *                   a plot or a DRC.  The board is then not modified if no zone is stale.
+     * @return error level (0 = no error): the count of zones which could not be filled
      */
-    int Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose = true );
+    int Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose = true, bool aStaleOnly = false );
 
 
     /**
@@ -1601,7 +1723,15 @@ public:
     void AutoPlaceModule( MODULE* Module, int place_mode, wxDC* DC );
 
     // Autorouting:
-    int Solve( wxDC* DC, int two_sides );
+
+    /**
+     * Function Solve
+     * routes the connections of the work list of the autorouter.
+     * @param aLayersCount is the count of routing layers, 1 or 2
+     * @param aParallel is true to search the paths of the connections apart from each
+     * other on several threads, their tracks being created in the order of the list.
+     */
+    int Solve( wxDC* DC, int aLayersCount, bool aParallel = false );
     void Reset_Noroutable( wxDC* DC );
     void Autoroute( wxDC* DC, int mode );
     void ReadAutoroutedTracks( wxDC* DC );
@@ -31,6 +31,9 @@
 
 #include <stack>
 
+#include <boost/bind.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include <wx/regex.h>
 #include <wx/stdpaths.h>
 #include <wx/string.h>
@@ -40,6 +43,8 @@
 #include <menus_helpers.h>
 #include <wildcards_and_files_ext.h>
 
+#include <pgm_base.h>
+
 #include "class_treeproject_item.h"
 #include "class_treeprojectfiles.h"
 #include "pgm_kicad.h"
@@ -56,8 +61,14 @@
  *   > First level subdirs trees are built (i.e subdirs contents are not read)
  *   > When expanding a subdir, each subdir contains is read,
  *     and the corresponding sub tree is populated on the fly.
+ * The directories are read on a thread of the process, and their files are added
+ * to the tree by batches, see TREE_PROJECT_FRAME::startScan().  Then the tree is
+ * kept up to date by the wxFileSystemWatcher events.
  */
 
+/// The number of files added to the tree at once by a scan
+#define SCAN_BATCH_SIZE     256
+
 // list of files extensions listed in the tree project window
 // *.sch files are always allowed, do not add here
 // Add extensions in a compatible regex format to see others files types
@@ -102,6 +113,161 @@ const wxChar  TextFileExtension[] = wxT( "txt" );
 const wxChar  TextFileWildcard[] = wxT( "Text files (*.txt)|*.txt" );
 
 
+/**
+ * Class TREE_FILE_FILTER
+ * tells which files and directories of the project are shown in the tree, and their
+ * types.  It only reads the file system, so the files of a scan are filtered on its
+ * thread, and its regular expressions are compiled once for all the files.
+ */
+class TREE_FILE_FILTER
+{
+public:
+    TREE_FILE_FILTER( const std::vector<wxString>& aFilters, const wxString& aRootName );
+
+    /**
+     * Function Classify
+     * @param aName is the full path of a file or directory.
+     * @param aType [out] is the type of the file if it is shown.
+     * @return true if the file or directory is shown in the tree.
+     */
+    bool Classify( const wxString& aName, TreeFileType* aType );
+
+private:
+    bool isTopLevelSchematic( const wxString& aName ) const;
+
+    boost::ptr_vector<wxRegEx>  m_filters;      ///< the first one is the schematic filter
+    boost::ptr_vector<wxRegEx>  m_extensions;   ///< the extension of m_types
+    std::vector<TreeFileType>   m_types;
+    wxString                    m_rootName;     ///< the project file, without its extension
+};
+
+
+TREE_FILE_FILTER::TREE_FILE_FILTER( const std::vector<wxString>& aFilters,
+                                    const wxString& aRootName ) :
+    m_rootName( aRootName )
+{
+    for( unsigned i = 0; i < aFilters.size(); i++ )
+    {
+        // kept when invalid, the first filter is known by its index
+        m_filters.push_back( new wxRegEx );
+
+        wxCHECK2_MSG( m_filters.back().Compile( aFilters[i], wxRE_ICASE ), continue,
+                      wxT( "Regular expression " ) + aFilters[i] +
+                      wxT( " failed to compile." ) );
+    }
+
+    for( int i = TREE_PROJECT; i < TREE_MAX; i++ )
+    {
+        wxString ext = TREE_PROJECT_FRAME::GetFileExt( (TreeFileType) i );
+
+        if( ext == wxT( "" ) )
+            continue;
+
+        m_extensions.push_back( new wxRegEx( wxString::FromAscii( "^.*\\" ) + ext +
+                                             wxString::FromAscii( "$" ), wxRE_ICASE ) );
+        m_types.push_back( (TreeFileType) i );
+    }
+}
+
+
+bool TREE_FILE_FILTER::Classify( const wxString& aName, TreeFileType* aType )
+{
+    // Skip not visible files and dirs
+    wxFileName      fn( aName );
+
+    // Files/dirs names starting by "." are not visible files under unices.
+    // Skip them also under Windows
+    if( fn.GetName().StartsWith( wxT( "." ) ) )
+        return false;
+
+    if( wxDirExists( aName ) )
+    {
+        *aType = TREE_DIRECTORY;
+        return true;
+    }
+
+    // Filter
+    bool    isSchematic = false;
+    bool    addFile     = false;
+
+    for( unsigned i = 0; i < m_filters.size(); i++ )
+    {
+        if( m_filters[i].IsValid() && m_filters[i].Matches( aName ) )
+        {
+            addFile = true;
+
+            if( i==0 )
+                isSchematic = true;
+
+            break;
+        }
+    }
+
+    if( !addFile )
+        return false;
+
+    if( isSchematic && !isTopLevelSchematic( aName ) )
+        return false;
+
+    *aType = TREE_UNKNOWN;
+
+    for( unsigned i = 0; i < m_extensions.size(); i++ )
+    {
+        if( m_extensions[i].IsValid() && m_extensions[i].Matches( aName ) )
+        {
+            *aType = m_types[i];
+            break;
+        }
+    }
+
+    return true;
+}
+
+
+bool TREE_FILE_FILTER::isTopLevelSchematic( const wxString& aName ) const
+{
+    // only show the schematic if it is a top level schematic.  Eeschema
+    // cannot open a schematic and display it properly unless it starts
+    // at the top of the hierarchy.  The schematic is top level only if
+    // there is a line in the header saying:
+    // "Sheet 1 "
+    // However if the file has the same name as the project, it is always
+    // shown, because it is expected the root sheet.
+    // (and to fix an issue (under XP but could exist under other OS),
+    // when a .sch file is created, the file
+    // create is sent to the wxFileSystemWatcher, but the file still has 0 byte
+    // so it cannot detected as root sheet
+    // This is an ugly fix.
+    if( aName.BeforeLast( '.' ) == m_rootName )
+        return true;
+
+    char        line[128]; // small because we just need a few bytes from the start of a line
+    FILE*       fp = wxFopen( aName, wxT( "rt" ) );
+
+    if( fp == NULL )
+        return false;
+
+    bool topLevel = false;
+
+    // check the first 100 lines for the "Sheet 1" string
+    for( int i = 0; i<100; ++i )
+    {
+        if( !fgets( line, sizeof(line), fp ) )
+            break;
+
+        if( !strncmp( line, "Sheet 1 ", 8 ) )
+        {
+            topLevel = true;
+            break;
+        }
+    }
+
+    fclose( fp );
+
+    return topLevel;
+}
+
+
 /**
  * @brief class TREE_PROJECT_FRAME is the frame that shows the tree list
  * of files and subdirs inside the working directory
@@ -126,7 +292,9 @@ TREE_PROJECT_FRAME::TREE_PROJECT_FRAME( KICAD_MANAGER_FRAME* parent ) :
                         ID_LEFT_FRAME,
                         wxDefaultPosition,
                         wxDefaultSize,
-                        wxNO_BORDER | wxSW_3D | wxTAB_TRAVERSAL )
+                        wxNO_BORDER | wxSW_3D | wxTAB_TRAVERSAL ),
+    m_scanTasks( Pgm().GetThreadPool() ),
+    m_scanGeneration( 0 )
 {
     m_Parent = parent;
     m_TreeProject = NULL;
@@ -154,6 +322,15 @@ TREE_PROJECT_FRAME::TREE_PROJECT_FRAME( KICAD_MANAGER_FRAME* parent ) :
 
 TREE_PROJECT_FRAME::~TREE_PROJECT_FRAME()
 {
+    {
+        boost::mutex::scoped_lock lock( m_scanLock );
+
+        ++m_scanGeneration;
+    }
+
+    // The batches already posted by the scans are dropped with the window
+    m_scanTasks.Wait();
+
     delete m_watcher;
 }
 
@@ -400,117 +577,11 @@ bool TREE_PROJECT_FRAME::AddItemToTreeProject( const wxString& aName,
     // Check the file type
     TreeFileType    type = TREE_UNKNOWN;
 
-    // Skip not visible files and dirs
-    wxFileName      fn( aName );
+    TREE_FILE_FILTER filter( m_filters, rootFileName() );
 
-    // Files/dirs names starting by "." are not visible files under unices.
-    // Skip them also under Windows
-    if( fn.GetName().StartsWith( wxT( "." ) ) )
+    if( !filter.Classify( aName, &type ) )
         return false;
 
-    if( wxDirExists( aName ) )
-    {
-        type = TREE_DIRECTORY;
-    }
-    else
-    {
-        // Filter
-        wxRegEx reg;
-
-        bool    isSchematic = false;
-        bool    addFile     = false;
-
-        for( unsigned i = 0; i < m_filters.size(); i++ )
-        {
-            wxCHECK2_MSG( reg.Compile( m_filters[i], wxRE_ICASE ), continue,
-                          wxT( "Regular expression " ) + m_filters[i] +
-                          wxT( " failed to compile." ) );
-
-            if( reg.Matches( aName ) )
-            {
-                addFile = true;
-
-                if( i==0 )
-                    isSchematic = true;
-
-                break;
-            }
-        }
-
-        if( !addFile )
-            return false;
-
-        // only show the schematic if it is a top level schematic.  Eeschema
-        // cannot open a schematic and display it properly unless it starts
-        // at the top of the hierarchy.  The schematic is top level only if
-        // there is a line in the header saying:
-        // "Sheet 1 "
-        // However if the file has the same name as the project, it is always
-        // shown, because it is expected the root sheet.
-        // (and to fix an issue (under XP but could exist under other OS),
-        // when a .sch file is created, the file
-        // create is sent to the wxFileSystemWatcher, but the file still has 0 byte
-        // so it cannot detected as root sheet
-        // This is an ugly fix.
-        if( isSchematic )
-        {
-            wxString    fullFileName = aName.BeforeLast( '.' );
-            wxString    rootName;
-            TREEPROJECT_ITEM* itemData = GetItemIdData( m_root );
-            if( itemData )
-                rootName = itemData->GetFileName().BeforeLast( '.' );
-
-            if( fullFileName != rootName )
-            {
-                char        line[128]; // small because we just need a few bytes from the start of a line
-                FILE*       fp;
-
-                fullFileName = aName;
-                fp = wxFopen( fullFileName, wxT( "rt" ) );
-
-                if( fp == NULL )
-                    return false;
-
-                addFile = false;
-
-                // check the first 100 lines for the "Sheet 1" string
-                for( int i = 0; i<100; ++i )
-                {
-                    if( !fgets( line, sizeof(line), fp ) )
-                        break;
-
-                    if( !strncmp( line, "Sheet 1 ", 8 ) )
-                    {
-                        addFile = true;
-                        break;
-                    }
-                }
-
-                fclose( fp );
-
-                if( !addFile )
-                    return false; // it is a non-top-level schematic
-            }
-        }
-
-        for( int i = TREE_PROJECT; i < TREE_MAX; i++ )
-        {
-            wxString ext = GetFileExt( (TreeFileType) i );
-
-            if( ext == wxT( "" ) )
-                continue;
-
-            reg.Compile( wxString::FromAscii( "^.*\\" ) + ext +
-                         wxString::FromAscii( "$" ), wxRE_ICASE );
-
-            if( reg.Matches( aName ) )
-            {
-                type = (TreeFileType) i;
-                break;
-            }
-        }
-    }
-
     // also check to see if it is already there.
     wxTreeItemIdValue   cookie;
     wxTreeItemId        kid = m_TreeProject->GetFirstChild( aRoot, cookie );
@@ -530,22 +601,7 @@ bool TREE_PROJECT_FRAME::AddItemToTreeProject( const wxString& aName,
         kid = m_TreeProject->GetNextChild( aRoot, cookie );
     }
 
-    // Append the item (only appending the filename not the full path):
-    wxString            file = wxFileNameFromPath( aName );
-    cellule = m_TreeProject->AppendItem( aRoot, file );
-    TREEPROJECT_ITEM*   data = new TREEPROJECT_ITEM( type, aName, m_TreeProject );
-
-    m_TreeProject->SetItemData( cellule, data );
-    data->SetState( 0 );
-
-    // Mark root files (files which have the same aName as the project)
-    wxFileName  project( m_Parent->GetProjectFileName() );
-    wxFileName  currfile( file );
-
-    if( currfile.GetName().CmpNoCase( project.GetName() ) == 0 )
-        data->SetRootFile( true );
-    else
-        data->SetRootFile( false );
+    cellule = addTreeItem( aName, type, aRoot );
 
     // This section adds dirs and files found in the subdirs
     // in this case AddFile is recursive, but for the first level only.
@@ -557,7 +613,7 @@ bool TREE_PROJECT_FRAME::AddItemToTreeProject( const wxString& aName,
         {
             wxString        dir_filename;
 
-            data->SetPopulated( true );
+            GetItemIdData( cellule )->SetPopulated( true );
 
             if( dir.GetFirst( &dir_filename ) )
             {
@@ -577,12 +633,195 @@ bool TREE_PROJECT_FRAME::AddItemToTreeProject( const wxString& aName,
 }
 
 
+wxTreeItemId TREE_PROJECT_FRAME::addTreeItem( const wxString& aName, TreeFileType aType,
+                                              wxTreeItemId& aRoot )
+{
+    // Append the item (only appending the filename not the full path):
+    wxString            file = wxFileNameFromPath( aName );
+    wxTreeItemId        cellule = m_TreeProject->AppendItem( aRoot, file );
+    TREEPROJECT_ITEM*   data = new TREEPROJECT_ITEM( aType, aName, m_TreeProject );
+
+    m_TreeProject->SetItemData( cellule, data );
+    data->SetState( 0 );
+
+    // Mark root files (files which have the same aName as the project)
+    wxFileName  project( m_Parent->GetProjectFileName() );
+    wxFileName  currfile( file );
+
+    if( currfile.GetName().CmpNoCase( project.GetName() ) == 0 )
+        data->SetRootFile( true );
+    else
+        data->SetRootFile( false );
+
+    return cellule;
+}
+
+
+wxString TREE_PROJECT_FRAME::rootFileName()
+{
+    TREEPROJECT_ITEM* itemData = GetItemIdData( m_root );
+
+    if( !itemData )
+        return wxEmptyString;
+
+    return itemData->GetFileName().BeforeLast( '.' );
+}
+
+
+void TREE_PROJECT_FRAME::startScan( const std::vector<wxString>& aDirs, const wxString& aSkip )
+{
+    for( unsigned i = 0; i < aDirs.size(); i++ )
+        m_scannedDirs.insert( aDirs[i] );
+
+    // The job gets copies of the arguments and of the filters
+    m_scanTasks.Run( boost::bind( &TREE_PROJECT_FRAME::scanDirectories, this, aDirs, aSkip,
+                                  m_filters, rootFileName(), m_scanGeneration ) );
+}
+
+
+bool TREE_PROJECT_FRAME::isScanCancelled( int aGeneration )
+{
+    boost::mutex::scoped_lock lock( m_scanLock );
+
+    return aGeneration != m_scanGeneration;
+}
+
+
+void TREE_PROJECT_FRAME::scanDirectories( const std::vector<wxString>& aDirs,
+                                          const wxString& aSkip,
+                                          const std::vector<wxString>& aFilters,
+                                          const wxString& aRootName, int aGeneration )
+{
+    TREE_FILE_FILTER filter( aFilters, aRootName );
+
+    for( unsigned i = 0; i < aDirs.size() && !isScanCancelled( aGeneration ); i++ )
+    {
+        boost::shared_ptr<TREE_SCANNED_ITEMS> items;
+        wxDir       dir( aDirs[i] );
+        wxString    filename;
+
+        // protected dirs will not open, see "man opendir()"
+        bool cont = dir.IsOpened() && dir.GetFirst( &filename );
+
+        if( dir.IsOpened() )
+            items.reset( new TREE_SCANNED_ITEMS );
+
+        while( cont )
+        {
+            TREE_SCANNED_ITEM item;
+
+            item.m_name = aDirs[i] + wxFileName::GetPathSeparator() + filename;
+
+            if( filename != aSkip && filter.Classify( item.m_name, &item.m_type ) )
+                items->push_back( item );
+
+            cont = dir.GetNext( &filename );
+
+            if( cont && items->size() == SCAN_BATCH_SIZE )
+            {
+                if( isScanCancelled( aGeneration ) )
+                    return;
+
+                CallAfter( boost::bind( &TREE_PROJECT_FRAME::addScannedItems, this,
+                                        aGeneration, aDirs[i], items, false ) );
+                items.reset( new TREE_SCANNED_ITEMS );
+            }
+        }
+
+        CallAfter( boost::bind( &TREE_PROJECT_FRAME::addScannedItems, this, aGeneration,
+                                aDirs[i], items, true ) );
+    }
+}
+
+
+void TREE_PROJECT_FRAME::addScannedItems( int aGeneration, const wxString& aDir,
+                                          boost::shared_ptr<TREE_SCANNED_ITEMS> aItems,
+                                          bool aDone )
+{
+    // the scan of a previous project
+    if( aGeneration != m_scanGeneration )
+        return;
+
+    if( aDone )
+        m_scannedDirs.erase( aDir );
+
+    // the directory could have been deleted while it was read
+    wxTreeItemId root_id = findSubdirTreeItem( aDir );
+
+    if( !root_id.IsOk() || !aItems )
+        return;
+
+    // The files already there were added by the file system events.  The children are
+    // listed once for the batch, not for each file.
+    std::set<wxString>  known;
+    wxTreeItemIdValue   cookie;
+
+    for( wxTreeItemId kid = m_TreeProject->GetFirstChild( root_id, cookie ); kid.IsOk();
+         kid = m_TreeProject->GetNextChild( root_id, cookie ) )
+    {
+        TREEPROJECT_ITEM* itemData = GetItemIdData( kid );
+
+        if( itemData )
+            known.insert( itemData->GetFileName() );
+    }
+
+    for( unsigned i = 0; i < aItems->size(); i++ )
+    {
+        const TREE_SCANNED_ITEM& item = (*aItems)[i];
+
+        if( known.insert( item.m_name ).second )
+            addTreeItem( item.m_name, item.m_type, root_id );
+    }
+
+    // Sort filenames by alphabetic order
+    m_TreeProject->SortChildren( root_id );
+
+    if( root_id == m_root && !m_TreeProject->IsExpanded( m_root ) )
+        m_TreeProject->Expand( m_root );
+
+    if( !aDone )
+        return;
+
+    if( root_id != m_root )
+    {
+        GetItemIdData( root_id )->SetPopulated( true );
+
+    #ifndef __WINDOWS__
+        // Watch the new directory, under Windows the whole tree is already watched.
+        // Until the first FileWatcherReset() call, the watcher adds it itself.
+        if( m_watcher && wxFileName::IsDirReadable( aDir ) )
+        {
+            wxFileName fn;
+
+            fn.AssignDir( aDir );
+            fn.DontFollowLink();
+            m_watcher->Add( fn );
+        }
+    #endif
+    }
+
+    // The subdirs of the expanded directories are read in turn, so that they can be
+    // expanded.  The first level subdirs are always read.
+    if( root_id == m_root || m_TreeProject->IsExpanded( root_id ) )
+        populateSubdirs( root_id );
+}
+
+
 void TREE_PROJECT_FRAME::ReCreateTreePrj()
 {
     wxTreeItemId    rootcellule;
     bool            prjOpened = false;
     wxString        pro_dir = m_Parent->GetProjectFileName();
 
+    // The scans of the previous tree are dropped
+    {
+        boost::mutex::scoped_lock lock( m_scanLock );
+
+        ++m_scanGeneration;
+    }
+
+    m_scannedDirs.clear();
+
     if( !m_TreeProject )
         m_TreeProject = new TREEPROJECTFILES( this );
     else
@@ -618,25 +857,9 @@ void TREE_PROJECT_FRAME::ReCreateTreePrj()
     // Now adding all current files if available
     if( prjOpened )
     {
+        // Read in the background, with the first level subdirs
         pro_dir = wxPathOnly( m_Parent->GetProjectFileName() );
-        wxDir dir( pro_dir );
-
-        if( dir.IsOpened() )    // protected dirs will not open, see "man opendir()"
-        {
-            wxString    filename;
-            bool        cont = dir.GetFirst( &filename );
-
-            while( cont )
-            {
-                if( filename != fn.GetFullName() )
-                {
-                    wxString name = dir.GetName() + wxFileName::GetPathSeparator() + filename;
-                    AddItemToTreeProject( name, m_root );
-                }
-
-                cont = dir.GetNext( &filename );
-            }
-        }
+        startScan( std::vector<wxString>( 1, pro_dir ), fn.GetFullName() );
     }
     else
     {
@@ -792,52 +1015,33 @@ void TREE_PROJECT_FRAME::OnExpand( wxTreeEvent& Event )
     if( tree_data->GetType() != TREE_DIRECTORY )
         return;
 
-    // explore list of non populated subdirs, and populate them
-    wxTreeItemIdValue   cookie;
-    wxTreeItemId        kid = m_TreeProject->GetFirstChild( itemId, cookie );
+    populateSubdirs( itemId );
+}
+
 
-    bool subdir_populated = false;
+void TREE_PROJECT_FRAME::populateSubdirs( const wxTreeItemId& aItem )
+{
+    // explore list of non populated subdirs, and populate them
+    wxTreeItemIdValue       cookie;
+    wxTreeItemId            kid = m_TreeProject->GetFirstChild( aItem, cookie );
+    std::vector<wxString>   subdirs;
 
-    for( ; kid.IsOk(); kid = m_TreeProject->GetNextChild( itemId, cookie ) )
+    for( ; kid.IsOk(); kid = m_TreeProject->GetNextChild( aItem, cookie ) )
     {
         TREEPROJECT_ITEM* itemData = GetItemIdData( kid );
 
         if( !itemData || itemData->GetType() != TREE_DIRECTORY )
             continue;
 
-        if( itemData->IsPopulated() )
+        if( itemData->IsPopulated() || m_scannedDirs.count( itemData->GetFileName() ) )
             continue;
 
-        wxString    fileName = itemData->GetFileName();
-        wxDir       dir( fileName );
-
-        if( dir.IsOpened() )
-        {
-            wxString    dir_filename;
-
-            if( dir.GetFirst( &dir_filename ) )
-            {
-                do    // Add name to tree item, but do not recurse in subdirs:
-                {
-                    wxString name = fileName + wxFileName::GetPathSeparator() + dir_filename;
-                    AddItemToTreeProject( name, kid, false );
-                } while( dir.GetNext( &dir_filename ) );
-            }
-
-            itemData->SetPopulated( true );       // set state to populated
-            subdir_populated = true;
-        }
-
-        // Sort filenames by alphabetic order
-        m_TreeProject->SortChildren( kid );
+        subdirs.push_back( itemData->GetFileName() );
     }
 
-    if( subdir_populated )
-    {
-    #ifndef __WINDOWS__
-        FileWatcherReset();
-    #endif
-    }
+    // The subdirs are watched once read, see addScannedItems()
+    if( !subdirs.empty() )
+        startScan( subdirs );
 }
 
 
@@ -30,16 +30,35 @@
 #ifndef TREEPRJ_FRAME_H
 #define TREEPRJ_FRAME_H
 
+#include <set>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
 #include <wx/fswatcher.h>
 #include <wx/laywin.h>
 #include <wx/treebase.h>
 
+#include <thread_pool.h>
+
 #include "kicad.h"
 
 
 class KICAD_MANAGER_FRAME;
 class TREEPROJECT_ITEM;
 class TREEPROJECTFILES;
+class TREE_FILE_FILTER;
+
+
+/// A file or a directory to show in the tree project, found by a scan of its directory
+struct TREE_SCANNED_ITEM
+{
+    wxString        m_name;         ///< full path
+    TreeFileType    m_type;
+};
+
+typedef std::vector<TREE_SCANNED_ITEM>  TREE_SCANNED_ITEMS;
 
 /** class TREE_PROJECT_FRAME
  * Window to display the tree files
@@ -47,6 +66,7 @@ class TREEPROJECTFILES;
 class TREE_PROJECT_FRAME : public wxSashLayoutWindow
 {
     friend class TREEPROJECT_ITEM;
+    friend class TREE_FILE_FILTER;
 public:
     KICAD_MANAGER_FRAME*    m_Parent;
     TREEPROJECTFILES*       m_TreeProject;
@@ -56,6 +76,12 @@ private:
     std::vector<wxString>   m_filters;
     wxFileSystemWatcher*    m_watcher; // file system watcher (since wxWidgets 2.9.2)
 
+    // The directories are read on the threads of the process, see startScan()
+    TASK_GROUP              m_scanTasks;
+    boost::mutex            m_scanLock;
+    int                     m_scanGeneration;   ///< incremented to cancel the scans
+    std::set<wxString>      m_scannedDirs;      ///< directories being read
+
 public:
     TREE_PROJECT_FRAME( KICAD_MANAGER_FRAME* parent );
     ~TREE_PROJECT_FRAME();
@@ -165,6 +191,51 @@ private:
                                                           wxTreeItemId& aRoot,
                                                           bool aRecurse = true );
 
+    /**
+     * Function addTreeItem
+     * appends the file or directory @a aName of type @a aType to the children of
+     * @a aRoot, without checking if it is already there.
+     * @return the new tree item.
+     */
+    wxTreeItemId addTreeItem( const wxString& aName, TreeFileType aType, wxTreeItemId& aRoot );
+
+    ///> Returns the file name of the project file of the tree, without extension
+    wxString rootFileName();
+
+    /**
+     * Function startScan
+     * reads the directories @a aDirs on a thread of the process.  Their files are added
+     * to the tree by addScannedItems(), in batches, so that the big directories are shown
+     * while they are read.
+     * @param aSkip is a file name not to add, the project file of the root directory.
+     */
+    void startScan( const std::vector<wxString>& aDirs, const wxString& aSkip = wxEmptyString );
+
+    /**
+     * Function populateSubdirs
+     * reads the subdirectories of @a aItem which were not read yet, so that they can
+     * be expanded in turn.
+     */
+    void populateSubdirs( const wxTreeItemId& aItem );
+
+    // The scan job, running on a thread of the process.  It does not touch the tree,
+    // which belongs to the GUI thread, and its filters are a copy of m_filters.
+    void scanDirectories( const std::vector<wxString>& aDirs, const wxString& aSkip,
+                          const std::vector<wxString>& aFilters, const wxString& aRootName,
+                          int aGeneration );
+
+    bool isScanCancelled( int aGeneration );
+
+    /**
+     * Function addScannedItems
+     * adds to the tree the files of the directory @a aDir found by a scan.  Called on
+     * the GUI thread by the scan job.
+     * @param aItems are the files, or NULL if the directory could not be read.
+     * @param aDone is true for the last batch of files of the directory.
+     */
+    void addScannedItems( int aGeneration, const wxString& aDir,
+                          boost::shared_ptr<TREE_SCANNED_ITEMS> aItems, bool aDone );
+
     /**
      * Function findSubdirTreeItem
      * searches for the item in tree project which is the
@@ -51,6 +51,12 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
+#include <time.h>
+#include <map>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
 
 #include <sch_dir_lib_source.h>
 using namespace SCH;
@@ -99,6 +105,115 @@ public:
 };
 
 
+/**
+ * Class DIR_WATCH
+ * tells when some directories have changed: an entry was created, removed or renamed.
+ * On Linux the changes are notified by inotify, elsewhere the modification times of
+ * the directories are compared, at most once a second so a series of lookups does
+ * not stat them each time.
+ */
+class SCH::DIR_WATCH
+{
+    std::map< STRING, time_t >  stamps;     ///< modification time of each directory
+    time_t                      lastCheck;
+
+#if defined(__linux__)
+    int                         fd;
+#endif
+
+    static time_t modTime( const STRING& aDir )
+    {
+        struct stat fs;
+
+        return stat( aDir.c_str(), &fs ) ? 0 : fs.st_mtime;
+    }
+
+public:
+    DIR_WATCH() :
+        lastCheck( 0 )
+    {
+#if defined(__linux__)
+        fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+#endif
+    }
+
+    ~DIR_WATCH()
+    {
+#if defined(__linux__)
+        if( fd != -1 )
+            close( fd );
+#endif
+    }
+
+    /**
+     * Function Add
+     * adds a directory to watch, after it was listed.
+     */
+    void Add( const STRING& aDir )
+    {
+#if defined(__linux__)
+        // a directory which cannot be watched falls back to its modification time
+        if( fd != -1 && inotify_add_watch( fd, aDir.c_str(), IN_CREATE | IN_DELETE |
+                        IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF ) != -1 )
+            return;
+#endif
+        stamps[aDir] = modTime( aDir );
+    }
+
+    /**
+     * Function Changed
+     * returns true if a watched directory has changed since the last call, or since
+     * it was added.  The watch is then empty: the directories listed again are added
+     * back.
+     */
+    bool Changed()
+    {
+        bool changed = false;
+
+#if defined(__linux__)
+        if( fd != -1 )
+        {
+            char    events[4096];
+
+            // the events are not looked at, any change reloads all the directories
+            while( read( fd, events, sizeof( events ) ) > 0 )
+                changed = true;
+        }
+#endif
+
+        time_t now = time( NULL );
+
+        if( !changed && !stamps.empty() && now != lastCheck )
+        {
+            lastCheck = now;
+
+            for( std::map< STRING, time_t >::const_iterator it = stamps.begin();
+                    it != stamps.end() && !changed;  ++it )
+            {
+                changed = modTime( it->first ) != it->second;
+            }
+        }
+
+        if( changed )
+            Clear();
+
+        return changed;
+    }
+
+    void Clear()
+    {
+#if defined(__linux__)
+        // the watches are removed with the inotify instance, a new one is cheap
+        if( fd != -1 )
+            close( fd );
+
+        fd = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+#endif
+        stamps.clear();
+    }
+};
+
+
 /**
  * Function strrstr
  * finds the last instance of needle in haystack, if any.
@@ -355,19 +470,30 @@ void DIR_LIB_SOURCE::cache() throw( IO_ERROR )
     partnames.clear();
     categories.clear();
 
+    watch->Clear();
+
     cacheOneDir( "" );
 }
 
 
+void DIR_LIB_SOURCE::refresh() throw( IO_ERROR )
+{
+    if( watch->Changed() )
+        cache();
+}
+
+
 DIR_LIB_SOURCE::DIR_LIB_SOURCE( const STRING& aDirectoryPath,
                                 const STRING& aOptions ) throw( IO_ERROR ) :
-    useVersioning( strstr( aOptions.c_str(), "useVersioning" ) )
+    useVersioning( strstr( aOptions.c_str(), "useVersioning" ) ),
+    watch( new DIR_WATCH )
 {
     sourceURI     = aDirectoryPath;
     sourceType    = "dir";
 
     if( sourceURI.size() == 0 )
     {
+        delete watch;
         THROW_IO_ERROR( STRING("aDirectoryPath cannot be empty")  );
     }
 
@@ -375,18 +501,29 @@ DIR_LIB_SOURCE::DIR_LIB_SOURCE( const STRING& aDirectoryPath,
     if( strchr( "/\\", sourceURI[sourceURI.size()-1] ) )
         sourceURI.erase( sourceURI.size()-1 );
 
-    cache();
+    try
+    {
+        cache();
+    }
+    catch( const IO_ERROR& )
+    {
+        delete watch;
+        throw;
+    }
 }
 
 
 DIR_LIB_SOURCE::~DIR_LIB_SOURCE()
 {
+    delete watch;
 }
 
 
 void DIR_LIB_SOURCE::GetCategoricalPartNames( STRINGS* aResults, const STRING& aCategory )
     throw( IO_ERROR )
 {
+    refresh();
+
     PN_ITER end = aCategory.size() ?
                         partnames.lower_bound( aCategory + char( '/' + 1 ) ) :
                         partnames.end();
@@ -430,6 +567,8 @@ void DIR_LIB_SOURCE::GetCategoricalPartNames( STRINGS* aResults, const STRING& a
 void DIR_LIB_SOURCE::GetRevisions( STRINGS* aResults, const STRING& aPartName )
     throw( IO_ERROR )
 {
+    refresh();
+
     aResults->clear();
 
     if( useVersioning )
@@ -468,6 +607,8 @@ void DIR_LIB_SOURCE::GetRevisions( STRINGS* aResults, const STRING& aPartName )
 void DIR_LIB_SOURCE::ReadPart( STRING* aResult, const STRING& aPartName, const STRING& aRev )
     throw( IO_ERROR )
 {
+    refresh();
+
     STRING      partName = aPartName;
     const char* hasRev   = endsWithRev( partName );
 
@@ -565,6 +706,8 @@ void DIR_LIB_SOURCE::ReadParts( STRINGS* aResults, const STRINGS& aPartNames )
 
 void DIR_LIB_SOURCE::GetCategories( STRINGS* aResults ) throw( IO_ERROR )
 {
+    refresh();
+
     aResults->clear();
 
     // caller fetches them sorted.
@@ -610,6 +753,9 @@ void DIR_LIB_SOURCE::cacheOneDir( const STRING& aCategory ) throw( IO_ERROR )
         THROW_IO_ERROR( msg );
     }
 
+    // watched before being listed, so that a change while listing is not missed
+    watch->Add( curDir );
+
     struct stat     fs;
     STRING          partName;
     STRING          fileName;
@@ -620,9 +766,25 @@ void DIR_LIB_SOURCE::cacheOneDir( const STRING& aCategory ) throw( IO_ERROR )
         if( !strcmp( ".", entry->d_name ) || !strcmp( "..", entry->d_name ) )
             continue;
 
-        fileName = curDir + "/" + entry->d_name;
+        bool known = false;
+
+#if defined(_DIRENT_HAVE_D_TYPE)
+        // the type of the entries is read with the directory, a stat() of each
+        // entry is slow on a network file system
+        if( entry->d_type == DT_REG || entry->d_type == DT_DIR )
+        {
+            fs.st_mode = entry->d_type == DT_REG ? S_IFREG : S_IFDIR;
+            known = true;
+        }
+#endif
+
+        if( !known )
+        {
+            fileName = curDir + "/" + entry->d_name;
+            known = !stat( fileName.c_str(), &fs );
+        }
 
-        if( !stat( fileName.c_str(), &fs ) )
+        if( known )
         {
             // is this a valid part name?
             if( S_ISREG( fs.st_mode ) && makePartName( &partName, entry->d_name, aCategory ) )
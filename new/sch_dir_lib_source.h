@@ -68,6 +68,8 @@ typedef std::set< STRING >          NAME_CACHE;
 
 namespace SCH {
 
+class DIR_WATCH;
+
 /**
  * Class DIR_LIB_SOURCE
  * implements a LIB_SOURCE in a file system directory.
@@ -91,12 +93,24 @@ class DIR_LIB_SOURCE : public LIB_SOURCE
 
     std::vector<char>   readBuffer;     ///< used by readString()
 
+    /// tells when the cached directories have changed, see refresh()
+    DIR_WATCH*          watch;
+
     /**
      * Function cache
      * [re-]loads the directory cache(s).
      */
     void cache() throw( IO_ERROR );
 
+    /**
+     * Function refresh
+     * reloads the directory caches if a part file or a category was added, removed
+     * or renamed since they were loaded.  The directories are not listed again
+     * otherwise: on Linux the changes are notified by the system, elsewhere the
+     * modification times of the directories are checked, at most once a second.
+     */
+    void refresh() throw( IO_ERROR );
+
     /**
      * Function isCategoryName
      * returns true iff aName is a valid category name.
@@ -0,0 +1,409 @@
+/**
+ * @file pcb_calculator/batch_job.cpp
+ * @brief The command line job of the PCB calculator: sweeps of transmission lines.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <profile.h>
+
+#include <pcb_calculator.h>
+#include <transline_sweep.h>
+#include <units_scales.h>
+
+
+// The exit status of the job
+#define BATCH_OK            0
+#define BATCH_FAILED        1
+
+
+// The names of the lines and of the parameters on the command line
+static const struct
+{
+    TRANSLINE_TYPE_ID   m_Type;
+    const char*         m_Name;
+} lineNames[] =
+{
+    { MICROSTRIP_TYPE,      "microstrip" },
+    { CPW_TYPE,             "cpw" },
+    { GROUNDED_CPW_TYPE,    "grounded_cpw" },
+    { RECTWAVEGUIDE_TYPE,   "rectwaveguide" },
+    { COAX_TYPE,            "coax" },
+    { C_MICROSTRIP_TYPE,    "c_microstrip" },
+    { STRIPLINE_TYPE,       "stripline" },
+    { TWISTEDPAIR_TYPE,     "twistedpair" }
+};
+
+
+static const struct
+{
+    PRMS_ID     m_Id;
+    const char* m_Name;
+} prmNames[] =
+{
+    { EPSILONR_PRM,                 "er" },
+    { TAND_PRM,                     "tand" },
+    { RHO_PRM,                      "rho" },
+    { H_PRM,                        "h" },
+    { TWISTEDPAIR_TWIST_PRM,        "twists" },
+    { H_T_PRM,                      "ht" },
+    { STRIPLINE_A_PRM,              "a" },
+    { T_PRM,                        "t" },
+    { ROUGH_PRM,                    "rough" },
+    { MUR_PRM,                      "mur" },
+    { TWISTEDPAIR_EPSILONR_ENV_PRM, "erenv" },
+    { MURC_PRM,                     "murc" },
+    { TANM_PRM,                     "tanm" },
+    { FREQUENCY_PRM,                "f" },
+    { Z0_PRM,                       "z0" },
+    { Z0_E_PRM,                     "zeven" },
+    { Z0_O_PRM,                     "zodd" },
+    { ANG_L_PRM,                    "ang_l" },
+    { PHYS_WIDTH_PRM,               "w" },
+    { PHYS_DIAM_IN_PRM,             "din" },
+    { PHYS_S_PRM,                   "s" },
+    { PHYS_DIAM_OUT_PRM,            "dout" },
+    { PHYS_LEN_PRM,                 "l" }
+};
+
+
+static void batchUsage()
+{
+    fprintf( stderr, "usage: pcb_calculator --batch --line <type> [--set <prm>=<value>]... "
+                     "[--sweep <prm>=<start>:<stop>:<count>]... [--synthesize <prm>] "
+                     "--output <file.csv>\n" );
+    fprintf( stderr, "lengths in mm, frequency in GHz, impedances in Ohm, angles in radian\n" );
+}
+
+
+static const char* prmName( PRMS_ID aId )
+{
+    for( unsigned ii = 0; ii < DIM( prmNames ); ii++ )
+    {
+        if( prmNames[ii].m_Id == aId )
+            return prmNames[ii].m_Name;
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Function findPrm
+ * returns the parameter of the line @a aIdent named @a aName on the command line,
+ * or NULL if the line has no such parameter.
+ */
+static TRANSLINE_PRM* findPrm( TRANSLINE_IDENT& aIdent, const wxString& aName )
+{
+    for( unsigned ii = 0; ii < aIdent.GetPrmsCount(); ii++ )
+    {
+        TRANSLINE_PRM*  prm = aIdent.GetPrm( ii );
+        const char*     name = prmName( prm->m_Id );
+
+        if( name && aName == FROM_UTF8( name ) )
+            return prm;
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Function prmScale
+ * returns the scaling factor from the command line units of a parameter to its
+ * normalized units: the first units of the dialog selectors.
+ */
+static double prmScale( const TRANSLINE_PRM* aPrm )
+{
+    if( !aPrm->m_ConvUnit )
+        return 1.0;
+
+    switch( aPrm->m_Id )
+    {
+    case FREQUENCY_PRM: return UNIT_GHZ;
+    case Z0_PRM:
+    case Z0_E_PRM:
+    case Z0_O_PRM:      return UNIT_OHM;
+    case ANG_L_PRM:     return UNIT_RADIAN;
+    default:            return UNIT_MM;
+    }
+}
+
+
+static const char* prmUnit( const TRANSLINE_PRM* aPrm )
+{
+    if( !aPrm->m_ConvUnit )
+        return NULL;
+
+    switch( aPrm->m_Id )
+    {
+    case FREQUENCY_PRM: return "GHz";
+    case Z0_PRM:
+    case Z0_E_PRM:
+    case Z0_O_PRM:      return "Ohm";
+    case ANG_L_PRM:     return "rad";
+    default:            return "mm";
+    }
+}
+
+
+static wxString csvString( const wxString& aText )
+{
+    wxString text = aText;
+
+    text.Replace( wxT( "\"" ), wxT( "\"\"" ) );
+
+    return wxT( "\"" ) + text.Strip( wxString::both ) + wxT( "\"" );
+}
+
+
+/**
+ * Function writeSweepCsv
+ * writes a line per point of @a aSweep to the CSV file @a aFileName: the parameters
+ * of the line, in the command line units, then its results.
+ * @return true if the file was written.
+ */
+static bool writeSweepCsv( const wxString& aFileName, TRANSLINE_IDENT& aIdent,
+                           const TRANSLINE_SWEEP& aSweep )
+{
+    std::vector<TRANSLINE_PRM*> prms;
+
+    for( unsigned ii = 0; ii < aIdent.GetPrmsCount(); ii++ )
+    {
+        if( prmName( aIdent.GetPrm( ii )->m_Id ) )
+            prms.push_back( aIdent.GetPrm( ii ) );
+    }
+
+    unsigned resultCount = std::min( (unsigned) aIdent.m_Messages.GetCount(),
+                                     (unsigned) TRANSLINE_RESULT_COUNT );
+
+    wxFFile file( aFileName, wxT( "wt" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    // A point, not a comma, as decimal separator
+    LOCALE_IO toggle;
+    wxString  line;
+
+    for( unsigned ii = 0; ii < prms.size(); ii++ )
+    {
+        const char* unit = prmUnit( prms[ii] );
+
+        line << ( ii ? wxT( "," ) : wxT( "" ) ) << FROM_UTF8( prmName( prms[ii]->m_Id ) );
+
+        if( unit )
+            line << wxT( " (" ) << FROM_UTF8( unit ) << wxT( ")" );
+    }
+
+    // The units of the results are the ones of the first point
+    for( unsigned ii = 0; ii < resultCount; ii++ )
+    {
+        wxString label = aIdent.m_Messages[ii];
+
+        if( aSweep.GetPointCount() && !std::isnan( aSweep.GetPoint( 0 ).m_Results[ii] )
+            && !aSweep.GetPoint( 0 ).m_ResultTexts[ii].empty() )
+        {
+            label << wxT( " (" ) << FROM_UTF8( aSweep.GetPoint( 0 ).m_ResultTexts[ii].c_str() )
+                  << wxT( ")" );
+        }
+
+        line << wxT( "," ) << csvString( label );
+    }
+
+    if( !file.Write( line + wxT( "\n" ) ) )
+        return false;
+
+    for( unsigned pt = 0; pt < aSweep.GetPointCount(); pt++ )
+    {
+        const TRANSLINE_VALUES& values = aSweep.GetPoint( pt );
+
+        line.Empty();
+
+        for( unsigned ii = 0; ii < prms.size(); ii++ )
+        {
+            line << ( ii ? wxT( "," ) : wxT( "" ) )
+                 << wxString::Format( wxT( "%.6g" ),
+                                      values.m_Prms[prms[ii]->m_Id] / prmScale( prms[ii] ) );
+        }
+
+        for( unsigned ii = 0; ii < resultCount; ii++ )
+        {
+            if( !std::isnan( values.m_Results[ii] ) )
+                line << wxString::Format( wxT( ",%.6g" ), values.m_Results[ii] );
+            else
+                line << wxT( "," ) << csvString( FROM_UTF8( values.m_ResultTexts[ii].c_str() ) );
+        }
+
+        if( !file.Write( line + wxT( "\n" ) ) )
+            return false;
+    }
+
+    return true;
+}
+
+
+int PCB_CALCULATOR_FRAME::RunBatchJob( const std::vector<wxString>& aArgs )
+{
+    int                     type = END_OF_LIST_TYPE;
+    wxString                output;
+    wxString                synthesize;
+    std::vector<wxString>   fixed;
+    std::vector<wxString>   swept;
+    bool                    usageError = false;
+
+    for( unsigned i = 0; i < aArgs.size(); i++ )
+    {
+        bool hasValue = i + 1 < aArgs.size();
+
+        if( aArgs[i] == wxT( "--line" ) && hasValue )
+        {
+            wxString name = aArgs[++i];
+
+            for( unsigned ii = 0; ii < DIM( lineNames ); ii++ )
+            {
+                if( name == FROM_UTF8( lineNames[ii].m_Name ) )
+                    type = lineNames[ii].m_Type;
+            }
+        }
+        else if( aArgs[i] == wxT( "--set" ) && hasValue )
+            fixed.push_back( aArgs[++i] );
+        else if( aArgs[i] == wxT( "--sweep" ) && hasValue )
+            swept.push_back( aArgs[++i] );
+        else if( aArgs[i] == wxT( "--synthesize" ) && hasValue )
+            synthesize = aArgs[++i];
+        else if( aArgs[i] == wxT( "--output" ) && hasValue )
+            output = aArgs[++i];
+        else
+            usageError = true;
+    }
+
+    if( usageError || type == END_OF_LIST_TYPE || output.IsEmpty() )
+    {
+        batchUsage();
+        return BATCH_FAILED;
+    }
+
+    // The default values of the dialog, not the saved ones, so that a job gives the
+    // same results on every machine
+    TRANSLINE_IDENT ident( (TRANSLINE_TYPE_ID) type );
+    TRANSLINE_SWEEP sweep( (TRANSLINE_TYPE_ID) type );
+
+    for( unsigned ii = 0; ii < ident.GetPrmsCount(); ii++ )
+    {
+        TRANSLINE_PRM* prm = ident.GetPrm( ii );
+
+        if( prmName( prm->m_Id ) )
+            sweep.SetValue( prm->m_Id, prm->m_Value * prmScale( prm ) );
+    }
+
+    for( unsigned ii = 0; ii < fixed.size(); ii++ )
+    {
+        TRANSLINE_PRM*  prm = findPrm( ident, fixed[ii].BeforeFirst( '=' ) );
+        double          value;
+
+        if( !prm || !fixed[ii].AfterFirst( '=' ).ToCDouble( &value ) )
+        {
+            fprintf( stderr, "invalid parameter '%s'\n", TO_UTF8( fixed[ii] ) );
+            return BATCH_FAILED;
+        }
+
+        sweep.SetValue( prm->m_Id, value * prmScale( prm ) );
+    }
+
+    for( unsigned ii = 0; ii < swept.size(); ii++ )
+    {
+        TRANSLINE_PRM*  prm = findPrm( ident, swept[ii].BeforeFirst( '=' ) );
+        wxString        range = swept[ii].AfterFirst( '=' );
+        double          start, stop;
+        long            count;
+
+        if( !prm || !range.BeforeFirst( ':' ).ToCDouble( &start )
+            || !range.AfterFirst( ':' ).BeforeFirst( ':' ).ToCDouble( &stop )
+            || !range.AfterFirst( ':' ).AfterFirst( ':' ).ToLong( &count ) || count < 1 )
+        {
+            fprintf( stderr, "invalid sweep '%s'\n", TO_UTF8( swept[ii] ) );
+            return BATCH_FAILED;
+        }
+
+        TRANSLINE_SWEEP::AXIS axis;
+
+        axis.m_Id    = prm->m_Id;
+        axis.m_Start = start * prmScale( prm );
+        axis.m_Stop  = stop * prmScale( prm );
+        axis.m_Count = (int) count;
+        sweep.AddAxis( axis );
+    }
+
+    if( !synthesize.IsEmpty() )
+    {
+        TRANSLINE_PRM* prm = findPrm( ident, synthesize );
+
+        if( !prm || prm->m_Type != PRM_TYPE_PHYS )
+        {
+            fprintf( stderr, "invalid parameter to synthesize '%s'\n", TO_UTF8( synthesize ) );
+            return BATCH_FAILED;
+        }
+
+        sweep.SetSynthesize( prm->m_Id );
+    }
+
+    prof_counter counter;
+
+    prof_start( &counter );
+    bool ok = sweep.Run();
+    prof_end( &counter );
+
+    printf( "%-12s %10.1f ms, %u points\n", "sweep", counter.msecs(), sweep.GetPointCount() );
+    fflush( stdout );
+
+    if( !ok )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( _( "The computation of the line failed" ) ) );
+        return BATCH_FAILED;
+    }
+
+    wxFileName fn( output );
+
+    fn.MakeAbsolute();
+
+    if( !writeSweepCsv( fn.GetFullPath(), ident, sweep ) )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( wxString::Format( _( "Failed to create file '%s'" ),
+                                                           GetChars( fn.GetFullPath() ) ) ) );
+        return BATCH_FAILED;
+    }
+
+    return BATCH_OK;
+}
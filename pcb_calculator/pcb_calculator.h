@@ -75,6 +75,21 @@ public:
     PCB_CALCULATOR_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~PCB_CALCULATOR_FRAME();
 
+    /**
+     * Function RunBatchJob
+     * computes a transmission line over a grid of parameter values, see TRANSLINE_SWEEP,
+     * and writes the parameters and the results of each point to a CSV file:
+     * <p>
+     * pcb_calculator --batch --line microstrip --set er=4.2 --sweep w=0.1:0.5:9
+     * [--synthesize w] --output microstrip.csv
+     * <p>
+     * The lengths are in mm, the frequency in GHz, the impedances in Ohm and the angles
+     * in radian.  The parameters not given have the default values of the dialog.
+     * See batch_job.cpp for the names of the lines and of the parameters.
+     * @return 0 on success, 1 if the job failed.
+     */
+    int RunBatchJob( const std::vector<wxString>& aArgs );      // virtual from KIWAY_PLAYER
+
 private:
 
     // Event handlers
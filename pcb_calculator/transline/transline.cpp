@@ -57,11 +57,25 @@ double GetPropertyInDialog( enum PRMS_ID aPrmId );
 bool   IsSelectedInDialog( enum PRMS_ID aPrmId );
 
 
+TRANSLINE_VALUES::TRANSLINE_VALUES()
+{
+    // As the dialog, which returns 1.0 for a parameter the line does not have
+    for( int ii = 0; ii <= DUMMY_PRM; ii++ )
+        m_Prms[ii] = 1.0;
+
+    m_Selected = UNKNOWN_ID;
+
+    for( int ii = 0; ii < TRANSLINE_RESULT_COUNT; ii++ )
+        m_Results[ii] = std::numeric_limits<double>::quiet_NaN();
+}
+
+
 /* Constructor creates a transmission line instance. */
 TRANSLINE::TRANSLINE()
 {
     murC = 1.0;
     m_name = (const char*) 0;
+    m_values = NULL;
 
     // Initialize these variables mainly to avoid warnings from a static analyzer
     f = 0.0;            // Frequency of operation
@@ -83,7 +97,10 @@ TRANSLINE::~TRANSLINE()
  */
 void TRANSLINE::setProperty( enum PRMS_ID aPrmId, double value )
 {
-    SetPropertyInDialog( aPrmId, value );
+    if( m_values )
+        m_values->m_Prms[aPrmId] = value;
+    else
+        SetPropertyInDialog( aPrmId, value );
 }
 
 /*
@@ -92,6 +109,9 @@ void TRANSLINE::setProperty( enum PRMS_ID aPrmId, double value )
  */
 bool TRANSLINE::isSelected( enum PRMS_ID aPrmId )
 {
+    if( m_values )
+        return aPrmId == m_values->m_Selected;
+
     return IsSelectedInDialog( aPrmId );
 }
 
@@ -100,17 +120,35 @@ bool TRANSLINE::isSelected( enum PRMS_ID aPrmId )
 */
 void TRANSLINE::setResult( int line, const char* text )
 {
-    SetResultInDialog( line, text );
+    if( m_values )
+    {
+        if( line >= 0 && line < TRANSLINE_RESULT_COUNT )
+            m_values->m_ResultTexts[line] = text;
+    }
+    else
+        SetResultInDialog( line, text );
 }
 void TRANSLINE::setResult( int line, double value, const char* text )
 {
-    SetResultInDialog( line, value, text );
+    if( m_values )
+    {
+        if( line >= 0 && line < TRANSLINE_RESULT_COUNT )
+        {
+            m_values->m_Results[line] = value;
+            m_values->m_ResultTexts[line] = text;
+        }
+    }
+    else
+        SetResultInDialog( line, value, text );
 }
 
 
 /* Returns a property value. */
 double TRANSLINE::getProperty( enum PRMS_ID aPrmId )
 {
+    if( m_values )
+        return m_values->m_Prms[aPrmId];
+
     return GetPropertyInDialog( aPrmId );
 }
 
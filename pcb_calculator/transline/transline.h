@@ -24,6 +24,8 @@
 #ifndef __TRANSLINE_H
 #define __TRANSLINE_H
 
+#include <string>
+
 // IDs for lines parameters used in calculation:
 // (Used to retrieve these parameters from UI.
 // DUMMY_PRM is used to skip a param line in dialogs. It is not really a parameter
@@ -56,11 +58,39 @@ enum PRMS_ID
     DUMMY_PRM
 };
 
+// The number of result lines of a transmission line, see TRANSLINE::setResult()
+#define TRANSLINE_RESULT_COUNT 7
+
+/**
+ * Struct TRANSLINE_VALUES
+ * holds the parameters and the results of a transmission line computed without
+ * the dialog, see TRANSLINE::SetValues().
+ * The parameters are in normalized units (meter, Hz, Ohm, radian).
+ */
+struct TRANSLINE_VALUES
+{
+    double      m_Prms[DUMMY_PRM + 1];                  // indexed by PRMS_ID
+    PRMS_ID     m_Selected;                             // the parameter to synthesize
+    double      m_Results[TRANSLINE_RESULT_COUNT];      // NaN for a text only result
+    std::string m_ResultTexts[TRANSLINE_RESULT_COUNT];  // unit or text of the results
+
+    TRANSLINE_VALUES();
+};
+
 class TRANSLINE
 {
 public: TRANSLINE();
     virtual ~TRANSLINE();
 
+    /**
+     * Function SetValues
+     * sets the values the line reads its parameters from and writes its results to,
+     * instead of the pcb_calculator dialog.  Lines with their own values can be
+     * analyzed and synthesized on any thread, see TRANSLINE_SWEEP.
+     * @param aValues is the values to use, or NULL to use the dialog
+     */
+    void SetValues( TRANSLINE_VALUES* aValues ) { m_values = aValues; }
+
     const char *m_name;
     void   setProperty( enum PRMS_ID aPrmId, double aValue);
     double getProperty( enum PRMS_ID aPrmId );
@@ -72,6 +102,7 @@ public: TRANSLINE();
     virtual void analyze() { };
 
 protected:
+    TRANSLINE_VALUES* m_values;     // the values used instead of the dialog, or NULL
     double f;           /* Frequency of operation */
     double er;          /* dielectric constant */
     double tand;        /* Dielectric Loss Tangent */
@@ -156,10 +156,11 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
                                _( "Frequency" ), _( "Height of Substrate" ), 1.0, true ) );
 
 
+    m_TLine = NewTransline( m_Type );
+
     switch( m_Type )
     {
     case MICROSTRIP_TYPE:      // microstrip
-        m_TLine    = new MICROSTRIP();
         m_Icon = new wxBitmap( microstrip_xpm );
 
         m_Messages.Add( _( "ErEff" ) );
@@ -195,7 +196,6 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
         break;
 
     case CPW_TYPE:          // coplanar waveguide
-        m_TLine    = new COPLANAR();
         m_Icon = new wxBitmap( cpw_xpm );
         m_HasPrmSelection = true;
 
@@ -227,7 +227,6 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
         break;
 
     case GROUNDED_CPW_TYPE:      // grounded coplanar waveguide
-        m_TLine    = new GROUNDEDCOPLANAR();
         m_Icon = new wxBitmap( cpw_back_xpm );
         m_HasPrmSelection = true;
 
@@ -260,7 +259,6 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
 
 
     case RECTWAVEGUIDE_TYPE:      // rectangular waveguide
-        m_TLine    = new RECTWAVEGUIDE();
         m_Icon = new wxBitmap( rectwaveguide_xpm );
         m_HasPrmSelection = true;
 
@@ -294,7 +292,6 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
         break;
 
     case COAX_TYPE:      // coaxial cable
-        m_TLine    = new COAX();
         m_Icon = new wxBitmap( coax_xpm );
         m_HasPrmSelection = true;
 
@@ -325,7 +322,6 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
         break;
 
     case C_MICROSTRIP_TYPE:      // coupled microstrip
-        m_TLine    = new C_MICROSTRIP();
         m_Icon = new wxBitmap( c_microstrip_xpm );
         m_HasPrmSelection = true;
 
@@ -365,7 +361,6 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
         break;
 
     case STRIPLINE_TYPE:      // stripline
-        m_TLine    = new STRIPLINE();
         m_Icon = new wxBitmap( stripline_xpm );
 
         m_Messages.Add( _( "ErEff" ) );
@@ -397,7 +392,6 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
         break;
 
     case TWISTEDPAIR_TYPE:      // twisted pair
-        m_TLine    = new TWISTEDPAIR();
         m_Icon = new wxBitmap( twistedpair_xpm );
         m_HasPrmSelection = true;
 
@@ -433,6 +427,26 @@ TRANSLINE_IDENT::TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType )
     }
 }
 
+TRANSLINE* TRANSLINE_IDENT::NewTransline( enum TRANSLINE_TYPE_ID aType )
+{
+    switch( aType )
+    {
+    case MICROSTRIP_TYPE:       return new MICROSTRIP();
+    case CPW_TYPE:              return new COPLANAR();
+    case GROUNDED_CPW_TYPE:     return new GROUNDEDCOPLANAR();
+    case RECTWAVEGUIDE_TYPE:    return new RECTWAVEGUIDE();
+    case COAX_TYPE:             return new COAX();
+    case C_MICROSTRIP_TYPE:     return new C_MICROSTRIP();
+    case STRIPLINE_TYPE:        return new STRIPLINE();
+    case TWISTEDPAIR_TYPE:      return new TWISTEDPAIR();
+    case END_OF_LIST_TYPE:      // Not really used
+        break;
+    }
+
+    return NULL;
+}
+
+
 TRANSLINE_IDENT::~TRANSLINE_IDENT()
 {
     delete m_TLine;
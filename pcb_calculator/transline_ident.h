@@ -103,6 +103,13 @@ public:
     TRANSLINE_IDENT( enum TRANSLINE_TYPE_ID aType );
     ~TRANSLINE_IDENT();
 
+    /**
+     * Function NewTransline
+     * creates the TRANSLINE computing a type of line, without its dialog data.
+     * @return the new line, owned by the caller, or NULL if @a aType is not a line
+     */
+    static TRANSLINE* NewTransline( enum TRANSLINE_TYPE_ID aType );
+
     // Add a new param in list
     void AddPrm( TRANSLINE_PRM* aParam )
     {
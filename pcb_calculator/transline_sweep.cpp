@@ -0,0 +1,114 @@
+/**
+ * @file transline_sweep.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <memory>
+
+#include <pgm_base.h>
+#include <thread_pool.h>
+
+#include <transline_sweep.h>
+
+#include <boost/bind.hpp>
+
+
+// The number of points computed by each task: a point takes a few microseconds
+#define SWEEP_POINTS_PER_TASK 256
+
+
+double TRANSLINE_SWEEP::AXIS::Value( int aIdx ) const
+{
+    if( m_Count <= 1 )
+        return m_Start;
+
+    return m_Start + ( m_Stop - m_Start ) * aIdx / ( m_Count - 1 );
+}
+
+
+TRANSLINE_SWEEP::TRANSLINE_SWEEP( enum TRANSLINE_TYPE_ID aType )
+{
+    m_type = aType;
+}
+
+
+bool TRANSLINE_SWEEP::Run()
+{
+    unsigned count = 1;
+
+    for( unsigned ii = 0; ii < m_axes.size(); ii++ )
+        count *= std::max( m_axes[ii].m_Count, 1 );
+
+    m_points.assign( count, m_fixed );
+
+    // The last axis varies first, as the rows of the nested loops over the axes
+    for( unsigned pt = 0; pt < count; pt++ )
+    {
+        unsigned idx = pt;
+
+        for( int ii = (int) m_axes.size() - 1; ii >= 0; ii-- )
+        {
+            const AXIS& axis = m_axes[ii];
+            unsigned    steps = std::max( axis.m_Count, 1 );
+
+            m_points[pt].m_Prms[axis.m_Id] = axis.Value( idx % steps );
+            idx /= steps;
+        }
+    }
+
+    if( m_type < START_OF_LIST_TYPE || m_type >= END_OF_LIST_TYPE )
+        return false;
+
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+    for( unsigned first = 0; first < count; first += SWEEP_POINTS_PER_TASK )
+    {
+        unsigned last = std::min( first + SWEEP_POINTS_PER_TASK, count );
+
+        tasks.Run( boost::bind( &TRANSLINE_SWEEP::computePoints, this, first, last ) );
+    }
+
+    return tasks.Wait();
+}
+
+
+void TRANSLINE_SWEEP::computePoints( unsigned aFirst, unsigned aLast )
+{
+    // The lines keep intermediate results in their members: one line per task
+    std::auto_ptr<TRANSLINE> line( TRANSLINE_IDENT::NewTransline( m_type ) );
+
+    for( unsigned pt = aFirst; pt < aLast; pt++ )
+    {
+        line->SetValues( &m_points[pt] );
+
+        if( IsSynthesize() )
+            line->synthesize();
+        else
+            line->analyze();
+    }
+
+    line->SetValues( NULL );
+}
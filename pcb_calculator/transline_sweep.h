@@ -0,0 +1,110 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file transline_sweep.h
+ */
+
+#ifndef TRANSLINE_SWEEP_H
+#define TRANSLINE_SWEEP_H
+
+#include <vector>
+
+#include <transline.h>
+#include <transline_ident.h>
+
+
+/**
+ * Class TRANSLINE_SWEEP
+ * computes a type of transmission line over a grid of parameter values, for instance
+ * the impedance of a microstrip for a range of widths and dielectric constants.
+ * <p>
+ * Each point of the grid is analyzed or synthesized by the TRANSLINE of its type, with
+ * its own TRANSLINE_VALUES instead of the dialog, so the points are computed in
+ * parallel on the threads of the process.
+ */
+class TRANSLINE_SWEEP
+{
+public:
+    /// A swept parameter, from m_Start to m_Stop in m_Count evenly spaced values
+    struct AXIS
+    {
+        PRMS_ID m_Id;
+        double  m_Start;
+        double  m_Stop;
+        int     m_Count;
+
+        double Value( int aIdx ) const;
+    };
+
+    TRANSLINE_SWEEP( enum TRANSLINE_TYPE_ID aType );
+
+    /**
+     * Function SetValue
+     * sets the value of a parameter for all the points, in normalized units
+     * (meter, Hz, Ohm, radian).
+     */
+    void SetValue( PRMS_ID aId, double aValue ) { m_fixed.m_Prms[aId] = aValue; }
+
+    /**
+     * Function AddAxis
+     * adds a swept parameter to the grid; the points iterate the last axis first.
+     */
+    void AddAxis( const AXIS& aAxis ) { m_axes.push_back( aAxis ); }
+
+    const std::vector<AXIS>& GetAxes() const { return m_axes; }
+
+    /**
+     * Function SetSynthesize
+     * selects the computation of the points: they are analyzed by default, and
+     * synthesized computing the physical parameter @a aSelected otherwise.
+     * @param aSelected is the parameter to synthesize, see TRANSLINE::isSelected(),
+     * or UNKNOWN_ID to analyze the points
+     */
+    void SetSynthesize( PRMS_ID aSelected ) { m_fixed.m_Selected = aSelected; }
+
+    bool IsSynthesize() const { return m_fixed.m_Selected != UNKNOWN_ID; }
+
+    /**
+     * Function Run
+     * computes all the points of the grid, and waits for them.
+     * @return false if the type of line is unknown or a point failed.
+     */
+    bool Run();
+
+    unsigned GetPointCount() const { return m_points.size(); }
+
+    /// the parameters and the results of a point, after Run()
+    const TRANSLINE_VALUES& GetPoint( unsigned aIdx ) const { return m_points[aIdx]; }
+
+private:
+    enum TRANSLINE_TYPE_ID          m_type;
+    TRANSLINE_VALUES                m_fixed;    // the values of the parameters not swept
+    std::vector<AXIS>               m_axes;
+    std::vector<TRANSLINE_VALUES>   m_points;
+
+    // the task computing the points from aFirst to aLast - 1, with its own line
+    void computePoints( unsigned aFirst, unsigned aLast );
+};
+
+#endif      // TRANSLINE_SWEEP_H
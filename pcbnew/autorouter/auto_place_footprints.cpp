@@ -50,6 +50,13 @@
 #include <convert_to_biu.h>
 #include <base_units.h>
 #include <protos.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
+
+#include <map>
+#include <vector>
 
 
 #define GAIN            16
@@ -84,6 +91,145 @@ static wxPoint  CurrPosition; // Current position of the current module placemen
 double          MinCout;
 
 
+/**
+ * Class PLACEMENT_AREA_SUMS
+ * holds the summed area tables of the placement matrix, which give in constant time
+ * what TstRectangle() and CalculateKeepOutArea() find in the cells of a rectangle:
+ * for each side, the sum of the keep out costs, the count of cells outside the board
+ * and the count of cells occupied by a footprint.
+ *
+ * The tables are built from the matrix when a footprint placement starts, and must
+ * be invalidated each time the matrix changes.
+ */
+class PLACEMENT_AREA_SUMS
+{
+public:
+    PLACEMENT_AREA_SUMS() : m_cols( 0 ), m_built( false ) {}
+
+    bool IsBuilt() const { return m_built; }
+
+    /**
+     * Function Build
+     * fills the tables from the cells of the initialized sides of RoutingMatrix.
+     */
+    void Build();
+
+    /**
+     * Function Clear
+     * frees the tables, after a change of RoutingMatrix.
+     */
+    void Clear();
+
+    // The sums of the cells of rows aRowMin..aRowMax and columns aColMin..aColMax
+    unsigned int KeepOutCost( int aSide, int aRowMin, int aRowMax,
+                              int aColMin, int aColMax ) const
+    {
+        return sum( m_dist[aSide], aRowMin, aRowMax, aColMin, aColMax );
+    }
+
+    unsigned int OutOfBoardCount( int aSide, int aRowMin, int aRowMax,
+                                  int aColMin, int aColMax ) const
+    {
+        return sum( m_outOfBoard[aSide], aRowMin, aRowMax, aColMin, aColMax );
+    }
+
+    unsigned int ModuleCount( int aSide, int aRowMin, int aRowMax,
+                              int aColMin, int aColMax ) const
+    {
+        return sum( m_module[aSide], aRowMin, aRowMax, aColMin, aColMax );
+    }
+
+private:
+    // the entry ( row, col ) is the sum of the cells of the rows < row and columns < col,
+    // sums are unsigned as the keep out cost of CalculateKeepOutArea()
+    std::vector<unsigned int> m_dist[MAX_ROUTING_LAYERS_COUNT];
+    std::vector<unsigned int> m_outOfBoard[MAX_ROUTING_LAYERS_COUNT];
+    std::vector<unsigned int> m_module[MAX_ROUTING_LAYERS_COUNT];
+    int                       m_cols;     // the columns of the tables, one more than the matrix
+    bool                      m_built;
+
+    int index( int aRow, int aCol ) const { return aRow * m_cols + aCol; }
+
+    unsigned int sum( const std::vector<unsigned int>& aTable, int aRowMin, int aRowMax,
+                      int aColMin, int aColMax ) const
+    {
+        if( aTable.empty() || aRowMin > aRowMax || aColMin > aColMax )
+            return 0;
+
+        return aTable[index( aRowMax + 1, aColMax + 1 )] - aTable[index( aRowMin, aColMax + 1 )]
+               - aTable[index( aRowMax + 1, aColMin )] + aTable[index( aRowMin, aColMin )];
+    }
+};
+
+
+void PLACEMENT_AREA_SUMS::Build()
+{
+    int rows = RoutingMatrix.m_Nrows;
+
+    m_cols = RoutingMatrix.m_Ncols + 1;
+
+    for( int side = 0; side < MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        m_dist[side].clear();
+        m_outOfBoard[side].clear();
+        m_module[side].clear();
+
+        if( !RoutingMatrix.m_BoardSide[side].IsInitialized() )
+            continue;
+
+        m_dist[side].assign( ( rows + 1 ) * m_cols, 0 );
+        m_outOfBoard[side].assign( ( rows + 1 ) * m_cols, 0 );
+        m_module[side].assign( ( rows + 1 ) * m_cols, 0 );
+
+        for( int row = 0; row < rows; row++ )
+        {
+            // the sums of the cells of the row up to col
+            unsigned int dist = 0;
+            unsigned int outOfBoard = 0;
+            unsigned int module = 0;
+
+            for( int col = 0; col < RoutingMatrix.m_Ncols; col++ )
+            {
+                MATRIX_CELL cell = RoutingMatrix.GetCell( row, col, side );
+
+                dist += RoutingMatrix.GetDist( row, col, side );
+
+                if( ( cell & CELL_is_ZONE ) == 0 )
+                    outOfBoard++;
+
+                if( cell & CELL_is_MODULE )
+                    module++;
+
+                int ii = index( row + 1, col + 1 );
+                int above = index( row, col + 1 );
+
+                m_dist[side][ii] = m_dist[side][above] + dist;
+                m_outOfBoard[side][ii] = m_outOfBoard[side][above] + outOfBoard;
+                m_module[side][ii] = m_module[side][above] + module;
+            }
+        }
+    }
+
+    m_built = true;
+}
+
+
+void PLACEMENT_AREA_SUMS::Clear()
+{
+    for( int side = 0; side < MAX_ROUTING_LAYERS_COUNT; side++ )
+    {
+        std::vector<unsigned int>().swap( m_dist[side] );
+        std::vector<unsigned int>().swap( m_outOfBoard[side] );
+        std::vector<unsigned int>().swap( m_module[side] );
+    }
+
+    m_built = false;
+}
+
+
+static PLACEMENT_AREA_SUMS s_AreaSums;
+
+
 /* generates the Routing matrix, used to fing the best placement
  * of a footprint.
  * Allocate a "bitmap" which is an image of the real board
@@ -100,15 +246,6 @@ int             genPlacementRoutingMatrix(  BOARD* aBrd, EDA_MSG_PANEL* messageP
 static int      getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame,
                                            MODULE* aModule, wxDC* aDC );
 
-/*
- * Function compute_Ratsnest_PlaceModule
- * displays the module's ratsnest during displacement, and assess the "cost"
- * of the position.
- *
- * The cost is the longest ratsnest distance with penalty for connections
- * approaching 45 degrees.
- */
-static double   compute_Ratsnest_PlaceModule( BOARD* aBrd );
 
 /* Place a footprint on the Routing matrix.
  */
@@ -118,7 +255,8 @@ void            genModuleOnRoutingMatrix( MODULE* Module );
  */
 static void     drawPlacementRoutingMatrix( BOARD* aBrd, wxDC* DC );
 
-static int      TstModuleOnBoard( BOARD* Pcb, MODULE* Module, bool TstOtherSide );
+static int      TstModuleOnBoard( BOARD* Pcb, MODULE* Module, const EDA_RECT& aFpBBox,
+                                  bool TstOtherSide );
 
 static void     CreateKeepOutRectangle( int ux0, int uy0, int ux1, int uy1,
                                         int marge, int aKeepOut, LSET aLayerMask );
@@ -391,6 +529,7 @@ end_of_tst:
 
     CurrPosition = memopos;
 
+    s_AreaSums.Clear();
     RoutingMatrix.UnInitRoutingMatrix();
 
     g_Route_Layer_TOP       = lay_tmp_TOP;
@@ -457,6 +596,7 @@ int genPlacementRoutingMatrix( BOARD* aBrd, EDA_MSG_PANEL* messagePanel )
 {
     wxString msg;
 
+    s_AreaSums.Clear();
     RoutingMatrix.UnInitRoutingMatrix();
 
     EDA_RECT bbox = aBrd->ComputeBoundingBox( true );
@@ -536,9 +676,8 @@ int genPlacementRoutingMatrix( BOARD* aBrd, EDA_MSG_PANEL* messagePanel )
         ii = propagate();
 
     // Initialize top layer. to the same value as the bottom layer
-    if( RoutingMatrix.m_BoardSide[TOP] )
-        memcpy( RoutingMatrix.m_BoardSide[TOP], RoutingMatrix.m_BoardSide[BOTTOM],
-                nbCells * sizeof(MATRIX_CELL) );
+    if( RoutingMatrix.m_BoardSide[TOP].IsInitialized() )
+        RoutingMatrix.m_BoardSide[TOP].CopyFrom( RoutingMatrix.m_BoardSide[BOTTOM] );
 
     return 1;
 }
@@ -554,6 +693,9 @@ void genModuleOnRoutingMatrix( MODULE* Module )
 
     EDA_RECT    fpBBox = Module->GetBoundingBox();
 
+    // the sums of the cells are built again at the next placement
+    s_AreaSums.Clear();
+
     fpBBox.Inflate( RoutingMatrix.m_GridRouting / 2 );
     ox  = fpBBox.GetX();
     fx  = fpBBox.GetRight();
@@ -613,11 +755,198 @@ inline void draw_FootprintRect(EDA_RECT * aClipBox, wxDC* aDC, EDA_RECT& fpBBox,
 #endif
 }
 
+/**
+ * Class PLACEMENT_NETS
+ * evaluates the ratsnest cost of the positions of a footprint being placed, as
+ * build_ratsnest_module() and compute_Ratsnest_PlaceModule() did at each position:
+ * for each net of the footprint, the cost of the connection between its nearest pads
+ * in the footprint and in the other footprints.
+ *
+ * Only the nets of the moving footprint change cost, so their pads are collected once
+ * and a position is evaluated from them without changing the board: the positions are
+ * evaluated on several threads.
+ */
+class PLACEMENT_NETS
+{
+public:
+    PLACEMENT_NETS( MODULE* aModule );
+
+    /**
+     * Function Cost
+     * @return the sum of the costs of the connections of the footprint moved by
+     * -aOffset, the length with a penalty for connections approaching 45 degrees,
+     * or -1 if the footprint has no connected pad.
+     */
+    double Cost( const wxPoint& aOffset ) const;
+
+private:
+    struct NET_PADS
+    {
+        std::vector<wxPoint> m_modulePads;      // the pads of the footprint
+        std::vector<wxPoint> m_otherPads;       // the pads of the other footprints
+        std::vector<char>    m_otherOnBoard;    // the footprint of m_otherPads is on the board
+    };
+
+    std::vector<NET_PADS> m_nets;
+    bool                  m_connected;
+};
+
+
+PLACEMENT_NETS::PLACEMENT_NETS( MODULE* aModule ) :
+    m_connected( false )
+{
+    std::map<int, unsigned> netIndex;     // the index in m_nets by net code
+
+    for( D_PAD* pad = aModule->Pads(); pad; pad = pad->Next() )
+    {
+        if( pad->GetNetCode() == NETINFO_LIST::UNCONNECTED )
+            continue;
+
+        m_connected = true;
+
+        std::map<int, unsigned>::iterator it = netIndex.find( pad->GetNetCode() );
+
+        if( it == netIndex.end() )
+        {
+            NETINFO_ITEM* net = pad->GetNet();
+
+            if( net == NULL )       // Should not occur
+                continue;
+
+            it = netIndex.insert( std::make_pair( pad->GetNetCode(),
+                                                  (unsigned) m_nets.size() ) ).first;
+            m_nets.push_back( NET_PADS() );
+
+            NET_PADS& pads = m_nets.back();
+
+            for( unsigned jj = 0; jj < net->m_PadInNetList.size(); jj++ )
+            {
+                D_PAD*  other = net->m_PadInNetList[jj];
+                MODULE* parent = other->GetParent();
+
+                if( parent == aModule )
+                    continue;
+
+                // Modules not inside the board area have no cost
+                pads.m_otherPads.push_back( other->GetPosition() );
+                pads.m_otherOnBoard.push_back(
+                        RoutingMatrix.m_BrdBox.Contains( parent->GetPosition() ) );
+            }
+        }
+
+        m_nets[it->second].m_modulePads.push_back( pad->GetPosition() );
+    }
+}
+
+
+double PLACEMENT_NETS::Cost( const wxPoint& aOffset ) const
+{
+    if( !m_connected )
+        return -1;
+
+    double curr_cost = 0;
+
+    for( unsigned ii = 0; ii < m_nets.size(); ii++ )
+    {
+        const NET_PADS& pads = m_nets[ii];
+        int             length = INT_MAX;
+        wxPoint         start;      // start point of the ratsnest of the net
+        wxPoint         end;        // end point of the ratsnest of the net
+        bool            onBoard = false;
+
+        // The nearest pair of pads
+        for( unsigned jj = 0; jj < pads.m_modulePads.size(); jj++ )
+        {
+            wxPoint pad_pos = pads.m_modulePads[jj] - aOffset;
+
+            for( unsigned kk = 0; kk < pads.m_otherPads.size(); kk++ )
+            {
+                const wxPoint& other = pads.m_otherPads[kk];
+                int distance = abs( other.x - pad_pos.x ) + abs( other.y - pad_pos.y );
+
+                if( distance < length )
+                {
+                    length  = distance;
+                    start   = pad_pos;
+                    end     = other;
+                    onBoard = pads.m_otherOnBoard[kk];
+                }
+            }
+        }
+
+        if( length == INT_MAX || !onBoard )
+            continue;
+
+        // Cost of the ratsnest.
+        int dx = abs( end.x - start.x );
+        int dy = abs( end.y - start.y );
+
+        // ttry to have always dx >= dy to calculate the cost of the rastsnet
+        if( dx < dy )
+            std::swap( dx, dy );
+
+        // Cost of the connection = lenght + penalty due to the slope
+        // dx is the biggest lenght relative to the X or Y axis
+        // the penalty is max for 45 degrees ratsnests,
+        // and 0 for horizontal or vertical ratsnests.
+        // For Horizontal and Vertical ratsnests, dy = 0;
+        double conn_cost = hypot( dx, dy * 2.0 );
+        curr_cost += conn_cost;    // Total cost = sum of costs of each connection
+    }
+
+    return curr_cost;
+}
+
+
+// The columns of positions evaluated by each thread between two screen updates
+#define PLACEMENT_COLUMNS_PER_THREAD 4
+
+
+// The positions of a footprint evaluated by getOptimalModulePlacement(), shared by the
+// evalPlacementColumn() tasks
+struct PLACEMENT_SCAN
+{
+    BOARD*                  m_board;
+    MODULE*                 m_module;
+    const PLACEMENT_NETS*   m_nets;
+    wxPoint                 m_modulePos;
+    wxPoint                 m_fpBBoxOrg;    // footprint rect origin, relative to its position
+    bool                    m_tstOtherSide;
+    int                     m_firstY;
+    int                     m_rowCount;     // positions in a column
+    std::vector<int>        m_keepOut;      // TstModuleOnBoard() of each position of the chunk
+    std::vector<double>     m_score;        // and the score of the placeable ones
+};
+
+
+// Evaluate the positions of the column aColumn of the chunk of columns at aPosX
+static void evalPlacementColumn( PLACEMENT_SCAN* aScan, int aColumn, int aPosX )
+{
+    EDA_RECT fpBBox = aScan->m_module->GetFootprintRect();
+    wxPoint  pos( aPosX, aScan->m_firstY );
+
+    for( int row = 0; row < aScan->m_rowCount; row++, pos.y += RoutingMatrix.m_GridRouting )
+    {
+        int ii = aColumn * aScan->m_rowCount + row;
+
+        fpBBox.SetOrigin( aScan->m_fpBBoxOrg + pos );
+
+        int keepOutCost = TstModuleOnBoard( aScan->m_board, aScan->m_module, fpBBox,
+                                            aScan->m_tstOtherSide );
+
+        aScan->m_keepOut[ii] = keepOutCost;
+
+        if( keepOutCost >= 0 )    // i.e. if the module can be put here
+            aScan->m_score[ii] = aScan->m_nets->Cost( aScan->m_modulePos - pos ) + keepOutCost;
+    }
+}
+
+
 int getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame, MODULE* aModule, wxDC* aDC )
 {
     int     error = 1;
     wxPoint LastPosOK;
-    double  min_cost, curr_cost, Score;
+    double  min_cost;
     bool    TstOtherSide;
     DISPLAY_OPTIONS* displ_opts = (DISPLAY_OPTIONS*)aFrame->GetDisplayOptions();
     BOARD*  brd = aFrame->GetBoard();
@@ -675,6 +1004,36 @@ int getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame, MODULE* aModule, wxDC* aD
         }
     }
 
+    // The pads of the nets, as build_ratsnest_module() needs them
+    if( ( brd->m_Status_Pcb & LISTE_PAD_OK ) == 0 )
+    {
+        brd->m_Status_Pcb = 0;
+        brd->BuildListOfNets();
+    }
+
+    if( !s_AreaSums.IsBuilt() )
+        s_AreaSums.Build();
+
+    PLACEMENT_NETS  nets( aModule );
+    PLACEMENT_SCAN  scan;
+
+    scan.m_board        = brd;
+    scan.m_module       = aModule;
+    scan.m_nets         = &nets;
+    scan.m_modulePos    = mod_pos;
+    scan.m_fpBBoxOrg    = fpBBoxOrg;
+    scan.m_tstOtherSide = TstOtherSide;
+    scan.m_firstY       = initialPos.y;
+    scan.m_rowCount     = 0;
+
+    for( int y = initialPos.y; y < xylimit.y; y += RoutingMatrix.m_GridRouting )
+        scan.m_rowCount++;
+
+    int chunkColumns = PLACEMENT_COLUMNS_PER_THREAD * Pgm().GetThreadPool().GetThreadCount();
+
+    scan.m_keepOut.resize( chunkColumns * scan.m_rowCount );
+    scan.m_score.resize( chunkColumns * scan.m_rowCount );
+
     // Draw the initial bounding box position
     EDA_COLOR_T color = BROWN;
     fpBBox.SetOrigin( fpBBoxOrg + CurrPosition );
@@ -683,7 +1042,7 @@ int getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame, MODULE* aModule, wxDC* aD
     min_cost = -1.0;
     aFrame->SetStatusText( wxT( "Score ??, pos ??" ) );
 
-    for( ; CurrPosition.x < xylimit.x; CurrPosition.x += RoutingMatrix.m_GridRouting )
+    while( CurrPosition.x < xylimit.x )
     {
         wxYield();
 
@@ -698,41 +1057,71 @@ int getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame, MODULE* aModule, wxDC* aD
                 aFrame->GetCanvas()->SetAbortRequest( false );
         }
 
-        CurrPosition.y = initialPos.y;
+        // Evaluate a chunk of columns, one task per column
+        TASK_GROUP  tasks( Pgm().GetThreadPool() );
+        int         columns = 0;
 
-        for( ; CurrPosition.y < xylimit.y; CurrPosition.y += RoutingMatrix.m_GridRouting )
+        for( int x = CurrPosition.x; columns < chunkColumns && x < xylimit.x;
+             x += RoutingMatrix.m_GridRouting, columns++ )
         {
-            // Erase traces.
-            draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+            tasks.Run( boost::bind( evalPlacementColumn, &scan, columns, x ) );
+        }
 
-            fpBBox.SetOrigin( fpBBoxOrg + CurrPosition );
-            g_Offset_Module = mod_pos - CurrPosition;
-            int keepOutCost = TstModuleOnBoard( brd, aModule, TstOtherSide );
+        tasks.Wait();
 
-            // Draw at new place
-            color = keepOutCost >= 0 ? BROWN : RED;
-            draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+        // Select the best position in the scan order: on equal scores the last one wins
+        bool updated = false;
+
+        for( int col = 0; col < columns; col++, CurrPosition.x += RoutingMatrix.m_GridRouting )
+        {
+            CurrPosition.y = initialPos.y;
 
-            if( keepOutCost >= 0 )    // i.e. if the module can be put here
+            for( int row = 0; row < scan.m_rowCount;
+                 row++, CurrPosition.y += RoutingMatrix.m_GridRouting )
             {
+                int ii = col * scan.m_rowCount + row;
+
+                if( scan.m_keepOut[ii] < 0 )
+                    continue;
+
                 error = 0;
-                aFrame->build_ratsnest_module( aModule );
-                curr_cost   = compute_Ratsnest_PlaceModule( brd );
-                Score       = curr_cost + keepOutCost;
+
+                double Score = scan.m_score[ii];
 
                 if( (min_cost >= Score ) || (min_cost < 0 ) )
                 {
                     LastPosOK   = CurrPosition;
                     min_cost    = Score;
-                    wxString msg;
-                    msg.Printf( wxT( "Score %g, pos %s, %s" ),
-                                min_cost,
-                                GetChars( ::CoordinateToString( LastPosOK.x ) ),
-                                GetChars( ::CoordinateToString( LastPosOK.y ) ) );
-                    aFrame->SetStatusText( msg );
+                    updated     = true;
                 }
             }
         }
+
+        if( scan.m_rowCount > 0 )
+        {
+            // Erase traces, and draw the last position of the chunk
+            draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+
+            int     last = columns * scan.m_rowCount - 1;
+            wxPoint lastPos( CurrPosition.x - RoutingMatrix.m_GridRouting,
+                             CurrPosition.y - RoutingMatrix.m_GridRouting );
+
+            fpBBox.SetOrigin( fpBBoxOrg + lastPos );
+            g_Offset_Module = mod_pos - lastPos;
+
+            color = scan.m_keepOut[last] >= 0 ? BROWN : RED;
+            draw_FootprintRect( aFrame->GetCanvas()->GetClipBox(), aDC, fpBBox, color );
+        }
+
+        if( updated )
+        {
+            wxString msg;
+            msg.Printf( wxT( "Score %g, pos %s, %s" ),
+                        min_cost,
+                        GetChars( ::CoordinateToString( LastPosOK.x ) ),
+                        GetChars( ::CoordinateToString( LastPosOK.y ) ) );
+            aFrame->SetStatusText( msg );
+        }
     }
 
     // erasing the last traces
@@ -750,20 +1139,13 @@ int getOptimalModulePlacement( PCB_EDIT_FRAME* aFrame, MODULE* aModule, wxDC* aD
 }
 
 
-/* Test if the rectangular area (ux, ux .. y0, y1):
- * - is a free zone (except OCCUPED_By_MODULE returns)
- * - is on the working surface of the board (otherwise returns OUT_OF_BOARD)
- *
- * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
- */
-int TstRectangle( BOARD* Pcb, const EDA_RECT& aRect, int side )
+// The cells of the matrix inside aRect, the rows aRowMin..aRowMax and columns
+// aColMin..aColMax, empty when aRect is outside the matrix
+static void rectToCells( const EDA_RECT& aRect, int* aRowMin, int* aRowMax,
+                         int* aColMin, int* aColMax )
 {
-    EDA_RECT rect = aRect;
-
-    rect.Inflate( RoutingMatrix.m_GridRouting / 2 );
-
-    wxPoint start   = rect.GetOrigin();
-    wxPoint end     = rect.GetEnd();
+    wxPoint start   = aRect.GetOrigin();
+    wxPoint end     = aRect.GetEnd();
 
     start   -= RoutingMatrix.m_BrdBox.GetOrigin();
     end     -= RoutingMatrix.m_BrdBox.GetOrigin();
@@ -791,82 +1173,64 @@ int TstRectangle( BOARD* Pcb, const EDA_RECT& aRect, int side )
     if( col_max >= ( RoutingMatrix.m_Ncols - 1 ) )
         col_max = RoutingMatrix.m_Ncols - 1;
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            unsigned int data = RoutingMatrix.GetCell( row, col, side );
-
-            if( ( data & CELL_is_ZONE ) == 0 )
-                return OUT_OF_BOARD;
-
-            if( (data & CELL_is_MODULE) )
-                return OCCUPED_By_MODULE;
-        }
-    }
-
-    return FREE_CELL;
+    *aRowMin = row_min;
+    *aRowMax = row_max;
+    *aColMin = col_min;
+    *aColMax = col_max;
 }
 
 
-/* Calculates and returns the clearance area of the rectangular surface
- * aRect):
- * (Sum of cells in terms of distance)
+/* Test if the rectangular area (ux, ux .. y0, y1):
+ * - is a free zone (except OCCUPED_By_MODULE returns)
+ * - is on the working surface of the board (otherwise returns OUT_OF_BOARD)
+ *
+ * Returns OUT_OF_BOARD, or OCCUPED_By_MODULE or FREE_CELL if OK
+ * The cells are counted in s_AreaSums, which must be built.
  */
-unsigned int CalculateKeepOutArea( const EDA_RECT& aRect, int side )
+int TstRectangle( BOARD* Pcb, const EDA_RECT& aRect, int side )
 {
-    wxPoint start   = aRect.GetOrigin();
-    wxPoint end     = aRect.GetEnd();
+    EDA_RECT rect = aRect;
 
-    start   -= RoutingMatrix.m_BrdBox.GetOrigin();
-    end     -= RoutingMatrix.m_BrdBox.GetOrigin();
+    rect.Inflate( RoutingMatrix.m_GridRouting / 2 );
 
-    int row_min = start.y / RoutingMatrix.m_GridRouting;
-    int row_max = end.y / RoutingMatrix.m_GridRouting;
-    int col_min = start.x / RoutingMatrix.m_GridRouting;
-    int col_max = end.x / RoutingMatrix.m_GridRouting;
+    int row_min, row_max, col_min, col_max;
 
-    if( start.y > row_min * RoutingMatrix.m_GridRouting )
-        row_min++;
+    rectToCells( rect, &row_min, &row_max, &col_min, &col_max );
 
-    if( start.x > col_min * RoutingMatrix.m_GridRouting )
-        col_min++;
+    if( s_AreaSums.OutOfBoardCount( side, row_min, row_max, col_min, col_max ) )
+        return OUT_OF_BOARD;
 
-    if( row_min < 0 )
-        row_min = 0;
+    if( s_AreaSums.ModuleCount( side, row_min, row_max, col_min, col_max ) )
+        return OCCUPED_By_MODULE;
 
-    if( row_max >= ( RoutingMatrix.m_Nrows - 1 ) )
-        row_max = RoutingMatrix.m_Nrows - 1;
+    return FREE_CELL;
+}
 
-    if( col_min < 0 )
-        col_min = 0;
 
-    if( col_max >= ( RoutingMatrix.m_Ncols - 1 ) )
-        col_max = RoutingMatrix.m_Ncols - 1;
+/* Calculates and returns the clearance area of the rectangular surface
+ * aRect):
+ * (Sum of cells in terms of distance)
+ * The sum is read in s_AreaSums, which must be built.
+ */
+unsigned int CalculateKeepOutArea( const EDA_RECT& aRect, int side )
+{
+    int row_min, row_max, col_min, col_max;
 
-    unsigned int keepOutCost = 0;
+    rectToCells( aRect, &row_min, &row_max, &col_min, &col_max );
 
-    for( int row = row_min; row <= row_max; row++ )
-    {
-        for( int col = col_min; col <= col_max; col++ )
-        {
-            // RoutingMatrix.GetDist returns the "cost" of the cell
-            // at position (row, col)
-            // in autoplace this is the cost of the cell, if it is
-            // inside aRect
-            keepOutCost += RoutingMatrix.GetDist( row, col, side );
-        }
-    }
-
-    return keepOutCost;
+    // RoutingMatrix.GetDist returns the "cost" of the cell
+    // at position (row, col)
+    // in autoplace this is the cost of the cell, if it is
+    // inside aRect
+    return s_AreaSums.KeepOutCost( side, row_min, row_max, col_min, col_max );
 }
 
 
 /* Test if the module can be placed on the board.
  * Returns the value TstRectangle().
- * Module is known by its bounding box
+ * Module is known by its bounding box aFpBBox at the tested position
  */
-int TstModuleOnBoard( BOARD* Pcb, MODULE* aModule, bool TstOtherSide )
+int TstModuleOnBoard( BOARD* Pcb, MODULE* aModule, const EDA_RECT& aFpBBox, bool TstOtherSide )
 {
     int side = TOP;
     int otherside = BOTTOM;
@@ -876,8 +1240,7 @@ int TstModuleOnBoard( BOARD* Pcb, MODULE* aModule, bool TstOtherSide )
         side = BOTTOM; otherside = TOP;
     }
 
-    EDA_RECT    fpBBox = aModule->GetFootprintRect();
-    fpBBox.Move( -g_Offset_Module );
+    EDA_RECT    fpBBox = aFpBBox;
 
     int         diag = TstRectangle( Pcb, fpBBox, side );
 
@@ -899,58 +1262,6 @@ int TstModuleOnBoard( BOARD* Pcb, MODULE* aModule, bool TstOtherSide )
 }
 
 
-double compute_Ratsnest_PlaceModule( BOARD* aBrd )
-{
-    double  curr_cost;
-    wxPoint start;      // start point of a ratsnest
-    wxPoint end;        // end point of a ratsnest
-    int     dx, dy;
-
-    if( ( aBrd->m_Status_Pcb & RATSNEST_ITEM_LOCAL_OK ) == 0 )
-        return -1;
-
-    curr_cost = 0;
-
-    for( unsigned ii = 0; ii < aBrd->m_LocalRatsnest.size(); ii++ )
-    {
-        RATSNEST_ITEM* pt_local_rats_nest = &aBrd->m_LocalRatsnest[ii];
-
-        if( ( pt_local_rats_nest->m_Status & LOCAL_RATSNEST_ITEM ) )
-            continue; // Skip ratsnest between 2 pads of the current module
-
-        // Skip modules not inside the board area
-        MODULE* module = pt_local_rats_nest->m_PadEnd->GetParent();
-
-        if( !RoutingMatrix.m_BrdBox.Contains( module->GetPosition() ) )
-            continue;
-
-        start   = pt_local_rats_nest->m_PadStart->GetPosition() - g_Offset_Module;
-        end     = pt_local_rats_nest->m_PadEnd->GetPosition();
-
-        // Cost of the ratsnest.
-        dx  = end.x - start.x;
-        dy  = end.y - start.y;
-
-        dx  = abs( dx );
-        dy  = abs( dy );
-
-        // ttry to have always dx >= dy to calculate the cost of the rastsnet
-        if( dx < dy )
-            std::swap( dx, dy );
-
-        // Cost of the connection = lenght + penalty due to the slope
-        // dx is the biggest lenght relative to the X or Y axis
-        // the penalty is max for 45 degrees ratsnests,
-        // and 0 for horizontal or vertical ratsnests.
-        // For Horizontal and Vertical ratsnests, dy = 0;
-        double conn_cost = hypot( dx, dy * 2.0 );
-        curr_cost += conn_cost;    // Total cost = sum of costs of each connection
-    }
-
-    return curr_cost;
-}
-
-
 /**
  * Function CreateKeepOutRectangle
  * builds the cost map:
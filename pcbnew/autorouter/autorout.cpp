@@ -35,6 +35,8 @@
 #include <wxPcbStruct.h>
 #include <gr_basic.h>
 #include <msgpanel.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
 
 #include <pcbnew.h>
 #include <cell.h>
@@ -190,10 +192,11 @@ void PCB_EDIT_FRAME::Autoroute( wxDC* DC, int mode )
 
     // DisplayRoutingMatrix( m_canvas, DC );
 
-    Solve( DC, RoutingMatrix.m_RoutingLayersCount );
+    // The whole board is routed in batches of parallel searches
+    Solve( DC, RoutingMatrix.m_RoutingLayersCount,
+           mode == ROUTE_ALL && Pgm().GetThreadPool().GetThreadCount() > 1 );
 
     /* Free memory. */
-    FreeQueue();
     InitWork();             /* Free memory for the list of router connections. */
     RoutingMatrix.UnInitRoutingMatrix();
     stop = time( NULL ) - start;
@@ -33,6 +33,10 @@
 #define AUTOROUT_H
 
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include <base_struct.h>
 #include <layers_id_colors_and_visibility.h>
 
@@ -65,19 +69,152 @@ enum AUTOPLACEROUTE_OPTIONS
 
 #define FORCE_PADS 1  /* Force placement of pads for any Netcode */
 
-/* search statistics */
-extern int OpenNodes;   /* total number of nodes opened */
-extern int ClosNodes;   /* total number of nodes closed */
-extern int MoveNodes;   /* total number of nodes moved */
-extern int MaxNodes;    /* maximum number of nodes opened at one time */
-
-
 /* Structures useful to the generation of board as bitmap. */
 typedef unsigned char MATRIX_CELL;
 typedef int  DIST_CELL;
 typedef char DIR_CELL;
 
 
+/**
+ * Class SPARSE_CELL_MAP
+ * is the map of one board side of the routing matrix.  The cells are stored in square
+ * tiles, allocated when one of their cells gets a value other than 0: the empty areas of
+ * the board use no memory, and clearing the map only frees the tiles used.
+ */
+template <class CELL>
+class SPARSE_CELL_MAP
+{
+public:
+    SPARSE_CELL_MAP() :
+        m_tileCols( 0 )
+    {
+    }
+
+    ~SPARSE_CELL_MAP()
+    {
+        Release();
+    }
+
+    /**
+     * Function Init
+     * sizes the map for aRows x aCols cells, all of value 0.
+     */
+    void Init( int aRows, int aCols )
+    {
+        Release();
+
+        int tileRows = ( aRows + TILE_SIZE - 1 ) >> TILE_SHIFT;
+
+        m_tileCols = ( aCols + TILE_SIZE - 1 ) >> TILE_SHIFT;
+        m_tiles.assign( tileRows * m_tileCols, (CELL*) NULL );
+    }
+
+    /// Frees the map, which has no cells until the next Init()
+    void Release()
+    {
+        Clear();
+        m_tiles.clear();
+        m_tileCols = 0;
+    }
+
+    bool IsInitialized() const { return !m_tiles.empty(); }
+
+    /// Sets all the cells to 0
+    void Clear()
+    {
+        for( unsigned ii = 0; ii < m_tiles.size(); ii++ )
+        {
+            delete[] m_tiles[ii];
+            m_tiles[ii] = NULL;
+        }
+    }
+
+    /// Gives to the map the same cells as aOther, of the same size
+    void CopyFrom( const SPARSE_CELL_MAP& aOther )
+    {
+        Clear();
+
+        for( unsigned ii = 0; ii < m_tiles.size() && ii < aOther.m_tiles.size(); ii++ )
+        {
+            if( aOther.m_tiles[ii] )
+            {
+                m_tiles[ii] = new CELL[TILE_CELLS];
+                memcpy( m_tiles[ii], aOther.m_tiles[ii], TILE_CELLS * sizeof(CELL) );
+            }
+        }
+    }
+
+    CELL Get( int aRow, int aCol ) const
+    {
+        const CELL* tile = m_tiles[ tileIndex( aRow, aCol ) ];
+
+        return tile ? tile[ cellIndex( aRow, aCol ) ] : 0;
+    }
+
+    void Set( int aRow, int aCol, CELL aValue )
+    {
+        CELL*& tile = m_tiles[ tileIndex( aRow, aCol ) ];
+
+        if( !tile )
+        {
+            if( aValue == 0 )
+                return;
+
+            tile = new CELL[TILE_CELLS];
+            memset( tile, 0, TILE_CELLS * sizeof(CELL) );
+        }
+
+        tile[ cellIndex( aRow, aCol ) ] = aValue;
+    }
+
+    /// Exchanges the cells of two maps of the same size
+    void Swap( SPARSE_CELL_MAP& aOther )
+    {
+        std::swap( m_tileCols, aOther.m_tileCols );
+        m_tiles.swap( aOther.m_tiles );
+    }
+
+    /// @return the size in bytes of the map, for statistics
+    size_t GetMemorySize() const
+    {
+        size_t size = m_tiles.size() * sizeof(CELL*);
+
+        for( unsigned ii = 0; ii < m_tiles.size(); ii++ )
+        {
+            if( m_tiles[ii] )
+                size += TILE_CELLS * sizeof(CELL);
+        }
+
+        return size;
+    }
+
+private:
+    // Not copyable, use CopyFrom()
+    SPARSE_CELL_MAP( const SPARSE_CELL_MAP& );
+    SPARSE_CELL_MAP& operator=( const SPARSE_CELL_MAP& );
+
+    enum
+    {
+        TILE_SHIFT  = 5,
+        TILE_SIZE   = 1 << TILE_SHIFT,
+        TILE_CELLS  = TILE_SIZE * TILE_SIZE
+    };
+
+    int tileIndex( int aRow, int aCol ) const
+    {
+        return ( aRow >> TILE_SHIFT ) * m_tileCols + ( aCol >> TILE_SHIFT );
+    }
+
+    static int cellIndex( int aRow, int aCol )
+    {
+        return ( ( aRow & ( TILE_SIZE - 1 ) ) << TILE_SHIFT ) + ( aCol & ( TILE_SIZE - 1 ) );
+    }
+
+    int                 m_tileCols;
+    std::vector<CELL*>  m_tiles;
+};
+
+
 /**
  * class MATRIX_ROUTING_HEAD
  * handle the matrix routing that describes the actual board
@@ -85,17 +222,18 @@ typedef char DIR_CELL;
 class MATRIX_ROUTING_HEAD
 {
 public:
-    MATRIX_CELL* m_BoardSide[MAX_ROUTING_LAYERS_COUNT]; // the image map of 2 board sides
-    DIST_CELL*   m_DistSide[MAX_ROUTING_LAYERS_COUNT];  // the image map of 2 board sides:
-                                                        // distance to cells
-    DIR_CELL*    m_DirSide[MAX_ROUTING_LAYERS_COUNT];   // the image map of 2 board sides:
-                                                        // pointers back to source
+    // the image map of 2 board sides
+    SPARSE_CELL_MAP<MATRIX_CELL> m_BoardSide[MAX_ROUTING_LAYERS_COUNT];
+    // the image map of 2 board sides: distance to cells
+    SPARSE_CELL_MAP<DIST_CELL>   m_DistSide[MAX_ROUTING_LAYERS_COUNT];
+    // the image map of 2 board sides: pointers back to source
+    SPARSE_CELL_MAP<DIR_CELL>    m_DirSide[MAX_ROUTING_LAYERS_COUNT];
     bool         m_InitMatrixDone;
     int          m_RoutingLayersCount;          // Number of layers for autorouting (0 or 1)
     int          m_GridRouting;                 // Size of grid for autoplace/autoroute
     EDA_RECT     m_BrdBox;                      // Actual board bounding box
     int          m_Nrows, m_Ncols;              // Matrix size
-    int          m_MemSize;                     // Memory requirement, just for statistics
+    int          m_MemSize;                     // Memory used, just for statistics
     int          m_RouteCount;                  // Number of routes
 
 private:
@@ -142,6 +280,12 @@ public:
 
     void UnInitRoutingMatrix();
 
+    /**
+     * Function GetMemorySize
+     * @return the memory used by the matrix, in bytes.
+     */
+    int GetMemorySize() const;
+
     // Initialize WriteCell to make the aLogicOp
     void SetCellOperation( int aLogicOp );
 
@@ -215,11 +359,51 @@ void TraceFilledRectangle( int ux0, int uy0, int ux1, int uy1,
                            int color, int op_logic );
 
 /* QUEUE.CPP */
-void FreeQueue();
-void InitQueue();
-void GetQueue( int *, int *, int *, int *, int * );
-bool  SetQueue( int, int, int, int, int, int, int );
-void ReSetQueue( int, int, int, int, int, int, int );
+
+/**
+ * Class ROUTING_QUEUE
+ * is the search queue of the routing of one connection, with its statistics.  Each
+ * search has its own queue, so the searches of the parallel routing do not share it.
+ */
+class ROUTING_QUEUE
+{
+public:
+    int m_OpenNodes;    // total number of nodes opened
+    int m_ClosNodes;    // total number of nodes closed
+    int m_MoveNodes;    // total number of nodes moved
+    int m_MaxNodes;     // maximum number of nodes opened at one time
+
+    ROUTING_QUEUE();
+    ~ROUTING_QUEUE();
+
+    /// Frees the memory used for storing all the queue
+    void Free();
+
+    /// Empties the queue before a search
+    void Init();
+
+    /// Gets the open cell of lowest estimated cost, ILLEGAL values if none is left
+    void Get( int* r, int* c, int* s, int* d, int* a );
+
+    /**
+     * Function Set
+     * adds a search node, of distance d and approximate distance to target a.
+     * @return false if the memory allocation failed.
+     */
+    bool Set( int r, int c, int s, int d, int a, int r2, int c2 );
+
+    /// Repositions a node whose distance is improved
+    void ReSet( int r, int c, int s, int d, int a, int r2, int c2 );
+
+private:
+    // Not copyable
+    ROUTING_QUEUE( const ROUTING_QUEUE& );
+    ROUTING_QUEUE& operator=( const ROUTING_QUEUE& );
+
+    struct QUEUE_DATA;
+
+    QUEUE_DATA* m_data;
+};
 
 /* WORK.CPP */
 void InitWork();
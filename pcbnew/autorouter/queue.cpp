@@ -39,76 +39,127 @@
 #include <autorout.h>
 #include <cell.h>
 
+#include <new>
+#include <queue>
 
+#include <boost/unordered_map.hpp>
+
+
+/* The search queue is a binary heap of the open cells, the first one being the cell of
+ * lowest estimated cost: the path distance so far, plus the approximate distance to the
+ * target.  A cell whose distance is improved is pushed again and its previous node left
+ * in the heap, found outdated when it is popped.
+ */
 struct PcbQueue /* search queue structure */
 {
-    struct PcbQueue* Next;
     int              Row;       /* current row                  */
     int              Col;       /* current column               */
     int              Side;      /* 0=top, 1=bottom              */
     int              Dist;      /* path distance to this cell so far        */
     int              ApxDist;   /* approximate distance to target from here */
+    bool             Goal;      /* the cell is the target cell              */
+    long             Order;     /* number of the node, the latest first at equal cost */
+
+    // The heap top is the largest node: the node of lower cost is the larger one.
+    // At equal cost the goal nodes come first, then the nodes queued last.
+    bool operator<( const PcbQueue& aOther ) const
+    {
+        int cost = Dist + ApxDist;
+        int otherCost = aOther.Dist + aOther.ApxDist;
+
+        if( cost != otherCost )
+            return cost > otherCost;
+
+        if( Goal != aOther.Goal )
+            return aOther.Goal;
+
+        return Order < aOther.Order;
+    }
 };
 
-static long             qlen = 0;   /* current queue length */
-static struct PcbQueue* Head = NULL;
-static struct PcbQueue* Tail = NULL;
-static struct PcbQueue* Save = NULL;    /* hold empty queue structs */
+typedef boost::unordered_map<long long, long> OPEN_CELLS;
 
 
-/* Free the memory used for storing all the queue */
-void FreeQueue()
+struct ROUTING_QUEUE::QUEUE_DATA
 {
-    struct PcbQueue* p;
+    long                            qlen;       /* current queue length */
+    long                            order;      /* number of the last node queued */
+    std::priority_queue<PcbQueue>   heap;
+    OPEN_CELLS                      openCells;  /* the current node of each open cell */
+};
 
-    InitQueue();
 
-    while( (p = Save) != NULL )
-    {
-        Save = p->Next;
-        delete p;
-    }
+static long long cellKey( int r, int c, int side )
+{
+    return ( ( (long long) r << 32 ) | ( (long long) c << 1 ) ) | side;
+}
+
+
+ROUTING_QUEUE::ROUTING_QUEUE() :
+    m_data( new QUEUE_DATA )
+{
+    Init();
+}
+
+
+ROUTING_QUEUE::~ROUTING_QUEUE()
+{
+    delete m_data;
+}
+
+
+/* Free the memory used for storing all the queue */
+void ROUTING_QUEUE::Free()
+{
+    Init();
+
+    // release the memory of the containers
+    std::priority_queue<PcbQueue>().swap( m_data->heap );
+    OPEN_CELLS().swap( m_data->openCells );
 }
 
 
 /* initialize the search queue */
-void InitQueue()
+void ROUTING_QUEUE::Init()
 {
-    struct PcbQueue* p;
+    while( !m_data->heap.empty() )
+        m_data->heap.pop();
 
-    while( (p = Head) != NULL )
-    {
-        Head    = p->Next;
-        p->Next = Save; Save = p;
-    }
+    m_data->openCells.clear();
+    m_data->order = 0;
+    m_data->qlen = 0;
 
-    Tail = NULL;
-    OpenNodes = ClosNodes = MoveNodes = MaxNodes = qlen = 0;
+    m_OpenNodes = m_ClosNodes = m_MoveNodes = m_MaxNodes = 0;
 }
 
 
 /* get search queue item from list */
-void GetQueue( int* r, int* c, int* s, int* d, int* a )
+void ROUTING_QUEUE::Get( int* r, int* c, int* s, int* d, int* a )
 {
-    struct PcbQueue* p;
-
-    if( (p = Head) != NULL )  /* return first item in list */
+    while( !m_data->heap.empty() )
     {
-        *r = p->Row; *c = p->Col;
-        *s = p->Side;
-        *d = p->Dist; *a = p->ApxDist;
+        PcbQueue p = m_data->heap.top();
+        m_data->heap.pop();
 
-        if( (Head = p->Next) == NULL )
-            Tail = NULL;
+        OPEN_CELLS::iterator it = m_data->openCells.find( cellKey( p.Row, p.Col, p.Side ) );
 
-        /* put node on free list */
-        p->Next = Save; Save = p;
-        ClosNodes++; qlen--;
-    }
-    else /* empty list */
-    {
-        *r = *c = *s = *d = *a = ILLEGAL;
+        // skip the nodes replaced by ReSet()
+        if( it == m_data->openCells.end() || it->second != p.Order )
+            continue;
+
+        m_data->openCells.erase( it );
+
+        /* return first item in list */
+        *r = p.Row; *c = p.Col;
+        *s = p.Side;
+        *d = p.Dist; *a = p.ApxDist;
+
+        m_ClosNodes++; m_data->qlen--;
+        return;
     }
+
+    /* empty list */
+    *r = *c = *s = *d = *a = ILLEGAL;
 }
 
 
@@ -117,104 +168,57 @@ void GetQueue( int* r, int* c, int* s, int* d, int* a )
  *      1 - OK
  *      0 - Failed to allocate memory.
  */
-bool SetQueue( int r, int c, int side, int d, int a, int r2, int c2 )
+bool ROUTING_QUEUE::Set( int r, int c, int side, int d, int a, int r2, int c2 )
 {
-    struct PcbQueue* p, * q, * t;
-    int i, j;
+    PcbQueue p;
 
-    j = 0;                      // gcc warning fix
+    p.Row  = r;
+    p.Col  = c;
+    p.Side = side;
+    p.Dist = d;
+    p.ApxDist = a;
+    p.Goal = ( r == r2 && c == c2 );
+    p.Order = ++m_data->order;
 
-    if( (p = Save) != NULL )    /* try free list first */
+    try
     {
-        Save = p->Next;
+        m_data->heap.push( p );
+        m_data->openCells[ cellKey( r, c, side ) ] = p.Order;
     }
-    else if( ( p = (PcbQueue*) operator new( sizeof( PcbQueue ), std::nothrow ) ) == NULL )
+    catch( const std::bad_alloc& )
     {
         return 0;
     }
 
-    p->Row  = r;
-    p->Col  = c;
-    p->Side = side;
-    i = (p->Dist = d) + (p->ApxDist = a);
-    p->Next = NULL;
-
-    if( (q = Head) != NULL ) /* insert in proper position in list */
-    {
-        if( q->Dist + q->ApxDist > i ) /* insert at head */
-        {
-            p->Next = q; Head = p;
-        }
-        else   /* search for proper position */
-        {
-            for( t = q, q = q->Next; q && i > ( j = q->Dist + q->ApxDist ); t = q, q = q->Next )
-                ;
-
-            if( q && i == j && q->Row == r2 && q->Col == c2 )
-            {
-                /* insert after q, which is a goal node */
-                if( ( p->Next = q->Next ) == NULL )
-                    Tail = p;
-
-                q->Next = p;
-            }
-            else  /* insert in front of q */
-            {
-                if( ( p->Next = q ) == NULL )
-                    Tail = p;
-
-                t->Next = p;
-            }
-        }
-    }
-    else /* empty search list */
-    {
-        Head = Tail = p;
-    }
-
-    OpenNodes++;
+    m_OpenNodes++;
 
-    if( ++qlen > MaxNodes )
-        MaxNodes = qlen;
+    if( ++m_data->qlen > m_MaxNodes )
+        m_MaxNodes = m_data->qlen;
 
     return 1;
 }
 
 
 /* reposition node in list */
-void ReSetQueue( int r, int c, int s, int d, int a, int r2, int c2 )
+void ROUTING_QUEUE::ReSet( int r, int c, int s, int d, int a, int r2, int c2 )
 {
-    struct PcbQueue* p, * q;
-
     /* first, see if it is already in the list */
-    for( q = NULL, p = Head; p; q = p, p = p->Next )
+    OPEN_CELLS::iterator it = m_data->openCells.find( cellKey( r, c, s ) );
+
+    if( it != m_data->openCells.end() )
     {
-        if( p->Row == r && p->Col == c && p->Side == s )
-        {
-            /* old one to remove */
-            if( q )
-            {
-                if( ( q->Next = p->Next ) == NULL )
-                    Tail = q;
-            }
-            else if( ( Head = p->Next ) == NULL )
-            {
-                Tail = NULL;
-            }
-
-            p->Next = Save;
-            Save = p;
-            OpenNodes--;
-            MoveNodes++;
-            qlen--;
-            break;
-        }
+        /* old one to remove: its node is outdated once the cell is queued again */
+        m_data->openCells.erase( it );
+        m_OpenNodes--;
+        m_MoveNodes++;
+        m_data->qlen--;
+    }
+    else                /* not found, it has already been closed once */
+    {
+        m_ClosNodes--;  /* we will close it again, but just count once */
     }
-
-    if( !p )            /* not found, it has already been closed once */
-        ClosNodes--;    /* we will close it again, but just count once */
 
     /* if it was there, it's gone now; insert it at the proper position */
-    bool res = SetQueue( r, c, s, d, a, r2, c2 );
+    bool res = Set( r, c, s, d, a, r2, c2 );
     (void) res;
 }
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file skyline_placement.cpp
+ */
+
+#include <algorithm>
+#include <climits>
+
+#include "skyline_placement.h"
+
+
+SKYLINE_PLACEMENT::SKYLINE_PLACEMENT( int aWidth ) :
+    m_width( aWidth ),
+    m_usedW( 0 ),
+    m_usedH( 0 )
+{
+    SEGMENT all = { 0, 0, aWidth };
+
+    m_skyline.push_back( all );
+}
+
+
+int SKYLINE_PLACEMENT::fitAt( unsigned aIndex, int aW ) const
+{
+    if( m_skyline[aIndex].x + aW > m_width )
+        return -1;
+
+    int y = 0;
+
+    // the segments cover the area width, the rectangle ends on one of them
+    for( unsigned ii = aIndex; aW > 0; ii++ )
+    {
+        y = std::max( y, m_skyline[ii].y );
+        aW -= m_skyline[ii].w;
+    }
+
+    return y;
+}
+
+
+bool SKYLINE_PLACEMENT::Add( int aW, int aH, int* aX, int* aY )
+{
+    if( aW <= 0 )
+    {
+        *aX = *aY = 0;
+        return true;
+    }
+
+    if( aW > m_width )
+        return false;
+
+    int bestIndex = -1;
+    int bestBottom = INT_MAX;
+    int bestY = 0;
+
+    // The segments are sorted by x: on equal bottoms the first one is on the left
+    for( unsigned ii = 0; ii < m_skyline.size(); ii++ )
+    {
+        int y = fitAt( ii, aW );
+
+        if( y >= 0 && y + aH < bestBottom )
+        {
+            bestIndex = ii;
+            bestBottom = y + aH;
+            bestY = y;
+        }
+    }
+
+    if( bestIndex < 0 )     // Should not occur, the first segment always fits
+        return false;
+
+    SEGMENT placed = { m_skyline[bestIndex].x, bestBottom, aW };
+
+    *aX = placed.x;
+    *aY = bestY;
+
+    // The new segment hides the part of the skyline under the rectangle
+    m_skyline.insert( m_skyline.begin() + bestIndex, placed );
+
+    unsigned next = bestIndex + 1;
+
+    while( next < m_skyline.size() && m_skyline[next].x < placed.x + placed.w )
+    {
+        int hidden = placed.x + placed.w - m_skyline[next].x;
+
+        if( m_skyline[next].w > hidden )
+        {
+            m_skyline[next].x += hidden;
+            m_skyline[next].w -= hidden;
+            break;
+        }
+
+        m_skyline.erase( m_skyline.begin() + next );
+    }
+
+    // Merge the neighbour segments of same height
+    for( unsigned ii = 1; ii < m_skyline.size(); )
+    {
+        if( m_skyline[ii - 1].y == m_skyline[ii].y )
+        {
+            m_skyline[ii - 1].w += m_skyline[ii].w;
+            m_skyline.erase( m_skyline.begin() + ii );
+        }
+        else
+            ii++;
+    }
+
+    m_usedW = std::max( m_usedW, placed.x + aW );
+    m_usedH = std::max( m_usedH, bestBottom );
+
+    return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file skyline_placement.h
+ */
+
+#ifndef SKYLINE_PLACEMENT_H_
+#define SKYLINE_PLACEMENT_H_
+
+#include <vector>
+
+
+/**
+ * Class SKYLINE_PLACEMENT
+ * packs rectangles in an area of a given width, growing in y.  The placed rectangles
+ * are described by their skyline, the first free y of each column, and each new
+ * rectangle is placed on the skyline where its end y is the smallest, then the most on
+ * the left.  The holes behind the skyline are not used, but the placement of a rectangle
+ * only looks at the skyline, which only has a few segments.
+ *
+ * The rectangles give the best packing when added by decreasing height.
+ */
+class SKYLINE_PLACEMENT
+{
+public:
+    SKYLINE_PLACEMENT( int aWidth );
+
+    /**
+     * Function Add
+     * places a rectangle of size aW, aH
+     * @param aX, aY [out] are the position of the rectangle in the area
+     * @return false if the rectangle is wider than the area
+     */
+    bool Add( int aW, int aH, int* aX, int* aY );
+
+    /// @return the size of the area used by the placed rectangles
+    int GetW() const { return m_usedW; }
+    int GetH() const { return m_usedH; }
+
+private:
+    // the first free y of the columns x .. x + w - 1
+    struct SEGMENT
+    {
+        int x, y, w;
+    };
+
+    std::vector<SEGMENT> m_skyline;     // sorted by x, covering the area width
+    int                  m_width;
+    int                  m_usedW;
+    int                  m_usedH;
+
+    // y of a rectangle of width aW on the skyline from its segment aIndex, or -1 when
+    // the rectangle ends outside the area
+    int fitAt( unsigned aIndex, int aW ) const;
+};
+
+#endif    // SKYLINE_PLACEMENT_H_
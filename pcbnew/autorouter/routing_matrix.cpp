@@ -47,9 +47,6 @@
 
 MATRIX_ROUTING_HEAD::MATRIX_ROUTING_HEAD()
 {
-    m_BoardSide[0] = m_BoardSide[1] = NULL;
-    m_DistSide[0] = m_DistSide[1] = NULL;
-    m_DirSide[0] = m_DirSide[1] = NULL;
     m_opWriteCell        = NULL;
     m_InitMatrixDone     = false;
     m_Nrows              = 0;
@@ -107,75 +104,51 @@ int MATRIX_ROUTING_HEAD::InitRoutingMatrix()
 
     m_InitMatrixDone = true;     // we have been called
 
-    // give a small margin for memory allocation:
-    int ii = (RoutingMatrix.m_Nrows + 1) * (RoutingMatrix.m_Ncols + 1);
+    // give a small margin for memory allocation.  The maps allocate their cells
+    // when they are written, the empty areas of the board use no memory.
+    int rows = m_Nrows + 1;
+    int cols = m_Ncols + 1;
 
     int side = BOTTOM;
     for( int jj = 0; jj < m_RoutingLayersCount; jj++ )  // m_RoutingLayersCount = 1 or 2
     {
-        m_BoardSide[side] = NULL;
-        m_DistSide[side]  = NULL;
-        m_DirSide[side]   = NULL;
+        m_BoardSide[side].Init( rows, cols );
+        m_DistSide[side].Init( rows, cols );
+        m_DirSide[side].Init( rows, cols );
 
-        // allocate matrix & initialize everything to empty
-        m_BoardSide[side] = (MATRIX_CELL*) operator new( ii * sizeof(MATRIX_CELL) );
-        memset( m_BoardSide[side], 0, ii * sizeof(MATRIX_CELL) );
-
-        if( m_BoardSide[side] == NULL )
-            return -1;
+        side = TOP;
+    }
 
-        // allocate Distances
-        m_DistSide[side] = (DIST_CELL*) operator new( ii * sizeof(DIST_CELL) );
-        memset( m_DistSide[side], 0, ii * sizeof(DIST_CELL) );
+    m_MemSize = GetMemorySize();
 
-        if( m_DistSide[side] == NULL )
-            return -1;
+    return m_MemSize;
+}
 
-        // allocate Dir (chars)
-        m_DirSide[side] = (char*) operator new( ii );
-        memset( m_DirSide[side], 0, ii );
 
-        if( m_DirSide[side] == NULL )
-            return -1;
+int MATRIX_ROUTING_HEAD::GetMemorySize() const
+{
+    size_t size = 0;
 
-        side = TOP;
+    for( int ii = 0; ii < MAX_ROUTING_LAYERS_COUNT; ii++ )
+    {
+        size += m_BoardSide[ii].GetMemorySize();
+        size += m_DistSide[ii].GetMemorySize();
+        size += m_DirSide[ii].GetMemorySize();
     }
 
-    m_MemSize = m_RouteCount * ii * ( sizeof(MATRIX_CELL)
-                + sizeof(DIST_CELL) + sizeof(char) );
-
-    return m_MemSize;
+    return (int) size;
 }
 
 
 void MATRIX_ROUTING_HEAD::UnInitRoutingMatrix()
 {
-    int ii;
-
     m_InitMatrixDone = false;
 
-    for( ii = 0; ii < MAX_ROUTING_LAYERS_COUNT; ii++ )
+    for( int ii = 0; ii < MAX_ROUTING_LAYERS_COUNT; ii++ )
     {
-        // de-allocate Dir matrix
-        if( m_DirSide[ii] )
-        {
-            delete m_DirSide[ii];
-            m_DirSide[ii] = NULL;
-        }
-
-        // de-allocate Distances matrix
-        if( m_DistSide[ii] )
-        {
-            delete m_DistSide[ii];
-            m_DistSide[ii] = NULL;
-        }
-
-        // de-allocate cells matrix
-        if( m_BoardSide[ii] )
-        {
-            delete m_BoardSide[ii];
-            m_BoardSide[ii] = NULL;
-        }
+        m_DirSide[ii].Release();
+        m_DistSide[ii].Release();
+        m_BoardSide[ii].Release();
     }
 
     m_Nrows = m_Ncols = 0;
@@ -448,10 +421,7 @@ void MATRIX_ROUTING_HEAD::SetCellOperation( int aLogicOp )
  */
 MATRIX_CELL MATRIX_ROUTING_HEAD::GetCell( int aRow, int aCol, int aSide )
 {
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    return p[aRow * m_Ncols + aCol];
+    return m_BoardSide[aSide].Get( aRow, aCol );
 }
 
 
@@ -459,10 +429,7 @@ MATRIX_CELL MATRIX_ROUTING_HEAD::GetCell( int aRow, int aCol, int aSide )
  */
 void MATRIX_ROUTING_HEAD::SetCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
 {
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] = x;
+    m_BoardSide[aSide].Set( aRow, aCol, x );
 }
 
 
@@ -470,10 +437,7 @@ void MATRIX_ROUTING_HEAD::SetCell( int aRow, int aCol, int aSide, MATRIX_CELL x
  */
 void MATRIX_ROUTING_HEAD::OrCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
 {
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] |= x;
+    m_BoardSide[aSide].Set( aRow, aCol, m_BoardSide[aSide].Get( aRow, aCol ) | x );
 }
 
 
@@ -481,10 +445,7 @@ void MATRIX_ROUTING_HEAD::OrCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
  */
 void MATRIX_ROUTING_HEAD::XorCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
 {
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] ^= x;
+    m_BoardSide[aSide].Set( aRow, aCol, m_BoardSide[aSide].Get( aRow, aCol ) ^ x );
 }
 
 
@@ -492,10 +453,7 @@ void MATRIX_ROUTING_HEAD::XorCell( int aRow, int aCol, int aSide, MATRIX_CELL x
  */
 void MATRIX_ROUTING_HEAD::AndCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
 {
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] &= x;
+    m_BoardSide[aSide].Set( aRow, aCol, m_BoardSide[aSide].Get( aRow, aCol ) & x );
 }
 
 
@@ -503,48 +461,33 @@ void MATRIX_ROUTING_HEAD::AndCell( int aRow, int aCol, int aSide, MATRIX_CELL x
  */
 void MATRIX_ROUTING_HEAD::AddCell( int aRow, int aCol, int aSide, MATRIX_CELL x )
 {
-    MATRIX_CELL* p;
-
-    p = RoutingMatrix.m_BoardSide[aSide];
-    p[aRow * m_Ncols + aCol] += x;
+    m_BoardSide[aSide].Set( aRow, aCol, m_BoardSide[aSide].Get( aRow, aCol ) + x );
 }
 
 
 // fetch distance cell
 DIST_CELL MATRIX_ROUTING_HEAD::GetDist( int aRow, int aCol, int aSide ) // fetch distance cell
 {
-    DIST_CELL* p;
-
-    p = RoutingMatrix.m_DistSide[aSide];
-    return p[aRow * m_Ncols + aCol];
+    return m_DistSide[aSide].Get( aRow, aCol );
 }
 
 
 // store distance cell
 void MATRIX_ROUTING_HEAD::SetDist( int aRow, int aCol, int aSide, DIST_CELL x )
 {
-    DIST_CELL* p;
-
-    p = RoutingMatrix.m_DistSide[aSide];
-    p[aRow * m_Ncols + aCol] = x;
+    m_DistSide[aSide].Set( aRow, aCol, x );
 }
 
 
 // fetch direction cell
 int MATRIX_ROUTING_HEAD::GetDir( int aRow, int aCol, int aSide )
 {
-    DIR_CELL* p;
-
-    p = RoutingMatrix.m_DirSide[aSide];
-    return (int) (p[aRow * m_Ncols + aCol]);
+    return (int) m_DirSide[aSide].Get( aRow, aCol );
 }
 
 
 // store direction cell
 void MATRIX_ROUTING_HEAD::SetDir( int aRow, int aCol, int aSide, int x )
 {
-    DIR_CELL* p;
-
-    p = RoutingMatrix.m_DirSide[aSide];
-    p[aRow * m_Ncols + aCol] = (char) x;
+    m_DirSide[aSide].Set( aRow, aCol, (DIR_CELL) x );
 }
@@ -39,6 +39,8 @@
 #include <wxPcbStruct.h>
 #include <gr_basic.h>
 #include <macros.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
 
 #include <class_board.h>
 #include <class_track.h>
@@ -48,15 +50,19 @@
 #include <autorout.h>
 #include <cell.h>
 
+#include <new>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/unordered_set.hpp>
+
+
+struct ROUTE_SEARCH;
 
 static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
                                 wxDC*           DC,
-                                int             two_sides,
-                                int             row_source,
-                                int             col_source,
-                                int             row_target,
-                                int             col_target,
-                                RATSNEST_ITEM*  pt_rat );
+                                ROUTE_SEARCH&   aSearch );
 
 static int Retrace( PCB_EDIT_FRAME* pcbframe,
                     wxDC*           DC,
@@ -85,10 +91,7 @@ static int            s_Clearance;  // Clearance value used in autorouter
 
 static PICKED_ITEMS_LIST s_ItemsListPicker;
 
-int OpenNodes;       // total number of nodes opened
-int ClosNodes;       // total number of nodes closed
-int MoveNodes;       // total number of nodes moved
-int MaxNodes;        // maximum number of nodes opened at one time
+static ROUTING_QUEUE  s_Queue;      // the queue of the serial searches
 
 #define NOSUCCESS       0
 #define STOP_FROM_ESC   -1
@@ -96,6 +99,14 @@ int MaxNodes;        // maximum number of nodes opened at one time
 #define SUCCESS         1
 #define TRIVIAL_SUCCESS 2
 
+// The cells added around the pads of a connection to the window of its parallel search
+#define MIN_WINDOW_SLACK 10
+
+// The connections examined to fill a batch of parallel searches, and the count of the
+// searches of a batch per thread
+#define BATCH_LOOKAHEAD             64
+#define BATCH_SEARCHES_PER_THREAD   4
+
 /*
 ** visit neighboring cells like this (where [9] is on the other side):
 **
@@ -230,20 +241,16 @@ static struct block blocking[8] =
   } };
 
 // mask for hole-related blocking effects
-static struct
-{
-    long trace;
-    int  present;
-} selfok2[8] =
+static const long selfok2[8] =
 {
-    { HOLE_NORTHWEST, 0 },
-    { HOLE_NORTH,     0 },
-    { HOLE_NORTHEAST, 0 },
-    { HOLE_WEST,      0 },
-    { HOLE_EAST,      0 },
-    { HOLE_SOUTHWEST, 0 },
-    { HOLE_SOUTH,     0 },
-    { HOLE_SOUTHEAST, 0 }
+    HOLE_NORTHWEST,
+    HOLE_NORTH,
+    HOLE_NORTHEAST,
+    HOLE_WEST,
+    HOLE_EAST,
+    HOLE_SOUTHWEST,
+    HOLE_SOUTH,
+    HOLE_SOUTHEAST
 };
 
 static long newmask[8] =
@@ -260,38 +267,227 @@ static long newmask[8] =
 };
 
 
+// A board cell read by a parallel search, with the value it had
+struct PATH_CELL
+{
+    int         m_Row;
+    int         m_Col;
+    int         m_Side;
+    MATRIX_CELL m_Cell;
+};
+
+
+/**
+ * Struct ROUTE_SEARCH
+ * is the search of the path of one connection, from its source cell to its target cell.
+ *
+ * The serial routing searches the full matrix, in the direction and distance maps of
+ * RoutingMatrix and through s_Queue.  The parallel searches have their own queue and
+ * maps, and are bounded to a window of the matrix around the pads of the connection:
+ * they only read the board cells, which none of them writes.
+ */
+struct ROUTE_SEARCH
+{
+    RATSNEST_ITEM*  m_Ratsnest;
+    int             m_RowSource, m_ColSource;
+    int             m_RowTarget, m_ColTarget;
+    bool            m_TwoSides;
+    int             m_MinRow, m_MinCol;     // the searched window of the matrix, inclusive
+    int             m_MaxRow, m_MaxCol;
+    int             m_TargetSide;           // the side the target is reached on
+    int             m_Result;               // the result of a parallel search
+    bool            m_Routed;
+
+    ROUTING_QUEUE*              m_Queue;
+    SPARSE_CELL_MAP<DIR_CELL>*  m_Dir[MAX_ROUTING_LAYERS_COUNT];
+    SPARSE_CELL_MAP<DIST_CELL>* m_Dist[MAX_ROUTING_LAYERS_COUNT];
+
+    // the queue and the maps of a parallel search
+    ROUTING_QUEUE               m_OwnQueue;
+    SPARSE_CELL_MAP<DIR_CELL>   m_OwnDir[MAX_ROUTING_LAYERS_COUNT];
+    SPARSE_CELL_MAP<DIST_CELL>  m_OwnDist[MAX_ROUTING_LAYERS_COUNT];
+
+    // the board cells of the path found by a parallel search, and next to it
+    std::vector<PATH_CELL>      m_PathCells;
+
+    ROUTE_SEARCH( int aRowSource, int aColSource, int aRowTarget, int aColTarget,
+                  RATSNEST_ITEM* aRatsnest, bool aTwoSides ) :
+        m_Ratsnest( aRatsnest ),
+        m_RowSource( aRowSource ), m_ColSource( aColSource ),
+        m_RowTarget( aRowTarget ), m_ColTarget( aColTarget ),
+        m_TwoSides( aTwoSides ),
+        m_TargetSide( BOTTOM ),
+        m_Result( NOSUCCESS ),
+        m_Routed( false )
+    {
+        UseMatrixMaps();
+    }
+
+    /// Searches the full matrix, in the maps of RoutingMatrix
+    void UseMatrixMaps()
+    {
+        m_MinRow = m_MinCol = 0;
+        m_MaxRow = RoutingMatrix.m_Nrows - 1;
+        m_MaxCol = RoutingMatrix.m_Ncols - 1;
+        m_Queue  = &s_Queue;
+
+        for( int side = 0; side < MAX_ROUTING_LAYERS_COUNT; side++ )
+        {
+            m_Dir[side]  = &RoutingMatrix.m_DirSide[side];
+            m_Dist[side] = &RoutingMatrix.m_DistSide[side];
+        }
+    }
+
+    /// Searches the window given by SetWindow(), in its own maps
+    void UseOwnMaps()
+    {
+        m_Queue = &m_OwnQueue;
+
+        for( int side = 0; side < MAX_ROUTING_LAYERS_COUNT; side++ )
+        {
+            m_OwnDir[side].Init( RoutingMatrix.m_Nrows + 1, RoutingMatrix.m_Ncols + 1 );
+            m_OwnDist[side].Init( RoutingMatrix.m_Nrows + 1, RoutingMatrix.m_Ncols + 1 );
+            m_Dir[side]  = &m_OwnDir[side];
+            m_Dist[side] = &m_OwnDist[side];
+        }
+    }
+
+    /// Frees the queue, the maps and the path cells of a parallel search
+    void ReleaseOwnMaps()
+    {
+        m_OwnQueue.Free();
+
+        for( int side = 0; side < MAX_ROUTING_LAYERS_COUNT; side++ )
+        {
+            m_OwnDir[side].Release();
+            m_OwnDist[side].Release();
+        }
+
+        std::vector<PATH_CELL>().swap( m_PathCells );
+    }
+
+    /**
+     * Function SetWindow
+     * bounds the search to the box of the pads of the connection, enlarged by the
+     * margin aMarge of the tracks, and by a slack growing with the size of the box.
+     */
+    void SetWindow( int aMarge )
+    {
+        EDA_RECT box = m_Ratsnest->m_PadStart->GetBoundingBox();
+
+        box.Merge( m_Ratsnest->m_PadEnd->GetBoundingBox() );
+        box.Inflate( aMarge );
+
+        int     grid   = RoutingMatrix.m_GridRouting;
+        wxPoint origin = RoutingMatrix.GetBrdCoordOrigin();
+        int     slack  = std::max( MIN_WINDOW_SLACK,
+                                   ( box.GetWidth() + box.GetHeight() ) / ( 4 * grid ) );
+
+        m_MinRow = std::max( ( box.GetY() - origin.y ) / grid - slack, 0 );
+        m_MinCol = std::max( ( box.GetX() - origin.x ) / grid - slack, 0 );
+        m_MaxRow = std::min( ( box.GetBottom() - origin.y ) / grid + 1 + slack,
+                             RoutingMatrix.m_Nrows - 1 );
+        m_MaxCol = std::min( ( box.GetRight() - origin.x ) / grid + 1 + slack,
+                             RoutingMatrix.m_Ncols - 1 );
+    }
+
+    /// @return true if the windows of two searches are less than aGap cells apart
+    bool IsNear( const ROUTE_SEARCH& aOther, int aGap ) const
+    {
+        return m_MinRow - aGap <= aOther.m_MaxRow && aOther.m_MinRow - aGap <= m_MaxRow
+            && m_MinCol - aGap <= aOther.m_MaxCol && aOther.m_MinCol - aGap <= m_MaxCol;
+    }
+
+    bool IsInWindow( int aRow, int aCol ) const
+    {
+        return aRow >= m_MinRow && aRow <= m_MaxRow && aCol >= m_MinCol && aCol <= m_MaxCol;
+    }
+
+    int GetDir( int aRow, int aCol, int aSide ) const
+    {
+        return (int) m_Dir[aSide]->Get( aRow, aCol );
+    }
+
+    void SetDir( int aRow, int aCol, int aSide, int aDir )
+    {
+        m_Dir[aSide]->Set( aRow, aCol, (DIR_CELL) aDir );
+    }
+
+    DIST_CELL GetDist( int aRow, int aCol, int aSide ) const
+    {
+        return m_Dist[aSide]->Get( aRow, aCol );
+    }
+
+    void SetDist( int aRow, int aCol, int aSide, DIST_CELL aDist )
+    {
+        m_Dist[aSide]->Set( aRow, aCol, aDist );
+    }
+};
+
+
+static void searchBatch( BOARD* aPcb, boost::ptr_vector<ROUTE_SEARCH>& aWork,
+                         unsigned aFirst, int aMarge, int aGap,
+                         std::vector<ROUTE_SEARCH*>& aBatch );
+static bool pathIsFree( const ROUTE_SEARCH& aSearch );
+static int commitRoute( PCB_EDIT_FRAME* pcbframe, wxDC* DC, ROUTE_SEARCH& aSearch );
+
+
 /* Route all traces
  * :
  *  1 if OK
  * -1 if escape (stop being routed) request
  * -2 if default memory allocation
+ *
+ * With aParallel, the connections are routed in batches: the paths of the connections
+ * whose windows are apart are searched at the same time on the threads of the process,
+ * then the tracks are created in the order of the work list.  A path crossing the
+ * tracks created before it, or not found in its window, is searched again on the full
+ * matrix.
  */
-int PCB_EDIT_FRAME::Solve( wxDC* DC, int aLayersCount )
+int PCB_EDIT_FRAME::Solve( wxDC* DC, int aLayersCount, bool aParallel )
 {
-    int           current_net_code;
-    int           row_source, col_source, row_target, col_target;
-    int           success, nbsucces = 0, nbunsucces = 0;
-    NETINFO_ITEM* net;
-    bool          stop = false;
-    wxString      msg;
-    int           routedCount = 0;      // routed ratsnest count
-    bool          two_sides = aLayersCount == 2;
+    int            current_net_code;
+    int            row_source, col_source, row_target, col_target;
+    int            success, nbsucces = 0, nbunsucces = 0;
+    NETINFO_ITEM*  net;
+    RATSNEST_ITEM* pt_rat;
+    bool           stop = false;
+    wxString       msg;
+    int            routedCount = 0;      // routed ratsnest count
+    bool           two_sides = aLayersCount == 2;
 
     m_canvas->SetAbortRequest( false );
 
     s_Clearance = GetBoard()->GetDesignSettings().GetDefault()->GetClearance();
 
+    // The margin of the tracks around the pads, and the count of cells between the windows
+    // of the parallel searches, which their new tracks do not reach
+    int marge     = s_Clearance + ( GetDesignSettings().GetCurrentTrackWidth() / 2 );
+    int via_marge = s_Clearance + ( GetDesignSettings().GetCurrentViaSize() / 2 );
+    int gap       = std::max( marge, via_marge ) / RoutingMatrix.m_GridRouting + 2;
+
     // Prepare the undo command info
     s_ItemsListPicker.ClearListAndDeleteItems();  // Should not be necessary, but...
 
-    // go until no more work to do
+    // The connections to route, in the order of the work list
+    boost::ptr_vector<ROUTE_SEARCH> work;
+
     GetWork( &row_source, &col_source, &current_net_code,
-             &row_target, &col_target, &pt_cur_ch ); // First net to route.
+             &row_target, &col_target, &pt_rat ); // First net to route.
 
     for( ; row_source != ILLEGAL; GetWork( &row_source, &col_source,
                                            &current_net_code, &row_target,
                                            &col_target,
-                                           &pt_cur_ch ) )
+                                           &pt_rat ) )
+    {
+        work.push_back( new ROUTE_SEARCH( row_source, col_source, row_target, col_target,
+                                          pt_rat, two_sides ) );
+    }
+
+    // go until no more work to do
+    unsigned first = 0;     // the first connection not routed
+
+    while( first < work.size() && !stop )
     {
         // Test to stop routing ( escape key pressed )
         wxYield();
@@ -310,70 +506,104 @@ int PCB_EDIT_FRAME::Solve( wxDC* DC, int aLayersCount )
             }
         }
 
-        EraseMsgBox();
+        std::vector<ROUTE_SEARCH*> batch;
 
-        routedCount++;
-        net = GetBoard()->FindNet( current_net_code );
+        if( aParallel )
+            searchBatch( GetBoard(), work, first, marge, gap, batch );
+        else
+            batch.push_back( &work[first] );
 
-        if( net )
+        bool searched = batch.size() > 1;
+
+        for( unsigned ii = 0; ii < batch.size() && !stop; ii++ )
         {
-            msg.Printf( wxT( "[%8.8s]" ), GetChars( net->GetNetname() ) );
-            AppendMsgPanel( wxT( "Net route" ), msg, BROWN );
-            msg.Printf( wxT( "%d / %d" ), routedCount, RoutingMatrix.m_RouteCount );
-            AppendMsgPanel( wxT( "Activity" ), msg, BROWN );
-        }
+            ROUTE_SEARCH& search = *batch[ii];
 
-        segm_oX = GetBoard()->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * col_source);
-        segm_oY = GetBoard()->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * row_source);
-        segm_fX = GetBoard()->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * col_target);
-        segm_fY = GetBoard()->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * row_target);
+            pt_cur_ch = search.m_Ratsnest;
 
-        // Draw segment.
-        GRLine( m_canvas->GetClipBox(), DC,
-                segm_oX, segm_oY, segm_fX, segm_fY,
-                0, WHITE );
-        pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
-        pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
+            EraseMsgBox();
 
-        success = Autoroute_One_Track( this, DC,
-                                       two_sides, row_source, col_source,
-                                       row_target, col_target, pt_cur_ch );
+            routedCount++;
+            net = GetBoard()->FindNet( pt_cur_ch->GetNet() );
 
-        switch( success )
-        {
-        case NOSUCCESS:
-            pt_cur_ch->m_Status |= CH_UNROUTABLE;
-            nbunsucces++;
-            break;
+            if( net )
+            {
+                msg.Printf( wxT( "[%8.8s]" ), GetChars( net->GetNetname() ) );
+                AppendMsgPanel( wxT( "Net route" ), msg, BROWN );
+                msg.Printf( wxT( "%d / %d" ), routedCount, RoutingMatrix.m_RouteCount );
+                AppendMsgPanel( wxT( "Activity" ), msg, BROWN );
+            }
 
-        case STOP_FROM_ESC:
-            stop = true;
-            break;
+            segm_oX = GetBoard()->GetBoundingBox().GetX() +
+                      (RoutingMatrix.m_GridRouting * search.m_ColSource);
+            segm_oY = GetBoard()->GetBoundingBox().GetY() +
+                      (RoutingMatrix.m_GridRouting * search.m_RowSource);
+            segm_fX = GetBoard()->GetBoundingBox().GetX() +
+                      (RoutingMatrix.m_GridRouting * search.m_ColTarget);
+            segm_fY = GetBoard()->GetBoundingBox().GetY() +
+                      (RoutingMatrix.m_GridRouting * search.m_RowTarget);
+
+            // Draw segment.
+            GRLine( m_canvas->GetClipBox(), DC,
+                    segm_oX, segm_oY, segm_fX, segm_fY,
+                    0, WHITE );
+            pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
+            pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
+
+            if( searched && search.m_Result == TRIVIAL_SUCCESS )
+            {
+                success = TRIVIAL_SUCCESS;
+            }
+            else if( searched && search.m_Result == SUCCESS && pathIsFree( search ) )
+            {
+                success = commitRoute( this, DC, search );
+            }
+            else
+            {
+                search.ReleaseOwnMaps();
+                success = Autoroute_One_Track( this, DC, search );
+            }
 
-        case ERR_MEMORY:
-            stop = true;
-            break;
+            search.m_Routed = true;
 
-        default:
-            nbsucces++;
-            break;
-        }
+            switch( success )
+            {
+            case NOSUCCESS:
+                pt_cur_ch->m_Status |= CH_UNROUTABLE;
+                nbunsucces++;
+                break;
 
-        msg.Printf( wxT( "%d" ), nbsucces );
-        AppendMsgPanel( wxT( "OK" ), msg, GREEN );
-        msg.Printf( wxT( "%d" ), nbunsucces );
-        AppendMsgPanel( wxT( "Fail" ), msg, RED );
-        msg.Printf( wxT( "  %d" ), GetBoard()->GetUnconnectedNetCount() );
-        AppendMsgPanel( wxT( "Not Connected" ), msg, CYAN );
+            case STOP_FROM_ESC:
+                stop = true;
+                break;
 
-        // Delete routing from display.
-        pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_AND );
-        pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_AND );
+            case ERR_MEMORY:
+                stop = true;
+                break;
 
-        if( stop )
-            break;
+            default:
+                nbsucces++;
+                break;
+            }
+
+            msg.Printf( wxT( "%d" ), nbsucces );
+            AppendMsgPanel( wxT( "OK" ), msg, GREEN );
+            msg.Printf( wxT( "%d" ), nbunsucces );
+            AppendMsgPanel( wxT( "Fail" ), msg, RED );
+            msg.Printf( wxT( "  %d" ), GetBoard()->GetUnconnectedNetCount() );
+            AppendMsgPanel( wxT( "Not Connected" ), msg, CYAN );
+
+            // Delete routing from display.
+            pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_AND );
+            pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_AND );
+        }
+
+        while( first < work.size() && work[first].m_Routed )
+            first++;
     }
 
+    s_Queue.Free();
+
     SaveCopyInUndoList( s_ItemsListPicker, UR_UNSPECIFIED );
     s_ItemsListPicker.ClearItemsList(); // s_ItemsListPicker is no more owner of picked items
 
@@ -381,159 +611,122 @@ int PCB_EDIT_FRAME::Solve( wxDC* DC, int aLayersCount )
 }
 
 
-/* Route a trace on the BOARD.
- * Parameters:
- * 1 side / 2 sides (0 / 1)
- * Coord source (row, col)
- * Coord destination (row, col)
- * Net_code
- * Pointer to the ratsnest reference
+/* Test if the routing of a connection is possible, ie if its pads are accessible on the
+ * routing layers and on the routing grid.
  *
  * Returns:
- * SUCCESS if routed
+ * SUCCESS if its path is to be searched
  * TRIVIAL_SUCCESS if pads are connected by overlay (no track needed)
- * If failure NOSUCCESS
- * Escape STOP_FROM_ESC if demand
- * ERR_MEMORY if memory allocation failed.
+ * NOSUCCESS if the pads are not accessible
  */
-static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
-                                wxDC*           DC,
-                                int             two_sides,
-                                int             row_source,
-                                int             col_source,
-                                int             row_target,
-                                int             col_target,
-                                RATSNEST_ITEM*  pt_rat )
+static int testPadsAccess( BOARD* aPcb, const ROUTE_SEARCH& aSearch )
 {
-    int          r, c, side, d, apx_dist, nr, nc;
-    int          result, skip;
-    int          i;
-    long         curcell, newcell, buddy, lastopen, lastclos, lastmove;
-    int          newdist, olddir, _self;
-    int          current_net_code;
-    int          marge;
-    LSET         padLayerMaskStart;    // Mask layers belonging to the starting pad.
-    LSET         padLayerMaskEnd;      // Mask layers belonging to the ending pad.
-
-    LSET         topLayerMask( g_Route_Layer_TOP );
-
-    LSET         bottomLayerMask( g_Route_Layer_BOTTOM );
-
-    LSET         routeLayerMask;       // Mask two layers for routing.
-
-    LSET         tab_mask[2];           // Enables the calculation of the mask layer being
-                                        // tested. (side = TOP or BOTTOM)
-    int          start_mask_layer = 0;
-    wxString     msg;
+    RATSNEST_ITEM* rat = aSearch.m_Ratsnest;
+    LSET           routeLayerMask = LSET( g_Route_Layer_TOP ) | LSET( g_Route_Layer_BOTTOM );
+    LSET           padLayerMaskStart = rat->m_PadStart->GetLayerSet();
+    LSET           padLayerMaskEnd = rat->m_PadEnd->GetLayerSet();
 
     // @todo this could be a bottle neck
-    LSET all_cu = LSET::AllCuMask( pcbframe->GetBoard()->GetCopperLayerCount() );
-
-    wxBusyCursor dummy_cursor;      // Set an hourglass cursor while routing a
-                                    // track
-
-    result = NOSUCCESS;
-
-    marge = s_Clearance + ( pcbframe->GetDesignSettings().GetCurrentTrackWidth() / 2 );
-
-    // clear direction flags
-    i = RoutingMatrix.m_Nrows * RoutingMatrix.m_Ncols * sizeof(DIR_CELL);
-
-    if( two_sides )
-        memset( RoutingMatrix.m_DirSide[TOP], FROM_NOWHERE, i );
-    memset( RoutingMatrix.m_DirSide[BOTTOM], FROM_NOWHERE, i );
-
-    lastopen = lastclos = lastmove = 0;
-
-    // Set tab_masque[side] for final test of routing.
-    if( two_sides )
-        tab_mask[TOP] = topLayerMask;
-    tab_mask[BOTTOM] = bottomLayerMask;
-
-    // Set active layers mask.
-    routeLayerMask = topLayerMask | bottomLayerMask;
-
-    pt_cur_ch = pt_rat;
-
-    current_net_code  = pt_rat->GetNet();
-    padLayerMaskStart = pt_cur_ch->m_PadStart->GetLayerSet();
-
-    padLayerMaskEnd = pt_cur_ch->m_PadEnd->GetLayerSet();
-
+    LSET all_cu = LSET::AllCuMask( aPcb->GetCopperLayerCount() );
 
     /* First Test if routing possible ie if the pads are accessible
      * on the routing layers.
      */
     if( ( routeLayerMask & padLayerMaskStart ) == 0 )
-        goto end_of_route;
+        return NOSUCCESS;
 
     if( ( routeLayerMask & padLayerMaskEnd ) == 0 )
-        goto end_of_route;
+        return NOSUCCESS;
 
     /* Then test if routing possible ie if the pads are accessible
      * On the routing grid (1 grid point must be in the pad)
      */
-    {
-        int cX = ( RoutingMatrix.m_GridRouting * col_source )
-                 + pcbframe->GetBoard()->GetBoundingBox().GetX();
-        int cY = ( RoutingMatrix.m_GridRouting * row_source )
-                 + pcbframe->GetBoard()->GetBoundingBox().GetY();
-        int dx = pt_cur_ch->m_PadStart->GetSize().x / 2;
-        int dy = pt_cur_ch->m_PadStart->GetSize().y / 2;
-        int px = pt_cur_ch->m_PadStart->GetPosition().x;
-        int py = pt_cur_ch->m_PadStart->GetPosition().y;
-
-        if( ( ( int( pt_cur_ch->m_PadStart->GetOrientation() ) / 900 ) & 1 ) != 0 )
-            std::swap( dx, dy );
-
-        if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
-            goto end_of_route;
-
-        cX = ( RoutingMatrix.m_GridRouting * col_target )
-             + pcbframe->GetBoard()->GetBoundingBox().GetX();
-        cY = ( RoutingMatrix.m_GridRouting * row_target )
-             + pcbframe->GetBoard()->GetBoundingBox().GetY();
-        dx = pt_cur_ch->m_PadEnd->GetSize().x / 2;
-        dy = pt_cur_ch->m_PadEnd->GetSize().y / 2;
-        px = pt_cur_ch->m_PadEnd->GetPosition().x;
-        py = pt_cur_ch->m_PadEnd->GetPosition().y;
-
-        if( ( ( int( pt_cur_ch->m_PadEnd->GetOrientation() ) / 900) & 1 ) != 0 )
-            std::swap( dx, dy );
-
-        if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
-            goto end_of_route;
-    }
+    int cX = ( RoutingMatrix.m_GridRouting * aSearch.m_ColSource )
+             + aPcb->GetBoundingBox().GetX();
+    int cY = ( RoutingMatrix.m_GridRouting * aSearch.m_RowSource )
+             + aPcb->GetBoundingBox().GetY();
+    int dx = rat->m_PadStart->GetSize().x / 2;
+    int dy = rat->m_PadStart->GetSize().y / 2;
+    int px = rat->m_PadStart->GetPosition().x;
+    int py = rat->m_PadStart->GetPosition().y;
+
+    if( ( ( int( rat->m_PadStart->GetOrientation() ) / 900 ) & 1 ) != 0 )
+        std::swap( dx, dy );
+
+    if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
+        return NOSUCCESS;
+
+    cX = ( RoutingMatrix.m_GridRouting * aSearch.m_ColTarget )
+         + aPcb->GetBoundingBox().GetX();
+    cY = ( RoutingMatrix.m_GridRouting * aSearch.m_RowTarget )
+         + aPcb->GetBoundingBox().GetY();
+    dx = rat->m_PadEnd->GetSize().x / 2;
+    dy = rat->m_PadEnd->GetSize().y / 2;
+    px = rat->m_PadEnd->GetPosition().x;
+    py = rat->m_PadEnd->GetPosition().y;
+
+    if( ( ( int( rat->m_PadEnd->GetOrientation() ) / 900) & 1 ) != 0 )
+        std::swap( dx, dy );
+
+    if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
+        return NOSUCCESS;
 
     // Test the trivial case: direct connection overlay pads.
-    if( row_source == row_target  && col_source == col_target &&
-            ( padLayerMaskEnd & padLayerMaskStart & all_cu ).any() )
+    if( aSearch.m_RowSource == aSearch.m_RowTarget
+            && aSearch.m_ColSource == aSearch.m_ColTarget
+            && ( padLayerMaskEnd & padLayerMaskStart & all_cu ).any() )
     {
-        result = TRIVIAL_SUCCESS;
-        goto end_of_route;
+        return TRIVIAL_SUCCESS;
     }
 
-    // Placing the bit to remove obstacles on 2 pads to a link.
-    pcbframe->SetStatusText( wxT( "Gen Cells" ) );
+    return SUCCESS;
+}
 
-    PlacePad( pt_cur_ch->m_PadStart, CURRENT_PAD, marge, WRITE_OR_CELL );
-    PlacePad( pt_cur_ch->m_PadEnd, CURRENT_PAD, marge, WRITE_OR_CELL );
 
-    // Regenerates the remaining barriers (which may encroach on the
-    // placement bits precedent)
-    i = pcbframe->GetBoard()->GetPadCount();
+/* Search the path of a connection with the A* algorithm, from its source cell to its
+ * target cell.  The CURRENT_PAD cells of its pads must be set.
+ * Parameters:
+ * aFrame shows the activity of the search, and can abort it.  It is NULL for the
+ * parallel searches.
+ *
+ * Returns:
+ * SUCCESS if the target is reached, on the side aSearch.m_TargetSide
+ * If failure NOSUCCESS
+ * Escape STOP_FROM_ESC if demand
+ * ERR_MEMORY if memory allocation failed.
+ */
+static int searchRoute( ROUTE_SEARCH& aSearch, PCB_EDIT_FRAME* aFrame )
+{
+    int            r, c, side, d, apx_dist, nr, nc;
+    int            i, skip;
+    long           curcell, newcell, buddy, lastopen, lastclos, lastmove;
+    int            newdist, olddir, _self;
+    int            present[8];          // the hole-related blocking effects of a cell
+    ROUTING_QUEUE& queue = *aSearch.m_Queue;
+    bool           two_sides  = aSearch.m_TwoSides;
+    int            row_source = aSearch.m_RowSource;
+    int            col_source = aSearch.m_ColSource;
+    int            row_target = aSearch.m_RowTarget;
+    int            col_target = aSearch.m_ColTarget;
+    LSET           padLayerMaskStart = aSearch.m_Ratsnest->m_PadStart->GetLayerSet();
+    LSET           padLayerMaskEnd = aSearch.m_Ratsnest->m_PadEnd->GetLayerSet();
+
+    LSET           topLayerMask( g_Route_Layer_TOP );
+
+    LSET           bottomLayerMask( g_Route_Layer_BOTTOM );
+
+    LSET           tab_mask[2];         // Enables the calculation of the mask layer being
+                                        // tested. (side = TOP or BOTTOM)
+    wxString       msg;
 
-    for( unsigned ii = 0; ii < pcbframe->GetBoard()->GetPadCount(); ii++ )
-    {
-        D_PAD* ptr = pcbframe->GetBoard()->GetPad( ii );
+    lastopen = lastclos = lastmove = 0;
 
-        if( ( pt_cur_ch->m_PadStart != ptr ) && ( pt_cur_ch->m_PadEnd != ptr ) )
-        {
-            PlacePad( ptr, ~CURRENT_PAD, marge, WRITE_AND_CELL );
-        }
-    }
+    // Set tab_masque[side] for final test of routing.
+    if( two_sides )
+        tab_mask[TOP] = topLayerMask;
+    tab_mask[BOTTOM] = bottomLayerMask;
 
-    InitQueue(); // initialize the search queue
+    queue.Init(); // initialize the search queue
     apx_dist = RoutingMatrix.GetApxDist( row_source, col_source, row_target, col_target );
 
     // Initialize first search.
@@ -543,10 +736,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
         {
             if( ( padLayerMaskStart & topLayerMask ).any() )
             {
-                start_mask_layer = 2;
-
-                if( SetQueue( row_source, col_source, TOP, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( queue.Set( row_source, col_source, TOP, 0, apx_dist,
+                               row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -554,10 +745,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
 
             if( ( padLayerMaskStart & bottomLayerMask ).any() )
             {
-                start_mask_layer |= 1;
-
-                if( SetQueue( row_source, col_source, BOTTOM, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( queue.Set( row_source, col_source, BOTTOM, 0, apx_dist,
+                               row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -567,10 +756,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
         {
             if( ( padLayerMaskStart & bottomLayerMask ).any() )
             {
-                start_mask_layer = 1;
-
-                if( SetQueue( row_source, col_source, BOTTOM, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( queue.Set( row_source, col_source, BOTTOM, 0, apx_dist,
+                               row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -578,10 +765,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
 
             if( ( padLayerMaskStart & topLayerMask ).any() )
             {
-                start_mask_layer |= 2;
-
-                if( SetQueue( row_source, col_source, TOP, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( queue.Set( row_source, col_source, TOP, 0, apx_dist,
+                               row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -590,18 +775,16 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
     }
     else if( ( padLayerMaskStart & bottomLayerMask ).any() )
     {
-        start_mask_layer = 1;
-
-        if( SetQueue( row_source, col_source, BOTTOM, 0, apx_dist, row_target, col_target ) == 0 )
+        if( queue.Set( row_source, col_source, BOTTOM, 0, apx_dist, row_target, col_target ) == 0 )
         {
             return ERR_MEMORY;
         }
     }
 
     // search until success or we exhaust all possibilities
-    GetQueue( &r, &c, &side, &d, &apx_dist );
+    queue.Get( &r, &c, &side, &d, &apx_dist );
 
-    for( ; r != ILLEGAL; GetQueue( &r, &c, &side, &d, &apx_dist ) )
+    for( ; r != ILLEGAL; queue.Get( &r, &c, &side, &d, &apx_dist ) )
     {
         curcell = RoutingMatrix.GetCell( r, c, side );
 
@@ -611,46 +794,26 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
         if( (r == row_target) && (c == col_target)  // success if layer OK
            && (tab_mask[side] & padLayerMaskEnd).any() )
         {
-            // Remove link.
-            GRSetDrawMode( DC, GR_XOR );
-            GRLine( pcbframe->GetCanvas()->GetClipBox(),
-                    DC,
-                    segm_oX,
-                    segm_oY,
-                    segm_fX,
-                    segm_fY,
-                    0,
-                    WHITE );
-
-            // Generate trace.
-            if( Retrace( pcbframe, DC, row_source, col_source,
-                         row_target, col_target, side, current_net_code ) )
-            {
-                result = SUCCESS;   // Success : Route OK
-            }
-
-            break;                  // Routing complete.
+            aSearch.m_TargetSide = side;
+            return SUCCESS;         // Routing complete.
         }
 
-        if( pcbframe->GetCanvas()->GetAbortRequest() )
-        {
-            result = STOP_FROM_ESC;
-            break;
-        }
+        if( aFrame && aFrame->GetCanvas()->GetAbortRequest() )
+            return STOP_FROM_ESC;
 
         // report every COUNT new nodes or so
         #define COUNT 20000
 
-        if( ( OpenNodes - lastopen > COUNT )
-           || ( ClosNodes - lastclos > COUNT )
-           || ( MoveNodes - lastmove > COUNT ) )
+        if( aFrame && ( ( queue.m_OpenNodes - lastopen > COUNT )
+                        || ( queue.m_ClosNodes - lastclos > COUNT )
+                        || ( queue.m_MoveNodes - lastmove > COUNT ) ) )
         {
-            lastopen = OpenNodes;
-            lastclos = ClosNodes;
-            lastmove = MoveNodes;
+            lastopen = queue.m_OpenNodes;
+            lastclos = queue.m_ClosNodes;
+            lastmove = queue.m_MoveNodes;
             msg.Printf( wxT( "Activity: Open %d   Closed %d   Moved %d" ),
-                        OpenNodes, ClosNodes, MoveNodes );
-            pcbframe->SetStatusText( msg );
+                        queue.m_OpenNodes, queue.m_ClosNodes, queue.m_MoveNodes );
+            aFrame->SetStatusText( msg );
         }
 
         _self = 0;
@@ -662,10 +825,10 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
             // set 'present' bits
             for( i = 0; i < 8; i++ )
             {
-                selfok2[i].present = 0;
+                present[i] = 0;
 
-                if( curcell & selfok2[i].trace )
-                    selfok2[i].present = 1;
+                if( curcell & selfok2[i] )
+                    present[i] = 1;
             }
         }
 
@@ -674,12 +837,11 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
             nr = r + delta[i][0];
             nc = c + delta[i][1];
 
-            // off the edge?
-            if( nr < 0 || nr >= RoutingMatrix.m_Nrows ||
-                nc < 0 || nc >= RoutingMatrix.m_Ncols )
+            // off the edge, or out of the searched window?
+            if( !aSearch.IsInWindow( nr, nc ) )
                 continue;  // off the edge
 
-            if( _self == 5 && selfok2[i].present )
+            if( _self == 5 && present[i] )
                 continue;
 
             newcell = RoutingMatrix.GetCell( nr, nc, side );
@@ -724,39 +886,39 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
 //              if (buddy & (blocking[i].b2)) continue;
             }
 
-            olddir  = RoutingMatrix.GetDir( r, c, side );
+            olddir  = aSearch.GetDir( r, c, side );
             newdist = d + RoutingMatrix.CalcDist( ndir[i], olddir,
                                     ( olddir == FROM_OTHERSIDE ) ?
-                                    RoutingMatrix.GetDir( r, c, 1 - side ) : 0, side );
+                                    aSearch.GetDir( r, c, 1 - side ) : 0, side );
 
             // if (a) not visited yet, or (b) we have
             // found a better path, add it to queue
-            if( !RoutingMatrix.GetDir( nr, nc, side ) )
+            if( !aSearch.GetDir( nr, nc, side ) )
             {
-                RoutingMatrix.SetDir( nr, nc, side, ndir[i] );
-                RoutingMatrix.SetDist( nr, nc, side, newdist );
+                aSearch.SetDir( nr, nc, side, ndir[i] );
+                aSearch.SetDist( nr, nc, side, newdist );
 
-                if( SetQueue( nr, nc, side, newdist,
-                              RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
-                              row_target, col_target ) == 0 )
+                if( queue.Set( nr, nc, side, newdist,
+                               RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
+                               row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
             }
-            else if( newdist < RoutingMatrix.GetDist( nr, nc, side ) )
+            else if( newdist < aSearch.GetDist( nr, nc, side ) )
             {
-                RoutingMatrix.SetDir( nr, nc, side, ndir[i] );
-                RoutingMatrix.SetDist( nr, nc, side, newdist );
-                ReSetQueue( nr, nc, side, newdist,
-                            RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
-                            row_target, col_target );
+                aSearch.SetDir( nr, nc, side, ndir[i] );
+                aSearch.SetDist( nr, nc, side, newdist );
+                queue.ReSet( nr, nc, side, newdist,
+                             RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
+                             row_target, col_target );
             }
         }
 
         //* Test the other layer. *
         if( two_sides )
         {
-            olddir = RoutingMatrix.GetDir( r, c, side );
+            olddir = aSearch.GetDir( r, c, side );
 
             if( olddir == FROM_OTHERSIDE )
                 continue;   // useless move, so don't bother
@@ -798,42 +960,360 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
             /*  if (a) not visited yet,
              *  or (b) we have found a better path,
              *  add it to queue */
-            if( !RoutingMatrix.GetDir( r, c, 1 - side ) )
+            if( !aSearch.GetDir( r, c, 1 - side ) )
             {
-                RoutingMatrix.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
-                RoutingMatrix.SetDist( r, c, 1 - side, newdist );
+                aSearch.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
+                aSearch.SetDist( r, c, 1 - side, newdist );
 
-                if( SetQueue( r, c, 1 - side, newdist, apx_dist, row_target, col_target ) == 0 )
+                if( queue.Set( r, c, 1 - side, newdist, apx_dist, row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
             }
-            else if( newdist < RoutingMatrix.GetDist( r, c, 1 - side ) )
+            else if( newdist < aSearch.GetDist( r, c, 1 - side ) )
             {
-                RoutingMatrix.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
-                RoutingMatrix.SetDist( r, c, 1 - side, newdist );
-                ReSetQueue( r, c,
-                            1 - side,
-                            newdist,
-                            apx_dist,
-                            row_target,
-                            col_target );
+                aSearch.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
+                aSearch.SetDist( r, c, 1 - side, newdist );
+                queue.ReSet( r, c,
+                             1 - side,
+                             newdist,
+                             apx_dist,
+                             row_target,
+                             col_target );
             }
         }     // Finished attempt to route on other layer.
     }
 
-end_of_route:
+    return NOSUCCESS;
+}
+
+
+/* Route a trace on the BOARD, searching the full matrix.
+ * Parameters:
+ * 1 side / 2 sides (0 / 1)
+ * Coord source (row, col)
+ * Coord destination (row, col)
+ * Pointer to the ratsnest reference
+ * (all given by aSearch)
+ *
+ * Returns:
+ * SUCCESS if routed
+ * TRIVIAL_SUCCESS if pads are connected by overlay (no track needed)
+ * If failure NOSUCCESS
+ * Escape STOP_FROM_ESC if demand
+ * ERR_MEMORY if memory allocation failed.
+ */
+static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe, wxDC* DC, ROUTE_SEARCH& aSearch )
+{
+    int          result;
+    int          marge;
+    wxString     msg;
+
+    wxBusyCursor dummy_cursor;      // Set an hourglass cursor while routing a
+                                    // track
+
+    marge = s_Clearance + ( pcbframe->GetDesignSettings().GetCurrentTrackWidth() / 2 );
+
+    aSearch.UseMatrixMaps();
+
+    // clear direction flags (FROM_NOWHERE), and the distances of the previous search,
+    // only read in the cells reached again
+    if( aSearch.m_TwoSides )
+    {
+        RoutingMatrix.m_DirSide[TOP].Clear();
+        RoutingMatrix.m_DistSide[TOP].Clear();
+    }
+
+    RoutingMatrix.m_DirSide[BOTTOM].Clear();
+    RoutingMatrix.m_DistSide[BOTTOM].Clear();
+
+    pt_cur_ch = aSearch.m_Ratsnest;
+
+    result = testPadsAccess( pcbframe->GetBoard(), aSearch );
+
+    if( result != SUCCESS )
+        return result;
+
+    // Placing the bit to remove obstacles on 2 pads to a link.
+    pcbframe->SetStatusText( wxT( "Gen Cells" ) );
+
+    PlacePad( pt_cur_ch->m_PadStart, CURRENT_PAD, marge, WRITE_OR_CELL );
+    PlacePad( pt_cur_ch->m_PadEnd, CURRENT_PAD, marge, WRITE_OR_CELL );
+
+    // Regenerates the remaining barriers (which may encroach on the
+    // placement bits precedent)
+    for( unsigned ii = 0; ii < pcbframe->GetBoard()->GetPadCount(); ii++ )
+    {
+        D_PAD* ptr = pcbframe->GetBoard()->GetPad( ii );
+
+        if( ( pt_cur_ch->m_PadStart != ptr ) && ( pt_cur_ch->m_PadEnd != ptr ) )
+        {
+            PlacePad( ptr, ~CURRENT_PAD, marge, WRITE_AND_CELL );
+        }
+    }
+
+    result = searchRoute( aSearch, pcbframe );
+
+    if( result == SUCCESS )
+    {
+        // Remove link.
+        GRSetDrawMode( DC, GR_XOR );
+        GRLine( pcbframe->GetCanvas()->GetClipBox(),
+                DC,
+                segm_oX,
+                segm_oY,
+                segm_fX,
+                segm_fY,
+                0,
+                WHITE );
+
+        // Generate trace.
+        if( !Retrace( pcbframe, DC, aSearch.m_RowSource, aSearch.m_ColSource,
+                      aSearch.m_RowTarget, aSearch.m_ColTarget, aSearch.m_TargetSide,
+                      pt_cur_ch->GetNet() ) )
+        {
+            result = NOSUCCESS;
+        }
+    }
+
     PlacePad( pt_cur_ch->m_PadStart, ~CURRENT_PAD, marge, WRITE_AND_CELL );
     PlacePad( pt_cur_ch->m_PadEnd, ~CURRENT_PAD, marge, WRITE_AND_CELL );
 
     msg.Printf( wxT( "Activity: Open %d   Closed %d   Moved %d"),
-                OpenNodes, ClosNodes, MoveNodes );
+                s_Queue.m_OpenNodes, s_Queue.m_ClosNodes, s_Queue.m_MoveNodes );
     pcbframe->SetStatusText( msg );
 
     return result;
 }
 
 
+/* Move the cell r, c, s of the path found by a search one step back to the source.
+ * Returns false if there is no way back from the cell.
+ */
+static bool stepBack( const ROUTE_SEARCH& aSearch, int* r, int* c, int* s )
+{
+    switch( aSearch.GetDir( *r, *c, *s ) )
+    {
+    case FROM_NORTH:        (*r)++;             break;
+    case FROM_EAST:         (*c)++;             break;
+    case FROM_SOUTH:        (*r)--;             break;
+    case FROM_WEST:         (*c)--;             break;
+    case FROM_NORTHEAST:    (*r)++; (*c)++;     break;
+    case FROM_SOUTHEAST:    (*r)--; (*c)++;     break;
+    case FROM_SOUTHWEST:    (*r)--; (*c)--;     break;
+    case FROM_NORTHWEST:    (*r)++; (*c)--;     break;
+    case FROM_OTHERSIDE:    *s = 1 - *s;        break;
+    default:                return false;
+    }
+
+    return true;
+}
+
+
+/* Keep the board cells of the path found by a parallel search, and their neighbors, with
+ * the values the search read.
+ */
+static void recordPath( ROUTE_SEARCH& aSearch )
+{
+    int r = aSearch.m_RowTarget;
+    int c = aSearch.m_ColTarget;
+    int s = aSearch.m_TargetSide;
+
+    aSearch.m_PathCells.clear();
+
+    for( ;; )
+    {
+        for( int i = -1; i < 8; i++ )
+        {
+            int nr = i < 0 ? r : r + delta[i][0];
+            int nc = i < 0 ? c : c + delta[i][1];
+
+            if( nr < 0 || nr >= RoutingMatrix.m_Nrows ||
+                nc < 0 || nc >= RoutingMatrix.m_Ncols )
+                continue;  // off the edge
+
+            PATH_CELL cell = { nr, nc, s, RoutingMatrix.GetCell( nr, nc, s ) };
+
+            aSearch.m_PathCells.push_back( cell );
+        }
+
+        if( r == aSearch.m_RowSource && c == aSearch.m_ColSource )
+            break;
+
+        // no way back: the connection is routed again by the serial search
+        if( !stepBack( aSearch, &r, &c, &s ) )
+        {
+            aSearch.m_Result = NOSUCCESS;
+            return;
+        }
+    }
+}
+
+
+/* The task of a parallel search: test the pads of the connection, search its path in
+ * its window, and keep the board cells the path goes through.
+ */
+static void searchInWindow( BOARD* aPcb, ROUTE_SEARCH* aSearch )
+{
+    try
+    {
+        aSearch->UseOwnMaps();
+        aSearch->m_Result = testPadsAccess( aPcb, *aSearch );
+
+        if( aSearch->m_Result == SUCCESS )
+            aSearch->m_Result = searchRoute( *aSearch, NULL );
+
+        if( aSearch->m_Result == SUCCESS )
+            recordPath( *aSearch );
+
+        aSearch->m_OwnQueue.Free();
+    }
+    catch( const std::bad_alloc& )
+    {
+        aSearch->m_Result = ERR_MEMORY;
+    }
+}
+
+
+/* Collect a batch of connections not routed, from the first one of the work list: the
+ * next ones whose windows are more than aGap cells apart from the windows of the batch,
+ * and of the connections left for later batches, which keep their order.  Then search
+ * the paths of the batch on the threads of the process.
+ *
+ * The CURRENT_PAD cells of the pads of the whole batch are set before the searches
+ * start, and cleared once they are all done.
+ */
+static void searchBatch( BOARD* aPcb, boost::ptr_vector<ROUTE_SEARCH>& aWork,
+                         unsigned aFirst, int aMarge, int aGap,
+                         std::vector<ROUTE_SEARCH*>& aBatch )
+{
+    std::vector<ROUTE_SEARCH*> skipped;
+    unsigned maxCount = Pgm().GetThreadPool().GetThreadCount() * BATCH_SEARCHES_PER_THREAD;
+
+    for( unsigned ii = aFirst;
+         ii < aWork.size() && ii < aFirst + BATCH_LOOKAHEAD && aBatch.size() < maxCount; ii++ )
+    {
+        ROUTE_SEARCH* candidate = &aWork[ii];
+
+        if( candidate->m_Routed )
+            continue;
+
+        candidate->SetWindow( aMarge );
+
+        bool apart = true;
+
+        for( unsigned jj = 0; apart && jj < aBatch.size(); jj++ )
+            apart = !candidate->IsNear( *aBatch[jj], aGap );
+
+        for( unsigned jj = 0; apart && jj < skipped.size(); jj++ )
+            apart = !candidate->IsNear( *skipped[jj], aGap );
+
+        if( apart )
+            aBatch.push_back( candidate );
+        else
+            skipped.push_back( candidate );
+    }
+
+    if( aBatch.size() < 2 )
+        return;
+
+    boost::unordered_set<D_PAD*> batchPads;
+
+    for( unsigned ii = 0; ii < aBatch.size(); ii++ )
+    {
+        RATSNEST_ITEM* rat = aBatch[ii]->m_Ratsnest;
+
+        PlacePad( rat->m_PadStart, CURRENT_PAD, aMarge, WRITE_OR_CELL );
+        PlacePad( rat->m_PadEnd, CURRENT_PAD, aMarge, WRITE_OR_CELL );
+
+        batchPads.insert( rat->m_PadStart );
+        batchPads.insert( rat->m_PadEnd );
+    }
+
+    // Regenerates the remaining barriers (which may encroach on the
+    // placement bits precedent)
+    for( unsigned ii = 0; ii < aPcb->GetPadCount(); ii++ )
+    {
+        D_PAD* ptr = aPcb->GetPad( ii );
+
+        if( batchPads.find( ptr ) == batchPads.end() )
+            PlacePad( ptr, ~CURRENT_PAD, aMarge, WRITE_AND_CELL );
+    }
+
+    {
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned ii = 0; ii < aBatch.size(); ii++ )
+            tasks.Run( boost::bind( &searchInWindow, aPcb, aBatch[ii] ) );
+
+        tasks.Wait();
+    }
+
+    for( boost::unordered_set<D_PAD*>::iterator it = batchPads.begin();
+         it != batchPads.end(); ++it )
+    {
+        PlacePad( *it, ~CURRENT_PAD, aMarge, WRITE_AND_CELL );
+    }
+}
+
+
+/* Test if the board cells of the path found by a parallel search still have the values
+ * it read: the tracks created since for the previous connections are not on its way.
+ */
+static bool pathIsFree( const ROUTE_SEARCH& aSearch )
+{
+    for( unsigned ii = 0; ii < aSearch.m_PathCells.size(); ii++ )
+    {
+        const PATH_CELL& cell = aSearch.m_PathCells[ii];
+        MATRIX_CELL      now = RoutingMatrix.GetCell( cell.m_Row, cell.m_Col, cell.m_Side );
+
+        // the CURRENT_PAD bits of the batch are cleared once searched
+        if( ( now ^ cell.m_Cell ) & ~CURRENT_PAD )
+            return false;
+    }
+
+    return true;
+}
+
+
+/* Create the tracks of the path found by a parallel search.  Its direction maps are
+ * exchanged with the ones of RoutingMatrix, read by Retrace().
+ * Returns:
+ * SUCCESS if routed
+ * NOSUCCESS if the tracks could not be created
+ */
+static int commitRoute( PCB_EDIT_FRAME* pcbframe, wxDC* DC, ROUTE_SEARCH& aSearch )
+{
+    int result = SUCCESS;
+
+    for( int side = 0; side < MAX_ROUTING_LAYERS_COUNT; side++ )
+        RoutingMatrix.m_DirSide[side].Swap( aSearch.m_OwnDir[side] );
+
+    // Remove link.
+    GRSetDrawMode( DC, GR_XOR );
+    GRLine( pcbframe->GetCanvas()->GetClipBox(),
+            DC,
+            segm_oX,
+            segm_oY,
+            segm_fX,
+            segm_fY,
+            0,
+            WHITE );
+
+    // Generate trace.
+    if( !Retrace( pcbframe, DC, aSearch.m_RowSource, aSearch.m_ColSource,
+                  aSearch.m_RowTarget, aSearch.m_ColTarget, aSearch.m_TargetSide,
+                  aSearch.m_Ratsnest->GetNet() ) )
+    {
+        result = NOSUCCESS;
+    }
+
+    aSearch.ReleaseOwnMaps();
+
+    return result;
+}
+
+
 static long bit[8][9] =
 {
     // OT=Otherside
@@ -1338,6 +1818,7 @@ static void AddNewTrace( PCB_EDIT_FRAME* pcbframe, wxDC* DC )
         ITEM_PICKER picker( track, UR_NEW );
         s_ItemsListPicker.PushItem( picker );
         pcbframe->GetBoard()->m_Track.Insert( track, insertBeforeMe );
+        pcbframe->GetBoard()->OnItemAdded( track );
     }
 
     DrawTraces( panel, DC, firstTrack, newCount, GR_OR );
@@ -35,7 +35,9 @@
  */
 
 #include <algorithm>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 #include <fctsys.h>
 #include <convert_to_biu.h>
@@ -45,20 +47,31 @@
 #include <wxPcbStruct.h>
 #include <class_board.h>
 #include <class_module.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
 
-#include <rect_placement/rect_placement.h>
+#include <rect_placement/skyline_placement.h>
 
-struct TSubRect : public CRectPlacement::TRect
+struct TSubRect
 {
+    int x, y, w, h;
     int n;      // Original index of this subrect, before sorting
 
-    TSubRect() : TRect(),
-        n( 0 )
+    TSubRect() : x( 0 ), y( 0 ), w( 0 ), h( 0 ), n( 0 )
     {
     }
 
     TSubRect( int _w, int _h, int _n ) :
-        TRect( 0, 0, _w, _h ), n( _n ) { }
+        x( 0 ), y( 0 ), w( std::max( _w, 0 ) ), h( std::max( _h, 0 ) ), n( _n ) { }
+
+    // The skyline packing is the best with the higher rects first
+    static bool Higher( const TSubRect& a, const TSubRect& b )
+    {
+        if( a.h != b.h )
+            return a.h > b.h;
+
+        return a.w > b.w;
+    }
 };
 
 typedef std::vector<TSubRect> CSubRectArray;
@@ -94,60 +107,66 @@ void fillRectList( CSubRectArray& vecSubRects, std::vector <EDA_RECT>& aRectList
 
 
 
-// Spread a list of rectangles inside a placement area
-void spreadRectangles( CRectPlacement& aPlacementArea,
-                       CSubRectArray& vecSubRects,
-                       int areaSizeX, int areaSizeY )
+// Spread a list of rectangles inside a placement area of width areaSizeX, widened to
+// the widest rectangle, the height of the area being the height needed by the rectangles.
+// The size of the used area is returned in aPlacedSizeX, aPlacedSizeY.
+void spreadRectangles( CSubRectArray& vecSubRects, int areaSizeX,
+                       int* aPlacedSizeX, int* aPlacedSizeY )
 {
     areaSizeX/= scale;
-    areaSizeY/= scale;
 
-    // Sort the subRects based on dimensions, larger dimension goes first.
-    std::sort( vecSubRects.begin(), vecSubRects.end(), CRectPlacement::TRect::Greater );
+    // Sort the subRects based on dimensions, higher goes first.
+    std::stable_sort( vecSubRects.begin(), vecSubRects.end(), TSubRect::Higher );
+
+    for( unsigned ii = 0; ii < vecSubRects.size(); ii++ )
+        areaSizeX = std::max( areaSizeX, vecSubRects[ii].w );
 
-    // gives the initial size to the area
-    aPlacementArea.Init( areaSizeX, areaSizeY );
+    SKYLINE_PLACEMENT placementArea( areaSizeX );
 
-    // Add all subrects
-    CSubRectArray::iterator it;
-    for( it = vecSubRects.begin(); it != vecSubRects.end(); )
+    // Add all subrects.  When correctly placed in the placement area, the coords are
+    // returned in x and y
+    for( unsigned ii = 0; ii < vecSubRects.size(); ii++ )
     {
-        CRectPlacement::TRect r( 0, 0, it->w, it->h );
+        TSubRect& rect = vecSubRects[ii];
 
-        bool bPlaced = aPlacementArea.AddAtEmptySpotAutoGrow( &r, areaSizeX, areaSizeY );
+        placementArea.Add( rect.w, rect.h, &rect.x, &rect.y );
+    }
 
-        if( !bPlaced )   // No room to place the rectangle: enlarge area and retry
-        {
-            areaSizeX = ceil(areaSizeX * 1.1);
-            areaSizeY = ceil(areaSizeY * 1.1);
-            aPlacementArea.Init( areaSizeX, areaSizeY );
-            it = vecSubRects.begin();
-            continue;
-        }
+    *aPlacedSizeX = placementArea.GetW();
+    *aPlacedSizeY = placementArea.GetH();
+}
 
-        // When correctly placed in a placement area, the coords are returned in r.x and r.y
-        // Store them.
-        it->x   = r.x;
-        it->y   = r.y;
 
-        it++;
-    }
-}
+// The footprints of a sheet, placed together in their sheet placement area
+struct SHEET_FOOTPRINTS
+{
+    std::vector<MODULE*>    m_footprints;
+    double                  m_surface;      // the area of the footprints
+    CSubRectArray           m_placement;    // their position in the sheet area
+    EDA_RECT                m_sheetArea;    // the size of the sheet area, with a margin
+};
 
 
-void moveFootprintsInArea( CRectPlacement& aPlacementArea,
-                           std::vector <MODULE*>& aModuleList,
-                           EDA_RECT& aFreeArea,
-                           bool aFindAreaOnly )
+// Calculate the placement of the footprints of a sheet, a task of SpreadFootprints()
+static void placeSheetFootprints( SHEET_FOOTPRINTS* aSheet )
 {
-    CSubRectArray   vecSubRects;
+    int Xsize_allowed = (int) ( sqrt( aSheet->m_surface ) * 4.0 / 3.0 );
+    int placedX, placedY;
 
-    fillRectList( vecSubRects, aModuleList );
-    spreadRectangles( aPlacementArea, vecSubRects,
-                      aFreeArea.GetWidth(), aFreeArea.GetHeight() );
+    fillRectList( aSheet->m_placement, aSheet->m_footprints );
+    spreadRectangles( aSheet->m_placement, Xsize_allowed, &placedX, &placedY );
+
+    aSheet->m_sheetArea.SetWidth( placedX * scale );
+    aSheet->m_sheetArea.SetHeight( placedY * scale );
+
+    // Add a margin around the sheet placement area:
+    aSheet->m_sheetArea.Inflate( Millimeter2iu( 1.5 ) );
+}
 
-    if( aFindAreaOnly )
-        return;
+
+void moveFootprintsInArea( SHEET_FOOTPRINTS& aSheet, const wxPoint& aAreaOrigin )
+{
+    CSubRectArray& vecSubRects = aSheet.m_placement;
 
     for( unsigned it = 0; it < vecSubRects.size(); ++it )
     {
@@ -155,11 +174,11 @@ void moveFootprintsInArea( CRectPlacement& aPlacementArea,
         pos.x *= scale;
         pos.y *= scale;
 
-        MODULE * module = aModuleList[vecSubRects[it].n];
+        MODULE * module = aSheet.m_footprints[vecSubRects[it].n];
 
         EDA_RECT fpBBox = module->GetBoundingBox();
         wxPoint mod_pos = pos + ( module->GetPosition() - fpBBox.GetOrigin() )
-                          + aFreeArea.GetOrigin();
+                          + aAreaOrigin;
 
         module->Move( mod_pos - module->GetPosition() );
     }
@@ -229,11 +248,21 @@ void PCB_EDIT_FRAME::SpreadFootprints( std::vector<MODULE*>* aFootprints,
         undoList.PushItem( picker );
     }
 
-    // Extract and place footprints by sheet
-    std::vector <MODULE*> footprintListBySheet;
-    std::vector <EDA_RECT> placementSheetAreas;
-    double subsurface;
-    double placementsurface = 0.0;
+    // Extract footprints by sheet
+    boost::ptr_vector<SHEET_FOOTPRINTS> sheets;
+
+    for( unsigned ii = 0; ii < footprintList.size(); ii++ )
+    {
+        if( ii == 0 || footprintList[ii]->GetPath().BeforeLast( '/' ) !=
+                       footprintList[ii-1]->GetPath().BeforeLast( '/' ) )
+        {
+            sheets.push_back( new SHEET_FOOTPRINTS );
+            sheets.back().m_surface = 0.0;
+        }
+
+        sheets.back().m_footprints.push_back( footprintList[ii] );
+        sheets.back().m_surface += footprintList[ii]->GetArea();
+    }
 
     wxPoint placementAreaPosition = GetCrossHairPosition();
 
@@ -250,98 +279,43 @@ void PCB_EDIT_FRAME::SpreadFootprints( std::vector<MODULE*>* aFootprints,
         }
     }
 
-    // The placement uses 2 passes:
-    // the first pass creates the rectangular areas to place footprints
-    // each sheet in schematic creates one rectangular area.
-    // the second pass moves footprints inside these areas
-    MODULE* footprint;
-    for( int pass = 0; pass < 2; pass++ )
+    // The placement is made in 2 steps:
+    // the first one places the footprints of each sheet in schematic in a rectangular
+    // area, the sheets being placed independently on the threads of the process.
+    // the second one places these areas, and moves the footprints inside them
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+    for( unsigned ii = 0; ii < sheets.size(); ii++ )
+        tasks.Run( boost::bind( placeSheetFootprints, &sheets[ii] ) );
+
+    tasks.Wait();
+
+    std::vector <EDA_RECT> placementSheetAreas;
+    double placementsurface = 0.0;
+
+    for( unsigned ii = 0; ii < sheets.size(); ii++ )
     {
-        int subareaIdx = 0;
-        footprintListBySheet.clear();
-        subsurface = 0.0;
+        const EDA_RECT& sub_area = sheets[ii].m_sheetArea;
 
-        for( unsigned ii = 0; ii < footprintList.size(); ii++ )
-        {
-            footprint = footprintList[ii];
-            bool islastItem = false;
-
-            if( ii == footprintList.size() - 1 ||
-                ( footprintList[ii]->GetPath().BeforeLast( '/' ) !=
-                  footprintList[ii+1]->GetPath().BeforeLast( '/' ) ) )
-                islastItem = true;
-
-            footprintListBySheet.push_back( footprint );
-            subsurface += footprint->GetArea();
-
-            if( islastItem )
-            {
-                // end of the footprint sublist relative to the same sheet path
-                // calculate placement of the current sublist
-                EDA_RECT freeArea;
-                int Xsize_allowed = (int) ( sqrt( subsurface ) * 4.0 / 3.0 );
-                int Ysize_allowed = (int) ( subsurface / Xsize_allowed );
-
-                freeArea.SetWidth( Xsize_allowed );
-                freeArea.SetHeight( Ysize_allowed );
-                CRectPlacement placementArea;
-
-                if( pass == 1 )
-                {
-                    wxPoint areapos = placementSheetAreas[subareaIdx].GetOrigin()
-                                      + placementAreaPosition;
-                    freeArea.SetOrigin( areapos );
-                }
-
-                bool findAreaOnly = pass == 0;
-                moveFootprintsInArea( placementArea, footprintListBySheet,
-                                      freeArea, findAreaOnly );
-
-                if( pass == 0 )
-                {
-                    // Populate sheet placement areas list
-                    EDA_RECT sub_area;
-                    sub_area.SetWidth( placementArea.GetW()*scale );
-                    sub_area.SetHeight( placementArea.GetH()*scale );
-                    // Add a margin around the sheet placement area:
-                    sub_area.Inflate( Millimeter2iu( 1.5 ) );
-
-                    placementSheetAreas.push_back( sub_area );
-
-                    placementsurface += (double) sub_area.GetWidth()*
-                                        sub_area.GetHeight();
-                }
-
-                // Prepare buffers for next sheet
-                subsurface  = 0.0;
-                footprintListBySheet.clear();
-                subareaIdx++;
-            }
-        }
+        placementSheetAreas.push_back( sub_area );
+        placementsurface += (double) sub_area.GetWidth()*
+                            sub_area.GetHeight();
+    }
 
-        // End of pass:
-        // At the end of the first pass, we have to find position of each sheet
-        // placement area
-        if( pass == 0 )
-        {
-            int Xsize_allowed = (int) ( sqrt( placementsurface ) * 4.0 / 3.0 );
-            int Ysize_allowed = (int) ( placementsurface / Xsize_allowed );
-            CRectPlacement placementArea;
-            CSubRectArray  vecSubRects;
-
-            fillRectList( vecSubRects, placementSheetAreas );
-            spreadRectangles( placementArea, vecSubRects, Xsize_allowed, Ysize_allowed );
-
-            for( unsigned it = 0; it < vecSubRects.size(); ++it )
-            {
-                TSubRect& srect = vecSubRects[it];
-                wxPoint pos( srect.x*scale, srect.y*scale );
-                wxSize size( srect.w*scale, srect.h*scale );
-                placementSheetAreas[srect.n].SetOrigin( pos );
-                placementSheetAreas[srect.n].SetSize( size );
-            }
-        }
-    }   // End pass
+    int Xsize_allowed = (int) ( sqrt( placementsurface ) * 4.0 / 3.0 );
+    int placedX, placedY;
+    CSubRectArray  vecSubRects;
+
+    fillRectList( vecSubRects, placementSheetAreas );
+    spreadRectangles( vecSubRects, Xsize_allowed, &placedX, &placedY );
+
+    for( unsigned it = 0; it < vecSubRects.size(); ++it )
+    {
+        TSubRect& srect = vecSubRects[it];
+        wxPoint pos( srect.x*scale, srect.y*scale );
+
+        moveFootprintsInArea( sheets[srect.n], pos + placementAreaPosition );
+    }
 
     // Undo: commit list
     SaveCopyInUndoList( undoList, UR_CHANGED );
@@ -43,6 +43,7 @@
 
 #include <pcbnew.h>
 #include <fp_lib_table.h>
+#include <footprint_info.h>
 #include <pcbnew_id.h>
 #include <class_board.h>
 #include <class_track.h>
@@ -164,6 +165,24 @@ FP_LIB_TABLE* PROJECT::PcbFootprintLibs()
 }
 
 
+boost::shared_ptr<FOOTPRINT_LIST> PROJECT::PcbFootprintList()
+{
+    SHARED_FOOTPRINT_LIST* list = (SHARED_FOOTPRINT_LIST*) GetElem( ELEM_FPLIST );
+
+    // its gotta be NULL or a SHARED_FOOTPRINT_LIST, or a bug.
+    wxASSERT( !list || dynamic_cast<SHARED_FOOTPRINT_LIST*>( list ) );
+
+    if( !list )
+    {
+        list = new SHARED_FOOTPRINT_LIST;
+
+        SetElem( ELEM_FPLIST, list );
+    }
+
+    return list->Get( PcbFootprintLibs() );
+}
+
+
 void PCB_BASE_FRAME::SetBoard( BOARD* aBoard )
 {
     if( m_Pcb != aBoard )
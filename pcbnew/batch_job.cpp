@@ -0,0 +1,537 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file pcbnew/batch_job.cpp
+ * @brief The command line job of Pcbnew: the fabrication outputs of a board without GUI.
+ *
+ * pcbnew --batch job_file [board_file]
+ *
+ * The job file is read like a project file: "key=value" lines in [groups].  The top
+ * level keys give the board, unless it is on the command line, and the output
+ * directory, both relative to the job file.  The output directory of the plot
+ * settings of the board is used by default.
+ *
+ *      Board=board.kicad_pcb
+ *      OutputDirectory=fab
+ *
+ * Each group enables one exporter, with its options:
+ *
+ *      [Gerber]
+ *      Layers=F.Cu,B.Cu,F.Mask,B.Mask,F.SilkS,B.SilkS,Edge.Cuts
+ *      ProtelExtensions=1
+ *      Optimize=1
+ *      [Pdf]
+ *      Layers=F.Fab,B.Fab
+ *      [Drill]
+ *      Metric=1
+ *      MergePTHNPTH=0
+ *      AuxOrigin=0
+ *      Map=1
+ *      OptimizePaths=0
+ *      [Position]
+ *      Metric=1
+ *      CSV=0
+ *      [D356]
+ *
+ * The plots use the plot settings of the board, and its plotted layers when there
+ * is no Layers key.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <fctsys.h>
+#include <common.h>
+#include <macros.h>
+#include <profile.h>
+#include <reporter.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
+#include <plot_common.h>
+#include <wildcards_and_files_ext.h>
+#include <wxPcbStruct.h>
+
+#include <class_board.h>
+#include <pcbplot.h>
+#include <gendrill_Excellon_writer.h>
+
+#include <wx/fileconf.h>
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+
+// The exit status of the job
+#define BATCH_OK            0
+#define BATCH_FAILED        1
+
+// The sides of DoGenFootprintsPositionFile()
+#define POSITION_BACK_SIDE  0
+#define POSITION_FRONT_SIDE 1
+
+
+/// One exporter of the job, run as a task of the thread pool
+struct BATCH_EXPORTER
+{
+    const char*                             m_Name;
+    boost::function<bool ( REPORTER& )>     m_Export;
+    wxString                                m_Messages;
+    bool                                    m_Ok;
+    double                                  m_Msecs;
+};
+
+
+static void batchUsage()
+{
+    fprintf( stderr, "usage: pcbnew --batch <job file> [<board.kicad_pcb>]\n" );
+}
+
+
+static void printTiming( const char* aName, double aMsecs )
+{
+    printf( "%-12s %10.1f ms\n", aName, aMsecs );
+    fflush( stdout );
+}
+
+
+static void runExporter( BATCH_EXPORTER* aExporter )
+{
+    WX_STRING_REPORTER  reporter( &aExporter->m_Messages );
+    prof_counter        counter;
+
+    prof_start( &counter );
+    aExporter->m_Ok = aExporter->m_Export( reporter );
+    prof_end( &counter );
+
+    aExporter->m_Msecs = counter.msecs();
+}
+
+
+static bool plotLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                        std::vector<PLOT_LAYER_JOB>* aJobs, REPORTER& aReporter )
+{
+    bool     ok = PlotBoardLayers( aBoard, aPlotOpts, *aJobs, wxEmptyString );
+    wxString msg;
+
+    for( unsigned ii = 0; ii < aJobs->size(); ii++ )
+    {
+        if( (*aJobs)[ii].m_Plotted )
+            msg.Printf( _( "Plot file '%s' created.\n" ), GetChars( (*aJobs)[ii].m_FileName ) );
+        else
+            msg.Printf( _( "Unable to create file '%s'.\n" ),
+                        GetChars( (*aJobs)[ii].m_FileName ) );
+
+        aReporter.Report( msg );
+    }
+
+    return ok;
+}
+
+
+static bool createDrillFiles( EXCELLON_WRITER* aWriter, const wxString& aDirectory,
+                              bool aGenMap, REPORTER& aReporter )
+{
+    return aWriter->CreateDrillandMapFilesSet( aDirectory, true, aGenMap, &aReporter );
+}
+
+
+static bool createPositionFiles( PCB_EDIT_FRAME* aFrame, const wxString& aFrontFile,
+                                 const wxString& aBackFile, bool aMetric, bool aCSV,
+                                 REPORTER& aReporter )
+{
+    const wxString* files[2] = { &aFrontFile, &aBackFile };
+    int             sides[2] = { POSITION_FRONT_SIDE, POSITION_BACK_SIDE };
+    wxString        msg;
+
+    for( int ii = 0; ii < 2; ii++ )
+    {
+        if( aFrame->DoGenFootprintsPositionFile( *files[ii], aMetric, false, sides[ii],
+                                                 aCSV ) < 0 )
+        {
+            msg.Printf( _( "Unable to create '%s'.\n" ), GetChars( *files[ii] ) );
+            aReporter.Report( msg );
+            return false;
+        }
+
+        msg.Printf( _( "Place file: '%s'.\n" ), GetChars( *files[ii] ) );
+        aReporter.Report( msg );
+    }
+
+    return true;
+}
+
+
+static bool createD356File( PCB_EDIT_FRAME* aFrame, const wxString& aFile,
+                            REPORTER& aReporter )
+{
+    wxString msg;
+    bool     ok = aFrame->DoGenD356File( aFile );
+
+    if( ok )
+        msg.Printf( _( "Create file %s\n" ), GetChars( aFile ) );
+    else
+        msg.Printf( _( "Unable to create %s\n" ), GetChars( aFile ) );
+
+    aReporter.Report( msg );
+
+    return ok;
+}
+
+
+/**
+ * Function readLayers
+ * reads the layer names of the key Layers of the current group of the job file to
+ * @a aLayers, which is left unchanged without this key.
+ * @return false if a layer name is not a layer of the board
+ */
+static bool readLayers( wxFileConfig& aJob, BOARD* aBoard, LSET* aLayers )
+{
+    wxString names;
+
+    if( !aJob.Read( wxT( "Layers" ), &names ) )
+        return true;
+
+    wxStringTokenizer tokens( names, wxT( ",;" ) );
+
+    aLayers->reset();
+
+    while( tokens.HasMoreTokens() )
+    {
+        wxString name = tokens.GetNextToken().Trim().Trim( false );
+        LAYER_ID layer = aBoard->GetLayerID( name );
+
+        if( layer == UNDEFINED_LAYER )
+        {
+            fprintf( stderr, "%s\n", TO_UTF8( wxString::Format( _( "Unknown layer '%s'" ),
+                                                                 GetChars( name ) ) ) );
+            return false;
+        }
+
+        aLayers->set( layer );
+    }
+
+    return true;
+}
+
+
+// The plot files of aLayers, named like the plot dialog names them
+static void buildPlotJobs( BOARD* aBoard, const PCB_PLOT_PARAMS& aPlotOpts,
+                           const wxString& aDirectory, LSET aLayers,
+                           std::vector<PLOT_LAYER_JOB>& aJobs )
+{
+    wxString file_ext( GetDefaultPlotExtension( aPlotOpts.GetFormat() ) );
+
+    for( LSEQ seq = aLayers.UIOrder();  seq;  ++seq )
+    {
+        LAYER_ID layer = *seq;
+
+        // The disabled copper layers are skipped, like in the plot dialog
+        if( ( LSET::AllCuMask() & ~aBoard->GetEnabledLayers() )[layer] )
+            continue;
+
+        wxFileName fn( aBoard->GetFileName() );
+
+        if( aPlotOpts.GetFormat() == PLOT_FORMAT_GERBER
+            && aPlotOpts.GetUseGerberProtelExtensions() )
+            file_ext = GetGerberProtelExtension( layer );
+
+        BuildPlotFileName( &fn, aDirectory, aBoard->GetLayerName( layer ), file_ext );
+
+        PLOT_LAYER_JOB job;
+
+        job.m_Layer = layer;
+        job.m_FileName = fn.GetFullPath();
+        job.m_Plotted = false;
+        aJobs.push_back( job );
+    }
+}
+
+
+static wxString jobPath( const wxString& aPath, const wxFileName& aJobFile )
+{
+    wxFileName fn( aPath );
+
+    fn.MakeAbsolute( aJobFile.GetPath() );
+
+    return fn.GetFullPath();
+}
+
+
+int PCB_EDIT_FRAME::RunBatchJob( const std::vector<wxString>& aArgs )
+{
+    if( aArgs.empty() || aArgs.size() > 2 )
+    {
+        batchUsage();
+        return BATCH_FAILED;
+    }
+
+    wxFileName jobFn( aArgs[0] );
+
+    jobFn.MakeAbsolute();
+
+    if( !jobFn.FileExists() )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( wxString::Format( _( "File '%s' not found" ),
+                                                             GetChars( jobFn.GetFullPath() ) ) ) );
+        return BATCH_FAILED;
+    }
+
+    wxFileConfig job( wxEmptyString, wxEmptyString, wxEmptyString, jobFn.GetFullPath(),
+                      wxCONFIG_USE_LOCAL_FILE );
+    wxString     boardFile;
+    wxString     outputPath;
+
+    // The board of the command line is relative to the working directory
+    if( aArgs.size() == 2 )
+    {
+        wxFileName fn( aArgs[1] );
+        fn.MakeAbsolute();
+        boardFile = fn.GetFullPath();
+    }
+    else if( job.Read( wxT( "Board" ), &boardFile ) )
+    {
+        boardFile = jobPath( boardFile, jobFn );
+    }
+    else
+    {
+        batchUsage();
+        return BATCH_FAILED;
+    }
+
+    prof_counter counter;
+    prof_counter total;
+
+    prof_start( &total );
+
+    // A missing board is not created by OpenProjectFiles(): IsOK() answers no in
+    // batch mode
+    prof_start( &counter );
+    bool loaded = OpenProjectFiles( std::vector<wxString>( 1, boardFile ) );
+    prof_end( &counter );
+    printTiming( "load", counter.msecs() );
+
+    if( !loaded )
+        return BATCH_FAILED;
+
+    BOARD*          board = GetBoard();
+    PCB_PLOT_PARAMS plotOpts = board->GetPlotOptions();
+    wxFileName      outputDir;
+    wxString        messages;
+    WX_STRING_REPORTER reporter( &messages );
+    bool            dirOk;
+
+    // Create the output directory if it does not exist, relative to the job file or
+    // else to the board, like the plot dialog does
+    if( job.Read( wxT( "OutputDirectory" ), &outputPath ) )
+    {
+        outputDir = wxFileName::DirName( outputPath );
+        dirOk = EnsureFileDirectoryExists( &outputDir, jobFn.GetFullPath(), &reporter );
+    }
+    else
+    {
+        outputDir = wxFileName::DirName( plotOpts.GetOutputDirectory() );
+        dirOk = EnsureFileDirectoryExists( &outputDir, board->GetFileName(), &reporter );
+    }
+
+    if( !messages.IsEmpty() )
+        fprintf( stderr, "%s\n", TO_UTF8( messages ) );
+
+    if( !dirOk )
+        return BATCH_FAILED;
+
+    wxString directory = outputDir.GetPath();
+
+    // The filled areas saved in the board file can be outdated, like in the plot dialog
+    prof_start( &counter );
+    Fill_All_Zones( NULL, false, true );
+    prof_end( &counter );
+    printTiming( "zones", counter.msecs() );
+
+    // Each exporter only reads the board: they all run concurrently
+    std::vector<BATCH_EXPORTER>  exporters;
+    BATCH_EXPORTER               exporter;
+
+    exporter.m_Ok = false;
+    exporter.m_Msecs = 0.0;
+
+    // The data of the exporters, which must live until they are done
+    PCB_PLOT_PARAMS              gerberOpts = plotOpts;
+    PCB_PLOT_PARAMS              pdfOpts = plotOpts;
+    std::vector<PLOT_LAYER_JOB>  gerberJobs;
+    std::vector<PLOT_LAYER_JOB>  pdfJobs;
+    EXCELLON_WRITER              drillWriter( board );
+
+    plotOpts.SetAutoScale( false );
+    plotOpts.SetScale( 1 );
+
+    if( job.HasGroup( wxT( "/Gerber" ) ) )
+    {
+        LSET layers = plotOpts.GetLayerSelection();
+        bool protel;
+        bool optimize;
+
+        job.SetPath( wxT( "/Gerber" ) );
+        job.Read( wxT( "ProtelExtensions" ), &protel, plotOpts.GetUseGerberProtelExtensions() );
+        job.Read( wxT( "Optimize" ), &optimize, plotOpts.GetUseGerberOptimization() );
+
+        if( !readLayers( job, board, &layers ) )
+            return BATCH_FAILED;
+
+        gerberOpts = plotOpts;
+        gerberOpts.SetFormat( PLOT_FORMAT_GERBER );
+        gerberOpts.SetUseGerberProtelExtensions( protel );
+        gerberOpts.SetUseGerberOptimization( optimize );
+        buildPlotJobs( board, gerberOpts, directory, layers, gerberJobs );
+
+        exporter.m_Name = "gerber";
+        exporter.m_Export = boost::bind( plotLayers, board, &gerberOpts, &gerberJobs, _1 );
+        exporters.push_back( exporter );
+    }
+
+    if( job.HasGroup( wxT( "/Pdf" ) ) )
+    {
+        LSET layers = plotOpts.GetLayerSelection();
+
+        job.SetPath( wxT( "/Pdf" ) );
+
+        if( !readLayers( job, board, &layers ) )
+            return BATCH_FAILED;
+
+        pdfOpts = plotOpts;
+        pdfOpts.SetFormat( PLOT_FORMAT_PDF );
+        buildPlotJobs( board, pdfOpts, directory, layers, pdfJobs );
+
+        exporter.m_Name = "pdf";
+        exporter.m_Export = boost::bind( plotLayers, board, &pdfOpts, &pdfJobs, _1 );
+        exporters.push_back( exporter );
+    }
+
+    if( job.HasGroup( wxT( "/Drill" ) ) )
+    {
+        bool metric, merge, auxOrigin, map, optimize;
+
+        job.SetPath( wxT( "/Drill" ) );
+        job.Read( wxT( "Metric" ), &metric, true );
+        job.Read( wxT( "MergePTHNPTH" ), &merge, false );
+        job.Read( wxT( "AuxOrigin" ), &auxOrigin, false );
+        job.Read( wxT( "Map" ), &map, false );
+        job.Read( wxT( "OptimizePaths" ), &optimize, false );
+
+        // The default format of the drill dialog
+        drillWriter.SetFormat( metric, EXCELLON_WRITER::DECIMAL_FORMAT );
+        drillWriter.SetOptions( false, false, auxOrigin ? GetAuxOrigin() : wxPoint( 0, 0 ),
+                                merge );
+        drillWriter.SetOptimizeToolPaths( optimize );
+        drillWriter.SetMapFileFormat( PLOT_FORMAT_PDF );
+
+        exporter.m_Name = "drill";
+        exporter.m_Export = boost::bind( createDrillFiles, &drillWriter, directory, map, _1 );
+        exporters.push_back( exporter );
+    }
+
+    if( job.HasGroup( wxT( "/Position" ) ) )
+    {
+        bool metric, csv;
+
+        job.SetPath( wxT( "/Position" ) );
+        job.Read( wxT( "Metric" ), &metric, true );
+        job.Read( wxT( "CSV" ), &csv, false );
+
+        wxFileName front( board->GetFileName() );
+        wxFileName back( board->GetFileName() );
+
+        front.SetPath( directory );
+        back.SetPath( directory );
+
+        // Named like the files of the footprint position dialog
+        if( csv )
+        {
+            front.SetName( front.GetName() + wxT( "-top-" ) + FootprintPlaceFileExtension );
+            back.SetName( back.GetName() + wxT( "-bottom-" ) + FootprintPlaceFileExtension );
+            front.SetExt( wxT( "csv" ) );
+            back.SetExt( wxT( "csv" ) );
+        }
+        else
+        {
+            front.SetName( front.GetName() + wxT( "-top" ) );
+            back.SetName( back.GetName() + wxT( "-bottom" ) );
+            front.SetExt( FootprintPlaceFileExtension );
+            back.SetExt( FootprintPlaceFileExtension );
+        }
+
+        exporter.m_Name = "position";
+        exporter.m_Export = boost::bind( createPositionFiles, this, front.GetFullPath(),
+                                         back.GetFullPath(), metric, csv, _1 );
+        exporters.push_back( exporter );
+    }
+
+    if( job.HasGroup( wxT( "/D356" ) ) )
+    {
+        wxFileName fn( board->GetFileName() );
+
+        fn.SetPath( directory );
+        fn.SetExt( wxT( "d356" ) );
+
+        exporter.m_Name = "d356";
+        exporter.m_Export = boost::bind( createD356File, this, fn.GetFullPath(), _1 );
+        exporters.push_back( exporter );
+    }
+
+    {
+        // The exporters and their C locale are set once, for all the threads
+        LOCALE_IO  toggle;
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned ii = 0; ii < exporters.size(); ii++ )
+            tasks.Run( boost::bind( runExporter, &exporters[ii] ) );
+
+        tasks.Wait();
+    }
+
+    int status = BATCH_OK;
+
+    for( unsigned ii = 0; ii < exporters.size(); ii++ )
+    {
+        if( !exporters[ii].m_Messages.IsEmpty() )
+            printf( "%s", TO_UTF8( exporters[ii].m_Messages ) );
+
+        printTiming( exporters[ii].m_Name, exporters[ii].m_Msecs );
+
+        if( !exporters[ii].m_Ok )
+        {
+            wxString name = FROM_UTF8( exporters[ii].m_Name );
+
+            fprintf( stderr, "%s\n", TO_UTF8( wxString::Format( _( "The %s export failed" ),
+                                                                 GetChars( name ) ) ) );
+            status = BATCH_FAILED;
+        }
+    }
+
+    prof_end( &total );
+    printTiming( "total", total.msecs() );
+
+    return status;
+}
@@ -0,0 +1,466 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+    A benchmark of the batch operations of Pcbnew on a set of boards, to measure the
+    gain of an optimization and catch the regressions:
+
+        board_bench [--repeat N] [--json results.json] [--synthetic TRACKS]... [board.kicad_pcb]...
+
+    Each phase runs N times (3 by default) on each board, and its minimum and median
+    times are reported, the median being the one to compare between runs.  The board
+    files are read with the s-expression plugin; --synthetic adds a generated board of
+    about TRACKS tracks and vias, with a ground zone under them.
+
+    The phases are the loading (PCB_PARSER), the formatting (PCB_IO::Format), the
+    ratsnest (RN_DATA::ProcessBoard), the zone fill, the union and fracturing of the
+    filled areas (SHAPE_POLY_SET), the DRC and the Gerber plot of the copper layers.
+    The router has its own benchmark, pns_replay_bench.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <wx/init.h>
+#include <wx/filename.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <pgm_base.h>
+#include <profile.h>
+#include <richio.h>
+#include <convert_to_biu.h>
+#include <io_mgr.h>
+#include <kicad_plugin.h>
+#include <plot_common.h>
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <class_netinfo.h>
+#include <ratsnest_data.h>
+#include <drc_stuff.h>
+#include <pcbplot.h>
+#include <geometry/shape_poly_set.h>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+
+/// The process of the benchmark, for the thread pool of the plots
+struct BENCH_PGM : public PGM_BASE
+{
+    bool OnPgmInit( wxApp* aWxApp )                 { return true; }
+    void OnPgmExit()                                {}
+    void MacOpenFile( const wxString& aFileName )   {}
+};
+
+
+PGM_BASE& Pgm()
+{
+    static BENCH_PGM program;
+
+    return program;
+}
+
+
+/// The times of a phase, in milliseconds
+struct BENCH_PHASE
+{
+    const char*         m_Name;
+    std::vector<double> m_Msecs;
+
+    double Min() const
+    {
+        return *std::min_element( m_Msecs.begin(), m_Msecs.end() );
+    }
+
+    double Median() const
+    {
+        std::vector<double> sorted = m_Msecs;
+
+        std::sort( sorted.begin(), sorted.end() );
+
+        return sorted[sorted.size() / 2];
+    }
+};
+
+
+struct BENCH_BOARD
+{
+    std::string                 m_Name;
+    int                         m_Tracks;
+    int                         m_Zones;
+    std::vector<BENCH_PHASE>    m_Phases;
+};
+
+
+static void usage( const char* aProgram )
+{
+    fprintf( stderr, "usage: %s [--repeat N] [--json results.json] [--synthetic TRACKS]... "
+                     "[board.kicad_pcb]...\n", aProgram );
+}
+
+
+/**
+ * Function makeSyntheticBoard
+ * creates a 2 layer board of parallel nets of aTracks segments and vias in total,
+ * alternating between the copper layers, above a ground zone filling the back layer.
+ */
+static BOARD* makeSyntheticBoard( int aTracks )
+{
+    const int pitch = Millimeter2iu( 0.5 );
+    const int segmentLength = Millimeter2iu( 2.0 );
+    const int segmentsPerNet = 20;
+    int       netCount = std::max( aTracks / segmentsPerNet, 1 );
+
+    BOARD* board = new BOARD;
+    NETINFO_ITEM* gnd = new NETINFO_ITEM( board, wxT( "GND" ) );
+
+    board->AppendNet( gnd );
+
+    for( int n = 0; n < netCount; n++ )
+    {
+        NETINFO_ITEM* net = new NETINFO_ITEM( board, wxString::Format( wxT( "N%d" ), n ) );
+
+        board->AppendNet( net );
+
+        int y = n * pitch;
+
+        for( int s = 0; s < segmentsPerNet; s++ )
+        {
+            wxPoint start( s * segmentLength, y );
+            wxPoint end( ( s + 1 ) * segmentLength, y );
+            TRACK*  track = new TRACK( board );
+
+            track->SetStart( start );
+            track->SetEnd( end );
+            track->SetWidth( Millimeter2iu( 0.2 ) );
+            track->SetLayer( s % 2 ? B_Cu : F_Cu );
+            track->SetNetCode( net->GetNet() );
+            board->Add( track );
+
+            if( s > 0 )
+            {
+                VIA* via = new VIA( board );
+
+                via->SetPosition( start );
+                via->SetWidth( Millimeter2iu( 0.45 ) );
+                via->SetDrill( Millimeter2iu( 0.2 ) );
+                via->SetViaType( VIA_THROUGH );
+                via->SetLayerPair( F_Cu, B_Cu );
+                via->SetNetCode( net->GetNet() );
+                board->Add( via );
+            }
+        }
+    }
+
+    int margin = Millimeter2iu( 2.0 );
+    int width = segmentsPerNet * segmentLength;
+    int height = netCount * pitch;
+    std::vector<wxPoint> corners;
+
+    corners.push_back( wxPoint( -margin, -margin ) );
+    corners.push_back( wxPoint( width + margin, -margin ) );
+    corners.push_back( wxPoint( width + margin, height + margin ) );
+    corners.push_back( wxPoint( -margin, height + margin ) );
+
+    ZONE_CONTAINER* zone = new ZONE_CONTAINER( board );
+
+    zone->SetLayer( B_Cu );
+    zone->SetNetCode( gnd->GetNet() );
+    zone->AddPolygon( corners );
+    zone->Outline()->SetHatch( CPolyLine::NO_HATCH, 0, true );
+    board->Add( zone );
+
+    return board;
+}
+
+
+static BOARD* loadBoard( const std::string& aFileName )
+{
+    try
+    {
+        return IO_MGR::Load( IO_MGR::KICAD, wxString::FromUTF8( aFileName.c_str() ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( ioe.errorText ) );
+        return NULL;
+    }
+}
+
+
+// The load phase: the board is loaded again to be measured by the other phases
+static void loadAndDelete( const std::string& aFileName, bool* aOk )
+{
+    BOARD* board = loadBoard( aFileName );
+
+    *aOk = board != NULL;
+    delete board;
+}
+
+
+static void formatBoard( BOARD* aBoard )
+{
+    STRING_FORMATTER formatter;
+    PCB_IO           io;
+    LOCALE_IO        toggle;
+
+    io.SetOutputFormatter( &formatter );
+    io.Format( aBoard );
+}
+
+
+static void fillZones( BOARD* aBoard )
+{
+    BOARD::ZONE_CONTAINERS zones;
+
+    for( int ii = 0; ii < aBoard->GetAreaCount(); ii++ )
+        zones.push_back( aBoard->GetArea( ii ) );
+
+    aBoard->FillZones( zones );
+}
+
+
+// The union of the filled areas of each copper layer, fractured as for the plots
+static void mergeFilledAreas( BOARD* aBoard )
+{
+    for( LSEQ seq = LSET::AllCuMask().Seq();  seq;  ++seq )
+    {
+        SHAPE_POLY_SET merged;
+
+        for( int ii = 0; ii < aBoard->GetAreaCount(); ii++ )
+        {
+            ZONE_CONTAINER* zone = aBoard->GetArea( ii );
+
+            if( zone->GetLayer() == *seq )
+                merged.BooleanAdd( zone->GetFilledPolysList(), SHAPE_POLY_SET::PM_FAST );
+        }
+
+        merged.Fracture( SHAPE_POLY_SET::PM_FAST );
+    }
+}
+
+
+static void runDrc( BOARD* aBoard )
+{
+    DRC drc( aBoard );
+
+    aBoard->DeleteMARKERs();
+    drc.RunTests();
+}
+
+
+static void plotCopperLayers( BOARD* aBoard, const wxString& aDirectory )
+{
+    PCB_PLOT_PARAMS             plotOpts = aBoard->GetPlotOptions();
+    std::vector<PLOT_LAYER_JOB> jobs;
+
+    plotOpts.SetFormat( PLOT_FORMAT_GERBER );
+
+    for( LSEQ seq = aBoard->GetEnabledLayers().CuStack();  seq;  ++seq )
+    {
+        PLOT_LAYER_JOB job;
+        wxFileName     fn( aDirectory, aBoard->GetLayerName( *seq ), wxT( "gbr" ) );
+
+        job.m_Layer = *seq;
+        job.m_FileName = fn.GetFullPath();
+        job.m_Plotted = false;
+        jobs.push_back( job );
+    }
+
+    PlotBoardLayers( aBoard, &plotOpts, jobs, wxEmptyString );
+}
+
+
+// Adds the times of aRepeat runs of aPhase to the results of a board
+static void measure( BENCH_BOARD& aResults, const char* aName, int aRepeat,
+                     const boost::function<void ()>& aPhase )
+{
+    BENCH_PHASE  phase;
+    prof_counter counter;
+
+    phase.m_Name = aName;
+
+    for( int i = 0; i < aRepeat; i++ )
+    {
+        prof_start( &counter );
+        aPhase();
+        prof_end( &counter );
+
+        phase.m_Msecs.push_back( counter.msecs() );
+    }
+
+    printf( "%-24s %-12s %10.1f ms (min %.1f ms)\n", aResults.m_Name.c_str(), aName,
+            phase.Median(), phase.Min() );
+    fflush( stdout );
+
+    aResults.m_Phases.push_back( phase );
+}
+
+
+static void benchBoard( BOARD* aBoard, BENCH_BOARD& aResults, int aRepeat,
+                        const wxString& aPlotDirectory )
+{
+    aResults.m_Tracks = aBoard->m_Track.GetCount();
+    aResults.m_Zones = aBoard->GetAreaCount();
+
+    measure( aResults, "save", aRepeat, boost::bind( formatBoard, aBoard ) );
+    measure( aResults, "ratsnest", aRepeat, boost::bind( &RN_DATA::ProcessBoard,
+                                                         aBoard->GetRatsnest() ) );
+    measure( aResults, "zone_fill", aRepeat, boost::bind( fillZones, aBoard ) );
+    measure( aResults, "polygons", aRepeat, boost::bind( mergeFilledAreas, aBoard ) );
+    measure( aResults, "drc", aRepeat, boost::bind( runDrc, aBoard ) );
+    measure( aResults, "plot_gerber", aRepeat, boost::bind( plotCopperLayers, aBoard,
+                                                            aPlotDirectory ) );
+}
+
+
+static bool writeJson( const char* aFileName, const std::vector<BENCH_BOARD>& aBoards,
+                       int aRepeat )
+{
+    FILE* file = fopen( aFileName, "w" );
+
+    if( !file )
+        return false;
+
+    fprintf( file, "{\n  \"repeat\": %d,\n  \"boards\": [", aRepeat );
+
+    for( unsigned i = 0; i < aBoards.size(); i++ )
+    {
+        const BENCH_BOARD& board = aBoards[i];
+
+        fprintf( file, "%s\n    { \"board\": \"%s\", \"tracks\": %d, \"zones\": %d,\n"
+                       "      \"phases_ms\": {", i ? "," : "", board.m_Name.c_str(),
+                 board.m_Tracks, board.m_Zones );
+
+        for( unsigned j = 0; j < board.m_Phases.size(); j++ )
+        {
+            const BENCH_PHASE& phase = board.m_Phases[j];
+
+            fprintf( file, "%s\n        \"%s\": { \"median\": %.2f, \"min\": %.2f }",
+                     j ? "," : "", phase.m_Name, phase.Median(), phase.Min() );
+        }
+
+        fprintf( file, "\n      } }" );
+    }
+
+    fprintf( file, "\n  ]\n}\n" );
+
+    return fclose( file ) == 0;
+}
+
+
+int main( int argc, char** argv )
+{
+    wxInitializer initializer( argc, argv );
+
+    int                      repeat = 3;
+    const char*              jsonFile = NULL;
+    std::vector<std::string> files;
+    std::vector<int>         synthetic;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        bool        hasValue = i + 1 < argc;
+
+        if( arg == "--repeat" && hasValue )
+            repeat = std::max( atoi( argv[++i] ), 1 );
+        else if( arg == "--json" && hasValue )
+            jsonFile = argv[++i];
+        else if( arg == "--synthetic" && hasValue )
+            synthetic.push_back( std::max( atoi( argv[++i] ), 1 ) );
+        else if( arg.compare( 0, 2, "--" ) != 0 )
+            files.push_back( arg );
+        else
+        {
+            usage( argv[0] );
+            return 1;
+        }
+    }
+
+    if( files.empty() && synthetic.empty() )
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    // The plots are written to a directory of their own, not kept
+    wxFileName plotDir = wxFileName::DirName( wxFileName::GetTempDir() );
+
+    plotDir.AppendDir( wxT( "board_bench" ) );
+    plotDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+    std::vector<BENCH_BOARD> results;
+    bool                     ok = true;
+
+    for( unsigned i = 0; i < synthetic.size(); i++ )
+    {
+        BENCH_BOARD board;
+        char        name[32];
+
+        snprintf( name, sizeof( name ), "synthetic-%d", synthetic[i] );
+        board.m_Name = name;
+
+        BOARD* pcb = makeSyntheticBoard( synthetic[i] );
+
+        benchBoard( pcb, board, repeat, plotDir.GetPath() );
+        results.push_back( board );
+        delete pcb;
+    }
+
+    for( unsigned i = 0; i < files.size(); i++ )
+    {
+        BENCH_BOARD board;
+        bool        loaded = false;
+        wxFileName  fn( wxString::FromUTF8( files[i].c_str() ) );
+
+        board.m_Name = TO_UTF8( fn.GetFullName() );
+
+        measure( board, "load", repeat, boost::bind( loadAndDelete, files[i], &loaded ) );
+
+        BOARD* pcb = loaded ? loadBoard( files[i] ) : NULL;
+
+        if( !pcb )
+        {
+            ok = false;
+            continue;
+        }
+
+        benchBoard( pcb, board, repeat, plotDir.GetPath() );
+        results.push_back( board );
+        delete pcb;
+    }
+
+    if( jsonFile && !writeJson( jsonFile, results, repeat ) )
+    {
+        fprintf( stderr, "can't write %s\n", jsonFile );
+        return 1;
+    }
+
+    return ok ? 0 : 1;
+}
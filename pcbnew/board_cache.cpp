@@ -0,0 +1,259 @@
+/**
+ * @file board_cache.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+
+#include <board_cache.h>
+
+/*
+    The cache file is made of native 32 bits words, it is not meant to be moved to
+    another machine:
+
+    "KIPCBCCH"                  magic
+    version, byte order mark    uint32 uint32
+    board file hash             uint64
+    zone count                  uint32
+    for each zone:
+        polygon count           uint32
+        for each polygon:
+            point count         uint32
+            points              int32 x, int32 y
+*/
+
+static const char       cacheMagic[8] = { 'K', 'I', 'P', 'C', 'B', 'C', 'C', 'H' };
+static const uint32_t   cacheVersion = 1;
+static const uint32_t   byteOrderMark = 0x01020304;
+
+
+wxString BOARD_CACHE::GetFileName( const wxString& aBoardFileName )
+{
+    return aBoardFileName + wxT( "-cache" );
+}
+
+
+uint64_t BOARD_CACHE::Hash( const char* aData, size_t aSize )
+{
+    // FNV-1a, on 8 bytes words: the board files with a cache are large
+    uint64_t h = 14695981039346656037ull ^ aSize;
+    size_t   i = 0;
+
+    for( ; i + 8 <= aSize; i += 8 )
+    {
+        uint64_t word;
+
+        memcpy( &word, aData + i, 8 );
+        h ^= word;
+        h *= 1099511628211ull;
+    }
+
+    for( ; i < aSize; ++i )
+    {
+        h ^= (unsigned char) aData[i];
+        h *= 1099511628211ull;
+    }
+
+    return h;
+}
+
+
+static void writeU32( FILE* aFile, uint32_t aValue )
+{
+    fwrite( &aValue, sizeof( aValue ), 1, aFile );
+}
+
+
+bool BOARD_CACHE::Save( const wxString& aFileName, uint64_t aHash, const BOARD* aBoard )
+{
+    // written to a temporary file first, an interrupted save leaves no partial cache
+    wxString tmpName = aFileName + wxT( ".tmp" );
+    FILE*    file = wxFopen( tmpName, wxT( "wb" ) );
+
+    if( !file )
+        return false;
+
+    fwrite( cacheMagic, sizeof( cacheMagic ), 1, file );
+    writeU32( file, cacheVersion );
+    writeU32( file, byteOrderMark );
+    fwrite( &aHash, sizeof( aHash ), 1, file );
+    writeU32( file, aBoard->GetAreaCount() );
+
+    std::vector<int32_t> coords;
+
+    for( int i = 0; i < aBoard->GetAreaCount(); ++i )
+    {
+        // the outlines only, as in the board file
+        const SHAPE_POLY_SET& fill = aBoard->GetArea( i )->GetFilledPolysList();
+
+        writeU32( file, fill.OutlineCount() );
+
+        for( int j = 0; j < fill.OutlineCount(); ++j )
+        {
+            const SHAPE_LINE_CHAIN& outline = fill.COutline( j );
+
+            coords.resize( outline.PointCount() * 2 );
+
+            for( int k = 0; k < outline.PointCount(); ++k )
+            {
+                coords[2 * k]     = outline.CPoint( k ).x;
+                coords[2 * k + 1] = outline.CPoint( k ).y;
+            }
+
+            writeU32( file, outline.PointCount() );
+
+            if( !coords.empty() )
+                fwrite( &coords[0], sizeof( int32_t ), coords.size(), file );
+        }
+    }
+
+    bool ok = !ferror( file );
+
+    ok = ( fclose( file ) == 0 ) && ok;
+
+    if( ok )
+        ok = wxRenameFile( tmpName, aFileName, true );
+
+    if( !ok )
+        wxRemoveFile( tmpName );
+
+    return ok;
+}
+
+
+/// Reads the words of a cache file, checking the end of the data
+struct CACHE_CURSOR
+{
+    const char* m_pos;
+    const char* m_end;
+
+    bool Read( void* aValue, size_t aSize )
+    {
+        if( (size_t) ( m_end - m_pos ) < aSize )
+            return false;
+
+        memcpy( aValue, m_pos, aSize );
+        m_pos += aSize;
+
+        return true;
+    }
+};
+
+
+bool BOARD_CACHE::Load( const wxString& aFileName, uint64_t aHash )
+{
+    m_zoneFills.clear();
+
+    if( !wxFileName::FileExists( aFileName ) )
+        return false;
+
+    wxFFile file( aFileName, wxT( "rb" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    std::vector<char> data( file.Length() );
+
+    if( data.empty() || file.Read( &data[0], data.size() ) != data.size() )
+        return false;
+
+    CACHE_CURSOR cursor = { &data[0], &data[0] + data.size() };
+    char         magic[sizeof( cacheMagic )];
+    uint32_t     version, bom, zoneCount;
+    uint64_t     hash;
+
+    if( !cursor.Read( magic, sizeof( magic ) ) || memcmp( magic, cacheMagic, sizeof( magic ) )
+        || !cursor.Read( &version, 4 ) || version != cacheVersion
+        || !cursor.Read( &bom, 4 ) || bom != byteOrderMark
+        || !cursor.Read( &hash, 8 ) || hash != aHash
+        || !cursor.Read( &zoneCount, 4 ) )
+        return false;
+
+    m_zoneFills.resize( zoneCount );
+
+    for( uint32_t i = 0; i < zoneCount; ++i )
+    {
+        uint32_t polygonCount;
+
+        if( !cursor.Read( &polygonCount, 4 ) )
+        {
+            m_zoneFills.clear();
+            return false;
+        }
+
+        for( uint32_t j = 0; j < polygonCount; ++j )
+        {
+            uint32_t pointCount;
+
+            if( !cursor.Read( &pointCount, 4 )
+                || (size_t) ( cursor.m_end - cursor.m_pos ) / 8 < pointCount )
+            {
+                m_zoneFills.clear();
+                return false;
+            }
+
+            SHAPE_LINE_CHAIN& outline = m_zoneFills[i].Outline( m_zoneFills[i].NewOutline() );
+
+            for( uint32_t k = 0; k < pointCount; ++k )
+            {
+                int32_t xy[2];
+
+                cursor.Read( xy, sizeof( xy ) );
+                outline.Append( xy[0], xy[1] );
+            }
+        }
+    }
+
+    // a truncated cache, or trailing data, is not the one written
+    if( cursor.m_pos != cursor.m_end )
+    {
+        m_zoneFills.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool BOARD_CACHE::Apply( BOARD* aBoard )
+{
+    if( aBoard->GetAreaCount() != (int) m_zoneFills.size() )
+        return false;
+
+    for( int i = 0; i < aBoard->GetAreaCount(); ++i )
+    {
+        if( !m_zoneFills[i].IsEmpty() )
+            aBoard->GetArea( i )->AddFilledPolysList( m_zoneFills[i] );
+    }
+
+    return true;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file board_cache.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _BOARD_CACHE_H
+#define _BOARD_CACHE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <geometry/shape_poly_set.h>
+
+class BOARD;
+
+
+/**
+ * Class BOARD_CACHE
+ * is the binary companion file of a large .kicad_pcb file, holding the filled polygons
+ * of its zones as raw point arrays.  The filled polygons make most of a large board
+ * file: when the cache is valid, the board parser skips them, and they are read from
+ * the cache instead, which is much faster.
+ *
+ * The cache holds the hash of the board file it was written with, and is ignored when
+ * the board file does not match it anymore.  The board file stays the reference: the
+ * cache only repeats its contents, so it can be deleted at any time.
+ */
+class BOARD_CACHE
+{
+public:
+    ///> The board files smaller than this have no cache, they are read fast enough
+    static const size_t MIN_BOARD_FILE_SIZE = 16 << 20;
+
+    ///> Returns the name of the cache file of the board file aBoardFileName
+    static wxString GetFileName( const wxString& aBoardFileName );
+
+    ///> Returns the hash of the contents of a board file
+    static uint64_t Hash( const char* aData, size_t aSize );
+
+    /**
+     * Function Save
+     * writes the cache of @a aBoard to @a aFileName.
+     * @param aHash is the hash of the board file @a aBoard was saved to.
+     * @return false if the cache could not be written.
+     */
+    static bool Save( const wxString& aFileName, uint64_t aHash, const BOARD* aBoard );
+
+    /**
+     * Function Load
+     * reads the cache file @a aFileName.
+     * @return false if it cannot be read, or if it was not written for the board file
+     * of hash @a aHash.
+     */
+    bool Load( const wxString& aFileName, uint64_t aHash );
+
+    /**
+     * Function Apply
+     * sets the filled polygons of the zones of @a aBoard, in the board order, from the
+     * loaded cache.
+     * @return false if the board does not have the zone count of the cache.
+     */
+    bool Apply( BOARD* aBoard );
+
+private:
+    std::vector<SHAPE_POLY_SET> m_zoneFills;
+};
+
+#endif    // _BOARD_CACHE_H
@@ -0,0 +1,172 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_commit.cpp
+ */
+
+#include <fctsys.h>
+#include <wxPcbStruct.h>
+#include <class_draw_panel_gal.h>
+#include <view/view.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <ratsnest_data.h>
+
+#include <board_commit.h>
+
+#include <boost/bind.hpp>
+
+
+BOARD_COMMIT::BOARD_COMMIT( PCB_BASE_FRAME* aFrame ) :
+    m_frame( aFrame ),
+    m_editModules( aFrame->IsType( FRAME_PCB_MODULE_EDITOR ) )
+{
+}
+
+
+BOARD_COMMIT::~BOARD_COMMIT()
+{
+    for( unsigned i = 0; i < m_changes.GetCount(); ++i )
+        delete m_changes.GetPickedItemLink( i );
+
+    m_changes.ClearItemsList();
+}
+
+
+void BOARD_COMMIT::record( BOARD_ITEM* aItem, UNDO_REDO_T aStatus )
+{
+    if( !m_recorded.insert( aItem ).second )
+        return;
+
+    // modedit saves everything upfront
+    if( m_editModules && Empty() )
+        m_frame->SaveCopyInUndoList( m_frame->GetBoard()->m_Modules, UR_MODEDIT );
+
+    ITEM_PICKER picker( aItem, aStatus );
+
+    if( aStatus == UR_CHANGED && !m_editModules )
+        picker.SetLink( aItem->Clone() );
+
+    m_changes.PushItem( picker );
+}
+
+
+void BOARD_COMMIT::Add( BOARD_ITEM* aItem )
+{
+    record( aItem, UR_NEW );
+}
+
+
+void BOARD_COMMIT::Remove( BOARD_ITEM* aItem )
+{
+    record( aItem, UR_DELETED );
+}
+
+
+void BOARD_COMMIT::Modify( BOARD_ITEM* aItem )
+{
+    // As the undo list does, see SaveCopyInUndoList()
+    if( !m_editModules && ( aItem->Type() == PCB_MODULE_TEXT_T || aItem->Type() == PCB_PAD_T ) )
+        aItem = static_cast<BOARD_ITEM*>( aItem->GetParent() );
+
+    record( aItem, UR_CHANGED );
+}
+
+
+void BOARD_COMMIT::Modify( const PICKED_ITEMS_LIST& aItems )
+{
+    for( unsigned i = 0; i < aItems.GetCount(); ++i )
+        Modify( static_cast<BOARD_ITEM*>( aItems.GetPickedItem( i ) ) );
+}
+
+
+// Appends an item to the items added to the view at once
+static void collectViewItem( std::vector<KIGFX::VIEW_ITEM*>* aItems, BOARD_ITEM* aItem )
+{
+    aItems->push_back( aItem );
+}
+
+
+void BOARD_COMMIT::Push()
+{
+    if( Empty() )
+        return;
+
+    RN_DATA*        ratsnest = m_frame->GetBoard()->GetRatsnest();
+    KIGFX::VIEW*    view = m_frame->GetGalCanvas()->GetView();
+    std::vector<KIGFX::VIEW_ITEM*> newItems;
+
+    for( unsigned i = 0; i < m_changes.GetCount(); ++i )
+    {
+        BOARD_ITEM* item = static_cast<BOARD_ITEM*>( m_changes.GetPickedItem( i ) );
+
+        switch( m_changes.GetPickedItemStatus( i ) )
+        {
+        case UR_NEW:
+            if( item->Type() == PCB_MODULE_T )
+            {
+                static_cast<MODULE*>( item )->RunOnChildren(
+                        boost::bind( collectViewItem, &newItems, _1 ) );
+            }
+
+            newItems.push_back( item );
+            ratsnest->Add( item );
+            break;
+
+        case UR_DELETED:
+            if( item->Type() == PCB_MODULE_T )
+            {
+                static_cast<MODULE*>( item )->RunOnChildren(
+                        boost::bind( &KIGFX::VIEW::Remove, view, _1 ) );
+            }
+
+            view->Remove( item );
+            ratsnest->Remove( item );
+            break;
+
+        case UR_CHANGED:
+            item->ViewUpdate( KIGFX::VIEW_ITEM::ALL );
+            ratsnest->Update( item );
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    view->AddItems( newItems );
+
+    // Only the nets made dirty by the changes are computed again
+    ratsnest->Recalculate();
+
+    // The undo list owns the copies, and the removed items, from now on
+    if( !m_editModules )
+        m_frame->SaveCopyInUndoList( m_changes, UR_UNSPECIFIED );
+
+    m_frame->OnModify();
+
+    m_changes.ClearItemsList();
+    m_recorded.clear();
+}
@@ -0,0 +1,102 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef BOARD_COMMIT_H_
+#define BOARD_COMMIT_H_
+
+#include <class_undoredo_container.h>
+
+#include <boost/unordered_set.hpp>
+
+class PCB_BASE_FRAME;
+class BOARD_ITEM;
+
+
+/**
+ * Class BOARD_COMMIT
+ * records the changes of the items of a board made by a tool action, and applies them
+ * to the view, the ratsnest and the undo list at once, when the action ends:
+ * <ul>
+ * <li> the new items are added to the view in one VIEW::AddItems() call, and the
+ *      modified ones only marked for update, refreshed by the next VIEW::UpdateItems();
+ * <li> the ratsnest of the items is updated, then RN_DATA::Recalculate() computes each
+ *      net made dirty by the changes once;
+ * <li> a single undo entry holds all the changes.
+ * </ul>
+ * In the module editor, the undo entry is a copy of the whole footprint, saved by the
+ * first change recorded: the items must then be recorded before being modified.
+ */
+class BOARD_COMMIT
+{
+public:
+    BOARD_COMMIT( PCB_BASE_FRAME* aFrame );
+
+    ///> Deletes the undo copies of the changes, if they were not pushed
+    ~BOARD_COMMIT();
+
+    /**
+     * Function Add
+     * records aItem, just added to the board.
+     */
+    void Add( BOARD_ITEM* aItem );
+
+    /**
+     * Function Remove
+     * records aItem, just removed from the board.  Once pushed, it is owned by the
+     * undo list.
+     */
+    void Remove( BOARD_ITEM* aItem );
+
+    /**
+     * Function Modify
+     * records aItem before it is modified, keeping a copy of it for the undo entry.
+     * In the board editor, the pads and texts of a footprint record their footprint.
+     * An item already recorded is skipped.
+     */
+    void Modify( BOARD_ITEM* aItem );
+
+    ///> Calls Modify() for each item of aItems, usually the items of a selection
+    void Modify( const PICKED_ITEMS_LIST& aItems );
+
+    bool Empty() const
+    {
+        return m_changes.GetCount() == 0;
+    }
+
+    /**
+     * Function Push
+     * applies the recorded changes to the view and the ratsnest, saves them in a
+     * single undo entry, and marks the board as modified.  The commit is then empty.
+     */
+    void Push();
+
+private:
+    void record( BOARD_ITEM* aItem, UNDO_REDO_T aStatus );
+
+    PCB_BASE_FRAME*                     m_frame;
+    bool                                m_editModules;  ///< the frame is the module editor
+    PICKED_ITEMS_LIST                   m_changes;
+    boost::unordered_set<BOARD_ITEM*>   m_recorded;     ///< items of m_changes
+};
+
+#endif  // BOARD_COMMIT_H_
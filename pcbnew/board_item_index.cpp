@@ -0,0 +1,568 @@
+/**
+ * @file board_item_index.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+
+#include <fctsys.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+#include <class_edge_mod.h>
+#include <class_drawsegment.h>
+
+#include <board_item_index.h>
+#include <fill_hash.h>
+
+
+// Number of clearance shapes kept per item: an item is usually near a few zones only,
+// with one or two clearance values
+static const unsigned s_maxCachedShapes = 4;
+
+
+BOARD_ITEM_INDEX::BOARD_ITEM_INDEX( BOARD* aBoard ) :
+    m_board( aBoard ),
+    m_valid( false ),
+    m_liveCount( 0 ),
+    m_maxLocalClearance( 0 )
+{
+    m_board->AddListener( this );
+}
+
+
+BOARD_ITEM_INDEX::~BOARD_ITEM_INDEX()
+{
+    m_board->RemoveListener( this );
+}
+
+
+void BOARD_ITEM_INDEX::OnBoardItemAdded( const BOARD_ITEM* aItem )
+{
+    // Before the first Update(), e.g. while the board is loaded, there is nothing to maintain
+    if( m_valid )
+        m_dirtyItems.insert( dirtyItem( aItem ) );
+}
+
+
+void BOARD_ITEM_INDEX::OnBoardItemRemoved( const BOARD_ITEM* aItem )
+{
+    if( !m_valid )
+        return;
+
+    // A removed item can be deleted before the next Update()
+    const BOARD_ITEM* parent = dirtyItem( aItem );
+
+    if( parent == aItem )
+    {
+        m_dirtyItems.erase( aItem );
+    }
+    else
+    {
+        // A single pad or edge of a footprint, the footprint is indexed again
+        m_dirtyItems.insert( parent );
+    }
+
+    unindexItem( aItem );
+}
+
+
+void BOARD_ITEM_INDEX::OnBoardItemChanged( const BOARD_ITEM* aItem )
+{
+    if( m_valid )
+        m_dirtyItems.insert( dirtyItem( aItem ) );
+}
+
+
+const BOARD_ITEM* BOARD_ITEM_INDEX::dirtyItem( const BOARD_ITEM* aItem ) const
+{
+    if( ( aItem->Type() == PCB_PAD_T || aItem->Type() == PCB_MODULE_EDGE_T )
+            && aItem->GetParent() )
+        return static_cast<const BOARD_ITEM*>( aItem->GetParent() );
+
+    return aItem;
+}
+
+
+void BOARD_ITEM_INDEX::Invalidate()
+{
+    m_valid = false;
+
+    m_tree.RemoveAll();
+    m_entries.clear();
+    m_liveCount = 0;
+    m_ordinals.clear();
+    m_shapes.clear();
+    m_moduleEntries.clear();
+    m_offCopperPads.clear();
+    m_dirtyItems.clear();
+    m_maxLocalClearance = 0;
+}
+
+
+void BOARD_ITEM_INDEX::Update()
+{
+    // Once most of the entries are dead, it is cheaper to build the index again
+    if( m_valid && m_entries.size() > 1024 && m_entries.size() > 4 * (unsigned) m_liveCount )
+        Invalidate();
+
+    if( !m_valid )
+    {
+        build();
+        return;
+    }
+
+    for( std::set<const BOARD_ITEM*>::iterator it = m_dirtyItems.begin();
+         it != m_dirtyItems.end(); ++it )
+    {
+        // Notifications give const items, but they are owned by m_board and still in it
+        // (removed items are not in m_dirtyItems)
+        BOARD_ITEM* item = const_cast<BOARD_ITEM*>( *it );
+
+        unindexItem( item );
+        indexItem( item );
+    }
+
+    m_dirtyItems.clear();
+}
+
+
+void BOARD_ITEM_INDEX::build()
+{
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+        indexItem( module );
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+        indexItem( track );
+
+    for( BOARD_ITEM* item = m_board->m_Drawings; item; item = item->Next() )
+        indexItem( item );
+
+    m_valid = true;
+}
+
+
+void BOARD_ITEM_INDEX::Query( const EDA_RECT& aBox, LAYER_ID aLayer,
+                              std::vector<BOARD_ITEM*>& aItems )
+{
+    Query( aBox, LSET( aLayer ), aItems );
+}
+
+
+void BOARD_ITEM_INDEX::Query( const EDA_RECT& aBox, LSET aLayers,
+                              std::vector<BOARD_ITEM*>& aItems )
+{
+    std::vector<int> ordinals;
+
+    m_tree.Query( aBox, aLayers, ordinals );
+
+    aItems.clear();
+    aItems.reserve( ordinals.size() );
+
+    for( unsigned ii = 0; ii < ordinals.size(); ++ii )
+        aItems.push_back( m_entries[ ordinals[ii] ].m_item );
+}
+
+
+void BOARD_ITEM_INDEX::QueryPoint( const wxPoint& aPosition, LSET aLayers,
+                                   std::vector<BOARD_ITEM*>& aItems )
+{
+    std::vector<int> ordinals;
+    EDA_RECT         box( aPosition, wxSize( 0, 0 ) );
+
+    // One more unit, so the rounding of the bounding boxes do not hide a hit
+    box.Inflate( 1 );
+
+    bool nonCopper = ( aLayers & LSET::AllNonCuMask() ).any();
+
+    // The items on copper layers can be on technical layers too, e.g. the pads on the
+    // mask layers: with a technical layer, all the copper layers are searched
+    m_tree.Query( box, nonCopper ? LSET::AllCuMask() : aLayers, ordinals );
+
+    if( nonCopper && !m_offCopperPads.empty() )
+    {
+        for( std::set<int>::const_iterator it = m_offCopperPads.begin();
+             it != m_offCopperPads.end(); ++it )
+        {
+            if( m_entries[*it].m_area.Intersects( box ) )
+                ordinals.push_back( *it );
+        }
+
+        std::sort( ordinals.begin(), ordinals.end() );
+    }
+
+    aItems.clear();
+    aItems.reserve( ordinals.size() );
+
+    for( unsigned ii = 0; ii < ordinals.size(); ++ii )
+        aItems.push_back( m_entries[ ordinals[ii] ].m_item );
+}
+
+
+void BOARD_ITEM_INDEX::QuerySegment( const wxPoint& aStart, const wxPoint& aEnd, int aWidth,
+                                     LSET aLayers, std::vector<BOARD_ITEM*>& aItems )
+{
+    std::vector<int> ordinals;
+    EDA_RECT         box( aStart, wxSize( aEnd.x - aStart.x, aEnd.y - aStart.y ) );
+
+    box.Normalize();
+    box.Inflate( aWidth / 2 );
+
+    m_tree.Query( box, aLayers, ordinals );
+
+    aItems.clear();
+
+    for( unsigned ii = 0; ii < ordinals.size(); ++ii )
+    {
+        const ENTRY& entry = m_entries[ ordinals[ii] ];
+        EDA_RECT     area = entry.m_area;
+
+        area.Inflate( aWidth / 2 );
+
+        if( area.Intersects( aStart, aEnd ) )
+            aItems.push_back( entry.m_item );
+    }
+}
+
+
+void BOARD_ITEM_INDEX::TransformItemShapeToPolygon( const BOARD_ITEM* aItem,
+                                                    SHAPE_POLY_SET& aCornerBuffer,
+                                                    int aClearanceValue,
+                                                    int aCircleToSegmentsCount,
+                                                    double aCorrectionFactor )
+{
+    // The index is not modified while it is used by several threads, only the shapes are
+    std::map<const BOARD_ITEM*, int>::const_iterator it = m_ordinals.find( aItem );
+    int     ordinal = it != m_ordinals.end() ? it->second : -1;
+    bool    found = false;
+
+    // Tells whether the item has been changed in place since its shapes were built
+    const uint64_t itemHash = geometryHash( aItem );
+
+    if( ordinal >= 0 )
+    {
+#ifdef USE_OPENMP
+        #pragma omp critical( boardItemShapes )
+#endif
+        {
+            std::map<int, std::vector<CACHED_SHAPE> >::const_iterator shapes =
+                    m_shapes.find( ordinal );
+
+            for( unsigned ii = 0; shapes != m_shapes.end() && ii < shapes->second.size(); ++ii )
+            {
+                const CACHED_SHAPE& cached = shapes->second[ii];
+
+                if( cached.m_geometryHash == itemHash
+                        && cached.m_clearance == aClearanceValue
+                        && cached.m_segsPerCircle == aCircleToSegmentsCount
+                        && cached.m_correctionFactor == aCorrectionFactor )
+                {
+                    aCornerBuffer.Append( cached.m_shape );
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        if( found )
+            return;
+    }
+
+    SHAPE_POLY_SET shape;
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+        static_cast<const D_PAD*>( aItem )->TransformShapeWithClearanceToPolygon(
+                shape, aClearanceValue, aCircleToSegmentsCount, aCorrectionFactor );
+        break;
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        static_cast<const TRACK*>( aItem )->TransformShapeWithClearanceToPolygon(
+                shape, aClearanceValue, aCircleToSegmentsCount, aCorrectionFactor );
+        break;
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+        static_cast<const DRAWSEGMENT*>( aItem )->TransformShapeWithClearanceToPolygon(
+                shape, aClearanceValue, aCircleToSegmentsCount, aCorrectionFactor );
+        break;
+
+    default:
+        wxFAIL_MSG( wxT( "BOARD_ITEM_INDEX::TransformItemShapeToPolygon(): unexpected item" ) );
+        return;
+    }
+
+    aCornerBuffer.Append( shape );
+
+    if( ordinal < 0 )
+        return;
+
+#ifdef USE_OPENMP
+    #pragma omp critical( boardItemShapes )
+#endif
+    {
+        std::vector<CACHED_SHAPE>& shapes = m_shapes[ordinal];
+
+        // The shapes built for an older geometry are of no use anymore
+        if( !shapes.empty() && shapes.back().m_geometryHash != itemHash )
+            shapes.clear();
+
+        if( shapes.size() >= s_maxCachedShapes )
+            shapes.erase( shapes.begin() );
+
+        CACHED_SHAPE cached;
+
+        cached.m_geometryHash     = itemHash;
+        cached.m_clearance        = aClearanceValue;
+        cached.m_segsPerCircle    = aCircleToSegmentsCount;
+        cached.m_correctionFactor = aCorrectionFactor;
+
+        shapes.push_back( cached );
+        shapes.back().m_shape = shape;
+    }
+}
+
+
+uint64_t BOARD_ITEM_INDEX::geometryHash( const BOARD_ITEM* aItem )
+{
+    FILL_HASH hash;
+
+    hash.Add( aItem->Type() );
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        hash.Add( pad->GetPosition() );
+        hash.Add( pad->GetSize().x );
+        hash.Add( pad->GetSize().y );
+        hash.Add( pad->GetShape() );
+        hash.Add( KiROUND( pad->GetOrientation() * 1000 ) );
+        hash.Add( pad->GetDelta().x );
+        hash.Add( pad->GetDelta().y );
+        hash.Add( pad->GetOffset() );
+        hash.Add( KiROUND( pad->GetRoundRectRadiusRatio() * 1e6 ) );
+    }
+        break;
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    {
+        const TRACK* track = static_cast<const TRACK*>( aItem );
+
+        hash.Add( track->GetStart() );
+        hash.Add( track->GetEnd() );
+        hash.Add( track->GetWidth() );
+    }
+        break;
+
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        const DRAWSEGMENT*          segment = static_cast<const DRAWSEGMENT*>( aItem );
+        const std::vector<wxPoint>& polyPoints = segment->GetPolyPoints();
+        const MODULE*               module = segment->GetParentModule();
+
+        hash.Add( segment->GetShape() );
+        hash.Add( segment->GetStart() );
+        hash.Add( segment->GetEnd() );
+        hash.Add( segment->GetWidth() );
+        hash.Add( KiROUND( segment->GetAngle() * 1000 ) );
+        hash.Add( (int64_t) polyPoints.size() );
+
+        for( unsigned ii = 0; ii < polyPoints.size(); ++ii )
+            hash.Add( polyPoints[ii] );
+
+        // The polygons of the footprints are placed with their footprint
+        if( module )
+        {
+            hash.Add( module->GetPosition() );
+            hash.Add( KiROUND( module->GetOrientation() * 1000 ) );
+        }
+    }
+        break;
+
+    default:
+        break;
+    }
+
+    return hash.Get();
+}
+
+
+void BOARD_ITEM_INDEX::indexItem( BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        MODULE*             module = static_cast<MODULE*>( aItem );
+        std::vector<int>&   entries = m_moduleEntries[module];
+
+        m_maxLocalClearance = std::max( m_maxLocalClearance, module->GetLocalClearance() );
+
+        for( D_PAD* pad = module->Pads().GetFirst(); pad; pad = pad->Next() )
+        {
+            m_maxLocalClearance = std::max( m_maxLocalClearance, pad->GetLocalClearance() );
+            m_maxLocalClearance = std::max( m_maxLocalClearance, pad->GetThermalGap() );
+
+            int ordinal = addEntry( pad, padArea( pad ), padLayers( pad ) );
+
+            if( !padLayers( pad ).any() )
+                m_offCopperPads.insert( ordinal );
+
+            entries.push_back( ordinal );
+        }
+
+        for( BOARD_ITEM* item = module->GraphicalItems(); item; item = item->Next() )
+        {
+            if( item->Type() != PCB_MODULE_EDGE_T )
+                continue;
+
+            LSET layers = item->IsOnLayer( Edge_Cuts ) ? LSET::AllCuMask()
+                                                      : item->GetLayerSet() & LSET::AllCuMask();
+
+            if( layers.any() )
+                entries.push_back( addEntry( item, item->GetBoundingBox(), layers ) );
+        }
+    }
+        break;
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        addEntry( aItem, aItem->GetBoundingBox(), aItem->GetLayerSet() & LSET::AllCuMask() );
+        break;
+
+    case PCB_LINE_T:
+    case PCB_TEXT_T:
+        if( aItem->GetLayer() == Edge_Cuts )
+            addEntry( aItem, aItem->GetBoundingBox(), LSET::AllCuMask() );
+        else if( IsCopperLayer( aItem->GetLayer() ) )
+            addEntry( aItem, aItem->GetBoundingBox(), LSET( aItem->GetLayer() ) );
+        break;
+
+    default:    // Other items do not create holes in zones
+        break;
+    }
+}
+
+
+int BOARD_ITEM_INDEX::addEntry( BOARD_ITEM* aItem, const EDA_RECT& aArea, LSET aLayers )
+{
+    ENTRY entry;
+
+    entry.m_item   = aItem;
+    entry.m_area   = aArea;
+    entry.m_layers = aLayers;
+
+    int ordinal = m_entries.size();
+
+    m_entries.push_back( entry );
+    m_ordinals[aItem] = ordinal;
+    m_liveCount++;
+
+    m_tree.Insert( ordinal, entry.m_area, entry.m_layers );
+
+    return ordinal;
+}
+
+
+void BOARD_ITEM_INDEX::unindexItem( const BOARD_ITEM* aItem )
+{
+    std::map<const BOARD_ITEM*, std::vector<int> >::iterator module =
+            m_moduleEntries.find( aItem );
+
+    if( module != m_moduleEntries.end() )
+    {
+        // The pads and edges of the footprint can have been deleted already, only their
+        // stored entries are used here
+        for( unsigned ii = 0; ii < module->second.size(); ++ii )
+            removeEntry( module->second[ii] );
+
+        m_moduleEntries.erase( module );
+        return;
+    }
+
+    std::map<const BOARD_ITEM*, int>::iterator it = m_ordinals.find( aItem );
+
+    if( it != m_ordinals.end() )
+        removeEntry( it->second );
+}
+
+
+void BOARD_ITEM_INDEX::removeEntry( int aOrdinal )
+{
+    ENTRY& entry = m_entries[aOrdinal];
+
+    // Already removed, e.g. a pad removed on its own before its footprint
+    if( entry.m_item == NULL )
+        return;
+
+    m_tree.Remove( aOrdinal, entry.m_area, entry.m_layers );
+    m_offCopperPads.erase( aOrdinal );
+    m_liveCount--;
+
+    m_shapes.erase( aOrdinal );
+
+    // The item can have been deleted, and its address reused by an item indexed since
+    std::map<const BOARD_ITEM*, int>::iterator it = m_ordinals.find( entry.m_item );
+
+    if( it != m_ordinals.end() && it->second == aOrdinal )
+        m_ordinals.erase( it );
+
+    entry.m_item = NULL;
+}
+
+
+EDA_RECT BOARD_ITEM_INDEX::padArea( const D_PAD* aPad )
+{
+    EDA_RECT area = aPad->GetBoundingBox();
+
+    // The hole of a pad can be larger than its copper shape
+    if( aPad->GetDrillSize().x || aPad->GetDrillSize().y )
+    {
+        EDA_RECT hole( aPad->GetPosition(), wxSize( 0, 0 ) );
+        hole.Inflate( std::max( aPad->GetDrillSize().x, aPad->GetDrillSize().y ) / 2 + 1 );
+        area.Merge( hole );
+    }
+
+    return area;
+}
+
+
+LSET BOARD_ITEM_INDEX::padLayers( const D_PAD* aPad )
+{
+    // The hole of a pad creates a hole in the zones of all the copper layers
+    if( aPad->GetDrillSize().x || aPad->GetDrillSize().y )
+        return LSET::AllCuMask();
+
+    return aPad->GetLayerSet() & LSET::AllCuMask();
+}
@@ -0,0 +1,207 @@
+/**
+ * @file board_item_index.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _BOARD_ITEM_INDEX_H
+#define _BOARD_ITEM_INDEX_H
+
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <class_board.h>
+#include <drc_rtree.h>
+#include <geometry/shape_poly_set.h>
+
+class D_PAD;
+
+
+/**
+ * Class BOARD_ITEM_INDEX
+ * is a spatial index of the board items which can create holes in a copper zone:
+ * pads, tracks, vias, footprint edges and board drawings on copper layers or on
+ * the board edges layer.  The point lookups of the BOARD (pads, vias, tracks and lock
+ * points) search it too.  It is owned by the BOARD, built on the first Update(),
+ * and then kept up to date from the board change notifications, like the ratsnest.
+ * Items on Edge_Cuts, and pads with a hole, are found on all the copper layers.
+ * It also keeps the clearance shapes built for the indexed items, so that the zones
+ * near an item reuse them, until the item is changed.
+ */
+class BOARD_ITEM_INDEX : public BOARD_LISTENER
+{
+public:
+    BOARD_ITEM_INDEX( BOARD* aBoard );
+    ~BOARD_ITEM_INDEX();
+
+    void OnBoardItemAdded( const BOARD_ITEM* aItem );
+    void OnBoardItemRemoved( const BOARD_ITEM* aItem );
+    void OnBoardItemChanged( const BOARD_ITEM* aItem );
+
+    /**
+     * Function Invalidate
+     * drops the index, which is built again by the next Update().  To be used when
+     * the board has been modified without notifications.
+     */
+    void Invalidate();
+
+    /**
+     * Function Update
+     * builds the index, or indexes again the items changed since the previous call.
+     */
+    void Update();
+
+    /**
+     * Function Query
+     * collects the indexed items found on aLayer whose bounding box overlaps aBox.
+     * Several threads can query the index at the same time, but not while it is updated.
+     * @param aItems is filled with the items found, in the order of the board lists
+     *               (the items added since the index was built come last).
+     */
+    void Query( const EDA_RECT& aBox, LAYER_ID aLayer, std::vector<BOARD_ITEM*>& aItems );
+
+    /**
+     * Function Query
+     * collects the indexed items found on at least one of the copper layers of aLayers
+     * whose bounding box overlaps aBox, as the function above does for one layer.
+     */
+    void Query( const EDA_RECT& aBox, LSET aLayers, std::vector<BOARD_ITEM*>& aItems );
+
+    /**
+     * Function QueryPoint
+     * collects the indexed items found on at least one of aLayers whose bounding box
+     * contains aPosition: the candidates of a hit test, which the caller does on them.
+     * When aLayers have non copper layers, the items of all the copper layers are
+     * candidates, and the pads without any copper layer, also indexed, are found too.
+     */
+    void QueryPoint( const wxPoint& aPosition, LSET aLayers, std::vector<BOARD_ITEM*>& aItems );
+
+    /**
+     * Function QuerySegment
+     * collects the indexed items found on at least one of the copper layers of aLayers
+     * whose bounding box, inflated by aWidth / 2, is crossed by the segment from aStart
+     * to aEnd.
+     */
+    void QuerySegment( const wxPoint& aStart, const wxPoint& aEnd, int aWidth, LSET aLayers,
+                       std::vector<BOARD_ITEM*>& aItems );
+
+    /**
+     * Function GetMaxLocalClearance
+     * @return the largest local clearance or thermal gap of the indexed pads and
+     * footprints: the area around a zone where its pads have to be searched has to
+     * be inflated by this value, or by the largest net class clearance.
+     */
+    int GetMaxLocalClearance() const { return m_maxLocalClearance; }
+
+    /**
+     * Function TransformItemShapeToPolygon
+     * appends to aCornerBuffer the shape of aItem (a pad, a track, a via or a graphic
+     * segment) inflated by aClearanceValue, as built by the item own
+     * TransformShapeWithClearanceToPolygon().  If aItem is indexed, the shape is kept,
+     * and reused by the next calls with the same parameters until aItem is notified as
+     * changed.  The shape is also keyed on a hash of the geometry of aItem, so an item
+     * changed without notification is not given its old shape.  Can be called from
+     * several threads at once.
+     */
+    void TransformItemShapeToPolygon( const BOARD_ITEM* aItem, SHAPE_POLY_SET& aCornerBuffer,
+                                      int aClearanceValue, int aCircleToSegmentsCount,
+                                      double aCorrectionFactor );
+
+private:
+    // Not copyable, like DRC_RTREE
+    BOARD_ITEM_INDEX( const BOARD_ITEM_INDEX& );
+    BOARD_ITEM_INDEX& operator=( const BOARD_ITEM_INDEX& );
+
+    /// A clearance shape built for an item, and the parameters used to build it
+    struct CACHED_SHAPE
+    {
+        uint64_t        m_geometryHash; ///< see geometryHash()
+        int             m_clearance;
+        int             m_segsPerCircle;
+        double          m_correctionFactor;
+        SHAPE_POLY_SET  m_shape;
+    };
+
+    /// An indexed item, and the area and layers used to index it
+    struct ENTRY
+    {
+        BOARD_ITEM*     m_item;     ///< NULL once the item is removed
+        EDA_RECT        m_area;
+        LSET            m_layers;
+    };
+
+    /// Indexes the whole board
+    void build();
+
+    /// Adds aItem (a footprint with its pads and edges, a track or a drawing) to the index
+    void indexItem( BOARD_ITEM* aItem );
+
+    /// Adds a single entry, @return its ordinal
+    int addEntry( BOARD_ITEM* aItem, const EDA_RECT& aArea, LSET aLayers );
+
+    /// Removes aItem, or the pads and edges of a footprint, from the index
+    void unindexItem( const BOARD_ITEM* aItem );
+
+    void removeEntry( int aOrdinal );
+
+    /// @return the top level item to index again when aItem has changed
+    const BOARD_ITEM* dirtyItem( const BOARD_ITEM* aItem ) const;
+
+    /// @return a hash of everything the clearance shape of aItem is built from
+    static uint64_t geometryHash( const BOARD_ITEM* aItem );
+
+    /// @return the area and layers used to index aPad, which include its hole
+    static EDA_RECT padArea( const D_PAD* aPad );
+    static LSET padLayers( const D_PAD* aPad );
+
+    BOARD*                  m_board;
+    bool                    m_valid;
+
+    DRC_RTREE               m_tree;
+
+    /// Indexed items by ordinal
+    std::vector<ENTRY>      m_entries;
+    int                     m_liveCount;
+    std::map<const BOARD_ITEM*, int> m_ordinals;
+
+    /// Clearance shapes of the indexed items by ordinal, the oldest first.  They are not
+    /// stored in m_entries, which would copy them each time it grows.
+    std::map<int, std::vector<CACHED_SHAPE> > m_shapes;
+
+    /// Ordinals of the pads and edges of the indexed footprints
+    std::map<const BOARD_ITEM*, std::vector<int> > m_moduleEntries;
+
+    /// Ordinals of the pads without any copper layer, which are in no tree
+    std::set<int>           m_offCopperPads;
+
+    /// Top level items added or modified since the last Update()
+    std::set<const BOARD_ITEM*> m_dirtyItems;
+
+    int                     m_maxLocalClearance;
+};
+
+#endif  // _BOARD_ITEM_INDEX_H
@@ -295,6 +295,16 @@ void ZONE_CONTAINER::TransformSolidAreasShapesToPolygonSet(
     // add filled areas polygons
     aCornerBuffer.Append( m_FilledPolysList );
 
+    TransformSolidAreasOutlinesToPolygonSet( aCornerBuffer, aCircleToSegmentsCount,
+                                             aCorrectionFactor );
+}
+
+
+void ZONE_CONTAINER::TransformSolidAreasOutlinesToPolygonSet(
+        SHAPE_POLY_SET& aCornerBuffer,
+        int             aCircleToSegmentsCount,
+        double          aCorrectionFactor )
+{
     // add filled areas outlines, which are drawn with thick lines
     for( int i = 0; i < m_FilledPolysList.OutlineCount(); i++ )
     {
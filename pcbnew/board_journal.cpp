@@ -0,0 +1,464 @@
+/**
+ * @file board_journal.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+
+#ifdef __WINDOWS__
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_zone.h>
+#include <class_netinfo.h>
+#include <kicad_plugin.h>
+#include <pcb_parser.h>
+#include <board_cache.h>
+
+#include <board_journal.h>
+
+/*
+    The journal is a list of s-expressions, the header then one per save:
+
+    (journal (version 1) (base "<size> <date of the board file>"))
+    (save
+      (nets (net <code> <name>) ...)
+      (add <id> <item>)
+      (change <id> <item>)
+      (remove <id>)
+    )
+*/
+
+
+// Writes the buffers of aFile to the disk
+static bool syncFile( FILE* aFile )
+{
+#ifdef __WINDOWS__
+    return _commit( _fileno( aFile ) ) == 0;
+#else
+    return fsync( fileno( aFile ) ) == 0;
+#endif
+}
+
+
+BOARD_JOURNAL::BOARD_JOURNAL() :
+    m_nextId( 0 ),
+    m_settingsHash( 0 ),
+    m_netsHash( 0 ),
+    m_started( false ),
+    m_valid( false ),
+    m_fileStarted( false )
+{
+}
+
+
+wxString BOARD_JOURNAL::GetFileName( const wxString& aBoardFileName )
+{
+    return aBoardFileName + wxT( "-journal" );
+}
+
+
+void BOARD_JOURNAL::collectItems( BOARD* aBoard, std::vector<BOARD_ITEM*>* aItems )
+{
+    // As PCB_IO::format() writes them
+    for( MODULE* module = aBoard->m_Modules;  module;  module = module->Next() )
+        aItems->push_back( module );
+
+    for( BOARD_ITEM* item = aBoard->m_Drawings;  item;  item = item->Next() )
+        aItems->push_back( item );
+
+    for( TRACK* track = aBoard->m_Track;  track;  track = track->Next() )
+        aItems->push_back( track );
+
+    for( int i = 0;  i < aBoard->GetAreaCount();  ++i )
+        aItems->push_back( aBoard->GetArea( i ) );
+}
+
+
+BOARD_JOURNAL::ZONE_FILL BOARD_JOURNAL::zoneFill( const BOARD_ITEM* aZone )
+{
+    const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aZone );
+
+    return ZONE_FILL( zone->IsFilled(), zone->GetFillHash() );
+}
+
+
+wxString BOARD_JOURNAL::fileStamp( const wxString& aFileName )
+{
+    wxFileName fn( aFileName );
+
+    if( !fn.FileExists() )
+        return wxEmptyString;
+
+    return wxString::Format( wxT( "%s %ld" ), GetChars( fn.GetSize().ToString() ),
+                             (long) fn.GetModificationTime().GetTicks() );
+}
+
+
+uint64_t BOARD_JOURNAL::settingsHash( BOARD* aBoard )
+{
+    // The net classes list the nets with pads only
+    aBoard->BuildListOfNets();
+
+    LOCALE_IO           toggle;
+    STRING_FORMATTER    out;
+    PCB_IO              io;
+
+    io.SetOutputFormatter( &out );
+    io.SetBoard( aBoard );
+    io.FormatBoardSettings( aBoard );
+
+    const std::string& settings = out.GetString();
+
+    return BOARD_CACHE::Hash( settings.data(), settings.size() );
+}
+
+
+uint64_t BOARD_JOURNAL::netsHash( BOARD* aBoard )
+{
+    uint64_t hash = 0;
+    NETINFO_LIST& nets = aBoard->GetNetInfo();
+
+    // The nets are not ordered, their hashes are combined in any order
+    for( NETINFO_LIST::iterator net = nets.begin();  net != nets.end();  ++net )
+    {
+        std::string name = TO_UTF8( net->GetNetname() );
+        int         code = net->GetNet();
+
+        hash ^= BOARD_CACHE::Hash( name.data(), name.size() )
+                + BOARD_CACHE::Hash( (const char*) &code, sizeof( code ) );
+    }
+
+    // 0 means no net table written
+    return hash ? hash : 1;
+}
+
+
+void BOARD_JOURNAL::recordBoard( BOARD* aBoard, const wxString& aBoardFileName,
+                                 const std::vector<BOARD_ITEM*>& aItems )
+{
+    m_ids.clear();
+    m_zoneFills.clear();
+    m_changed.clear();
+
+    for( unsigned id = 0;  id < aItems.size();  ++id )
+    {
+        BOARD_ITEM* item = aItems[id];
+
+        if( !item )
+            continue;
+
+        m_ids[item] = id;
+
+        if( item->Type() == PCB_ZONE_AREA_T )
+            m_zoneFills[item] = zoneFill( item );
+    }
+
+    m_nextId        = aItems.size();
+    m_boardFileName = aBoardFileName;
+    m_base          = fileStamp( aBoardFileName );
+    m_settingsHash  = settingsHash( aBoard );
+    m_netsHash      = 0;
+    m_started       = true;
+}
+
+
+void BOARD_JOURNAL::Start( BOARD* aBoard, const wxString& aBoardFileName )
+{
+    std::vector<BOARD_ITEM*> items;
+
+    collectItems( aBoard, &items );
+    recordBoard( aBoard, aBoardFileName, items );
+
+    // The journal file of the previous board file is overwritten by the next save
+    m_valid       = true;
+    m_fileStarted = false;
+}
+
+
+bool BOARD_JOURNAL::applyRecord( BOARD* aBoard, const BOARD_JOURNAL_RECORD& aRecord,
+                                 std::vector<BOARD_ITEM*>& aItems )
+{
+    unsigned id = aRecord.m_id;
+
+    if( aRecord.m_type == BOARD_JOURNAL_RECORD::ADD )
+    {
+        // The added items are numbered after the ones of the board file
+        if( id < aItems.size() )
+        {
+            delete aRecord.m_item;
+            return false;
+        }
+
+        aItems.resize( id + 1, NULL );
+    }
+    else
+    {
+        if( id >= aItems.size() || !aItems[id] )
+        {
+            delete aRecord.m_item;
+            return false;
+        }
+
+        aBoard->Delete( aItems[id] );
+    }
+
+    aItems[id] = aRecord.m_item;
+
+    if( aRecord.m_item )
+        aBoard->Add( aRecord.m_item );
+
+    return true;
+}
+
+
+int BOARD_JOURNAL::Open( BOARD* aBoard, const wxString& aBoardFileName, wxString* aErrors )
+{
+    std::vector<BOARD_ITEM*>            items;
+    std::vector<BOARD_JOURNAL_RECORD>   records;
+    wxString                            journalFile = GetFileName( aBoardFileName );
+    int                                 applied = 0;
+    bool                                continued = false;
+    bool                                valid = true;
+
+    collectItems( aBoard, &items );
+
+    if( wxFileName::FileExists( journalFile ) )
+    {
+        LOCALE_IO toggle;
+
+        try
+        {
+            FILE_LINE_READER reader( journalFile );
+            PCB_PARSER       parser( &reader );
+
+            parser.SetBoard( aBoard );
+
+            if( parser.ParseJournalHeader() != fileStamp( aBoardFileName ) )
+            {
+                // The board file was written without it, it is overwritten by the next save
+                *aErrors += wxString::Format( _( "The journal '%s' does not match its board "
+                                                 "file anymore, and was ignored.\n" ),
+                                              GetChars( journalFile ) );
+            }
+            else
+            {
+                continued = true;
+
+                // A save is applied only once read entirely, the last one may be torn
+                while( parser.ParseJournalSave( records ) )
+                {
+                    for( unsigned i = 0;  i < records.size();  ++i )
+                    {
+                        if( applyRecord( aBoard, records[i], items ) )
+                            ++applied;
+                        else
+                            *aErrors += wxString::Format( _( "The journal record of the item "
+                                                             "%u could not be applied.\n" ),
+                                                          records[i].m_id );
+                    }
+
+                    records.clear();
+                }
+            }
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            for( unsigned i = 0;  i < records.size();  ++i )
+                delete records[i].m_item;
+
+            *aErrors += wxString::Format( _( "The end of the journal '%s' could not be "
+                                             "read:\n%s\n" ),
+                                          GetChars( journalFile ), GetChars( ioe.errorText ) );
+            valid = false;
+        }
+    }
+
+    recordBoard( aBoard, aBoardFileName, items );
+
+    // A journal not read entirely is not continued, the next save is full
+    m_valid       = valid;
+    m_fileStarted = continued && valid;
+
+    return applied;
+}
+
+
+void BOARD_JOURNAL::Stop()
+{
+    m_ids.clear();
+    m_zoneFills.clear();
+    m_changed.clear();
+    m_boardFileName.Clear();
+    m_started     = false;
+    m_valid       = false;
+    m_fileStarted = false;
+}
+
+
+void BOARD_JOURNAL::MarkChanged( const BOARD_ITEM* aItem )
+{
+    if( !m_started || !aItem )
+        return;
+
+    // The journal records the footprints as a whole
+    while( aItem->GetParent() && aItem->GetParent()->Type() == PCB_MODULE_T )
+        aItem = static_cast<const BOARD_ITEM*>( aItem->GetParent() );
+
+    m_changed.insert( aItem );
+}
+
+
+bool BOARD_JOURNAL::Append( BOARD* aBoard, const wxString& aBoardFileName ) throw( IO_ERROR )
+{
+    if( !m_started || !m_valid || aBoardFileName != m_boardFileName
+        || fileStamp( aBoardFileName ) != m_base || settingsHash( aBoard ) != m_settingsHash )
+        return false;
+
+    LOCALE_IO                   toggle;
+    STRING_FORMATTER            out;
+    PCB_IO                      io;
+    std::vector<BOARD_ITEM*>    items;
+    ITEM_IDS                    ids;
+    ZONE_FILLS                  zoneFills;
+    unsigned                    nextId = m_nextId;
+    uint64_t                    nets = netsHash( aBoard );
+    int                         records = 0;
+
+    io.SetOutputFormatter( &out );
+    io.SetBoard( aBoard );
+
+    if( !m_fileStarted )
+        out.Print( 0, "(journal (version %d) (base %s))\n", VERSION,
+                   out.Quotew( m_base ).c_str() );
+
+    out.Print( 0, "(save\n" );
+
+    // The net codes of the items are the ones of the board, named by the net table
+    if( nets != m_netsHash )
+    {
+        NETINFO_LIST& netInfo = aBoard->GetNetInfo();
+
+        out.Print( 1, "(nets\n" );
+
+        for( NETINFO_LIST::iterator net = netInfo.begin();  net != netInfo.end();  ++net )
+            out.Print( 2, "(net %d %s)\n", net->GetNet(),
+                       out.Quotew( net->GetNetname() ).c_str() );
+
+        out.Print( 1, ")\n" );
+    }
+
+    collectItems( aBoard, &items );
+
+    for( unsigned i = 0;  i < items.size();  ++i )
+    {
+        BOARD_ITEM*                 item = items[i];
+        ITEM_IDS::const_iterator    it = m_ids.find( item );
+        bool                        isZone = item->Type() == PCB_ZONE_AREA_T;
+        const char*                 record = NULL;
+        unsigned                    id;
+
+        if( it == m_ids.end() )
+        {
+            id = nextId++;
+            record = "add";
+        }
+        else
+        {
+            id = it->second;
+
+            // A zone refilled without undo record is changed as well
+            if( m_changed.count( item )
+                || ( isZone && m_zoneFills[item] != zoneFill( item ) ) )
+                record = "change";
+        }
+
+        ids[item] = id;
+
+        if( isZone )
+            zoneFills[item] = zoneFill( item );
+
+        if( record )
+        {
+            out.Print( 1, "(%s %u\n", record, id );
+            io.Format( item, 2 );
+            out.Print( 1, ")\n" );
+            ++records;
+        }
+    }
+
+    for( ITEM_IDS::const_iterator it = m_ids.begin();  it != m_ids.end();  ++it )
+    {
+        if( !ids.count( it->first ) )
+        {
+            out.Print( 1, "(remove %u)\n", it->second );
+            ++records;
+        }
+    }
+
+    out.Print( 0, ")\n" );
+
+    // Nothing to write, a net table alone is not
+    if( records == 0 )
+        return true;
+
+    // Until written entirely, the journal does not match the recorded board anymore
+    m_valid = false;
+
+    wxString    journalFile = GetFileName( aBoardFileName );
+    wxFFile     file( journalFile, m_fileStarted ? wxT( "ab" ) : wxT( "wb" ) );
+
+    if( !file.IsOpened() )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open the journal file '%s'" ),
+                                          GetChars( journalFile ) ) );
+
+    const std::string& data = out.GetString();
+
+    if( file.Write( data.data(), data.size() ) != data.size() || !file.Flush()
+        || !syncFile( file.fp() ) )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to write the journal file '%s'" ),
+                                          GetChars( journalFile ) ) );
+
+    file.Close();
+
+    m_ids.swap( ids );
+    m_zoneFills.swap( zoneFills );
+    m_changed.clear();
+    m_nextId      = nextId;
+    m_netsHash    = nets;
+    m_valid       = true;
+    m_fileStarted = true;
+
+    return true;
+}
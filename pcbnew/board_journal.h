@@ -0,0 +1,184 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _BOARD_JOURNAL_H
+#define _BOARD_JOURNAL_H
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <richio.h>
+
+class BOARD;
+class BOARD_ITEM;
+class ZONE_CONTAINER;
+
+
+/**
+ * Struct BOARD_JOURNAL_RECORD
+ * is a change of a board item read from a #BOARD_JOURNAL.
+ */
+struct BOARD_JOURNAL_RECORD
+{
+    enum TYPE { ADD, CHANGE, REMOVE };
+
+    TYPE        m_type;
+    unsigned    m_id;       ///< the item, see BOARD_JOURNAL
+    BOARD_ITEM* m_item;     ///< the new item of an ADD or CHANGE record, else NULL
+
+    BOARD_JOURNAL_RECORD() :
+        m_type( ADD ),
+        m_id( 0 ),
+        m_item( NULL )
+    {
+    }
+};
+
+
+/**
+ * Class BOARD_JOURNAL
+ * is the append-only companion file of a .kicad_pcb file, holding the changes of its
+ * board saved since the board file was last written as a whole.  An incremental save
+ * appends the items added, changed and removed since the previous save, in the
+ * s-expression format of the board file, and syncs the journal to the disk: its cost
+ * depends on the changes, not on the size of the board.
+ *
+ * The items are numbered in the order of the board file, and the added ones after
+ * them, in the order of the journal.  A save holds the net table of the board when it
+ * changed, the net codes of its items are the ones of this table.
+ *
+ * The journal holds the size and date of the board file it applies to, and is ignored
+ * when the board file does not match them anymore.  When a board is loaded, its
+ * journal is replayed over it, also after a crash; a save which was not completely
+ * written is skipped.  The board file and its journal are only merged by a full save.
+ *
+ * The changed items are the ones given to MarkChanged(), by the undo list of the board
+ * editor, and the zones whose filled areas changed.  A change of the board settings or
+ * of the net classes, or an edit which is not in the undo list, needs a full save.
+ */
+class BOARD_JOURNAL
+{
+public:
+    ///> The version of the journal files written
+    static const int VERSION = 1;
+
+    BOARD_JOURNAL();
+
+    ///> Returns the name of the journal file of the board file aBoardFileName
+    static wxString GetFileName( const wxString& aBoardFileName );
+
+    /**
+     * Function Start
+     * records the items of \a aBoard, just written to \a aBoardFileName: the next
+     * Append() starts a new journal file with the changes made from now on.
+     */
+    void Start( BOARD* aBoard, const wxString& aBoardFileName );
+
+    /**
+     * Function Open
+     * replays the journal file of \a aBoardFileName, if any, over \a aBoard just loaded
+     * from it, then records the items of the board as Start() does.  The next Append()
+     * adds its changes to the journal file, unless the journal could not be read
+     * entirely.
+     * @param aErrors [out] receives the description of the records which could not be
+     *  applied, and of the read errors.
+     * @return the number of records applied.
+     */
+    int Open( BOARD* aBoard, const wxString& aBoardFileName, wxString* aErrors );
+
+    ///> Forgets the recorded board, until the next Start() or Open()
+    void Stop();
+
+    bool IsStarted() const { return m_started; }
+
+    /**
+     * Function MarkChanged
+     * records that \a aItem is about to change, or was just changed.  The pads and texts
+     * of a footprint record their footprint.
+     */
+    void MarkChanged( const BOARD_ITEM* aItem );
+
+    ///> Records that the board was changed without MarkChanged(): the next save is full
+    void Invalidate() { m_valid = false; }
+
+    /**
+     * Function Append
+     * appends the changes of \a aBoard since the last save to the journal file of
+     * \a aBoardFileName, and syncs it to the disk.
+     * @return false if the changes cannot be journaled, and need a full save: the
+     *  journal was not started for this file, the board file was written since, or the
+     *  board settings changed.
+     * @throw IO_ERROR if the journal file cannot be written.  The next save is then full.
+     */
+    bool Append( BOARD* aBoard, const wxString& aBoardFileName ) throw( IO_ERROR );
+
+private:
+    typedef boost::unordered_map<const BOARD_ITEM*, unsigned>   ITEM_IDS;
+    typedef std::pair<bool, uint64_t>                           ZONE_FILL;
+    typedef boost::unordered_map<const BOARD_ITEM*, ZONE_FILL>  ZONE_FILLS;
+
+    ///> Appends the items of aBoard saved in a board file to aItems, in the file order
+    static void collectItems( BOARD* aBoard, std::vector<BOARD_ITEM*>* aItems );
+
+    ///> Returns the filled state of a zone: a zone whose state changed was refilled
+    static ZONE_FILL zoneFill( const BOARD_ITEM* aZone );
+
+    ///> Returns the size and date of a file, empty if it does not exist
+    static wxString fileStamp( const wxString& aFileName );
+
+    ///> Returns the hash of the settings and net classes saved in the board file
+    static uint64_t settingsHash( BOARD* aBoard );
+
+    ///> Returns the hash of the net table of aBoard
+    static uint64_t netsHash( BOARD* aBoard );
+
+    ///> Records aItems, the items of aBoard by id, and its settings
+    void recordBoard( BOARD* aBoard, const wxString& aBoardFileName,
+                      const std::vector<BOARD_ITEM*>& aItems );
+
+    // apply a record read by Open() to aBoard, whose items by id are aItems
+    bool applyRecord( BOARD* aBoard, const BOARD_JOURNAL_RECORD& aRecord,
+                      std::vector<BOARD_ITEM*>& aItems );
+
+    wxString    m_boardFileName;
+    wxString    m_base;             ///< fileStamp() of the board file
+    ITEM_IDS    m_ids;              ///< the items of the board at the last save
+    unsigned    m_nextId;           ///< the id of the next item added
+    ZONE_FILLS  m_zoneFills;        ///< the filled state of the zones at the last save
+    uint64_t    m_settingsHash;
+    uint64_t    m_netsHash;         ///< of the net table last written, 0 if none yet
+
+    boost::unordered_set<const BOARD_ITEM*> m_changed;
+
+    bool        m_started;
+    bool        m_valid;            ///< false when the next save must be full
+    bool        m_fileStarted;      ///< the journal file continues the recorded state
+};
+
+#endif  // _BOARD_JOURNAL_H
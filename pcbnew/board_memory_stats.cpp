@@ -0,0 +1,265 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file board_memory_stats.cpp
+ * @brief The memory usage report of the board editor.
+ */
+
+#include <fctsys.h>
+#include <confirm.h>
+#include <memory_stats.h>
+#include <wxPcbStruct.h>
+#include <class_drawpanel.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <class_pad.h>
+#include <class_drawsegment.h>
+#include <class_pcb_text.h>
+#include <class_text_mod.h>
+#include <class_edge_mod.h>
+#include <class_dimension.h>
+#include <class_mire.h>
+#include <class_marker_pcb.h>
+#include <ratsnest_data.h>
+
+#include <wx/filedlg.h>
+#include <wx/msgdlg.h>
+
+
+// The size of a zone outline and filled areas, without the zone itself
+static size_t zoneDataBytes( const ZONE_CONTAINER* aZone )
+{
+    return aZone->GetNumCorners() * sizeof( CPolyPt )
+           + aZone->GetFilledPolysList().TotalVertices() * sizeof( VECTOR2I )
+           + aZone->FillSegments().size() * sizeof( SEGMENT );
+}
+
+
+/**
+ * Function itemBytes
+ * returns the estimated size of an item, with the items of a footprint and the outline
+ * and filled areas of a zone.
+ */
+static size_t itemBytes( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:           return sizeof( TRACK );
+    case PCB_VIA_T:             return sizeof( VIA );
+    case PCB_ZONE_T:            return sizeof( SEGZONE );
+    case PCB_PAD_T:             return sizeof( D_PAD );
+    case PCB_LINE_T:            return sizeof( DRAWSEGMENT );
+    case PCB_TEXT_T:            return sizeof( TEXTE_PCB );
+    case PCB_MODULE_TEXT_T:     return sizeof( TEXTE_MODULE );
+    case PCB_MODULE_EDGE_T:     return sizeof( EDGE_MODULE );
+    case PCB_DIMENSION_T:       return sizeof( DIMENSION );
+    case PCB_TARGET_T:          return sizeof( PCB_TARGET );
+    case PCB_MARKER_T:          return sizeof( MARKER_PCB );
+
+    case PCB_ZONE_AREA_T:
+        return sizeof( ZONE_CONTAINER ) + zoneDataBytes( (const ZONE_CONTAINER*) aItem );
+
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = (const MODULE*) aItem;
+        size_t        bytes = sizeof( MODULE ) + 2 * sizeof( TEXTE_MODULE );
+
+        for( const D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            bytes += sizeof( D_PAD );
+
+        for( const BOARD_ITEM* item = module->GraphicalItems(); item; item = item->Next() )
+            bytes += itemBytes( item );
+
+        return bytes;
+    }
+
+    default:
+        return sizeof( BOARD_ITEM );
+    }
+}
+
+
+// Adds the commands of an undo or redo list, and the item copies they own
+static void addUndoStats( MEMORY_STATS& aStats, const wxString& aItems,
+                          const UNDO_REDO_CONTAINER& aList )
+{
+    size_t pickers = 0;
+    size_t bytes = 0;
+
+    for( unsigned i = 0; i < aList.m_CommandsList.size(); i++ )
+    {
+        const PICKED_ITEMS_LIST* command = aList.m_CommandsList[i];
+
+        bytes += sizeof( PICKED_ITEMS_LIST );
+
+        for( unsigned j = 0; j < command->GetCount(); j++ )
+        {
+            const BOARD_ITEM* link = (const BOARD_ITEM*) command->GetPickedItemLink( j );
+
+            ++pickers;
+            bytes += sizeof( ITEM_PICKER );
+
+            // the copies of the changed items, and the deleted items, are owned by the list
+            if( link )
+                bytes += itemBytes( link );
+            else if( command->GetPickedItemStatus( j ) == UR_DELETED
+                     && command->GetPickedItem( j ) )
+                bytes += itemBytes( (const BOARD_ITEM*) command->GetPickedItem( j ) );
+        }
+    }
+
+    aStats.Add( _( "Undo history" ), aItems, pickers, bytes );
+}
+
+
+void PCB_EDIT_FRAME::CollectMemoryStats( MEMORY_STATS& aStats )
+{
+    BOARD*   board = GetBoard();
+    wxString subsystem = _( "Board" );
+    size_t   count = 0, bytes = 0;
+
+    for( const TRACK* track = board->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() == PCB_TRACE_T )
+        {
+            ++count;
+            bytes += sizeof( TRACK );
+        }
+    }
+
+    aStats.Add( subsystem, _( "tracks" ), count, bytes );
+
+    count = board->m_Track.GetCount() - count;
+    aStats.Add( subsystem, _( "vias" ), count, count * sizeof( VIA ) );
+
+    count = bytes = 0;
+
+    for( const MODULE* module = board->m_Modules; module; module = module->Next() )
+    {
+        ++count;
+        bytes += itemBytes( module );
+    }
+
+    aStats.Add( subsystem, _( "footprints" ), count, bytes );
+
+    count = bytes = 0;
+
+    for( const BOARD_ITEM* item = board->m_Drawings; item; item = item->Next() )
+    {
+        ++count;
+        bytes += itemBytes( item );
+    }
+
+    aStats.Add( subsystem, _( "drawings" ), count, bytes );
+
+    count = bytes = 0;
+
+    for( int ii = 0; ii < board->GetAreaCount(); ii++ )
+    {
+        const ZONE_CONTAINER* zone = board->GetArea( ii );
+
+        ++count;
+        bytes += sizeof( ZONE_CONTAINER ) + zone->GetNumCorners() * sizeof( CPolyPt );
+    }
+
+    aStats.Add( subsystem, _( "zones" ), count, bytes );
+
+    // The filled areas, usually the biggest part of the board
+    size_t vertices = 0;
+
+    bytes = 0;
+
+    for( int ii = 0; ii < board->GetAreaCount(); ii++ )
+    {
+        const ZONE_CONTAINER* zone = board->GetArea( ii );
+
+        vertices += zone->GetFilledPolysList().TotalVertices();
+        bytes += zoneDataBytes( zone ) - zone->GetNumCorners() * sizeof( CPolyPt );
+    }
+
+    aStats.Add( _( "Zone fills" ), _( "filled area vertices" ), vertices, bytes );
+
+    count = board->m_Zone.GetCount();
+    aStats.Add( _( "Zone fills" ), _( "legacy fill segments" ), count, count * sizeof( SEGZONE ) );
+
+    aStats.Add( subsystem, _( "markers" ), board->GetMARKERCount(),
+                board->GetMARKERCount() * sizeof( MARKER_PCB ) );
+
+    addUndoStats( aStats, _( "undo commands" ), GetScreen()->m_UndoList );
+    addUndoStats( aStats, _( "redo commands" ), GetScreen()->m_RedoList );
+
+    // The ratsnest of the GAL canvas, the net 0 is not handled by the ratsnest
+    RN_DATA* ratsnest = board->GetRatsnest();
+    size_t   nodes = 0, connections = 0, unconnected = 0;
+
+    for( int net = 1; net < ratsnest->GetNetCount(); net++ )
+    {
+        const RN_NET& rnNet = ratsnest->GetNet( net );
+
+        nodes += rnNet.GetNodeCount();
+        connections += rnNet.GetConnectionCount();
+
+        if( rnNet.GetUnconnected() )
+            unconnected += rnNet.GetUnconnected()->size();
+    }
+
+    aStats.Add( _( "Ratsnest" ), _( "nodes" ), nodes, nodes * sizeof( RN_NODE ) );
+    aStats.Add( _( "Ratsnest" ), _( "connections" ), connections,
+                connections * sizeof( RN_EDGE_MST ) );
+    aStats.Add( _( "Ratsnest" ), _( "unconnected edges" ), unconnected,
+                unconnected * sizeof( RN_EDGE_MST ) );
+
+    MEMORY_STATS::CollectRegistered( aStats );
+}
+
+
+void PCB_EDIT_FRAME::ShowMemoryStats( wxCommandEvent& event )
+{
+    MEMORY_STATS stats;
+
+    CollectMemoryStats( stats );
+
+    wxMessageDialog dlg( this, _( "Estimated memory usage, without the allocator overhead:" ),
+                         _( "Memory Usage" ), wxYES_NO | wxICON_INFORMATION );
+
+    dlg.SetExtendedMessage( stats.Format() );
+    dlg.SetYesNoLabels( _( "&Save..." ), _( "&Close" ) );
+
+    if( dlg.ShowModal() != wxID_YES )
+        return;
+
+    wxFileDialog fileDlg( this, _( "Save Memory Usage Report" ), wxEmptyString,
+                          wxT( "memory_usage.txt" ), wxT( "*.txt" ),
+                          wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( fileDlg.ShowModal() == wxID_CANCEL )
+        return;
+
+    if( !stats.Write( fileDlg.GetPath() ) )
+        DisplayError( this, wxString::Format( _( "Unable to create file '%s'" ),
+                                              GetChars( fileDlg.GetPath() ) ) );
+}
@@ -49,6 +49,38 @@
 #include <wxPcbStruct.h>
 
 
+BOARD_FOOTPRINT_MAP::BOARD_FOOTPRINT_MAP( BOARD* aBoard, bool aByTimeStamp ) :
+    m_byTimeStamp( aByTimeStamp )
+{
+    for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
+        Add( aByTimeStamp ? module->GetPath() : module->GetReference(), module );
+}
+
+
+MODULE* BOARD_FOOTPRINT_MAP::Find( const wxString& aRefOrTimeStamp ) const
+{
+    MODULE_MAP::const_iterator it = m_modules.find( key( aRefOrTimeStamp ) );
+
+    return it != m_modules.end() ? it->second : NULL;
+}
+
+
+void BOARD_FOOTPRINT_MAP::Add( const wxString& aRefOrTimeStamp, MODULE* aModule )
+{
+    // The first footprint of the board list is found
+    m_modules.insert( std::make_pair( key( aRefOrTimeStamp ), aModule ) );
+}
+
+
+void BOARD_FOOTPRINT_MAP::Remove( const wxString& aRefOrTimeStamp, MODULE* aModule )
+{
+    MODULE_MAP::iterator it = m_modules.find( key( aRefOrTimeStamp ) );
+
+    if( it != m_modules.end() && it->second == aModule )
+        m_modules.erase( it );
+}
+
+
 BOARD_NETLIST_UPDATER::BOARD_NETLIST_UPDATER ( PCB_EDIT_FRAME *aFrame, BOARD *aBoard ) :
     m_frame ( aFrame ),
     m_board( aBoard )
@@ -77,15 +109,28 @@ void BOARD_NETLIST_UPDATER::pushUndo( BOARD_ITEM* aItem, UNDO_REDO_T aCommandTyp
 
     if( aCommandType == UR_CHANGED )
     {
-        if( m_undoList->FindItem ( aItem ) >= 0 ) // add only once
+        if( m_undoItems.count( aItem ) ) // add only once
+        {
+            delete aCopy;
             return;
+        }
 
         picker.SetLink( aCopy ? aCopy : aItem->Clone() );
     }
 
+    m_undoItems.insert( aItem );
     m_undoList->PushItem( picker );
 }
 
+
+MODULE* BOARD_NETLIST_UPDATER::undoCopy( MODULE* aModule )
+{
+    if( m_undoItems.count( aModule ) )
+        return NULL;
+
+    return (MODULE*) aModule->Clone();
+}
+
 wxPoint BOARD_NETLIST_UPDATER::estimateComponentInsertionPosition()
 {
     wxPoint bestPosition;
@@ -252,7 +297,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( MODULE *aPcbComponent, CO
         return false;
 
     bool changed = false;
-    MODULE* copy = (MODULE*) aPcbComponent->Clone();
+    MODULE* copy = NULL;    // made before the first change
 
     // Test for reference designator field change.
     if( aPcbComponent->GetReference() != aNewComponent->GetReference() )
@@ -272,6 +317,9 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( MODULE *aPcbComponent, CO
 
         if ( !m_isDryRun )
         {
+            if( !changed )
+                copy = undoCopy( aPcbComponent );
+
             changed = true;
             aPcbComponent->SetReference( aNewComponent->GetReference() );
         }
@@ -296,6 +344,9 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( MODULE *aPcbComponent, CO
 
         if ( !m_isDryRun )
         {
+            if( !changed )
+                copy = undoCopy( aPcbComponent );
+
             changed = true;
             aPcbComponent->SetValue( aNewComponent->GetValue() );
         }
@@ -312,6 +363,9 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( MODULE *aPcbComponent, CO
 
         if ( !m_isDryRun )
         {
+            if( !changed )
+                copy = undoCopy( aPcbComponent );
+
             changed = true;
             aPcbComponent->SetPath( aNewComponent->GetTimeStamp() );
         }
@@ -319,8 +373,6 @@ bool BOARD_NETLIST_UPDATER::updateComponentParameters( MODULE *aPcbComponent, CO
 
     if( changed )
         pushUndo( aPcbComponent, UR_CHANGED, copy );
-    else
-        delete copy;
 
     return true;
 }
@@ -330,7 +382,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE *aPcbComponent
     wxString msg;
 
     bool changed = false;
-    MODULE* copy = (MODULE*) aPcbComponent->Clone();
+    MODULE* copy = NULL;    // made before the first change
 
     // At this point, the component footprint is updated.  Now update the nets.
     for( D_PAD *pad = aPcbComponent->Pads(); pad; pad = pad->Next() )
@@ -354,8 +406,11 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE *aPcbComponent
 
             }
 
-            if( !m_isDryRun )
+            if( !m_isDryRun && pad->GetNetCode() != NETINFO_LIST::UNCONNECTED )
             {
+                if( !changed )
+                    copy = undoCopy( aPcbComponent );
+
                 changed = true;
                 pad->SetNetCode( NETINFO_LIST::UNCONNECTED );
             }
@@ -371,6 +426,9 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE *aPcbComponent
                     // It is a new net, we have to add it
                     if( !m_isDryRun )
                     {
+                        if( !changed )
+                            copy = undoCopy( aPcbComponent );
+
                         changed = true;
                         netinfo = new NETINFO_ITEM( m_board, net.GetNetName() );
                         m_board->AppendNet( netinfo );
@@ -412,6 +470,9 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE *aPcbComponent
 
                 if ( !m_isDryRun )
                 {
+                    if( !changed )
+                        copy = undoCopy( aPcbComponent );
+
                     changed = true;
                     pad->SetNetCode( netinfo->GetNet() );
                 }
@@ -421,8 +482,6 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE *aPcbComponent
 
     if( changed )
         pushUndo( aPcbComponent, UR_CHANGED, copy );
-    else
-        delete copy;
 
     return true;
 }
@@ -431,7 +490,17 @@ bool BOARD_NETLIST_UPDATER::deleteUnusedComponents( NETLIST& aNetlist )
 {
     wxString msg;
     MODULE* nextModule;
-    const COMPONENT* component;
+
+    // The references or time stamps of the components
+    boost::unordered_set<wxString, WXSTRING_HASH> components;
+
+    for( unsigned i = 0; i < aNetlist.GetCount(); i++ )
+    {
+        COMPONENT* component = aNetlist.GetComponent( i );
+
+        components.insert( m_lookupByTimestamp ? component->GetTimeStamp()
+                                               : component->GetReference() );
+    }
 
     for( MODULE* module = m_board->m_Modules; module != NULL; module = nextModule )
     {
@@ -440,12 +509,8 @@ bool BOARD_NETLIST_UPDATER::deleteUnusedComponents( NETLIST& aNetlist )
         if( module->IsLocked() )
             continue;
 
-        if( m_lookupByTimestamp )
-            component = aNetlist.GetComponentByTimeStamp( module->GetPath() );
-        else
-            component = aNetlist.GetComponentByReference( module->GetReference() );
-
-        if( component == NULL )
+        if( !components.count( m_lookupByTimestamp ? module->GetPath()
+                                                   : module->GetReference() ) )
         {
             msg.Printf( _( "Remove component %s." ),
                         GetChars( module->GetReference() ) );
@@ -569,11 +634,12 @@ bool BOARD_NETLIST_UPDATER::testConnectivity( NETLIST& aNetlist )
 
     wxString msg;
     wxString padname;
+    BOARD_FOOTPRINT_MAP footprints( m_board, false );
 
     for( int i = 0; i < (int) aNetlist.GetCount(); i++ )
     {
         const COMPONENT* component = aNetlist.GetComponent( i );
-        MODULE* footprint = m_board->FindModuleByReference( component->GetReference() );
+        MODULE* footprint = footprints.Find( component->GetReference() );
 
         if( footprint == NULL )    // It can be missing in partial designs
             continue;
@@ -631,6 +697,7 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
         m_board->SetStatus( 0 );
     }
 
+    BOARD_FOOTPRINT_MAP footprints( m_board, aNetlist.IsFindByTimeStamp() );
 
     for( int i = 0; i < (int) aNetlist.GetCount();  i++ )
     {
@@ -644,16 +711,19 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
 
         m_reporter->Report( msg, REPORTER::RPT_INFO );
 
-        if( aNetlist.IsFindByTimeStamp() )
-            footprint = m_board->FindModule( component->GetTimeStamp(), true );
-        else
-            footprint = m_board->FindModule( component->GetReference() );
+        const wxString& key = aNetlist.IsFindByTimeStamp() ? component->GetTimeStamp()
+                                                            : component->GetReference();
+
+        footprint = footprints.Find( key );
 
         if( footprint )        // An existing footprint.
         {
             MODULE *newFootprint = replaceComponent ( aNetlist, footprint, component );
             if ( newFootprint )
+            {
+                footprints.Remove( key, footprint );
                 footprint = newFootprint;
+            }
         }
         else
         {
@@ -664,6 +734,10 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
         {
             updateComponentParameters( footprint, component );
             updateComponentPadConnections( footprint, component );
+
+            // Now found by its new reference or time stamp, as by BOARD::FindModule()
+            if( !m_isDryRun )
+                footprints.Add( key, footprint );
         }
     }
 
@@ -43,6 +43,44 @@ class PICKED_ITEMS_LIST;
 class PCB_EDIT_FRAME;
 
 #include <class_undoredo_container.h>
+#include <hashtables.h>
+
+#include <boost/unordered_set.hpp>
+
+
+/**
+ * Class BOARD_FOOTPRINT_MAP
+ * finds the footprints of a #BOARD by reference or by time stamp path as
+ * BOARD::FindModule() does, in a hash table built once instead of a scan of the
+ * footprint list for each component of a #NETLIST.  The time stamps are compared
+ * without case, as BOARD::FindModule() does.
+ */
+class BOARD_FOOTPRINT_MAP
+{
+public:
+	BOARD_FOOTPRINT_MAP( BOARD* aBoard, bool aByTimeStamp );
+
+	///> @return the first footprint of the board having the reference or time stamp, or NULL
+	MODULE* Find( const wxString& aRefOrTimeStamp ) const;
+
+	///> Adds a footprint under a reference or time stamp, unless one has it already
+	void Add( const wxString& aRefOrTimeStamp, MODULE* aModule );
+
+	///> Removes a footprint removed from the board
+	void Remove( const wxString& aRefOrTimeStamp, MODULE* aModule );
+
+private:
+	typedef boost::unordered_map<wxString, MODULE*, WXSTRING_HASH> MODULE_MAP;
+
+	wxString key( const wxString& aRefOrTimeStamp ) const
+	{
+		return m_byTimeStamp ? aRefOrTimeStamp.Upper() : aRefOrTimeStamp;
+	}
+
+	MODULE_MAP m_modules;
+	bool m_byTimeStamp;
+};
+
 
 /**
  * Class BOARD_NETLIST_UPDATER
@@ -68,6 +106,10 @@ class PCB_EDIT_FRAME;
  * - After all of the footprints have been added, updated, and net names properly set,
  *   any extra unlock footprints are removed from the #BOARD.
  *
+ * The changes of all the components are made in one pass: the footprints are found in
+ * hash tables, a footprint is copied for the undo list only before its first change,
+ * and all the changes are saved in one undo entry.  The connectivity and the ratsnest
+ * are built once at the end.
  */
 class BOARD_NETLIST_UPDATER
 {
@@ -136,6 +178,9 @@ private:
 
 	void pushUndo( BOARD_ITEM* aItem, UNDO_REDO_T aCommandType, BOARD_ITEM* aCopy = NULL );
 
+	///> @return a copy of aModule for the undo list, or NULL if it is already in the list
+	MODULE* undoCopy( MODULE* aModule );
+
 	wxPoint estimateComponentInsertionPosition();
 	MODULE* addNewComponent( COMPONENT* aComponent );
 	MODULE* replaceComponent( NETLIST& aNetlist, MODULE *aPcbComponent, COMPONENT* aNewComponent );
@@ -146,6 +191,7 @@ private:
 	bool testConnectivity( NETLIST& aNetlist );
 
 	PICKED_ITEMS_LIST *m_undoList;
+	boost::unordered_set<const BOARD_ITEM*> m_undoItems;   // the items of m_undoList
 	PCB_EDIT_FRAME *m_frame;
 	BOARD *m_board;
 	REPORTER *m_reporter;
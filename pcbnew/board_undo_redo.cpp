@@ -24,6 +24,7 @@
  */
 
 #include <boost/bind.hpp>
+#include <boost/unordered_set.hpp>
 #include <fctsys.h>
 #include <class_drawpanel.h>
 #include <class_draw_panel_gal.h>
@@ -101,90 +102,76 @@
  */
 
 
+/// The top level items of a board, for the integrity tests of PutDataInPreviousState()
+typedef boost::unordered_set<const BOARD_ITEM*> BOARD_ITEM_SET;
+
+
 /**
- * Function TestForExistingItem
- * test if aItem exists somewhere in lists of items
- * This is a function used by PutDataInPreviousState to be sure an item was not deleted
+ * Function collectExistingItems
+ * fills aItems with the items existing somewhere in lists of items of aPcb.
+ * It is used by PutDataInPreviousState to be sure an item was not deleted
  * since an undo or redo.
  * This could be possible:
  *   - if a call to SaveCopyInUndoList was forgotten in Pcbnew
  *   - in zones outlines, when a change in one zone merges this zone with an other
- * This function avoids a Pcbnew crash
- * Before using this function to test existence of items,
- * it must be called with aItem = NULL to prepare the list
+ * This test avoids a Pcbnew crash
  * @param aPcb = board to test
- * @param aItem = item to find
- *              = NULL to build the list of existing items
+ * @param aItems = the set to fill with the existing items
  */
-
-static bool TestForExistingItem( BOARD* aPcb, BOARD_ITEM* aItem )
+static void collectExistingItems( BOARD* aPcb, BOARD_ITEM_SET& aItems )
 {
-    static std::vector<BOARD_ITEM*> itemsList;
-
-    if( aItem == NULL ) // Build list
-    {
-        // Count items to store in itemsList:
-        int icnt = 0;
-        BOARD_ITEM* item;
-
-        // Count tracks:
-        for( item = aPcb->m_Track; item != NULL; item = item->Next() )
-            icnt++;
-
-        // Count modules:
-        for( item = aPcb->m_Modules; item != NULL; item = item->Next() )
-            icnt++;
-
-        // Count drawings
-        for( item = aPcb->m_Drawings; item != NULL; item = item->Next() )
-            icnt++;
-
-        // Count zones outlines
-        icnt +=  aPcb->GetAreaCount();
+    NETINFO_LIST& netInfo = aPcb->GetNetInfo();
+    BOARD_ITEM* item;
 
-        // Count zones segm (now obsolete):
-        for( item = aPcb->m_Zone; item != NULL; item = item->Next() )
-             icnt++;
+    aItems.clear();
+    aItems.rehash( aPcb->m_Track.GetCount() + aPcb->m_Modules.GetCount() +
+                   aPcb->m_Drawings.GetCount() + aPcb->GetAreaCount() +
+                   aPcb->m_Zone.GetCount() + netInfo.GetNetCount() );
 
-        NETINFO_LIST& netInfo = aPcb->GetNetInfo();
+    for( item = aPcb->m_Track; item != NULL; item = item->Next() )
+        aItems.insert( item );
 
-        icnt += netInfo.GetNetCount();
+    for( item = aPcb->m_Modules; item != NULL; item = item->Next() )
+        aItems.insert( item );
 
-        // Build candidate list:
-        itemsList.clear();
-        itemsList.reserve(icnt);
+    for( item = aPcb->m_Drawings; item != NULL; item = item->Next() )
+        aItems.insert( item );
 
-        // Store items in list:
-        // Append tracks:
-        for( item = aPcb->m_Track; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+    // zones outlines
+    for( int ii = 0; ii < aPcb->GetAreaCount(); ii++ )
+        aItems.insert( aPcb->GetArea( ii ) );
 
-        // Append modules:
-        for( item = aPcb->m_Modules; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+    // zones segm (now obsolete)
+    for( item = aPcb->m_Zone; item != NULL; item = item->Next() )
+        aItems.insert( item );
 
-        // Append drawings
-        for( item = aPcb->m_Drawings; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+    for( NETINFO_LIST::iterator i = netInfo.begin(); i != netInfo.end(); ++i )
+        aItems.insert( *i );
+}
 
-        // Append zones outlines
-        for( int ii = 0; ii < aPcb->GetAreaCount(); ii++ )
-            itemsList.push_back( aPcb->GetArea( ii ) );
 
-        // Append zones segm:
-        for( item = aPcb->m_Zone; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+/**
+ * Function dropZoneFill
+ * removes the filled areas from the copy of a zone kept in the undo or redo list.
+ * They are the largest part of a zone, and can be built again from its outlines:
+ * the copy is flagged as not filled, so a zone put back by PutDataInPreviousState()
+ * is shown unfilled until the user fills it again.  Refilling it there would turn
+ * the undo into a fill, and would not give back a fill which was left outdated.
+ */
+static void dropZoneFill( EDA_ITEM* aImage )
+{
+    if( aImage == NULL || aImage->Type() != PCB_ZONE_AREA_T )
+        return;
 
-        for( NETINFO_LIST::iterator i = netInfo.begin(); i != netInfo.end(); ++i )
-            itemsList.push_back( *i );
+    ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( aImage );
 
-        // Sort list
-        std::sort( itemsList.begin(), itemsList.end() );
-        return false;
-    }
+    if( !zone->IsFilled() )
+        return;
 
-    // search in list:
-    return std::binary_search( itemsList.begin(), itemsList.end(), aItem );
+    zone->ClearFilledPolysList();
+    zone->FillSegments().clear();
+    zone->SetIsFilled( false );
+    zone->SetFillHash( 0 );
 }
 
 
@@ -336,6 +323,8 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM*    aItem,
     case UR_CHANGED:                        // Create a copy of item
         if( itemWrapper.GetLink() == NULL ) // When not null, the copy is already done
             itemWrapper.SetLink( aItem->Clone() );
+
+        dropZoneFill( itemWrapper.GetLink() );
         commandToUndo->PushItem( itemWrapper );
         break;
 
@@ -366,6 +355,13 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM*    aItem,
 
     if( commandToUndo->GetCount() )
     {
+        // Written by the next incremental save
+        m_journal.MarkChanged( aItem );
+
+        // Notified to the board listeners by OnModify()
+        if( aCommandType != UR_DELETED )
+            GetBoard()->MarkItemChanged( aItem );
+
         /* Save the copy in undo list */
         GetScreen()->PushCommandToUndoList( commandToUndo );
 
@@ -451,6 +447,9 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsList,
                 EDA_ITEM* cloned = item->Clone();
                 commandToUndo->SetPickedItemLink( cloned, ii );
             }
+
+            // Also the copies of zones made by SaveCopyOfZones()
+            dropZoneFill( commandToUndo->GetPickedItemLink( ii ) );
             break;
 
         case UR_MOVED:
@@ -475,6 +474,18 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( const PICKED_ITEMS_LIST& aItemsList,
 
     if( commandToUndo->GetCount() )
     {
+        // Written by the next incremental save
+        for( unsigned ii = 0; ii < commandToUndo->GetCount(); ii++ )
+        {
+            BOARD_ITEM* item = (BOARD_ITEM*) commandToUndo->GetPickedItem( ii );
+
+            m_journal.MarkChanged( item );
+
+            // Notified to the board listeners by OnModify()
+            if( commandToUndo->GetPickedItemStatus( ii ) != UR_DELETED )
+                GetBoard()->MarkItemChanged( item );
+        }
+
         /* Save the copy in undo list */
         GetScreen()->PushCommandToUndoList( commandToUndo );
 
@@ -503,6 +514,7 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
     // like the same item can be changes and deleted in the same complex command
 
     bool build_item_list = true;    // if true the list of existing items must be rebuilt
+    BOARD_ITEM_SET existingItems;
 
     for( int ii = aList->GetCount() - 1; ii >= 0 ; ii-- )
     {
@@ -522,11 +534,11 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
         {
             if( build_item_list )
                 // Build list of existing items, for integrity test
-                TestForExistingItem( GetBoard(), NULL );
+                collectExistingItems( GetBoard(), existingItems );
 
             build_item_list = false;
 
-            if( !TestForExistingItem( GetBoard(), item ) )
+            if( existingItems.count( item ) == 0 )
             {
                 // Remove this non existent item
                 aList->RemovePicker( ii );
@@ -538,6 +550,7 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
         }
 
         item->ClearFlags();
+        m_journal.MarkChanged( item );
 
         // see if we must rebuild ratsnets and pointers lists
         switch( item->Type() )
@@ -576,6 +589,9 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
 
             item->SwapData( image );
 
+            // The copy now holds the state to redo, or to undo again
+            dropZoneFill( image );
+
             // Update all pads/drawings/texts, as they become invalid
             // for the VIEW after SwapData() called for modules
             if( item->Type() == PCB_MODULE_T )
@@ -586,6 +602,9 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
             view->Add( item );
             ratsnest->Add( item );
 
+            // The item, and the pads of a footprint, have new positions in the board index
+            GetBoard()->OnItemChanged( item );
+
             item->ClearFlags( SELECTED );
             item->ViewUpdate( KIGFX::VIEW_ITEM::LAYERS );
         }
@@ -617,7 +636,9 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
             view->Add( item );
 
             item->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
-            build_item_list = true;
+
+            // The restored item exists again, for the next items of the list
+            existingItems.insert( item );
             break;
 
         case UR_MOVED:
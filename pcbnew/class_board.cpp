@@ -32,6 +32,7 @@
 
 #include <limits.h>
 #include <algorithm>
+#include <map>
 
 #include <fctsys.h>
 #include <common.h>
@@ -43,6 +44,9 @@
 #include <base_units.h>
 #include <ratsnest_data.h>
 #include <ratsnest_viewitem.h>
+#include <board_item_index.h>
+#include <net_lengths.h>
+#include <copper_occupancy_map.h>
 #include <worksheet_viewitem.h>
 
 #include <pcbnew.h>
@@ -59,6 +63,10 @@
 #include <class_mire.h>
 #include <class_dimension.h>
 
+#include <boost/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
 
 /* This is an odd place for this, but CvPcb won't link if it is
  *  in class_board_item.cpp like I first tried it.
@@ -107,16 +115,21 @@ BOARD::BOARD() :
 
     // Initialize ratsnest
     m_ratsnest = new RN_DATA( this );
+
+    m_itemIndex = new BOARD_ITEM_INDEX( this );
+    m_netLengths = new BOARD_NET_LENGTHS( this );
+    m_copperOccupancy = new COPPER_OCCUPANCY_MAP( this );
 }
 
 
 BOARD::~BOARD()
 {
-    while( m_ZoneDescriptorList.size() )
-    {
-        ZONE_CONTAINER* area_to_remove = m_ZoneDescriptorList[0];
-        Delete( area_to_remove );
-    }
+    // The zones are not removed from the ratsnest deleted with them, the items of a
+    // Snapshot() copy were never added to it
+    for( unsigned i = 0; i < m_ZoneDescriptorList.size(); ++i )
+        delete m_ZoneDescriptorList[i];
+
+    m_ZoneDescriptorList.clear();
 
     delete m_ratsnest;
 
@@ -128,6 +141,10 @@ BOARD::~BOARD()
 
     delete m_CurrentZoneContour;
     m_CurrentZoneContour = NULL;
+
+    delete m_itemIndex;
+    delete m_netLengths;
+    delete m_copperOccupancy;
 }
 
 
@@ -182,9 +199,131 @@ void BOARD::Move( const wxPoint& aMoveVector )        // overload
 }
 
 
-void BOARD::chainMarkedSegments( wxPoint aPosition, const LSET& aLayerMask, TRACK_PTRS* aList )
+/**
+ * Class TRACK_ENDPOINTS
+ * is the adjacency of the tracks of a board, used by MarkTrace(): the tracks and vias by
+ * end point, and the vias by cell of a grid as large as the largest via.  It is built
+ * in one pass over the track list, then each connection is found in constant time,
+ * instead of a scan of the list.  It is built at each MarkTrace() call, which the
+ * legacy tools use on tracks just inserted in the list, before any notification.
+ */
+class TRACK_ENDPOINTS
 {
-    TRACK*  segment;            // The current segment being analyzed.
+public:
+    TRACK_ENDPOINTS( TRACK* aTracks ) :
+        m_viaCell( 1 )
+    {
+        std::vector<VIA*> vias;
+
+        for( TRACK* track = aTracks; track; track = track->Next() )
+        {
+            if( track->GetState( IS_DELETED ) )
+                continue;
+
+            m_tracks[ key( track->GetStart() ) ].push_back( track );
+
+            if( track->GetEnd() != track->GetStart() )
+                m_tracks[ key( track->GetEnd() ) ].push_back( track );
+
+            if( track->Type() == PCB_VIA_T )
+            {
+                vias.push_back( static_cast<VIA*>( track ) );
+                m_viaCell = std::max( m_viaCell, track->GetWidth() );
+            }
+        }
+
+        for( unsigned ii = 0; ii < vias.size(); ii++ )
+            m_vias[ cell( vias[ii]->GetStart() ) ].push_back( vias[ii] );
+    }
+
+    /**
+     * Function TracksAt
+     * collects the tracks of aLayerMask with an end at aPosition, which are not flagged
+     * BUSY or IS_DELETED, in the order of the list: the ones ::GetTrack() finds one
+     * after the other from the start of the list.
+     */
+    void TracksAt( const wxPoint& aPosition, LSET aLayerMask, TRACK_PTRS& aTracks ) const
+    {
+        aTracks.clear();
+
+        ENDPOINT_MAP::const_iterator it = m_tracks.find( key( aPosition ) );
+
+        if( it == m_tracks.end() )
+            return;
+
+        for( unsigned ii = 0; ii < it->second.size(); ii++ )
+        {
+            TRACK* track = it->second[ii];
+
+            if( track->GetState( IS_DELETED | BUSY ) == 0
+                && ( aLayerMask & track->GetLayerSet() ).any() )
+                aTracks.push_back( track );
+        }
+    }
+
+    /**
+     * Function ViaAt
+     * @return a via of aLayerMask hit at aPosition, not flagged BUSY or IS_DELETED,
+     * as TRACK::GetVia() finds it (the one at the start of the list, when vias overlap).
+     */
+    VIA* ViaAt( const wxPoint& aPosition, LSET aLayerMask ) const
+    {
+        std::pair<int, int> center = cell( aPosition );
+
+        // The vias hit at aPosition have their centers in the neighbour cells
+        for( int dx = -1; dx <= 1; dx++ )
+        {
+            for( int dy = -1; dy <= 1; dy++ )
+            {
+                VIA_MAP::const_iterator it =
+                        m_vias.find( std::make_pair( center.first + dx, center.second + dy ) );
+
+                if( it == m_vias.end() )
+                    continue;
+
+                for( unsigned ii = 0; ii < it->second.size(); ii++ )
+                {
+                    VIA* via = it->second[ii];
+
+                    if( via->HitTest( aPosition ) && !via->GetState( BUSY | IS_DELETED )
+                        && ( aLayerMask & via->GetLayerSet() ).any() )
+                        return via;
+                }
+            }
+        }
+
+        return NULL;
+    }
+
+private:
+    typedef boost::unordered_map< std::pair<int, int>, TRACK_PTRS >           ENDPOINT_MAP;
+    typedef boost::unordered_map< std::pair<int, int>, std::vector<VIA*> >    VIA_MAP;
+
+    static std::pair<int, int> key( const wxPoint& aPosition )
+    {
+        return std::make_pair( aPosition.x, aPosition.y );
+    }
+
+    std::pair<int, int> cell( const wxPoint& aPosition ) const
+    {
+        return std::make_pair( floorDiv( aPosition.x ), floorDiv( aPosition.y ) );
+    }
+
+    int floorDiv( int aCoord ) const
+    {
+        return aCoord >= 0 ? aCoord / m_viaCell : -( ( -aCoord - 1 ) / m_viaCell ) - 1;
+    }
+
+    ENDPOINT_MAP    m_tracks;
+    VIA_MAP         m_vias;
+    int             m_viaCell;
+};
+
+
+void BOARD::chainMarkedSegments( wxPoint aPosition, const LSET& aLayerMask, TRACK_PTRS* aList,
+                                 const TRACK_ENDPOINTS& aEndpoints )
+{
+    TRACK_PTRS segments;        // The segments connected at the current position.
     TRACK*  via;                // The via identified, eventually destroy
     TRACK*  candidate;          // The end segment to destroy (or NULL = segment)
     int     NbSegm;
@@ -218,7 +357,7 @@ void BOARD::chainMarkedSegments( wxPoint aPosition, const LSET& aLayerMask, TRAC
          * is found we do not know at this time the number of connected items
          * and we do not know if this via is on the track or finish the track
          */
-        via = m_Track->GetVia( NULL, aPosition, layer_set );
+        via = aEndpoints.ViaAt( aPosition, layer_set );
 
         if( via )
         {
@@ -232,35 +371,23 @@ void BOARD::chainMarkedSegments( wxPoint aPosition, const LSET& aLayerMask, TRAC
          *  if > 1 segment:
          *      end of track (more than 2 segment connected at this location)
          */
-        segment = m_Track;
         candidate = NULL;
         NbSegm  = 0;
 
-        while( ( segment = ::GetTrack( segment, NULL, aPosition, layer_set ) ) != NULL )
-        {
-            if( segment->GetState( BUSY ) ) // already found and selected: skip it
-            {
-                segment = segment->Next();
-                continue;
-            }
+        // The segments already found and selected are flagged BUSY, and not collected
+        aEndpoints.TracksAt( aPosition, layer_set, segments );
 
-            if( segment == via ) // just previously found: skip it
-            {
-                segment = segment->Next();
+        for( unsigned ii = 0; ii < segments.size(); ii++ )
+        {
+            if( segments[ii] == via ) // just previously found: skip it
                 continue;
-            }
 
             NbSegm++;
 
             if( NbSegm == 1 ) // First time we found a connected item: segment is candidate
-            {
-                candidate = segment;
-                segment = segment->Next();
-            }
+                candidate = segments[ii];
             else // More than 1 segment connected -> this location is an end of the track
-            {
                 return;
-            }
         }
 
         if( candidate )      // A candidate is found: flag it and push it in list
@@ -753,6 +880,48 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, int aControl )
     }
 
     m_ratsnest->Add( aBoardItem );
+
+    for( unsigned i = 0; i < m_listeners.size(); ++i )
+        m_listeners[i]->OnBoardItemAdded( aBoardItem );
+}
+
+
+// Orders the tracks by net code, see ReplaceTracks()
+static bool lessNetCode( const TRACK* aFirst, const TRACK* aSecond )
+{
+    return aFirst->GetNetCode() < aSecond->GetNetCode();
+}
+
+
+void BOARD::ReplaceTracks( const std::vector<TRACK*>& aTracks, std::vector<TRACK*>* aOldTracks )
+{
+    while( TRACK* track = m_Track.PopFront() )
+    {
+        m_markedItems.erase( track );
+
+        for( unsigned i = 0; i < m_listeners.size(); ++i )
+            m_listeners[i]->OnBoardItemRemoved( track );
+
+        if( aOldTracks )
+            aOldTracks->push_back( track );
+        else
+            delete track;
+    }
+
+    std::vector<TRACK*> sorted( aTracks );
+
+    std::stable_sort( sorted.begin(), sorted.end(), lessNetCode );
+
+    for( unsigned ii = 0; ii < sorted.size(); ++ii )
+    {
+        sorted[ii]->SetParent( this );
+        m_Track.PushBack( sorted[ii] );
+
+        for( unsigned i = 0; i < m_listeners.size(); ++i )
+            m_listeners[i]->OnBoardItemAdded( sorted[ii] );
+    }
+
+    m_ratsnest->ProcessBoard();
 }
 
 
@@ -823,16 +992,153 @@ BOARD_ITEM* BOARD::Remove( BOARD_ITEM* aBoardItem )
     }
 
     m_ratsnest->Remove( aBoardItem );
+    m_markedItems.erase( aBoardItem );
+
+    for( unsigned i = 0; i < m_listeners.size(); ++i )
+        m_listeners[i]->OnBoardItemRemoved( aBoardItem );
 
     return aBoardItem;
 }
 
 
+void BOARD::AddListener( BOARD_LISTENER* aListener )
+{
+    if( std::find( m_listeners.begin(), m_listeners.end(), aListener ) == m_listeners.end() )
+        m_listeners.push_back( aListener );
+}
+
+
+void BOARD::RemoveListener( BOARD_LISTENER* aListener )
+{
+    std::vector<BOARD_LISTENER*>::iterator it =
+            std::find( m_listeners.begin(), m_listeners.end(), aListener );
+
+    if( it != m_listeners.end() )
+        m_listeners.erase( it );
+}
+
+
+void BOARD::OnItemChanged( const BOARD_ITEM* aItem ) const
+{
+    for( unsigned i = 0; i < m_listeners.size(); ++i )
+        m_listeners[i]->OnBoardItemChanged( aItem );
+}
+
+
+void BOARD::OnItemAdded( const BOARD_ITEM* aItem ) const
+{
+    for( unsigned i = 0; i < m_listeners.size(); ++i )
+        m_listeners[i]->OnBoardItemAdded( aItem );
+}
+
+
+void BOARD::OnItemRemoved( const BOARD_ITEM* aItem )
+{
+    m_markedItems.erase( aItem );
+
+    for( unsigned i = 0; i < m_listeners.size(); ++i )
+        m_listeners[i]->OnBoardItemRemoved( aItem );
+}
+
+
+void BOARD::MarkItemChanged( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+    case PCB_MODULE_TEXT_T:
+    case PCB_MODULE_EDGE_T:
+        // The listeners index the pads and edges with their footprint
+        if( aItem->GetParent() && aItem->GetParent()->Type() == PCB_MODULE_T )
+            aItem = static_cast<const BOARD_ITEM*>( aItem->GetParent() );
+        else
+            return;
+
+        break;
+
+    case PCB_MODULE_T:
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    case PCB_LINE_T:
+    case PCB_TEXT_T:
+        break;
+
+    default:
+        // No listener keeps anything about the other items
+        return;
+    }
+
+    m_markedItems.insert( aItem );
+}
+
+
+void BOARD::NotifyMarkedItems()
+{
+    std::set<const BOARD_ITEM*> items;
+
+    items.swap( m_markedItems );
+
+    for( std::set<const BOARD_ITEM*>::const_iterator it = items.begin(); it != items.end(); ++it )
+        OnItemChanged( *it );
+}
+
+
+BOARD_ITEM_INDEX& BOARD::GetItemIndex()
+{
+    // The zones can be filled by several threads, see FillZones()
+#ifdef USE_OPENMP
+    #pragma omp critical( boardItemIndex )
+#endif
+    m_itemIndex->Update();
+
+    return *m_itemIndex;
+}
+
+
+void BOARD::InvalidateItemIndex()
+{
+    m_itemIndex->Invalidate();
+}
+
+
+BOARD_NET_LENGTHS& BOARD::GetNetLengths()
+{
+    m_netLengths->Update();
+
+    return *m_netLengths;
+}
+
+
+void BOARD::InvalidateNetLengths()
+{
+    m_netLengths->Invalidate();
+}
+
+
+COPPER_OCCUPANCY_MAP& BOARD::GetCopperOccupancy()
+{
+    m_copperOccupancy->Update();
+
+    return *m_copperOccupancy;
+}
+
+
+void BOARD::InvalidateCopperOccupancy()
+{
+    m_copperOccupancy->Invalidate();
+}
+
+
 void BOARD::DeleteMARKERs()
 {
     // the vector does not know how to delete the MARKER_PCB, it holds pointers
     for( unsigned i = 0; i<m_markers.size(); ++i )
+    {
+        for( unsigned j = 0; j < m_listeners.size(); ++j )
+            m_listeners[j]->OnBoardItemRemoved( m_markers[i] );
+
         delete m_markers[i];
+    }
 
     m_markers.clear();
 }
@@ -867,6 +1173,11 @@ unsigned BOARD::GetNodesCount() const
 }
 
 
+// The exporters of a batch job compute the board bounding box on several threads:
+// only the saved box is shared
+static boost::mutex boundingBoxLock;
+
+
 EDA_RECT BOARD::ComputeBoundingBox( bool aBoardEdgesOnly )
 {
     bool hasItems = false;
@@ -936,7 +1247,11 @@ EDA_RECT BOARD::ComputeBoundingBox( bool aBoardEdgesOnly )
         }
     }
 
-    m_BoundingBox = area;   // save for BOARD::GetBoundingBox()
+    {
+        boost::mutex::scoped_lock lock( boundingBoxLock );
+
+        m_BoundingBox = area;   // save for BOARD::GetBoundingBox()
+    }
 
     return area;
 }
@@ -1483,8 +1798,18 @@ int BOARD::SetAreasNetCodesFromNetNames()
 
 VIA* BOARD::GetViaByPosition( const wxPoint& aPosition, LAYER_ID aLayer) const
 {
-    for( VIA *via = GetFirstVia( m_Track); via; via = GetFirstVia( via->Next() ) )
+    std::vector<BOARD_ITEM*> items;
+
+    // GetItemIndex() brings the index up to date first, so it is not const
+    const_cast<BOARD*>( this )->GetItemIndex().QueryPoint( aPosition, LSET::AllCuMask(), items );
+
+    for( unsigned ii = 0; ii < items.size(); ii++ )
     {
+        if( items[ii]->Type() != PCB_VIA_T )
+            continue;
+
+        VIA* via = static_cast<VIA*>( items[ii] );
+
         if( (via->GetStart() == aPosition) &&
                 (via->GetState( BUSY | IS_DELETED ) == 0) &&
                 ((aLayer == UNDEFINED_LAYER) || (via->IsOnLayer( aLayer ))) )
@@ -1500,11 +1825,19 @@ D_PAD* BOARD::GetPad( const wxPoint& aPosition, LSET aLayerMask )
     if( !aLayerMask.any() )
         aLayerMask = LSET::AllCuMask();
 
-    for( MODULE* module = m_Modules;  module;  module = module->Next() )
+    std::vector<BOARD_ITEM*> items;
+
+    GetItemIndex().QueryPoint( aPosition, aLayerMask, items );
+
+    // In the order of the footprints, then of their pads, as MODULE::GetPad() finds them
+    for( unsigned ii = 0; ii < items.size(); ii++ )
     {
-        D_PAD* pad = module->GetPad( aPosition, aLayerMask );
+        if( items[ii]->Type() != PCB_PAD_T )
+            continue;
 
-        if( pad )
+        D_PAD* pad = static_cast<D_PAD*>( items[ii] );
+
+        if( ( pad->GetLayerSet() & aLayerMask ).any() && pad->HitTest( aPosition ) )
             return pad;
     }
 
@@ -1518,15 +1851,7 @@ D_PAD* BOARD::GetPad( TRACK* aTrace, ENDPOINT_T aEndPoint )
 
     LSET aLayerMask( aTrace->GetLayer() );
 
-    for( MODULE* module = m_Modules;  module;  module = module->Next() )
-    {
-        D_PAD*  pad = module->GetPad( aPosition, aLayerMask );
-
-        if( pad )
-            return pad;
-    }
-
-    return NULL;
+    return GetPad( aPosition, aLayerMask );
 }
 
 
@@ -1684,32 +2009,55 @@ void BOARD::PadDelete( D_PAD* aPad )
 }
 
 
+// The tests of BOARD::GetTrack() for one track
+static bool isTrackAt( const BOARD* aBoard, TRACK* aTrack, const wxPoint& aPosition,
+                       LSET aLayerMask )
+{
+    LAYER_ID layer = aTrack->GetLayer();
+
+    if( aTrack->GetState( BUSY | IS_DELETED ) )
+        return false;
+
+    if( aBoard->GetDesignSettings().IsLayerVisible( layer ) == false )
+        return false;
+
+    // Vias are found on all layers, segments on the layers of aLayerMask only
+    if( aTrack->Type() != PCB_VIA_T && !aLayerMask[layer] )
+        return false;
+
+    return aTrack->HitTest( aPosition );
+}
+
+
 TRACK* BOARD::GetTrack( TRACK* aTrace, const wxPoint& aPosition,
         LSET aLayerMask ) const
 {
-    for( TRACK* track = aTrace; track; track = track->Next() )
+    if( aTrace == m_Track )
     {
-        LAYER_ID layer = track->GetLayer();
+        // The whole list is searched, through the index
+        std::vector<BOARD_ITEM*> items;
 
-        if( track->GetState( BUSY | IS_DELETED ) )
-            continue;
-
-        if( m_designSettings.IsLayerVisible( layer ) == false )
-            continue;
+        const_cast<BOARD*>( this )->GetItemIndex().QueryPoint( aPosition, LSET::AllCuMask(),
+                                                               items );
 
-        if( track->Type() == PCB_VIA_T )    // VIA encountered.
-        {
-            if( track->HitTest( aPosition ) )
-                return track;
-        }
-        else
+        for( unsigned ii = 0; ii < items.size(); ii++ )
         {
-            if( !aLayerMask[layer] )
-                continue;   // Segments on different layers.
+            KICAD_T type = items[ii]->Type();
 
-            if( track->HitTest( aPosition ) )
-                return track;
+            if( type != PCB_TRACE_T && type != PCB_VIA_T )
+                continue;
+
+            if( isTrackAt( this, static_cast<TRACK*>( items[ii] ), aPosition, aLayerMask ) )
+                return static_cast<TRACK*>( items[ii] );
         }
+
+        return NULL;
+    }
+
+    for( TRACK* track = aTrace; track; track = track->Next() )
+    {
+        if( isTrackAt( this, track, aPosition, aLayerMask ) )
+            return track;
     }
 
     return NULL;
@@ -1758,6 +2106,10 @@ TRACK* BOARD::MarkTrace( TRACK*  aTrace, int* aCount,
     for( TRACK* track = m_Track; track; track = track->Next() )
         track->SetState( BUSY, false );
 
+    // The connections of the segments are searched in the end point maps
+    TRACK_ENDPOINTS endpoints( m_Track );
+    TRACK_PTRS      connected;
+
     // Set flags of the initial track segment
     aTrace->SetState( BUSY, true );
     LSET layer_set = aTrace->GetLayerSet();
@@ -1773,21 +2125,12 @@ TRACK* BOARD::MarkTrace( TRACK*  aTrace, int* aCount,
      */
     if( aTrace->Type() == PCB_VIA_T )
     {
-        TRACK* segm1 = ::GetTrack( m_Track, NULL, aTrace->GetStart(), layer_set );
-        TRACK* segm2 = NULL;
-        TRACK* segm3 = NULL;
-
-        if( segm1 )
-        {
-            segm2 = ::GetTrack( segm1->Next(), NULL, aTrace->GetStart(), layer_set );
-        }
+        endpoints.TracksAt( aTrace->GetStart(), layer_set, connected );
 
-        if( segm2 )
-        {
-            segm3 = ::GetTrack( segm2->Next(), NULL, aTrace->GetStart(), layer_set );
-        }
+        TRACK* segm1 = connected.size() > 0 ? connected[0] : NULL;
+        TRACK* segm2 = connected.size() > 1 ? connected[1] : NULL;
 
-        if( segm3 )
+        if( connected.size() > 2 )
         {
             // More than 2 segments are connected to this via.
             // The "track" is only this via.
@@ -1801,13 +2144,13 @@ TRACK* BOARD::MarkTrace( TRACK*  aTrace, int* aCount,
         if( segm1 ) // search for other segments connected to the initial segment start point
         {
             layer_set = segm1->GetLayerSet();
-            chainMarkedSegments( aTrace->GetStart(), layer_set, &trackList );
+            chainMarkedSegments( aTrace->GetStart(), layer_set, &trackList, endpoints );
         }
 
         if( segm2 ) // search for other segments connected to the initial segment end point
         {
             layer_set = segm2->GetLayerSet();
-            chainMarkedSegments( aTrace->GetStart(), layer_set, &trackList );
+            chainMarkedSegments( aTrace->GetStart(), layer_set, &trackList, endpoints );
         }
     }
     else    // mark the chain using both ends of the initial segment
@@ -1815,8 +2158,8 @@ TRACK* BOARD::MarkTrace( TRACK*  aTrace, int* aCount,
         TRACK_PTRS  from_start;
         TRACK_PTRS  from_end;
 
-        chainMarkedSegments( aTrace->GetStart(), layer_set, &from_start );
-        chainMarkedSegments( aTrace->GetEnd(),   layer_set, &from_end );
+        chainMarkedSegments( aTrace->GetStart(), layer_set, &from_start, endpoints );
+        chainMarkedSegments( aTrace->GetEnd(),   layer_set, &from_end, endpoints );
 
         // DBG( dump_tracks( "first_clicked", trackList ); )
         // DBG( dump_tracks( "from_start", from_start ); )
@@ -1846,12 +2189,12 @@ TRACK* BOARD::MarkTrace( TRACK*  aTrace, int* aCount,
 
         layer_set = via->GetLayerSet();
 
-        TRACK* track = ::GetTrack( m_Track, NULL, via->GetStart(), layer_set );
+        endpoints.TracksAt( via->GetStart(), layer_set, connected );
 
-        // GetTrace does not consider tracks flagged BUSY.
+        // TracksAt does not consider tracks flagged BUSY.
         // So if no connected track found, this via is on the current track
         // only: keep it
-        if( track == NULL )
+        if( connected.empty() )
             continue;
 
         /* If a track is found, this via connects also other segments of
@@ -1866,10 +2209,12 @@ TRACK* BOARD::MarkTrace( TRACK*  aTrace, int* aCount,
          * if they are on the same layer, then the via is on the selected track;
          * if they are on different layers, the via is on another track.
          */
-        LAYER_NUM layer = track->GetLayer();
+        LAYER_NUM layer = connected[0]->GetLayer();
 
-        while( ( track = ::GetTrack( track->Next(), NULL, via->GetStart(), layer_set ) ) != NULL )
+        for( unsigned jj = 1; jj < connected.size(); jj++ )
         {
+            TRACK* track = connected[jj];
+
             if( layer != track->GetLayer() )
             {
                 // The via connects segments of another track: it is removed
@@ -2072,16 +2417,34 @@ MODULE* BOARD::GetFootprint( const wxPoint& aPosition, LAYER_ID aActiveLayer,
 
 BOARD_CONNECTED_ITEM* BOARD::GetLockPoint( const wxPoint& aPosition, LSET aLayerMask )
 {
-    for( MODULE* module = m_Modules; module; module = module->Next() )
+    D_PAD* pad = GetPad( aPosition, aLayerMask );
+
+    if( pad )
+        return pad;
+
+    // No pad has been located so check for a segment of the trace, with an end at
+    // aPosition, as ::GetTrack() does it
+    std::vector<BOARD_ITEM*> items;
+    TRACK* segment = NULL;
+
+    GetItemIndex().QueryPoint( aPosition, LSET::AllCuMask(), items );
+
+    for( unsigned ii = 0; ii < items.size() && !segment; ii++ )
     {
-        D_PAD* pad = module->GetPad( aPosition, aLayerMask );
+        KICAD_T type = items[ii]->Type();
 
-        if( pad )
-            return pad;
-    }
+        if( type != PCB_TRACE_T && type != PCB_VIA_T )
+            continue;
 
-    // No pad has been located so check for a segment of the trace.
-    TRACK* segment = ::GetTrack( m_Track, NULL, aPosition, aLayerMask );
+        TRACK* track = static_cast<TRACK*>( items[ii] );
+
+        if( track->GetState( IS_DELETED | BUSY ) )
+            continue;
+
+        if( ( aPosition == track->GetStart() || aPosition == track->GetEnd() )
+                && ( aLayerMask & track->GetLayerSet() ).any() )
+            segment = track;
+    }
 
     if( segment == NULL )
         segment = GetTrack( m_Track, aPosition, aLayerMask );
@@ -2723,6 +3086,133 @@ BOARD_ITEM* BOARD::DuplicateAndAddItem( const BOARD_ITEM* aItem,
 }
 
 
+// Point the net of an item of a BOARD::Snapshot() copy to the net of the copy
+static void remapNet( BOARD_CONNECTED_ITEM* aItem, const std::map<int, int>& aNetCodes )
+{
+    std::map<int, int>::const_iterator it = aNetCodes.find( aItem->GetNetCode() );
+
+    aItem->SetNetCode( it != aNetCodes.end() ? it->second : NETINFO_LIST::ORPHANED );
+}
+
+
+// Give the items of a footprint copied for BOARD::Snapshot() the time stamps of the
+// original ones: the copy constructors give new ones, and the footprints are linked to the
+// schematic by their time stamps
+static void keepTimeStamps( const MODULE* aModule, MODULE* aClone )
+{
+    aClone->SetTimeStamp( aModule->GetTimeStamp() );
+    aClone->Reference().SetTimeStamp( aModule->Reference().GetTimeStamp() );
+    aClone->Value().SetTimeStamp( aModule->Value().GetTimeStamp() );
+
+    const D_PAD* pad = aModule->Pads();
+
+    for( D_PAD* clone = aClone->Pads(); pad && clone; pad = pad->Next(), clone = clone->Next() )
+        clone->SetTimeStamp( pad->GetTimeStamp() );
+
+    const BOARD_ITEM* item = aModule->GraphicalItems();
+
+    for( BOARD_ITEM* clone = aClone->GraphicalItems(); item && clone;
+         item = item->Next(), clone = clone->Next() )
+        clone->SetTimeStamp( item->GetTimeStamp() );
+}
+
+
+BOARD* BOARD::Snapshot() const
+{
+    BOARD* copy = new BOARD();
+
+    copy->m_fileName = m_fileName;
+    copy->m_fileFormatVersionAtLoad = m_fileFormatVersionAtLoad;
+    copy->m_Status_Pcb = m_Status_Pcb;
+    copy->m_BoundingBox = m_BoundingBox;
+    copy->m_paper = m_paper;
+    copy->m_titles = m_titles;
+    copy->m_plotOptions = m_plotOptions;
+    copy->m_zoneSettings = m_zoneSettings;
+    copy->m_nodeCount = m_nodeCount;
+    copy->m_unconnectedNetCount = m_unconnectedNetCount;
+
+    for( LAYER_NUM layer = 0; layer < LAYER_ID_COUNT; ++layer )
+        copy->m_Layer[layer] = m_Layer[layer];
+
+    // The net classes are copied too, not shared with this board
+    copy->m_designSettings = m_designSettings;
+
+    const NETCLASSES& netClasses = m_designSettings.m_NetClasses;
+    NETCLASSES&       copyClasses = copy->m_designSettings.m_NetClasses;
+
+    copyClasses.Clear();
+    copyClasses.Add( boost::make_shared<NETCLASS>( *netClasses.GetDefault() ) );
+
+    for( NETCLASSES::const_iterator it = netClasses.begin(); it != netClasses.end(); ++it )
+        copyClasses.Add( boost::make_shared<NETCLASS>( *it->second ) );
+
+    // The nets are appended in the order of their codes, net 0 already exists
+    std::map<int, NETINFO_ITEM*> nets( m_NetInfo.m_netCodes.begin(), m_NetInfo.m_netCodes.end() );
+    std::map<int, int>           netCodes;
+
+    for( std::map<int, NETINFO_ITEM*>::const_iterator it = nets.begin(); it != nets.end(); ++it )
+    {
+        if( it->first == 0 )
+        {
+            netCodes[0] = 0;
+            continue;
+        }
+
+        NETINFO_ITEM* net = new NETINFO_ITEM( copy, it->second->GetNetname() );
+        NETCLASSPTR   netClass = copyClasses.Find( it->second->GetClassName() );
+
+        net->SetClass( netClass ? netClass : copyClasses.GetDefault() );
+        copy->m_NetInfo.AppendNet( net );
+        netCodes[it->first] = net->GetNet();
+    }
+
+    // The items are not added with Add(): the copy has no ratsnest to build
+    for( MODULE* module = m_Modules; module; module = module->Next() )
+    {
+        MODULE* clone = static_cast<MODULE*>( module->Clone() );
+
+        keepTimeStamps( module, clone );
+        clone->SetParent( copy );
+        copy->m_Modules.PushBack( clone );
+
+        for( D_PAD* pad = clone->Pads(); pad; pad = pad->Next() )
+            remapNet( pad, netCodes );
+    }
+
+    for( BOARD_ITEM* item = m_Drawings; item; item = item->Next() )
+    {
+        BOARD_ITEM* clone = static_cast<BOARD_ITEM*>( item->Clone() );
+
+        clone->SetTimeStamp( item->GetTimeStamp() );
+        clone->SetParent( copy );
+        copy->m_Drawings.PushBack( clone );
+    }
+
+    for( TRACK* track = m_Track; track; track = track->Next() )
+    {
+        TRACK* clone = static_cast<TRACK*>( track->Clone() );
+
+        clone->SetTimeStamp( track->GetTimeStamp() );
+        clone->SetParent( copy );
+        copy->m_Track.PushBack( clone );
+        remapNet( clone, netCodes );
+    }
+
+    for( unsigned i = 0; i < m_ZoneDescriptorList.size(); ++i )
+    {
+        ZONE_CONTAINER* clone = static_cast<ZONE_CONTAINER*>( m_ZoneDescriptorList[i]->Clone() );
+
+        clone->SetTimeStamp( m_ZoneDescriptorList[i]->GetTimeStamp() );
+        clone->SetParent( copy );
+        copy->m_ZoneDescriptorList.push_back( clone );
+        remapNet( clone, netCodes );
+    }
+
+    return copy;
+}
+
+
 wxString BOARD::GetNextModuleReferenceWithPrefix( const wxString& aPrefix,
                                                   bool aFillSequenceGaps )
 {
@@ -31,6 +31,8 @@
 #define CLASS_BOARD_H_
 
 
+#include <set>
+
 #include <dlist.h>
 
 #include <common.h>                         // PAGE_INFO
@@ -57,7 +59,12 @@ class MSG_PANEL_ITEM;
 class NETLIST;
 class REPORTER;
 class RN_DATA;
+class BOARD_ITEM_INDEX;
+class BOARD_NET_LENGTHS;
+class COPPER_OCCUPANCY_MAP;
+class TRACK_ENDPOINTS;
 class SHAPE_POLY_SET;
+class PROGRESS_REPORTER;
 
 // non-owning container of item candidates when searching for items on the same track.
 typedef std::vector< TRACK* >   TRACK_PTRS;
@@ -156,6 +163,39 @@ protected:
 };
 
 
+/**
+ * Class BOARD_LISTENER
+ * is an interface for the objects which want to be notified when the items
+ * of a BOARD are added, removed or modified.
+ * The notifications are sent by BOARD::Add() and BOARD::Remove(), and by
+ * RN_DATA::Update() which is called by the editing tools for modified items.
+ */
+class BOARD_LISTENER
+{
+public:
+    virtual ~BOARD_LISTENER() { }
+
+    /**
+     * Function OnBoardItemAdded
+     * is called after aItem has been added to the board.
+     */
+    virtual void OnBoardItemAdded( const BOARD_ITEM* aItem ) { }
+
+    /**
+     * Function OnBoardItemRemoved
+     * is called when aItem is removed from the board.  aItem is not yet deleted,
+     * but the listener must not keep a reference to it.
+     */
+    virtual void OnBoardItemRemoved( const BOARD_ITEM* aItem ) { }
+
+    /**
+     * Function OnBoardItemChanged
+     * is called after aItem has been modified.
+     */
+    virtual void OnBoardItemChanged( const BOARD_ITEM* aItem ) { }
+};
+
+
 /**
  * Class BOARD
  * holds information pertinent to a Pcbnew printed circuit board.
@@ -191,6 +231,9 @@ private:
     EDA_RECT                m_BoundingBox;
     NETINFO_LIST            m_NetInfo;              ///< net info list (name, design constraints ..
     RN_DATA*                m_ratsnest;
+    BOARD_ITEM_INDEX*       m_itemIndex;            ///< spatial index used to fill the zones
+    BOARD_NET_LENGTHS*      m_netLengths;           ///< routed length of the nets
+    COPPER_OCCUPANCY_MAP*   m_copperOccupancy;      ///< raster of the copper, for the DRC
 
     BOARD_DESIGN_SETTINGS   m_designSettings;
     ZONE_SETTINGS           m_zoneSettings;
@@ -205,6 +248,12 @@ private:
     /// Number of unconnected nets in the current rats nest.
     int                     m_unconnectedNetCount;
 
+    /// Objects to notify of the item changes, not owned.
+    std::vector<BOARD_LISTENER*> m_listeners;
+
+    /// Items changed in place by the legacy tools, see MarkItemChanged().
+    std::set<const BOARD_ITEM*> m_markedItems;
+
     /**
      * Function chainMarkedSegments
      * is used by MarkTrace() to set the BUSY flag of connected segments of the trace
@@ -213,8 +262,10 @@ private:
      * @param aPosition A wxPoint object containing the position of the starting search.
      * @param aLayerSet The allowed layers for segments to search.
      * @param aList The track list to fill with points of flagged segments.
+     * @param aEndpoints The tracks of the board by end point, built by MarkTrace().
      */
-    void chainMarkedSegments( wxPoint aPosition, const LSET& aLayerSet, TRACK_PTRS* aList );
+    void chainMarkedSegments( wxPoint aPosition, const LSET& aLayerSet, TRACK_PTRS* aList,
+                              const TRACK_ENDPOINTS& aEndpoints );
 
 public:
     static inline bool ClassOf( const EDA_ITEM* aItem )
@@ -271,6 +322,18 @@ public:
 
 #define ADD_APPEND 1        ///< aControl flag for Add( aControl ), appends not inserts
 
+    /**
+     * Function ReplaceTracks
+     * replaces all the tracks and vias of this BOARD by aTracks at once, and takes
+     * ownership of their memory.  The new tracks are sorted by net code as Add()
+     * inserts them, the listeners are notified of each item, and the ratsnest is
+     * built again once, instead of being updated for each item.
+     * @param aTracks are the new tracks and vias.
+     * @param aOldTracks if not NULL receives the previous tracks and vias, which are
+     *                   then owned by the caller, otherwise they are deleted.
+     */
+    void ReplaceTracks( const std::vector<TRACK*>& aTracks, std::vector<TRACK*>* aOldTracks );
+
     /**
      * Function Delete
      * removes the given single item from this BOARD and deletes its memory.
@@ -297,6 +360,15 @@ public:
     BOARD_ITEM* DuplicateAndAddItem( const BOARD_ITEM* aItem,
                                      bool aIncrementReferences );
 
+    /**
+     * Function Snapshot
+     * returns a copy of this board for writing it to a file on another thread, while
+     * this board is still edited: the items, nets, net classes and settings saved in a
+     * board file are copied, not shared.  The copy has no ratsnest.
+     * @return BOARD* - the copy, owned by the caller.
+     */
+    BOARD* Snapshot() const;
+
     /**
      * Function GetNextModuleReferenceWithPrefix
      * Get the next available module reference with this prefix
@@ -304,6 +376,98 @@ public:
     wxString GetNextModuleReferenceWithPrefix( const wxString& aPrefix,
                                                bool aFillSequenceGaps );
 
+    /**
+     * Function AddListener
+     * registers aListener to be notified of the item changes of this board.
+     * The listener is not owned, and must be removed before being deleted.
+     */
+    void AddListener( BOARD_LISTENER* aListener );
+
+    /**
+     * Function RemoveListener
+     * unregisters a listener added by AddListener().
+     */
+    void RemoveListener( BOARD_LISTENER* aListener );
+
+    /**
+     * Function OnItemChanged
+     * notifies the listeners that aItem has been modified.
+     */
+    void OnItemChanged( const BOARD_ITEM* aItem ) const;
+
+    /**
+     * Function OnItemAdded
+     * notifies the listeners that aItem has been linked to the board lists without
+     * Add(), e.g. by the legacy track tools.
+     */
+    void OnItemAdded( const BOARD_ITEM* aItem ) const;
+
+    /**
+     * Function OnItemRemoved
+     * notifies the listeners that aItem has been unlinked from the board lists without
+     * Remove().  BOARD_ITEM::UnLink() calls it.
+     */
+    void OnItemRemoved( const BOARD_ITEM* aItem );
+
+    /**
+     * Function MarkItemChanged
+     * records that aItem is modified in place by code which does not notify the
+     * listeners, e.g. the legacy tools, which save it in the undo list before changing
+     * it.  The listeners learn of the change from NotifyMarkedItems(), once the edit is
+     * done.  The pads and graphic items of a footprint record their footprint.
+     */
+    void MarkItemChanged( const BOARD_ITEM* aItem );
+
+    /**
+     * Function NotifyMarkedItems
+     * notifies the listeners that the items recorded by MarkItemChanged() have been
+     * modified, and forgets them.
+     */
+    void NotifyMarkedItems();
+
+    /**
+     * Function GetItemIndex
+     * returns the spatial index of the items which create holes in the zones, after
+     * indexing again the items changed since the previous call.
+     */
+    BOARD_ITEM_INDEX& GetItemIndex();
+
+    /**
+     * Function InvalidateItemIndex
+     * drops the spatial index of the items, to be used when the board has been modified
+     * without notifying the listeners.  The index is built again when needed.
+     */
+    void InvalidateItemIndex();
+
+    /**
+     * Function GetNetLengths
+     * returns the routed length of all the nets, after measuring again the tracks
+     * changed since the previous call.
+     */
+    BOARD_NET_LENGTHS& GetNetLengths();
+
+    /**
+     * Function InvalidateNetLengths
+     * drops the net lengths, to be used when the board has been modified without
+     * notifying the listeners.  The nets are measured again when needed.
+     */
+    void InvalidateNetLengths();
+
+    /**
+     * Function GetCopperOccupancy
+     * returns the raster of the pads and tracks, which tells where a new track is
+     * definitely clear of the copper, after rasterizing again the items changed since
+     * the previous call.
+     */
+    COPPER_OCCUPANCY_MAP& GetCopperOccupancy();
+
+    /**
+     * Function InvalidateCopperOccupancy
+     * drops the raster of the copper, to be used when the board has been modified
+     * without notifying the listeners.  It is built again when needed.
+     */
+    void InvalidateCopperOccupancy();
+
     /**
      * Function GetRatsnest()
      * returns list of missing connections between components/tracks.
@@ -316,7 +480,7 @@ public:
 
     /**
      * Function DeleteMARKERs
-     * deletes ALL MARKERS from the board.
+     * deletes ALL MARKERS from the board, and notifies the listeners of their removal.
      */
     void DeleteMARKERs();
 
@@ -1136,7 +1300,9 @@ public:
 
     /**
      * Function CombineAllAreasInNet
-     * Checks all copper areas in net for intersections, combining them if found
+     * Checks all copper areas in net for intersections, combining them if found.
+     * The areas are paired by a sweep of their bounding boxes, and each group of
+     * intersecting areas is merged with a single union.
      * @param aDeletedList = a PICKED_ITEMS_LIST * where to store deleted areas (useful
      *                       in undo commands can be NULL
      * @param aNetCode = net to consider
@@ -1203,6 +1369,28 @@ public:
     int Test_Drc_Areas_Outlines_To_Areas_Outlines( ZONE_CONTAINER* aArea_To_Examine,
                                                    bool            aCreate_Markers );
 
+    /**
+     * Function FillZones
+     * builds the filled areas of the zones of aZones (keepout areas are skipped).
+     * The zones do not depend on the filled areas of each other, so when OpenMP is
+     * enabled they are filled concurrently, and must not be modified by the caller
+     * until this function returns.  It can run on any thread, see RunInBackground().
+     * @param aZones is the list of zones to fill.
+     * @param aReporter, if not NULL, is advanced by one step per zone processed, and
+     *                  allows the user to cancel the fill.
+     * @param aStaleOnly = true to keep the filled areas of the zones whose fill inputs have
+     *                   not changed since they were filled (see ZONE_CONTAINER::IsFillUpToDate()).
+     * @param aErrorCount, if not NULL, receives the count of zones which could not be filled,
+     *                    e.g. because of a malformed outline.
+     * @param aStopOnError = true to stop the fill after the first zone which could not be
+     *                     filled: the zones not filled yet keep their previous filled areas.
+     * @return false if the fill was cancelled: some zones are then left with their previous
+     *         filled areas.
+     */
+    bool FillZones( const std::vector<ZONE_CONTAINER*>& aZones,
+                    PROGRESS_REPORTER* aReporter = NULL, bool aStaleOnly = false,
+                    int* aErrorCount = NULL, bool aStopOnError = false );
+
     /****** function relative to ratsnest calculations: */
 
     /**
@@ -30,6 +30,7 @@
 
 #include <fctsys.h>
 #include <common.h>
+#include <numeric_io.h>
 #include <pcbnew.h>
 
 #include <class_board.h>
@@ -56,7 +57,16 @@ void BOARD_ITEM::UnLink()
     wxASSERT( list );
 
     if( list )
+    {
         list->Remove( this );
+
+        // Keep the board caches (item index, online DRC...) from referring to this item,
+        // which can be deleted right after
+        BOARD* board = GetBoard();
+
+        if( board )
+            board->OnItemRemoved( this );
+    }
 }
 
 
@@ -91,25 +101,7 @@ std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 #if 1
 
     char    buf[50];
-    int     len;
-    double  mm = aValue / IU_PER_MM;
-
-    if( mm != 0.0 && fabs( mm ) <= 0.0001 )
-    {
-        len = sprintf( buf, "%.10f", mm );
-
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
-
-        if( buf[len] == '.' )
-            buf[len] = '\0';
-        else
-            ++len;
-    }
-    else
-    {
-        len = sprintf( buf, "%.10g", mm );
-    }
+    int     len = FormatInternalUnits( aValue, buf );
 
     return std::string( buf, len );
 
@@ -167,11 +159,79 @@ std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 }
 
 
+int BOARD_ITEM::FormatInternalUnits( int aValue, char* aBuffer )
+{
+    if( IU_PER_MM == 1e6 )
+    {
+        // With nanometre units, the result of the general algorithm below is the digits
+        // of aValue, with a decimal point 6 digits from the end and no trailing zeros.
+        // They are written directly, which is much faster than sprintf().
+        unsigned    n = aValue < 0 ? 0u - (unsigned) aValue : (unsigned) aValue;
+        char        digits[16];     // least significant first
+        int         count = 0;
+        int         first = 0;      // first non zero decimal
+        char*       p = aBuffer;
+
+        do
+        {
+            digits[count++] = '0' + n % 10;
+            n /= 10;
+        } while( n );
+
+        while( count < 7 )
+            digits[count++] = '0';
+
+        while( first < 6 && digits[first] == '0' )
+            ++first;
+
+        if( aValue < 0 )
+            *p++ = '-';
+
+        for( int i = count - 1; i >= 6; --i )
+            *p++ = digits[i];
+
+        if( first < 6 )
+        {
+            *p++ = '.';
+
+            for( int i = 5; i >= first; --i )
+                *p++ = digits[i];
+        }
+
+        *p = '\0';
+
+        return p - aBuffer;
+    }
+
+    int     len;
+    double  mm = aValue / IU_PER_MM;
+
+    if( mm != 0.0 && fabs( mm ) <= 0.0001 )
+    {
+        len = KiSnprintf( aBuffer, 50, "%.10f", mm );
+
+        while( --len > 0 && aBuffer[len] == '0' )
+            aBuffer[len] = '\0';
+
+        if( aBuffer[len] == '.' )
+            aBuffer[len] = '\0';
+        else
+            ++len;
+    }
+    else
+    {
+        len = KiSnprintf( aBuffer, 50, "%.10g", mm );
+    }
+
+    return len;
+}
+
+
 std::string BOARD_ITEM::FormatAngle( double aAngle )
 {
     char temp[50];
 
-    int len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
+    int len = KiSnprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
 
     return std::string( temp, len );
 }
@@ -179,13 +239,19 @@ std::string BOARD_ITEM::FormatAngle( double aAngle )
 
 std::string BOARD_ITEM::FormatInternalUnits( const wxPoint& aPoint )
 {
-    return FormatInternalUnits( aPoint.x ) + " " + FormatInternalUnits( aPoint.y );
+    char    buf[100];
+    int     len = FormatInternalUnits( aPoint.x, buf );
+
+    buf[len++] = ' ';
+    len += FormatInternalUnits( aPoint.y, buf + len );
+
+    return std::string( buf, len );
 }
 
 
 std::string BOARD_ITEM::FormatInternalUnits( const wxSize& aSize )
 {
-    return FormatInternalUnits( aSize.GetWidth() ) + " " + FormatInternalUnits( aSize.GetHeight() );
+    return FormatInternalUnits( wxPoint( aSize.GetWidth(), aSize.GetHeight() ) );
 }
 
 
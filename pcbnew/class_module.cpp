@@ -979,8 +979,12 @@ void MODULE::Rotate( const wxPoint& aRotCentre, double aAngle )
 {
     wxPoint newpos = m_Pos;
     RotatePoint( &newpos, aRotCentre, aAngle );
-    SetPosition( newpos );
-    SetOrientation( GetOrientation() + aAngle );
+
+    // One pass over the items, with the final position and orientation
+    double newangle = GetOrientation() + aAngle;
+    NORMALIZE_ANGLE_POS( newangle );
+
+    setPlacement( newpos, newangle );
 }
 
 
@@ -1033,13 +1037,16 @@ void MODULE::SetPosition( const wxPoint& newpos )
 {
     wxPoint delta = newpos - m_Pos;
 
+    // All the items are translated: their draw coordinates, the polygons of the pads and
+    // the bounding box are moved by delta, instead of computed again from the local
+    // coordinates, which is the same once the bounding box has been computed.
     m_Pos += delta;
     m_Reference->SetTextPosition( m_Reference->GetTextPosition() + delta );
     m_Value->SetTextPosition( m_Value->GetTextPosition() + delta );
 
     for( D_PAD* pad = m_Pads;  pad;  pad = pad->Next() )
     {
-        pad->SetPosition( pad->GetPosition() + delta );
+        pad->Translate( delta );
     }
 
     for( EDA_ITEM* item = m_Drawings;  item;  item = item->Next() )
@@ -1049,7 +1056,8 @@ void MODULE::SetPosition( const wxPoint& newpos )
         case PCB_MODULE_EDGE_T:
         {
             EDGE_MODULE* pt_edgmod = (EDGE_MODULE*) item;
-            pt_edgmod->SetDrawCoord();
+            pt_edgmod->SetStart( pt_edgmod->GetStart() + delta );
+            pt_edgmod->SetEnd( pt_edgmod->GetEnd() + delta );
             break;
         }
 
@@ -1066,7 +1074,11 @@ void MODULE::SetPosition( const wxPoint& newpos )
         }
     }
 
-    CalculateBoundingBox();
+    // A footprint being built, e.g. by a loader or a script, can have no bounding box yet
+    if( m_BoundaryBox.GetSize() == wxSize( 0, 0 ) )
+        CalculateBoundingBox();
+    else
+        m_BoundaryBox.Move( delta );
 }
 
 
@@ -1131,11 +1143,18 @@ void MODULE::MoveAnchorPosition( const wxPoint& aMoveVector )
 
 void MODULE::SetOrientation( double newangle )
 {
-    double  angleChange = newangle - m_Orient;  // change in rotation
-
     NORMALIZE_ANGLE_POS( newangle );
 
-    m_Orient = newangle;
+    setPlacement( m_Pos, newangle );
+}
+
+
+void MODULE::setPlacement( const wxPoint& aPosition, double aOrientation )
+{
+    double  angleChange = aOrientation - m_Orient;  // change in rotation
+
+    m_Pos = aPosition;
+    m_Orient = aOrientation;
 
     for( D_PAD* pad = m_Pads;  pad;  pad = pad->Next() )
     {
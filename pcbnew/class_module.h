@@ -695,6 +695,13 @@ private:
 
     wxArrayString*    m_initial_comments;   ///< leading s-expression comments in the module,
                                             ///< lazily allocated only if needed for speed
+
+    /**
+     * Function setPlacement
+     * places the module at @a aPosition with the orientation @a aOrientation, updating the
+     * draw coordinates of all its items in one pass, and then its bounding box.
+     */
+    void setPlacement( const wxPoint& aPosition, double aOrientation );
 };
 
 #endif     // MODULE_H_
@@ -43,6 +43,7 @@
 #include <class_board.h>
 #include <class_module.h>
 #include <class_track.h>
+#include <net_lengths.h>
 
 
 /*********************************************************/
@@ -113,24 +114,12 @@ void NETINFO_ITEM::GetMsgPanelInfo( std::vector< MSG_PANEL_ITEM >& aList )
     txt.Printf( wxT( "%d" ), count );
     aList.push_back( MSG_PANEL_ITEM( _( "Pads" ), txt, DARKGREEN ) );
 
-    count  = 0;
+    // The tracks are measured once for all the nets, see BOARD_NET_LENGTHS
+    const NET_LENGTH& length = board->GetNetLengths().GetNet( GetNet() );
 
-    for( const TRACK *track = board->m_Track; track != NULL; track = track->Next() )
-    {
-        if( track->Type() == PCB_VIA_T )
-        {
-            if( track->GetNetCode() == GetNet() )
-                count++;
-        }
+    lengthnet = length.m_TrackLength;
 
-        if( track->Type() == PCB_TRACE_T )
-        {
-            if( track->GetNetCode() == GetNet() )
-                lengthnet += track->GetLength();
-        }
-    }
-
-    txt.Printf( wxT( "%d" ), count );
+    txt.Printf( wxT( "%d" ), length.m_ViaCount );
     aList.push_back( MSG_PANEL_ITEM( _( "Vias" ), txt, BLUE ) );
 
     // Displays the full net length (tracks on pcb + internal ICs connections ):
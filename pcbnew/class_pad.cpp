@@ -83,6 +83,7 @@ D_PAD::D_PAD( MODULE* parent ) :
     SetSubRatsnest( 0 );                       // used in ratsnest calculations
 
     m_boundingRadius      = -1;
+    m_effectivePolygonDirty = true;
 }
 
 
@@ -260,6 +261,7 @@ void D_PAD::SetDrawCoord()
     MODULE* module = (MODULE*) m_Parent;
 
     m_Pos = m_Pos0;
+    m_effectivePolygonDirty = true;
 
     if( module == NULL )
         return;
@@ -299,6 +301,7 @@ void D_PAD::SetOrientation( double aAngle )
 {
     NORMALIZE_ANGLE_POS( aAngle );
     m_Orient = aAngle;
+    m_effectivePolygonDirty = true;
 }
 
 
@@ -371,6 +374,47 @@ const wxPoint D_PAD::ShapePos() const
 }
 
 
+const SHAPE_CONVEX& D_PAD::GetEffectivePolygon() const
+{
+    if( !m_effectivePolygonDirty )
+        return m_effectivePolygon;
+
+    wxPoint corners[4];
+    int     cornerCount = 0;
+
+    switch( GetShape() )
+    {
+    case PAD_SHAPE_RECT:
+    case PAD_SHAPE_TRAPEZOID:
+        BuildPadPolygon( corners, wxSize( 0, 0 ), m_Orient );
+
+        for( int ii = 0; ii < 4; ii++ )
+            corners[ii] += ShapePos();
+
+        cornerCount = 4;
+        break;
+
+    case PAD_SHAPE_ROUNDRECT:
+        GetRoundRectCornerCenters( corners, GetRoundRectCornerRadius(), ShapePos(),
+                                   m_Size, m_Orient );
+        cornerCount = 4;
+        break;
+
+    default:    // circles and ovals are tested as circles and segments
+        break;
+    }
+
+    m_effectivePolygon.Clear();
+
+    for( int ii = 0; ii < cornerCount; ii++ )
+        m_effectivePolygon.Append( corners[ii] );
+
+    m_effectivePolygonDirty = false;
+
+    return m_effectivePolygon;
+}
+
+
 const wxString D_PAD::GetPadName() const
 {
     wxString name;
@@ -460,6 +504,7 @@ void D_PAD::Copy( D_PAD* source )
     m_ThermalWidth = source->m_ThermalWidth;
     m_ThermalGap = source->m_ThermalGap;
     m_padRoundRectRadiusScale = source->m_padRoundRectRadiusScale;
+    m_effectivePolygonDirty = true;
 
     SetSubRatsnest( 0 );
     SetSubNet( 0 );
@@ -872,6 +917,7 @@ void D_PAD::Rotate( const wxPoint& aRotCentre, double aAngle )
     RotatePoint( &m_Pos, aRotCentre, aAngle );
     m_Orient += aAngle;
     NORMALIZE_ANGLE_360( m_Orient );
+    m_effectivePolygonDirty = true;
 
     SetLocalCoord();
 }
@@ -1015,6 +1061,10 @@ unsigned int D_PAD::ViewGetLOD( int aLayer ) const
         return ( Millimeter2iu( 100 ) / std::max( m_Size.x, m_Size.y ) );
     }
 
+    // Holes are not drawn when they would be smaller than a pixel
+    if( aLayer == ITEM_GAL_LAYER( PADS_HOLES_VISIBLE ) )
+        return ( Millimeter2iu( 3.7 ) / std::max( 1, std::min( m_Drill.x, m_Drill.y ) ) );
+
     // Other layers are shown without any conditions
     return 0;
 }
@@ -35,8 +35,10 @@
 #include <class_board_connected_item.h>
 #include <pad_shapes.h>
 #include <PolyLine.h>
+#include <geometry/shape_convex.h>
 #include <config_params.h>       // PARAM_CFG_ARRAY
 #include "zones.h"
+#include <chunked_pool.h>
 
 
 class LINE_READER;
@@ -82,6 +84,11 @@ public:
 public:
     D_PAD( MODULE* parent );
 
+    // The pads are allocated in chunks, the pads of a footprint being neighbours in memory
+#ifndef SWIG
+    DECLARE_CHUNKED_POOL_ALLOCATION
+#endif
+
     // Do not create a copy constructor.  The one generated by the compiler is adequate.
     // D_PAD( const D_PAD& o );
 
@@ -160,13 +167,18 @@ public:
      * @return the shape of this pad.
      */
     PAD_SHAPE_T GetShape() const                { return m_padShape; }
-    void SetShape( PAD_SHAPE_T aShape )         { m_padShape = aShape; m_boundingRadius = -1; }
+    void SetShape( PAD_SHAPE_T aShape )
+    {
+        m_padShape = aShape;
+        m_boundingRadius = -1;
+        m_effectivePolygonDirty = true;
+    }
 
-    void SetPosition( const wxPoint& aPos )     { m_Pos = aPos; }   // was overload
+    void SetPosition( const wxPoint& aPos )     { m_Pos = aPos; m_effectivePolygonDirty = true; }
     const wxPoint& GetPosition() const          { return m_Pos; }   // was overload
 
-    void SetY( int y )                          { m_Pos.y = y; }
-    void SetX( int x )                          { m_Pos.x = x; }
+    void SetY( int y )                          { m_Pos.y = y; m_effectivePolygonDirty = true; }
+    void SetX( int x )                          { m_Pos.x = x; m_effectivePolygonDirty = true; }
 
     void SetPos0( const wxPoint& aPos )         { m_Pos0 = aPos; }
     const wxPoint& GetPos0() const              { return m_Pos0; }
@@ -174,16 +186,26 @@ public:
     void SetY0( int y )                         { m_Pos0.y = y; }
     void SetX0( int x )                         { m_Pos0.x = x; }
 
-    void SetSize( const wxSize& aSize )         { m_Size = aSize;  m_boundingRadius = -1; }
+    void SetSize( const wxSize& aSize )
+    {
+        m_Size = aSize;
+        m_boundingRadius = -1;
+        m_effectivePolygonDirty = true;
+    }
     const wxSize& GetSize() const               { return m_Size; }
 
-    void SetDelta( const wxSize& aSize )        { m_DeltaSize = aSize;  m_boundingRadius = -1; }
+    void SetDelta( const wxSize& aSize )
+    {
+        m_DeltaSize = aSize;
+        m_boundingRadius = -1;
+        m_effectivePolygonDirty = true;
+    }
     const wxSize& GetDelta() const              { return m_DeltaSize; }
 
     void SetDrillSize( const wxSize& aSize )    { m_Drill = aSize; }
     const wxSize& GetDrillSize() const          { return m_Drill; }
 
-    void SetOffset( const wxPoint& aOffset )    { m_Offset = aOffset; }
+    void SetOffset( const wxPoint& aOffset )    { m_Offset = aOffset; m_effectivePolygonDirty = true; }
     const wxPoint& GetOffset() const            { return m_Offset; }
 
 
@@ -426,6 +448,7 @@ public:
         // Any member function which would affect this calculation should set
         // m_boundingRadius to -1 to re-trigger the calculation from here.
         // Currently that is only m_Size, m_DeltaSize, and m_padShape accessors.
+        // (m_effectivePolygonDirty is set the same way, by all the geometry accessors)
         if( m_boundingRadius == -1 )
         {
             m_boundingRadius = boundingRadius();
@@ -436,6 +459,18 @@ public:
 
     const wxPoint ShapePos() const;
 
+    /**
+     * Function GetEffectivePolygon
+     * returns the convex polygon used to test the clearance of rect, trapezoidal and
+     * rounded rect pads, in board coordinates.  It is the outline of rect and
+     * trapezoidal pads, and the centres of the rounded corners of rounded rect pads
+     * (the pad shape is then the polygon inflated by GetRoundRectCornerRadius()), so
+     * the tests are exact.  It is empty for other shapes.
+     * The polygon is built on demand and kept until the pad geometry is modified,
+     * so do not call it for the first time from concurrent threads.
+     */
+    const SHAPE_CONVEX& GetEffectivePolygon() const;
+
     /**
      * has meaning only for rounded rect pads
      * @return the scaling factor between the smaller Y or Y size and the radius
@@ -461,6 +496,7 @@ public:
             aRadiusScale = 0.0;
 
         m_padRoundRectRadiusScale = std::min( aRadiusScale, 0.5 );
+        m_effectivePolygonDirty = true;
     }
 
     /**
@@ -503,9 +539,23 @@ public:
     void Move( const wxPoint& aMoveVector )
     {
         m_Pos += aMoveVector;
+        m_effectivePolygonDirty = true;
         SetLocalCoord();
     }
 
+    /**
+     * Function Translate
+     * moves the pad with its footprint: its local coordinates are unchanged, and its
+     * effective polygon, if already built, is moved instead of built again.
+     */
+    void Translate( const wxPoint& aDelta )
+    {
+        m_Pos += aDelta;
+
+        if( !m_effectivePolygonDirty )
+            m_effectivePolygon.Move( VECTOR2I( aDelta ) );
+    }
+
     void Rotate( const wxPoint& aRotCentre, double aAngle );
 
     wxString GetSelectMenuText() const;
@@ -587,6 +637,9 @@ private:    // Private variable members:
     // Actually computed and cached on demand by the accessor
     mutable int m_boundingRadius;  ///< radius of the circle containing the pad shape
 
+    mutable SHAPE_CONVEX m_effectivePolygon;    ///< see GetEffectivePolygon()
+    mutable bool        m_effectivePolygonDirty;
+
     /// Pad name (4 char) or a long identifier (used in pad name
     /// comparisons because this is faster than string comparison)
     union
@@ -771,6 +771,16 @@ unsigned int TRACK::ViewGetLOD( int aLayer ) const
 }
 
 
+unsigned int VIA::ViewGetLOD( int aLayer ) const
+{
+    // Holes are not drawn when they would be smaller than a pixel
+    if( aLayer == ITEM_GAL_LAYER( VIAS_HOLES_VISIBLE ) )
+        return ( 3700000 / ( GetDrillValue() + 1 ) );
+
+    return TRACK::ViewGetLOD( aLayer );
+}
+
+
 void VIA::Draw( EDA_DRAW_PANEL* panel, wxDC* aDC, GR_DRAWMODE aDrawMode, const wxPoint& aOffset )
 {
     wxCHECK_RET( panel != NULL, wxT( "VIA::Draw panel cannot be NULL." ) );
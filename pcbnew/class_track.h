@@ -36,6 +36,7 @@
 #include <class_board_connected_item.h>
 #include <PolyLine.h>
 #include <trigo.h>
+#include <chunked_pool.h>
 
 
 class TRACK;
@@ -92,6 +93,12 @@ public:
 
     TRACK( BOARD_ITEM* aParent, KICAD_T idtype = PCB_TRACE_T );
 
+    // The tracks, vias and zone segments are allocated in chunks, in the order they are
+    // created, so the walks of the track list of a board read the memory in sequence
+#ifndef SWIG
+    DECLARE_CHUNKED_POOL_ALLOCATION
+#endif
+
     // Do not create a copy constructor.  The one generated by the compiler is adequate.
 
     TRACK* Next() const { return static_cast<TRACK*>( Pnext ); }
@@ -435,6 +442,9 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLayers()
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetLOD()
+    virtual unsigned int ViewGetLOD( int aLayer ) const;
+
     virtual void Flip( const wxPoint& aCentre );
 
 #if defined (DEBUG)
@@ -55,9 +55,12 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
 {
     m_CornerSelection = -1;
     m_IsFilled = false;                         // fill status : true when the zone is filled
+    m_fillHash = 0;
     m_FillMode = 0;                             // How to fill areas: 0 = use filled polygons, != 0 fill with segments
     m_priority = 0;
     m_smoothedPoly = NULL;
+    m_fillRefillCount = 0;
+    m_tiledFill = false;
     m_cornerSmoothingType = ZONE_SETTINGS::SMOOTHING_NONE;
     SetIsKeepout( false );
     SetDoNotAllowCopperPour( false );           // has meaning only if m_isKeepout == true
@@ -74,6 +77,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     BOARD_CONNECTED_ITEM( aZone )
 {
     m_smoothedPoly = NULL;
+    m_fillRefillCount = 0;
 
     // Should the copy be on the same net?
     SetNetCode( aZone.GetNetCode() );
@@ -82,11 +86,13 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     // For corner moving, corner index to drag, or -1 if no selection
     m_CornerSelection = -1;
     m_IsFilled = aZone.m_IsFilled;
+    m_fillHash = aZone.m_fillHash;
     m_ZoneClearance = aZone.m_ZoneClearance;     // clearance value
     m_ZoneMinThickness = aZone.m_ZoneMinThickness;
     m_FillMode = aZone.m_FillMode;               // Filling mode (segments/polygons)
     m_priority = aZone.m_priority;
     m_ArcToSegmentsCount = aZone.m_ArcToSegmentsCount;
+    m_tiledFill = aZone.m_tiledFill;
     m_PadConnection = aZone.m_PadConnection;
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
@@ -126,6 +132,7 @@ bool ZONE_CONTAINER::UnFill()
     m_FilledPolysList.RemoveAllContours();
     m_FillSegmList.clear();
     m_IsFilled = false;
+    m_fillHash = 0;
 
     return change;
 }
@@ -196,13 +203,15 @@ void ZONE_CONTAINER::Draw( EDA_DRAW_PANEL* panel, wxDC* DC, GR_DRAWMODE aDrawMod
     GRLineArray( panel->GetClipBox(), DC, lines, 0, color );
 
     // draw hatches
+    const std::vector<CSegment>& hatchLines = m_Poly->GetHatchLines();
+
     lines.clear();
-    lines.reserve( (m_Poly->m_HatchLines.size() * 2) + 2 );
+    lines.reserve( (hatchLines.size() * 2) + 2 );
 
-    for( unsigned ic = 0; ic < m_Poly->m_HatchLines.size(); ic++ )
+    for( unsigned ic = 0; ic < hatchLines.size(); ic++ )
     {
-        seg_start = m_Poly->m_HatchLines[ic].m_Start + offset;
-        seg_end   = m_Poly->m_HatchLines[ic].m_End + offset;
+        seg_start = hatchLines[ic].m_Start + offset;
+        seg_end   = hatchLines[ic].m_End + offset;
         lines.push_back( seg_start );
         lines.push_back( seg_end );
     }
@@ -638,7 +647,7 @@ void ZONE_CONTAINER::GetMsgPanelInfo( std::vector< MSG_PANEL_ITEM >& aList )
     aList.push_back( MSG_PANEL_ITEM( _( "Fill Mode" ), msg, BROWN ) );
 
     // Useful for statistics :
-    msg.Printf( wxT( "%d" ), (int) m_Poly->m_HatchLines.size() );
+    msg.Printf( wxT( "%d" ), (int) m_Poly->GetHatchLines().size() );
     aList.push_back( MSG_PANEL_ITEM( _( "Hatch Lines" ), msg, BLUE ) );
 
     if( !m_FilledPolysList.IsEmpty() )
@@ -765,16 +774,18 @@ void ZONE_CONTAINER::Copy( ZONE_CONTAINER* src )
     m_ZoneMinThickness = src->m_ZoneMinThickness;
     m_FillMode = src->m_FillMode;               // Filling mode (segments/polygons)
     m_ArcToSegmentsCount = src->m_ArcToSegmentsCount;
+    m_tiledFill = src->m_tiledFill;
     m_PadConnection = src->m_PadConnection;
     m_ThermalReliefGap = src->m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = src->m_ThermalReliefCopperBridge;
     m_Poly->SetHatchStyle( src->m_Poly->GetHatchStyle() );
     m_Poly->SetHatchPitch( src->m_Poly->GetHatchPitch() );
-    m_Poly->m_HatchLines = src->m_Poly->m_HatchLines;   // Copy vector <CSegment>
+    m_Poly->Hatch();                            // the hatch lines of the copied outline
     m_FilledPolysList.RemoveAllContours();
     m_FilledPolysList.Append( src->m_FilledPolysList );
     m_FillSegmList.clear();
     m_FillSegmList = src->m_FillSegmList;
+    m_fillHash = src->m_fillHash;
 }
 
 
@@ -33,6 +33,7 @@
 
 
 #include <vector>
+#include <stdint.h>
 #include <gr_basic.h>
 #include <class_board_item.h>
 #include <class_board_connected_item.h>
@@ -190,9 +191,43 @@ public:
     void SetArcSegmentCount( int aArcSegCount ) { m_ArcToSegmentsCount = aArcSegCount; }
     int GetArcSegmentCount() const { return m_ArcToSegmentsCount; }
 
+    /**
+     * Function SetTiledFill
+     * selects the tiled fill of the zone, where the holes are removed from tiles of the zone
+     * area in parallel (see SHAPE_POLY_SET::BooleanSubtractTiled()).  Only useful for the
+     * largest zones, e.g. the planes, with many thousands of holes.
+     */
+    void SetTiledFill( bool aTiled ) { m_tiledFill = aTiled; }
+    bool GetTiledFill() const { return m_tiledFill; }
+
     bool IsFilled() const { return m_IsFilled; }
     void SetIsFilled( bool isFilled ) { m_IsFilled = isFilled; }
 
+    /**
+     * Function GetFillHash
+     * @return the hash of the fill inputs recorded by the last fill of the zone (see
+     * BuildFillHash()), saved in the board file with the filled areas, or 0 if unknown.
+     */
+    uint64_t GetFillHash() const { return m_fillHash; }
+    void SetFillHash( uint64_t aHash ) { m_fillHash = aHash; }
+
+    /**
+     * Function BuildFillHash
+     * computes a hash of everything the fill of the zone depends on: its outline and fill
+     * settings and, on copper layers, the holes made by the board items in clearance range
+     * and the items of its net which keep its areas connected.  The hash does not depend
+     * on the platform, and is never 0.
+     * Like the fill, it can be computed for several zones at the same time.
+     */
+    uint64_t BuildFillHash( BOARD* aPcb );
+
+    /**
+     * Function IsFillUpToDate
+     * @return true if the zone is filled, and its fill inputs have not changed since it
+     * was filled, so that filling it again would give the same areas.
+     */
+    bool IsFillUpToDate( BOARD* aPcb );
+
     int GetZoneClearance() const { return m_ZoneClearance; }
     void SetZoneClearance( int aZoneClearance ) { m_ZoneClearance = aZoneClearance; }
 
@@ -262,6 +297,17 @@ public:
     void TransformSolidAreasShapesToPolygonSet( SHAPE_POLY_SET& aCornerBuffer,
                                                 int             aCircleToSegmentsCount,
                                                 double          aCorrectionFactor );
+
+    /**
+     * Function TransformSolidAreasOutlinesToPolygonSet
+     * Same as TransformSolidAreasShapesToPolygonSet(), for the thick outlines of the
+     * solid areas only: the filled areas are drawn from GetFilledPolysList() and their
+     * cached triangles
+     */
+    void TransformSolidAreasOutlinesToPolygonSet( SHAPE_POLY_SET& aCornerBuffer,
+                                                  int             aCircleToSegmentsCount,
+                                                  double          aCorrectionFactor );
+
     /**
      * Function BuildFilledSolidAreasPolygons
      * Build the filled solid areas data from real outlines (stored in m_Poly)
@@ -278,6 +324,8 @@ public:
      * if not null:
      * Only the zone outline (with holes, if any) is stored in aOutlineBuffer
      * with holes linked. Therefore only one polygon is created
+     * and the zone is not modified, so other zones can use this outline
+     * while this zone is filled by another thread.
      *
      * When aOutlineBuffer is not null, his function calls
      * AddClearanceAreasPolygonsToPolysList() to add holes for pads and tracks
@@ -347,9 +395,13 @@ public:
      * A scan is made line per line, on the whole filled areas, with a step of m_ZoneMinThickness.
      * all intersecting points with the horizontal infinite line and polygons to fill are calculated
      * a list of SEGZONE items is built, line per line
+     * The scan keeps a table of the edges crossing the current line, so each line only
+     * intersects these edges.
+     * @param aMergeSegments = true to merge the segments of the same line which touch or
+     *                       overlap, so fewer segments are drawn, plotted and saved.
      * @return number of segments created
      */
-    int FillZoneAreasWithSegments();
+    int FillZoneAreasWithSegments( bool aMergeSegments = true );
 
     /**
      * Function UnFill
@@ -480,11 +532,13 @@ public:
 
    /**
      * Function AddFilledPolysList
-     * sets the list of filled polygons.
+     * sets the list of filled polygons, and triangulates them for the renderers unless
+     * they come with their triangulation (see SHAPE_POLY_SET::CacheTriangulation()).
      */
     void AddFilledPolysList( SHAPE_POLY_SET& aPolysList )
     {
         m_FilledPolysList = aPolysList;
+        m_FilledPolysList.CacheTriangulation();
     }
 
     /**
@@ -549,6 +603,30 @@ public:
 private:
     void buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeatures );
 
+    /**
+     * Function refillChangedAreas
+     * computes aSolidAreas minus aHoles from the previous fill, when only a small part of
+     * the holes has changed: the area of the holes that are not in m_fillHoles, or that
+     * have disappeared from it, is rebuilt, and the rest of m_fillRawAreas is kept.
+     * @param aSolidAreas is the zone area, which must be the same as m_fillSolidAreas.
+     * @param aHoles is the new hole list.
+     * @param aResult is filled with the new filled areas (not fractured).
+     * @return false if too much has changed, and a full fill is faster.
+     */
+    bool refillChangedAreas( const SHAPE_POLY_SET& aSolidAreas, const SHAPE_POLY_SET& aHoles,
+                             SHAPE_POLY_SET& aResult ) const;
+
+    /**
+     * Function fillHash
+     * @return the hash of the fill inputs, see BuildFillHash().
+     * @param aHoles is the hole list built by buildFeatureHoleList(), or NULL for the zones
+     *               which are not on a copper layer.
+     */
+    uint64_t fillHash( BOARD* aPcb, const SHAPE_POLY_SET* aHoles ) const;
+
+    /// @return a new corner-smoothed copy of m_Poly, owned by the caller
+    CPolyLine* buildSmoothedPoly() const;
+
     CPolyLine*            m_Poly;                ///< Outline of the zone.
     CPolyLine*            m_smoothedPoly;        // Corner-smoothed version of m_Poly
     int                   m_cornerSmoothingType;
@@ -580,9 +658,15 @@ private:
         #ARC_APPROX_SEGMENTS_COUNT_LOW_DEF or #ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF. */
     int                   m_ArcToSegmentsCount;
 
+    /** True when the zone is filled by tiles, see SetTiledFill(). */
+    bool                  m_tiledFill;
+
     /** True when a zone was filled, false after deleting the filled areas. */
     bool                  m_IsFilled;
 
+    /** Hash of the fill inputs when the zone was filled, or 0, see GetFillHash(). */
+    uint64_t              m_fillHash;
+
     ///< Width of the gap in thermal reliefs.
     int                   m_ThermalReliefGap;
 
@@ -616,6 +700,15 @@ private:
      * described by m_Poly can have many filled areas
      */
     SHAPE_POLY_SET m_FilledPolysList;
+
+    /* Data kept from the previous fill of a copper zone, so that the next fill only has to
+     * be computed again where the holes have changed (see refillChangedAreas())
+     */
+    SHAPE_POLY_SET m_fillSolidAreas;    ///< Zone area, before removing the holes
+    SHAPE_POLY_SET m_fillHoles;         ///< Holes, as built by buildFeatureHoleList()
+    SHAPE_POLY_SET m_fillRawAreas;      ///< m_fillSolidAreas minus m_fillHoles, not fractured
+    int            m_fillRefillCount;   ///< Number of fills done by refillChangedAreas() since
+                                        ///< the last full fill
 };
 
 
@@ -60,6 +60,8 @@ ZONE_SETTINGS::ZONE_SETTINGS()
 
     m_Zone_45_Only = false;
 
+    m_TiledFill = false;
+
     m_cornerSmoothingType = SMOOTHING_NONE;
     m_cornerRadius = 0;
 
@@ -80,6 +82,7 @@ ZONE_SETTINGS& ZONE_SETTINGS::operator << ( const ZONE_CONTAINER& aSource )
     m_CurrentZone_Layer  = aSource.GetLayer();
     m_Zone_HatchingStyle = aSource.GetHatchStyle();
     m_ArcToSegmentsCount = aSource.GetArcSegmentCount();
+    m_TiledFill = aSource.GetTiledFill();
     m_ThermalReliefGap = aSource.GetThermalReliefGap();
     m_ThermalReliefCopperBridge = aSource.GetThermalReliefCopperBridge();
     m_PadConnection = aSource.GetPadConnection();
@@ -100,6 +103,7 @@ void ZONE_SETTINGS::ExportSetting( ZONE_CONTAINER& aTarget, bool aFullExport ) c
     aTarget.SetZoneClearance( m_ZoneClearance );
     aTarget.SetMinThickness( m_ZoneMinThickness );
     aTarget.SetArcSegmentCount( m_ArcToSegmentsCount );
+    aTarget.SetTiledFill( m_TiledFill );
     aTarget.SetThermalReliefGap( m_ThermalReliefGap );
     aTarget.SetThermalReliefCopperBridge( m_ThermalReliefCopperBridge );
     aTarget.SetPadConnection( m_PadConnection );
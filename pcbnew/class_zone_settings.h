@@ -77,6 +77,9 @@ public:
 
     bool m_Zone_45_Only;
 
+    /// Option to fill the zone by tiles, in parallel: for the largest zones (e.g. planes)
+    bool m_TiledFill;
+
 private:
     int  m_cornerSmoothingType;           ///< Corner smoothing type
     unsigned int  m_cornerRadius;         ///< Corner chamfer distance / fillet radius
@@ -39,12 +39,143 @@
 #include <dialog_cleaning_options.h>
 #include <ratsnest_data.h>
 
+#include <algorithm>
+#include <deque>
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+
+/**
+ * Class TRACK_ENDPOINT_MAP
+ * keeps the tracks and vias of a board by end point, so that the cleaner finds the
+ * items connected to a track end in constant time.  The cleaner removes the tracks it
+ * deletes, and indexes again the tracks it modifies.
+ */
+class TRACK_ENDPOINT_MAP
+{
+public:
+    void Build( TRACK* aTracks )
+    {
+        m_tracks.clear();
+        m_order.clear();
+
+        int order = 0;
+
+        for( TRACK* track = aTracks; track; track = track->Next() )
+        {
+            m_order[track] = order++;
+            Add( track );
+        }
+    }
+
+    void Add( TRACK* aTrack )
+    {
+        m_tracks[ key( aTrack->GetStart() ) ].push_back( aTrack );
+
+        if( aTrack->GetEnd() != aTrack->GetStart() )
+            m_tracks[ key( aTrack->GetEnd() ) ].push_back( aTrack );
+    }
+
+    void Remove( TRACK* aTrack )
+    {
+        remove( aTrack, aTrack->GetStart() );
+        remove( aTrack, aTrack->GetEnd() );
+    }
+
+    /**
+     * Function At
+     * @return the tracks with an end at aPosition, in any net and on any layer.
+     */
+    const TRACK_PTRS& At( const wxPoint& aPosition ) const
+    {
+        static const TRACK_PTRS none;
+
+        ENDPOINT_MAP::const_iterator it = m_tracks.find( key( aPosition ) );
+
+        return it == m_tracks.end() ? none : it->second;
+    }
+
+    /**
+     * Function Connected
+     * collects the tracks connected to aEndPoint of aTrack, as
+     * TRACK::GetTrack() tests them: sharing a layer, with an end at this
+     * point, and not flagged BUSY or IS_DELETED.
+     */
+    void Connected( const TRACK* aTrack, ENDPOINT_T aEndPoint, bool aSameNetOnly,
+                    TRACK_PTRS& aTracks ) const
+    {
+        const TRACK_PTRS& candidates = At( aTrack->GetEndPoint( aEndPoint ) );
+        LSET refLayers = aTrack->GetLayerSet();
+
+        aTracks.clear();
+
+        for( unsigned ii = 0; ii < candidates.size(); ii++ )
+        {
+            TRACK* other = candidates[ii];
+
+            if( other == aTrack || other->GetState( BUSY | IS_DELETED ) )
+                continue;
+
+            if( aSameNetOnly && other->GetNetCode() != aTrack->GetNetCode() )
+                continue;
+
+            if( ( refLayers & other->GetLayerSet() ).any() )
+                aTracks.push_back( other );
+        }
+    }
+
+    /**
+     * Function Order
+     * @return the position of aTrack in the track list when the map was built.
+     */
+    int Order( const TRACK* aTrack ) const
+    {
+        boost::unordered_map<const TRACK*, int>::const_iterator it = m_order.find( aTrack );
+
+        return it == m_order.end() ? -1 : it->second;
+    }
+
+private:
+    typedef boost::unordered_map< std::pair<int, int>, TRACK_PTRS > ENDPOINT_MAP;
+
+    static std::pair<int, int> key( const wxPoint& aPosition )
+    {
+        return std::make_pair( aPosition.x, aPosition.y );
+    }
+
+    void remove( TRACK* aTrack, const wxPoint& aPosition )
+    {
+        ENDPOINT_MAP::iterator it = m_tracks.find( key( aPosition ) );
+
+        if( it == m_tracks.end() )
+            return;
+
+        TRACK_PTRS& tracks = it->second;
+        tracks.erase( std::remove( tracks.begin(), tracks.end(), aTrack ), tracks.end() );
+
+        if( tracks.empty() )
+            m_tracks.erase( it );
+    }
+
+    ENDPOINT_MAP                            m_tracks;
+    boost::unordered_map<const TRACK*, int> m_order;
+};
+
+
 // Helper class used to clean tracks and vias
 class TRACKS_CLEANER: CONNECTIONS
 {
 private:
     BOARD *m_Brd;
 
+    /// The tracks of the board by end point
+    TRACK_ENDPOINT_MAP m_endpoints;
+
+    /// The tracks to examine by the current cleaning pass
+    std::deque<TRACK*>          m_pending;
+    boost::unordered_set<TRACK*> m_queued;
+
 public:
     TRACKS_CLEANER( BOARD * aPcb );
 
@@ -108,6 +239,15 @@ private:
     const ZONE_CONTAINER* zoneForTrackEndpoint( const TRACK *aTrack,
             ENDPOINT_T aEndPoint );
 
+    /// Deletes aTrack from the board, the ratsnest, the end point map and the pass queue
+    void removeTrack( TRACK* aTrack );
+
+    /// Queues aTrack for the current cleaning pass, if it is not already
+    void queueTrack( TRACK* aTrack );
+
+    /// @return the next track queued, or NULL once the queue is empty
+    TRACK* nextQueuedTrack();
+
     bool testTrackEndpointDangling( TRACK *aTrack, ENDPOINT_T aEndPoint );
 };
 
@@ -175,6 +315,7 @@ bool TRACKS_CLEANER::CleanupBoard( PCB_EDIT_FRAME *aFrame,
     {
         // Clear undo and redo lists to avoid inconsistencies between lists
         aFrame->GetScreen()->ClearUndoRedoList();
+        aFrame->GetJournal().Invalidate();
         aFrame->SetCurItem( NULL );
         aFrame->Compile_Ratsnest( NULL, true );
         aFrame->OnModify();
@@ -190,6 +331,42 @@ TRACKS_CLEANER::TRACKS_CLEANER( BOARD * aPcb ): CONNECTIONS( aPcb )
     // Build connections info
     BuildPadsList();
     buildTrackConnectionInfo();
+
+    m_endpoints.Build( m_Brd->m_Track );
+}
+
+
+void TRACKS_CLEANER::removeTrack( TRACK* aTrack )
+{
+    m_endpoints.Remove( aTrack );
+    m_queued.erase( aTrack );
+
+    m_Brd->GetRatsnest()->Remove( aTrack );
+    aTrack->ViewRelease();
+    aTrack->DeleteStructure();
+}
+
+
+void TRACKS_CLEANER::queueTrack( TRACK* aTrack )
+{
+    if( m_queued.insert( aTrack ).second )
+        m_pending.push_back( aTrack );
+}
+
+
+TRACK* TRACKS_CLEANER::nextQueuedTrack()
+{
+    while( !m_pending.empty() )
+    {
+        TRACK* track = m_pending.front();
+        m_pending.pop_front();
+
+        // The tracks deleted while queued are no more in m_queued
+        if( m_queued.erase( track ) )
+            return track;
+    }
+
+    return NULL;
 }
 
 void TRACKS_CLEANER::buildTrackConnectionInfo()
@@ -233,20 +410,20 @@ bool TRACKS_CLEANER::remove_duplicates_of_via( const VIA *aVia )
 {
     bool modified = false;
 
-    // Search and delete others vias at same location
-    VIA* next_via;
-    for( VIA* alt_via = GetFirstVia( aVia->Next() ); alt_via != NULL;
-            alt_via = next_via )
+    // Search and delete the following vias at same location
+    TRACK_PTRS others = m_endpoints.At( aVia->GetStart() );
+    int        order = m_endpoints.Order( aVia );
+
+    for( unsigned ii = 0; ii < others.size(); ii++ )
     {
-        next_via = GetFirstVia( alt_via->Next() );
+        VIA* alt_via = dyn_cast<VIA*>( others[ii] );
 
-        if( (alt_via->GetViaType() == VIA_THROUGH) &&
+        if( alt_via && alt_via != aVia && m_endpoints.Order( alt_via ) > order &&
+                (alt_via->GetViaType() == VIA_THROUGH) &&
                 (alt_via->GetStart() == aVia->GetStart()) )
         {
             // delete via
-            m_Brd->GetRatsnest()->Remove( alt_via );
-            alt_via->ViewRelease();
-            alt_via->DeleteStructure();
+            removeTrack( alt_via );
             modified = true;
         }
     }
@@ -257,22 +434,29 @@ bool TRACKS_CLEANER::clean_vias()
 {
     bool modified = false;
 
-    for( VIA* via = GetFirstVia( m_Brd->m_Track ); via != NULL;
-            via = GetFirstVia( via->Next() ) )
+    VIA* next_via;
+
+    for( VIA* via = GetFirstVia( m_Brd->m_Track ); via != NULL; via = next_via )
     {
         // Correct via m_End defects (if any), should never happen
         if( via->GetStart() != via->GetEnd() )
         {
             wxFAIL_MSG( wxT( "Via with mismatching ends" ) );
+            m_endpoints.Remove( via );
             via->SetEnd( via->GetStart() );
+            m_endpoints.Add( via );
         }
 
         /* Important: these cleanups only do thru hole vias, they don't
          * (yet) handle high density interconnects */
         if( via->GetViaType() != VIA_THROUGH )
-        {
             modified |= remove_duplicates_of_via( via );
 
+        // The duplicates removed follow the via, which can be removed below
+        next_via = GetFirstVia( via->Next() );
+
+        if( via->GetViaType() != VIA_THROUGH )
+        {
             /* To delete through Via on THT pads at same location
              * Examine the list of connected pads:
              * if one through pad is found, the via can be removed */
@@ -285,9 +469,7 @@ bool TRACKS_CLEANER::clean_vias()
                 if( (pad->GetLayerSet() & all_cu) == all_cu )
                 {
                     // redundant: delete the via
-                    m_Brd->GetRatsnest()->Remove( via );
-                    via->ViewRelease();
-                    via->DeleteStructure();
+                    removeTrack( via );
                     modified = true;
                     break;
                 }
@@ -322,9 +504,12 @@ const ZONE_CONTAINER* TRACKS_CLEANER::zoneForTrackEndpoint( const TRACK *aTrack,
  * Returns true if the track must be deleted, false if not necessarily */
 bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK *aTrack, ENDPOINT_T aEndPoint )
 {
-    bool flag_erase = false;
+    bool       flag_erase = false;
+    TRACK_PTRS connected;
 
-    TRACK* other = aTrack->GetTrack( m_Brd->m_Track, NULL, aEndPoint, true, false );
+    m_endpoints.Connected( aTrack, aEndPoint, true, connected );
+
+    TRACK* other = connected.empty() ? NULL : connected[0];
 
     if( (other == NULL) && (zoneForTrackEndpoint( aTrack, aEndPoint ) == NULL) )
         flag_erase = true; // Start endpoint is neither on pad, zone or other track
@@ -346,10 +531,10 @@ bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK *aTrack, ENDPOINT_T aEndPo
             // search for another segment following the via
             aTrack->SetState( BUSY, true );
 
-            other = via->GetTrack( m_Brd->m_Track, NULL, aEndPoint, true, false );
+            m_endpoints.Connected( via, aEndPoint, true, connected );
 
             // There is a via on the start but it goes nowhere
-            if( (other == NULL) &&
+            if( connected.empty() &&
                     (zoneForTrackEndpoint( via, aEndPoint ) == NULL) )
                 flag_erase = true;
 
@@ -371,46 +556,55 @@ bool TRACKS_CLEANER::deleteUnconnectedTracks()
         return false;
 
     bool modified = false;
-    bool item_erased;
-    do // Iterate when at least one track is deleted
+
+    // All the tracks are examined once, then only the tracks connected to a deleted track
+    m_pending.clear();
+    m_queued.clear();
+
+    for( TRACK* track = m_Brd->m_Track; track != NULL; track = track->Next() )
+        queueTrack( track );
+
+    while( TRACK* track = nextQueuedTrack() )
     {
-        item_erased = false;
-        TRACK* next_track;
-        for( TRACK *track = m_Brd->m_Track; track != NULL; track = next_track )
-        {
-            next_track = track->Next();
+        bool flag_erase = false; // Start without a good reason to erase it
+
+        /* if a track endpoint is not connected to a pad, test if
+         * the endpoint is connected to another track or to a zone.
+         * For via test, an enhancement could be to test if
+         * connected to 2 items on different layers. Currently
+         * a via must be connected to 2 items, that can be on the
+         * same layer */
 
-            bool flag_erase = false; // Start without a good reason to erase it
+        // Check if there is nothing attached on the start
+        if( !(track->GetState( START_ON_PAD )) )
+            flag_erase |= testTrackEndpointDangling( track, ENDPOINT_START );
 
-            /* if a track endpoint is not connected to a pad, test if
-             * the endpoint is connected to another track or to a zone.
-             * For via test, an enhancement could be to test if
-             * connected to 2 items on different layers. Currently
-             * a via must be connected to 2 items, that can be on the
-             * same layer */
+        // Check if there is nothing attached on the end
+        if( !(track->GetState( END_ON_PAD )) )
+            flag_erase |= testTrackEndpointDangling( track, ENDPOINT_END );
+
+        if( flag_erase )
+        {
+            /* a track connected to the deleted track, or to a via the deleted
+             * track was connected to, now perhaps is not connected and should be
+             * deleted: examine it again */
+            TRACK_PTRS neighbours = m_endpoints.At( track->GetStart() );
+            const TRACK_PTRS& endNeighbours = m_endpoints.At( track->GetEnd() );
 
-            // Check if there is nothing attached on the start
-            if( !(track->GetState( START_ON_PAD )) )
-                flag_erase |= testTrackEndpointDangling( track, ENDPOINT_START );
+            neighbours.insert( neighbours.end(), endNeighbours.begin(), endNeighbours.end() );
 
-            // Check if there is nothing attached on the end
-            if( !(track->GetState( END_ON_PAD )) )
-                flag_erase |= testTrackEndpointDangling( track, ENDPOINT_END );
+            // remove segment from board
+            removeTrack( track );
 
-            if( flag_erase )
+            for( unsigned ii = 0; ii < neighbours.size(); ii++ )
             {
-                // remove segment from board
-                m_Brd->GetRatsnest()->Remove( track );
-                track->ViewRelease();
-                track->DeleteStructure();
-
-                /* keep iterating, because a track connected to the deleted track
-                 * now perhaps is not connected and should be deleted */
-                item_erased = true;
-                modified = true;
+                if( neighbours[ii] != track )
+                    queueTrack( neighbours[ii] );
             }
+
+            modified = true;
         }
-    } while( item_erased );
+    }
 
     return modified;
 }
@@ -428,9 +622,7 @@ bool TRACKS_CLEANER::delete_null_segments()
 
         if( segment->IsNull() )     // Length segment = 0; delete it
         {
-            m_Brd->GetRatsnest()->Remove( segment );
-            segment->ViewRelease();
-            segment->DeleteStructure();
+            removeTrack( segment );
             modified = true;
         }
     }
@@ -441,14 +633,20 @@ bool TRACKS_CLEANER::remove_duplicates_of_track( const TRACK *aTrack )
 {
     bool modified = false;
 
-    TRACK *nextsegment;
-    for( TRACK *other = aTrack->Next(); other; other = nextsegment )
+    // The candidates have an end at the start of aTrack, and follow it in the list
+    TRACK_PTRS others = m_endpoints.At( aTrack->GetStart() );
+    int        order = m_endpoints.Order( aTrack );
+
+    for( unsigned ii = 0; ii < others.size(); ii++ )
     {
-        nextsegment = other->Next();
+        TRACK* other = others[ii];
 
-        // New netcode, break out (can't be there any other)
+        if( other == aTrack || m_endpoints.Order( other ) <= order )
+            continue;
+
+        // Other netcode (can't be the same track)
         if( aTrack->GetNetCode() != other->GetNetCode() )
-            break;
+            continue;
 
         // Must be of the same type, on the same layer and the endpoints
         // must be the same (maybe swapped)
@@ -460,9 +658,7 @@ bool TRACKS_CLEANER::remove_duplicates_of_track( const TRACK *aTrack )
                 ((aTrack->GetStart() == other->GetEnd()) &&
                  (aTrack->GetEnd() == other->GetStart())))
             {
-                m_Brd->GetRatsnest()->Remove( other );
-                other->ViewRelease();
-                other->DeleteStructure();
+                removeTrack( other );
                 modified = true;
             }
         }
@@ -472,47 +668,40 @@ bool TRACKS_CLEANER::remove_duplicates_of_track( const TRACK *aTrack )
 
 bool TRACKS_CLEANER::merge_collinear_of_track( TRACK *aSegment )
 {
-    bool merged_this = false;
+    bool       merged_this = false;
+    TRACK_PTRS connected;
 
     // *WHY* doesn't C++ have prec and succ (or ++ --) like PASCAL?
     for( ENDPOINT_T endpoint = ENDPOINT_START; endpoint <= ENDPOINT_END;
             endpoint = ENDPOINT_T( endpoint + 1 ) )
     {
         // search for a possible segment connected to the current endpoint of the current one
-        TRACK *other = aSegment->Next();
-        if( other )
+        m_endpoints.Connected( aSegment, endpoint, true, connected );
+
+        // There can be only one segment connected
+        if( connected.size() != 1 )
+            continue;
+
+        TRACK* other = connected[0];
+
+        // the two segments must have the same width and the other
+        // cannot be a via
+        if( (aSegment->GetWidth() == other->GetWidth()) &&
+                (other->Type() == PCB_TRACE_T) )
         {
-            other = aSegment->GetTrack( other, NULL, endpoint, true, false );
+            // Try to merge them; aSegment gets a new end point
+            m_endpoints.Remove( aSegment );
 
-            if( other )
+            TRACK *segDelete = mergeCollinearSegmentIfPossible( aSegment,
+                    other, endpoint );
+
+            m_endpoints.Add( aSegment );
+
+            // Merge succesful, the other one has to go away
+            if( segDelete )
             {
-                // the two segments must have the same width and the other
-                // cannot be a via
-                if( (aSegment->GetWidth() == other->GetWidth()) &&
-                        (other->Type() == PCB_TRACE_T) )
-                {
-                    // There can be only one segment connected
-                    other->SetState( BUSY, true );
-                    TRACK *yet_another = aSegment->GetTrack( m_Brd->m_Track, NULL,
-                            endpoint, true, false );
-                    other->SetState( BUSY, false );
-
-                    if( !yet_another )
-                    {
-                        // Try to merge them
-                        TRACK *segDelete = mergeCollinearSegmentIfPossible( aSegment,
-                                other, endpoint );
-
-                        // Merge succesful, the other one has to go away
-                        if( segDelete )
-                        {
-                            m_Brd->GetRatsnest()->Remove( segDelete );
-                            segDelete->ViewRelease();
-                            segDelete->DeleteStructure();
-                            merged_this = true;
-                        }
-                    }
-                }
+                removeTrack( segDelete );
+                merged_this = true;
             }
         }
     }
@@ -532,22 +721,23 @@ bool TRACKS_CLEANER::clean_segments()
     for( TRACK *segment = m_Brd->m_Track; segment; segment = segment->Next() )
         modified |= remove_duplicates_of_track( segment );
 
-    // merge collinear segments:
-    TRACK *nextsegment;
+    // merge collinear segments: a merged segment is queued again, to be merged with
+    // its new neighbours
+    m_pending.clear();
+    m_queued.clear();
 
-    for( TRACK *segment = m_Brd->m_Track; segment; segment = nextsegment )
+    for( TRACK *segment = m_Brd->m_Track; segment; segment = segment->Next() )
     {
-        nextsegment = segment->Next();
-
         if( segment->Type() == PCB_TRACE_T )
-        {
-            bool merged_this = merge_collinear_of_track( segment );
+            queueTrack( segment );
+    }
 
-            if( merged_this ) // The current segment was modified, retry to merge it again
-            {
-                nextsegment = segment->Next();
-                modified = true;
-            }
+    while( TRACK* segment = nextQueuedTrack() )
+    {
+        if( merge_collinear_of_track( segment ) )
+        {
+            queueTrack( segment );
+            modified = true;
         }
     }
 
@@ -637,6 +827,7 @@ TRACK* TRACKS_CLEANER::mergeCollinearSegmentIfPossible( TRACK* aTrackRef, TRACK*
             aTrackRef->start = aCandidate->end;
             aTrackRef->SetState( START_ON_PAD, aCandidate->GetState( END_ON_PAD) );
             aTrackRef->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
+            m_Brd->OnItemChanged( aTrackRef );
             return aCandidate;
         }
         else
@@ -645,6 +836,7 @@ TRACK* TRACKS_CLEANER::mergeCollinearSegmentIfPossible( TRACK* aTrackRef, TRACK*
             aTrackRef->start = aCandidate->start;
             aTrackRef->SetState( START_ON_PAD, aCandidate->GetState( START_ON_PAD) );
             aTrackRef->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
+            m_Brd->OnItemChanged( aTrackRef );
             return aCandidate;
         }
     }
@@ -662,6 +854,7 @@ TRACK* TRACKS_CLEANER::mergeCollinearSegmentIfPossible( TRACK* aTrackRef, TRACK*
             aTrackRef->end = aCandidate->end;
             aTrackRef->SetState( END_ON_PAD, aCandidate->GetState( END_ON_PAD) );
             aTrackRef->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
+            m_Brd->OnItemChanged( aTrackRef );
             return aCandidate;
         }
         else
@@ -670,6 +863,7 @@ TRACK* TRACKS_CLEANER::mergeCollinearSegmentIfPossible( TRACK* aTrackRef, TRACK*
             aTrackRef->end = aCandidate->start;
             aTrackRef->SetState( END_ON_PAD, aCandidate->GetState( START_ON_PAD) );
             aTrackRef->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
+            m_Brd->OnItemChanged( aTrackRef );
             return aCandidate;
         }
     }
@@ -22,13 +22,24 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+
 #include <collectors.h>
 #include <class_board_item.h>             // class BOARD_ITEM
 
+#include <class_board.h>
 #include <class_module.h>
 #include <class_pad.h>
 #include <class_track.h>
 #include <class_marker_pcb.h>
+#include <convert_to_biu.h>
+#include <view/view.h>
+
+#include <boost/unordered_set.hpp>
+
+/// How far out of its bounding box an item can be hit, the corner and edge distance
+/// of ZONE_CONTAINER::HitTest()
+#define HITTEST_MARGIN  Millimeter2iu( 0.25 )
 
 
 /*  This module contains out of line member functions for classes given in
@@ -477,6 +488,90 @@ void GENERAL_COLLECTOR::Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
 }
 
 
+// Returns the position of aType in aScanList, or -1 if it is not scanned
+static int scanRank( const KICAD_T aScanList[], KICAD_T aType )
+{
+    for( int i = 0; aScanList[i] != EOT; ++i )
+    {
+        if( aScanList[i] == aType )
+            return i;
+    }
+
+    return -1;
+}
+
+
+// Sorts the candidates of a collection in the order of the scan list, as Visit() does
+struct SCAN_ORDER
+{
+    const KICAD_T* m_scanList;
+
+    SCAN_ORDER( const KICAD_T aScanList[] ) : m_scanList( aScanList ) {}
+
+    bool operator()( const BOARD_ITEM* aA, const BOARD_ITEM* aB ) const
+    {
+        return scanRank( m_scanList, aA->Type() ) < scanRank( m_scanList, aB->Type() );
+    }
+};
+
+
+// see collectors.h
+void GENERAL_COLLECTOR::Collect( BOARD* aBoard, const KIGFX::VIEW* aView,
+                                 const KICAD_T aScanList[], const wxPoint& aRefPos,
+                                 const COLLECTORS_GUIDE& aGuide )
+{
+    Empty();        // empty the collection, primary criteria list
+    Empty2nd();     // empty the collection, secondary criteria list
+
+    SetGuide( &aGuide );
+    SetScanTypes( aScanList );
+    SetRefPos( aRefPos );
+
+    // Broad phase: the items whose bounding box is near aRefPos
+    BOX2I area( VECTOR2I( aRefPos ), VECTOR2I( 0, 0 ) );
+    area.Inflate( HITTEST_MARGIN );
+
+    std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR> found;
+    aView->Query( area, found );
+
+    // An item is found once per layer it is drawn on
+    std::vector<BOARD_ITEM*>            candidates;
+    boost::unordered_set<BOARD_ITEM*>   added;
+
+    for( unsigned i = 0; i < found.size(); ++i )
+    {
+        BOARD_ITEM* item = static_cast<BOARD_ITEM*>( found[i].first );
+
+        if( scanRank( aScanList, item->Type() ) >= 0 && added.insert( item ).second )
+            candidates.push_back( item );
+    }
+
+    // The markers are on a display only layer, which is not queried
+    if( scanRank( aScanList, PCB_MARKER_T ) >= 0 )
+    {
+        for( int i = 0; i < aBoard->GetMARKERCount(); ++i )
+            candidates.push_back( aBoard->GetMARKER( i ) );
+    }
+
+    std::stable_sort( candidates.begin(), candidates.end(), SCAN_ORDER( aScanList ) );
+
+    // Narrow phase: the hit tests of Inspect()
+    for( unsigned i = 0; i < candidates.size(); ++i )
+        Inspect( candidates[i], NULL );
+
+    SetTimeNow();               // when snapshot was taken
+
+    // record the length of the primary list before concatenating on to it.
+    m_PrimaryLength = m_List.size();
+
+    // append 2nd list onto end of the first list
+    for( unsigned i = 0;  i<m_List2nd.size();  ++i )
+        Append( m_List2nd[i] );
+
+    Empty2nd();
+}
+
+
 // see collectors.h
 SEARCH_RESULT PCB_TYPE_COLLECTOR::Inspect( EDA_ITEM* testItem, const void* testData )
 {
@@ -40,6 +40,12 @@
 
 
 class BOARD_ITEM;
+class BOARD;
+
+namespace KIGFX
+{
+    class VIEW;
+}
 
 
 /**
@@ -370,6 +376,23 @@ public:
      */
     void Collect( BOARD_ITEM* aItem, const KICAD_T aScanList[],
                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
+
+    /**
+     * Function Collect
+     * collects the same items as Collect( aBoard, ... ) without visiting the whole board:
+     * the R-tree of the view showing the board gives the items whose bounding box is near
+     * aRefPos, and only these are hit tested by Inspect().  The items are collected in
+     * the order of aScanList, but not in the order of the board lists within a type.
+     * @param aBoard is the board shown by aView.
+     * @param aView is the view indexing the items of aBoard.
+     * @param aScanList A list of KICAD_Ts with a terminating EOT, that specs
+     *  what is to be collected and the priority order of the resultant
+     *  collection in "m_List".
+     * @param aRefPos A wxPoint to use in hit-testing.
+     * @param aGuide The COLLECTORS_GUIDE to use in collecting items.
+     */
+    void Collect( BOARD* aBoard, const KIGFX::VIEW* aView, const KICAD_T aScanList[],
+                  const wxPoint& aRefPos, const COLLECTORS_GUIDE& aGuide );
 };
 
 
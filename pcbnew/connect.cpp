@@ -141,83 +141,49 @@ void CONNECTIONS::SearchTracksConnectedToPads( bool add_to_padlist, bool add_to_
     }
 }
 
+/* RTree search callback: stores the index of a candidate found in m_candidatesIndex
+ * aContext is the std::vector<int> to fill
+ */
+static bool collectCandidateIndex( int aIndex, void* aContext )
+{
+    static_cast< std::vector<int>* >( aContext )->push_back( aIndex );
+    return true;
+}
+
+
 void CONNECTIONS::CollectItemsNearTo( std::vector<CONNECTED_POINT*>& aList,
                                        const wxPoint& aPosition, int aDistMax )
 {
     /* Search items in m_Candidates that position is <= aDistMax from aPosition
      * (Rectilinear distance)
-     * m_Candidates is sorted by X then Y values, so a fast binary search is used
-     * to locate the "best" entry point in list
-     * The best entry is a pad having its m_Pos.x == (or near) aPosition.x
-     * All candidates are near this candidate in list
-     * So from this entry point, a linear search is made to find all candidates
+     * m_candidatesIndex is a R-tree of the candidate points, so only the
+     * candidates inside the search square are visited, whatever the
+     * number of candidates sharing the same X coordinate.
      */
-    int idxmax = m_candidates.size()-1;
+    const int mmin[2] = { aPosition.x - aDistMax, aPosition.y - aDistMax };
+    const int mmax[2] = { aPosition.x + aDistMax, aPosition.y + aDistMax };
 
-    int delta = m_candidates.size();
+    m_foundCandidates.clear();
+    m_candidatesIndex.Search( mmin, mmax, collectCandidateIndex, &m_foundCandidates );
 
-    int idx = 0;        // Starting index is the beginning of list
-    while( delta )
-    {
-        // Calculate half size of remaining interval to test.
-        // Ensure the computed value is not truncated (too small)
-        if( (delta & 1) && ( delta > 1 ) )
-            delta++;
-        delta /= 2;
+    // Keep the m_candidates order (sorted by X then Y), the tree order is not stable
+    sort( m_foundCandidates.begin(), m_foundCandidates.end() );
 
-        CONNECTED_POINT& item = m_candidates[idx];
+    for( unsigned ii = 0; ii < m_foundCandidates.size(); ii++ )
+        aList.push_back( &m_candidates[ m_foundCandidates[ii] ] );
+}
 
-        int dist = item.GetPoint().x - aPosition.x;
-        if( abs(dist) <= aDistMax )
-        {
-            break;   // A good entry point is found. The list can be scanned from this point.
-        }
 
-        else if( item.GetPoint().x < aPosition.x ) // We should search after this item
-        {
-            idx += delta;
-            if( idx > idxmax )
-                idx = idxmax;
-        }
-        else    // We should search before this item
-        {
-            idx -= delta;
-            if( idx < 0 )
-                idx = 0;
-        }
-    }
+void CONNECTIONS::buildCandidatesIndex()
+{
+    m_candidatesIndex.RemoveAll();
 
-    /* Now explore the candidate list from the "best" entry point found
-     * (candidate "near" aPosition.x)
-     * We explore the list until abs(candidate->m_Point.x - aPosition.x) > aDistMax
-     * because the list is sorted by X position (and for a given X pos, by Y pos)
-     * Currently a linear search is made because the number of candidates
-     * having the right X position is usually small
-     */
-    // search next candidates in list
-    wxPoint diff;
-    for( int ii = idx; ii <= idxmax; ii++ )
+    for( unsigned ii = 0; ii < m_candidates.size(); ii++ )
     {
-        CONNECTED_POINT* item = &m_candidates[ii];
-        diff = item->GetPoint() - aPosition;
-        if( abs(diff.x) > aDistMax )
-            break;    // Exit: the distance is to long, we cannot find other candidates
-        if( abs(diff.y) > aDistMax )
-            continue;    // the y distance is to long, but we can find other candidates
-        // We have here a good candidate: add it
-        aList.push_back( item );
-    }
-    // search previous candidates in list
-    for(  int ii = idx-1; ii >=0; ii-- )
-    {
-        CONNECTED_POINT * item = &m_candidates[ii];
-        diff = item->GetPoint() - aPosition;
-        if( abs(diff.x) > aDistMax )
-            break;
-        if( abs(diff.y) > aDistMax )
-            continue;
-        // We have here a good candidate:add it
-        aList.push_back( item );
+        const wxPoint& point = m_candidates[ii].GetPoint();
+        const int pos[2] = { point.x, point.y };
+
+        m_candidatesIndex.Insert( pos, pos, ii );
     }
 }
 
@@ -232,6 +198,8 @@ void CONNECTIONS::BuildPadsCandidatesList()
         CONNECTED_POINT candidate( pad, pad->GetPosition() );
         m_candidates.push_back( candidate );
     }
+
+    buildCandidatesIndex();
 }
 
 /* sort function used to sort .m_Connected by X the Y values
@@ -288,6 +256,8 @@ void CONNECTIONS::BuildTracksCandidatesList( TRACK* aBegin, TRACK* aEnd)
     // and for increasing Y coordinate when items have the same X coordinate
     // So candidates to the same location are consecutive in list.
     sort( m_candidates.begin(), m_candidates.end(), sortConnectedPointByXthenYCoordinates );
+
+    buildCandidatesIndex();
 }
 
 
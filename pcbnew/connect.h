@@ -32,6 +32,7 @@
 
 #include <class_track.h>
 #include <class_board.h>
+#include <geometry/rtree.h>
 
 
 // Helper classes to handle connection points (i.e. candidates) for tracks
@@ -95,6 +96,8 @@ private:
                                                 // to a given track or via
     std::vector <CONNECTED_POINT> m_candidates; // List of points to test
                                                 // (end points of tracks or vias location )
+    RTree<int, int, 2, float> m_candidatesIndex; // Spatial index of m_candidates (by index)
+    std::vector<int> m_foundCandidates;         // Search buffer used by CollectItemsNearTo
     BOARD * m_brd;                              // the master board.
     const TRACK * m_firstTrack;                 // The first track used to build m_Candidates
     const TRACK * m_lastTrack;                  // The last track used to build m_Candidates
@@ -199,7 +202,9 @@ public:
      * function CollectItemsNearTo
      * Used by SearchTracksConnectedToPads
      * Fills aList with pads near to aPosition
-     * near means aPosition to pad position <= aDistMax
+     * near means aPosition to pad position <= aDistMax (rectilinear distance)
+     * Items are found from m_candidatesIndex, and are added by increasing
+     * X (then Y) coordinate, i.e. in the m_candidates order.
      * @param aList = list to fill
      * @param aPosition = aPosition to use as reference
      * @param aDistMax = dist max from aPosition to a candidate to select it
@@ -224,6 +229,17 @@ public:
     void Propagate_SubNets();
 
 private:
+    // m_candidatesIndex owns its nodes through raw pointers, so it cannot be copied
+    CONNECTIONS( const CONNECTIONS& );
+    CONNECTIONS& operator=( const CONNECTIONS& );
+
+    /**
+     * function buildCandidatesIndex
+     * Rebuilds m_candidatesIndex from m_candidates.
+     * Must be called each time m_candidates is modified.
+     */
+    void buildCandidatesIndex();
+
     /**
      * function searchEntryPointInCandidatesList
      * Search an item in m_Connected connected to aPoint
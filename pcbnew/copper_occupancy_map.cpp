@@ -0,0 +1,531 @@
+/**
+ * @file copper_occupancy_map.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <fctsys.h>
+#include <convert_to_biu.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+
+#include <copper_occupancy_map.h>
+
+
+// The distances are kept up to this number of cells, a larger distance being stored as
+// MAX_DISTANCE; so a change redoes the distance transform up to this far only
+#define MAX_DISTANCE        16
+
+// Bounds of the grid: a large board gets larger cells
+#define MAX_CELLS_PER_SIDE  512
+#define MIN_CELL_SIZE       Millimeter2iu( 0.1 )
+
+// The margin around the items when the map is built, left for the next edits
+#define GRID_MARGIN         Millimeter2iu( 10.0 )
+
+
+COPPER_OCCUPANCY_MAP::COPPER_OCCUPANCY_MAP( BOARD* aBoard ) :
+    m_board( aBoard ),
+    m_valid( false ),
+    m_cellSize( 0 ),
+    m_columns( 0 ),
+    m_rows( 0 )
+{
+    m_board->AddListener( this );
+}
+
+
+COPPER_OCCUPANCY_MAP::~COPPER_OCCUPANCY_MAP()
+{
+    m_board->RemoveListener( this );
+}
+
+
+void COPPER_OCCUPANCY_MAP::OnBoardItemAdded( const BOARD_ITEM* aItem )
+{
+    if( m_valid )
+        m_dirtyItems.insert( dirtyItem( aItem ) );
+}
+
+
+void COPPER_OCCUPANCY_MAP::OnBoardItemRemoved( const BOARD_ITEM* aItem )
+{
+    if( !m_valid )
+        return;
+
+    // A removed item can be deleted before the next Update(): its stamps are removed now
+    const BOARD_ITEM* parent = dirtyItem( aItem );
+
+    if( parent == aItem )
+    {
+        m_dirtyItems.erase( aItem );
+        unstampItem( aItem );
+    }
+    else
+    {
+        // A single pad of a footprint, the footprint is rasterized again
+        m_dirtyItems.insert( parent );
+    }
+}
+
+
+void COPPER_OCCUPANCY_MAP::OnBoardItemChanged( const BOARD_ITEM* aItem )
+{
+    if( m_valid )
+        m_dirtyItems.insert( dirtyItem( aItem ) );
+}
+
+
+const BOARD_ITEM* COPPER_OCCUPANCY_MAP::dirtyItem( const BOARD_ITEM* aItem ) const
+{
+    if( aItem->Type() == PCB_PAD_T && aItem->GetParent() )
+        return static_cast<const BOARD_ITEM*>( aItem->GetParent() );
+
+    return aItem;
+}
+
+
+void COPPER_OCCUPANCY_MAP::Invalidate()
+{
+    m_valid = false;
+
+    m_layers.clear();
+    m_stamps.clear();
+    m_dirtyItems.clear();
+}
+
+
+void COPPER_OCCUPANCY_MAP::Update()
+{
+    if( !m_valid )
+    {
+        build();
+        return;
+    }
+
+    if( m_dirtyItems.empty() )
+        return;
+
+    for( std::set<const BOARD_ITEM*>::iterator it = m_dirtyItems.begin();
+         it != m_dirtyItems.end(); ++it )
+    {
+        unstampItem( *it );
+
+        // An item moved out of the grid: the grid is sized again
+        if( !stampItem( *it ) )
+        {
+            Invalidate();
+            build();
+            return;
+        }
+    }
+
+    m_dirtyItems.clear();
+
+    for( unsigned layer = 0; layer < m_layers.size(); ++layer )
+    {
+        if( m_layers[layer].m_dirty )
+            updateDistances( m_layers[layer] );
+    }
+}
+
+
+int COPPER_OCCUPANCY_MAP::cellX( int aX ) const
+{
+    // floor division, the coordinates can be before the origin
+    int dx = aX - m_origin.x;
+
+    return dx >= 0 ? dx / m_cellSize : -( ( m_cellSize - 1 - dx ) / m_cellSize );
+}
+
+
+int COPPER_OCCUPANCY_MAP::cellY( int aY ) const
+{
+    int dy = aY - m_origin.y;
+
+    return dy >= 0 ? dy / m_cellSize : -( ( m_cellSize - 1 - dy ) / m_cellSize );
+}
+
+
+static EDA_RECT padArea( const D_PAD* aPad )
+{
+    EDA_RECT area = aPad->GetBoundingBox();
+
+    // the hole of a pad without copper can be larger than its pad
+    area.Merge( EDA_RECT( aPad->GetPosition() - wxPoint( aPad->GetDrillSize().x / 2,
+                                                         aPad->GetDrillSize().y / 2 ),
+                          aPad->GetDrillSize() ) );
+    area.Inflate( aPad->GetClearance() + 1 );
+
+    return area;
+}
+
+
+static EDA_RECT trackArea( const TRACK* aTrack )
+{
+    EDA_RECT area = aTrack->GetBoundingBox();
+
+    area.Inflate( aTrack->GetClearance() + 1 );
+
+    return area;
+}
+
+
+void COPPER_OCCUPANCY_MAP::build()
+{
+    EDA_RECT area;
+    bool     hasItems = false;
+
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+        {
+            if( hasItems )
+                area.Merge( padArea( pad ) );
+            else
+                area = padArea( pad );
+
+            hasItems = true;
+        }
+    }
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+    {
+        if( hasItems )
+            area.Merge( trackArea( track ) );
+        else
+            area = trackArea( track );
+
+        hasItems = true;
+    }
+
+    area.Inflate( GRID_MARGIN );
+
+    int side = std::max( area.GetWidth(), area.GetHeight() );
+
+    m_cellSize = std::max( (int) MIN_CELL_SIZE, side / MAX_CELLS_PER_SIDE + 1 );
+    m_origin = area.GetOrigin();
+    m_columns = area.GetWidth() / m_cellSize + 1;
+    m_rows = area.GetHeight() / m_cellSize + 1;
+
+    m_layers.clear();
+    m_layers.resize( B_Cu + 1 );
+    m_stamps.clear();
+
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+        stampItem( module );
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+        stampItem( track );
+
+    for( unsigned layer = 0; layer < m_layers.size(); ++layer )
+    {
+        if( m_layers[layer].m_dirty )
+            updateDistances( m_layers[layer] );
+    }
+
+    m_dirtyItems.clear();
+    m_valid = true;
+}
+
+
+bool COPPER_OCCUPANCY_MAP::stampItem( const BOARD_ITEM* aItem )
+{
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+
+        for( const D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+        {
+            // The holes are tested on all the copper layers
+            LSET layers = pad->GetDrillSize().x > 0 ? LSET::AllCuMask() : pad->GetLayerSet();
+
+            if( !addStamp( aItem, padArea( pad ), layers ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    if( aItem->Type() == PCB_TRACE_T || aItem->Type() == PCB_VIA_T )
+    {
+        const TRACK* track = static_cast<const TRACK*>( aItem );
+
+        return addStamp( aItem, trackArea( track ), track->GetLayerSet() );
+    }
+
+    // Only the pads and the tracks are tested by DRC::doTrackDrc()
+    return true;
+}
+
+
+bool COPPER_OCCUPANCY_MAP::addStamp( const BOARD_ITEM* aItem, const EDA_RECT& aArea,
+                                     LSET aLayers )
+{
+    STAMP stamp;
+
+    stamp.m_layers = aLayers & LSET::AllCuMask();
+    stamp.m_x0 = cellX( aArea.GetX() );
+    stamp.m_y0 = cellY( aArea.GetY() );
+    stamp.m_x1 = cellX( aArea.GetRight() ) + 1;
+    stamp.m_y1 = cellY( aArea.GetBottom() ) + 1;
+
+    if( stamp.m_layers.none() )
+        return true;
+
+    if( stamp.m_x0 < 0 || stamp.m_y0 < 0 || stamp.m_x1 > m_columns || stamp.m_y1 > m_rows )
+        return false;
+
+    m_stamps[aItem].push_back( stamp );
+    applyStamp( stamp, 1 );
+
+    return true;
+}
+
+
+void COPPER_OCCUPANCY_MAP::unstampItem( const BOARD_ITEM* aItem )
+{
+    STAMPS::iterator it = m_stamps.find( aItem );
+
+    if( it == m_stamps.end() )
+        return;
+
+    for( unsigned ii = 0; ii < it->second.size(); ++ii )
+        applyStamp( it->second[ii], -1 );
+
+    m_stamps.erase( it );
+}
+
+
+void COPPER_OCCUPANCY_MAP::applyStamp( const STAMP& aStamp, int aDelta )
+{
+    for( LSEQ cu = aStamp.m_layers.CuStack();  cu;  ++cu )
+    {
+        LAYER_GRID& grid = m_layers[*cu];
+
+        if( grid.m_counts.empty() )
+        {
+            grid.m_counts.assign( m_columns * m_rows, 0 );
+            grid.m_distances.assign( m_columns * m_rows, MAX_DISTANCE );
+        }
+
+        for( int y = aStamp.m_y0; y < aStamp.m_y1; ++y )
+        {
+            unsigned short* count = &grid.m_counts[y * m_columns + aStamp.m_x0];
+
+            for( int x = aStamp.m_x0; x < aStamp.m_x1; ++x, ++count )
+            {
+                wxASSERT( aDelta > 0 ? *count < 0xFFFF : *count > 0 );
+                *count += aDelta;
+            }
+        }
+
+        if( !grid.m_dirty )
+        {
+            grid.m_dirty = true;
+            grid.m_dirtyX0 = aStamp.m_x0;
+            grid.m_dirtyY0 = aStamp.m_y0;
+            grid.m_dirtyX1 = aStamp.m_x1;
+            grid.m_dirtyY1 = aStamp.m_y1;
+        }
+        else
+        {
+            grid.m_dirtyX0 = std::min( grid.m_dirtyX0, aStamp.m_x0 );
+            grid.m_dirtyY0 = std::min( grid.m_dirtyY0, aStamp.m_y0 );
+            grid.m_dirtyX1 = std::max( grid.m_dirtyX1, aStamp.m_x1 );
+            grid.m_dirtyY1 = std::max( grid.m_dirtyY1, aStamp.m_y1 );
+        }
+    }
+}
+
+
+void COPPER_OCCUPANCY_MAP::updateDistances( LAYER_GRID& aGrid )
+{
+    // The cells farther than MAX_DISTANCE from the dirty ones keep their distance: the
+    // window is measured again, its neighbour cells being the other sources
+    int x0 = std::max( aGrid.m_dirtyX0 - MAX_DISTANCE, 0 );
+    int y0 = std::max( aGrid.m_dirtyY0 - MAX_DISTANCE, 0 );
+    int x1 = std::min( aGrid.m_dirtyX1 + MAX_DISTANCE, m_columns );
+    int y1 = std::min( aGrid.m_dirtyY1 + MAX_DISTANCE, m_rows );
+
+    aGrid.m_dirty = false;
+
+    std::vector<unsigned char>& dist = aGrid.m_distances;
+    const int                   cols = m_columns;
+
+    for( int y = y0; y < y1; ++y )
+    {
+        for( int x = x0; x < x1; ++x )
+            dist[y * cols + x] = aGrid.m_counts[y * cols + x] ? 0 : MAX_DISTANCE;
+    }
+
+    // Two pass chessboard distance transform: the forward pass propagates the distances
+    // from the left and from above, the backward one from the right and from below
+    for( int y = y0; y < y1; ++y )
+    {
+        for( int x = x0; x < x1; ++x )
+        {
+            unsigned char d = dist[y * cols + x];
+
+            if( x > 0 )
+                d = std::min<unsigned char>( d, dist[y * cols + x - 1] + 1 );
+
+            if( y > 0 )
+            {
+                const unsigned char* above = &dist[( y - 1 ) * cols + x];
+
+                d = std::min<unsigned char>( d, above[0] + 1 );
+
+                if( x > 0 )
+                    d = std::min<unsigned char>( d, above[-1] + 1 );
+
+                if( x + 1 < cols )
+                    d = std::min<unsigned char>( d, above[1] + 1 );
+            }
+
+            dist[y * cols + x] = d;
+        }
+    }
+
+    for( int y = y1 - 1; y >= y0; --y )
+    {
+        for( int x = x1 - 1; x >= x0; --x )
+        {
+            unsigned char d = dist[y * cols + x];
+
+            if( x + 1 < cols )
+                d = std::min<unsigned char>( d, dist[y * cols + x + 1] + 1 );
+
+            if( y + 1 < m_rows )
+            {
+                const unsigned char* below = &dist[( y + 1 ) * cols + x];
+
+                d = std::min<unsigned char>( d, below[0] + 1 );
+
+                if( x > 0 )
+                    d = std::min<unsigned char>( d, below[-1] + 1 );
+
+                if( x + 1 < cols )
+                    d = std::min<unsigned char>( d, below[1] + 1 );
+            }
+
+            dist[y * cols + x] = std::min<unsigned char>( d, MAX_DISTANCE );
+        }
+    }
+}
+
+
+// The distance from ( aX, aY ) to the segment from aStart to aEnd
+static double distanceToSegment( double aX, double aY, const wxPoint& aStart,
+                                 const wxPoint& aEnd )
+{
+    double dx = aEnd.x - aStart.x;
+    double dy = aEnd.y - aStart.y;
+    double px = aX - aStart.x;
+    double py = aY - aStart.y;
+    double len2 = dx * dx + dy * dy;
+
+    if( len2 > 0.0 )
+    {
+        double t = std::max( 0.0, std::min( 1.0, ( px * dx + py * dy ) / len2 ) );
+
+        px -= t * dx;
+        py -= t * dy;
+    }
+
+    return sqrt( px * px + py * py );
+}
+
+
+static inline int clampCell( int aCell, int aCount )
+{
+    return std::max( 0, std::min( aCell, aCount - 1 ) );
+}
+
+
+bool COPPER_OCCUPANCY_MAP::IsClear( const TRACK* aTrack ) const
+{
+    if( !m_valid )
+        return false;
+
+    // An occupied cell holds an item inflated by its clearance: the track is clear of it
+    // with its own clearance when they are this many cells apart
+    int needed = 1 + ( aTrack->GetClearance() + m_cellSize - 1 ) / m_cellSize;
+
+    if( needed >= MAX_DISTANCE )
+        return false;
+
+    LSET layers = aTrack->GetLayerSet() & LSET::AllCuMask();
+
+    // A via has the same start and end
+    wxPoint start = aTrack->GetStart();
+    wxPoint end = aTrack->Type() == PCB_VIA_T ? start : aTrack->GetEnd();
+    int     radius = aTrack->GetWidth() / 2 + 1;
+
+    // A cell can touch the track when its centre is this close to the segment.  The
+    // cells out of the grid are tested as the nearest cells of the grid, which are not
+    // farther from the occupied cells.
+    double reach = radius + m_cellSize * 0.7072;     // half the cell diagonal
+
+    int x0 = clampCell( cellX( std::min( start.x, end.x ) - radius ), m_columns );
+    int y0 = clampCell( cellY( std::min( start.y, end.y ) - radius ), m_rows );
+    int x1 = clampCell( cellX( std::max( start.x, end.x ) + radius ), m_columns );
+    int y1 = clampCell( cellY( std::max( start.y, end.y ) + radius ), m_rows );
+
+    for( int y = y0; y <= y1; ++y )
+    {
+        double cy = m_origin.y + ( y + 0.5 ) * m_cellSize;
+
+        for( int x = x0; x <= x1; ++x )
+        {
+            double cx = m_origin.x + ( x + 0.5 ) * m_cellSize;
+
+            // the clamped cells of a track out of the grid are always considered
+            bool clamped = ( x == 0 || y == 0 || x == m_columns - 1 || y == m_rows - 1 );
+
+            if( !clamped && distanceToSegment( cx, cy, start, end ) > reach )
+                continue;
+
+            for( LSEQ cu = layers.CuStack();  cu;  ++cu )
+            {
+                const LAYER_GRID& grid = m_layers[*cu];
+
+                // no copper at all on this layer
+                if( grid.m_distances.empty() )
+                    continue;
+
+                if( grid.m_distances[y * m_columns + x] < needed )
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,155 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file copper_occupancy_map.h
+ * @brief A coarse raster of the copper of a board, telling which places are clear.
+ */
+
+#ifndef COPPER_OCCUPANCY_MAP_H
+#define COPPER_OCCUPANCY_MAP_H
+
+#include <set>
+#include <vector>
+
+#include <class_board.h>
+
+#include <boost/unordered_map.hpp>
+
+class TRACK;
+
+
+/**
+ * Class COPPER_OCCUPANCY_MAP
+ * rasterizes the pads and the tracks of a board in a grid of coarse cells, one grid
+ * per copper layer, each item being inflated by its clearance.  A distance transform
+ * gives for each cell its distance, in cells, to the nearest occupied one.
+ *
+ * It answers in a few cell reads whether a new track segment or via is definitely clear
+ * of the copper: then the exact DRC tests are not needed.  Otherwise, near the copper,
+ * the exact tests decide.  The items of the net of the segment are not told apart, so
+ * a segment touching its own net is never definitely clear.
+ *
+ * It is owned by the BOARD, built on the first Update(), and then kept up to date from
+ * the board change notifications, like the BOARD_ITEM_INDEX: only the cells near the
+ * items changed since the previous Update() are rasterized and measured again.
+ */
+class COPPER_OCCUPANCY_MAP : public BOARD_LISTENER
+{
+public:
+    COPPER_OCCUPANCY_MAP( BOARD* aBoard );
+    ~COPPER_OCCUPANCY_MAP();
+
+    void OnBoardItemAdded( const BOARD_ITEM* aItem );
+    void OnBoardItemRemoved( const BOARD_ITEM* aItem );
+    void OnBoardItemChanged( const BOARD_ITEM* aItem );
+
+    /**
+     * Function Invalidate
+     * drops the map, which is built again by the next Update().  To be used when the
+     * board has been modified without notifications.
+     */
+    void Invalidate();
+
+    /**
+     * Function Update
+     * builds the map, or rasterizes again the items changed since the previous call.
+     */
+    void Update();
+
+    /**
+     * Function IsClear
+     * tells whether aTrack, with its clearance, is far enough from all the pads and the
+     * tracks of the board, as they were at the last Update().  aTrack should not be on
+     * the board: its own cells would be occupied.
+     * @return true if aTrack is definitely clear, false if it has to be tested exactly.
+     */
+    bool IsClear( const TRACK* aTrack ) const;
+
+    /// The size of the cells, in internal units
+    int GetCellSize() const { return m_cellSize; }
+
+private:
+    /// The cells of an item on a set of layers, inflated by its clearance
+    struct STAMP
+    {
+        LSET    m_layers;
+        int     m_x0, m_y0;     ///< the first cell
+        int     m_x1, m_y1;     ///< the cell after the last one
+    };
+
+    /// The raster of a copper layer
+    struct LAYER_GRID
+    {
+        std::vector<unsigned short> m_counts;       ///< the items on each cell
+        std::vector<unsigned char>  m_distances;    ///< see MAX_DISTANCE
+        bool                        m_dirty;
+        int                         m_dirtyX0, m_dirtyY0, m_dirtyX1, m_dirtyY1;
+
+        LAYER_GRID() : m_dirty( false ) { }
+    };
+
+    typedef boost::unordered_map<const BOARD_ITEM*, std::vector<STAMP> > STAMPS;
+
+    // Not copyable, like the BOARD_ITEM_INDEX
+    COPPER_OCCUPANCY_MAP( const COPPER_OCCUPANCY_MAP& );
+    COPPER_OCCUPANCY_MAP& operator=( const COPPER_OCCUPANCY_MAP& );
+
+    // sizes the grid from the board items, and rasterizes them
+    void build();
+
+    // adds the cells of aItem, a track or a footprint; false if out of the grid
+    bool stampItem( const BOARD_ITEM* aItem );
+
+    // adds a stamp of aItem over aArea in IU, to the cells and to m_stamps
+    bool addStamp( const BOARD_ITEM* aItem, const EDA_RECT& aArea, LSET aLayers );
+
+    // removes the cells of aItem, if it was rasterized
+    void unstampItem( const BOARD_ITEM* aItem );
+
+    // adds aDelta to the item count of the cells of aStamp, and marks them dirty
+    void applyStamp( const STAMP& aStamp, int aDelta );
+
+    // computes again the distances of the dirty cells, and of the cells near them
+    void updateDistances( LAYER_GRID& aGrid );
+
+    // the track or footprint whose cells change when aItem changes
+    const BOARD_ITEM* dirtyItem( const BOARD_ITEM* aItem ) const;
+
+    int cellX( int aX ) const;
+    int cellY( int aY ) const;
+
+    BOARD*                          m_board;
+    bool                            m_valid;
+
+    wxPoint                         m_origin;       ///< the corner of the first cell
+    int                             m_cellSize;
+    int                             m_columns;
+    int                             m_rows;
+
+    std::vector<LAYER_GRID>         m_layers;       ///< indexed by copper LAYER_ID
+    STAMPS                          m_stamps;
+    std::set<const BOARD_ITEM*>     m_dirtyItems;
+};
+
+#endif  // COPPER_OCCUPANCY_MAP_H
@@ -177,6 +177,7 @@ void PCB_EDIT_FRAME::Delete_net( wxDC* DC, TRACK* aTrack )
         GetBoard()->GetRatsnest()->Remove( segm );
         segm->ViewRelease();
         GetBoard()->m_Track.Remove( segm );
+        GetBoard()->OnItemRemoved( segm );
 
         // redraw the area where the track was
         m_canvas->RefreshDrawingRect( segm->GetBoundingBox() );
@@ -224,6 +225,7 @@ void PCB_EDIT_FRAME::Remove_One_Track( wxDC* DC, TRACK* pt_segm )
         GetBoard()->GetRatsnest()->Remove( tracksegment );
         tracksegment->ViewRelease();
         GetBoard()->m_Track.Remove( tracksegment );
+        GetBoard()->OnItemRemoved( tracksegment );
 
         // redraw the area where the track was
         m_canvas->RefreshDrawingRect( tracksegment->GetBoundingBox() );
@@ -230,6 +230,8 @@ void DIALOG_COPPER_ZONE::initDialog()
     m_ArcApproximationOpt->SetSelection(
         m_settings.m_ArcToSegmentsCount == ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF ? 1 : 0 );
 
+    m_TiledFillOpt->SetValue( m_settings.m_TiledFill );
+
     // Create one column in m_LayerSelectionCtrl
     wxListItem column0;
     column0.SetId( 0 );
@@ -371,6 +373,8 @@ bool DIALOG_COPPER_ZONE::AcceptOptions( bool aPromptForErrors, bool aUseExportab
                                            ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF :
                                            ARC_APPROX_SEGMENTS_COUNT_LOW_DEF;
 
+    m_settings.m_TiledFill = m_TiledFillOpt->GetValue();
+
     if( m_Config )
     {
         m_Config->Write( ZONE_NET_OUTLINES_HATCH_OPTION_KEY,
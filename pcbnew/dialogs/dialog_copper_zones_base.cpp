@@ -213,6 +213,11 @@ DIALOG_COPPER_ZONE_BASE::DIALOG_COPPER_ZONE_BASE( wxWindow* parent, wxWindowID i
 	m_ArcApproximationOpt->SetSelection( 0 );
 	m_MiddleBox->Add( m_ArcApproximationOpt, 0, wxBOTTOM|wxEXPAND|wxLEFT|wxRIGHT, 5 );
 	
+	m_TiledFillOpt = new wxCheckBox( m_ExportableSetupSizer->GetStaticBox(), wxID_ANY, _("Tiled fill"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_TiledFillOpt->SetToolTip( _("Fill the zone by tiles, in parallel.\nOnly useful for large planes with many holes.") );
+	
+	m_MiddleBox->Add( m_TiledFillOpt, 0, wxBOTTOM|wxRIGHT|wxLEFT, 5 );
+	
 	
 	m_ExportableSetupSizer->Add( m_MiddleBox, 0, wxEXPAND, 5 );
 	
@@ -26,6 +26,7 @@ class wxListView;
 #include <wx/listbox.h>
 #include <wx/choice.h>
 #include <wx/textctrl.h>
+#include <wx/checkbox.h>
 #include <wx/button.h>
 #include <wx/statbox.h>
 #include <wx/spinctrl.h>
@@ -105,6 +106,7 @@ class DIALOG_COPPER_ZONE_BASE : public DIALOG_SHIM
 		wxChoice* m_FillModeCtrl;
 		wxStaticText* m_staticText12;
 		wxChoice* m_ArcApproximationOpt;
+		wxCheckBox* m_TiledFillOpt;
 		wxStaticText* m_staticText14;
 		wxChoice* m_OrientEdgesOpt;
 		wxStaticText* m_staticText15;
@@ -272,6 +272,7 @@ void DIALOG_MODULE_BOARD_EDITOR::InitModeditProperties()
     wxString alias;
     wxString shortPath;
     S3D_FILENAME_RESOLVER* res = Prj().Get3DCacheManager()->GetResolver();
+    std::list< wxString > models;
 
     while( draw3D )
     {
@@ -281,6 +282,7 @@ void DIALOG_MODULE_BOARD_EDITOR::InitModeditProperties()
             draw3DCopy->Copy( draw3D );
             m_Shapes3D_list.push_back( draw3DCopy );
             origPath = draw3DCopy->GetShape3DName();
+            models.push_back( origPath );
 
             if( res && res->SplitAlias( origPath, alias, shortPath ) )
             {
@@ -295,6 +297,9 @@ void DIALOG_MODULE_BOARD_EDITOR::InitModeditProperties()
         draw3D = (S3D_MASTER*) draw3D->Next();
     }
 
+    // the models are read at once, on all the threads, before the preview needs them
+    Prj().Get3DCacheManager()->Preload( models );
+
     m_ReferenceCopy = new TEXTE_MODULE( NULL );
     m_ValueCopy     = new TEXTE_MODULE( NULL );
     m_ReferenceCopy->Copy( &m_CurrentModule->Reference() );
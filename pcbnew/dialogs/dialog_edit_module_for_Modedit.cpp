@@ -124,6 +124,7 @@ void DIALOG_MODULE_MODULE_EDITOR::initModeditProperties()
     wxString alias;
     wxString shortPath;
     S3D_FILENAME_RESOLVER* res = Prj().Get3DCacheManager()->GetResolver();
+    std::list< wxString > models;
 
     while( draw3D )
     {
@@ -134,6 +135,7 @@ void DIALOG_MODULE_MODULE_EDITOR::initModeditProperties()
             m_shapes3D_list.push_back( draw3DCopy );
 
             origPath = draw3DCopy->GetShape3DName();
+            models.push_back( origPath );
 
             if( res && res->SplitAlias( origPath, alias, shortPath ) )
             {
@@ -148,6 +150,9 @@ void DIALOG_MODULE_MODULE_EDITOR::initModeditProperties()
         draw3D = (S3D_MASTER*) draw3D->Next();
     }
 
+    // the models are read at once, on all the threads, before the preview needs them
+    Prj().Get3DCacheManager()->Preload( models );
+
     m_DocCtrl->SetValue( m_currentModule->GetDescription() );
     m_KeywordCtrl->SetValue( m_currentModule->GetKeywords() );
     m_referenceCopy = new TEXTE_MODULE( NULL );
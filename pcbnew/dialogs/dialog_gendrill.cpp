@@ -51,6 +51,7 @@
 #define MirrorKey               wxT( "DrillMirrorYOpt" )
 #define MinimalHeaderKey        wxT( "DrillMinHeader" )
 #define MergePTHNPTHKey         wxT( "DrillMergePTHNPTH" )
+#define OptimizePathsKey        wxT( "DrillOptimizePaths" )
 #define UnitDrillInchKey        wxT( "DrillUnit" )
 #define DrillOriginIsAuxAxisKey wxT( "DrillAuxAxis" )
 #define DrillMapFileTypeKey     wxT( "DrillMapFileType" )
@@ -92,6 +93,7 @@ int DIALOG_GENDRILL::m_ZerosFormat     = EXCELLON_WRITER::DECIMAL_FORMAT;
 bool DIALOG_GENDRILL::m_MinimalHeader   = false;
 bool DIALOG_GENDRILL::m_Mirror = false;
 bool DIALOG_GENDRILL::m_Merge_PTH_NPTH = false;
+bool DIALOG_GENDRILL::m_OptimizeToolPaths = false;
 bool DIALOG_GENDRILL::m_DrillOriginIsAuxAxis = false;
 int DIALOG_GENDRILL::m_mapFileType = 1;
 
@@ -107,6 +109,7 @@ void DIALOG_GENDRILL::initDialog()
     m_config->Read( ZerosFormatKey, &m_ZerosFormat );
     m_config->Read( MirrorKey, &m_Mirror );
     m_config->Read( MergePTHNPTHKey, &m_Merge_PTH_NPTH );
+    m_config->Read( OptimizePathsKey, &m_OptimizeToolPaths );
     m_config->Read( MinimalHeaderKey, &m_MinimalHeader );
     m_config->Read( UnitDrillInchKey, &m_UnitDrillIsInch );
     m_config->Read( DrillOriginIsAuxAxisKey, &m_DrillOriginIsAuxAxis );
@@ -130,6 +133,7 @@ void DIALOG_GENDRILL::InitDisplayParams()
 
     m_Check_Mirror->SetValue( m_Mirror );
     m_Check_Merge_PTH_NPTH->SetValue( m_Merge_PTH_NPTH );
+    m_Check_Optimize_Paths->SetValue( m_OptimizeToolPaths );
     m_Choice_Drill_Map->SetSelection( m_mapFileType );
     m_ViaDrillValue->SetLabel( _( "Use Netclasses values" ) );
     m_MicroViaDrillValue->SetLabel( _( "Use Netclasses values" ) );
@@ -231,6 +235,7 @@ void DIALOG_GENDRILL::UpdateConfig()
     m_config->Write( ZerosFormatKey, m_ZerosFormat );
     m_config->Write( MirrorKey, m_Mirror );
     m_config->Write( MergePTHNPTHKey, m_Merge_PTH_NPTH );
+    m_config->Write( OptimizePathsKey, m_OptimizeToolPaths );
     m_config->Write( MinimalHeaderKey, m_MinimalHeader );
     m_config->Write( UnitDrillInchKey, m_UnitDrillIsInch );
     m_config->Write( DrillOriginIsAuxAxisKey, m_DrillOriginIsAuxAxis );
@@ -334,6 +339,7 @@ void DIALOG_GENDRILL::SetParams()
     m_MinimalHeader   = m_Check_Minimal->IsChecked();
     m_Mirror = m_Check_Mirror->IsChecked();
     m_Merge_PTH_NPTH = m_Check_Merge_PTH_NPTH->IsChecked();
+    m_OptimizeToolPaths = m_Check_Optimize_Paths->IsChecked();
     m_ZerosFormat = m_Choice_Zeros_Format->GetSelection();
     m_DrillOriginIsAuxAxis = m_Choice_Drill_Offset->GetSelection();
 
@@ -375,6 +381,7 @@ void DIALOG_GENDRILL::GenDrillAndMapFiles(bool aGenDrill, bool aGenMap)
                               m_Precision.m_lhs, m_Precision.m_rhs );
     excellonWriter.SetOptions( m_Mirror, m_MinimalHeader,
                                m_FileDrillOffset, m_Merge_PTH_NPTH );
+    excellonWriter.SetOptimizeToolPaths( m_OptimizeToolPaths );
     excellonWriter.SetMapFileFormat( filefmt[choice] );
 
     excellonWriter.CreateDrillandMapFilesSet( defaultPath, aGenDrill, aGenMap,
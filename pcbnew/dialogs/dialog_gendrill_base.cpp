@@ -97,6 +97,11 @@ DIALOG_GENDRILL_BASE::DIALOG_GENDRILL_BASE( wxWindow* parent, wxWindowID id, con
 	
 	sbOptSizer->Add( m_Check_Merge_PTH_NPTH, 0, wxALL, 5 );
 	
+	m_Check_Optimize_Paths = new wxCheckBox( sbOptSizer->GetStaticBox(), wxID_ANY, _("Optimize the drilling path of each tool"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_Check_Optimize_Paths->SetToolTip( _("Order the holes of each tool along a short path, instead of by position.\nReduces the drilling time on machines which do not optimize the path themselves.") );
+	
+	sbOptSizer->Add( m_Check_Optimize_Paths, 0, wxALL, 5 );
+	
 	
 	bMiddleBoxSizer->Add( sbOptSizer, 0, wxEXPAND|wxRIGHT|wxLEFT, 5 );
 	
@@ -160,6 +160,9 @@ void DIALOG_PLOT::Init_Dialog()
     // Option for including Gerber attributes (from Gerber X2 format) in the output
     m_useGerberAttributes->SetValue( m_plotOpts.GetUseGerberAttributes() );
 
+    // Option for writing compact Gerber files
+    m_useGerberOptimization->SetValue( m_plotOpts.GetUseGerberOptimization() );
+
     // Gerber precision for coordinates
     m_rbGerberFormat->SetSelection( m_plotOpts.GetGerberPrecision() == 5 ? 0 : 1 );
 
@@ -368,6 +371,8 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
         m_useGerberExtensions->SetValue( false );
         m_useGerberAttributes->Enable( false );
         m_useGerberAttributes->SetValue( false );
+        m_useGerberOptimization->Enable( false );
+        m_useGerberOptimization->SetValue( false );
         m_scaleOpt->Enable( false );
         m_scaleOpt->SetSelection( 1 );
         m_fineAdjustXscaleOpt->Enable( false );
@@ -397,6 +402,8 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
         m_useGerberExtensions->SetValue( false );
         m_useGerberAttributes->Enable( false );
         m_useGerberAttributes->SetValue( false );
+        m_useGerberOptimization->Enable( false );
+        m_useGerberOptimization->SetValue( false );
         m_scaleOpt->Enable( true );
         m_fineAdjustXscaleOpt->Enable( true );
         m_fineAdjustYscaleOpt->Enable( true );
@@ -423,6 +430,7 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
         m_subtractMaskFromSilk->Enable( true );
         m_useGerberExtensions->Enable( true );
         m_useGerberAttributes->Enable( true );
+        m_useGerberOptimization->Enable( true );
         m_scaleOpt->Enable( false );
         m_scaleOpt->SetSelection( 1 );
         m_fineAdjustXscaleOpt->Enable( false );
@@ -453,6 +461,8 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
         m_useGerberExtensions->SetValue( false );
         m_useGerberAttributes->Enable( false );
         m_useGerberAttributes->SetValue( false );
+        m_useGerberOptimization->Enable( false );
+        m_useGerberOptimization->SetValue( false );
         m_scaleOpt->Enable( true );
         m_fineAdjustXscaleOpt->Enable( false );
         m_fineAdjustYscaleOpt->Enable( false );
@@ -481,6 +491,8 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
         m_useGerberExtensions->SetValue( false );
         m_useGerberAttributes->Enable( false );
         m_useGerberAttributes->SetValue( false );
+        m_useGerberOptimization->Enable( false );
+        m_useGerberOptimization->SetValue( false );
         m_scaleOpt->Enable( false );
         m_scaleOpt->SetSelection( 1 );
         m_fineAdjustXscaleOpt->Enable( false );
@@ -650,6 +662,7 @@ void DIALOG_PLOT::applyPlotSettings()
 
     tempOptions.SetUseGerberProtelExtensions( m_useGerberExtensions->GetValue() );
     tempOptions.SetUseGerberAttributes( m_useGerberAttributes->GetValue() );
+    tempOptions.SetUseGerberOptimization( m_useGerberOptimization->GetValue() );
     tempOptions.SetGerberPrecision( m_rbGerberFormat->GetSelection() == 0 ? 5 : 6 );
 
     LSET selectedLayers;
@@ -757,8 +770,14 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
     // Save the current plot options in the board
     m_parent->SetPlotSettings( m_plotOpts );
 
+    // The filled areas saved in the board file can be outdated: refill the zones whose
+    // fill inputs have changed since they were filled, and only them
+    m_parent->Fill_All_Zones( this, false, true );
+
     wxBusyCursor dummy;
 
+    std::vector<PLOT_LAYER_JOB> jobs;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         LAYER_ID layer = *seq;
@@ -784,26 +803,29 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
                            m_board->GetLayerName( layer ),
                            file_ext );
 
-        LOCALE_IO toggle;
+        PLOT_LAYER_JOB job;
 
-        BOARD*      board = m_parent->GetBoard();
-        PLOTTER*    plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
+        job.m_Layer = layer;
+        job.m_FileName = fn.GetFullPath();
+        jobs.push_back( job );
+    }
 
+    // All the layers are plotted concurrently
+    PlotBoardLayers( m_parent->GetBoard(), &m_plotOpts, jobs, wxEmptyString );
+
+    for( unsigned ii = 0; ii < jobs.size(); ii++ )
+    {
         // Print diags in messages box:
         wxString msg;
 
-        if( plotter )
+        if( jobs[ii].m_Plotted )
         {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter;
-
-            msg.Printf( _( "Plot file '%s' created." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Plot file '%s' created." ), GetChars( jobs[ii].m_FileName ) );
             reporter.Report( msg, REPORTER::RPT_ACTION );
         }
         else
         {
-            msg.Printf( _( "Unable to create file '%s'." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Unable to create file '%s'." ), GetChars( jobs[ii].m_FileName ) );
             reporter.Report( msg, REPORTER::RPT_ERROR );
         }
     }
@@ -232,6 +232,11 @@ DIALOG_PLOT_BASE::DIALOG_PLOT_BASE( wxWindow* parent, wxWindowID id, const wxStr
 	
 	bSizerGbrOpt->Add( m_useGerberAttributes, 0, wxALL, 2 );
 	
+	m_useGerberOptimization = new wxCheckBox( m_GerberOptionsSizer->GetStaticBox(), wxID_ANY, _("Optimize file size"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_useGerberOptimization->SetToolTip( _("Write compact Gerber files: chained tracks, zones as single regions, and coordinates written only when changed") );
+	
+	bSizerGbrOpt->Add( m_useGerberOptimization, 0, wxALL, 2 );
+	
 	m_subtractMaskFromSilk = new wxCheckBox( m_GerberOptionsSizer->GetStaticBox(), wxID_ANY, _("Subtract soldermask from silkscreen"), wxDefaultPosition, wxDefaultSize, 0 );
 	m_subtractMaskFromSilk->SetToolTip( _("Remove silkscreen from areas without soldermask") );
 	
@@ -93,6 +93,7 @@ class DIALOG_PLOT_BASE : public DIALOG_SHIM
 		wxStaticBoxSizer* m_GerberOptionsSizer;
 		wxCheckBox* m_useGerberExtensions;
 		wxCheckBox* m_useGerberAttributes;
+		wxCheckBox* m_useGerberOptimization;
 		wxCheckBox* m_subtractMaskFromSilk;
 		wxRadioBox* m_rbGerberFormat;
 		wxStaticBoxSizer* m_HPGLOptionsSizer;
@@ -36,6 +36,8 @@
 #include <pcbnew.h>
 #include <wxPcbStruct.h>
 #include <class_board.h>
+#include <net_lengths.h>
+#include <base_units.h>
 #include <dialog_select_net_from_list_base.h>
 #include <eda_pattern_match.h>
 
@@ -45,6 +47,9 @@
 
 #define COL_NETNAME 0
 #define COL_NETINFO 1
+#define COL_VIAS    2
+#define COL_LENGTH  3
+#define COL_LAYERS  4
 
 class DIALOG_SELECT_NET_FROM_LIST: public DIALOG_SELECT_NET_FROM_LIST_BASE
 {
@@ -65,6 +70,9 @@ private:
 	void onFilterChange( wxCommandEvent& event );
 
     void buildNetsList();
+
+    // returns the length of each layer of a net, from the front layer
+    wxString layerLengths( const NET_LENGTH& aLength );
 };
 
 
@@ -126,6 +134,10 @@ void DIALOG_SELECT_NET_FROM_LIST::buildNetsList()
     filter.SetPattern( netFilter.MakeUpper() );
     wxString txt;
 
+    // All the nets are measured once, when the board is loaded, and then only the
+    // tracks modified since
+    BOARD_NET_LENGTHS& lengths = m_brd->GetNetLengths();
+
     int row_idx = 0;
 
     // Populate the nets list with nets names matching the filters:
@@ -160,6 +172,14 @@ void DIALOG_SELECT_NET_FROM_LIST::buildNetsList()
         else    // For the net 0 (unconnected pads), the pad count is not known
             m_netsListGrid->SetCellValue( row_idx, COL_NETINFO, "---" );
 
+        const NET_LENGTH& length = lengths.GetNet( net->GetNet() );
+
+        txt.Printf( wxT( "%d" ), length.m_ViaCount );
+        m_netsListGrid->SetCellValue( row_idx, COL_VIAS, txt );
+        m_netsListGrid->SetCellValue( row_idx, COL_LENGTH,
+                                      LengthDoubleToString( length.GetTotalLength() ) );
+        m_netsListGrid->SetCellValue( row_idx, COL_LAYERS, layerLengths( length ) );
+
         row_idx++;
     }
 
@@ -177,6 +197,23 @@ void DIALOG_SELECT_NET_FROM_LIST::buildNetsList()
 }
 
 
+wxString DIALOG_SELECT_NET_FROM_LIST::layerLengths( const NET_LENGTH& aLength )
+{
+    wxString txt;
+
+    for( std::map<LAYER_ID, long long>::const_iterator it = aLength.m_LayerLengths.begin();
+         it != aLength.m_LayerLengths.end(); ++it )
+    {
+        if( !txt.IsEmpty() )
+            txt += wxT( ", " );
+
+        txt += m_brd->GetLayerName( it->first ) + wxT( " " ) + LengthDoubleToString( it->second );
+    }
+
+    return txt;
+}
+
+
 DIALOG_SELECT_NET_FROM_LIST::~DIALOG_SELECT_NET_FROM_LIST()
 {
 }
@@ -39,20 +39,26 @@ DIALOG_SELECT_NET_FROM_LIST_BASE::DIALOG_SELECT_NET_FROM_LIST_BASE( wxWindow* pa
 	m_netsListGrid = new wxGrid( this, wxID_ANY, wxDefaultPosition, wxDefaultSize, 0 );
 	
 	// Grid
-	m_netsListGrid->CreateGrid( 1, 2 );
+	m_netsListGrid->CreateGrid( 1, 5 );
 	m_netsListGrid->EnableEditing( false );
 	m_netsListGrid->EnableGridLines( true );
 	m_netsListGrid->EnableDragGridSize( false );
 	m_netsListGrid->SetMargins( 0, 0 );
 	
 	// Columns
-	m_netsListGrid->SetColSize( 0, 325 );
+	m_netsListGrid->SetColSize( 0, 250 );
 	m_netsListGrid->SetColSize( 1, 100 );
+	m_netsListGrid->SetColSize( 2, 60 );
+	m_netsListGrid->SetColSize( 3, 100 );
+	m_netsListGrid->SetColSize( 4, 250 );
 	m_netsListGrid->EnableDragColMove( false );
 	m_netsListGrid->EnableDragColSize( true );
 	m_netsListGrid->SetColLabelSize( 20 );
 	m_netsListGrid->SetColLabelValue( 0, _("Net name") );
 	m_netsListGrid->SetColLabelValue( 1, _("Number of pads") );
+	m_netsListGrid->SetColLabelValue( 2, _("Vias") );
+	m_netsListGrid->SetColLabelValue( 3, _("Routed length") );
+	m_netsListGrid->SetColLabelValue( 4, _("Length per layer") );
 	m_netsListGrid->SetColLabelAlignment( wxALIGN_LEFT, wxALIGN_CENTRE );
 	
 	// Rows
@@ -65,7 +71,7 @@ DIALOG_SELECT_NET_FROM_LIST_BASE::DIALOG_SELECT_NET_FROM_LIST_BASE( wxWindow* pa
 	
 	// Cell Defaults
 	m_netsListGrid->SetDefaultCellAlignment( wxALIGN_LEFT, wxALIGN_TOP );
-	m_netsListGrid->SetMinSize( wxSize( 485,300 ) );
+	m_netsListGrid->SetMinSize( wxSize( 820,300 ) );
 	
 	bSizerMain->Add( m_netsListGrid, 1, wxALL|wxEXPAND, 5 );
 	
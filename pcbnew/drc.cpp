@@ -28,7 +28,14 @@
  * @file drc.cpp
  */
 
+#include <atomic>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 #include <fctsys.h>
+#include <common.h>
 #include <wxPcbStruct.h>
 #include <trigo.h>
 #include <base_units.h>
@@ -42,12 +49,17 @@
 #include <class_draw_panel_gal.h>
 #include <view/view.h>
 #include <geometry/seg.h>
+#include <ratsnest_data.h>
 
 #include <tool/tool_manager.h>
 #include <tools/common_actions.h>
 
 #include <pcbnew.h>
 #include <drc_stuff.h>
+#include <drc_rtree.h>
+#include <drc_online.h>
+#include <copper_occupancy_map.h>
+#include <trace_events.h>
 
 #include <dialog_drc.h>
 #include <wx/progdlg.h>
@@ -92,6 +104,20 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
 {
     m_mainWindow = aPcbWindow;
     m_pcb = aPcbWindow->GetBoard();
+    init();
+}
+
+
+DRC::DRC( BOARD* aBoard )
+{
+    m_mainWindow = NULL;
+    m_pcb = aBoard;
+    init();
+}
+
+
+void DRC::init()
+{
     m_drcDialog  = NULL;
 
     // establish initial values for everything:
@@ -107,6 +133,7 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     // m_rptFilename set to empty by its constructor
 
     m_currentMarker = NULL;
+    m_online = NULL;
 
     m_segmAngle  = 0;
     m_segmLength = 0;
@@ -120,6 +147,8 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
 
 DRC::~DRC()
 {
+    delete m_online;
+
     // maybe someday look at pointainer.h  <- google for "pointainer.h"
     for( unsigned i = 0; i<m_unconnected.size();  ++i )
         delete m_unconnected[i];
@@ -130,7 +159,12 @@ int DRC::Drc( TRACK* aRefSegm, TRACK* aList )
 {
     updatePointers();
 
-    if( !doTrackDrc( aRefSegm, aList, true ) )
+    // A new segment, not yet on the board, drawn away from the copper needs no exact test
+    // against the pads and the tracks
+    bool clear = aRefSegm->IsNew() && aList == m_pcb->m_Track
+                 && m_pcb->GetCopperOccupancy().IsClear( aRefSegm );
+
+    if( !clear && !doTrackDrc( aRefSegm, aList, true ) )
     {
         wxASSERT( m_currentMarker );
 
@@ -165,14 +199,41 @@ int DRC::Drc( ZONE_CONTAINER* aArea, int aCornerIndex )
 }
 
 
+void DRC::EnableOnlineTests( bool aEnable )
+{
+    delete m_online;
+    m_online = NULL;
+
+    if( aEnable )
+    {
+        m_pcb = m_mainWindow->GetBoard();
+        m_online = new DRC_ONLINE( this, m_pcb );
+    }
+}
+
+
+void DRC::RunOnlineTests()
+{
+    if( m_online )
+        m_online->Update();
+}
+
+
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
+    TRACE_SCOPE( "DRC::RunTests" );
+
     // be sure m_pcb is the current board, not a old one
     // ( the board can be reloaded )
-    m_pcb = m_mainWindow->GetBoard();
+    updatePointers();
+
+    m_timings.clear();
+
+    unsigned startTime = GetRunningMicroSecs();
 
     // Ensure ratsnest is up to date:
-    if( (m_pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
+    // (without a frame, testUnconnected() uses the board connectivity data instead)
+    if( m_mainWindow && (m_pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
     {
         if( aMessages )
         {
@@ -181,10 +242,13 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         }
 
         m_mainWindow->Compile_Ratsnest( NULL, true );
+        addPhaseTiming( wxT( "ratsnest" ), startTime );
     }
 
     // someone should have cleared the two lists before calling this.
 
+    startTime = GetRunningMicroSecs();
+
     if( !testNetClasses() )
     {
         // testing the netclasses is a special case because if the netclasses
@@ -194,12 +258,16 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         if( aMessages )
             aMessages->AppendText( _( "Aborting\n" ) );
 
+        addPhaseTiming( wxT( "netclasses" ), startTime );
+
         // update the m_drcDialog listboxes
         updatePointers();
 
         return;
     }
 
+    addPhaseTiming( wxT( "netclasses" ), startTime );
+
     // test pad to pad clearances, nothing to do with tracks, vias or zones.
     if( m_doPad2PadTest )
     {
@@ -209,7 +277,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             wxSafeYield();
         }
 
+        startTime = GetRunningMicroSecs();
         testPad2Pad();
+        addPhaseTiming( wxT( "pad_clearances" ), startTime );
     }
 
     // test track and via clearances to other tracks, pads, and vias
@@ -219,18 +289,27 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testTracks( aMessages ? aMessages->GetParent() : m_mainWindow, true );
+    startTime = GetRunningMicroSecs();
+    testTracks( aMessages ? aMessages->GetParent() : m_mainWindow, m_mainWindow != NULL );
+    addPhaseTiming( wxT( "track_clearances" ), startTime );
 
-    // Before testing segments and unconnected, refill all zones:
-    // this is a good caution, because filled areas can be outdated.
+    // Before testing segments and unconnected, refill the zones whose filled areas
+    // are outdated.
     if( aMessages )
     {
         aMessages->AppendText( _( "Fill zones...\n" ) );
         wxSafeYield();
     }
 
-    m_mainWindow->Fill_All_Zones( aMessages ? aMessages->GetParent() : m_mainWindow,
-                                  false );
+    startTime = GetRunningMicroSecs();
+
+    if( m_mainWindow )
+        m_mainWindow->Fill_All_Zones( aMessages ? aMessages->GetParent() : m_mainWindow,
+                                      false, true );
+    else
+        fillAllZones();
+
+    addPhaseTiming( wxT( "zone_fill" ), startTime );
 
     // test zone clearances to other zones
     if( aMessages )
@@ -239,7 +318,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
+    startTime = GetRunningMicroSecs();
     testZones();
+    addPhaseTiming( wxT( "zones" ), startTime );
 
     // find and gather unconnected pads.
     if( m_doUnconnectedTest )
@@ -250,7 +331,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        startTime = GetRunningMicroSecs();
         testUnconnected();
+        addPhaseTiming( wxT( "unconnected" ), startTime );
     }
 
     // find and gather vias, tracks, pads inside keepout areas.
@@ -262,7 +345,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
+        startTime = GetRunningMicroSecs();
         testKeepoutAreas();
+        addPhaseTiming( wxT( "keepout_areas" ), startTime );
     }
 
     // find and gather vias, tracks, pads inside text boxes.
@@ -272,7 +357,9 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
+    startTime = GetRunningMicroSecs();
     testTexts();
+    addPhaseTiming( wxT( "texts" ), startTime );
 
     // update the m_drcDialog listboxes
     updatePointers();
@@ -298,7 +385,9 @@ void DRC::ListUnconnectedPads()
 void DRC::updatePointers()
 {
     // update my pointers, m_mainWindow is the only unchangeable one
-    m_pcb = m_mainWindow->GetBoard();
+    // (without a frame, the board given to the constructor is used)
+    if( m_mainWindow )
+        m_pcb = m_mainWindow->GetBoard();
 
     if( m_drcDialog )  // Use diag list boxes only in DRC dialog
     {
@@ -308,6 +397,40 @@ void DRC::updatePointers()
 }
 
 
+void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
+{
+    m_pcb->Add( aMarker );
+
+    if( m_mainWindow )
+        m_mainWindow->GetGalCanvas()->GetView()->Add( aMarker );
+}
+
+
+void DRC::addPhaseTiming( const wxString& aName, unsigned aStartTime )
+{
+    DRC_PHASE_TIMING timing;
+
+    timing.m_Name = aName;
+    timing.m_Time = GetRunningMicroSecs() - aStartTime;
+
+    m_timings.push_back( timing );
+}
+
+
+void DRC::fillAllZones()
+{
+    // Remove segment zones
+    m_pcb->m_Zone.DeleteAll();
+
+    std::vector<ZONE_CONTAINER*> zones;
+
+    for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
+        zones.push_back( m_pcb->GetArea( ii ) );
+
+    m_pcb->FillZones( zones, NULL, true );
+}
+
+
 bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
 {
     bool ret = true;
@@ -326,8 +449,7 @@ bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
                     );
 
         m_currentMarker = fillMarker( DRCE_NETCLASS_CLEARANCE, msg, m_currentMarker );
-        m_pcb->Add( m_currentMarker );
-        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+        addMarkerToPcb( m_currentMarker );
         m_currentMarker = 0;
         ret = false;
     }
@@ -342,8 +464,7 @@ bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
                     );
 
         m_currentMarker = fillMarker( DRCE_NETCLASS_TRACKWIDTH, msg, m_currentMarker );
-        m_pcb->Add( m_currentMarker );
-        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+        addMarkerToPcb( m_currentMarker );
         m_currentMarker = 0;
         ret = false;
     }
@@ -357,8 +478,7 @@ bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
                     );
 
         m_currentMarker = fillMarker( DRCE_NETCLASS_VIASIZE, msg, m_currentMarker );
-        m_pcb->Add( m_currentMarker );
-        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+        addMarkerToPcb( m_currentMarker );
         m_currentMarker = 0;
         ret = false;
     }
@@ -372,8 +492,7 @@ bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
                     );
 
         m_currentMarker = fillMarker( DRCE_NETCLASS_VIADRILLSIZE, msg, m_currentMarker );
-        m_pcb->Add( m_currentMarker );
-        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+        addMarkerToPcb( m_currentMarker );
         m_currentMarker = 0;
         ret = false;
     }
@@ -387,8 +506,7 @@ bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
                     );
 
         m_currentMarker = fillMarker( DRCE_NETCLASS_uVIASIZE, msg, m_currentMarker );
-        m_pcb->Add( m_currentMarker );
-        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+        addMarkerToPcb( m_currentMarker );
         m_currentMarker = 0;
         ret = false;
     }
@@ -402,8 +520,7 @@ bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
                     );
 
         m_currentMarker = fillMarker( DRCE_NETCLASS_uVIADRILLSIZE, msg, m_currentMarker );
-        m_pcb->Add( m_currentMarker );
-        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+        addMarkerToPcb( m_currentMarker );
         m_currentMarker = 0;
         ret = false;
     }
@@ -414,6 +531,8 @@ bool DRC::doNetClass( NETCLASSPTR nc, wxString& msg )
 
 bool DRC::testNetClasses()
 {
+    TRACE_SCOPE( "DRC::testNetClasses" );
+
     bool        ret = true;
 
     NETCLASSES& netclasses = m_pcb->GetDesignSettings().m_NetClasses;
@@ -437,46 +556,116 @@ bool DRC::testNetClasses()
 
 void DRC::testPad2Pad()
 {
+    TRACE_SCOPE( "DRC::testPad2Pad" );
+
+    // The sorted order only decides which pad of a pair is the reference pad of
+    // its marker, it is kept so the markers are the same as the X sweep ones
     std::vector<D_PAD*> sortedPads;
 
     m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
 
-    // find the max size of the pads (used to stop the test)
-    int max_size = 0;
+    // Build the spatial index of the pads.  The layers are handled by doPadToPadsDrc()
+    // (a hole is on all layers, and pads can be only on technical layers), so all the
+    // pads are stored in the same layer tree.
+    const LSET  indexLayer( F_Cu );
+    DRC_RTREE   padIndex;
+    int         padCount = sortedPads.size();
 
-    for( unsigned i = 0; i < sortedPads.size(); ++i )
+    for( int i = 0; i < padCount; ++i )
     {
-        D_PAD* pad = sortedPads[i];
+        padIndex.Insert( i, padDrcArea( sortedPads[i] ), indexLayer );
 
-        // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
-        int radius = pad->GetBoundingRadius();
-        if( radius > max_size )
-            max_size = radius;
+        // Build the cached pad polygon before the pads are shared between threads
+        sortedPads[i]->GetEffectivePolygon();
     }
 
-    // Test the pads
-    D_PAD** listEnd = &sortedPads[ sortedPads.size() ];
+    // The marker found for each pad, if any.  Each thread only writes the entries of
+    // the pads it tests, and the markers are added to the board afterwards in the
+    // pad order, so the result does not depend on the thread scheduling.
+    std::vector<MARKER_PCB*> markers( padCount, (MARKER_PCB*) NULL );
 
-    for( unsigned i = 0; i< sortedPads.size(); ++i )
+#ifdef USE_OPENMP
+    #pragma omp parallel
+#endif
     {
-        D_PAD* pad = sortedPads[i];
+        // The single tests store intermediate results in the DRC object,
+        // so each thread needs its own one
+        DRC worker( m_pcb );
+
+        // Used to test pads versus holes, see doPadToPadsDrc()
+        MODULE  dummymodule( m_pcb );    // Creates a dummy parent
+        D_PAD   dummypad( &dummymodule );
 
-        int    x_limit = max_size + pad->GetClearance() +
-                         pad->GetBoundingRadius() + pad->GetPosition().x;
+        std::vector<int>    candidates;
+        std::vector<D_PAD*> nearPads;
 
-        if( !doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+#ifdef USE_OPENMP
+        #pragma omp for schedule(dynamic, 64)
+#endif
+        for( int i = 0; i < padCount; ++i )
         {
-            wxASSERT( m_currentMarker );
-            m_pcb->Add( m_currentMarker );
-            m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
-            m_currentMarker = 0;
+            D_PAD* pad = sortedPads[i];
+
+            // Only the pads after pad in the sorted list are tested, so each
+            // pair of pads is tested once
+            padIndex.Query( padDrcArea( pad ), indexLayer, candidates, i );
+            nearPads.clear();
+
+            for( unsigned jj = 0; jj < candidates.size(); ++jj )
+                nearPads.push_back( sortedPads[ candidates[jj] ] );
+
+            if( !worker.doPadToPadsDrc( pad, nearPads, dummypad ) )
+            {
+                wxASSERT( worker.m_currentMarker );
+                markers[i] = worker.m_currentMarker;
+                worker.m_currentMarker = NULL;
+            }
         }
+    }   // end of parallel section
+
+    for( int i = 0; i < padCount; ++i )
+    {
+        if( markers[i] )
+            addMarkerToPcb( markers[i] );
     }
 }
 
 
+EDA_RECT DRC::padDrcArea( D_PAD* aPad )
+{
+    EDA_RECT area;
+
+    area.SetOrigin( aPad->ShapePos() );
+    area.Inflate( aPad->GetBoundingRadius() + aPad->GetClearance() + 1 );
+
+    if( aPad->GetDrillSize().x )
+    {
+        EDA_RECT hole;
+        hole.SetOrigin( aPad->GetPosition() );
+        hole.Inflate( std::max( aPad->GetDrillSize().x, aPad->GetDrillSize().y ) / 2 + 1 );
+        area.Merge( hole );
+    }
+
+    return area;
+}
+
+
+LSET DRC::padDrcLayers( D_PAD* aPad )
+{
+    LSET layers = aPad->GetLayerSet();
+
+    // a hole must be tested against the tracks of all copper layers
+    if( aPad->GetDrillSize().x )
+        layers |= LSET::AllCuMask();
+
+    return layers;
+}
+
+
 void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 {
+    TRACE_SCOPE( "DRC::testTracks" );
+
     wxProgressDialog * progressDialog = NULL;
     const int delta = 500;  // This is the number of tests between 2 calls to the
                             // progress bar
@@ -495,35 +684,115 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
+    // Build the spatial indexes of pads and tracks.  A segment is tested only against
+    // the items whose area (inflated by their clearance) overlaps its own area
+    // (inflated by its clearance), in the same order as doTrackDrc( segm, segm->Next() )
+    // would test them, so the markers are the same as a full sweep would create.
+    std::vector<D_PAD*> padList = m_pcb->GetPads();
+    std::vector<TRACK*> trackList;
+    DRC_RTREE           padIndex;
+    DRC_RTREE           trackIndex;
+
+    for( unsigned ii = 0; ii < padList.size(); ++ii )
+    {
+        padIndex.Insert( ii, padDrcArea( padList[ii] ), padDrcLayers( padList[ii] ) );
 
-    for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
+        // Build the cached pad polygon before the pads are shared between threads
+        padList[ii]->GetEffectivePolygon();
+    }
+
+    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
     {
-        if ( ii++ > delta )
+        trackIndex.Insert( trackList.size(), segm->GetBoundingBox(), segm->GetLayerSet() );
+        trackList.push_back( segm );
+    }
+
+    int  lastOrdinal = (int) trackList.size() - 1;   // the last segment has nothing to test
+
+    // Set by the main thread when the user aborts, read by all the threads
+    std::atomic<bool> aborted( false );
+
+    // The marker found for each segment, if any, see testPad2Pad()
+    std::vector<MARKER_PCB*> markers( trackList.size(), (MARKER_PCB*) NULL );
+
+#ifdef USE_OPENMP
+    #pragma omp parallel shared( aborted )
+#endif
+    {
+        // The single tests store intermediate results in the DRC object,
+        // so each thread needs its own one
+        DRC     worker( m_pcb );
+
+        // Used to test tracks versus holes, see doTrackDrc()
+        MODULE  dummymodule( m_pcb );    // Creates a dummy parent
+        D_PAD   dummypad( &dummymodule );
+
+        dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
+
+        std::vector<int>    candidates;
+        std::vector<D_PAD*> nearPads;
+        std::vector<TRACK*> nearTracks;
+
+        int ii = 0;
+
+#ifdef USE_OPENMP
+        #pragma omp for schedule(dynamic, 64)
+#endif
+        for( int ordinal = 0; ordinal < lastOrdinal; ++ordinal )
         {
-            ii = 0;
-            count++;
+            // A loop shared between threads cannot be left, so skip the remaining items
+            if( aborted )
+                continue;
+
+            // The progress bar is a GUI item, only the main thread can update it
+            bool mainThread = true;
+#ifdef USE_OPENMP
+            mainThread = omp_get_thread_num() == 0;
+#endif
 
-            if( progressDialog )
+            if( progressDialog && mainThread && ii++ > delta )
             {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
+                ii = 0;
+                count = ordinal / delta;
+
+                if( !progressDialog->Update( std::min( count, deltamax ), wxEmptyString ) )
+                    aborted = true;     // Aborted by user
 #ifdef __WXMAC__
                 // Work around a dialog z-order issue on OS X
                 if( count == deltamax )
                     aActiveWindow->Raise();
 #endif
             }
-        }
 
-        if( !doTrackDrc( segm, segm->Next(), true ) )
-        {
-            wxASSERT( m_currentMarker );
-            m_pcb->Add( m_currentMarker );
-            m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
-            m_currentMarker = 0;
+            TRACK*          segm = trackList[ordinal];
+            const EDA_RECT  area = segm->GetBoundingBox();
+
+            padIndex.Query( area, segm->GetLayerSet(), candidates );
+            nearPads.clear();
+
+            for( unsigned jj = 0; jj < candidates.size(); ++jj )
+                nearPads.push_back( padList[ candidates[jj] ] );
+
+            // Only the tracks after segm in m_Track are tested, like in the full sweep
+            trackIndex.Query( area, segm->GetLayerSet(), candidates, ordinal );
+            nearTracks.clear();
+
+            for( unsigned jj = 0; jj < candidates.size(); ++jj )
+                nearTracks.push_back( trackList[ candidates[jj] ] );
+
+            if( !worker.doTrackDrc( segm, nearPads, nearTracks, dummypad ) )
+            {
+                wxASSERT( worker.m_currentMarker );
+                markers[ordinal] = worker.m_currentMarker;
+                worker.m_currentMarker = NULL;
+            }
         }
+    }   // end of parallel section
+
+    for( unsigned ordinal = 0; ordinal < markers.size(); ++ordinal )
+    {
+        if( markers[ordinal] )
+            addMarkerToPcb( markers[ordinal] );
     }
 
     if( progressDialog )
@@ -533,6 +802,43 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 
 void DRC::testUnconnected()
 {
+    TRACE_SCOPE( "DRC::testUnconnected" );
+
+    if( !m_mainWindow )
+    {
+        // The legacy ratsnest can only be built by a frame, so use the board
+        // connectivity data.  It gives only the positions of the unconnected items.
+        RN_DATA* ratsnest = m_pcb->GetRatsnest();
+
+        ratsnest->ProcessBoard();
+        ratsnest->Recalculate();
+
+        for( int netCode = 1; netCode < ratsnest->GetNetCount(); ++netCode )
+        {
+            const std::vector<RN_EDGE_MST_PTR>* edges = ratsnest->GetNet( netCode ).GetUnconnected();
+            NETINFO_ITEM* net = m_pcb->FindNet( netCode );
+
+            if( !edges || !net )
+                continue;
+
+            wxString msg = wxT( "net " ) + net->GetNetname();
+
+            for( unsigned ii = 0; ii < edges->size(); ++ii )
+            {
+                const RN_NODE_PTR& start = (*edges)[ii]->GetSourceNode();
+                const RN_NODE_PTR& end   = (*edges)[ii]->GetTargetNode();
+
+                DRC_ITEM* uncItem = new DRC_ITEM( DRCE_UNCONNECTED_PADS, msg, msg,
+                                                  wxPoint( start->GetX(), start->GetY() ),
+                                                  wxPoint( end->GetX(), end->GetY() ) );
+
+                m_unconnected.push_back( uncItem );
+            }
+        }
+
+        return;
+    }
+
     if( (m_pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
     {
         wxClientDC dc( m_mainWindow->GetCanvas() );
@@ -568,6 +874,8 @@ void DRC::testUnconnected()
 
 void DRC::testZones()
 {
+    TRACE_SCOPE( "DRC::testZones" );
+
     // Test copper areas for valid netcodes
     // if a netcode is < 0 the netname was not found when reading a netlist
     // if a netcode is == 0 the netname is void, and the zone is not connected.
@@ -595,8 +903,7 @@ void DRC::testZones()
         {
             m_currentMarker = fillMarker( test_area,
                                           DRCE_SUSPICIOUS_NET_FOR_ZONE_OUTLINE, m_currentMarker );
-            m_pcb->Add( m_currentMarker );
-            m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+            addMarkerToPcb( m_currentMarker );
             m_currentMarker = NULL;
         }
     }
@@ -608,6 +915,8 @@ void DRC::testZones()
 
 void DRC::testKeepoutAreas()
 {
+    TRACE_SCOPE( "DRC::testKeepoutAreas" );
+
     // Test keepout areas for vias, tracks and pads inside keepout areas
     for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
     {
@@ -631,8 +940,7 @@ void DRC::testKeepoutAreas()
                 {
                     m_currentMarker = fillMarker( segm, NULL,
                                                   DRCE_TRACK_INSIDE_KEEPOUT, m_currentMarker );
-                    m_pcb->Add( m_currentMarker );
-                    m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+                    addMarkerToPcb( m_currentMarker );
                     m_currentMarker = 0;
                 }
             }
@@ -648,8 +956,7 @@ void DRC::testKeepoutAreas()
                 {
                     m_currentMarker = fillMarker( segm, NULL,
                                                   DRCE_VIA_INSIDE_KEEPOUT, m_currentMarker );
-                    m_pcb->Add( m_currentMarker );
-                    m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+                    addMarkerToPcb( m_currentMarker );
                     m_currentMarker = 0;
                 }
             }
@@ -661,6 +968,8 @@ void DRC::testKeepoutAreas()
 
 void DRC::testTexts()
 {
+    TRACE_SCOPE( "DRC::testTexts" );
+
     std::vector<wxPoint> textShape;      // a buffer to store the text shape (set of segments)
     std::vector<D_PAD*> padList = m_pcb->GetPads();
 
@@ -709,8 +1018,7 @@ void DRC::testTexts()
                         m_currentMarker = fillMarker( track, text,
                                                       DRCE_TRACK_INSIDE_TEXT,
                                                       m_currentMarker );
-                        m_pcb->Add( m_currentMarker );
-                        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+                        addMarkerToPcb( m_currentMarker );
                         m_currentMarker = NULL;
                         break;
                     }
@@ -728,8 +1036,7 @@ void DRC::testTexts()
                     {
                         m_currentMarker = fillMarker( track, text,
                                                       DRCE_VIA_INSIDE_TEXT, m_currentMarker );
-                        m_pcb->Add( m_currentMarker );
-                        m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+                        addMarkerToPcb( m_currentMarker );
                         m_currentMarker = NULL;
                         break;
                     }
@@ -778,8 +1085,7 @@ void DRC::testTexts()
                 {
                     m_currentMarker = fillMarker( pad, text,
                                                   DRCE_PAD_INSIDE_TEXT, m_currentMarker );
-                    m_pcb->Add( m_currentMarker );
-                    m_mainWindow->GetGalCanvas()->GetView()->Add( m_currentMarker );
+                    addMarkerToPcb( m_currentMarker );
                     m_currentMarker = NULL;
                     break;
                 }
@@ -836,7 +1142,8 @@ bool DRC::doTrackKeepoutDrc( TRACK* aRefSeg )
 }
 
 
-bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit )
+bool DRC::doPadToPadsDrc( D_PAD* aRefPad, const std::vector<D_PAD*>& aPads,
+                          D_PAD& aHolePad )
 {
     const static LSET all_cu = LSET::AllCuMask();
 
@@ -845,11 +1152,8 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
     /* used to test DRC pad to holes: this dummy pad has the size and shape of the hole
      * to test pad to pad hole DRC, using the pad to pad DRC test function.
      * Therefore, this dummy pad is a circle or an oval.
-     * A pad must have a parent because some functions expect a non null parent
-     * to find the parent board, and some other data
      */
-    MODULE  dummymodule( m_pcb );    // Creates a dummy parent
-    D_PAD   dummypad( &dummymodule );
+    D_PAD&  dummypad = aHolePad;
 
     // Ensure the hole is on all copper layers
     dummypad.SetLayerSet( all_cu | dummypad.GetLayerSet() );
@@ -859,18 +1163,13 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
     // (a value = 0 means use netclass value)
     dummypad.SetLocalClearance( 1 );
 
-    for( D_PAD** pad_list = aStart;  pad_list<aEnd;  ++pad_list )
+    for( unsigned ii = 0; ii < aPads.size(); ++ii )
     {
-        D_PAD* pad = *pad_list;
+        D_PAD* pad = aPads[ii];
 
         if( pad == aRefPad )
             continue;
 
-        // We can stop the test when pad->GetPosition().x > x_limit
-        // because the list is sorted by X values
-        if( pad->GetPosition().x > x_limit )
-            break;
-
         // No problem if pads which are on copper layers are on different copper layers,
         // (pads can be only on a technical layer, to build complex pads)
         // but their hole (if any ) can create DRC error because they are on all
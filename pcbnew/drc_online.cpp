@@ -0,0 +1,304 @@
+/**
+ * @file drc_online.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+#include <wxPcbStruct.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+#include <class_marker_pcb.h>
+#include <class_draw_panel_gal.h>
+#include <view/view.h>
+
+#include <drc_stuff.h>
+#include <drc_online.h>
+
+
+DRC_ONLINE::DRC_ONLINE( DRC* aDrc, BOARD* aBoard ) :
+    m_drc( aDrc ),
+    m_board( aBoard )
+{
+    build();
+
+    m_board->AddListener( this );
+}
+
+
+DRC_ONLINE::~DRC_ONLINE()
+{
+    m_board->RemoveListener( this );
+
+    while( !m_markers.empty() )
+        removeMarker( m_markers.begin()->first );
+}
+
+
+void DRC_ONLINE::OnBoardItemAdded( const BOARD_ITEM* aItem )
+{
+    forEachConnectedItem( aItem, &DRC_ONLINE::markDirty );
+}
+
+
+void DRC_ONLINE::OnBoardItemRemoved( const BOARD_ITEM* aItem )
+{
+    // A marker of this session deleted by someone else, e.g. by a full DRC run
+    if( aItem->Type() == PCB_MARKER_T )
+    {
+        std::map<const BOARD_ITEM*, const TRACK*>::iterator it = m_markerTracks.find( aItem );
+
+        if( it != m_markerTracks.end() )
+        {
+            m_markers.erase( it->second );
+            m_markerTracks.erase( it );
+        }
+
+        return;
+    }
+
+    forEachConnectedItem( aItem, &DRC_ONLINE::unindexItem );
+}
+
+
+void DRC_ONLINE::OnBoardItemChanged( const BOARD_ITEM* aItem )
+{
+    forEachConnectedItem( aItem, &DRC_ONLINE::markDirty );
+}
+
+
+void DRC_ONLINE::forEachConnectedItem( const BOARD_ITEM* aItem,
+                                       void (DRC_ONLINE::*aFunc)( const BOARD_ITEM* ) )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+        for( const D_PAD* pad = static_cast<const MODULE*>( aItem )->Pads().GetFirst();
+             pad; pad = pad->Next() )
+            (this->*aFunc)( pad );
+        break;
+
+    case PCB_PAD_T:
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        (this->*aFunc)( aItem );
+        break;
+
+    default:    // Other items are not tested by the online DRC
+        break;
+    }
+}
+
+
+void DRC_ONLINE::markDirty( const BOARD_ITEM* aItem )
+{
+    // Its indexed area, the old one, is made dirty when it is indexed again by Update()
+    m_dirtyItems.insert( aItem );
+}
+
+
+void DRC_ONLINE::build()
+{
+    m_trackIndex.RemoveAll();
+    m_padIndex.RemoveAll();
+    m_entries.clear();
+    m_ordinals.clear();
+
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads().GetFirst(); pad; pad = pad->Next() )
+            indexItem( pad );
+    }
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+        indexItem( track );
+}
+
+
+void DRC_ONLINE::indexItem( BOARD_CONNECTED_ITEM* aItem )
+{
+    ENTRY entry;
+
+    entry.m_item = aItem;
+
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+        entry.m_area   = DRC::padDrcArea( pad );
+        entry.m_layers = DRC::padDrcLayers( pad );
+    }
+    else
+    {
+        entry.m_area   = aItem->GetBoundingBox();
+        entry.m_layers = aItem->GetLayerSet();
+    }
+
+    int ordinal = m_entries.size();
+
+    m_entries.push_back( entry );
+    m_ordinals[aItem] = ordinal;
+
+    if( aItem->Type() == PCB_PAD_T )
+        m_padIndex.Insert( ordinal, entry.m_area, entry.m_layers );
+    else
+        m_trackIndex.Insert( ordinal, entry.m_area, entry.m_layers );
+}
+
+
+void DRC_ONLINE::unindexItem( const BOARD_ITEM* aItem )
+{
+    // A removed item must not be tested, and can be deleted before the next Update()
+    m_dirtyItems.erase( aItem );
+
+    std::map<const BOARD_ITEM*, int>::iterator it = m_ordinals.find( aItem );
+
+    if( it == m_ordinals.end() )
+        return;
+
+    ENTRY& entry = m_entries[it->second];
+
+    if( aItem->Type() == PCB_PAD_T )
+    {
+        m_padIndex.Remove( it->second, entry.m_area, entry.m_layers );
+    }
+    else
+    {
+        m_trackIndex.Remove( it->second, entry.m_area, entry.m_layers );
+        removeMarker( static_cast<const TRACK*>( aItem ) );
+    }
+
+    // The tracks which were close to the item have to be tested again
+    m_dirtyAreas.push_back( entry.m_area );
+
+    entry.m_item = NULL;
+    m_ordinals.erase( it );
+}
+
+
+void DRC_ONLINE::removeMarker( const TRACK* aTrack )
+{
+    std::map<const TRACK*, MARKER_PCB*>::iterator it = m_markers.find( aTrack );
+
+    if( it == m_markers.end() )
+        return;
+
+    MARKER_PCB* marker = it->second;
+
+    // The markers deleted by someone else have been forgotten by OnBoardItemRemoved()
+    m_markers.erase( it );
+    m_markerTracks.erase( marker );
+
+    m_drc->m_mainWindow->GetGalCanvas()->GetView()->Remove( marker );
+    m_board->Delete( marker );
+}
+
+
+void DRC_ONLINE::Update()
+{
+    if( !IsDirty() )
+        return;
+
+    // Once most of the entries are dead, it is cheaper to build the indexes again
+    if( m_entries.size() > 1024 && m_entries.size() > 4 * m_ordinals.size() )
+        build();
+
+    // Index again the items changed since the last call: both their old and their new
+    // areas are dirty.  They are still in the board, the removed ones are not in the set.
+    std::set<const BOARD_ITEM*> dirtyItems;
+    dirtyItems.swap( m_dirtyItems );
+
+    for( std::set<const BOARD_ITEM*>::iterator it = dirtyItems.begin();
+         it != dirtyItems.end(); ++it )
+    {
+        BOARD_CONNECTED_ITEM* item =
+                static_cast<BOARD_CONNECTED_ITEM*>( const_cast<BOARD_ITEM*>( *it ) );
+
+        unindexItem( item );
+        indexItem( item );
+
+        m_dirtyAreas.push_back( m_entries.back().m_area );
+    }
+
+    // Find the tracks close to the dirty areas
+    std::set<int>       toTest;
+    std::vector<int>    candidates;
+
+    for( unsigned ii = 0; ii < m_dirtyAreas.size(); ++ii )
+    {
+        m_trackIndex.Query( m_dirtyAreas[ii], LSET::AllCuMask(), candidates );
+        toTest.insert( candidates.begin(), candidates.end() );
+    }
+
+    m_dirtyAreas.clear();
+
+    // Test them against their neighbours.  Like in DRC::testTracks(), a track is only
+    // tested against the tracks after it (here, indexed after it), so a pair of tracks
+    // too close to each other creates only one marker.
+    MODULE  dummymodule( m_board );    // Creates a dummy parent
+    D_PAD   dummypad( &dummymodule );
+
+    dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
+
+    std::vector<D_PAD*> nearPads;
+    std::vector<TRACK*> nearTracks;
+
+    m_drc->m_pcb = m_board;
+
+    for( std::set<int>::iterator it = toTest.begin(); it != toTest.end(); ++it )
+    {
+        const ENTRY& entry = m_entries[*it];
+        TRACK*       track = static_cast<TRACK*>( entry.m_item );
+
+        removeMarker( track );
+
+        m_padIndex.Query( entry.m_area, entry.m_layers, candidates );
+        nearPads.clear();
+
+        for( unsigned jj = 0; jj < candidates.size(); ++jj )
+            nearPads.push_back( static_cast<D_PAD*>( m_entries[ candidates[jj] ].m_item ) );
+
+        m_trackIndex.Query( entry.m_area, entry.m_layers, candidates, *it );
+        nearTracks.clear();
+
+        for( unsigned jj = 0; jj < candidates.size(); ++jj )
+            nearTracks.push_back( static_cast<TRACK*>( m_entries[ candidates[jj] ].m_item ) );
+
+        if( !m_drc->doTrackDrc( track, nearPads, nearTracks, dummypad ) )
+        {
+            MARKER_PCB* marker = m_drc->m_currentMarker;
+
+            wxASSERT( marker );
+            m_drc->m_currentMarker = NULL;
+
+            m_board->Add( marker );
+            m_drc->m_mainWindow->GetGalCanvas()->GetView()->Add( marker );
+            m_markers[track] = marker;
+            m_markerTracks[marker] = track;
+        }
+    }
+}
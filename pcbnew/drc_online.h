@@ -0,0 +1,142 @@
+/**
+ * @file drc_online.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _DRC_ONLINE_H
+#define _DRC_ONLINE_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <class_board.h>
+#include <drc_rtree.h>
+
+class DRC;
+class BOARD_CONNECTED_ITEM;
+
+
+/**
+ * Class DRC_ONLINE
+ * keeps the track clearance markers of a board up to date while it is edited.
+ * It indexes the tracks and pads of the board once, and keeps the indexes up to date
+ * from the board item changes: Update() indexes again only the items changed since
+ * the previous call, and tests again the tracks close to their old and new areas.
+ * Only the items modified while the session is active are tested: a full DRC
+ * run is still needed to check the rest of the board.
+ */
+class DRC_ONLINE : public BOARD_LISTENER
+{
+public:
+    /**
+     * Constructor
+     * indexes the tracks and pads of aBoard and starts listening to its changes.
+     * @param aDrc is the DRC object used to run the tests, and to find the view
+     *             the markers have to be added to.
+     * @param aBoard is the board to check.
+     */
+    DRC_ONLINE( DRC* aDrc, BOARD* aBoard );
+
+    /**
+     * Destructor
+     * stops listening to the board, and removes the markers created by this session.
+     */
+    ~DRC_ONLINE();
+
+    void OnBoardItemAdded( const BOARD_ITEM* aItem );
+    void OnBoardItemRemoved( const BOARD_ITEM* aItem );
+    void OnBoardItemChanged( const BOARD_ITEM* aItem );
+
+    /**
+     * Function Update
+     * tests the tracks close to the items changed since the last call, and
+     * replaces their markers.
+     */
+    void Update();
+
+    /**
+     * Function IsDirty
+     * @return true if some items have changed since the last Update().
+     */
+    bool IsDirty() const
+    {
+        return !m_dirtyItems.empty() || !m_dirtyAreas.empty();
+    }
+
+    BOARD* GetBoard() const { return m_board; }
+
+private:
+    /// An indexed item, and the area and layers used to index it
+    struct ENTRY
+    {
+        BOARD_CONNECTED_ITEM*   m_item;     ///< NULL once the item is removed
+        EDA_RECT                m_area;
+        LSET                    m_layers;
+    };
+
+    /// Indexes all the tracks and pads of the board
+    void build();
+
+    /// Adds aItem (a track, a via, or a pad) to the indexes
+    void indexItem( BOARD_CONNECTED_ITEM* aItem );
+
+    /// Removes aItem from the indexes, and stores its indexed area as dirty
+    void unindexItem( const BOARD_ITEM* aItem );
+
+    /// Removes the marker created for aTrack, if any
+    void removeMarker( const TRACK* aTrack );
+
+    /// Calls aFunc for aItem, or for its pads if it is a footprint
+    void forEachConnectedItem( const BOARD_ITEM* aItem,
+                               void (DRC_ONLINE::*aFunc)( const BOARD_ITEM* ) );
+
+    /// Stores aItem to be tested again, and its indexed area as dirty
+    void markDirty( const BOARD_ITEM* aItem );
+
+    DRC*                    m_drc;
+    BOARD*                  m_board;
+
+    DRC_RTREE               m_trackIndex;
+    DRC_RTREE               m_padIndex;
+
+    /// Indexed items by ordinal, the ordinal of a track also gives the pair test order
+    std::vector<ENTRY>      m_entries;
+    std::map<const BOARD_ITEM*, int> m_ordinals;
+
+    /// Items added or modified since the last Update(), tested from their new area
+    std::set<const BOARD_ITEM*> m_dirtyItems;
+
+    /// Areas of the items removed or modified since the last Update()
+    std::vector<EDA_RECT>   m_dirtyAreas;
+
+    /// Markers created by this session, by reference track
+    std::map<const TRACK*, MARKER_PCB*> m_markers;
+
+    /// Reference tracks of the markers of m_markers, by marker
+    std::map<const BOARD_ITEM*, const TRACK*> m_markerTracks;
+};
+
+#endif  // _DRC_ONLINE_H
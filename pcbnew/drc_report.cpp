@@ -0,0 +1,235 @@
+/**
+ * @file drc_report.cpp
+ * @brief DRC report files written by DRC::WriteReport(), e.g. for batch runs.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <fctsys.h>
+#include <common.h>
+#include <macros.h>
+#include <richio.h>
+#include <convert_to_biu.h>
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+#include <drc_stuff.h>
+
+
+/**
+ * Function jsonString
+ * @return aText as a quoted JSON string.
+ */
+static std::string jsonString( const wxString& aText )
+{
+    std::string text = TO_UTF8( aText );
+    std::string ret = "\"";
+
+    for( unsigned ii = 0; ii < text.size(); ii++ )
+    {
+        unsigned char c = text[ii];
+
+        if( c == '"' || c == '\\' )
+        {
+            ret += '\\';
+            ret += c;
+        }
+        else if( c == '\n' )
+            ret += "\\n";
+        else if( c < 0x20 )
+            ret += StrPrintf( "\\u%04x", c );
+        else
+            ret += c;
+    }
+
+    ret += '"';
+    return ret;
+}
+
+
+/**
+ * Function csvString
+ * @return aText as a quoted CSV field.
+ */
+static std::string csvString( const wxString& aText )
+{
+    std::string text = TO_UTF8( aText );
+    std::string ret = "\"";
+
+    for( unsigned ii = 0; ii < text.size(); ii++ )
+    {
+        if( text[ii] == '"' )
+            ret += '"';
+
+        ret += text[ii];
+    }
+
+    ret += '"';
+    return ret;
+}
+
+
+/// Writes the main or the auxiliary item of a DRC_ITEM as a JSON object
+static void writeJsonItem( FILE* aFile, const wxString& aText, const wxPoint& aPos )
+{
+    fprintf( aFile, "{ \"description\": %s, \"x_mm\": %.6f, \"y_mm\": %.6f }",
+             jsonString( aText ).c_str(), aPos.x / IU_PER_MM, aPos.y / IU_PER_MM );
+}
+
+
+/// Writes a DRC_ITEM as a JSON object
+static void writeJsonDrcItem( FILE* aFile, const DRC_ITEM& aItem, bool aLast )
+{
+    fprintf( aFile, "    { \"code\": %d, \"description\": %s,\n      \"items\": [ ",
+             aItem.GetErrorCode(), jsonString( aItem.GetErrorText() ).c_str() );
+
+    writeJsonItem( aFile, aItem.GetTextA(), aItem.GetPointA() );
+
+    if( aItem.HasSecondItem() )
+    {
+        fprintf( aFile, ",\n                 " );
+        writeJsonItem( aFile, aItem.GetTextB(), aItem.GetPointB() );
+    }
+
+    fprintf( aFile, " ] }%s\n", aLast ? "" : "," );
+}
+
+
+/// Writes a DRC_ITEM as a CSV record
+static void writeCsvDrcItem( FILE* aFile, const char* aType, const DRC_ITEM& aItem )
+{
+    fprintf( aFile, "%s,%d,%s,,%s,%.6f,%.6f", aType, aItem.GetErrorCode(),
+             csvString( aItem.GetErrorText() ).c_str(),
+             csvString( aItem.GetTextA() ).c_str(),
+             aItem.GetPointA().x / IU_PER_MM, aItem.GetPointA().y / IU_PER_MM );
+
+    if( aItem.HasSecondItem() )
+        fprintf( aFile, ",%s,%.6f,%.6f\n", csvString( aItem.GetTextB() ).c_str(),
+                 aItem.GetPointB().x / IU_PER_MM, aItem.GetPointB().y / IU_PER_MM );
+    else
+        fprintf( aFile, ",,,\n" );
+}
+
+
+bool DRC::WriteReport( const wxString& aFullFileName ) const
+{
+    FILE* fp = wxFopen( aFullFileName, wxT( "w" ) );
+
+    if( fp == NULL )
+        return false;
+
+    LOCALE_IO   toggle;     // Use '.' as decimal separator in coordinates
+    wxString    ext = wxFileName( aFullFileName ).GetExt().Lower();
+    bool        success;
+
+    if( ext == wxT( "json" ) )
+        success = writeJsonReport( fp );
+    else if( ext == wxT( "csv" ) )
+        success = writeCsvReport( fp );
+    else
+        success = writeTextReport( fp );
+
+    if( fclose( fp ) != 0 )
+        success = false;
+
+    return success;
+}
+
+
+bool DRC::writeTextReport( FILE* aFile ) const
+{
+    fprintf( aFile, "** Drc report for %s **\n", TO_UTF8( m_pcb->GetFileName() ) );
+
+    wxDateTime now = wxDateTime::Now();
+
+    fprintf( aFile, "** Created on %s **\n", TO_UTF8( now.Format( wxT( "%F %T" ) ) ) );
+
+    fprintf( aFile, "\n** Found %d DRC errors **\n", m_pcb->GetMARKERCount() );
+
+    for( int ii = 0; ii < m_pcb->GetMARKERCount(); ii++ )
+        fprintf( aFile, "%s", TO_UTF8( m_pcb->GetMARKER( ii )->GetReporter().ShowReport() ) );
+
+    fprintf( aFile, "\n** Found %d unconnected pads **\n", (int) m_unconnected.size() );
+
+    for( unsigned ii = 0; ii < m_unconnected.size(); ii++ )
+        fprintf( aFile, "%s", TO_UTF8( m_unconnected[ii]->ShowReport() ) );
+
+    fprintf( aFile, "\n** Phase timings **\n" );
+
+    for( unsigned ii = 0; ii < m_timings.size(); ii++ )
+        fprintf( aFile, "%s: %.3f ms\n", TO_UTF8( m_timings[ii].m_Name ),
+                 m_timings[ii].m_Time / 1000.0 );
+
+    return fprintf( aFile, "\n** End of Report **\n" ) > 0;
+}
+
+
+bool DRC::writeJsonReport( FILE* aFile ) const
+{
+    wxDateTime now = wxDateTime::Now();
+
+    fprintf( aFile, "{\n  \"source\": %s,\n  \"date\": %s,\n",
+             jsonString( m_pcb->GetFileName() ).c_str(),
+             jsonString( now.Format( wxT( "%F %T" ) ) ).c_str() );
+
+    fprintf( aFile, "  \"timings\": [\n" );
+
+    for( unsigned ii = 0; ii < m_timings.size(); ii++ )
+        fprintf( aFile, "    { \"phase\": %s, \"time_us\": %u }%s\n",
+                 jsonString( m_timings[ii].m_Name ).c_str(), m_timings[ii].m_Time,
+                 ii + 1 < m_timings.size() ? "," : "" );
+
+    fprintf( aFile, "  ],\n  \"markers\": [\n" );
+
+    int markerCount = m_pcb->GetMARKERCount();
+
+    for( int ii = 0; ii < markerCount; ii++ )
+        writeJsonDrcItem( aFile, m_pcb->GetMARKER( ii )->GetReporter(), ii + 1 == markerCount );
+
+    fprintf( aFile, "  ],\n  \"unconnected\": [\n" );
+
+    for( unsigned ii = 0; ii < m_unconnected.size(); ii++ )
+        writeJsonDrcItem( aFile, *m_unconnected[ii], ii + 1 == m_unconnected.size() );
+
+    return fprintf( aFile, "  ]\n}\n" ) > 0;
+}
+
+
+bool DRC::writeCsvReport( FILE* aFile ) const
+{
+    fprintf( aFile, "type,code,description,time_us,item_a,x_a_mm,y_a_mm,item_b,x_b_mm,y_b_mm\n" );
+
+    for( unsigned ii = 0; ii < m_timings.size(); ii++ )
+        fprintf( aFile, "timing,,%s,%u,,,,,,\n",
+                 csvString( m_timings[ii].m_Name ).c_str(), m_timings[ii].m_Time );
+
+    for( int ii = 0; ii < m_pcb->GetMARKERCount(); ii++ )
+        writeCsvDrcItem( aFile, "marker", m_pcb->GetMARKER( ii )->GetReporter() );
+
+    for( unsigned ii = 0; ii < m_unconnected.size(); ii++ )
+        writeCsvDrcItem( aFile, "unconnected", *m_unconnected[ii] );
+
+    return !ferror( aFile );
+}
@@ -0,0 +1,153 @@
+/**
+ * @file drc_rtree.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _DRC_RTREE_H
+#define _DRC_RTREE_H
+
+#include <vector>
+#include <algorithm>
+
+#include <class_eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+#include <geometry/rtree.h>
+
+
+/**
+ * Class DRC_RTREE
+ * is a set of R-trees, one per copper layer, used by the DRC to find the items
+ * which are close enough to a reference item to need a real clearance test
+ * (and by BOARD_ITEM_INDEX to find the items close to a zone).
+ * Items are not stored directly: each entry is the ordinal of the item in a list
+ * owned by the caller.  Queries return ordinals sorted in ascending order,
+ * so the caller can test the candidates in exactly the same order as a linear
+ * sweep of its list would, and therefore create exactly the same markers.
+ * Non-owning.
+ */
+class DRC_RTREE
+{
+public:
+    typedef RTree<int, int, 2, float> LAYER_TREE;
+
+    DRC_RTREE() {}
+
+    /**
+     * Function Insert
+     * adds an item to the trees of all the copper layers of aLayers.
+     * @param aOrdinal is the index of the item in the caller's list (must be >= 0).
+     * @param aBox is the item area, already inflated by the item clearance.
+     * @param aLayers is the set of layers the item must be found on.
+     */
+    void Insert( int aOrdinal, const EDA_RECT& aBox, LSET aLayers )
+    {
+        const int mmin[2] = { aBox.GetX(), aBox.GetY() };
+        const int mmax[2] = { aBox.GetRight(), aBox.GetBottom() };
+
+        for( LSEQ cu = aLayers.CuStack(); cu; ++cu )
+            m_tree[*cu].Insert( mmin, mmax, aOrdinal );
+    }
+
+    /**
+     * Function Remove
+     * removes an item added by Insert().
+     * @param aOrdinal, aBox and aLayers must be the values given to Insert().
+     */
+    void Remove( int aOrdinal, const EDA_RECT& aBox, LSET aLayers )
+    {
+        const int mmin[2] = { aBox.GetX(), aBox.GetY() };
+        const int mmax[2] = { aBox.GetRight(), aBox.GetBottom() };
+
+        for( LSEQ cu = aLayers.CuStack(); cu; ++cu )
+            m_tree[*cu].Remove( mmin, mmax, aOrdinal );
+    }
+
+    /**
+     * Function Query
+     * collects the ordinals of the items found on at least one of aLayers, whose
+     * area overlaps aBox, and whose ordinal is greater than aMinOrdinal.
+     * @param aBox is the search area, already inflated by the reference item clearance.
+     * @param aLayers is the set of layers to search.
+     * @param aOrdinals is filled with the ordinals found, sorted and without duplicates.
+     * @param aMinOrdinal allows skipping the items already tested by the caller (use -1
+     *                    to get all of them).
+     */
+    void Query( const EDA_RECT& aBox, LSET aLayers, std::vector<int>& aOrdinals,
+                int aMinOrdinal = -1 )
+    {
+        const int mmin[2] = { aBox.GetX(), aBox.GetY() };
+        const int mmax[2] = { aBox.GetRight(), aBox.GetBottom() };
+
+        COLLECTOR collector( aOrdinals, aMinOrdinal );
+
+        aOrdinals.clear();
+
+        for( LSEQ cu = aLayers.CuStack(); cu; ++cu )
+            m_tree[*cu].Search( mmin, mmax, collector );
+
+        std::sort( aOrdinals.begin(), aOrdinals.end() );
+        aOrdinals.erase( std::unique( aOrdinals.begin(), aOrdinals.end() ), aOrdinals.end() );
+    }
+
+    /**
+     * Function RemoveAll
+     * empties all the layer trees.
+     */
+    void RemoveAll()
+    {
+        for( int layer = 0; layer < MAX_CU_LAYERS; ++layer )
+            m_tree[layer].RemoveAll();
+    }
+
+private:
+    // RTree owns its nodes through raw pointers, so the trees cannot be copied
+    DRC_RTREE( const DRC_RTREE& );
+    DRC_RTREE& operator=( const DRC_RTREE& );
+
+    /// Search visitor: stores the ordinals above a threshold
+    struct COLLECTOR
+    {
+        COLLECTOR( std::vector<int>& aOrdinals, int aMinOrdinal ) :
+            m_ordinals( aOrdinals ),
+            m_minOrdinal( aMinOrdinal )
+        {
+        }
+
+        bool operator()( int aOrdinal )
+        {
+            if( aOrdinal > m_minOrdinal )
+                m_ordinals.push_back( aOrdinal );
+
+            return true;
+        }
+
+        std::vector<int>&   m_ordinals;
+        int                 m_minOrdinal;
+    };
+
+    LAYER_TREE  m_tree[MAX_CU_LAYERS];
+};
+
+#endif  // _DRC_RTREE_H
@@ -0,0 +1,199 @@
+/**
+ * @file drc_segment_batch.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc_segment_batch.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define USE_SSE2_SEGMENT_BATCH
+#endif
+
+
+/* Squared distance between the point (px, py) and the segment starting at (ax, ay)
+ * with the direction (dx, dy), like SEG::SquaredDistance().
+ * Written with selects only, to keep the batch loop free of unpredictable branches.
+ */
+static inline double pointToSegment2( double px, double py,
+                                      double ax, double ay, double dx, double dy )
+{
+    // The coordinates are integers, so len2 is 0 or >= 1, and dot is 0 when len2 is 0
+    double len2 = dx * dx + dy * dy;
+    double dot  = ( px - ax ) * dx + ( py - ay ) * dy;
+    double t    = dot / ( len2 < 1.0 ? 1.0 : len2 );
+
+    t = t < 0.0 ? 0.0 : t;
+    t = t > 1.0 ? 1.0 : t;
+
+    double ex = ax + t * dx - px;
+    double ey = ay + t * dy - py;
+
+    return ex * ex + ey * ey;
+}
+
+
+#ifdef USE_SSE2_SEGMENT_BATCH
+/* The same as pointToSegment2(), for two points and segments at once.  The operations
+ * are the same, in the same order, so the results are the same to the last bit.
+ */
+static inline __m128d pointToSegment2( __m128d px, __m128d py,
+                                       __m128d ax, __m128d ay, __m128d dx, __m128d dy )
+{
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one  = _mm_set1_pd( 1.0 );
+
+    __m128d len2 = _mm_add_pd( _mm_mul_pd( dx, dx ), _mm_mul_pd( dy, dy ) );
+    __m128d dot  = _mm_add_pd( _mm_mul_pd( _mm_sub_pd( px, ax ), dx ),
+                               _mm_mul_pd( _mm_sub_pd( py, ay ), dy ) );
+    __m128d t    = _mm_div_pd( dot, _mm_max_pd( len2, one ) );
+
+    t = _mm_min_pd( _mm_max_pd( t, zero ), one );
+
+    __m128d ex = _mm_sub_pd( _mm_add_pd( ax, _mm_mul_pd( t, dx ) ), px );
+    __m128d ey = _mm_sub_pd( _mm_add_pd( ay, _mm_mul_pd( t, dy ) ), py );
+
+    return _mm_add_pd( _mm_mul_pd( ex, ex ), _mm_mul_pd( ey, ey ) );
+}
+
+
+/// @return rdx * ( by - ay ) - rdy * ( bx - ax ), for two points b at once
+static inline __m128d orient( __m128d rdx, __m128d rdy, __m128d ax, __m128d ay,
+                              __m128d bx, __m128d by )
+{
+    return _mm_sub_pd( _mm_mul_pd( rdx, _mm_sub_pd( by, ay ) ),
+                       _mm_mul_pd( rdy, _mm_sub_pd( bx, ax ) ) );
+}
+#endif
+
+
+void DRC_SEGMENT_BATCH::Clear()
+{
+    m_ax.clear();
+    m_ay.clear();
+    m_dx.clear();
+    m_dy.clear();
+    m_limit.clear();
+}
+
+
+void DRC_SEGMENT_BATCH::Add( const wxPoint& aStart, const wxPoint& aEnd, int aMinDist )
+{
+    double limit = (double) aMinDist + MARGIN;
+
+    m_ax.push_back( aStart.x );
+    m_ay.push_back( aStart.y );
+    m_dx.push_back( (double) aEnd.x - aStart.x );
+    m_dy.push_back( (double) aEnd.y - aStart.y );
+    m_limit.push_back( limit * limit );
+}
+
+
+void DRC_SEGMENT_BATCH::FindClose( const wxPoint& aStart, const wxPoint& aEnd,
+                                   std::vector<unsigned char>& aClose ) const
+{
+    const int    count = m_ax.size();
+    const double rax = aStart.x;
+    const double ray = aStart.y;
+    const double rdx = (double) aEnd.x - aStart.x;
+    const double rdy = (double) aEnd.y - aStart.y;
+
+    aClose.resize( count );
+
+    int ii = 0;
+
+#ifdef USE_SSE2_SEGMENT_BATCH
+    // Two candidates at once, the reference segment in both lanes
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d rax2 = _mm_set1_pd( rax );
+    const __m128d ray2 = _mm_set1_pd( ray );
+    const __m128d rdx2 = _mm_set1_pd( rdx );
+    const __m128d rdy2 = _mm_set1_pd( rdy );
+    const __m128d rbx2 = _mm_add_pd( rax2, rdx2 );
+    const __m128d rby2 = _mm_add_pd( ray2, rdy2 );
+
+    for( ; ii + 1 < count; ii += 2 )
+    {
+        const __m128d ax = _mm_loadu_pd( &m_ax[ii] );
+        const __m128d ay = _mm_loadu_pd( &m_ay[ii] );
+        const __m128d dx = _mm_loadu_pd( &m_dx[ii] );
+        const __m128d dy = _mm_loadu_pd( &m_dy[ii] );
+        const __m128d bx = _mm_add_pd( ax, dx );
+        const __m128d by = _mm_add_pd( ay, dy );
+
+        __m128d o1 = orient( rdx2, rdy2, rax2, ray2, ax, ay );
+        __m128d o2 = orient( rdx2, rdy2, rax2, ray2, bx, by );
+        __m128d o3 = orient( dx, dy, ax, ay, rax2, ray2 );
+        __m128d o4 = orient( dx, dy, ax, ay, rbx2, rby2 );
+
+        __m128d intersect = _mm_and_pd( _mm_cmple_pd( _mm_mul_pd( o1, o2 ), zero ),
+                                        _mm_cmple_pd( _mm_mul_pd( o3, o4 ), zero ) );
+
+        __m128d dist = _mm_min_pd( pointToSegment2( ax, ay, rax2, ray2, rdx2, rdy2 ),
+                                   pointToSegment2( bx, by, rax2, ray2, rdx2, rdy2 ) );
+
+        dist = _mm_min_pd( pointToSegment2( rax2, ray2, ax, ay, dx, dy ), dist );
+        dist = _mm_min_pd( pointToSegment2( rbx2, rby2, ax, ay, dx, dy ), dist );
+
+        __m128d close = _mm_or_pd( intersect,
+                                   _mm_cmplt_pd( dist, _mm_loadu_pd( &m_limit[ii] ) ) );
+        int     mask = _mm_movemask_pd( close );
+
+        aClose[ii]     = mask & 1;
+        aClose[ii + 1] = ( mask >> 1 ) & 1;
+    }
+#endif
+
+    // The remaining candidate, or all of them without SSE2
+    for( ; ii < count; ii++ )
+    {
+        const double ax = m_ax[ii];
+        const double ay = m_ay[ii];
+        const double dx = m_dx[ii];
+        const double dy = m_dy[ii];
+
+        // Like SEG::Distance(): 0 if the segments intersect, otherwise the
+        // smallest distance between an end point and the other segment.
+        // (collinear segments are always seen as intersecting, which is safe here)
+        double o1 = rdx * ( ay - ray ) - rdy * ( ax - rax );
+        double o2 = rdx * ( ay + dy - ray ) - rdy * ( ax + dx - rax );
+        double o3 = dx * ( ray - ay ) - dy * ( rax - ax );
+        double o4 = dx * ( ray + rdy - ay ) - dy * ( rax + rdx - ax );
+
+        bool intersect = ( o1 * o2 <= 0.0 ) & ( o3 * o4 <= 0.0 );
+
+        double d1 = pointToSegment2( ax, ay, rax, ray, rdx, rdy );
+        double d2 = pointToSegment2( ax + dx, ay + dy, rax, ray, rdx, rdy );
+        double d3 = pointToSegment2( rax, ray, ax, ay, dx, dy );
+        double d4 = pointToSegment2( rax + rdx, ray + rdy, ax, ay, dx, dy );
+
+        double dist = d1 < d2 ? d1 : d2;
+
+        dist = d3 < dist ? d3 : dist;
+        dist = d4 < dist ? d4 : dist;
+
+        aClose[ii] = intersect | ( dist < m_limit[ii] );
+    }
+}
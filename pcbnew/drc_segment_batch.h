@@ -0,0 +1,86 @@
+/**
+ * @file drc_segment_batch.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _DRC_SEGMENT_BATCH_H
+#define _DRC_SEGMENT_BATCH_H
+
+#include <vector>
+#include <wx/gdicmn.h>
+
+
+/**
+ * Class DRC_SEGMENT_BATCH
+ * stores the candidate segments of a track DRC test in structure of arrays form,
+ * and finds in one pass the candidates which may be too close to a reference
+ * segment, without the rotations and trigonometry of the exact tests.
+ * This is only a filter: a candidate reported as close must still be tested by
+ * the exact DRC functions, but a candidate reported as far away cannot fail them
+ * (the distances are computed like SEG::Distance(), with a small safety margin
+ * covering the rounding of the exact tests).
+ * With SSE2, two candidates are tested at once, with the same results.
+ */
+class DRC_SEGMENT_BATCH
+{
+public:
+    /// Margin added to the minimum distances, in internal units
+    static const int MARGIN = 100;
+
+    /**
+     * Function Clear
+     * removes all the candidates.
+     */
+    void Clear();
+
+    /**
+     * Function Add
+     * adds a candidate segment (a via is a segment with aStart == aEnd).
+     * @param aMinDist is the distance between the segment axes below which there is a
+     *                 violation, i.e. the clearance plus the half widths of both segments.
+     */
+    void Add( const wxPoint& aStart, const wxPoint& aEnd, int aMinDist );
+
+    int GetCount() const { return m_ax.size(); }
+
+    /**
+     * Function FindClose
+     * computes the distance from each candidate to a reference segment.
+     * @param aStart and aEnd are the reference segment ends.
+     * @param aClose is filled with one entry per candidate: non zero if the candidate
+     *               may be closer than its minimum distance, and must be tested.
+     */
+    void FindClose( const wxPoint& aStart, const wxPoint& aEnd,
+                    std::vector<unsigned char>& aClose ) const;
+
+private:
+    std::vector<double> m_ax;       ///< start points
+    std::vector<double> m_ay;
+    std::vector<double> m_dx;       ///< end - start
+    std::vector<double> m_dy;
+    std::vector<double> m_limit;    ///< squared minimum distances, margin included
+};
+
+#endif  // _DRC_SEGMENT_BATCH_H
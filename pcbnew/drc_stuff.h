@@ -32,6 +32,8 @@
 #include <vector>
 #include <boost/shared_ptr.hpp>
 
+#include <drc_segment_batch.h>
+
 #define OK_DRC  0
 #define BAD_DRC 1
 
@@ -91,6 +93,10 @@ class TRACK;
 class MARKER_PCB;
 class DRC_ITEM;
 class NETCLASS;
+class EDA_RECT;
+class LSET;
+class DRC_ONLINE;
+class TRACK_EDIT_BATCH;
 
 
 /**
@@ -140,6 +146,17 @@ public:
 typedef std::vector<DRC_ITEM*> DRC_LIST;
 
 
+/**
+ * Struct DRC_PHASE_TIMING
+ * is the time spent in one of the test phases of DRC::RunTests().
+ */
+struct DRC_PHASE_TIMING
+{
+    wxString    m_Name;         ///< phase name, not translated because used in reports
+    unsigned    m_Time;         ///< run time in microseconds
+};
+
+
 /**
  * Class DRC
  * is the Design Rule Checker, and performs all the DRC tests.  The output of
@@ -152,6 +169,8 @@ typedef std::vector<DRC_ITEM*> DRC_LIST;
 class DRC
 {
     friend class DIALOG_DRC_CONTROL;
+    friend class DRC_ONLINE;
+    friend class TRACK_EDIT_BATCH;
 
 private:
 
@@ -193,17 +212,52 @@ private:
     int                 m_xcliphi;
     int                 m_ycliphi;
 
+    /* used in doTrackDrc() to reject the far away candidate tracks in one pass,
+     * kept here to reuse their buffers
+     */
+    DRC_SEGMENT_BATCH           m_trackBatch;
+    std::vector<unsigned char>  m_trackClose;
+
     PCB_EDIT_FRAME*     m_mainWindow;
     BOARD*              m_pcb;
     DIALOG_DRC_CONTROL* m_drcDialog;
 
     DRC_LIST            m_unconnected;  ///< list of unconnected pads, as DRC_ITEMs
 
+    DRC_ONLINE*         m_online;       ///< the online DRC session, NULL when disabled
+
+    std::vector<DRC_PHASE_TIMING> m_timings; ///< run times of the last RunTests() phases
+
+
+    /// Sets the initial values of the settings and of the test state
+    void init();
+
+    /**
+     * Function addMarkerToPcb
+     * adds a marker to the board, and to the view when the DRC runs in a frame.
+     */
+    void addMarkerToPcb( MARKER_PCB* aMarker );
+
+    /**
+     * Function addPhaseTiming
+     * records the run time of a RunTests() phase.
+     * @param aName is the phase name.
+     * @param aStartTime is the GetRunningMicroSecs() value at the phase start.
+     */
+    void addPhaseTiming( const wxString& aName, unsigned aStartTime );
+
+    /**
+     * Function fillAllZones
+     * refills the outdated copper zones without a frame, like
+     * PCB_EDIT_FRAME::Fill_All_Zones() does, for batch runs.
+     */
+    void fillAllZones();
+
 
     /**
      * Function updatePointers
      * is a private helper function used to update needed pointers from the
-     * one pointer which is known not to change, m_mainWindow.
+     * one pointer which is known not to change, m_mainWindow (if any).
      */
     void updatePointers();
 
@@ -253,6 +307,20 @@ private:
     MARKER_PCB* fillMarker( int aErrorCode, const wxString& aMessage, MARKER_PCB* fillMe );
 
 
+    /**
+     * Function padDrcArea
+     * @return the area which contains the shape and the hole of aPad,
+     * inflated by the pad clearance, used to index the pads.
+     */
+    static EDA_RECT padDrcArea( D_PAD* aPad );
+
+    /**
+     * Function padDrcLayers
+     * @return the layers aPad must be tested on against tracks: its own layers,
+     * and all the copper layers if it has a hole.
+     */
+    static LSET padDrcLayers( D_PAD* aPad );
+
     //-----<categorical group tests>-----------------------------------------
 
     /**
@@ -270,6 +338,8 @@ private:
     /**
      * Function testTracks
      * performs the DRC on all tracks.
+     * Pads and tracks are stored in spatial indexes first, so each segment is only
+     * tested against the items close to it.
      * because this test can take a while, a progress bar can be displayed
      * @param aActiveWindow = the active window ued as parent for the progress bar
      * @param aShowProgressBar = true to show a progress bar
@@ -277,6 +347,11 @@ private:
      */
     void testTracks( wxWindow * aActiveWindow, bool aShowProgressBar );
 
+    /**
+     * Function testPad2Pad
+     * performs the pad to pad DRC.  The pads are stored in a spatial index first,
+     * so each pad is only tested against the pads close to it.
+     */
     void testPad2Pad();
 
     void testUnconnected();
@@ -294,13 +369,12 @@ private:
     /**
      * Function doPadToPadsDrc
      * tests the clearance between aRefPad and other pads.
-     * The pad list must be sorted by x coordinate.
      * @param aRefPad The pad to test
-     * @param aStart The start of the pad list to test against
-     * @param aEnd Marks the end of the list and is not included
-     * @param x_limit is used to stop the test (when the any pad's X coord exceeds this)
+     * @param aPads The pads to test against, usually the pads close to aRefPad
+     * @param aHolePad A pad with a parent, used to test the holes (its size,
+     *                 shape, layers and clearance are modified by the test)
      */
-    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit );
+    bool doPadToPadsDrc( D_PAD* aRefPad, const std::vector<D_PAD*>& aPads, D_PAD& aHolePad );
 
     /**
      * Function DoTrackDrc
@@ -313,6 +387,22 @@ private:
      */
     bool doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool doPads = true );
 
+    /**
+     * Function DoTrackDrc
+     * tests the current segment against a list of candidate pads and tracks,
+     * usually the ones found near aRefSeg by a spatial index.
+     * The candidates are tested in the list order, so giving them in the board order
+     * gives the same result as the other doTrackDrc().
+     * @param aRefSeg The segment to test
+     * @param aPads The pads to test against
+     * @param aTracks The tracks to test against
+     * @param aHolePad A dummy pad on all copper layers, used to test pad holes
+     * @return bool - true if no poblems, else false and m_currentMarker is
+     *          filled in with the problem information.
+     */
+    bool doTrackDrc( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                     const std::vector<TRACK*>& aTracks, D_PAD& aHolePad );
+
     /**
      * Function doTrackKeepoutDrc
      * tests the current segment or via.
@@ -336,6 +426,44 @@ private:
 
     //-----<single tests>----------------------------------------------
 
+    /**
+     * Function checkTrackSizes
+     * tests the width of a track, or the sizes and the layer pair of a via,
+     * against the board design settings.
+     * @param aRefSeg The track or via to test
+     * @return bool - true if no poblems, else false and m_currentMarker is
+     *          filled in with the problem information.
+     */
+    bool checkTrackSizes( TRACK* aRefSeg );
+
+    /**
+     * Function setRefSegment
+     * initializes m_segmEnd, m_segmAngle and m_segmLength from aRefSeg, used by
+     * checkTrackToPad() and checkTrackToTrack().
+     */
+    void setRefSegment( TRACK* aRefSeg );
+
+    /**
+     * Function checkTrackToPad
+     * tests the clearance between aRefSeg and a pad, or its hole if the pad is not
+     * on the aRefSeg layers.  setRefSegment( aRefSeg ) must have been called.
+     * @param aRefSeg The segment to test
+     * @param aPad The pad to test against
+     * @param aHolePad A dummy pad on all copper layers, used to test the pad hole
+     * @return bool - true if no poblems, else false and m_currentMarker is
+     *          filled in with the problem information.
+     */
+    bool checkTrackToPad( TRACK* aRefSeg, D_PAD* aPad, D_PAD& aHolePad );
+
+    /**
+     * Function checkTrackToTrack
+     * tests the clearance between aRefSeg and an other track or via.
+     * setRefSegment( aRefSeg ) must have been called.
+     * @return bool - true if no poblems, else false and m_currentMarker is
+     *          filled in with the problem information.
+     */
+    bool checkTrackToTrack( TRACK* aRefSeg, TRACK* aTrack );
+
     /**
      * Function checkClearancePadToPad
      * @param aRefPad The reference pad to check
@@ -390,9 +518,22 @@ private:
 
     //-----</single tests>---------------------------------------------
 
+    /// Report writers used by WriteReport()
+    bool writeTextReport( FILE* aFile ) const;
+    bool writeJsonReport( FILE* aFile ) const;
+    bool writeCsvReport( FILE* aFile ) const;
+
 public:
     DRC( PCB_EDIT_FRAME* aPcbWindow );
 
+    /**
+     * Constructor
+     * creates a DRC which is not attached to a frame, to test aBoard in batch mode
+     * (e.g. from a script).  The markers are only added to the board, and the
+     * GUI only functions (ShowDialog(), online tests) cannot be used.
+     */
+    DRC( BOARD* aBoard );
+
     ~DRC();
 
     /**
@@ -491,6 +632,55 @@ public:
      */
     void ListUnconnectedPads();
 
+    /**
+     * Function EnableOnlineTests
+     * starts or stops the online DRC.  When it is enabled, the board changes are
+     * recorded, and RunOnlineTests() checks the tracks close to the changed items.
+     * Stopping it removes the markers it has created.
+     */
+    void EnableOnlineTests( bool aEnable );
+
+    bool OnlineTestsEnabled() const
+    {
+        return m_online != NULL;
+    }
+
+    /**
+     * Function RunOnlineTests
+     * checks the tracks close to the items changed since the last call, if the
+     * online DRC is enabled, and updates their markers.
+     */
+    void RunOnlineTests();
+
+    /**
+     * Function GetUnconnectedCount
+     * @return the number of unconnected items found by the last test.
+     */
+    int GetUnconnectedCount() const
+    {
+        return m_unconnected.size();
+    }
+
+    /**
+     * Function GetPhaseTimings
+     * @return the run time of each phase of the last RunTests() call.
+     */
+    const std::vector<DRC_PHASE_TIMING>& GetPhaseTimings() const
+    {
+        return m_timings;
+    }
+
+    /**
+     * Function WriteReport
+     * writes the markers of the board, the unconnected items and the phase timings
+     * of the last RunTests() call to a file.  The format depends on the file extension:
+     * JSON for .json, comma separated values for .csv, and the same text as the DRC
+     * dialog report otherwise.
+     * @param aFullFileName is the report file name.
+     * @return true if the file was written.
+     */
+    bool WriteReport( const wxString& aFullFileName ) const;
+
     /**
      * @return a pointer to the current marker (last created marker
      */
@@ -45,6 +45,10 @@ reporting.
 User can load the source XML file into firefox or other xml browser and follow
 our error message.
 
+The file is parsed in place by the rapidxml parser of property_tree, and only one
+record of the board at a time, such as a signal or a library, is converted to a ptree
+for its loader.  The ptree of a large board takes many times the size of the file.
+
 Load() TODO's
 
 *) verify zone fill clearances are correct
@@ -52,10 +56,14 @@ Load() TODO's
 */
 
 #include <errno.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 
 #include <wx/string.h>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
+#include <boost/property_tree/detail/rapidxml.hpp>
 
 #include <eagle_plugin.h>
 
@@ -78,6 +86,10 @@ Load() TODO's
 using namespace boost::property_tree;
 using namespace std;
 
+namespace rapidxml = boost::property_tree::detail::rapidxml;
+
+typedef rapidxml::xml_document<char>    XML_DOC;
+
 typedef EAGLE_PLUGIN::BIU                   BIU;
 typedef PTREE::const_assoc_iterator         CA_ITER;
 typedef PTREE::const_iterator               CITER;
@@ -1106,11 +1118,58 @@ static inline string makeKey( const string& aFirst, const string& aSecond )
 }
 
 
-/// Make a unique time stamp
-static inline unsigned long timeStamp( CPTREE& aTree )
+/**
+ * Function parseXmlFile
+ * reads the file @a aFileName in @a aText and parses it in place in @a aDocument, as
+ * read_xml() does but without copying it to a PTREE.  The nodes of @a aDocument point
+ * into @a aText, which must outlive it.
+ * @throw xml_parser_error if the file cannot be read or parsed.
+ */
+static void parseXmlFile( const string& aFileName, vector<char>& aText, XML_DOC& aDocument )
+{
+    ifstream stream( aFileName.c_str() );
+
+    if( !stream )
+        throw xml_parser_error( "cannot open file", aFileName, 0 );
+
+    stream.unsetf( ios::skipws );
+    aText.assign( istreambuf_iterator<char>( stream.rdbuf() ), istreambuf_iterator<char>() );
+
+    if( !stream.good() )
+        throw xml_parser_error( "read error", aFileName, 0 );
+
+    aText.push_back( 0 );
+
+    try
+    {
+        aDocument.parse<0>( &aText[0] );
+    }
+    catch( rapidxml::parse_error& pe )
+    {
+        long line = (long) count( &aText[0], pe.where<char>(), '\n' ) + 1;
+
+        throw xml_parser_error( pe.what(), aFileName, line );
+    }
+}
+
+
+/// Return the child element @a aName of @a aNode, or throw ptree_bad_path as get_child()
+static XML_NODE* xmlChild( XML_NODE* aNode, const char* aName )
+{
+    XML_NODE* child = aNode->first_node( aName );
+
+    if( !child )
+        throw ptree_bad_path( "No such node", PTREE::path_type( aName ) );
+
+    return child;
+}
+
+
+/// Copy the element @a aNode to @a aTree, as its single child like read_xml() reads it
+static void xmlRecord( XML_NODE* aNode, PTREE& aTree )
 {
-    // in this case from a unique tree memory location
-    return (unsigned long)(void*) &aTree;
+    aTree.clear();
+    xml_parser::read_xml_node( aNode, aTree, xml_parser::no_comments );
 }
 
 
@@ -1181,7 +1240,8 @@ wxSize inline EAGLE_PLUGIN::kicad_fontz( double d ) const
 BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const PROPERTIES* aProperties )
 {
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-    PTREE       doc;
+    vector<char> text;
+    XML_DOC     doc;
 
     init( aProperties );
 
@@ -1201,13 +1261,13 @@ BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const
         // and is not necessarily utf8.
         string filename = (const char*) aFileName.char_str( wxConvFile );
 
-        read_xml( filename, doc, xml_parser::no_comments );
+        parseXmlFile( filename, text, doc );
 
         m_min_trace    = INT_MAX;
         m_min_via      = INT_MAX;
         m_min_via_hole = INT_MAX;
 
-        loadAllSections( doc );
+        loadAllSections( &doc );
 
         BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
 
@@ -1278,6 +1338,8 @@ void EAGLE_PLUGIN::init( const PROPERTIES* aProperties )
     m_min_trace    = 0;
     m_min_via      = 0;
     m_min_via_hole = 0;
+    m_netcode      = 1;
+    m_timestamp    = GetNewTimeStamp();
     m_xpath->clear();
     m_pads_to_nets.clear();
 
@@ -1303,18 +1365,19 @@ void EAGLE_PLUGIN::clear_cu_map()
 }
 
 
-void EAGLE_PLUGIN::loadAllSections( CPTREE& aDoc )
+void EAGLE_PLUGIN::loadAllSections( XML_NODE* aDoc )
 {
-    CPTREE& drawing = aDoc.get_child( "eagle.drawing" );
-    CPTREE& board   = drawing.get_child( "board" );
+    XML_NODE* drawing = xmlChild( xmlChild( aDoc, "eagle" ), "drawing" );
+    XML_NODE* board   = xmlChild( drawing, "board" );
+    PTREE     section;
 
     m_xpath->push( "eagle.drawing" );
 
     {
         m_xpath->push( "board" );
 
-        CPTREE& designrules = board.get_child( "designrules" );
-        loadDesignRules( designrules );
+        xmlRecord( xmlChild( board, "designrules" ), section );
+        loadDesignRules( section.front().second );
 
         m_xpath->pop();
     }
@@ -1322,26 +1385,21 @@ void EAGLE_PLUGIN::loadAllSections( CPTREE& aDoc )
     {
         m_xpath->push( "layers" );
 
-        CPTREE& layers = drawing.get_child( "layers" );
-        loadLayerDefs( layers );
+        xmlRecord( xmlChild( drawing, "layers" ), section );
+        loadLayerDefs( section.front().second );
 
         m_xpath->pop();
     }
 
+    section.clear();
+
     {
         m_xpath->push( "board" );
 
-        CPTREE& plain = board.get_child( "plain" );
-        loadPlain( plain );
-
-        CPTREE&  signals = board.get_child( "signals" );
-        loadSignals( signals );
-
-        CPTREE&  libs = board.get_child( "libraries" );
-        loadLibraries( libs );
-
-        CPTREE& elems = board.get_child( "elements" );
-        loadElements( elems );
+        loadRecords( xmlChild( board, "plain" ), &EAGLE_PLUGIN::loadPlain );
+        loadRecords( xmlChild( board, "signals" ), &EAGLE_PLUGIN::loadSignals );
+        loadRecords( xmlChild( board, "libraries" ), &EAGLE_PLUGIN::loadLibraries );
+        loadRecords( xmlChild( board, "elements" ), &EAGLE_PLUGIN::loadElements );
 
         m_xpath->pop();     // "board"
     }
@@ -1350,6 +1408,22 @@ void EAGLE_PLUGIN::loadAllSections( CPTREE& aDoc )
 }
 
 
+void EAGLE_PLUGIN::loadRecords( XML_NODE* aSection, void (EAGLE_PLUGIN::*aLoader)( CPTREE& ) )
+{
+    PTREE   record;
+
+    for( XML_NODE* node = aSection->first_node();  node;  node = node->next_sibling() )
+    {
+        if( node->type() != rapidxml::node_element )
+            continue;
+
+        // the section holding only this record
+        xmlRecord( node, record );
+        (this->*aLoader)( record );
+    }
+}
+
+
 void EAGLE_PLUGIN::loadDesignRules( CPTREE& aDesignRules )
 {
     m_xpath->push( "designrules" );
@@ -1461,7 +1535,7 @@ void EAGLE_PLUGIN::loadPlain( CPTREE& aGraphics )
                     dseg->SetAngle( *w.curve * -10.0 ); // KiCad rotates the other way
                 }
 
-                dseg->SetTimeStamp( timeStamp( gr->second ) );
+                dseg->SetTimeStamp( timeStamp() );
                 dseg->SetLayer( layer );
                 dseg->SetWidth( Millimeter2iu( DEFAULT_PCB_EDGE_THICKNESS ) );
             }
@@ -1487,7 +1561,7 @@ void EAGLE_PLUGIN::loadPlain( CPTREE& aGraphics )
                 m_board->Add( pcbtxt, ADD_APPEND );
 
                 pcbtxt->SetLayer( layer );
-                pcbtxt->SetTimeStamp( timeStamp( gr->second ) );
+                pcbtxt->SetTimeStamp( timeStamp() );
                 pcbtxt->SetText( FROM_UTF8( t.text.c_str() ) );
                 pcbtxt->SetTextPosition( wxPoint( kicad_x( t.x ), kicad_y( t.y ) ) );
 
@@ -1575,7 +1649,7 @@ void EAGLE_PLUGIN::loadPlain( CPTREE& aGraphics )
                 m_board->Add( dseg, ADD_APPEND );
 
                 dseg->SetShape( S_CIRCLE );
-                dseg->SetTimeStamp( timeStamp( gr->second ) );
+                dseg->SetTimeStamp( timeStamp() );
                 dseg->SetLayer( layer );
                 dseg->SetStart( wxPoint( kicad_x( c.x ), kicad_y( c.y ) ) );
                 dseg->SetEnd( wxPoint( kicad_x( c.x + c.radius ), kicad_y( c.y ) ) );
@@ -1598,7 +1672,7 @@ void EAGLE_PLUGIN::loadPlain( CPTREE& aGraphics )
                 ZONE_CONTAINER* zone = new ZONE_CONTAINER( m_board );
                 m_board->Add( zone, ADD_APPEND );
 
-                zone->SetTimeStamp( timeStamp( gr->second ) );
+                zone->SetTimeStamp( timeStamp() );
                 zone->SetLayer( layer );
                 zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
 
@@ -1657,6 +1731,7 @@ void EAGLE_PLUGIN::loadPlain( CPTREE& aGraphics )
             pad->SetSize( sz );
 
             pad->SetLayerSet( LSET::AllCuMask() );
+            module->CalculateBoundingBox();
             m_xpath->pop();
         }
         else if( gr->first == "frame" )
@@ -1987,6 +2062,9 @@ void EAGLE_PLUGIN::loadElements( CPTREE& aElements )
         }
 
         orientModuleAndText( m, e, nameAttr, valueAttr );
+
+        // SetPosition() only moves the bounding box of the package
+        m->CalculateBoundingBox();
     }
 
     m_xpath->pop();     // "elements.element"
@@ -2315,7 +2393,7 @@ void EAGLE_PLUGIN::packageText( MODULE* aModule, CPTREE& aTree ) const
         aModule->GraphicalItems().PushBack( txt );
     }
 
-    txt->SetTimeStamp( timeStamp( aTree ) );
+    txt->SetTimeStamp( timeStamp() );
     txt->SetText( FROM_UTF8( t.text.c_str() ) );
 
     wxPoint pos( kicad_x( t.x ), kicad_y( t.y ) );
@@ -2412,7 +2490,7 @@ void EAGLE_PLUGIN::packageRectangle( MODULE* aModule, CPTREE& aTree ) const
         dwg->SetLayer( layer );
         dwg->SetWidth( 0 );
 
-        dwg->SetTimeStamp( timeStamp( aTree ) );
+        dwg->SetTimeStamp( timeStamp() );
 
         std::vector<wxPoint> pts;
 
@@ -2458,7 +2536,7 @@ void EAGLE_PLUGIN::packagePolygon( MODULE* aModule, CPTREE& aTree ) const
 
         dwg->SetLayer( layer );
 
-        dwg->SetTimeStamp( timeStamp( aTree ) );
+        dwg->SetTimeStamp( timeStamp() );
 
         std::vector<wxPoint> pts;
         pts.reserve( aTree.size() );
@@ -2503,7 +2581,7 @@ void EAGLE_PLUGIN::packageCircle( MODULE* aModule, CPTREE& aTree ) const
     }
 
     gr->SetLayer( layer );
-    gr->SetTimeStamp( timeStamp( aTree ) );
+    gr->SetTimeStamp( timeStamp() );
 
     gr->SetStart0( wxPoint( kicad_x( e.x ), kicad_y( e.y ) ) );
     gr->SetEnd0( wxPoint( kicad_x( e.x + e.radius ), kicad_y( e.y ) ) );
@@ -2610,7 +2688,7 @@ void EAGLE_PLUGIN::loadSignals( CPTREE& aSignals )
 
     m_xpath->push( "signals.signal", "name" );
 
-    int netCode = 1;
+    int netCode = m_netcode;
 
     for( CITER net = aSignals.begin();  net != aSignals.end();  ++net )
     {
@@ -2644,7 +2722,7 @@ void EAGLE_PLUGIN::loadSignals( CPTREE& aSignals )
                 {
                     TRACK*  t = new TRACK( m_board );
 
-                    t->SetTimeStamp( timeStamp( it->second ) );
+                    t->SetTimeStamp( timeStamp() );
 
                     t->SetPosition( wxPoint( kicad_x( w.x1 ), kicad_y( w.y1 ) ) );
                     t->SetEnd( wxPoint( kicad_x( w.x2 ), kicad_y( w.y2 ) ) );
@@ -2713,7 +2791,7 @@ void EAGLE_PLUGIN::loadSignals( CPTREE& aSignals )
                     else
                         via->SetViaType( VIA_BLIND_BURIED );
 
-                    via->SetTimeStamp( timeStamp( it->second ) );
+                    via->SetTimeStamp( timeStamp() );
 
                     wxPoint pos( kicad_x( v.x ), kicad_y( v.y ) );
 
@@ -2759,7 +2837,7 @@ void EAGLE_PLUGIN::loadSignals( CPTREE& aSignals )
                     m_board->Add( zone, ADD_APPEND );
                     zones.push_back( zone );
 
-                    zone->SetTimeStamp( timeStamp( it->second ) );
+                    zone->SetTimeStamp( timeStamp() );
                     zone->SetLayer( layer );
                     zone->SetNetCode( netCode );
 
@@ -2844,6 +2922,8 @@ void EAGLE_PLUGIN::loadSignals( CPTREE& aSignals )
             netCode++;
     }
 
+    m_netcode = netCode;
+
     m_xpath->pop();     // "signals.signal"
 }
 
@@ -3051,7 +3131,9 @@ void EAGLE_PLUGIN::cacheLib( const wxString& aLibPath )
 
         if( aLibPath != m_lib_path || load )
         {
-            PTREE       doc;
+            vector<char> text;
+            XML_DOC     doc;
+            PTREE       section;
             LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
             m_templates.clear();
@@ -3066,19 +3148,21 @@ void EAGLE_PLUGIN::cacheLib( const wxString& aLibPath )
             // and is not necessarily utf8.
             string filename = (const char*) aLibPath.char_str( wxConvFile );
 
-            read_xml( filename, doc, xml_parser::no_comments );
+            parseXmlFile( filename, text, doc );
+
+            XML_NODE* drawing = xmlChild( xmlChild( &doc, "eagle" ), "drawing" );
 
             // clear the cu map and then rebuild it.
             clear_cu_map();
 
             m_xpath->push( "eagle.drawing.layers" );
-            CPTREE& layers  = doc.get_child( "eagle.drawing.layers" );
-            loadLayerDefs( layers );
+            xmlRecord( xmlChild( drawing, "layers" ), section );
+            loadLayerDefs( section.front().second );
             m_xpath->pop();
 
             m_xpath->push( "eagle.drawing.library" );
-            CPTREE& library = doc.get_child( "eagle.drawing.library" );
-            loadLibrary( library, NULL );
+            xmlRecord( xmlChild( drawing, "library" ), section );
+            loadLibrary( section.front().second, NULL );
             m_xpath->pop();
 
             m_mod_time = modtime;
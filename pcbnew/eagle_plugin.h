@@ -36,6 +36,10 @@
 #include <boost/ptr_container/ptr_map.hpp>
 #include <map>
 
+namespace boost { namespace property_tree { namespace detail { namespace rapidxml {
+    template<class Ch> class xml_node;
+} } } }
+
 
 class MODULE;
 typedef boost::ptr_map< std::string, MODULE >   MODULE_MAP;
@@ -62,6 +66,8 @@ typedef NET_MAP::const_iterator         NET_MAP_CITER;
 typedef boost::property_tree::ptree     PTREE;
 typedef const PTREE                     CPTREE;
 
+typedef boost::property_tree::detail::rapidxml::xml_node<char>  XML_NODE;
+
 struct EELEMENT;
 class XPATH;
 struct ERULES;
@@ -140,6 +146,9 @@ private:
     int         m_min_via;          ///< smallest via we find on Load(), in BIU.
     int         m_min_via_hole;     ///< smallest via diameter hole we find on Load(), in BIU.
 
+    int         m_netcode;          ///< net code of the next signal in Load().
+    mutable unsigned long m_timestamp;  ///< last of the unique time stamps of the items.
+
     double      mm_per_biu;         ///< how many mm in each BIU
     double      biu_per_mm;         ///< how many bius in a mm
 
@@ -175,7 +184,21 @@ private:
 
     // all these loadXXX() throw IO_ERROR or ptree_error exceptions:
 
-    void loadAllSections( CPTREE& aDocument );
+    /**
+     * Function loadAllSections
+     * loads the board of the parsed XML document @a aDocument.  The sections are
+     * converted to a PTREE one record at a time, see loadRecords().
+     */
+    void loadAllSections( XML_NODE* aDocument );
+
+    /**
+     * Function loadRecords
+     * calls @a aLoader for each child element of @a aSection: each plain item, signal,
+     * library or element.  The child is converted to a PTREE holding it, which is freed
+     * once it is loaded, instead of converting the whole document.
+     */
+    void loadRecords( XML_NODE* aSection, void (EAGLE_PLUGIN::*aLoader)( CPTREE& ) );
+
     void loadDesignRules( CPTREE& aDesignRules );
     void loadLayerDefs( CPTREE& aLayers );
     void loadPlain( CPTREE& aPlain );
@@ -201,6 +224,9 @@ private:
     void orientModuleText( MODULE* m, const EELEMENT& e, TEXTE_MODULE* txt, const EATTR* a );
 
 
+    /// return a new time stamp, unique within the loaded items
+    unsigned long timeStamp() const         { return ++m_timestamp; }
+
     /// move the BOARD into the center of the page
     void centerBoard();
 
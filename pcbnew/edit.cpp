@@ -297,6 +297,10 @@ void PCB_EDIT_FRAME::Process_Special_Functions( wxCommandEvent& event )
         m_drc->ShowDialog();
         break;
 
+    case ID_DRC_ONLINE:
+        m_drc->EnableOnlineTests( !m_drc->OnlineTestsEnabled() );
+        break;
+
     case ID_GET_NETLIST:
         InstallNetlistFrame( &dc );
         break;
@@ -39,6 +39,7 @@
 #include <pcbnew.h>
 #include <drc_stuff.h>
 #include <protos.h>
+#include <track_edit_batch.h>
 
 
 /**
@@ -48,11 +49,13 @@
  * @param aTrackItem = the track segment or via to modify
  * @param aItemsListPicker = the list picker to use for an undo command (can be NULL)
  * @param aUseNetclassValue = true to use NetClass value, false to use BOARD::m_designSettings value
+ * @param aBatch = the batch of edits aTrackItem belongs to (can be NULL)
  * @return  true if done, false if no not change (because DRC error)
  */
 bool PCB_EDIT_FRAME::SetTrackSegmentWidth( TRACK*             aTrackItem,
                                            PICKED_ITEMS_LIST* aItemsListPicker,
-                                           bool               aUseNetclassValue )
+                                           bool               aUseNetclassValue,
+                                           TRACK_EDIT_BATCH*  aBatch )
 {
     int           initial_width, new_width;
     int           initial_drill = -1,new_drill = -1;
@@ -64,6 +67,8 @@ bool PCB_EDIT_FRAME::SetTrackSegmentWidth( TRACK*             aTrackItem,
 
     initial_width = aTrackItem->GetWidth();
 
+    const EDA_RECT initial_area = aTrackItem->GetBoundingBox();
+
     if( net )
         new_width = net->GetTrackWidth();
     else
@@ -123,7 +128,9 @@ bool PCB_EDIT_FRAME::SetTrackSegmentWidth( TRACK*             aTrackItem,
     {
         int diagdrc = OK_DRC;
 
-        if( g_Drc_On )
+        if( g_Drc_On && aBatch )
+            diagdrc = aBatch->Drc( aTrackItem );
+        else if( g_Drc_On )
             diagdrc = m_drc->Drc( aTrackItem, GetBoard()->m_Track );
 
         if( diagdrc == OK_DRC )
@@ -142,7 +149,8 @@ bool PCB_EDIT_FRAME::SetTrackSegmentWidth( TRACK*             aTrackItem,
 
     if( change_ok )
     {
-        OnModify();
+        if( !aBatch )
+            OnModify();
 
         if( aItemsListPicker )
         {
@@ -162,6 +170,9 @@ bool PCB_EDIT_FRAME::SetTrackSegmentWidth( TRACK*             aTrackItem,
                     via->SetDrillDefault();
             }
         }
+
+        if( aBatch )
+            aBatch->Changed( aTrackItem, initial_area );
     }
     else
     {
@@ -269,7 +280,7 @@ bool PCB_EDIT_FRAME::Change_Net_Tracks_And_Vias_Sizes( int aNetcode, bool aUseNe
 
     // Examine segments
     PICKED_ITEMS_LIST itemsListPicker;
-    bool change = false;
+    TRACK_EDIT_BATCH  batch( m_drc, GetBoard() );
 
     for( pt_segm = GetBoard()->m_Track; pt_segm != NULL; pt_segm = pt_segm->Next() )
     {
@@ -277,15 +288,16 @@ bool PCB_EDIT_FRAME::Change_Net_Tracks_And_Vias_Sizes( int aNetcode, bool aUseNe
             continue;
 
         // we have found a item member of the net
-        if( SetTrackSegmentWidth( pt_segm, &itemsListPicker, aUseNetclassValue ) )
-            change = true;
+        SetTrackSegmentWidth( pt_segm, &itemsListPicker, aUseNetclassValue, &batch );
     }
 
-    if( !change )
+    if( batch.GetChangeCount() == 0 )
         return false;
 
     // Some segment have changed: save them in undo list
     SaveCopyInUndoList( itemsListPicker, UR_CHANGED );
+    OnModify();
+
     return true;
 }
 
@@ -296,28 +308,23 @@ bool PCB_EDIT_FRAME::Reset_All_Tracks_And_Vias_To_Netclass_Values( bool aTrack,
 
     // read and edit tracks and vias if required
     PICKED_ITEMS_LIST itemsListPicker;
-    bool change = false;
+    TRACK_EDIT_BATCH  batch( m_drc, GetBoard() );
 
     for( pt_segm = GetBoard()->m_Track; pt_segm != NULL; pt_segm = pt_segm->Next() )
     {
         if( (pt_segm->Type() == PCB_VIA_T ) && aVia )
-        {
-            if( SetTrackSegmentWidth( pt_segm, &itemsListPicker, true ) )
-                change = true;
-        }
+            SetTrackSegmentWidth( pt_segm, &itemsListPicker, true, &batch );
 
         if( (pt_segm->Type() == PCB_TRACE_T ) && aTrack )
-        {
-            if( SetTrackSegmentWidth( pt_segm, &itemsListPicker, true ) )
-                change = true;
-        }
+            SetTrackSegmentWidth( pt_segm, &itemsListPicker, true, &batch );
     }
 
-    if( !change )
+    if( batch.GetChangeCount() == 0 )
         return false;
 
     // Some segment have changed: save them in undo list
     SaveCopyInUndoList( itemsListPicker, UR_CHANGED );
+    OnModify();
 
     return true;
 }
@@ -43,9 +43,15 @@
 #include <class_module.h>
 #include <class_track.h>
 #include <class_edge_mod.h>
+#include <richio.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
 #include <vector>
 #include <cctype>
 
+#include <boost/bind.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
 /* Structure for holding the D-356 record fields.
  * Useful because 356A (when implemented) must be sorted before outputting it */
 struct D356_RECORD
@@ -279,14 +285,77 @@ static const wxString intern_new_d356_netname( const wxString &aNetname,
     return canon;
 }
 
+// The number of records formatted by each task
+#define D356_RECORDS_PER_TASK 512
+
+/* Format the records aFirst to aLast - 1 in D356 format; aNets are their
+ * canonicalized network names */
+static void format_D356_records( const std::vector <D356_RECORD>* aRecords,
+                                 const std::vector <std::string>* aNets,
+                                 unsigned aFirst, unsigned aLast,
+                                 STRING_FORMATTER* aOut )
+{
+    for( unsigned i = aFirst; i < aLast; i++ )
+    {
+        const D356_RECORD &rk = (*aRecords)[i];
+
+        // Choose the best record type
+        int rktype;
+        if( rk.smd )
+            rktype = 327;
+        else
+        {
+            if( rk.mechanical )
+                rktype = 367;
+            else
+                rktype = 317;
+        }
+
+        // Operation code, signal and component
+        aOut->Print( 0, "%03d%-14.14s   %-6.6s%c%-4.4s%c",
+                     rktype, (*aNets)[i].c_str(),
+                     TO_UTF8(rk.refdes),
+                     rk.pin.empty()?' ':'-',
+                     TO_UTF8(rk.pin),
+                     rk.midpoint?'M':' ' );
+
+        // Hole definition
+        if( rk.hole )
+        {
+            aOut->Print( 0, "D%04d%c",
+                         iu_to_d356( rk.drill, 9999 ),
+                         rk.mechanical ? 'U':'P' );
+        }
+        else
+            aOut->Print( 0, "      " );
+
+        // Test point access
+        aOut->Print( 0, "A%02dX%+07dY%+07dX%04dY%04dR%03d",
+                     rk.access,
+                     iu_to_d356( rk.x_location, 999999 ),
+                     iu_to_d356( rk.y_location, 999999 ),
+                     iu_to_d356( rk.x_size, 9999 ),
+                     iu_to_d356( rk.y_size, 9999 ),
+                     rk.rotation );
+
+        // Soldermask
+        aOut->Print( 0, "S%d\n", rk.soldermask );
+    }
+}
+
 /* Write all the accumuled data to the file in D356 format */
 static void write_D356_records( std::vector <D356_RECORD> &aRecords,
-                                FILE *fout )
+                                OUTPUTFORMATTER* aOut )
 {
     // Sanified and shorted network names and set of short names
     std::map<wxString, wxString> d356_net_map;
     std::set<wxString> d356_net_set;
 
+    // The network name of each record, in UTF8
+    std::vector<std::string> d356_nets( aRecords.size() );
+
+    // The names are made unique in the order of the records, before the
+    // records are formatted by blocks on the threads of the process
     for (unsigned i = 0; i < aRecords.size(); i++)
     {
         D356_RECORD &rk = aRecords[i];
@@ -304,47 +373,35 @@ static void write_D356_records( std::vector <D356_RECORD> &aRecords,
                                                     d356_net_set );
         }
 
-        // Choose the best record type
-        int rktype;
-        if( rk.smd )
-            rktype = 327;
-        else
-        {
-            if( rk.mechanical )
-                rktype = 367;
-            else
-                rktype = 317;
-        }
+        d356_nets[i] = TO_UTF8( d356_net );
+    }
 
-        // Operation code, signal and component
-        fprintf( fout, "%03d%-14.14s   %-6.6s%c%-4.4s%c",
-                 rktype, TO_UTF8(d356_net),
-                 TO_UTF8(rk.refdes),
-                 rk.pin.empty()?' ':'-',
-                 TO_UTF8(rk.pin),
-                 rk.midpoint?'M':' ' );
+    unsigned blockCount = ( aRecords.size() + D356_RECORDS_PER_TASK - 1 )
+                          / D356_RECORDS_PER_TASK;
+    boost::ptr_vector<STRING_FORMATTER> blocks;
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
 
-        // Hole definition
-        if( rk.hole )
-        {
-            fprintf( fout, "D%04d%c",
-                     iu_to_d356( rk.drill, 9999 ),
-                     rk.mechanical ? 'U':'P' );
-        }
-        else
-            fprintf( fout, "      " );
+    for( unsigned i = 0; i < blockCount; i++ )
+        blocks.push_back( new STRING_FORMATTER );
 
-        // Test point access
-        fprintf( fout, "A%02dX%+07dY%+07dX%04dY%04dR%03d",
-                rk.access,
-                iu_to_d356( rk.x_location, 999999 ),
-                iu_to_d356( rk.y_location, 999999 ),
-                iu_to_d356( rk.x_size, 9999 ),
-                iu_to_d356( rk.y_size, 9999 ),
-                rk.rotation );
+    for( unsigned i = 0; i < blockCount; i++ )
+    {
+        unsigned first = i * D356_RECORDS_PER_TASK;
+        unsigned last = std::min( first + D356_RECORDS_PER_TASK,
+                                  (unsigned) aRecords.size() );
 
-        // Soldermask
-        fprintf( fout, "S%d\n", rk.soldermask );
+        tasks.Run( boost::bind( &format_D356_records, &aRecords, &d356_nets,
+                                first, last, &blocks[i] ) );
+    }
+
+    tasks.Wait();
+
+    // The blocks are written in order, the file is the same as a sequential one
+    for( unsigned i = 0; i < blockCount; i++ )
+    {
+        const std::string& text = blocks[i].GetString();
+
+        aOut->Write( 0, text.c_str(), text.size() );
     }
 }
 
@@ -353,7 +410,6 @@ void PCB_EDIT_FRAME::GenD356File( wxCommandEvent& aEvent )
 {
     wxFileName  fn = GetBoard()->GetFileName();
     wxString    msg, ext, wildcard;
-    FILE*       file;
 
     ext = wxT( "d356" );
     wildcard = _( "IPC-D-356 Test Files (.d356)|*.d356" );
@@ -368,12 +424,16 @@ void PCB_EDIT_FRAME::GenD356File( wxCommandEvent& aEvent )
     if( dlg.ShowModal() == wxID_CANCEL )
         return;
 
-    if( ( file = wxFopen( dlg.GetPath(), wxT( "wt" ) ) ) == NULL )
+    if( !DoGenD356File( dlg.GetPath() ) )
     {
         msg = _( "Unable to create " ) + dlg.GetPath();
         DisplayError( this, msg ); return;
     }
+}
+
 
+bool PCB_EDIT_FRAME::DoGenD356File( const wxString& aFullFileName )
+{
     LOCALE_IO       toggle;     // Switch the locale to standard C
 
     // This will contain everything needed for the 356 file
@@ -384,14 +444,23 @@ void PCB_EDIT_FRAME::GenD356File( wxCommandEvent& aEvent )
 
     build_pad_testpoints( pcb, d356_records );
 
-    // Code 00 AFAIK is ASCII, CUST 0 is decimils/degrees
-    // CUST 1 would be metric but gerbtool simply ignores it!
-    fprintf( file, "P  CODE 00\n" );
-    fprintf( file, "P  UNITS CUST 0\n" );
-    fprintf( file, "P  DIM   N\n" );
-    write_D356_records( d356_records, file );
-    fprintf( file, "999\n" );
+    try
+    {
+        // Buffered, as the board files
+        FILE_OUTPUTFORMATTER file( aFullFileName, wxT( "wt" ) );
+
+        // Code 00 AFAIK is ASCII, CUST 0 is decimils/degrees
+        // CUST 1 would be metric but gerbtool simply ignores it!
+        file.Print( 0, "P  CODE 00\n" );
+        file.Print( 0, "P  UNITS CUST 0\n" );
+        file.Print( 0, "P  DIM   N\n" );
+        write_D356_records( d356_records, &file );
+        file.Print( 0, "999\n" );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
 
-    fclose( file );
+    return true;
 }
-
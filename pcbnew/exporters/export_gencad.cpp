@@ -46,18 +46,25 @@
 #include <class_track.h>
 #include <class_edge_mod.h>
 
-
-static bool CreateHeaderInfoData( FILE* aFile, PCB_EDIT_FRAME* frame );
-static void CreateArtworksSection( FILE* aFile );
-static void CreateTracksInfoData( FILE* aFile, BOARD* aPcb );
-static void CreateBoardSection( FILE* aFile, BOARD* aPcb );
-static void CreateComponentsSection( FILE* aFile, BOARD* aPcb );
-static void CreateDevicesSection( FILE* aFile, BOARD* aPcb );
-static void CreateRoutesSection( FILE* aFile, BOARD* aPcb );
-static void CreateSignalsSection( FILE* aFile, BOARD* aPcb );
-static void CreateShapesSection( FILE* aFile, BOARD* aPcb );
-static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb );
-static void FootprintWriteShape( FILE* File, MODULE* module );
+#include <richio.h>
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
+
+static bool CreateHeaderInfoData( OUTPUTFORMATTER* aFile, PCB_EDIT_FRAME* frame );
+static void CreateArtworksSection( OUTPUTFORMATTER* aFile );
+static void CreateTracksInfoData( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static void CreateBoardSection( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static void CreateComponentsSection( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static void CreateDevicesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static void CreateRoutesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static void CreateSignalsSection( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static void CreateShapesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static void CreatePadsShapesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb );
+static bool FootprintWriteShape( OUTPUTFORMATTER* aFile, MODULE* module );
 
 // layer names for Gencad export
 
@@ -244,7 +251,6 @@ static double MapYTo( int aY )
 void PCB_EDIT_FRAME::ExportToGenCAD( wxCommandEvent& aEvent )
 {
     wxFileName  fn = GetBoard()->GetFileName();
-    FILE*       file;
 
     wxString    ext = wxT( "cad" );
     wxString    wildcard = _( "GenCAD 1.4 board files (.cad)|*.cad" );
@@ -260,7 +266,14 @@ void PCB_EDIT_FRAME::ExportToGenCAD( wxCommandEvent& aEvent )
     if( dlg.ShowModal() == wxID_CANCEL )
         return;
 
-    if( ( file = wxFopen( dlg.GetPath(), wxT( "wt" ) ) ) == NULL )
+    // The sections are written through a buffered formatter, as the board files
+    boost::scoped_ptr<FILE_OUTPUTFORMATTER> file;
+
+    try
+    {
+        file.reset( new FILE_OUTPUTFORMATTER( dlg.GetPath(), wxT( "wt" ) ) );
+    }
+    catch( const IO_ERROR& )
     {
         wxString    msg;
 
@@ -305,25 +318,32 @@ void PCB_EDIT_FRAME::ExportToGenCAD( wxCommandEvent& aEvent )
      *  need the padstack section (which is optional) anyway. Also the
      *  order of the section *is* important */
 
-    CreateHeaderInfoData( file, this );     // Gencad header
-    CreateBoardSection( file, pcb );        // Board perimeter
+    try
+    {
+        CreateHeaderInfoData( file.get(), this );   // Gencad header
+        CreateBoardSection( file.get(), pcb );      // Board perimeter
 
-    CreatePadsShapesSection( file, pcb );   // Pads and padstacks
-    CreateArtworksSection( file );          // Empty but mandatory
+        CreatePadsShapesSection( file.get(), pcb ); // Pads and padstacks
+        CreateArtworksSection( file.get() );        // Empty but mandatory
 
-    /* Gencad splits a component info in shape, component and device.
-     *  We don't do any sharing (it would be difficult since each module is
-     *  customizable after placement) */
-    CreateShapesSection( file, pcb );
-    CreateComponentsSection( file, pcb );
-    CreateDevicesSection( file, pcb );
+        /* Gencad splits a component info in shape, component and device.
+         *  We don't do any sharing (it would be difficult since each module is
+         *  customizable after placement) */
+        CreateShapesSection( file.get(), pcb );
+        CreateComponentsSection( file.get(), pcb );
+        CreateDevicesSection( file.get(), pcb );
 
-    // In a similar way the netlist is split in net, track and route
-    CreateSignalsSection( file, pcb );
-    CreateTracksInfoData( file, pcb );
-    CreateRoutesSection( file, pcb );
+        // In a similar way the netlist is split in net, track and route
+        CreateSignalsSection( file.get(), pcb );
+        CreateTracksInfoData( file.get(), pcb );
+        CreateRoutesSection( file.get(), pcb );
 
-    fclose( file );
+        file.reset();
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        DisplayError( this, ioe.errorText );
+    }
 
     // Undo the footprints modifications (flipped footprints)
     for( module = pcb->m_Modules; module; module = module->Next() )
@@ -367,17 +387,17 @@ static int ViaSort( const void* aRefptr, const void* aObjptr )
 
 
 // The ARTWORKS section is empty but (officially) mandatory
-static void CreateArtworksSection( FILE* aFile )
+static void CreateArtworksSection( OUTPUTFORMATTER* aFile )
 {
     /* The artworks section is empty */
-    fputs( "$ARTWORKS\n", aFile );
-    fputs( "$ENDARTWORKS\n\n", aFile );
+    aFile->Print( 0, "$ARTWORKS\n" );
+    aFile->Print( 0, "$ENDARTWORKS\n\n" );
 }
 
 
 // Emit PADS and PADSTACKS. They are sorted and emitted uniquely.
 // Via name is synthesized from their attributes, pads are numbered
-static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
+static void CreatePadsShapesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb )
 {
     std::vector<D_PAD*> pads;
     std::vector<D_PAD*> padstacks;
@@ -390,7 +410,7 @@ static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
     LSET    master_layermask = aPcb->GetDesignSettings().GetEnabledLayers();
     int     cu_count = aPcb->GetCopperLayerCount();
 
-    fputs( "$PADS\n", aFile );
+    aFile->Print( 0, "$PADS\n" );
 
     // Enumerate and sort the pads
     if( aPcb->GetPadCount() > 0 )
@@ -421,11 +441,11 @@ static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
 
         old_via = via;
         viastacks.push_back( via );
-        fprintf( aFile, "PAD V%d.%d.%s ROUND %g\nCIRCLE 0 0 %g\n",
-                via->GetWidth(), via->GetDrillValue(),
-                fmt_mask( via->GetLayerSet() ).c_str(),
-                via->GetDrillValue() / SCALE_FACTOR,
-                via->GetWidth() / (SCALE_FACTOR * 2) );
+        aFile->Print( 0, "PAD V%d.%d.%s ROUND %g\nCIRCLE 0 0 %g\n",
+                     via->GetWidth(), via->GetDrillValue(),
+                     fmt_mask( via->GetLayerSet() ).c_str(),
+                     via->GetDrillValue() / SCALE_FACTOR,
+                     via->GetWidth() / (SCALE_FACTOR * 2) );
     }
 
     // Emit component pads
@@ -446,7 +466,7 @@ static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
         pad_name_number++;
         pad->SetSubRatsnest( pad_name_number );
 
-        fprintf( aFile, "PAD P%d", pad->GetSubRatsnest() );
+        aFile->Print( 0, "PAD P%d", pad->GetSubRatsnest() );
 
         padstacks.push_back( pad ); // Will have its own padstack later
         int dx = pad->GetSize().x / 2;
@@ -456,110 +476,110 @@ static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
         {
         default:
         case PAD_SHAPE_CIRCLE:
-            fprintf( aFile, " ROUND %g\n",
-                     pad->GetDrillSize().x / SCALE_FACTOR );
+            aFile->Print( 0, " ROUND %g\n",
+                          pad->GetDrillSize().x / SCALE_FACTOR );
             /* Circle is center, radius */
-            fprintf( aFile, "CIRCLE %g %g %g\n",
-                    pad->GetOffset().x / SCALE_FACTOR,
-                    -pad->GetOffset().y / SCALE_FACTOR,
-                    pad->GetSize().x / (SCALE_FACTOR * 2) );
+            aFile->Print( 0, "CIRCLE %g %g %g\n",
+                         pad->GetOffset().x / SCALE_FACTOR,
+                         -pad->GetOffset().y / SCALE_FACTOR,
+                         pad->GetSize().x / (SCALE_FACTOR * 2) );
             break;
 
         case PAD_SHAPE_RECT:
-            fprintf( aFile, " RECTANGULAR %g\n",
-                     pad->GetDrillSize().x / SCALE_FACTOR );
+            aFile->Print( 0, " RECTANGULAR %g\n",
+                          pad->GetDrillSize().x / SCALE_FACTOR );
 
             // Rectangle is begin, size *not* begin, end!
-            fprintf( aFile, "RECTANGLE %g %g %g %g\n",
-                    (-dx + pad->GetOffset().x ) / SCALE_FACTOR,
-                    (-dy - pad->GetOffset().y ) / SCALE_FACTOR,
-                    dx / (SCALE_FACTOR / 2), dy / (SCALE_FACTOR / 2) );
+            aFile->Print( 0, "RECTANGLE %g %g %g %g\n",
+                         (-dx + pad->GetOffset().x ) / SCALE_FACTOR,
+                         (-dy - pad->GetOffset().y ) / SCALE_FACTOR,
+                         dx / (SCALE_FACTOR / 2), dy / (SCALE_FACTOR / 2) );
             break;
 
         case PAD_SHAPE_OVAL:     // Create outline by 2 lines and 2 arcs
             {
                 // OrCAD Layout call them OVAL or OBLONG - GenCAD call them FINGERs
-                fprintf( aFile, " FINGER %g\n",
-                         pad->GetDrillSize().x / SCALE_FACTOR );
+                aFile->Print( 0, " FINGER %g\n",
+                              pad->GetDrillSize().x / SCALE_FACTOR );
                 int dr = dx - dy;
 
                 if( dr >= 0 )       // Horizontal oval
                 {
                     int radius = dy;
-                    fprintf( aFile, "LINE %g %g %g %g\n",
-                             (-dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - radius) / SCALE_FACTOR,
-                             (dr + pad->GetOffset().x ) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - radius) / SCALE_FACTOR );
+                    aFile->Print( 0, "LINE %g %g %g %g\n",
+                                  (-dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - radius) / SCALE_FACTOR,
+                                  (dr + pad->GetOffset().x ) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - radius) / SCALE_FACTOR );
 
                     // GenCAD arcs are (start, end, center)
-                    fprintf( aFile, "ARC %g %g %g %g %g %g\n",
-                             (dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - radius) / SCALE_FACTOR,
-                             (dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + radius) / SCALE_FACTOR,
-                             (dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             -pad->GetOffset().y / SCALE_FACTOR );
-
-                    fprintf( aFile, "LINE %g %g %g %g\n",
-                             (dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + radius) / SCALE_FACTOR,
-                             (-dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + radius) / SCALE_FACTOR );
-                    fprintf( aFile, "ARC %g %g %g %g %g %g\n",
-                             (-dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + radius) / SCALE_FACTOR,
-                             (-dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - radius) / SCALE_FACTOR,
-                             (-dr + pad->GetOffset().x) / SCALE_FACTOR,
-                             -pad->GetOffset().y / SCALE_FACTOR );
+                    aFile->Print( 0, "ARC %g %g %g %g %g %g\n",
+                                  (dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - radius) / SCALE_FACTOR,
+                                  (dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + radius) / SCALE_FACTOR,
+                                  (dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  -pad->GetOffset().y / SCALE_FACTOR );
+
+                    aFile->Print( 0, "LINE %g %g %g %g\n",
+                                  (dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + radius) / SCALE_FACTOR,
+                                  (-dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + radius) / SCALE_FACTOR );
+                    aFile->Print( 0, "ARC %g %g %g %g %g %g\n",
+                                  (-dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + radius) / SCALE_FACTOR,
+                                  (-dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - radius) / SCALE_FACTOR,
+                                  (-dr + pad->GetOffset().x) / SCALE_FACTOR,
+                                  -pad->GetOffset().y / SCALE_FACTOR );
                 }
                 else        // Vertical oval
                 {
                     dr = -dr;
                     int radius = dx;
-                    fprintf( aFile, "LINE %g %g %g %g\n",
-                             (-radius + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - dr) / SCALE_FACTOR,
-                             (-radius + pad->GetOffset().x ) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + dr) / SCALE_FACTOR );
-                    fprintf( aFile, "ARC %g %g %g %g %g %g\n",
-                             (-radius + pad->GetOffset().x ) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + dr) / SCALE_FACTOR,
-                             (radius + pad->GetOffset().x ) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + dr) / SCALE_FACTOR,
-                             pad->GetOffset().x / SCALE_FACTOR,
-                             (-pad->GetOffset().y + dr) / SCALE_FACTOR );
-
-                    fprintf( aFile, "LINE %g %g %g %g\n",
-                             (radius + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y + dr) / SCALE_FACTOR,
-                             (radius + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - dr) / SCALE_FACTOR );
-                    fprintf( aFile, "ARC %g %g %g %g %g %g\n",
-                             (radius + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - dr) / SCALE_FACTOR,
-                             (-radius + pad->GetOffset().x) / SCALE_FACTOR,
-                             (-pad->GetOffset().y - dr) / SCALE_FACTOR,
-                             pad->GetOffset().x / SCALE_FACTOR,
-                             (-pad->GetOffset().y - dr) / SCALE_FACTOR );
+                    aFile->Print( 0, "LINE %g %g %g %g\n",
+                                  (-radius + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - dr) / SCALE_FACTOR,
+                                  (-radius + pad->GetOffset().x ) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + dr) / SCALE_FACTOR );
+                    aFile->Print( 0, "ARC %g %g %g %g %g %g\n",
+                                  (-radius + pad->GetOffset().x ) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + dr) / SCALE_FACTOR,
+                                  (radius + pad->GetOffset().x ) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + dr) / SCALE_FACTOR,
+                                  pad->GetOffset().x / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + dr) / SCALE_FACTOR );
+
+                    aFile->Print( 0, "LINE %g %g %g %g\n",
+                                  (radius + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y + dr) / SCALE_FACTOR,
+                                  (radius + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - dr) / SCALE_FACTOR );
+                    aFile->Print( 0, "ARC %g %g %g %g %g %g\n",
+                                  (radius + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - dr) / SCALE_FACTOR,
+                                  (-radius + pad->GetOffset().x) / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - dr) / SCALE_FACTOR,
+                                  pad->GetOffset().x / SCALE_FACTOR,
+                                  (-pad->GetOffset().y - dr) / SCALE_FACTOR );
                 }
             }
             break;
 
         case PAD_SHAPE_TRAPEZOID:
-            fprintf( aFile, " POLYGON %g\n",
-                     pad->GetDrillSize().x / SCALE_FACTOR );
+            aFile->Print( 0, " POLYGON %g\n",
+                          pad->GetDrillSize().x / SCALE_FACTOR );
 
             // XXX TO BE IMPLEMENTED! and I don't know if it could be actually imported by something
             break;
         }
     }
 
-    fputs( "\n$ENDPADS\n\n", aFile );
+    aFile->Print( 0, "\n$ENDPADS\n\n" );
 
     // Now emit the padstacks definitions, using the combined layer masks
-    fputs( "$PADSTACKS\n", aFile );
+    aFile->Print( 0, "$PADSTACKS\n" );
 
     // Via padstacks
     for( unsigned i = 0; i < viastacks.size(); i++ )
@@ -568,20 +588,20 @@ static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
 
         LSET mask = via->GetLayerSet() & master_layermask;
 
-        fprintf( aFile, "PADSTACK VIA%d.%d.%s %g\n",
-                 via->GetWidth(), via->GetDrillValue(),
-                 fmt_mask( mask ).c_str(),
-                 via->GetDrillValue() / SCALE_FACTOR );
+        aFile->Print( 0, "PADSTACK VIA%d.%d.%s %g\n",
+                      via->GetWidth(), via->GetDrillValue(),
+                      fmt_mask( mask ).c_str(),
+                      via->GetDrillValue() / SCALE_FACTOR );
 
         for( LSEQ seq = mask.Seq( gc_seq, DIM( gc_seq ) );  seq;  ++seq )
         {
             LAYER_ID layer = *seq;
 
-            fprintf( aFile, "PAD V%d.%d.%s %s 0 0\n",
-                    via->GetWidth(), via->GetDrillValue(),
-                    fmt_mask( mask ).c_str(),
-                    GenCADLayerName( cu_count, layer ).c_str()
-                    );
+            aFile->Print( 0, "PAD V%d.%d.%s %s 0 0\n",
+                         via->GetWidth(), via->GetDrillValue(),
+                         fmt_mask( mask ).c_str(),
+                         GenCADLayerName( cu_count, layer ).c_str()
+                         );
         }
     }
 
@@ -595,7 +615,7 @@ static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
         D_PAD* pad = padstacks[i];
 
         // Straight padstack
-        fprintf( aFile, "PADSTACK PAD%u %g\n", i, pad->GetDrillSize().x / SCALE_FACTOR );
+        aFile->Print( 0, "PADSTACK PAD%u %g\n", i, pad->GetDrillSize().x / SCALE_FACTOR );
 
         LSET pad_set = pad->GetLayerSet() & master_layermask;
 
@@ -604,169 +624,248 @@ static void CreatePadsShapesSection( FILE* aFile, BOARD* aPcb )
         {
             LAYER_ID layer = *seq;
 
-            fprintf( aFile, "PAD P%u %s 0 0\n", i, GenCADLayerName( cu_count, layer ).c_str() );
+            aFile->Print( 0, "PAD P%u %s 0 0\n", i, GenCADLayerName( cu_count, layer ).c_str() );
         }
 
         // Flipped padstack
-        fprintf( aFile, "PADSTACK PAD%uF %g\n", i, pad->GetDrillSize().x / SCALE_FACTOR );
+        aFile->Print( 0, "PADSTACK PAD%uF %g\n", i, pad->GetDrillSize().x / SCALE_FACTOR );
 
         // the normal LAYER_ID sequence is inverted from gc_seq[]
         for( LSEQ seq = pad_set.Seq();  seq;  ++seq )
         {
             LAYER_ID layer = *seq;
 
-            fprintf( aFile, "PAD P%u %s 0 0\n", i, GenCADLayerNameFlipped( cu_count, layer ).c_str() );
+            aFile->Print( 0, "PAD P%u %s 0 0\n", i,
+                          GenCADLayerNameFlipped( cu_count, layer ).c_str() );
         }
     }
 
-    fputs( "$ENDPADSTACKS\n\n", aFile );
+    aFile->Print( 0, "$ENDPADSTACKS\n\n" );
 }
 
 
-/* Creates the footprint shape list.
- * Since module shape is customizable after the placement we cannot share them;
- * instead we opt for the one-module-one-shape-one-component-one-device approach
+// Writes a footprint of a section, see writeModules()
+typedef bool (*MODULE_WRITER)( OUTPUTFORMATTER* aFile, MODULE* aModule );
+
+// The number of footprints formatted by each task
+#define MODULES_PER_TASK 64
+
+
+// The task formatting the footprints aFirst to aLast - 1 into aText
+static void formatModules( MODULE_WRITER aWriter, const std::vector<MODULE*>* aModules,
+                           unsigned aFirst, unsigned aLast, STRING_FORMATTER* aText, int* aFailed )
+{
+    for( unsigned ii = aFirst; ii < aLast; ii++ )
+    {
+        if( !aWriter( aText, (*aModules)[ii] ) )
+            ++*aFailed;
+    }
+}
+
+
+/**
+ * Function writeModules
+ * writes all the footprints of the board with aWriter, in the order of the board.
+ * The footprints are formatted by blocks on the threads of the process, and the text
+ * of the blocks is then written in order.  aWriter must only read the board.
+ * @return false if aWriter failed for a footprint.
  */
-static void CreateShapesSection( FILE* aFile, BOARD* aPcb )
+static bool writeModules( OUTPUTFORMATTER* aFile, BOARD* aPcb, MODULE_WRITER aWriter )
+{
+    std::vector<MODULE*> modules;
+
+    for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
+        modules.push_back( module );
+
+    unsigned                            blockCount = ( modules.size() + MODULES_PER_TASK - 1 )
+                                                     / MODULES_PER_TASK;
+    boost::ptr_vector<STRING_FORMATTER> blocks;
+    std::vector<int>                    failed( blockCount, 0 );
+    TASK_GROUP                          tasks( Pgm().GetThreadPool() );
+
+    for( unsigned ii = 0; ii < blockCount; ii++ )
+        blocks.push_back( new STRING_FORMATTER );
+
+    for( unsigned ii = 0; ii < blockCount; ii++ )
+    {
+        unsigned first = ii * MODULES_PER_TASK;
+        unsigned last = std::min( first + MODULES_PER_TASK, (unsigned) modules.size() );
+
+        tasks.Run( boost::bind( &formatModules, aWriter, &modules, first, last, &blocks[ii],
+                                &failed[ii] ) );
+    }
+
+    bool success = tasks.Wait();
+
+    for( unsigned ii = 0; ii < blockCount; ii++ )
+    {
+        const std::string& text = blocks[ii].GetString();
+
+        aFile->Write( 0, text.c_str(), text.size() );
+        success = success && failed[ii] == 0;
+    }
+
+    return success;
+}
+
+
+// Writes the shape of a footprint with its pins, see CreateShapesSection()
+static bool writeModuleShape( OUTPUTFORMATTER* aFile, MODULE* module )
 {
-    MODULE*     module;
     D_PAD*      pad;
     const char* layer;
     wxString    pinname;
     const char* mirror = "0";
 
-    fputs( "$SHAPES\n", aFile );
-
     const LSET all_cu = LSET::AllCuMask();
 
-    for( module = aPcb->m_Modules; module; module = module->Next() )
-    {
-        FootprintWriteShape( aFile, module );
+    bool ok = FootprintWriteShape( aFile, module );
 
-        for( pad = module->Pads(); pad; pad = pad->Next() )
+    for( pad = module->Pads(); pad; pad = pad->Next() )
+    {
+        /* Funny thing: GenCAD requires the pad side even if you use
+         *  padstacks (which are theorically optional but gerbtools
+         *requires* them). Now the trouble thing is that 'BOTTOM'
+         *  is interpreted by someone as a padstack flip even
+         *  if the spec explicitly says it's not... */
+        layer = "ALL";
+
+        if( ( pad->GetLayerSet() & all_cu ) == LSET( B_Cu ) )
         {
-            /* Funny thing: GenCAD requires the pad side even if you use
-             *  padstacks (which are theorically optional but gerbtools
-             *requires* them). Now the trouble thing is that 'BOTTOM'
-             *  is interpreted by someone as a padstack flip even
-             *  if the spec explicitly says it's not... */
-            layer = "ALL";
-
-            if( ( pad->GetLayerSet() & all_cu ) == LSET( B_Cu ) )
-            {
-                layer = module->GetFlag() ? "TOP" : "BOTTOM";
-            }
-            else if( ( pad->GetLayerSet() & all_cu ) == LSET( F_Cu ) )
-            {
-                layer = module->GetFlag() ? "BOTTOM" : "TOP";
-            }
+            layer = module->GetFlag() ? "TOP" : "BOTTOM";
+        }
+        else if( ( pad->GetLayerSet() & all_cu ) == LSET( F_Cu ) )
+        {
+            layer = module->GetFlag() ? "BOTTOM" : "TOP";
+        }
 
-            pad->StringPadName( pinname );
+        pad->StringPadName( pinname );
 
-            if( pinname.IsEmpty() )
-                pinname = wxT( "none" );
+        if( pinname.IsEmpty() )
+            pinname = wxT( "none" );
 
-            double orient = pad->GetOrientation() - module->GetOrientation();
-            NORMALIZE_ANGLE_POS( orient );
+        double orient = pad->GetOrientation() - module->GetOrientation();
+        NORMALIZE_ANGLE_POS( orient );
 
-            // Bottom side modules use the flipped padstack
-            fprintf( aFile, (module->GetFlag()) ?
-                     "PIN %s PAD%dF %g %g %s %g %s\n" :
-                     "PIN %s PAD%d %g %g %s %g %s\n",
-                     TO_UTF8( pinname ), pad->GetSubRatsnest(),
-                     pad->GetPos0().x / SCALE_FACTOR,
-                     -pad->GetPos0().y / SCALE_FACTOR,
-                     layer, orient / 10.0, mirror );
-        }
+        // Bottom side modules use the flipped padstack
+        aFile->Print( 0, (module->GetFlag()) ?
+                      "PIN %s PAD%dF %g %g %s %g %s\n" :
+                      "PIN %s PAD%d %g %g %s %g %s\n",
+                      TO_UTF8( pinname ), pad->GetSubRatsnest(),
+                      pad->GetPos0().x / SCALE_FACTOR,
+                      -pad->GetPos0().y / SCALE_FACTOR,
+                      layer, orient / 10.0, mirror );
     }
 
-    fputs( "$ENDSHAPES\n\n", aFile );
+    return ok;
 }
 
 
-/* Creates the section $COMPONENTS (Footprints placement)
- * Bottom side components are difficult to handle: shapes must be mirrored or
- * flipped, silk layers need to be handled correctly and so on. Also it seems
- * that *noone* follows the specs...
+/* Creates the footprint shape list.
+ * Since module shape is customizable after the placement we cannot share them;
+ * instead we opt for the one-module-one-shape-one-component-one-device approach
  */
-static void CreateComponentsSection( FILE* aFile, BOARD* aPcb )
+static void CreateShapesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb )
 {
-    fputs( "$COMPONENTS\n", aFile );
+    aFile->Print( 0, "$SHAPES\n" );
 
-    int cu_count = aPcb->GetCopperLayerCount();
+    // The footprints are formatted on worker threads: the error is shown once, after
+    if( !writeModules( aFile, aPcb, &writeModuleShape ) )
+        DisplayError( NULL, wxT( "Type Edge Module invalid." ) );
 
-    for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
-    {
-        const char*   mirror;
-        const char*   flip;
-        double        fp_orient = module->GetOrientation();
+    aFile->Print( 0, "$ENDSHAPES\n\n" );
+}
 
-        if( module->GetFlag() )
-        {
-            mirror = "0";
-            flip   = "FLIP";
-            NEGATE_AND_NORMALIZE_ANGLE_POS( fp_orient );
-        }
-        else
-        {
-            mirror = "0";
-            flip   = "0";
-        }
 
-        fprintf( aFile, "\nCOMPONENT %s\n",
-                 TO_UTF8( module->GetReference() ) );
-        fprintf( aFile, "DEVICE %s_%s\n",
-                 TO_UTF8( module->GetReference() ),
-                 TO_UTF8( module->GetValue() ) );
-        fprintf( aFile, "PLACE %g %g\n",
-                 MapXTo( module->GetPosition().x ),
-                 MapYTo( module->GetPosition().y ) );
-        fprintf( aFile, "LAYER %s\n",
-                 (module->GetFlag()) ? "BOTTOM" : "TOP" );
-        fprintf( aFile, "ROTATION %g\n",
-                 fp_orient / 10.0 );
-        fprintf( aFile, "SHAPE %s %s %s\n",
-                 TO_UTF8( module->GetReference() ),
-                 mirror, flip );
-
-        // Text on silk layer: RefDes and value (are they actually useful?)
-        TEXTE_MODULE *textmod = &module->Reference();
-
-        for( int ii = 0; ii < 2; ii++ )
-        {
-            double      txt_orient = textmod->GetOrientation();
-            std::string layer  = GenCADLayerName( cu_count, module->GetFlag() ? B_SilkS : F_SilkS );
-
-            fprintf( aFile, "TEXT %g %g %g %g %s %s \"%s\"",
-                     textmod->GetPos0().x / SCALE_FACTOR,
-                    -textmod->GetPos0().y / SCALE_FACTOR,
-                     textmod->GetSize().x / SCALE_FACTOR,
-                     txt_orient / 10.0,
-                     mirror,
-                     layer.c_str(),
-                     TO_UTF8( textmod->GetText() ) );
-
-            // Please note, the width is approx
-            fprintf( aFile, " 0 0 %g %g\n",
-                     ( textmod->GetSize().x * textmod->GetLength() ) / SCALE_FACTOR,
-                     textmod->GetSize().y / SCALE_FACTOR );
-
-            textmod = &module->Value(); // Dirty trick for the second iteration
-        }
+// Writes the placement of a footprint, see CreateComponentsSection()
+static bool writeComponent( OUTPUTFORMATTER* aFile, MODULE* module )
+{
+    int cu_count = module->GetBoard()->GetCopperLayerCount();
+
+    const char*   mirror;
+    const char*   flip;
+    double        fp_orient = module->GetOrientation();
+
+    if( module->GetFlag() )
+    {
+        mirror = "0";
+        flip   = "FLIP";
+        NEGATE_AND_NORMALIZE_ANGLE_POS( fp_orient );
+    }
+    else
+    {
+        mirror = "0";
+        flip   = "0";
+    }
 
-        // The SHEET is a 'generic description' for referencing the component
-        fprintf( aFile, "SHEET \"RefDes: %s, Value: %s\"\n",
-                 TO_UTF8( module->GetReference() ),
-                 TO_UTF8( module->GetValue() ) );
+    aFile->Print( 0, "\nCOMPONENT %s\n",
+                  TO_UTF8( module->GetReference() ) );
+    aFile->Print( 0, "DEVICE %s_%s\n",
+                  TO_UTF8( module->GetReference() ),
+                  TO_UTF8( module->GetValue() ) );
+    aFile->Print( 0, "PLACE %g %g\n",
+                  MapXTo( module->GetPosition().x ),
+                  MapYTo( module->GetPosition().y ) );
+    aFile->Print( 0, "LAYER %s\n",
+                  (module->GetFlag()) ? "BOTTOM" : "TOP" );
+    aFile->Print( 0, "ROTATION %g\n",
+                  fp_orient / 10.0 );
+    aFile->Print( 0, "SHAPE %s %s %s\n",
+                  TO_UTF8( module->GetReference() ),
+                  mirror, flip );
+
+    // Text on silk layer: RefDes and value (are they actually useful?)
+    TEXTE_MODULE *textmod = &module->Reference();
+
+    for( int ii = 0; ii < 2; ii++ )
+    {
+        double      txt_orient = textmod->GetOrientation();
+        std::string layer  = GenCADLayerName( cu_count, module->GetFlag() ? B_SilkS : F_SilkS );
+
+        aFile->Print( 0, "TEXT %g %g %g %g %s %s \"%s\"",
+                      textmod->GetPos0().x / SCALE_FACTOR,
+                     -textmod->GetPos0().y / SCALE_FACTOR,
+                      textmod->GetSize().x / SCALE_FACTOR,
+                      txt_orient / 10.0,
+                      mirror,
+                      layer.c_str(),
+                      TO_UTF8( textmod->GetText() ) );
+
+        // Please note, the width is approx
+        aFile->Print( 0, " 0 0 %g %g\n",
+                      ( textmod->GetSize().x * textmod->GetLength() ) / SCALE_FACTOR,
+                      textmod->GetSize().y / SCALE_FACTOR );
+
+        textmod = &module->Value(); // Dirty trick for the second iteration
     }
 
-    fputs( "$ENDCOMPONENTS\n\n", aFile );
+    // The SHEET is a 'generic description' for referencing the component
+    aFile->Print( 0, "SHEET \"RefDes: %s, Value: %s\"\n",
+                  TO_UTF8( module->GetReference() ),
+                  TO_UTF8( module->GetValue() ) );
+
+    return true;
+}
+
+
+/* Creates the section $COMPONENTS (Footprints placement)
+ * Bottom side components are difficult to handle: shapes must be mirrored or
+ * flipped, silk layers need to be handled correctly and so on. Also it seems
+ * that *noone* follows the specs...
+ */
+static void CreateComponentsSection( OUTPUTFORMATTER* aFile, BOARD* aPcb )
+{
+    aFile->Print( 0, "$COMPONENTS\n" );
+
+    writeModules( aFile, aPcb, &writeComponent );
+
+    aFile->Print( 0, "$ENDCOMPONENTS\n\n" );
 }
 
 
 /* Emit the netlist (which is actually the thing for which GenCAD is used these
  * days!); tracks are handled later */
-static void CreateSignalsSection( FILE* aFile, BOARD* aPcb )
+static void CreateSignalsSection( OUTPUTFORMATTER* aFile, BOARD* aPcb )
 {
     wxString      msg;
     NETINFO_ITEM* net;
@@ -774,7 +873,19 @@ static void CreateSignalsSection( FILE* aFile, BOARD* aPcb )
     MODULE*       module;
     int           NbNoConn = 1;
 
-    fputs( "$SIGNALS\n", aFile );
+    // The pads of each net, in the order of the board, gathered in one pass
+    std::vector< std::vector<D_PAD*> > netPads( aPcb->GetNetCount() );
+
+    for( module = aPcb->m_Modules; module; module = module->Next() )
+    {
+        for( pad = module->Pads(); pad; pad = pad->Next() )
+        {
+            if( pad->GetNetCode() > 0 && pad->GetNetCode() < (int) netPads.size() )
+                netPads[pad->GetNetCode()].push_back( pad );
+        }
+    }
+
+    aFile->Print( 0, "$SIGNALS\n" );
 
     for( unsigned ii = 0; ii < aPcb->GetNetCount(); ii++ )
     {
@@ -790,65 +901,65 @@ static void CreateSignalsSection( FILE* aFile, BOARD* aPcb )
 
         msg = wxT( "SIGNAL " ) + net->GetNetname();
 
-        fputs( TO_UTF8( msg ), aFile );
-        fputs( "\n", aFile );
+        aFile->Print( 0, "%s", TO_UTF8( msg ) );
+        aFile->Print( 0, "\n" );
 
-        for( module = aPcb->m_Modules; module; module = module->Next() )
-        {
-            for( pad = module->Pads(); pad; pad = pad->Next() )
-            {
-                wxString padname;
+        if( net->GetNet() >= (int) netPads.size() )
+            continue;
 
-                if( pad->GetNetCode() != net->GetNet() )
-                    continue;
+        const std::vector<D_PAD*>& pads = netPads[net->GetNet()];
 
-                pad->StringPadName( padname );
-                msg.Printf( wxT( "NODE %s %s" ),
-                            GetChars( module->GetReference() ),
-                            GetChars( padname ) );
+        for( unsigned jj = 0; jj < pads.size(); jj++ )
+        {
+            wxString padname;
 
-                fputs( TO_UTF8( msg ), aFile );
-                fputs( "\n", aFile );
-            }
+            pad = pads[jj];
+            pad->StringPadName( padname );
+            msg.Printf( wxT( "NODE %s %s" ),
+                        GetChars( pad->GetParent()->GetReference() ),
+                        GetChars( padname ) );
+
+            aFile->Print( 0, "%s", TO_UTF8( msg ) );
+            aFile->Print( 0, "\n" );
         }
     }
 
-    fputs( "$ENDSIGNALS\n\n", aFile );
+    aFile->Print( 0, "$ENDSIGNALS\n\n" );
 }
 
 
 // Creates the header section
-static bool CreateHeaderInfoData( FILE* aFile, PCB_EDIT_FRAME* aFrame )
+static bool CreateHeaderInfoData( OUTPUTFORMATTER* aFile, PCB_EDIT_FRAME* aFrame )
 {
     wxString    msg;
     BOARD *board = aFrame->GetBoard();
 
-    fputs( "$HEADER\n", aFile );
-    fputs( "GENCAD 1.4\n", aFile );
+    aFile->Print( 0, "$HEADER\n" );
+    aFile->Print( 0, "GENCAD 1.4\n" );
 
     // Please note: GenCAD syntax requires quoted strings if they can contain spaces
     msg.Printf( wxT( "USER \"%s %s\"\n" ),
                GetChars( Pgm().App().GetAppName() ),
                GetChars( GetBuildVersion() ) );
-    fputs( TO_UTF8( msg ), aFile );
+    aFile->Print( 0, "%s", TO_UTF8( msg ) );
 
     msg = wxT( "DRAWING \"" ) + board->GetFileName() + wxT( "\"\n" );
-    fputs( TO_UTF8( msg ), aFile );
+    aFile->Print( 0, "%s", TO_UTF8( msg ) );
 
     const TITLE_BLOCK&  tb = aFrame->GetTitleBlock();
 
     msg = wxT( "REVISION \"" ) + tb.GetRevision() + wxT( " " ) + tb.GetDate() + wxT( "\"\n" );
 
-    fputs( TO_UTF8( msg ), aFile );
-    fputs( "UNITS INCH\n", aFile );
+    aFile->Print( 0, "%s", TO_UTF8( msg ) );
+    aFile->Print( 0, "UNITS INCH\n" );
 
     msg.Printf( wxT( "ORIGIN %g %g\n" ),
                 MapXTo( aFrame->GetAuxOrigin().x ),
                 MapYTo( aFrame->GetAuxOrigin().y ) );
-    fputs( TO_UTF8( msg ), aFile );
+    aFile->Print( 0, "%s", TO_UTF8( msg ) );
 
-    fputs( "INTERTRACK 0\n", aFile );
-    fputs( "$ENDHEADER\n\n", aFile );
+    aFile->Print( 0, "INTERTRACK 0\n" );
+    aFile->Print( 0, "$ENDHEADER\n\n" );
 
     return true;
 }
@@ -888,7 +999,7 @@ static int TrackListSortByNetcode( const void* refptr, const void* objptr )
  *  $ENROUTE
  *  Track segments must be sorted by nets
  */
-static void CreateRoutesSection( FILE* aFile, BOARD* aPcb )
+static void CreateRoutesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb )
 {
     TRACK*  track, ** tracklist;
     int     vianum = 1;
@@ -927,7 +1038,7 @@ static void CreateRoutesSection( FILE* aFile, BOARD* aPcb )
 
     qsort( tracklist, nbitems, sizeof(TRACK*), TrackListSortByNetcode );
 
-    fputs( "$ROUTES\n", aFile );
+    aFile->Print( 0, "$ROUTES\n" );
 
     old_netcode = -1; old_width = -1; old_layer = -1;
 
@@ -946,13 +1057,13 @@ static void CreateRoutesSection( FILE* aFile, BOARD* aPcb )
             else
                 netname = wxT( "_noname_" );
 
-            fprintf( aFile, "ROUTE %s\n", TO_UTF8( netname ) );
+            aFile->Print( 0, "ROUTE %s\n", TO_UTF8( netname ) );
         }
 
         if( old_width != track->GetWidth() )
         {
             old_width = track->GetWidth();
-            fprintf( aFile, "TRACK TRACK%d\n", track->GetWidth() );
+            aFile->Print( 0, "TRACK TRACK%d\n", track->GetWidth() );
         }
 
         if( (track->Type() == PCB_TRACE_T) || (track->Type() == PCB_ZONE_T) )
@@ -960,14 +1071,14 @@ static void CreateRoutesSection( FILE* aFile, BOARD* aPcb )
             if( old_layer != track->GetLayer() )
             {
                 old_layer = track->GetLayer();
-                fprintf( aFile, "LAYER %s\n",
-                        GenCADLayerName( cu_count, track->GetLayer() ).c_str()
-                        );
+                aFile->Print( 0, "LAYER %s\n",
+                             GenCADLayerName( cu_count, track->GetLayer() ).c_str()
+                             );
             }
 
-            fprintf( aFile, "LINE %g %g %g %g\n",
-                    MapXTo( track->GetStart().x ), MapYTo( track->GetStart().y ),
-                    MapXTo( track->GetEnd().x ), MapYTo( track->GetEnd().y ) );
+            aFile->Print( 0, "LINE %g %g %g %g\n",
+                         MapXTo( track->GetStart().x ), MapYTo( track->GetStart().y ),
+                         MapXTo( track->GetEnd().x ), MapYTo( track->GetEnd().y ) );
         }
 
         if( track->Type() == PCB_VIA_T )
@@ -976,15 +1087,15 @@ static void CreateRoutesSection( FILE* aFile, BOARD* aPcb )
 
             LSET vset = via->GetLayerSet() & master_layermask;
 
-            fprintf( aFile, "VIA VIA%d.%d.%s %g %g ALL %g via%d\n",
-                     via->GetWidth(), via->GetDrillValue(),
-                     fmt_mask( vset ).c_str(),
-                     MapXTo( via->GetStart().x ), MapYTo( via->GetStart().y ),
-                     via->GetDrillValue() / SCALE_FACTOR, vianum++ );
+            aFile->Print( 0, "VIA VIA%d.%d.%s %g %g ALL %g via%d\n",
+                          via->GetWidth(), via->GetDrillValue(),
+                          fmt_mask( vset ).c_str(),
+                          MapXTo( via->GetStart().x ), MapYTo( via->GetStart().y ),
+                          via->GetDrillValue() / SCALE_FACTOR, vianum++ );
         }
     }
 
-    fputs( "$ENDROUTES\n\n", aFile );
+    aFile->Print( 0, "$ENDROUTES\n\n" );
 
     delete tracklist;
 }
@@ -994,17 +1105,17 @@ static void CreateRoutesSection( FILE* aFile, BOARD* aPcb )
  * This is a list of footprints properties
  *  ( Shapes are in section $SHAPE )
  */
-static void CreateDevicesSection( FILE* aFile, BOARD* aPcb )
+static void CreateDevicesSection( OUTPUTFORMATTER* aFile, BOARD* aPcb )
 {
     MODULE* module;
 
-    fputs( "$DEVICES\n", aFile );
+    aFile->Print( 0, "$DEVICES\n" );
 
     for( module = aPcb->m_Modules; module; module = module->Next() )
     {
-        fprintf( aFile, "DEVICE \"%s\"\n", TO_UTF8( module->GetReference() ) );
-        fprintf( aFile, "PART \"%s\"\n", TO_UTF8( module->GetValue() ) );
-        fprintf( aFile, "PACKAGE \"%s\"\n", module->GetFPID().Format().c_str() );
+        aFile->Print( 0, "DEVICE \"%s\"\n", TO_UTF8( module->GetReference() ) );
+        aFile->Print( 0, "PART \"%s\"\n", TO_UTF8( module->GetValue() ) );
+        aFile->Print( 0, "PACKAGE \"%s\"\n", module->GetFPID().Format().c_str() );
 
         // The TYPE attribute is almost freeform
         const char* ty = "TH";
@@ -1015,19 +1126,19 @@ static void CreateDevicesSection( FILE* aFile, BOARD* aPcb )
         if( module->GetAttributes() & MOD_VIRTUAL )
             ty = "VIRTUAL";
 
-        fprintf( aFile, "TYPE %s\n", ty );
+        aFile->Print( 0, "TYPE %s\n", ty );
     }
 
-    fputs( "$ENDDEVICES\n\n", aFile );
+    aFile->Print( 0, "$ENDDEVICES\n\n" );
 }
 
 
 /* Creates the section $BOARD.
  *  We output here only the board perimeter
  */
-static void CreateBoardSection( FILE* aFile, BOARD* aPcb )
+static void CreateBoardSection( OUTPUTFORMATTER* aFile, BOARD* aPcb )
 {
-    fputs( "$BOARD\n", aFile );
+    aFile->Print( 0, "$BOARD\n" );
 
     // Extract the board edges
     for( EDA_ITEM* drawing = aPcb->m_Drawings; drawing != 0;
@@ -1039,14 +1150,14 @@ static void CreateBoardSection( FILE* aFile, BOARD* aPcb )
             if( drawseg->GetLayer() == Edge_Cuts )
             {
                 // XXX GenCAD supports arc boundaries but I've seen nothing that reads them
-                fprintf( aFile, "LINE %g %g %g %g\n",
-                         MapXTo( drawseg->GetStart().x ), MapYTo( drawseg->GetStart().y ),
-                         MapXTo( drawseg->GetEnd().x ), MapYTo( drawseg->GetEnd().y ) );
+                aFile->Print( 0, "LINE %g %g %g %g\n",
+                              MapXTo( drawseg->GetStart().x ), MapYTo( drawseg->GetStart().y ),
+                              MapXTo( drawseg->GetEnd().x ), MapYTo( drawseg->GetEnd().y ) );
             }
         }
     }
 
-    fputs( "$ENDBOARD\n\n", aFile );
+    aFile->Print( 0, "$ENDBOARD\n\n" );
 }
 
 
@@ -1060,7 +1171,7 @@ static void CreateBoardSection( FILE* aFile, BOARD* aPcb )
  *  Each tool name is build like this: "TRACK" + track width.
  *  For instance for a width = 120 : name = "TRACK120".
  */
-static void CreateTracksInfoData( FILE* aFile, BOARD* aPcb )
+static void CreateTracksInfoData( OUTPUTFORMATTER* aFile, BOARD* aPcb )
 {
     TRACK* track;
     int    last_width = -1;
@@ -1107,15 +1218,15 @@ static void CreateTracksInfoData( FILE* aFile, BOARD* aPcb )
     }
 
     // Write data
-    fputs( "$TRACKS\n", aFile );
+    aFile->Print( 0, "$TRACKS\n" );
 
     for( ii = 0; ii < trackinfo.size(); ii++ )
     {
-        fprintf( aFile, "TRACK TRACK%d %g\n", trackinfo[ii],
-                 trackinfo[ii] / SCALE_FACTOR );
+        aFile->Print( 0, "TRACK TRACK%d %g\n", trackinfo[ii],
+                      trackinfo[ii] / SCALE_FACTOR );
     }
 
-    fputs( "$ENDTRACKS\n\n", aFile );
+    aFile->Print( 0, "$ENDTRACKS\n\n" );
 }
 
 
@@ -1124,10 +1235,11 @@ static void CreateTracksInfoData( FILE* aFile, BOARD* aPcb )
  * It's almost guaranteed that the silk layer will be imported wrong but
  * the shape also contains the pads!
  */
-static void FootprintWriteShape( FILE* aFile, MODULE* module )
+static bool FootprintWriteShape( OUTPUTFORMATTER* aFile, MODULE* module )
 {
     EDGE_MODULE* PtEdge;
     EDA_ITEM*    PtStruct;
+    bool         ok = true;
 
     // Control Y axis change sign for flipped modules
     int          Yaxis_sign = -1;
@@ -1137,21 +1249,21 @@ static void FootprintWriteShape( FILE* aFile, MODULE* module )
         Yaxis_sign = 1;
 
     /* creates header: */
-    fprintf( aFile, "\nSHAPE %s\n", TO_UTF8( module->GetReference() ) );
+    aFile->Print( 0, "\nSHAPE %s\n", TO_UTF8( module->GetReference() ) );
 
     if( module->GetAttributes() & MOD_VIRTUAL )
     {
-        fprintf( aFile, "INSERT SMD\n" );
+        aFile->Print( 0, "INSERT SMD\n" );
     }
     else
     {
         if( module->GetAttributes() & MOD_CMS )
         {
-            fprintf( aFile, "INSERT SMD\n" );
+            aFile->Print( 0, "INSERT SMD\n" );
         }
         else
         {
-            fprintf( aFile, "INSERT TH\n" );
+            aFile->Print( 0, "INSERT TH\n" );
         }
     }
 
@@ -1160,15 +1272,15 @@ static void FootprintWriteShape( FILE* aFile, MODULE* module )
 
     if( module->m_Attributs != MOD_DEFAULT )
     {
-        fprintf( aFile, "ATTRIBUTE" );
+        aFile->Print( 0, "ATTRIBUTE" );
 
         if( module->m_Attributs & MOD_CMS )
-            fprintf( aFile, " PAD_SMD" );
+            aFile->Print( 0, " PAD_SMD" );
 
         if( module->m_Attributs & MOD_VIRTUAL )
-            fprintf( aFile, " VIRTUAL" );
+            aFile->Print( 0, " VIRTUAL" );
 
-        fprintf( aFile, "\n" );
+        aFile->Print( 0, "\n" );
     }
 #endif
 
@@ -1193,21 +1305,21 @@ static void FootprintWriteShape( FILE* aFile, MODULE* module )
                 switch( PtEdge->GetShape() )
                 {
                 case S_SEGMENT:
-                    fprintf( aFile, "LINE %g %g %g %g\n",
-                             (PtEdge->m_Start0.x) / SCALE_FACTOR,
-                             (Yaxis_sign * PtEdge->m_Start0.y) / SCALE_FACTOR,
-                             (PtEdge->m_End0.x) / SCALE_FACTOR,
-                             (Yaxis_sign * PtEdge->m_End0.y ) / SCALE_FACTOR );
+                    aFile->Print( 0, "LINE %g %g %g %g\n",
+                                  (PtEdge->m_Start0.x) / SCALE_FACTOR,
+                                  (Yaxis_sign * PtEdge->m_Start0.y) / SCALE_FACTOR,
+                                  (PtEdge->m_End0.x) / SCALE_FACTOR,
+                                  (Yaxis_sign * PtEdge->m_End0.y ) / SCALE_FACTOR );
                     break;
 
                 case S_CIRCLE:
                 {
                     int radius = KiROUND( GetLineLength( PtEdge->m_End0,
                                                          PtEdge->m_Start0 ) );
-                    fprintf( aFile, "CIRCLE %g %g %g\n",
-                             PtEdge->m_Start0.x / SCALE_FACTOR,
-                             Yaxis_sign * PtEdge->m_Start0.y / SCALE_FACTOR,
-                             radius / SCALE_FACTOR );
+                    aFile->Print( 0, "CIRCLE %g %g %g\n",
+                                  PtEdge->m_Start0.x / SCALE_FACTOR,
+                                  Yaxis_sign * PtEdge->m_Start0.y / SCALE_FACTOR,
+                                  radius / SCALE_FACTOR );
                     break;
                 }
 
@@ -1222,29 +1334,29 @@ static void FootprintWriteShape( FILE* aFile, MODULE* module )
                     if( Yaxis_sign == -1 )
                     {
                         // Flipping Y flips the arc direction too
-                        fprintf( aFile, "ARC %g %g %g %g %g %g\n",
-                                 (arcendx) / SCALE_FACTOR,
-                                 (Yaxis_sign * arcendy) / SCALE_FACTOR,
-                                 (PtEdge->m_End0.x) / SCALE_FACTOR,
-                                 (Yaxis_sign * PtEdge->GetEnd0().y) / SCALE_FACTOR,
-                                 (PtEdge->GetStart0().x) / SCALE_FACTOR,
-                                 (Yaxis_sign * PtEdge->GetStart0().y) / SCALE_FACTOR );
+                        aFile->Print( 0, "ARC %g %g %g %g %g %g\n",
+                                      (arcendx) / SCALE_FACTOR,
+                                      (Yaxis_sign * arcendy) / SCALE_FACTOR,
+                                      (PtEdge->m_End0.x) / SCALE_FACTOR,
+                                      (Yaxis_sign * PtEdge->GetEnd0().y) / SCALE_FACTOR,
+                                      (PtEdge->GetStart0().x) / SCALE_FACTOR,
+                                      (Yaxis_sign * PtEdge->GetStart0().y) / SCALE_FACTOR );
                     }
                     else
                     {
-                        fprintf( aFile, "ARC %g %g %g %g %g %g\n",
-                                 (PtEdge->GetEnd0().x) / SCALE_FACTOR,
-                                 (Yaxis_sign * PtEdge->GetEnd0().y) / SCALE_FACTOR,
-                                 (arcendx) / SCALE_FACTOR,
-                                 (Yaxis_sign * arcendy) / SCALE_FACTOR,
-                                 (PtEdge->GetStart0().x) / SCALE_FACTOR,
-                                 (Yaxis_sign * PtEdge->GetStart0().y) / SCALE_FACTOR );
+                        aFile->Print( 0, "ARC %g %g %g %g %g %g\n",
+                                      (PtEdge->GetEnd0().x) / SCALE_FACTOR,
+                                      (Yaxis_sign * PtEdge->GetEnd0().y) / SCALE_FACTOR,
+                                      (arcendx) / SCALE_FACTOR,
+                                      (Yaxis_sign * arcendy) / SCALE_FACTOR,
+                                      (PtEdge->GetStart0().x) / SCALE_FACTOR,
+                                      (Yaxis_sign * PtEdge->GetStart0().y) / SCALE_FACTOR );
                     }
                     break;
                 }
 
                 default:
-                    DisplayError( NULL, wxT( "Type Edge Module invalid." ) );
+                    ok = false;     // reported by the caller, on the GUI thread
                     break;
                 }
             }
@@ -1254,4 +1366,6 @@ static void FootprintWriteShape( FILE* aFile, MODULE* module )
             break;
         }
     }
+
+    return ok;
 }
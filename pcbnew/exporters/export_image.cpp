@@ -0,0 +1,215 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file export_image.cpp
+ * @brief Export of the board to a PNG image, rendered by the OpenGL canvas.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <fctsys.h>
+#include <common.h>
+#include <confirm.h>
+#include <project.h>
+#include <wxPcbStruct.h>
+#include <wildcards_and_files_ext.h>
+#include <class_draw_panel_gal.h>
+#include <view/view.h>
+#include <painter.h>
+#include <gal/opengl/opengl_gal.h>
+
+#include <class_board.h>
+
+#include <wx/filename.h>
+#include <wx/image.h>
+#include <wx/textdlg.h>
+
+
+// The default resolution of the images, in dots per inch
+#define BOARD_IMAGE_DEFAULT_DPI     300
+
+// The maximal size of the images, in pixels, to keep them in memory
+#define BOARD_IMAGE_MAX_SIZE        32768
+
+
+/**
+ * Function renderTile
+ * draws the area of the view at aCenter to the main target of aGal, and starts its
+ * read back.
+ * @return the pixel buffer of the tile, for OPENGL_GAL::ReadPixels().
+ */
+static unsigned int renderTile( KIGFX::VIEW* aView, KIGFX::OPENGL_GAL* aGal,
+                                const VECTOR2D& aCenter, const KIGFX::COLOR4D& aBackground )
+{
+    aView->SetCenter( aCenter );
+
+    aGal->BeginDrawing();
+    aGal->ClearScreen( aBackground );
+
+    aView->ClearTargets();
+    aView->Redraw();
+
+    return aGal->EndOffscreenDrawing();
+}
+
+
+bool PCB_EDIT_FRAME::ExportBoardImage( const wxString& aFullFileName, int aDpi )
+{
+    EDA_DRAW_PANEL_GAL* canvas = GetGalCanvas();
+
+    if( !IsGalCanvasActive() || canvas->GetBackend() != EDA_DRAW_PANEL_GAL::GAL_TYPE_OPENGL )
+        return false;
+
+    KIGFX::VIEW*       view = canvas->GetView();
+    KIGFX::OPENGL_GAL* gal = static_cast<KIGFX::OPENGL_GAL*>( canvas->GetGAL() );
+    KIGFX::COLOR4D     background = view->GetPainter()->GetSettings()->GetBackgroundColor();
+
+    EDA_RECT bbox = GetBoard()->ComputeBoundingBox();
+
+    if( bbox.GetWidth() <= 0 || bbox.GetHeight() <= 0 )
+        return false;
+
+    // The size of the pixels, in internal units
+    double pixelSize = IU_PER_MILS * 1000.0 / aDpi;
+    int    width = KiROUND( bbox.GetWidth() / pixelSize ) + 1;
+    int    height = KiROUND( bbox.GetHeight() / pixelSize ) + 1;
+
+    if( width > BOARD_IMAGE_MAX_SIZE || height > BOARD_IMAGE_MAX_SIZE )
+        return false;
+
+    // The tiles are the size of the canvas, drawn one by one at the resolution of the image
+    VECTOR2I tileSize = gal->GetScreenPixelSize();
+
+    if( tileSize.x <= 0 || tileSize.y <= 0 )
+        return false;
+
+    VECTOR2D oldCenter = view->GetCenter();
+    double   oldScale = view->GetScale();
+    double   scale = oldScale / ( gal->GetWorldScale() * pixelSize );
+
+    view->SetScale( scale );
+
+    bool ok = std::abs( view->GetScale() - scale ) <= scale * 1e-6;
+
+    wxImage image;
+
+    if( ok )
+        image.Create( width, height, false );
+
+    int cols = ( width + tileSize.x - 1 ) / tileSize.x;
+    int rows = ( height + tileSize.y - 1 ) / tileSize.y;
+    int count = ok ? cols * rows : 0;
+
+    // The tile N is rendered while the tile N - 1 is transferred, then copied
+    unsigned int pending = 0;
+    wxImage      tile;
+
+    for( int ii = 0; ii <= count; ii++ )
+    {
+        unsigned int pixelBuffer = 0;
+
+        if( ii < count )
+        {
+            VECTOR2D center( bbox.GetX() + ( ( ii % cols ) + 0.5 ) * tileSize.x * pixelSize,
+                             bbox.GetY() + ( ( ii / cols ) + 0.5 ) * tileSize.y * pixelSize );
+
+            pixelBuffer = renderTile( view, gal, center, background );
+        }
+
+        if( ii > 0 )
+        {
+            int prev = ii - 1;
+
+            if( !gal->ReadPixels( pending, tile, background ) )
+            {
+                ok = false;
+                break;
+            }
+
+            // The GL frame buffer may be larger than the canvas, on high DPI screens
+            if( tile.GetWidth() != tileSize.x || tile.GetHeight() != tileSize.y )
+                tile.Rescale( tileSize.x, tileSize.y );
+
+            image.Paste( tile, ( prev % cols ) * tileSize.x, ( prev / cols ) * tileSize.y );
+        }
+
+        pending = pixelBuffer;
+    }
+
+    // Restore the view of the canvas
+    view->SetScale( oldScale );
+    view->SetCenter( oldCenter );
+    view->MarkDirty();
+    canvas->Refresh();
+
+    return ok && image.SaveFile( aFullFileName, wxBITMAP_TYPE_PNG );
+}
+
+
+void PCB_EDIT_FRAME::OnExportImage( wxCommandEvent& event )
+{
+    if( !IsGalCanvasActive()
+        || GetGalCanvas()->GetBackend() != EDA_DRAW_PANEL_GAL::GAL_TYPE_OPENGL )
+    {
+        DisplayInfoMessage( this, _( "The image export needs the OpenGL canvas" ) );
+        return;
+    }
+
+    wxString text = wxGetTextFromUser( _( "Resolution (dpi):" ), _( "Export Board Image" ),
+                                       wxString::Format( wxT( "%d" ), BOARD_IMAGE_DEFAULT_DPI ),
+                                       this );
+    long     dpi;
+
+    if( text.IsEmpty() )
+        return;
+
+    if( !text.ToLong( &dpi ) || dpi <= 0 )
+    {
+        DisplayError( this, _( "Invalid resolution" ) );
+        return;
+    }
+
+    wxFileName fn = GetBoard()->GetFileName();
+
+    fn.SetExt( wxT( "png" ) );
+
+    wxString pro_dir = wxPathOnly( Prj().GetProjectFullName() );
+
+    wxFileDialog dlg( this, _( "Export Board Image" ), pro_dir,
+                      fn.GetFullName(), PngFileWildcard,
+                      wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( dlg.ShowModal() == wxID_CANCEL )
+        return;
+
+    wxBusyCursor dummy;
+
+    if( !ExportBoardImage( dlg.GetPath(), dpi ) )
+    {
+        wxString msg;
+        msg.Printf( _( "Unable to create file '%s'" ), GetChars( dlg.GetPath() ) );
+        DisplayError( this, msg );
+    }
+}
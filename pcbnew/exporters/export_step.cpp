@@ -0,0 +1,996 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file export_step.cpp
+ * @brief Export of the board and of its components to a STEP AP214 file.
+ *
+ * The board body and the copper layers are faceted solids, extruded from their
+ * polygons.  The 3D models are the triangles of their render data, each model being
+ * written once as a part, placed by a transformation at each of its footprints.
+ * The entities are written as they are built, one copper layer at a time.
+ */
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fctsys.h>
+#include <kicad_string.h>
+#include <common.h>
+#include <confirm.h>
+#include <macros.h>
+#include <trigo.h>
+#include <pgm_base.h>
+#include <project.h>
+#include <thread_pool.h>
+#include <wxPcbStruct.h>
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/shape_poly_set.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <3d_struct.h>
+
+#include "3d_cache/3d_cache.h"
+
+#include <boost/bind.hpp>
+
+// thickness of the copper layers, mm
+#define STEP_COPPER_THICKNESS   0.035
+
+// number of segments to approximate the circle of a hole
+#define STEP_HOLE_SEGMENTS      16
+
+// size of the buffer of the output file
+#define STEP_OUTPUT_BUFFER_SIZE ( 1 << 20 )
+
+// the millimeters by internal unit
+#define STEP_MM_PER_IU          ( 1.0 / IU_PER_MM )
+
+
+// Formats a STEP real, which always has a decimal point
+static std::string stepReal( double aValue, int aDigits = 6 )
+{
+    char buf[64];
+
+    snprintf( buf, sizeof( buf ), "%.*f", aDigits, aValue );
+
+    // remove the trailing zeros, keeping the decimal point
+    char* end = buf + strlen( buf ) - 1;
+
+    while( *end == '0' )
+        *end-- = 0;
+
+    if( strcmp( buf, "-0." ) == 0 )
+        return "0.";
+
+    return buf;
+}
+
+
+// Formats a STEP string, quoted.  The characters out of the printable ASCII set are
+// replaced, STEP has its own encoding of them.
+static std::string stepString( const wxString& aText )
+{
+    std::string utf8 = TO_UTF8( aText );
+    std::string text = "'";
+
+    for( unsigned ii = 0; ii < utf8.size(); ii++ )
+    {
+        char ch = utf8[ii];
+
+        if( ch == '\'' )
+            text += "''";
+        else if( ch == '\\' )
+            text += "\\\\";
+        else if( ch < 0x20 || ch > 0x7e )
+            text += '_';
+        else
+            text += ch;
+    }
+
+    return text + "'";
+}
+
+
+/**
+ * Class STEP_WRITER
+ * writes the entities of the DATA section of a STEP file as they are built, numbered
+ * in sequence.  A STEP file may refer to entities defined later: an entity whose id
+ * is needed before its contents are known gets its id from Reserve().
+ */
+class STEP_WRITER
+{
+public:
+    STEP_WRITER( FILE* aFile ) :
+        m_file( aFile ),
+        m_nextId( 1 )
+    {
+    }
+
+    int Reserve() { return m_nextId++; }
+
+    /**
+     * Function Entity
+     * writes an entity from a printf() like format, without its "#id=" and its ";"
+     * @return the id of the entity
+     */
+    int Entity( const char* aFormat, ... )
+    {
+        int     id = m_nextId++;
+        va_list args;
+
+        fprintf( m_file, "#%d=", id );
+
+        va_start( args, aFormat );
+        vfprintf( m_file, aFormat, args );
+        va_end( args );
+
+        fputs( ";\n", m_file );
+
+        return id;
+    }
+
+    /**
+     * Function Begin
+     * starts an entity ending with a list of ids, completed by IdList() and End().
+     * @param aId is a reserved id, or 0 for a new one
+     * @return the id of the entity
+     */
+    int Begin( int aId, const char* aText )
+    {
+        if( aId == 0 )
+            aId = m_nextId++;
+
+        fprintf( m_file, "#%d=%s", aId, aText );
+
+        return aId;
+    }
+
+    void IdList( const std::vector<int>& aIds )
+    {
+        fputc( '(', m_file );
+
+        for( unsigned ii = 0; ii < aIds.size(); ii++ )
+        {
+            if( ii > 0 )
+                fputs( ( ii % 16 ) ? "," : ",\n", m_file );
+
+            fprintf( m_file, "#%d", aIds[ii] );
+        }
+
+        fputc( ')', m_file );
+    }
+
+    void End( const char* aText )
+    {
+        fprintf( m_file, "%s;\n", aText );
+    }
+
+    int Point( double aX, double aY, double aZ )
+    {
+        return Entity( "CARTESIAN_POINT('',(%s,%s,%s))", stepReal( aX ).c_str(),
+                       stepReal( aY ).c_str(), stepReal( aZ ).c_str() );
+    }
+
+    int Direction( double aX, double aY, double aZ )
+    {
+        return Entity( "DIRECTION('',(%s,%s,%s))", stepReal( aX, 10 ).c_str(),
+                       stepReal( aY, 10 ).c_str(), stepReal( aZ, 10 ).c_str() );
+    }
+
+    /// Writes the placement of origin ( aX, aY, aZ ), of axis aAxis and of X direction aRef
+    int Placement( double aX, double aY, double aZ, const double aAxis[3], const double aRef[3] )
+    {
+        int origin = Point( aX, aY, aZ );
+        int axis = Direction( aAxis[0], aAxis[1], aAxis[2] );
+        int ref = Direction( aRef[0], aRef[1], aRef[2] );
+
+        return Entity( "AXIS2_PLACEMENT_3D('',#%d,#%d,#%d)", origin, axis, ref );
+    }
+
+    /**
+     * Function Style
+     * gives the colour ( aRed, aGreen, aBlue ) to the item aItem.  The styles are shared
+     * by the items of the same colour, and the styled items are written by
+     * WritePresentation().
+     */
+    void Style( int aItem, double aRed, double aGreen, double aBlue )
+    {
+        unsigned long key = ( (unsigned long) ( aRed * 255.0 + 0.5 ) << 16 )
+                            | ( (unsigned long) ( aGreen * 255.0 + 0.5 ) << 8 )
+                            | (unsigned long) ( aBlue * 255.0 + 0.5 );
+
+        std::map<unsigned long, int>::iterator it = m_styles.find( key );
+
+        if( it == m_styles.end() )
+        {
+            int colour = Entity( "COLOUR_RGB('',%s,%s,%s)", stepReal( aRed, 3 ).c_str(),
+                                 stepReal( aGreen, 3 ).c_str(), stepReal( aBlue, 3 ).c_str() );
+            int fill = Entity( "FILL_AREA_STYLE_COLOUR('',#%d)", colour );
+            int area = Entity( "FILL_AREA_STYLE('',(#%d))", fill );
+            int surface = Entity( "SURFACE_STYLE_FILL_AREA(#%d)", area );
+            int side = Entity( "SURFACE_SIDE_STYLE('',(#%d))", surface );
+            int usage = Entity( "SURFACE_STYLE_USAGE(.BOTH.,#%d)", side );
+            int style = Entity( "PRESENTATION_STYLE_ASSIGNMENT((#%d))", usage );
+
+            it = m_styles.insert( std::make_pair( key, style ) ).first;
+        }
+
+        m_styledItems.push_back( Entity( "STYLED_ITEM('color',(#%d),#%d)", it->second, aItem ) );
+    }
+
+    void WritePresentation( int aContext )
+    {
+        if( m_styledItems.empty() )
+            return;
+
+        Begin( 0, "MECHANICAL_DESIGN_GEOMETRIC_PRESENTATION_REPRESENTATION(''," );
+        IdList( m_styledItems );
+        fprintf( m_file, ",#%d", aContext );
+        End( ")" );
+    }
+
+private:
+    FILE*                           m_file;
+    int                             m_nextId;
+
+    std::map<unsigned long, int>    m_styles;       // the style assignments by colour
+    std::vector<int>                m_styledItems;
+};
+
+
+// The contexts shared by the products and the representations
+struct STEP_CONTEXT
+{
+    int m_product;
+    int m_definition;
+    int m_geometry;
+};
+
+
+// A part with its product definition, and the origin placement of its representation
+struct STEP_PART
+{
+    int m_definition;
+    int m_shape;
+    int m_origin;
+};
+
+
+/**
+ * Function write_product
+ * writes the product of a part or an assembly, of shape representation aShape.
+ * @return the product definition of the part.
+ */
+static int write_product( STEP_WRITER& aWriter, const STEP_CONTEXT& aContext,
+                          const wxString& aName, int aShape )
+{
+    std::string name = stepString( aName );
+
+    int product = aWriter.Entity( "PRODUCT(%s,%s,'',(#%d))", name.c_str(), name.c_str(),
+                                  aContext.m_product );
+    int formation = aWriter.Entity( "PRODUCT_DEFINITION_FORMATION('','',#%d)", product );
+    int definition = aWriter.Entity( "PRODUCT_DEFINITION('design','',#%d,#%d)", formation,
+                                     aContext.m_definition );
+    int shape = aWriter.Entity( "PRODUCT_DEFINITION_SHAPE('','',#%d)", definition );
+
+    aWriter.Entity( "SHAPE_DEFINITION_REPRESENTATION(#%d,#%d)", shape, aShape );
+    aWriter.Entity( "PRODUCT_RELATED_PRODUCT_CATEGORY('part',$,(#%d))", product );
+
+    return definition;
+}
+
+
+/**
+ * Function write_contour
+ * writes the points of a contour at the heights aBottom and aTop, in mm, with Y up.
+ * The contour is oriented counterclockwise when aCCW is true, clockwise otherwise.
+ * @return false if the contour is degenerate, and nothing is written
+ */
+static bool write_contour( STEP_WRITER& aWriter, const SHAPE_LINE_CHAIN& aContour, bool aCCW,
+                           double aBottom, double aTop,
+                           std::vector<int>& aBottomIds, std::vector<int>& aTopIds )
+{
+    std::vector<VECTOR2I> points;
+
+    for( int ii = 0; ii < aContour.PointCount(); ii++ )
+    {
+        const VECTOR2I& pt = aContour.CPoint( ii );
+
+        if( points.empty() || pt != points.back() )
+            points.push_back( pt );
+    }
+
+    while( points.size() > 1 && points.back() == points.front() )
+        points.pop_back();
+
+    if( points.size() < 3 )
+        return false;
+
+    // the signed area, with the Y axis going up
+    double area = 0.0;
+
+    for( unsigned ii = 0; ii < points.size(); ii++ )
+    {
+        const VECTOR2I& a = points[ii];
+        const VECTOR2I& b = points[( ii + 1 ) % points.size()];
+
+        area += (double) a.x * -b.y - (double) b.x * -a.y;
+    }
+
+    if( area == 0.0 )
+        return false;
+
+    if( ( area > 0.0 ) != aCCW )
+        std::reverse( points.begin(), points.end() );
+
+    for( unsigned ii = 0; ii < points.size(); ii++ )
+    {
+        double x = points[ii].x * STEP_MM_PER_IU;
+        double y = -points[ii].y * STEP_MM_PER_IU;
+
+        aBottomIds.push_back( aWriter.Point( x, y, aBottom ) );
+        aTopIds.push_back( aWriter.Point( x, y, aTop ) );
+    }
+
+    return true;
+}
+
+
+// Writes a planar face bounded by aLoops, the outer loop first, reversed if aReverse is
+// true, and returns its id
+static int write_face( STEP_WRITER& aWriter, const std::vector< std::vector<int> >& aLoops,
+                       bool aReverse )
+{
+    std::vector<int> bounds;
+
+    for( unsigned ii = 0; ii < aLoops.size(); ii++ )
+    {
+        std::vector<int> loop( aLoops[ii] );
+
+        if( aReverse )
+            std::reverse( loop.begin(), loop.end() );
+
+        int id = aWriter.Begin( 0, "POLY_LOOP(''," );
+        aWriter.IdList( loop );
+        aWriter.End( ")" );
+
+        bounds.push_back( aWriter.Entity( ii == 0 ? "FACE_OUTER_BOUND('',#%d,.T.)" :
+                                          "FACE_BOUND('',#%d,.T.)", id ) );
+    }
+
+    int face = aWriter.Begin( 0, "FACE(''," );
+    aWriter.IdList( bounds );
+    aWriter.End( ")" );
+
+    return face;
+}
+
+
+/**
+ * Function write_extrusion
+ * writes a faceted solid for each polygon of aPolys, extruded from aBottom to aTop
+ * in mm, and appends their ids to aSolids.
+ */
+static void write_extrusion( STEP_WRITER& aWriter, const SHAPE_POLY_SET& aPolys,
+                             double aBottom, double aTop, std::vector<int>& aSolids )
+{
+    for( int ii = 0; ii < aPolys.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aPolys.CPolygon( ii );
+
+        // the contours, the outline first, then its holes
+        std::vector< std::vector<int> > bottom;
+        std::vector< std::vector<int> > top;
+
+        for( unsigned jj = 0; jj < polygon.size(); jj++ )
+        {
+            std::vector<int> bottomIds, topIds;
+
+            if( write_contour( aWriter, polygon[jj], jj == 0, aBottom, aTop, bottomIds, topIds ) )
+            {
+                bottom.push_back( bottomIds );
+                top.push_back( topIds );
+            }
+            else if( jj == 0 )
+            {
+                break;
+            }
+        }
+
+        if( top.empty() )
+            continue;
+
+        std::vector<int> faces;
+
+        faces.push_back( write_face( aWriter, top, false ) );
+        faces.push_back( write_face( aWriter, bottom, true ) );
+
+        // the sides, the outline being counterclockwise and the holes clockwise, face
+        // outwards
+        std::vector< std::vector<int> > quad( 1, std::vector<int>( 4 ) );
+
+        for( unsigned jj = 0; jj < top.size(); jj++ )
+        {
+            unsigned count = top[jj].size();
+
+            for( unsigned kk = 0; kk < count; kk++ )
+            {
+                unsigned next = ( kk + 1 ) % count;
+
+                quad[0][0] = bottom[jj][kk];
+                quad[0][1] = bottom[jj][next];
+                quad[0][2] = top[jj][next];
+                quad[0][3] = top[jj][kk];
+
+                faces.push_back( write_face( aWriter, quad, false ) );
+            }
+        }
+
+        int shell = aWriter.Begin( 0, "CLOSED_SHELL(''," );
+        aWriter.IdList( faces );
+        aWriter.End( ")" );
+
+        aSolids.push_back( aWriter.Entity( "FACETED_BREP('',#%d)", shell ) );
+    }
+}
+
+
+// A vertex of a mesh, to write the vertices shared by its triangles once
+struct STEP_VERTEX
+{
+    float x, y, z;
+
+    bool operator<( const STEP_VERTEX& aOther ) const
+    {
+        if( x != aOther.x )
+            return x < aOther.x;
+
+        if( y != aOther.y )
+            return y < aOther.y;
+
+        return z < aOther.z;
+    }
+};
+
+
+/**
+ * Function write_model
+ * writes the meshes of a 3D model, scaled by aScale, as surface models of triangles
+ * coloured by their material, and appends their ids to aItems.
+ */
+static void write_model( STEP_WRITER& aWriter, const S3DMODEL* aModel, const S3DPOINT& aScale,
+                         std::vector<int>& aItems )
+{
+    for( unsigned ii = 0; ii < aModel->m_MeshesSize; ii++ )
+    {
+        const SMESH& mesh = aModel->m_Meshes[ii];
+
+        std::map<STEP_VERTEX, int> vertexIds;
+        std::vector<int>           ids( mesh.m_VertexSize );
+        std::vector<int>           faces;
+
+        for( unsigned jj = 0; jj < mesh.m_VertexSize; jj++ )
+        {
+            STEP_VERTEX vertex;
+
+            vertex.x = mesh.m_Positions[jj].x * aScale.x;
+            vertex.y = mesh.m_Positions[jj].y * aScale.y;
+            vertex.z = mesh.m_Positions[jj].z * aScale.z;
+
+            std::map<STEP_VERTEX, int>::iterator it = vertexIds.find( vertex );
+
+            if( it == vertexIds.end() )
+            {
+                int id = aWriter.Point( vertex.x, vertex.y, vertex.z );
+
+                it = vertexIds.insert( std::make_pair( vertex, id ) ).first;
+            }
+
+            ids[jj] = it->second;
+        }
+
+        std::vector< std::vector<int> > triangle( 1, std::vector<int>( 3 ) );
+
+        for( unsigned jj = 0; jj + 2 < mesh.m_FaceIdxSize; jj += 3 )
+        {
+            if( mesh.m_FaceIdx[jj] >= mesh.m_VertexSize
+                || mesh.m_FaceIdx[jj + 1] >= mesh.m_VertexSize
+                || mesh.m_FaceIdx[jj + 2] >= mesh.m_VertexSize )
+                continue;
+
+            triangle[0][0] = ids[mesh.m_FaceIdx[jj]];
+            triangle[0][1] = ids[mesh.m_FaceIdx[jj + 1]];
+            triangle[0][2] = ids[mesh.m_FaceIdx[jj + 2]];
+
+            // the degenerate triangles are not valid faces
+            if( triangle[0][0] == triangle[0][1] || triangle[0][1] == triangle[0][2]
+                || triangle[0][2] == triangle[0][0] )
+                continue;
+
+            faces.push_back( write_face( aWriter, triangle, false ) );
+        }
+
+        if( faces.empty() )
+            continue;
+
+        int shell = aWriter.Begin( 0, "OPEN_SHELL(''," );
+        aWriter.IdList( faces );
+        aWriter.End( ")" );
+
+        int surface = aWriter.Entity( "SHELL_BASED_SURFACE_MODEL('',(#%d))", shell );
+
+        if( mesh.m_MaterialIdx < aModel->m_MaterialsSize )
+        {
+            const SFVEC3F& diffuse = aModel->m_Materials[mesh.m_MaterialIdx].m_Diffuse;
+
+            aWriter.Style( surface, diffuse.x, diffuse.y, diffuse.z );
+        }
+
+        aItems.push_back( surface );
+    }
+}
+
+
+// Applies the rotation of aAngle radians about the axis aAxis (0 to 2 for X to Z) after
+// the rotation aMatrix
+static void rotate( double aMatrix[3][3], int aAxis, double aAngle )
+{
+    double c = cos( aAngle );
+    double s = sin( aAngle );
+    double r[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+    int    u = ( aAxis + 1 ) % 3;
+    int    v = ( aAxis + 2 ) % 3;
+
+    r[u][u] = c;
+    r[u][v] = -s;
+    r[v][u] = s;
+    r[v][v] = c;
+
+    double tmp[3][3];
+
+    for( int ii = 0; ii < 3; ii++ )
+    {
+        for( int jj = 0; jj < 3; jj++ )
+        {
+            tmp[ii][jj] = 0.0;
+
+            for( int kk = 0; kk < 3; kk++ )
+                tmp[ii][jj] += r[ii][kk] * aMatrix[kk][jj];
+        }
+    }
+
+    memcpy( aMatrix, tmp, sizeof( tmp ) );
+}
+
+
+/**
+ * Function write_model_placement
+ * writes the placement of a 3D model of a footprint in the assembly, with the rotation
+ * and the offset given by the model, as the VRML export.
+ * @param aLayerZ is the height of the surface of the footprint side, mm
+ */
+static int write_model_placement( STEP_WRITER& aWriter, MODULE* aModule, S3D_MASTER* aModel,
+                                  double aLayerZ )
+{
+    bool   isFlipped = aModule->GetLayer() == B_Cu;
+    double rotx = -aModel->m_MatRotation.x;
+    double roty = -aModel->m_MatRotation.y;
+    double rotz = -aModel->m_MatRotation.z;
+
+    if( isFlipped )
+    {
+        rotx += 180.0;
+        roty = -roty;
+        rotz = -rotz;
+    }
+
+    double matrix[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+
+    rotate( matrix, 0, DEG2RAD( rotx ) );
+    rotate( matrix, 1, DEG2RAD( roty ) );
+    rotate( matrix, 2, DEG2RAD( rotz ) );
+    rotate( matrix, 2, DECIDEG2RAD( aModule->GetOrientation() ) );
+
+    // the model offsets are in inches
+    double offsetx = aModel->m_MatPosition.x * IU_PER_MILS * 1000.0;
+    double offsety = aModel->m_MatPosition.y * IU_PER_MILS * 1000.0;
+    double offsetz = aModel->m_MatPosition.z * IU_PER_MILS * 1000.0;
+
+    if( isFlipped )
+        offsetz = -offsetz;
+    else    // the Y axis of Pcbnew goes down
+        offsety = -offsety;
+
+    RotatePoint( &offsetx, &offsety, aModule->GetOrientation() );
+
+    double axis[3] = { matrix[0][2], matrix[1][2], matrix[2][2] };
+    double ref[3] = { matrix[0][0], matrix[1][0], matrix[2][0] };
+
+    return aWriter.Placement( ( offsetx + aModule->GetPosition().x ) * STEP_MM_PER_IU,
+                              -( offsety + aModule->GetPosition().y ) * STEP_MM_PER_IU,
+                              offsetz * STEP_MM_PER_IU + aLayerZ, axis, ref );
+}
+
+
+// The copper of a layer, built while the previous layer is written
+struct STEP_COPPER_LAYER
+{
+    LAYER_ID        m_layer;
+    SHAPE_POLY_SET  m_polys;
+};
+
+
+// The task building the copper of a layer, without the holes of aHoles.  One layer is
+// built at a time: the conversion of the texts to polygons is not reentrant.
+static void build_copper_layer( BOARD* aPcb, const SHAPE_POLY_SET* aHoles,
+                                STEP_COPPER_LAYER* aLayer )
+{
+    aPcb->ConvertBrdLayerToPolygonalContours( aLayer->m_layer, aLayer->m_polys );
+    aLayer->m_polys.Simplify( SHAPE_POLY_SET::PM_FAST );
+    aLayer->m_polys.BooleanSubtract( *aHoles, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+}
+
+
+// Builds the through holes of the pads and the vias of the board
+static void build_holes( BOARD* aPcb, SHAPE_POLY_SET& aHoles )
+{
+    for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            pad->BuildPadDrillShapePolygon( aHoles, 0, STEP_HOLE_SEGMENTS );
+    }
+
+    for( TRACK* track = aPcb->m_Track; track; track = track->Next() )
+    {
+        if( track->Type() != PCB_VIA_T )
+            continue;
+
+        VIA* via = static_cast<VIA*>( track );
+
+        // the blind and buried vias do not go through the board
+        if( via->GetViaType() != VIA_THROUGH )
+            continue;
+
+        TransformCircleToPolygon( aHoles, via->GetStart(), via->GetDrillValue() / 2,
+                                  STEP_HOLE_SEGMENTS );
+    }
+}
+
+
+bool PCB_EDIT_FRAME::ExportSTEP_File( const wxString& aFullFileName, bool aExportComponents )
+{
+    BOARD*   pcb = GetBoard();
+    wxString msg;
+
+    SHAPE_POLY_SET body;
+    SHAPE_POLY_SET holes;
+
+    if( !pcb->GetBoardPolygonOutlines( body, holes, &msg ) )
+    {
+        msg << wxT( "\n\n" ) <<
+        _( "Unable to calculate the board outlines;\n"
+           "fall back to using the board boundary box." );
+        wxMessageBox( msg );
+    }
+
+    build_holes( pcb, holes );
+    holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+    body.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    FILE* file = wxFopen( aFullFileName, wxT( "wt" ) );
+
+    if( !file )
+        return false;
+
+    std::vector<char> outputBuffer( STEP_OUTPUT_BUFFER_SIZE );
+
+    setvbuf( file, &outputBuffer[0], _IOFBF, outputBuffer.size() );
+
+    // Switch the locale to standard C (needed to print floating point numbers)
+    LOCALE_IO toggle;
+
+    wxFileName fn( aFullFileName );
+
+    fprintf( file, "ISO-10303-21;\nHEADER;\n" );
+    fprintf( file, "FILE_DESCRIPTION(('KiCad electronic assembly'),'2;1');\n" );
+    fprintf( file, "FILE_NAME(%s,%s,(''),(''),'Pcbnew','Pcbnew','');\n",
+             stepString( fn.GetFullName() ).c_str(),
+             stepString( wxDateTime::Now().FormatISOCombined() ).c_str() );
+    fprintf( file, "FILE_SCHEMA(('AUTOMOTIVE_DESIGN { 1 0 10303 214 1 1 1 1 }'));\n" );
+    fprintf( file, "ENDSEC;\nDATA;\n" );
+
+    STEP_WRITER  writer( file );
+    STEP_CONTEXT context;
+
+    int application = writer.Entity( "APPLICATION_CONTEXT('automotive design')" );
+    writer.Entity( "APPLICATION_PROTOCOL_DEFINITION('international standard',"
+                   "'automotive_design',2000,#%d)", application );
+    context.m_product = writer.Entity( "PRODUCT_CONTEXT('',#%d,'mechanical')", application );
+    context.m_definition = writer.Entity( "PRODUCT_DEFINITION_CONTEXT('part definition',#%d,"
+                                          "'design')", application );
+
+    int length = writer.Entity( "(LENGTH_UNIT()NAMED_UNIT(*)SI_UNIT(.MILLI.,.METRE.))" );
+    int angle = writer.Entity( "(NAMED_UNIT(*)PLANE_ANGLE_UNIT()SI_UNIT($,.RADIAN.))" );
+    int solidAngle = writer.Entity( "(NAMED_UNIT(*)SI_UNIT($,.STERADIAN.)SOLID_ANGLE_UNIT())" );
+    int uncertainty = writer.Entity( "UNCERTAINTY_MEASURE_WITH_UNIT(LENGTH_MEASURE(1.E-06),#%d,"
+                                     "'distance_accuracy_value','confusion accuracy')", length );
+    context.m_geometry = writer.Entity( "(GEOMETRIC_REPRESENTATION_CONTEXT(3)"
+                                        "GLOBAL_UNCERTAINTY_ASSIGNED_CONTEXT((#%d))"
+                                        "GLOBAL_UNIT_ASSIGNED_CONTEXT((#%d,#%d,#%d))"
+                                        "REPRESENTATION_CONTEXT('Context #1',"
+                                        "'3D Context with UNIT and UNCERTAINTY'))",
+                                        uncertainty, length, angle, solidAngle );
+
+    const double zAxis[3] = { 0.0, 0.0, 1.0 };
+    const double xAxis[3] = { 1.0, 0.0, 0.0 };
+
+    // The assembly, whose representation holds the placements of its parts, is
+    // written last
+    STEP_PART assembly;
+    std::vector<int> assemblyItems;
+
+    assembly.m_shape = writer.Reserve();
+    assembly.m_origin = writer.Placement( 0.0, 0.0, 0.0, zAxis, xAxis );
+    assemblyItems.push_back( assembly.m_origin );
+
+    wxString boardName = fn.GetName();
+
+    assembly.m_definition = write_product( writer, context, boardName, assembly.m_shape );
+
+    // The board part: the body, then the copper layers, one at a time
+    double thickness = pcb->GetDesignSettings().GetBoardThickness() * STEP_MM_PER_IU;
+    int    copperCount = pcb->GetCopperLayerCount();
+
+    STEP_PART        board;
+    std::vector<int> boardItems;
+
+    board.m_origin = writer.Placement( 0.0, 0.0, 0.0, zAxis, xAxis );
+    boardItems.push_back( board.m_origin );
+
+    LSEQ              layers = pcb->GetEnabledLayers().CuStack();
+    STEP_COPPER_LAYER copper[2];
+    TASK_GROUP        tasks( Pgm().GetThreadPool() );
+
+    // The first copper layer is built while the body is written
+    if( !layers.empty() )
+    {
+        copper[0].m_layer = layers[0];
+        tasks.Run( boost::bind( build_copper_layer, pcb, &holes, &copper[0] ) );
+    }
+
+    unsigned bodyStart = boardItems.size();
+
+    write_extrusion( writer, body, 0.0, thickness, boardItems );
+
+    for( unsigned ii = bodyStart; ii < boardItems.size(); ii++ )
+        writer.Style( boardItems[ii], 0.1, 0.35, 0.1 );
+
+    body.RemoveAllContours();
+
+    for( unsigned ii = 0; ii < layers.size(); ii++ )
+    {
+        tasks.Wait();
+
+        STEP_COPPER_LAYER& current = copper[ii % 2];
+
+        if( ii + 1 < layers.size() )
+        {
+            STEP_COPPER_LAYER& next = copper[( ii + 1 ) % 2];
+
+            next.m_layer = layers[ii + 1];
+            tasks.Run( boost::bind( build_copper_layer, pcb, &holes, &next ) );
+        }
+
+        double z;
+
+        if( current.m_layer == F_Cu )
+            z = thickness + STEP_COPPER_THICKNESS / 2;
+        else if( current.m_layer == B_Cu )
+            z = -STEP_COPPER_THICKNESS / 2;
+        else
+            z = thickness * ( 1.0 - (double) current.m_layer / ( copperCount - 1 ) );
+
+        unsigned layerStart = boardItems.size();
+
+        write_extrusion( writer, current.m_polys, z - STEP_COPPER_THICKNESS / 2,
+                         z + STEP_COPPER_THICKNESS / 2, boardItems );
+
+        for( unsigned jj = layerStart; jj < boardItems.size(); jj++ )
+            writer.Style( boardItems[jj], 0.85, 0.6, 0.2 );
+
+        current.m_polys.RemoveAllContours();
+    }
+
+    board.m_shape = writer.Begin( 0, "FACETED_BREP_SHAPE_REPRESENTATION(''," );
+    writer.IdList( boardItems );
+    fprintf( file, ",#%d", context.m_geometry );
+    writer.End( ")" );
+
+    board.m_definition = write_product( writer, context, boardName + wxT( "_PCB" ),
+                                        board.m_shape );
+
+    // The parts placed in the assembly, the board and the 3D models of the footprints
+    std::vector<STEP_PART*>   placedParts;
+    std::vector<int>          placements;
+    std::vector<wxString>     placementNames;
+
+    placedParts.push_back( &board );
+    placements.push_back( writer.Placement( 0.0, 0.0, 0.0, zAxis, xAxis ) );
+    placementNames.push_back( boardName + wxT( "_PCB" ) );
+
+    // The parts of the 3D models by file name and scale, each used model is written once
+    std::map<wxString, STEP_PART> modelParts;
+
+    if( aExportComponents )
+    {
+        S3D_CACHE*           cache = Prj().Get3DCacheManager();
+        std::list<wxString>  modelFiles;
+
+        for( MODULE* module = pcb->m_Modules; module; module = module->Next() )
+        {
+            for( S3D_MASTER* model = module->Models(); model; model = model->Next() )
+            {
+                if( !model->GetShape3DName().IsEmpty() )
+                    modelFiles.push_back( model->GetShape3DName() );
+            }
+        }
+
+        // the models are loaded by the threads of the process
+        cache->Preload( modelFiles );
+
+        for( MODULE* module = pcb->m_Modules; module; module = module->Next() )
+        {
+            double layerZ = module->GetLayer() == B_Cu ? -STEP_COPPER_THICKNESS
+                                                       : thickness + STEP_COPPER_THICKNESS;
+
+            for( S3D_MASTER* model = module->Models(); model; model = model->Next() )
+            {
+                wxString name = model->GetShape3DName();
+
+                if( name.IsEmpty() )
+                    continue;
+
+                wxString key = name + wxString::Format( wxT( "|%g|%g|%g" ),
+                                                        model->m_MatScale.x,
+                                                        model->m_MatScale.y,
+                                                        model->m_MatScale.z );
+
+                std::map<wxString, STEP_PART>::iterator it = modelParts.find( key );
+
+                if( it == modelParts.end() )
+                {
+                    // a model without render data is a part without a shape
+                    STEP_PART        part = { 0, 0, 0 };
+                    S3DMODEL*        data = cache->GetModel( name );
+                    std::vector<int> items;
+
+                    if( data )
+                    {
+                        part.m_origin = writer.Placement( 0.0, 0.0, 0.0, zAxis, xAxis );
+                        items.push_back( part.m_origin );
+
+                        write_model( writer, data, model->m_MatScale, items );
+                    }
+
+                    if( items.size() > 1 )
+                    {
+                        part.m_shape = writer.Begin( 0, "SHAPE_REPRESENTATION(''," );
+                        writer.IdList( items );
+                        fprintf( file, ",#%d", context.m_geometry );
+                        writer.End( ")" );
+
+                        part.m_definition = write_product( writer, context,
+                                                           wxFileName( name ).GetName(),
+                                                           part.m_shape );
+                    }
+
+                    it = modelParts.insert( std::make_pair( key, part ) ).first;
+                }
+
+                if( it->second.m_definition == 0 )
+                    continue;
+
+                placedParts.push_back( &it->second );
+                placements.push_back( write_model_placement( writer, module, model, layerZ ) );
+                placementNames.push_back( module->GetReference() );
+            }
+        }
+    }
+
+    // The instances of the parts, located by the transformation from their origin to
+    // their placement in the assembly
+    for( unsigned ii = 0; ii < placedParts.size(); ii++ )
+    {
+        STEP_PART*  part = placedParts[ii];
+        std::string name = stepString( placementNames[ii] );
+
+        assemblyItems.push_back( placements[ii] );
+
+        int transformation = writer.Entity( "ITEM_DEFINED_TRANSFORMATION('','',#%d,#%d)",
+                                            part->m_origin, placements[ii] );
+        int relationship = writer.Entity( "(REPRESENTATION_RELATIONSHIP('','',#%d,#%d)"
+                                          "REPRESENTATION_RELATIONSHIP_WITH_TRANSFORMATION(#%d)"
+                                          "SHAPE_REPRESENTATION_RELATIONSHIP())",
+                                          part->m_shape, assembly.m_shape, transformation );
+        int occurrence = writer.Entity( "NEXT_ASSEMBLY_USAGE_OCCURRENCE(%s,%s,'',#%d,#%d,$)",
+                                        name.c_str(), name.c_str(), assembly.m_definition,
+                                        part->m_definition );
+        int shape = writer.Entity( "PRODUCT_DEFINITION_SHAPE('','',#%d)", occurrence );
+
+        writer.Entity( "CONTEXT_DEPENDENT_SHAPE_REPRESENTATION(#%d,#%d)", relationship, shape );
+    }
+
+    writer.Begin( assembly.m_shape, "SHAPE_REPRESENTATION(''," );
+    writer.IdList( assemblyItems );
+    fprintf( file, ",#%d", context.m_geometry );
+    writer.End( ")" );
+
+    writer.WritePresentation( context.m_geometry );
+
+    fprintf( file, "ENDSEC;\nEND-ISO-10303-21;\n" );
+
+    bool ok = !ferror( file );
+
+    // the buffer of the file must outlive it
+    if( fclose( file ) != 0 )
+        ok = false;
+
+    return ok;
+}
+
+
+void PCB_EDIT_FRAME::OnExportSTEP( wxCommandEvent& event )
+{
+    wxFileName fn = GetBoard()->GetFileName();
+    wxString   wildcard = _( "STEP files (*.stp *.step)|*.stp;*.step" );
+
+    fn.SetExt( wxT( "stp" ) );
+
+    wxString pro_dir = wxPathOnly( Prj().GetProjectFullName() );
+
+    wxFileDialog dlg( this, _( "Export STEP File" ), pro_dir,
+                      fn.GetFullName(), wildcard,
+                      wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( dlg.ShowModal() == wxID_CANCEL )
+        return;
+
+    wxBusyCursor dummy;
+
+    if( !ExportSTEP_File( dlg.GetPath(), true ) )
+    {
+        wxString msg;
+        msg.Printf( _( "Unable to create file '%s'" ), GetChars( dlg.GetPath() ) );
+        DisplayError( this, msg );
+    }
+}
@@ -36,6 +36,9 @@
 #include <exception>
 #include <fstream>
 #include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread_pool.h>
 
 #include <pcbnew.h>
 
@@ -53,12 +56,18 @@
 #include <cmath>
 #include <vrml_layer.h>
 
+#include <boost/bind.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+
 // minimum width (mm) of a VRML line
 #define MIN_VRML_LINEWIDTH 0.12
 
 // offset for art layers, mm (silk, paste, etc)
 #define  ART_OFFSET 0.025
 
+// size of the buffer of the output file
+#define VRML_OUTPUT_BUFFER_SIZE ( 1 << 20 )
+
 
 struct VRML_COLOR
 {
@@ -128,6 +137,19 @@ enum VRML_COLOR_INDEX
 };
 
 
+// A pad or via shape, tesselated once and instanced by DEF/USE at each of its positions
+struct VRML_PROTOTYPE
+{
+    VRML_LAYER          layer;      // the shape, around the origin
+    VRML_COLOR_INDEX    color;
+    bool                top;        // true if the shape is visible from above
+    double              z;          // the Z coordinate of the shape
+
+    // the positions of the instances, in the coordinates of the layers
+    std::vector< std::pair<double, double> > positions;
+};
+
+
 class MODEL_VRML
 {
 private:
@@ -162,6 +184,10 @@ public:
     LAYER_NUM s_text_layer;
     int s_text_width;
 
+    // the pad and via prototypes, in creation order, and by key
+    boost::ptr_vector<VRML_PROTOTYPE>           prototypes;
+    std::map<std::string, VRML_PROTOTYPE*>      prototypeMap;
+
     MODEL_VRML()
     {
         for( unsigned i = 0; i < DIM( layer_z );  ++i )
@@ -197,6 +223,34 @@ public:
         return colors[aIndex];
     }
 
+    // return the prototype of the shape described by aKey; aCreated is set to true
+    // if it is a new one, which has to be filled by the caller
+    VRML_PROTOTYPE* GetPrototype( const std::string& aKey, bool* aCreated )
+    {
+        std::map<std::string, VRML_PROTOTYPE*>::iterator it = prototypeMap.find( aKey );
+
+        *aCreated = ( it == prototypeMap.end() );
+
+        if( !*aCreated )
+            return it->second;
+
+        VRML_PROTOTYPE* proto = new VRML_PROTOTYPE;
+        int     maxSeg;
+        double  minLen, maxLen;
+
+        // the arc parameters of the layers, as set by SetScale()
+        holes.GetArcParams( maxSeg, minLen, maxLen );
+        proto->layer.SetArcParams( maxSeg, minLen, maxLen );
+        proto->color = VRML_COLOR_TIN;
+        proto->top = true;
+        proto->z = 0;
+
+        prototypes.push_back( proto );
+        prototypeMap[aKey] = proto;
+
+        return proto;
+    }
+
     void SetOffset( double aXoff, double aYoff )
     {
         tx = aXoff;
@@ -300,162 +354,264 @@ static bool GetLayer( MODEL_VRML& aModel, LAYER_NUM layer, VRML_LAYER** vlayer )
 }
 
 
-static void write_triangle_bag( std::ofstream& output_file, VRML_COLOR& color,
+// write a Shape node of the tesselated layer, named aDefName if not NULL
+static void write_shape( std::ostream& output_file, const char* aDefName, VRML_COLOR& color,
+                         VRML_LAYER* layer, bool plane, bool top,
+                         double top_z, double bottom_z, int aPrecision )
+{
+    output_file << "        ";
+
+    if( aDefName )
+        output_file << "DEF " << aDefName << " ";
+
+    output_file << "Shape {\n";
+    output_file << "          appearance Appearance {\n";
+    output_file << "            material Material {\n";
+
+    output_file << "              diffuseColor " << std::setprecision(3);
+    output_file << color.diffuse_red << " ";
+    output_file << color.diffuse_grn << " ";
+    output_file << color.diffuse_blu << "\n";
+
+    output_file << "              specularColor ";
+    output_file << color.spec_red << " ";
+    output_file << color.spec_grn << " ";
+    output_file << color.spec_blu << "\n";
+
+    output_file << "              emissiveColor ";
+    output_file << color.emit_red << " ";
+    output_file << color.emit_grn << " ";
+    output_file << color.emit_blu << "\n";
+
+    output_file << "              ambientIntensity " << color.ambient << "\n";
+    output_file << "              transparency " << color.transp << "\n";
+    output_file << "              shininess " << color.shiny << "\n";
+
+    output_file << "            }\n";
+    output_file << "          }\n";
+    output_file << "          geometry IndexedFaceSet {\n";
+    output_file << "            solid TRUE\n";
+    output_file << "            coord Coordinate {\n";
+    output_file << "              point [\n";
+
+    if( plane )
+        layer->WriteVertices( top_z, output_file, aPrecision );
+    else
+        layer->Write3DVertices( top_z, bottom_z, output_file, aPrecision );
+
+    output_file << "\n";
+    output_file << "              ]\n";
+    output_file << "            }\n";
+    output_file << "            coordIndex [\n";
+
+    if( plane )
+        layer->WriteIndices( top, output_file );
+    else
+        layer->Write3DIndices( output_file );
+
+    output_file << "\n";
+    output_file << "            ]\n";
+    output_file << "          }\n";
+    output_file << "        }\n";
+}
+
+
+static void write_triangle_bag( std::ostream& output_file, VRML_COLOR& color,
                                 VRML_LAYER* layer, bool plane, bool top,
                                 double top_z, double bottom_z, int aPrecision )
 {
     /* A lot of nodes are not required, but blender sometimes chokes
      * without them */
-    static const char* shape_boiler[] =
-    {
-        "Transform {\n",
-        "  children [\n",
-        "    Group {\n",
-        "      children [\n",
-        "        Shape {\n",
-        "          appearance Appearance {\n",
-        "            material Material {\n",
-        0,                                      // Material marker
-        "            }\n",
-        "          }\n",
-        "          geometry IndexedFaceSet {\n",
-        "            solid TRUE\n",
-        "            coord Coordinate {\n",
-        "              point [\n",
-        0,                                      // Coordinates marker
-        "              ]\n",
-        "            }\n",
-        "            coordIndex [\n",
-        0,                                      // Index marker
-        "            ]\n",
-        "          }\n",
-        "        }\n",
-        "      ]\n",
-        "    }\n",
-        "  ]\n",
-        "}\n",
-        0    // End marker
-    };
-
-    int marker_found = 0, lineno = 0;
-
-    while( marker_found < 4 )
+    output_file << "Transform {\n";
+    output_file << "  children [\n";
+    output_file << "    Group {\n";
+    output_file << "      children [\n";
+
+    write_shape( output_file, NULL, color, layer, plane, top, top_z, bottom_z, aPrecision );
+
+    output_file << "      ]\n";
+    output_file << "    }\n";
+    output_file << "  ]\n";
+    output_file << "}\n";
+}
+
+
+// A shape of the output, a layer or a prototype, tesselated and formatted by a task
+struct VRML_SHAPE_JOB
+{
+    VRML_LAYER*     layer;
+    VRML_LAYER*     holes;      // the holes cut in the layer, or NULL
+    bool            holesOnly;  // true for the walls of the plated holes
+    VRML_COLOR*     color;
+    bool            plane;
+    bool            top;
+    double          top_z;
+    double          bottom_z;
+    std::string     defName;    // the DEF name of a prototype, empty for a layer
+    std::string     text;       // the formatted shape, empty if the tesselation failed
+
+    VRML_SHAPE_JOB( VRML_LAYER* aLayer, VRML_LAYER* aHoles, bool aHolesOnly,
+                    VRML_COLOR& aColor, bool aPlane, bool aTop,
+                    double aTopZ, double aBottomZ ) :
+        layer( aLayer ), holes( aHoles ), holesOnly( aHolesOnly ), color( &aColor ),
+        plane( aPlane ), top( aTop ), top_z( aTopZ ), bottom_z( aBottomZ )
     {
-        if( shape_boiler[lineno] )
-            output_file << shape_boiler[lineno];
-        else
-        {
-            marker_found++;
+    }
+};
 
-            switch( marker_found )
-            {
-            case 1:    // Material marker
-                output_file << "              diffuseColor " << std::setprecision(3);
-                output_file << color.diffuse_red << " ";
-                output_file << color.diffuse_grn << " ";
-                output_file << color.diffuse_blu << "\n";
-
-                output_file << "              specularColor ";
-                output_file << color.spec_red << " ";
-                output_file << color.spec_grn << " ";
-                output_file << color.spec_blu << "\n";
-
-                output_file << "              emissiveColor ";
-                output_file << color.emit_red << " ";
-                output_file << color.emit_grn << " ";
-                output_file << color.emit_blu << "\n";
-
-                output_file << "              ambientIntensity " << color.ambient << "\n";
-                output_file << "              transparency " << color.transp << "\n";
-                output_file << "              shininess " << color.shiny << "\n";
-                break;
 
-            case 2:
+static void build_shape( VRML_SHAPE_JOB* aJob, int aPrecision )
+{
+    // an empty layer or shape is not written
+    if( !aJob->layer->Tesselate( aJob->holes, aJob->holesOnly ) )
+        return;
 
-                if( plane )
-                    layer->WriteVertices( top_z, output_file, aPrecision );
-                else
-                    layer->Write3DVertices( top_z, bottom_z, output_file, aPrecision );
+    std::ostringstream out;
 
-                output_file << "\n";
-                break;
+    if( aJob->defName.empty() )
+        write_triangle_bag( out, *aJob->color, aJob->layer, aJob->plane, aJob->top,
+                            aJob->top_z, aJob->bottom_z, aPrecision );
+    else
+        write_shape( out, aJob->defName.c_str(), *aJob->color, aJob->layer, aJob->plane,
+                     aJob->top, aJob->top_z, aJob->bottom_z, aPrecision );
 
-            case 3:
+    aJob->text = out.str();
+}
 
-                if( plane )
-                    layer->WriteIndices( top, output_file );
-                else
-                    layer->Write3DIndices( output_file );
 
-                output_file << "\n";
-                break;
+// write the instances of a prototype: the first one defines its shape
+static void write_instances( MODEL_VRML& aModel, std::ostream& output_file,
+                             const VRML_PROTOTYPE& aProto, const VRML_SHAPE_JOB& aJob )
+{
+    std::ostringstream pos;
 
-            default:
-                break;
-            }
-        }
+    pos << std::fixed << std::setprecision( aModel.precision );
+
+    for( unsigned i = 0; i < aProto.positions.size(); ++i )
+    {
+        pos.str( "" );
+        pos << ( aProto.positions[i].first + aModel.tx ) << " "
+            << ( aProto.positions[i].second - aModel.ty ) << " 0";
+
+        output_file << "Transform {\n";
+        output_file << "  translation " << pos.str() << "\n";
+        output_file << "  children [\n";
+
+        if( i == 0 )
+            output_file << aJob.text;
+        else
+            output_file << "        USE " << aJob.defName << "\n";
 
-        lineno++;
+        output_file << "  ]\n";
+        output_file << "}\n";
     }
 }
 
 
 static void write_layers( MODEL_VRML& aModel, std::ofstream& output_file, BOARD* aPcb )
 {
-    // VRML_LAYER board;
-    aModel.board.Tesselate( &aModel.holes );
+    std::vector<VRML_SHAPE_JOB>     jobs;
+    boost::ptr_vector<VRML_LAYER>   holeCopies;
+
     double brdz = aModel.board_thickness / 2.0
                   - ( Millimeter2iu( ART_OFFSET / 2.0 ) ) * aModel.scale;
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_PCB ),
-                        &aModel.board, false, false, brdz, -brdz, aModel.precision );
+    double tinz = Millimeter2iu( ART_OFFSET / 2.0 ) * aModel.scale;
 
-    if( aModel.plainPCB )
-        return;
+    // The Tesselate() of a layer renumbers the vertices of its holes: the layers are
+    // tesselated concurrently, each one with its own copy of the holes, made before any
+    // tesselation.  One copy for each of top copper, top tin, bottom copper, bottom tin,
+    // top silk and bottom silk; the board uses the holes themselves.
+    VRML_LAYER* holes[6];
+
+    for( unsigned i = 0; i < DIM( holes ); ++i )
+    {
+        holes[i] = NULL;
 
-    // VRML_LAYER top_copper;
-    aModel.top_copper.Tesselate( &aModel.holes );
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_TRACK ),
-                        &aModel.top_copper, true, true,
-                        aModel.GetLayerZ( F_Cu ), 0, aModel.precision );
-
-    // VRML_LAYER top_tin;
-    aModel.top_tin.Tesselate( &aModel.holes );
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_TIN ),
-                        &aModel.top_tin, true, true,
-                        aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * aModel.scale,
-                        0, aModel.precision );
-
-    // VRML_LAYER bot_copper;
-    aModel.bot_copper.Tesselate( &aModel.holes );
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_TRACK ),
-                        &aModel.bot_copper, true, false,
-                        aModel.GetLayerZ( B_Cu ), 0, aModel.precision );
-
-    // VRML_LAYER bot_tin;
-    aModel.bot_tin.Tesselate( &aModel.holes );
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_TIN ),
-                        &aModel.bot_tin, true, false,
-                        aModel.GetLayerZ( B_Cu )
-                        - Millimeter2iu( ART_OFFSET / 2.0 ) * aModel.scale,
-                        0, aModel.precision );
-
-    // VRML_LAYER PTH;
-    aModel.plated_holes.Tesselate( NULL, true );
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_TIN ),
-                        &aModel.plated_holes, false, false,
-                        aModel.GetLayerZ( F_Cu ) + Millimeter2iu( ART_OFFSET / 2.0 ) * aModel.scale,
-                        aModel.GetLayerZ( B_Cu ) - Millimeter2iu( ART_OFFSET / 2.0 ) * aModel.scale,
-                        aModel.precision );
-
-    // VRML_LAYER top_silk;
-    aModel.top_silk.Tesselate( &aModel.holes );
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_SILK ), &aModel.top_silk,
-                        true, true, aModel.GetLayerZ( F_SilkS ), 0, aModel.precision );
-
-    // VRML_LAYER bot_silk;
-    aModel.bot_silk.Tesselate( &aModel.holes );
-    write_triangle_bag( output_file, aModel.GetColor( VRML_COLOR_SILK ), &aModel.bot_silk,
-                        true, false, aModel.GetLayerZ( B_SilkS ), 0, aModel.precision );
+        if( aModel.plainPCB )
+            continue;
+
+        holeCopies.push_back( new VRML_LAYER );
+        holeCopies.back().AddContours( aModel.holes );
+        holes[i] = &holeCopies.back();
+    }
+
+    // VRML_LAYER board;
+    jobs.push_back( VRML_SHAPE_JOB( &aModel.board, &aModel.holes, false,
+                                    aModel.GetColor( VRML_COLOR_PCB ),
+                                    false, false, brdz, -brdz ) );
+
+    if( !aModel.plainPCB )
+    {
+        // VRML_LAYER top_copper;
+        jobs.push_back( VRML_SHAPE_JOB( &aModel.top_copper, holes[0], false,
+                                        aModel.GetColor( VRML_COLOR_TRACK ),
+                                        true, true, aModel.GetLayerZ( F_Cu ), 0 ) );
+
+        // VRML_LAYER top_tin;
+        jobs.push_back( VRML_SHAPE_JOB( &aModel.top_tin, holes[1], false,
+                                        aModel.GetColor( VRML_COLOR_TIN ),
+                                        true, true, aModel.GetLayerZ( F_Cu ) + tinz, 0 ) );
+
+        // VRML_LAYER bot_copper;
+        jobs.push_back( VRML_SHAPE_JOB( &aModel.bot_copper, holes[2], false,
+                                        aModel.GetColor( VRML_COLOR_TRACK ),
+                                        true, false, aModel.GetLayerZ( B_Cu ), 0 ) );
+
+        // VRML_LAYER bot_tin;
+        jobs.push_back( VRML_SHAPE_JOB( &aModel.bot_tin, holes[3], false,
+                                        aModel.GetColor( VRML_COLOR_TIN ),
+                                        true, false, aModel.GetLayerZ( B_Cu ) - tinz, 0 ) );
+
+        // VRML_LAYER PTH;
+        jobs.push_back( VRML_SHAPE_JOB( &aModel.plated_holes, NULL, true,
+                                        aModel.GetColor( VRML_COLOR_TIN ),
+                                        false, false, aModel.GetLayerZ( F_Cu ) + tinz,
+                                        aModel.GetLayerZ( B_Cu ) - tinz ) );
+
+        // VRML_LAYER top_silk;
+        jobs.push_back( VRML_SHAPE_JOB( &aModel.top_silk, holes[4], false,
+                                        aModel.GetColor( VRML_COLOR_SILK ),
+                                        true, true, aModel.GetLayerZ( F_SilkS ), 0 ) );
+
+        // VRML_LAYER bot_silk;
+        jobs.push_back( VRML_SHAPE_JOB( &aModel.bot_silk, holes[5], false,
+                                        aModel.GetColor( VRML_COLOR_SILK ),
+                                        true, false, aModel.GetLayerZ( B_SilkS ), 0 ) );
+    }
+
+    unsigned firstPrototype = jobs.size();
+
+    for( unsigned i = 0; i < aModel.prototypes.size(); ++i )
+    {
+        VRML_PROTOTYPE& proto = aModel.prototypes[i];
+
+        jobs.push_back( VRML_SHAPE_JOB( &proto.layer, NULL, false,
+                                        aModel.GetColor( proto.color ),
+                                        true, proto.top, proto.z, 0 ) );
+
+        std::ostringstream name;
+        name << "PROTO_" << i;
+        jobs.back().defName = name.str();
+    }
+
+    // The jobs must not move once the tasks are queued
+    {
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned i = 0; i < jobs.size(); ++i )
+            tasks.Run( boost::bind( build_shape, &jobs[i], aModel.precision ) );
+
+        tasks.Wait();
+    }
+
+    for( unsigned i = 0; i < firstPrototype; ++i )
+        output_file << jobs[i].text;
+
+    for( unsigned i = firstPrototype; i < jobs.size(); ++i )
+    {
+        if( !jobs[i].text.empty() )
+            write_instances( aModel, output_file, aModel.prototypes[i - firstPrototype], jobs[i] );
+    }
 }
 
 
@@ -821,8 +977,42 @@ static void export_vrml_via( MODEL_VRML& aModel, BOARD* pcb, const VIA* via )
     if( top_layer != F_Cu && bottom_layer != B_Cu )
         return;
 
-    // Export the via padstack
-    export_round_padstack( aModel, pcb, x, y, r, bottom_layer, top_layer, hole );
+    if( top_layer != F_Cu || bottom_layer != B_Cu || aModel.plainPCB )
+    {
+        // Export the via padstack
+        export_round_padstack( aModel, pcb, x, y, r, bottom_layer, top_layer, hole );
+        return;
+    }
+
+    // The copper of a thru via is instanced from a prototype, the annulus of its width
+    // and drill; its hole is cut in the board and in the other items
+    if( hole > 0 )
+        aModel.holes.AddCircle( x, -y, hole, true );
+
+    for( int side = 0; side < 2; ++side )
+    {
+        LAYER_ID layer = side == 0 ? F_Cu : B_Cu;
+        std::ostringstream key;
+        bool created;
+
+        key << "via " << via->GetWidth() << " " << via->GetDrillValue() << " " << layer;
+
+        VRML_PROTOTYPE* proto = aModel.GetPrototype( key.str(), &created );
+
+        if( created )
+        {
+            proto->layer.AddCircle( 0, 0, r );
+
+            if( hole > 0 )
+                proto->layer.AddCircle( 0, 0, hole, true );
+
+            proto->color = VRML_COLOR_TRACK;
+            proto->top = ( layer == F_Cu );
+            proto->z = aModel.GetLayerZ( layer );
+        }
+
+        proto->positions.push_back( std::make_pair( x, -y ) );
+    }
 }
 
 
@@ -975,10 +1165,11 @@ static void export_vrml_edge_module( MODEL_VRML& aModel, EDGE_MODULE* aOutline,
 }
 
 
+// add the shape of a pad to aTinLayer, around the pad position
 static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_PAD* aPad )
 {
-    // The (maybe offset) pad position
-    wxPoint pad_pos = aPad->ShapePos();
+    // The (maybe offset) pad position, relative to the pad position
+    wxPoint pad_pos = aPad->ShapePos() - aPad->GetPosition();
     double  pad_x   = pad_pos.x * aModel.scale;
     double  pad_y   = pad_pos.y * aModel.scale;
     wxSize  pad_delta = aPad->GetDelta();
@@ -1059,6 +1250,55 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
 }
 
 
+// add an instance of the prototype of a pad on the aLayer copper side; the pads of the
+// same shape, orientation and drill share their prototype
+static void export_vrml_pad_instance( MODEL_VRML& aModel, D_PAD* aPad, LAYER_ID aLayer )
+{
+    wxPoint offset = aPad->ShapePos() - aPad->GetPosition();
+    std::ostringstream key;
+    bool created;
+
+    key << "pad " << aPad->GetShape()
+        << " " << aPad->GetSize().x << " " << aPad->GetSize().y
+        << " " << aPad->GetDelta().x << " " << aPad->GetDelta().y
+        << " " << aPad->GetOrientation() << " " << offset.x << " " << offset.y
+        << " " << aPad->GetDrillShape()
+        << " " << aPad->GetDrillSize().x << " " << aPad->GetDrillSize().y
+        << " " << aLayer;
+
+    VRML_PROTOTYPE* proto = aModel.GetPrototype( key.str(), &created );
+
+    if( created )
+    {
+        export_vrml_padshape( aModel, &proto->layer, aPad );
+
+        // the pad hole is cut in the prototype
+        double hole_drill_w = (double) aPad->GetDrillSize().x * aModel.scale / 2.0;
+        double hole_drill_h = (double) aPad->GetDrillSize().y * aModel.scale / 2.0;
+        double hole_drill   = std::min( hole_drill_w, hole_drill_h );
+
+        if( hole_drill > 0 )
+        {
+            if( aPad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG )
+                proto->layer.AddSlot( 0, 0, hole_drill_w * 2.0, hole_drill_h * 2.0,
+                                      aPad->GetOrientation()/10.0, true );
+            else
+                proto->layer.AddCircle( 0, 0, hole_drill, true );
+        }
+
+        double tinz = Millimeter2iu( ART_OFFSET / 2.0 ) * aModel.scale;
+
+        proto->color = VRML_COLOR_TIN;
+        proto->top = ( aLayer == F_Cu );
+        proto->z = aLayer == F_Cu ? aModel.GetLayerZ( F_Cu ) + tinz
+                                  : aModel.GetLayerZ( B_Cu ) - tinz;
+    }
+
+    proto->positions.push_back( std::make_pair( aPad->GetPosition().x * aModel.scale,
+                                                -aPad->GetPosition().y * aModel.scale ) );
+}
+
+
 static void export_vrml_pad( MODEL_VRML& aModel, BOARD* pcb, D_PAD* aPad )
 {
     double  hole_drill_w    = (double) aPad->GetDrillSize().x * aModel.scale / 2.0;
@@ -1105,14 +1345,10 @@ static void export_vrml_pad( MODEL_VRML& aModel, BOARD* pcb, D_PAD* aPad )
     LSET layer_mask = aPad->GetLayerSet();
 
     if( layer_mask[B_Cu] )
-    {
-        export_vrml_padshape( aModel, &aModel.bot_tin, aPad );
-    }
+        export_vrml_pad_instance( aModel, aPad, B_Cu );
 
     if( layer_mask[F_Cu] )
-    {
-        export_vrml_padshape( aModel, &aModel.top_tin, aPad );
-    }
+        export_vrml_pad_instance( aModel, aPad, F_Cu );
 }
 
 
@@ -1327,8 +1563,14 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
     model3d.plainPCB = aUsePlainPCB;
 
     model_vrml = &model3d;
+
+    // A large buffer for the output file, which must outlive it
+    std::vector<char> outputBuffer( VRML_OUTPUT_BUFFER_SIZE );
     std::ofstream output_file;
 
+    // takes effect only before the file is opened
+    output_file.rdbuf()->pubsetbuf( &outputBuffer[0], outputBuffer.size() );
+
     // Switch the locale to standard C (needed to print floating point numbers)
     LOCALE_IO toggle;
 
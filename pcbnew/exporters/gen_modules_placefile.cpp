@@ -366,7 +366,6 @@ static const char unit_text_inch[] = "## Unit = inches, Angle = deg.\n";
 static const double conv_unit_mm = 1.0 / IU_PER_MM;    // units = mm
 static const char unit_text_mm[] = "## Unit = mm, Angle = deg.\n";
 
-static wxPoint File_Place_Offset;  // Offset coordinates for generated file.
 
 
 // Sort function use by GenereModulesPosition()
@@ -425,7 +424,7 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
     int lenValText = 8;
     int lenPkgText = 16;
 
-    File_Place_Offset = GetAuxOrigin();
+    wxPoint placeOffset = GetAuxOrigin();  // Offset coordinates for generated file
 
     // Calculating the number of useful footprints (CMS attribute, not VIRTUAL)
     int footprintCount = 0;
@@ -515,7 +514,7 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
         {
             wxPoint  footprint_pos;
             footprint_pos  = list[ii].m_Module->GetPosition();
-            footprint_pos -= File_Place_Offset;
+            footprint_pos -= placeOffset;
 
             LAYER_NUM layer = list[ii].m_Module->GetLayer();
             wxASSERT( layer == F_Cu || layer == B_Cu );
@@ -572,7 +571,7 @@ int PCB_EDIT_FRAME::DoGenFootprintsPositionFile( const wxString& aFullFileName,
         {
             wxPoint  footprint_pos;
             footprint_pos  = list[ii].m_Module->GetPosition();
-            footprint_pos -= File_Place_Offset;
+            footprint_pos -= placeOffset;
 
             LAYER_NUM layer = list[ii].m_Module->GetLayer();
             wxASSERT( layer == F_Cu || layer == B_Cu );
@@ -642,7 +641,7 @@ bool PCB_EDIT_FRAME::DoGenFootprintsReport( const wxString& aFullFilename, bool
     FILE*    rptfile;
     wxPoint  module_pos;
 
-    File_Place_Offset = wxPoint( 0, 0 );
+    wxPoint placeOffset( 0, 0 );
 
     rptfile = wxFopen( aFullFilename, wxT( "wt" ) );
 
@@ -702,8 +701,8 @@ bool PCB_EDIT_FRAME::DoGenFootprintsReport( const wxString& aFullFilename, bool
         fputs( TO_UTF8( msg ), rptfile );
 
         module_pos    = Module->GetPosition();
-        module_pos.x -= File_Place_Offset.x;
-        module_pos.y -= File_Place_Offset.y;
+        module_pos.x -= placeOffset.x;
+        module_pos.y -= placeOffset.y;
 
         fprintf( rptfile, "position %9.6f %9.6f  orientation %.2f\n",
                  module_pos.x * conv_unit,
@@ -36,6 +36,8 @@
 
 #include <fctsys.h>
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include <plot_common.h>
@@ -56,6 +58,9 @@
 #include <wildcards_and_files_ext.h>
 #include <reporter.h>
 #include <collectors.h>
+#include <thread_pool.h>
+
+#include <boost/bind.hpp>
 
 // Comment/uncomment this to write or not a comment
 // in drill file when PTH and NPTH are merged to flag
@@ -72,6 +77,7 @@ EXCELLON_WRITER::EXCELLON_WRITER( BOARD* aPcb )
     m_unitsDecimal    = true;
     m_mirror = false;
     m_merge_PTH_NPTH = false;
+    m_optimizeToolPaths = false;
     m_minimalHeader = false;
     m_ShortHeader = false;
     m_mapFileFmt = PLOT_FORMAT_PDF;
@@ -79,7 +85,7 @@ EXCELLON_WRITER::EXCELLON_WRITER( BOARD* aPcb )
 }
 
 
-void EXCELLON_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
+bool EXCELLON_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
                                             bool aGenDrill, bool aGenMap,
                                             REPORTER * aReporter )
 {
@@ -92,79 +98,123 @@ void EXCELLON_WRITER::CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
     if( !m_merge_PTH_NPTH )
         hole_sets.push_back( LAYER_PAIR( F_Cu, B_Cu ) );
 
-    for( std::vector<LAYER_PAIR>::const_iterator it = hole_sets.begin();
-            it != hole_sets.end();  ++it )
+    // Each layer pair has its own writer, with its own hole and tool lists, so the
+    // lists of all the pairs are built, and their drill files written, in parallel.
+    std::vector<EXCELLON_WRITER> writers( hole_sets.size(), *this );
+    std::vector<FILE*>           files( hole_sets.size(), (FILE*) NULL );
+    unsigned                     setCount = hole_sets.size();
+
     {
-        LAYER_PAIR  pair = *it;
-        // For separate drill files, the last layer pair is the NPTH dril file.
-        bool doing_npth = m_merge_PTH_NPTH ? false : ( it == hole_sets.end() - 1 );
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
 
-        BuildHolesList( pair, doing_npth );
+        for( unsigned ii = 0; ii < hole_sets.size(); ii++ )
+        {
+            // For separate drill files, the last layer pair is the NPTH dril file.
+            bool doing_npth = m_merge_PTH_NPTH ? false : ( ii == hole_sets.size() - 1 );
+
+            tasks.Run( boost::bind( &EXCELLON_WRITER::BuildHolesList, &writers[ii],
+                                    hole_sets[ii], doing_npth ) );
+        }
 
-        // The file is created if it has holes, or if it is the non plated drill file
-        // to be sure the NPTH file is up to date in separate files mode.
-        if( GetHolesCount() > 0 || doing_npth )
+        tasks.Wait();
+    }
+
+    if( aGenDrill )
+    {
+        // The files are created in the layer pairs order, the generation stops at
+        // the first file which cannot be created.
+        for( unsigned ii = 0; ii < hole_sets.size(); ii++ )
         {
-            fn = drillFileName( pair, doing_npth );
+            bool doing_npth = m_merge_PTH_NPTH ? false : ( ii == hole_sets.size() - 1 );
+
+            // The file is created if it has holes, or if it is the non plated drill file
+            // to be sure the NPTH file is up to date in separate files mode.
+            if( writers[ii].GetHolesCount() == 0 && !doing_npth )
+                continue;
+
+            fn = drillFileName( hole_sets[ii], doing_npth );
             fn.SetPath( aPlotDirectory );
 
-            if( aGenDrill )
-            {
-                wxString fullFilename = fn.GetFullPath();
+            wxString fullFilename = fn.GetFullPath();
 
-                FILE* file = wxFopen( fullFilename, wxT( "w" ) );
+            files[ii] = wxFopen( fullFilename, wxT( "w" ) );
 
-                if( file == NULL )
+            if( files[ii] == NULL )
+            {
+                if( aReporter )
                 {
-                    if( aReporter )
-                    {
-                        msg.Printf(  _( "** Unable to create %s **\n" ),
-                                          GetChars( fullFilename ) );
-                        aReporter->Report( msg );
-                    }
-                    break;
+                    msg.Printf(  _( "** Unable to create %s **\n" ),
+                                      GetChars( fullFilename ) );
+                    aReporter->Report( msg );
                 }
-                else
+
+                setCount = ii;
+                break;
+            }
+            else
+            {
+                if( aReporter )
                 {
-                    if( aReporter )
-                    {
-                        msg.Printf( _( "Create file %s\n" ), GetChars( fullFilename ) );
-                        aReporter->Report( msg );
-                    }
+                    msg.Printf( _( "Create file %s\n" ), GetChars( fullFilename ) );
+                    aReporter->Report( msg );
                 }
-
-                CreateDrillFile( file );
             }
+        }
 
-            if( aGenMap )
-            {
-                fn.SetExt( wxEmptyString ); // Will be added by GenDrillMap
-                wxString fullfilename = fn.GetFullPath() + wxT( "-drl_map" );
-                fullfilename << wxT(".") << GetDefaultPlotExtension( m_mapFileFmt );
+        // CreateDrillFile() uses its own LOCALE_IO: set the C locale once for all
+        // the tasks, before they run.
+        LOCALE_IO  toggle;
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
 
-                bool success = GenDrillMapFile( fullfilename, m_mapFileFmt );
+        for( unsigned ii = 0; ii < setCount; ii++ )
+        {
+            if( files[ii] )
+                tasks.Run( boost::bind( &EXCELLON_WRITER::CreateDrillFile, &writers[ii],
+                                        files[ii] ) );
+        }
 
-                if( ! success )
-                {
-                    if( aReporter )
-                    {
-                        msg.Printf( _( "** Unable to create %s **\n" ), GetChars( fullfilename ) );
-                        aReporter->Report( msg );
-                    }
+        tasks.Wait();
+    }
 
-                    return;
-                }
-                else
-                {
-                    if( aReporter )
-                    {
-                        msg.Printf( _( "Create file %s\n" ), GetChars( fullfilename ) );
-                        aReporter->Report( msg );
-                    }
-                }
+    if( !aGenMap )
+        return setCount == hole_sets.size();
+
+    for( unsigned ii = 0; ii < setCount; ii++ )
+    {
+        bool doing_npth = m_merge_PTH_NPTH ? false : ( ii == hole_sets.size() - 1 );
+
+        if( writers[ii].GetHolesCount() == 0 && !doing_npth )
+            continue;
+
+        fn = drillFileName( hole_sets[ii], doing_npth );
+        fn.SetPath( aPlotDirectory );
+        fn.SetExt( wxEmptyString ); // Will be added by GenDrillMap
+        wxString fullfilename = fn.GetFullPath() + wxT( "-drl_map" );
+        fullfilename << wxT(".") << GetDefaultPlotExtension( m_mapFileFmt );
+
+        bool success = writers[ii].GenDrillMapFile( fullfilename, m_mapFileFmt );
+
+        if( ! success )
+        {
+            if( aReporter )
+            {
+                msg.Printf( _( "** Unable to create %s **\n" ), GetChars( fullfilename ) );
+                aReporter->Report( msg );
+            }
+
+            return false;
+        }
+        else
+        {
+            if( aReporter )
+            {
+                msg.Printf( _( "Create file %s\n" ), GetChars( fullfilename ) );
+                aReporter->Report( msg );
             }
         }
     }
+
+    return setCount == hole_sets.size();
 }
 
 
@@ -569,6 +619,183 @@ static bool CmpHoleSettings( const HOLE_INFO& a, const HOLE_INFO& b )
 }
 
 
+// The number of next holes tried by the 2-opt moves from each hole of a tool path,
+// and the max number of passes of these moves
+#define TWO_OPT_WINDOW  64
+#define TWO_OPT_PASSES  8
+
+
+static double holeDistance( const HOLE_INFO& a, const HOLE_INFO& b )
+{
+    return hypot( (double) a.m_Hole_Pos.x - b.m_Hole_Pos.x,
+                  (double) a.m_Hole_Pos.y - b.m_Hole_Pos.y );
+}
+
+
+/* Helper function for the drilling path optimization.
+ * Returns in aTour the holes of aHoles along a nearest neighbour tour from the first
+ * hole.  The holes are bucketed in a grid of about one hole per cell, and the cells
+ * are searched in growing rings around the current hole.
+ */
+static void nearestNeighbourTour( const std::vector<HOLE_INFO>& aHoles,
+                                  std::vector<unsigned>& aTour )
+{
+    EDA_RECT bbox( aHoles[0].m_Hole_Pos, wxSize( 0, 0 ) );
+
+    for( unsigned ii = 1; ii < aHoles.size(); ii++ )
+        bbox.Merge( aHoles[ii].m_Hole_Pos );
+
+    int    side = std::max( 1, (int) sqrt( (double) aHoles.size() ) );
+    double cellSize = std::max( 1.0, (double) std::max( bbox.GetWidth(), bbox.GetHeight() ) / side );
+    int    cols = (int) ( bbox.GetWidth() / cellSize ) + 1;
+    int    rows = (int) ( bbox.GetHeight() / cellSize ) + 1;
+
+    std::vector< std::vector<unsigned> > cells( cols * rows );
+    std::vector<int> cellCol( aHoles.size() );
+    std::vector<int> cellRow( aHoles.size() );
+
+    for( unsigned ii = 0; ii < aHoles.size(); ii++ )
+    {
+        cellCol[ii] = (int) ( ( aHoles[ii].m_Hole_Pos.x - bbox.GetX() ) / cellSize );
+        cellRow[ii] = (int) ( ( aHoles[ii].m_Hole_Pos.y - bbox.GetY() ) / cellSize );
+        cells[cellRow[ii] * cols + cellCol[ii]].push_back( ii );
+    }
+
+    aTour.clear();
+    aTour.reserve( aHoles.size() );
+
+    unsigned current = 0;
+
+    for( ;; )
+    {
+        // remove the current hole from its cell
+        std::vector<unsigned>& own = cells[cellRow[current] * cols + cellCol[current]];
+        own.erase( std::find( own.begin(), own.end(), current ) );
+        aTour.push_back( current );
+
+        if( aTour.size() == aHoles.size() )
+            break;
+
+        int     best = -1;
+        double  bestDist = 0.0;
+        int     maxRing = std::max( cols, rows );
+
+        for( int ring = 0; ring <= maxRing; ring++ )
+        {
+            // the holes of this ring and of the next ones are at least
+            // ( ring - 1 ) * cellSize away
+            if( best >= 0 && bestDist <= ( ring - 1 ) * cellSize )
+                break;
+
+            for( int row = cellRow[current] - ring; row <= cellRow[current] + ring; row++ )
+            {
+                if( row < 0 || row >= rows )
+                    continue;
+
+                // only the cells on the border of the ring are not yet searched
+                bool border = ( row == cellRow[current] - ring || row == cellRow[current] + ring );
+                int  step = ( border || ring == 0 ) ? 1 : 2 * ring;
+
+                for( int col = cellCol[current] - ring; col <= cellCol[current] + ring; col += step )
+                {
+                    if( col < 0 || col >= cols )
+                        continue;
+
+                    const std::vector<unsigned>& cell = cells[row * cols + col];
+
+                    for( unsigned jj = 0; jj < cell.size(); jj++ )
+                    {
+                        double dist = holeDistance( aHoles[current], aHoles[cell[jj]] );
+
+                        if( best < 0 || dist < bestDist )
+                        {
+                            best = cell[jj];
+                            bestDist = dist;
+                        }
+                    }
+                }
+            }
+        }
+
+        current = best;
+    }
+}
+
+
+/* Helper function for the drilling path optimization.
+ * Improves the open path aTour by 2-opt moves: the path between two holes is reversed
+ * when it makes the path shorter.  Only the moves between near positions in the path
+ * are tried, which keeps the time linear in the hole count.
+ */
+static void twoOptImprove( const std::vector<HOLE_INFO>& aHoles, std::vector<unsigned>& aTour )
+{
+    unsigned count = aTour.size();
+    bool     improved = true;
+
+    for( int pass = 0; improved && pass < TWO_OPT_PASSES; pass++ )
+    {
+        improved = false;
+
+        for( unsigned ii = 0; ii + 2 < count; ii++ )
+        {
+            const HOLE_INFO& a = aHoles[aTour[ii]];
+            const HOLE_INFO& b = aHoles[aTour[ii + 1]];
+            double           ab = holeDistance( a, b );
+
+            unsigned last = std::min( count - 1, ii + TWO_OPT_WINDOW );
+
+            for( unsigned jj = ii + 2; jj <= last; jj++ )
+            {
+                const HOLE_INFO& c = aHoles[aTour[jj]];
+
+                // the last hole of the path has no next hole
+                double delta = holeDistance( a, c ) - ab;
+
+                if( jj + 1 < count )
+                {
+                    const HOLE_INFO& d = aHoles[aTour[jj + 1]];
+                    delta += holeDistance( b, d ) - holeDistance( c, d );
+                }
+
+                if( delta < -1.0 )
+                {
+                    std::reverse( aTour.begin() + ii + 1, aTour.begin() + jj + 1 );
+                    improved = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+/* Helper function for the drilling path optimization.
+ * Reorders the holes [aFirst, aLast), holes of the same tool and shape, along a short
+ * drilling path, starting at the first hole in the position order.
+ */
+static void optimizeToolPath( std::vector<HOLE_INFO>::iterator aFirst,
+                              std::vector<HOLE_INFO>::iterator aLast )
+{
+    if( aLast - aFirst < 3 )
+        return;
+
+    std::vector<HOLE_INFO> holes( aFirst, aLast );
+    std::vector<unsigned>  tour;
+
+    nearestNeighbourTour( holes, tour );
+    twoOptImprove( holes, tour );
+
+    for( unsigned ii = 0; ii < tour.size(); ii++ )
+        *( aFirst + ii ) = holes[tour[ii]];
+}
+
+
+static bool isRoundHole( const HOLE_INFO& aHole )
+{
+    return aHole.m_Hole_Shape == 0;
+}
+
+
 void EXCELLON_WRITER::BuildHolesList( LAYER_PAIR aLayerPair,
                                       bool aGenerateNPTH_list )
 {
@@ -684,6 +911,30 @@ void EXCELLON_WRITER::BuildHolesList( LAYER_PAIR aLayerPair,
         if( m_holeListBuffer[ii].m_Hole_Shape )
             m_toolListBuffer.back().m_OvalCount++;
     }
+
+    if( !m_optimizeToolPaths )
+        return;
+
+    // The round holes and the oblong holes of a tool are drilled in separate passes,
+    // each of them gets its own path
+    std::vector<HOLE_INFO>::iterator first = m_holeListBuffer.begin();
+
+    while( first != m_holeListBuffer.end() )
+    {
+        std::vector<HOLE_INFO>::iterator last = first;
+
+        while( last != m_holeListBuffer.end()
+               && last->m_Tool_Reference == first->m_Tool_Reference )
+            ++last;
+
+        std::vector<HOLE_INFO>::iterator oblong =
+                std::stable_partition( first, last, isRoundHole );
+
+        optimizeToolPath( first, oblong );
+        optimizeToolPath( oblong, last );
+
+        first = last;
+    }
 }
 
 
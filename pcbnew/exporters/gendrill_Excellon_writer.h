@@ -148,6 +148,8 @@ private:
     bool                     m_mirror;
     wxPoint                  m_offset;                  // Drill offset coordinates
     bool                     m_merge_PTH_NPTH;          // True to generate only one drill file
+    bool                     m_optimizeToolPaths;       // True to sort the holes of each tool
+                                                        // along a short drilling path
     std::vector<HOLE_INFO>   m_holeListBuffer;          // Buffer containing holes
     std::vector<DRILL_TOOL>  m_toolListBuffer;          // Buffer containing tools
 
@@ -215,6 +217,14 @@ public:
         m_merge_PTH_NPTH = aMerge_PTH_NPTH;
     }
 
+    /**
+     * Function SetOptimizeToolPaths
+     * enables the ordering of the holes of each tool along a short path: a nearest
+     * neighbour tour, improved by 2-opt moves.  When disabled, the holes are sorted
+     * by position.
+     */
+    void SetOptimizeToolPaths( bool aOptimize ) { m_optimizeToolPaths = aOptimize; }
+
     /**
      * Function BuildHolesList
      * Create the list of holes and tools for a given board
@@ -237,12 +247,15 @@ public:
      * Function CreateDrillandMapFilesSet
      * Creates the full set of Excellon drill file for the board
      * filenames are computed from the board name, and layers id
+     * The drill files of the layer pairs are built and written in parallel, the map
+     * files are plotted afterwards.
      * @param aPlotDirectory = the output folder
      * @param aGenDrill = true to generate the EXCELLON drill file
      * @param aGenMap = true to generate a drill map file
      * @param aReporter = a REPORTER to return activity or any message (can be NULL)
+     * @return true if all the files are created
      */
-    void CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
+    bool CreateDrillandMapFilesSet( const wxString& aPlotDirectory,
                                     bool aGenDrill, bool aGenMap,
                                     REPORTER * aReporter = NULL );
 
@@ -55,6 +55,8 @@
 
 #include <wx/stdpaths.h>
 
+#include <boost/bind.hpp>
+
 
 //#define     USE_INSTRUMENTATION     1
 #define     USE_INSTRUMENTATION     0
@@ -310,6 +312,18 @@ void PCB_EDIT_FRAME::Files_io_from_id( int id )
         }
         break;
 
+    case ID_MENU_PCB_INCREMENTAL_SAVE:
+        // Journaled from the next full save of the board
+        m_incrementalSave = !m_incrementalSave;
+        break;
+
+    case ID_MENU_PCB_COMPACT_BOARD:
+        // Merge the journal into the board file
+        if( !GetBoard()->GetFileName().IsEmpty() )
+            SavePcbFile( Prj().AbsolutePath( GetBoard()->GetFileName() ) );
+
+        break;
+
     case ID_NEW_BOARD:
     {
         if( !Clear_Pcb( true ) )
@@ -331,7 +345,9 @@ void PCB_EDIT_FRAME::Files_io_from_id( int id )
     case ID_SAVE_BOARD:
         if( ! GetBoard()->GetFileName().IsEmpty() )
         {
-            SavePcbFile( Prj().AbsolutePath( GetBoard()->GetFileName() ) );
+            if( !m_incrementalSave || !SavePcbJournal() )
+                SavePcbFile( Prj().AbsolutePath( GetBoard()->GetFileName() ) );
+
             break;
         }
     // Fall through
@@ -521,6 +537,23 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
             return false;
         }
 
+        // Replay the changes saved incrementally since the board file was written
+        int journalRecords = 0;
+
+        if( pluginType == IO_MGR::KICAD )
+        {
+            wxString errors;
+
+            journalRecords = m_journal.Open( loadedBoard, fullFileName, &errors );
+
+            if( !errors.IsEmpty() )
+                DisplayError( this, errors );
+        }
+        else
+        {
+            m_journal.Stop();
+        }
+
         SetBoard( loadedBoard );
 
         // we should not ask PLUGINs to do these items:
@@ -535,6 +568,13 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
 
         GetScreen()->ClrModify();
 
+        // Without incremental save, the next save merges the journal into the board file
+        if( journalRecords > 0 && !m_incrementalSave )
+        {
+            GetScreen()->SetModify();
+            m_journal.Stop();
+        }
+
         {
             wxFileName fn = fullFileName;
             CheckForAutoSaveFile( fullFileName, fn.GetExt() );
@@ -596,6 +636,9 @@ bool PCB_EDIT_FRAME::OpenProjectFiles( const std::vector<wxString>& aFileSet, in
         wxBusyCursor dummy;    // Displays an Hourglass while building connectivity
         Compile_Ratsnest( NULL, true );
         GetBoard()->GetRatsnest()->ProcessBoard();
+
+        // Measured with the connectivity, the net list dialog shows the lengths at once
+        GetBoard()->GetNetLengths();
     }
 
     SetMsgPanel( GetBoard() );
@@ -739,7 +782,10 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     if( aCreateBackupFile )
         UpdateFileHistory( GetBoard()->GetFileName() );
 
-    // Delete auto save file on successful save.
+    // Delete auto save file on successful save, once an auto save still being written
+    // is done with it.
+    m_autoSaveTasks.Wait();
+
     wxFileName autoSaveFileName = pcbFileName;
 
     autoSaveFileName.SetName( wxString( autosavePrefix ) + pcbFileName.GetName() );
@@ -747,6 +793,17 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     if( autoSaveFileName.FileExists() )
         wxRemoveFile( autoSaveFileName.GetFullPath() );
 
+    // The board file holds the changes of its journal now
+    wxString journalFileName = BOARD_JOURNAL::GetFileName( pcbFileName.GetFullPath() );
+
+    if( wxFileName::FileExists( journalFileName ) )
+        wxRemoveFile( journalFileName );
+
+    if( m_incrementalSave )
+        m_journal.Start( GetBoard(), pcbFileName.GetFullPath() );
+    else
+        m_journal.Stop();
+
     if( !!backupFileName )
         upperTxt.Printf( _( "Backup file: '%s'" ), GetChars( backupFileName ) );
 
@@ -760,6 +817,48 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
 }
 
 
+bool PCB_EDIT_FRAME::SavePcbJournal()
+{
+    wxString boardFileName = Prj().AbsolutePath( GetBoard()->GetFileName() );
+
+    // The auto save file is deleted below, once written
+    m_autoSaveTasks.Wait();
+
+    GetBoard()->m_Status_Pcb &= ~CONNEXION_OK;
+    GetBoard()->SynchronizeNetsAndNetClasses();
+    SetCurrentNetClass( NETCLASS::Default );
+
+    try
+    {
+        if( !m_journal.Append( GetBoard(), boardFileName ) )
+            return false;
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        // Saved in full instead
+        wxLogDebug( wxT( "%s" ), GetChars( ioe.errorText ) );
+        return false;
+    }
+
+    wxFileName autoSaveFileName = boardFileName;
+
+    autoSaveFileName.SetName( wxString( autosavePrefix ) + autoSaveFileName.GetName() );
+
+    if( autoSaveFileName.FileExists() )
+        wxRemoveFile( autoSaveFileName.GetFullPath() );
+
+    ClearMsgPanel();
+    AppendMsgPanel( wxEmptyString,
+                    wxString::Format( _( "Wrote board journal: '%s'" ),
+                                      GetChars( BOARD_JOURNAL::GetFileName( boardFileName ) ) ),
+                    CYAN );
+
+    GetScreen()->ClrModify();
+    GetScreen()->ClrSave();
+    return true;
+}
+
+
 bool PCB_EDIT_FRAME::SavePcbCopy( const wxString& aFileName )
 {
     wxFileName  pcbFileName = aFileName;
@@ -814,28 +913,76 @@ bool PCB_EDIT_FRAME::SavePcbCopy( const wxString& aFileName )
 
 bool PCB_EDIT_FRAME::doAutoSave()
 {
-    wxFileName tmpFileName = Prj().AbsolutePath( GetBoard()->GetFileName() );
-    wxFileName fn = tmpFileName;
+    // The previous auto save is still being written
+    if( !m_autoSaveTasks.WaitFor( 0 ) )
+        return false;
+
+    wxFileName fn = Prj().AbsolutePath( GetBoard()->GetFileName() );
 
     // Auto save file name is the normal file name prepended with
     // autosaveFilePrefix string.
     fn.SetName( wxString( autosavePrefix ) + fn.GetName() );
 
+    if( fn.GetExt() == LegacyPcbFileExtension )
+        fn.SetExt( KiCadPcbFileExtension );
+
     wxLogTrace( traceAutoSave,
                 wxT( "Creating auto save file <" + fn.GetFullPath() ) + wxT( ">" ) );
 
-    if( !fn.IsOk() )
+    if( !fn.IsOk() || !IsWritable( fn ) )
         return false;
-    else if( SavePcbFile( fn.GetFullPath(), NO_BACKUP_FILE ) )
+
+    // As SavePcbFile() before writing the file
+    GetBoard()->m_Status_Pcb &= ~CONNEXION_OK;
+    GetBoard()->SynchronizeNetsAndNetClasses();
+    SetCurrentNetClass( NETCLASS::Default );
+
+    // The board is copied on the GUI thread, the copy is written on the thread pool
+    // while the board is edited
+    BOARD* snapshot = GetBoard()->Snapshot();
+
+    m_autoSaveTasks.Run( boost::bind( &PCB_EDIT_FRAME::writeAutoSaveFile, this, snapshot,
+                                      fn.GetFullPath() ) );
+
+    // The changes made from now on are saved by the next auto save
+    GetScreen()->ClrSave();
+    m_autoSaveState = false;
+    return true;
+}
+
+
+void PCB_EDIT_FRAME::writeAutoSaveFile( BOARD* aBoard, const wxString& aFileName )
+{
+    wxString error;
+
+    try
     {
-        GetScreen()->SetModify();
-        GetBoard()->SetFileName( tmpFileName.GetFullPath() );
-        UpdateTitle();
-        m_autoSaveState = false;
-        return true;
+        PLUGIN::RELEASER    pi( IO_MGR::PluginFind( IO_MGR::KICAD ) );
+
+        pi->Save( aFileName, aBoard, NULL );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        error = wxString::Format( _( "Error saving board file '%s'.\n%s" ),
+                                  GetChars( aFileName ), GetChars( ioe.errorText ) );
+    }
+
+    delete aBoard;
+
+    CallAfter( boost::bind( &PCB_EDIT_FRAME::onAutoSaveDone, this, error ) );
+}
+
+
+void PCB_EDIT_FRAME::onAutoSaveDone( const wxString& aError )
+{
+    if( aError.IsEmpty() )
+    {
+        wxLogTrace( traceAutoSave, wxT( "Auto save file written." ) );
+        return;
     }
 
-    GetBoard()->SetFileName( tmpFileName.GetFullPath() );
+    DisplayError( this, aError );
 
-    return false;
+    // Saved again at the next auto save interval
+    GetScreen()->SetSave();
 }
@@ -0,0 +1,104 @@
+/**
+ * @file fill_hash.h
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef _FILL_HASH_H
+#define _FILL_HASH_H
+
+#include <stdint.h>
+
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+#include <macros.h>
+#include <math/vector2d.h>
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * Class FILL_HASH
+ * computes a 64 bit FNV-1a hash.  The values are hashed byte per byte, the least significant
+ * byte first, so that the hash does not depend on the platform.  It hashes the zone fills,
+ * and the geometry of the items whose clearance shapes are kept by BOARD_ITEM_INDEX.
+ */
+class FILL_HASH
+{
+public:
+    FILL_HASH() : m_hash( 0xcbf29ce484222325ULL ) {}
+
+    void Add( int64_t aValue )
+    {
+        uint64_t value = aValue;
+
+        for( int ii = 0; ii < 8; ii++, value >>= 8 )
+        {
+            m_hash ^= value & 0xff;
+            m_hash *= 0x100000001b3ULL;
+        }
+    }
+
+    void Add( const VECTOR2I& aPoint )
+    {
+        Add( aPoint.x );
+        Add( aPoint.y );
+    }
+
+    void Add( const wxPoint& aPoint )
+    {
+        Add( aPoint.x );
+        Add( aPoint.y );
+    }
+
+    void Add( const wxString& aText )
+    {
+        std::string text = TO_UTF8( aText );
+
+        Add( (int64_t) text.size() );
+
+        for( unsigned ii = 0; ii < text.size(); ii++ )
+            Add( (unsigned char) text[ii] );
+    }
+
+    void Add( const SHAPE_POLY_SET::POLYGON& aPolygon )
+    {
+        for( unsigned ii = 0; ii < aPolygon.size(); ii++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = aPolygon[ii];
+
+            Add( chain.PointCount() );
+
+            for( int jj = 0; jj < chain.PointCount(); jj++ )
+                Add( chain.CPoint( jj ) );
+        }
+    }
+
+    uint64_t Get() const { return m_hash; }
+
+private:
+    uint64_t m_hash;
+};
+
+#endif    // _FILL_HASH_H
@@ -0,0 +1,211 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_viewer_cache.cpp
+ */
+
+#include <fctsys.h>
+#include <fp_lib_table.h>
+#include <class_module.h>
+
+#include <footprint_viewer_cache.h>
+
+#include <boost/bind.hpp>
+
+
+/// The number of footprints kept, enough for the neighbours of the selected footprint
+#define CACHED_FOOTPRINTS   64
+
+
+FOOTPRINT_VIEWER_CACHE::FOOTPRINT_VIEWER_CACHE( THREAD_POOL& aPool ) :
+    m_table( NULL ),
+    m_running( false ),
+    m_tasks( aPool )
+{
+}
+
+
+FOOTPRINT_VIEWER_CACHE::~FOOTPRINT_VIEWER_CACHE()
+{
+    Clear();
+}
+
+
+void FOOTPRINT_VIEWER_CACHE::Clear()
+{
+    {
+        boost::mutex::scoped_lock lock( m_lock );
+
+        m_pending.clear();
+    }
+
+    // loadPending() returns after the footprint it is loading
+    m_tasks.Wait();
+
+    boost::mutex::scoped_lock lock( m_lock );
+
+    for( MODULES::iterator it = m_modules.begin(); it != m_modules.end(); ++it )
+        delete it->second;
+
+    m_modules.clear();
+    m_order.clear();
+}
+
+
+void FOOTPRINT_VIEWER_CACHE::setLibrary( FP_LIB_TABLE* aTable, const wxString& aNickname )
+{
+    if( aTable == m_table && aNickname == m_nickname )
+        return;
+
+    // No task runs once cleared, m_table and m_nickname can change
+    Clear();
+
+    m_table = aTable;
+    m_nickname = aNickname;
+}
+
+
+void FOOTPRINT_VIEWER_CACHE::store( const wxString& aFootprintName, MODULE* aModule )
+{
+    m_modules[aFootprintName] = aModule;
+    m_order.push_back( aFootprintName );
+
+    while( m_order.size() > CACHED_FOOTPRINTS )
+    {
+        MODULES::iterator it = m_modules.find( m_order.front() );
+
+        delete it->second;
+        m_modules.erase( it );
+        m_order.pop_front();
+    }
+}
+
+
+MODULE* FOOTPRINT_VIEWER_CACHE::Load( FP_LIB_TABLE* aTable, const wxString& aNickname,
+                                      const wxString& aFootprintName )
+{
+    setLibrary( aTable, aNickname );
+
+    {
+        boost::mutex::scoped_lock lock( m_lock );
+        MODULES::const_iterator it = m_modules.find( aFootprintName );
+
+        if( it != m_modules.end() )
+            return it->second ? new MODULE( *it->second ) : NULL;
+    }
+
+    boost::mutex::scoped_lock loadLock( m_loadLock );
+
+    {
+        // The background task may have loaded it meanwhile
+        boost::mutex::scoped_lock lock( m_lock );
+        MODULES::const_iterator it = m_modules.find( aFootprintName );
+
+        if( it != m_modules.end() )
+            return it->second ? new MODULE( *it->second ) : NULL;
+    }
+
+    MODULE* module = m_table->FootprintLoad( m_nickname, aFootprintName );
+
+    // As PCB_BASE_FRAME::loadFootprint(), to be sure there is no broken link to any
+    // netinfo list
+    if( module )
+        module->ClearAllNets();
+
+    boost::mutex::scoped_lock lock( m_lock );
+
+    store( aFootprintName, module );
+
+    return module ? new MODULE( *module ) : NULL;
+}
+
+
+void FOOTPRINT_VIEWER_CACHE::Prefetch( FP_LIB_TABLE* aTable, const wxString& aNickname,
+                                       const std::vector<wxString>& aFootprintNames )
+{
+    setLibrary( aTable, aNickname );
+
+    boost::mutex::scoped_lock lock( m_lock );
+
+    m_pending.assign( aFootprintNames.begin(), aFootprintNames.end() );
+
+    if( !m_running && !m_pending.empty() )
+    {
+        m_running = true;
+        m_tasks.Run( boost::bind( &FOOTPRINT_VIEWER_CACHE::loadPending, this ) );
+    }
+}
+
+
+void FOOTPRINT_VIEWER_CACHE::loadPending()
+{
+    for( ;; )
+    {
+        wxString name;
+
+        {
+            boost::mutex::scoped_lock lock( m_lock );
+
+            if( m_pending.empty() )
+            {
+                m_running = false;
+                return;
+            }
+
+            name = m_pending.front();
+            m_pending.pop_front();
+
+            if( m_modules.count( name ) )
+                continue;
+        }
+
+        boost::mutex::scoped_lock loadLock( m_loadLock );
+
+        {
+            boost::mutex::scoped_lock lock( m_lock );
+
+            if( m_modules.count( name ) )
+                continue;
+        }
+
+        MODULE* module = NULL;
+
+        try
+        {
+            module = m_table->FootprintLoad( m_nickname, name );
+        }
+        catch( ... )
+        {
+            // Not cached: Load() reports the error when the footprint is shown
+            continue;
+        }
+
+        if( module )
+            module->ClearAllNets();
+
+        boost::mutex::scoped_lock lock( m_lock );
+
+        store( name, module );
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_viewer_cache.h
+ */
+
+#ifndef FOOTPRINT_VIEWER_CACHE_H_
+#define FOOTPRINT_VIEWER_CACHE_H_
+
+#include <deque>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include <hashtables.h>
+#include <thread_pool.h>
+
+class FP_LIB_TABLE;
+class MODULE;
+
+
+/**
+ * Class FOOTPRINT_VIEWER_CACHE
+ * keeps the footprints of a library recently shown by the FOOTPRINT_VIEWER_FRAME, and
+ * loads the footprints next to the selected one in the list on the thread pool, so that
+ * they are shown at once when the list is browsed.
+ *
+ * The plugin of a library is not reentrant: its footprints are loaded one at a time,
+ * by the background task and by Load() alike.
+ */
+class FOOTPRINT_VIEWER_CACHE
+{
+public:
+    FOOTPRINT_VIEWER_CACHE( THREAD_POOL& aPool );
+    ~FOOTPRINT_VIEWER_CACHE();
+
+    /**
+     * Function Load
+     * returns a new copy of the footprint @a aFootprintName of the library @a aNickname,
+     * which is loaded unless it is already in the cache.  The cached footprints of another
+     * library are dropped.
+     *
+     * @return the footprint, owned by the caller, or NULL if it was not found.
+     * @throw IO_ERROR as FP_LIB_TABLE::FootprintLoad().
+     */
+    MODULE* Load( FP_LIB_TABLE* aTable, const wxString& aNickname,
+                  const wxString& aFootprintName );
+
+    /**
+     * Function Prefetch
+     * replaces the footprints of the library @a aNickname still to be loaded in the
+     * background by @a aFootprintNames, loaded in this order.
+     */
+    void Prefetch( FP_LIB_TABLE* aTable, const wxString& aNickname,
+                   const std::vector<wxString>& aFootprintNames );
+
+    /**
+     * Function Clear
+     * drops the cached footprints, once the footprint being loaded in the background is
+     * loaded.  To be called when the library may have been modified.
+     */
+    void Clear();
+
+private:
+    typedef boost::unordered_map< wxString, MODULE*, WXSTRING_HASH > MODULES;
+
+    ///> Calls Clear() if the cached footprints are not those of @a aNickname of @a aTable
+    void setLibrary( FP_LIB_TABLE* aTable, const wxString& aNickname );
+
+    ///> Adds @a aModule to the cache, dropping the oldest footprints.  Call with m_lock held.
+    void store( const wxString& aFootprintName, MODULE* aModule );
+
+    ///> The background task, loading the footprints of m_pending
+    void loadPending();
+
+    FP_LIB_TABLE*           m_table;
+    wxString                m_nickname;
+
+    boost::mutex            m_loadLock;     ///< held while a footprint of the library loads
+
+    boost::mutex            m_lock;         ///< protects the members below
+    MODULES                 m_modules;      ///< a NULL footprint was not found
+    std::deque<wxString>    m_order;        ///< the footprints of m_modules, oldest first
+    std::deque<wxString>    m_pending;      ///< the footprints to load in the background
+    bool                    m_running;      ///< true while loadPending() runs
+
+    TASK_GROUP              m_tasks;
+};
+
+#endif  // FOOTPRINT_VIEWER_CACHE_H_
@@ -20,6 +20,13 @@
 #include <base_units.h>
 
 
+// The delay after the last parameter edit to rebuild the footprint, in ms
+#define FOOTPRINT_REBUILD_DELAY 300
+
+// The number of footprints kept by FOOTPRINT_WIZARD_FRAME::buildFootprint()
+#define BUILT_FOOTPRINTS_MAX    16
+
+
 void FOOTPRINT_WIZARD_FRAME::Process_Special_Functions( wxCommandEvent& event )
 {
     wxString    msg;
@@ -102,7 +109,7 @@ void FOOTPRINT_WIZARD_FRAME::ReloadFootprint()
 
     // Creates the module
     wxString msg;
-    MODULE* module = footprintWizard->GetFootprint( &msg );
+    MODULE* module = buildFootprint( footprintWizard, &msg );
     DisplayBuildMessage( msg );
 
     if( module )
@@ -110,6 +117,9 @@ void FOOTPRINT_WIZARD_FRAME::ReloadFootprint()
         //  Add the object to board
         GetBoard()->Add( module, ADD_APPEND );
         module->SetPosition( wxPoint( 0, 0 ) );
+
+        // The wizard script does not compute the bounding box of the items it created
+        module->CalculateBoundingBox();
     }
     else
     {
@@ -120,6 +130,51 @@ void FOOTPRINT_WIZARD_FRAME::ReloadFootprint()
 }
 
 
+MODULE* FOOTPRINT_WIZARD_FRAME::buildFootprint( FOOTPRINT_WIZARD* aWizard, wxString* aMessage )
+{
+    wxString key = aWizard->GetName();
+
+    for( int page = 0; page < aWizard->GetNumParameterPages(); page++ )
+    {
+        wxArrayString values = aWizard->GetParameterValues( page );
+
+        key << wxT( '\n' ) << page;
+
+        for( unsigned ii = 0; ii < values.GetCount(); ii++ )
+            key << wxT( '\n' ) << values[ii];
+    }
+
+    for( unsigned ii = 0; ii < m_builtFootprints.size(); ii++ )
+    {
+        if( m_builtFootprints[ii].m_key == key )
+        {
+            *aMessage = m_builtFootprints[ii].m_message;
+            return new MODULE( *m_builtFootprints[ii].m_module );
+        }
+    }
+
+    MODULE* module = aWizard->GetFootprint( aMessage );
+
+    if( module )
+    {
+        BUILT_FOOTPRINT built;
+
+        built.m_key = key;
+        built.m_module = new MODULE( *module );
+        built.m_message = *aMessage;
+        m_builtFootprints.push_front( built );
+
+        if( m_builtFootprints.size() > BUILT_FOOTPRINTS_MAX )
+        {
+            delete m_builtFootprints.back().m_module;
+            m_builtFootprints.pop_back();
+        }
+    }
+
+    return module;
+}
+
+
 void FOOTPRINT_WIZARD_FRAME::DisplayBuildMessage( wxString& aMessage )
 {
     if( m_messagesFrame == NULL )
@@ -160,7 +215,7 @@ MODULE* FOOTPRINT_WIZARD_FRAME::GetBuiltFootprint()
     if( footprintWizard && m_modal_ret_val )
     {
         wxString msg;
-        MODULE * footprint = footprintWizard->GetFootprint( &msg );
+        MODULE * footprint = buildFootprint( footprintWizard, &msg );
         DisplayBuildMessage( msg );
 
         return footprint;
@@ -190,6 +245,9 @@ void FOOTPRINT_WIZARD_FRAME::SelectFootprintWizard()
         m_wizardDescription.Empty();
     }
 
+    // A rebuild pending for the previous wizard is useless
+    m_rebuildTimer.Stop();
+
     ReloadFootprint();
     Zoom_Automatique( false );
     DisplayWizardInfos();
@@ -271,12 +329,19 @@ void FOOTPRINT_WIZARD_FRAME::ParametersUpdated( wxGridEvent& event )
         if( !res.IsEmpty() )
             wxMessageBox( res );
 
-        ReloadFootprint();
-        DisplayWizardInfos();
+        // Rebuilding a large footprint takes time: a series of edits is rebuilt once
+        m_rebuildTimer.Start( FOOTPRINT_REBUILD_DELAY, wxTIMER_ONE_SHOT );
     }
 }
 
 
+void FOOTPRINT_WIZARD_FRAME::OnRebuildTimer( wxTimerEvent& aEvent )
+{
+    ReloadFootprint();
+    DisplayWizardInfos();
+}
+
+
 /**
  * Function RedrawActiveWindow
  * Display the current selected component.
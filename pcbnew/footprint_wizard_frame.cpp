@@ -40,6 +40,7 @@
 #include <class_module.h>
 #include <module_editor_frame.h>
 
+#include <pcbnew.h>
 #include <pcbnew_id.h>
 #include "footprint_wizard_frame.h"
 #include <footprint_info.h>
@@ -79,6 +80,8 @@ BEGIN_EVENT_TABLE( FOOTPRINT_WIZARD_FRAME, EDA_DRAW_FRAME )
                                FOOTPRINT_WIZARD_FRAME::ParametersUpdated )
 
     EVT_MENU( ID_SET_RELATIVE_OFFSET, FOOTPRINT_WIZARD_FRAME::OnSetRelativeOffset )
+
+    EVT_TIMER( ID_FOOTPRINT_WIZARD_REBUILD_TIMER, FOOTPRINT_WIZARD_FRAME::OnRebuildTimer )
 END_EVENT_TABLE()
 
 // Column index to display parameters in m_parameterGrid
@@ -108,13 +111,19 @@ FOOTPRINT_WIZARD_FRAME::FOOTPRINT_WIZARD_FRAME( KIWAY* aKiway,
                 wxDefaultPosition, wxDefaultSize,
                 aParent ? KICAD_DEFAULT_DRAWFRAME_STYLE | MODAL_MODE_EXTRASTYLE
                           : KICAD_DEFAULT_DRAWFRAME_STYLE | wxSTAY_ON_TOP,
-                FOOTPRINT_WIZARD_FRAME_NAME )
+                FOOTPRINT_WIZARD_FRAME_NAME ),
+    m_rebuildTimer( this, ID_FOOTPRINT_WIZARD_REBUILD_TIMER )
 {
     wxASSERT( aFrameType == FRAME_PCB_FOOTPRINT_WIZARD_MODAL );
 
     // This frame is always show modal:
     SetModal( true );
 
+#if defined( KICAD_SCRIPTING )
+    // The wizards are Python plugins
+    PcbnewStartScripting();
+#endif
+
     m_messagesFrame = NULL;     // This windows will be created the first time a wizard is loaded
     m_showAxis      = true;     // true to draw axis.
 
@@ -221,6 +230,11 @@ FOOTPRINT_WIZARD_FRAME::FOOTPRINT_WIZARD_FRAME( KIWAY* aKiway,
 
 FOOTPRINT_WIZARD_FRAME::~FOOTPRINT_WIZARD_FRAME()
 {
+    m_rebuildTimer.Stop();
+
+    for( unsigned ii = 0; ii < m_builtFootprints.size(); ii++ )
+        delete m_builtFootprints[ii].m_module;
+
     EDA_3D_FRAME* draw3DFrame = Get3DViewerFrame();
 
     if( draw3DFrame )
@@ -230,6 +244,8 @@ FOOTPRINT_WIZARD_FRAME::~FOOTPRINT_WIZARD_FRAME()
 
 void FOOTPRINT_WIZARD_FRAME::OnCloseWindow( wxCloseEvent& Event )
 {
+    m_rebuildTimer.Stop();
+
     if( m_messagesFrame )
         m_messagesFrame->SaveSettings();
 
@@ -251,6 +267,9 @@ void FOOTPRINT_WIZARD_FRAME::OnCloseWindow( wxCloseEvent& Event )
 
 void FOOTPRINT_WIZARD_FRAME::ExportSelectedFootprint( wxCommandEvent& aEvent )
 {
+    // The exported footprint is built from the current parameters anyway
+    m_rebuildTimer.Stop();
+
     DismissModal( true );
     Close();
 }
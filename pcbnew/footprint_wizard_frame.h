@@ -31,7 +31,10 @@
 #define FOOTPRINT_WIZARD_FRAME_H_
 
 
+#include <deque>
+
 #include <wx/gdicmn.h>
+#include <wx/timer.h>
 #include <class_footprint_wizard.h>
 class wxSashLayoutWindow;
 class wxListBox;
@@ -54,6 +57,20 @@ private:
     int             m_parameterGridWidth;   ///< size of the grid
     FOOTPRINT_WIZARD_MESSAGES* m_messagesFrame;
 
+    /// Rebuilds the footprint once the parameters do not change anymore
+    wxTimer         m_rebuildTimer;
+
+    /// A footprint built by the wizard, see buildFootprint()
+    struct BUILT_FOOTPRINT
+    {
+        wxString    m_key;                  ///< the wizard name and parameter values
+        MODULE*     m_module;
+        wxString    m_message;              ///< the build messages
+    };
+
+    /// The last footprints built, the most recent first
+    std::deque<BUILT_FOOTPRINT> m_builtFootprints;
+
     // Column index to display parameters in m_parameterGrid
     static int      m_columnPrmName;
     static int      m_columnPrmValue;
@@ -121,6 +138,18 @@ private:
      */
     void                ReloadFootprint();
 
+    /**
+     * Function buildFootprint
+     * returns a new footprint built by the wizard from its current parameters.
+     * The last footprints built are kept by parameter values: going back to
+     * previous values, or rebuilding for the board, does not run the wizard again.
+     * @param aMessage [out] receives the build messages
+     */
+    MODULE*             buildFootprint( FOOTPRINT_WIZARD* aWizard, wxString* aMessage );
+
+    /// The timer event of m_rebuildTimer, rebuilding the footprint after edits
+    void                OnRebuildTimer( wxTimerEvent& aEvent );
+
     /**
      * Function DisplayBuildMessages
      * Display the message generated by the python build footprint script
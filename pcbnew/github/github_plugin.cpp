@@ -65,14 +65,21 @@ Vary: Accept-Encoding
 
 #include <kicad_curl/kicad_curl_easy.h>     // Include before any wx file
 #include <sstream>
+#include <boost/bind.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
 #include <set>
 
 #include <wx/zipstrm.h>
 #include <wx/mstream.h>
 #include <wx/uri.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
 
 #include <fctsys.h>
+#include <common.h>
 
 #include <io_mgr.h>
 #include <richio.h>
@@ -83,6 +90,8 @@ Vary: Accept-Encoding
 #include <macros.h>
 #include <fp_lib_table.h>       // ExpandSubstitutions()
 #include <github_getliblist.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
 
 
 using namespace std;
@@ -106,6 +115,284 @@ struct GH_CACHE : public MODULE_MAP
 };
 
 
+/**
+ * Class GH_ZIP_STORE
+ * holds the zip images downloaded by all the GITHUB_PLUGINs of the process.  A zip
+ * image being downloaded is waited for instead of being downloaded again.
+ *
+ * The images are also written to the "github-cache" directory of the KiCad
+ * configuration, with their ETag and Last-Modified headers.  The next sessions send
+ * them in conditional requests, and download the images again only if they changed.
+ * The copy on the disk is also used when the server cannot be reached.
+ */
+class GH_ZIP_STORE
+{
+public:
+    static GH_ZIP_STORE& Instance()
+    {
+        static GH_ZIP_STORE store;
+
+        return store;
+    }
+
+    /**
+     * Function Get
+     * copies the image of the zip file @a aZipURL to @a aImage, downloading it if this
+     * was not done yet by a thread of the process.
+     */
+    void Get( const std::string& aZipURL, std::string* aImage ) throw( IO_ERROR );
+
+    ///> Starts downloading @a aZipURL on a thread of the process
+    void Prefetch( const std::string& aZipURL );
+
+    void WaitForPrefetch();
+
+private:
+    GH_ZIP_STORE() :
+        m_prefetch( NULL )
+    {
+    }
+
+    struct ZIP
+    {
+        bool        m_ready;        ///< false while being downloaded
+        std::string m_image;
+    };
+
+    typedef std::map<std::string, ZIP>  ZIPS;
+
+    ///> The Prefetch() task
+    void prefetch( const std::string& aZipURL );
+
+    ///> Downloads @a aZipURL, using its copy on the disk if it did not change
+    static void download( const std::string& aZipURL, std::string* aImage ) throw( IO_ERROR );
+
+    ///> Returns the name of the copy on the disk of @a aZipURL, with extension @a aExt
+    static wxString diskFileName( const std::string& aZipURL, const wxString& aExt );
+
+    ZIPS                        m_zips;
+    boost::mutex                m_lock;
+    boost::condition_variable   m_downloaded;
+    TASK_GROUP*                 m_prefetch;     ///< used by the main thread only
+};
+
+
+void GH_ZIP_STORE::Get( const std::string& aZipURL, std::string* aImage ) throw( IO_ERROR )
+{
+    {
+        boost::mutex::scoped_lock lock( m_lock );
+
+        for( ;; )
+        {
+            ZIPS::iterator it = m_zips.find( aZipURL );
+
+            if( it == m_zips.end() )
+                break;
+
+            if( it->second.m_ready )
+            {
+                *aImage = it->second.m_image;
+                return;
+            }
+
+            // another thread is downloading it, a failed download is retried here
+            m_downloaded.wait( lock );
+        }
+
+        m_zips[aZipURL].m_ready = false;
+    }
+
+    try
+    {
+        download( aZipURL, aImage );
+    }
+    catch( ... )
+    {
+        boost::mutex::scoped_lock lock( m_lock );
+
+        m_zips.erase( aZipURL );
+        m_downloaded.notify_all();
+        throw;
+    }
+
+    boost::mutex::scoped_lock lock( m_lock );
+    ZIP& zip = m_zips[aZipURL];
+
+    zip.m_ready = true;
+    zip.m_image = *aImage;
+    m_downloaded.notify_all();
+}
+
+
+void GH_ZIP_STORE::Prefetch( const std::string& aZipURL )
+{
+    if( !m_prefetch )
+        m_prefetch = new TASK_GROUP( Pgm().GetThreadPool() );
+
+    m_prefetch->Run( boost::bind( &GH_ZIP_STORE::prefetch, this, aZipURL ) );
+}
+
+
+void GH_ZIP_STORE::WaitForPrefetch()
+{
+    if( m_prefetch )
+    {
+        m_prefetch->Wait();
+
+        delete m_prefetch;
+        m_prefetch = NULL;
+    }
+}
+
+
+void GH_ZIP_STORE::prefetch( const std::string& aZipURL )
+{
+    std::string image;
+
+    try
+    {
+        Get( aZipURL, &image );
+    }
+    catch( const IO_ERROR& )
+    {
+        // not an error yet, the library may never be opened.  Opening it downloads it
+        // again and reports the error.
+    }
+}
+
+
+wxString GH_ZIP_STORE::diskFileName( const std::string& aZipURL, const wxString& aExt )
+{
+    wxFileName  fn( GetKicadConfigPath(), wxEmptyString );
+    uint64_t    h = 14695981039346656037ull;
+
+    fn.AppendDir( wxT( "github-cache" ) );
+
+    if( !fn.DirExists() )
+        fn.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
+    // FNV-1a, the URLs do not make valid file names
+    for( unsigned i = 0; i < aZipURL.size(); ++i )
+    {
+        h ^= (unsigned char) aZipURL[i];
+        h *= 1099511628211ull;
+    }
+
+    fn.SetName( wxString::Format( wxT( "%08x%08x" ), (unsigned) ( h >> 32 ), (unsigned) h ) );
+    fn.SetExt( aExt );
+
+    return fn.GetFullPath();
+}
+
+
+static bool readDiskFile( const wxString& aFileName, std::string* aContents )
+{
+    if( !wxFileName::FileExists( aFileName ) )
+        return false;
+
+    wxFFile file( aFileName, wxT( "rb" ) );
+
+    if( !file.IsOpened() )
+        return false;
+
+    aContents->resize( file.Length() );
+
+    return aContents->empty() || file.Read( &(*aContents)[0], aContents->size() ) == aContents->size();
+}
+
+
+static bool writeDiskFile( const wxString& aFileName, const std::string& aContents )
+{
+    // an interrupted write must not leave a truncated copy
+    wxString    tmpName = aFileName + wxT( ".tmp" );
+    bool        ok;
+
+    {
+        wxFFile file( tmpName, wxT( "wb" ) );
+
+        ok = file.IsOpened() && file.Write( aContents.data(), aContents.size() ) == aContents.size()
+             && file.Close();
+    }
+
+    ok = ok && wxRenameFile( tmpName, aFileName, true );
+
+    if( !ok )
+        wxRemoveFile( tmpName );
+
+    return ok;
+}
+
+
+void GH_ZIP_STORE::download( const std::string& aZipURL, std::string* aImage ) throw( IO_ERROR )
+{
+    wxString    zipFile = diskFileName( aZipURL, wxT( "zip" ) );
+    wxString    tagFile = diskFileName( aZipURL, wxT( "tag" ) );
+    std::string tags, etag, lastModified;
+
+    // the tag file holds the ETag line, then the Last-Modified line, of the zip file
+    if( wxFileName::FileExists( zipFile ) && readDiskFile( tagFile, &tags ) )
+    {
+        size_t eol = tags.find( '\n' );
+
+        if( eol != std::string::npos )
+        {
+            etag = tags.substr( 0, eol );
+            lastModified = tags.substr( eol + 1 );
+        }
+    }
+
+    KICAD_CURL_EASY kcurl;      // this can THROW_IO_ERROR
+
+    kcurl.SetURL( aZipURL.c_str() );
+    kcurl.SetUserAgent( "http://kicad-pcb.org" );
+    kcurl.SetHeader( "Accept", "application/zip" );
+    kcurl.SetFollowRedirects( true );
+
+    if( !etag.empty() )
+        kcurl.SetHeader( "If-None-Match", etag );
+
+    if( !lastModified.empty() )
+        kcurl.SetHeader( "If-Modified-Since", lastModified );
+
+    try
+    {
+        kcurl.Perform();
+    }
+    catch( const IO_ERROR& )
+    {
+        // the server cannot be reached, use the last downloaded copy if any
+        if( readDiskFile( zipFile, aImage ) )
+            return;
+
+        throw;
+    }
+
+    if( kcurl.GetResponseCode() == 304 )
+    {
+        if( readDiskFile( zipFile, aImage ) )
+            return;
+
+        // the copy disappeared meanwhile, ask for the whole file
+        wxRemoveFile( tagFile );
+        download( aZipURL, aImage );
+        return;
+    }
+
+    *aImage = kcurl.GetBuffer();
+
+    if( kcurl.GetResponseCode() == 200 )
+    {
+        etag = kcurl.GetResponseHeader( "ETag" );
+        lastModified = kcurl.GetResponseHeader( "Last-Modified" );
+
+        wxRemoveFile( tagFile );
+
+        if( ( !etag.empty() || !lastModified.empty() ) && writeDiskFile( zipFile, *aImage ) )
+            writeDiskFile( tagFile, etag + '\n' + lastModified );
+    }
+}
+
+
 GITHUB_PLUGIN::GITHUB_PLUGIN() :
     PCB_IO(),
     m_gh_cache( 0 )
@@ -524,17 +811,9 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL ) throw( IO_ERROR )
 
     wxLogDebug( wxT( "Attempting to download: " ) + zip_url );
 
-    KICAD_CURL_EASY kcurl;      // this can THROW_IO_ERROR
-
-    kcurl.SetURL( zip_url.c_str() );
-    kcurl.SetUserAgent( "http://kicad-pcb.org" );
-    kcurl.SetHeader( "Accept", "application/zip" );
-    kcurl.SetFollowRedirects( true );
-
     try
     {
-        kcurl.Perform();
-        m_zip_image = kcurl.GetBuffer();
+        GH_ZIP_STORE::Instance().Get( zip_url, &m_zip_image );
     }
     catch( const IO_ERROR& ioe )
     {
@@ -565,6 +844,36 @@ void GITHUB_PLUGIN::remoteGetZip( const wxString& aRepoURL ) throw( IO_ERROR )
     }
 }
 
+
+void GITHUB_PLUGIN::PrefetchLibraries( FP_LIB_TABLE& aTable )
+{
+    const wxString          github = IO_MGR::ShowType( IO_MGR::GITHUB );
+    std::vector<wxString>   nicknames = aTable.GetLogicalLibs();
+
+    for( unsigned i = 0; i < nicknames.size(); ++i )
+    {
+        try
+        {
+            const FP_LIB_TABLE::ROW* row = aTable.FindRow( nicknames[i] );
+            std::string zip_url;
+
+            if( row->GetType() == github && repoURL_zipURL( row->GetFullURI( true ), &zip_url ) )
+                GH_ZIP_STORE::Instance().Prefetch( zip_url );
+        }
+        catch( const IO_ERROR& )
+        {
+            // reported when the library is opened
+        }
+    }
+}
+
+
+void GITHUB_PLUGIN::WaitForPrefetch()
+{
+    GH_ZIP_STORE::Instance().WaitForPrefetch();
+}
+
+
 #if 0 && defined(STANDALONE)
 
 int main( int argc, char** argv )
@@ -596,3 +905,4 @@ int main( int argc, char** argv )
 }
 
 #endif
+
@@ -28,6 +28,7 @@
 #include <kicad_plugin.h>
 
 struct GH_CACHE;
+class FP_LIB_TABLE;
 
 
 /**
@@ -196,6 +197,20 @@ public:
     GITHUB_PLUGIN();        // constructor, if any, must be zero arg
     ~GITHUB_PLUGIN();
 
+    /**
+     * Function PrefetchLibraries
+     * starts downloading the zip files of all the Github libraries of @a aTable on the
+     * threads of the process, so that they are ready when the libraries are opened.
+     */
+    static void PrefetchLibraries( FP_LIB_TABLE& aTable );
+
+    /**
+     * Function WaitForPrefetch
+     * waits for the downloads started by PrefetchLibraries(), before the threads of the
+     * process are stopped.
+     */
+    static void WaitForPrefetch();
+
 protected:
 
     void init( const PROPERTIES* aProperties );
@@ -215,7 +230,9 @@ protected:
     /**
      * Function remoteGetZip
      * fetches a zip file image from a github repo synchronously.  The byte image
-     * is received into the m_input_stream.
+     * is received into the m_input_stream.  The zip files are kept for the whole
+     * session, and on the disk for the next ones: they are then only downloaded
+     * again if they changed.
      */
     void remoteGetZip( const wxString& aRepoURL ) throw( IO_ERROR );
 
@@ -52,6 +52,10 @@
 // the value 0.0218 is equivalent to about 5 degrees arc,
 #define MIN_BULGE 0.0218
 
+// the maximal distance, in internal units, of the vertices of aligned polyline segments
+// to the line of the first one, for the segments to be merged into one
+#define MERGE_TOLERANCE 1.0
+
 DXF2BRD_CONVERTER::DXF2BRD_CONVERTER() : DRW_Interface()
 {
     m_xOffset   = 0.0;      // X coord offset for conversion (in mm)
@@ -60,6 +64,7 @@ DXF2BRD_CONVERTER::DXF2BRD_CONVERTER() : DRW_Interface()
     m_version   = 0;
     m_defaultThickness = 0.1;
     m_brdLayer = Dwgs_User;
+    m_lastSegment = NULL;
 }
 
 
@@ -130,11 +135,16 @@ void DXF2BRD_CONVERTER::addLine( const DRW_Line& aData )
 void DXF2BRD_CONVERTER::addPolyline(const DRW_Polyline& aData )
 {
     // Currently, Pcbnew does not know polylines, for boards.
-    // So we have to convert a polyline to a set of segments.
+    // So we have to convert a polyline to a set of segments and arcs,
+    // as a LWPolyline.
     // Obviously, the z coordinate is ignored
+    wxRealPoint seg_start;
+    wxRealPoint poly_start;
+    double bulge = 0.0;
+    int lineWidth = mapDim( aData.thickness == 0 ? m_defaultThickness
+                            : aData.thickness );
 
-    wxPoint polyline_startpoint;
-    wxPoint segment_startpoint;
+    m_lastSegment = NULL;
 
     for( unsigned ii = 0; ii < aData.vertlist.size(); ii++ )
     {
@@ -142,36 +152,35 @@ void DXF2BRD_CONVERTER::addPolyline(const DRW_Polyline& aData )
 
         if( ii == 0 )
         {
-            segment_startpoint.x = mapX( vertex->basePoint.x );
-            segment_startpoint.y = mapY( vertex->basePoint.y );
-            polyline_startpoint  = segment_startpoint;
+            seg_start.x = m_xOffset + vertex->basePoint.x * m_DXF2mm;
+            seg_start.y = m_yOffset - vertex->basePoint.y * m_DXF2mm;
+            bulge = vertex->bulge;
+            poly_start = seg_start;
             continue;
         }
 
-        DRAWSEGMENT*    segm = new DRAWSEGMENT( NULL );
+        wxRealPoint seg_end( m_xOffset + vertex->basePoint.x * m_DXF2mm,
+                             m_yOffset - vertex->basePoint.y * m_DXF2mm );
 
-        segm->SetLayer( ToLAYER_ID( m_brdLayer ) );
-        segm->SetStart( segment_startpoint );
-        wxPoint segment_endpoint( mapX( vertex->basePoint.x ), mapY( vertex->basePoint.y ) );
-        segm->SetEnd( segment_endpoint );
-        segm->SetWidth( mapDim( aData.thickness == 0 ? m_defaultThickness
-                                : aData.thickness ) );
-        m_newItemsList.push_back( segm );
-        segment_startpoint = segment_endpoint;
+        if( std::abs( bulge ) < MIN_BULGE )
+            insertLine( seg_start, seg_end, lineWidth );
+        else
+            insertArc( seg_start, seg_end, bulge, lineWidth );
+
+        bulge = vertex->bulge;
+        seg_start = seg_end;
     }
 
     // Polyline flags bit 0 indicates closed (1) or open (0) polyline
     if( aData.flags & 1 )
     {
-        DRAWSEGMENT*    closing_segm = new DRAWSEGMENT( NULL );
-
-        closing_segm->SetLayer( ToLAYER_ID( m_brdLayer ) );
-        closing_segm->SetStart( segment_startpoint );
-        closing_segm->SetEnd( polyline_startpoint );
-        closing_segm->SetWidth( mapDim( aData.thickness == 0 ? m_defaultThickness
-                                : aData.thickness ) );
-        m_newItemsList.push_back( closing_segm );
+        if( std::abs( bulge ) < MIN_BULGE )
+            insertLine( seg_start, poly_start, lineWidth );
+        else
+            insertArc( seg_start, poly_start, bulge, lineWidth );
     }
+
+    m_lastSegment = NULL;
 }
 
 void DXF2BRD_CONVERTER::addLWPolyline(const DRW_LWPolyline& aData )
@@ -187,6 +196,8 @@ void DXF2BRD_CONVERTER::addLWPolyline(const DRW_LWPolyline& aData )
     int lineWidth = mapDim( aData.thickness == 0 ? m_defaultThickness
                             : aData.thickness );
 
+    m_lastSegment = NULL;
+
     for( unsigned ii = 0; ii < aData.vertlist.size(); ii++ )
     {
         DRW_Vertex2D* vertex = aData.vertlist[ii];
@@ -219,6 +230,8 @@ void DXF2BRD_CONVERTER::addLWPolyline(const DRW_LWPolyline& aData )
         else
             insertArc( seg_start, poly_start, bulge, lineWidth );
     }
+
+    m_lastSegment = NULL;
 }
 
 /*
@@ -708,16 +721,43 @@ void DXF2BRD_CONVERTER::addTextStyle( const DRW_Textstyle& aData )
 void DXF2BRD_CONVERTER::insertLine( const wxRealPoint& aSegStart,
                                     const wxRealPoint& aSegEnd, int aWidth )
 {
-    DRAWSEGMENT*    segm = new DRAWSEGMENT( NULL );
     wxPoint segment_startpoint( Millimeter2iu( aSegStart.x ), Millimeter2iu( aSegStart.y ) );
     wxPoint segment_endpoint( Millimeter2iu( aSegEnd.x ), Millimeter2iu( aSegEnd.y ) );
 
+    // The repeated vertices of the polylines give null segments
+    if( segment_startpoint == segment_endpoint )
+        return;
+
+    // The polylines of mechanical outlines often have many aligned vertices: the
+    // segment is merged with the previous one when it goes on along the line of the
+    // first merged segment.  Comparing to that line, not to the previous segment, keeps
+    // the finely tessellated curves from being merged into chords.
+    if( m_lastSegment && m_lastSegment->GetEnd() == segment_startpoint
+        && m_lastSegment->GetWidth() == aWidth )
+    {
+        VECTOR2D start( m_lastSegment->GetStart() );
+        VECTOR2D vertex = VECTOR2D( segment_startpoint ) - start;
+        VECTOR2D end = VECTOR2D( segment_endpoint ) - start;
+
+        if( end.Dot( m_lastDirection ) > vertex.Dot( m_lastDirection )
+            && std::abs( end.Cross( m_lastDirection ) )
+                   <= MERGE_TOLERANCE * m_lastDirection.EuclideanNorm() )
+        {
+            m_lastSegment->SetEnd( segment_endpoint );
+            return;
+        }
+    }
+
+    DRAWSEGMENT*    segm = new DRAWSEGMENT( NULL );
+
     segm->SetLayer( ToLAYER_ID( m_brdLayer ) );
     segm->SetStart( segment_startpoint );
     segm->SetEnd( segment_endpoint );
     segm->SetWidth( aWidth );
 
     m_newItemsList.push_back( segm );
+    m_lastSegment = segm;
+    m_lastDirection = VECTOR2D( segment_endpoint - segment_startpoint );
     return;
 }
 
@@ -797,5 +837,6 @@ void DXF2BRD_CONVERTER::insertArc( const wxRealPoint& aSegStart, const wxRealPoi
     segm->SetWidth( aWidth );
 
     m_newItemsList.push_back( segm );
+    m_lastSegment = NULL;
     return;
 }
@@ -29,9 +29,11 @@
 #include "drw_interface.h"
 #include "wx/wx.h"
 #include <list>
+#include <math/vector2d.h>
 
 class BOARD;
 class BOARD_ITEM;
+class DRAWSEGMENT;
 
 /**
  * This format filter class can import and export DXF files.
@@ -50,6 +52,8 @@ private:
     int m_brdLayer;         // The board layer to place imported DXF items
     int m_version;          // the dxf version, not used here
     std::string m_codePage; // The code page, not used here
+    DRAWSEGMENT* m_lastSegment; // The last straight segment of the current polyline, if any
+    VECTOR2D m_lastDirection;   // The direction of the first segment merged in m_lastSegment
 
 public:
     DXF2BRD_CONVERTER();
@@ -98,6 +102,7 @@ private:
     int mapDim( double aDxfValue );
 
     // Functions to aid in the creation of a LWPolyline
+    // insertLine() extends the previous segment of the polyline, if aligned with it
     void insertLine( const wxRealPoint& aSegStart, const wxRealPoint& aSegEnd, int aWidth );
     void insertArc( const wxRealPoint& aSegStart, const wxRealPoint& aSegEnd,
                     double aBulge, int aWidth );
@@ -51,6 +51,7 @@ bool PCB_EDIT_FRAME::Clear_Pcb( bool aQuery )
     // Clear undo and redo lists because we want a full deletion
     GetScreen()->ClearUndoRedoList();
     GetScreen()->ClrModify();
+    m_journal.Stop();
 
     // Items visibility flags will be set because a new board will be created.
     // Grid and ratsnest can be left to their previous state
@@ -32,6 +32,7 @@
 #include <pcad2kicadpcb_plugin/pcad_plugin.h>
 #include <gpcb_plugin.h>
 #include <config.h>
+#include <trace_events.h>
 
 #if defined(BUILD_GITHUB_PLUGIN)
  #include <github/github_plugin.h>
@@ -244,6 +245,8 @@ IO_MGR::PCB_FILE_T IO_MGR::GuessPluginTypeFromLibPath( const wxString& aLibPath
 BOARD* IO_MGR::Load( PCB_FILE_T aFileType, const wxString& aFileName,
                      BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
+    TRACE_SCOPE( "IO_MGR::Load" );
+
     // release the PLUGIN even if an exception is thrown.
     PLUGIN::RELEASER pi( PluginFind( aFileType ) );
 
@@ -258,6 +261,8 @@ BOARD* IO_MGR::Load( PCB_FILE_T aFileType, const wxString& aFileName,
 
 void IO_MGR::Save( PCB_FILE_T aFileType, const wxString& aFileName, BOARD* aBoard, const PROPERTIES* aProperties )
 {
+    TRACE_SCOPE( "IO_MGR::Save" );
+
     // release the PLUGIN even if an exception is thrown.
     PLUGIN::RELEASER pi( PluginFind( aFileType ) );
 
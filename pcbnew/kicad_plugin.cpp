@@ -44,10 +44,12 @@
 #include <zones.h>
 #include <kicad_plugin.h>
 #include <pcb_parser.h>
+#include <board_cache.h>
 
 #include <wx/dir.h>
 #include <wx/filename.h>
 #include <wx/wfstream.h>
+#include <list>
 #include <boost/ptr_container/ptr_map.hpp>
 #include <memory.h>
 
@@ -88,7 +90,7 @@ class FP_CACHE_ITEM
 {
     wxFileName              m_file_name; ///< The the full file name and path of the footprint to cache.
     wxDateTime              m_mod_time;  ///< The last file modified time stamp.
-    std::auto_ptr<MODULE>   m_module;
+    std::auto_ptr<MODULE>   m_module;    ///< NULL until the footprint file is parsed.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName );
@@ -100,6 +102,7 @@ public:
     bool        IsModified() const;
 
     MODULE*     GetModule() const { return m_module.get(); }
+    void        SetModule( MODULE* aModule ) { m_module.reset( aModule ); }
     void        UpdateModificationTime() { m_mod_time = m_file_name.GetModificationTime(); }
 };
 
@@ -136,6 +139,13 @@ typedef MODULE_MAP::iterator                          MODULE_ITER;
 typedef MODULE_MAP::const_iterator                    MODULE_CITER;
 
 
+/**
+ * Class FP_CACHE
+ * is the cache of a .pretty library.  Load() only lists the footprint files, which are
+ * parsed when GetModule() first requests them.  Only the MAX_PARSED_MODULES footprints
+ * requested last are kept parsed, so placing a footprint of a big library parses a
+ * single file, and browsing it does not keep the whole library in memory.
+ */
 class FP_CACHE
 {
     PCB_IO*         m_owner;        /// Plugin object that owns the cache.
@@ -143,7 +153,13 @@ class FP_CACHE
     wxDateTime      m_mod_time;     /// Footprint library path modified time stamp.
     MODULE_MAP      m_modules;      /// Map of footprint file name per MODULE*.
 
+    /// Names of the parsed footprints, the last requested first.  A name may remain
+    /// here after its footprint was removed from m_modules.
+    std::list<std::string>  m_parsed;
+
 public:
+    static const unsigned MAX_PARSED_MODULES = 64;
+
     FP_CACHE( PCB_IO* aOwner, const wxString& aLibraryPath );
 
     wxString    GetPath() const { return m_lib_path.GetPath(); }
@@ -158,8 +174,17 @@ public:
     /// save the entire legacy library to m_lib_name;
     void Save();
 
+    /// list the footprint files of the library, without parsing them
     void Load();
 
+    /**
+     * Function GetModule
+     * returns the footprint @a aFootprintName, parsing its file if needed, or NULL if
+     * it is not in the library.  The footprint is owned by the cache, and may be
+     * deleted by the next call.
+     */
+    MODULE* GetModule( const std::string& aFootprintName );
+
     void Remove( const wxString& aFootprintName );
 
     wxDateTime GetLibModificationTime() const;
@@ -225,7 +250,8 @@ void FP_CACHE::Save()
     {
         wxFileName fn = it->second->GetFileName();
 
-        if( fn.FileExists() && !it->second->IsModified() )
+        // a footprint never parsed is its file
+        if( !it->second->GetModule() || ( fn.FileExists() && !it->second->IsModified() ) )
             continue;
 
         wxString tempFileName =
@@ -293,16 +319,11 @@ void FP_CACHE::Load()
             // prepend the libpath into fullPath
             wxFileName fullPath( m_lib_path.GetPath(), fpFileName );
 
-            FILE_LINE_READER    reader( fullPath.GetFullPath() );
-
-            m_owner->m_parser->SetLineReader( &reader );
-
+            // The footprint name is the file name without the extension, its file
+            // is only parsed by GetModule().
             std::string name = TO_UTF8( fullPath.GetName() );
-            MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
 
-            // The footprint name is the file name without the extension.
-            footprint->SetFPID( FPID( fullPath.GetName() ) );
-            m_modules.insert( name, new FP_CACHE_ITEM( footprint, fullPath ) );
+            m_modules.insert( name, new FP_CACHE_ITEM( NULL, fullPath ) );
 
         } while( dir.GetNext( &fpFileName ) );
 
@@ -314,6 +335,50 @@ void FP_CACHE::Load()
 }
 
 
+MODULE* FP_CACHE::GetModule( const std::string& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( aFootprintName );
+
+    if( it == m_modules.end() )
+        return NULL;
+
+    FP_CACHE_ITEM* item = it->second;
+
+    m_parsed.remove( aFootprintName );
+    m_parsed.push_front( aFootprintName );
+
+    if( !item->GetModule() )
+    {
+        wxFileName          fullPath = item->GetFileName();
+        FILE_LINE_READER    reader( fullPath.GetFullPath() );
+
+        // the time stamp of the parsed contents
+        item->UpdateModificationTime();
+
+        m_owner->m_parser->SetLineReader( &reader );
+
+        MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
+
+        footprint->SetFPID( FPID( fullPath.GetName() ) );
+        item->SetModule( footprint );
+    }
+
+    // Forget the footprints requested the longest time ago.  Those modified by
+    // FootprintSave() were written to their files already.
+    while( m_parsed.size() > MAX_PARSED_MODULES )
+    {
+        MODULE_ITER old = m_modules.find( m_parsed.back() );
+
+        if( old != m_modules.end() )
+            old->second->SetModule( NULL );
+
+        m_parsed.pop_back();
+    }
+
+    return item->GetModule();
+}
+
+
 void FP_CACHE::Remove( const wxString& aFootprintName )
 {
     std::string footprintName = TO_UTF8( aFootprintName );
@@ -404,16 +469,37 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
-    FILE_OUTPUTFORMATTER    formatter( aFileName );
+    {
+        FILE_OUTPUTFORMATTER    formatter( aFileName );
 
-    m_out = &formatter;     // no ownership
+        m_out = &formatter;     // no ownership
 
-    m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
-                  formatter.Quotew( GetBuildVersion() ).c_str() );
+        m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
+                      formatter.Quotew( GetBuildVersion() ).c_str() );
 
-    Format( aBoard, 1 );
+        Format( aBoard, 1 );
 
-    m_out->Print( 0, ")\n" );
+        m_out->Print( 0, ")\n" );
+    }   // the file is closed here, before its cache is written
+
+    m_out = NULL;
+
+    wxString cacheFileName = BOARD_CACHE::GetFileName( aFileName );
+    wxFileName fn( aFileName );
+
+    if( fn.GetSize() >= BOARD_CACHE::MIN_BOARD_FILE_SIZE )
+    {
+        MAPPED_FILE_LINE_READER reader( aFileName );
+
+        // Not an error if the cache cannot be written, it only makes the next load slower
+        if( BOARD_CACHE::Save( cacheFileName, BOARD_CACHE::Hash( reader.Data(), reader.Size() ),
+                               aBoard ) )
+            return;
+    }
+
+    // a stale cache would be ignored because of its hash, but it is useless
+    if( wxFileName::FileExists( cacheFileName ) )
+        wxRemoveFile( cacheFileName );
 }
 
 
@@ -498,6 +584,27 @@ void PCB_IO::Format( BOARD_ITEM* aItem, int aNestLevel ) const
 }
 
 
+void PCB_IO::formatXY( int aNestLevel, bool aContinued, int aX, int aY ) const
+    throw( IO_ERROR )
+{
+    char    buf[120];
+    char*   p = buf;
+
+    // the zone outlines and fills make most of a board file: this is its hot path
+    if( aContinued )
+        *p++ = ' ';
+
+    memcpy( p, "(xy ", 4 );
+    p += 4;
+    p += BOARD_ITEM::FormatInternalUnits( aX, p );
+    *p++ = ' ';
+    p += BOARD_ITEM::FormatInternalUnits( aY, p );
+    *p++ = ')';
+
+    m_out->Write( aContinued ? 0 : aNestLevel, buf, p - buf );
+}
+
+
 void PCB_IO::formatLayer( const BOARD_ITEM* aItem ) const
 {
     if( m_ctl & CTL_STD_LAYER_NAMES )
@@ -512,32 +619,18 @@ void PCB_IO::formatLayer( const BOARD_ITEM* aItem ) const
 }
 
 
-void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
+void PCB_IO::FormatBoardSettings( BOARD* aBoard ) const
     throw( IO_ERROR )
 {
-    const BOARD_DESIGN_SETTINGS& dsnSettings = aBoard->GetDesignSettings();
-
-    m_out->Print( 0, "\n" );
-
-    m_out->Print( aNestLevel, "(general\n" );
-    m_out->Print( aNestLevel+1, "(links %d)\n", aBoard->GetRatsnestsCount() );
-    m_out->Print( aNestLevel+1, "(no_connects %d)\n", aBoard->GetUnconnectedNetCount() );
+    formatSetup( aBoard, 0 );
+    formatNetClasses( aBoard, 0 );
+}
 
-    // Write Bounding box info
-    m_out->Print( aNestLevel+1,  "(area %s %s %s %s)\n",
-                  FMTIU( aBoard->GetBoundingBox().GetX() ).c_str(),
-                  FMTIU( aBoard->GetBoundingBox().GetY() ).c_str(),
-                  FMTIU( aBoard->GetBoundingBox().GetRight() ).c_str(),
-                  FMTIU( aBoard->GetBoundingBox().GetBottom() ).c_str() );
-    m_out->Print( aNestLevel+1, "(thickness %s)\n",
-                  FMTIU( dsnSettings.GetBoardThickness() ).c_str() );
 
-    m_out->Print( aNestLevel+1, "(drawings %d)\n", aBoard->m_Drawings.GetCount() );
-    m_out->Print( aNestLevel+1, "(tracks %d)\n", aBoard->GetNumSegmTrack() );
-    m_out->Print( aNestLevel+1, "(zones %d)\n", aBoard->GetNumSegmZone() );
-    m_out->Print( aNestLevel+1, "(modules %d)\n", aBoard->m_Modules.GetCount() );
-    m_out->Print( aNestLevel+1, "(nets %d)\n", m_mapping->GetSize() );
-    m_out->Print( aNestLevel, ")\n\n" );
+void PCB_IO::formatSetup( BOARD* aBoard, int aNestLevel ) const
+    throw( IO_ERROR )
+{
+    const BOARD_DESIGN_SETTINGS& dsnSettings = aBoard->GetDesignSettings();
 
     aBoard->GetPageSettings().Format( m_out, aNestLevel, m_ctl );
     aBoard->GetTitleBlock().Format( m_out, aNestLevel, m_ctl );
@@ -711,17 +804,13 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     aBoard->GetPlotOptions().Format( m_out, aNestLevel+1 );
 
     m_out->Print( aNestLevel, ")\n\n" );
+}
 
-    // Save net codes and names
-    for( NETINFO_MAPPING::iterator net = m_mapping->begin(), netEnd = m_mapping->end();
-            net != netEnd; ++net )
-    {
-        m_out->Print( aNestLevel, "(net %d %s)\n",
-                                  m_mapping->Translate( net->GetNet() ),
-                                  m_out->Quotew( net->GetNetname() ).c_str() );
-    }
 
-    m_out->Print( 0, "\n" );
+void PCB_IO::formatNetClasses( BOARD* aBoard, int aNestLevel ) const
+    throw( IO_ERROR )
+{
+    const BOARD_DESIGN_SETTINGS& dsnSettings = aBoard->GetDesignSettings();
 
     // Save the default net class first.
     NETCLASS defaultNC = *dsnSettings.GetDefault();
@@ -737,6 +826,50 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
         filterNetClass( *aBoard, netclass );    // Remove empty nets (from a copy of a netclass)
         netclass.Format( m_out, aNestLevel, m_ctl );
     }
+}
+
+
+void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
+    throw( IO_ERROR )
+{
+    const BOARD_DESIGN_SETTINGS& dsnSettings = aBoard->GetDesignSettings();
+
+    m_out->Print( 0, "\n" );
+
+    m_out->Print( aNestLevel, "(general\n" );
+    m_out->Print( aNestLevel+1, "(links %d)\n", aBoard->GetRatsnestsCount() );
+    m_out->Print( aNestLevel+1, "(no_connects %d)\n", aBoard->GetUnconnectedNetCount() );
+
+    // Write Bounding box info
+    m_out->Print( aNestLevel+1,  "(area %s %s %s %s)\n",
+                  FMTIU( aBoard->GetBoundingBox().GetX() ).c_str(),
+                  FMTIU( aBoard->GetBoundingBox().GetY() ).c_str(),
+                  FMTIU( aBoard->GetBoundingBox().GetRight() ).c_str(),
+                  FMTIU( aBoard->GetBoundingBox().GetBottom() ).c_str() );
+    m_out->Print( aNestLevel+1, "(thickness %s)\n",
+                  FMTIU( dsnSettings.GetBoardThickness() ).c_str() );
+
+    m_out->Print( aNestLevel+1, "(drawings %d)\n", aBoard->m_Drawings.GetCount() );
+    m_out->Print( aNestLevel+1, "(tracks %d)\n", aBoard->GetNumSegmTrack() );
+    m_out->Print( aNestLevel+1, "(zones %d)\n", aBoard->GetNumSegmZone() );
+    m_out->Print( aNestLevel+1, "(modules %d)\n", aBoard->m_Modules.GetCount() );
+    m_out->Print( aNestLevel+1, "(nets %d)\n", m_mapping->GetSize() );
+    m_out->Print( aNestLevel, ")\n\n" );
+
+    formatSetup( aBoard, aNestLevel );
+
+    // Save net codes and names
+    for( NETINFO_MAPPING::iterator net = m_mapping->begin(), netEnd = m_mapping->end();
+            net != netEnd; ++net )
+    {
+        m_out->Print( aNestLevel, "(net %d %s)\n",
+                                  m_mapping->Translate( net->GetNet() ),
+                                  m_out->Quotew( net->GetNetname() ).c_str() );
+    }
+
+    m_out->Print( 0, "\n" );
+
+    formatNetClasses( aBoard, aNestLevel );
 
     // Save the modules.
     for( MODULE* module = aBoard->m_Modules;  module;  module = module->Next() )
@@ -1560,6 +1693,15 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
                   FMT_IU( aZone->GetThermalReliefGap() ).c_str(),
                   FMT_IU( aZone->GetThermalReliefCopperBridge() ).c_str() );
 
+    // Default is not tiled.
+    if( aZone->GetTiledFill() )
+        m_out->Print( 0, " (tiled yes)" );
+
+    // The hash of the fill inputs, to find the zones whose saved fill is still valid
+    if( aZone->IsFilled() && aZone->GetFillHash() )
+        m_out->Print( 0, " (hash %08X%08X)", (unsigned) ( aZone->GetFillHash() >> 32 ),
+                      (unsigned) ( aZone->GetFillHash() & 0xFFFFFFFF ) );
+
     if( aZone->GetCornerSmoothingType() != ZONE_SETTINGS::SMOOTHING_NONE )
     {
         m_out->Print( 0, " (smoothing" );
@@ -1597,12 +1739,7 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
         for( unsigned it = 0; it < cv.GetCornersCount(); ++it )
         {
-            if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( cv.GetX( it ) ).c_str(), FMT_IU( cv.GetY( it ) ).c_str() );
-            else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( cv.GetX( it ) ).c_str(), FMT_IU( cv.GetY( it ) ).c_str() );
+            formatXY( aNestLevel+3, newLine != 0, cv.GetX( it ), cv.GetY( it ) );
 
             if( newLine < 4 )
             {
@@ -1645,12 +1782,7 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
         for( SHAPE_POLY_SET::CONST_ITERATOR it = fv.CIterate(); it; ++it )
         {
-            if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( it->x ).c_str(), FMT_IU( it->y ).c_str() );
-            else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( it->x ) .c_str(), FMT_IU( it->y ).c_str() );
+            formatXY( aNestLevel+3, newLine != 0, it->x, it->y );
 
             if( newLine < 4 )
             {
@@ -1724,26 +1856,57 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     init( aProperties );
 
     m_parser->SetLineReader( &reader );
     m_parser->SetBoard( aAppendToMe );
 
+    // The filled polygons of the zones of a large board are read from its cache, when the
+    // cache was written for this very board file
+    BOARD_CACHE cache;
+    bool        useCache = !aAppendToMe && reader.Size() >= BOARD_CACHE::MIN_BOARD_FILE_SIZE
+                           && cache.Load( BOARD_CACHE::GetFileName( aFileName ),
+                                          BOARD_CACHE::Hash( reader.Data(), reader.Size() ) );
+
+    m_parser->SetSkipZoneFills( useCache );
+
     BOARD* board;
 
     try
     {
         board = dynamic_cast<BOARD*>( m_parser->Parse() );
+
+        if( board && useCache && !cache.Apply( board ) )
+        {
+            // Cannot happen with a cache written with the board, read the whole file again
+            delete board;
+
+            reader.Rewind();
+            m_parser->SetSkipZoneFills( false );
+            m_parser->SetLineReader( &reader );
+            m_parser->SetBoard( NULL );
+
+            board = dynamic_cast<BOARD*>( m_parser->Parse() );
+        }
     }
     catch( const PARSE_ERROR& parse_error )
     {
+        m_parser->SetSkipZoneFills( false );
+
         if( m_parser->IsTooRecent() )
             throw FUTURE_FORMAT_ERROR( parse_error, m_parser->GetRequiredVersion() );
         else
             throw;
     }
+    catch( ... )
+    {
+        m_parser->SetSkipZoneFills( false );
+        throw;
+    }
+
+    m_parser->SetSkipZoneFills( false );
 
     if( !board )
     {
@@ -1834,17 +1997,15 @@ MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 
     cacheLib( aLibraryPath, aFootprintName );
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( TO_UTF8( aFootprintName ) );
+    MODULE* module = m_cache->GetModule( TO_UTF8( aFootprintName ) );
 
-    if( it == mods.end() )
+    if( !module )
     {
         return NULL;
     }
 
     // copy constructor to clone the already loaded MODULE
-    return new MODULE( *it->second->GetModule() );
+    return new MODULE( *module );
 }
 
 
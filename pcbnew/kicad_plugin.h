@@ -39,8 +39,12 @@ class NETINFO_MAPPING;
 /// Current s-expression file format version.  2 was the last legacy format version.
 
 //#define SEXPR_BOARD_FILE_VERSION    3     // first s-expression format, used legacy cu stack
-#define SEXPR_BOARD_FILE_VERSION    4       // reversed cu stack, changed Inner* to In* in reverse order
+//#define SEXPR_BOARD_FILE_VERSION    4     // reversed cu stack, changed Inner* to In* in reverse order
                                             // went to 32 Cu layers from 16.
+#define SEXPR_BOARD_FILE_VERSION    20161014    // zone fill hash, tiled zone fills
+
+/// First s-expression format version whose zone fill hashes can be trusted
+#define SEXPR_BOARD_FILE_VERSION_FILL_HASH  20161014
 
 #define CTL_STD_LAYER_NAMES         (1 << 0)    ///< Use English Standard layer names
 #define CTL_OMIT_NETS               (1 << 1)    ///< Omit pads net names (useless in library)
@@ -154,6 +158,22 @@ public:
 
     void SetOutputFormatter( OUTPUTFORMATTER* aFormatter ) { m_out = aFormatter; }
 
+    /**
+     * Function SetBoard
+     * sets the board of the items output by Format() outside of Save(), for the names of
+     * its layers.
+     */
+    void SetBoard( BOARD* aBoard ) { m_board = aBoard; }
+
+    /**
+     * Function FormatBoardSettings
+     * outputs the page, title block, layers, setup and net classes of \a aBoard: the
+     * parts of its board file which are neither its items nor its nets.
+     * @throw IO_ERROR on write error.
+     */
+    void FormatBoardSettings( BOARD* aBoard ) const
+        throw( IO_ERROR );
+
     BOARD_ITEM* Parse( const wxString& aClipboardSourceInput )
         throw( FUTURE_FORMAT_ERROR, PARSE_ERROR, IO_ERROR );
 
@@ -187,6 +207,12 @@ private:
     void format( BOARD* aBoard, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 
+    void formatSetup( BOARD* aBoard, int aNestLevel = 0 ) const
+        throw( IO_ERROR );
+
+    void formatNetClasses( BOARD* aBoard, int aNestLevel = 0 ) const
+        throw( IO_ERROR );
+
     void format( DIMENSION* aDimension, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 
@@ -219,6 +245,14 @@ private:
 
     void formatLayer( const BOARD_ITEM* aItem ) const;
 
+    /**
+     * Function formatXY
+     * outputs the "(xy x y)" of a polygon corner, without printf(), preceded by a space
+     * if @a aContinued, indented by @a aNestLevel otherwise.
+     */
+    void formatXY( int aNestLevel, bool aContinued, int aX, int aY ) const
+        throw( IO_ERROR );
+
     void formatLayers( LSET aLayerMask, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 };
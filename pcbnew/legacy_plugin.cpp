@@ -59,6 +59,7 @@
 
 
 #include <cmath>
+#include <algorithm>
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
@@ -88,6 +89,9 @@
 #include <build_version.h>
 
 #include <boost/make_shared.hpp>
+#include <boost/bind.hpp>
+#include <pgm_base.h>
+#include <thread_pool.h>
 
 
 typedef LEGACY_PLUGIN::BIU      BIU;
@@ -387,6 +391,78 @@ static inline long hexParse( const char* next, const char** out = NULL )
 }
 
 
+/**
+ * Function decimalParse
+ * parses the plain decimal numbers of the files, such as "-1250" or "3.5", into
+ * @a aValue, with the result strtod() gives them: at most 15 digits convert exactly
+ * to a double, and a division by an exact power of ten rounds correctly.
+ * @return false for any other text, such as an exponent, more digits, a hex, inf or
+ *  nan value, which is left to strtod().
+ */
+static inline bool decimalParse( const char* aText, double* aValue, const char** aEnd )
+{
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+    };
+
+    const char* next = aText;
+    bool        negative = false;
+    long long   mantissa = 0;
+    int         digits = 0;
+    int         decimals = 0;
+
+    while( *next == ' ' || *next == '\t' )
+        ++next;
+
+    if( *next == '-' || *next == '+' )
+        negative = *next++ == '-';
+
+    for( ; *next >= '0' && *next <= '9';  ++next )
+    {
+        if( ++digits > 15 )
+            return false;
+
+        mantissa = mantissa * 10 + ( *next - '0' );
+    }
+
+    if( *next == '.' )
+    {
+        for( ++next;  *next >= '0' && *next <= '9';  ++next, ++decimals )
+        {
+            if( ++digits > 15 )
+                return false;
+
+            mantissa = mantissa * 10 + ( *next - '0' );
+        }
+    }
+
+    if( !digits || *next == 'e' || *next == 'E' || *next == 'x' || *next == 'X' )
+        return false;
+
+    double value = (double) mantissa / powers[decimals];
+
+    *aValue = negative ? -value : value;
+    *aEnd = next;
+
+    return true;
+}
+
+
+/// the number of footprints parsed by each task of LEGACY_PLUGIN::loadMODULE_SECTIONS()
+#define MODULES_PER_TASK    16
+
+
+/// a $MODULE section of a board, read by loadAllSections() and parsed on a thread
+struct LEGACY_PLUGIN::MODULE_SECTION
+{
+    std::string             m_fpName;   ///< of the $MODULE line
+    std::string             m_lines;    ///< the lines after it, up to $EndMODULE
+    unsigned                m_lineNum;  ///< the line number of the $MODULE line
+    auto_ptr<MODULE>        m_module;   ///< the footprint, once parsed
+    auto_ptr<IO_ERROR>      m_error;    ///< the parse error, if any
+};
+
+
 BOARD* LEGACY_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
         const PROPERTIES* aProperties )
 {
@@ -403,7 +479,7 @@ BOARD* LEGACY_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
     // delete on exception, iff I own m_board, according to aAppendToMe
     auto_ptr<BOARD> deleter( aAppendToMe ? NULL : m_board );
 
-    FILE_LINE_READER    reader( aFileName );
+    MAPPED_FILE_LINE_READER reader( aFileName );
 
     m_reader = &reader;          // member function accessibility
 
@@ -427,28 +503,17 @@ void LEGACY_PLUGIN::loadAllSections( bool doAppend )
     // Then follows $EQUIPOT and all the rest
     char* line;
 
+    // The footprints are parsed in parallel at the end of the board
+    MODULE_SECTIONS modules;
+
     while( ( line = READLINE( m_reader ) ) != NULL )
     {
         // put the more frequent ones at the top, but realize TRACKs are loaded as a group
 
         if( TESTLINE( "$MODULE" ) )
         {
-            auto_ptr<MODULE>    module( new MODULE( m_board ) );
-
-            FPID        fpid;
-            std::string fpName = StrPurge( line + SZ( "$MODULE" ) );
-
-            // The footprint names in legacy libraries can contain the '/' and ':'
-            // characters which will cause the FPID parser to choke.
-            ReplaceIllegalFileNameChars( &fpName );
-
-            if( !fpName.empty() )
-                fpid = FPID( fpName );
-
-            module->SetFPID( fpid );
-
-            loadMODULE( module.get() );
-            m_board->Add( module.release(), ADD_APPEND );
+            modules.push_back( new MODULE_SECTION );
+            readMODULE_SECTION( &modules.back() );
         }
 
         else if( TESTLINE( "$DRAWSEGMENT" ) )
@@ -524,13 +589,124 @@ void LEGACY_PLUGIN::loadAllSections( bool doAppend )
         }
 
         else if( TESTLINE( "$EndBOARD" ) )
+        {
+            loadMODULE_SECTIONS( modules );
             return;     // preferred exit
+        }
     }
 
     THROW_IO_ERROR( "Missing '$EndBOARD'" );
 }
 
 
+void LEGACY_PLUGIN::readMODULE_SECTION( MODULE_SECTION* aSection )
+{
+    char* line = m_reader->Line();
+
+    aSection->m_fpName  = StrPurge( line + SZ( "$MODULE" ) );
+    aSection->m_lineNum = m_reader->LineNumber();
+
+    while( ( line = READLINE( m_reader ) ) != NULL )
+    {
+        aSection->m_lines += line;
+
+        if( TESTLINE( "$EndMODULE" ) )
+            return;
+    }
+
+    // Parse the truncated section now, for the error of loadMODULE()
+    loadMODULE_SECTION( aSection );
+
+    if( aSection->m_error.get() )
+        throw *aSection->m_error;
+}
+
+
+void LEGACY_PLUGIN::loadMODULE_SECTIONS( MODULE_SECTIONS& aSections )
+{
+    {
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned first = 0;  first < aSections.size();  first += MODULES_PER_TASK )
+        {
+            unsigned last = std::min( first + MODULES_PER_TASK, (unsigned) aSections.size() );
+
+            tasks.Run( boost::bind( &LEGACY_PLUGIN::parseMODULE_SECTIONS, this,
+                                    &aSections, first, last ) );
+        }
+
+        if( !tasks.Wait() )
+            THROW_IO_ERROR( _( "Unable to load the footprints" ) );
+    }
+
+    // report the first error of the file, before adding any footprint
+    for( unsigned ii = 0;  ii < aSections.size();  ++ii )
+    {
+        if( aSections[ii].m_error.get() )
+            throw *aSections[ii].m_error;
+    }
+
+    for( unsigned ii = 0;  ii < aSections.size();  ++ii )
+        m_board->Add( aSections[ii].m_module.release(), ADD_APPEND );
+}
+
+
+void LEGACY_PLUGIN::parseMODULE_SECTIONS( MODULE_SECTIONS* aSections,
+                                          unsigned aFirst, unsigned aLast ) const
+{
+    // loadMODULE() uses the reader, error and field strings of its own parser
+    LEGACY_PLUGIN   parser;
+
+    parser.m_board      = m_board;
+    parser.m_props      = m_props;
+    parser.m_reader     = m_reader;
+    parser.m_cu_count   = m_cu_count;
+    parser.m_loading_format_version = m_loading_format_version;
+    parser.m_netCodes   = m_netCodes;
+    parser.biuToDisk    = biuToDisk;
+    parser.diskToBiu    = diskToBiu;
+
+    for( unsigned ii = aFirst;  ii < aLast;  ++ii )
+        parser.loadMODULE_SECTION( &(*aSections)[ii] );
+}
+
+
+void LEGACY_PLUGIN::loadMODULE_SECTION( MODULE_SECTION* aSection )
+{
+    LINE_READER*        boardReader = m_reader;
+    STRING_LINE_READER  reader( aSection->m_lines, boardReader->GetSource(),
+                                aSection->m_lineNum );
+
+    m_reader = &reader;
+
+    try
+    {
+        auto_ptr<MODULE>    module( new MODULE( m_board ) );
+
+        FPID        fpid;
+        std::string fpName = aSection->m_fpName;
+
+        // The footprint names in legacy libraries can contain the '/' and ':'
+        // characters which will cause the FPID parser to choke.
+        ReplaceIllegalFileNameChars( &fpName );
+
+        if( !fpName.empty() )
+            fpid = FPID( fpName );
+
+        module->SetFPID( fpid );
+
+        loadMODULE( module.get() );
+        aSection->m_module = module;
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        aSection->m_error.reset( new IO_ERROR( ioe ) );
+    }
+
+    m_reader = boardReader;
+}
+
+
 void LEGACY_PLUGIN::checkVersion()
 {
     // Read first line and TEST if it is a PCB file format header like this:
@@ -2996,11 +3172,23 @@ void LEGACY_PLUGIN::loadPCB_TARGET()
 
 BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 {
+    const char* end;
+    double      fval;
+
+    // most values are plain decimals, strtod() is left for the others and the errors
+    if( decimalParse( aValue, &fval, &end ) )
+    {
+        if( nptrptr )
+            *nptrptr = end;
+
+        return KiROUND( fval * diskToBiu );
+    }
+
     char*   nptr;
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    fval = strtod( aValue, &nptr );
 
     if( errno )
     {
@@ -3033,11 +3221,22 @@ BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 
 double LEGACY_PLUGIN::degParse( const char* aValue, const char** nptrptr )
 {
+    const char* end;
+    double      fval;
+
+    if( decimalParse( aValue, &fval, &end ) )
+    {
+        if( nptrptr )
+            *nptrptr = end;
+
+        return fval;
+    }
+
     char*   nptr;
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    fval = strtod( aValue, &nptr );
 
     if( errno )
     {
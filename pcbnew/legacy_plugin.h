@@ -27,6 +27,7 @@
 
 #include <io_mgr.h>
 #include <boost/shared_ptr.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 #include <string>
 #include <layers_id_colors_and_visibility.h>
 
@@ -200,6 +201,32 @@ protected:
     void loadNETCLASS();
     void loadMODULE( MODULE* aModule );
 
+    struct MODULE_SECTION;
+    typedef boost::ptr_vector<MODULE_SECTION>   MODULE_SECTIONS;
+
+    /**
+     * Function readMODULE_SECTION
+     * reads the lines of the $MODULE section beginning at the current line into
+     * @a aSection, up to its $EndMODULE line, without parsing them.
+     */
+    void readMODULE_SECTION( MODULE_SECTION* aSection );
+
+    /**
+     * Function loadMODULE_SECTIONS
+     * parses the footprints of the $MODULE sections of a board on the threads of the
+     * process, and adds them to the board in the order of the file.  It is called at the
+     * end of the board, the net codes of the pads are final.
+     */
+    void loadMODULE_SECTIONS( MODULE_SECTIONS& aSections );
+
+    /// the task of loadMODULE_SECTIONS(), parsing sections aFirst to aLast - 1 with a
+    /// LEGACY_PLUGIN of its own
+    void parseMODULE_SECTIONS( MODULE_SECTIONS* aSections, unsigned aFirst,
+                               unsigned aLast ) const;
+
+    /// parse the footprint of aSection, keeping its IO_ERROR in the section
+    void loadMODULE_SECTION( MODULE_SECTION* aSection );
+
     /**
      * Function loadTrackList
      * reads a list of segments (Tracks and Vias, or Segzones)
@@ -61,8 +61,6 @@
 
 static void DisplayCmpDoc( wxString& aName, void* aData );
 
-static FOOTPRINT_LIST MList;
-
 static void clearModuleItemFlags( BOARD_ITEM* aItem )
 {
     aItem->ClearFlags();
@@ -365,15 +363,25 @@ wxString PCB_BASE_FRAME::SelectFootprint( EDA_DRAW_FRAME* aWindow,
 
     wxASSERT( aTable != NULL );
 
-    MList.ReadFootprintFiles( aTable, !aLibraryName ? NULL : &aLibraryName );
+    boost::shared_ptr<FOOTPRINT_LIST> list;
+
+    // All the libraries of the project are read once for all the frames, and again
+    // only if modified
+    if( !aLibraryName && aTable == Prj().PcbFootprintLibs() )
+        list = Prj().PcbFootprintList();
+    else
+    {
+        list.reset( new FOOTPRINT_LIST );
+        list->ReadFootprintFiles( aTable, !aLibraryName ? NULL : &aLibraryName );
+    }
 
-    if( MList.GetErrorCount() )
+    if( list->GetErrorCount() )
     {
-        MList.DisplayErrors( this );
+        list->DisplayErrors( this );
         return wxEmptyString;
     }
 
-    if( MList.GetCount() == 0 )
+    if( list->GetCount() == 0 )
     {
         wxString tmp;
 
@@ -391,39 +399,39 @@ wxString PCB_BASE_FRAME::SelectFootprint( EDA_DRAW_FRAME* aWindow,
 
     if( !aKeyWord.IsEmpty() )       // Create a list of modules found by keyword.
     {
-        for( unsigned ii = 0; ii < MList.GetCount(); ii++ )
+        for( unsigned ii = 0; ii < list->GetCount(); ii++ )
         {
-            if( KeyWordOk( aKeyWord, MList.GetItem( ii ).GetKeywords() ) )
+            if( KeyWordOk( aKeyWord, list->GetItem( ii ).GetKeywords() ) )
             {
                 wxArrayString   cols;
-                cols.Add( MList.GetItem( ii ).GetFootprintName() );
-                cols.Add( MList.GetItem( ii ).GetNickname() );
+                cols.Add( list->GetItem( ii ).GetFootprintName() );
+                cols.Add( list->GetItem( ii ).GetNickname() );
                 rows.push_back( cols );
             }
         }
     }
     else if( !aMask.IsEmpty() )     // Create a list of modules found by pattern
     {
-        for( unsigned ii = 0; ii < MList.GetCount(); ii++ )
+        for( unsigned ii = 0; ii < list->GetCount(); ii++ )
         {
-            const wxString& candidate = MList.GetItem( ii ).GetFootprintName();
+            const wxString& candidate = list->GetItem( ii ).GetFootprintName();
 
             if( WildCompareString( aMask, candidate, false ) )
             {
                 wxArrayString   cols;
-                cols.Add( MList.GetItem( ii ).GetFootprintName() );
-                cols.Add( MList.GetItem( ii ).GetNickname() );
+                cols.Add( list->GetItem( ii ).GetFootprintName() );
+                cols.Add( list->GetItem( ii ).GetNickname() );
                 rows.push_back( cols );
             }
         }
     }
     else                            // Create the full list of modules
     {
-        for( unsigned ii = 0; ii < MList.GetCount(); ii++ )
+        for( unsigned ii = 0; ii < list->GetCount(); ii++ )
         {
             wxArrayString   cols;
-            cols.Add( MList.GetItem( ii ).GetFootprintName() );
-            cols.Add( MList.GetItem( ii ).GetNickname() );
+            cols.Add( list->GetItem( ii ).GetFootprintName() );
+            cols.Add( list->GetItem( ii ).GetNickname() );
             rows.push_back( cols );
         }
     }
@@ -437,7 +445,7 @@ wxString PCB_BASE_FRAME::SelectFootprint( EDA_DRAW_FRAME* aWindow,
 
         msg.Printf( _( "Footprints [%d items]" ), (int) rows.size() );
 
-        EDA_LIST_DIALOG dlg( aWindow, msg, headers, rows, oldName, DisplayCmpDoc );
+        EDA_LIST_DIALOG dlg( aWindow, msg, headers, rows, oldName, DisplayCmpDoc, list.get() );
 
         if( dlg.ShowModal() == wxID_OK )
         {
@@ -467,7 +475,7 @@ wxString PCB_BASE_FRAME::SelectFootprint( EDA_DRAW_FRAME* aWindow,
 
 static void DisplayCmpDoc( wxString& aName, void* aData )
 {
-    FOOTPRINT_INFO* module_info = MList.GetModuleInfo( aName );
+    FOOTPRINT_INFO* module_info = ( (FOOTPRINT_LIST*) aData )->GetModuleInfo( aName );
 
     if( !module_info )
     {
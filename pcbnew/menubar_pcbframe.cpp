@@ -137,6 +137,16 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
                      KiBitmap( save_as_xpm ) );
     }
 
+    AddMenuItem( filesMenu, ID_MENU_PCB_INCREMENTAL_SAVE,
+                 _( "Save &Incrementally" ),
+                 _( "Save only the changes of the board, to a journal next to its file" ),
+                 KiBitmap( save_xpm ), wxITEM_CHECK );
+
+    AddMenuItem( filesMenu, ID_MENU_PCB_COMPACT_BOARD,
+                 _( "Co&mpact Board File" ),
+                 _( "Save the whole board, merging the journal of its changes into its file" ),
+                 KiBitmap( save_xpm ) );
+
     filesMenu->AppendSeparator();
 
     AddMenuItem( filesMenu, ID_MENU_READ_BOARD_BACKUP_FILE,
@@ -217,6 +227,16 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
                  _( "Export a VRML board representation" ),
                  KiBitmap( three_d_xpm ) );
 
+    AddMenuItem( submenuexport, ID_GEN_EXPORT_FILE_STEP,
+                 _( "S&TEP" ),
+                 _( "Export a STEP representation of the board and its components" ),
+                 KiBitmap( three_d_xpm ) );
+
+    AddMenuItem( submenuexport, ID_GEN_EXPORT_FILE_IMAGE,
+                 _( "&Image (PNG)" ),
+                 _( "Export an image of the visible layers, rendered by the OpenGL canvas" ),
+                 KiBitmap( export_xpm ) );
+
     AddMenuItem( submenuexport, ID_GEN_EXPORT_FILE_IDF3,
                  _( "I&DFv3" ), _( "IDFv3 board and component export" ),
                  KiBitmap( export_idf_xpm ) );
@@ -612,6 +632,16 @@ void PCB_EDIT_FRAME::ReCreateMenuBar()
                  _( "&DRC" ),
                  _( "Perform design rules check" ), KiBitmap( erc_xpm ) );
 
+    AddMenuItem( toolsMenu, ID_DRC_ONLINE,
+                 _( "&Online DRC" ),
+                 _( "Check the track clearances near each modified item" ),
+                 KiBitmap( erc_xpm ), wxITEM_CHECK );
+
+    AddMenuItem( toolsMenu, ID_MENU_PCB_SHOW_MEMORY_STATS,
+                 _( "&Memory Usage" ),
+                 _( "Show the memory used by the board, the undo history, the views and the caches" ),
+                 KiBitmap( info_xpm ) );
+
     AddMenuItem( toolsMenu, ID_TOOLBARH_PCB_FREEROUTE_ACCESS,
                  _( "&FreeRoute" ),
                  _( "Fast access to the web based FreeROUTE advanced router" ),
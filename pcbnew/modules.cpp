@@ -266,6 +266,7 @@ bool PCB_EDIT_FRAME::Delete_Module( MODULE* aModule, wxDC* aDC )
 
     /* Remove module from list, and put it in undo command list */
     m_Pcb->m_Modules.Remove( aModule );
+    m_Pcb->OnItemRemoved( aModule );
     aModule->SetState( IS_DELETED, true );
     SaveCopyInUndoList( aModule, UR_DELETED );
 
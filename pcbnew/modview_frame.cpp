@@ -64,6 +64,9 @@
 #define NEW_PART        0
 #define PREVIOUS_PART   -1
 
+// The number of footprints loaded in the background on each side of the selected one
+#define PREFETCHED_FOOTPRINTS   8
+
 
 BEGIN_EVENT_TABLE( FOOTPRINT_VIEWER_FRAME, EDA_DRAW_FRAME )
     // Window events
@@ -128,7 +131,8 @@ FOOTPRINT_VIEWER_FRAME::FOOTPRINT_VIEWER_FRAME( KIWAY* aKiway, wxWindow* aParent
                 : KICAD_DEFAULT_DRAWFRAME_STYLE,
             aFrameType == FRAME_PCB_MODULE_VIEWER_MODAL ?
                                 FOOTPRINT_VIEWER_FRAME_NAME_MODAL
-                                : FOOTPRINT_VIEWER_FRAME_NAME )
+                                : FOOTPRINT_VIEWER_FRAME_NAME ),
+    m_footprintCache( Pgm().GetThreadPool() )
 {
     wxASSERT( aFrameType == FRAME_PCB_MODULE_VIEWER_MODAL ||
               aFrameType == FRAME_PCB_MODULE_VIEWER );
@@ -375,6 +379,9 @@ void FOOTPRINT_VIEWER_FRAME::ReCreateFootprintList()
 {
     m_footprintList->Clear();
 
+    // The footprints may have been modified since they were cached
+    m_footprintCache.Clear();
+
     if( !getCurNickname() )
     {
         setCurFootprintName( wxEmptyString );
@@ -448,13 +455,9 @@ void FOOTPRINT_VIEWER_FRAME::ClickOnFootprintList( wxCommandEvent& event )
         // Delete the current footprint
         GetBoard()->m_Modules.DeleteAll();
 
-        FPID id;
-        id.SetLibNickname( getCurNickname() );
-        id.SetFootprintName( getCurFootprintName() );
-
         try
         {
-            GetBoard()->Add( loadFootprint( id ) );
+            GetBoard()->Add( loadSelectedFootprint( ii ) );
         }
         catch( const IO_ERROR& ioe )
         {
@@ -479,6 +482,33 @@ void FOOTPRINT_VIEWER_FRAME::ClickOnFootprintList( wxCommandEvent& event )
 }
 
 
+MODULE* FOOTPRINT_VIEWER_FRAME::loadSelectedFootprint( int aSelection )
+{
+    FP_LIB_TABLE* fptbl = Prj().PcbFootprintLibs();
+
+    wxCHECK_MSG( fptbl, NULL, wxT( "Cannot look up FPID in NULL FP_LIB_TABLE." ) );
+
+    MODULE* footprint = m_footprintCache.Load( fptbl, getCurNickname(),
+                                               m_footprintList->GetString( aSelection ) );
+
+    // The next footprints first, the list is usually browsed downwards
+    std::vector<wxString> neighbours;
+
+    for( int ii = 1; ii <= PREFETCHED_FOOTPRINTS; ii++ )
+    {
+        if( aSelection + ii < (int) m_footprintList->GetCount() )
+            neighbours.push_back( m_footprintList->GetString( aSelection + ii ) );
+
+        if( aSelection - ii >= 0 )
+            neighbours.push_back( m_footprintList->GetString( aSelection - ii ) );
+    }
+
+    m_footprintCache.Prefetch( fptbl, getCurNickname(), neighbours );
+
+    return footprint;
+}
+
+
 void FOOTPRINT_VIEWER_FRAME::DClickOnFootprintList( wxCommandEvent& event )
 {
     if( IsModal() )
@@ -819,8 +849,7 @@ void FOOTPRINT_VIEWER_FRAME::SelectAndViewFootprint( int aMode )
         // Delete the current footprint
         GetBoard()->m_Modules.DeleteAll();
 
-        MODULE* footprint = Prj().PcbFootprintLibs()->FootprintLoad(
-                                getCurNickname(), getCurFootprintName() );
+        MODULE* footprint = loadSelectedFootprint( selection );
 
         if( footprint )
             GetBoard()->Add( footprint, ADD_APPEND );
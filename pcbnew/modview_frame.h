@@ -32,6 +32,8 @@
 
 #include <wx/gdicmn.h>
 
+#include <footprint_viewer_cache.h>
+
 class wxSashLayoutWindow;
 class wxListBox;
 class FP_LIB_TABLE;
@@ -67,6 +69,8 @@ private:
     wxListBox*          m_libList;               // The list of libs names
     wxListBox*          m_footprintList;         // The list of footprint names
 
+    FOOTPRINT_VIEWER_CACHE m_footprintCache;     // The footprints around the selected one
+
     const wxString      getCurNickname();
     void                setCurNickname( const wxString& aNickname );
 
@@ -78,6 +82,14 @@ private:
     void ReCreateFootprintList();
     void OnIterateFootprintList( wxCommandEvent& event );
 
+    /**
+     * Function loadSelectedFootprint
+     * returns the current footprint, from the footprint cache, and loads its neighbours in
+     * the footprint list in the background.
+     * @param aSelection is the index of the current footprint in the list.
+     */
+    MODULE* loadSelectedFootprint( int aSelection );
+
     /**
      * Function UpdateTitle
      * updates the window title with current library information.
@@ -0,0 +1,224 @@
+/**
+ * @file net_lengths.cpp
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <fctsys.h>
+#include <common.h>
+#include <macros.h>
+
+#include <class_board.h>
+#include <class_track.h>
+
+#include <net_lengths.h>
+
+
+BOARD_NET_LENGTHS::BOARD_NET_LENGTHS( BOARD* aBoard ) :
+    m_board( aBoard ),
+    m_valid( false ),
+    m_boardThickness( 0 ),
+    m_copperLayerCount( 0 )
+{
+    m_board->AddListener( this );
+}
+
+
+BOARD_NET_LENGTHS::~BOARD_NET_LENGTHS()
+{
+    m_board->RemoveListener( this );
+}
+
+
+bool BOARD_NET_LENGTHS::isTrack( const BOARD_ITEM* aItem )
+{
+    return aItem->Type() == PCB_TRACE_T || aItem->Type() == PCB_VIA_T;
+}
+
+
+void BOARD_NET_LENGTHS::OnBoardItemAdded( const BOARD_ITEM* aItem )
+{
+    // Before the first Update(), e.g. while the board is loaded, there is nothing to maintain
+    if( m_valid && isTrack( aItem ) )
+        m_dirtyTracks.insert( aItem );
+}
+
+
+void BOARD_NET_LENGTHS::OnBoardItemRemoved( const BOARD_ITEM* aItem )
+{
+    if( !m_valid || !isTrack( aItem ) )
+        return;
+
+    // A removed track can be deleted before the next Update()
+    m_dirtyTracks.erase( aItem );
+    removeTrack( aItem );
+}
+
+
+void BOARD_NET_LENGTHS::OnBoardItemChanged( const BOARD_ITEM* aItem )
+{
+    if( m_valid && isTrack( aItem ) )
+        m_dirtyTracks.insert( aItem );
+}
+
+
+void BOARD_NET_LENGTHS::Invalidate()
+{
+    m_valid = false;
+
+    m_nets.clear();
+    m_tracks.clear();
+    m_dirtyTracks.clear();
+}
+
+
+void BOARD_NET_LENGTHS::Update()
+{
+    const BOARD_DESIGN_SETTINGS& settings = m_board->GetDesignSettings();
+
+    if( settings.GetBoardThickness() != m_boardThickness
+            || m_board->GetCopperLayerCount() != m_copperLayerCount )
+        Invalidate();
+
+    if( !m_valid )
+    {
+        m_boardThickness = settings.GetBoardThickness();
+        m_copperLayerCount = m_board->GetCopperLayerCount();
+
+        for( const TRACK* track = m_board->m_Track; track; track = track->Next() )
+            addTrack( track );
+
+        m_valid = true;
+        return;
+    }
+
+    // The net of a changed track may have changed too: it is removed from the net it
+    // was measured in
+    for( std::set<const BOARD_ITEM*>::iterator it = m_dirtyTracks.begin();
+         it != m_dirtyTracks.end(); ++it )
+    {
+        removeTrack( *it );
+        addTrack( static_cast<const TRACK*>( *it ) );
+    }
+
+    m_dirtyTracks.clear();
+}
+
+
+const NET_LENGTH& BOARD_NET_LENGTHS::GetNet( int aNetCode ) const
+{
+    static const NET_LENGTH empty;
+
+    if( aNetCode < 0 || aNetCode >= (int) m_nets.size() )
+        return empty;
+
+    return m_nets[aNetCode];
+}
+
+
+long long BOARD_NET_LENGTHS::viaLength( const VIA* aVia ) const
+{
+    if( m_copperLayerCount < 2 )
+        return 0;
+
+    LAYER_ID top, bottom;
+
+    aVia->LayerPair( &top, &bottom );
+
+    // The position of a copper layer in the stack, from the front: B_Cu is the last one
+    int topPos = top == B_Cu ? m_copperLayerCount - 1 : top - F_Cu;
+    int bottomPos = bottom == B_Cu ? m_copperLayerCount - 1 : bottom - F_Cu;
+
+    return (long long) m_boardThickness * std::abs( bottomPos - topPos )
+                / ( m_copperLayerCount - 1 );
+}
+
+
+void BOARD_NET_LENGTHS::addTrack( const TRACK* aTrack )
+{
+    TRACK_LENGTH length;
+
+    length.m_netCode = std::max( aTrack->GetNetCode(), 0 );
+    length.m_layer = aTrack->GetLayer();
+    length.m_isVia = aTrack->Type() == PCB_VIA_T;
+
+    if( length.m_isVia )
+        length.m_length = viaLength( static_cast<const VIA*>( aTrack ) );
+    else
+        length.m_length = KiROUND( aTrack->GetLength() );
+
+    if( length.m_netCode >= (int) m_nets.size() )
+    {
+        for( int netCode = m_nets.size(); netCode <= length.m_netCode; netCode++ )
+            m_nets.push_back( NET_LENGTH( netCode ) );
+    }
+
+    NET_LENGTH& net = m_nets[length.m_netCode];
+
+    if( length.m_isVia )
+    {
+        net.m_ViaLength += length.m_length;
+        net.m_ViaCount++;
+    }
+    else
+    {
+        net.m_TrackLength += length.m_length;
+        net.m_LayerLengths[length.m_layer] += length.m_length;
+        net.m_SegmentCount++;
+    }
+
+    m_tracks[aTrack] = length;
+}
+
+
+void BOARD_NET_LENGTHS::removeTrack( const BOARD_ITEM* aTrack )
+{
+    TRACK_LENGTHS::iterator it = m_tracks.find( aTrack );
+
+    if( it == m_tracks.end() )
+        return;
+
+    // The lengths are integers: removing a track gives back the exact previous sums
+    const TRACK_LENGTH& length = it->second;
+    NET_LENGTH&         net = m_nets[length.m_netCode];
+
+    if( length.m_isVia )
+    {
+        net.m_ViaLength -= length.m_length;
+        net.m_ViaCount--;
+    }
+    else
+    {
+        net.m_TrackLength -= length.m_length;
+        net.m_SegmentCount--;
+
+        if( ( net.m_LayerLengths[length.m_layer] -= length.m_length ) == 0 )
+            net.m_LayerLengths.erase( length.m_layer );
+    }
+
+    m_tracks.erase( it );
+}
@@ -0,0 +1,152 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file net_lengths.h
+ */
+
+#ifndef NET_LENGTHS_H
+#define NET_LENGTHS_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <class_board.h>
+
+#include <boost/unordered_map.hpp>
+
+
+/**
+ * Class NET_LENGTH
+ * is the routed length of a net: the length of its track segments, on each layer
+ * and in total, and the number and length of its vias.  The lengths are in internal
+ * units, a via being as long as the part of the board thickness it crosses.
+ */
+class NET_LENGTH
+{
+public:
+    int         m_NetCode;
+    long long   m_TrackLength;      ///< the length of the track segments
+    long long   m_ViaLength;        ///< the length of the vias
+    int         m_SegmentCount;
+    int         m_ViaCount;
+
+    /// the length of the track segments on each copper layer
+    std::map<LAYER_ID, long long> m_LayerLengths;
+
+    NET_LENGTH( int aNetCode = 0 ) :
+        m_NetCode( aNetCode ),
+        m_TrackLength( 0 ),
+        m_ViaLength( 0 ),
+        m_SegmentCount( 0 ),
+        m_ViaCount( 0 )
+    {
+    }
+
+    long long GetTotalLength() const { return m_TrackLength + m_ViaLength; }
+
+    long long GetLayerLength( LAYER_ID aLayer ) const
+    {
+        std::map<LAYER_ID, long long>::const_iterator it = m_LayerLengths.find( aLayer );
+
+        return it != m_LayerLengths.end() ? it->second : 0;
+    }
+};
+
+
+/**
+ * Class BOARD_NET_LENGTHS
+ * keeps the routed length of all the nets of a board, see NET_LENGTH.  It is owned
+ * by the BOARD, built in one pass over the tracks on the first Update(), and then kept
+ * up to date from the board change notifications, like the BOARD_ITEM_INDEX: only the
+ * tracks changed since the previous Update() are measured again.
+ */
+class BOARD_NET_LENGTHS : public BOARD_LISTENER
+{
+public:
+    BOARD_NET_LENGTHS( BOARD* aBoard );
+    ~BOARD_NET_LENGTHS();
+
+    void OnBoardItemAdded( const BOARD_ITEM* aItem );
+    void OnBoardItemRemoved( const BOARD_ITEM* aItem );
+    void OnBoardItemChanged( const BOARD_ITEM* aItem );
+
+    /**
+     * Function Invalidate
+     * drops the lengths, which are measured again by the next Update().  To be used
+     * when the board has been modified without notifications.
+     */
+    void Invalidate();
+
+    /**
+     * Function Update
+     * measures all the nets, or again the tracks changed since the previous call.
+     * The lengths of the vias depend on the board thickness and on the copper layer
+     * count: all the nets are measured again when they change.
+     */
+    void Update();
+
+    /**
+     * Function GetNet
+     * @return the length of the net aNetCode, empty if the net has no tracks.
+     */
+    const NET_LENGTH& GetNet( int aNetCode ) const;
+
+    /// the count of net codes measured, one more than the largest net code with tracks
+    unsigned GetNetCount() const { return m_nets.size(); }
+
+private:
+    /// What a track contributes to the length of its net
+    struct TRACK_LENGTH
+    {
+        int         m_netCode;
+        LAYER_ID    m_layer;
+        long long   m_length;
+        bool        m_isVia;
+    };
+
+    typedef boost::unordered_map<const BOARD_ITEM*, TRACK_LENGTH> TRACK_LENGTHS;
+
+    // measures a track or a via and adds it to its net
+    void addTrack( const TRACK* aTrack );
+
+    // removes from its net what a track contributed when it was measured, if it was
+    void removeTrack( const BOARD_ITEM* aTrack );
+
+    // the length of a via, the part of the board thickness between its layers
+    long long viaLength( const VIA* aVia ) const;
+
+    static bool isTrack( const BOARD_ITEM* aItem );
+
+    BOARD*                          m_board;
+    bool                            m_valid;
+    int                             m_boardThickness;   ///< used by the via lengths
+    int                             m_copperLayerCount; ///< used by the via lengths
+
+    std::vector<NET_LENGTH>         m_nets;             ///< indexed by net code
+    TRACK_LENGTHS                   m_tracks;
+    std::set<const BOARD_ITEM*>     m_dirtyTracks;
+};
+
+#endif  // NET_LENGTHS_H
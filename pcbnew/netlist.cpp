@@ -47,6 +47,10 @@
 #include <ratsnest_data.h>
 #include <pcbnew.h>
 #include <io_mgr.h>
+#include <board_netlist_updater.h>
+#include <thread_pool.h>
+
+#include <map>
 
 #include <tool/tool_manager.h>
 #include <tools/common_actions.h>
@@ -98,7 +102,15 @@ void PCB_EDIT_FRAME::ReadPcbNetlist( const wxString& aNetlistFileName,
 
     // Clear undo and redo lists to avoid inconsistencies between lists
     if( !netlist.IsDryRun() )
+    {
         GetScreen()->ClearUndoRedoList();
+        m_journal.Invalidate();
+
+        // The net codes of the pads and tracks are renumbered without notifications
+        board->InvalidateItemIndex();
+        board->InvalidateNetLengths();
+        board->InvalidateCopperOccupancy();
+    }
 
     if( !netlist.IsDryRun() )
     {
@@ -206,6 +218,146 @@ MODULE* PCB_EDIT_FRAME::ListAndSelectModuleName()
 
 #define ALLOW_PARTIAL_FPID      1
 
+
+/**
+ * Class FOOTPRINT_PRELOADER
+ * loads the footprints of a netlist from the footprint library table, a task per
+ * library on the threads of the process, as FOOTPRINT_LIST::ReadFootprintFiles() reads
+ * the libraries.  The footprints of a library are loaded one at a time by its plugin.
+ * The footprints without library nickname are searched in all the libraries, they are
+ * not preloaded.
+ */
+class FOOTPRINT_PRELOADER
+{
+public:
+    FOOTPRINT_PRELOADER( FP_LIB_TABLE* aTable ) : m_table( aTable ) {}
+
+    ~FOOTPRINT_PRELOADER();
+
+    /// Adds a footprint to load, once for each FPID
+    void Add( const FPID& aFPID );
+
+    void Load();
+
+    /**
+     * Function Take
+     * gives the footprint loaded for @a aFPID: it is owned by the caller, and is NULL if
+     * the footprint was not found.
+     * @return false if aFPID was not preloaded.
+     * @throw IO_ERROR the error of the load of the footprint.
+     */
+    bool Take( const FPID& aFPID, MODULE** aModule ) throw( IO_ERROR );
+
+private:
+    struct FOOTPRINT
+    {
+        MODULE*  m_module;
+        wxString m_error;       // the IO_ERROR text of a failed load
+        bool     m_failed;
+    };
+
+    typedef std::map<FPID, FOOTPRINT> FOOTPRINTS;
+
+    // the footprints of a library, loaded by a loadLibrary() task
+    struct LIBRARY
+    {
+        FP_LIB_TABLE*                    m_table;
+        std::vector<FOOTPRINTS::iterator> m_footprints;
+    };
+
+    static void loadLibrary( LIBRARY* aLibrary );
+
+    FP_LIB_TABLE*                   m_table;
+    FOOTPRINTS                      m_footprints;
+    std::map<std::string, LIBRARY>  m_libraries;    // by nickname
+};
+
+
+FOOTPRINT_PRELOADER::~FOOTPRINT_PRELOADER()
+{
+    for( FOOTPRINTS::iterator it = m_footprints.begin(); it != m_footprints.end(); ++it )
+        delete it->second.m_module;
+}
+
+
+void FOOTPRINT_PRELOADER::Add( const FPID& aFPID )
+{
+    if( aFPID.GetLibNickname().empty() || m_footprints.count( aFPID ) )
+        return;
+
+    FOOTPRINT footprint = { NULL, wxEmptyString, false };
+    LIBRARY&  library = m_libraries[aFPID.GetLibNickname()];
+
+    library.m_table = m_table;
+    library.m_footprints.push_back( m_footprints.insert( std::make_pair( aFPID,
+                                                                         footprint ) ).first );
+}
+
+
+void FOOTPRINT_PRELOADER::loadLibrary( LIBRARY* aLibrary )
+{
+    for( unsigned ii = 0; ii < aLibrary->m_footprints.size(); ii++ )
+    {
+        FOOTPRINT& footprint = aLibrary->m_footprints[ii]->second;
+
+        try
+        {
+            footprint.m_module = aLibrary->m_table->FootprintLoadWithOptionalNickname(
+                                        aLibrary->m_footprints[ii]->first );
+
+            // As PCB_BASE_FRAME::loadFootprint()
+            if( footprint.m_module )
+                footprint.m_module->ClearAllNets();
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            footprint.m_error = ioe.errorText;
+            footprint.m_failed = true;
+        }
+    }
+}
+
+
+void FOOTPRINT_PRELOADER::Load()
+{
+    // Keep the locale of the plugins set for all the tasks, as
+    // FOOTPRINT_LIST::ReadFootprintFiles()
+    LOCALE_IO  top_most_nesting;
+    TASK_GROUP jobs( Pgm().GetThreadPool() );
+
+    for( std::map<std::string, LIBRARY>::iterator it = m_libraries.begin();
+         it != m_libraries.end(); ++it )
+    {
+        jobs.Run( boost::bind( &FOOTPRINT_PRELOADER::loadLibrary, &it->second ) );
+    }
+
+    // loadLibrary() catches its IO_ERRORs
+    jobs.Wait();
+}
+
+
+bool FOOTPRINT_PRELOADER::Take( const FPID& aFPID, MODULE** aModule ) throw( IO_ERROR )
+{
+    FOOTPRINTS::iterator it = m_footprints.find( aFPID );
+
+    if( it == m_footprints.end() )
+        return false;
+
+    if( it->second.m_failed )
+    {
+        IO_ERROR ioe;
+
+        ioe.errorText = it->second.m_error;
+        throw ioe;
+    }
+
+    *aModule = it->second.m_module;
+    it->second.m_module = NULL;
+
+    return true;
+}
+
+
 void PCB_EDIT_FRAME::LoadFootprints( NETLIST& aNetlist, REPORTER* aReporter )
     throw( IO_ERROR, PARSE_ERROR )
 {
@@ -220,6 +372,30 @@ void PCB_EDIT_FRAME::LoadFootprints( NETLIST& aNetlist, REPORTER* aReporter )
 
     aNetlist.SortByFPID();
 
+    // Load the footprints of all the libraries in parallel first, the footprints are
+    // then given to their components in the netlist order
+    BOARD_FOOTPRINT_MAP  footprints( m_Pcb, aNetlist.IsFindByTimeStamp() );
+    FOOTPRINT_PRELOADER  preloader( Prj().PcbFootprintLibs() );
+
+    for( unsigned ii = 0; ii < aNetlist.GetCount(); ii++ )
+    {
+        component = aNetlist.GetComponent( ii );
+
+        if( aNetlist.IsFindByTimeStamp() )
+            fpOnBoard = footprints.Find( component->GetTimeStamp() );
+        else
+            fpOnBoard = footprints.Find( component->GetReference() );
+
+        bool footprintMisMatch = aNetlist.GetReplaceFootprints() && fpOnBoard &&
+                                 fpOnBoard->GetFPID() != component->GetFPID();
+
+        if( ( fpOnBoard == NULL || footprintMisMatch )
+            && component->GetFPID().GetFootprintName().size() )
+            preloader.Add( component->GetFPID() );
+    }
+
+    preloader.Load();
+
     for( unsigned ii = 0; ii < aNetlist.GetCount(); ii++ )
     {
         component = aNetlist.GetComponent( ii );
@@ -245,9 +421,9 @@ void PCB_EDIT_FRAME::LoadFootprints( NETLIST& aNetlist, REPORTER* aReporter )
         // Check if component footprint is already on BOARD and only load the footprint from
         // the library if it's needed.  Nickname can be blank.
         if( aNetlist.IsFindByTimeStamp() )
-            fpOnBoard = m_Pcb->FindModule( aNetlist.GetComponent( ii )->GetTimeStamp(), true );
+            fpOnBoard = footprints.Find( component->GetTimeStamp() );
         else
-            fpOnBoard = m_Pcb->FindModule( aNetlist.GetComponent( ii )->GetReference() );
+            fpOnBoard = footprints.Find( component->GetReference() );
 
         bool footprintMisMatch = fpOnBoard &&
                                  fpOnBoard->GetFPID() != component->GetFPID();
@@ -296,7 +472,8 @@ void PCB_EDIT_FRAME::LoadFootprints( NETLIST& aNetlist, REPORTER* aReporter )
             }
 
             // loadFootprint() can find a footprint with an empty nickname in fpid.
-            module = PCB_BASE_FRAME::loadFootprint( component->GetFPID() );
+            if( !preloader.Take( component->GetFPID(), &module ) )
+                module = PCB_BASE_FRAME::loadFootprint( component->GetFPID() );
 
             if( module )
             {
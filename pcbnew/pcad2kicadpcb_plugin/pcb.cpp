@@ -243,6 +243,12 @@ void PCB::DoPCBComponents( XNODE*           aNode,
     PCB_KEEPOUT*  keepOut;
     wxString      cn, str, propValue;
 
+    // The pattern definitions found, by pattern name: a pattern is usually placed
+    // many times, and each search scans the library
+    std::map<wxString, XNODE*> patternDefs;
+    XNODE*                     library = FindNode( (XNODE *)aXmlDoc->GetRoot(),
+                                                   wxT( "library" ) );
+
     lNode = aNode->GetChildren();
 
     while( lNode )
@@ -254,11 +260,17 @@ void PCB::DoPCBComponents( XNODE*           aNode,
             FindNode( lNode, wxT( "patternRef" ) )->GetAttribute( wxT( "Name" ),
                                                                   &cn );
             cn      = ValidateName( cn );
-            tNode   = FindNode( (XNODE *)aXmlDoc->GetRoot(), wxT( "library" ) );
+            tNode   = library;
 
             if( tNode && cn.Len() > 0 )
             {
-                tNode = FindModulePatternDefName( tNode, cn );
+                std::map<wxString, XNODE*>::iterator def = patternDefs.find( cn );
+
+                if( def == patternDefs.end() )
+                    def = patternDefs.insert( std::make_pair( cn,
+                                    FindModulePatternDefName( tNode, cn ) ) ).first;
+
+                tNode = def->second;
 
                 if( tNode )
                 {
@@ -420,27 +432,30 @@ void PCB::DoPCBComponents( XNODE*           aNode,
 }
 
 
-void PCB::ConnectPinToNet( wxString aCompRef, wxString aPinRef, wxString aNetName )
+void PCB::ConnectPinToNet( const MODULES_BY_REF& aModules, wxString aCompRef,
+                           wxString aPinRef, wxString aNetName )
 {
     PCB_MODULE* module;
     PCB_PAD*    cp;
     int         i, j;
 
-    for( i = 0; i < (int) m_pcbComponents.GetCount(); i++ )
+    MODULES_BY_REF::const_iterator modules = aModules.find( aCompRef );
+
+    if( modules == aModules.end() )
+        return;
+
+    for( i = 0; i < (int) modules->second.size(); i++ )
     {
-        module = (PCB_MODULE*) m_pcbComponents[i];
+        module = modules->second[i];
 
-        if( module->m_objType == wxT( 'M' ) && module->m_name.text == aCompRef )
+        for( j = 0; j < (int) module->m_moduleObjects.GetCount(); j++ )
         {
-            for( j = 0; j < (int) module->m_moduleObjects.GetCount(); j++ )
+            if( module->m_moduleObjects[j]->m_objType == wxT( 'P' ) )
             {
-                if( module->m_moduleObjects[j]->m_objType == wxT( 'P' ) )
-                {
-                    cp = (PCB_PAD*) module->m_moduleObjects[j];
+                cp = (PCB_PAD*) module->m_moduleObjects[j];
 
-                    if( cp->m_name.text == aPinRef )
-                        cp->m_net = aNetName;
-                }
+                if( cp->m_name.text == aPinRef )
+                    cp->m_net = aNetName;
             }
         }
     }
@@ -811,6 +826,17 @@ void PCB::Parse( wxStatusBar* aStatusBar, wxXmlDocument* aXmlDoc, wxString aActu
         // POSTPROCESS -- SET NETLIST REFERENCES
         // aStatusBar->SetStatusText( wxT( "Processing NETLIST " ) );
 
+        MODULES_BY_REF modules;
+
+        for( i = 0; i < (int) m_pcbComponents.GetCount(); i++ )
+        {
+            if( m_pcbComponents[i]->m_objType == wxT( 'M' ) )
+            {
+                module = (PCB_MODULE*) m_pcbComponents[i];
+                modules[module->m_name.text].push_back( module );
+            }
+        }
+
         for( i = 0; i < (int) m_pcbNetlist.GetCount(); i++ )
         {
             net = m_pcbNetlist[i];
@@ -823,7 +849,7 @@ void PCB::Parse( wxStatusBar* aStatusBar, wxXmlDocument* aXmlDoc, wxString aActu
                 pinRef = net->m_netNodes[j]->m_pinRef;
                 pinRef.Trim( false );
                 pinRef.Trim( true );
-                ConnectPinToNet( compRef, pinRef, net->m_name );
+                ConnectPinToNet( modules, compRef, pinRef, net->m_name );
             }
         }
 
@@ -30,6 +30,9 @@
 #ifndef pcb_H_
 #define pcb_H_
 
+#include <map>
+#include <vector>
+
 #include <wx/wx.h>
 #include <xnode.h>
 
@@ -79,7 +82,11 @@ private:
                                      wxXmlDocument* aXmlDoc,
                                      wxString       aActualConversion,
                                      wxStatusBar*   aStatusBar );
-    void            ConnectPinToNet( wxString aCr, wxString aPr, wxString aNetName );
+    // the modules of the board by reference designator
+    typedef std::map< wxString, std::vector<PCB_MODULE*> > MODULES_BY_REF;
+
+    void            ConnectPinToNet( const MODULES_BY_REF& aModules, wxString aCr,
+                                     wxString aPr, wxString aNetName );
     int             FindLayer( wxString aLayerName );
     void            MapLayer( XNODE* aNode );
     int             FindOutlinePoint( VERTICES_ARRAY* aOutline, wxRealPoint aPoint );
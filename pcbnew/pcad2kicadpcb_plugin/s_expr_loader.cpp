@@ -26,6 +26,8 @@
  * @file s_expr_loader.cpp
  */
 
+#include <vector>
+
 #include <dsnlexer.h>
 #include <macros.h>
 #include <wx/xml/xml.h>
@@ -36,14 +38,31 @@ namespace PCAD2KICAD {
 static KEYWORD empty_keywords[1] = {};
 static const char ACCEL_ASCII_KEYWORD[] = "ACCEL_ASCII";
 
+// Sets the text content of aNode, the content of its first child as GetNodeContent()
+static void setNodeContent( XNODE* aNode, const wxString& aContent )
+{
+    if( aNode->GetChildren() )
+        aNode->GetChildren()->SetContent( aContent );
+    else
+        aNode->AddChild( new wxXmlNode( wxXML_TEXT_NODE, wxEmptyString, aContent ) );
+}
+
+
 void LoadInputFile( wxString aFileName, wxXmlDocument* aXmlDoc )
 {
     char      line[sizeof( ACCEL_ASCII_KEYWORD )];
     int       tok;
     XNODE*    iNode = NULL, *cNode = NULL;
-    wxString  str, propValue, content;
+    wxString  str;
     wxCSConv  conv( wxT( "windows-1251" ) );
 
+    // The content of cNode and the Name attributes of iNode and its parents are
+    // appended to here, and set in the nodes once complete: appending each token to
+    // the node itself copies its whole text each time.
+    wxString                content;
+    std::vector<wxString>   names( 1 );
+    std::vector<bool>       hasName( 1, false );
+
     FILE* fp = wxFopen( aFileName, wxT( "rt" ) );
 
     if( !fp )
@@ -67,15 +86,32 @@ void LoadInputFile( wxString aFileName, wxXmlDocument* aXmlDoc )
     {
         if( tok == DSN_RIGHT )
         {
-            iNode = iNode->GetParent();
+            // an unbalanced parenthesis would leave the root
+            if( names.size() > 1 )
+            {
+                if( hasName.back() )
+                    iNode->AddAttribute( wxT( "Name" ), names.back() );
+
+                names.pop_back();
+                hasName.pop_back();
+                iNode = iNode->GetParent();
+            }
         }
         else if( tok == DSN_LEFT )
         {
+            // the content of the previous node is complete: the tokens following a
+            // node go to the content of the node created last
+            if( cNode && !content.IsEmpty() )
+                setNodeContent( cNode, content );
+
+            content.Empty();
+
             tok = lexer.NextTok();
-            str = wxEmptyString;
             cNode = new XNODE( wxXML_ELEMENT_NODE, wxString( lexer.CurText(), conv ) );
             iNode->AddChild( cNode );
             iNode = cNode;
+            names.push_back( wxEmptyString );
+            hasName.push_back( false );
         }
         else if( cNode )
         {
@@ -83,29 +119,39 @@ void LoadInputFile( wxString aFileName, wxXmlDocument* aXmlDoc )
             if( tok == DSN_STRING )
             {
                 // update attribute
-                if( iNode->GetAttribute( wxT( "Name" ), &propValue ) )
-                {
-                    iNode->DeleteAttribute( wxT( "Name" ) );
-                    iNode->AddAttribute( wxT( "Name" ), propValue + wxT( ' ' ) + str );
-                }
-                else
-                    iNode->AddAttribute( wxT( "Name" ), str );
+                if( hasName.back() )
+                    names.back() += wxT( ' ' );
+
+                names.back() += str;
+                hasName.back() = true;
             }
             else if( str != wxEmptyString )
             {
                 // update node content
-                content = cNode->GetNodeContent() + wxT( ' ' ) + str;
-
-                if( cNode->GetChildren() )
-                    cNode->GetChildren()->SetContent( content );
-                else
-                    cNode->AddChild( new wxXmlNode( wxXML_TEXT_NODE,
-                                                    wxEmptyString,
-                                                    content ) );
+                content += wxT( ' ' );
+                content += str;
             }
         }
     }
 
+    if( cNode && !content.IsEmpty() )
+        setNodeContent( cNode, content );
+
+    // the nodes left open by a truncated file
+    while( names.size() > 1 )
+    {
+        if( hasName.back() )
+            iNode->AddAttribute( wxT( "Name" ), names.back() );
+
+        names.pop_back();
+        hasName.pop_back();
+        iNode = iNode->GetParent();
+    }
+
+    // the root node can have a name too
+    if( hasName.back() )
+        iNode->AddAttribute( wxT( "Name" ), names.back() );
+
     if( iNode )
     {
         aXmlDoc->SetRoot( iNode );
@@ -103,6 +103,9 @@ EDA_DRAW_PANEL_GAL( aParentWindow, aWindowId, aPosition, aSize, aGalType )
     m_worksheet = NULL;
     m_ratsnest = NULL;
 
+    m_painter = new KIGFX::PCB_PAINTER( m_gal );
+    m_view->SetPainter( m_painter );
+
     setDefaultLayerOrder();
     setDefaultLayerDeps();
 
@@ -126,32 +129,44 @@ PCB_DRAW_PANEL_GAL::~PCB_DRAW_PANEL_GAL()
 }
 
 
+/// Appends a module child to the items added to the view by DisplayBoard()
+static void collectViewItem( std::vector<KIGFX::VIEW_ITEM*>* aItems, BOARD_ITEM* aItem )
+{
+    aItems->push_back( aItem );
+}
+
+
 void PCB_DRAW_PANEL_GAL::DisplayBoard( const BOARD* aBoard )
 {
     m_view->Clear();
 
+    // The board items are collected, to be added to the view at once
+    std::vector<KIGFX::VIEW_ITEM*> items;
+
     // Load zones
     for( int i = 0; i < aBoard->GetAreaCount(); ++i )
-        m_view->Add( (KIGFX::VIEW_ITEM*) ( aBoard->GetArea( i ) ) );
+        items.push_back( aBoard->GetArea( i ) );
 
     // Load drawings
     for( BOARD_ITEM* drawing = aBoard->m_Drawings; drawing; drawing = drawing->Next() )
-        m_view->Add( drawing );
+        items.push_back( drawing );
 
     // Load tracks
     for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
-        m_view->Add( track );
+        items.push_back( track );
 
     // Load modules and its additional elements
     for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
     {
-        module->RunOnChildren( boost::bind( &KIGFX::VIEW::Add, m_view, _1 ) );
-        m_view->Add( module );
+        module->RunOnChildren( boost::bind( collectViewItem, &items, _1 ) );
+        items.push_back( module );
     }
 
     // Segzones (equivalent of ZONE_CONTAINER for legacy boards)
     for( SEGZONE* zone = aBoard->m_Zone; zone; zone = zone->Next() )
-        m_view->Add( zone );
+        items.push_back( zone );
+
+    m_view->AddItems( items );
 
     // Ratsnest
     if( m_ratsnest )
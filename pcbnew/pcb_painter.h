@@ -92,6 +92,12 @@ public:
     /// @copydoc RENDER_SETTINGS::GetColor()
     virtual const COLOR4D& GetColor( const VIEW_ITEM* aItem, int aLayer ) const;
 
+    /// @copydoc RENDER_SETTINGS::GetGridColor()
+    virtual const COLOR4D& GetGridColor() const
+    {
+        return m_layerColors[ITEM_GAL_LAYER( GRID_VISIBLE )];
+    }
+
     /**
      * Function GetLayerColor
      * Returns the color used to draw a layer.
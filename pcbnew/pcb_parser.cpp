@@ -51,9 +51,17 @@
 #include <pcb_plot_params.h>
 #include <zones.h>
 #include <pcb_parser.h>
+#include <board_journal.h>
+#include <numeric_io.h>
+
+#include <algorithm>
 
 #include <boost/make_shared.hpp>
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 using namespace PCB_KEYS_T;
 
 
@@ -127,11 +135,17 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble() throw( IO_ERROR )
 {
+    DECIMAL_NUMBER number;
+    double fval;
+
+    if( number.Parse( CurText() ) && number.ToDouble( fval ) )
+        return fval;
+
     char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    fval = KiStrtod( CurText(), &tmp );
 
     if( errno )
     {
@@ -468,6 +482,14 @@ BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR, FUTURE_FORMAT_ERRO
 BOARD* PCB_PARSER::parseBOARD_unchecked() throw( IO_ERROR, PARSE_ERROR )
 {
     T token;
+    std::deque<DEFERRED_SECTION> deferred;
+    bool defer = false;
+
+#ifdef USE_OPENMP
+    // The modules and the zones make most of a board file: they are only copied while
+    // reading the file, and parsed on several threads once the layers and nets are known.
+    defer = omp_get_max_threads() > 1;
+#endif /* USE_OPENMP */
 
     parseHeader();
 
@@ -525,7 +547,15 @@ BOARD* PCB_PARSER::parseBOARD_unchecked() throw( IO_ERROR, PARSE_ERROR )
             break;
 
         case T_module:
-            m_board->Add( parseMODULE(), ADD_APPEND );
+            if( defer )
+            {
+                deferred.push_back( DEFERRED_SECTION() );
+                captureSection( deferred.back() );
+            }
+            else
+            {
+                m_board->Add( parseMODULE(), ADD_APPEND );
+            }
             break;
 
         case T_segment:
@@ -537,7 +567,15 @@ BOARD* PCB_PARSER::parseBOARD_unchecked() throw( IO_ERROR, PARSE_ERROR )
             break;
 
         case T_zone:
-            m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
+            if( defer )
+            {
+                deferred.push_back( DEFERRED_SECTION() );
+                captureSection( deferred.back() );
+            }
+            else
+            {
+                m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
+            }
             break;
 
         case T_target:
@@ -551,10 +589,177 @@ BOARD* PCB_PARSER::parseBOARD_unchecked() throw( IO_ERROR, PARSE_ERROR )
         }
     }
 
+    if( !deferred.empty() )
+        parseDeferredSections( deferred );
+
     return m_board;
 }
 
 
+void PCB_PARSER::captureSection( DEFERRED_SECTION& aSection ) throw( IO_ERROR, PARSE_ERROR )
+{
+    aSection.m_text = "(";
+    aSection.m_text += CurText();
+    aSection.m_lineNumber = CurLineNumber();
+    aSection.m_item = NULL;
+
+    skipSection( &aSection.m_text );
+}
+
+
+void PCB_PARSER::skipSection( std::string* aText ) throw( IO_ERROR, PARSE_ERROR )
+{
+    int  depth  = 1;
+    bool quoted = false;
+
+    for( ;; )
+    {
+        const char* cc;
+
+        for( cc = next;  cc < limit;  ++cc )
+        {
+            if( quoted )
+            {
+                if( *cc == '\\' && cc + 1 < limit )
+                    ++cc;
+                else if( *cc == '"' )
+                    quoted = false;
+            }
+            else if( *cc == '"' )
+                quoted = true;
+            else if( *cc == '(' )
+                ++depth;
+            else if( *cc == ')' && --depth == 0 )
+                break;
+        }
+
+        if( depth == 0 )
+        {
+            if( aText )
+                aText->append( next, cc + 1 );
+
+            next = cc + 1;
+            return;
+        }
+
+        if( aText )
+            aText->append( next, limit );
+
+        if( !readLine() )
+            Expecting( T_RIGHT );
+    }
+}
+
+
+void PCB_PARSER::initSectionParser( const PCB_PARSER& aParent )
+{
+    m_board           = aParent.m_board;
+    m_layerIndices    = aParent.m_layerIndices;
+    m_layerMasks      = aParent.m_layerMasks;
+    m_netCodes        = aParent.m_netCodes;
+    m_tooRecent       = aParent.m_tooRecent;
+    m_requiredVersion = aParent.m_requiredVersion;
+    m_skipZoneFills   = aParent.m_skipZoneFills;
+    m_sectionParser   = true;
+}
+
+
+void PCB_PARSER::parseSection( DEFERRED_SECTION& aSection, const wxString& aSource )
+    throw( IO_ERROR, PARSE_ERROR )
+{
+    // The line number is the one of the section start, the reader counts from the next
+    STRING_LINE_READER reader( aSection.m_text, aSource, aSection.m_lineNumber - 1 );
+
+    SetLineReader( &reader );
+    m_unknownZoneNet.Empty();
+
+    NeedLEFT();
+
+    switch( NextTok() )
+    {
+    case T_module:
+        aSection.m_item = parseMODULE();
+        break;
+
+    case T_zone:
+        aSection.m_item = parseZONE_CONTAINER();
+        break;
+
+    default:
+        Unexpected( CurText() );
+    }
+
+    aSection.m_unknownZoneNet = m_unknownZoneNet;
+    PopReader();
+
+    // the text of a parsed section is not needed anymore
+    std::string().swap( aSection.m_text );
+}
+
+
+void PCB_PARSER::parseDeferredSections( std::deque<DEFERRED_SECTION>& aSections )
+    throw( IO_ERROR, PARSE_ERROR )
+{
+    const wxString source = CurSource();
+    int count  = aSections.size();
+    int failed = count;     // the first section that could not be parsed
+
+#ifdef USE_OPENMP
+    #pragma omp parallel
+#endif /* USE_OPENMP */
+    {
+        PCB_PARSER parser;
+
+        parser.initSectionParser( *this );
+
+#ifdef USE_OPENMP
+        #pragma omp for schedule(dynamic, 1)
+#endif /* USE_OPENMP */
+        for( int i = 0; i < count; ++i )
+        {
+            // No exception can leave a parallel region: a faulty section is parsed
+            // again below, to throw its error from the main thread
+            try
+            {
+                parser.parseSection( aSections[i], source );
+            }
+            catch( ... )
+            {
+#ifdef USE_OPENMP
+                #pragma omp critical( pcbParserFailedSection )
+#endif /* USE_OPENMP */
+                failed = std::min( failed, i );
+            }
+        }
+    }
+
+    if( failed < count )
+    {
+        for( int i = 0; i < count; ++i )
+            delete aSections[i].m_item;
+
+        PCB_PARSER parser;
+
+        parser.initSectionParser( *this );
+        parser.parseSection( aSections[failed], source );
+
+        delete aSections[failed].m_item;
+        THROW_IO_ERROR( wxString::Format( _( "cannot parse the section at line %d of\n%s" ),
+                                          aSections[failed].m_lineNumber,
+                                          GetChars( source ) ) );
+    }
+
+    for( int i = 0; i < count; ++i )
+    {
+        m_board->Add( aSections[i].m_item, ADD_APPEND );
+
+        if( !aSections[i].m_unknownZoneNet.IsEmpty() )
+            fixZoneNet( static_cast<ZONE_CONTAINER*>( aSections[i].m_item ),
+                        aSections[i].m_unknownZoneNet );
+    }
+}
+
+
 void PCB_PARSER::parseHeader() throw( IO_ERROR, PARSE_ERROR )
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -2789,6 +2994,26 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER() throw( IO_ERROR, PARSE_ERROR )
                     NeedRIGHT();
                     break;
 
+                case T_tiled:
+                    token = NextTok();
+
+                    if( token != T_yes && token != T_no )
+                        Expecting( "yes or no" );
+
+                    zone->SetTiledFill( token == T_yes );
+                    NeedRIGHT();
+                    break;
+
+                case T_hash:
+                    NextTok();
+
+                    // The files saved before the hash was part of the format are refilled
+                    if( m_requiredVersion >= SEXPR_BOARD_FILE_VERSION_FILL_HASH )
+                        zone->SetFillHash( strtoull( CurText(), NULL, 16 ) );
+
+                    NeedRIGHT();
+                    break;
+
                 case T_thermal_gap:
                     zone->SetThermalReliefGap( parseBoardUnits( T_thermal_gap ) );
                     NeedRIGHT();
@@ -2830,7 +3055,7 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER() throw( IO_ERROR, PARSE_ERROR )
                     break;
 
                 default:
-                    Expecting( "mode, arc_segments, thermal_gap, thermal_bridge_width, "
+                    Expecting( "mode, arc_segments, tiled, hash, thermal_gap, thermal_bridge_width, "
                                "smoothing, or radius" );
                 }
             }
@@ -2900,6 +3125,12 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER() throw( IO_ERROR, PARSE_ERROR )
             break;
 
         case T_filled_polygon:
+            if( m_skipZoneFills )
+            {
+                skipSection();
+                break;
+            }
+
             {
                 // "(filled_polygon (pts"
                 NeedLEFT();
@@ -2974,38 +3205,48 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER() throw( IO_ERROR, PARSE_ERROR )
     // Ensure the zone net name is valid, and matches the net code, for copper zones
     if( zone_has_net && ( zone->GetNet()->GetNetname() != netnameFromfile ) )
     {
-        // Can happens which old boards, with nonexistent nets ...
-        // or after being edited by hand
-        // We try to fix the mismatch.
-        NETINFO_ITEM* net = m_board->FindNet( netnameFromfile );
-
-        if( net )   // An existing net has the same net name. use it for the zone
-            zone->SetNetCode( net->GetNet() );
-        else    // Not existing net: add a new net to keep trace of the zone netname
-        {
-            int newnetcode = m_board->GetNetCount();
-            net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
-            m_board->AppendNet( net );
-
-            // Store the new code mapping
-            pushValueIntoMap( newnetcode, net->GetNet() );
-            // and update the zone netcode
-            zone->SetNetCode( net->GetNet() );
-
-            // Prompt the user
-            wxString msg;
-            msg.Printf( _( "There is a zone that belongs to a not existing net\n"
-                           "\"%s\"\n"
-                           "you should verify and edit it (run DRC test)." ),
-                           GetChars( netnameFromfile ) );
-            DisplayError( NULL, msg );
-        }
+        // The board parser adds the missing net, sections parsers leave the board as is
+        if( m_sectionParser && !m_board->FindNet( netnameFromfile ) )
+            m_unknownZoneNet = netnameFromfile;
+        else
+            fixZoneNet( zone.get(), netnameFromfile );
     }
 
     return zone.release();
 }
 
 
+void PCB_PARSER::fixZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetName )
+{
+    // Can happens which old boards, with nonexistent nets ...
+    // or after being edited by hand
+    // We try to fix the mismatch.
+    NETINFO_ITEM* net = m_board->FindNet( aNetName );
+
+    if( net )   // An existing net has the same net name. use it for the zone
+        aZone->SetNetCode( net->GetNet() );
+    else    // Not existing net: add a new net to keep trace of the zone netname
+    {
+        int newnetcode = m_board->GetNetCount();
+        net = new NETINFO_ITEM( m_board, aNetName, newnetcode );
+        m_board->AppendNet( net );
+
+        // Store the new code mapping
+        pushValueIntoMap( newnetcode, net->GetNet() );
+        // and update the zone netcode
+        aZone->SetNetCode( net->GetNet() );
+
+        // Prompt the user
+        wxString msg;
+        msg.Printf( _( "There is a zone that belongs to a not existing net\n"
+                       "\"%s\"\n"
+                       "you should verify and edit it (run DRC test)." ),
+                       GetChars( aNetName ) );
+        DisplayError( NULL, msg );
+    }
+}
+
+
 PCB_TARGET* PCB_PARSER::parsePCB_TARGET() throw( IO_ERROR, PARSE_ERROR )
 {
     wxCHECK_MSG( CurTok() == T_target, NULL,
@@ -3065,3 +3306,179 @@ PCB_TARGET* PCB_PARSER::parsePCB_TARGET() throw( IO_ERROR, PARSE_ERROR )
 
     return target.release();
 }
+
+
+wxString PCB_PARSER::ParseJournalHeader() throw( IO_ERROR, PARSE_ERROR )
+{
+    wxCHECK_MSG( m_board != NULL, wxEmptyString, wxT( "A journal needs a board." ) );
+
+    NeedLEFT();
+
+    if( NextTok() != T_journal )
+        Expecting( T_journal );
+
+    NeedLEFT();
+
+    if( NextTok() != T_version )
+        Expecting( T_version );
+
+    int version = parseInt( "journal version" );
+
+    if( version > BOARD_JOURNAL::VERSION )
+        THROW_IO_ERROR( wxString::Format( _( "Unsupported board journal version %d" ),
+                                          version ) );
+
+    NeedRIGHT();
+    NeedLEFT();
+
+    if( NextTok() != T_base )
+        Expecting( T_base );
+
+    NeedSYMBOL();
+    wxString base = FromUTF8();
+
+    NeedRIGHT();
+    NeedRIGHT();
+
+    // The items name the layers of the board, which may not be the standard names
+    for( LAYER_NUM layer = 0;  layer < LAYER_ID_COUNT;  ++layer )
+    {
+        std::string name = TO_UTF8( m_board->GetLayerName( LAYER_ID( layer ) ) );
+
+        m_layerIndices[ name ] = LAYER_ID( layer );
+        m_layerMasks[ name ]   = LSET( LAYER_ID( layer ) );
+    }
+
+    return base;
+}
+
+
+bool PCB_PARSER::ParseJournalSave( std::vector<BOARD_JOURNAL_RECORD>& aRecords )
+    throw( IO_ERROR, PARSE_ERROR )
+{
+    T token = NextTok();
+
+    if( token == T_EOF )
+        return false;
+
+    if( token != T_LEFT )
+        Expecting( T_LEFT );
+
+    if( NextTok() != T_save )
+        Expecting( T_save );
+
+    for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        BOARD_JOURNAL_RECORD record;
+
+        switch( NextTok() )
+        {
+        case T_nets:
+            parseJournalNets();
+            continue;
+
+        case T_add:
+            record.m_type = BOARD_JOURNAL_RECORD::ADD;
+            break;
+
+        case T_change:
+            record.m_type = BOARD_JOURNAL_RECORD::CHANGE;
+            break;
+
+        case T_remove:
+            record.m_type = BOARD_JOURNAL_RECORD::REMOVE;
+            break;
+
+        default:
+            Expecting( "nets, add, change or remove" );
+        }
+
+        record.m_id = parseInt( "item id" );
+
+        if( record.m_type != BOARD_JOURNAL_RECORD::REMOVE )
+            record.m_item = parseJournalItem();
+
+        aRecords.push_back( record );
+
+        NeedRIGHT();
+    }
+
+    return true;
+}
+
+
+void PCB_PARSER::parseJournalNets() throw( IO_ERROR, PARSE_ERROR )
+{
+    for( T token = NextTok();  token != T_RIGHT;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        if( NextTok() != T_net )
+            Expecting( T_net );
+
+        int netCode = parseInt( "net number" );
+
+        NeedSYMBOLorNUMBER();
+        wxString name = FromUTF8();
+
+        NeedRIGHT();
+
+        // The nets are matched by name, the codes of the journal are the ones of the
+        // board it was written from
+        NETINFO_ITEM* net = m_board->FindNet( name );
+
+        if( net == NULL )
+        {
+            net = new NETINFO_ITEM( m_board, name );
+            m_board->AppendNet( net );
+        }
+
+        pushValueIntoMap( netCode, net->GetNet() );
+    }
+}
+
+
+BOARD_ITEM* PCB_PARSER::parseJournalItem() throw( IO_ERROR, PARSE_ERROR )
+{
+    NeedLEFT();
+
+    switch( NextTok() )
+    {
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+        return parseDRAWSEGMENT();
+
+    case T_gr_text:
+        return parseTEXTE_PCB();
+
+    case T_dimension:
+        return parseDIMENSION();
+
+    case T_module:
+        return parseMODULE();
+
+    case T_segment:
+        return parseTRACK();
+
+    case T_via:
+        return parseVIA();
+
+    case T_zone:
+        return parseZONE_CONTAINER();
+
+    case T_target:
+        return parsePCB_TARGET();
+
+    default:
+        Expecting( "a board item" );
+    }
+
+    return NULL;
+}
@@ -30,11 +30,14 @@
 #ifndef _PCBNEW_PARSER_H_
 #define _PCBNEW_PARSER_H_
 
+#include <deque>
+
 #include <pcb_lexer.h>
 #include <hashtables.h>
 #include <layers_id_colors_and_visibility.h>    // LAYER_ID
 #include <common.h>                             // KiROUND
 #include <convert_to_biu.h>                     // IU_PER_MM
+#include <decimal_parser.h>
 
 
 class BOARD;
@@ -53,6 +56,7 @@ class VIA;
 class S3D_MASTER;
 class ZONE_CONTAINER;
 struct LAYER;
+struct BOARD_JOURNAL_RECORD;
 
 
 /**
@@ -71,6 +75,20 @@ class PCB_PARSER : public PCB_LEXER
     std::vector<int>    m_netCodes;         ///< net codes mapping for boards being loaded
     bool                m_tooRecent;        ///< true if version parses as later than supported
     int                 m_requiredVersion;  ///< set to the KiCad format version this board requires
+    bool                m_sectionParser;    ///< true when parsing a board section on a worker thread
+    bool                m_skipZoneFills;    ///< true to skip the filled polygons of the zones
+    wxString            m_unknownZoneNet;   ///< net name of the last zone parsed by a section
+                                            ///< parser, when the board has no such net
+
+    ///> A module or zone of a board, copied as text by the board parser to be parsed on
+    ///> a worker thread once the whole board file is read
+    struct DEFERRED_SECTION
+    {
+        std::string     m_text;             ///< the section, from its opening parenthesis
+        int             m_lineNumber;       ///< line of the file the section starts at
+        BOARD_ITEM*     m_item;             ///< the parsed section
+        wxString        m_unknownZoneNet;   ///< see PCB_PARSER::m_unknownZoneNet
+    };
 
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
@@ -137,8 +155,59 @@ class PCB_PARSER : public PCB_LEXER
     VIA*            parseVIA() throw( IO_ERROR, PARSE_ERROR );
     ZONE_CONTAINER* parseZONE_CONTAINER() throw( IO_ERROR, PARSE_ERROR );
     PCB_TARGET*     parsePCB_TARGET() throw( IO_ERROR, PARSE_ERROR );
+
+    // the net table of a journal save, and the item of one of its records
+    void            parseJournalNets() throw( IO_ERROR, PARSE_ERROR );
+    BOARD_ITEM*     parseJournalItem() throw( IO_ERROR, PARSE_ERROR );
     BOARD*          parseBOARD() throw( IO_ERROR, PARSE_ERROR, FUTURE_FORMAT_ERROR );
 
+    /**
+     * Function captureSection
+     * copies the text of the section whose keyword is the current token to @a aSection,
+     * from its opening parenthesis up to its closing one, and moves the lexer past it.
+     * Only the parentheses and the quoted strings are recognized, which is much faster
+     * than tokenizing the section.
+     */
+    void            captureSection( DEFERRED_SECTION& aSection ) throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function skipSection
+     * moves the lexer past the end of the section whose keyword is the current token,
+     * appending its text to @a aText if not NULL, like captureSection().
+     */
+    void            skipSection( std::string* aText = NULL ) throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function initSectionParser
+     * makes this parser use the board, the layers and the net codes of @a aParent, to
+     * parse the sections captured by it.
+     */
+    void            initSectionParser( const PCB_PARSER& aParent );
+
+    /**
+     * Function parseSection
+     * parses a module or zone captured by captureSection() from @a aSource.  The board is
+     * not modified, so several sections can be parsed at once by parsers of different
+     * threads.
+     */
+    void            parseSection( DEFERRED_SECTION& aSection, const wxString& aSource )
+                        throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function parseDeferredSections
+     * parses the sections captured while reading the board, on several threads if
+     * OpenMP is available, then adds them to the board in the file order.
+     */
+    void            parseDeferredSections( std::deque<DEFERRED_SECTION>& aSections )
+                        throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function fixZoneNet
+     * assigns to @a aZone the board net named @a aNetName, adding the net to the board
+     * when it does not exist.
+     */
+    void            fixZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetName );
+
     /**
      * Function parseBOARD_unchecked
      * Parse a module, but do not replace PARSE_ERROR with FUTURE_FORMAT_ERROR automatically.
@@ -208,7 +277,8 @@ class PCB_PARSER : public PCB_LEXER
     /**
      * Function parseDouble
      * parses the current token as an ASCII numeric string with possible leading
-     * whitespace into a double precision floating point number.
+     * whitespace into a double precision floating point number.  The numbers in fixed
+     * notation are converted without strtod(), with the same result.
      *
      * @throw IO_ERROR if an error occurs attempting to convert the current token.
      * @return The result of the parsed token.
@@ -228,6 +298,14 @@ class PCB_PARSER : public PCB_LEXER
 
     inline int parseBoardUnits() throw( IO_ERROR )
     {
+        DECIMAL_NUMBER number;
+        int biu;
+
+        // The lengths are written in mm with up to 6 decimals: when the internal units
+        // are nanometres, their digits are the result, and strtod() is not needed.
+        if( IU_PER_MM == 1e6 && number.Parse( CurText() ) && number.ToMillionths( biu ) )
+            return biu;
+
         // There should be no major rounding issues here, since the values in
         // the file are in mm and get converted to nano-meters.
         // See test program tools/test-nm-biu-to-ascii-mm-round-tripping.cpp
@@ -239,10 +317,8 @@ class PCB_PARSER : public PCB_LEXER
 
     inline int parseBoardUnits( const char* aExpected ) throw( PARSE_ERROR, IO_ERROR )
     {
-        // Use here KiROUND, not KIROUND (see comments about them)
-        // when having a function as argument, because it will be called twice
-        // with KIROUND
-        return KiROUND( parseDouble( aExpected ) * IU_PER_MM );
+        NeedNUMBER( aExpected );
+        return parseBoardUnits();
     }
 
     inline int parseBoardUnits( PCB_KEYS_T::T aToken ) throw( PARSE_ERROR, IO_ERROR )
@@ -279,7 +355,9 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_sectionParser( false ),
+        m_skipZoneFills( false )
     {
         init();
     }
@@ -305,6 +383,16 @@ public:
         m_board = aBoard;
     }
 
+    /**
+     * Function SetSkipZoneFills
+     * makes the parser skip the filled polygons of the zones, when they are read from
+     * a BOARD_CACHE instead.
+     */
+    void SetSkipZoneFills( bool aSkip )
+    {
+        m_skipZoneFills = aSkip;
+    }
+
     BOARD_ITEM* Parse() throw( IO_ERROR, PARSE_ERROR );
 
     /**
@@ -321,6 +409,25 @@ public:
      */
     wxString GetRequiredVersion();
 
+    /**
+     * Function ParseJournalHeader
+     * reads the header of a board journal, see BOARD_JOURNAL, whose records are then
+     * read by ParseJournalSave() into the board set with SetBoard().
+     * @return the stamp of the board file the journal applies to.
+     */
+    wxString ParseJournalHeader() throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function ParseJournalSave
+     * reads the records of the next save of a board journal.  The nets of its net table
+     * missing in the board are added to it, and the net codes of the items are translated
+     * to the ones of the board.
+     * @param aRecords [out] receives the records, whose items are owned by the caller, also
+     *  when a record cannot be read.
+     * @return false at the end of the journal.
+     */
+    bool ParseJournalSave( std::vector<BOARD_JOURNAL_RECORD>& aRecords )
+        throw( IO_ERROR, PARSE_ERROR );
 };
 
 
@@ -71,6 +71,7 @@
 #include <tools/common_actions.h>
 
 #include <wildcards_and_files_ext.h>
+#include <trace_events.h>
 
 #if defined(KICAD_SCRIPTING) || defined(KICAD_SCRIPTING_WXPYTHON)
 #include <python_scripting.h>
@@ -89,6 +90,7 @@ static const wxString MagneticTracksEntry =     "PcbMagTrackOpt";
 static const wxString ShowMicrowaveEntry =      "ShowMicrowaveTools";
 static const wxString ShowLayerManagerEntry =   "ShowLayerManagerTools";
 static const wxString ShowPageLimitsEntry =     "ShowPageLimits";
+static const wxString IncrementalSaveEntry =    "IncrementalSave";
 
 ///@}
 
@@ -108,6 +110,8 @@ BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
     EVT_TOOL( ID_MENU_RECOVER_BOARD_AUTOSAVE, PCB_EDIT_FRAME::Files_io )
     EVT_TOOL( ID_NEW_BOARD, PCB_EDIT_FRAME::Files_io )
     EVT_TOOL( ID_SAVE_BOARD, PCB_EDIT_FRAME::Files_io )
+    EVT_MENU( ID_MENU_PCB_INCREMENTAL_SAVE, PCB_EDIT_FRAME::Files_io )
+    EVT_MENU( ID_MENU_PCB_COMPACT_BOARD, PCB_EDIT_FRAME::Files_io )
     EVT_TOOL( ID_OPEN_MODULE_EDITOR, PCB_EDIT_FRAME::Process_Special_Functions )
     EVT_TOOL( ID_OPEN_MODULE_VIEWER, PCB_EDIT_FRAME::Process_Special_Functions )
 
@@ -126,6 +130,8 @@ BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
     EVT_MENU( ID_GEN_EXPORT_FILE_GENCADFORMAT, PCB_EDIT_FRAME::ExportToGenCAD )
     EVT_MENU( ID_GEN_EXPORT_FILE_MODULE_REPORT, PCB_EDIT_FRAME::GenFootprintsReport )
     EVT_MENU( ID_GEN_EXPORT_FILE_VRML, PCB_EDIT_FRAME::OnExportVRML )
+    EVT_MENU( ID_GEN_EXPORT_FILE_STEP, PCB_EDIT_FRAME::OnExportSTEP )
+    EVT_MENU( ID_GEN_EXPORT_FILE_IMAGE, PCB_EDIT_FRAME::OnExportImage )
     EVT_MENU( ID_GEN_EXPORT_FILE_IDF3, PCB_EDIT_FRAME::ExportToIDF3 )
 
     EVT_MENU( ID_GEN_IMPORT_SPECCTRA_SESSION,PCB_EDIT_FRAME::ImportSpecctraSession )
@@ -167,6 +173,7 @@ BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
 
     // menu Miscellaneous
     EVT_MENU( ID_MENU_LIST_NETS, PCB_EDIT_FRAME::ListNetsAndSelect )
+    EVT_MENU( ID_MENU_PCB_SHOW_MEMORY_STATS, PCB_EDIT_FRAME::ShowMemoryStats )
     EVT_MENU( ID_PCB_GLOBAL_DELETE, PCB_EDIT_FRAME::Process_Special_Functions )
     EVT_MENU( ID_MENU_PCB_CLEAN, PCB_EDIT_FRAME::Process_Special_Functions )
     EVT_MENU( ID_MENU_PCB_SWAP_LAYERS, PCB_EDIT_FRAME::Process_Special_Functions )
@@ -203,6 +210,7 @@ BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
     EVT_TOOL( ID_FIND_ITEMS, PCB_EDIT_FRAME::Process_Special_Functions )
     EVT_TOOL( ID_GET_NETLIST, PCB_EDIT_FRAME::Process_Special_Functions )
     EVT_TOOL( ID_DRC_CONTROL, PCB_EDIT_FRAME::Process_Special_Functions )
+    EVT_MENU( ID_DRC_ONLINE, PCB_EDIT_FRAME::Process_Special_Functions )
     EVT_TOOL( ID_AUX_TOOLBAR_PCB_SELECT_LAYER_PAIR, PCB_EDIT_FRAME::Process_Special_Functions )
     EVT_TOOL( ID_AUX_TOOLBAR_PCB_SELECT_AUTO_WIDTH, PCB_EDIT_FRAME::Tracks_and_Vias_Size_Event )
     EVT_COMBOBOX( ID_TOOLBARH_PCB_SELECT_LAYER, PCB_EDIT_FRAME::Process_Special_Functions )
@@ -274,6 +282,8 @@ BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
     EVT_UPDATE_UI( ID_AUX_TOOLBAR_PCB_SELECT_LAYER_PAIR, PCB_EDIT_FRAME::OnUpdateLayerPair )
     EVT_UPDATE_UI( ID_TOOLBARH_PCB_SELECT_LAYER, PCB_EDIT_FRAME::OnUpdateLayerSelectBox )
     EVT_UPDATE_UI( ID_TB_OPTIONS_DRC_OFF, PCB_EDIT_FRAME::OnUpdateDrcEnable )
+    EVT_UPDATE_UI( ID_DRC_ONLINE, PCB_EDIT_FRAME::OnUpdateOnlineDrc )
+    EVT_UPDATE_UI( ID_MENU_PCB_INCREMENTAL_SAVE, PCB_EDIT_FRAME::OnUpdateIncrementalSave )
     EVT_UPDATE_UI( ID_TB_OPTIONS_SHOW_RATSNEST, PCB_EDIT_FRAME::OnUpdateShowBoardRatsnest )
     EVT_UPDATE_UI( ID_TB_OPTIONS_SHOW_MODULE_RATSNEST, PCB_EDIT_FRAME::OnUpdateShowModuleRatsnest )
     EVT_UPDATE_UI( ID_TB_OPTIONS_AUTO_DEL_TRACK, PCB_EDIT_FRAME::OnUpdateAutoDeleteTrack )
@@ -312,7 +322,8 @@ END_EVENT_TABLE()
 
 PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     PCB_BASE_EDIT_FRAME( aKiway, aParent, FRAME_PCB, wxT( "Pcbnew" ), wxDefaultPosition,
-        wxDefaultSize, KICAD_DEFAULT_DRAWFRAME_STYLE, PCB_EDIT_FRAME_NAME )
+        wxDefaultSize, KICAD_DEFAULT_DRAWFRAME_STYLE, PCB_EDIT_FRAME_NAME ),
+    m_autoSaveTasks( Pgm().GetThreadPool() )
 {
     m_showBorderAndTitleBlock = true;   // true to display sheet references
     m_showAxis = false;                 // true to display X and Y axis
@@ -323,12 +334,16 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     m_SelLayerBox = NULL;
     m_show_microwave_tools = false;
     m_show_layer_manager_tools = true;
+    m_incrementalSave = false;
     m_hotkeysDescrList = g_Board_Editor_Hokeys_Descr;
     m_hasAutoSave = true;
     m_microWaveToolBar = NULL;
+    m_drc = NULL;       // created after SetBoard(), which uses it
 
     m_rotationAngle = 900;
 
+    TRACE_SCOPE( "PCB_EDIT_FRAME::PCB_EDIT_FRAME" );
+
     // Create GAL canvas
     EDA_DRAW_PANEL_GAL* galCanvas = new PCB_DRAW_PANEL_GAL( this, -1, wxPoint( 0, 0 ),
                                                 m_FrameSize, EDA_DRAW_PANEL_GAL::GAL_TYPE_NONE );
@@ -471,14 +486,27 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
 PCB_EDIT_FRAME::~PCB_EDIT_FRAME()
 {
+    // the auto save task reports to this frame
+    m_autoSaveTasks.Wait();
+
     delete m_drc;
 }
 
 
 void PCB_EDIT_FRAME::SetBoard( BOARD* aBoard )
 {
+    // The online DRC listens to the board changes, so it must stop before the board
+    // is deleted, and restart on the new board.
+    bool onlineDrc = m_drc && m_drc->OnlineTestsEnabled();
+
+    if( onlineDrc )
+        m_drc->EnableOnlineTests( false );
+
     PCB_BASE_EDIT_FRAME::SetBoard( aBoard );
 
+    if( onlineDrc )
+        m_drc->EnableOnlineTests( true );
+
     if( IsGalCanvasActive() )
     {
         aBoard->GetRatsnest()->Recalculate();
@@ -743,6 +771,7 @@ void PCB_EDIT_FRAME::LoadSettings( wxConfigBase* aCfg )
     aCfg->Read( ShowMicrowaveEntry, &m_show_microwave_tools );
     aCfg->Read( ShowLayerManagerEntry, &m_show_layer_manager_tools );
     aCfg->Read( ShowPageLimitsEntry, &m_showPageLimits );
+    aCfg->Read( IncrementalSaveEntry, &m_incrementalSave );
 }
 
 
@@ -759,6 +788,7 @@ void PCB_EDIT_FRAME::SaveSettings( wxConfigBase* aCfg )
     aCfg->Write( ShowMicrowaveEntry, (long) m_show_microwave_tools );
     aCfg->Write( ShowLayerManagerEntry, (long)m_show_layer_manager_tools );
     aCfg->Write( ShowPageLimitsEntry, m_showPageLimits );
+    aCfg->Write( IncrementalSaveEntry, m_incrementalSave );
 }
 
 
@@ -947,6 +977,13 @@ void PCB_EDIT_FRAME::OnModify( )
 {
     PCB_BASE_FRAME::OnModify();
 
+    // The legacy code modifies the items in place without notifying the board listeners,
+    // after saving them in the undo list, which has marked them
+    GetBoard()->NotifyMarkedItems();
+
+    if( m_drc )
+        m_drc->RunOnlineTests();
+
     EDA_3D_FRAME* draw3DFrame = Get3DViewerFrame();
 
     if( draw3DFrame )
@@ -997,6 +1034,13 @@ void PCB_EDIT_FRAME::UpdateTitle()
 void PCB_EDIT_FRAME::ScriptingConsoleEnableDisable( wxCommandEvent& aEvent )
 {
 
+    // Also when used before the frame started Python
+    if( !PcbnewStartScripting() )
+    {
+        wxMessageBox( wxT( "Error: the Python scripting is not available" ) );
+        return;
+    }
+
     wxWindow * pythonPanelFrame = findPythonConsole();
     bool pythonPanelShown = true;
 
@@ -58,6 +58,15 @@
 #include <modview_frame.h>
 #include <footprint_wizard_frame.h>
 
+#include <config.h>
+#include <trace_events.h>
+
+#include <boost/bind.hpp>
+
+#if defined(BUILD_GITHUB_PLUGIN)
+ #include <github/github_plugin.h>
+#endif
+
 extern bool IsWxPythonLoaded();
 
 // Colors for layers and items
@@ -122,6 +131,9 @@ static struct IFACE : public KIFACE_I
 #if defined( KICAD_SCRIPTING )
             // give the scripting helpers access to our frame
             ScriptingSetPcbEditFrame( (PCB_EDIT_FRAME*) frame );
+
+            // Python is started once the frame is shown, rather than before it is built
+            ( (PCB_EDIT_FRAME*) frame )->CallAfter( boost::bind( &PcbnewStartScripting ) );
 #endif
 
             if( Kiface().IsSingle() )
@@ -201,6 +213,10 @@ PGM_BASE& Pgm()
 
 
 #if defined( KICAD_SCRIPTING )
+/// The bundled scripts and plugins, given to Python by PcbnewStartScripting()
+static wxString scriptingPath;
+
+
 static bool scriptingSetup()
 {
     wxString path_frag;
@@ -298,13 +314,29 @@ static bool scriptingSetup()
 
     // path_frag is the path to the bundled scripts and plugins, all other paths are
     // determined by the python pcbnew.py initialisation code.
-    if( !pcbnewInitPythonScripting( TO_UTF8( path_frag ) ) )
+    scriptingPath = path_frag;
+
+    return true;
+}
+
+
+bool PcbnewStartScripting()
+{
+    static bool started = false;
+    static bool ready = false;
+
+    if( !started )
     {
-        wxLogError( wxT( "pcbnewInitPythonScripting() failed." ) );
-        return false;
+        TRACE_SCOPE( "pcbnewInitPythonScripting" );
+
+        started = true;
+        ready = pcbnewInitPythonScripting( TO_UTF8( scriptingPath ) );
+
+        if( !ready )
+            wxLogError( wxT( "pcbnewInitPythonScripting() failed." ) );
     }
 
-    return true;
+    return ready;
 }
 #endif  // KICAD_SCRIPTING
 
@@ -321,6 +353,8 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
 
     // Do nothing in here pertinent to a project!
 
+    TRACE_SCOPE( "PCB::IFACE::OnKifaceStart" );
+
     start_common( aCtlBits );
 
     // Must be called before creating the main frame in order to
@@ -357,6 +391,11 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
         return false;
     }
 
+#if defined(BUILD_GITHUB_PLUGIN)
+    // Download the Github libraries while the user does something else
+    GITHUB_PLUGIN::PrefetchLibraries( GFootprintTable );
+#endif
+
 #if defined(KICAD_SCRIPTING)
     scriptingSetup();
 #endif
@@ -367,6 +406,10 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
 
 void IFACE::OnKifaceEnd()
 {
+#if defined(BUILD_GITHUB_PLUGIN)
+    GITHUB_PLUGIN::WaitForPrefetch();
+#endif
+
     end_common();
 
 #if defined( KICAD_SCRIPTING_WXPYTHON )
@@ -102,6 +102,17 @@ extern DLIST<TRACK> g_CurrentTrackList;
 #define g_FirstTrackSegment   g_CurrentTrackList.GetFirst()   ///< first segment created
 
 
+#if defined( KICAD_SCRIPTING )
+/**
+ * Function PcbnewStartScripting
+ * initializes Python and loads the scripting plugins, on the first call only.  It is
+ * called once the board editor is shown, and before any use of the scripting.
+ * @return true if the scripting is available.
+ */
+bool PcbnewStartScripting();
+#endif
+
+
 enum MagneticPadOptionValues {
     no_effect,
     capture_cursor_in_track_tool,
@@ -254,6 +254,8 @@ enum pcbnew_ids
 
     ID_MENU_READ_BOARD_BACKUP_FILE,
     ID_MENU_RECOVER_BOARD_AUTOSAVE,
+    ID_MENU_PCB_INCREMENTAL_SAVE,
+    ID_MENU_PCB_COMPACT_BOARD,
     ID_MENU_ARCHIVE_MODULES,
     ID_MENU_ARCHIVE_MODULES_IN_LIBRARY,
     ID_MENU_CREATE_LIBRARY_AND_ARCHIVE_MODULES,
@@ -265,6 +267,8 @@ enum pcbnew_ids
 
     ID_GEN_EXPORT_FILE_IDF3,
     ID_GEN_EXPORT_FILE_VRML,
+    ID_GEN_EXPORT_FILE_STEP,
+    ID_GEN_EXPORT_FILE_IMAGE,
     ID_GEN_EXPORT_SPECCTRA,
     ID_GEN_EXPORT_FILE_GENCADFORMAT,
     ID_GEN_EXPORT_FILE_MODULE_REPORT,
@@ -300,6 +304,7 @@ enum pcbnew_ids
     ID_MENU_PCB_SHOW_DESIGN_RULES_DIALOG,
     ID_MENU_PCB_SHOW_HIDE_LAYERS_MANAGER_DIALOG,
     ID_MENU_PCB_SHOW_HIDE_MUWAVE_TOOLBAR,
+    ID_MENU_PCB_SHOW_MEMORY_STATS,
 
     ID_TB_OPTIONS_SHOW_MANAGE_LAYERS_VERTICAL_TOOLBAR,
     ID_TB_OPTIONS_SHOW_ZONES,
@@ -324,6 +329,7 @@ enum pcbnew_ids
     ID_PCB_MUWAVE_END_CMD,
 
     ID_DRC_CONTROL,
+    ID_DRC_ONLINE,
     ID_PCB_GLOBAL_DELETE,
     ID_POPUP_PCB_DELETE_TRACKSEG,
     ID_TOOLBARH_PCB_SELECT_LAYER,
@@ -391,6 +397,7 @@ enum pcbnew_ids
     ID_FOOTPRINT_WIZARD_PARAMETERS_WINDOW,
     ID_FOOTPRINT_WIZARD_SELECT_WIZARD,
     ID_FOOTPRINT_WIZARD_EXPORT_TO_BOARD,
+    ID_FOOTPRINT_WIZARD_REBUILD_TIMER,
 
     ID_UPDATE_PCB_FROM_SCH,
     ID_PCBNEW_END_LIST
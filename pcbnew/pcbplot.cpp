@@ -43,6 +43,7 @@
 #include <dialog_plot.h>
 #include <macros.h>
 #include <build_version.h>
+#include <trace_events.h>
 
 
 const wxString GetGerberProtelExtension( LAYER_NUM aLayer )
@@ -395,6 +396,8 @@ bool PLOT_CONTROLLER::OpenPlotfile( const wxString &aSuffix,
 
 bool PLOT_CONTROLLER::PlotLayer()
 {
+    TRACE_SCOPE( "PLOT_CONTROLLER::PlotLayer" );
+
     LOCALE_IO toggle;
 
     // No plot open, nothing to do...
@@ -29,6 +29,8 @@
 #ifndef PCBPLOT_H_
 #define PCBPLOT_H_
 
+#include <vector>
+
 #include <wx/filename.h>
 #include <pad_shapes.h>
 #include <pcb_plot_params.h>
@@ -129,6 +131,14 @@ public:
      */
     void PlotPad( D_PAD* aPad, EDA_COLOR_T aColor, EDA_DRAW_MODE_T aPlotMode );
 
+    /**
+     * Plot a pad with the size aSize instead of its own size, for instance
+     * the size of its solder mask opening.  The pad is not modified, so the
+     * layers of a board can be plotted concurrently.
+     */
+    void PlotPad( D_PAD* aPad, EDA_COLOR_T aColor, EDA_DRAW_MODE_T aPlotMode,
+                  const wxSize& aSize );
+
     /**
      * plot items like text and graphics,
      *  but not tracks and modules
@@ -183,6 +193,32 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt );
 
+/// A layer to plot by PlotBoardLayers(), to its own file
+struct PLOT_LAYER_JOB
+{
+    LAYER_ID    m_Layer;
+    wxString    m_FileName;
+    bool        m_Plotted;      // set by PlotBoardLayers() when the file is complete
+};
+
+/**
+ * Function PlotBoardLayers
+ * plots each layer of a fabrication set to its own file, the layers being plotted
+ * concurrently on the threads of the process, so a set of layers takes about the
+ * time of its slowest layer.
+ * The files are opened, and their header and frame reference plotted, one at a
+ * time by StartPlotBoard().  Then each layer is plotted by PlotOneBoardLayer(),
+ * which only reads the board.
+ * @param aBoard = the board to plot, with its zones filled
+ * @param aPlotOpts = the plot options, shared by all the layers
+ * @param aJobs = the layers to plot and their file names
+ * @param aSheetDesc = the sheet description of the frame references
+ * @return true if all the files are plotted
+ */
+bool PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs,
+                      const wxString& aSheetDesc );
+
 /**
  * Function PlotStandardLayer
  * plot copper or technical layers.
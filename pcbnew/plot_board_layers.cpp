@@ -29,6 +29,10 @@
  */
 
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include <fctsys.h>
 #include <common.h>
 #include <plot_common.h>
@@ -50,6 +54,13 @@
 
 #include <pcbnew.h>
 #include <pcbplot.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
+#include <trace_events.h>
+
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_map.hpp>
 
 // Local
 /* Plot a solder mask layer.
@@ -144,6 +155,8 @@ void PlotSilkScreen( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt )
 {
+    TRACE_SCOPE( "PlotOneBoardLayer" );
+
     PCB_PLOT_PARAMS plotOpt = aPlotOpt;
     int soldermask_min_thickness = aBoard->GetDesignSettings().m_SolderMaskMinWidth;
 
@@ -275,6 +288,95 @@ void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, LAYER_ID aLayer,
 }
 
 
+// A track segment, as plotted
+struct PLOT_SEGMENT
+{
+    wxPoint     m_Start;
+    wxPoint     m_End;
+    int         m_Width;
+    LAYER_ID    m_Layer;
+};
+
+
+static bool segmentWidthLess( const PLOT_SEGMENT& aFirst, const PLOT_SEGMENT& aSecond )
+{
+    return aFirst.m_Width < aSecond.m_Width;
+}
+
+
+/* Order the segments in chains, each segment of a chain starting at the end of the
+ * previous one, so that the Gerber plotter writes them as polylines with one aperture.
+ * The segments are grouped by width, and chained greedily inside a group.
+ */
+static void chainSegments( std::vector<PLOT_SEGMENT>& aSegments )
+{
+    typedef std::multimap< std::pair<int, int>, unsigned > ENDPOINT_MAP;
+
+    std::stable_sort( aSegments.begin(), aSegments.end(), segmentWidthLess );
+
+    std::vector<PLOT_SEGMENT> chained;
+    std::vector<bool>         used( aSegments.size(), false );
+
+    chained.reserve( aSegments.size() );
+
+    for( unsigned first = 0; first < aSegments.size(); )
+    {
+        unsigned last = first;
+
+        while( last < aSegments.size() && aSegments[last].m_Width == aSegments[first].m_Width )
+            last++;
+
+        ENDPOINT_MAP ends;
+
+        for( unsigned ii = first; ii < last; ii++ )
+        {
+            const PLOT_SEGMENT& seg = aSegments[ii];
+
+            ends.insert( std::make_pair( std::make_pair( seg.m_Start.x, seg.m_Start.y ), ii ) );
+            ends.insert( std::make_pair( std::make_pair( seg.m_End.x, seg.m_End.y ), ii ) );
+        }
+
+        for( unsigned ii = first; ii < last; ii++ )
+        {
+            if( used[ii] )
+                continue;
+
+            used[ii] = true;
+            chained.push_back( aSegments[ii] );
+
+            // Follow the chain from the end of the segment, while an unused segment
+            // of the group touches it
+            for( ;; )
+            {
+                wxPoint end = chained.back().m_End;
+                std::pair<ENDPOINT_MAP::iterator, ENDPOINT_MAP::iterator> range =
+                        ends.equal_range( std::make_pair( end.x, end.y ) );
+                ENDPOINT_MAP::iterator it = range.first;
+
+                while( it != range.second && used[it->second] )
+                    ++it;
+
+                if( it == range.second )
+                    break;
+
+                PLOT_SEGMENT next = aSegments[it->second];
+
+                used[it->second] = true;
+
+                if( next.m_Start != end )
+                    std::swap( next.m_Start, next.m_End );
+
+                chained.push_back( next );
+            }
+        }
+
+        first = last;
+    }
+
+    aSegments.swap( chained );
+}
+
+
 /* Plot a copper layer or mask.
  * Silk screen layers are not plotted here.
  */
@@ -365,15 +467,13 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = ColorFromInt( color | aBoard->GetVisibleElementColor( PAD_FR_VISIBLE ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-            pad->SetSize( padPlotsSize );
+            // The pad is plotted with the required plot size, it is not modified
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    (pad->GetSize() == pad->GetDrillSize()) &&
+                    (padPlotsSize == pad->GetDrillSize()) &&
                     (pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED) )
                     break;
 
@@ -382,11 +482,9 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_ROUNDRECT:
             default:
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( pad, color, plotMode, padPlotsSize );
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
         }
     }
 
@@ -441,6 +539,8 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
     }
 
     // Plot tracks (not vias) :
+    std::vector<PLOT_SEGMENT> segments;
+
     for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
     {
         if( track->Type() == PCB_VIA_T )
@@ -449,9 +549,25 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
         if( !aLayerMask[track->GetLayer()] )
             continue;
 
-        int width = track->GetWidth() + itemplotter.getFineWidthAdj();
-        aPlotter->SetColor( itemplotter.getColor( track->GetLayer() ) );
-        aPlotter->ThickSegment( track->GetStart(), track->GetEnd(), width, plotMode );
+        PLOT_SEGMENT seg;
+
+        seg.m_Start = track->GetStart();
+        seg.m_End   = track->GetEnd();
+        seg.m_Width = track->GetWidth() + itemplotter.getFineWidthAdj();
+        seg.m_Layer = track->GetLayer();
+        segments.push_back( seg );
+    }
+
+    // The optimized Gerber output draws the touching tracks of a width as polylines
+    if( aPlotter->GetPlotterType() == PLOT_FORMAT_GERBER && aPlotOpt.GetUseGerberOptimization() )
+        chainSegments( segments );
+
+    for( unsigned ii = 0; ii < segments.size(); ii++ )
+    {
+        const PLOT_SEGMENT& seg = segments[ii];
+
+        aPlotter->SetColor( itemplotter.getColor( seg.m_Layer ) );
+        aPlotter->ThickSegment( seg.m_Start, seg.m_End, seg.m_Width, plotMode );
     }
 
     // Plot zones (outdated, for old boards compatibility):
@@ -550,16 +666,25 @@ void PlotLayerOutlines( BOARD* aBoard, PLOTTER* aPlotter,
     BRDITEMS_PLOTTER itemplotter( aPlotter, aBoard, aPlotOpt );
     itemplotter.SetLayerSet( aLayerMask );
 
-    SHAPE_POLY_SET outlines;
+    // The contours of the layers are merged together, the layers in parallel
+    LSEQ seq = aLayerMask.Seq( plot_seq, DIM( plot_seq ) );
+    std::vector<SHAPE_POLY_SET> layerOutlines( seq.size() );
+    SHAPE_POLY_SET::BOOLEAN_BATCH batch;
 
-    for( LSEQ seq = aLayerMask.Seq( plot_seq, DIM( plot_seq ) );  seq;  ++seq )
+    for( unsigned ll = 0; ll < seq.size(); ll++ )
     {
-        LAYER_ID layer = *seq;
+        aBoard->ConvertBrdLayerToPolygonalContours( seq[ll], layerOutlines[ll] );
 
-        outlines.RemoveAllContours();
-        aBoard->ConvertBrdLayerToPolygonalContours( layer, outlines );
+        batch.NewJob();
+        batch.Simplify( layerOutlines[ll], SHAPE_POLY_SET::PM_FAST );
+    }
 
-        outlines.Simplify( SHAPE_POLY_SET::PM_FAST );
+    batch.Run();
+
+    for( unsigned ll = 0; ll < seq.size(); ll++ )
+    {
+        LAYER_ID layer = seq[ll];
+        const SHAPE_POLY_SET& outlines = layerOutlines[ll];
 
         // Plot outlines
         std::vector< wxPoint > cornerList;
@@ -624,6 +749,152 @@ void PlotLayerOutlines( BOARD* aBoard, PLOTTER* aPlotter,
 }
 
 
+/**
+ * Class PAD_MASK_SHAPES
+ * builds the solder mask polygons of the pads.  The polygon of a pad shape (shape, size,
+ * orientation, offset and margin) is built once, and moved to the position of each pad
+ * having this shape: a board has many pads but few pad shapes.
+ */
+class PAD_MASK_SHAPES
+{
+public:
+    PAD_MASK_SHAPES( int aSegmentsPerCircle, double aCorrectionFactor ) :
+        m_segmentsPerCircle( aSegmentsPerCircle ),
+        m_correctionFactor( aCorrectionFactor )
+    {
+    }
+
+    /**
+     * Function Add
+     * adds the polygons of the pads of @a aModule on @a aLayer to @a aBuffer, inflated
+     * by their solder mask margin and by @a aInflateValue, like
+     * MODULE::TransformPadsShapesWithClearanceToPolygon().
+     */
+    void Add( const MODULE* aModule, LAYER_ID aLayer, int aInflateValue, SHAPE_POLY_SET& aBuffer )
+    {
+        for( const D_PAD* pad = aModule->Pads(); pad; pad = pad->Next() )
+        {
+            if( !pad->IsOnLayer( aLayer ) )
+                continue;
+
+            int margin = pad->GetSolderMaskMargin() + aInflateValue;
+            KEY key = { pad->GetShape(), pad->GetSize(), pad->GetDelta(),
+                        pad->ShapePos() - pad->GetPosition(), pad->GetOrientation(),
+                        pad->GetRoundRectCornerRadius(), margin };
+
+            SHAPE_MAP::iterator it = m_shapes.find( key );
+
+            if( it == m_shapes.end() )
+            {
+                SHAPE_POLY_SET shape;
+
+                pad->BuildPadShapePolygon( shape, wxSize( margin, margin ),
+                                           m_segmentsPerCircle, m_correctionFactor );
+                shape.Move( -VECTOR2I( pad->GetPosition() ) );
+
+                it = m_shapes.insert( std::make_pair( key, shape ) ).first;
+            }
+
+            SHAPE_POLY_SET moved( it->second );
+
+            moved.Move( pad->GetPosition() );
+            aBuffer.Append( moved );
+        }
+    }
+
+private:
+    struct KEY
+    {
+        PAD_SHAPE_T m_shape;
+        wxSize      m_size;
+        wxSize      m_delta;
+        wxPoint     m_offset;
+        double      m_orient;
+        int         m_cornerRadius;
+        int         m_margin;
+
+        bool operator==( const KEY& aOther ) const
+        {
+            return m_shape == aOther.m_shape && m_size == aOther.m_size
+                   && m_delta == aOther.m_delta && m_offset == aOther.m_offset
+                   && m_orient == aOther.m_orient && m_cornerRadius == aOther.m_cornerRadius
+                   && m_margin == aOther.m_margin;
+        }
+    };
+
+    struct KEY_HASH
+    {
+        std::size_t operator()( const KEY& aKey ) const
+        {
+            std::size_t seed = 0;
+
+            boost::hash_combine( seed, (int) aKey.m_shape );
+            boost::hash_combine( seed, aKey.m_size.x );
+            boost::hash_combine( seed, aKey.m_size.y );
+            boost::hash_combine( seed, aKey.m_delta.x );
+            boost::hash_combine( seed, aKey.m_delta.y );
+            boost::hash_combine( seed, aKey.m_offset.x );
+            boost::hash_combine( seed, aKey.m_offset.y );
+            boost::hash_combine( seed, aKey.m_orient );
+            boost::hash_combine( seed, aKey.m_cornerRadius );
+            boost::hash_combine( seed, aKey.m_margin );
+
+            return seed;
+        }
+    };
+
+    typedef boost::unordered_map<KEY, SHAPE_POLY_SET, KEY_HASH> SHAPE_MAP;
+
+    SHAPE_MAP   m_shapes;
+    int         m_segmentsPerCircle;
+    double      m_correctionFactor;
+};
+
+
+/**
+ * Function deflateMergedAreas
+ * deflates the merged polygons of @a aAreas by @a aDeflate.  The merged polygons are
+ * disjoint, so they are deflated separately, by groups on the threads of the pool.
+ */
+static void deflateMergedAreas( SHAPE_POLY_SET& aAreas, int aDeflate, int aSegmentsPerCircle )
+{
+    const int polysPerGroup = 64;
+    int polyCount = aAreas.OutlineCount();
+
+    if( polyCount <= polysPerGroup )
+    {
+        aAreas.Inflate( -aDeflate, aSegmentsPerCircle );
+        return;
+    }
+
+    std::vector<SHAPE_POLY_SET> groups( ( polyCount + polysPerGroup - 1 ) / polysPerGroup );
+
+    for( int ii = 0; ii < polyCount; ii++ )
+    {
+        SHAPE_POLY_SET& group = groups[ii / polysPerGroup];
+        int outline = group.AddOutline( aAreas.COutline( ii ) );
+
+        for( int jj = 0; jj < aAreas.HoleCount( ii ); jj++ )
+            group.AddHole( aAreas.CHole( ii, jj ), outline );
+    }
+
+    {
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned ii = 0; ii < groups.size(); ii++ )
+            tasks.Run( boost::bind( &SHAPE_POLY_SET::Inflate, &groups[ii], -aDeflate,
+                                    aSegmentsPerCircle ) );
+
+        tasks.Wait();
+    }
+
+    aAreas.RemoveAllContours();
+
+    for( unsigned ii = 0; ii < groups.size(); ii++ )
+        aAreas.Append( groups[ii] );
+}
+
+
 /* Plot a solder mask layer.
  * Solder mask layers have a minimum thickness value and cannot be drawn like standard layers,
  * unless the minimum thickness is 0.
@@ -694,16 +965,14 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter,
     double correction = 1.0 / cos( M_PI / circleToSegmentsCount );
 
     // Plot pads
+    PAD_MASK_SHAPES padShapes( circleToSegmentsCount, correction );
+
     for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
     {
         // add shapes with exact size
-        module->TransformPadsShapesWithClearanceToPolygon( layer,
-                        initialPolys, 0,
-                        circleToSegmentsCount, correction );
+        padShapes.Add( module, layer, 0, initialPolys );
         // add shapes inflated by aMinThickness/2
-        module->TransformPadsShapesWithClearanceToPolygon( layer,
-                        areas, inflate,
-                        circleToSegmentsCount, correction );
+        padShapes.Add( module, layer, inflate, areas );
     }
 
     // Plot vias on solder masks, if aPlotOpt.GetPlotViaOnMaskLayer() is true,
@@ -774,8 +1043,13 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter,
     zone.SetMinThickness( 0 );      // trace polygons only
     zone.SetLayer ( layer );
 
+    // Merge the many overlapping shapes of each set by batches of neighbours, before
+    // their union
+    areas.SimplifyBatched( SHAPE_POLY_SET::PM_FAST );
+    initialPolys.SimplifyBatched( SHAPE_POLY_SET::PM_FAST );
+
     areas.BooleanAdd( initialPolys, SHAPE_POLY_SET::PM_FAST );
-    areas.Inflate( -inflate, circleToSegmentsCount );
+    deflateMergedAreas( areas, inflate, circleToSegmentsCount );
 
     // Combine the current areas to initial areas. This is mandatory because
     // inflate/deflate transform is not perfect, and we want the initial areas perfectly kept
@@ -872,6 +1146,7 @@ static void initializePlotter( PLOTTER *aPlotter, BOARD * aBoard,
                            aPlotOpts->GetMirror() );
     // has meaning only for gerber plotter. Must be called only after SetViewport
     aPlotter->SetGerberCoordinatesFormat( aPlotOpts->GetGerberPrecision() );
+    aPlotter->SetGerberOptimization( aPlotOpts->GetUseGerberOptimization() );
 
     aPlotter->SetDefaultLineWidth( aPlotOpts->GetLineWidth() );
     aPlotter->SetCreator( wxT( "PCBNEW" ) );
@@ -1021,3 +1296,58 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts,
     delete plotter;
     return NULL;
 }
+
+
+// The task of PlotBoardLayers() plotting one layer to its already started plotter.  The
+// texts of the layers plotted concurrently are drawn one at a time by DrawGraphicText(),
+// which locks the shared basic_gal.
+static void plotLayerTask( BOARD* aBoard, PLOTTER* aPlotter, PLOT_LAYER_JOB* aJob,
+                           const PCB_PLOT_PARAMS* aPlotOpts )
+{
+    PlotOneBoardLayer( aBoard, aPlotter, aJob->m_Layer, *aPlotOpts );
+    aPlotter->EndPlot();
+
+    aJob->m_Plotted = true;
+}
+
+
+bool PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs,
+                      const wxString& aSheetDesc )
+{
+    // The C locale is set once, for the plots of all the threads
+    LOCALE_IO toggle;
+
+    std::vector<PLOTTER*> plotters( aJobs.size(), (PLOTTER*) NULL );
+
+    // StartPlotBoard() computes the board bounding box: it is not run concurrently
+    for( unsigned ii = 0; ii < aJobs.size(); ii++ )
+    {
+        aJobs[ii].m_Plotted = false;
+        plotters[ii] = StartPlotBoard( aBoard, aPlotOpts, aJobs[ii].m_Layer,
+                                       aJobs[ii].m_FileName, aSheetDesc );
+    }
+
+    {
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+        for( unsigned ii = 0; ii < aJobs.size(); ii++ )
+        {
+            if( plotters[ii] )
+                tasks.Run( boost::bind( plotLayerTask, aBoard, plotters[ii], &aJobs[ii],
+                                        aPlotOpts ) );
+        }
+
+        tasks.Wait();
+    }
+
+    bool success = true;
+
+    for( unsigned ii = 0; ii < aJobs.size(); ii++ )
+    {
+        delete plotters[ii];
+        success = success && aJobs[ii].m_Plotted;
+    }
+
+    return success;
+}
@@ -64,6 +64,13 @@ EDA_COLOR_T BRDITEMS_PLOTTER::getColor( LAYER_NUM aLayer )
 
 
 void BRDITEMS_PLOTTER::PlotPad( D_PAD* aPad, EDA_COLOR_T aColor, EDA_DRAW_MODE_T aPlotMode )
+{
+    PlotPad( aPad, aColor, aPlotMode, aPad->GetSize() );
+}
+
+
+void BRDITEMS_PLOTTER::PlotPad( D_PAD* aPad, EDA_COLOR_T aColor, EDA_DRAW_MODE_T aPlotMode,
+                                const wxSize& aSize )
 {
     wxPoint shape_pos = aPad->ShapePos();
 
@@ -74,11 +81,11 @@ void BRDITEMS_PLOTTER::PlotPad( D_PAD* aPad, EDA_COLOR_T aColor, EDA_DRAW_MODE_T
     switch( aPad->GetShape() )
     {
     case PAD_SHAPE_CIRCLE:
-        m_plotter->FlashPadCircle( shape_pos, aPad->GetSize().x, aPlotMode );
+        m_plotter->FlashPadCircle( shape_pos, aSize.x, aPlotMode );
         break;
 
     case PAD_SHAPE_OVAL:
-        m_plotter->FlashPadOval( shape_pos, aPad->GetSize(),
+        m_plotter->FlashPadOval( shape_pos, aSize,
                                  aPad->GetOrientation(), aPlotMode );
         break;
 
@@ -86,19 +93,29 @@ void BRDITEMS_PLOTTER::PlotPad( D_PAD* aPad, EDA_COLOR_T aColor, EDA_DRAW_MODE_T
         {
         wxPoint coord[4];
         aPad->BuildPadPolygon( coord, wxSize(0,0), 0 );
+
+        // The corners of a pad of size aSize, with the same delta size
+        int dx = ( aSize.x >> 1 ) - ( aPad->GetSize().x >> 1 );
+        int dy = ( aSize.y >> 1 ) - ( aPad->GetSize().y >> 1 );
+
+        coord[0] += wxPoint( -dx, dy );
+        coord[1] += wxPoint( -dx, -dy );
+        coord[2] += wxPoint( dx, -dy );
+        coord[3] += wxPoint( dx, dy );
+
         m_plotter->FlashPadTrapez( shape_pos, coord,
                                    aPad->GetOrientation(), aPlotMode );
         }
         break;
 
     case PAD_SHAPE_ROUNDRECT:
-        m_plotter->FlashPadRoundRect( shape_pos, aPad->GetSize(), aPad->GetRoundRectCornerRadius(),
+        m_plotter->FlashPadRoundRect( shape_pos, aSize, aPad->GetRoundRectCornerRadius( aSize ),
                                       aPad->GetOrientation(), aPlotMode );
         break;
 
     case PAD_SHAPE_RECT:
     default:
-        m_plotter->FlashPadRect( shape_pos, aPad->GetSize(),
+        m_plotter->FlashPadRect( shape_pos, aSize,
                                  aPad->GetOrientation(), aPlotMode );
         break;
     }
@@ -502,9 +519,12 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone )
         return;
 
     // We need a buffer to store corners coordinates:
-    static std::vector< wxPoint > cornerList;
+    std::vector< wxPoint > cornerList;
     cornerList.clear();
 
+    // The solid polygons, plotted together once collected
+    std::vector< std::vector< wxPoint > > solidPolygons;
+
     m_plotter->SetColor( getColor( aZone->GetLayer() ) );
 
     /* Plot all filled areas: filled areas have a filled area and a thick
@@ -533,7 +553,7 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone )
                 // The area can be filled by segments or uses solid polygons
                 if( aZone->GetFillMode() == 0 ) // We are using solid polygons
                 {
-                    m_plotter->PlotPoly( cornerList, FILLED_SHAPE, aZone->GetMinThickness() );
+                    solidPolygons.push_back( cornerList );
                 }
                 else    // We are using areas filled by segments: plot segments and outline
                 {
@@ -567,6 +587,10 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone )
             cornerList.clear();
         }
     }
+
+    // A Gerber plotter can write all the polygons as a single region
+    if( !solidPolygons.empty() )
+        m_plotter->PlotPolys( solidPolygons, FILLED_SHAPE, aZone->GetMinThickness() );
 }
 
 
@@ -27,10 +27,6 @@
  * @brief Class that computes missing connections on a PCB.
  */
 
-#ifdef USE_OPENMP
-#include <omp.h>
-#endif /* USE_OPENMP */
-
 #include <ratsnest_data.h>
 
 #include <class_board.h>
@@ -38,6 +34,8 @@
 #include <class_pad.h>
 #include <class_track.h>
 #include <class_zone.h>
+#include <pgm_base.h>
+#include <thread_pool.h>
 
 #include <boost/range/adaptor/map.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -52,6 +50,7 @@
 
 #ifdef PROFILE
 #include <profile.h>
+#include <trace_events.h>
 #endif
 
 static uint64_t getDistance( const RN_NODE_PTR& aNode1, const RN_NODE_PTR& aNode2 )
@@ -65,13 +64,6 @@ static uint64_t getDistance( const RN_NODE_PTR& aNode1, const RN_NODE_PTR& aNode
 }
 
 
-static bool sortDistance( const RN_NODE_PTR& aOrigin, const RN_NODE_PTR& aNode1,
-                   const RN_NODE_PTR& aNode2 )
-{
-    return getDistance( aOrigin, aNode1 ) < getDistance( aOrigin, aNode2 );
-}
-
-
 static bool sortWeight( const RN_EDGE_PTR& aEdge1, const RN_EDGE_PTR& aEdge2 )
 {
     return aEdge1->GetWeight() < aEdge2->GetWeight();
@@ -128,6 +120,7 @@ static std::vector<RN_EDGE_MST_PTR>* kruskalMST( RN_LINKS::RN_EDGE_LIST& aEdges,
 
     // Set tags for marking cycles
     boost::unordered_map<RN_NODE_PTR, int> tags;
+    tags.rehash( nodeNumber );
     unsigned int tag = 0;
     BOOST_FOREACH( RN_NODE_PTR& node, aNodes )
     {
@@ -254,6 +247,7 @@ void RN_NET::validateEdge( RN_EDGE_MST_PTR& aEdge )
 void RN_NET::removeNode( RN_NODE_PTR& aNode, const BOARD_CONNECTED_ITEM* aParent )
 {
     aNode->RemoveParent( aParent );
+    m_changedNodes.push_back( aNode );
 
     if( m_links.RemoveNode( aNode ) )
     {
@@ -271,6 +265,8 @@ void RN_NET::removeEdge( RN_EDGE_MST_PTR& aEdge, const BOARD_CONNECTED_ITEM* aPa
 
     start->RemoveParent( aParent );
     end->RemoveParent( aParent );
+    m_changedNodes.push_back( start );
+    m_changedNodes.push_back( end );
 
     // Connection has to be removed before running RemoveNode(),
     // as RN_NODE influences the reference counter
@@ -412,9 +408,16 @@ bool RN_POLY::HitTest( const RN_NODE_PTR& aNode ) const
 
 void RN_NET::Update()
 {
+    // Nodes are compared by their coordinates, so this is the set of changed locations
+    RN_LINKS::RN_NODE_SET changedNodes( m_changedNodes.begin(), m_changedNodes.end() );
+
     // Add edges resulting from nodes being connected by zones
-    processZones();
-    processPads();
+    processZones( changedNodes );
+    processPads( changedNodes );
+
+    m_changedNodes.clear();
+    m_dirtyPads.clear();
+    m_dirtyZones.clear();
 
     compute();
 
@@ -434,6 +437,8 @@ void RN_NET::AddItem( const D_PAD* aPad )
     RN_NODE_PTR node = m_links.AddNode( aPad->GetPosition().x, aPad->GetPosition().y );
     node->AddParent( aPad );
     m_pads[aPad].m_Node = node;
+    m_dirtyPads.insert( aPad );
+    m_changedNodes.push_back( node );
 
     m_dirty = true;
 }
@@ -444,6 +449,7 @@ void RN_NET::AddItem( const VIA* aVia )
     RN_NODE_PTR node = m_links.AddNode( aVia->GetPosition().x, aVia->GetPosition().y );
     node->AddParent( aVia );
     m_vias[aVia] = node;
+    m_changedNodes.push_back( node );
 
     m_dirty = true;
 }
@@ -460,6 +466,8 @@ void RN_NET::AddItem( const TRACK* aTrack )
     start->AddParent( aTrack );
     end->AddParent( aTrack );
     m_tracks[aTrack] = m_links.AddConnection( start, end );
+    m_changedNodes.push_back( start );
+    m_changedNodes.push_back( end );
 
     m_dirty = true;
 }
@@ -476,8 +484,11 @@ void RN_NET::AddItem( const ZONE_CONTAINER* aZone )
 
         RN_POLY poly = RN_POLY( &polySet, i, m_links, path.BBox() );
         m_zones[aZone].m_Polygons.push_back( poly );
+        m_changedNodes.push_back( poly.GetNode() );
     }
 
+    m_dirtyZones.insert( aZone );
+
     m_dirty = true;
 }
 
@@ -496,6 +507,7 @@ void RN_NET::RemoveItem( const D_PAD* aPad )
         removeEdge( edge, aPad );
 
     m_pads.erase( aPad );
+    m_dirtyPads.erase( aPad );
 }
 
 
@@ -545,6 +557,7 @@ void RN_NET::RemoveItem( const ZONE_CONTAINER* aZone )
     edges.clear();
 
     m_zones.erase( it );
+    m_dirtyZones.erase( aZone );
 }
 
 
@@ -608,53 +621,80 @@ const RN_NODE_PTR RN_NET::GetClosestNode( const RN_NODE_PTR& aNode,
 }
 
 
-std::list<RN_NODE_PTR> RN_NET::GetClosestNodes( const RN_NODE_PTR& aNode, int aNumber ) const
+///> Node found by getClosestNodes(), with its distance to the reference node.
+struct RN_NODE_DISTANCE
 {
-    std::list<RN_NODE_PTR> closest;
-    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
+    uint64_t            m_distance;
+    unsigned int        m_order;    ///< Position in the node set, to sort equal distances
+    const RN_NODE_PTR*  m_node;
 
-    // Copy nodes
-    BOOST_FOREACH( const RN_NODE_PTR& node, nodes )
-        closest.push_back( node );
+    bool operator<( const RN_NODE_DISTANCE& aOther ) const
+    {
+        if( m_distance != aOther.m_distance )
+            return m_distance < aOther.m_distance;
+
+        return m_order < aOther.m_order;
+    }
+};
 
-    // Sort by the distance from aNode
-    closest.sort( boost::bind( sortDistance, boost::cref( aNode ), _1, _2 ) );
 
-    // aNode should not be returned in the results
-    closest.remove( aNode );
+/**
+ * Function getClosestNodes
+ * Returns the nodes of aNodes that pass aFilter, sorted by their distance from aOrigin.
+ * Distances are computed once, in a contiguous array, and only the aNumber closest nodes
+ * (all the nodes if aNumber <= 0) are sorted.  Nodes at the same distance are kept in the node set order.
+ */
+static std::list<RN_NODE_PTR> getClosestNodes( const RN_LINKS::RN_NODE_SET& aNodes,
+                                               const RN_NODE_PTR& aOrigin,
+                                               const RN_NODE_FILTER& aFilter, int aNumber )
+{
+    std::vector<RN_NODE_DISTANCE> found;
+    found.reserve( aNodes.size() );
 
-    // Trim the result to the asked size
-    if( aNumber > 0 )
-        closest.resize( std::min( (size_t)aNumber, nodes.size() ) );
+    unsigned int order = 0;
 
-    return closest;
-}
+    BOOST_FOREACH( const RN_NODE_PTR& node, aNodes )
+    {
+        // aOrigin (and the nodes at the same place) should not be returned in the results
+        if( node != aOrigin && aFilter( node ) )
+        {
+            RN_NODE_DISTANCE item = { getDistance( aOrigin, node ), order, &node };
+            found.push_back( item );
+        }
 
+        ++order;
+    }
+
+    // Trim the result to the asked size, all the nodes are returned for 0 or less
+    if( aNumber > 0 && (size_t) aNumber < found.size() )
+    {
+        std::partial_sort( found.begin(), found.begin() + aNumber, found.end() );
+        found.resize( aNumber );
+    }
+    else
+    {
+        std::sort( found.begin(), found.end() );
+    }
 
-std::list<RN_NODE_PTR> RN_NET::GetClosestNodes( const RN_NODE_PTR& aNode,
-                                                const RN_NODE_FILTER& aFilter, int aNumber ) const
-{
     std::list<RN_NODE_PTR> closest;
-    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
 
-    // Copy nodes
-    BOOST_FOREACH( const RN_NODE_PTR& node, nodes )
-        closest.push_back( node );
+    for( unsigned int i = 0; i < found.size(); ++i )
+        closest.push_back( *found[i].m_node );
 
-    // Sort by the distance from aNode
-    closest.sort( boost::bind( sortDistance, boost::cref( aNode ), _1, _2 ) );
+    return closest;
+}
 
-    // aNode should not be returned in the results
-    closest.remove( aNode );
 
-    // Filter out by condition
-    std::remove_if( closest.begin(), closest.end(), aFilter );
+std::list<RN_NODE_PTR> RN_NET::GetClosestNodes( const RN_NODE_PTR& aNode, int aNumber ) const
+{
+    return getClosestNodes( m_links.GetNodes(), aNode, RN_NODE_FILTER(), aNumber );
+}
 
-    // Trim the result to the asked size
-    if( aNumber > 0 )
-        closest.resize( std::min( static_cast<size_t>( aNumber ), nodes.size() ) );
 
-    return closest;
+std::list<RN_NODE_PTR> RN_NET::GetClosestNodes( const RN_NODE_PTR& aNode,
+                                                const RN_NODE_FILTER& aFilter, int aNumber ) const
+{
+    return getClosestNodes( m_links.GetNodes(), aNode, aFilter, aNumber );
 }
 
 
@@ -942,22 +982,81 @@ int RN_DATA::GetUnconnectedCount() const
 }
 
 
-void RN_NET::processZones()
+void RN_NET::removeHelperEdges( std::deque<RN_EDGE_MST_PTR>& aEdges,
+                                const RN_LINKS::RN_NODE_SET& aNodes )
+{
+    std::deque<RN_EDGE_MST_PTR>::iterator it = aEdges.begin();
+
+    while( it != aEdges.end() )
+    {
+        // Helper edges go from the pad or polygon node to the node found in its area
+        if( aNodes.count( (*it)->GetTargetNode() ) )
+        {
+            m_links.RemoveConnection( *it );
+            it = aEdges.erase( it );
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+
+void RN_NET::processZones( const RN_LINKS::RN_NODE_SET& aChangedNodes )
 {
+    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
+
     for( ZONE_DATA_MAP::iterator it = m_zones.begin(); it != m_zones.end(); ++it )
     {
         const ZONE_CONTAINER* zone = it->first;
         RN_ZONE_DATA& zoneData = it->second;
+        LSET layers = zone->GetLayerSet();
+
+        if( !m_dirtyZones.count( zone ) )
+        {
+            // The zone has not changed: only the changed nodes have to be tested again
+            if( aChangedNodes.empty() )
+                continue;
+
+            removeHelperEdges( zoneData.m_Edges, aChangedNodes );
+
+            BOOST_FOREACH( const RN_NODE_PTR& changed, aChangedNodes )
+            {
+                // Get the node currently at the changed location, if any
+                RN_LINKS::RN_NODE_SET::const_iterator live = nodes.find( changed );
+
+                if( live == nodes.end() )
+                    continue;
+
+                const RN_NODE_PTR& point = *live;
+
+                if( !( point->GetLayers() & layers ).any() )
+                    continue;
+
+                // Polygons are sorted by area, a point belongs to the first one containing it
+                BOOST_FOREACH( const RN_POLY& poly, zoneData.m_Polygons )
+                {
+                    if( point != poly.GetNode() && poly.HitTest( point ) )
+                    {
+                        zoneData.m_Edges.push_back( m_links.AddConnection( poly.GetNode(),
+                                                                           point ) );
+                        break;
+                    }
+                }
+            }
+
+            continue;
+        }
 
         // Reset existing connections
         BOOST_FOREACH( RN_EDGE_MST_PTR edge, zoneData.m_Edges )
             m_links.RemoveConnection( edge );
 
         zoneData.m_Edges.clear();
-        LSET layers = zone->GetLayerSet();
 
         // Compute new connections
-        RN_LINKS::RN_NODE_SET candidates = m_links.GetNodes();
+        RN_LINKS::RN_NODE_SET candidates = nodes;
         RN_LINKS::RN_NODE_SET::iterator point, pointEnd;
 
         // Sorting by area should speed up the processing, as smaller polygons are computed
@@ -996,26 +1095,52 @@ void RN_NET::processZones()
 }
 
 
-void RN_NET::processPads()
+void RN_NET::processPads( const RN_LINKS::RN_NODE_SET& aChangedNodes )
 {
+    const RN_LINKS::RN_NODE_SET& nodes = m_links.GetNodes();
+
     for( PAD_NODE_MAP::iterator it = m_pads.begin(); it != m_pads.end(); ++it )
     {
         const D_PAD* pad = it->first;
         RN_NODE_PTR node = it->second.m_Node;
         std::deque<RN_EDGE_MST_PTR>& edges = it->second.m_Edges;
+        LSET layers = pad->GetLayerSet();
+
+        if( !m_dirtyPads.count( pad ) )
+        {
+            // The pad has not changed: only the changed nodes have to be tested again
+            if( aChangedNodes.empty() )
+                continue;
+
+            removeHelperEdges( edges, aChangedNodes );
+
+            BOOST_FOREACH( const RN_NODE_PTR& changed, aChangedNodes )
+            {
+                RN_LINKS::RN_NODE_SET::const_iterator live = nodes.find( changed );
+
+                if( live == nodes.end() )
+                    continue;
+
+                const RN_NODE_PTR& point = *live;
+
+                if( point != node && ( point->GetLayers() & layers ).any()
+                        && pad->HitTest( wxPoint( point->GetX(), point->GetY() ) ) )
+                {
+                    edges.push_back( m_links.AddConnection( node, point ) );
+                }
+            }
+
+            continue;
+        }
 
         // Reset existing connections
         BOOST_FOREACH( RN_EDGE_MST_PTR edge, edges )
             m_links.RemoveConnection( edge );
 
-        LSET layers = pad->GetLayerSet();
-        const RN_LINKS::RN_NODE_SET& candidates = m_links.GetNodes();
-        RN_LINKS::RN_NODE_SET::iterator point, pointEnd;
-
-        point = candidates.begin();
-        pointEnd = candidates.end();
+        edges.clear();
 
-        while( point != pointEnd )
+        for( RN_LINKS::RN_NODE_SET::const_iterator point = nodes.begin(), pointEnd = nodes.end();
+             point != pointEnd; ++point )
         {
             if( *point != node && ( (*point)->GetLayers() & layers ).any() &&
                     pad->HitTest( wxPoint( (*point)->GetX(), (*point)->GetY() ) ) )
@@ -1025,8 +1150,6 @@ void RN_NET::processPads()
                 RN_EDGE_MST_PTR connection = m_links.AddConnection( node, *point );
                 edges.push_back( connection );
             }
-
-            ++point;
         }
     }
 }
@@ -1167,17 +1290,24 @@ void RN_DATA::Update( const BOARD_ITEM* aItem )
 {
     Remove( aItem );
     Add( aItem );
+
+    // Editing tools report their changes here, forward them to the board listeners
+    m_board->OnItemChanged( aItem );
 }
 
 
 void RN_DATA::ProcessBoard()
 {
+    TRACE_SCOPE( "RN_DATA::ProcessBoard" );
+
     int netCount = m_board->GetNetCount();
     m_nets.clear();
     m_nets.resize( netCount );
     int netCode;
 
-    // Iterate over all items that may need to be connected
+    // Gather the items that may need to be connected by net, in one pass over the board
+    std::vector<NET_ITEMS> items( netCount );
+
     for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
     {
         for( D_PAD* pad = module->Pads().GetFirst(); pad; pad = pad->Next() )
@@ -1187,7 +1317,7 @@ void RN_DATA::ProcessBoard()
             assert( netCode >= 0 && netCode < netCount );
 
             if( netCode > 0 && netCode < netCount )
-                m_nets[netCode].AddItem( pad );
+                items[netCode].m_Pads.push_back( pad );
         }
     }
 
@@ -1198,12 +1328,7 @@ void RN_DATA::ProcessBoard()
         assert( netCode >= 0 && netCode < netCount );
 
         if( netCode > 0 && netCode < netCount )
-        {
-            if( track->Type() == PCB_VIA_T )
-                m_nets[netCode].AddItem( static_cast<VIA*>( track ) );
-            else if( track->Type() == PCB_TRACE_T )
-                m_nets[netCode].AddItem( track );
-        }
+            items[netCode].m_Tracks.push_back( track );
     }
 
     for( int i = 0; i < m_board->GetAreaCount(); ++i )
@@ -1215,15 +1340,50 @@ void RN_DATA::ProcessBoard()
         assert( netCode >= 0 && netCode < netCount );
 
         if( netCode > 0 && netCode < netCount )
-            m_nets[netCode].AddItem( zone );
+            items[netCode].m_Zones.push_back( zone );
     }
 
-    Recalculate();
+    // The nets do not share any data: each one is built and computed by its own task,
+    // including the hit tests of its nodes against its zones.
+    TASK_GROUP tasks( Pgm().GetThreadPool() );
+
+    // Start with net number 1, as 0 stands for not connected
+    for( netCode = 1; netCode < netCount; ++netCode )
+        tasks.Run( boost::bind( &RN_DATA::processNet, this, netCode, &items[netCode] ) );
+
+    tasks.Wait();
+}
+
+
+void RN_DATA::processNet( int aNetCode, const NET_ITEMS* aItems )
+{
+    RN_NET& net = m_nets[aNetCode];
+
+    for( unsigned i = 0; i < aItems->m_Pads.size(); ++i )
+        net.AddItem( aItems->m_Pads[i] );
+
+    for( unsigned i = 0; i < aItems->m_Tracks.size(); ++i )
+    {
+        const TRACK* track = aItems->m_Tracks[i];
+
+        if( track->Type() == PCB_VIA_T )
+            net.AddItem( static_cast<const VIA*>( track ) );
+        else if( track->Type() == PCB_TRACE_T )
+            net.AddItem( track );
+    }
+
+    for( unsigned i = 0; i < aItems->m_Zones.size(); ++i )
+        net.AddItem( aItems->m_Zones[i] );
+
+    if( net.IsDirty() )
+        updateNet( aNetCode );
 }
 
 
 void RN_DATA::Recalculate( int aNet )
 {
+    TRACE_SCOPE( "RN_DATA::Recalculate" );
+
     unsigned int netCount = m_board->GetNetCount();
 
     if( netCount > m_nets.size() )
@@ -1236,22 +1396,17 @@ void RN_DATA::Recalculate( int aNet )
     prof_start( &totalRealTime );
 #endif
 
-        unsigned int i;
+        TASK_GROUP tasks( Pgm().GetThreadPool() );
 
-#ifdef USE_OPENMP
-        #pragma omp parallel shared(netCount) private(i)
+        // Start with net number 1, as 0 stands for not connected
+        for( unsigned int i = 1; i < netCount; ++i )
         {
-            #pragma omp for schedule(guided, 1)
-#else /* USE_OPENMP */
-        {
-#endif
-            // Start with net number 1, as 0 stands for not connected
-            for( i = 1; i < netCount; ++i )
-            {
-                if( m_nets[i].IsDirty() )
-                    updateNet( i );
-            }
-        }  /* end of parallel section */
+            if( m_nets[i].IsDirty() )
+                tasks.Run( boost::bind( &RN_DATA::updateNet, this, (int) i ) );
+        }
+
+        tasks.Wait();
+
 #ifdef PROFILE
     prof_end( &totalRealTime );
 
@@ -373,9 +373,23 @@ public:
         return m_rnEdges.get();
     }
 
+    ///> Returns the number of nodes of the net, for the memory statistics
+    size_t GetNodeCount() const
+    {
+        return m_links.GetNodes().size();
+    }
+
+    ///> Returns the number of connections of the net, for the memory statistics
+    size_t GetConnectionCount() const
+    {
+        return m_links.GetConnections().size();
+    }
+
     /**
      * Function Update()
      * Recomputes ratsnest for a net.
+     * Connections made by pads and zones are only searched again for the items changed since
+     * the previous call, the minimum spanning tree is recomputed from scratch.
      */
     void Update();
 
@@ -562,10 +576,17 @@ protected:
     void clearNode( const RN_NODE_PTR& aNode );
 
     ///> Adds appropriate edges for nodes that are connected by zones.
-    void processZones();
+    ///> Only the zones added and the nodes changed since the last update are processed.
+    void processZones( const RN_LINKS::RN_NODE_SET& aChangedNodes );
 
     ///> Adds additional edges to account for connections made by items located in pads areas.
-    void processPads();
+    ///> Only the pads added and the nodes changed since the last update are processed.
+    void processPads( const RN_LINKS::RN_NODE_SET& aChangedNodes );
+
+    ///> Removes from aEdges (and from m_links) the helper edges targetting a node located
+    ///> at one of aNodes.
+    void removeHelperEdges( std::deque<RN_EDGE_MST_PTR>& aEdges,
+                            const RN_LINKS::RN_NODE_SET& aNodes );
 
     ///> Recomputes ratsnset from scratch.
     void compute();
@@ -585,6 +606,16 @@ protected:
     ///> Flag indicating necessity of recalculation of ratsnest for a net.
     bool m_dirty;
 
+    ///> Nodes added, removed, or whose parents changed since the last update. The pad and zone
+    ///> connections at their locations have to be found again, the other ones are kept.
+    std::vector<RN_NODE_PTR> m_changedNodes;
+
+    ///> Pads added since the last update, whose connections have to be found from scratch.
+    boost::unordered_set<const D_PAD*> m_dirtyPads;
+
+    ///> Zones added since the last update, whose connections have to be found from scratch.
+    boost::unordered_set<const ZONE_CONTAINER*> m_dirtyZones;
+
     ///> Structure to hold ratsnest data for ZONE_CONTAINER objects.
     typedef struct
     {
@@ -692,7 +723,8 @@ public:
     /**
      * Function ProcessBoard()
      * Prepares data for computing (computes a list of current nodes and connections). It is
-     * required to run only once after loading a board.
+     * required to run only once after loading a board. The items are gathered by net in one
+     * pass, then each net is built and computed as a task of the thread pool.
      */
     void ProcessBoard();
 
@@ -771,6 +803,22 @@ protected:
      */
     void updateNet( int aNetCode );
 
+    ///> Items of a single net, gathered by ProcessBoard() in one pass over the board.
+    struct NET_ITEMS
+    {
+        std::vector<const D_PAD*>           m_Pads;
+        std::vector<const TRACK*>           m_Tracks;   ///< tracks and vias, in board order
+        std::vector<const ZONE_CONTAINER*>  m_Zones;
+    };
+
+    /**
+     * Function processNet()
+     * Adds the gathered items of a net and computes its ratsnest.
+     * @param aNetCode is the net number of the items.
+     * @param aItems are the items of the net.
+     */
+    void processNet( int aNetCode, const NET_ITEMS* aItems );
+
     ///> Board to be processed.
     const BOARD* m_board;
 
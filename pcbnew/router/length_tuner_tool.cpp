@@ -38,6 +38,7 @@
 #include "pns_segment.h"
 #include "pns_router.h"
 #include "pns_meander_placer.h" // fixme: move settings to separate header
+#include "pns_meander_batch.h"
 #include "pns_tune_status_popup.h"
 
 #include "length_tuner_tool.h"
@@ -68,6 +69,9 @@ static TOOL_ACTION ACT_AmplIncrease( "pcbnew.LengthTuner.AmplIncrease", AS_CONTE
 static TOOL_ACTION ACT_AmplDecrease( "pcbnew.LengthTuner.AmplDecrease", AS_CONTEXT, '4',
     _( "Decrease amplitude" ), _( "Decrease meander amplitude by one step." ) );
 
+static TOOL_ACTION ACT_TuneNetGroup( "pcbnew.LengthTuner.TuneNetGroup", AS_CONTEXT, 'G',
+    _( "Tune Net Group..." ), _( "Matches the lengths of a group of nets to the longest one." ) );
+
 
 LENGTH_TUNER_TOOL::LENGTH_TUNER_TOOL() :
     PNS_TOOL_BASE( "pcbnew.LengthTuner" )
@@ -92,6 +96,10 @@ public:
         Add( ACT_AmplIncrease );
         Add( ACT_AmplDecrease );
         Add( ACT_Settings );
+
+        AppendSeparator();
+
+        Add( ACT_TuneNetGroup );
     }
 };
 
@@ -240,6 +248,41 @@ void LENGTH_TUNER_TOOL::performTuning()
 }
 
 
+void LENGTH_TUNER_TOOL::tuneNetGroup()
+{
+    wxString pattern = wxGetTextFromUser( _( "Nets to tune (wildcards allowed, e.g. DQ*):" ),
+                                          _( "Tune Net Group" ), wxEmptyString, m_frame );
+
+    if( pattern.IsEmpty() )
+        return;
+
+    PNS_MEANDER_BATCH batch( m_router, m_savedMeanderSettings );
+
+    for( unsigned int i = 1; i < m_board->GetNetCount(); i++ )
+    {
+        NETINFO_ITEM* net = m_board->FindNet( i );
+
+        if( net && net->GetNetname().Matches( pattern ) )
+            batch.AddNet( i );
+    }
+
+    if( batch.Results().empty() )
+    {
+        wxMessageBox( _( "No net matches this name." ), _( "Tune Net Group" ) );
+        return;
+    }
+
+    batch.Run();
+
+    // Save the changes in the undo buffer
+    m_frame->SaveCopyInUndoList( m_router->GetUndoBuffer(), UR_UNSPECIFIED );
+    m_router->ClearUndoBuffer();
+    m_frame->OnModify();
+
+    wxMessageBox( batch.Report(), _( "Tune Net Group" ) );
+}
+
+
 int LENGTH_TUNER_TOOL::TuneSingleTrace( const TOOL_EVENT& aEvent )
 {
     m_frame->SetToolID( ID_TRACK_BUTT, wxCURSOR_PENCIL, _( "Tune Trace Length" ) );
@@ -296,6 +339,10 @@ int LENGTH_TUNER_TOOL::mainLoop( PNS_ROUTER_MODE aMode )
             updateStartItem( *evt );
             performTuning();
         }
+        else if( evt->IsAction( &ACT_TuneNetGroup ) )
+        {
+            tuneNetGroup();
+        }
 
         handleCommonEvents( *evt );
     }
@@ -42,6 +42,7 @@ public:
 
 private:
     void performTuning( );
+    void tuneNetGroup();
     int mainLoop( PNS_ROUTER_MODE aMode );
     void handleCommonEvents( const TOOL_EVENT& aEvent );
     void updateStatusPopup ( PNS_TUNE_STATUS_POPUP& aPopup );
@@ -26,6 +26,7 @@
 
 #include <boost/foreach.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <list>
 #include <geometry/shape_index.h>
@@ -47,6 +48,14 @@ public:
     typedef boost::unordered_set<PNS_ITEM*> ITEM_SET;
 
     PNS_INDEX();
+
+    /**
+     * Copy constructor
+     *
+     * Builds an index of the same items as aOther (which are not copied).
+     */
+    PNS_INDEX( const PNS_INDEX& aOther );
+
     ~PNS_INDEX();
 
     /**
@@ -153,6 +162,11 @@ private:
     ITEM_SHAPE_INDEX* m_subIndices[MaxSubIndices];
     std::map<int, NET_ITEMS_LIST> m_netMap;
     ITEM_SET m_allItems;
+
+    ///> position of each item in its net list, so that it is removed in constant time
+    ///> (a net list can hold thousands of items, e.g. for the ground net)
+    typedef std::pair<NET_ITEMS_LIST*, NET_ITEMS_LIST::iterator> NET_ITEM_POSITION;
+    boost::unordered_map<PNS_ITEM*, NET_ITEM_POSITION> m_netPositions;
 };
 
 PNS_INDEX::PNS_INDEX()
@@ -160,6 +174,14 @@ PNS_INDEX::PNS_INDEX()
     memset( m_subIndices, 0, sizeof( m_subIndices ) );
 }
 
+PNS_INDEX::PNS_INDEX( const PNS_INDEX& aOther )
+{
+    memset( m_subIndices, 0, sizeof( m_subIndices ) );
+
+    for( ITEM_SET::const_iterator i = aOther.m_allItems.begin(); i != aOther.m_allItems.end(); ++i )
+        Add( *i );
+}
+
 PNS_INDEX::ITEM_SHAPE_INDEX* PNS_INDEX::getSubindex( const PNS_ITEM* aItem )
 {
     int idx_n = -1;
@@ -210,7 +232,10 @@ void PNS_INDEX::Add( PNS_ITEM* aItem )
 
     if( net >= 0 )
     {
-        m_netMap[net].push_back( aItem );
+        NET_ITEMS_LIST& netItems = m_netMap[net];
+
+        m_netPositions[aItem] = NET_ITEM_POSITION( &netItems,
+                                                   netItems.insert( netItems.end(), aItem ) );
     }
 }
 
@@ -221,10 +246,13 @@ void PNS_INDEX::Remove( PNS_ITEM* aItem )
     idx->Remove( aItem );
     m_allItems.erase( aItem );
 
-    int net = aItem->Net();
+    boost::unordered_map<PNS_ITEM*, NET_ITEM_POSITION>::iterator pos = m_netPositions.find( aItem );
 
-    if( net >= 0 && m_netMap.find( net ) != m_netMap.end() )
-        m_netMap[net].remove( aItem );
+    if( pos != m_netPositions.end() )
+    {
+        pos->second.first->erase( pos->second.second );
+        m_netPositions.erase( pos );
+    }
 }
 
 void PNS_INDEX::Replace( PNS_ITEM* aOldItem, PNS_ITEM* aNewItem )
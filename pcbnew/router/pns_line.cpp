@@ -18,8 +18,11 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <new>
+
 #include <boost/foreach.hpp>
 #include <boost/optional.hpp>
+#include <boost/pool/singleton_pool.hpp>
 
 #include <math/vector2d.h>
 
@@ -33,6 +36,11 @@
 
 using boost::optional;
 
+struct PNS_SEGMENT_POOL_TAG {};
+
+/// Blocks of the size of a PNS_SEGMENT, recycled instead of being given back to the heap
+typedef boost::singleton_pool<PNS_SEGMENT_POOL_TAG, sizeof( PNS_SEGMENT )> PNS_SEGMENT_POOL;
+
 PNS_LINE::PNS_LINE( const PNS_LINE& aOther ) :
         PNS_ITEM( aOther ),
         m_line( aOther.m_line ),
@@ -68,7 +76,16 @@ const PNS_LINE& PNS_LINE::operator=( const PNS_LINE& aOther )
     m_marker = aOther.m_marker;
     m_rank = aOther.m_rank;
 
-    copyLinks( &aOther );
+    // lines are assigned over and over by the shove: keep the storage of the links
+    if( m_segmentRefs && aOther.m_segmentRefs )
+    {
+        *m_segmentRefs = *aOther.m_segmentRefs;
+    }
+    else
+    {
+        delete m_segmentRefs;
+        copyLinks( &aOther );
+    }
 
     return *this;
 }
@@ -135,6 +152,32 @@ void PNS_LINE::copyLinks( const PNS_LINE* aParent )
 }
 
 
+void* PNS_SEGMENT::operator new( std::size_t aSize )
+{
+    if( aSize != sizeof( PNS_SEGMENT ) )
+        return ::operator new( aSize );
+
+    void* p = PNS_SEGMENT_POOL::malloc();
+
+    if( !p )
+        throw std::bad_alloc();
+
+    return p;
+}
+
+
+void PNS_SEGMENT::operator delete( void* aPtr, std::size_t aSize )
+{
+    if( !aPtr )
+        return;
+
+    if( aSize != sizeof( PNS_SEGMENT ) )
+        ::operator delete( aPtr );
+    else
+        PNS_SEGMENT_POOL::free( aPtr );
+}
+
+
 PNS_SEGMENT* PNS_SEGMENT::Clone() const
 {
     PNS_SEGMENT* s = new PNS_SEGMENT;
@@ -0,0 +1,277 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+#include <boost/foreach.hpp>
+
+#include <base_units.h>
+#include <class_board.h>
+
+#include "pns_node.h"
+#include "pns_line.h"
+#include "pns_segment.h"
+#include "pns_topology.h"
+#include "pns_router.h"
+#include "pns_meander_placer.h"
+#include "pns_meander_batch.h"
+
+
+PNS_MEANDER_BATCH::PNS_MEANDER_BATCH( PNS_ROUTER* aRouter,
+                                      const PNS_MEANDER_SETTINGS& aSettings ) :
+    m_router( aRouter ),
+    m_settings( aSettings )
+{
+}
+
+
+PNS_MEANDER_BATCH::~PNS_MEANDER_BATCH()
+{
+}
+
+
+void PNS_MEANDER_BATCH::AddNet( int aNet, int aTargetLength )
+{
+    BOOST_FOREACH( const NET_RESULT& net, m_results )
+    {
+        if( net.m_net == aNet )
+            return;
+    }
+
+    NET_RESULT net;
+
+    net.m_net = aNet;
+    net.m_targetLength = aTargetLength;
+    net.m_initialLength = 0;
+    net.m_length = 0;
+    net.m_coupledNet = -1;
+    net.m_status = PNS_MEANDER_PLACER_BASE::TOO_SHORT;
+
+    m_results.push_back( net );
+}
+
+
+PNS_SEGMENT* PNS_MEANDER_BATCH::findTunedSegment( PNS_NODE* aNode, int aNet ) const
+{
+    std::set<PNS_ITEM*> items;
+    PNS_SEGMENT* longest = NULL;
+
+    aNode->AllItemsInNet( aNet, items );
+
+    BOOST_FOREACH( PNS_ITEM* item, items )
+    {
+        PNS_SEGMENT* seg = dyn_cast<PNS_SEGMENT*>( item );
+
+        if( seg && ( !longest || seg->Seg().Length() > longest->Seg().Length() ) )
+            longest = seg;
+    }
+
+    return longest;
+}
+
+
+int PNS_MEANDER_BATCH::pathLength( PNS_NODE* aNode, PNS_SEGMENT* aSegment ) const
+{
+    PNS_TOPOLOGY topo( aNode );
+    const PNS_ITEMSET path = topo.AssembleTrivialPath( aSegment );
+    int total = 0;
+
+    BOOST_FOREACH( const PNS_ITEM* item, path.CItems() )
+    {
+        if( const PNS_LINE* l = dyn_cast<const PNS_LINE*>( item ) )
+            total += l->CLine().Length();
+    }
+
+    return total;
+}
+
+
+PNS_MEANDER_PLACER_BASE::TUNING_STATUS PNS_MEANDER_BATCH::status( int aLength,
+                                                                  int aTargetLength ) const
+{
+    if( std::abs( aLength - aTargetLength ) <= m_settings.m_lengthTolerance )
+        return PNS_MEANDER_PLACER_BASE::TUNED;
+
+    return aLength > aTargetLength ? PNS_MEANDER_PLACER_BASE::TOO_LONG :
+                                     PNS_MEANDER_PLACER_BASE::TOO_SHORT;
+}
+
+
+void PNS_MEANDER_BATCH::tuneNet( PNS_NODE* aNode, NET_RESULT& aNet )
+{
+    PNS_SEGMENT* seg = findTunedSegment( aNode, aNet.m_net );
+
+    // meanders can only make a net longer
+    if( seg && aNet.m_length < aNet.m_targetLength - m_settings.m_lengthTolerance )
+    {
+        PNS_MEANDER_PLACER placer( m_router );
+
+        placer.UpdateSettings( m_settings );
+        aNet.m_length = placer.TuneLine( aNode, seg, aNet.m_targetLength );
+    }
+
+    aNet.m_status = status( aNet.m_length, aNet.m_targetLength );
+}
+
+
+/// Orders the nets of the group by decreasing elongation
+struct ELONGATION_ORDER
+{
+    ELONGATION_ORDER( const std::vector<PNS_MEANDER_BATCH::NET_RESULT>& aNets ) :
+        m_nets( aNets )
+    {
+    }
+
+    bool operator()( int aA, int aB ) const
+    {
+        return m_nets[aA].m_targetLength - m_nets[aA].m_initialLength >
+               m_nets[aB].m_targetLength - m_nets[aB].m_initialLength;
+    }
+
+    const std::vector<PNS_MEANDER_BATCH::NET_RESULT>& m_nets;
+};
+
+
+bool PNS_MEANDER_BATCH::Run()
+{
+    PNS_NODE* world = m_router->GetWorld();
+    PNS_TOPOLOGY topo( world );
+    int longest = 0;
+
+    BOOST_FOREACH( NET_RESULT& net, m_results )
+    {
+        PNS_SEGMENT* seg = findTunedSegment( world, net.m_net );
+
+        net.m_initialLength = seg ? pathLength( world, seg ) : 0;
+        net.m_length = net.m_initialLength;
+        longest = std::max( longest, net.m_initialLength );
+    }
+
+    std::vector<int> order;
+
+    for( unsigned int i = 0; i < m_results.size(); i++ )
+    {
+        NET_RESULT& net = m_results[i];
+
+        if( net.m_targetLength < 0 )
+            net.m_targetLength = longest;
+
+        int coupled = topo.DpCoupledNet( net.m_net );
+
+        for( unsigned int j = 0; j < m_results.size(); j++ )
+        {
+            if( m_results[j].m_net == coupled )
+                net.m_coupledNet = coupled;
+        }
+
+        order.push_back( i );
+    }
+
+    // the nets needing the longest meanders are tuned first, while there is still room
+    // for them. Each net is tuned in the node holding the nets tuned before, so that
+    // the meanders of the group do not collide.
+    std::stable_sort( order.begin(), order.end(), ELONGATION_ORDER( m_results ) );
+
+    PNS_NODE* node = world->Branch();
+    std::vector<bool> done( m_results.size(), false );
+
+    BOOST_FOREACH( int i, order )
+    {
+        if( done[i] )
+            continue;
+
+        tuneNet( node, m_results[i] );
+        done[i] = true;
+
+        if( m_results[i].m_coupledNet < 0 )
+            continue;
+
+        // de-skew the pair: the other net is matched to the length reached by this one
+        for( unsigned int j = 0; j < m_results.size(); j++ )
+        {
+            if( m_results[j].m_net == m_results[i].m_coupledNet && !done[j] )
+            {
+                m_results[j].m_targetLength = m_results[i].m_length + m_settings.m_targetSkew;
+                tuneNet( node, m_results[j] );
+                done[j] = true;
+            }
+        }
+    }
+
+    m_router->CommitRouting( node );
+
+    bool tuned = true;
+
+    BOOST_FOREACH( const NET_RESULT& net, m_results )
+    {
+        if( net.m_status != PNS_MEANDER_PLACER_BASE::TUNED )
+            tuned = false;
+    }
+
+    return tuned;
+}
+
+
+const wxString PNS_MEANDER_BATCH::Report() const
+{
+    BOARD* board = m_router->GetBoard();
+    wxString report;
+
+    BOOST_FOREACH( const NET_RESULT& net, m_results )
+    {
+        NETINFO_ITEM* netInfo = board->FindNet( net.m_net );
+        wxString status;
+
+        switch( net.m_status )
+        {
+        case PNS_MEANDER_PLACER_BASE::TOO_LONG:
+            status = _( "too long" );
+            break;
+        case PNS_MEANDER_PLACER_BASE::TOO_SHORT:
+            status = _( "too short" );
+            break;
+        default:
+            status = _( "tuned" );
+            break;
+        }
+
+        report += netInfo ? netInfo->GetNetname() : wxString( wxT( "?" ) );
+        report += wxT( ": " ) + status + wxT( ", " );
+        report += LengthDoubleToString( (double) net.m_length, false );
+        report += wxT( "/" );
+        report += LengthDoubleToString( (double) net.m_targetLength, false );
+        report += _( ", skew " );
+        report += LengthDoubleToString( (double) net.m_length - net.m_targetLength, false );
+
+        BOOST_FOREACH( const NET_RESULT& coupled, m_results )
+        {
+            if( coupled.m_net == net.m_coupledNet )
+            {
+                report += _( ", pair skew " );
+                report += LengthDoubleToString( (double) net.m_length - coupled.m_length, false );
+            }
+        }
+
+        report += wxT( "\n" );
+    }
+
+    return report;
+}
@@ -0,0 +1,110 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PNS_MEANDER_BATCH_H
+#define __PNS_MEANDER_BATCH_H
+
+#include <vector>
+
+#include <wx/string.h>
+
+#include "pns_meander.h"
+#include "pns_meander_placer_base.h"
+
+class PNS_ROUTER;
+class PNS_NODE;
+class PNS_SEGMENT;
+
+/**
+ * Class PNS_MEANDER_BATCH
+ *
+ * Tunes the length of a group of nets (e.g. a memory bus) at once, without user
+ * interaction. Each net gets its longest line meandered, until the length of the path
+ * it belongs to matches the target length of the net. The members of a differential
+ * pair found in the group are then de-skewed: the second one tuned is matched to the
+ * length reached by the first one.
+ */
+class PNS_MEANDER_BATCH
+{
+public:
+    ///> Tuning result of a net of the group
+    struct NET_RESULT
+    {
+        int m_net;
+        int m_targetLength;
+        int m_initialLength;
+        int m_length;
+
+        ///> the other net of the differential pair this net belongs to, if it is in
+        ///> the group, -1 otherwise
+        int m_coupledNet;
+
+        PNS_MEANDER_PLACER_BASE::TUNING_STATUS m_status;
+    };
+
+    PNS_MEANDER_BATCH( PNS_ROUTER* aRouter, const PNS_MEANDER_SETTINGS& aSettings );
+    ~PNS_MEANDER_BATCH();
+
+    /**
+     * Function AddNet()
+     *
+     * Adds a net to the group.
+     * @param aTargetLength the length the net is to be tuned to. When negative, the
+     * nets are matched to the length of the longest net of the group.
+     */
+    void AddNet( int aNet, int aTargetLength = -1 );
+
+    /**
+     * Function Run()
+     *
+     * Tunes the nets of the group, and commits the meandered lines to the board
+     * (a single undo step, see PNS_ROUTER::GetUndoBuffer()).
+     * @return true if all the nets were tuned within the tolerance of the settings
+     */
+    bool Run();
+
+    const std::vector<NET_RESULT>& Results() const
+    {
+        return m_results;
+    }
+
+    /**
+     * Function Report()
+     *
+     * Returns a description of the achieved length, and of the skew, of each net.
+     */
+    const wxString Report() const;
+
+private:
+    ///> finds the longest segment of aNet in aNode, the one to meander
+    PNS_SEGMENT* findTunedSegment( PNS_NODE* aNode, int aNet ) const;
+
+    ///> returns the length of the path of aSegment
+    int pathLength( PNS_NODE* aNode, PNS_SEGMENT* aSegment ) const;
+
+    PNS_MEANDER_PLACER_BASE::TUNING_STATUS status( int aLength, int aTargetLength ) const;
+
+    void tuneNet( PNS_NODE* aNode, NET_RESULT& aNet );
+
+    PNS_ROUTER* m_router;
+    PNS_MEANDER_SETTINGS m_settings;
+    std::vector<NET_RESULT> m_results;
+};
+
+#endif    // __PNS_MEANDER_BATCH_H
@@ -108,10 +108,59 @@ int PNS_MEANDER_PLACER::origPathLength() const
 
 bool PNS_MEANDER_PLACER::Move( const VECTOR2I& aP, PNS_ITEM* aEndItem )
 {
+    BOOST_FOREACH ( const PNS_ITEM* item, m_tunedPath.CItems() )
+    {
+        if( const PNS_LINE* l = dyn_cast<const PNS_LINE*>( item ) )
+        {
+            Router()->DisplayDebugLine( l->CLine(), 5, 30000 );
+        }
+    }
+
     return doMove( aP, aEndItem, m_settings.m_targetLength );
 }
 
 
+int PNS_MEANDER_PLACER::TuneLine( PNS_NODE* aNode, PNS_SEGMENT* aSegment, int aTargetLength )
+{
+    m_initialSegment = aSegment;
+    m_currentNode = NULL;
+
+    m_world = aNode->Branch();
+    m_originLine = m_world->AssembleLine( aSegment );
+
+    PNS_TOPOLOGY topo( m_world );
+    m_tunedPath = topo.AssembleTrivialPath( aSegment );
+
+    m_world->Remove( &m_originLine );
+
+    m_currentWidth = m_originLine.Width();
+    m_currentStart = m_originLine.CPoint( 0 );
+    m_currentEnd = VECTOR2I( 0, 0 );
+
+    // the tuned part spans the whole line
+    doMove( m_originLine.CPoint( -1 ), NULL, aTargetLength );
+
+    int length = origPathLength();
+
+    // keep the original line if no meander fitted
+    if( m_finalShape.SegmentCount() && m_finalShape.Length() > m_originLine.CLine().Length() )
+    {
+        m_currentTrace = PNS_LINE( m_originLine, m_finalShape );
+        aNode->Remove( m_originLine );
+        aNode->Add( &m_currentTrace );
+        length = m_lastLength;
+    }
+
+    delete m_currentNode;
+    delete m_world;
+
+    m_currentNode = NULL;
+    m_world = NULL;
+
+    return length;
+}
+
+
 bool PNS_MEANDER_PLACER::doMove( const VECTOR2I& aP, PNS_ITEM* aEndItem, int aTargetLength )
 {
     SHAPE_LINE_CHAIN pre, tuned, post;
@@ -148,14 +197,6 @@ bool PNS_MEANDER_PLACER::doMove( const VECTOR2I& aP, PNS_ITEM* aEndItem, int aTa
         tuneLineLength( m_result, aTargetLength - lineLen );
     }
 
-    BOOST_FOREACH ( const PNS_ITEM* item, m_tunedPath.CItems() )
-    {
-        if( const PNS_LINE* l = dyn_cast<const PNS_LINE*>( item ) )
-        {
-            Router()->DisplayDebugLine( l->CLine(), 5, 30000 );
-        }
-    }
-
     if( m_lastStatus != TOO_LONG )
     {
         tuned.Clear();
@@ -86,6 +86,16 @@ public:
     /// @copydoc PNS_MEANDER_PLACER_BASE::CheckFit()
     bool CheckFit ( PNS_MEANDER_SHAPE* aShape );
 
+    /**
+     * Function TuneLine()
+     *
+     * Meanders the whole line of aSegment in aNode, without user interaction,
+     * to bring the length of its path to aTargetLength (see PNS_MEANDER_BATCH).
+     * The meandered line replaces the original one in aNode.
+     * @return the length of the path after tuning
+     */
+    int TuneLine( PNS_NODE* aNode, PNS_SEGMENT* aSegment, int aTargetLength );
+
 protected:
 
     bool doMove( const VECTOR2I& aP, PNS_ITEM* aEndItem, int aTargetLength );
@@ -21,6 +21,12 @@
 #include <vector>
 #include <cassert>
 
+#include <boost/functional/hash.hpp>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
 #include <math/vector2d.h>
 
 #include <geometry/seg.h>
@@ -53,8 +59,12 @@ PNS_NODE::PNS_NODE()
     m_parent = NULL;
     m_maxClearance = 800000;    // fixme: depends on how thick traces are.
     m_clearanceFunctor = NULL;
-    m_index = new PNS_INDEX;
+    m_index.reset( new PNS_INDEX );
+    m_joints.reset( new JOINT_MAP );
+    m_override.reset( new boost::unordered_set<PNS_ITEM*> );
     m_collisionFilter = NULL;
+    m_generation = 0;
+    m_collisionCacheGeneration = 0;
 
 #ifdef DEBUG
     allocNodes.insert( this );
@@ -82,7 +92,7 @@ PNS_NODE::~PNS_NODE()
     allocNodes.erase( this );
 #endif
 
-    m_joints.clear();
+    m_joints.reset();
 
     for( PNS_INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
     {
@@ -92,8 +102,6 @@ PNS_NODE::~PNS_NODE()
 
     releaseGarbage();
     unlinkParent();
-
-    delete m_index;
 }
 
 int PNS_NODE::GetClearance( const PNS_ITEM* aA, const PNS_ITEM* aB ) const
@@ -120,26 +128,43 @@ PNS_NODE* PNS_NODE::Branch()
     child->m_collisionFilter = m_collisionFilter;
 
     // immmediate offspring of the root branch needs not copy anything.
-    // For the rest, deep-copy joints, overridden item map and pointers
-    // to stored items.
+    // The rest share the joints, overridden item map and pointers to stored
+    // items with this node, until either of them modifies them.
     if( !isRoot() )
     {
-        JOINT_MAP::iterator j;
-
-        for( PNS_INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
-            child->m_index->Add( *i );
-
+        child->m_index = m_index;
         child->m_joints = m_joints;
         child->m_override = m_override;
     }
 
     TRACE( 2, "%d items, %d joints, %d overrides",
-            child->m_index->Size() % child->m_joints.size() % child->m_override.size() );
+            child->m_index->Size() % child->m_joints->size() % child->m_override->size() );
 
     return child;
 }
 
 
+void PNS_NODE::detachJoints()
+{
+    if( !m_joints.unique() )
+        m_joints.reset( new JOINT_MAP( *m_joints ) );
+}
+
+
+void PNS_NODE::detachOverrides()
+{
+    if( !m_override.unique() )
+        m_override.reset( new boost::unordered_set<PNS_ITEM*>( *m_override ) );
+}
+
+
+void PNS_NODE::detachIndex()
+{
+    if( !m_index.unique() )
+        m_index.reset( new PNS_INDEX( *m_index ) );
+}
+
+
 void PNS_NODE::unlinkParent()
 {
     if( isRoot() )
@@ -218,6 +243,10 @@ struct PNS_NODE::OBSTACLE_VISITOR
         if( m_override && m_override->overrides( aItem ) )
             return true;
 
+        // items of the same net never collide here: skip them before the clearance lookup
+        if( m_differentNetsOnly && aItem->Net() == m_item->Net() )
+            return true;
+
         int clearance = m_extraClearance + m_node->GetClearance( aItem, m_item );
 
         if( m_node->m_collisionFilter && (*m_node->m_collisionFilter)( aItem, m_item ) )
@@ -229,7 +258,7 @@ struct PNS_NODE::OBSTACLE_VISITOR
         if( m_forceClearance >= 0 )
             clearance = m_forceClearance;
 
-        if( !aItem->Collide( m_item, clearance, m_differentNetsOnly ) )
+        if( !m_node->collideCached( aItem, m_item, clearance, m_differentNetsOnly ) )
             return true;
 
         PNS_OBSTACLE obs;
@@ -248,6 +277,85 @@ struct PNS_NODE::OBSTACLE_VISITOR
 };
 
 
+std::size_t PNS_NODE::COLLISION_KEY_HASH::operator()( const COLLISION_KEY& aKey ) const
+{
+    std::size_t seed = boost::hash_value( aKey.m_obstacle );
+
+    boost::hash_combine( seed, aKey.m_a.x );
+    boost::hash_combine( seed, aKey.m_a.y );
+    boost::hash_combine( seed, aKey.m_b.x );
+    boost::hash_combine( seed, aKey.m_b.y );
+    boost::hash_combine( seed, aKey.m_width );
+    boost::hash_combine( seed, aKey.m_layerStart );
+    boost::hash_combine( seed, aKey.m_layerEnd );
+    boost::hash_combine( seed, aKey.m_clearance );
+
+    return seed;
+}
+
+
+bool PNS_NODE::collideCached( const PNS_ITEM* aObstacle, const PNS_ITEM* aItem, int aClearance,
+                              bool aDifferentNetsOnly )
+{
+    // only the items of the root are stable enough to be cached, and among them only
+    // the pads and the locked tracks, which the router never moves.  The items of the
+    // same net are skipped by OBSTACLE_VISITOR when aDifferentNetsOnly is set, so the
+    // cached result only depends on the geometry.
+    bool isStatic = isRoot() && ( aObstacle->Kind() == PNS_ITEM::SOLID ||
+                                  ( aObstacle->Marker() & MK_LOCKED ) );
+
+#ifdef USE_OPENMP
+    // the cache is shared by all the branches: the walkarounds running in parallel
+    // do without it.
+    isStatic = isStatic && !omp_in_parallel();
+#endif
+
+    if( !isStatic || !aItem->OfKind( PNS_ITEM::SEGMENT | PNS_ITEM::VIA ) )
+        return aObstacle->Collide( aItem, aClearance, aDifferentNetsOnly );
+
+    COLLISION_KEY key;
+
+    key.m_obstacle = aObstacle;
+    key.m_layerStart = aItem->Layers().Start();
+    key.m_layerEnd = aItem->Layers().End();
+    key.m_clearance = aClearance;
+
+    if( aItem->Kind() == PNS_ITEM::SEGMENT )
+    {
+        const PNS_SEGMENT* seg = static_cast<const PNS_SEGMENT*>( aItem );
+
+        key.m_a = seg->Seg().A;
+        key.m_b = seg->Seg().B;
+        key.m_width = seg->Width();
+    }
+    else
+    {
+        const PNS_VIA* via = static_cast<const PNS_VIA*>( aItem );
+
+        key.m_a = key.m_b = via->Pos();
+        key.m_width = -via->Diameter();    // tells a via from a zero length segment
+    }
+
+    if( m_collisionCacheGeneration != m_generation ||
+        m_collisionCache.size() >= MaxCachedCollisions )
+    {
+        m_collisionCache.clear();
+        m_collisionCacheGeneration = m_generation;
+    }
+
+    COLLISION_CACHE::const_iterator i = m_collisionCache.find( key );
+
+    if( i != m_collisionCache.end() )
+        return i->second;
+
+    bool colliding = aObstacle->Collide( aItem, aClearance, aDifferentNetsOnly );
+
+    m_collisionCache[key] = colliding;
+
+    return colliding;
+}
+
+
 int PNS_NODE::QueryColliding( const PNS_ITEM* aItem,
         PNS_NODE::OBSTACLES& aObstacles, int aKindMask, int aLimitCount, bool aDifferentNetsOnly, int aForceClearance )
 {
@@ -507,6 +615,7 @@ const PNS_ITEMSET PNS_NODE::HitTest( const VECTOR2I& aPoint ) const
 void PNS_NODE::addSolid( PNS_SOLID* aSolid )
 {
     linkJoint( aSolid->Pos(), aSolid->Layers(), aSolid->Net(), aSolid );
+    detachIndex();
     m_index->Add( aSolid );
 }
 
@@ -514,6 +623,7 @@ void PNS_NODE::addSolid( PNS_SOLID* aSolid )
 void PNS_NODE::addVia( PNS_VIA* aVia )
 {
     linkJoint( aVia->Pos(), aVia->Layers(), aVia->Net(), aVia );
+    detachIndex();
     m_index->Add( aVia );
 }
 
@@ -549,6 +659,7 @@ void PNS_NODE::addLine( PNS_LINE* aLine, bool aAllowRedundant )
 
                 aLine->LinkSegment( pseg );
 
+                detachIndex();
                 m_index->Add( pseg );
             }
         }
@@ -572,6 +683,7 @@ void PNS_NODE::addSegment( PNS_SEGMENT* aSeg, bool aAllowRedundant )
     linkJoint( aSeg->Seg().A, aSeg->Layers(), aSeg->Net(), aSeg );
     linkJoint( aSeg->Seg().B, aSeg->Layers(), aSeg->Net(), aSeg );
 
+    detachIndex();
     m_index->Add( aSeg );
 }
 
@@ -579,6 +691,7 @@ void PNS_NODE::addSegment( PNS_SEGMENT* aSeg, bool aAllowRedundant )
 void PNS_NODE::Add( PNS_ITEM* aItem, bool aAllowRedundant )
 {
     aItem->SetOwner( this );
+    touchRoot();
 
     switch( aItem->Kind() )
     {
@@ -606,15 +719,23 @@ void PNS_NODE::Add( PNS_ITEM* aItem, bool aAllowRedundant )
 
 void PNS_NODE::doRemove( PNS_ITEM* aItem )
 {
+    touchRoot();
+
     // case 1: removing an item that is stored in the root node from any branch:
     // mark it as overridden, but do not remove
     if( aItem->BelongsTo( m_root ) && !isRoot() )
-        m_override.insert( aItem );
+    {
+        detachOverrides();
+        m_override->insert( aItem );
+    }
 
     // case 2: the item belongs to this branch or a parent, non-root branch,
     // or the root itself and we are the root: remove from the index
     else if( !aItem->BelongsTo( m_root ) || isRoot() )
+    {
+        detachIndex();
         m_index->Remove( aItem );
+    }
 
     // the item belongs to this particular branch: un-reference it
     if( aItem->BelongsTo( this ) )
@@ -663,13 +784,15 @@ void PNS_NODE::removeVia( PNS_VIA* aVia )
     tag.net = net;
     tag.pos = p;
 
+    detachJoints();
+
     bool split;
     do
     {
         split = false;
-        std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range = m_joints.equal_range( tag );
+        std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range = m_joints->equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == m_joints->end() )
             break;
 
         // find and remove all joints containing the via to be removed
@@ -678,7 +801,7 @@ void PNS_NODE::removeVia( PNS_VIA* aVia )
         {
             if( aVia->LayersOverlap ( &f->second ) )
             {
-                m_joints.erase( f );
+                m_joints->erase( f );
                 split = true;
                 break;
             }
@@ -917,12 +1040,12 @@ PNS_JOINT* PNS_NODE::FindJoint( const VECTOR2I& aPos, int aLayer, int aNet )
     tag.net = aNet;
     tag.pos = aPos;
 
-    JOINT_MAP::iterator f = m_joints.find( tag ), end = m_joints.end();
+    JOINT_MAP::iterator f = m_joints->find( tag ), end = m_joints->end();
 
     if( f == end && !isRoot() )
     {
-        end = m_root->m_joints.end();
-        f = m_root->m_joints.find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
+        end = m_root->m_joints->end();
+        f = m_root->m_joints->find( tag );    // m_root->FindJoint(aPos, aLayer, aNet);
     }
 
     if( f == end )
@@ -954,18 +1077,20 @@ PNS_JOINT& PNS_NODE::touchJoint( const VECTOR2I& aPos, const PNS_LAYERSET& aLaye
     tag.pos = aPos;
     tag.net = aNet;
 
+    detachJoints();
+
     // try to find the joint in this node.
-    JOINT_MAP::iterator f = m_joints.find( tag );
+    JOINT_MAP::iterator f = m_joints->find( tag );
 
     std::pair<JOINT_MAP::iterator, JOINT_MAP::iterator> range;
 
     // not found and we are not root? find in the root and copy results here.
-    if( f == m_joints.end() && !isRoot() )
+    if( f == m_joints->end() && !isRoot() )
     {
-        range = m_root->m_joints.equal_range( tag );
+        range = m_root->m_joints->equal_range( tag );
 
         for( f = range.first; f != range.second; ++f )
-            m_joints.insert( *f );
+            m_joints->insert( *f );
     }
 
     // now insert and combine overlapping joints
@@ -976,9 +1101,9 @@ PNS_JOINT& PNS_NODE::touchJoint( const VECTOR2I& aPos, const PNS_LAYERSET& aLaye
     do
     {
         merged  = false;
-        range   = m_joints.equal_range( tag );
+        range   = m_joints->equal_range( tag );
 
-        if( range.first == m_joints.end() )
+        if( range.first == m_joints->end() )
             break;
 
         for( f = range.first; f != range.second; ++f )
@@ -986,7 +1111,7 @@ PNS_JOINT& PNS_NODE::touchJoint( const VECTOR2I& aPos, const PNS_LAYERSET& aLaye
             if( aLayers.Overlaps( f->second.Layers() ) )
             {
                 jt.Merge( f->second );
-                m_joints.erase( f );
+                m_joints->erase( f );
                 merged = true;
                 break;
             }
@@ -994,7 +1119,7 @@ PNS_JOINT& PNS_NODE::touchJoint( const VECTOR2I& aPos, const PNS_LAYERSET& aLaye
     }
     while( merged );
 
-    return m_joints.insert( TagJointPair( tag, jt ) )->second;
+    return m_joints->insert( TagJointPair( tag, jt ) )->second;
 }
 
 
@@ -1048,7 +1173,7 @@ void PNS_NODE::Dump( bool aLong )
     JOINT_MAP::iterator j;
 
     if( aLong )
-        for( j = m_joints.begin(); j != m_joints.end(); ++j )
+        for( j = m_joints->begin(); j != m_joints->end(); ++j )
         {
             printf( "joint : %s, links : %d\n",
                     j->second.GetPos().Format().c_str(), j->second.LinkCount() );
@@ -1100,20 +1225,20 @@ void PNS_NODE::Dump( bool aLong )
         lines_count++;
     }
 
-    printf( "Local joints: %d, lines : %d \n", m_joints.size(), lines_count );
+    printf( "Local joints: %d, lines : %d \n", m_joints->size(), lines_count );
 #endif
 }
 
 
 void PNS_NODE::GetUpdatedItems( ITEM_VECTOR& aRemoved, ITEM_VECTOR& aAdded )
 {
-    aRemoved.reserve( m_override.size() );
+    aRemoved.reserve( m_override->size() );
     aAdded.reserve( m_index->Size() );
 
     if( isRoot() )
         return;
 
-    BOOST_FOREACH( PNS_ITEM* item, m_override )
+    BOOST_FOREACH( PNS_ITEM* item, *m_override )
         aRemoved.push_back( item );
 
     for( PNS_INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
@@ -1153,7 +1278,7 @@ void PNS_NODE::Commit( PNS_NODE* aNode )
     if( aNode->isRoot() )
         return;
 
-    BOOST_FOREACH( PNS_ITEM* item, aNode->m_override )
+    BOOST_FOREACH( PNS_ITEM* item, *aNode->m_override )
     Remove( item );
 
     for( PNS_INDEX::ITEM_SET::iterator i = aNode->m_index->begin();
@@ -1276,6 +1401,15 @@ void PNS_NODE::SetCollisionFilter( PNS_COLLISION_FILTER* aFilter )
 }
 
 
+void PNS_NODE::AllItems( ITEM_VECTOR& aItems )
+{
+    aItems.reserve( aItems.size() + m_index->Size() );
+
+    for( PNS_INDEX::ITEM_SET::iterator i = m_index->begin(); i != m_index->end(); ++i )
+        aItems.push_back( *i );
+}
+
+
 PNS_ITEM *PNS_NODE::FindItemByParent( const BOARD_CONNECTED_ITEM* aParent )
 {
     PNS_INDEX::NET_ITEMS_LIST* l_cur = m_index->GetItemsForNet( aParent->GetNetCode() );
@@ -27,6 +27,7 @@
 #include <boost/unordered_set.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
@@ -72,6 +73,10 @@ private:
     struct CLEARANCE_ENT {
         int coupledNet;
         int clearance;
+
+        ///> true if a pad of the net has a local clearance larger than the net class one:
+        ///> the pads of the other nets need not be looked at.
+        bool padOverride;
     };
 
     PNS_ROUTER *m_router;
@@ -165,7 +170,7 @@ public:
     ///> Returns the number of joints
     int JointCount() const
     {
-        return m_joints.size();
+        return m_joints->size();
     }
 
     ///> Returns the number of nodes in the inheritance chain (wrs to the root node)
@@ -376,6 +381,10 @@ public:
 
     void AllItemsInNet( int aNet, std::set<PNS_ITEM*>& aItems );
 
+    ///> collects the items stored in this node's own index: all the items of the world,
+    ///> for the root node.
+    void AllItems( ITEM_VECTOR& aItems );
+
     void ClearRanks( int aMarkerMask = MK_HEAD | MK_VIOLATION );
 
     int FindByMarker( int aMarker, PNS_ITEMSET& aItems );
@@ -435,9 +444,59 @@ private:
     ///> from the root branch.
     bool overrides( PNS_ITEM* aItem ) const
     {
-        return m_override.find( aItem ) != m_override.end();
+        return m_override->find( aItem ) != m_override->end();
+    }
+
+    ///> a collision test between a static item of the root node (a pad or a locked
+    ///> track) and a segment or a via, described by its geometry: the segments and vias
+    ///> being routed are rebuilt on each move, but keep most of their shapes.
+    struct COLLISION_KEY
+    {
+        const PNS_ITEM* m_obstacle;
+        VECTOR2I m_a;
+        VECTOR2I m_b;
+        int m_width;
+        int m_layerStart;
+        int m_layerEnd;
+        int m_clearance;
+
+        bool operator==( const COLLISION_KEY& aOther ) const
+        {
+            return m_obstacle == aOther.m_obstacle && m_a == aOther.m_a && m_b == aOther.m_b &&
+                   m_width == aOther.m_width && m_layerStart == aOther.m_layerStart &&
+                   m_layerEnd == aOther.m_layerEnd && m_clearance == aOther.m_clearance;
+        }
+    };
+
+    struct COLLISION_KEY_HASH
+    {
+        std::size_t operator()( const COLLISION_KEY& aKey ) const;
+    };
+
+    typedef boost::unordered_map<COLLISION_KEY, bool, COLLISION_KEY_HASH> COLLISION_CACHE;
+
+    ///> max number of cached collision tests, before the cache is flushed
+    static const unsigned int MaxCachedCollisions = 65536;
+
+    ///> tests aItem against aObstacle, an item of the root node, with aClearance,
+    ///> using the collision cache of the root when aObstacle is static.
+    bool collideCached( const PNS_ITEM* aObstacle, const PNS_ITEM* aItem, int aClearance,
+                        bool aDifferentNetsOnly );
+
+    ///> invalidates the collision cache of the root, when the root is modified
+    void touchRoot()
+    {
+        if( isRoot() )
+            m_generation++;
     }
 
+    ///> give the node its own copy of its joints, overridden items or index, if they are
+    ///> still shared with the node it was branched from or with a branch, before
+    ///> modifying them (see Branch())
+    void detachJoints();
+    void detachOverrides();
+    void detachIndex();
+
     PNS_SEGMENT* findRedundantSegment( PNS_SEGMENT* aSeg );
 
     ///> scans the joint map, forming a line starting from segment (current).
@@ -452,7 +511,9 @@ private:
 
     ///> hash table with the joints, linking the items. Joints are hashed by
     ///> their position, layer set and net.
-    JOINT_MAP m_joints;
+    ///> The joints, the overridden items and the index are shared by a node and its
+    ///> branches until one of them modifies them: copy-on-write.
+    boost::shared_ptr<JOINT_MAP> m_joints;
 
     ///> node this node was branched from
     PNS_NODE* m_parent;
@@ -464,7 +525,7 @@ private:
     std::set<PNS_NODE*> m_children;
 
     ///> hash of root's items that have been changed in this node
-    boost::unordered_set<PNS_ITEM*> m_override;
+    boost::shared_ptr< boost::unordered_set<PNS_ITEM*> > m_override;
 
     ///> worst case item-item clearance
     int m_maxClearance;
@@ -473,7 +534,7 @@ private:
     PNS_CLEARANCE_FUNC* m_clearanceFunctor;
 
     ///> Geometric/Net index of the items
-    PNS_INDEX* m_index;
+    boost::shared_ptr<PNS_INDEX> m_index;
 
     ///> depth of the node (number of parent nodes in the inheritance chain)
     int m_depth;
@@ -482,6 +543,12 @@ private:
     PNS_COLLISION_FILTER* m_collisionFilter;
 
     boost::unordered_set<PNS_ITEM*> m_garbageItems;
+
+    ///> number of modifications of the root node: the collision cache, kept by the root,
+    ///> is valid as long as it is tagged with the current generation.
+    unsigned int m_generation;
+    unsigned int m_collisionCacheGeneration;
+    COLLISION_CACHE m_collisionCache;
 };
 
 #endif
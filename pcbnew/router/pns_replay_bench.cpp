@@ -0,0 +1,226 @@
+/*
+ * KiRouter - a push-and-(sometimes-)shove PCB router
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+    A benchmark of the router, replaying a recorded routing session without a view.
+
+    Usage:  pns_replay_bench board.kicad_pcb router_events.log
+
+    The events are recorded by the router since the activation of the router tool, and
+    saved to /tmp/router_events.log by PNS_ROUTER::DumpLog() (key '0' of the router
+    tool).  The board must be the one the session started from, so save it before
+    activating the router tool.
+
+    The latency of each PNS_ROUTER::Move() is measured, and its percentiles reported.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/foreach.hpp>
+
+#include <wx/init.h>
+
+#include <profile.h>
+#include <io_mgr.h>
+#include <class_board.h>
+#include <ratsnest_data.h>
+
+#include "pns_item.h"
+#include "pns_itemset.h"
+#include "pns_router.h"
+#include "pns_sizes_settings.h"
+
+
+/// Finds the item of aNet and aKind under aP, to replay an event on
+static PNS_ITEM* findItem( PNS_ROUTER& aRouter, const VECTOR2I& aP, int aNet, int aKind )
+{
+    if( !aKind )
+        return NULL;
+
+    PNS_ITEMSET items = aRouter.QueryHoverItems( aP );
+
+    BOOST_FOREACH( PNS_ITEM* item, items.Items() )
+    {
+        if( item->Net() == aNet && (int) item->Kind() == aKind )
+            return item;
+    }
+
+    return NULL;
+}
+
+
+static double percentile( const std::vector<double>& aSorted, int aPercent )
+{
+    if( aSorted.empty() )
+        return 0.0;
+
+    unsigned int i = aSorted.size() * aPercent / 100;
+
+    return aSorted[std::min<unsigned int>( i, aSorted.size() - 1 )];
+}
+
+
+int main( int argc, char** argv )
+{
+    wxInitializer initializer( argc, argv );
+
+    if( argc < 3 )
+    {
+        printf( "usage: %s board.kicad_pcb router_events.log\n", argv[0] );
+        return 1;
+    }
+
+    BOARD* board = NULL;
+
+    try
+    {
+        board = IO_MGR::Load( IO_MGR::KICAD, wxString::FromUTF8( argv[1] ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", (const char*) ioe.errorText.mb_str() );
+        return 1;
+    }
+
+    std::ifstream events( argv[2] );
+
+    if( !events )
+    {
+        fprintf( stderr, "can't open %s\n", argv[2] );
+        return 1;
+    }
+
+    board->GetRatsnest()->ProcessBoard();
+
+    PNS_ROUTER router;
+    prof_counter cnt;
+
+    router.SetBoard( board );
+
+    prof_start( &cnt );
+    router.SyncWorld();
+    prof_end( &cnt );
+
+    printf( "sync: %.1f ms\n", cnt.msecs() );
+
+    std::vector<double> moveTimes;
+    std::string line;
+    int started = 0, fixed = 0, failed = 0;
+
+    while( std::getline( events, line ) )
+    {
+        std::istringstream ev( line );
+        std::string name;
+
+        ev >> name;
+
+        if( name == "mode" )
+        {
+            int routerMode, pnsMode;
+
+            ev >> routerMode >> pnsMode;
+            router.SetMode( (PNS_ROUTER_MODE) routerMode );
+            router.Settings().SetMode( (PNS_MODE) pnsMode );
+            continue;
+        }
+        else if( name == "sizes" )
+        {
+            PNS_SIZES_SETTINGS sizes;
+            int trackWidth, viaDiameter, viaDrill, viaType, dpWidth, dpGap, top, bottom;
+
+            ev >> trackWidth >> viaDiameter >> viaDrill >> viaType >> dpWidth >> dpGap
+               >> top >> bottom;
+
+            sizes.SetTrackWidth( trackWidth );
+            sizes.SetViaDiameter( viaDiameter );
+            sizes.SetViaDrill( viaDrill );
+            sizes.SetViaType( (VIATYPE_T) viaType );
+            sizes.SetDiffPairWidth( dpWidth );
+            sizes.SetDiffPairGap( dpGap );
+            sizes.AddLayerPair( top, bottom );
+            router.UpdateSizes( sizes );
+            continue;
+        }
+
+        VECTOR2I p;
+        int net = -1, kind = 0, param = 0;
+
+        ev >> p.x >> p.y >> net >> kind >> param;
+
+        PNS_ITEM* item = findItem( router, p, net, kind );
+
+        if( name == "route" || name == "drag" )
+        {
+            bool rv = ( name == "route" ) ? router.StartRouting( p, item, param )
+                                          : router.StartDragging( p, item );
+            started++;
+
+            if( !rv )
+                failed++;
+        }
+        else if( name == "move" )
+        {
+            prof_start( &cnt );
+            router.Move( p, item );
+            prof_end( &cnt );
+
+            moveTimes.push_back( cnt.msecs() );
+        }
+        else if( name == "fix" )
+        {
+            if( router.FixRoute( p, item ) )
+                fixed++;
+
+            router.ClearUndoBuffer();
+        }
+        else if( name == "stop" )
+            router.StopRouting();
+        else if( name == "layer" )
+            router.SwitchLayer( param );
+        else if( name == "via" )
+            router.ToggleViaPlacement();
+        else if( name == "posture" )
+            router.FlipPosture();
+    }
+
+    router.StopRouting();
+
+    double total = 0.0;
+
+    BOOST_FOREACH( double t, moveTimes )
+        total += t;
+
+    std::sort( moveTimes.begin(), moveTimes.end() );
+
+    printf( "sessions: %d (%d failed to start), fixed: %d\n", started, failed, fixed );
+    printf( "moves     mean ms  p50 ms  p90 ms  p99 ms  max ms\n" );
+    printf( "%5u  %10.2f  %6.2f  %6.2f  %6.2f  %6.2f\n", (unsigned int) moveTimes.size(),
+            moveTimes.empty() ? 0.0 : total / moveTimes.size(),
+            percentile( moveTimes, 50 ), percentile( moveTimes, 90 ),
+            percentile( moveTimes, 99 ), moveTimes.empty() ? 0.0 : moveTimes.back() );
+
+    delete board;
+
+    return 0;
+}
@@ -19,9 +19,12 @@
  */
 
 #include <cstdio>
+#include <fstream>
 #include <vector>
 
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
 
 #include <view/view.h>
 #include <view/view_item.h>
@@ -36,6 +39,7 @@
 #include <geometry/shape_circle.h>
 
 #include <tools/grid_helper.h>
+#include <memory_stats.h>
 
 #include "trace.h"
 #include "pns_node.h"
@@ -59,6 +63,7 @@
 #include <class_module.h>
 #include <class_track.h>
 #include <ratsnest_data.h>
+#include <trace_events.h>
 #include <layers_id_colors_and_visibility.h>
 #include <geometry/convex_hull.h>
 
@@ -86,6 +91,7 @@ PNS_PCBNEW_CLEARANCE_FUNC::PNS_PCBNEW_CLEARANCE_FUNC( PNS_ROUTER* aRouter ) :
 
         CLEARANCE_ENT ent;
         ent.coupledNet = topo.DpCoupledNet( i );
+        ent.padOverride = false;
 
         wxString netClassName = ni->GetClassName();
         NETCLASSPTR nc = brd->GetDesignSettings().m_NetClasses.Find( netClassName );
@@ -98,6 +104,18 @@ PNS_PCBNEW_CLEARANCE_FUNC::PNS_PCBNEW_CLEARANCE_FUNC( PNS_ROUTER* aRouter ) :
             clearance );
     }
 
+    for( MODULE* module = brd->m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+        {
+            int net = pad->GetNetCode();
+
+            if( net >= 0 && net < (int) m_clearanceCache.size() &&
+                pad->GetLocalClearance() > m_clearanceCache[net].clearance )
+                m_clearanceCache[net].padOverride = true;
+        }
+    }
+
     m_overrideEnabled = false;
     m_defaultClearance = Millimeter2iu( 0.254 );    // aBoard->m_NetClasses.Find ("Default clearance")->GetClearance();
     m_overrideNetA = 0;
@@ -124,20 +142,28 @@ int PNS_PCBNEW_CLEARANCE_FUNC::localPadClearance( const PNS_ITEM* aItem ) const
 int PNS_PCBNEW_CLEARANCE_FUNC::operator()( const PNS_ITEM* aA, const PNS_ITEM* aB )
 {
     int net_a = aA->Net();
-    int cl_a = ( net_a >= 0 ? m_clearanceCache[net_a].clearance : m_defaultClearance );
     int net_b = aB->Net();
-    int cl_b = ( net_b >= 0 ? m_clearanceCache[net_b].clearance : m_defaultClearance );
-
-    bool linesOnly = aA->OfKind( PNS_ITEM::SEGMENT | PNS_ITEM::LINE ) && aB->OfKind( PNS_ITEM::SEGMENT | PNS_ITEM::LINE );
 
     if( net_a == net_b )
         return 0;
 
-    if( m_useDpGap && linesOnly && net_a >= 0 && net_b >= 0 && m_clearanceCache[net_a].coupledNet == net_b )
+    const CLEARANCE_ENT* ent_a = ( net_a >= 0 ? &m_clearanceCache[net_a] : NULL );
+    const CLEARANCE_ENT* ent_b = ( net_b >= 0 ? &m_clearanceCache[net_b] : NULL );
+    int cl_a = ( ent_a ? ent_a->clearance : m_defaultClearance );
+    int cl_b = ( ent_b ? ent_b->clearance : m_defaultClearance );
+
+    if( m_useDpGap && ent_a && ent_b && ent_a->coupledNet == net_b )
     {
-        cl_a = cl_b = m_router->Sizes().DiffPairGap() - 2 * PNS_HULL_MARGIN;
+        bool linesOnly = aA->OfKind( PNS_ITEM::SEGMENT | PNS_ITEM::LINE ) && aB->OfKind( PNS_ITEM::SEGMENT | PNS_ITEM::LINE );
+
+        if( linesOnly )
+            cl_a = cl_b = m_router->Sizes().DiffPairGap() - 2 * PNS_HULL_MARGIN;
     }
 
+    // fast path: no pad of either net can raise the net class clearance
+    if( ( ent_a && !ent_a->padOverride ) && ( ent_b && !ent_b->padOverride ) )
+        return std::max( cl_a, cl_b );
+
     int pad_a = localPadClearance( aA );
     int pad_b = localPadClearance( aB );
 
@@ -255,19 +281,9 @@ PNS_ITEM* PNS_ROUTER::syncPad( D_PAD* aPad )
                 break;
 
             case PAD_SHAPE_TRAPEZOID:
-            {
-                wxPoint coords[4];
-                aPad->BuildPadPolygon( coords, wxSize( 0, 0 ), aPad->GetOrientation() );
-                SHAPE_CONVEX* shape = new SHAPE_CONVEX();
-
-                for( int ii = 0; ii < 4; ii++ )
-                {
-                    shape->Append( wx_c + coords[ii] );
-                }
-
-                solid->SetShape( shape );
+                // the pad caches its outline in board coordinates
+                solid->SetShape( new SHAPE_CONVEX( aPad->GetEffectivePolygon() ) );
                 break;
-            }
 
             case PAD_SHAPE_ROUNDRECT:
             {
@@ -353,19 +369,9 @@ PNS_ITEM* PNS_ROUTER::syncPad( D_PAD* aPad )
 
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_TRAPEZOID:
-            {
-                wxPoint coords[4];
-                aPad->BuildPadPolygon( coords, wxSize( 0, 0 ), aPad->GetOrientation() );
-
-                SHAPE_CONVEX* shape = new SHAPE_CONVEX();
-                for( int ii = 0; ii < 4; ii++ )
-                {
-                    shape->Append( wx_c + coords[ii] );
-                }
-
-                solid->SetShape( shape );
+                // the pad caches its outline in board coordinates
+                solid->SetShape( new SHAPE_CONVEX( aPad->GetEffectivePolygon() ) );
                 break;
-            }
 
             case PAD_SHAPE_ROUNDRECT:
             {
@@ -429,6 +435,158 @@ PNS_ITEM* PNS_ROUTER::syncVia( VIA* aVia )
 }
 
 
+PNS_ITEM* PNS_ROUTER::syncItem( BOARD_CONNECTED_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+        return syncPad( static_cast<D_PAD*>( aItem ) );
+
+    case PCB_TRACE_T:
+        return syncTrack( static_cast<TRACK*>( aItem ) );
+
+    case PCB_VIA_T:
+        return syncVia( static_cast<VIA*>( aItem ) );
+
+    default:
+        return NULL;
+    }
+}
+
+
+std::size_t PNS_ROUTER::syncSignature( BOARD_CONNECTED_ITEM* aItem )
+{
+    std::size_t seed = boost::hash_value( (int) aItem->Type() );
+
+    boost::hash_combine( seed, aItem->GetNetCode() );
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+        boost::hash_combine( seed, pad->ShapePos().x );
+        boost::hash_combine( seed, pad->ShapePos().y );
+        boost::hash_combine( seed, pad->GetSize().x );
+        boost::hash_combine( seed, pad->GetSize().y );
+        boost::hash_combine( seed, pad->GetOffset().x );
+        boost::hash_combine( seed, pad->GetOffset().y );
+        boost::hash_combine( seed, pad->GetDelta().x );
+        boost::hash_combine( seed, pad->GetDelta().y );
+        boost::hash_combine( seed, pad->GetOrientation() );
+        boost::hash_combine( seed, pad->GetRoundRectRadiusRatio() );
+        boost::hash_combine( seed, (int) pad->GetShape() );
+        boost::hash_combine( seed, (int) pad->GetAttribute() );
+        boost::hash_combine( seed, ( pad->GetLayerSet() & LSET::AllCuMask() ).to_ulong() );
+        break;
+    }
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    {
+        TRACK* track = static_cast<TRACK*>( aItem );
+
+        boost::hash_combine( seed, track->GetStart().x );
+        boost::hash_combine( seed, track->GetStart().y );
+        boost::hash_combine( seed, track->GetEnd().x );
+        boost::hash_combine( seed, track->GetEnd().y );
+        boost::hash_combine( seed, track->GetWidth() );
+        boost::hash_combine( seed, (int) track->GetLayer() );
+
+        if( aItem->Type() == PCB_VIA_T )
+        {
+            VIA* via = static_cast<VIA*>( aItem );
+            LAYER_ID top, bottom;
+
+            via->LayerPair( &top, &bottom );
+            boost::hash_combine( seed, (int) top );
+            boost::hash_combine( seed, (int) bottom );
+            boost::hash_combine( seed, via->GetDrillValue() );
+            boost::hash_combine( seed, (int) via->GetViaType() );
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    return seed;
+}
+
+
+void PNS_ROUTER::updateWorld()
+{
+    // the board change notifications do not cover all the edits (e.g. undo, or the
+    // global track edits), so the items to update are found by comparing each board
+    // item with the signature it had at the previous sync.
+    PNS_NODE::ITEM_VECTOR items;
+    SYNCED_ITEMS synced;
+    SYNC_SIGNATURES signatures;
+
+    m_world->KillChildren();
+    m_world->AllItems( items );
+
+    BOOST_FOREACH( PNS_ITEM* item, items )
+    {
+        if( item->Parent() )
+            synced[item->Parent()] = item;
+        else
+            m_world->Remove( item );
+    }
+
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            updateItem( pad, synced, signatures );
+    }
+
+    for( TRACK* t = m_board->m_Track; t; t = t->Next() )
+        updateItem( t, synced, signatures );
+
+    // what remains belongs to items removed from the board
+    for( SYNCED_ITEMS::iterator i = synced.begin(); i != synced.end(); ++i )
+        m_world->Remove( i->second );
+
+    m_syncSignatures.swap( signatures );
+}
+
+
+void PNS_ROUTER::updateItem( BOARD_CONNECTED_ITEM* aItem, SYNCED_ITEMS& aSynced,
+                             SYNC_SIGNATURES& aSignatures )
+{
+    std::size_t signature = syncSignature( aItem );
+    SYNC_SIGNATURES::const_iterator prev = m_syncSignatures.find( aItem );
+    bool unchanged = ( prev != m_syncSignatures.end() && prev->second == signature );
+    SYNCED_ITEMS::iterator i = aSynced.find( aItem );
+
+    aSignatures[aItem] = signature;
+
+    if( i != aSynced.end() )
+    {
+        PNS_ITEM* old = i->second;
+
+        aSynced.erase( i );
+
+        if( unchanged )
+            return;
+
+        m_world->Remove( old );
+    }
+    else if( unchanged )
+    {
+        // an item the router does not use (e.g. a non-copper pad)
+        return;
+    }
+
+    PNS_ITEM* item = syncItem( aItem );
+
+    if( item )
+        m_world->Add( item );
+}
+
+
 void PNS_ROUTER::SetBoard( BOARD* aBoard )
 {
     m_board = aBoard;
@@ -444,35 +602,48 @@ void PNS_ROUTER::SyncWorld()
         return;
     }
 
-    ClearWorld();
+    m_eventLog.str( std::string() );
 
-    m_world = new PNS_NODE();
-
-    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    // a world kept from a previous routing session is only updated with the items
+    // changed on the board since then
+    if( m_world && m_state == IDLE )
     {
-        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+        updateWorld();
+    }
+    else
+    {
+        ClearWorld();
+        m_syncSignatures.clear();
+
+        m_world = new PNS_NODE();
+
+        for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
         {
-            PNS_ITEM* solid = syncPad( pad );
+            for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            {
+                PNS_ITEM* solid = syncPad( pad );
+
+                m_syncSignatures[pad] = syncSignature( pad );
 
-            if( solid )
-                m_world->Add( solid );
+                if( solid )
+                    m_world->Add( solid );
+            }
         }
-    }
 
-    for( TRACK* t = m_board->m_Track; t; t = t->Next() )
-    {
-        KICAD_T type = t->Type();
-        PNS_ITEM* item = NULL;
+        for( TRACK* t = m_board->m_Track; t; t = t->Next() )
+        {
+            PNS_ITEM* item = syncItem( t );
 
-        if( type == PCB_TRACE_T )
-            item = syncTrack( t );
-        else if( type == PCB_VIA_T )
-            item = syncVia( static_cast<VIA*>( t ) );
+            m_syncSignatures[t] = syncSignature( t );
 
-        if( item )
-            m_world->Add( item );
+            if( item )
+                m_world->Add( item );
+        }
     }
 
+    // net classes are not tracked: the clearances are resolved again
+    delete m_clearanceFunc;
+
     int worstClearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
     m_clearanceFunc = new PNS_PCBNEW_CLEARANCE_FUNC( this );
     m_world->SetClearanceFunctor( m_clearanceFunc );
@@ -505,6 +676,7 @@ PNS_ROUTER::PNS_ROUTER()
     m_violation = false;
     m_gridHelper = NULL;
 
+    MEMORY_STATS::RegisterSource( this, boost::bind( &PNS_ROUTER::addMemoryStats, this, _1 ) );
 }
 
 
@@ -524,6 +696,35 @@ void PNS_ROUTER::SetView( KIGFX::VIEW* aView )
 }
 
 
+void PNS_ROUTER::addMemoryStats( MEMORY_STATS& aStats ) const
+{
+    if( !m_world )
+        return;
+
+    PNS_NODE::ITEM_VECTOR items;
+    size_t segments = 0, vias = 0, solids = 0;
+
+    m_world->AllItems( items );
+
+    BOOST_FOREACH( const PNS_ITEM* item, items )
+    {
+        switch( item->Kind() )
+        {
+        case PNS_ITEM::SEGMENT: ++segments; break;
+        case PNS_ITEM::VIA:     ++vias;     break;
+        case PNS_ITEM::SOLID:   ++solids;   break;
+        default:                            break;
+        }
+    }
+
+    aStats.Add( wxT( "Router" ), wxT( "segments" ), segments, segments * sizeof( PNS_SEGMENT ) );
+    aStats.Add( wxT( "Router" ), wxT( "vias" ), vias, vias * sizeof( PNS_VIA ) );
+    aStats.Add( wxT( "Router" ), wxT( "solids" ), solids, solids * sizeof( PNS_SOLID ) );
+    aStats.Add( wxT( "Router" ), wxT( "joints" ), m_world->JointCount(),
+                m_world->JointCount() * sizeof( PNS_JOINT ) );
+}
+
+
 PNS_ROUTER* PNS_ROUTER::GetInstance()
 {
     return theRouter;
@@ -532,6 +733,7 @@ PNS_ROUTER* PNS_ROUTER::GetInstance()
 
 PNS_ROUTER::~PNS_ROUTER()
 {
+    MEMORY_STATS::UnregisterSource( this );
     ClearWorld();
     theRouter = NULL;
 
@@ -637,6 +839,9 @@ bool PNS_ROUTER::StartDragging( const VECTOR2I& aP, PNS_ITEM* aStartItem )
     if( !aStartItem || aStartItem->OfKind( PNS_ITEM::SOLID ) )
         return false;
 
+    m_eventLog << "mode " << m_mode << " " << m_settings.Mode() << std::endl;
+    logEvent( "drag", aP, aStartItem );
+
     m_dragger = new PNS_DRAGGER( this );
     m_dragger->SetWorld( m_world );
 
@@ -654,6 +859,13 @@ bool PNS_ROUTER::StartDragging( const VECTOR2I& aP, PNS_ITEM* aStartItem )
 
 bool PNS_ROUTER::StartRouting( const VECTOR2I& aP, PNS_ITEM* aStartItem, int aLayer )
 {
+    m_eventLog << "mode " << m_mode << " " << m_settings.Mode() << std::endl;
+    m_eventLog << "sizes " << m_sizes.TrackWidth() << " " << m_sizes.ViaDiameter() << " "
+               << m_sizes.ViaDrill() << " " << m_sizes.ViaType() << " "
+               << m_sizes.DiffPairWidth() << " " << m_sizes.DiffPairGap() << " "
+               << m_sizes.GetLayerTop() << " " << m_sizes.GetLayerBottom() << std::endl;
+    logEvent( "route", aP, aStartItem, aLayer );
+
     m_clearanceFunc->UseDpGap( false );
 
     switch( m_mode )
@@ -718,6 +930,10 @@ void PNS_ROUTER::eraseView()
 
 void PNS_ROUTER::DisplayItem( const PNS_ITEM* aItem, int aColor, int aClearance )
 {
+    // no view to display on, when replaying the router events
+    if( !m_previewItems )
+        return;
+
     ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( aItem, m_previewItems );
 
     if( aColor >= 0 )
@@ -742,6 +958,9 @@ void PNS_ROUTER::DisplayItems( const PNS_ITEMSET& aItems )
 
 void PNS_ROUTER::DisplayDebugLine( const SHAPE_LINE_CHAIN& aLine, int aType, int aWidth )
 {
+    if( !m_previewItems )
+        return;
+
     ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( NULL, m_previewItems );
 
     pitem->Line( aLine, aWidth, aType );
@@ -753,6 +972,9 @@ void PNS_ROUTER::DisplayDebugLine( const SHAPE_LINE_CHAIN& aLine, int aType, int
 
 void PNS_ROUTER::DisplayDebugPoint( const VECTOR2I aPos, int aType )
 {
+    if( !m_previewItems )
+        return;
+
     ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( NULL, m_previewItems );
 
     pitem->Point( aPos, aType );
@@ -764,8 +986,13 @@ void PNS_ROUTER::DisplayDebugPoint( const VECTOR2I aPos, int aType )
 
 void PNS_ROUTER::Move( const VECTOR2I& aP, PNS_ITEM* endItem )
 {
+    TRACE_SCOPE( "PNS_ROUTER::Move" );
+
     m_currentEnd = aP;
 
+    if( m_state != IDLE )
+        logEvent( "move", aP, endItem );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -830,7 +1057,7 @@ void PNS_ROUTER::updateView( PNS_NODE* aNode, PNS_ITEMSET& aCurrent )
     PNS_NODE::ITEM_VECTOR removed, added;
     PNS_NODE::OBSTACLES obstacles;
 
-    if( !aNode )
+    if( !aNode || !m_previewItems )
         return;
 
     if( Settings().Mode() == RM_MarkObstacles )
@@ -908,7 +1135,10 @@ void PNS_ROUTER::CommitRouting( PNS_NODE* aNode )
 
         if( parent )
         {
-            m_view->Remove( parent );
+            if( m_view )
+                m_view->Remove( parent );
+
+
             m_board->Remove( parent );
             m_undoBuffer.PushItem( ITEM_PICKER( parent, UR_DELETED ) );
         }
@@ -958,7 +1188,9 @@ void PNS_ROUTER::CommitRouting( PNS_NODE* aNode )
         {
             item->SetParent( newBI );
             newBI->ClearFlags();
-            m_view->Add( newBI );
+            if( m_view )
+                m_view->Add( newBI );
+
             m_board->Add( newBI );
             m_undoBuffer.PushItem( ITEM_PICKER( newBI, UR_NEW ) );
             newBI->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
@@ -974,6 +1206,9 @@ bool PNS_ROUTER::FixRoute( const VECTOR2I& aP, PNS_ITEM* aEndItem )
 {
     bool rv = false;
 
+    if( m_state != IDLE )
+        logEvent( "fix", aP, aEndItem );
+
     switch( m_state )
     {
     case ROUTE_TRACK:
@@ -1014,6 +1249,8 @@ void PNS_ROUTER::StopRouting()
     if( !RoutingInProgress() )
         return;
 
+    logEvent( "stop" );
+
     if( m_placer )
         delete m_placer;
 
@@ -1035,6 +1272,7 @@ void PNS_ROUTER::FlipPosture()
 {
     if( m_state == ROUTE_TRACK )
     {
+        logEvent( "posture" );
         m_placer->FlipPosture();
     }
 }
@@ -1045,6 +1283,7 @@ void PNS_ROUTER::SwitchLayer( int aLayer )
     switch( m_state )
     {
     case ROUTE_TRACK:
+        logEvent( "layer", VECTOR2I( 0, 0 ), NULL, aLayer );
         m_placer->SetLayer( aLayer );
         break;
     default:
@@ -1058,6 +1297,8 @@ void PNS_ROUTER::ToggleViaPlacement()
     if( m_state == ROUTE_TRACK )
     {
         bool toggle = !m_placer->IsPlacingVia();
+
+        logEvent( "via" );
         m_placer->ToggleVia( toggle );
     }
 }
@@ -1100,6 +1341,19 @@ void PNS_ROUTER::DumpLog()
 
     if( logger )
         logger->Save( "/tmp/shove.log" );
+
+    std::ofstream events( "/tmp/router_events.log" );
+
+    events << m_eventLog.str();
+}
+
+
+void PNS_ROUTER::logEvent( const char* aName, const VECTOR2I& aP, const PNS_ITEM* aItem,
+                           int aParam )
+{
+    m_eventLog << aName << " " << aP.x << " " << aP.y << " "
+               << ( aItem ? aItem->Net() : -1 ) << " " << ( aItem ? (int) aItem->Kind() : 0 )
+               << " " << aParam << std::endl;
 }
 
 
@@ -22,9 +22,11 @@
 #define __PNS_ROUTER_H
 
 #include <list>
+#include <sstream>
 
 #include <boost/optional.hpp>
 #include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <geometry/shape_line_chain.h>
 #include <class_undoredo_container.h>
@@ -41,6 +43,7 @@ class D_PAD;
 class TRACK;
 class VIA;
 class GRID_HELPER;
+class MEMORY_STATS;
 class PNS_NODE;
 class PNS_DIFF_PAIR_PLACER;
 class PNS_PLACEMENT_ALGO;
@@ -131,6 +134,14 @@ public:
     int GetCurrentLayer() const;
     const std::vector<int> GetCurrentNets() const;
 
+    /**
+     * Function DumpLog()
+     *
+     * Saves the geometry log of the current placer or dragger to /tmp/shove.log, and
+     * the router events recorded since the last SyncWorld() to /tmp/router_events.log.
+     * The events can be replayed by pns_replay_bench, on the board as it was saved
+     * when the router tool was activated.
+     */
     void DumpLog();
 
     PNS_CLEARANCE_FUNC* GetClearanceFunc() const
@@ -222,6 +233,27 @@ public:
     }
 
 private:
+    typedef boost::unordered_map<const BOARD_CONNECTED_ITEM*, PNS_ITEM*> SYNCED_ITEMS;
+    typedef boost::unordered_map<const BOARD_CONNECTED_ITEM*, std::size_t> SYNC_SIGNATURES;
+
+    ///> builds the router item of a pad, a track or a via
+    PNS_ITEM* syncItem( BOARD_CONNECTED_ITEM* aItem );
+
+    ///> @return a hash of the properties of aItem its router item is built from
+    static std::size_t syncSignature( BOARD_CONNECTED_ITEM* aItem );
+
+    ///> updates the world kept from the previous sync with the board changes
+    void updateWorld();
+
+    ///> adds the items of the world to aStats, see MEMORY_STATS::RegisterSource()
+    void addMemoryStats( MEMORY_STATS& aStats ) const;
+    void updateItem( BOARD_CONNECTED_ITEM* aItem, SYNCED_ITEMS& aSynced,
+                     SYNC_SIGNATURES& aSignatures );
+
+    ///> records a router event, for DumpLog()
+    void logEvent( const char* aName, const VECTOR2I& aP = VECTOR2I( 0, 0 ),
+                   const PNS_ITEM* aItem = NULL, int aParam = 0 );
+
     void movePlacing( const VECTOR2I& aP, PNS_ITEM* aItem );
     void moveDragging( const VECTOR2I& aP, PNS_ITEM* aItem );
 
@@ -271,6 +303,12 @@ private:
 
     boost::unordered_set<BOARD_CONNECTED_ITEM*> m_hiddenItems;
 
+    ///> signatures of the board items, at the last sync
+    SYNC_SIGNATURES m_syncSignatures;
+
+    ///> router events since the last sync, one per line: name x y net kind param
+    std::stringstream m_eventLog;
+
     ///> Stores list of modified items in the current operation
     PICKED_ITEMS_LIST m_undoBuffer;
     PNS_SIZES_SETTINGS m_sizes;
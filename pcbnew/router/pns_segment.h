@@ -62,6 +62,11 @@ public:
 
     PNS_SEGMENT* Clone() const;
 
+    ///> segments are allocated from a pool (see pns_line.cpp), as the shove creates and
+    ///> destroys thousands of them on each mouse move
+    static void* operator new( std::size_t aSize );
+    static void operator delete( void* aPtr, std::size_t aSize );
+
     const SHAPE* Shape() const
     {
         return static_cast<const SHAPE*>( &m_seg );
@@ -26,10 +26,49 @@
 #include <geometry/shape_circle.h>
 #include <geometry/shape_convex.h>
 
+#include <boost/thread/mutex.hpp>
+
 #include "pns_solid.h"
 #include "pns_utils.h"
 
+// The walkaround looks for the obstacles in both directions at the same time
+static boost::mutex s_hullCacheLock;
+
+// The number of hulls kept per solid, a few clearances and track widths are used at a time
+static const unsigned s_maxCachedHulls = 8;
+
+
 const SHAPE_LINE_CHAIN PNS_SOLID::Hull( int aClearance, int aWalkaroundThickness ) const
+{
+    {
+        boost::mutex::scoped_lock lock( s_hullCacheLock );
+
+        for( unsigned i = 0; i < m_hulls.size(); i++ )
+        {
+            if( m_hulls[i].m_clearance == aClearance
+                    && m_hulls[i].m_walkaroundThickness == aWalkaroundThickness )
+                return m_hulls[i].m_hull;
+        }
+    }
+
+    CACHED_HULL entry;
+
+    entry.m_clearance = aClearance;
+    entry.m_walkaroundThickness = aWalkaroundThickness;
+    entry.m_hull = buildHull( aClearance, aWalkaroundThickness );
+
+    boost::mutex::scoped_lock lock( s_hullCacheLock );
+
+    if( m_hulls.size() >= s_maxCachedHulls )
+        m_hulls.erase( m_hulls.begin() );
+
+    m_hulls.push_back( entry );
+
+    return entry.m_hull;
+}
+
+
+const SHAPE_LINE_CHAIN PNS_SOLID::buildHull( int aClearance, int aWalkaroundThickness ) const
 {
     int cl = aClearance + ( aWalkaroundThickness + 1 )/ 2;
 
@@ -23,6 +23,8 @@
 
 #include <math/vector2d.h>
 
+#include <vector>
+
 #include <geometry/seg.h>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
@@ -58,6 +60,12 @@ public:
 
     const SHAPE* Shape() const { return m_shape; }
 
+    /**
+     * Function Hull()
+     * returns the hull of the solid.  The hulls are cached per clearance and walkaround
+     * thickness: the solids do not move, and the same hulls are requested on each shove
+     * and walkaround step.
+     */
     const SHAPE_LINE_CHAIN Hull( int aClearance = 0, int aWalkaroundThickness = 0 ) const;
 
     void SetShape( SHAPE* shape )
@@ -66,6 +74,7 @@ public:
             delete m_shape;
 
         m_shape = shape;
+        m_hulls.clear();
     }
 
     const VECTOR2I& Pos() const
@@ -99,9 +108,21 @@ public:
     }
 
 private:
+    struct CACHED_HULL
+    {
+        int                 m_clearance;
+        int                 m_walkaroundThickness;
+        SHAPE_LINE_CHAIN    m_hull;
+    };
+
+    const SHAPE_LINE_CHAIN buildHull( int aClearance, int aWalkaroundThickness ) const;
+
     VECTOR2I    m_pos;
     SHAPE*      m_shape;
     VECTOR2I    m_offset;
+
+    ///> the hulls built by Hull(), the oldest first
+    mutable std::vector<CACHED_HULL> m_hulls;
 };
 
 #endif
@@ -90,20 +90,31 @@ PNS_TOOL_BASE::~PNS_TOOL_BASE()
 
 void PNS_TOOL_BASE::Reset( RESET_REASON aReason )
 {
-    if( m_router )
+    BOARD* board = getModel<BOARD>();
+
+    // a tool invoked again on the same board keeps its router: the world of the router
+    // is only updated with the items changed since the previous session.
+    if( m_router && ( aReason != RUN || board != m_board ) )
+    {
         delete m_router;
+        m_router = NULL;
+    }
 
     if( m_gridHelper)
         delete m_gridHelper;
 
     m_frame = getEditFrame<PCB_EDIT_FRAME>();
     m_ctls = getViewControls();
-    m_board = getModel<BOARD>();
+    m_board = board;
 
-    m_router = new PNS_ROUTER;
+    if( !m_router )
+    {
+        m_router = new PNS_ROUTER;
+
+        m_router->ClearWorld();
+        m_router->SetBoard( m_board );
+    }
 
-    m_router->ClearWorld();
-    m_router->SetBoard( m_board );
     m_router->SyncWorld();
     m_router->LoadSettings( m_savedSettings );
     m_router->UpdateSizes( m_savedSizes );
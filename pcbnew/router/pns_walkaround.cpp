@@ -18,6 +18,9 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <climits>
+
 #include <boost/foreach.hpp>
 #include <boost/optional.hpp>
 
@@ -31,7 +34,6 @@ using boost::optional;
 
 void PNS_WALKAROUND::start( const PNS_LINE& aInitialPath )
 {
-    m_iteration = 0;
     m_iterationLimit = 50;
 }
 
@@ -51,12 +53,15 @@ PNS_NODE::OPT_OBSTACLE PNS_WALKAROUND::nearestObstacle( const PNS_LINE& aPath )
 
 
 PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::singleStep( PNS_LINE& aPath,
-                                                              bool aWindingDirection )
+                                                              bool aWindingDirection,
+                                                              int aIteration )
 {
     optional<PNS_OBSTACLE>& current_obs =
         aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
 
     bool& prev_recursive = aWindingDirection ? m_recursiveCollision[0] : m_recursiveCollision[1];
+    int& blockage_count =
+        aWindingDirection ? m_recursiveBlockageCount[0] : m_recursiveBlockageCount[1];
 
     if( !current_obs )
         return DONE;
@@ -67,9 +72,9 @@ PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::singleStep( PNS_LINE& aPath,
 
     if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
     {
-        m_recursiveBlockageCount++;
+        blockage_count++;
 
-        if( m_recursiveBlockageCount < 3 )
+        if( blockage_count < 3 )
             aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
         else
         {
@@ -84,7 +89,7 @@ PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::singleStep( PNS_LINE& aPath,
                       path_post[1], !aWindingDirection );
 
 #ifdef DEBUG
-    m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+    m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", aIteration );
     m_logger.Log( &path_walk[0], 0, "path-walk" );
     m_logger.Log( &path_pre[0], 1, "path-pre" );
     m_logger.Log( &path_post[0], 4, "path-post" );
@@ -140,6 +145,42 @@ PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::singleStep( PNS_LINE& aPath,
 }
 
 
+PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::walk( PNS_LINE& aPath,
+        bool aWindingDirection, WALKAROUND_STATUS aStatus, int& aDoneIteration,
+        volatile int& aStopIteration )
+{
+    aDoneIteration = INT_MAX;
+
+    if( aStatus == STUCK )
+        return STUCK;
+
+    // Once a direction is done (and a shorter path is wanted), the other one is only
+    // useful until the same iteration, where it could be done with a shorter path
+    for( int iteration = 0; iteration < m_iterationLimit && iteration <= aStopIteration;
+         iteration++ )
+    {
+        aStatus = singleStep( aPath, aWindingDirection, iteration );
+
+        if( aStatus == DONE )
+        {
+            aDoneIteration = iteration;
+
+            if( !m_forceLongerPath )
+            {
+#ifdef USE_OPENMP
+                #pragma omp critical( walkaroundStop )
+#endif
+                aStopIteration = std::min( (int) aStopIteration, iteration );
+            }
+
+            break;
+        }
+    }
+
+    return aStatus;
+}
+
+
 PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::Route( const PNS_LINE& aInitialPath,
         PNS_LINE& aWalkPath, bool aOptimize )
 {
@@ -160,7 +201,7 @@ PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::Route( const PNS_LINE& aInitia
     start( aInitialPath );
 
     m_currentObstacle[0] = m_currentObstacle[1] = nearestObstacle( aInitialPath );
-    m_recursiveBlockageCount = 0;
+    m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
 
     aWalkPath = aInitialPath;
 
@@ -173,51 +214,41 @@ PNS_WALKAROUND::WALKAROUND_STATUS PNS_WALKAROUND::Route( const PNS_LINE& aInitia
         m_forceSingleDirection = false;
     }
 
-    while( m_iteration < m_iterationLimit )
-    {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
-
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
-
-        if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
-        {
-            int len_cw  = path_cw.CLine().Length();
-            int len_ccw = path_ccw.CLine().Length();
-
-            if( m_forceLongerPath )
-                aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
-            else
-                aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
+    // The two directions do not depend on each other, and only read the world, so they
+    // are walked at the same time.  The logger is not thread safe.
+    int             done_cw, done_ccw;
+    volatile int    stop_iteration = m_iterationLimit;
 
-            break;
-        }
-        else if( s_cw == DONE && !m_forceLongerPath )
-        {
-            aWalkPath = path_cw;
-            break;
-        }
-        else if( s_ccw == DONE && !m_forceLongerPath )
-        {
-            aWalkPath = path_ccw;
-            break;
-        }
-
-        m_iteration++;
-    }
-
-    if( m_iteration == m_iterationLimit )
+#if defined( USE_OPENMP ) && !defined( DEBUG )
+    #pragma omp parallel sections num_threads( 2 )
+#endif
     {
-        int len_cw  = path_cw.CLine().Length();
-        int len_ccw = path_ccw.CLine().Length();
+#if defined( USE_OPENMP ) && !defined( DEBUG )
+        #pragma omp section
+#endif
+        s_cw = walk( path_cw, true, s_cw, done_cw, stop_iteration );
 
-        if( m_forceLongerPath )
-            aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
-        else
-            aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
+#if defined( USE_OPENMP ) && !defined( DEBUG )
+        #pragma omp section
+#endif
+        s_ccw = walk( path_ccw, false, s_ccw, done_ccw, stop_iteration );
     }
 
+    int len_cw  = path_cw.CLine().Length();
+    int len_ccw = path_ccw.CLine().Length();
+
+    // Pick the path the directions walked one step after the other would give: the
+    // first done (the shortest if both are done at the same iteration), or when a
+    // longer path is wanted or none is done, the longest or the shortest one.
+    if( m_forceLongerPath )
+        aWalkPath = ( len_cw > len_ccw ? path_cw : path_ccw );
+    else if( done_cw < done_ccw )
+        aWalkPath = path_cw;
+    else if( done_ccw < done_cw )
+        aWalkPath = path_ccw;
+    else
+        aWalkPath = ( len_cw < len_ccw ? path_cw : path_ccw );
+
     if( m_cursorApproachMode )
     {
         // int len_cw = path_cw.GetCLine().Length();
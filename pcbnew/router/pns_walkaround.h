@@ -46,9 +46,8 @@ public:
         m_itemMask = PNS_ITEM::ANY;
 
         // Initialize other members, to avoid uninitialized variables.
-        m_recursiveBlockageCount = 0;
+        m_recursiveBlockageCount[0] = m_recursiveBlockageCount[1] = 0;
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
-        m_iteration = 0;
         m_forceCw = false;
     }
 
@@ -126,13 +125,18 @@ public:
 private:
     void start( const PNS_LINE& aInitialPath );
 
-    WALKAROUND_STATUS singleStep( PNS_LINE& aPath, bool aWindingDirection );
+    WALKAROUND_STATUS singleStep( PNS_LINE& aPath, bool aWindingDirection, int aIteration );
+
+    ///> walks aPath around the obstacles in one direction, until it is done or
+    ///> the iteration limit or aStopIteration is reached.  aDoneIteration is set to
+    ///> the iteration where the path was done, or INT_MAX.
+    WALKAROUND_STATUS walk( PNS_LINE& aPath, bool aWindingDirection, WALKAROUND_STATUS aStatus,
+                            int& aDoneIteration, volatile int& aStopIteration );
     PNS_NODE::OPT_OBSTACLE nearestObstacle( const PNS_LINE& aPath );
 
     PNS_NODE* m_world;
 
-    int m_recursiveBlockageCount;
-    int m_iteration;
+    int m_recursiveBlockageCount[2];
     int m_iterationLimit;
     int m_itemMask;
     bool m_forceSingleDirection, m_forceLongerPath;
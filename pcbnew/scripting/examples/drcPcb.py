@@ -0,0 +1,23 @@
+#!/usr/bin/env python
+#
+# Runs the DRC on a board without the GUI, for batch or CI use:
+#   drcPcb.py board.kicad_pcb report.json
+# The report format depends on its extension (.json, .csv, or text).
+# The exit code is 0 when the board passes, 1 on DRC errors, 2 on failure.
+import sys
+from pcbnew import *
+
+filename=sys.argv[1]
+reportname=sys.argv[2]
+
+pcb = LoadBoard(filename)
+
+errors = RunDRC(pcb, reportname)
+
+if errors < 0:
+    print "Cannot write the report file %s" % reportname
+    sys.exit(2)
+
+print "%d DRC errors and unconnected items found, see %s" % (errors, reportname)
+
+sys.exit(1 if errors else 0)
@@ -0,0 +1,40 @@
+#!/usr/bin/env python
+#
+# Lists the routed length of the nets of a board, for the length matching reviews:
+#   listNetLengths.py board.kicad_pcb [net name pattern]
+# The lengths are in mm, a via being as long as the board thickness it crosses.
+import sys
+import fnmatch
+from pcbnew import *
+
+filename=sys.argv[1]
+pattern=sys.argv[2] if len(sys.argv) > 2 else "*"
+
+pcb = LoadBoard(filename)
+
+# The lengths are long integers, which ToMM() does not take
+def ToLengthMM(iu):
+    return float(iu) / float(IU_PER_MM)
+
+# All the nets are measured in one pass over the tracks
+lengths = pcb.GetNetLengths()
+
+print "%-30s %6s %10s  %s" % ("net", "vias", "length", "per layer")
+
+for netcode in range(1, pcb.GetNetCount()):
+    net = pcb.GetNetInfo().GetNetItem(netcode)
+
+    if not fnmatch.fnmatch(net.GetNetname(), pattern):
+        continue
+
+    length = lengths.GetNet(netcode)
+
+    layers = []
+
+    for layer in range(F_Cu, B_Cu + 1):
+        if length.GetLayerLength(layer) > 0:
+            layers.append("%s %.3f" % (pcb.GetLayerName(layer),
+                                       ToLengthMM(length.GetLayerLength(layer))))
+
+    print "%-30s %6d %10.3f  %s" % (net.GetNetname(), length.m_ViaCount,
+                                     ToLengthMM(length.GetTotalLength()), ", ".join(layers))
@@ -53,10 +53,8 @@
 %rename(RemoveChild) MODULE::Remove;
 %rename(DeleteChild) MODULE::Delete;
 
-%exception {
-    try{
-        $action
-    }
+// the C++ exceptions are turned into Python exceptions by all the wrappers
+%define KICAD_CATCH_EXCEPTIONS
     catch( IO_ERROR e )
     {
         std::string str = TO_UTF8( e.errorText );
@@ -75,7 +73,47 @@
     {
         SWIG_fail;
     }
+%enddef
+
+%exception {
+    try{
+        $action
+    }
+    KICAD_CATCH_EXCEPTIONS
 }
+
+// The long running calls release the GIL, so that other Python threads run meanwhile,
+// e.g. to load, plot and fill the zones of several boards at once.  They only use the
+// C++ objects given as arguments, which are converted before and after the GIL is
+// released.  Loading, saving, plotting, generating the drill files, testing the DRC
+// and filling the zones can run concurrently on distinct BOARDs, provided that each
+// BOARD (and its PLOT_CONTROLLER or EXCELLON_WRITER) is used by one thread at a time.
+// The board of the editor, returned by GetBoard(), must only be used from the thread
+// of the editor.
+%define KICAD_RELEASE_GIL( function )
+%exception function {
+    try{
+        PYTHON_GIL_RELEASER releaser;
+        $action
+    }
+    KICAD_CATCH_EXCEPTIONS
+}
+%enddef
+
+KICAD_RELEASE_GIL( LoadBoard )
+KICAD_RELEASE_GIL( SaveBoard )
+KICAD_RELEASE_GIL( RunDRC )
+KICAD_RELEASE_GIL( IO_MGR::Load )
+KICAD_RELEASE_GIL( IO_MGR::Save )
+KICAD_RELEASE_GIL( PLOT_CONTROLLER::OpenPlotfile )
+KICAD_RELEASE_GIL( PLOT_CONTROLLER::PlotLayer )
+KICAD_RELEASE_GIL( PLOT_CONTROLLER::ClosePlot )
+KICAD_RELEASE_GIL( EXCELLON_WRITER::CreateDrillandMapFilesSet )
+KICAD_RELEASE_GIL( EXCELLON_WRITER::GenDrillReportFile )
+KICAD_RELEASE_GIL( EXCELLON_WRITER::GenDrillMapFile )
+KICAD_RELEASE_GIL( ZONE_CONTAINER::BuildFilledSolidAreasPolygons )
+KICAD_RELEASE_GIL( ZONE_CONTAINER::FillZoneAreasWithSegments )
+
 %include exception.i
 
 
@@ -106,6 +144,7 @@
   #include <class_zone_settings.h>
   #include <class_netclass.h>
   #include <class_netinfo.h>
+  #include <net_lengths.h>
   #include <pcbnew_scripting_helpers.h>
 
   #include <plotcontroller.h>
@@ -114,6 +153,17 @@
   #include <colors.h>
 
   BOARD *GetBoard(); /* get current editor board */
+
+  // Releases the GIL for its lifetime, and takes it back even when an exception is thrown
+  class PYTHON_GIL_RELEASER
+  {
+  public:
+      PYTHON_GIL_RELEASER() : m_state( PyEval_SaveThread() ) {}
+      ~PYTHON_GIL_RELEASER() { PyEval_RestoreThread( m_state ); }
+
+  private:
+      PyThreadState* m_state;
+  };
 %}
 
 
@@ -145,6 +195,7 @@
 %include <class_zone_settings.h>
 %include <class_netclass.h>
 %include <class_netinfo.h>
+%include <net_lengths.h>
 
 %include <plotcontroller.h>
 %include <pcb_plot_params.h>
@@ -34,6 +34,8 @@
 #include <pcbnew_id.h>
 #include <build_version.h>
 #include <class_board.h>
+#include <class_track.h>
+#include <drc_stuff.h>
 #include <kicad_string.h>
 #include <io_mgr.h>
 #include <macros.h>
@@ -107,3 +109,89 @@ bool SaveBoard( wxString& aFileName, BOARD* aBoard,
 #endif
     return true;
 }
+
+
+int RunDRC( BOARD* aBoard, wxString& aReportFileName )
+{
+    DRC drc( aBoard );
+
+    aBoard->DeleteMARKERs();
+    drc.RunTests();
+
+    if( !drc.WriteReport( aReportFileName ) )
+        return -1;
+
+    return aBoard->GetMARKERCount() + drc.GetUnconnectedCount();
+}
+
+
+PyObject* GetTrackData( BOARD* aBoard )
+{
+    Py_ssize_t size = (Py_ssize_t) aBoard->m_Track.GetCount()
+                      * TRACK_DATA_FIELD_COUNT * sizeof( int32_t );
+    PyObject*  data = PyByteArray_FromStringAndSize( NULL, size );
+
+    if( !data )
+        return NULL;
+
+    int32_t* record = (int32_t*) PyByteArray_AS_STRING( data );
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        record[TRACK_DATA_START_X]  = track->GetStart().x;
+        record[TRACK_DATA_START_Y]  = track->GetStart().y;
+        record[TRACK_DATA_END_X]    = track->GetEnd().x;
+        record[TRACK_DATA_END_Y]    = track->GetEnd().y;
+        record[TRACK_DATA_WIDTH]    = track->GetWidth();
+        record[TRACK_DATA_LAYER]    = track->GetLayer();
+        record[TRACK_DATA_NETCODE]  = track->GetNetCode();
+        record[TRACK_DATA_IS_VIA]   = track->Type() == PCB_VIA_T;
+
+        record += TRACK_DATA_FIELD_COUNT;
+    }
+
+    return data;
+}
+
+
+bool SetTrackData( BOARD* aBoard, PyObject* aData )
+{
+    Py_buffer view;
+
+    if( PyObject_GetBuffer( aData, &view, PyBUF_SIMPLE ) < 0 )
+    {
+        PyErr_Clear();
+        return false;
+    }
+
+    Py_ssize_t size = (Py_ssize_t) aBoard->m_Track.GetCount()
+                      * TRACK_DATA_FIELD_COUNT * sizeof( int32_t );
+
+    if( view.len != size )
+    {
+        PyBuffer_Release( &view );
+        return false;
+    }
+
+    const int32_t* record = (const int32_t*) view.buf;
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        track->SetStart( wxPoint( record[TRACK_DATA_START_X], record[TRACK_DATA_START_Y] ) );
+        track->SetEnd( wxPoint( record[TRACK_DATA_END_X], record[TRACK_DATA_END_Y] ) );
+        track->SetWidth( record[TRACK_DATA_WIDTH] );
+        track->SetNetCode( record[TRACK_DATA_NETCODE], true );
+
+        if( track->Type() != PCB_VIA_T )
+            track->SetLayer( (LAYER_ID) record[TRACK_DATA_LAYER] );
+
+        record += TRACK_DATA_FIELD_COUNT;
+    }
+
+    PyBuffer_Release( &view );
+
+    // the connections of the tracks are rebuilt when needed
+    aBoard->m_Status_Pcb = 0;
+
+    return true;
+}
@@ -25,6 +25,8 @@
 #ifndef __PCBNEW_SCRIPTING_HELPERS_H
 #define __PCBNEW_SCRIPTING_HELPERS_H
 
+#include <Python.h>
+
 #include <wxPcbStruct.h>
 #include <io_mgr.h>
 /* we could be including all these methods as static in a class, but
@@ -43,5 +45,51 @@ BOARD*  LoadBoard( wxString& aFileName );
 bool    SaveBoard( wxString& aFileName, BOARD* aBoard, IO_MGR::PCB_FILE_T aFormat );
 bool    SaveBoard( wxString& aFileName, BOARD* aBoard );
 
+/**
+ * Function RunDRC
+ * runs all the DRC tests on aBoard without a frame, and writes the report.
+ * The existing markers of aBoard are deleted first, and the new ones are added to it.
+ * @param aBoard is the board to test.
+ * @param aReportFileName is the report file: a .json or .csv extension selects a
+ *                        machine readable format, other names get the text report.
+ * @return the number of DRC errors and unconnected items found, or -1 if the report
+ *         cannot be written.
+ */
+int     RunDRC( BOARD* aBoard, wxString& aReportFileName );
+
+/**
+ * The fields of the track records of GetTrackData() and SetTrackData(), each an int32.
+ * A via has its position as start and end, and its top layer as layer.
+ */
+enum TRACK_DATA_FIELD
+{
+    TRACK_DATA_START_X,
+    TRACK_DATA_START_Y,
+    TRACK_DATA_END_X,
+    TRACK_DATA_END_Y,
+    TRACK_DATA_WIDTH,
+    TRACK_DATA_LAYER,
+    TRACK_DATA_NETCODE,
+    TRACK_DATA_IS_VIA,          ///< 1 for a via, read only
+    TRACK_DATA_FIELD_COUNT
+};
+
+/**
+ * Function GetTrackData
+ * returns the tracks and vias of aBoard in one bytearray, TRACK_DATA_FIELD_COUNT
+ * native int32 per item in the order of BOARD::m_Track, without wrapping each item
+ * in a proxy.  With NumPy:
+ *   numpy.frombuffer( GetTrackData( board ), numpy.int32 ).reshape( -1, TRACK_DATA_FIELD_COUNT )
+ */
+PyObject* GetTrackData( BOARD* aBoard );
+
+/**
+ * Function SetTrackData
+ * sets the coordinates, widths, layers and netcodes of all the tracks of aBoard from
+ * aData, any contiguous buffer of records in the layout of GetTrackData(), e.g. a
+ * NumPy int32 array.  The layer of the vias is not changed.
+ * @return false if aData is not a buffer of one record per item of BOARD::m_Track.
+ */
+bool    SetTrackData( BOARD* aBoard, PyObject* aData );
 
 #endif
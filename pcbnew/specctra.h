@@ -31,6 +31,7 @@
 
 //  see http://www.boost.org/libs/ptr_container/doc/ptr_set.html
 #include <boost/ptr_container/ptr_set.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include <fctsys.h>
@@ -44,6 +45,7 @@ class VIA;
 class NETCLASS;
 class MODULE;
 class SHAPE_POLY_SET;
+class PICKED_ITEMS_LIST;
 
 typedef DSN::T  DSN_T;
 
@@ -2094,6 +2096,7 @@ typedef boost::ptr_vector<IMAGE>    IMAGES;
 class PADSTACK : public ELEM_HOLDER
 {
     friend class SPECCTRA_DB;
+    friend class LIBRARY;
 
     std::string     hash;       ///< a hash string used by Compare(), not Format()ed/exported.
 
@@ -2234,12 +2237,54 @@ class LIBRARY : public ELEM
     PADSTACKS       padstacks;      ///< all except vias, which are in 'vias'
     PADSTACKS       vias;
 
+    typedef boost::unordered_map<std::string, int> INDEX;
+
+    /// The images and the vias by their hash, for the lookups of FindIMAGE() and
+    /// FindVia().  The entries appended to the library are indexed by the next lookup.
+    INDEX           imageIndex;
+    INDEX           imageIdCounts;  ///< the number of images of each image_id
+    unsigned        indexedImages;
+    INDEX           viaIndex;
+    unsigned        indexedVias;
+
+    // the key of a via: the padstack id is compared too, see PADSTACK::Compare()
+    static std::string viaKey( PADSTACK* aVia )
+    {
+        if( !aVia->hash.size() )
+            aVia->hash = aVia->makeHash();
+
+        return aVia->hash + '\n' + aVia->padstack_id;
+    }
+
+    void indexImages()
+    {
+        for( ; indexedImages < images.size(); ++indexedImages )
+        {
+            IMAGE* image = &images[indexedImages];
+
+            if( !image->hash.size() )
+                image->hash = image->makeHash();
+
+            // the first of equal images is the one found
+            imageIndex.insert( INDEX::value_type( image->hash, (int) indexedImages ) );
+            ++imageIdCounts[image->image_id];
+        }
+    }
+
+    void indexVias()
+    {
+        for( ; indexedVias < vias.size(); ++indexedVias )
+            viaIndex.insert( INDEX::value_type( viaKey( &vias[indexedVias] ), (int) indexedVias ) );
+    }
+
 public:
 
     LIBRARY( ELEM* aParent, DSN_T aType = T_library ) :
         ELEM( aType, aParent )
     {
         unit = 0;
+        indexedImages = 0;
+        indexedVias = 0;
 //        via_start_index = -1;       // 0 or greater means there is at least one via
     }
     ~LIBRARY()
@@ -2272,21 +2317,22 @@ public:
      */
     int FindIMAGE( IMAGE* aImage )
     {
-        unsigned i;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == IMAGE::Compare( aImage, &images[i] ) )
-                return (int) i;
-        }
+        indexImages();
+
+        if( !aImage->hash.size() )
+            aImage->hash = aImage->makeHash();
+
+        INDEX::const_iterator it = imageIndex.find( aImage->hash );
+
+        if( it != imageIndex.end() )
+            return it->second;
 
         // There is no match to the IMAGE contents, but now generate a unique
         // name for it.
-        int dups = 1;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == aImage->image_id.compare( images[i].image_id ) )
-                aImage->duplicated = dups++;
-        }
+        it = imageIdCounts.find( aImage->image_id );
+
+        if( it != imageIdCounts.end() )
+            aImage->duplicated = it->second;
 
         return -1;
     }
@@ -2328,12 +2374,11 @@ public:
      */
     int FindVia( PADSTACK* aVia )
     {
-        for( unsigned i=0;  i<vias.size();  ++i )
-        {
-            if( 0 == PADSTACK::Compare( aVia, &vias[i] ) )
-                return int( i );
-        }
-        return -1;
+        indexVias();
+
+        INDEX::const_iterator it = viaIndex.find( viaKey( aVia ) );
+
+        return it != viaIndex.end() ? it->second : -1;
     }
 
     /**
@@ -3633,6 +3678,13 @@ class SPECCTRA_DB : public SPECCTRA_LEXER
 
     PADSTACKSET     padstackset;
 
+    typedef boost::unordered_map<std::string, PADSTACK*> PADSTACK_INDEX;
+
+    /// the padstacks of padstackset by the geometry of the pads they are made of, to
+    /// not make again the padstack of a pad like another one, memory for them is not
+    /// owned here.
+    PADSTACK_INDEX  padstackIndex;
+
     /// we don't want ownership here permanently, so we don't use boost::ptr_vector
     std::vector<NET*>   nets;
 
@@ -3835,6 +3887,13 @@ class SPECCTRA_DB : public SPECCTRA_LEXER
     ::VIA* makeVIA( PADSTACK* aPadstack, const POINT& aPoint, int aNetCode, int aViaDrillDefault )
         throw( IO_ERROR );
 
+    /**
+     * Function makeSessionTracks
+     * creates the tracks and vias of the wires of the session routes.
+     * @param aTracks receives the new items, which are not added to aBoard.
+     */
+    void makeSessionTracks( BOARD* aBoard, std::vector<TRACK*>& aTracks ) throw( IO_ERROR );
+
     //-----</FromSESSION>----------------------------------------------------
 
 public:
@@ -3949,9 +4008,15 @@ public:
      * the BOARD given to this function will have all its tracks and via's replaced,
      * and all its components are subject to being moved.
      *
+     * The new tracks and vias are built first, and then replace the old ones at
+     * once, see BOARD::ReplaceTracks().
+     *
      * @param aBoard The BOARD to merge the SESSION information into.
+     * @param aUndoList if not NULL receives the moved components, as UR_CHANGED
+     *                  with their previous state, the old tracks and vias, as
+     *                  UR_DELETED, and the new ones, as UR_NEW.
      */
-    void FromSESSION( BOARD* aBoard ) throw( IO_ERROR );
+    void FromSESSION( BOARD* aBoard, PICKED_ITEMS_LIST* aUndoList = NULL ) throw( IO_ERROR );
 
     /**
      * Function ExportSESSION
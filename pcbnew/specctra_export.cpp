@@ -652,6 +652,24 @@ PADSTACK* SPECCTRA_DB::makePADSTACK( BOARD* aBoard, D_PAD* aPad )
 }
 
 
+/**
+ * Function padstackKey
+ * returns a key of the pad properties used by makePADSTACK(): the pads of equal
+ * keys have the same padstack.
+ */
+static std::string padstackKey( D_PAD* aPad )
+{
+    char key[128];
+
+    snprintf( key, sizeof(key), "%d %d %d %d %d %d %d %lx", aPad->GetShape(),
+              aPad->GetSize().x, aPad->GetSize().y, aPad->GetOffset().x, aPad->GetOffset().y,
+              aPad->GetDelta().x, aPad->GetDelta().y,
+              ( aPad->GetLayerSet() & LSET::AllCuMask() ).to_ulong() );
+
+    return key;
+}
+
+
 /// data type used to ensure unique-ness of pin names, holding (wxString and int)
 typedef std::map<wxString, int> PINMAP;
 
@@ -701,18 +719,32 @@ IMAGE* SPECCTRA_DB::makeIMAGE( BOARD* aBoard, MODULE* aModule )
 
         else
         {
-            PADSTACK*               padstack = makePADSTACK( aBoard, pad );
-            PADSTACKSET::iterator   iter = padstackset.find( *padstack );
+            std::string                 key = padstackKey( pad );
+            PADSTACK_INDEX::iterator    found = padstackIndex.find( key );
+            PADSTACK*                   padstack;
 
-            if( iter != padstackset.end() )
+            if( found != padstackIndex.end() )
             {
-                // padstack is a duplicate, delete it and use the original
-                delete padstack;
-                padstack = (PADSTACK*) *iter.base();    // folklore, be careful here
+                padstack = found->second;
             }
             else
             {
-                padstackset.insert( padstack );
+                padstack = makePADSTACK( aBoard, pad );
+
+                PADSTACKSET::iterator   iter = padstackset.find( *padstack );
+
+                if( iter != padstackset.end() )
+                {
+                    // padstack is a duplicate, delete it and use the original
+                    delete padstack;
+                    padstack = (PADSTACK*) *iter.base();    // folklore, be careful here
+                }
+                else
+                {
+                    padstackset.insert( padstack );
+                }
+
+                padstackIndex[key] = padstack;
             }
 
             PIN* pin = new PIN( image );
@@ -1808,6 +1840,7 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
         items.Collect( aBoard, scanMODULEs );
 
         padstackset.clear();
+        padstackIndex.clear();
 
         for( int m = 0; m<items.GetCount(); ++m )
         {
@@ -1888,6 +1921,8 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
             pcb->library->AddPadstack( padstack );
         }
 
+        padstackIndex.clear();
+
         // copy our SPECCTRA_DB::nets to the pcb->network
         for( unsigned n = 1; n<nets.size(); ++n )
         {
@@ -2060,6 +2095,9 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
 
         items.Collect( aBoard, scanVIAs );
 
+        // the registered padstacks by via size, drill and layers, made once
+        PADSTACK_INDEX  viaPadstacks;
+
         for( int i = 0; i<items.GetCount(); ++i )
         {
             ::VIA* via = (::VIA*) items[i];
@@ -2070,14 +2108,28 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
             if( netcode == 0 )
                 continue;
 
-            PADSTACK*   padstack    = makeVia( via );
-            PADSTACK*   registered  = pcb->library->LookupVia( padstack );
+            LAYER_ID    topLayer;
+            LAYER_ID    botLayer;
+            char        key[64];
 
-            // if the one looked up is not our padstack, then delete our padstack
-            // since it was a duplicate of one already registered.
-            if( padstack != registered )
+            via->LayerPair( &topLayer, &botLayer );
+            snprintf( key, sizeof(key), "%d %d %d %d", via->GetWidth(), via->GetDrillValue(),
+                      topLayer, botLayer );
+
+            PADSTACK*&  registered = viaPadstacks[key];
+
+            if( !registered )
             {
-                delete padstack;
+                PADSTACK*   padstack = makeVia( via );
+
+                registered = pcb->library->LookupVia( padstack );
+
+                // if the one looked up is not our padstack, then delete our padstack
+                // since it was a duplicate of one already registered.
+                if( padstack != registered )
+                {
+                    delete padstack;
+                }
             }
 
             WIRE_VIA* dsnVia = new WIRE_VIA( pcb->wiring );
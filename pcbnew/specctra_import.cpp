@@ -32,11 +32,14 @@
 */
 
 
+#include <set>
+
 #include <class_drawpanel.h>    // m_canvas
 #include <confirm.h>            // DisplayError()
 #include <gestfich.h>           // EDA_FileSelector()
 #include <wxPcbStruct.h>
 #include <macros.h>
+#include <class_undoredo_container.h>
 
 #include <class_board.h>
 #include <class_module.h>
@@ -93,16 +96,19 @@ void PCB_EDIT_FRAME::ImportSpecctraSession( wxCommandEvent& event )
     if( fullFileName == wxEmptyString )
         return;
 
-    SPECCTRA_DB     db;
-    LOCALE_IO       toggle;
+    SPECCTRA_DB         db;
+    LOCALE_IO           toggle;
+    PICKED_ITEMS_LIST   undoList;
 
     try
     {
         db.LoadSESSION( fullFileName );
-        db.FromSESSION( GetBoard() );
+        db.FromSESSION( GetBoard(), &undoList );
     }
     catch( const IO_ERROR& ioe )
     {
+        undoList.ClearListAndDeleteItems();
+
         wxString msg = ioe.errorText;
         msg += '\n';
         msg += _("BOARD may be corrupted, do not save it.");
@@ -113,17 +119,15 @@ void PCB_EDIT_FRAME::ImportSpecctraSession( wxCommandEvent& event )
         return;
     }
 
+    // The whole import is a single undo command
+    SaveCopyInUndoList( undoList, UR_UNSPECIFIED );
+    undoList.ClearItemsList();
+
     OnModify();
     GetBoard()->m_Status_Pcb = 0;
 
-    /* At this point we should call Compile_Ratsnest()
-     * but this could be time consumming.
-     * So if incorrect number of Connected and No connected pads is accepted
-     * until Compile_Ratsnest() is called (when track tool selected for instance)
-     * leave the next line commented
-     * Otherwise uncomment this line
-    */
-    //Compile_Ratsnest( NULL, true );
+    // The tracks are all added at once, the connectivity is built once for them
+    Compile_Ratsnest( NULL, true );
 
     SetStatusText( wxString( _( "Session file imported and merged OK." ) ) );
 
@@ -351,7 +355,7 @@ TRACK* SPECCTRA_DB::makeTRACK( PATH* aPath, int aPointIndex, int aNetcode ) thro
 // no UI code in this function, throw exception to report problems to the
 // UI handler: void PCB_EDIT_FRAME::ImportSpecctraSession( wxCommandEvent& event )
 
-void SPECCTRA_DB::FromSESSION( BOARD* aBoard ) throw( IO_ERROR )
+void SPECCTRA_DB::FromSESSION( BOARD* aBoard, PICKED_ITEMS_LIST* aUndoList ) throw( IO_ERROR )
 {
     sessionBoard = aBoard;      // not owned here
 
@@ -369,13 +373,13 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard ) throw( IO_ERROR )
     if( !session->route->library )
         THROW_IO_ERROR( _("Session file is missing the \"library_out\" section") );
 
-    // delete all the old tracks and vias
-    aBoard->m_Track.DeleteAll();
-
+    // the old tracks and vias are replaced once the new ones are built
     aBoard->DeleteMARKERs();
 
     buildLayerMaps( aBoard );
 
+    std::set<MODULE*>   movedModules;
+
     if( session->placement )
     {
         // Walk the PLACEMENT object's COMPONENTs list, and for each PLACE within
@@ -400,6 +404,15 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard ) throw( IO_ERROR )
                 if( !place->hasVertex )
                     continue;
 
+                // the state of a component before its first move
+                if( aUndoList && movedModules.insert( module ).second )
+                {
+                    ITEM_PICKER picker( module, UR_CHANGED );
+
+                    picker.SetLink( module->Clone() );
+                    aUndoList->PushItem( picker );
+                }
+
                 UNIT_RES* resolution = place->GetUnits();
                 wxASSERT( resolution );
 
@@ -442,6 +455,39 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard ) throw( IO_ERROR )
 
     routeResolution = session->route->GetUnits();
 
+    // the new tracks and vias, owned here until they replace the old ones
+    std::vector<TRACK*> tracks;
+
+    try
+    {
+        makeSessionTracks( aBoard, tracks );
+    }
+    catch( ... )
+    {
+        for( unsigned i = 0; i < tracks.size(); ++i )
+            delete tracks[i];
+
+        throw;
+    }
+
+    std::vector<TRACK*> oldTracks;
+
+    aBoard->ReplaceTracks( tracks, aUndoList ? &oldTracks : NULL );
+
+    if( aUndoList )
+    {
+        for( unsigned i = 0; i < oldTracks.size(); ++i )
+            aUndoList->PushItem( ITEM_PICKER( oldTracks[i], UR_DELETED ) );
+
+        for( unsigned i = 0; i < tracks.size(); ++i )
+            aUndoList->PushItem( ITEM_PICKER( tracks[i], UR_NEW ) );
+    }
+}
+
+
+void SPECCTRA_DB::makeSessionTracks( BOARD* aBoard, std::vector<TRACK*>& aTracks )
+        throw( IO_ERROR )
+{
     // Walk the NET_OUTs and create tracks and vias anew.
     NET_OUTS& net_outs = session->route->net_outs;
     for( NET_OUTS::iterator net = net_outs.begin(); net!=net_outs.end(); ++net )
@@ -496,8 +542,7 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard ) throw( IO_ERROR )
                     }
                     */
 
-                    TRACK* track = makeTRACK( path, pt, netoutCode );
-                    aBoard->Add( track );
+                    aTracks.push_back( makeTRACK( path, pt, netoutCode ) );
                 }
             }
         }
@@ -550,8 +595,8 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard ) throw( IO_ERROR )
 
             for( unsigned v=0;  v<wire_via->vertexes.size();  ++v )
             {
-                ::VIA* via = makeVIA( padstack, wire_via->vertexes[v], netCode, via_drill_default );
-                aBoard->Add( via );
+                aTracks.push_back( makeVIA( padstack, wire_via->vertexes[v], netCode,
+                                            via_drill_default ) );
             }
         }
     }
@@ -48,8 +48,6 @@
 
 #include <wx/wupdlock.h>
 
-extern bool IsWxPythonLoaded();
-
 #define SEL_LAYER_HELP _( \
         "Show active layer selections\nand select layer pair for route and place via" )
 
@@ -301,17 +299,14 @@ void PCB_EDIT_FRAME::ReCreateHToolbar()
                             KiBitmap( web_support_xpm ),
                             _( "Fast access to the FreeROUTE external advanced router" ) );
 
-    // Access to the scripting console
+    // Access to the scripting console, started once the frame is shown
 #if defined(KICAD_SCRIPTING_WXPYTHON)
-    if( IsWxPythonLoaded() )
-    {
-        m_mainToolBar->AddSeparator();
+    m_mainToolBar->AddSeparator();
 
-        m_mainToolBar->AddTool( ID_TOOLBARH_PCB_SCRIPTING_CONSOLE, wxEmptyString,
-                                KiBitmap( py_script_xpm ),
-                                _( "Show/Hide the Python Scripting console" ),
-                                wxITEM_CHECK );
-    }
+    m_mainToolBar->AddTool( ID_TOOLBARH_PCB_SCRIPTING_CONSOLE, wxEmptyString,
+                            KiBitmap( py_script_xpm ),
+                            _( "Show/Hide the Python Scripting console" ),
+                            wxITEM_CHECK );
 #endif
 
     // after adding the buttons to the toolbar, must call Realize() to reflect the changes
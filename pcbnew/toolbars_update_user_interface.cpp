@@ -140,6 +140,17 @@ void PCB_EDIT_FRAME::OnUpdateDrcEnable( wxUpdateUIEvent& aEvent )
                                         _( "Enable design rule checking" ) );
 }
 
+
+void PCB_EDIT_FRAME::OnUpdateOnlineDrc( wxUpdateUIEvent& aEvent )
+{
+    aEvent.Check( m_drc->OnlineTestsEnabled() );
+}
+
+void PCB_EDIT_FRAME::OnUpdateIncrementalSave( wxUpdateUIEvent& aEvent )
+{
+    aEvent.Check( m_incrementalSave );
+}
+
 void PCB_EDIT_FRAME::OnUpdateShowBoardRatsnest( wxUpdateUIEvent& aEvent )
 {
     aEvent.Check( GetBoard()->IsElementVisible( RATSNEST_VISIBLE ) );
@@ -513,6 +513,9 @@ int DRAWING_TOOL::PlaceDXF( const TOOL_EVENT& aEvent )
 
         else if( evt->IsClick( BUT_LEFT ) )
         {
+            // The placed items are added to the view at once, see VIEW::AddItems()
+            std::vector<KIGFX::VIEW_ITEM*> placed;
+
             // Place the drawing
             if( m_editModules )
             {
@@ -553,7 +556,7 @@ int DRAWING_TOOL::PlaceDXF( const TOOL_EVENT& aEvent )
                     if( converted )
                     {
                         m_board->m_Modules->Add( converted );
-                        m_view->Add( converted );
+                        placed.push_back( converted );
                     }
                 }
             }
@@ -569,12 +572,14 @@ int DRAWING_TOOL::PlaceDXF( const TOOL_EVENT& aEvent )
                     ITEM_PICKER itemWrapper( item, UR_NEW );
                     picklist.PushItem( itemWrapper );
 
-                    m_view->Add( item );
+                    placed.push_back( item );
                 }
 
                 m_frame->SaveCopyInUndoList( picklist, UR_NEW );
             }
 
+            m_view->AddItems( placed );
+
             m_frame->OnModify();
             break;
         }
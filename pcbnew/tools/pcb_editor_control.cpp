@@ -511,21 +511,41 @@ int PCB_EDITOR_CONTROL::ZoneFill( const TOOL_EVENT& aEvent )
 }
 
 
+// The job of ZoneFillAll(), filling the zones on the threads of the pool
+static void fillZonesJob( BOARD* aBoard, const std::vector<ZONE_CONTAINER*>* aZones,
+                          PROGRESS_REPORTER& aReporter )
+{
+    aBoard->FillZones( *aZones, &aReporter );
+}
+
+
 int PCB_EDITOR_CONTROL::ZoneFillAll( const TOOL_EVENT& aEvent )
 {
     BOARD* board = getModel<BOARD>();
     RN_DATA* ratsnest = board->GetRatsnest();
+    std::vector<ZONE_CONTAINER*> zones;
 
     for( int i = 0; i < board->GetAreaCount(); ++i )
+        zones.push_back( board->GetArea( i ) );
+
+    // The views and the ratsnest are not thread safe, they are updated once the fill ended.
+    // A cancelled fill leaves the zones not reached yet with their previous filled areas.
+    RunInBackground( boost::bind( fillZonesJob, board, &zones, _1 ), _( "Fill All Zones" ),
+                     zones.size() );
+
+    for( unsigned i = 0; i < zones.size(); ++i )
     {
-        ZONE_CONTAINER* zone = board->GetArea( i );
-        m_frame->Fill_Zone( zone );
-        zone->SetIsFilled( true );
+        ZONE_CONTAINER* zone = zones[i];
+
+        if( zone->GetIsKeepout() )
+            continue;
+
         ratsnest->Update( zone );
         zone->ViewUpdate();
     }
 
     ratsnest->Recalculate();
+    m_frame->OnModify();
 
     return 0;
 }
@@ -753,16 +773,38 @@ static bool highlightNet( TOOL_MANAGER* aToolMgr, const VECTOR2D& aPosition )
     GENERAL_COLLECTORS_GUIDE guide = static_cast<PCB_BASE_FRAME*>( aToolMgr->GetEditFrame() )->GetCollectorsGuide();
     BOARD* board = static_cast<BOARD*>( aToolMgr->GetModel() );
     GENERAL_COLLECTOR collector;
-    int net = -1;
+    KIGFX::VIEW* view = aToolMgr->GetView();
+    std::vector<KIGFX::VIEW_ITEM*> shown;
+    BOARD_CONNECTED_ITEM* item = NULL;
+
+    // The connected item seen under the cursor, if the view can pick it
+    if( view->Pick( view->ToScreen( aPosition ), 0, shown ) )
+    {
+        for( unsigned i = 0; i < shown.size() && !item; ++i )
+        {
+            BOARD_ITEM* boardItem = dynamic_cast<BOARD_ITEM*>( shown[i] );
+
+            if( boardItem && boardItem->IsConnected() )
+                item = static_cast<BOARD_CONNECTED_ITEM*>( boardItem );
+        }
+    }
+
+    // Else find a connected item for which we are going to highlight a net
+    if( !item )
+    {
+        collector.Collect( board, GENERAL_COLLECTOR::PadsTracksOrZones,
+                           wxPoint( aPosition.x, aPosition.y ), guide );
 
-    // Find a connected item for which we are going to highlight a net
-    collector.Collect( board, GENERAL_COLLECTOR::PadsTracksOrZones,
-                       wxPoint( aPosition.x, aPosition.y ), guide );
-    bool enableHighlight = ( collector.GetCount() > 0 );
+        if( collector.GetCount() > 0 )
+            item = static_cast<BOARD_CONNECTED_ITEM*>( collector[0] );
+    }
+
+    bool enableHighlight = ( item != NULL );
+    int net = -1;
 
     // Obtain net code for the clicked item
     if( enableHighlight )
-        net = static_cast<BOARD_CONNECTED_ITEM*>( collector[0] )->GetNetCode();
+        net = item->GetNetCode();
 
     // Toggle highlight when the same net was picked
     if( net > 0 && net == render->GetHighlightNetCode() )
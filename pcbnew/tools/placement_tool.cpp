@@ -29,7 +29,7 @@
 
 #include <wxPcbStruct.h>
 #include <class_board.h>
-#include <ratsnest_data.h>
+#include <board_commit.h>
 
 #include <confirm.h>
 #include <boost/foreach.hpp>
@@ -78,11 +78,8 @@ int PLACEMENT_TOOL::AlignTop( const TOOL_EVENT& aEvent )
 
     if( selection.Size() > 1 )
     {
-        PCB_BASE_FRAME* editFrame = getEditFrame<PCB_BASE_FRAME>();
-        RN_DATA* ratsnest = getModel<BOARD>()->GetRatsnest();
-
-        editFrame->OnModify();
-        editFrame->SaveCopyInUndoList( selection.items, UR_CHANGED );
+        BOARD_COMMIT commit( getEditFrame<PCB_BASE_FRAME>() );
+        commit.Modify( selection.items );
 
         // Compute the highest point of selection - it will be the edge of alignment
         int top = selection.Item<BOARD_ITEM>( 0 )->GetBoundingBox().GetY();
@@ -102,11 +99,9 @@ int PLACEMENT_TOOL::AlignTop( const TOOL_EVENT& aEvent )
             int difference = top - item->GetBoundingBox().GetY();
 
             item->Move( wxPoint( 0, difference ) );
-            item->ViewUpdate();
-            ratsnest->Update( item );
         }
 
-        getModel<BOARD>()->GetRatsnest()->Recalculate();
+        commit.Push();
     }
 
     return 0;
@@ -119,11 +114,8 @@ int PLACEMENT_TOOL::AlignBottom( const TOOL_EVENT& aEvent )
 
     if( selection.Size() > 1 )
     {
-        PCB_BASE_FRAME* editFrame = getEditFrame<PCB_BASE_FRAME>();
-        RN_DATA* ratsnest = getModel<BOARD>()->GetRatsnest();
-
-        editFrame->OnModify();
-        editFrame->SaveCopyInUndoList( selection.items, UR_CHANGED );
+        BOARD_COMMIT commit( getEditFrame<PCB_BASE_FRAME>() );
+        commit.Modify( selection.items );
 
         // Compute the lowest point of selection - it will be the edge of alignment
         int bottom = selection.Item<BOARD_ITEM>( 0 )->GetBoundingBox().GetBottom();
@@ -143,11 +135,9 @@ int PLACEMENT_TOOL::AlignBottom( const TOOL_EVENT& aEvent )
             int difference = bottom - item->GetBoundingBox().GetBottom();
 
             item->Move( wxPoint( 0, difference ) );
-            item->ViewUpdate();
-            ratsnest->Update( item );
         }
 
-        getModel<BOARD>()->GetRatsnest()->Recalculate();
+        commit.Push();
     }
 
     return 0;
@@ -160,11 +150,8 @@ int PLACEMENT_TOOL::AlignLeft( const TOOL_EVENT& aEvent )
 
     if( selection.Size() > 1 )
     {
-        PCB_BASE_FRAME* editFrame = getEditFrame<PCB_BASE_FRAME>();
-        RN_DATA* ratsnest = getModel<BOARD>()->GetRatsnest();
-
-        editFrame->OnModify();
-        editFrame->SaveCopyInUndoList( selection.items, UR_CHANGED );
+        BOARD_COMMIT commit( getEditFrame<PCB_BASE_FRAME>() );
+        commit.Modify( selection.items );
 
         // Compute the leftmost point of selection - it will be the edge of alignment
         int left = selection.Item<BOARD_ITEM>( 0 )->GetBoundingBox().GetX();
@@ -184,11 +171,9 @@ int PLACEMENT_TOOL::AlignLeft( const TOOL_EVENT& aEvent )
             int difference = left - item->GetBoundingBox().GetX();
 
             item->Move( wxPoint( difference, 0 ) );
-            item->ViewUpdate();
-            ratsnest->Update( item );
         }
 
-        getModel<BOARD>()->GetRatsnest()->Recalculate();
+        commit.Push();
     }
 
     return 0;
@@ -201,11 +186,8 @@ int PLACEMENT_TOOL::AlignRight( const TOOL_EVENT& aEvent )
 
     if( selection.Size() > 1 )
     {
-        PCB_BASE_FRAME* editFrame = getEditFrame<PCB_BASE_FRAME>();
-        RN_DATA* ratsnest = getModel<BOARD>()->GetRatsnest();
-
-        editFrame->OnModify();
-        editFrame->SaveCopyInUndoList( selection.items, UR_CHANGED );
+        BOARD_COMMIT commit( getEditFrame<PCB_BASE_FRAME>() );
+        commit.Modify( selection.items );
 
         // Compute the rightmost point of selection - it will be the edge of alignment
         int right = selection.Item<BOARD_ITEM>( 0 )->GetBoundingBox().GetRight();
@@ -225,11 +207,9 @@ int PLACEMENT_TOOL::AlignRight( const TOOL_EVENT& aEvent )
             int difference = right - item->GetBoundingBox().GetRight();
 
             item->Move( wxPoint( difference, 0 ) );
-            item->ViewUpdate();
-            ratsnest->Update( item );
         }
 
-        getModel<BOARD>()->GetRatsnest()->Recalculate();
+        commit.Push();
     }
 
     return 0;
@@ -254,11 +234,8 @@ int PLACEMENT_TOOL::DistributeHorizontally( const TOOL_EVENT& aEvent )
 
     if( selection.Size() > 1 )
     {
-        PCB_BASE_FRAME* editFrame = getEditFrame<PCB_BASE_FRAME>();
-        RN_DATA* ratsnest = getModel<BOARD>()->GetRatsnest();
-
-        editFrame->OnModify();
-        editFrame->SaveCopyInUndoList( selection.items, UR_CHANGED );
+        BOARD_COMMIT commit( getEditFrame<PCB_BASE_FRAME>() );
+        commit.Modify( selection.items );
 
         // Prepare a list, so the items can be sorted by their X coordinate
         std::list<BOARD_ITEM*> itemsList;
@@ -282,13 +259,11 @@ int PLACEMENT_TOOL::DistributeHorizontally( const TOOL_EVENT& aEvent )
             int difference = position - item->GetBoundingBox().Centre().x;
 
             item->Move( wxPoint( difference, 0 ) );
-            item->ViewUpdate();
-            ratsnest->Update( item );
 
             position += distance;
         }
 
-        getModel<BOARD>()->GetRatsnest()->Recalculate();
+        commit.Push();
     }
 
     return 0;
@@ -301,11 +276,8 @@ int PLACEMENT_TOOL::DistributeVertically( const TOOL_EVENT& aEvent )
 
     if( selection.Size() > 1 )
     {
-        PCB_BASE_FRAME* editFrame = getEditFrame<PCB_BASE_FRAME>();
-        RN_DATA* ratsnest = getModel<BOARD>()->GetRatsnest();
-
-        editFrame->OnModify();
-        editFrame->SaveCopyInUndoList( selection.items, UR_CHANGED );
+        BOARD_COMMIT commit( getEditFrame<PCB_BASE_FRAME>() );
+        commit.Modify( selection.items );
 
         // Prepare a list, so the items can be sorted by their Y coordinate
         std::list<BOARD_ITEM*> itemsList;
@@ -329,13 +301,11 @@ int PLACEMENT_TOOL::DistributeVertically( const TOOL_EVENT& aEvent )
             int difference = position - item->GetBoundingBox().Centre().y;
 
             item->Move( wxPoint( 0, difference ) );
-            item->ViewUpdate();
-            ratsnest->Update( item );
 
             position += distance;
         }
 
-        getModel<BOARD>()->GetRatsnest()->Recalculate();
+        commit.Push();
     }
 
     return 0;
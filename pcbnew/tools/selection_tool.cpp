@@ -27,6 +27,7 @@
 #include <boost/foreach.hpp>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <boost/unordered_set.hpp>
 
 #include <class_board.h>
 #include <class_board_item.h>
@@ -361,11 +362,12 @@ bool SELECTION_TOOL::selectPoint( const VECTOR2I& aWhere, bool aOnDrag )
     GENERAL_COLLECTORS_GUIDE guide = m_frame->GetCollectorsGuide();
     GENERAL_COLLECTOR collector;
 
+    // Only the items of the view near the cursor are hit tested
     if( m_editModules )
-        collector.Collect( getModel<BOARD>(), GENERAL_COLLECTOR::ModuleItems,
+        collector.Collect( getModel<BOARD>(), getView(), GENERAL_COLLECTOR::ModuleItems,
                            wxPoint( aWhere.x, aWhere.y ), guide );
     else
-        collector.Collect( getModel<BOARD>(), GENERAL_COLLECTOR::AllBoardItems,
+        collector.Collect( getModel<BOARD>(), getView(), GENERAL_COLLECTOR::AllBoardItems,
                            wxPoint( aWhere.x, aWhere.y ), guide );
 
     bool anyCollected = collector.GetCount() != 0;
@@ -403,6 +405,16 @@ bool SELECTION_TOOL::selectPoint( const VECTOR2I& aWhere, bool aOnDrag )
         }
         else if( collector.GetCount() > 1 )
         {
+            // The item seen under the cursor is the one clicked
+            item = pickShownItem( aWhere, collector );
+
+            if( item )
+            {
+                toggleSelection( item );
+
+                return true;
+            }
+
             if( aOnDrag )
                 Wait( TOOL_EVENT( TC_ANY, TA_MOUSE_UP, BUT_LEFT ) );
 
@@ -475,17 +487,18 @@ bool SELECTION_TOOL::selectMultiple()
             view->Query( selectionBox, selectedItems );         // Get the list of selected items
 
             std::vector<KIGFX::VIEW::LAYER_ITEM_PAIR>::iterator it, it_end;
+            boost::unordered_set<BOARD_ITEM*> tested;   // items are found once per layer
 
             for( it = selectedItems.begin(), it_end = selectedItems.end(); it != it_end; ++it )
             {
                 BOARD_ITEM* item = static_cast<BOARD_ITEM*>( it->first );
 
+                if( item->IsSelected() || !tested.insert( item ).second )
+                    continue;
+
                 // Add only those items that are visible and fully within the selection box
-                if( !item->IsSelected() && selectable( item ) &&
-                        selectionBox.Contains( item->ViewBBox() ) )
-                {
+                if( selectionBox.Contains( item->ViewBBox() ) && selectable( item ) )
                     select( item );
-                }
             }
 
             if( m_selection.Size() == 1 )
@@ -778,6 +791,26 @@ void SELECTION_TOOL::clearSelection()
 }
 
 
+BOARD_ITEM* SELECTION_TOOL::pickShownItem( const VECTOR2I& aWhere,
+                                            const GENERAL_COLLECTOR& aItems )
+{
+    KIGFX::VIEW* view = getView();
+    std::vector<KIGFX::VIEW_ITEM*> shown;
+
+    // Only the pixel under the cursor
+    if( !view->Pick( view->ToScreen( aWhere ), 0, shown ) || shown.empty() )
+        return NULL;
+
+    for( int i = 0; i < aItems.GetCount(); ++i )
+    {
+        if( aItems[i] == shown[0] )
+            return aItems[i];
+    }
+
+    return NULL;
+}
+
+
 BOARD_ITEM* SELECTION_TOOL::disambiguationMenu( GENERAL_COLLECTOR* aCollector )
 {
     BOARD_ITEM* current = NULL;
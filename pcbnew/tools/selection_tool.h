@@ -248,6 +248,16 @@ private:
      */
     BOARD_ITEM* disambiguationMenu( GENERAL_COLLECTOR* aItems );
 
+    /**
+     * Function pickShownItem()
+     * Returns the item shown on top at the given point, if the view can pick it and it is
+     * one of the collected items, else NULL.
+     *
+     * @param aWhere is the point, in world coordinates.
+     * @param aItems contains the candidate items.
+     */
+    BOARD_ITEM* pickShownItem( const VECTOR2I& aWhere, const GENERAL_COLLECTOR& aItems );
+
     /**
      * Function pickSmallestComponent()
      * Allows to find the smallest (in terms of bounding box area) item from the list.
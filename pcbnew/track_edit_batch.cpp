@@ -0,0 +1,124 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file track_edit_batch.cpp
+ */
+
+#include <fctsys.h>
+#include <wxPcbStruct.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+
+#include <drc_stuff.h>
+#include <track_edit_batch.h>
+
+
+TRACK_EDIT_BATCH::TRACK_EDIT_BATCH( DRC* aDrc, BOARD* aBoard ) :
+    m_drc( aDrc ),
+    m_board( aBoard ),
+    m_indexed( false ),
+    m_changeCount( 0 )
+{
+}
+
+
+void TRACK_EDIT_BATCH::buildIndexes()
+{
+    // Indexed as in DRC::testTracks()
+    m_pads = m_board->GetPads();
+
+    for( unsigned ii = 0; ii < m_pads.size(); ++ii )
+        m_padIndex.Insert( ii, DRC::padDrcArea( m_pads[ii] ), DRC::padDrcLayers( m_pads[ii] ) );
+
+    for( TRACK* track = m_board->m_Track; track; track = track->Next() )
+    {
+        m_trackIndex.Insert( m_tracks.size(), track->GetBoundingBox(), track->GetLayerSet() );
+        m_trackOrdinals[track] = m_tracks.size();
+        m_tracks.push_back( track );
+    }
+
+    m_indexed = true;
+}
+
+
+int TRACK_EDIT_BATCH::Drc( TRACK* aTrack )
+{
+    if( !m_indexed )
+        buildIndexes();
+
+    const EDA_RECT      area = aTrack->GetBoundingBox();
+    std::vector<int>    candidates;
+    std::vector<D_PAD*> nearPads;
+    std::vector<TRACK*> nearTracks;
+
+    m_padIndex.Query( area, aTrack->GetLayerSet(), candidates );
+
+    for( unsigned ii = 0; ii < candidates.size(); ++ii )
+        nearPads.push_back( m_pads[ candidates[ii] ] );
+
+    // All the close tracks, as the sweep of the whole track list would test
+    m_trackIndex.Query( area, aTrack->GetLayerSet(), candidates );
+
+    for( unsigned ii = 0; ii < candidates.size(); ++ii )
+        nearTracks.push_back( m_tracks[ candidates[ii] ] );
+
+    MODULE  dummymodule( m_board );    // Creates a dummy parent
+    D_PAD   dummypad( &dummymodule );
+
+    dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
+
+    m_drc->updatePointers();
+
+    if( !m_drc->doTrackDrc( aTrack, nearPads, nearTracks, dummypad )
+            || !m_drc->doTrackKeepoutDrc( aTrack ) )
+    {
+        wxASSERT( m_drc->m_currentMarker );
+
+        m_drc->m_mainWindow->SetMsgPanel( m_drc->m_currentMarker );
+        return BAD_DRC;
+    }
+
+    return OK_DRC;
+}
+
+
+void TRACK_EDIT_BATCH::Changed( TRACK* aTrack, const EDA_RECT& aOldArea )
+{
+    if( m_indexed )
+    {
+        boost::unordered_map<TRACK*, int>::iterator it = m_trackOrdinals.find( aTrack );
+
+        if( it != m_trackOrdinals.end() )
+        {
+            m_trackIndex.Remove( it->second, aOldArea, aTrack->GetLayerSet() );
+            m_trackIndex.Insert( it->second, aTrack->GetBoundingBox(), aTrack->GetLayerSet() );
+        }
+    }
+
+    aTrack->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
+    ++m_changeCount;
+}
@@ -0,0 +1,89 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef TRACK_EDIT_BATCH_H_
+#define TRACK_EDIT_BATCH_H_
+
+#include <vector>
+
+#include <class_eda_rect.h>
+#include <drc_rtree.h>
+
+#include <boost/unordered_map.hpp>
+
+class BOARD;
+class DRC;
+class D_PAD;
+class TRACK;
+
+
+/**
+ * Class TRACK_EDIT_BATCH
+ * supports a batch of size changes of the tracks and vias of a board, like the global
+ * edits of PCB_EDIT_FRAME::Reset_All_Tracks_And_Vias_To_Netclass_Values().
+ * The clearance test of each widened item uses spatial indexes of the pads and tracks
+ * built once for the batch, instead of a sweep of the whole board.  The views of the
+ * changed items are only marked for update, and are refreshed in one pass by the next
+ * VIEW::UpdateItems().  The caller still saves the single undo entry of the batch.
+ */
+class TRACK_EDIT_BATCH
+{
+public:
+    TRACK_EDIT_BATCH( DRC* aDrc, BOARD* aBoard );
+
+    /**
+     * Function Drc
+     * tests aTrack like DRC::Drc( aTrack, aBoard->m_Track ), against the pads and tracks
+     * close to it only.  The indexes are built by the first call.
+     * @return OK_DRC if no error, or BAD_DRC, the marker being shown in the message panel.
+     */
+    int Drc( TRACK* aTrack );
+
+    /**
+     * Function Changed
+     * records the size change of aTrack: it is moved in the indexes, and its view is
+     * marked for update.
+     * @param aOldArea is the bounding box of aTrack before the change.
+     */
+    void Changed( TRACK* aTrack, const EDA_RECT& aOldArea );
+
+    ///> Returns the number of items changed in the batch
+    int GetChangeCount() const          { return m_changeCount; }
+
+private:
+    void buildIndexes();
+
+    DRC*                    m_drc;
+    BOARD*                  m_board;
+    bool                    m_indexed;
+    int                     m_changeCount;
+
+    std::vector<D_PAD*>     m_pads;
+    std::vector<TRACK*>     m_tracks;
+    boost::unordered_map<TRACK*, int> m_trackOrdinals;
+
+    DRC_RTREE               m_padIndex;
+    DRC_RTREE               m_trackIndex;
+};
+
+#endif  // TRACK_EDIT_BATCH_H_
@@ -32,8 +32,15 @@
 #include <fctsys.h>
 #include <trigo.h>
 #include <wxPcbStruct.h>
+#include <progress_reporter.h>
 
+#include <class_board.h>
+#include <class_pad.h>
+#include <class_track.h>
 #include <class_zone.h>
+#include <board_item_index.h>
+#include <fill_hash.h>
+#include <trace_events.h>
 
 #include <pcbnew.h>
 #include <zones.h>
@@ -56,6 +63,8 @@
 
 bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb, SHAPE_POLY_SET* aOutlineBuffer )
 {
+    TRACE_SCOPE( "ZONE_CONTAINER::BuildFilledSolidAreasPolygons" );
+
     /* convert outlines + holes to outlines without holes (adding extra segments if necessary)
      * m_Poly data is expected normalized, i.e. NormalizeAreaOutlines was used after building
      * this zone
@@ -64,22 +73,63 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb, SHAPE_POLY_SET*
     if( GetNumCorners() <= 2 )  // malformed zone. polygon calculations do not like it ...
         return 0;
 
+    if( aOutlineBuffer )
+    {
+        // Do not touch m_smoothedPoly: the outline of a zone is used to fill the other
+        // zones, which can be done concurrently with the fill of this zone
+        CPolyLine* smoothedPoly = buildSmoothedPoly();
+
+        aOutlineBuffer->Append( ConvertPolyListToPolySet( smoothedPoly->m_CornersList ) );
+        delete smoothedPoly;
+
+        return true;
+    }
+
     // Make a smoothed polygon out of the user-drawn polygon if required
-    if( m_smoothedPoly )
+    delete m_smoothedPoly;
+    m_smoothedPoly = buildSmoothedPoly();
+
+    /* For copper layers, we now must add holes in the Polygon list.
+     * holes are pads and tracks with their clearance area
+     * for non copper layers just recalculate the m_FilledPolysList
+     * with m_ZoneMinThickness taken in account
+     */
+    m_FilledPolysList.RemoveAllContours();
+
+    if( IsOnCopperLayer() )
+    {
+        AddClearanceAreasPolygonsToPolysList_NG( aPcb );
+    }
+    else
     {
-        delete m_smoothedPoly;
-        m_smoothedPoly = NULL;
+        int margin = m_ZoneMinThickness / 2;
+        m_FilledPolysList = ConvertPolyListToPolySet( m_smoothedPoly->m_CornersList );
+        m_FilledPolysList.Inflate( -margin, 16 );
+        m_FilledPolysList.Fracture( SHAPE_POLY_SET::PM_FAST );
+        m_fillHash = fillHash( aPcb, NULL );
     }
 
+    // Triangulated once here rather than by the renderers at each redraw
+    m_FilledPolysList.CacheTriangulation();
+
+    if( m_FillMode )   // if fill mode uses segments, create them:
+        FillZoneAreasWithSegments();
+
+    m_IsFilled = true;
+
+    return true;
+}
+
+
+CPolyLine* ZONE_CONTAINER::buildSmoothedPoly() const
+{
     switch( m_cornerSmoothingType )
     {
     case ZONE_SETTINGS::SMOOTHING_CHAMFER:
-        m_smoothedPoly = m_Poly->Chamfer( m_cornerRadius );
-        break;
+        return m_Poly->Chamfer( m_cornerRadius );
 
     case ZONE_SETTINGS::SMOOTHING_FILLET:
-        m_smoothedPoly = m_Poly->Fillet( m_cornerRadius, m_ArcToSegmentsCount );
-        break;
+        return m_Poly->Fillet( m_cornerRadius, m_ArcToSegmentsCount );
 
     default:
         // Acute angles between adjacent edges can create issues in calculations,
@@ -87,41 +137,244 @@ bool ZONE_CONTAINER::BuildFilledSolidAreasPolygons( BOARD* aPcb, SHAPE_POLY_SET*
         // We can avoid issues by creating a very small chamfer which remove acute angles,
         // or left it without chamfer and use only CPOLYGONS_LIST::InflateOutline to create
         // clearance areas
-        m_smoothedPoly = m_Poly->Chamfer( Millimeter2iu( 0.0 ) );
-        break;
+        return m_Poly->Chamfer( Millimeter2iu( 0.0 ) );
     }
+}
 
-    if( aOutlineBuffer )
-        aOutlineBuffer->Append( ConvertPolyListToPolySet( m_smoothedPoly->m_CornersList ) );
 
-    /* For copper layers, we now must add holes in the Polygon list.
-     * holes are pads and tracks with their clearance area
-     * for non copper layers just recalculate the m_FilledPolysList
-     * with m_ZoneMinThickness taken in account
-     */
-    else
+// To be incremented when the filler is changed in a way that changes its results, so that
+// the fills saved by the previous versions are seen as stale
+static const int s_fillHashVersion = 2;
+
+
+uint64_t ZONE_CONTAINER::fillHash( BOARD* aPcb, const SHAPE_POLY_SET* aHoles ) const
+{
+    FILL_HASH hash;
+
+    hash.Add( s_fillHashVersion );
+    hash.Add( GetLayer() );
+    hash.Add( GetNetname() );
+    hash.Add( m_ZoneClearance );
+    hash.Add( m_ZoneMinThickness );
+    hash.Add( m_FillMode );
+    hash.Add( m_ArcToSegmentsCount );
+    hash.Add( m_tiledFill );
+    hash.Add( m_PadConnection );
+    hash.Add( m_ThermalReliefGap );
+    hash.Add( m_ThermalReliefCopperBridge );
+    hash.Add( m_cornerSmoothingType );
+    hash.Add( m_cornerRadius );
+    hash.Add( m_priority );
+    hash.Add( GetClearance() );
+
+    const CPOLYGONS_LIST& corners = m_Poly->m_CornersList;
+
+    for( unsigned ii = 0; ii < corners.GetCornersCount(); ii++ )
+    {
+        hash.Add( corners.GetPos( ii ) );
+        hash.Add( corners.IsEndContour( ii ) );
+    }
+
+    if( aHoles == NULL )
+        return std::max( hash.Get(), (uint64_t) 1 );
+
+    // The holes and the items are found in the order of the board item index, which is not
+    // the same after the board is loaded again: they are hashed one by one, and their hashes
+    // are summed, which does not depend on their order.
+    uint64_t itemSum = 0;
+
+    for( int ii = 0; ii < aHoles->OutlineCount(); ii++ )
+    {
+        FILL_HASH holeHash;
+        holeHash.Add( aHoles->CPolygon( ii ) );
+        itemSum += holeHash.Get();
+    }
+
+    hash.Add( aHoles->OutlineCount() );
+
+    // The pads and tracks of the zone net are not holes, but the insulated islands and the
+    // unconnected thermal stubs are found from them
+    std::vector<BOARD_ITEM*> nearItems;
+    aPcb->GetItemIndex().Query( GetBoundingBox(), GetLayer(), nearItems );
+
+    for( unsigned ii = 0; ii < nearItems.size(); ii++ )
     {
-        m_FilledPolysList.RemoveAllContours();
+        BOARD_ITEM* item = nearItems[ii];
+        FILL_HASH   itemHash;
 
-        if( IsOnCopperLayer() )
+        if( item->Type() == PCB_PAD_T )
         {
-            AddClearanceAreasPolygonsToPolysList_NG( aPcb );
+            D_PAD* pad = static_cast<D_PAD*>( item );
+
+            if( !pad->IsOnLayer( GetLayer() ) || pad->GetNetCode() != GetNetCode() )
+                continue;
+
+            itemHash.Add( pad->Type() );
+            itemHash.Add( pad->GetPosition() );
+            itemHash.Add( pad->GetSize().x );
+            itemHash.Add( pad->GetSize().y );
+            itemHash.Add( pad->GetShape() );
+            itemHash.Add( KiROUND( pad->GetOrientation() ) );
+            itemHash.Add( pad->GetDelta().x );
+            itemHash.Add( pad->GetDelta().y );
+            itemHash.Add( pad->GetOffset() );
+            itemHash.Add( KiROUND( pad->GetRoundRectRadiusRatio() * 1e6 ) );
+            itemHash.Add( pad->GetAttribute() );
+            itemHash.Add( pad->GetDrillShape() );
+            itemHash.Add( pad->GetDrillSize().x );
+            itemHash.Add( pad->GetDrillSize().y );
+
+            // The connection to the zone, with the overrides of the pad and its footprint
+            itemHash.Add( pad->GetZoneConnection() );
+            itemHash.Add( pad->GetThermalGap() );
+            itemHash.Add( pad->GetThermalWidth() );
+            itemHash.Add( pad->GetLocalClearance() );
+            itemHash.Add( pad->GetClearance() );
         }
-        else
+        else if( item->Type() == PCB_TRACE_T || item->Type() == PCB_VIA_T )
         {
-            int margin = m_ZoneMinThickness / 2;
-            m_FilledPolysList = ConvertPolyListToPolySet( m_smoothedPoly->m_CornersList );
-            m_FilledPolysList.Inflate( -margin, 16 );
-            m_FilledPolysList.Fracture( SHAPE_POLY_SET::PM_FAST );
+            TRACK* track = static_cast<TRACK*>( item );
+
+            if( !track->IsOnLayer( GetLayer() ) || track->GetNetCode() != GetNetCode() )
+                continue;
+
+            itemHash.Add( track->Type() );
+            itemHash.Add( track->GetStart() );
+            itemHash.Add( track->GetEnd() );
+            itemHash.Add( track->GetWidth() );
         }
+        else
+            continue;
 
-        if( m_FillMode )   // if fill mode uses segments, create them:
-            FillZoneAreasWithSegments();
+        itemSum += itemHash.Get();
+    }
 
-        m_IsFilled = true;
+    hash.Add( (int64_t) itemSum );
+
+    return std::max( hash.Get(), (uint64_t) 1 );
+}
+
+
+uint64_t ZONE_CONTAINER::BuildFillHash( BOARD* aPcb )
+{
+    if( !IsOnCopperLayer() )
+        return fillHash( aPcb, NULL );
+
+    SHAPE_POLY_SET holes;
+    buildFeatureHoleList( aPcb, holes );
+
+    return fillHash( aPcb, &holes );
+}
+
+
+bool ZONE_CONTAINER::IsFillUpToDate( BOARD* aPcb )
+{
+    if( !m_IsFilled || m_fillHash == 0 || GetNumCorners() <= 2 )
+        return false;
+
+    return BuildFillHash( aPcb ) == m_fillHash;
+}
+
+
+bool BOARD::FillZones( const std::vector<ZONE_CONTAINER*>& aZones,
+                       PROGRESS_REPORTER* aReporter, bool aStaleOnly,
+                       int* aErrorCount, bool aStopOnError )
+{
+    TRACE_SCOPE( "BOARD::FillZones" );
+
+    int     zoneCount = aZones.size();
+    int     doneCount = 0;
+    int     errorCount = 0;
+    bool    cancelled = false;
+
+    // Set once the fill is cancelled or stopped on error, read by all the threads: it is
+    // only accessed atomically
+    int     stopped = 0;
+
+    // Bring the board item index up to date before the threads start querying it
+    GetItemIndex();
+
+    // The fill of a zone uses the outlines of the other zones, but never their filled areas,
+    // and only modifies the zone itself, so the zones do not depend on each other.
+    // Large zones take much longer than small ones, so they are dispatched one at a time.
+    // The zones with a tiled fill are filled afterwards, one after the other, so that all
+    // the threads are available for their tiles.
+    for( int pass = 0; pass < 2; pass++ )
+    {
+        bool tiledPass = pass == 1;
+
+#ifdef USE_OPENMP
+        #pragma omp parallel for schedule(dynamic, 1) if( !tiledPass )
+#endif
+        for( int ii = 0; ii < zoneCount; ii++ )
+        {
+            ZONE_CONTAINER* zone = aZones[ii];
+            int             stop;
+
+#ifdef USE_OPENMP
+            #pragma omp atomic read
+#endif
+            stop = stopped;
+
+            if( stop || zone->GetTiledFill() != tiledPass )
+                continue;
+
+            bool filled = true;
+
+            // Cannot fill keepout zones.  Checking the fill inputs costs much less than
+            // the fill itself, which is mostly spent in the polygon operations.
+            if( !zone->GetIsKeepout() && !( aStaleOnly && zone->IsFillUpToDate( this ) ) )
+            {
+                zone->ClearFilledPolysList();
+                zone->UnFill();
+                filled = zone->BuildFilledSolidAreasPolygons( this );
+            }
+
+#ifdef USE_OPENMP
+            #pragma omp critical( fillZonesProgress )
+#endif
+            {
+                ++doneCount;
+
+                if( !filled )
+                {
+                    ++errorCount;
+
+                    if( aStopOnError )
+                        stop = 1;
+                }
+
+                if( aReporter )
+                {
+                    wxString msg;
+                    msg.Printf( _( "Filling zone %d out of %d (net %s)..." ),
+                                doneCount, zoneCount, GetChars( zone->GetNetname() ) );
+
+                    aReporter->Report( msg );
+                    aReporter->AdvanceProgress();
+
+                    if( aReporter->IsCancelled() )
+                    {
+                        cancelled = true;   // Aborted by user
+                        stop = 1;
+                    }
+                }
+            }
+
+            if( stop )
+            {
+#ifdef USE_OPENMP
+                #pragma omp atomic write
+#endif
+                stopped = 1;
+            }
+        }
     }
 
-    return true;
+    if( aErrorCount )
+        *aErrorCount = errorCount;
+
+    return !cancelled;
 }
 
 
@@ -132,7 +385,32 @@ static bool SortByXValues( const int& a, const int &b )
 }
 
 
-int ZONE_CONTAINER::FillZoneAreasWithSegments()
+/// A non horizontal edge of a filled area, crossed by the scanlines y with m_yMin <= y < m_yMax
+struct FILL_EDGE
+{
+    int         m_yMin;
+    int         m_yMax;
+    VECTOR2I    m_start;
+    VECTOR2I    m_end;
+};
+
+
+static bool fillEdgeLessY( const FILL_EDGE& aA, const FILL_EDGE& aB )
+{
+    return aA.m_yMin < aB.m_yMin;
+}
+
+
+static bool fillSegmentLess( const SEGMENT& aA, const SEGMENT& aB )
+{
+    if( aA.m_Start.y != aB.m_Start.y )
+        return aA.m_Start.y < aB.m_Start.y;
+
+    return aA.m_Start.x < aB.m_Start.x;
+}
+
+
+int ZONE_CONTAINER::FillZoneAreasWithSegments( bool aMergeSegments )
 {
     int count = 0;
     std::vector <int> x_coordinates;
@@ -143,6 +421,9 @@ int ZONE_CONTAINER::FillZoneAreasWithSegments()
     int step = m_ZoneMinThickness - margin;
     step = std::max( step, minwidth );
 
+    std::vector<FILL_EDGE> edges;
+    std::vector<int> activeEdges;   // Indexes in edges of the edges crossed by the scanline
+
     // Read all filled areas in m_FilledPolysList
     m_FillSegmList.clear();
 
@@ -151,42 +432,60 @@ int ZONE_CONTAINER::FillZoneAreasWithSegments()
         const SHAPE_LINE_CHAIN& outline = m_FilledPolysList.COutline( index );
         const BOX2I& rect = outline.BBox();
 
+        // Build the edge table, sorted by the first scanline crossing each edge.
+        // Horizontal edges are never crossed by a scanline: skip them.
+        edges.clear();
+
+        for( int v = 0; v < outline.PointCount(); v++ )
+        {
+            FILL_EDGE edge;
+            edge.m_start = outline.CPoint( v );
+            edge.m_end = outline.CPoint( v + 1 );
+
+            if( edge.m_start.y == edge.m_end.y )
+                continue;
+
+            edge.m_yMin = std::min( edge.m_start.y, edge.m_end.y );
+            edge.m_yMax = std::max( edge.m_start.y, edge.m_end.y );
+            edges.push_back( edge );
+        }
+
+        std::sort( edges.begin(), edges.end(), fillEdgeLessY );
+
+        activeEdges.clear();
+        unsigned nextEdge = 0;
+
         // Calculate the y limits of the zone
         for( int refy = rect.GetY(), endy = rect.GetBottom(); refy < endy; refy += step )
         {
-            // find all intersection points of an infinite line with polyline sides
-            x_coordinates.clear();
+            // Update the active edges: add the edges starting above the scanline, and
+            // remove the edges ending above it.  Only the active edges are intersected.
+            while( nextEdge < edges.size() && edges[nextEdge].m_yMin <= refy )
+                activeEdges.push_back( nextEdge++ );
+
+            unsigned kept = 0;
 
-            for( int v = 0; v < outline.PointCount(); v++ )
+            for( unsigned ii = 0; ii < activeEdges.size(); ii++ )
             {
+                if( edges[activeEdges[ii]].m_yMax > refy )
+                    activeEdges[kept++] = activeEdges[ii];
+            }
 
-                int seg_startX = outline.CPoint( v ).x;
-                int seg_startY = outline.CPoint( v ).y;
-                int seg_endX   = outline.CPoint( v + 1 ).x;
-                int seg_endY   = outline.CPoint( v + 1 ).y;
+            activeEdges.resize( kept );
 
-                /* Trivial cases: skip if ref above or below the segment to test */
-                if( ( seg_startY > refy ) && ( seg_endY > refy ) )
-                    continue;
+            // find all intersection points of an infinite line with polyline sides
+            x_coordinates.clear();
 
-                // segment below ref point, or its Y end pos on Y coordinate ref point: skip
-                if( ( seg_startY <= refy ) && (seg_endY <= refy ) )
-                    continue;
+            for( unsigned ii = 0; ii < activeEdges.size(); ii++ )
+            {
+                const FILL_EDGE& edge = edges[activeEdges[ii]];
 
-                /* at this point refy is between seg_startY and seg_endY
-                 * see if an horizontal line at Y = refy is intersecting this segment
-                 */
                 // calculate the x position of the intersection of this segment and the
                 // infinite line this is more easier if we move the X,Y axis origin to
                 // the segment start point:
-
-                seg_endX -= seg_startX;
-                seg_endY -= seg_startY;
-                double newrefy = (double) ( refy - seg_startY );
-                double intersec_x;
-
-                if ( seg_endY == 0 )    // horizontal segment on the same line: skip
-                    continue;
+                int seg_endX = edge.m_end.x - edge.m_start.x;
+                int seg_endY = edge.m_end.y - edge.m_start.y;
+                double newrefy = (double) ( refy - edge.m_start.y );
 
                 // Now calculate the x intersection coordinate of the horizontal line at
                 // y = newrefy and the segment from (0,0) to (seg_endX,seg_endY) with the
@@ -194,11 +493,11 @@ int ZONE_CONTAINER::FillZoneAreasWithSegments()
                 // slope = seg_endY/seg_endX; and inv_slope = seg_endX/seg_endY
                 // and the x pos relative to the new origin is:
                 // intersec_x = refy/slope = refy * inv_slope
-                // Note: because horizontal segments are already tested and skipped, slope
+                // Note: horizontal segments are not in the edge table, so the slope
                 // exists (seg_end_y not O)
                 double inv_slope = (double) seg_endX / seg_endY;
-                intersec_x = newrefy * inv_slope;
-                x_coordinates.push_back( (int) intersec_x + seg_startX );
+                double intersec_x = newrefy * inv_slope;
+                x_coordinates.push_back( (int) intersec_x + edge.m_start.x );
             }
 
             // A line scan is finished: build list of segments
@@ -240,6 +539,29 @@ int ZONE_CONTAINER::FillZoneAreasWithSegments()
             break;
     }
 
+    // Merge the segments of a scanline which touch or overlap, e.g. at the boundary of
+    // two filled areas: they are drawn, plotted and saved as a single segment
+    if( aMergeSegments && !m_FillSegmList.empty() )
+    {
+        std::sort( m_FillSegmList.begin(), m_FillSegmList.end(), fillSegmentLess );
+
+        unsigned last = 0;
+
+        for( unsigned ii = 1; ii < m_FillSegmList.size(); ii++ )
+        {
+            SEGMENT& segment = m_FillSegmList[last];
+            const SEGMENT& next = m_FillSegmList[ii];
+
+            if( next.m_Start.y == segment.m_Start.y && next.m_Start.x <= segment.m_End.x )
+                segment.m_End.x = std::max( segment.m_End.x, next.m_End.x );
+            else
+                m_FillSegmList[++last] = next;
+        }
+
+        m_FillSegmList.resize( last + 1 );
+        count = m_FillSegmList.size();
+    }
+
     if( !error )
         m_IsFilled = true;
 
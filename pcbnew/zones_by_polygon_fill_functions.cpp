@@ -35,6 +35,7 @@
 #include <ratsnest_data.h>
 #include <wxPcbStruct.h>
 #include <macros.h>
+#include <progress_reporter.h>
 
 #include <class_board.h>
 #include <class_track.h>
@@ -43,6 +44,8 @@
 #include <pcbnew.h>
 #include <zones.h>
 
+#include <boost/bind.hpp>
+
 #define FORMAT_STRING _( "Filling zone %d out of %d (net %s)..." )
 
 
@@ -124,7 +127,16 @@ int PCB_EDIT_FRAME::Fill_Zone( ZONE_CONTAINER* aZone )
 }
 
 
-int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose )
+// The job filling the zones of Fill_All_Zones() on a thread of the pool
+static void fillZonesJob( BOARD* aBoard, const std::vector<ZONE_CONTAINER*>* aZones,
+                          bool aStaleOnly, int* aErrorLevel, bool aStopOnError,
+                          PROGRESS_REPORTER& aReporter )
+{
+    aBoard->FillZones( *aZones, &aReporter, aStaleOnly, aErrorLevel, aStopOnError );
+}
+
+
+int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose, bool aStaleOnly )
 {
     int errorLevel = 0;
     int areaCount = GetBoard()->GetAreaCount();
@@ -146,33 +158,73 @@ int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose )
         progressDialog->Update( 0, _( "Starting zone fill..." ) );
 
     // Remove segment zones
+    bool changed = GetBoard()->m_Zone.GetCount() != 0;
+
     GetBoard()->m_Zone.DeleteAll();
 
-    int ii;
+    std::vector<ZONE_CONTAINER*> zones;
+    std::vector<uint64_t> previousHashes;
+
+    for( int ii = 0; ii < areaCount; ii++ )
+    {
+        zones.push_back( GetBoard()->GetArea( ii ) );
+        previousHashes.push_back( zones[ii]->GetFillHash() );
+    }
+
+    // The progress dialog keeps handling the events while the zones are filled.  It is
+    // application modal, so the board cannot be edited meanwhile, but the canvas would
+    // still be painted from the zones being filled: stop drawing it until the fill ended.
+    bool galCanvas = IsGalCanvasActive();
+
+    if( galCanvas )
+        GetGalCanvas()->StopDrawing();
+    else
+        m_canvas->Freeze();
+
+    // Unless verbose, the fill stops after the first zone which cannot be filled
+    bool completed = RunInBackground( boost::bind( fillZonesJob, GetBoard(), &zones,
+                                                   aStaleOnly, &errorLevel, !aVerbose, _1 ),
+                                      progressDialog );
 
-    for( ii = 0; ii < areaCount; ii++ )
+    if( galCanvas )
+        GetGalCanvas()->StartDrawing();
+    else
+        m_canvas->Thaw();
+
+    // The view and the ratsnest are not thread safe, update them once all zones are filled
+    for( int ii = 0; ii < areaCount; ii++ )
     {
-        ZONE_CONTAINER* zoneContainer = GetBoard()->GetArea( ii );
+        ZONE_CONTAINER* zoneContainer = zones[ii];
+
         if( zoneContainer->GetIsKeepout() )
             continue;
 
-        msg.Printf( FORMAT_STRING, ii + 1, areaCount, GetChars( zoneContainer->GetNetname() ) );
+        // A refilled zone has a new hash (UnFill() clears it), an up to date one is unchanged
+        if( aStaleOnly && zoneContainer->GetFillHash() == previousHashes[ii]
+                && zoneContainer->GetFillHash() != 0 )
+            continue;
 
-        if( progressDialog )
-        {
-            if( !progressDialog->Update( ii+1, msg ) )
-                break;  // Aborted by user
-        }
+        changed = true;
 
-        errorLevel = Fill_Zone( zoneContainer );
+        zoneContainer->ViewUpdate( KIGFX::VIEW_ITEM::ALL );
+        GetBoard()->GetRatsnest()->Update( zoneContainer );
+    }
+
+    // Aborted by user: the zones not reached yet keep their previous filled areas, the
+    // connections are not tested from a partial fill
+    if( !completed || ( aStaleOnly && !changed ) )
+    {
+        if( progressDialog )
+            progressDialog->Destroy();
 
-        if( errorLevel && !aVerbose )
-            break;
+        return errorLevel;
     }
 
+    OnModify();
+
     if( progressDialog )
     {
-        progressDialog->Update( ii+2, _( "Updating ratsnest..." ) );
+        progressDialog->Update( areaCount+1, _( "Updating ratsnest..." ) );
 #ifdef __WXMAC__
         // Work around a dialog z-order issue on OS X
         aActiveWindow->Raise();
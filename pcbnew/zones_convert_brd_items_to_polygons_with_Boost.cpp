@@ -48,6 +48,7 @@
 
 #include <cmath>
 #include <sstream>
+#include <algorithm>
 
 #include <fctsys.h>
 #include <wxPcbStruct.h>
@@ -60,6 +61,7 @@
 #include <class_drawsegment.h>
 #include <class_pcb_text.h>
 #include <class_zone.h>
+#include <board_item_index.h>
 #include <project.h>
 
 #include <pcbnew.h>
@@ -97,6 +99,110 @@ extern void CreateThermalReliefPadPolygon( SHAPE_POLY_SET&       aCornerBuffer,
 // Local Variables:
 static double s_thermalRot = 450;  // angle of stubs in thermal reliefs for round pads
 
+// When a zone is refilled only where its holes have changed, the rebuilt areas are made
+// slightly larger than the changed areas, so that they overlap the areas kept from the previous
+// fill and no gap can be created by the rounding of the intersections along their boundaries.
+static const int s_refillOverlap = 10;
+
+// If the changed areas cover more than this ratio of the zone, a full fill is faster
+static const double s_maxRefillRatio = 0.5;
+
+// The rounding errors of successive partial refills add up, so after this number of partial
+// refills, the zone is filled again from scratch
+static const int s_maxRefillCount = 16;
+
+// In a tiled fill, the zone is split in tiles of about this number of holes, the tiles being
+// filled in parallel.  Smaller tiles add work on their borders.
+static const int s_holesPerTile = 1000;
+static const int s_maxTilesPerSide = 8;
+
+
+/**
+ * Function comparePolygons
+ * compares the vertices of two polygons.
+ * @return < 0, 0 or > 0 when aA is before, equal to, or after aB, in an arbitrary but
+ * strict order.
+ */
+static int comparePolygons( const SHAPE_POLY_SET::POLYGON& aA, const SHAPE_POLY_SET::POLYGON& aB )
+{
+    if( aA.size() != aB.size() )
+        return aA.size() < aB.size() ? -1 : 1;
+
+    for( unsigned ii = 0; ii < aA.size(); ii++ )
+    {
+        const SHAPE_LINE_CHAIN& a = aA[ii];
+        const SHAPE_LINE_CHAIN& b = aB[ii];
+
+        if( a.PointCount() != b.PointCount() )
+            return a.PointCount() < b.PointCount() ? -1 : 1;
+
+        for( int jj = 0; jj < a.PointCount(); jj++ )
+        {
+            const VECTOR2I& pa = a.CPoint( jj );
+            const VECTOR2I& pb = b.CPoint( jj );
+
+            if( pa.x != pb.x )
+                return pa.x < pb.x ? -1 : 1;
+
+            if( pa.y != pb.y )
+                return pa.y < pb.y ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/// Sort functor for the indexes of the polygons of a SHAPE_POLY_SET
+struct POLYGON_INDEX_LESS
+{
+    POLYGON_INDEX_LESS( const SHAPE_POLY_SET& aSet ) : m_set( aSet ) {}
+
+    bool operator()( int aA, int aB ) const
+    {
+        return comparePolygons( m_set.CPolygon( aA ), m_set.CPolygon( aB ) ) < 0;
+    }
+
+    const SHAPE_POLY_SET& m_set;
+};
+
+
+/// Fills aIndexes with the indexes of the polygons of aSet, sorted by POLYGON_INDEX_LESS
+static void sortPolygons( const SHAPE_POLY_SET& aSet, std::vector<int>& aIndexes )
+{
+    aIndexes.resize( aSet.OutlineCount() );
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+        aIndexes[ii] = ii;
+
+    std::sort( aIndexes.begin(), aIndexes.end(), POLYGON_INDEX_LESS( aSet ) );
+}
+
+
+/// @return true if aA and aB have exactly the same polygons, in the same order
+static bool samePolygons( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    if( aA.OutlineCount() != aB.OutlineCount() )
+        return false;
+
+    for( int ii = 0; ii < aA.OutlineCount(); ii++ )
+    {
+        if( comparePolygons( aA.CPolygon( ii ), aB.CPolygon( ii ) ) != 0 )
+            return false;
+    }
+
+    return true;
+}
+
+/// @return the number of tiles per side to use in the tiled fill of a zone with aHoles
+static int fillTileCount( const SHAPE_POLY_SET& aHoles )
+{
+    int count = KiROUND( sqrt( (double) aHoles.OutlineCount() / s_holesPerTile ) );
+
+    return std::max( 2, std::min( count, s_maxTilesPerSide ) );
+}
+
+
 void ZONE_CONTAINER::buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeatures )
 {
     int segsPerCircle;
@@ -135,6 +241,50 @@ void ZONE_CONTAINER::buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeature
     biggest_clearance = std::max( biggest_clearance, zone_clearance );
     zone_boundingbox.Inflate( biggest_clearance );
 
+    /* Only the items found near the zone in the board item index are tested.
+     * The search area is large enough to find all the items whose bounding box,
+     * inflated by their own clearance or thermal gap, reaches zone_boundingbox.
+     */
+    BOARD_ITEM_INDEX&   itemIndex = aPcb->GetItemIndex();
+    EDA_RECT            searchArea = zone_boundingbox;
+    int                 searchMargin = std::max( biggest_clearance, m_ThermalReliefGap );
+
+    searchMargin = std::max( searchMargin, itemIndex.GetMaxLocalClearance() );
+    searchArea.Inflate( searchMargin + outline_half_thickness );
+
+    std::vector<BOARD_ITEM*> nearItems;
+    itemIndex.Query( searchArea, GetLayer(), nearItems );
+
+    std::vector<D_PAD*>         nearPads;
+    std::vector<TRACK*>         nearTracks;
+    std::vector<EDGE_MODULE*>   nearModuleEdges;
+    std::vector<BOARD_ITEM*>    nearDrawings;
+
+    for( unsigned ii = 0; ii < nearItems.size(); ii++ )
+    {
+        BOARD_ITEM* item = nearItems[ii];
+
+        switch( item->Type() )
+        {
+        case PCB_PAD_T:
+            nearPads.push_back( static_cast<D_PAD*>( item ) );
+            break;
+
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+            nearTracks.push_back( static_cast<TRACK*>( item ) );
+            break;
+
+        case PCB_MODULE_EDGE_T:
+            nearModuleEdges.push_back( static_cast<EDGE_MODULE*>( item ) );
+            break;
+
+        default:
+            nearDrawings.push_back( item );
+            break;
+        }
+    }
+
     /*
      * First : Add pads. Note: pads having the same net as zone are left in zone.
      * Thermal shapes will be created later if necessary
@@ -151,71 +301,65 @@ void ZONE_CONTAINER::buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeature
     MODULE dummymodule( aPcb );    // Creates a dummy parent
     D_PAD dummypad( &dummymodule );
 
-    for( MODULE* module = aPcb->m_Modules;  module;  module = module->Next() )
+    for( unsigned ii = 0; ii < nearPads.size(); ii++ )
     {
-        D_PAD* nextpad;
+        D_PAD* pad = nearPads[ii];  // pad pointer can be modified by next code
 
-        for( D_PAD* pad = module->Pads(); pad != NULL; pad = nextpad )
+        if( !pad->IsOnLayer( GetLayer() ) )
         {
-            nextpad = pad->Next();  // pad pointer can be modified by next code, so
-                                    // calculate the next pad here
+            /* Test for pads that are on top or bottom only and have a hole.
+             * There are curious pads but they can be used for some components that are
+             * inside the board (in fact inside the hole. Some photo diodes and Leds are
+             * like this)
+             */
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-            if( !pad->IsOnLayer( GetLayer() ) )
-            {
-                /* Test for pads that are on top or bottom only and have a hole.
-                 * There are curious pads but they can be used for some components that are
-                 * inside the board (in fact inside the hole. Some photo diodes and Leds are
-                 * like this)
-                 */
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
-
-                // Use a dummy pad to calculate a hole shape that have the same dimension as
-                // the pad hole
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetOrientation( pad->GetOrientation() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
-                                   PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
-                dummypad.SetPosition( pad->GetPosition() );
-
-                pad = &dummypad;
-            }
+            // Use a dummy pad to calculate a hole shape that have the same dimension as
+            // the pad hole
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetOrientation( pad->GetOrientation() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
+                               PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
+            dummypad.SetPosition( pad->GetPosition() );
 
-            // Note: netcode <=0 means not connected item
-            if( ( pad->GetNetCode() != GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
-            {
-                item_clearance   = pad->GetClearance() + outline_half_thickness;
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( item_clearance );
+            pad = &dummypad;
+        }
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
-                {
-                    int clearance = std::max( zone_clearance, item_clearance );
-                    pad->TransformShapeWithClearanceToPolygon( aFeatures,
-                                                               clearance,
-                                                               segsPerCircle,
-                                                               correctionFactor );
-                }
+        // Note: netcode <=0 means not connected item
+        if( ( pad->GetNetCode() != GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
+        {
+            item_clearance   = pad->GetClearance() + outline_half_thickness;
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( item_clearance );
 
-                continue;
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+            {
+                int clearance = std::max( zone_clearance, item_clearance );
+                itemIndex.TransformItemShapeToPolygon( pad, aFeatures,
+                                                       clearance,
+                                                       segsPerCircle,
+                                                       correctionFactor );
             }
 
-            // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
-            if( GetPadConnection( pad ) == PAD_ZONE_CONN_NONE )
-            {
-                int gap = zone_clearance;
-                int thermalGap = GetThermalReliefGap( pad );
-                gap = std::max( gap, thermalGap );
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( gap );
+            continue;
+        }
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
-                {
-                    pad->TransformShapeWithClearanceToPolygon( aFeatures,
-                                                               gap,
-                                                               segsPerCircle,
-                                                               correctionFactor );
-                }
+        // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
+        if( GetPadConnection( pad ) == PAD_ZONE_CONN_NONE )
+        {
+            int gap = zone_clearance;
+            int thermalGap = GetThermalReliefGap( pad );
+            gap = std::max( gap, thermalGap );
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( gap );
+
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+            {
+                itemIndex.TransformItemShapeToPolygon( pad, aFeatures,
+                                                       gap,
+                                                       segsPerCircle,
+                                                       correctionFactor );
             }
         }
     }
@@ -223,8 +367,10 @@ void ZONE_CONTAINER::buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeature
     /* Add holes (i.e. tracks and vias areas as polygons outlines)
      * in cornerBufferPolysToSubstract
      */
-    for( TRACK* track = aPcb->m_Track;  track;  track = track->Next() )
+    for( unsigned ii = 0; ii < nearTracks.size(); ii++ )
     {
+        TRACK* track = nearTracks[ii];
+
         if( !track->IsOnLayer( GetLayer() ) )
             continue;
 
@@ -237,10 +383,10 @@ void ZONE_CONTAINER::buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeature
         if( item_boundingbox.Intersects( zone_boundingbox ) )
         {
             int clearance = std::max( zone_clearance, item_clearance );
-            track->TransformShapeWithClearanceToPolygon( aFeatures,
-                                                         clearance,
-                                                         segsPerCircle,
-                                                         correctionFactor );
+            itemIndex.TransformItemShapeToPolygon( track, aFeatures,
+                                                   clearance,
+                                                   segsPerCircle,
+                                                   correctionFactor );
         }
     }
 
@@ -248,39 +394,36 @@ void ZONE_CONTAINER::buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeature
      * Pcbnew allows these items to be on copper layers in microwave applictions
      * This is a bad thing, but must be handled here, until a better way is found
      */
-    for( MODULE* module = aPcb->m_Modules;  module;  module = module->Next() )
+    for( unsigned ii = 0; ii < nearModuleEdges.size(); ii++ )
     {
-        for( BOARD_ITEM* item = module->GraphicalItems();  item;  item = item->Next() )
-        {
-            if( !item->IsOnLayer( GetLayer() ) && !item->IsOnLayer( Edge_Cuts ) )
-                continue;
+        EDGE_MODULE* item = nearModuleEdges[ii];
 
-            if( item->Type() != PCB_MODULE_EDGE_T )
-                continue;
+        if( !item->IsOnLayer( GetLayer() ) && !item->IsOnLayer( Edge_Cuts ) )
+            continue;
 
-            item_boundingbox = item->GetBoundingBox();
+        item_boundingbox = item->GetBoundingBox();
 
-            if( item_boundingbox.Intersects( zone_boundingbox ) )
-            {
-                ( (EDGE_MODULE*) item )->TransformShapeWithClearanceToPolygon(
-                    aFeatures, zone_clearance,
-                    segsPerCircle, correctionFactor );
-            }
+        if( item_boundingbox.Intersects( zone_boundingbox ) )
+        {
+            itemIndex.TransformItemShapeToPolygon( item, aFeatures, zone_clearance,
+                                                   segsPerCircle, correctionFactor );
         }
     }
 
     // Add graphic items (copper texts) and board edges
-    for( BOARD_ITEM* item = aPcb->m_Drawings; item; item = item->Next() )
+    for( unsigned ii = 0; ii < nearDrawings.size(); ii++ )
     {
+        BOARD_ITEM* item = nearDrawings[ii];
+
         if( item->GetLayer() != GetLayer() && item->GetLayer() != Edge_Cuts )
             continue;
 
         switch( item->Type() )
         {
         case PCB_LINE_T:
-            ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
-                aFeatures,
-                zone_clearance, segsPerCircle, correctionFactor );
+            itemIndex.TransformItemShapeToPolygon( item, aFeatures,
+                                                   zone_clearance, segsPerCircle,
+                                                   correctionFactor );
             break;
 
         case PCB_TEXT_T:
@@ -341,40 +484,138 @@ void ZONE_CONTAINER::buildFeatureHoleList( BOARD* aPcb, SHAPE_POLY_SET& aFeature
     }
 
    // Remove thermal symbols
-    for( MODULE* module = aPcb->m_Modules;  module;  module = module->Next() )
+    for( unsigned ii = 0; ii < nearPads.size(); ii++ )
     {
-        for( D_PAD* pad = module->Pads(); pad != NULL; pad = pad->Next() )
+        D_PAD* pad = nearPads[ii];
+
+        // Rejects non-standard pads with tht-only thermal reliefs
+        if( GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
+         && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
+            continue;
+
+        if( GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+         && GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+            continue;
+
+        if( !pad->IsOnLayer( GetLayer() ) )
+            continue;
+
+        if( pad->GetNetCode() != GetNetCode() )
+            continue;
+        item_boundingbox = pad->GetBoundingBox();
+        int thermalGap = GetThermalReliefGap( pad );
+        item_boundingbox.Inflate( thermalGap, thermalGap );
+
+        if( item_boundingbox.Intersects( zone_boundingbox ) )
         {
-            // Rejects non-standard pads with tht-only thermal reliefs
-            if( GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
-             && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
-                continue;
+            CreateThermalReliefPadPolygon( aFeatures,
+                                           *pad, thermalGap,
+                                           GetThermalReliefCopperBridge( pad ),
+                                           m_ZoneMinThickness,
+                                           segsPerCircle,
+                                           correctionFactor, s_thermalRot );
+        }
+    }
 
-            if( GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
-             && GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
-                continue;
+}
 
-            if( !pad->IsOnLayer( GetLayer() ) )
-                continue;
 
-            if( pad->GetNetCode() != GetNetCode() )
-                continue;
-            item_boundingbox = pad->GetBoundingBox();
-            int thermalGap = GetThermalReliefGap( pad );
-            item_boundingbox.Inflate( thermalGap, thermalGap );
+bool ZONE_CONTAINER::refillChangedAreas( const SHAPE_POLY_SET& aSolidAreas,
+                                         const SHAPE_POLY_SET& aHoles,
+                                         SHAPE_POLY_SET& aResult ) const
+{
+    // Find the holes which have been added or removed since the previous fill
+    std::vector<int> oldHoles, newHoles;
+    sortPolygons( m_fillHoles, oldHoles );
+    sortPolygons( aHoles, newHoles );
 
-            if( item_boundingbox.Intersects( zone_boundingbox ) )
+    std::vector<BOX2I> changedBoxes;
+    unsigned ii = 0, jj = 0;
+
+    while( ii < oldHoles.size() || jj < newHoles.size() )
+    {
+        int cmp;
+
+        if( ii == oldHoles.size() )
+            cmp = 1;
+        else if( jj == newHoles.size() )
+            cmp = -1;
+        else
+            cmp = comparePolygons( m_fillHoles.CPolygon( oldHoles[ii] ),
+                                   aHoles.CPolygon( newHoles[jj] ) );
+
+        if( cmp < 0 )
+            changedBoxes.push_back( m_fillHoles.CPolygon( oldHoles[ii++] )[0].BBox() );
+        else if( cmp > 0 )
+            changedBoxes.push_back( aHoles.CPolygon( newHoles[jj++] )[0].BBox() );
+        else
+            ii++, jj++;
+    }
+
+    if( changedBoxes.empty() )
+    {
+        aResult = m_fillRawAreas;
+        return true;
+    }
+
+    SHAPE_POLY_SET changedAreas;
+    double changedSurface = 0.0;
+
+    BOOST_FOREACH( BOX2I& box, changedBoxes )
+    {
+        box.Inflate( s_refillOverlap );
+        changedSurface += (double) box.GetWidth() * box.GetHeight();
+
+        changedAreas.NewOutline();
+        changedAreas.Append( box.GetOrigin() );
+        changedAreas.Append( VECTOR2I( box.GetRight(), box.GetY() ) );
+        changedAreas.Append( box.GetEnd() );
+        changedAreas.Append( VECTOR2I( box.GetX(), box.GetBottom() ) );
+    }
+
+    const BOX2I zoneBox = aSolidAreas.BBox();
+
+    if( changedSurface > s_maxRefillRatio * zoneBox.GetWidth() * (double) zoneBox.GetHeight() )
+        return false;
+
+    changedAreas.Simplify( POLY_CALC_MODE );
+
+    // The holes which have a part inside the changed areas
+    SHAPE_POLY_SET localHoles;
+
+    for( int hole = 0; hole < aHoles.OutlineCount(); hole++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aHoles.CPolygon( hole );
+        BOX2I holeBox = polygon[0].BBox();
+
+        BOOST_FOREACH( const BOX2I& box, changedBoxes )
+        {
+            if( holeBox.Intersects( box ) )
             {
-                CreateThermalReliefPadPolygon( aFeatures,
-                                               *pad, thermalGap,
-                                               GetThermalReliefCopperBridge( pad ),
-                                               m_ZoneMinThickness,
-                                               segsPerCircle,
-                                               correctionFactor, s_thermalRot );
+                // Hole shapes are not closed chains, so AddOutline() cannot be used
+                int outline = localHoles.NewOutline();
+                localHoles.Outline( outline ) = polygon[0];
+
+                for( unsigned kk = 1; kk < polygon.size(); kk++ )
+                {
+                    localHoles.NewHole( outline );
+                    localHoles.Hole( outline, kk - 1 ) = polygon[kk];
+                }
+
+                break;
             }
         }
     }
 
+    // Rebuild the changed areas, and replace them in the previous fill
+    SHAPE_POLY_SET rebuiltAreas;
+    rebuiltAreas.BooleanIntersection( aSolidAreas, changedAreas, POLY_CALC_MODE );
+    rebuiltAreas.BooleanSubtract( localHoles, POLY_CALC_MODE );
+
+    aResult.BooleanSubtract( m_fillRawAreas, changedAreas, POLY_CALC_MODE );
+    aResult.BooleanAdd( rebuiltAreas, POLY_CALC_MODE );
+
+    return true;
 }
 
 
@@ -448,22 +689,54 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList_NG( BOARD* aPcb )
 
     tmp.RemoveAllContours();
     buildFeatureHoleList( aPcb, holes );
+    m_fillHash = fillHash( aPcb, &holes );
 
     if(g_DumpZonesWhenFilling)
         dumper->Write( &holes, "feature-holes" );
 
-    holes.Simplify( POLY_CALC_MODE );
+    // When the zone area has not changed since the previous fill, only the areas where
+    // the holes have changed are computed again
+    SHAPE_POLY_SET rawAreas;
 
-    if (g_DumpZonesWhenFilling)
-        dumper->Write( &holes, "feature-holes-postsimplify" );
+    if( m_fillRefillCount < s_maxRefillCount && !m_fillSolidAreas.IsEmpty()
+            && samePolygons( solidAreas, m_fillSolidAreas )
+            && refillChangedAreas( solidAreas, holes, rawAreas ) )
+    {
+        m_fillRefillCount++;
+        m_fillHoles = holes;
+        m_fillRawAreas = rawAreas;
+        solidAreas = rawAreas;
+    }
+    else
+    {
+        m_fillRefillCount = 0;
+        m_fillSolidAreas = solidAreas;
+        m_fillHoles = holes;
 
-    solidAreas.BooleanSubtract( holes, POLY_CALC_MODE );
+        if (g_DumpZonesWhenFilling)
+        {
+            SHAPE_POLY_SET simplifiedHoles = holes;
+            simplifiedHoles.Simplify( POLY_CALC_MODE );
+            dumper->Write( &simplifiedHoles, "feature-holes-postsimplify" );
+        }
+
+        // The holes are not merged first: the subtraction handles the overlapping holes
+        // (with the non-zero fill rule) in the same sweep, and gives the same result
+        // in about half the time of Simplify() followed by the subtraction
+        if( m_tiledFill )
+            solidAreas.BooleanSubtractTiled( solidAreas, holes, fillTileCount( holes ),
+                                             POLY_CALC_MODE );
+        else
+            solidAreas.BooleanSubtract( holes, POLY_CALC_MODE );
+
+        m_fillRawAreas = solidAreas;
+    }
 
     if (g_DumpZonesWhenFilling)
         dumper->Write( &solidAreas, "solid-areas-minus-holes" );
 
     SHAPE_POLY_SET areas_fractured = solidAreas;
-    areas_fractured.Fracture( POLY_CALC_MODE );
+    areas_fractured.Fracture( POLY_CALC_MODE, m_tiledFill ? fillTileCount( holes ) : 1 );
 
     if (g_DumpZonesWhenFilling)
         dumper->Write( &areas_fractured, "areas_fractured" );
@@ -494,7 +767,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList_NG( BOARD* aPcb )
 
         // put these areas in m_FilledPolysList
         SHAPE_POLY_SET th_fractured = solidAreas;
-        th_fractured.Fracture( POLY_CALC_MODE );
+        th_fractured.Fracture( POLY_CALC_MODE, m_tiledFill ? fillTileCount( holes ) : 1 );
 
         if( g_DumpZonesWhenFilling )
             dumper->Write ( &th_fractured, "th_fractured" );
@@ -92,6 +92,9 @@ bool ZONE_CONTAINER::IsSame( const ZONE_CONTAINER& aZoneToCompare )
     if( m_ArcToSegmentsCount != aZoneToCompare.GetArcSegmentCount() )
         return false;
 
+    if( m_tiledFill != aZoneToCompare.GetTiledFill() )
+        return false;
+
     if( m_ZoneClearance != aZoneToCompare.m_ZoneClearance )
         return false;
 
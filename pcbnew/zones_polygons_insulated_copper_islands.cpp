@@ -25,32 +25,55 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+
 #include <fctsys.h>
 #include <common.h>
 
 #include <class_board.h>
 #include <class_module.h>
+#include <class_pad.h>
 #include <class_track.h>
 #include <class_zone.h>
+#include <board_item_index.h>
 
 #include <pcbnew.h>
 #include <zones.h>
 #include <polygon_test_point_inside.h>
 
 
+/// Sort function for the connection points: by increasing x
+static bool sortPointsByX( const VECTOR2I& aA, const VECTOR2I& aB )
+{
+    return aA.x < aB.x;
+}
+
+
 void ZONE_CONTAINER::TestForCopperIslandAndRemoveInsulatedIslands( BOARD* aPcb )
 {
     if( m_FilledPolysList.IsEmpty() )
         return;
 
     // Build a list of points connected to the net:
-    // list of coordinates of pads and vias on this layer and on this net.
-    std::vector <wxPoint> listPointsCandidates;
+    // list of coordinates of pads and vias on this layer and on this net,
+    // among the items found near the filled areas in the board item index.
+    const BOX2I fillBox = m_FilledPolysList.BBox();
+    std::vector<BOARD_ITEM*> nearItems;
+
+    aPcb->GetItemIndex().Query( EDA_RECT( wxPoint( fillBox.GetX(), fillBox.GetY() ),
+                                          wxSize( fillBox.GetWidth(), fillBox.GetHeight() ) ),
+                                GetLayer(), nearItems );
 
-    for( MODULE* module = aPcb->m_Modules; module; module = module->Next() )
+    std::vector<VECTOR2I> listPointsCandidates;
+
+    for( unsigned ii = 0; ii < nearItems.size(); ii++ )
     {
-        for( D_PAD* pad = module->Pads(); pad != NULL; pad = pad->Next() )
+        BOARD_ITEM* item = nearItems[ii];
+
+        if( item->Type() == PCB_PAD_T )
         {
+            D_PAD* pad = static_cast<D_PAD*>( item );
+
             if( !pad->IsOnLayer( GetLayer() ) )
                 continue;
 
@@ -59,44 +82,63 @@ void ZONE_CONTAINER::TestForCopperIslandAndRemoveInsulatedIslands( BOARD* aPcb )
 
             listPointsCandidates.push_back( pad->GetPosition() );
         }
-    }
+        else if( item->Type() == PCB_TRACE_T || item->Type() == PCB_VIA_T )
+        {
+            TRACK* track = static_cast<TRACK*>( item );
 
-    for( TRACK* track = aPcb->m_Track; track; track = track->Next() )
-    {
-        if( !track->IsOnLayer( GetLayer() ) )
-            continue;
+            if( !track->IsOnLayer( GetLayer() ) )
+                continue;
 
-        if( track->GetNetCode() != GetNetCode() )
-            continue;
+            if( track->GetNetCode() != GetNetCode() )
+                continue;
 
-        listPointsCandidates.push_back( track->GetStart() );
+            listPointsCandidates.push_back( track->GetStart() );
 
-        if( track->Type() != PCB_VIA_T )
-            listPointsCandidates.push_back( track->GetEnd() );
+            if( track->Type() != PCB_VIA_T )
+                listPointsCandidates.push_back( track->GetEnd() );
+        }
     }
 
-    // test if a point is inside
+    // Test if a point is inside each polygon.  Only the points in its bounding box are
+    // tested, found in the points sorted by x.
+    std::sort( listPointsCandidates.begin(), listPointsCandidates.end(), sortPointsByX );
+
+    SHAPE_POLY_SET connectedPolys;
 
     for( int outline = 0; outline < m_FilledPolysList.OutlineCount(); outline++ )
     {
+        const BOX2I box = m_FilledPolysList.COutline( outline ).BBox();
         bool connected = false;
 
-        for( unsigned ic = 0; ic < listPointsCandidates.size(); ic++ )
+        std::vector<VECTOR2I>::const_iterator it =
+                std::lower_bound( listPointsCandidates.begin(), listPointsCandidates.end(),
+                                  box.GetOrigin(), sortPointsByX );
+
+        for( ; it != listPointsCandidates.end() && it->x <= box.GetRight(); ++it )
         {
             // test if this area is connected to a board item:
-            wxPoint pos = listPointsCandidates[ic];
+            if( it->y < box.GetY() || it->y > box.GetBottom() )
+                continue;
 
-            if( m_FilledPolysList.Contains( VECTOR2I( pos.x, pos.y ), outline ) )
+            if( m_FilledPolysList.Contains( *it, outline ) )
             {
                 connected = true;
                 break;
             }
         }
 
-        if( !connected )                 // this polygon is connected: analyse next polygon
+        if( connected )                 // this polygon is connected: keep it
         {
-            m_FilledPolysList.DeletePolygon( outline );
-            outline--;
+            const SHAPE_POLY_SET::POLYGON& poly = m_FilledPolysList.CPolygon( outline );
+
+            connectedPolys.AddOutline( poly[0] );
+
+            for( unsigned ii = 1; ii < poly.size(); ii++ )
+                connectedPolys.AddHole( poly[ii] );
         }
     }
+
+    // (Deleting the insulated polygons one by one would move all the next ones each time)
+    if( connectedPolys.OutlineCount() != m_FilledPolysList.OutlineCount() )
+        m_FilledPolysList = connectedPolys;
 }
@@ -85,66 +85,169 @@ bool BOARD::OnAreaPolygonModified( PICKED_ITEMS_LIST* aModifiedZonesList,
 }
 
 
+// A zone of the net examined by CombineAllAreasInNet()
+struct NET_AREA
+{
+    ZONE_CONTAINER* m_zone;
+    EDA_RECT        m_bbox;
+    unsigned        m_index;        // index in the zone list of the board
+};
+
+
+static bool sortAreasByLeft( const NET_AREA& a, const NET_AREA& b )
+{
+    return a.m_bbox.GetX() < b.m_bbox.GetX();
+}
+
+
+static bool sortAreasByIndex( const NET_AREA& a, const NET_AREA& b )
+{
+    return a.m_index < b.m_index;
+}
+
+
+static int findGroup( std::vector<int>& aGroups, int aArea )
+{
+    while( aGroups[aArea] != aArea )
+    {
+        aGroups[aArea] = aGroups[aGroups[aArea]];
+        aArea = aGroups[aArea];
+    }
+
+    return aArea;
+}
+
+
 bool BOARD::CombineAllAreasInNet( PICKED_ITEMS_LIST* aDeletedList, int aNetCode,
                                   bool aUseLocalFlags )
 {
     if( m_ZoneDescriptorList.size() <= 1 )
         return false;
 
-    bool modified = false;
+    // The zones of the net, sorted by the left side of their bounding box: the zones
+    // which can intersect a zone are the next ones starting before its right side
+    std::vector<NET_AREA> areas;
 
-    // Loop through all combinations
-    for( unsigned ia1 = 0; ia1 < m_ZoneDescriptorList.size() - 1; ia1++ )
+    for( unsigned ia = 0; ia < m_ZoneDescriptorList.size(); ia++ )
     {
-        ZONE_CONTAINER* curr_area = m_ZoneDescriptorList[ia1];
+        ZONE_CONTAINER* zone = m_ZoneDescriptorList[ia];
 
-        if( curr_area->GetNetCode() != aNetCode )
+        if( zone->GetNetCode() != aNetCode )
             continue;
 
-        // legal polygon
-        EDA_RECT b1 = curr_area->Outline()->GetBoundingBox();
-        bool  mod_ia1 = false;
+        NET_AREA area = { zone, zone->Outline()->GetBoundingBox(), ia };
+        areas.push_back( area );
+    }
 
-        for( unsigned ia2 = m_ZoneDescriptorList.size() - 1; ia2 > ia1; ia2-- )
-        {
-            ZONE_CONTAINER* area2 = m_ZoneDescriptorList[ia2];
+    int count = areas.size();
 
-            if( area2->GetNetCode() != aNetCode )
-                continue;
+    if( count <= 1 )
+        return false;
 
-            if( curr_area->GetPriority() != area2->GetPriority() )
-                continue;
+    std::sort( areas.begin(), areas.end(), sortAreasByLeft );
 
-            if( curr_area->GetIsKeepout() != area2->GetIsKeepout() )
-                continue;
+    // Group the intersecting zones.  As when the zones were merged pair by pair, with
+    // aUseLocalFlags only the pairs of a flagged zone are tested, and a zone merged in a
+    // group is flagged: the groups grow until no new pair can be tested.
+    std::vector<int>  groups( count );
+    std::vector<char> flagged( count );
+    std::vector<char> tested( count * count, 0 );
+    bool              grouped = false;
+    bool              changed = true;
 
-            if( curr_area->GetLayer() != area2->GetLayer() )
-                continue;
+    for( int ii = 0; ii < count; ii++ )
+    {
+        groups[ii] = ii;
+        flagged[ii] = !aUseLocalFlags || areas[ii].m_zone->GetLocalFlags();
+    }
+
+    while( changed )
+    {
+        changed = false;
 
-            EDA_RECT b2 = area2->Outline()->GetBoundingBox();
+        for( int ii = 0; ii < count; ii++ )
+        {
+            const NET_AREA& area1 = areas[ii];
 
-            if( b1.Intersects( b2 ) )
+            for( int jj = ii + 1;
+                 jj < count && areas[jj].m_bbox.GetX() <= area1.m_bbox.GetRight(); jj++ )
             {
-                // check area2 against curr_area
-                if( curr_area->GetLocalFlags() || area2->GetLocalFlags()
-                    || aUseLocalFlags == false )
-                {
-                    bool ret = TestAreaIntersection( curr_area, area2 );
+                const NET_AREA& area2 = areas[jj];
+                int group1 = findGroup( groups, ii );
+                int group2 = findGroup( groups, jj );
 
-                    if( ret )
-                        ret = CombineAreas( aDeletedList, curr_area, area2 );
+                if( tested[ii * count + jj] || group1 == group2 )
+                    continue;
 
-                    if( ret )
-                    {
-                        mod_ia1 = true;
-                        modified = true;
-                    }
-                }
+                if( !flagged[group1] && !flagged[group2] )
+                    continue;       // perhaps testable once a zone of the pair is flagged
+
+                tested[ii * count + jj] = 1;
+
+                if( area1.m_zone->GetPriority() != area2.m_zone->GetPriority()
+                    || area1.m_zone->GetIsKeepout() != area2.m_zone->GetIsKeepout()
+                    || area1.m_zone->GetLayer() != area2.m_zone->GetLayer() )
+                    continue;
+
+                if( !area1.m_bbox.Intersects( area2.m_bbox )
+                    || !TestAreaIntersection( area1.m_zone, area2.m_zone ) )
+                    continue;
+
+                groups[group2] = group1;
+                flagged[group1] = true;
+                grouped = changed = true;
             }
         }
+    }
+
+    if( !grouped )
+        return false;
+
+    // Merge each group into its first zone in the zone list, with a single union
+    std::vector< std::vector<NET_AREA> > members( count );
+
+    for( int ii = 0; ii < count; ii++ )
+        members[findGroup( groups, ii )].push_back( areas[ii] );
+
+    bool modified = false;
+
+    for( int ig = 0; ig < count; ig++ )
+    {
+        std::vector<NET_AREA>& group = members[ig];
+
+        if( group.size() < 2 )
+            continue;
 
-        if( mod_ia1 )
-            ia1--;     // if modified, we need to check it again
+        std::sort( group.begin(), group.end(), sortAreasByIndex );
+
+        ZONE_CONTAINER* area_ref = group[0].m_zone;
+        SHAPE_POLY_SET  mergedOutlines;
+
+        for( unsigned ii = 0; ii < group.size(); ii++ )
+            mergedOutlines.Append( ConvertPolyListToPolySet( group[ii].m_zone->Outline()->m_CornersList ) );
+
+        mergedOutlines.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+        if( mergedOutlines.OutlineCount() == 1 )
+        {
+            area_ref->Outline()->m_CornersList = ConvertPolySetToPolyList( mergedOutlines );
+
+            for( unsigned ii = 1; ii < group.size(); ii++ )
+                RemoveArea( aDeletedList, group[ii].m_zone );
+
+            area_ref->SetLocalFlags( 1 );
+            area_ref->Outline()->Hatch();
+            modified = true;
+            continue;
+        }
+
+        // Some zones only have a common corner, and cannot be merged with the others:
+        // merge the group pair by pair
+        for( unsigned ii = 1; ii < group.size(); ii++ )
+        {
+            if( CombineAreas( aDeletedList, area_ref, group[ii].m_zone ) )
+                modified = true;
+        }
     }
 
     return modified;
@@ -222,6 +325,13 @@ bool BOARD::TestAreaIntersection( ZONE_CONTAINER* area_ref, ZONE_CONTAINER* area
                 yf1 = poly1->GetY( is1 );
             }
 
+            // only the segments inside the bounding box of the other outline can cross it
+            EDA_RECT segBox( wxPoint( xi1, yi1 ), wxSize( xf1 - xi1, yf1 - yi1 ) );
+            segBox.Normalize();
+
+            if( !segBox.Intersects( b2 ) )
+                continue;
+
             for( int icont2 = 0; icont2<poly2->GetContoursCount(); icont2++ )
             {
                 int is2 = poly2->GetContourStart( icont2 );
@@ -244,6 +354,12 @@ bool BOARD::TestAreaIntersection( ZONE_CONTAINER* area_ref, ZONE_CONTAINER* area
                         yf2 = poly2->GetY( is2 );
                     }
 
+                    if( std::max( xi2, xf2 ) < segBox.GetX()
+                        || std::min( xi2, xf2 ) > segBox.GetRight()
+                        || std::max( yi2, yf2 ) < segBox.GetY()
+                        || std::min( yi2, yf2 ) > segBox.GetBottom() )
+                        continue;
+
                     bool intersect = FindSegmentIntersections( xi1, yi1, xf1, yf1,
                                                                xi2, yi2, xf2, yf2 );
                     if( intersect )
@@ -260,7 +376,7 @@ bool BOARD::TestAreaIntersection( ZONE_CONTAINER* area_ref, ZONE_CONTAINER* area
         int x = poly2->GetX( ic2 );
         int y = poly2->GetY( ic2 );
 
-        if( poly1->TestPointInside( x, y ) )
+        if( b1.Contains( x, y ) && poly1->TestPointInside( x, y ) )
         {
             return true;
         }
@@ -271,7 +387,7 @@ bool BOARD::TestAreaIntersection( ZONE_CONTAINER* area_ref, ZONE_CONTAINER* area
         int x = poly1->GetX( ic1 );
         int y = poly1->GetY( ic1 );
 
-        if( poly2->TestPointInside( x, y ) )
+        if( b2.Contains( x, y ) && poly2->TestPointInside( x, y ) )
         {
             return true;
         }
@@ -293,8 +409,8 @@ bool BOARD::CombineAreas( PICKED_ITEMS_LIST* aDeletedList, ZONE_CONTAINER* area_
     SHAPE_POLY_SET mergedOutlines = ConvertPolyListToPolySet( area_ref->Outline()->m_CornersList );
     SHAPE_POLY_SET areaToMergePoly = ConvertPolyListToPolySet( area_to_combine->Outline()->m_CornersList );
 
+    // the union is already simplified
     mergedOutlines.BooleanAdd( areaToMergePoly, SHAPE_POLY_SET::PM_FAST  );
-    mergedOutlines.Simplify( SHAPE_POLY_SET::PM_FAST );
 
     // We should have one polygon with hole
     // We can have 2 polygons with hole, if the 2 initial polygons have only one common corner
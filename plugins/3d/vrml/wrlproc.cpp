@@ -27,6 +27,7 @@
 #include <wx/string.h>
 #include <wx/log.h>
 #include "wrlproc.h"
+#include "decimal_parser.h"
 
 #define GETLINE do {\
     try { \
@@ -46,6 +47,67 @@
     } } while( 0 )
 
 
+// The numbers of the point and index arrays make most of the model files, and a
+// std::istringstream per number is what their parsing costs: the plain decimal
+// numbers are converted directly, the others still go through the stream.
+
+// converts a whole glob to a float, as a stream does, returning false on trailing text
+static bool convertFloat( const std::string& aGlob, float& aValue )
+{
+    // float powers of 10 are exact up to 1e10
+    static const float powersOf10[] =
+    {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    DECIMAL_NUMBER number;
+
+    // with digits and a power of 10 both exact floats, the division is correctly
+    // rounded as the stream conversion is
+    if( number.Parse( aGlob.c_str() ) && number.digits < ( 1u << 24 ) && number.decimals <= 10 )
+    {
+        aValue = (float) number.digits / powersOf10[number.decimals];
+
+        if( number.negative )
+            aValue = -aValue;
+
+        return true;
+    }
+
+    std::istringstream istr;
+    std::string tail;
+
+    istr.str( aGlob );
+    istr >> aValue;
+    istr >> tail;
+
+    return tail.empty();
+}
+
+
+// converts a whole glob to an int, as a stream does, returning false on trailing text
+static bool convertInt( const std::string& aGlob, int& aValue )
+{
+    DECIMAL_NUMBER number;
+
+    if( number.Parse( aGlob.c_str() ) && std::string::npos == aGlob.find( '.' )
+        && number.digits <= INT_MAX )
+    {
+        aValue = number.negative ? -(int) number.digits : (int) number.digits;
+        return true;
+    }
+
+    std::istringstream istr;
+    std::string tail;
+
+    istr.str( aGlob );
+    istr >> aValue;
+    istr >> tail;
+
+    return tail.empty();
+}
+
+
 WRLPROC::WRLPROC( LINE_READER* aLineReader )
 {
     m_fileVersion = VRML_INVALID;
@@ -256,23 +318,24 @@ bool WRLPROC::ReadGlob( std::string& aGlob )
     }
 
     size_t ssize = m_buf.size();
+    size_t start = m_bufpos;
 
     while( m_bufpos < ssize && m_buf[m_bufpos] > 0x20 )
     {
-        if( ',' == m_buf[m_bufpos] )
-        {
-            // the comma is a special instance of blank space
-            ++m_bufpos;
-            return true;
-        }
+        char c = m_buf[m_bufpos];
 
-        if( '{' == m_buf[m_bufpos] || '}' == m_buf[m_bufpos]
-            || '[' == m_buf[m_bufpos] || ']' == m_buf[m_bufpos] )
-            return true;
+        if( ',' == c || '{' == c || '}' == c || '[' == c || ']' == c )
+            break;
 
-        aGlob.append( 1, m_buf[m_bufpos++] );
+        ++m_bufpos;
     }
 
+    aGlob.assign( m_buf, start, m_bufpos - start );
+
+    // the comma is a special instance of blank space
+    if( m_bufpos < ssize && ',' == m_buf[m_bufpos] )
+        ++m_bufpos;
+
     return true;
 }
 
@@ -826,14 +889,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
         return false;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-
-    istr >> aSFFloat;
-    tmp.clear();
-    istr >> tmp;
-
-    if( !tmp.empty() )
+    if( !convertFloat( tmp, aSFFloat ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -899,14 +955,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
         return true;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-
-    istr >> aSFInt32;
-    tmp.clear();
-    istr >> tmp;
-
-    if( !tmp.empty() )
+    if( !convertInt( tmp, aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -969,14 +1018,7 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-
-        istr >> trot[i];
-        tmp.clear();
-        istr >> tmp;
-
-        if( !tmp.empty() )
+        if( !convertFloat( tmp, trot[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1045,14 +1087,7 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-
-        istr >> tcol[i];
-        tmp.clear();
-        istr >> tmp;
-
-        if( !tmp.empty() )
+        if( !convertFloat( tmp, tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1127,14 +1162,7 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
         if( ',' == m_buf[m_bufpos] )
             Pop();
 
-        std::istringstream istr;
-        istr.str( tmp );
-
-        istr >> tcol[i];
-        tmp.clear();
-        istr >> tmp;
-
-        if( !tmp.empty() )
+        if( !convertFloat( tmp, tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
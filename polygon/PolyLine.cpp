@@ -54,12 +54,14 @@ CPolyLine::CPolyLine()
     m_hatchPitch = 0;
     m_layer      = F_Cu;
     m_flags    = 0;
+    m_hatchDirty = false;
 }
 
 CPolyLine::CPolyLine( const CPolyLine& aCPolyLine)
 {
     Copy( &aCPolyLine );
     m_HatchLines    = aCPolyLine.m_HatchLines;     // vector <> copy
+    m_hatchDirty    = aCPolyLine.m_hatchDirty;
 }
 
 
@@ -160,11 +162,7 @@ int CPolyLine::NormalizeAreaOutlines( std::vector<CPolyLine*>* aNewPolygonList )
             aNewPolygonList->push_back( polyline );
         }
 
-        SHAPE_POLY_SET pnew;
-        pnew.NewOutline();
-        pnew.Polygon( 0 ) = polySet.CPolygon( ii );
-
-        polyline->m_CornersList = ConvertPolySetToPolyList( pnew );
+        polyline->m_CornersList = ConvertPolySetToPolyList( polySet, ii );
     }
 
     return polySet.OutlineCount();
@@ -540,6 +538,7 @@ void CPolyLine::InsertCorner( int ic, int x, int y )
 void CPolyLine::UnHatch()
 {
     m_HatchLines.clear();
+    m_hatchDirty = false;
 }
 
 
@@ -709,6 +708,14 @@ bool sort_ends_by_descending_X( const wxPoint& ref, const wxPoint& tst )
 void CPolyLine::Hatch()
 {
     m_HatchLines.clear();
+    m_hatchDirty = true;
+}
+
+
+void CPolyLine::buildHatch()
+{
+    m_HatchLines.clear();
+    m_hatchDirty = false;
 
     if( m_hatchStyle == NO_HATCH || m_hatchPitch == 0 )
         return;
@@ -1299,52 +1306,54 @@ const SHAPE_POLY_SET ConvertPolyListToPolySet( const CPOLYGONS_LIST& aList )
 
     unsigned corners_count = aList.GetCornersCount();
 
-    // Enter main outline: this is the first contour
-    unsigned ic = 0;
-
     if( !corners_count )
         return rv;
 
-    int index = 0;
+    // Enter main outline: this is the first contour, the next ones are its holes.
+    // Each contour is built then added at once.
+    unsigned ic = 0;
+    SHAPE_LINE_CHAIN contour;
 
     while( ic < corners_count )
     {
-        int hole = -1;
-
-        if( index == 0 )
-        {
-            rv.NewOutline();
-            hole = -1;
-        }
-        else
-        {
-            hole = rv.NewHole();
-        }
+        contour.Clear();
 
         while( ic < corners_count )
         {
-            rv.Append( aList.GetX( ic ), aList.GetY( ic ), 0, hole );
+            contour.Append( aList.GetX( ic ), aList.GetY( ic ) );
 
             if( aList.IsEndContour( ic ) )
                 break;
 
             ic++;
         }
+
         ic++;
 
-        index++;
+        contour.SetClosed( true );
+
+        if( rv.OutlineCount() == 0 )
+            rv.AddOutline( contour );
+        else
+            rv.AddHole( contour );
     }
 
     return rv;
 }
 
 
-const CPOLYGONS_LIST ConvertPolySetToPolyList(const SHAPE_POLY_SET& aPolyset)
+const CPOLYGONS_LIST ConvertPolySetToPolyList( const SHAPE_POLY_SET& aPolyset, int aOutline )
 {
     CPOLYGONS_LIST list;
     CPolyPt corner, firstCorner;
 
-    const SHAPE_POLY_SET::POLYGON& poly = aPolyset.CPolygon( 0 );
+    const SHAPE_POLY_SET::POLYGON& poly = aPolyset.CPolygon( aOutline );
+    int count = 0;
+
+    for( unsigned int jj = 0; jj < poly.size() ; jj++ )
+        count += poly[jj].PointCount() + 1;
+
+    list.reserve( count );
 
     for( unsigned int jj = 0; jj < poly.size() ; jj++ )
     {
@@ -294,9 +294,24 @@ public:
     void        RemoveAllContours( void );
 
     // Remove or create hatch
+    // The hatch lines are built by the next GetHatchLines(), not by Hatch(): the
+    // outlines can be changed many times between two redraws
     void        UnHatch();
     void        Hatch();
 
+    /**
+     * Function GetHatchLines
+     * @return the hatch lines of the outline, built if Hatch() was called since the
+     * the last call
+     */
+    const std::vector<CSegment>& GetHatchLines()
+    {
+        if( m_hatchDirty )
+            buildHatch();
+
+        return m_HatchLines;
+    }
+
     // Transform functions
     void        MoveOrigin( int x_off, int y_off );
 
@@ -478,12 +493,18 @@ private:
                                             // and the len of eacvh segment
                                             // for DIAGONAL_FULL, the pitch is twice this value
     int                 m_flags;            // a flag used in some calculations
+    bool                m_hatchDirty;       // Hatch() was called, m_HatchLines is to be built
+
+    // build the hatch lines, see Hatch()
+    void buildHatch();
+
 public:
     CPOLYGONS_LIST          m_CornersList;  // array of points for corners
-    std::vector <CSegment>  m_HatchLines;   // hatch lines showing the polygon area
+    std::vector <CSegment>  m_HatchLines;   // hatch lines showing the polygon area,
+                                            // see GetHatchLines()
 };
 
 const SHAPE_POLY_SET ConvertPolyListToPolySet( const CPOLYGONS_LIST& aList );
-const CPOLYGONS_LIST ConvertPolySetToPolyList( const SHAPE_POLY_SET& aPolyset );
+const CPOLYGONS_LIST ConvertPolySetToPolyList( const SHAPE_POLY_SET& aPolyset, int aOutline = 0 );
 
 #endif    // #ifndef POLYLINE_H
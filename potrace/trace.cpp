@@ -8,11 +8,16 @@
 #include <config.h>
 #endif
 
+#include <errno.h>
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
 #include "potracelib.h"
 #include "curve.h"
 #include "lists.h"
@@ -1485,59 +1490,111 @@ calloc_error:
 #define TRY( x ) if( x ) \
         goto try_error
 
-/* return 0 on success, 1 on error with errno set. */
-int process_path( path_t* plist, const potrace_param_t* param, progress_t* progress )
+/* compute the curve of a single path, independently of the other paths.
+ *  Return 0 on success, 1 on error with errno set. */
+static int process_one_path( path_t* p, const potrace_param_t* param )
 {
-    path_t* p;
-    double  nn = 0, cn = 0;
+    TRY( calc_sums( p->priv ) );
+    TRY( calc_lon( p->priv ) );
+    TRY( bestpolygon( p->priv ) );
+    TRY( adjust_vertices( p->priv ) );
 
-    if( progress->callback )
+    if( p->sign == '-' )    /* reverse orientation of negative paths */
     {
-        /* precompute task size for progress estimates */
-        nn = 0;
-        list_forall( p, plist ) {
-            nn += p->priv->len;
-        }
-        cn = 0;
+        reverse( &p->priv->curve );
+    }
+
+    smooth( &p->priv->curve, param->alphamax );
+
+    if( param->opticurve )
+    {
+        TRY( opticurve( p->priv, param->opttolerance ) );
+        p->priv->fcurve = &p->priv->ocurve;
     }
+    else
+    {
+        p->priv->fcurve = &p->priv->curve;
+    }
+
+    privcurve_to_curve( p->priv->fcurve, &p->curve );
 
-    /* call downstream function with each path */
+    return 0;
+
+try_error:
+    return 1;
+}
+
+
+/* return 0 on success, 1 on error with errno set. */
+int process_path( path_t* plist, const potrace_param_t* param, progress_t* progress )
+{
+    path_t*     p;
+    path_t**    paths;
+    double      nn = 0, cn = 0;
+    int         count = 0;
+    int         failed = 0;
+
+    /* precompute task size for progress estimates */
     list_forall( p, plist ) {
-        TRY( calc_sums( p->priv ) );
-        TRY( calc_lon( p->priv ) );
-        TRY( bestpolygon( p->priv ) );
-        TRY( adjust_vertices( p->priv ) );
+        nn += p->priv->len;
+        count++;
+    }
 
-        if( p->sign == '-' )    /* reverse orientation of negative paths */
-        {
-            reverse( &p->priv->curve );
-        }
+    /* the paths are independent, they are processed on the threads of OpenMP */
+    paths = (path_t**) malloc( ( count ? count : 1 ) * sizeof( path_t* ) );
 
-        smooth( &p->priv->curve, param->alphamax );
+    if( !paths )
+        return 1;
 
-        if( param->opticurve )
-        {
-            TRY( opticurve( p->priv, param->opttolerance ) );
-            p->priv->fcurve = &p->priv->ocurve;
-        }
-        else
+    count = 0;
+    list_forall( p, plist ) {
+        paths[count++] = p;
+    }
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule( dynamic, 16 ) shared( failed, cn )
+#endif
+    for( int i = 0; i < count; i++ )
+    {
+        /* a loop shared between threads cannot be left, skip the remaining paths */
+        if( failed )
+            continue;
+
+        if( process_one_path( paths[i], param ) )
         {
-            p->priv->fcurve = &p->priv->curve;
+            failed = 1;
+            continue;
         }
 
-        privcurve_to_curve( p->priv->fcurve, &p->curve );
-
         if( progress->callback )
         {
-            cn += p->priv->len;
-            progress_update( cn / nn, progress );
+            /* the callback is only called by the calling thread */
+            int mainThread = 1;
+
+#ifdef USE_OPENMP
+            #pragma omp atomic
+#endif
+            cn += paths[i]->priv->len;
+
+#ifdef USE_OPENMP
+            mainThread = omp_get_thread_num() == 0;
+#endif
+
+            if( mainThread )
+                progress_update( cn / nn, progress );
         }
     }
 
+    free( paths );
+
+    if( failed )
+    {
+        /* errno was set by the thread that failed */
+        errno = ENOMEM;
+        return 1;
+    }
+
     progress_update( 1.0, progress );
 
     return 0;
-
-try_error:
-    return 1;
 }
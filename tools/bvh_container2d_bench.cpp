@@ -0,0 +1,230 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+    A benchmark of the CBVHCONTAINER2D builders: the build time of the tree, and the
+    time of the queries of the 3D renders, for the middle split, the SAH split, and the
+    SAH split built on the thread pool.
+
+    Usage:  bvh_container2d_bench [board.kicad_pcb] [queries]
+
+    The tracks and vias of each copper layer of the board file are used, so real boards
+    can be measured.  Without a file, a synthetic BGA fan-out is used.  The queries are
+    random boxes of up to 2 mm, the size of a tile of rays, whose results must match for
+    all the builders.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <profile.h>
+#include <thread_pool.h>
+#include <class_track.h>
+
+#include <3d_rendering/3d_render_raytracing/accelerators/ccontainer2d.h>
+#include <3d_rendering/3d_render_raytracing/shapes2D/croundsegment2d.h>
+
+
+/// A track of the board, in mm
+struct SEGMENT
+{
+    SFVEC2F m_start;
+    SFVEC2F m_end;
+    float   m_width;
+};
+
+typedef std::map< std::string, std::vector<SEGMENT> > LAYER_SEGMENTS;
+
+
+static void addSegment( std::vector<SEGMENT>& aLayer, const SFVEC2F& aStart,
+                        const SFVEC2F& aEnd, float aWidth )
+{
+    SEGMENT segment;
+
+    segment.m_start = aStart;
+    // a round segment needs a direction, the vias and pads are very short segments
+    segment.m_end = ( aStart == aEnd ) ? aEnd + SFVEC2F( 0.0001f, 0.0f ) : aEnd;
+    segment.m_width = aWidth;
+    aLayer.push_back( segment );
+}
+
+
+/// Builds a grid of BGA pads, each with a fan-out track and a via
+static void buildFanout( int aSize, std::vector<SEGMENT>& aLayer )
+{
+    const float pitch = 1.0f;
+
+    for( int ii = 1; ii <= aSize; ii++ )
+    {
+        for( int jj = 1; jj <= aSize; jj++ )
+        {
+            SFVEC2F pad( ii * pitch, jj * pitch );
+            SFVEC2F via = pad + SFVEC2F( pitch / 2, pitch / 2 );
+
+            addSegment( aLayer, pad, pad, pitch * 0.45f );
+            addSegment( aLayer, pad, via, pitch * 0.15f );
+            addSegment( aLayer, via, via, pitch * 0.3f );
+        }
+    }
+}
+
+
+/// Reads the tracks and vias of a .kicad_pcb file, one item per line as saved by pcbnew
+static bool readBoard( const char* aFileName, LAYER_SEGMENTS& aLayers )
+{
+    FILE* file = fopen( aFileName, "r" );
+
+    if( !file )
+        return false;
+
+    char  line[1024];
+    char  layer[64];
+    float x0, y0, x1, y1, width;
+
+    while( fgets( line, sizeof( line ), file ) )
+    {
+        if( sscanf( line, " (segment (start %f %f) (end %f %f) (width %f) (layer %63[^)])",
+                    &x0, &y0, &x1, &y1, &width, layer ) == 6 )
+        {
+            addSegment( aLayers[layer], SFVEC2F( x0, y0 ), SFVEC2F( x1, y1 ), width );
+        }
+        else if( sscanf( line, " (via (at %f %f) (size %f)", &x0, &y0, &width ) == 3 )
+        {
+            // the through vias, on the outer layers only
+            addSegment( aLayers["F.Cu"], SFVEC2F( x0, y0 ), SFVEC2F( x0, y0 ), width );
+            addSegment( aLayers["B.Cu"], SFVEC2F( x0, y0 ), SFVEC2F( x0, y0 ), width );
+        }
+    }
+
+    fclose( file );
+
+    return true;
+}
+
+
+static float randomFloat( float aMin, float aMax )
+{
+    return aMin + ( aMax - aMin ) * ( rand() / (float) RAND_MAX );
+}
+
+
+int main( int argc, char** argv )
+{
+    LAYER_SEGMENTS layers;
+
+    if( argc > 1 )
+    {
+        if( !readBoard( argv[1], layers ) )
+        {
+            printf( "cannot read %s\n", argv[1] );
+            return 1;
+        }
+    }
+    else
+    {
+        buildFanout( 100, layers["F.Cu"] );
+    }
+
+    const int       queryCount = argc > 2 ? atoi( argv[2] ) : 100000;
+    THREAD_POOL     pool;
+    TRACK           dummyTrack( NULL );
+    int             mismatches = 0;
+
+    const char*         methodNames[] = { "middle", "sah", "sah pool" };
+    BVH_SPLIT_METHOD    methods[] = { BVH_SPLIT_MIDDLE, BVH_SPLIT_SAH, BVH_SPLIT_SAH };
+    THREAD_POOL*        pools[] = { NULL, NULL, &pool };
+
+    printf( "layer     objects  method    build ms  query ms  found\n" );
+
+    for( LAYER_SEGMENTS::const_iterator ii = layers.begin(); ii != layers.end(); ++ii )
+    {
+        const std::vector<SEGMENT>& segments = ii->second;
+        CBVHCONTAINER2D             container;
+        CBBOX2D                     bbox;
+
+        bbox.Reset();
+
+        for( unsigned jj = 0; jj < segments.size(); jj++ )
+        {
+            COBJECT2D* object = new CROUNDSEGMENT2D( segments[jj].m_start, segments[jj].m_end,
+                                                     segments[jj].m_width, dummyTrack );
+
+            bbox.Union( object->GetBBox() );
+            container.Add( object );
+        }
+
+        // the same queries for all the builders
+        std::vector<CBBOX2D> queries( queryCount );
+
+        srand( 1 );
+
+        for( int jj = 0; jj < queryCount; jj++ )
+        {
+            SFVEC2F min( randomFloat( bbox.Min().x, bbox.Max().x ),
+                         randomFloat( bbox.Min().y, bbox.Max().y ) );
+            SFVEC2F size( randomFloat( 0.0f, 2.0f ), randomFloat( 0.0f, 2.0f ) );
+
+            queries[jj].Set( min, min + size );
+        }
+
+        unsigned long refFound = 0;
+
+        for( unsigned mm = 0; mm < sizeof( methods ) / sizeof( methods[0] ); mm++ )
+        {
+            prof_counter  cnt;
+            unsigned long found = 0;
+
+            prof_start( &cnt );
+            container.BuildBVH( methods[mm], pools[mm] );
+            prof_end( &cnt );
+            float buildTime = cnt.msecs();
+
+            prof_start( &cnt );
+
+            for( int jj = 0; jj < queryCount; jj++ )
+            {
+                CONST_LIST_OBJECT2D result;
+
+                container.GetListObjectsIntersects( queries[jj], result );
+                found += result.size();
+            }
+
+            prof_end( &cnt );
+            float queryTime = cnt.msecs();
+
+            if( mm == 0 )
+                refFound = found;
+            else if( found != refFound )
+                mismatches++;
+
+            printf( "%-8s  %7u  %-8s  %8.1f  %8.1f  %lu\n", ii->first.c_str(),
+                    (unsigned) segments.size(), methodNames[mm], buildTime, queryTime, found );
+        }
+    }
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+    A benchmark of DECIMAL_NUMBER, the number conversion of PCB_PARSER.
+
+    Usage:  decimal_parser_bench [count]
+
+    Random lengths in mm are formatted like the board files do, with up to 6 decimals,
+    and random angles and ratios with up to 15 digits.  They are converted by strtod()
+    and by DECIMAL_NUMBER, whose results must match exactly.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <profile.h>
+#include <decimal_parser.h>
+
+
+static int kiRound( double v )
+{
+    return (int) ( v < 0 ? v - 0.5 : v + 0.5 );
+}
+
+
+/// A length in mm as written by the board files: a nanometre count, trailing zeros removed
+static std::string randomLength()
+{
+    char buf[32];
+    int nm = rand() % 2000000000 / ( rand() % 2 ? 1 : 1000 ) * ( rand() % 2 ? 1 : -1 );
+
+    sprintf( buf, "%.6f", nm / 1e6 );
+
+    std::string s( buf );
+
+    while( s[s.size() - 1] == '0' )
+        s.erase( s.size() - 1 );
+
+    if( s[s.size() - 1] == '.' )
+        s.erase( s.size() - 1 );
+
+    return s;
+}
+
+
+static std::string randomDouble()
+{
+    char buf[32];
+    double v = ( rand() - RAND_MAX / 2 ) / (double) ( rand() % 100000 + 1 );
+
+    sprintf( buf, "%.*f", rand() % 12, v );
+
+    return buf;
+}
+
+
+int main( int argc, char** argv )
+{
+    int count = argc > 1 ? atoi( argv[1] ) : 1000000;
+    int mismatches = 0, fallbacks = 0;
+    prof_counter cnt;
+    std::vector<std::string> lengths, doubles;
+
+    srand( 1 );
+
+    for( int i = 0; i < count; i++ )
+    {
+        lengths.push_back( randomLength() );
+        doubles.push_back( randomDouble() );
+    }
+
+    const char* special[] = { "0", "-0", "0.0", "-0.5", ".5", "5.", "+1.25", "1e3",
+                              "0.0000005", "1234567.891234", "3000", "-2147.483648" };
+
+    for( unsigned i = 0; i < sizeof( special ) / sizeof( special[0] ); i++ )
+    {
+        lengths.push_back( special[i] );
+        doubles.push_back( special[i] );
+    }
+
+    long long refSum = 0, newSum = 0;
+    double refDSum = 0.0, newDSum = 0.0;
+
+    prof_start( &cnt );
+
+    for( unsigned i = 0; i < lengths.size(); i++ )
+        refSum += kiRound( strtod( lengths[i].c_str(), NULL ) * 1e6 );
+
+    for( unsigned i = 0; i < doubles.size(); i++ )
+        refDSum += strtod( doubles[i].c_str(), NULL );
+
+    prof_end( &cnt );
+    float refTime = cnt.msecs();
+
+    prof_start( &cnt );
+
+    for( unsigned i = 0; i < lengths.size(); i++ )
+    {
+        DECIMAL_NUMBER number;
+        int biu;
+
+        if( !number.Parse( lengths[i].c_str() ) || !number.ToMillionths( biu ) )
+            biu = kiRound( strtod( lengths[i].c_str(), NULL ) * 1e6 );
+
+        newSum += biu;
+    }
+
+    for( unsigned i = 0; i < doubles.size(); i++ )
+    {
+        DECIMAL_NUMBER number;
+        double v;
+
+        if( !number.Parse( doubles[i].c_str() ) || !number.ToDouble( v ) )
+            v = strtod( doubles[i].c_str(), NULL );
+
+        newDSum += v;
+    }
+
+    prof_end( &cnt );
+    float newTime = cnt.msecs();
+
+    // the exact comparison, outside of the timings
+    for( unsigned i = 0; i < lengths.size(); i++ )
+    {
+        DECIMAL_NUMBER number;
+        int biu;
+        double v;
+
+        if( number.Parse( lengths[i].c_str() ) && number.ToMillionths( biu ) )
+        {
+            if( biu != kiRound( strtod( lengths[i].c_str(), NULL ) * 1e6 ) )
+            {
+                printf( "length mismatch: %s\n", lengths[i].c_str() );
+                mismatches++;
+            }
+        }
+        else
+            fallbacks++;
+
+        if( number.Parse( doubles[i].c_str() ) && number.ToDouble( v ) )
+        {
+            double ref = strtod( doubles[i].c_str(), NULL );
+
+            if( memcmp( &v, &ref, sizeof( v ) ) )
+            {
+                printf( "double mismatch: %s\n", doubles[i].c_str() );
+                mismatches++;
+            }
+        }
+        else
+            fallbacks++;
+    }
+
+    printf( "numbers  strtod ms  decimal_number ms  fallbacks  mismatches\n" );
+    printf( "%7u  %9.1f  %17.1f  %9d  %10d\n", (unsigned) ( lengths.size() + doubles.size() ),
+            refTime, newTime, fallbacks, mismatches );
+
+    return mismatches || refSum != newSum || refDSum != newDSum ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+    A benchmark of the SHAPE_LINE_CHAIN collision and intersection tests, which skip
+    the segments found apart by SHAPE_LINE_CHAIN::NearSegments().
+
+    Usage:  line_chain_collide_bench [iterations]
+
+    The results are compared to the ones of the plain segment by segment tests, which
+    they must match exactly.  Random meanders are used, on a coarse grid so that
+    collinear, touching and overlapping segments are frequent.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <profile.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_circle.h>
+
+
+/// The segment by segment SHAPE_LINE_CHAIN::Collide()
+static bool refCollide( const SHAPE_LINE_CHAIN& aChain, const SEG& aSeg, int aClearance )
+{
+    BOX2I box_a( aSeg.A, aSeg.B - aSeg.A );
+    BOX2I::ecoord_type dist_sq = (BOX2I::ecoord_type) aClearance * aClearance;
+
+    for( int i = 0; i < aChain.SegmentCount(); i++ )
+    {
+        const SEG& s = aChain.CSegment( i );
+        BOX2I box_b( s.A, s.B - s.A );
+
+        if( box_a.SquaredDistance( box_b ) < dist_sq && s.Collide( aSeg, aClearance ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+/// The segment by segment circle to line chain collision
+static bool refCollide( const SHAPE_LINE_CHAIN& aChain, const SHAPE_CIRCLE& aCircle,
+                        int aClearance )
+{
+    for( int s = 0; s < aChain.SegmentCount(); s++ )
+    {
+        if( aCircle.Collide( aChain.CSegment( s ), aClearance ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+/// The segment by segment SHAPE_LINE_CHAIN::Intersect()
+static void refIntersect( const SHAPE_LINE_CHAIN& aA, const SHAPE_LINE_CHAIN& aB,
+                          SHAPE_LINE_CHAIN::INTERSECTIONS& aIp )
+{
+    BOX2I bb_other = aB.BBox();
+
+    for( int s1 = 0; s1 < aA.SegmentCount(); s1++ )
+    {
+        const SEG& a = aA.CSegment( s1 );
+
+        if( !bb_other.Intersects( BOX2I( a.A, a.B - a.A ) ) )
+            continue;
+
+        for( int s2 = 0; s2 < aB.SegmentCount(); s2++ )
+        {
+            const SEG& b = aB.CSegment( s2 );
+            SHAPE_LINE_CHAIN::INTERSECTION is;
+
+            is.our = a;
+            is.their = b;
+
+            if( a.Collinear( b ) )
+            {
+                if( a.Contains( b.A ) ) { is.p = b.A; aIp.push_back( is ); }
+                if( a.Contains( b.B ) ) { is.p = b.B; aIp.push_back( is ); }
+                if( b.Contains( a.A ) ) { is.p = a.A; aIp.push_back( is ); }
+                if( b.Contains( a.B ) ) { is.p = a.B; aIp.push_back( is ); }
+            }
+            else
+            {
+                OPT_VECTOR2I p = a.Intersect( b );
+
+                if( p )
+                {
+                    is.p = *p;
+                    aIp.push_back( is );
+                }
+            }
+        }
+    }
+}
+
+
+/// The segment by segment SHAPE_LINE_CHAIN::SelfIntersecting(), reporting the point only
+static bool refSelfIntersecting( const SHAPE_LINE_CHAIN& aChain, VECTOR2I& aP )
+{
+    int n = aChain.SegmentCount();
+
+    for( int s1 = 0; s1 < n; s1++ )
+    {
+        for( int s2 = s1 + 1; s2 < n; s2++ )
+        {
+            const SEG a = aChain.CSegment( s1 ), b = aChain.CSegment( s2 );
+
+            if( s1 + 1 != s2 && a.Contains( b.A ) )
+            {
+                aP = b.A;
+                return true;
+            }
+            else if( a.Contains( b.B ) && !( aChain.IsClosed() && s1 == 0 && s2 == n - 1 ) )
+            {
+                aP = b.B;
+                return true;
+            }
+            else
+            {
+                OPT_VECTOR2I p = a.Intersect( b, true );
+
+                if( p )
+                {
+                    aP = *p;
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+
+static bool sameIntersections( const SHAPE_LINE_CHAIN::INTERSECTIONS& aA,
+                               const SHAPE_LINE_CHAIN::INTERSECTIONS& aB )
+{
+    if( aA.size() != aB.size() )
+        return false;
+
+    for( unsigned i = 0; i < aA.size(); i++ )
+    {
+        if( aA[i].p != aB[i].p || aA[i].our.Index() != aB[i].our.Index() ||
+            aA[i].their.Index() != aB[i].their.Index() )
+            return false;
+    }
+
+    return true;
+}
+
+
+/// A random walk of aCount points on a grid of aPitch, in a aSize x aSize square
+static SHAPE_LINE_CHAIN randomChain( int aCount, int aPitch, int aSize )
+{
+    SHAPE_LINE_CHAIN chain;
+    VECTOR2I p( rand() % aSize, rand() % aSize );
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        chain.Append( p * aPitch );
+        p.x = std::max( 0, std::min( aSize, p.x + rand() % 5 - 2 ) );
+        p.y = std::max( 0, std::min( aSize, p.y + rand() % 5 - 2 ) );
+    }
+
+    chain.SetClosed( rand() % 4 == 0 );
+
+    return chain;
+}
+
+
+int main( int argc, char** argv )
+{
+    int iterations = argc > 1 ? atoi( argv[1] ) : 2000;
+    int mismatches = 0;
+    prof_counter cnt;
+    float refTime = 0.0, newTime = 0.0;
+
+    srand( 1 );
+
+    for( int i = 0; i < iterations; i++ )
+    {
+        const int pitch = i % 2 ? 1 : 100000;
+        SHAPE_LINE_CHAIN a = randomChain( 20 + rand() % 200, pitch, 100 );
+        SHAPE_LINE_CHAIN b = randomChain( 1 + rand() % 50, pitch, 100 );
+        SEG seg( b.CPoint( 0 ), b.CPoint( -1 ) );
+        SHAPE_CIRCLE circle( b.CPoint( 0 ), rand() % 3 * pitch );
+        int clearance = ( rand() % 4 - 1 ) * pitch;
+
+        SHAPE_LINE_CHAIN::INTERSECTIONS refIp, newIp;
+        bool refCol, newCol, refCircle, newCircle, refSelf, newSelf;
+        VECTOR2I refSelfP, newSelfP;
+
+        prof_start( &cnt );
+        refCol = refCollide( a, seg, clearance );
+        refCircle = refCollide( a, circle, clearance );
+        refIntersect( a, b, refIp );
+        refSelf = refSelfIntersecting( a, refSelfP );
+        prof_end( &cnt );
+        refTime += cnt.msecs();
+
+        prof_start( &cnt );
+        newCol = a.Collide( seg, clearance );
+        newCircle = static_cast<const SHAPE&>( circle ).Collide( &a, clearance );
+        a.Intersect( b, newIp );
+        boost::optional<SHAPE_LINE_CHAIN::INTERSECTION> self = a.SelfIntersecting();
+        prof_end( &cnt );
+        newTime += cnt.msecs();
+
+        newSelf = !!self;
+
+        if( newSelf )
+            newSelfP = self->p;
+
+        if( refCol != newCol || refCircle != newCircle || !sameIntersections( refIp, newIp ) ||
+            refSelf != newSelf || ( refSelf && refSelfP != newSelfP ) )
+        {
+            printf( "mismatch in test %d\n", i );
+            mismatches++;
+        }
+    }
+
+    printf( "tests  segment by segment ms  near segments ms  mismatches\n" );
+    printf( "%5d  %21.1f  %16.1f  %10d\n", iterations, refTime, newTime, mismatches );
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+    A benchmark of SHAPE_POLY_SET::Fracture(), on the filled areas of zones.
+
+    Usage:  polyset_fracture_bench [zones_dump.txt]
+
+    The dump file is written by the zone filler when g_DumpZonesWhenFilling is set
+    (see zones_convert_brd_items_to_polygons_with_Boost.cpp): its "solid-areas-minus-holes"
+    shapes, the filled areas before Fracture(), are used.  Without a file, a synthetic
+    plane stitched by a grid of vias is used.
+
+    The area of each result is compared to the area before Fracture(), which it must keep.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <profile.h>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_file_io.h>
+
+#define POLY_MODE   SHAPE_POLY_SET::PM_FAST
+
+
+/// Builds a square plane with a grid of aSize x aSize octagonal via holes
+static void buildStitchedPlane( int aSize, SHAPE_POLY_SET& aPlane )
+{
+    const int   pitch = 1000000;        // 1 mm
+    const int   radius = 300000;
+    const int   width = ( aSize + 1 ) * pitch;
+
+    aPlane.NewOutline();
+    aPlane.Append( 0, 0 );
+    aPlane.Append( width, 0 );
+    aPlane.Append( width, width );
+    aPlane.Append( 0, width );
+
+    for( int ii = 1; ii <= aSize; ii++ )
+    {
+        for( int jj = 1; jj <= aSize; jj++ )
+        {
+            int hole = aPlane.NewHole();
+
+            for( int kk = 0; kk < 8; kk++ )
+            {
+                double a = M_PI * ( 2 * kk + 1 ) / 8;
+                aPlane.Append( ii * pitch + radius * cos( a ), jj * pitch + radius * sin( a ),
+                               -1, hole );
+            }
+        }
+    }
+}
+
+
+/// Reads the filled areas of the zones of a zone filler dump
+static void readDump( const char* aFileName, std::vector<SHAPE_POLY_SET>& aAreas )
+{
+    SHAPE_FILE_IO   file( aFileName, SHAPE_FILE_IO::IOM_READ );
+    SHAPE*          shape;
+    std::string     name;
+
+    while( ( shape = file.Read( &name ) ) != NULL )
+    {
+        if( shape->Type() == SH_POLY_SET && name == "solid-areas-minus-holes" )
+            aAreas.push_back( *static_cast<SHAPE_POLY_SET*>( shape ) );
+
+        delete shape;
+    }
+}
+
+
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double total = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aSet.CPolygon( ii );
+
+        for( unsigned jj = 0; jj < poly.size(); jj++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = poly[jj];
+            double a = 0.0;
+
+            for( int kk = 0; kk < chain.PointCount(); kk++ )
+            {
+                const VECTOR2I& p = chain.CPoint( kk );
+                const VECTOR2I& q = chain.CPoint( ( kk + 1 ) % chain.PointCount() );
+                a += (double) p.x * q.y - (double) q.x * p.y;
+            }
+
+            total += jj == 0 ? fabs( a ) / 2 : -fabs( a ) / 2;
+        }
+    }
+
+    return total;
+}
+
+
+int main( int argc, char** argv )
+{
+    std::vector<SHAPE_POLY_SET> areas;
+
+    if( argc > 1 )
+    {
+        readDump( argv[1], areas );
+    }
+    else
+    {
+        areas.resize( 1 );
+        buildStitchedPlane( 100, areas[0] );
+    }
+
+    printf( "zone  outlines  holes  vertices  fracture ms  area change nm2\n" );
+
+    for( unsigned ii = 0; ii < areas.size(); ii++ )
+    {
+        prof_counter    cnt;
+        SHAPE_POLY_SET  fractured = areas[ii];
+        int             holes = 0;
+
+        for( int jj = 0; jj < areas[ii].OutlineCount(); jj++ )
+            holes += areas[ii].HoleCount( jj );
+
+        prof_start( &cnt );
+        fractured.Fracture( POLY_MODE );
+        prof_end( &cnt );
+
+        printf( "%4u  %8d  %5d  %8d  %11.1f  %15.0f\n", ii, areas[ii].OutlineCount(), holes,
+                areas[ii].TotalVertices(), cnt.msecs(), area( fractured ) - area( areas[ii] ) );
+    }
+
+    return 0;
+}
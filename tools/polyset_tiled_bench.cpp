@@ -0,0 +1,303 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+    A comparison of SHAPE_POLY_SET::BooleanSubtractTiled(), used by the tiled zone fill,
+    with BooleanSubtract(), for several tile counts.
+
+    Usage:  polyset_tiled_bench [zones_dump.txt]
+
+    The dump file is written by the zone filler when g_DumpZonesWhenFilling is set
+    (see zones_convert_brd_items_to_polygons_with_Boost.cpp), so real boards can be
+    used.  Without a file, a synthetic plane is used, whose holes have islands inside,
+    and the islands holes: the tiled subtraction gives its inner holes back to the
+    polygons of the merged tiles, and a hole given to the wrong polygon shows here.
+
+    The tiled result must have the same outlines and holes as the untiled one, and the
+    area of their difference must only come from the rounding of the intersections.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <profile.h>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_file_io.h>
+
+#define POLY_MODE   SHAPE_POLY_SET::PM_FAST
+
+
+/// Appends a circle of 16 segments to aSet, as a new outline or as a hole of aOutline
+static void addCircle( SHAPE_POLY_SET& aSet, const VECTOR2I& aCenter, int aRadius,
+                       int aOutline = -1 )
+{
+    int hole = aOutline < 0 ? -1 : aSet.NewHole( aOutline );
+
+    if( aOutline < 0 )
+        aOutline = aSet.NewOutline();
+
+    for( int ii = 0; ii < 16; ii++ )
+    {
+        double a = M_PI * ( 2 * ii + 1 ) / 16;
+        aSet.Append( aCenter.x + aRadius * cos( a ), aCenter.y + aRadius * sin( a ),
+                     aOutline, hole );
+    }
+}
+
+
+/**
+ * Builds a square plane for a grid of aSize x aSize cells.  The holes of a cell are a
+ * ring, which leaves an island in the plane, a via in the island, and a via in the plane
+ * next to the ring.
+ */
+static void buildRingPlane( int aSize, SHAPE_POLY_SET& aArea, SHAPE_POLY_SET& aHoles )
+{
+    const int   pitch = 2000000;    // 2 mm
+    const int   width = ( aSize + 1 ) * pitch;
+
+    aArea.NewOutline();
+    aArea.Append( 0, 0 );
+    aArea.Append( width, 0 );
+    aArea.Append( width, width );
+    aArea.Append( 0, width );
+
+    for( int ii = 1; ii <= aSize; ii++ )
+    {
+        for( int jj = 1; jj <= aSize; jj++ )
+        {
+            VECTOR2I center( ii * pitch, jj * pitch );
+
+            addCircle( aHoles, center, pitch * 35 / 100 );
+            addCircle( aHoles, center, pitch * 25 / 100, aHoles.OutlineCount() - 1 );
+            addCircle( aHoles, center, pitch * 8 / 100 );
+            addCircle( aHoles, center + VECTOR2I( pitch / 2, pitch / 2 ), pitch * 10 / 100 );
+        }
+    }
+}
+
+
+/// Reads the (solid-areas, feature-holes) pairs of a zone filler dump
+static void readDump( const char* aFileName, std::vector<SHAPE_POLY_SET>& aAreas,
+                      std::vector<SHAPE_POLY_SET>& aHoles )
+{
+    SHAPE_FILE_IO   file( aFileName, SHAPE_FILE_IO::IOM_READ );
+    SHAPE*          shape;
+    std::string     name;
+
+    while( ( shape = file.Read( &name ) ) != NULL )
+    {
+        if( shape->Type() == SH_POLY_SET )
+        {
+            const SHAPE_POLY_SET& polySet = *static_cast<SHAPE_POLY_SET*>( shape );
+
+            if( name == "solid-areas" )
+                aAreas.push_back( polySet );
+            else if( name == "feature-holes" && aHoles.size() < aAreas.size() )
+                aHoles.push_back( polySet );
+        }
+
+        delete shape;
+    }
+
+    aAreas.resize( aHoles.size() );
+}
+
+
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double total = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aSet.CPolygon( ii );
+
+        for( unsigned jj = 0; jj < poly.size(); jj++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = poly[jj];
+            double a = 0.0;
+
+            for( int kk = 0; kk < chain.PointCount(); kk++ )
+            {
+                const VECTOR2I& p = chain.CPoint( kk );
+                const VECTOR2I& q = chain.CPoint( ( kk + 1 ) % chain.PointCount() );
+                a += (double) p.x * q.y - (double) q.x * p.y;
+            }
+
+            total += jj == 0 ? fabs( a ) / 2 : -fabs( a ) / 2;
+        }
+    }
+
+    return total;
+}
+
+
+/// @return the area of the symmetric difference of aA and aB
+static double xorArea( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    SHAPE_POLY_SET a, b;
+
+    a.BooleanSubtract( aA, aB, POLY_MODE );
+    b.BooleanSubtract( aB, aA, POLY_MODE );
+
+    return area( a ) + area( b );
+}
+
+
+/// @return true if aA and aB are the same boxes, but for aTolerance
+static bool sameBox( const BOX2I& aA, const BOX2I& aB, int aTolerance )
+{
+    return std::abs( aA.GetX() - aB.GetX() ) <= aTolerance
+           && std::abs( aA.GetY() - aB.GetY() ) <= aTolerance
+           && std::abs( aA.GetRight() - aB.GetRight() ) <= aTolerance
+           && std::abs( aA.GetBottom() - aB.GetBottom() ) <= aTolerance;
+}
+
+
+/**
+ * @return true if each polygon of aRef has a polygon of aTest with the same outline and
+ * the same holes, compared by their bounding boxes.  The area of the difference of two
+ * sets does not tell which polygon a hole belongs to: a hole of an island given to the
+ * polygon around the island covers the same points.
+ */
+static bool sameStructure( const SHAPE_POLY_SET& aRef, const SHAPE_POLY_SET& aTest )
+{
+    // The intersections on the tile borders are rounded
+    const int tolerance = 100;
+
+    if( aRef.OutlineCount() != aTest.OutlineCount() )
+        return false;
+
+    std::vector<bool> used( aTest.OutlineCount(), false );
+
+    for( int ii = 0; ii < aRef.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& ref = aRef.CPolygon( ii );
+        const BOX2I refBox = ref[0].BBox();
+        bool found = false;
+
+        for( int jj = 0; !found && jj < aTest.OutlineCount(); jj++ )
+        {
+            const SHAPE_POLY_SET::POLYGON& test = aTest.CPolygon( jj );
+
+            if( used[jj] || test.size() != ref.size()
+                    || !sameBox( refBox, test[0].BBox(), tolerance ) )
+                continue;
+
+            std::vector<bool> holeUsed( test.size(), false );
+            bool sameHoles = true;
+
+            for( unsigned kk = 1; sameHoles && kk < ref.size(); kk++ )
+            {
+                const BOX2I holeBox = ref[kk].BBox();
+                sameHoles = false;
+
+                for( unsigned ll = 1; !sameHoles && ll < test.size(); ll++ )
+                {
+                    if( !holeUsed[ll] && sameBox( holeBox, test[ll].BBox(), tolerance ) )
+                        holeUsed[ll] = sameHoles = true;
+                }
+            }
+
+            if( sameHoles )
+                used[jj] = found = true;
+        }
+
+        if( !found )
+            return false;
+    }
+
+    return true;
+}
+
+
+static int holeCount( const SHAPE_POLY_SET& aSet )
+{
+    int count = 0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+        count += aSet.HoleCount( ii );
+
+    return count;
+}
+
+
+int main( int argc, char** argv )
+{
+    std::vector<SHAPE_POLY_SET> areas, holes;
+
+    if( argc > 1 )
+    {
+        readDump( argv[1], areas, holes );
+    }
+    else
+    {
+        areas.resize( 1 );
+        holes.resize( 1 );
+        buildRingPlane( 25, areas[0], holes[0] );
+    }
+
+    const int   tileCounts[] = { 2, 3, 4, 8 };
+    const int   tileCountsSize = sizeof( tileCounts ) / sizeof( tileCounts[0] );
+    int         mismatches = 0;
+
+    printf( "zone  tiles  outlines  holes  sub ms  tiled sub ms  xor nm2  same\n" );
+
+    for( unsigned ii = 0; ii < areas.size(); ii++ )
+    {
+        prof_counter    cnt;
+        SHAPE_POLY_SET  ref;
+
+        prof_start( &cnt );
+        ref.BooleanSubtract( areas[ii], holes[ii], POLY_MODE );
+        prof_end( &cnt );
+        float refTime = cnt.msecs();
+
+        for( int jj = 0; jj < tileCountsSize; jj++ )
+        {
+            SHAPE_POLY_SET tiled;
+
+            prof_start( &cnt );
+            tiled.BooleanSubtractTiled( areas[ii], holes[ii], tileCounts[jj], POLY_MODE );
+            prof_end( &cnt );
+
+            // The rounding on the tile borders leaves slivers of a few nm2 per crossed edge,
+            // far less than the area of any hole
+            double  xor_nm2 = xorArea( ref, tiled );
+            bool    same = sameStructure( ref, tiled ) && xor_nm2 < 1e-6 * area( ref );
+
+            if( !same )
+                mismatches++;
+
+            printf( "%4u  %5d  %4d/%-4d  %5d/%-5d  %6.1f  %12.1f  %7.0f  %s\n", ii,
+                    tileCounts[jj], tiled.OutlineCount(), ref.OutlineCount(),
+                    holeCount( tiled ), holeCount( ref ), refTime, cnt.msecs(), xor_nm2,
+                    same ? "yes" : "NO" );
+        }
+    }
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2016 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+    A benchmark of the ways to remove the hole list of a zone from its area:
+    Simplify() of the holes then subtraction (the previous zone filler),
+    SimplifyBatched() of the holes then subtraction, direct subtraction, and tiled
+    subtraction (BooleanSubtractTiled(), used by the tiled zone fill).
+
+    Usage:  polyset_union_bench [zones_dump.txt]
+
+    The dump file is written by the zone filler when g_DumpZonesWhenFilling is set
+    (see zones_convert_brd_items_to_polygons_with_Boost.cpp), so real boards can be
+    used.  Without a file, a synthetic BGA fan-out is used.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <profile.h>
+#include <geometry/shape_poly_set.h>
+#include <geometry/shape_file_io.h>
+
+#define POLY_MODE   SHAPE_POLY_SET::PM_FAST
+#define TILE_COUNT  4
+
+
+/// Appends an oval from aStart to aEnd, with a radius of aRadius
+static void addOval( SHAPE_POLY_SET& aSet, const VECTOR2I& aStart, const VECTOR2I& aEnd,
+                     int aRadius )
+{
+    const int   segs = 8;
+    double      angle = atan2( (double) ( aEnd.y - aStart.y ), (double) ( aEnd.x - aStart.x ) );
+
+    aSet.NewOutline();
+
+    for( int ii = 0; ii <= segs; ii++ )
+    {
+        double a = angle + M_PI / 2 + M_PI * ii / segs;
+        aSet.Append( aEnd.x + aRadius * cos( a ), aEnd.y + aRadius * sin( a ) );
+    }
+
+    for( int ii = 0; ii <= segs; ii++ )
+    {
+        double a = angle - M_PI / 2 + M_PI * ii / segs;
+        aSet.Append( aStart.x + aRadius * cos( a ), aStart.y + aRadius * sin( a ) );
+    }
+}
+
+
+/// Builds a square zone covering a grid of BGA pads, each with a fan-out track and a via
+static void buildFanout( int aSize, SHAPE_POLY_SET& aArea, SHAPE_POLY_SET& aHoles )
+{
+    const int   pitch = 1000000;    // 1 mm
+    const int   width = ( aSize + 1 ) * pitch;
+
+    aArea.NewOutline();
+    aArea.Append( 0, 0 );
+    aArea.Append( width, 0 );
+    aArea.Append( width, width );
+    aArea.Append( 0, width );
+
+    for( int ii = 1; ii <= aSize; ii++ )
+    {
+        for( int jj = 1; jj <= aSize; jj++ )
+        {
+            VECTOR2I pad( ii * pitch, jj * pitch );
+            VECTOR2I via = pad + VECTOR2I( pitch / 2, pitch / 2 );
+
+            addOval( aHoles, pad, pad + VECTOR2I( 1, 0 ), pitch * 35 / 100 );
+            addOval( aHoles, pad, via, pitch * 15 / 100 );
+            addOval( aHoles, via, via + VECTOR2I( 1, 0 ), pitch * 30 / 100 );
+        }
+    }
+}
+
+
+/// Reads the (solid-areas, feature-holes) pairs of a zone filler dump
+static void readDump( const char* aFileName, std::vector<SHAPE_POLY_SET>& aAreas,
+                      std::vector<SHAPE_POLY_SET>& aHoles )
+{
+    SHAPE_FILE_IO   file( aFileName, SHAPE_FILE_IO::IOM_READ );
+    SHAPE*          shape;
+    std::string     name;
+
+    while( ( shape = file.Read( &name ) ) != NULL )
+    {
+        if( shape->Type() == SH_POLY_SET )
+        {
+            const SHAPE_POLY_SET& polySet = *static_cast<SHAPE_POLY_SET*>( shape );
+
+            if( name == "solid-areas" )
+                aAreas.push_back( polySet );
+            else if( name == "feature-holes" && aHoles.size() < aAreas.size() )
+                aHoles.push_back( polySet );
+        }
+
+        delete shape;
+    }
+
+    aAreas.resize( aHoles.size() );
+}
+
+
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double total = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ii++ )
+    {
+        const SHAPE_POLY_SET::POLYGON& poly = aSet.CPolygon( ii );
+
+        for( unsigned jj = 0; jj < poly.size(); jj++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = poly[jj];
+            double a = 0.0;
+
+            for( int kk = 0; kk < chain.PointCount(); kk++ )
+            {
+                const VECTOR2I& p = chain.CPoint( kk );
+                const VECTOR2I& q = chain.CPoint( ( kk + 1 ) % chain.PointCount() );
+                a += (double) p.x * q.y - (double) q.x * p.y;
+            }
+
+            total += jj == 0 ? fabs( a ) / 2 : -fabs( a ) / 2;
+        }
+    }
+
+    return total;
+}
+
+
+/// @return the area of the symmetric difference of aA and aB
+static double xorArea( const SHAPE_POLY_SET& aA, const SHAPE_POLY_SET& aB )
+{
+    SHAPE_POLY_SET a, b;
+
+    a.BooleanSubtract( aA, aB, POLY_MODE );
+    b.BooleanSubtract( aB, aA, POLY_MODE );
+
+    return area( a ) + area( b );
+}
+
+
+int main( int argc, char** argv )
+{
+    std::vector<SHAPE_POLY_SET> areas, holes;
+
+    if( argc > 1 )
+    {
+        readDump( argv[1], areas, holes );
+    }
+    else
+    {
+        areas.resize( 1 );
+        holes.resize( 1 );
+        buildFanout( 50, areas[0], holes[0] );
+    }
+
+    printf( "zone  holes  vertices  simplify+sub ms  batched+sub ms  direct sub ms  "
+            "tiled sub ms  xor batched nm2  xor direct nm2  xor tiled nm2\n" );
+
+    for( unsigned ii = 0; ii < areas.size(); ii++ )
+    {
+        prof_counter    cnt;
+        SHAPE_POLY_SET  simplified = holes[ii], batched = holes[ii];
+        SHAPE_POLY_SET  ref, resBatched, resDirect, resTiled;
+
+        prof_start( &cnt );
+        simplified.Simplify( POLY_MODE );
+        ref.BooleanSubtract( areas[ii], simplified, POLY_MODE );
+        prof_end( &cnt );
+        float refTime = cnt.msecs();
+
+        prof_start( &cnt );
+        batched.SimplifyBatched( POLY_MODE );
+        resBatched.BooleanSubtract( areas[ii], batched, POLY_MODE );
+        prof_end( &cnt );
+        float batchedTime = cnt.msecs();
+
+        prof_start( &cnt );
+        resDirect.BooleanSubtract( areas[ii], holes[ii], POLY_MODE );
+        prof_end( &cnt );
+        float directTime = cnt.msecs();
+
+        prof_start( &cnt );
+        resTiled.BooleanSubtractTiled( areas[ii], holes[ii], TILE_COUNT, POLY_MODE );
+        prof_end( &cnt );
+        float tiledTime = cnt.msecs();
+
+        printf( "%4u  %5d  %8d  %15.1f  %14.1f  %13.1f  %12.1f  %15.0f  %14.0f  %13.0f\n", ii,
+                holes[ii].OutlineCount(), holes[ii].TotalVertices(),
+                refTime, batchedTime, directTime, tiledTime,
+                xorArea( ref, resBatched ), xorArea( ref, resDirect ), xorArea( ref, resTiled ) );
+    }
+
+    return 0;
+}
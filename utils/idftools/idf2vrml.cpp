@@ -50,6 +50,8 @@
 #include <libgen.h>
 #include <unistd.h>
 #include <boost/ptr_container/ptr_map.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 #include <idf_helpers.h>
 #include <idf_common.h>
@@ -101,6 +103,21 @@ struct VRML_IDS
     }
 };
 
+// the tesselation of a component outline, shared by all of its placements in the
+// compact output, where they USE the object of the first one
+struct VRML_OUTLINE
+{
+    IDF3_COMP_OUTLINE* outline;
+    VRML_LAYER layer;
+    bool populated;
+
+    VRML_OUTLINE()
+    {
+        outline = NULL;
+        populated = false;
+    }
+};
+
 #define NCOLORS 7
 VRML_COLOR colors[NCOLORS] =
 {
@@ -117,6 +134,10 @@ bool WriteHeader( IDF3_BOARD& board, std::ofstream& file );
 bool MakeBoard( IDF3_BOARD& board, std::ofstream& file );
 bool MakeComponents( IDF3_BOARD& board, std::ofstream& file, bool compact );
 bool MakeOtherOutlines( IDF3_BOARD& board, std::ofstream& file );
+void TesselateOutlines( IDF3_BOARD& board,
+                        boost::ptr_map< const std::string, VRML_OUTLINE >& outlines );
+void TesselateOutlineRange( const std::vector< VRML_OUTLINE* >* outlines, double scale,
+                            unsigned first, unsigned step );
 bool PopulateVRML( VRML_LAYER& model, const std::list< IDF_OUTLINE* >* items, bool bottom,
                    double scale, double dX = 0.0, double dY = 0.0, double angle = 0.0 );
 bool AddSegment( VRML_LAYER& model, IDF_SEGMENT* seg, int icont, int iseg );
@@ -749,6 +770,12 @@ bool MakeComponents( IDF3_BOARD& board, std::ofstream& file, bool compact )
     VRML_IDS* vcp;
     IDF3_COMP_OUTLINE* pout;
 
+    // the outlines by UID, tesselated once for all of their placements
+    boost::ptr_map< const std::string, VRML_OUTLINE > outlines;
+
+    if( compact )
+        TesselateOutlines( board, outlines );
+
     while( sc != ec )
     {
         sc->second->GetPosition( vX, vY, vA, lyr );
@@ -786,6 +813,8 @@ bool MakeComponents( IDF3_BOARD& board, std::ofstream& file, bool compact )
                 continue;
             }
 
+            VRML_LAYER* layer = &vpcb;
+
             if( !compact )
             {
                 if( !PopulateVRML( vpcb, (*so)->GetOutline()->GetOutlines(), bottom,
@@ -796,11 +825,13 @@ bool MakeComponents( IDF3_BOARD& board, std::ofstream& file, bool compact )
             }
             else
             {
-                if( !vcp->used && !PopulateVRML( vpcb, (*so)->GetOutline()->GetOutlines(), false,
-                    board.GetUserScale() ) )
-                {
+                // the outline was tesselated by TesselateOutlines()
+                VRML_OUTLINE* shared = &outlines.at( pout->GetUID() );
+
+                if( !vcp->used && !shared->populated )
                     return false;
-                }
+
+                layer = &shared->layer;
 
                 vcp->dX = tX * scale;
                 vcp->dY = tY * scale;
@@ -808,7 +839,7 @@ bool MakeComponents( IDF3_BOARD& board, std::ofstream& file, bool compact )
                 vcp->dA = tA * M_PI / 180.0;
             }
 
-            if( !compact || !vcp->used )
+            if( !compact )
             {
                 vpcb.EnsureWinding( 0, false );
 
@@ -849,7 +880,7 @@ bool MakeComponents( IDF3_BOARD& board, std::ofstream& file, bool compact )
             if( bot > top )
                 std::swap( bot, top );
 
-            WriteTriangles( file, vcp, &vpcb, false,
+            WriteTriangles( file, vcp, layer, false,
                             false, top, bot, board.GetUserPrecision(), compact );
 
             vpcb.Clear();
@@ -863,6 +894,99 @@ bool MakeComponents( IDF3_BOARD& board, std::ofstream& file, bool compact )
 }
 
 
+// tesselates the outlines of the range first, first + step, ... of the list
+void TesselateOutlineRange( const std::vector< VRML_OUTLINE* >* outlines, double scale,
+                            unsigned first, unsigned step )
+{
+    for( unsigned i = first; i < outlines->size(); i += step )
+    {
+        VRML_OUTLINE* vout = (*outlines)[i];
+        VRML_LAYER& layer = vout->layer;
+
+        // set the arc parameters according to output scale
+        int tI;
+        double tMin, tMax;
+        layer.GetArcParams( tI, tMin, tMax );
+        layer.SetArcParams( tI, tMin * scale, tMax * scale );
+
+        vout->populated = PopulateVRML( layer, vout->outline->GetOutlines(), false, scale );
+
+        if( !vout->populated )
+            continue;
+
+        layer.EnsureWinding( 0, false );
+
+        int nvcont = layer.GetNContours() - 1;
+
+        while( nvcont > 0 )
+            layer.EnsureWinding( nvcont--, true );
+
+        layer.Tesselate( NULL );
+    }
+}
+
+
+// tesselates each component outline of the board once, the outlines being shared by
+// many components; each VRML_LAYER has its own GLU tesselator, so the outlines are
+// tesselated on as many threads as the hardware runs
+void TesselateOutlines( IDF3_BOARD& board,
+                        boost::ptr_map< const std::string, VRML_OUTLINE >& outlines )
+{
+    std::vector< VRML_OUTLINE* > list;
+
+    const std::map< std::string, IDF3_COMPONENT* >*const comp = board.GetComponents();
+    std::map< std::string, IDF3_COMPONENT* >::const_iterator sc = comp->begin();
+    std::map< std::string, IDF3_COMPONENT* >::const_iterator ec = comp->end();
+
+    std::list< IDF3_COMP_OUTLINE_DATA* >::const_iterator so;
+    std::list< IDF3_COMP_OUTLINE_DATA* >::const_iterator eo;
+
+    while( sc != ec )
+    {
+        so = sc->second->GetOutlinesData()->begin();
+        eo = sc->second->GetOutlinesData()->end();
+
+        while( so != eo )
+        {
+            IDF3_COMP_OUTLINE* pout = (IDF3_COMP_OUTLINE*)((*so)->GetOutline());
+
+            // the outlines skipped by MakeComponents()
+            if( !pout || ( pout->GetThickness() < 0.00000001 && nozeroheights )
+                || outlines.find( pout->GetUID() ) != outlines.end() )
+            {
+                ++so;
+                continue;
+            }
+
+            VRML_OUTLINE* vout = new VRML_OUTLINE;
+            vout->outline = pout;
+
+            std::string uid = pout->GetUID();
+            outlines.insert( uid, vout );
+            list.push_back( vout );
+            ++so;
+        }
+
+        ++sc;
+    }
+
+    unsigned nthreads = std::max( 1u, boost::thread::hardware_concurrency() );
+
+    if( nthreads > list.size() )
+        nthreads = std::max( (size_t) 1, list.size() );
+
+    boost::thread_group threads;
+
+    // the calling thread tesselates the first range
+    for( unsigned i = 1; i < nthreads; ++i )
+        threads.create_thread( boost::bind( TesselateOutlineRange, &list,
+                                            board.GetUserScale(), i, nthreads ) );
+
+    TesselateOutlineRange( &list, board.GetUserScale(), 0, nthreads );
+    threads.join_all();
+}
+
+
 VRML_IDS* GetColor( boost::ptr_map<const std::string, VRML_IDS>& cmap, int& index, const std::string& uid )
 {
     static int refnum = 0;
@@ -411,6 +411,38 @@ bool VRML_LAYER::EnsureWinding( int aContourID, bool aHoleFlag )
 }
 
 
+// adds a copy of the contours of another layer
+bool VRML_LAYER::AddContours( const VRML_LAYER& aLayer )
+{
+    if( fix )
+    {
+        error = "AddContours(): no more vertices may be added (Tesselate was previously executed)";
+        return false;
+    }
+
+    for( unsigned int i = 0; i < aLayer.contours.size(); ++i )
+    {
+        int contour = NewContour( aLayer.pth[i] );
+
+        if( contour < 0 )
+            return false;
+
+        std::list<int>::const_iterator cbeg = aLayer.contours[i]->begin();
+        std::list<int>::const_iterator cend = aLayer.contours[i]->end();
+
+        while( cbeg != cend )
+        {
+            VERTEX_3D* vp = aLayer.vertices[ *cbeg++ ];
+
+            if( !AddVertex( contour, vp->x, vp->y ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
 bool VRML_LAYER::AppendCircle( double aXpos, double aYpos,
                                double aRadius, int aContourID,
                                bool aHoleFlag )
@@ -980,7 +1012,7 @@ bool VRML_LAYER::pushOutline( VRML_LAYER* holes )
 
 
 // writes out the vertex list for a planar feature
-bool VRML_LAYER::WriteVertices( double aZcoord, std::ofstream& aOutFile, int aPrecision )
+bool VRML_LAYER::WriteVertices( double aZcoord, std::ostream& aOutFile, int aPrecision )
 {
     if( ordmap.size() < 3 )
     {
@@ -1026,7 +1058,7 @@ bool VRML_LAYER::WriteVertices( double aZcoord, std::ofstream& aOutFile, int aPr
 // writes out the vertex list for a 3D feature; top and bottom are the
 // Z values for the top and bottom; top must be > bottom
 bool VRML_LAYER::Write3DVertices( double aTopZ, double aBottomZ,
-                                  std::ofstream& aOutFile, int aPrecision )
+                                  std::ostream& aOutFile, int aPrecision )
 {
     if( ordmap.size() < 3 )
     {
@@ -1113,7 +1145,7 @@ bool VRML_LAYER::Write3DVertices( double aTopZ, double aBottomZ,
 // writes out the index list;
 // 'top' indicates the vertex ordering and should be
 // true for a polygon visible from above the PCB
-bool VRML_LAYER::WriteIndices( bool aTopFlag, std::ofstream& aOutFile )
+bool VRML_LAYER::WriteIndices( bool aTopFlag, std::ostream& aOutFile )
 {
     if( triplets.empty() )
     {
@@ -1161,7 +1193,7 @@ bool VRML_LAYER::WriteIndices( bool aTopFlag, std::ofstream& aOutFile )
 
 
 // writes out the index list for a 3D feature
-bool VRML_LAYER::Write3DIndices( std::ofstream& aOutFile, bool aIncludePlatedHoles )
+bool VRML_LAYER::Write3DIndices( std::ostream& aOutFile, bool aIncludePlatedHoles )
 {
     if( outline.empty() )
     {
@@ -229,6 +229,18 @@ public:
      */
     bool EnsureWinding( int aContourID, bool aHoleFlag );
 
+    /**
+     * Function AddContours
+     * adds a copy of all the contours of another layer, with their winding and their
+     * plated hole flag.  A layer used as holes by Tesselate() is modified by it: each
+     * layer tesselated concurrently needs its own copy of the holes.
+     *
+     * @param aLayer is the layer to copy, which must not have been tesselated
+     *
+     * @return bool: true if the contours were added
+     */
+    bool AddContours( const VRML_LAYER& aLayer );
+
     /**
      * Function AppendCircle
      * adds a circular contour to the specified (empty) contour
@@ -336,7 +348,7 @@ public:
      *
      * @return bool: true if the operation succeeded
      */
-    bool WriteVertices( double aZcoord, std::ofstream& aOutFile, int aPrecision );
+    bool WriteVertices( double aZcoord, std::ostream& aOutFile, int aPrecision );
 
     /**
      * Function Write3DVertices
@@ -349,7 +361,7 @@ public:
      *
      * @return bool: true if the operation succeeded
      */
-    bool Write3DVertices( double aTopZ, double aBottomZ, std::ofstream& aOutFile, int aPrecision );
+    bool Write3DVertices( double aTopZ, double aBottomZ, std::ostream& aOutFile, int aPrecision );
 
     /**
      * Function WriteIndices
@@ -362,7 +374,7 @@ public:
      *
      * @return bool: true if the operation succeeded
      */
-    bool WriteIndices( bool aTopFlag, std::ofstream& aOutFile );
+    bool WriteIndices( bool aTopFlag, std::ostream& aOutFile );
 
     /**
      * Function Write3DIndices
@@ -375,7 +387,7 @@ public:
      *
      * @return bool: true if the operation succeeded
      */
-    bool Write3DIndices( std::ofstream& aOutFile, bool aIncludePlatedHoles = false );
+    bool Write3DIndices( std::ostream& aOutFile, bool aIncludePlatedHoles = false );
 
     /**
      * Function AddExtraVertex